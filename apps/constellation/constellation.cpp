@@ -17,9 +17,15 @@
 //------------------------------------------------------------------------------
 
 #include "constellation.hpp"
+#include "core/byte_array/decoders.hpp"
+#include "core/service_ids.hpp"
+#include "core/startup_graph.hpp"
 #include "http/middleware/allow_origin.hpp"
+#include "http/middleware/compression.hpp"
+#include "ledger/block_replay_profiler.hpp"
 #include "ledger/chain/consensus/bad_miner.hpp"
 #include "ledger/chain/consensus/dummy_miner.hpp"
+#include "ledger/chaincode/compiled_script_cache.hpp"
 #include "ledger/chaincode/contract_http_interface.hpp"
 #include "ledger/chaincode/wallet_http_interface.hpp"
 #include "ledger/execution_manager.hpp"
@@ -33,9 +39,19 @@
 #include "network/uri.hpp"
 
 #include "health_check_http_module.hpp"
-
+#include "prometheus_http_module.hpp"
+#include "rpc_metrics_http_module.hpp"
+#include "runtime_stats_http_module.hpp"
+#include "storage_metrics_http_module.hpp"
+#include "thread_usage_http_module.hpp"
+#include "trace_http_module.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
 #include <memory>
 #include <random>
+#include <string>
 #include <utility>
 
 using fetch::byte_array::ToBase64;
@@ -60,6 +76,7 @@ using LaneIndex = fetch::ledger::LaneIdentity::lane_type;
 
 // static const std::chrono::milliseconds LANE_CONNECTION_TIME{10000};
 static const std::size_t HTTP_THREADS{4};
+static char const *const TX_ADDRESS_INDEX_FILENAME = "tx_address_index.db";
 
 bool WaitForLaneServersToStart()
 {
@@ -78,6 +95,34 @@ std::size_t CalcNetworkManagerThreads(std::size_t num_lanes)
   return (num_lanes * THREADS_PER_LANE) + OTHER_THREADS;
 }
 
+/**
+ * Build the compression options for the traffic to peers outside of the local network
+ *
+ * @param dictionary_path The path to the preset dictionary, empty if there is none
+ * @return The compression options
+ */
+muddle::CompressionOptions CreateCompressionOptions(std::string const &dictionary_path)
+{
+  muddle::CompressionOptions options;
+  options.enabled = true;
+
+  if (!dictionary_path.empty())
+  {
+    std::ifstream stream(dictionary_path, std::ios::in | std::ios::binary);
+    std::string   contents{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+
+    if (contents.empty())
+    {
+      FETCH_LOG_WARN(Constellation::LOGGING_NAME,
+                     "Unable to read the compression dictionary: ", dictionary_path);
+    }
+
+    options.dictionary = byte_array::ConstByteArray{contents};
+  }
+
+  return options;
+}
+
 uint16_t LookupLocalPort(Manifest const &manifest, ServiceType service, uint16_t instance = 0)
 {
   ServiceIdentifier identifier{service, instance};
@@ -91,7 +136,8 @@ uint16_t LookupLocalPort(Manifest const &manifest, ServiceType service, uint16_t
 }
 
 ledger::ShardConfigs GenerateShardsConfig(uint32_t num_lanes, uint16_t start_port,
-                                          std::string const &storage_path)
+                                          std::string const &storage_path, bool pipelined_tx_sync,
+                                          bool reconcile_tx_sync, bool speculative_execution)
 {
   ledger::ShardConfigs configs(num_lanes);
 
@@ -106,9 +152,12 @@ ledger::ShardConfigs GenerateShardsConfig(uint32_t num_lanes, uint16_t start_por
     cfg.external_port     = start_port++;
     cfg.external_network_id =
         muddle::NetworkId{(static_cast<uint32_t>(i) & 0xFFFFFFu) | (uint32_t{'L'} << 24u)};
-    cfg.internal_identity   = std::make_shared<crypto::ECDSASigner>();
-    cfg.internal_port       = start_port++;
-    cfg.internal_network_id = muddle::NetworkId{"ISRD"};
+    cfg.internal_identity      = std::make_shared<crypto::ECDSASigner>();
+    cfg.internal_port          = start_port++;
+    cfg.internal_network_id    = muddle::NetworkId{"ISRD"};
+    cfg.sync_service_pipelined = pipelined_tx_sync;
+    cfg.sync_service_reconcile = reconcile_tx_sync;
+    cfg.state_forks            = speculative_execution;
 
     auto const &ext_identity = cfg.external_identity->identity().identifier();
     auto const &int_identity = cfg.internal_identity->identity().identifier();
@@ -143,9 +192,13 @@ Constellation::Constellation(CertificatePtr &&certificate, Config config)
   , p2p_port_(LookupLocalPort(cfg_.manifest, ServiceType::CORE))
   , http_port_(LookupLocalPort(cfg_.manifest, ServiceType::HTTP))
   , lane_port_start_(LookupLocalPort(cfg_.manifest, ServiceType::LANE))
-  , shard_cfgs_{GenerateShardsConfig(config.num_lanes(), lane_port_start_, cfg_.db_prefix)}
+  , shard_cfgs_{GenerateShardsConfig(config.num_lanes(), lane_port_start_, cfg_.db_prefix,
+                                    cfg_.pipelined_tx_sync, cfg_.reconcile_tx_sync,
+                                    cfg_.speculative_execution)}
   , reactor_{"Reactor"}
-  , network_manager_{"NetMgr", CalcNetworkManagerThreads(cfg_.num_lanes())}
+  , network_manager_{"NetMgr", CalcNetworkManagerThreads(cfg_.num_lanes()),
+                     cfg_.per_core_network ? NetworkManager::Mode::PER_CORE
+                                           : NetworkManager::Mode::SHARED}
   , http_network_manager_{"Http", HTTP_THREADS}
   , muddle_{muddle::NetworkId{"IHUB"}, std::move(certificate), network_manager_,
             !config.disable_signing, config.sign_broadcasts}
@@ -159,7 +212,9 @@ Constellation::Constellation(CertificatePtr &&certificate, Config config)
                                                  cfg_.log2_num_lanes))
   , lane_control_(internal_muddle_.AsEndpoint(), shard_cfgs_, cfg_.log2_num_lanes)
   , execution_manager_{std::make_shared<ExecutionManager>(
-        cfg_.num_executors, storage_, [this] { return std::make_shared<Executor>(storage_); })}
+        cfg_.num_executors, storage_, [this] { return std::make_shared<Executor>(storage_); },
+        cfg_.optimistic_execution ? ExecutionManager::Mode::OPTIMISTIC
+                                  : ExecutionManager::Mode::SERIAL)}
   , chain_{ledger::MainChain::Mode::LOAD_PERSISTENT_DB}
   , block_packer_{cfg_.log2_num_lanes, cfg_.num_slices}
   , block_coordinator_{chain_,
@@ -172,9 +227,17 @@ Constellation::Constellation(CertificatePtr &&certificate, Config config)
                        cfg_.num_lanes(),
                        cfg_.num_slices,
                        cfg_.block_difficulty}
-  , main_chain_service_{std::make_shared<MainChainRpcService>(p2p_.AsEndpoint(), chain_, trust_,
-                                                              cfg_.standalone)}
-  , tx_processor_{*storage_, block_packer_, tx_status_cache_, cfg_.processor_threads}
+  , main_chain_service_{std::make_shared<MainChainRpcService>(
+        p2p_.AsEndpoint(), chain_, trust_, cfg_.standalone,
+        cfg_.stream_block_sync ? MainChainRpcService::SyncMode::STREAMING
+                               : MainChainRpcService::SyncMode::REQUEST_RESPONSE,
+        cfg_.compact_blocks ? &tx_summary_cache_ : nullptr)}
+  , tx_processor_{*storage_,
+                  block_packer_,
+                  tx_status_cache_,
+                  cfg_.processor_threads,
+                  cfg_.compact_blocks ? &tx_summary_cache_ : nullptr,
+                  &tx_verified_cache_}
   , http_{http_network_manager_}
   , http_modules_{
         std::make_shared<ledger::WalletHttpInterface>(*storage_, tx_processor_, cfg_.num_lanes()),
@@ -183,9 +246,17 @@ Constellation::Constellation(CertificatePtr &&certificate, Config config)
             p2p::P2PHttpInterface::WeakStateMachines{main_chain_service_->GetWeakStateMachine(),
                                                      block_coordinator_.GetWeakStateMachine()}),
         std::make_shared<ledger::TxStatusHttpInterface>(tx_status_cache_),
-        std::make_shared<ledger::TxQueryHttpInterface>(*storage_, cfg_.log2_num_lanes),
-        std::make_shared<ledger::ContractHttpInterface>(*storage_, tx_processor_),
-        std::make_shared<HealthCheckHttpModule>(chain_, *main_chain_service_, block_coordinator_)}
+        std::make_shared<ledger::TxQueryHttpInterface>(
+            *storage_, cfg_.log2_num_lanes,
+            cfg_.index_tx_addresses ? &tx_address_index_ : nullptr),
+        std::make_shared<ledger::ContractHttpInterface>(*storage_, tx_processor_, &query_cache_),
+        std::make_shared<HealthCheckHttpModule>(chain_, *main_chain_service_, block_coordinator_),
+        std::make_shared<StorageMetricsHttpModule>(), std::make_shared<RpcMetricsHttpModule>(),
+        std::make_shared<TraceHttpModule>(), std::make_shared<PrometheusHttpModule>(),
+        std::make_shared<ThreadUsageHttpModule>(),
+        std::make_shared<RuntimeStatsHttpModule>(tx_processor_, block_packer_, chain_,
+                                                 *main_chain_service_, muddle_, internal_muddle_,
+                                                 query_cache_)}
 {
   // print the start up log banner
   FETCH_LOG_INFO(LOGGING_NAME, "Constellation :: ", cfg_.interface_address, " E ",
@@ -193,14 +264,74 @@ Constellation::Constellation(CertificatePtr &&certificate, Config config)
   FETCH_LOG_INFO(LOGGING_NAME, "              :: ", ToBase64(p2p_.identity().identifier()));
   FETCH_LOG_INFO(LOGGING_NAME, "");
 
+  // block propagation is latency sensitive, bulk chain synchronisation is not
+  muddle_.SetPriority(SERVICE_MAIN_CHAIN, CHANNEL_BLOCKS, network::MessagePriority::HIGH);
+  muddle_.SetPriority(SERVICE_MAIN_CHAIN, CHANNEL_COMPACT_BLOCKS, network::MessagePriority::HIGH);
+  muddle_.SetPriority(SERVICE_MAIN_CHAIN, CHANNEL_BLOCK_STREAM, network::MessagePriority::LOW);
+
+  // like the chain, compiled contracts persist across restarts
+  ledger::CompiledScriptCache::Instance().Load("script_cache.db", "script_cache.index.db");
+
+  // so does the address index, which is only rebuilt from the blocks executed from now on
+  if (cfg_.index_tx_addresses)
+  {
+    if (!tx_address_index_.Load(TX_ADDRESS_INDEX_FILENAME))
+    {
+      tx_address_index_.New(TX_ADDRESS_INDEX_FILENAME);
+    }
+
+    block_coordinator_.SetAddressIndex(&tx_address_index_);
+  }
+
   // attach the services to the reactor
   reactor_.Attach(main_chain_service_->GetWeakRunnable());
 
-  // configure all the lane services
+  // wake the block coordinator as soon as the events it is waiting on occur, rather than waiting
+  // for its next poll
+  chain_.OnBlockAdded([this]() { block_coordinator_.Wake(); });
+  execution_manager_->OnExecutionFinished([this]() { block_coordinator_.Wake(); });
+
+  // the cached query results are only valid for the state they were computed from
+  block_coordinator_.OnWorldStateChange([this](byte_array::ConstByteArray const &merkle_root) {
+    if (merkle_root.empty())
+    {
+      query_cache_.BeginStateUpdate();
+    }
+    else
+    {
+      query_cache_.SetState(merkle_root);
+    }
+  });
+
+  // compress the large packets sent to peers outside of the local network, where bandwidth is
+  // scarce. The dictionary is only used with peers which have been configured with the same one.
+  if (cfg_.compress_wan)
+  {
+    auto const compression = CreateCompressionOptions(cfg_.wan_dictionary);
+
+    muddle_.SetCompression(compression);
+    for (auto &shard_cfg : shard_cfgs_)
+    {
+      shard_cfg.external_compression = compression;
+    }
+  }
+
+  // configure all the lane services, each transaction is verified once across all of them
+  for (auto &shard_cfg : shard_cfgs_)
+  {
+    shard_cfg.verified_cache = &tx_verified_cache_;
+  }
+
   lane_services_.Setup(network_manager_, shard_cfgs_, !config.disable_signing);
 
+  // the lanes run in this process, so the storage unit calls them directly rather than serialising
+  // its requests over the internal muddle
+  storage_->AttachLocalLanes(lane_services_.GetLocalLanes(),
+                             internal_muddle_.identity().identifier());
+
   // configure the middleware of the http server
   http_.AddMiddleware(http::middleware::AllowOrigin("*"));
+  http_.AddMiddleware(http::middleware::Compression());
 
   // attach all the modules to the http server
   for (auto const &module : http_modules_)
@@ -241,6 +372,12 @@ void Constellation::CreateInfoFile(std::string const &filename)
  */
 void Constellation::Run(UriList const &initial_peers, core::WeakRunnable bootstrap_monitor)
 {
+  if (!cfg_.replay_block.empty())
+  {
+    ReplayBlock(cfg_.replay_block);
+    return;
+  }
+
   //---------------------------------------------------------------
   // Step 1. Start all the components
   //---------------------------------------------------------------
@@ -251,94 +388,76 @@ void Constellation::Run(UriList const &initial_peers, core::WeakRunnable bootstr
     block_coordinator_.SetBlockPeriod(std::chrono::milliseconds{cfg_.block_interval_ms});
   }
 
-  /// NETWORKING INFRASTRUCTURE
-
-  // start all the services
-  network_manager_.Start();
-  http_network_manager_.Start();
-  muddle_.Start({p2p_port_});
+  block_coordinator_.EnableSpeculativeExecution(cfg_.speculative_execution);
+  execution_manager_->SetConflictSchedulingEnabled(cfg_.conflict_scheduling);
 
-  /// LANE / SHARD SERVERS
+  // Each subsystem is started as soon as the subsystems it depends on are ready, so that the
+  // independent parts (the p2p muddle, the lane servers, the reactor) come up concurrently
+  core::StartupGraph startup;
 
-  // start all the lane services and wait for them to start accepting
-  // connections
-  lane_services_.Start();
-
-  FETCH_LOG_INFO(LOGGING_NAME, "Starting shard services...");
-  if (!WaitForLaneServersToStart())
-  {
-    FETCH_LOG_ERROR(LOGGING_NAME, "Unable to start lane server instances");
-    return;
-  }
-  FETCH_LOG_INFO(LOGGING_NAME, "Starting shard services...complete");
-
-  /// LANE / SHARD CLIENTS
-
-  {
-    FETCH_LOG_INFO(LOGGING_NAME,
-                   "Inter-shard Identity: ", ToBase64(internal_muddle_.identity().identifier()));
-
-    // build the complete list of Uris to all the lane services across the internal network
-    Muddle::UriList uris;
-    uris.reserve(shard_cfgs_.size());
-
-    for (auto const &shard : shard_cfgs_)
-    {
-      uris.emplace_back(Uri{Peer{"127.0.0.1", shard.internal_port}});
-    }
+  /// NETWORKING INFRASTRUCTURE
 
-    // start the muddle up and connect to all the shards
-    internal_muddle_.Start({}, uris);
+  startup.Add("network", {}, [this]() {
+    network_manager_.Start();
+    http_network_manager_.Start();
+    return true;
+  });
 
-    for (;;)
-    {
-      auto const clients = internal_muddle_.GetConnections(true);
+  startup.Add("p2p-muddle", {"network"}, [this]() {
+    muddle_.Start({p2p_port_});
+    return true;
+  });
 
-      // exit the wait loop until all the connections have been formed
-      if (clients.size() >= shard_cfgs_.size())
-      {
-        FETCH_LOG_INFO(LOGGING_NAME, "Internal muddle network established between shards");
+  /// LANE / SHARD SERVERS
 
-        for (auto const &client : clients)
-        {
-          FETCH_LOG_INFO(LOGGING_NAME, " - Connected to: ", ToBase64(client.first), " (",
-                         client.second.ToString(), ")");
-        }
+  // start all the lane services and wait for them to start accepting connections
+  startup.Add("lane-servers", {"network"}, [this]() { return StartLaneServers(); });
 
-        break;
-      }
-      else
-      {
-        FETCH_LOG_DEBUG(LOGGING_NAME,
-                        "Waiting for internal muddle connection to be established...");
-      }
+  /// LANE / SHARD CLIENTS
 
-      std::this_thread::sleep_for(std::chrono::milliseconds{500});
-    }
-  }
+  startup.Add("lane-clients", {"lane-servers"}, [this]() { return ConnectLaneClients(); });
 
   // reactor important to run the block/chain state machine
-  reactor_.Start();
+  startup.Add("reactor", {}, [this]() {
+    reactor_.Start();
+    return true;
+  });
 
   /// BLOCK EXECUTION & MINING
 
-  execution_manager_->Start();
-  tx_processor_.Start();
+  startup.Add("execution", {"lane-clients"}, [this]() {
+    execution_manager_->Start();
+    tx_processor_.Start();
+    return true;
+  });
 
   /// P2P (TRUST) HIGH LEVEL MANAGEMENT
 
-  // P2P configuration
-  p2p_.SetLocalManifest(cfg_.manifest);
-  p2p_.Start(initial_peers);
+  startup.Add("p2p", {"p2p-muddle", "lane-clients"}, [this, &initial_peers]() {
+    p2p_.SetLocalManifest(cfg_.manifest);
+    p2p_.Start(initial_peers);
+    return true;
+  });
 
   /// INPUT INTERFACES
 
-  // Finally start the HTTP server
-  http_.Start(http_port_);
+  startup.Add("http", {"network", "lane-clients"}, [this]() {
+    http_.Start(http_port_);
+    return true;
+  });
 
   // The block coordinator needs to access correctly started lanes to recover state in the case of
   // a crash.
-  reactor_.Attach(block_coordinator_.GetWeakRunnable());
+  startup.Add("block-coordinator", {"reactor", "execution"}, [this]() {
+    reactor_.Attach(block_coordinator_.GetWeakRunnable());
+    return true;
+  });
+
+  if (!startup.Run())
+  {
+    FETCH_LOG_ERROR(LOGGING_NAME, "Unable to start the constellation subsystems");
+    return;
+  }
 
   //---------------------------------------------------------------
   // Step 2. Main monitor loop
@@ -400,6 +519,117 @@ void Constellation::Run(UriList const &initial_peers, core::WeakRunnable bootstr
   FETCH_LOG_INFO(LOGGING_NAME, "Shutting down...complete");
 }
 
+/**
+ * Start all the lane services and wait for them to start accepting connections
+ *
+ * @return true if successful, otherwise false
+ */
+bool Constellation::StartLaneServers()
+{
+  lane_services_.Start();
+
+  FETCH_LOG_INFO(LOGGING_NAME, "Starting shard services...");
+  if (!WaitForLaneServersToStart())
+  {
+    FETCH_LOG_ERROR(LOGGING_NAME, "Unable to start lane server instances");
+    return false;
+  }
+  FETCH_LOG_INFO(LOGGING_NAME, "Starting shard services...complete");
+
+  return true;
+}
+
+/**
+ * Connect the internal muddle to all the lane services
+ *
+ * @return true if successful, otherwise false
+ */
+bool Constellation::ConnectLaneClients()
+{
+  FETCH_LOG_INFO(LOGGING_NAME,
+                 "Inter-shard Identity: ", ToBase64(internal_muddle_.identity().identifier()));
+
+  // build the complete list of Uris to all the lane services across the internal network
+  Muddle::UriList uris;
+  uris.reserve(shard_cfgs_.size());
+
+  for (auto const &shard : shard_cfgs_)
+  {
+    uris.emplace_back(Uri{Peer{"127.0.0.1", shard.internal_port}});
+  }
+
+  // start the muddle up and connect to all the shards, waking as soon as the routing changes
+  // rather than polling
+  internal_muddle_.Start({}, uris);
+
+  while (active_ &&
+         !internal_muddle_.WaitForConnections(shard_cfgs_.size(), std::chrono::seconds{1}))
+  {
+    FETCH_LOG_DEBUG(LOGGING_NAME, "Waiting for internal muddle connection to be established...");
+  }
+
+  if (!active_)
+  {
+    return false;
+  }
+
+  FETCH_LOG_INFO(LOGGING_NAME, "Internal muddle network established between shards");
+
+  for (auto const &client : internal_muddle_.GetConnections(true))
+  {
+    FETCH_LOG_INFO(LOGGING_NAME, " - Connected to: ", ToBase64(client.first), " (",
+                   client.second.ToString(), ")");
+  }
+
+  return true;
+}
+
+/**
+ * Replay a stored block on a fork of the state of its parent and print the cost of each of its
+ * transactions, instead of running the node. Only the lanes are started, so that nothing else
+ * modifies the state while the block is replayed.
+ *
+ * @param digest The hex encoded digest of the block
+ */
+void Constellation::ReplayBlock(std::string const &digest)
+{
+  using BlockReplayProfiler = ledger::BlockReplayProfiler;
+
+  network_manager_.Start();
+
+  if (StartLaneServers() && ConnectLaneClients())
+  {
+    MainChain::BlockPtr const block = chain_.GetBlock(byte_array::FromHex(digest));
+    MainChain::BlockPtr       parent{};
+    if (block)
+    {
+      parent = chain_.GetBlock(block->body.previous_hash);
+    }
+
+    if (!block || !parent)
+    {
+      FETCH_LOG_ERROR(LOGGING_NAME, "Unable to find block ", digest, " and its parent");
+    }
+    else
+    {
+      BlockReplayProfiler         profiler{storage_};
+      BlockReplayProfiler::Report report{};
+
+      if (!profiler.Replay(*block, *parent, report))
+      {
+        FETCH_LOG_WARN(LOGGING_NAME, "The replay of block ", digest, " did not complete");
+      }
+
+      BlockReplayProfiler::WriteReport(std::cout, report);
+    }
+  }
+
+  storage_.reset();
+
+  lane_services_.Stop();
+  network_manager_.Stop();
+}
+
 void Constellation::OnBlock(ledger::Block const &block)
 {
   main_chain_service_->BroadcastBlock(block);
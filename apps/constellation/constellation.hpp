@@ -24,13 +24,17 @@
 #include "ledger/chain/block_coordinator.hpp"
 #include "ledger/chain/consensus/consensus_miner_interface.hpp"
 #include "ledger/chain/main_chain.hpp"
+#include "ledger/chaincode/query_result_cache.hpp"
 #include "ledger/execution_manager.hpp"
 #include "ledger/protocols/main_chain_rpc_service.hpp"
 #include "ledger/storage_unit/lane_remote_control.hpp"
 #include "ledger/storage_unit/storage_unit_bundled_service.hpp"
 #include "ledger/storage_unit/storage_unit_client.hpp"
+#include "ledger/transaction_address_index.hpp"
 #include "ledger/transaction_processor.hpp"
 #include "ledger/transaction_status_cache.hpp"
+#include "ledger/transaction_summary_cache.hpp"
+#include "ledger/verified_digest_cache.hpp"
 #include "miner/basic_miner.hpp"
 #include "network/muddle/muddle.hpp"
 #include "network/p2pservice/manifest.hpp"
@@ -95,6 +99,18 @@ public:
     bool        disable_signing{false};
     bool        sign_broadcasts{false};
     bool        standalone{false};
+    bool        optimistic_execution{false};
+    bool        stream_block_sync{false};
+    bool        compact_blocks{false};
+    bool        per_core_network{false};
+    bool        pipelined_tx_sync{false};
+    bool        reconcile_tx_sync{false};
+    bool        speculative_execution{false};
+    bool        conflict_scheduling{false};
+    bool        index_tx_addresses{false};
+    bool        compress_wan{false};
+    std::string wan_dictionary{};
+    std::string replay_block{};  ///< Replay and profile this block instead of running the node
 
     uint32_t num_lanes() const
     {
@@ -114,6 +130,9 @@ protected:
 
 private:
   void CreateInfoFile(std::string const &filename);
+  bool StartLaneServers();
+  bool ConnectLaneClients();
+  void ReplayBlock(std::string const &digest);
 
   using Muddle                 = muddle::Muddle;
   using NetworkManager         = network::NetworkManager;
@@ -138,6 +157,10 @@ private:
   using TrustSystem            = p2p::P2PTrustBayRank<Muddle::Address>;
   using ShardConfigs           = ledger::ShardConfigs;
   using TxStatusCache          = ledger::TransactionStatusCache;
+  using TxSummaryCache         = ledger::TransactionSummaryCache;
+  using TxVerifiedCache        = ledger::VerifiedDigestCache;
+  using TxAddressIndex         = ledger::TransactionAddressIndex;
+  using QueryCache             = ledger::QueryResultCache;
 
   /// @name Configuration
   /// @{
@@ -163,10 +186,14 @@ private:
 
   /// @name Transaction and State Database shards
   /// @{
-  TxStatusCache        tx_status_cache_;  ///< Cache of transaction status
-  LaneServices         lane_services_;    ///< The lane services
-  StorageUnitClientPtr storage_;          ///< The storage client to the lane services
-  LaneRemoteControl    lane_control_;     ///< The lane control client for the lane services
+  TxStatusCache        tx_status_cache_;    ///< Cache of transaction status
+  TxSummaryCache       tx_summary_cache_;   ///< Cache of recent summaries (compact blocks)
+  TxVerifiedCache      tx_verified_cache_;  ///< Digests of the transactions already verified
+  TxAddressIndex       tx_address_index_;   ///< Index of the executed transactions by address
+  QueryCache           query_cache_;        ///< Results of the contract queries on the state
+  LaneServices         lane_services_;      ///< The lane services
+  StorageUnitClientPtr storage_;            ///< The storage client to the lane services
+  LaneRemoteControl    lane_control_;       ///< The lane control client for the lane services
   /// @}
 
   /// @name Block Processing
@@ -26,6 +26,7 @@
 #include "crypto/fetch_identity.hpp"
 #include "crypto/prover.hpp"
 #include "metrics/metrics.hpp"
+#include "metrics/tracer.hpp"
 #include "network/adapters.hpp"
 #include "network/fetch_asio.hpp"
 #include "network/management/network_manager.hpp"
@@ -34,7 +35,9 @@
 #include "bootstrap_monitor.hpp"
 #include "constellation.hpp"
 #include "fetch_version.hpp"
+#include "thread_budget.hpp"
 
+#include <algorithm>
 #include <csignal>
 #include <cstdlib>
 #include <fstream>
@@ -186,6 +189,10 @@ struct CommandLineArguments
   std::string external_address{};
   /// @}
 
+  bool     async_logging{false};
+  uint32_t trace_sample_rate{0};
+  bool     pin_threads{false};
+
   static CommandLineArguments Parse(int argc, char **argv, BootstrapPtr &bootstrap,
                                     ProverPtr const &prover)
   {
@@ -223,6 +230,21 @@ struct CommandLineArguments
     p.add(args.cfg.disable_signing,       "disable-signing",       "Do not sign outbound packets or verify those inbound, in trusted network",      bool{});
     p.add(args.cfg.sign_broadcasts,       "sign-broadcasts",       "Sign and verify broadcast packets",                                             bool{});
     p.add(args.cfg.standalone,            "standalone",            "Expect the node to run in on its own (useful for testing and development)",     false);
+    p.add(args.cfg.optimistic_execution,  "optimistic-execution",  "Start transactions from the next slice as soon as their lanes become free",       false);
+    p.add(args.cfg.stream_block_sync,     "stream-block-sync",     "Synchronise missing blocks as a flow controlled stream from peers",             false);
+    p.add(args.cfg.compact_blocks,        "compact-blocks",        "Relay blocks as short transaction ids, rebuilt from the transactions seen",     false);
+    p.add(args.cfg.per_core_network,      "per-core-network",      "Run one network reactor per core and keep each connection on a single core",    false);
+    p.add(args.cfg.pipelined_tx_sync,     "pipelined-tx-sync",     "Keep adaptive windows of transaction sync requests in flight to each peer",     false);
+    p.add(args.cfg.reconcile_tx_sync,     "reconcile-tx-sync",     "Fetch only the recent transactions missing from a peer, found from sketches",   false);
+    p.add(args.cfg.speculative_execution, "speculative-exec",      "Execute competing blocks on a fork of the state ahead of a possible reorg",     false);
+    p.add(args.cfg.conflict_scheduling,   "conflict-scheduling",   "Schedule the transactions of a block from their resources, not its slices",     false);
+    p.add(args.cfg.index_tx_addresses,    "index-tx-addresses",    "Index executed transactions by the addresses they touch, for address queries",  false);
+    p.add(args.cfg.compress_wan,          "compress-wan",          "Compress large packets sent to peers outside of the local network",             false);
+    p.add(args.cfg.wan_dictionary,        "wan-dictionary",        "The preset dictionary (e.g. trained on transactions) shared by the peers",      std::string{});
+    p.add(args.cfg.replay_block,          "replay-block",          "Replay the block with this (hex) digest, print the cost of each tx and exit",   std::string{});
+    p.add(args.async_logging,             "async-logging",         "Queue log entries and write them from a background thread",                     false);
+    p.add(args.trace_sample_rate,         "trace-sample-rate",     "Trace one in this many transactions (0 disables tracing)",                      uint32_t{0});
+    p.add(args.pin_threads,               "pin-threads",           "Pin the threads of each subsystem to its own share of the cores",               false);
     // clang-format on
 
     // parse the args
@@ -253,6 +275,21 @@ struct CommandLineArguments
     UpdateConfigFromEnvironment(args.cfg.disable_signing,       "CONSTELLATION_DISABLE_SIGNING");
     UpdateConfigFromEnvironment(args.cfg.sign_broadcasts,       "CONSTELLATION_SIGN_BROADCASTS");
     UpdateConfigFromEnvironment(args.cfg.standalone,            "CONSTELLATION_STANDALONE");
+    UpdateConfigFromEnvironment(args.cfg.optimistic_execution,  "CONSTELLATION_OPTIMISTIC_EXECUTION");
+    UpdateConfigFromEnvironment(args.cfg.stream_block_sync,     "CONSTELLATION_STREAM_BLOCK_SYNC");
+    UpdateConfigFromEnvironment(args.cfg.compact_blocks,        "CONSTELLATION_COMPACT_BLOCKS");
+    UpdateConfigFromEnvironment(args.cfg.per_core_network,      "CONSTELLATION_PER_CORE_NETWORK");
+    UpdateConfigFromEnvironment(args.cfg.pipelined_tx_sync,     "CONSTELLATION_PIPELINED_TX_SYNC");
+    UpdateConfigFromEnvironment(args.cfg.reconcile_tx_sync,     "CONSTELLATION_RECONCILE_TX_SYNC");
+    UpdateConfigFromEnvironment(args.cfg.speculative_execution, "CONSTELLATION_SPECULATIVE_EXEC");
+    UpdateConfigFromEnvironment(args.cfg.conflict_scheduling,   "CONSTELLATION_CONFLICT_SCHEDULING");
+    UpdateConfigFromEnvironment(args.cfg.index_tx_addresses,    "CONSTELLATION_INDEX_TX_ADDRESSES");
+    UpdateConfigFromEnvironment(args.cfg.compress_wan,          "CONSTELLATION_COMPRESS_WAN");
+    UpdateConfigFromEnvironment(args.cfg.wan_dictionary,        "CONSTELLATION_WAN_DICTIONARY");
+    UpdateConfigFromEnvironment(args.cfg.replay_block,          "CONSTELLATION_REPLAY_BLOCK");
+    UpdateConfigFromEnvironment(args.async_logging,             "CONSTELLATION_ASYNC_LOGGING");
+    UpdateConfigFromEnvironment(args.trace_sample_rate,         "CONSTELLATION_TRACE_SAMPLE_RATE");
+    UpdateConfigFromEnvironment(args.pin_threads,               "CONSTELLATION_PIN_THREADS");
     // clang-format on
 
     // update the peers
@@ -475,6 +512,76 @@ struct CommandLineArguments
       s << "stand alone...............: Enabled\n";
     }
 
+    if (args.cfg.optimistic_execution)
+    {
+      s << "optimistic execution......: Enabled\n";
+    }
+
+    if (args.cfg.stream_block_sync)
+    {
+      s << "stream block sync.........: Enabled\n";
+    }
+
+    if (args.cfg.compact_blocks)
+    {
+      s << "compact blocks............: Enabled\n";
+    }
+
+    if (args.cfg.per_core_network)
+    {
+      s << "per core network..........: Enabled\n";
+    }
+
+    if (args.cfg.pipelined_tx_sync)
+    {
+      s << "pipelined tx sync.........: Enabled\n";
+    }
+
+    if (args.cfg.reconcile_tx_sync)
+    {
+      s << "reconciled tx sync........: Enabled\n";
+    }
+
+    if (args.cfg.speculative_execution)
+    {
+      s << "speculative execution.....: Enabled\n";
+    }
+
+    if (args.cfg.conflict_scheduling)
+    {
+      s << "conflict scheduling.......: Enabled\n";
+    }
+
+    if (args.cfg.index_tx_addresses)
+    {
+      s << "index tx addresses........: Enabled\n";
+    }
+
+    if (args.cfg.compress_wan)
+    {
+      s << "compress wan traffic......: Enabled\n";
+    }
+
+    if (!args.cfg.replay_block.empty())
+    {
+      s << "replay block..............: " << args.cfg.replay_block << '\n';
+    }
+
+    if (args.async_logging)
+    {
+      s << "async logging.............: Enabled\n";
+    }
+
+    if (args.trace_sample_rate > 0)
+    {
+      s << "trace sample rate.........: 1 in " << args.trace_sample_rate << '\n';
+    }
+
+    if (args.pin_threads)
+    {
+      s << "pin threads...............: Enabled\n";
+    }
+
     // generate the peer listing
     s << "peers.....................: ";
     for (auto const &peer : args.peers)
@@ -614,7 +721,8 @@ int main(int argc, char **argv)
   try
   {
 #ifdef FETCH_ENABLE_METRICS
-    fetch::metrics::Metrics::Instance().ConfigureFileHandler("metrics.csv");
+    fetch::metrics::Metrics::Instance().ConfigureFileHandler(
+        "metrics.bin", fetch::metrics::MetricFileFormat::BINARY);
 #endif  // FETCH_ENABLE_METRICS
 
     // create and load the main certificate for the bootstrapper
@@ -623,6 +731,25 @@ int main(int argc, char **argv)
     BootstrapPtr bootstrap_monitor;
     auto         args = CommandLineArguments::Parse(argc, argv, bootstrap_monitor, p2p_key);
 
+    if (args.async_logging)
+    {
+      fetch::logger.EnableAsync();
+    }
+
+    fetch::metrics::Tracer::Instance().SetSampleRate(args.trace_sample_rate);
+
+    if (args.pin_threads)
+    {
+      // must be applied before any of the subsystem threads are started
+      fetch::ThreadBudget budget{fetch::ThreadBudget::DetectTopology(),
+                                 fetch::ThreadBudget::DefaultShares()};
+      budget.Apply();
+
+      // more verification threads than cores only adds contention
+      auto const verification_cores = static_cast<uint32_t>(budget.CoresFor("verification"));
+      args.cfg.processor_threads    = std::min(args.cfg.processor_threads, verification_cores);
+    }
+
     FETCH_LOG_INFO(LOGGING_NAME, "Configuration:\n", args);
 
     // create and run the constellation
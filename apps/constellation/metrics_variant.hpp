@@ -0,0 +1,86 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "metrics/latency_histogram.hpp"
+#include "variant/variant.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace fetch {
+
+/**
+ * Convert a list of elements into a variant array
+ *
+ * @param elements The elements of the array
+ * @return The variant array
+ */
+inline variant::Variant ToVariantArray(std::vector<variant::Variant> const &elements)
+{
+  variant::Variant array = variant::Variant::Array(elements.size());
+  for (std::size_t i = 0; i < elements.size(); ++i)
+  {
+    array[i] = elements[i];
+  }
+
+  return array;
+}
+
+/**
+ * Convert a latency histogram into a variant object, for reporting in the metrics endpoints
+ *
+ * @param histogram The histogram to be converted
+ * @return The variant object
+ */
+inline variant::Variant ToVariant(metrics::LatencyHistogram const &histogram)
+{
+  using metrics::LatencyHistogram;
+  using variant::Variant;
+
+  auto const counts = histogram.buckets();
+
+  // only report the populated buckets, each of them is identified by its upper bound
+  std::vector<Variant> buckets{};
+  for (std::size_t i = 0; i < counts.size(); ++i)
+  {
+    if (counts[i] == 0)
+    {
+      continue;
+    }
+
+    Variant bucket  = Variant::Object();
+    bucket["count"] = counts[i];
+
+    if (i + 1 < LatencyHistogram::NUM_BUCKETS)
+    {
+      bucket["upper_bound_us"] = LatencyHistogram::BucketUpperBound(i);
+    }
+
+    buckets.emplace_back(std::move(bucket));
+  }
+
+  Variant result     = Variant::Object();
+  result["count"]    = histogram.count();
+  result["total_us"] = histogram.total_us();
+  result["buckets"]  = ToVariantArray(buckets);
+
+  return result;
+}
+
+}  // namespace fetch
@@ -0,0 +1,44 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "http/module.hpp"
+#include "http/response.hpp"
+#include "metrics/metrics.hpp"
+
+namespace fetch {
+
+/**
+ * Exposes the counters and latency histograms aggregated from the metric events in the
+ * Prometheus text format. The values are only updated while a metric file handler is configured.
+ */
+class PrometheusHttpModule : public http::HTTPModule
+{
+public:
+  PrometheusHttpModule()
+  {
+    Get("/api/metrics/prometheus", [](http::ViewParameters const &, http::HTTPRequest const &) {
+      auto const &aggregator = metrics::Metrics::Instance().aggregator();
+
+      return http::HTTPResponse(aggregator.ToPrometheusText(),
+                                http::MimeType{".txt", "text/plain; version=0.0.4"});
+    });
+  }
+};
+
+}  // namespace fetch
@@ -0,0 +1,70 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "http/json_response.hpp"
+#include "http/module.hpp"
+#include "metrics/rpc_metrics.hpp"
+#include "metrics_variant.hpp"
+#include "variant/variant.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace fetch {
+
+/**
+ * Exposes the RPC instruments (call, failure and timeout counts along with the latency histogram
+ * of every protocol / function pair called by the node) so that slow remote calls, for example to
+ * the lanes, can be identified.
+ */
+class RpcMetricsHttpModule : public http::HTTPModule
+{
+public:
+  using Variant        = variant::Variant;
+  using RpcMetrics     = metrics::RpcMetrics;
+  using RpcCallMetrics = metrics::RpcCallMetrics;
+
+  RpcMetricsHttpModule()
+  {
+    Get("/api/metrics/rpc", [](http::ViewParameters const &, http::HTTPRequest const &) {
+      std::vector<Variant> calls{};
+      RpcMetrics::Instance().VisitCalls(
+          [&calls](uint64_t protocol, uint64_t function, RpcCallMetrics const &call) {
+            Variant entry      = Variant::Object();
+            entry["protocol"]  = protocol;
+            entry["function"]  = function;
+            entry["calls"]     = call.calls.load();
+            entry["succeeded"] = call.succeeded.load();
+            entry["failed"]    = call.failed.load();
+            entry["timeouts"]  = call.timeouts.load();
+            entry["latency"]   = ToVariant(call.latency);
+
+            calls.emplace_back(std::move(entry));
+          });
+
+      Variant response  = Variant::Object();
+      response["calls"] = ToVariantArray(calls);
+
+      return http::CreateJsonResponse(response);
+    });
+  }
+};
+
+}  // namespace fetch
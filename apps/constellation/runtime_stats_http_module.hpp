@@ -0,0 +1,286 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/thread_placement.hpp"
+#include "http/json_response.hpp"
+#include "http/module.hpp"
+#include "http/response.hpp"
+#include "ledger/block_packer_interface.hpp"
+#include "ledger/chain/main_chain.hpp"
+#include "ledger/chaincode/query_result_cache.hpp"
+#include "ledger/protocols/main_chain_rpc_service.hpp"
+#include "ledger/transaction_processor.hpp"
+#include "metrics/cpu_profiler.hpp"
+#include "metrics/process_metrics.hpp"
+#include "metrics/storage_metrics.hpp"
+#include "metrics_variant.hpp"
+#include "network/muddle/muddle.hpp"
+#include "variant/variant.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fetch {
+
+/**
+ * Exposes the runtime state of the node which is needed to diagnose a collapse in throughput
+ * without restarting it: the depth of the main queues, the utilisation of the threads of each
+ * subsystem, the state of the heap allocator and the hit ratios of the caches.
+ *
+ * A CPU profile of the whole process can also be captured on demand, the request blocks for the
+ * duration of the capture.
+ */
+class RuntimeStatsHttpModule : public http::HTTPModule
+{
+public:
+  using Variant              = variant::Variant;
+  using TransactionProcessor = ledger::TransactionProcessor;
+  using BlockPacker          = ledger::BlockPackerInterface;
+  using MainChain            = ledger::MainChain;
+  using MainChainRpcService  = ledger::MainChainRpcService;
+  using QueryResultCache     = ledger::QueryResultCache;
+  using Muddle               = muddle::Muddle;
+  using MuddleQueueStats     = muddle::Router::QueueStats;
+  using ThreadPlacement      = core::ThreadPlacement;
+  using CpuProfiler          = metrics::CpuProfiler;
+
+  static constexpr uint32_t DEFAULT_PROFILE_SECONDS = 10;
+  static constexpr uint32_t MAX_PROFILE_SECONDS     = 60;
+
+  RuntimeStatsHttpModule(TransactionProcessor &processor, BlockPacker &packer, MainChain &chain,
+                         MainChainRpcService &chain_service, Muddle &muddle,
+                         Muddle &internal_muddle, QueryResultCache &query_cache)
+    : processor_{processor}
+    , packer_{packer}
+    , chain_{chain}
+    , chain_service_{chain_service}
+    , muddle_{muddle}
+    , internal_muddle_{internal_muddle}
+    , query_cache_{query_cache}
+  {
+    Get("/api/runtime/stats", [this](http::ViewParameters const &, http::HTTPRequest const &) {
+      Variant response       = Variant::Object();
+      response["queues"]     = QueueStats();
+      response["subsystems"] = ThreadStats();
+      response["allocator"]  = AllocatorStats();
+      response["caches"]     = CacheStats();
+
+      return http::CreateJsonResponse(response);
+    });
+
+    Get("/api/runtime/profile", [](http::ViewParameters const &, http::HTTPRequest const &request) {
+      return CaptureProfile(request);
+    });
+  }
+
+private:
+  using Clock     = std::chrono::steady_clock;
+  using Timepoint = Clock::time_point;
+  using CpuTimes  = std::unordered_map<std::string, double>;
+
+  static Variant ToVariant(MuddleQueueStats const &stats)
+  {
+    Variant entry                 = Variant::Object();
+    entry["connections"]          = stats.connections;
+    entry["congested"]            = stats.congested;
+    entry["queued_bytes"]         = stats.queued_bytes;
+    entry["max_queued_bytes"]     = stats.max_queued_bytes;
+    entry["batched_packets"]      = stats.batched_packets;
+    entry["verification_backlog"] = stats.verify_backlog;
+
+    return entry;
+  }
+
+  static double Ratio(uint64_t hits, uint64_t misses)
+  {
+    uint64_t const total = hits + misses;
+
+    return (total) ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+  }
+
+  Variant QueueStats() const
+  {
+    Variant muddle     = Variant::Object();
+    muddle["external"] = ToVariant(muddle_.GetQueueStats());
+    muddle["internal"] = ToVariant(internal_muddle_.GetQueueStats());
+
+    Variant queues           = Variant::Object();
+    queues["verifier"]       = processor_.GetVerifierBacklog();
+    queues["packer"]         = packer_.GetBacklog();
+    queues["missing_blocks"] = chain_.GetMissingBlockHashes().size();
+    queues["block_stream"]   = chain_service_.GetStreamBacklog();
+    queues["muddle"]         = muddle;
+
+    return queues;
+  }
+
+  /**
+   * Report the CPU time of each subsystem, along with the fraction of the time of its threads they
+   * have spent running since the previous request
+   */
+  Variant ThreadStats()
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+
+    Timepoint const now     = Clock::now();
+    double const    elapsed = std::chrono::duration<double>(now - last_sample_).count();
+
+    std::vector<Variant> subsystems{};
+    for (auto const &usage : ThreadPlacement::Instance().Report())
+    {
+      double &previous = cpu_times_[usage.subsystem];
+
+      double utilisation{0};
+      if ((elapsed > 0) && (usage.threads != 0))
+      {
+        double const busy = std::max(usage.cpu_seconds - previous, 0.0);
+        utilisation       = busy / (elapsed * static_cast<double>(usage.threads));
+      }
+
+      previous = usage.cpu_seconds;
+
+      Variant entry        = Variant::Object();
+      entry["subsystem"]   = usage.subsystem;
+      entry["threads"]     = usage.threads;
+      entry["cpu_seconds"] = usage.cpu_seconds;
+      entry["utilisation"] = utilisation;
+
+      subsystems.emplace_back(std::move(entry));
+    }
+
+    last_sample_ = now;
+
+    return ToVariantArray(subsystems);
+  }
+
+  static Variant AllocatorStats()
+  {
+    auto const stats = metrics::AllocatorStats::Read();
+
+    Variant allocator             = Variant::Object();
+    allocator["arena_bytes"]      = stats.arena_bytes;
+    allocator["mmap_bytes"]       = stats.mmap_bytes;
+    allocator["in_use_bytes"]     = stats.in_use_bytes;
+    allocator["free_bytes"]       = stats.free_bytes;
+    allocator["releasable_bytes"] = stats.releasable_bytes;
+    allocator["resident_bytes"]   = stats.resident_bytes;
+    allocator["fragmentation"]    = stats.fragmentation();
+
+    return allocator;
+  }
+
+  Variant CacheStats() const
+  {
+    // the caches of the individual stacks are reported by the storage metrics module
+    uint64_t storage_hits{0};
+    uint64_t storage_misses{0};
+    metrics::StorageMetrics::Instance().VisitStacks(
+        [&](std::string const &, metrics::StackMetrics const &stack) {
+          storage_hits += stack.cache_hits.load();
+          storage_misses += stack.cache_misses.load();
+        });
+
+    Variant storage      = Variant::Object();
+    storage["hits"]      = storage_hits;
+    storage["misses"]    = storage_misses;
+    storage["hit_ratio"] = Ratio(storage_hits, storage_misses);
+
+    auto const counters = query_cache_.counters();
+
+    Variant query          = Variant::Object();
+    query["hits"]          = counters.hits;
+    query["misses"]        = counters.misses;
+    query["hit_ratio"]     = Ratio(counters.hits, counters.misses);
+    query["evictions"]     = counters.evictions;
+    query["invalidations"] = counters.invalidations;
+    query["entries"]       = query_cache_.size();
+    query["bytes"]         = query_cache_.bytes();
+
+    Variant caches    = Variant::Object();
+    caches["storage"] = storage;
+    caches["query"]   = query;
+
+    return caches;
+  }
+
+  /**
+   * Capture a CPU profile of the process, formatted as folded stacks. The length of the capture
+   * (`seconds`) and the sampling rate (`frequency`) can be set in the query.
+   */
+  static http::HTTPResponse CaptureProfile(http::HTTPRequest const &request)
+  {
+    static http::MimeType const TEXT{".txt", "text/plain"};
+
+    if (!CpuProfiler::supported())
+    {
+      return http::HTTPResponse("CPU profiling is not supported on this platform\n", TEXT,
+                                http::Status::SERVER_ERROR_NOT_IMPLEMENTED);
+    }
+
+    auto const &query = request.query();
+
+    int64_t seconds   = DEFAULT_PROFILE_SECONDS;
+    int64_t frequency = CpuProfiler::DEFAULT_FREQUENCY;
+    if (query.Has("seconds"))
+    {
+      seconds = query["seconds"].AsInt();
+    }
+    if (query.Has("frequency"))
+    {
+      frequency = query["frequency"].AsInt();
+    }
+
+    if ((seconds <= 0) || (seconds > MAX_PROFILE_SECONDS) || (frequency <= 0) ||
+        (frequency > CpuProfiler::MAX_FREQUENCY))
+    {
+      return http::HTTPResponse("Invalid profile duration or frequency\n", TEXT,
+                                http::Status::CLIENT_ERROR_BAD_REQUEST);
+    }
+
+    CpuProfiler::Profile profile{};
+    if (!CpuProfiler::Instance().Capture(std::chrono::seconds{seconds},
+                                         static_cast<uint32_t>(frequency), profile))
+    {
+      return http::HTTPResponse("A profile is already being captured\n", TEXT,
+                                http::Status::CLIENT_ERROR_CONFLICT);
+    }
+
+    return http::HTTPResponse(CpuProfiler::ToFoldedStacks(profile), TEXT);
+  }
+
+  TransactionProcessor &processor_;
+  BlockPacker &         packer_;
+  MainChain &           chain_;
+  MainChainRpcService & chain_service_;
+  Muddle &              muddle_;
+  Muddle &              internal_muddle_;
+  QueryResultCache &    query_cache_;
+
+  std::mutex lock_;
+  Timepoint  last_sample_{Clock::now()};  ///< The time of the previous thread report
+  CpuTimes   cpu_times_{};                ///< The CPU time of each subsystem at that time
+};
+
+}  // namespace fetch
@@ -0,0 +1,83 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "http/json_response.hpp"
+#include "http/module.hpp"
+#include "metrics/storage_metrics.hpp"
+#include "metrics_variant.hpp"
+#include "variant/variant.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fetch {
+
+/**
+ * Exposes the storage instruments (cache, I/O and latency figures for every stack and document
+ * store of the node) so that slow blocks can be attributed to I/O or to execution.
+ */
+class StorageMetricsHttpModule : public http::HTTPModule
+{
+public:
+  using Variant              = variant::Variant;
+  using StorageMetrics       = metrics::StorageMetrics;
+  using StackMetrics         = metrics::StackMetrics;
+  using DocumentStoreMetrics = metrics::DocumentStoreMetrics;
+
+  StorageMetricsHttpModule()
+  {
+    Get("/api/metrics/storage", [](http::ViewParameters const &, http::HTTPRequest const &) {
+      auto const &metrics = StorageMetrics::Instance();
+
+      std::vector<Variant> stacks{};
+      metrics.VisitStacks([&stacks](std::string const &name, StackMetrics const &stack) {
+        Variant entry            = Variant::Object();
+        entry["name"]            = name;
+        entry["cache_hits"]      = stack.cache_hits.load();
+        entry["cache_misses"]    = stack.cache_misses.load();
+        entry["cache_hit_ratio"] = stack.cache_hit_ratio();
+        entry["bytes_read"]      = stack.bytes_read.load();
+        entry["bytes_written"]   = stack.bytes_written.load();
+        entry["flush_latency"]   = ToVariant(stack.flush_latency);
+
+        stacks.emplace_back(std::move(entry));
+      });
+
+      std::vector<Variant> stores{};
+      metrics.VisitDocumentStores(
+          [&stores](std::string const &name, DocumentStoreMetrics const &store) {
+            Variant entry           = Variant::Object();
+            entry["name"]           = name;
+            entry["commit_latency"] = ToVariant(store.commit_latency);
+            entry["revert_latency"] = ToVariant(store.revert_latency);
+
+            stores.emplace_back(std::move(entry));
+          });
+
+      Variant response            = Variant::Object();
+      response["stacks"]          = ToVariantArray(stacks);
+      response["document_stores"] = ToVariantArray(stores);
+
+      return http::CreateJsonResponse(response);
+    });
+  }
+};
+
+}  // namespace fetch
@@ -0,0 +1,356 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "core/logger.hpp"
+
+#include "thread_budget.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#if defined(FETCH_PLATFORM_LINUX)
+#include <sched.h>
+#endif
+
+namespace fetch {
+namespace {
+
+constexpr char const *LOGGING_NAME = "ThreadBudget";
+constexpr char const *NODE_PATH    = "/sys/devices/system/node/node";
+
+/**
+ * Get the cores the process is allowed to run on (which may have been restricted with taskset or
+ * a cgroup)
+ *
+ * @return The usable cores
+ */
+ThreadBudget::Cores AllowedCores()
+{
+  ThreadBudget::Cores cores{};
+
+#if defined(FETCH_PLATFORM_LINUX)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+
+  if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0)
+  {
+    for (std::size_t core = 0; core < CPU_SETSIZE; ++core)
+    {
+      if (CPU_ISSET(core, &cpu_set))
+      {
+        cores.push_back(core);
+      }
+    }
+  }
+#endif
+
+  if (cores.empty())
+  {
+    cores.resize(std::max(std::thread::hardware_concurrency(), 1u));
+    std::iota(cores.begin(), cores.end(), std::size_t{0});
+  }
+
+  return cores;
+}
+
+std::string ToString(ThreadBudget::Cores const &cores)
+{
+  std::ostringstream oss;
+  for (std::size_t i = 0; i < cores.size(); ++i)
+  {
+    oss << ((i == 0) ? "" : ",") << cores[i];
+  }
+
+  return oss.str();
+}
+
+}  // namespace
+
+/**
+ * The default shares of a constellation node, the weights reflect where the CPU time of a busy
+ * node goes: transaction verification and execution, followed by networking
+ *
+ * @return The default shares
+ */
+ThreadBudget::Shares ThreadBudget::DefaultShares()
+{
+  return {
+      {"network",
+       {"NetMgr", "TP:Router", "TP:Verify", "TP:Mdl-", "TP:CORE", "TP:FeedSubscriptionManager"},
+       3},
+      {"http", {"Http", "TP:HTTP"}, 1},
+      {"verification", {"TxV-"}, 4},
+      {"execution", {"Executor", "ExecMgrMon"}, 4},
+      {"compute", {"Compute", "Miner", "Annealer", "DataParallel"}, 2},
+      {"services", {"Reactor", "LaneServiceReactor", "TxProc", "BW:", "TP:ContractCompiler"}, 2},
+  };
+}
+
+/**
+ * Determine the usable cores of each NUMA node of the machine. Machines without NUMA information
+ * are treated as a single node.
+ *
+ * @return The cores of each node
+ */
+ThreadBudget::Nodes ThreadBudget::DetectTopology()
+{
+  Cores const allowed = AllowedCores();
+
+  Nodes nodes{};
+  for (std::size_t node = 0;; ++node)
+  {
+    std::ifstream input{NODE_PATH + std::to_string(node) + "/cpulist"};
+    if (!input.is_open())
+    {
+      break;
+    }
+
+    std::string list;
+    std::getline(input, list);
+
+    // only the cores the process is allowed to use
+    Cores cores{};
+    for (auto const core : ParseCpuList(list))
+    {
+      if (std::binary_search(allowed.begin(), allowed.end(), core))
+      {
+        cores.push_back(core);
+      }
+    }
+
+    if (!cores.empty())
+    {
+      nodes.push_back(std::move(cores));
+    }
+  }
+
+  if (nodes.empty())
+  {
+    nodes.push_back(allowed);
+  }
+
+  return nodes;
+}
+
+/**
+ * Parse a kernel CPU list, e.g. "0-3,8-11"
+ *
+ * @param list The list to be parsed
+ * @return The sorted cores in the list, malformed entries are ignored
+ */
+ThreadBudget::Cores ThreadBudget::ParseCpuList(std::string const &list)
+{
+  Cores cores{};
+
+  std::istringstream stream{list};
+  std::string        entry;
+  while (std::getline(stream, entry, ','))
+  {
+    std::size_t first{0};
+    std::size_t last{0};
+    char        separator{0};
+
+    std::istringstream range{entry};
+    if (!(range >> first))
+    {
+      continue;
+    }
+
+    last = first;
+    if ((range >> separator) && (separator == '-') && !(range >> last))
+    {
+      continue;
+    }
+
+    for (std::size_t core = first; core <= last; ++core)
+    {
+      cores.push_back(core);
+    }
+  }
+
+  std::sort(cores.begin(), cores.end());
+  cores.erase(std::unique(cores.begin(), cores.end()), cores.end());
+
+  return cores;
+}
+
+/**
+ * Construct the budget, dividing the cores of the nodes between the shares
+ *
+ * @param nodes The usable cores of each NUMA node
+ * @param shares The shares of the subsystems
+ */
+ThreadBudget::ThreadBudget(Nodes const &nodes, Shares shares)
+  : shares_{std::move(shares)}
+  , assignments_{Plan(nodes, shares_)}
+{}
+
+/**
+ * Assign the cores of every share to its subsystem, the threads of the subsystem started from now
+ * on are pinned to them
+ */
+void ThreadBudget::Apply() const
+{
+  auto &placement = core::ThreadPlacement::Instance();
+
+  for (std::size_t i = 0; i < shares_.size(); ++i)
+  {
+    auto const &share      = shares_[i];
+    auto const &assignment = assignments_[i];
+
+    placement.Assign(share.subsystem, share.prefixes, assignment.cores);
+
+    FETCH_LOG_INFO(LOGGING_NAME, "Subsystem ", share.subsystem, " pinned to cores ",
+                   ToString(assignment.cores));
+  }
+}
+
+/**
+ * Get the number of cores assigned to a subsystem
+ *
+ * @param subsystem The name of the subsystem
+ * @return The number of cores, zero if the subsystem has no share
+ */
+std::size_t ThreadBudget::CoresFor(std::string const &subsystem) const
+{
+  for (auto const &assignment : assignments_)
+  {
+    if (assignment.subsystem == subsystem)
+    {
+      return assignment.cores.size();
+    }
+  }
+
+  return 0;
+}
+
+ThreadBudget::Assignments const &ThreadBudget::assignments() const
+{
+  return assignments_;
+}
+
+/**
+ * Internal: Divide the cores between the shares. The number of cores of each share is its
+ * proportion of the total weight (rounded by largest remainder, at least one core each). The
+ * largest shares are placed first, each on the node with the most free cores, only spilling onto
+ * other nodes when it does not fit. When there are fewer cores than shares, every share is given
+ * all of the cores.
+ *
+ * @param nodes The usable cores of each NUMA node
+ * @param shares The shares to be placed
+ * @return The cores of each share, in the same order as the shares
+ */
+ThreadBudget::Assignments ThreadBudget::Plan(Nodes const &nodes, Shares const &shares)
+{
+  Assignments assignments(shares.size());
+  for (std::size_t i = 0; i < shares.size(); ++i)
+  {
+    assignments[i].subsystem = shares[i].subsystem;
+  }
+
+  Cores all_cores{};
+  for (auto const &node : nodes)
+  {
+    all_cores.insert(all_cores.end(), node.begin(), node.end());
+  }
+
+  std::size_t const num_cores = all_cores.size();
+  std::size_t const total_weight =
+      std::accumulate(shares.begin(), shares.end(), std::size_t{0},
+                      [](std::size_t total, Share const &share) { return total + share.weight; });
+
+  if (shares.empty() || (num_cores == 0))
+  {
+    return assignments;
+  }
+
+  if ((num_cores < shares.size()) || (total_weight == 0))
+  {
+    std::sort(all_cores.begin(), all_cores.end());
+    for (auto &assignment : assignments)
+    {
+      assignment.cores = all_cores;
+    }
+
+    return assignments;
+  }
+
+  // size each share in proportion to its weight
+  std::vector<std::size_t> counts(shares.size());
+  std::vector<double>      remainders(shares.size());
+  std::size_t              allocated{0};
+  for (std::size_t i = 0; i < shares.size(); ++i)
+  {
+    double const exact = static_cast<double>(shares[i].weight * num_cores) /
+                         static_cast<double>(total_weight);
+
+    counts[i]     = std::max<std::size_t>(static_cast<std::size_t>(exact), 1);
+    remainders[i] = exact - static_cast<double>(counts[i]);
+    allocated += counts[i];
+  }
+
+  while (allocated > num_cores)
+  {
+    // the minimum of one core each has overcommitted, take back from the largest share
+    auto const largest = std::max_element(counts.begin(), counts.end());
+    --(*largest);
+    --allocated;
+  }
+
+  while (allocated < num_cores)
+  {
+    auto const index = static_cast<std::size_t>(
+        std::max_element(remainders.begin(), remainders.end()) - remainders.begin());
+    ++counts[index];
+    remainders[index] -= 1.0;
+    ++allocated;
+  }
+
+  // place the largest shares first, each on the nodes with the most free cores
+  std::vector<std::size_t> order(shares.size());
+  std::iota(order.begin(), order.end(), std::size_t{0});
+  std::stable_sort(order.begin(), order.end(),
+                   [&counts](std::size_t a, std::size_t b) { return counts[a] > counts[b]; });
+
+  Nodes free_cores = nodes;
+  for (auto const index : order)
+  {
+    Cores &cores = assignments[index].cores;
+    while (cores.size() < counts[index])
+    {
+      auto &node = *std::max_element(
+          free_cores.begin(), free_cores.end(),
+          [](Cores const &a, Cores const &b) { return a.size() < b.size(); });
+
+      std::size_t const taken = std::min(counts[index] - cores.size(), node.size());
+      cores.insert(cores.end(), node.begin(), node.begin() + static_cast<std::ptrdiff_t>(taken));
+      node.erase(node.begin(), node.begin() + static_cast<std::ptrdiff_t>(taken));
+    }
+
+    std::sort(cores.begin(), cores.end());
+  }
+
+  return assignments;
+}
+
+}  // namespace fetch
@@ -0,0 +1,84 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/thread_placement.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace fetch {
+
+/**
+ * The division of the cores of the machine between the subsystems of a constellation node
+ *
+ * Every subsystem is given a share of the cores in proportion to its weight (at least one core
+ * each), and its threads are pinned to those cores as they start, so that the subsystems stop
+ * competing with each other for the same cores. Where a share fits within a single NUMA node it
+ * is placed on one node, so that the threads of a subsystem share caches and local memory.
+ */
+class ThreadBudget
+{
+public:
+  using Cores    = core::ThreadPlacement::Cores;
+  using Prefixes = core::ThreadPlacement::Prefixes;
+  using Nodes    = std::vector<Cores>;  ///< The (usable) cores of each NUMA node
+
+  struct Share
+  {
+    std::string subsystem{};
+    Prefixes    prefixes{};  ///< The prefixes of the names of the threads of the subsystem
+    std::size_t weight{1};
+  };
+
+  struct Assignment
+  {
+    std::string subsystem{};
+    Cores       cores{};
+  };
+
+  using Shares      = std::vector<Share>;
+  using Assignments = std::vector<Assignment>;
+
+  static Shares DefaultShares();
+  static Nodes  DetectTopology();
+  static Cores  ParseCpuList(std::string const &list);
+
+  // Construction / Destruction
+  ThreadBudget(Nodes const &nodes, Shares shares);
+  ThreadBudget(ThreadBudget const &) = delete;
+  ThreadBudget(ThreadBudget &&)      = delete;
+  ~ThreadBudget()                    = default;
+
+  void               Apply() const;
+  std::size_t        CoresFor(std::string const &subsystem) const;
+  Assignments const &assignments() const;
+
+  // Operators
+  ThreadBudget &operator=(ThreadBudget const &) = delete;
+  ThreadBudget &operator=(ThreadBudget &&) = delete;
+
+private:
+  static Assignments Plan(Nodes const &nodes, Shares const &shares);
+
+  Shares      shares_;
+  Assignments assignments_;  ///< The cores of each share, in the same order
+};
+
+}  // namespace fetch
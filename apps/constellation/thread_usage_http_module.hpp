@@ -0,0 +1,72 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/thread_placement.hpp"
+#include "http/json_response.hpp"
+#include "http/module.hpp"
+#include "metrics_variant.hpp"
+#include "variant/variant.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace fetch {
+
+/**
+ * Exposes the threads and CPU time of each subsystem of the node, along with the cores the
+ * subsystem has been pinned to (if any), so that the thread budget can be checked against the
+ * actual load.
+ */
+class ThreadUsageHttpModule : public http::HTTPModule
+{
+public:
+  using Variant         = variant::Variant;
+  using ThreadPlacement = core::ThreadPlacement;
+
+  ThreadUsageHttpModule()
+  {
+    Get("/api/threads", [](http::ViewParameters const &, http::HTTPRequest const &) {
+      std::vector<Variant> subsystems{};
+      for (auto const &usage : ThreadPlacement::Instance().Report())
+      {
+        std::vector<Variant> cores{};
+        for (auto const core : usage.cores)
+        {
+          cores.emplace_back(static_cast<int64_t>(core));
+        }
+
+        Variant entry        = Variant::Object();
+        entry["subsystem"]   = usage.subsystem;
+        entry["cores"]       = ToVariantArray(cores);
+        entry["threads"]     = usage.threads;
+        entry["cpu_seconds"] = usage.cpu_seconds;
+
+        subsystems.emplace_back(std::move(entry));
+      }
+
+      Variant response       = Variant::Object();
+      response["subsystems"] = ToVariantArray(subsystems);
+
+      return http::CreateJsonResponse(response);
+    });
+  }
+};
+
+}  // namespace fetch
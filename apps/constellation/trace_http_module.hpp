@@ -0,0 +1,52 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "http/json_response.hpp"
+#include "http/module.hpp"
+#include "metrics/tracer.hpp"
+
+#include <string>
+
+namespace fetch {
+
+/**
+ * Exports (and clears) the spans recorded by the tracer since the last request. By default the
+ * spans are formatted as a Chrome trace, `?format=otlp` formats them as an OTLP/HTTP JSON export
+ * request instead.
+ */
+class TraceHttpModule : public http::HTTPModule
+{
+public:
+  using Tracer = metrics::Tracer;
+
+  TraceHttpModule()
+  {
+    Get("/api/metrics/trace", [](http::ViewParameters const &, http::HTTPRequest const &request) {
+      auto &     tracer  = Tracer::Instance();
+      auto const records = tracer.Collect();
+
+      bool const otlp = request.query().Has("format") && (request.query()["format"] == "otlp");
+
+      return http::CreateJsonResponse(otlp ? Tracer::ToOtlpJson(records, "constellation")
+                                           : Tracer::ToChromeTrace(records));
+    });
+  }
+};
+
+}  // namespace fetch
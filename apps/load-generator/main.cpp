@@ -0,0 +1,562 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/encoders.hpp"
+#include "core/commandline/params.hpp"
+#include "core/json/document.hpp"
+#include "core/mutex.hpp"
+#include "http/http_client.hpp"
+#include "http/request.hpp"
+#include "http/response.hpp"
+#include "ledger/chain/mutable_transaction.hpp"
+#include "ledger/chain/wire_transaction.hpp"
+#include "variant/variant.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using fetch::byte_array::ByteArray;
+using fetch::byte_array::ConstByteArray;
+using fetch::byte_array::ToBase64;
+using fetch::byte_array::ToHex;
+using fetch::http::HTTPRequest;
+using fetch::http::HTTPResponse;
+using fetch::http::HttpClient;
+using fetch::ledger::MutableTransaction;
+
+using Clock      = std::chrono::steady_clock;
+using Timepoint  = Clock::time_point;
+using Duration   = Clock::duration;
+using PrivateKey = fetch::ledger::TxSigningAdapter<>::private_key_type;
+using Samples    = std::vector<double>;
+using Mutex      = fetch::mutex::Mutex;
+
+struct CommandLineArguments
+{
+  std::string host{"127.0.0.1"};
+  uint16_t    port{8000};
+  std::size_t rate{100};
+  std::size_t duration{60};
+  std::size_t batch_size{10};
+  std::size_t accounts{100};
+  std::size_t transfer_weight{9};
+  std::size_t wealth_weight{1};
+  std::size_t hot_percent{0};
+  std::size_t sample{10};
+  std::size_t settle{30};
+
+  static CommandLineArguments Parse(int argc, char **argv)
+  {
+    CommandLineArguments args;
+
+    fetch::commandline::Params parameters;
+    parameters.description("Drives a running node at a target transaction rate and reports the "
+                           "achieved throughput and latencies");
+    parameters.add(args.host, "host", "The host name of the node's HTTP interface", args.host);
+    parameters.add(args.port, "port", "The port of the node's HTTP interface", args.port);
+    parameters.add(args.rate, "rate", "The target rate of submission in tx/s", args.rate);
+    parameters.add(args.duration, "duration", "The duration of the load in seconds",
+                   args.duration);
+    parameters.add(args.batch_size, "batch", "The number of transactions per HTTP request",
+                   args.batch_size);
+    parameters.add(args.accounts, "accounts", "The number of accounts to transfer between",
+                   args.accounts);
+    parameters.add(args.transfer_weight, "transfer-weight",
+                   "The relative weight of token transfers in the mix", args.transfer_weight);
+    parameters.add(args.wealth_weight, "wealth-weight",
+                   "The relative weight of wealth creation in the mix", args.wealth_weight);
+    parameters.add(args.hot_percent, "hot",
+                   "The percentage of transfers which involve the hottest 1% of the accounts",
+                   args.hot_percent);
+    parameters.add(args.sample, "sample",
+                   "Track the inclusion and execution of one in this many transactions",
+                   args.sample);
+    parameters.add(args.settle, "settle",
+                   "The number of seconds to wait for tracked transactions after the load",
+                   args.settle);
+
+    parameters.Parse(argc, argv);
+
+    if ((args.rate == 0) || (args.batch_size == 0) || (args.accounts < 2) || (args.sample == 0) ||
+        ((args.transfer_weight + args.wealth_weight) == 0))
+    {
+      throw std::runtime_error("Invalid load configuration");
+    }
+
+    return args;
+  }
+
+  friend std::ostream &operator<<(std::ostream &s, CommandLineArguments const &args)
+  {
+    s << "Target     : " << args.host << ':' << args.port << '\n';
+    s << "Rate       : " << args.rate << " tx/s for " << args.duration << " s (batches of "
+      << args.batch_size << ")\n";
+    s << "Mix        : transfer " << args.transfer_weight << " / wealth " << args.wealth_weight
+      << " over " << args.accounts << " accounts (" << args.hot_percent << "% hot)\n";
+    s << "Tracking   : 1 in " << args.sample << " transactions" << std::endl;
+    return s;
+  }
+};
+
+struct Account
+{
+  PrivateKey     key{};
+  ConstByteArray address{};  ///< The binary address (public key) of the account
+  ConstByteArray encoded{};  ///< The base64 encoded address used in the contract payloads
+};
+
+using Accounts = std::vector<Account>;
+
+/**
+ * The timestamps of a tracked transaction as it progresses through the node
+ */
+struct Tracked
+{
+  Timepoint submitted{};
+  Timepoint mined{};
+  Timepoint executed{};
+  bool      is_mined{false};
+  bool      is_executed{false};
+};
+
+using TrackedMap = std::unordered_map<std::string, Tracked>;  // keyed by hex digest
+
+double ToMilliseconds(Duration const &duration)
+{
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+/**
+ * Print the percentiles of a set of latency samples
+ *
+ * @param name The name of the stage
+ * @param samples The latency samples in milliseconds
+ */
+void PrintLatencies(std::string const &name, Samples samples)
+{
+  std::cout << std::left << std::setw(11) << name << ": ";
+
+  if (samples.empty())
+  {
+    std::cout << "no samples" << std::endl;
+    return;
+  }
+
+  std::sort(samples.begin(), samples.end());
+
+  auto const percentile = [&samples](double p) {
+    return samples[static_cast<std::size_t>(p * static_cast<double>(samples.size() - 1))];
+  };
+
+  std::cout << std::fixed << std::setprecision(1) << "n=" << samples.size()
+            << " p50=" << percentile(0.5) << "ms p90=" << percentile(0.9)
+            << "ms p99=" << percentile(0.99) << "ms max=" << samples.back() << "ms" << std::endl;
+}
+
+class LoadGenerator
+{
+public:
+  explicit LoadGenerator(CommandLineArguments const &args)
+    : args_{args}
+    , rng_{std::random_device{}()}
+  {
+    accounts_.resize(args_.accounts);
+    for (auto &account : accounts_)
+    {
+      account.address = account.key.publicKey().keyAsBin();
+      account.encoded = ToBase64(account.address);
+    }
+  }
+
+  void Run()
+  {
+    // every account needs funds before it can make transfers
+    Fund();
+
+    std::atomic<bool> submitting{true};
+    std::thread       poller{[this, &submitting]() { Poll(submitting); }};
+
+    Submit();
+
+    submitting = false;
+    poller.join();
+
+    Report();
+  }
+
+private:
+  static constexpr uint64_t INITIAL_BALANCE = 1000000000;
+
+  MutableTransaction CreateWealth(Account const &account, uint64_t amount)
+  {
+    std::ostringstream oss;
+    oss << R"({"address": ")" << account.encoded << R"(", "amount": )" << amount << '}';
+
+    MutableTransaction tx;
+    tx.set_contract_name("fetch.token.wealth");
+    tx.set_data(oss.str());
+    tx.PushResource(account.address);
+    tx.Sign(account.key);
+    tx.UpdateDigest();
+
+    return tx;
+  }
+
+  MutableTransaction CreateTransfer(Account const &from, Account const &to, uint64_t amount)
+  {
+    std::ostringstream oss;
+    oss << R"({"from": ")" << from.encoded << R"(", "to": ")" << to.encoded << R"(", "amount": )"
+        << amount << '}';
+
+    MutableTransaction tx;
+    tx.set_contract_name("fetch.token.transfer");
+    tx.set_data(oss.str());
+    tx.PushResource(from.address);
+    tx.PushResource(to.address);
+    tx.Sign(from.key);
+    tx.UpdateDigest();
+
+    return tx;
+  }
+
+  /**
+   * Pick an account, preferring the hottest 1% of the accounts for the configured share of picks
+   * so that the load exhibits the resource contention of a real workload
+   */
+  Account const &PickAccount()
+  {
+    std::size_t population = accounts_.size();
+
+    if (Uniform(100) < args_.hot_percent)
+    {
+      population = std::max<std::size_t>(population / 100, 2);
+    }
+
+    return accounts_[Uniform(population)];
+  }
+
+  MutableTransaction CreateFromMix()
+  {
+    if (Uniform(args_.transfer_weight + args_.wealth_weight) < args_.wealth_weight)
+    {
+      return CreateWealth(PickAccount(), 1 + Uniform(100));
+    }
+
+    Account const *from = &PickAccount();
+    Account const *to   = &PickAccount();
+    while (to == from)
+    {
+      to = &accounts_[Uniform(accounts_.size())];
+    }
+
+    return CreateTransfer(*from, *to, 1 + Uniform(10));
+  }
+
+  std::size_t Uniform(std::size_t n)
+  {
+    return std::uniform_int_distribution<std::size_t>{0, n - 1}(rng_);
+  }
+
+  /**
+   * Submit a batch of transactions in a single request
+   *
+   * @param client The client to submit with
+   * @param batch The transactions to be submitted
+   * @return The number of transactions accepted by the node
+   */
+  static std::size_t SubmitBatch(HttpClient &client, std::vector<MutableTransaction> const &batch)
+  {
+    ByteArray body;
+    body.Append("[");
+    for (std::size_t i = 0; i < batch.size(); ++i)
+    {
+      if (i > 0)
+      {
+        body.Append(",");
+      }
+      body.Append(fetch::ledger::ToWireTransaction(batch[i]));
+    }
+    body.Append("]");
+
+    HTTPRequest request;
+    request.SetMethod(fetch::http::Method::POST);
+    request.SetURI("/api/contract/submit");
+    request.AddHeader("Content-Type", "application/vnd+fetch.transaction+json");
+    request.SetBody(body);
+
+    HTTPResponse response;
+    if (!client.Request(request, response) ||
+        (response.status() != fetch::http::Status::SUCCESS_OK))
+    {
+      return 0;
+    }
+
+    fetch::json::JSONDocument doc{response.body()};
+    return doc.root()["counts"]["submitted"].As<std::size_t>();
+  }
+
+  void Fund()
+  {
+    HttpClient                      client{args_.host, args_.port};
+    std::vector<MutableTransaction> batch;
+
+    for (auto const &account : accounts_)
+    {
+      batch.emplace_back(CreateWealth(account, INITIAL_BALANCE));
+
+      if ((batch.size() == args_.batch_size) || (&account == &accounts_.back()))
+      {
+        if (SubmitBatch(client, batch) != batch.size())
+        {
+          throw std::runtime_error("Unable to fund the load generation accounts");
+        }
+
+        batch.clear();
+      }
+    }
+
+    std::cout << "Funded " << accounts_.size() << " accounts" << std::endl;
+  }
+
+  void Submit()
+  {
+    HttpClient client{args_.host, args_.port};
+
+    // the interval between the batches which achieves the target rate
+    std::chrono::duration<double> const seconds_per_batch{static_cast<double>(args_.batch_size) /
+                                                          static_cast<double>(args_.rate)};
+
+    std::size_t const total    = args_.rate * args_.duration;
+    Duration const    interval = std::chrono::duration_cast<Duration>(seconds_per_batch);
+
+    std::vector<MutableTransaction> batch;
+    batch.reserve(args_.batch_size);
+
+    Timepoint const start    = Clock::now();
+    Timepoint       deadline = start;
+
+    while (generated_ < total)
+    {
+      batch.clear();
+      for (std::size_t i = 0; (i < args_.batch_size) && (generated_ < total); ++i, ++generated_)
+      {
+        batch.emplace_back(CreateFromMix());
+      }
+
+      // wait for the slot of this batch, if generation is keeping up with the target rate
+      deadline += interval;
+      std::this_thread::sleep_until(deadline);
+
+      Timepoint const   submitted = Clock::now();
+      std::size_t const accepted  = SubmitBatch(client, batch);
+      Timepoint const   responded = Clock::now();
+
+      submission_latencies_.push_back(ToMilliseconds(responded - submitted));
+      accepted_ += accepted;
+
+      if (accepted != batch.size())
+      {
+        ++failed_requests_;
+        continue;
+      }
+
+      FETCH_LOCK(tracked_lock_);
+      for (auto const &tx : batch)
+      {
+        if ((tracked_count_++ % args_.sample) == 0)
+        {
+          tracked_[static_cast<std::string>(ToHex(tx.digest()))].submitted = submitted;
+        }
+      }
+    }
+
+    submit_time_ = Clock::now() - start;
+  }
+
+  /**
+   * Poll the status of the tracked transactions until they have all been executed, or until the
+   * settle time has elapsed after the end of the submission
+   *
+   * @param submitting Flag signalling that the submission is still in progress
+   */
+  void Poll(std::atomic<bool> const &submitting)
+  {
+    HttpClient client{args_.host, args_.port};
+
+    Timepoint settle_deadline{Timepoint::max()};
+
+    for (;;)
+    {
+      if (!submitting && (settle_deadline == Timepoint::max()))
+      {
+        settle_deadline = Clock::now() + std::chrono::seconds{args_.settle};
+      }
+
+      std::vector<std::string> outstanding;
+      {
+        FETCH_LOCK(tracked_lock_);
+        for (auto const &element : tracked_)
+        {
+          if (!element.second.is_executed)
+          {
+            outstanding.push_back(element.first);
+          }
+        }
+      }
+
+      if (!submitting && (outstanding.empty() || (Clock::now() >= settle_deadline)))
+      {
+        break;
+      }
+
+      for (auto const &digest : outstanding)
+      {
+        HTTPRequest request;
+        request.SetMethod(fetch::http::Method::GET);
+        request.SetURI("/api/status/tx/" + digest);
+
+        HTTPResponse response;
+        if (!client.Request(request, response))
+        {
+          continue;
+        }
+
+        fetch::json::JSONDocument doc{response.body()};
+        auto const status = doc.root()["status"].As<ConstByteArray>();
+
+        bool const executed = (status == "Executed");
+        bool const mined    = executed || (status == "Mined");
+
+        Timepoint const now = Clock::now();
+
+        FETCH_LOCK(tracked_lock_);
+        auto &tracked = tracked_[digest];
+        if (mined && !tracked.is_mined)
+        {
+          tracked.mined    = now;
+          tracked.is_mined = true;
+        }
+        if (executed)
+        {
+          tracked.executed    = now;
+          tracked.is_executed = true;
+        }
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    }
+  }
+
+  void Report()
+  {
+    Samples inclusion;
+    Samples execution;
+
+    FETCH_LOCK(tracked_lock_);
+    for (auto const &element : tracked_)
+    {
+      auto const &tracked = element.second;
+
+      if (tracked.is_mined)
+      {
+        inclusion.push_back(ToMilliseconds(tracked.mined - tracked.submitted));
+      }
+      if (tracked.is_executed)
+      {
+        execution.push_back(ToMilliseconds(tracked.executed - tracked.submitted));
+      }
+    }
+
+    double const seconds = std::chrono::duration<double>(submit_time_).count();
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Submitted  : " << generated_ << " tx in " << seconds << " s ("
+              << (static_cast<double>(generated_) / seconds) << " tx/s, target " << args_.rate
+              << " tx/s)\n";
+    std::cout << "Accepted   : " << accepted_ << " tx (" << failed_requests_
+              << " failed requests)\n";
+    std::cout << "Executed   : " << execution.size() << " of " << tracked_.size()
+              << " tracked tx (" << (static_cast<double>(execution.size()) / seconds)
+              << " tx/s sampled)" << std::endl;
+
+    PrintLatencies("submission", submission_latencies_);
+    PrintLatencies("inclusion", inclusion);
+    PrintLatencies("execution", execution);
+  }
+
+  CommandLineArguments const &args_;
+  std::mt19937_64             rng_;
+  Accounts                    accounts_{};
+
+  std::size_t generated_{0};
+  std::size_t accepted_{0};
+  std::size_t failed_requests_{0};
+  Duration    submit_time_{};
+  Samples     submission_latencies_{};  ///< The round trip time of each submission request
+
+  Mutex       tracked_lock_{__LINE__, __FILE__};
+  TrackedMap  tracked_{};  ///< The sampled transactions, guarded by tracked_lock_
+  std::size_t tracked_count_{0};
+};
+
+}  // namespace
+
+/**
+ * Load generator for a running node (or constellation). Token transactions are generated from a
+ * configurable mix, submitted over the HTTP interface at a target rate, and a sample of them is
+ * followed through the status API. On completion the achieved throughput is reported along with
+ * the latency percentiles of the submission, inclusion (submitted to mined) and execution
+ * (submitted to executed) of the transactions:
+ *
+ * @code{.sh}
+ * load-generator -host 127.0.0.1 -port 8000 -rate 2000 -duration 120 -accounts 1000 -hot 20
+ * @endcode
+ */
+int main(int argc, char **argv)
+{
+  try
+  {
+    auto const args = CommandLineArguments::Parse(argc, argv);
+    std::cout << args << std::endl;
+
+    LoadGenerator generator{args};
+    generator.Run();
+
+    return EXIT_SUCCESS;
+  }
+  catch (std::exception const &ex)
+  {
+    std::cerr << "Fatal Error: " << ex.what() << std::endl;
+  }
+
+  return EXIT_FAILURE;
+}
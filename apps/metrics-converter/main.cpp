@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/commandline/params.hpp"
+#include "metrics/metric_aggregator.hpp"
+#include "metrics/metric_file_format.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using fetch::metrics::MetricAggregator;
+using fetch::metrics::MetricRecord;
+
+namespace {
+
+struct CommandLineArguments
+{
+  std::string input;
+  std::string output;
+  bool        prometheus{false};
+
+  static CommandLineArguments Parse(int argc, char **argv)
+  {
+    CommandLineArguments args;
+
+    fetch::commandline::Params parameters;
+    parameters.description("Converts a binary metrics file into CSV (or aggregated) form");
+    parameters.add(args.input, "input", "The binary metrics file to be converted",
+                   std::string{"metrics.bin"});
+    parameters.add(args.output, "output", "The output file, the standard output if not set",
+                   std::string{});
+    parameters.add(args.prometheus, "prometheus",
+                   "Output the aggregated counters and histograms instead of the events", false);
+
+    parameters.Parse(argc, argv);
+
+    return args;
+  }
+};
+
+/**
+ * Convert all the records of the input stream
+ *
+ * @param input The binary metrics stream, after the header
+ * @param output The stream to which the output is written
+ * @param prometheus Whether to output the aggregated values instead of each event
+ * @return The number of records converted
+ */
+std::size_t Convert(std::istream &input, std::ostream &output, bool prometheus)
+{
+  MetricAggregator aggregator;
+  MetricRecord     record;
+  std::size_t      count{0};
+
+  if (!prometheus)
+  {
+    fetch::metrics::WriteCsvHeader(output);
+  }
+
+  while (input.read(reinterpret_cast<char *>(&record), sizeof(record)))
+  {
+    if (prometheus)
+    {
+      aggregator.Update(record);
+    }
+    else
+    {
+      fetch::metrics::WriteCsvRecord(output, record);
+    }
+
+    ++count;
+  }
+
+  if (prometheus)
+  {
+    output << aggregator.ToPrometheusText();
+  }
+
+  return count;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+  auto const args = CommandLineArguments::Parse(argc, argv);
+
+  std::ifstream input(args.input.c_str(), std::ios::in | std::ios::binary);
+  if (!input)
+  {
+    std::cerr << "Unable to open input file: " << args.input << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!fetch::metrics::ReadHeader(input))
+  {
+    std::cerr << "Not a binary metrics file (or an unsupported version): " << args.input
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::size_t count{0};
+  if (args.output.empty())
+  {
+    count = Convert(input, std::cout, args.prometheus);
+  }
+  else
+  {
+    std::ofstream output(args.output.c_str());
+    if (!output)
+    {
+      std::cerr << "Unable to open output file: " << args.output << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    count = Convert(input, output, args.prometheus);
+  }
+
+  std::cerr << "Converted " << count << " records" << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -32,6 +32,7 @@
 #include <iterator>
 #include <random>
 #include <sstream>
+#include <thread>
 #include <unordered_set>
 
 using namespace fetch;
@@ -318,6 +319,16 @@ int main(int argc, char **argv)
                  "temperature.";
     std::cout << std::endl;
 
+    std::cout << std::setw(18) << "-replicas";
+    std::cout << std::setw(10) << "[number]";
+    std::cout << " parallel tempering replicas, 1 for a single annealing chain.";
+    std::cout << std::endl;
+
+    std::cout << std::setw(18) << "-threads";
+    std::cout << std::setw(10) << "[number]";
+    std::cout << " threads over which the replicas are run.";
+    std::cout << std::endl;
+
     std::cout << std::setw(18) << "-strategy";
     std::cout << std::setw(10) << "[number]";
     std::cout << " indicates the strategy to pick a batch.";
@@ -352,7 +363,7 @@ int main(int argc, char **argv)
 
   int         file_format = params.GetParam<int>("file-format", 1);
   double      beta0, beta1;
-  std::size_t sweeps, reps, batch_size, explore;
+  std::size_t sweeps, reps, batch_size, explore, replicas, threads;
   int         strategy = 0;
 
   lane_count = params.GetParam<std::size_t>("lane-count", lane_count);
@@ -385,6 +396,8 @@ int main(int argc, char **argv)
   sweeps      = params.GetParam<std::size_t>("sweeps", 100);
   beta0       = params.GetParam<double>("b0", 0.1);
   beta1       = params.GetParam<double>("b1", 3);
+  replicas    = params.GetParam<std::size_t>("replicas", 1);
+  threads     = params.GetParam<std::size_t>("threads", std::thread::hardware_concurrency());
   strategy    = params.GetParam<int>("strategy", 0);
 
   // Flags
@@ -392,7 +405,7 @@ int main(int argc, char **argv)
   bool print_solution = (params.GetParam<int>("print-solution", 0) == 1);
 
   // Solving
-  generator.ConfigureAnnealer(sweeps, beta0, beta1);
+  generator.ConfigureAnnealer(sweeps, beta0, beta1, replicas, threads);
 
   std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
 
@@ -25,6 +25,7 @@
 #include "vm/analyser.hpp"
 #include "vm/compiler.hpp"
 #include "vm/module.hpp"
+#include "vm/profiler.hpp"
 #include "vm/typeids.hpp"
 #include "vm/vm.hpp"
 #include "vm_modules/vm_factory.hpp"
@@ -38,6 +39,7 @@
 namespace {
 
 using fetch::vm::Script;
+using fetch::vm::Profiler;
 using fetch::vm::Ptr;
 using fetch::vm::VM;
 using fetch::vm::String;
@@ -257,6 +259,11 @@ int main(int argc, char **argv)
   if (2u != params.program().arg_size())
   {
     std::cerr << "Usage: " << argv[0] << " [options] <filename> -- [script args]..." << std::endl;
+    std::cerr << "\nOptions:\n";
+    std::cerr << "  -data <file>          The JSON file holding the state of the script\n";
+    std::cerr << "  -func <name>          The function to execute (default: main)\n";
+    std::cerr << "  -profile <file>       Profile the execution, writing folded stacks to file\n";
+    std::cerr << "  -profile-lines <0|1>  Annotate the profiled stacks with source lines\n";
     return 1;
   }
 
@@ -304,6 +311,15 @@ int main(int argc, char **argv)
     state_map.LoadFromFile(data_path.c_str());
   }
 
+  // attach the profiler when the execution is to be profiled
+  std::string const profile_path = params.program().GetParam("profile", "");
+
+  Profiler profiler;
+  if (!profile_path.empty())
+  {
+    vm->SetProfiler(&profiler);
+  }
+
   // Execute the requested function
   std::string        error;
   std::string        console;
@@ -329,5 +345,16 @@ int main(int argc, char **argv)
     state_map.SaveToFile(data_path.c_str());
   }
 
+  // export the profile, the folded stacks can be rendered with the flamegraph tools
+  if (!profile_path.empty())
+  {
+    bool const    with_lines = params.program().GetParam<bool>("profile-lines", false);
+    std::ofstream profile_file{profile_path};
+    profiler.WriteFoldedStacks(profile_file, with_lines);
+
+    std::cerr << '\n';
+    profiler.WriteReport(std::cerr);
+  }
+
   return (success) ? 0 : 1;
 }
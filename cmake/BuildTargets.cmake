@@ -36,6 +36,10 @@ macro(setup_compiler)
     math(EXPR _num_architectures_compiler "${_num_architectures_compiler}+1")
     list(APPEND _list_architectures_compiler "AVX2")
   endif(FETCH_ARCH_AVX2)
+  if(FETCH_ARCH_AVX512)
+    math(EXPR _num_architectures_compiler "${_num_architectures_compiler}+1")
+    list(APPEND _list_architectures_compiler "AVX512")
+  endif(FETCH_ARCH_AVX512)
 
   # platform configuration
   if (WIN32)
@@ -62,10 +66,15 @@ macro(setup_compiler)
     set(_compiler_arch "fma")
   elseif(FETCH_ARCH_AVX2)
     set(_compiler_arch "avx2")
+  elseif(FETCH_ARCH_AVX512)
+    set(_compiler_arch "avx512f")
   endif()
 
-  # update actual compiler configuration
-  set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -m${_compiler_arch}")
+  # update actual compiler configuration, on ARM the (NEON) vector extensions are part of the
+  # baseline instruction set and the x86 architecture flags do not apply
+  if(NOT CMAKE_SYSTEM_PROCESSOR MATCHES "^(aarch64|arm64)$")
+    set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -m${_compiler_arch}")
+  endif()
 
   # warnings
   set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -Wall -Wextra -Wconversion -Wpedantic")
@@ -178,6 +187,33 @@ function(configure_vendor_targets)
 
   target_include_directories(vendor-openssl INTERFACE ${OPENSSL_INCLUDE_DIR})
 
+  # libsecp256k1 (optional ECDSA verification backend)
+  if(FETCH_ENABLE_SECP256K1)
+    find_path(SECP256K1_INCLUDE_DIR secp256k1.h)
+    find_library(SECP256K1_LIBRARY secp256k1)
+
+    if(NOT SECP256K1_INCLUDE_DIR OR NOT SECP256K1_LIBRARY)
+      message(FATAL_ERROR "libsecp256k1 requested but not found")
+    endif()
+
+    if(FETCH_VERBOSE_CMAKE)
+      message(STATUS "libsecp256k1 include dir: ${SECP256K1_INCLUDE_DIR}")
+      message(STATUS "libsecp256k1 library: ${SECP256K1_LIBRARY}")
+    endif(FETCH_VERBOSE_CMAKE)
+
+    add_library(vendor-secp256k1 INTERFACE)
+    target_link_libraries(vendor-secp256k1 INTERFACE ${SECP256K1_LIBRARY})
+    target_include_directories(vendor-secp256k1 INTERFACE ${SECP256K1_INCLUDE_DIR})
+    target_compile_definitions(vendor-secp256k1 INTERFACE -DFETCH_ENABLE_SECP256K1)
+  endif(FETCH_ENABLE_SECP256K1)
+
+  # zlib
+  find_package(ZLIB REQUIRED)
+
+  add_library(vendor-zlib INTERFACE)
+  target_link_libraries(vendor-zlib INTERFACE ${ZLIB_LIBRARIES})
+  target_include_directories(vendor-zlib INTERFACE ${ZLIB_INCLUDE_DIRS})
+
   # setup the testing
   if(FETCH_ENABLE_TESTS)
     include(CTest)
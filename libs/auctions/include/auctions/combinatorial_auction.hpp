@@ -23,9 +23,19 @@
 #include "core/random/lcg.hpp"
 #include "core/random/lfg.hpp"
 
+#include <unordered_map>
+#include <vector>
+
 namespace fetch {
 namespace auctions {
 
+/**
+ * Combinatorial auction cleared by simulated annealing over the graph of the bids.
+ *
+ * Each bid is a node whose local field is the release value of the bid, and conflicting bids (bids
+ * sharing items or excluding each other) are joined by edges with negative couplings. The graph is
+ * sparse, so it is stored as adjacency lists and updated incrementally as bids are placed.
+ */
 class CombinatorialAuction : public Auction
 {
 
@@ -50,24 +60,46 @@ public:
   ErrorCode                  Execute() override;
   fetch::math::Tensor<Value> LocalFields();
   std::uint32_t              Active(std::size_t n);
-  void                       Mine(std::size_t random_seed, std::size_t run_time);
-  ErrorCode                  PlaceBid(Bid const &bid);
-  ErrorCode                  AddItem(Item const &item);
-  ErrorCode                  ShowAuctionResult();
+  void      Mine(std::size_t random_seed, std::size_t run_time, bool warm_start = false);
+  ErrorCode PlaceBid(Bid const &bid);
+  ErrorCode AddItem(Item const &item);
+  ErrorCode ShowAuctionResult();
+  ErrorCode Reset();
 
 private:
+  struct Edge
+  {
+    std::size_t bid;              ///< The index of the neighbouring bid
+    Value       item_coupling;    ///< The coupling due to the items shared by both bids
+    bool        exclusive{false};  ///< Signal that one of the bids excludes the other
+  };
+
+  using Edges      = std::vector<Edge>;
+  using Graph      = std::vector<Edges>;
+  using Activation = std::vector<std::uint32_t>;
+  using BidIndices = std::vector<std::size_t>;
+
+  void  EnsureGraph();
+  void  AddBidToGraph(std::size_t index);
+  Value Coupling(Edge const &edge) const;
+  Value Benefit(Activation const &active) const;
+  Value FlipDelta(std::size_t n) const;
+
   // bids on binary vector
-  fetch::math::Tensor<Value>         couplings_;
-  fetch::math::Tensor<Value>         local_fields_;
-  fetch::math::Tensor<std::uint32_t> active_;
-  fetch::math::Tensor<std::uint32_t> prev_active_;
+  Graph              graph_;         ///< The adjacency lists of the conflicting bids
+  std::vector<Value> local_fields_;  ///< The release value of each bid
+  Value              max_local_field_{std::numeric_limits<Value>::lowest()};
+  Activation         active_;
 
-  Value                              best_value_;
-  fetch::math::Tensor<std::uint32_t> best_active_;
+  std::unordered_map<ItemId, BidIndices>  item_bids_;    ///< The bids on each item
+  std::unordered_map<AgentId, BidIndices> bidder_bids_;  ///< The bids of each bidder
+  std::unordered_map<BidId, BidIndices>   bid_indices_;  ///< The bids with each bid id
+  std::unordered_map<BidId, BidIndices>   excluded_by_;  ///< The bids excluding each bid id
 
-  std::uint32_t max_flips_ = std::numeric_limits<std::uint32_t>::max();
+  Value      best_value_;
+  Activation best_active_;
 
-  bool graph_built_ = false;
+  std::uint32_t max_flips_ = std::numeric_limits<std::uint32_t>::max();
 
   void SelectWinners() override;
 };
@@ -31,6 +31,34 @@ constexpr Value   DEFAULT_ITEM_MAX_BID    = std::numeric_limits<Value>::min();
 constexpr Value   DEFAULT_ITEM_SELL_PRICE = std::numeric_limits<Value>::min();
 constexpr AgentId DEFAULT_ITEM_WINNER     = std::numeric_limits<AgentId>::max();
 
+/**
+ * The two highest bids on an item, maintained as the bids are placed so that single item auctions
+ * can be cleared without scanning all of the bids again. Ties are won by the earlier bid.
+ */
+struct TopBids
+{
+  std::size_t count  = 0;                    ///< The number of bids seen
+  AgentId     bidder = DEFAULT_ITEM_WINNER;  ///< The bidder of the highest bid
+  Value       first  = 0;                    ///< The highest price
+  Value       second = 0;                    ///< The second highest price
+
+  void Add(AgentId bid_bidder, Value price)
+  {
+    if ((count == 0) || (price > first))
+    {
+      second = first;
+      first  = price;
+      bidder = bid_bidder;
+    }
+    else if ((count == 1) || (price > second))
+    {
+      second = price;
+    }
+
+    ++count;
+  }
+};
+
 /**
  * An item in the auction which may be bid upon
  */
@@ -52,6 +80,7 @@ public:
   Value sell_price = DEFAULT_ITEM_SELL_PRICE;
 
   std::vector<Bid> bids{};
+  TopBids          top_bids{};
 
   std::uint32_t bid_count = 0;
   BidId         winner    = DEFAULT_ITEM_WINNER;
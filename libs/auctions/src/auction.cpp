@@ -80,7 +80,9 @@ ErrorCode Auction::PlaceBid(Bid bid)
     bids_.push_back(bid);
     for (std::size_t j = 0; j < bid.item_ids().size(); ++j)
     {
-      items_[bid.item_ids()[j]].bids.push_back(bid);
+      auto &item = items_[bid.item_ids()[j]];
+      item.bids.push_back(bid);
+      item.top_bids.Add(bid.bidder, bid.price);
 
       // count of how many times this bidder has bid on this item
       IncrementBidCount(bid.bidder, bid.item_ids()[j]);
@@ -17,56 +17,92 @@
 //------------------------------------------------------------------------------
 
 #include "auctions/combinatorial_auction.hpp"
-#include "math/matrix_operations.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
 
 namespace fetch {
 namespace auctions {
 
 /**
- * adding new items automatically sets graph built back to false. This is useful if items and bids
- * are added, some mining takes place, and then more items are added later
+ * adds an item to the auction. Bids can only be placed on items which are already in the auction,
+ * therefore new items do not affect the existing graph
  * @param item
  * @return
  */
 ErrorCode CombinatorialAuction::AddItem(Item const &item)
 {
-  ErrorCode ec = Auction::AddItem(item);
+  return Auction::AddItem(item);
+}
+
+/**
+ * places a bid and adds it to the graph, linking it to the existing bids it conflicts with. This is
+ * useful if bids are added, some mining takes place, and then more bids are added later
+ * @param bid
+ * @return
+ */
+ErrorCode CombinatorialAuction::PlaceBid(Bid const &bid)
+{
+  ErrorCode ec = Auction::PlaceBid(bid);
   if (ec == fetch::auctions::ErrorCode::SUCCESS)
   {
-    graph_built_ = false;
+    EnsureGraph();
   }
   return ec;
 }
 
 /**
- * adding new items automatically sets graph built back to false. This is useful if items and bids
- * are added, some mining takes place, and then more bids are added later
- * @param item
+ * resets the auction, clearing the graph along with the items and bids
  * @return
  */
-ErrorCode CombinatorialAuction::PlaceBid(Bid const &bid)
+ErrorCode CombinatorialAuction::Reset()
 {
-  ErrorCode ec = Auction::PlaceBid(bid);
+  ErrorCode ec = Auction::Reset();
   if (ec == fetch::auctions::ErrorCode::SUCCESS)
   {
-    graph_built_ = false;
+    BuildGraph();
+
+    best_value_ = std::numeric_limits<Value>::lowest();
+    best_active_.clear();
   }
   return ec;
 }
 
 /**
  * mining function for finding better solutions
+ * @param random_seed  the seed of the annealing
+ * @param run_time  the number of annealing sweeps
+ * @param warm_start  start from the best assignment found so far, rather than a random one
  */
-void CombinatorialAuction::Mine(std::size_t random_seed, std::size_t run_time)
+void CombinatorialAuction::Mine(std::size_t random_seed, std::size_t run_time, bool warm_start)
 {
   auction_valid_ = AuctionState::MINING;
   fetch::random::LaggedFibonacciGenerator<> rng(random_seed);
-  BuildGraph();
+  EnsureGraph();
 
-  for (std::size_t j = 0; j < active_.size(); ++j)
+  std::size_t const num_bids = bids_.size();
+  if (num_bids == 0)
+  {
+    return;
+  }
+
+  // bids placed since the previous round are not part of the best assignment, and the value of the
+  // assignment may have changed with the graph
+  best_active_.resize(num_bids, 0);
+  best_value_ = Benefit(best_active_);
+
+  if (warm_start)
+  {
+    active_ = best_active_;
+  }
+  else
   {
-    RandomInt val = (rng() >> 17) & 1;
-    active_[j]    = static_cast<std::uint32_t>(val);
+    for (std::size_t j = 0; j < num_bids; ++j)
+    {
+      RandomInt val = (rng() >> 17) & 1;
+      active_[j]    = static_cast<std::uint32_t>(val);
+    }
   }
 
   // simulated annealing
@@ -76,37 +112,37 @@ void CombinatorialAuction::Mine(std::size_t random_seed, std::size_t run_time)
   Value beta       = beta_start;
   Value prev_reward, new_reward, de;
 
-  std::size_t rejected = 0;
+  std::vector<std::size_t> flipped{};
 
   for (std::size_t i = 0; i < run_time; ++i)
   {
     std::cout << "mining run: " << i << std::endl;
-    for (std::size_t j = 0; j < bids_.size(); ++j)
+
+    // the reward is updated incrementally for each flip, recalculate it once per sweep so that
+    // rounding errors do not accumulate
+    Value reward = Benefit(active_);
+
+    for (std::size_t j = 0; j < num_bids; ++j)
     {
-      prev_active_ = active_.Copy();
-      prev_reward  = TotalBenefit();
+      prev_reward = reward;
+      flipped.clear();
 
       RandomInt nn = 1 + ((rng() >> 17) % max_flips_);
       for (RandomInt k = 0; k < nn; ++k)
       {
-        RandomInt n = (rng() >> 17) % bids_.size();
+        RandomInt n = (rng() >> 17) % num_bids;
 
-        if (active_[n] == 1)
-        {
-          active_[n] = 0;
-        }
-        else
-        {
-          active_[n] = 1;
-        }
+        reward += FlipDelta(n);
+        active_[n] ^= 1u;
+        flipped.push_back(n);
       }
 
-      new_reward = TotalBenefit();
+      new_reward = reward;
 
       // record best iteration
       if (new_reward > best_value_)
       {
-        best_active_ = active_.Copy();
+        best_active_ = active_;
         best_value_  = new_reward;
       }
 
@@ -116,8 +152,12 @@ void CombinatorialAuction::Mine(std::size_t random_seed, std::size_t run_time)
       Value threshold = std::exp(-beta * de);  // TODO(tfr): use exponential approximation
       if (ran_val >= threshold)
       {
-        active_.Copy(prev_active_);
-        rejected += 1;
+        for (auto it = flipped.rbegin(); it != flipped.rend(); ++it)
+        {
+          active_[*it] ^= 1u;
+        }
+
+        reward = prev_reward;
       }
     }
 
@@ -128,18 +168,43 @@ void CombinatorialAuction::Mine(std::size_t random_seed, std::size_t run_time)
 
 std::uint32_t CombinatorialAuction::Active(std::size_t n)
 {
-  assert(graph_built_);
+  assert(n < active_.size());
   return active_[n];
 }
 
 fetch::math::Tensor<Value> CombinatorialAuction::LocalFields()
 {
-  return local_fields_;
+  EnsureGraph();
+
+  fetch::math::Tensor<Value> local_fields(local_fields_.size());
+  for (std::size_t i = 0; i < local_fields_.size(); ++i)
+  {
+    local_fields[i] = local_fields_[i];
+  }
+
+  return local_fields;
 }
 
+/**
+ * builds the dense matrix of the couplings between the bids
+ * @return
+ */
 fetch::math::Tensor<Value> CombinatorialAuction::Couplings()
 {
-  return couplings_;
+  EnsureGraph();
+
+  fetch::math::Tensor<Value> couplings({graph_.size(), graph_.size()});
+  couplings.Fill(Value(0));
+
+  for (std::size_t i = 0; i < graph_.size(); ++i)
+  {
+    for (auto const &edge : graph_[i])
+    {
+      couplings.At(i, edge.bid) = Coupling(edge);
+    }
+  }
+
+  return couplings;
 }
 
 ErrorCode CombinatorialAuction::Execute()
@@ -161,136 +226,236 @@ ErrorCode CombinatorialAuction::Execute()
  */
 Value CombinatorialAuction::TotalBenefit()
 {
-  assert(graph_built_);
+  EnsureGraph();
+  return Benefit(active_);
+}
+
+void CombinatorialAuction::SelectBid(std::size_t const &bid)
+{
+  EnsureGraph();
 
-  Value         reward = 0;
-  std::uint32_t a1 = 0, a2 = 0;
-  for (std::size_t i = 0; i < bids_.size(); ++i)
+  for (auto const &edge : graph_[bid])
   {
-    a1 = active_[i];
-    reward += a1 * local_fields_[i];
-
-    for (std::size_t j = 0; j < bids_.size(); ++j)
+    if (Coupling(edge) != 0)
     {
-      a2 = active_[j];
-      reward += a1 * a2 * couplings_.At(j, i);
+      active_[edge.bid] = 0;
     }
   }
 
-  return reward;
+  active_[bid] = 1;
 }
 
-void CombinatorialAuction::SelectBid(std::size_t const &bid)
+/**
+ * builds the graph from all the bids in the auction
+ */
+void CombinatorialAuction::BuildGraph()
 {
-  if (active_.size() != bids_.size())
+  graph_.clear();
+  local_fields_.clear();
+  max_local_field_ = std::numeric_limits<Value>::lowest();
+  active_.clear();
+
+  item_bids_.clear();
+  bidder_bids_.clear();
+  bid_indices_.clear();
+  excluded_by_.clear();
+
+  EnsureGraph();
+}
+
+/**
+ * adds any bids which are not yet part of the graph
+ */
+void CombinatorialAuction::EnsureGraph()
+{
+  if (graph_.size() > bids_.size())
   {
-    active_ = fetch::math::Tensor<std::uint32_t>(bids_.size());
+    BuildGraph();
+    return;
   }
 
-  for (std::size_t j = 0; j < bids_.size(); ++j)
+  for (std::size_t i = graph_.size(); i < bids_.size(); ++i)
   {
-    if (couplings_.At(j, bid) != 0)
-    {
-      active_[j] = 0;
-    }
+    AddBidToGraph(i);
   }
 
-  active_[bid] = 1;
+  active_.resize(bids_.size(), 0);
 }
 
 /**
- * couplings_ = Sum(Bi + Bj) + delta
+ * adds a bid to the graph. The local field of the bid is its release value:
+ * local_field = bid_price - Sum(items.min_price)
+ * and the bid is coupled to each of the existing bids which it conflicts with:
+ * coupling = -(Sum(Bi + Bj) over the shared items + exclusive_bid_penalty)
+ * @param index  the index of the bid
  */
-void CombinatorialAuction::BuildGraph()
+void CombinatorialAuction::AddBidToGraph(std::size_t index)
 {
-  couplings_    = fetch::math::Tensor<Value>({bids_.size(), bids_.size()});
-  local_fields_ = fetch::math::Tensor<Value>(bids_.size());
-  active_       = fetch::math::Tensor<std::uint32_t>(bids_.size());
-  local_fields_.Fill(Value(0));
-  active_.Fill(std::uint32_t(0));
-
-  // check for any cases where bids specify to 'exclude all' and set up the relevant 'excludes'
-  // vector
-  for (std::size_t j = 0; j < bids_.size(); ++j)
+  assert(index == graph_.size());
+
+  auto const &bid   = bids_[index];
+  auto const  items = bid.item_ids();
+
+  // only bids with positive local fields can be accepted
+  Value local_field = bid.price;
+  for (auto const &item_id : items)
   {
-    if (bids_[j].exclude_all)
+    auto const it = items_.find(item_id);
+    if (it != items_.end())
     {
-      // get all bids made by this bidder (except current bid)
-      std::vector<BidId> all_bids{};
-      for (std::size_t k = 0; k < bids_.size(); ++k)
-      {
-        if (!(j == k) && (bids_[k].bidder == bids_[j].bidder))
-        {
-          all_bids.emplace_back(bids_[k].id);
-        }
-      }
+      local_field -= it->second.min_price;
+    }
+  }
+
+  local_fields_.push_back(local_field);
+  max_local_field_ = std::max(max_local_field_, local_field);
+
+  // collect the edges to the existing bids (ordered, so that the graph is deterministic)
+  std::map<std::size_t, Edge> edges{};
+
+  auto const mark_exclusive = [&edges, index](std::size_t other) {
+    if (other != index)
+    {
+      auto &edge     = edges[other];
+      edge.bid       = other;
+      edge.exclusive = true;
+    }
+  };
+
+  // bids sharing items
+  for (auto const &item_id : items)
+  {
+    if (items_.find(item_id) == items_.end())
+    {
+      continue;
+    }
 
-      bids_[j].excludes = all_bids;
+    for (auto const other : item_bids_[item_id])
+    {
+      auto &edge = edges[other];
+      edge.bid   = other;
+      edge.item_coupling += bid.price + bids_[other].price;
+    }
+  }
+
+  // bids excluded by this bid and bids which exclude this bid
+  for (auto const &excluded_id : bid.excludes)
+  {
+    auto const it = bid_indices_.find(excluded_id);
+    if (it != bid_indices_.end())
+    {
+      std::for_each(it->second.begin(), it->second.end(), mark_exclusive);
     }
   }
 
-  // set local fields according to the following equation:
-  // local_fields_ = bid_price - Sum(items.min_price)
-  // thus local_fields_ represents the release value due to a bid
-  // and only bids with positive local_fields can be accepted
-  for (std::size_t i = 0; i < bids_.size(); ++i)
+  auto const excluded_it = excluded_by_.find(bid.id);
+  if (excluded_it != excluded_by_.end())
   {
+    std::for_each(excluded_it->second.begin(), excluded_it->second.end(), mark_exclusive);
+  }
 
-    local_fields_[i] = static_cast<Value>(bids_[i].price);
-    couplings_.Set(i, i, 0);
-    for (auto &cur_item : items_)
+  // bids which specify to 'exclude all' exclude all the other bids of the same bidder
+  for (auto const other : bidder_bids_[bid.bidder])
+  {
+    if (bid.exclude_all || bids_[other].exclude_all)
     {
-      for (std::size_t j = 0; j < bids_[i].item_ids().size(); ++j)
-      {
-        if (bids_[i].item_ids()[j] == cur_item.second.id)
-        {
-          local_fields_[i] -= cur_item.second.min_price;
-        }
-      }
+      mark_exclusive(other);
+    }
+  }
+
+  // register the bid in the lookups
+  for (auto const &item_id : items)
+  {
+    if (items_.find(item_id) != items_.end())
+    {
+      item_bids_[item_id].push_back(index);
     }
   }
 
-  // Assign Couplings
-  for (std::size_t i = 0; i < bids_.size(); ++i)
+  for (auto const &excluded_id : bid.excludes)
   {
+    excluded_by_[excluded_id].push_back(index);
+  }
 
-    Value max_local_fields_;
-    max_local_fields_           = fetch::math::Max(local_fields_);
-    Value exclusive_bid_penalty = 2 * max_local_fields_;
+  bid_indices_[bid.id].push_back(index);
+  bidder_bids_[bid.bidder].push_back(index);
+
+  // finally add the edges in both directions
+  graph_.emplace_back();
+  for (auto const &element : edges)
+  {
+    Edge const &edge = element.second;
 
-    // next set couplings strengths
-    for (std::size_t j = i + 1; j < bids_.size(); ++j)
+    graph_[index].push_back(edge);
+    graph_[edge.bid].push_back(Edge{index, edge.item_coupling, edge.exclusive});
+  }
+}
+
+/**
+ * gets the coupling of an edge. Exclusive bid combinations are penalised relative to the largest
+ * local field, which can change as bids are added, so the penalty is applied here
+ * @param edge
+ * @return
+ */
+Value CombinatorialAuction::Coupling(Edge const &edge) const
+{
+  Value coupling = edge.item_coupling;
+
+  if (edge.exclusive)
+  {
+    coupling += 2 * max_local_field_;
+  }
+
+  return -coupling;
+}
+
+/**
+ * calculates the benefit of an assignment of the bids
+ * @param active  the assignment
+ * @return
+ */
+Value CombinatorialAuction::Benefit(Activation const &active) const
+{
+  Value reward = 0;
+  for (std::size_t i = 0; i < graph_.size(); ++i)
+  {
+    if (active[i] == 0)
     {
-      Value coupling = 0;
+      continue;
+    }
 
-      // penalize exclusive bid combinations
-      for (std::size_t k = 0; k < bids_[j].excludes.size(); ++k)
-      {
-        if (bids_[j].excludes[k] == bids_[i].id)
-        {
-          coupling = exclusive_bid_penalty;
-        }
-      }
+    reward += local_fields_[i];
 
-      for (auto const &itm : items_)
+    for (auto const &edge : graph_[i])
+    {
+      if (active[edge.bid] != 0)
       {
-        for (auto const &itm1 : bids_[i].item_ids())
-        {
-          for (auto const &itm2 : bids_[j].item_ids())
-          {
-            if ((itm.first == itm1) && (itm.first == itm2))
-            {
-              coupling += (bids_[i].price + bids_[j].price);
-            }
-          }
-        }
+        reward += Coupling(edge);
       }
+    }
+  }
 
-      couplings_.At(j, i) = couplings_.At(i, j) = -coupling;
+  return reward;
+}
+
+/**
+ * calculates the change in the total benefit if the specified bid was flipped
+ * @param n  the index of the bid
+ * @return
+ */
+Value CombinatorialAuction::FlipDelta(std::size_t n) const
+{
+  // each coupling is counted in both directions by the total benefit
+  Value field = local_fields_[n];
+  for (auto const &edge : graph_[n])
+  {
+    if (active_[edge.bid] != 0)
+    {
+      field += 2 * Coupling(edge);
     }
   }
 
-  graph_built_ = true;
+  return (active_[n] != 0) ? -field : field;
 }
 
 /**
@@ -299,8 +464,7 @@ void CombinatorialAuction::BuildGraph()
 void CombinatorialAuction::SelectWinners()
 {
   // assign all item winners according to active bids
-  std::vector<BidId> ret{};
-  for (std::size_t j = 0; j < active_.size(); ++j)
+  for (std::size_t j = 0; j < best_active_.size(); ++j)
   {
     if (best_active_[j] == 1)
     {
@@ -57,18 +57,17 @@ ErrorCode FirstPriceAuction::Execute()
  */
 void FirstPriceAuction::SelectWinners()
 {
-  // iterate through all items in auction
+  // the top bids are tracked as the bids are placed, so clearing only visits each item once
   for (auto &cur_item_it : items_)
   {
-    // find highest bid for this item and set winner
-    for (auto &cur_bid_it : cur_item_it.second.bids)
+    auto &      item     = cur_item_it.second;
+    auto const &top_bids = item.top_bids;
+
+    if (top_bids.count != 0)
     {
-      if (cur_bid_it.price > cur_item_it.second.max_bid)
-      {
-        cur_item_it.second.winner     = cur_bid_it.bidder;
-        cur_item_it.second.max_bid    = cur_bid_it.price;
-        cur_item_it.second.sell_price = cur_bid_it.price;
-      }
+      item.winner     = top_bids.bidder;
+      item.max_bid    = top_bids.first;
+      item.sell_price = top_bids.first;
     }
   }
 }
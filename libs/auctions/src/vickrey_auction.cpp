@@ -44,100 +44,27 @@ ErrorCode VickreyAuction::Execute()
 }
 
 /**
- * finds the highest bid on each item
+ * finds the highest bid on each item, which is sold at the price of the second highest bid
  */
 void VickreyAuction::SelectWinners()
 {
-  // iterate through all items in auction
+  // the top bids are tracked as the bids are placed, so clearing only visits each item once
   for (auto &cur_item_it : items_)
   {
-    // handle special cases of 0, 1, and 2 bids
-    std::size_t loop_count = 0;
+    auto &      item     = cur_item_it.second;
+    auto const &top_bids = item.top_bids;
 
-    // iterate through bids on this item
-    if (cur_item_it.second.bids.size() > 2)
-    {
-      for (auto &cur_bid_it : cur_item_it.second.bids)
-      {
-        if (loop_count == 0)
-        {
-          cur_item_it.second.winner     = cur_bid_it.bidder;
-          cur_item_it.second.max_bid    = cur_bid_it.price;
-          cur_item_it.second.sell_price = cur_bid_it.price;
-          ++loop_count;
-        }
-        else if (loop_count == 1)
-        {
-          if (cur_bid_it.price > cur_item_it.second.max_bid)
-          {
-            cur_item_it.second.winner  = cur_bid_it.bidder;
-            cur_item_it.second.max_bid = cur_bid_it.price;
-          }
-          else
-          {
-            cur_item_it.second.sell_price = cur_bid_it.price;
-          }
-          ++loop_count;
-        }
-        else
-        {
-          if (cur_bid_it.price > cur_item_it.second.max_bid)
-          {
-            cur_item_it.second.winner     = cur_bid_it.bidder;
-            cur_item_it.second.sell_price = cur_item_it.second.max_bid;
-            cur_item_it.second.max_bid    = cur_bid_it.price;
-          }
-          else if (cur_bid_it.price > cur_item_it.second.max_bid)
-          {
-            cur_item_it.second.sell_price = cur_bid_it.price;
-          }
-        }
-      }
-    }
-
-    // only 2 bids
-    else if (cur_item_it.second.bids.size() == 2)
+    // no bids!
+    if (top_bids.count == 0)
     {
-      for (auto &cur_bid_it : cur_item_it.second.bids)
-      {
-        if (loop_count == 0)
-        {
-          // just using this to store the value for now
-          cur_item_it.second.sell_price = cur_bid_it.price;
-
-          cur_item_it.second.winner = cur_bid_it.bidder;
-        }
-        else if (loop_count == 1)
-        {
-          if (cur_bid_it.price > cur_item_it.second.sell_price)
-          {
-            cur_item_it.second.winner  = cur_bid_it.bidder;
-            cur_item_it.second.max_bid = cur_bid_it.price;
-          }
-          else
-          {
-            cur_item_it.second.sell_price = cur_bid_it.price;
-          }
-        }
-        ++loop_count;
-      }
+      continue;
     }
 
-    // only 1 bid
-    else if (cur_item_it.second.bids.size() == 1)
-    {
-      for (auto &cur_bid_it : cur_item_it.second.bids)
-      {
-        cur_item_it.second.winner     = cur_bid_it.bidder;
-        cur_item_it.second.sell_price = cur_bid_it.price;
-        cur_item_it.second.max_bid    = cur_bid_it.price;
-      }
-    }
+    item.winner  = top_bids.bidder;
+    item.max_bid = top_bids.first;
 
-    // no bids!
-    else
-    {
-    }
+    // with a single bid the item is sold at the bid price
+    item.sell_price = (top_bids.count > 1) ? top_bids.second : top_bids.first;
   }
 }
 
@@ -139,3 +139,95 @@ TEST(combinatorial_auction, many_bid_many_item_auction)
   // should accept one but not both of these bids since they're exclusive
   ASSERT_TRUE(((ca.Active(4) == 0) && (ca.Active(5) == 0)) || (ca.Active(4) != ca.Active(5)));
 }
+
+TEST(combinatorial_auction, incremental_graph_matches_rebuilt_graph)
+{
+  CombinatorialAuction ca = CombinatorialAuction();
+
+  AgentId seller_id = 990;
+  for (ItemId item_id = 0; item_id < 4; ++item_id)
+  {
+    ASSERT_EQ(ca.AddItem(Item(item_id, seller_id, 1)), ErrorCode::SUCCESS);
+  }
+
+  Bid bid1(0, {0, 1}, 10, 0);
+  Bid bid2(1, {1, 2}, 12, 1);
+  Bid bid3(2, {3}, 5, 0);
+  Bid bid4(3, {0, 3}, 40, 2);
+  bid1.exclude_all = true;
+  bid4.excludes.emplace_back(bid2.id);
+
+  ASSERT_EQ(ca.PlaceBid(bid1), ErrorCode::SUCCESS);
+  ASSERT_EQ(ca.PlaceBid(bid2), ErrorCode::SUCCESS);
+
+  // the graph is extended as each bid is placed
+  ASSERT_EQ(ca.Couplings().shape().at(0), 2);
+
+  ASSERT_EQ(ca.PlaceBid(bid3), ErrorCode::SUCCESS);
+  ASSERT_EQ(ca.PlaceBid(bid4), ErrorCode::SUCCESS);
+
+  fetch::math::Tensor<Value> const incremental_couplings    = ca.Couplings();
+  fetch::math::Tensor<Value> const incremental_local_fields = ca.LocalFields();
+
+  ca.BuildGraph();
+  fetch::math::Tensor<Value> const couplings    = ca.Couplings();
+  fetch::math::Tensor<Value> const local_fields = ca.LocalFields();
+
+  ASSERT_EQ(couplings.shape(), incremental_couplings.shape());
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(local_fields[i], incremental_local_fields[i]);
+    for (std::size_t j = 0; j < 4; ++j)
+    {
+      EXPECT_EQ(couplings.At(i, j), incremental_couplings.At(i, j));
+      EXPECT_EQ(couplings.At(i, j), couplings.At(j, i));
+    }
+  }
+
+  // the local fields are the bid prices less the minimum prices of the items
+  EXPECT_EQ(local_fields[0], 8);
+  EXPECT_EQ(local_fields[3], 38);
+
+  // shared items couple the bids
+  EXPECT_EQ(couplings.At(0, 1), -22);
+  EXPECT_EQ(couplings.At(1, 2), 0);
+
+  // exclusive bids are penalised relative to the largest local field, in both directions
+  EXPECT_EQ(couplings.At(0, 2), -76);
+  EXPECT_EQ(couplings.At(1, 3), -76);
+}
+
+TEST(combinatorial_auction, warm_start_keeps_the_best_assignment)
+{
+  CombinatorialAuction ca = CombinatorialAuction();
+
+  AgentId seller_id = 990;
+  for (ItemId item_id = 0; item_id < 3; ++item_id)
+  {
+    ASSERT_EQ(ca.AddItem(Item(item_id, seller_id, 0)), ErrorCode::SUCCESS);
+  }
+
+  ASSERT_EQ(ca.PlaceBid(Bid(0, {0}, 10, 0)), ErrorCode::SUCCESS);
+  ASSERT_EQ(ca.PlaceBid(Bid(1, {0, 1}, 5, 1)), ErrorCode::SUCCESS);
+  ASSERT_EQ(ca.PlaceBid(Bid(2, {2}, 4, 2)), ErrorCode::SUCCESS);
+  ca.Mine(3, 20);
+
+  // continuing from the best assignment found so far
+  for (std::size_t j = 0; j < 5; ++j)
+  {
+    ca.Mine(5 + j, 10, true);
+  }
+
+  ASSERT_EQ(ca.Execute(), ErrorCode::SUCCESS);
+  for (auto const &item : ca.ShowListedItems())
+  {
+    if (item.id == 0)
+    {
+      EXPECT_EQ(item.winner, 0);
+    }
+    else if (item.id == 2)
+    {
+      EXPECT_EQ(item.winner, 2);
+    }
+  }
+}
@@ -146,6 +146,36 @@ TEST(vickrey_auction, many_bid_auction)
   ASSERT_EQ(va.items()[0].sell_price, bidders[bidders.size() - 2].funds);
 }
 
+TEST(vickrey_auction, unordered_bid_auction)
+{
+  // set up auction
+  VickreyAuction va = SetupAuction();
+
+  // add item to auction
+  ItemId    item_id   = 0;
+  AgentId   seller_id = 999;
+  Value     min_price = 7;
+  Item      item(item_id, seller_id, min_price);
+  ErrorCode err = va.AddItem(item);
+  ASSERT_EQ(err, ErrorCode::SUCCESS);
+
+  // the highest and second highest bids arrive before and in between the lower bids
+  std::vector<Value> prices{20, 5, 30, 10, 25, 15};
+  for (std::size_t j = 0; j < prices.size(); ++j)
+  {
+    Bid cur_bid(static_cast<BidId>(j), {item.id}, prices[j], static_cast<AgentId>(j));
+    err = va.PlaceBid(cur_bid);
+    ASSERT_EQ(err, ErrorCode::SUCCESS);
+  }
+
+  err = va.Execute();
+
+  ASSERT_EQ(err, ErrorCode::SUCCESS);
+  ASSERT_EQ(va.Winner(item.id), 2);
+  ASSERT_EQ(va.items()[0].max_bid, 30);
+  ASSERT_EQ(va.items()[0].sell_price, 25);
+}
+
 TEST(vickrey_auction, many_bid_many_item_auction)
 {
   ErrorCode err;
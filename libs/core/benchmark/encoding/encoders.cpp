@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/byte_array.hpp"
+#include "core/byte_array/decoders.hpp"
+#include "core/byte_array/encoders.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+
+using fetch::byte_array::ByteArray;
+using fetch::byte_array::ConstByteArray;
+
+ConstByteArray GenerateInput(std::size_t size)
+{
+  ByteArray input;
+  input.Resize(size);
+
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    input[i] = static_cast<uint8_t>((i * 31u) + 7u);
+  }
+
+  return {input};
+}
+
+void ToHex(benchmark::State &state)
+{
+  ConstByteArray const input = GenerateInput(static_cast<std::size_t>(state.range(0)));
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(fetch::byte_array::ToHex(input));
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void FromHex(benchmark::State &state)
+{
+  ConstByteArray const input =
+      fetch::byte_array::ToHex(GenerateInput(static_cast<std::size_t>(state.range(0))));
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(fetch::byte_array::FromHex(input));
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void ToBase64(benchmark::State &state)
+{
+  ConstByteArray const input = GenerateInput(static_cast<std::size_t>(state.range(0)));
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(fetch::byte_array::ToBase64(input));
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void FromBase64(benchmark::State &state)
+{
+  ConstByteArray const input =
+      fetch::byte_array::ToBase64(GenerateInput(static_cast<std::size_t>(state.range(0))));
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(fetch::byte_array::FromBase64(input));
+  }
+
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+// digest and public key sized inputs, as well as whole payloads
+BENCHMARK(ToHex)->Arg(32)->Arg(64)->Arg(4096)->Arg(1 << 20);
+BENCHMARK(FromHex)->Arg(32)->Arg(64)->Arg(4096)->Arg(1 << 20);
+BENCHMARK(ToBase64)->Arg(32)->Arg(64)->Arg(4096)->Arg(1 << 20);
+BENCHMARK(FromBase64)->Arg(32)->Arg(64)->Arg(4096)->Arg(1 << 20);
@@ -21,6 +21,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <ostream>
 #include <type_traits>
@@ -46,12 +47,46 @@ public:
 
   ByteArray() = default;
 
+  // the contents of mutable arrays are never stored inline, so that copies share them
+  ByteArray(char const *str)
+    : ByteArray{reinterpret_cast<uint8_t const *>(str), str ? std::strlen(str) : 0}
+  {}
+
+  ByteArray(container_type const *const data, std::size_t const &size)
+  {
+    if (size > 0)
+    {
+      assert(data != nullptr);
+      Resize(size);
+      WriteBytes(data, size);
+    }
+  }
+
+  ByteArray(std::string const &s)
+    : ByteArray(reinterpret_cast<uint8_t const *>(s.data()), s.size())
+  {}
+
   ByteArray(super_type const &other)
-    : super_type(other.Copy())
+    : ByteArray(other.pointer(), other.size())
   {}
   ByteArray(super_type &&other)
-    : super_type(other.IsUnique() ? std::move(other) : other.Copy())
-  {}
+  {
+    if (other.IsUnique() && !other.IsInline())
+    {
+      // the shared array is not referenced elsewhere, so its contents can be taken over
+      super_type::operator=(std::move(other));
+    }
+    else
+    {
+      super_type::operator=(ByteArray{static_cast<super_type const &>(other)});
+
+      if (other.IsInline())
+      {
+        // an inline array has a single owner, like a unique one it is left empty after the move
+        other = super_type{};
+      }
+    }
+  }
 
   self_type SubArray(std::size_t const &start, std::size_t length = std::size_t(-1)) const
   {
@@ -40,6 +40,16 @@ inline void Deserialize(T &, byte_array::ConstByteArray &);
 
 namespace byte_array {
 
+/**
+ * An immutable array of bytes. The contents are held in a reference counted shared array so that
+ * copies and sub arrays are cheap views of the same memory.
+ *
+ * Small arrays (up to INLINE_CAPACITY bytes, for example digests and identifiers) which are copied
+ * into a ConstByteArray are instead stored inline in the object. These never allocate and their
+ * copies are plain memory copies rather than reference count updates. Since the contents are
+ * immutable either representation has the same value semantics. The mutable ByteArray always uses
+ * the shared representation, so that its copies continue to refer to the same memory.
+ */
 class ConstByteArray
 {
 public:
@@ -52,6 +62,8 @@ public:
     NPOS = uint64_t(-1)
   };
 
+  static constexpr std::size_t INLINE_CAPACITY = 48;
+
   ConstByteArray() = default;
 
   explicit ConstByteArray(std::size_t const &n)
@@ -68,9 +80,17 @@ public:
     if (size > 0)
     {
       assert(data != nullptr);
-      Reserve(size);
-      Resize(size);
-      WriteBytes(data, size);
+
+      if (size <= INLINE_CAPACITY)
+      {
+        SetInline(data, size);
+      }
+      else
+      {
+        Reserve(size);
+        Resize(size);
+        WriteBytes(data, size);
+      }
     }
   }
 
@@ -88,21 +108,105 @@ public:
     : ConstByteArray(reinterpret_cast<uint8_t const *>(s.data()), s.size())
   {}
 
-  ConstByteArray(self_type const &other) = default;
-  ConstByteArray(self_type &&other)      = default;
+  /**
+   * Create a view of a shared region of memory without copying it. The contents must not be
+   * modified through the resulting array.
+   *
+   * @param data The shared region
+   */
+  explicit ConstByteArray(shared_array_type data)
+    : data_(std::move(data))
+    , length_(data_.size())
+    , arr_pointer_(data_.pointer())
+  {}
+
+  ConstByteArray(self_type const &other)
+    : data_(other.data_)
+    , start_(other.start_)
+    , length_(other.length_)
+    , arr_pointer_(other.arr_pointer_)
+  {
+    if (other.IsInline())
+    {
+      SetInline(other.arr_pointer_, other.length_);
+    }
+  }
+
+  ConstByteArray(self_type &&other)
+    : data_(std::move(other.data_))
+    , start_(other.start_)
+    , length_(other.length_)
+    , arr_pointer_(other.arr_pointer_)
+  {
+    // checked on this array, since moving the shared array swaps it with the (empty) current one
+    if (IsInline())
+    {
+      SetInline(other.arr_pointer_, other.length_);
+    }
+  }
+
   // TODO(pbukva): (private issue #229: confusion what method does without analysing implementation
   // details - absolute vs relative[against `other.start_`] size)
   ConstByteArray(self_type const &other, std::size_t const &start, std::size_t const &length)
     : data_(other.data_)
     , start_(start)
     , length_(length)
-    , arr_pointer_(data_.pointer() + start_)
+    , arr_pointer_(other.IsInline() ? nullptr : data_.pointer() + start_)
   {
-    assert(start_ + length_ <= data_.size());
+    if (other.IsInline())
+    {
+      // inline contents can not be shared, the start is relative to them (start_ is always zero)
+      assert(start + length <= other.length_);
+
+      start_ = 0;
+      SetInline(other.arr_pointer_ + start, length);
+    }
+    else
+    {
+      assert(start_ + length_ <= data_.size());
+    }
   }
 
-  ConstByteArray &operator=(ConstByteArray const &) = default;
-  ConstByteArray &operator=(ConstByteArray &&other) = default;
+  ConstByteArray &operator=(ConstByteArray const &other)
+  {
+    if (this != &other)
+    {
+      data_        = other.data_;
+      start_       = other.start_;
+      length_      = other.length_;
+      arr_pointer_ = other.arr_pointer_;
+
+      if (other.IsInline())
+      {
+        SetInline(other.arr_pointer_, other.length_);
+      }
+    }
+
+    return *this;
+  }
+
+  ConstByteArray &operator=(ConstByteArray &&other)
+  {
+    if (this != &other)
+    {
+      // checked first, since moving the shared array swaps it with the current one
+      if (other.IsInline())
+      {
+        data_  = shared_array_type{};
+        start_ = 0;
+        SetInline(other.arr_pointer_, other.length_);
+      }
+      else
+      {
+        data_        = std::move(other.data_);
+        start_       = other.start_;
+        length_      = other.length_;
+        arr_pointer_ = other.arr_pointer_;
+      }
+    }
+
+    return *this;
+  }
 
   ConstByteArray Copy() const
   {
@@ -186,7 +290,7 @@ public:
 
   std::size_t capacity() const
   {
-    return data_.size();
+    return IsInline() ? length_ : data_.size();
   }
 
   bool operator==(char const *str) const
@@ -212,6 +316,14 @@ public:
 public:
   self_type SubArray(std::size_t const &start, std::size_t length = std::size_t(-1)) const
   {
+    length = std::min(length, length_ - start);
+
+    // small ranges are copied, rather than keeping the whole of the array alive
+    if (length <= INLINE_CAPACITY)
+    {
+      return self_type{arr_pointer_ + start, length};
+    }
+
     return SubArray<self_type>(start, length);
   }
 
@@ -293,20 +405,42 @@ public:
   // Non-const functions go here
   void FromByteArray(self_type const &other, std::size_t const &start, std::size_t length)
   {
-    data_        = other.data_;
-    start_       = other.start_ + start;
-    length_      = length;
-    arr_pointer_ = data_.pointer() + start_;
+    if (other.IsInline())
+    {
+      assert(start + length <= other.length_);
+
+      data_  = shared_array_type{};
+      start_ = 0;
+      SetInline(other.arr_pointer_ + start, length);
+    }
+    else
+    {
+      data_        = other.data_;
+      start_       = other.start_ + start;
+      length_      = length;
+      arr_pointer_ = data_.pointer() + start_;
+    }
   }
 
   bool IsUnique() const noexcept
   {
-    return data_.IsUnique();
+    return IsInline() || data_.IsUnique();
   }
 
+  /**
+   * @return The number of arrays referring to the contents, which is always one for inline ones
+   */
   uint64_t UseCount() const noexcept
   {
-    return data_.UseCount();
+    return IsInline() ? 1u : data_.UseCount();
+  }
+
+  /**
+   * @return true if the contents are stored inline in this object, otherwise false
+   */
+  bool IsInline() const noexcept
+  {
+    return (arr_pointer_ != nullptr) && (data_.pointer() == nullptr);
   }
 
 protected:
@@ -402,18 +536,25 @@ protected:
       break;
     }
 
-    if (new_capacity_for_reserve <= data_.size())
+    std::size_t const current_capacity = capacity();
+    if (new_capacity_for_reserve <= current_capacity)
     {
       return;
     }
 
     assert(new_capacity_for_reserve != 0);
 
+    // inline contents are moved to the shared array (start_ is always zero for them)
+    container_type const *current = IsInline() ? arr_pointer_ : data_.pointer();
+
     shared_array_type newdata(new_capacity_for_reserve);
-    std::memcpy(newdata.pointer(), data_.pointer(), data_.size());
+    if (current_capacity > 0)
+    {
+      std::memcpy(newdata.pointer(), current, current_capacity);
+    }
     if (zero_reserved_space)
     {
-      newdata.SetZeroAfter(data_.size());
+      newdata.SetZeroAfter(current_capacity);
     }
 
     data_        = newdata;
@@ -427,7 +568,7 @@ protected:
 
   char *char_pointer()
   {
-    return reinterpret_cast<char *>(data_.pointer());
+    return reinterpret_cast<char *>(IsInline() ? arr_pointer_ : data_.pointer());
   }
 
   template <typename... Arg>
@@ -477,12 +618,30 @@ private:
     std::memcpy(pointer() + acc_size, &other, 1u);
   }
 
+  void SetInline(container_type const *data, std::size_t size)
+  {
+    assert(size <= INLINE_CAPACITY);
+
+    if (size > 0)
+    {
+      std::memmove(inline_, data, size);
+      arr_pointer_ = inline_;
+    }
+    else
+    {
+      arr_pointer_ = nullptr;
+    }
+
+    length_ = size;
+  }
+
   template <typename T>
   friend void fetch::serializers::Deserialize(T &serializer, ConstByteArray &s);
 
   shared_array_type data_;
   std::size_t       start_ = 0, length_ = 0;
   container_type *  arr_pointer_ = nullptr;
+  container_type    inline_[INLINE_CAPACITY];
 };
 
 inline std::ostream &operator<<(std::ostream &os, ConstByteArray const &str)
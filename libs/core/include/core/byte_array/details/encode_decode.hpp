@@ -39,6 +39,17 @@ enum
 
 uint8_t DecodeHexChar(char const &c);
 
+/// @name Base64 Kernels
+/// These use SSSE3 and must only be called if the CPU supports it. Each processes as much of the
+/// start of the input as it can and returns the number of input bytes it has consumed, leaving the
+/// rest to the scalar implementation.
+/// @{
+bool        HasBase64Ssse3Kernels();
+std::size_t EncodeBase64Ssse3(uint8_t const *src, std::size_t size, uint8_t *dest);
+std::size_t DecodeBase64Ssse3(uint8_t const *src, std::size_t size, uint8_t *dest,
+                              std::size_t dest_size);
+/// @}
+
 enum
 {
   B64_WHITESPACE = 64,
@@ -0,0 +1,359 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "meta/is_log2.hpp"
+#include "meta/type_traits.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace fetch {
+namespace core {
+
+/**
+ * Lock free, bounded, multi producer multi consumer queue
+ *
+ * Unlike the blocking `Queue` family this queue never waits: pushing onto a full queue or popping
+ * from an empty one fails immediately, leaving it to the caller to decide how to back off. Each
+ * cell carries a sequence number which tells producers and consumers whether it is ready for them,
+ * so the only shared state contended on is the pair of read / write positions.
+ *
+ * @tparam T The type of element to be stored in the queue
+ * @tparam SIZE The max size of the queue
+ */
+template <typename T, std::size_t SIZE>
+class LockFreeMPMCQueue
+{
+public:
+  static constexpr std::size_t QUEUE_LENGTH = SIZE;
+
+  using Element = T;
+
+  // Construction / Destruction
+  LockFreeMPMCQueue();
+  LockFreeMPMCQueue(LockFreeMPMCQueue const &) = delete;
+  LockFreeMPMCQueue(LockFreeMPMCQueue &&)      = delete;
+  ~LockFreeMPMCQueue()                         = default;
+
+  /// @name Queue Interaction
+  /// @{
+  template <typename U>
+  meta::EnableIfSame<T, meta::Decay<U>, bool> TryPush(U &&element);
+  bool TryPop(T &value);
+  template <typename Iterator>
+  std::size_t TryPushBulk(Iterator &begin, Iterator end);
+  std::size_t TryPopBulk(std::vector<T> &values, std::size_t max);
+  std::size_t size() const;
+  bool        empty() const;
+  /// @}
+
+  // Operators
+  LockFreeMPMCQueue &operator=(LockFreeMPMCQueue const &) = delete;
+  LockFreeMPMCQueue &operator=(LockFreeMPMCQueue &&) = delete;
+
+private:
+  static constexpr std::size_t MASK            = SIZE - 1;
+  static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+  using Position = std::atomic<std::size_t>;
+  using Padding  = char[CACHE_LINE_SIZE - sizeof(Position)];
+
+  struct Cell
+  {
+    Position sequence{0};
+    T        value{};
+  };
+
+  using Cells = std::unique_ptr<Cell[]>;
+
+  Cells    cells_;         ///< The ring of cells
+  Padding  pad0_{};        ///< Keep the positions on separate cache lines
+  Position write_pos_{0};  ///< The next position to be written
+  Padding  pad1_{};        ///< Keep the positions on separate cache lines
+  Position read_pos_{0};   ///< The next position to be read
+  Padding  pad2_{};        ///< Keep the positions on separate cache lines
+
+  // static asserts
+  static_assert(meta::IsLog2<SIZE>::value, "Queue size must be a valid power of 2");
+  static_assert(std::is_default_constructible<T>::value, "T must be default constructable");
+  static_assert(std::is_move_assignable<T>::value, "T must have move assignment");
+};
+
+template <typename T, std::size_t N>
+constexpr std::size_t LockFreeMPMCQueue<T, N>::QUEUE_LENGTH;
+
+template <typename T, std::size_t N>
+LockFreeMPMCQueue<T, N>::LockFreeMPMCQueue()
+  : cells_{new Cell[N]}
+{
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * Attempt to push an element onto the queue
+ *
+ * @tparam T The type of element to be stored in the queue
+ * @tparam N The max size of the queue
+ * @tparam U The deduced type of the element, same as T after decay
+ * @param element The universal reference to the element
+ * @return true if the element was added, false if the queue is full
+ */
+template <typename T, std::size_t N>
+template <typename U>
+meta::EnableIfSame<T, meta::Decay<U>, bool> LockFreeMPMCQueue<T, N>::TryPush(U &&element)
+{
+  std::size_t position = write_pos_.load(std::memory_order_relaxed);
+
+  for (;;)
+  {
+    Cell &      cell     = cells_[position & MASK];
+    std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    auto const  delta    = static_cast<std::ptrdiff_t>(sequence - position);
+
+    if (delta == 0)
+    {
+      // the cell is free, attempt to claim it
+      if (write_pos_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+      {
+        cell.value = std::forward<U>(element);
+        cell.sequence.store(position + 1, std::memory_order_release);
+        return true;
+      }
+    }
+    else if (delta < 0)
+    {
+      // the cell has not been consumed since the last lap, the queue is full
+      return false;
+    }
+    else
+    {
+      // another producer has claimed this position
+      position = write_pos_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+/**
+ * Attempt to pop an element from the queue
+ *
+ * @tparam T The type of element to be stored in the queue
+ * @tparam N The max size of the queue
+ * @param value The reference to the value to be populated
+ * @return true if an element was extracted, false if the queue is empty
+ */
+template <typename T, std::size_t N>
+bool LockFreeMPMCQueue<T, N>::TryPop(T &value)
+{
+  std::size_t position = read_pos_.load(std::memory_order_relaxed);
+
+  for (;;)
+  {
+    Cell &      cell     = cells_[position & MASK];
+    std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    auto const  delta    = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+
+    if (delta == 0)
+    {
+      // the cell has been written, attempt to claim it
+      if (read_pos_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+      {
+        value      = std::move(cell.value);
+        cell.value = T{};
+        cell.sequence.store(position + MASK + 1, std::memory_order_release);
+        return true;
+      }
+    }
+    else if (delta < 0)
+    {
+      // the cell has not been written yet, the queue is empty
+      return false;
+    }
+    else
+    {
+      // another consumer has claimed this position
+      position = read_pos_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+/**
+ * Attempt to push a range of elements onto the queue
+ *
+ * As many of the elements as there are consecutive free cells for are claimed with a single update
+ * of the write position. The begin iterator is advanced past the elements which were pushed.
+ *
+ * @tparam T The type of element to be stored in the queue
+ * @tparam N The max size of the queue
+ * @tparam Iterator The iterator type of the range, a move iterator moves the elements
+ * @param begin The start of the range of elements, advanced past the pushed elements
+ * @param end The end of the range of elements
+ * @return The number of elements pushed, zero if the queue is full
+ */
+template <typename T, std::size_t N>
+template <typename Iterator>
+std::size_t LockFreeMPMCQueue<T, N>::TryPushBulk(Iterator &begin, Iterator end)
+{
+  auto const  requested = static_cast<std::size_t>(std::distance(begin, end));
+  std::size_t position  = write_pos_.load(std::memory_order_relaxed);
+
+  while (requested != 0)
+  {
+    // determine how many consecutive cells are free from the current position
+    std::size_t available{0};
+    bool        claimed_by_other{false};
+    while (available < requested)
+    {
+      std::size_t const target   = position + available;
+      std::size_t const sequence = cells_[target & MASK].sequence.load(std::memory_order_acquire);
+      auto const        delta    = static_cast<std::ptrdiff_t>(sequence - target);
+
+      if (delta != 0)
+      {
+        claimed_by_other = (delta > 0);
+        break;
+      }
+
+      ++available;
+    }
+
+    if (available == 0)
+    {
+      if (!claimed_by_other)
+      {
+        // the queue is full
+        return 0;
+      }
+
+      position = write_pos_.load(std::memory_order_relaxed);
+    }
+    else if (write_pos_.compare_exchange_weak(position, position + available,
+                                              std::memory_order_relaxed))
+    {
+      for (std::size_t i = 0; i < available; ++i, ++begin)
+      {
+        Cell &cell = cells_[(position + i) & MASK];
+        cell.value = *begin;
+        cell.sequence.store(position + i + 1, std::memory_order_release);
+      }
+
+      return available;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * Attempt to pop a number of elements from the queue
+ *
+ * As many of the elements as are consecutively available (up to the maximum) are claimed with a
+ * single update of the read position.
+ *
+ * @tparam T The type of element to be stored in the queue
+ * @tparam N The max size of the queue
+ * @param values The container to which the extracted elements are appended
+ * @param max The maximum number of elements to be extracted
+ * @return The number of elements extracted, zero if the queue is empty
+ */
+template <typename T, std::size_t N>
+std::size_t LockFreeMPMCQueue<T, N>::TryPopBulk(std::vector<T> &values, std::size_t max)
+{
+  std::size_t position = read_pos_.load(std::memory_order_relaxed);
+
+  while (max != 0)
+  {
+    // determine how many consecutive cells have been written from the current position
+    std::size_t available{0};
+    bool        claimed_by_other{false};
+    while (available < max)
+    {
+      std::size_t const target   = position + available;
+      std::size_t const sequence = cells_[target & MASK].sequence.load(std::memory_order_acquire);
+      auto const        delta    = static_cast<std::ptrdiff_t>(sequence - (target + 1));
+
+      if (delta != 0)
+      {
+        claimed_by_other = (delta > 0);
+        break;
+      }
+
+      ++available;
+    }
+
+    if (available == 0)
+    {
+      if (!claimed_by_other)
+      {
+        // the queue is empty
+        return 0;
+      }
+
+      position = read_pos_.load(std::memory_order_relaxed);
+    }
+    else if (read_pos_.compare_exchange_weak(position, position + available,
+                                             std::memory_order_relaxed))
+    {
+      for (std::size_t i = 0; i < available; ++i)
+      {
+        Cell &cell = cells_[(position + i) & MASK];
+        values.emplace_back(std::move(cell.value));
+        cell.value = T{};
+        cell.sequence.store(position + i + MASK + 1, std::memory_order_release);
+      }
+
+      return available;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * Get the (approximate) number of elements in the queue
+ *
+ * @return The number of elements
+ */
+template <typename T, std::size_t N>
+std::size_t LockFreeMPMCQueue<T, N>::size() const
+{
+  std::size_t const read  = read_pos_.load(std::memory_order_relaxed);
+  std::size_t const write = write_pos_.load(std::memory_order_relaxed);
+
+  return (write > read) ? (write - read) : 0;
+}
+
+/**
+ * Determine if the queue is (approximately) empty
+ *
+ * @return true if empty, otherwise false
+ */
+template <typename T, std::size_t N>
+bool LockFreeMPMCQueue<T, N>::empty() const
+{
+  return size() == 0;
+}
+
+}  // namespace core
+}  // namespace fetch
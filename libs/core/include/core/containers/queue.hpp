@@ -17,13 +17,21 @@
 //
 //------------------------------------------------------------------------------
 
+#include "core/containers/lock_free_queue.hpp"
 #include "core/mutex.hpp"
 #include "core/sync/tickets.hpp"
 #include "meta/is_log2.hpp"
 #include "meta/type_traits.hpp"
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <deque>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace fetch {
 namespace core {
@@ -63,6 +71,15 @@ public:
     function((*this)++);
   }
 
+  template <typename Function>
+  void IncrementBulk(std::size_t count, Function &&function)
+  {
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      function((*this)++);
+    }
+  }
+
   // Operators
   SingleThreadedIndex &operator=(SingleThreadedIndex const &) = delete;
   SingleThreadedIndex &operator=(SingleThreadedIndex &&) = delete;
@@ -110,6 +127,13 @@ public:
     Base::Increment(std::forward<Function>(function));
   }
 
+  template <typename Function>
+  void IncrementBulk(std::size_t count, Function &&function)
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    Base::IncrementBulk(count, std::forward<Function>(function));
+  }
+
 private:
   std::mutex lock_;
 };
@@ -148,6 +172,8 @@ public:
   template <typename U, typename R, typename P>
   meta::EnableIfSame<T, meta::Decay<U>, bool> Push(U &&element, std::size_t &count,
                                                    std::chrono::duration<R, P> const &duration);
+  template <typename Iterator>
+  void PushBulk(Iterator begin, Iterator end);
   /// @}
 
   // Operators
@@ -310,6 +336,420 @@ meta::EnableIfSame<T, meta::Decay<U>, bool> Queue<T, N, P, C>::Push(
   return true;
 }
 
+/**
+ * Push a range of elements onto the queue
+ *
+ * The elements are inserted in batches of as many as there is space for, each batch claiming the
+ * free space and the write index once. If the queue is full this function will block until the
+ * remaining elements can be added.
+ *
+ * @tparam T The type of element to be stored in the queue
+ * @tparam N The max size of the queue
+ * @tparam P The producer index type
+ * @tparam C The consumer index type
+ * @tparam Iterator The iterator type of the range, a move iterator moves the elements
+ * @param begin The start of the range of elements
+ * @param end The end of the range of elements
+ */
+template <typename T, std::size_t N, typename P, typename C>
+template <typename Iterator>
+void Queue<T, N, P, C>::PushBulk(Iterator begin, Iterator end)
+{
+  auto remaining = static_cast<std::size_t>(std::distance(begin, end));
+
+  while (remaining != 0)
+  {
+    std::size_t const claimed = write_count_.WaitBulk(remaining);
+
+    write_index_.IncrementBulk(claimed,
+                               [this, &begin](auto const index) { queue_[index] = *begin++; });
+
+    read_count_.PostBulk(claimed);
+    remaining -= claimed;
+  }
+}
+
+/**
+ * Multi Producer, Multi Consumer fixed-length blocking queue
+ *
+ * The elements are stored in a lock free ring (see `LockFreeMPMCQueue`), so producers and
+ * consumers never take a lock while the queue is neither full nor empty. When a caller has to
+ * wait it first spins on the ring, then yields, and only then parks on a condition variable. The
+ * other side only touches the condition variable when it has seen a parked waiter.
+ *
+ * @tparam T The type of element to be stored in the queue
+ * @tparam SIZE The max size of the queue
+ */
+template <typename T, std::size_t SIZE>
+class LockFreeBlockingQueue
+{
+public:
+  static constexpr std::size_t QUEUE_LENGTH = SIZE;
+
+  using Element = T;
+
+  // Construction / Destruction
+  LockFreeBlockingQueue()                              = default;
+  LockFreeBlockingQueue(LockFreeBlockingQueue const &) = delete;
+  LockFreeBlockingQueue(LockFreeBlockingQueue &&)      = delete;
+
+  /// @name Queue Interaction
+  /// @{
+  T Pop();
+  template <typename R, typename P>
+  bool Pop(T &value, std::chrono::duration<R, P> const &duration);
+  template <typename R, typename P>
+  std::size_t PopBulk(std::vector<T> &values, std::size_t max,
+                      std::chrono::duration<R, P> const &duration);
+  template <typename U>
+  meta::EnableIfSame<T, meta::Decay<U>> Push(U &&element);
+  template <typename U>
+  meta::EnableIfSame<T, meta::Decay<U>> Push(U &&element, std::size_t &count);
+  template <typename U, typename R, typename P>
+  meta::EnableIfSame<T, meta::Decay<U>, bool> Push(U &&element, std::size_t &count,
+                                                   std::chrono::duration<R, P> const &duration);
+  template <typename Iterator>
+  void        PushBulk(Iterator begin, Iterator end);
+  std::size_t size() const;
+  /// @}
+
+  // Operators
+  LockFreeBlockingQueue &operator=(LockFreeBlockingQueue const &) = delete;
+  LockFreeBlockingQueue &operator=(LockFreeBlockingQueue &&) = delete;
+
+private:
+  static constexpr std::size_t SPIN_ATTEMPTS  = 64;
+  static constexpr std::size_t YIELD_ATTEMPTS = 16;
+
+  using Ring      = LockFreeMPMCQueue<T, SIZE>;
+  using Clock     = std::chrono::steady_clock;
+  using Timepoint = Clock::time_point;
+
+  struct WaitList
+  {
+    std::mutex               mutex;
+    std::condition_variable  cv;
+    std::atomic<std::size_t> waiters{0};  ///< The number of threads parked (or about to park)
+  };
+
+  template <typename Attempt>
+  static bool Await(WaitList &list, Attempt &&attempt, Timepoint const *deadline);
+  static void Notify(WaitList &list, bool all);
+
+  Ring     ring_;       ///< The lock free element storage
+  WaitList not_empty_;  ///< The consumers waiting for an element
+  WaitList not_full_;   ///< The producers waiting for a free slot
+};
+
+template <typename T, std::size_t N>
+constexpr std::size_t LockFreeBlockingQueue<T, N>::QUEUE_LENGTH;
+
+/**
+ * Pop an element from the queue
+ *
+ * If no element is available then the function will block until an element is available.
+ *
+ * @tparam T The type of element to be stored in the queue
+ * @tparam N The max size of the queue
+ * @return The element retrieved from the queue
+ */
+template <typename T, std::size_t N>
+T LockFreeBlockingQueue<T, N>::Pop()
+{
+  T value;
+  Await(not_empty_, [this, &value]() { return ring_.TryPop(value); }, nullptr);
+  Notify(not_full_, false);
+
+  return value;
+}
+
+/**
+ * Pop an element from the queue with a specified maximum wait duration
+ *
+ * @tparam T The type of element to be stored in the queue
+ * @tparam N The max size of the queue
+ * @tparam Rep The tick representation for the duration
+ * @tparam Per The tick period for the duration
+ * @param value The reference to the value to be populated
+ * @param duration The maximum amount of time to wait for an element
+ * @return true if an element was extracted, otherwise false
+ */
+template <typename T, std::size_t N>
+template <typename Rep, typename Per>
+bool LockFreeBlockingQueue<T, N>::Pop(T &value, std::chrono::duration<Rep, Per> const &duration)
+{
+  bool success = ring_.TryPop(value);
+
+  if (!success && (duration > duration.zero()))
+  {
+    Timepoint const deadline = Clock::now() + duration;
+    success = Await(not_empty_, [this, &value]() { return ring_.TryPop(value); }, &deadline);
+  }
+
+  if (success)
+  {
+    Notify(not_full_, false);
+  }
+
+  return success;
+}
+
+/**
+ * Pop a number of elements from the queue with a specified maximum wait duration
+ *
+ * The function waits for at most the duration for the first element to become available, and then
+ * extracts as many of the elements as are available, up to the maximum.
+ *
+ * @tparam T The type of element to be stored in the queue
+ * @tparam N The max size of the queue
+ * @tparam Rep The tick representation for the duration
+ * @tparam Per The tick period for the duration
+ * @param values The container to which the extracted elements are appended
+ * @param max The maximum number of elements to be extracted
+ * @param duration The maximum amount of time to wait for an element
+ * @return The number of elements extracted
+ */
+template <typename T, std::size_t N>
+template <typename Rep, typename Per>
+std::size_t LockFreeBlockingQueue<T, N>::PopBulk(std::vector<T> &values, std::size_t max,
+                                                 std::chrono::duration<Rep, Per> const &duration)
+{
+  std::size_t popped = ring_.TryPopBulk(values, max);
+
+  if ((popped == 0) && (max != 0) && (duration > duration.zero()))
+  {
+    Timepoint const deadline = Clock::now() + duration;
+    Await(not_empty_,
+          [this, &values, &popped, max]() {
+            popped = ring_.TryPopBulk(values, max);
+            return popped != 0;
+          },
+          &deadline);
+  }
+
+  if (popped != 0)
+  {
+    Notify(not_full_, popped > 1);
+  }
+
+  return popped;
+}
+
+/**
+ * Push an element onto the queue
+ *
+ * If the queue is full this function will block until an element can be added
+ *
+ * @tparam T The type of element to be stored in the queue
+ * @tparam N The max size of the queue
+ * @tparam U The deduced type of the element, same as T after decay
+ * @param element The universal reference to the element
+ */
+template <typename T, std::size_t N>
+template <typename U>
+meta::EnableIfSame<T, meta::Decay<U>> LockFreeBlockingQueue<T, N>::Push(U &&element)
+{
+  // the ring only consumes the element once a cell has been claimed, so retrying is safe
+  Await(not_full_, [this, &element]() { return ring_.TryPush(std::forward<U>(element)); },
+        nullptr);
+  Notify(not_empty_, false);
+}
+
+/**
+ * Push an element onto the queue
+ *
+ * If the queue is full this function will block until an element can be added
+ *
+ * @tparam T The type of element to be stored in the queue
+ * @tparam N The max size of the queue
+ * @tparam U The deduced type of the element, same as T after decay
+ * @param element The universal reference to the element
+ * @param count Number of enqueued elements still waiting in the queue to be processed.
+ */
+template <typename T, std::size_t N>
+template <typename U>
+meta::EnableIfSame<T, meta::Decay<U>> LockFreeBlockingQueue<T, N>::Push(U &&element,
+                                                                        std::size_t &count)
+{
+  Push(std::forward<U>(element));
+  count = ring_.size();
+}
+
+/**
+ * Push an element onto the queue
+ *
+ * If the queue is full this function will block for at most the specified duration
+ *
+ * @tparam T The type of element to be stored in the queue
+ * @tparam N The max size of the queue
+ * @tparam U The deduced type of the element, same as T after decay
+ * @param element The universal reference to the element
+ * @param count Number of enqueued elements still waiting in the queue to be processed.
+ * @param duration The maximum amount of time to wait for being able to insert the element
+ * @return true if an element was inserted in given timeout, otherwise false
+ */
+template <typename T, std::size_t N>
+template <typename U, typename Rep, typename Per>
+meta::EnableIfSame<T, meta::Decay<U>, bool> LockFreeBlockingQueue<T, N>::Push(
+    U &&element, std::size_t &count, std::chrono::duration<Rep, Per> const &duration)
+{
+  Timepoint const deadline = Clock::now() + duration;
+
+  if (!Await(not_full_, [this, &element]() { return ring_.TryPush(std::forward<U>(element)); },
+             &deadline))
+  {
+    return false;
+  }
+
+  Notify(not_empty_, false);
+  count = ring_.size();
+
+  return true;
+}
+
+/**
+ * Push a range of elements onto the queue
+ *
+ * The elements are inserted in batches of as many as there is space for, each batch claiming its
+ * cells with a single update of the write position. If the queue is full this function will block
+ * until the remaining elements can be added.
+ *
+ * @tparam T The type of element to be stored in the queue
+ * @tparam N The max size of the queue
+ * @tparam Iterator The iterator type of the range, a move iterator moves the elements
+ * @param begin The start of the range of elements
+ * @param end The end of the range of elements
+ */
+template <typename T, std::size_t N>
+template <typename Iterator>
+void LockFreeBlockingQueue<T, N>::PushBulk(Iterator begin, Iterator end)
+{
+  while (begin != end)
+  {
+    std::size_t pushed{0};
+    Await(not_full_,
+          [this, &begin, &end, &pushed]() {
+            pushed = ring_.TryPushBulk(begin, end);
+            return pushed != 0;
+          },
+          nullptr);
+
+    Notify(not_empty_, pushed > 1);
+  }
+}
+
+/**
+ * Get the (approximate) number of elements in the queue
+ *
+ * @return The number of elements
+ */
+template <typename T, std::size_t N>
+std::size_t LockFreeBlockingQueue<T, N>::size() const
+{
+  return ring_.size();
+}
+
+/**
+ * Internal: Repeatedly make an attempt on the ring until it succeeds. The caller first spins, then
+ * yields and finally parks on the wait list, until it is notified or the deadline expires.
+ *
+ * @tparam Attempt The type of the attempt callable
+ * @param list The wait list to park on
+ * @param attempt The callable which makes the attempt, returning true on success
+ * @param deadline The deadline for the attempts, or nullptr to wait indefinitely
+ * @return true if the attempt succeeded, otherwise false
+ */
+template <typename T, std::size_t N>
+template <typename Attempt>
+bool LockFreeBlockingQueue<T, N>::Await(WaitList &list, Attempt &&attempt,
+                                        Timepoint const *deadline)
+{
+  for (std::size_t i = 0; i < SPIN_ATTEMPTS; ++i)
+  {
+    if (attempt())
+    {
+      return true;
+    }
+  }
+
+  for (std::size_t i = 0; i < YIELD_ATTEMPTS; ++i)
+  {
+    if (attempt())
+    {
+      return true;
+    }
+
+    if ((deadline != nullptr) && (Clock::now() >= *deadline))
+    {
+      return false;
+    }
+
+    std::this_thread::yield();
+  }
+
+  std::unique_lock<std::mutex> lock(list.mutex);
+
+  // announce the waiter before the final attempt, pairs with the fence in Notify
+  list.waiters.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  bool success{false};
+  for (;;)
+  {
+    if (attempt())
+    {
+      success = true;
+      break;
+    }
+
+    if (deadline == nullptr)
+    {
+      list.cv.wait(lock);
+    }
+    else if (std::cv_status::timeout == list.cv.wait_until(lock, *deadline))
+    {
+      success = attempt();
+      break;
+    }
+  }
+
+  list.waiters.fetch_sub(1, std::memory_order_relaxed);
+
+  return success;
+}
+
+/**
+ * Internal: Wake the threads parked on the wait list (if there are any) after the ring has changed
+ *
+ * @param list The wait list to be notified
+ * @param all true if all the waiters should be woken, otherwise only one
+ */
+template <typename T, std::size_t N>
+void LockFreeBlockingQueue<T, N>::Notify(WaitList &list, bool all)
+{
+  // pairs with the fence in Await, either the waiter is seen or it sees the change to the ring
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  if (list.waiters.load(std::memory_order_relaxed) == 0)
+  {
+    return;
+  }
+
+  {
+    // a waiter which has been counted is either parked or holds the lock until it parks
+    std::lock_guard<std::mutex> lock(list.mutex);
+  }
+
+  if (all)
+  {
+    list.cv.notify_all();
+  }
+  else
+  {
+    list.cv.notify_one();
+  }
+}
+
 // Helpful Typedefs
 template <typename T, std::size_t N>
 using SPSCQueue = Queue<T, N, SingleThreadedIndex<N>, SingleThreadedIndex<N>>;
@@ -318,10 +758,10 @@ template <typename T, std::size_t N>
 using SPMCQueue = Queue<T, N, SingleThreadedIndex<N>, MultiThreadedIndex<N>>;
 
 template <typename T, std::size_t N>
-using MPSCQueue = Queue<T, N, MultiThreadedIndex<N>, SingleThreadedIndex<N>>;
+using MPSCQueue = LockFreeBlockingQueue<T, N>;
 
 template <typename T, std::size_t N>
-using MPMCQueue = Queue<T, N, MultiThreadedIndex<N>, MultiThreadedIndex<N>>;
+using MPMCQueue = LockFreeBlockingQueue<T, N>;
 
 }  // namespace core
 }  // namespace fetch
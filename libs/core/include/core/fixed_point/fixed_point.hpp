@@ -447,7 +447,7 @@ public:
   }
 
   template <typename T>
-  constexpr FixedPoint operator+(const T &n) const
+  constexpr meta::EnableIf<std::is_arithmetic<T>::value, FixedPoint> operator+(const T &n) const
   {
     return FixedPoint(T(data_) + n);
   }
@@ -459,7 +459,7 @@ public:
   }
 
   template <typename T>
-  constexpr FixedPoint operator-(const T &n) const
+  constexpr meta::EnableIf<std::is_arithmetic<T>::value, FixedPoint> operator-(const T &n) const
   {
     return FixedPoint(T(data_) - n);
   }
@@ -472,7 +472,7 @@ public:
   }
 
   template <typename T>
-  constexpr FixedPoint operator*(const T &n) const
+  constexpr meta::EnableIf<std::is_arithmetic<T>::value, FixedPoint> operator*(const T &n) const
   {
     return *this * FixedPoint(n);
   }
@@ -491,7 +491,7 @@ public:
   }
 
   template <typename T>
-  constexpr FixedPoint operator/(const T &n) const
+  constexpr meta::EnableIf<std::is_arithmetic<T>::value, FixedPoint> operator/(const T &n) const
   {
     return *this / FixedPoint(n);
   }
@@ -612,8 +612,8 @@ public:
     // Multiply the coefficients as they are the same in both numerator and denominator
     r *= FixedPoint(0.5);
     r2 *= FixedPoint(3.0 / 28.0);
-    r3 *= CONST_ONE / FixedPoint(84.0);
-    r4 *= CONST_ONE / FixedPoint(1680.0);
+    r3 *= FixedPoint(1.0 / 84.0);
+    r4 *= FixedPoint(1.0 / 1680.0);
     FixedPoint P  = CONST_ONE + r + r2 + r3 + r4;
     FixedPoint Q  = CONST_ONE - r + r2 - r3 + r4;
     FixedPoint e2 = P / Q;
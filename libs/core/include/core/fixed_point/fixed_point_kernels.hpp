@@ -0,0 +1,461 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/fixed_point/fixed_point.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace fetch {
+namespace fixed_point {
+
+/**
+ * Batch kernels over arrays of fixed point numbers
+ *
+ * The arithmetic kernels give exactly the same results as the scalar operators, but work directly
+ * on the underlying integers in simple loops which the compiler vectorises (e.g. the widening
+ * multiply of 16.16 numbers maps onto packed 32 x 32 -> 64 bit multiplies).
+ *
+ * The transcendental kernels are computed entirely in integer arithmetic, so are deterministic
+ * across platforms, from a 64 entry table and a short polynomial in W = TOTAL_BITS - 2 working
+ * bits (30 bits for 16.16, 62 bits for 32.32). Their error bounds, with u = 2^-F the unit in the
+ * last place, are:
+ *
+ *  - Exp:  |error| <= u + 2^-(W - 4) * exp(x), for MIN_EXP <= x <= MAX_EXP
+ *  - Log2: |error| <= u, for x > 0 (Log adds at most a further u)
+ *  - Sqrt: |error| <= u / 2, i.e. correctly rounded, for x >= 0
+ *
+ * Unlike the scalar FixedPoint::Exp and FixedPoint::Log2, which are kept as they are so that
+ * existing results do not change, these never divide and never go through floating point. Sqrt
+ * starts from a floating point estimate, but corrects it exactly in integer arithmetic.
+ */
+namespace batch {
+namespace detail {
+
+// 2^(j/64), log2(1 + j/64) and 1/(1 + j/64) for j = 0..63, rounded to 62 fractional bits
+static constexpr uint64_t EXP2_TABLE[64] = {
+    0x4000000000000000ull, 0x40b268f9de0183baull, 0x4166c34c5615d0ecull, 0x421d1461d66f2023ull,
+    0x42d561b3e6243d8aull, 0x438fb0cb4f468808ull, 0x444c0740496d4294ull, 0x450a6abaa4b77ecdull,
+    0x45cae0f1f545eb73ull, 0x468d6fadbf2dd4f3ull, 0x47521cc5a2e6a9e0ull, 0x4818ee218a3358eeull,
+    0x48e1e9b9d588e19bull, 0x49ad159789f37496ull, 0x4a7a77d47f7b84b1ull, 0x4b4a169b900c2d00ull,
+    0x4c1bf828c6dc54b8ull, 0x4cf022c9905bfd32ull, 0x4dc69cdceaa72a9cull, 0x4e9f6cd3967fdba8ull,
+    0x4f7a993048d088d7ull, 0x50582887dcb8a7e1ull, 0x513821818624b40cull, 0x521a8ad704f3404full,
+    0x52ff6b54d8a89c75ull, 0x53e6c9da74b29ab5ull, 0x54d0ad5a753e077cull, 0x55bd1cdad49f699cull,
+    0x56ac1f752150a563ull, 0x579dbc56b48521baull, 0x5891fac0e95612c8ull, 0x5988e20954889245ull,
+    0x5a827999fcef3242ull, 0x5b7ec8f19468bbc9ull, 0x5c7dd7a3b17dcf75ull, 0x5d7fad59099f22feull,
+    0x5e8451cfac061b5full, 0x5f8bccdb3d398841ull, 0x6096266533384a2bull, 0x61a3666d124bb204ull,
+    0x62b39508aa836d6full, 0x63c6ba6455dcd8aeull, 0x64dcdec3371793d1ull, 0x65f60a7f79393e2eull,
+    0x6712460a8fc24072ull, 0x683199ed779592caull, 0x69540ec8f895722dull, 0x6a79ad55e7f6fd10ull,
+    0x6ba27e656b4eb57aull, 0x6cce8ae13c57ebdbull, 0x6dfddbcbed791babull, 0x6f307a412f074892ull,
+    0x70666f76154a7089ull, 0x719fc4b95f452d29ull, 0x72dc8373be41a454ull, 0x741cb5281e25ee34ull,
+    0x75606373ee921c97ull, 0x76a7980f6cca15c2ull, 0x77f25ccdee6d7ae6ull, 0x7940bb9e2cffd89dull,
+    0x7a92be8a92436616ull, 0x7be86fb985689ddcull, 0x7d41d96db915019dull, 0x7e9f06067a4360baull};
+
+static constexpr uint64_t LOG2_TABLE[64] = {
+    0x0000000000000000ull, 0x016e79685c2d2299ull, 0x02d75a6eb1dfb0e6ull, 0x043ace27e8a7e6adull,
+    0x0598fdbeb244c59full, 0x06f210902b6aee99ull, 0x08462c466d3cf1cbull, 0x099574f13c570d10ull,
+    0x0ae00d1cfdeb43d0ull, 0x0c2615e81781d97full, 0x0d67af16da7649f8ull, 0x0ea4f726192cb7e4ull,
+    0x0fde0b5c81340512ull, 0x111307dad30b75cbull, 0x124407ab0e073982ull, 0x137124cea4cdecdaull,
+    0x149a784bcd1b8afeull, 0x15c01a39fbd687a0ull, 0x16e221cd9d0cde58ull, 0x1800a563161c5433ull,
+    0x191bba891f1708b5ull, 0x1a33760a7f60509dull, 0x1b47ebf73882a0a4ull, 0x1c592fad295b567eull,
+    0x1d6753e032ea0efeull, 0x1e726aa1e754d20cull, 0x1f7a8568cb06ceceull, 0x207fb5172f32fe67ull,
+    0x21820a01ac754cb1ull, 0x228193f543ca873cull, 0x237e623d2ba01bc7ull, 0x247883a84e4f9010ull,
+    0x2570068e7ef5a1e8ull, 0x2664f8d569394d91ull, 0x275767f54042cd9aull, 0x284760fd30d552ceull,
+    0x2934f0979a3715fdull, 0x2a20230e1151f1bcull, 0x2b09044d313a6787ull, 0x2bef9fe83c135d72ull,
+    0x2cd4011c8f11979aull, 0x2db632d4ec3293b3ull, 0x2e963fac9c0ea78eull, 0x2f7431f26a05c814ull,
+    0x305013ab7ce0e5b8ull, 0x3129ee960ddf1681ull, 0x3201cc2c000599fdull, 0x32d7b5a5596bebe0ull,
+    0x33abb3faa02166cdull, 0x347dcfe71c303da1ull, 0x354e11eb0029a6faull, 0x361c824d7990d7afull,
+    0x36e9291eaa65b497ull, 0x37b40e398cfcdb6aull, 0x387d3945c340aa67ull, 0x3944b1b952662c6cull,
+    0x3a0a7eda4c112ce6ull, 0x3acea7c065d41dfcull, 0x3b9133567fead8bdull, 0x3c52285c1c02803full,
+    0x3d118d66c4d4e554ull, 0x3dcf68e36752a0fbull, 0x3e8bc1179e0caa9dull, 0x3f469c22ef8466c5ull};
+
+static constexpr uint64_t RECIPROCAL_TABLE[64] = {
+    0x4000000000000000ull, 0x3f03f03f03f03f04ull, 0x3e0f83e0f83e0f84ull, 0x3d226357e16ece54ull,
+    0x3c3c3c3c3c3c3c3cull, 0x3b5cc0ed7303b5ccull, 0x3a83a83a83a83a84ull, 0x39b0ad12073615a2ull,
+    0x38e38e38e38e38e4ull, 0x381c0e070381c0e0ull, 0x3759f22983759f23ull, 0x369d0369d0369d03ull,
+    0x35e50d79435e50d8ull, 0x3531dec0d4c77b03ull, 0x3483483483483483ull, 0x33d91d2a2067b23aull,
+    0x3333333333333333ull, 0x329161f9add3c0caull, 0x31f3831f3831f383ull, 0x3159721ed7e75347ull,
+    0x30c30c30c30c30c3ull, 0x3030303030303030ull, 0x2fa0be82fa0be830ull, 0x2f149902f149902full,
+    0x2e8ba2e8ba2e8ba3ull, 0x2e05c0b81702e05cull, 0x2d82d82d82d82d83ull, 0x2d02d02d02d02d03ull,
+    0x2c8590b21642c859ull, 0x2c0b02c0b02c0b03ull, 0x2b9310572620ae4cull, 0x2b1da46102b1da46ull,
+    0x2aaaaaaaaaaaaaabull, 0x2a3a0fd5c5f02a3aull, 0x29cbc14e5e0a72f0ull, 0x295fad40a57eb503ull,
+    0x28f5c28f5c28f5c3ull, 0x288df0cac5b3f5ddull, 0x2828282828282828ull, 0x27c45979c95204f9ull,
+    0x2762762762762762ull, 0x2702702702702702ull, 0x26a439f656f1826aull, 0x2647c69456217eceull,
+    0x25ed097b425ed098ull, 0x2593f69b02593f6aull, 0x253c8253c8253c82ull, 0x24e6a171024e6a17ull,
+    0x2492492492492492ull, 0x243f6f0243f6f024ull, 0x23ee08fb823ee090ull, 0x239e0d5b450239e1ull,
+    0x234f72c234f72c23ull, 0x2302302302302302ull, 0x22b63cbeea4e1a09ull, 0x226b90226b90226cull,
+    0x2222222222222222ull, 0x21d9ead7cd391fbcull, 0x2192e29f79b47582ull, 0x214d0214d0214d02ull,
+    0x2108421084210842ull, 0x20c49ba5e353f7cfull, 0x2082082082082082ull, 0x2040810204081020ull};
+
+// 1 / n! for n = 0 ... 8, to 62 fractional bits
+static constexpr uint64_t INVERSE_FACTORIAL_TABLE[9] = {
+    0x4000000000000000ull, 0x4000000000000000ull, 0x2000000000000000ull,
+    0x0aaaaaaaaaaaaaabull, 0x02aaaaaaaaaaaaabull, 0x0088888888888889ull,
+    0x0016c16c16c16c17ull, 0x0003403403403403ull, 0x0000680680680680ull};
+
+static constexpr uint64_t LOG2E_62 = 0x5c551d94ae0bf85eull;  ///< log2(e) to 62 fractional bits
+static constexpr uint64_t LN2_62   = 0x2c5c85fdf473de6bull;  ///< ln(2) to 62 fractional bits
+
+/**
+ * The constants of the working precision of a fixed point type
+ */
+template <std::uint16_t I, std::uint16_t F>
+struct Working
+{
+  using FP       = FixedPoint<I, F>;
+  using Type     = typename FP::Type;
+  using NextType = typename FP::NextType;
+
+  static_assert(FP::TOTAL_BITS == 32 || FP::TOTAL_BITS == 64,
+                "batch kernels are only available for 32 and 64 bit fixed point types");
+
+  static constexpr int BITS      = static_cast<int>(FP::TOTAL_BITS) - 2;  ///< W
+  static constexpr int NEXT_BITS = 2 * static_cast<int>(FP::TOTAL_BITS);
+
+  // the bits of log2(e) applied to the input, limited so that the product fits the next type
+  static constexpr int LOG2E_BITS =
+      ((NEXT_BITS - 9 - static_cast<int>(F)) < 62) ? (NEXT_BITS - 9 - static_cast<int>(F)) : 62;
+
+  // the terms of the Taylor series of e^u for u < ln(2) / 64
+  static constexpr int EXP_DEGREE = (BITS > 32) ? 8 : 4;
+
+  static_assert(BITS >= static_cast<int>(F), "too many fractional bits for the batch kernels");
+
+  static NextType One()
+  {
+    return NextType{1} << BITS;
+  }
+
+  /**
+   * Scale a constant with 62 fractional bits to the working precision, rounding to nearest
+   */
+  static NextType FromTable(uint64_t value)
+  {
+    return static_cast<NextType>(RoundShift(static_cast<NextType>(value), 62 - BITS));
+  }
+
+  static NextType RoundShift(NextType value, int shift)
+  {
+    if (shift <= 0)
+    {
+      return value << -shift;
+    }
+
+    return (value + (NextType{1} << (shift - 1))) >> shift;
+  }
+};
+
+template <std::uint16_t I, std::uint16_t F>
+typename FixedPoint<I, F>::Type Exp(typename FixedPoint<I, F>::Type x)
+{
+  using W        = Working<I, F>;
+  using Type     = typename W::Type;
+  using NextType = typename W::NextType;
+
+  // x * log2(e) = k + f, with k an integer and f in [0, 1)
+  NextType const log2e = static_cast<NextType>(LOG2E_62 >> (62 - W::LOG2E_BITS));
+  NextType const t     = (NextType{x} * log2e) >> (static_cast<int>(F) + W::LOG2E_BITS - W::BITS);
+  NextType const k     = t >> W::BITS;
+  NextType const f     = t - (k << W::BITS);
+
+  // 2^f = 2^(j / 64) * e^u, with u = (f - j / 64) * ln(2) in [0, ln(2) / 64)
+  auto const     j = static_cast<std::size_t>(f >> (W::BITS - 6));
+  NextType const g = f - (static_cast<NextType>(j) << (W::BITS - 6));
+  NextType const u = (g * W::FromTable(LN2_62)) >> W::BITS;
+
+  // e^u = 1 + u (1/1! + u (1/2! + u (1/3! + ...))), with enough terms that the truncation error
+  // is below 2^-(W + 2)
+  NextType p = W::FromTable(INVERSE_FACTORIAL_TABLE[W::EXP_DEGREE]);
+  for (int n = W::EXP_DEGREE - 1; n >= 0; --n)
+  {
+    p = W::FromTable(INVERSE_FACTORIAL_TABLE[n]) + ((u * p) >> W::BITS);
+  }
+
+  NextType const result = (W::FromTable(EXP2_TABLE[j]) * p) >> W::BITS;
+
+  // finally scale by 2^k, saturating at the largest value
+  int const shift = W::BITS - static_cast<int>(F) - static_cast<int>(k);
+  if (shift >= W::NEXT_BITS - 1)
+  {
+    return Type{0};
+  }
+
+  NextType const scaled = W::RoundShift(result, shift);
+  return (scaled > NextType{FixedPoint<I, F>::MAX}) ? FixedPoint<I, F>::MAX
+                                                    : static_cast<Type>(scaled);
+}
+
+template <std::uint16_t I, std::uint16_t F>
+typename FixedPoint<I, F>::Type Log2(typename FixedPoint<I, F>::Type x)
+{
+  using W        = Working<I, F>;
+  using Type     = typename W::Type;
+  using NextType = typename W::NextType;
+
+  NextType const one = W::One();
+
+  // x = 2^k * m with m in [1, 2)
+  int const      highest = HighestSetBit(x) - 1;
+  int const      k       = highest - static_cast<int>(F);
+  NextType const m = (highest <= W::BITS) ? (NextType{x} << (W::BITS - highest))
+                                          : (NextType{x} >> (highest - W::BITS));
+
+  // m = (1 + j / 64) * (1 + r), with r in [0, 1/64)
+  auto const     j = static_cast<std::size_t>((m - one) >> (W::BITS - 6));
+  NextType const r = ((m * W::FromTable(RECIPROCAL_TABLE[j])) >> W::BITS) - one;
+
+  // ln(1 + r) = r (1 - r (1/2 - r (1/3 - r (1/4 - r/5)))), the truncation error is below 2^-38
+  NextType p = (one / 4) - (r / 5);
+  p          = (one / 3) - ((r * p) >> W::BITS);
+  p          = (one / 2) - ((r * p) >> W::BITS);
+  p          = one - ((r * p) >> W::BITS);
+  p          = (r * p) >> W::BITS;
+
+  NextType const result = (NextType{k} << W::BITS) + W::FromTable(LOG2_TABLE[j]) +
+                          ((p * W::FromTable(LOG2E_62)) >> W::BITS);
+
+  return static_cast<Type>(W::RoundShift(result, W::BITS - static_cast<int>(F)));
+}
+
+template <std::uint16_t I, std::uint16_t F>
+typename FixedPoint<I, F>::Type Sqrt(typename FixedPoint<I, F>::Type x)
+{
+  using Type         = typename FixedPoint<I, F>::Type;
+  using NextType     = typename FixedPoint<I, F>::NextType;
+  using UnsignedNext = typename FixedPoint<I, F>::BaseTypeInfo::NextSize::UnsignedType;
+
+  // the integer square root of x * 2^F. The floating point estimate is within one of the root,
+  // the correction makes the result exact (and so independent of the platform)
+  UnsignedNext const n = static_cast<UnsignedNext>(NextType{x}) << F;
+  auto               result = static_cast<UnsignedNext>(std::sqrt(static_cast<double>(n)));
+
+  while (result * result > n)
+  {
+    --result;
+  }
+
+  while ((result + 1) * (result + 1) <= n)
+  {
+    ++result;
+  }
+
+  // round to nearest, the remainder is x * 2^F - result^2
+  if ((n - (result * result)) > result)
+  {
+    ++result;
+  }
+
+  return static_cast<Type>(result);
+}
+
+}  // namespace detail
+
+/**
+ * out[i] = a[i] + b[i]
+ */
+template <std::uint16_t I, std::uint16_t F>
+void Add(FixedPoint<I, F> const *a, FixedPoint<I, F> const *b, FixedPoint<I, F> *out,
+         std::size_t count)
+{
+  using Type = typename FixedPoint<I, F>::Type;
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    out[i] = FixedPoint<I, F>::FromBase(static_cast<Type>(a[i].Data() + b[i].Data()));
+  }
+}
+
+/**
+ * out[i] = a[i] - b[i]
+ */
+template <std::uint16_t I, std::uint16_t F>
+void Subtract(FixedPoint<I, F> const *a, FixedPoint<I, F> const *b, FixedPoint<I, F> *out,
+              std::size_t count)
+{
+  using Type = typename FixedPoint<I, F>::Type;
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    out[i] = FixedPoint<I, F>::FromBase(static_cast<Type>(a[i].Data() - b[i].Data()));
+  }
+}
+
+/**
+ * out[i] = a[i] * b[i]
+ */
+template <std::uint16_t I, std::uint16_t F>
+void Multiply(FixedPoint<I, F> const *a, FixedPoint<I, F> const *b, FixedPoint<I, F> *out,
+              std::size_t count)
+{
+  using Type     = typename FixedPoint<I, F>::Type;
+  using NextType = typename FixedPoint<I, F>::NextType;
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    NextType const product = NextType{a[i].Data()} * NextType{b[i].Data()};
+    out[i]                 = FixedPoint<I, F>::FromBase(static_cast<Type>(product >> F));
+  }
+}
+
+/**
+ * out[i] = a[i] * scale
+ */
+template <std::uint16_t I, std::uint16_t F>
+void Multiply(FixedPoint<I, F> const *a, FixedPoint<I, F> const &scale, FixedPoint<I, F> *out,
+              std::size_t count)
+{
+  using Type     = typename FixedPoint<I, F>::Type;
+  using NextType = typename FixedPoint<I, F>::NextType;
+
+  NextType const factor = scale.Data();
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    NextType const product = NextType{a[i].Data()} * factor;
+    out[i]                 = FixedPoint<I, F>::FromBase(static_cast<Type>(product >> F));
+  }
+}
+
+/**
+ * out[i] = a[i] / b[i]
+ *
+ * @throws std::overflow_error if any of the divisors is zero, in which case out is left unchanged
+ */
+template <std::uint16_t I, std::uint16_t F>
+void Divide(FixedPoint<I, F> const *a, FixedPoint<I, F> const *b, FixedPoint<I, F> *out,
+            std::size_t count)
+{
+  using Type     = typename FixedPoint<I, F>::Type;
+  using NextType = typename FixedPoint<I, F>::NextType;
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    if (b[i].Data() == 0)
+    {
+      throw std::overflow_error("Division by zero!");
+    }
+  }
+
+  // the magnitude of the numerator is divided, as the scalar operator does
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    Type const     numerator = a[i].Data();
+    NextType const magnitude = NextType{(numerator < 0) ? -numerator : numerator} << F;
+    auto const     quotient  = static_cast<Type>(magnitude / NextType{b[i].Data()});
+
+    out[i] = FixedPoint<I, F>::FromBase((numerator < 0) ? static_cast<Type>(-quotient) : quotient);
+  }
+}
+
+/**
+ * out[i] = e^a[i]
+ *
+ * @throws std::overflow_error if any of the values is larger than MAX_EXP
+ */
+template <std::uint16_t I, std::uint16_t F>
+void Exp(FixedPoint<I, F> const *a, FixedPoint<I, F> *out, std::size_t count)
+{
+  using FP = FixedPoint<I, F>;
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    if (a[i] > FP::MAX_EXP)
+    {
+      throw std::overflow_error("Exp() does not support exponents larger than MAX_EXP");
+    }
+  }
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    out[i] = (a[i] < FP::MIN_EXP) ? FP::CONST_ZERO : FP::FromBase(detail::Exp<I, F>(a[i].Data()));
+  }
+}
+
+/**
+ * out[i] = log2(a[i])
+ *
+ * @throws std::runtime_error if any of the values is not positive
+ */
+template <std::uint16_t I, std::uint16_t F>
+void Log2(FixedPoint<I, F> const *a, FixedPoint<I, F> *out, std::size_t count)
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    if (a[i].Data() <= 0)
+    {
+      throw std::runtime_error("Log2(): mathematical operation not defined: x <= 0!");
+    }
+  }
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    out[i] = FixedPoint<I, F>::FromBase(detail::Log2<I, F>(a[i].Data()));
+  }
+}
+
+/**
+ * out[i] = ln(a[i])
+ *
+ * @throws std::runtime_error if any of the values is not positive
+ */
+template <std::uint16_t I, std::uint16_t F>
+void Log(FixedPoint<I, F> const *a, FixedPoint<I, F> *out, std::size_t count)
+{
+  using FP       = FixedPoint<I, F>;
+  using Type     = typename FP::Type;
+  using NextType = typename FP::NextType;
+
+  Log2(a, out, count);
+
+  // ln(x) = log2(x) * ln(2), rounded to nearest
+  auto const ln2 = static_cast<NextType>(detail::LN2_62 >> (62 - detail::Working<I, F>::BITS));
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    NextType const product = NextType{out[i].Data()} * ln2;
+    out[i]                 = FP::FromBase(static_cast<Type>(
+        detail::Working<I, F>::RoundShift(product, detail::Working<I, F>::BITS)));
+  }
+}
+
+/**
+ * out[i] = sqrt(a[i]), correctly rounded
+ *
+ * @throws std::runtime_error if any of the values is negative
+ */
+template <std::uint16_t I, std::uint16_t F>
+void Sqrt(FixedPoint<I, F> const *a, FixedPoint<I, F> *out, std::size_t count)
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    if (a[i].Data() < 0)
+    {
+      throw std::runtime_error("Sqrt(): mathematical operation not defined: x < 0!");
+    }
+  }
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    out[i] = FixedPoint<I, F>::FromBase(detail::Sqrt<I, F>(a[i].Data()));
+  }
+}
+
+}  // namespace batch
+}  // namespace fixed_point
+}  // namespace fetch
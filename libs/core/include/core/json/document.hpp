@@ -23,6 +23,8 @@
 #include "core/json/exceptions.hpp"
 #include "variant/variant.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <stack>
 #include <vector>
@@ -32,6 +34,11 @@ namespace json {
 
 /**
  * Basic JSON parser
+ *
+ * The document is parsed in two stages. The first stage indexes the positions of the structural
+ * elements (operators, quotes and the start of every scalar) with vector instructions, 64
+ * characters at a time. The second stage walks this index to build a tape of tokens, from which
+ * either the Variant tree is built (Parse) or values are extracted on demand (ParseLazy).
  */
 class JSONDocument
 {
@@ -57,6 +64,8 @@ public:
     KEY = 16
   };
 
+  class LazyValue;
+
 public:
   using ByteArray      = byte_array::ByteArray;
   using ConstByteArray = byte_array::ConstByteArray;
@@ -104,6 +113,12 @@ public:
 
   void Parse(ConstByteArray const &document);
 
+  /// @name On Demand Access
+  /// @{
+  void      ParseLazy(ConstByteArray const &document);
+  LazyValue lazy_root() const;
+  /// @}
+
   JSONDocument &operator=(JSONDocument const &) = delete;
   JSONDocument &operator=(JSONDocument &&) = default;
 
@@ -116,6 +131,11 @@ private:
     uint8_t  type  = 0;
   };
 
+  /**
+   * A token of the tape. For strings the first and second fields are the start and end of the
+   * contents, for numbers the start and length. Opening tokens record the index of their closing
+   * token in second, closing tokens the number of elements (keys count as elements) contained.
+   */
   struct JSONToken
   {
     uint64_t first  = 0;
@@ -123,16 +143,75 @@ private:
     uint8_t  type   = 0;
   };
 
+  void        IndexStructurals(ConstByteArray const &document);
   void        Tokenise(ConstByteArray const &document);
+  uint64_t    TokeniseRange(ConstByteArray const &document, uint64_t pos, uint64_t end,
+                            uint64_t &element_counter);
+  void        AddOperator(char c, uint64_t pos, uint64_t &element_counter);
+  void        Build(Variant &root, std::size_t begin, std::size_t end) const;
   static void ExtractPrimitive(Variant &variant, JSONToken const &token,
                                ConstByteArray const &document);
 
-  std::vector<uint16_t>    counters_{};
-  std::vector<JSONToken *> object_stack_{};
+  ConstByteArray           document_{};
+  std::vector<uint32_t>    structurals_{};
+  std::vector<uint64_t>    counters_{};
+  std::vector<std::size_t> open_tokens_{};
   std::vector<JSONToken>   tokens_{};
   Variant                  variant_{1024};
   std::size_t              objects_{0};
   std::vector<char>        brace_stack_{};
 };
+
+/**
+ * A view of a value of a tokenised document which is only converted into a Variant when
+ * requested, so that a few fields can be read from a large document cheaply. The view refers to
+ * the document, which must outlive it and must not be parsed again or moved in the meantime.
+ */
+class JSONDocument::LazyValue
+{
+public:
+  LazyValue(JSONDocument const &document, std::size_t token);
+
+  /// @name Type Checks
+  /// @{
+  bool IsObject() const;
+  bool IsArray() const;
+  bool IsString() const;
+  bool IsInteger() const;
+  bool IsFloatingPoint() const;
+  bool IsBoolean() const;
+  bool IsNull() const;
+  /// @}
+
+  /// @name Element Access
+  /// @{
+  std::size_t size() const;
+  bool        Has(ConstByteArray const &key) const;
+  LazyValue   operator[](ConstByteArray const &key) const;
+  LazyValue   operator[](std::size_t index) const;
+  /// @}
+
+  /// @name Conversion
+  /// @{
+  Variant ToVariant() const;
+
+  template <typename T>
+  T As() const
+  {
+    return ToVariant().As<T>();
+  }
+  /// @}
+
+private:
+  static constexpr std::size_t NPOS = std::size_t(-1);
+
+  JSONToken const &token() const;
+  std::size_t      Next(std::size_t token) const;
+  std::size_t      Find(ConstByteArray const &key) const;
+
+  JSONDocument const *document_;
+  std::size_t         token_;
+};
+
 }  // namespace json
 }  // namespace fetch
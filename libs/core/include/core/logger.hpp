@@ -21,11 +21,18 @@
 #include "core/commandline/vt100.hpp"
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <ctime>
 #include <execinfo.h>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <sstream>
+#include <string>
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
@@ -189,59 +196,57 @@ public:
     HIGHLIGHT = 4
   };
 
+  using Clock     = std::chrono::system_clock;
+  using Timepoint = Clock::time_point;
+
   virtual void StartEntry(Level level, char const *name, shared_context_type ctx)
   {
 #ifndef FETCH_DISABLE_COUT_LOGGING
-    using Clock     = std::chrono::system_clock;
-    using Timepoint = Clock::time_point;
-    using Duration  = Clock::duration;
+    int const thread_number = ReadableThread::GetThreadID(std::this_thread::get_id());
 
-    using namespace fetch::commandline::VT100;
-    int color = 9, bg_color = 9;
+    WritePrefix(std::cout, level, Clock::now(), thread_number);
+    WriteSource(std::cout, level, name, ctx.get());
+#endif
+  }
 
-    char const *level_name = "UNKNWN";
-    switch (level)
-    {
-    case Level::INFO:
-      color      = 3;
-      level_name = "INFO  ";
-      break;
-    case Level::WARNING:
-      color      = 6;
-      level_name = "WARN  ";
-      break;
-    case Level::ERROR:
-      color      = 1;
-      level_name = "ERROR ";
-      break;
-    case Level::DEBUG:
-      level_name = "DEBUG ";
-      color      = 7;
-      break;
-    case Level::HIGHLIGHT:
-      level_name = "HLIGHT";
-      bg_color   = 4;
-      color      = 7;
-      break;
-    }
+  /**
+   * Writes the time, thread and level columns which start every entry
+   */
+  static void WritePrefix(std::ostream &stream, Level level, Timepoint const &time,
+                          int thread_number)
+  {
+    using namespace fetch::commandline::VT100;
 
-    int const       thread_number = ReadableThread::GetThreadID(std::this_thread::get_id());
-    Timepoint const now           = Clock::now();
-    Duration const  duration      = now.time_since_epoch();
+    int         color = 9, bg_color = 9;
+    char const *level_name = Style(level, color, bg_color);
 
-    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() % 1000;
+    auto millis =
+        std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() %
+        1000;
 
     // format and generate the time
-    std::time_t now_c = std::chrono::system_clock::to_time_t(now);
-    std::cout << "[ " << GetColor(color, bg_color) << std::put_time(std::localtime(&now_c), "%F %T")
-              << "." << std::setw(3) << millis << DefaultAttributes();
+    std::time_t time_c = Clock::to_time_t(time);
+    stream << "[ " << GetColor(color, bg_color) << std::put_time(std::localtime(&time_c), "%F %T")
+           << "." << std::setw(3) << millis << DefaultAttributes();
 
     // thread information
-    std::cout << ", #" << std::setw(2) << thread_number << ' ' << level_name;
+    stream << ", #" << std::setw(2) << thread_number << ' ' << level_name;
+  }
+
+  /**
+   * Writes the name (or context) column, the message of the entry follows it
+   */
+  static void WriteSource(std::ostream &stream, Level level, char const *name,
+                          ContextDetails const *ctx)
+  {
+    using namespace fetch::commandline::VT100;
+
+    int color = 9, bg_color = 9;
+    Style(level, color, bg_color);
 
     // determine which of the two logging formats we should use
     bool use_name = name != nullptr;
-    if (use_name && ctx->instance())
+    if (use_name && ctx && ctx->instance())
     {
       // in the case where we actually context information we should use this variant
       use_name = false;
@@ -249,16 +254,15 @@ public:
 
     if (use_name)
     {
-      std::cout << ": " << std::setw(35) << name << " ] ";
+      stream << ": " << std::setw(35) << name << " ] ";
     }
     else
     {
-      std::cout << ": " << std::setw(15) << ctx->instance() << std::setw(20) << ctx->context(18)
-                << " ] ";
+      void *      instance = ctx ? ctx->instance() : nullptr;
+      std::string context  = ctx ? ctx->context(18) : "(root)";
+      stream << ": " << std::setw(15) << instance << std::setw(20) << context << " ] ";
     }
-    std::cout << GetColor(color, bg_color);
-
-#endif
+    stream << GetColor(color, bg_color);
   }
 
   template <typename T>
@@ -285,6 +289,96 @@ public:
   }
 
 private:
+  static char const *Style(Level level, int &color, int &bg_color)
+  {
+    char const *level_name = "UNKNWN";
+    switch (level)
+    {
+    case Level::INFO:
+      color      = 3;
+      level_name = "INFO  ";
+      break;
+    case Level::WARNING:
+      color      = 6;
+      level_name = "WARN  ";
+      break;
+    case Level::ERROR:
+      color      = 1;
+      level_name = "ERROR ";
+      break;
+    case Level::DEBUG:
+      level_name = "DEBUG ";
+      color      = 7;
+      break;
+    case Level::HIGHLIGHT:
+      level_name = "HLIGHT";
+      bg_color   = 4;
+      color      = 7;
+      break;
+    }
+    return level_name;
+  }
+};
+
+/**
+ * Logging backend which takes the formatting and writing of the entries off the calling threads.
+ * Every thread queues its entries, with the message already converted to text, on its own lock
+ * free ring buffer. A background thread collects the entries of all the threads, orders them by
+ * time and writes them out in batches
+ */
+class AsyncLogger
+{
+public:
+  using Level     = DefaultLogger::Level;
+  using Timepoint = DefaultLogger::Timepoint;
+
+  /// The number of entries each thread can queue before it has to wait for the writer
+  static constexpr std::size_t QUEUE_CAPACITY = 1024;
+
+  /// The longest time an entry waits to be written when nobody flushes
+  static constexpr std::chrono::milliseconds WRITE_INTERVAL{10};
+
+  AsyncLogger();
+  AsyncLogger(AsyncLogger const &) = delete;
+  AsyncLogger &operator=(AsyncLogger const &) = delete;
+  ~AsyncLogger();
+
+  void Push(Level level, std::string text);
+  void Flush();
+
+private:
+  struct Entry
+  {
+    Level       level         = Level::INFO;
+    int         thread_number = 0;
+    Timepoint   time;
+    std::string text;
+  };
+
+  struct Queue;
+  struct QueueRef;
+  using QueuePtr = std::shared_ptr<Queue>;
+
+  Queue &LocalQueue();
+  void   Wake();
+  void   Run();
+  void   Drain(std::vector<Entry> &entries);
+  void   Write(std::vector<Entry> &entries);
+
+  uint64_t const id_;
+
+  std::mutex            queues_mutex_;
+  std::vector<QueuePtr> queues_;
+
+  std::mutex              wake_mutex_;
+  std::condition_variable wake_;
+  std::condition_variable flushed_;
+  std::atomic<bool>       pending_{false};
+  uint64_t                flush_requested_{0};
+  uint64_t                flush_completed_{0};
+  bool                    running_{true};
+
+  std::thread thread_;
 };
 
 namespace details {
@@ -301,6 +395,10 @@ public:
 
   ~LogWrapper()
   {
+    // writes out the entries which are still queued
+    async_ = nullptr;
+    async_logger_.reset();
+
     std::lock_guard<std::mutex> lock(mutex_);
     if (log_)
     {
@@ -310,15 +408,64 @@ public:
 
   void DisableLogger()
   {
+    async_ = nullptr;
     if (log_)
     {
       log_.reset();
     }
   }
 
+  /**
+   * Switches to the asynchronous backend, the calling threads only queue their entries and a
+   * background thread writes them. Errors are still written before the call returns
+   */
+  void EnableAsync()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (log_ != nullptr)
+    {
+      if (!async_logger_)
+      {
+        async_logger_ = std::make_unique<AsyncLogger>();
+      }
+      async_ = async_logger_.get();
+    }
+  }
+
+  /**
+   * Switches back to writing the entries on the calling threads, once the queued entries are out
+   */
+  void DisableAsync()
+  {
+    async_ = nullptr;
+    Flush();
+  }
+
+  /**
+   * Waits until the entries queued by the asynchronous backend have been written
+   */
+  void Flush()
+  {
+    AsyncLogger *async_logger = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      async_logger = async_logger_.get();
+    }
+
+    if (async_logger != nullptr)
+    {
+      async_logger->Flush();
+    }
+  }
+
   template <typename... Args>
   void Info(Args &&... args)
   {
+    if (QueueEntry(DefaultLogger::Level::INFO, nullptr, args...))
+    {
+      return;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
     if (this->log_ != nullptr)
     {
@@ -331,6 +478,11 @@ public:
   template <typename... Args>
   void InfoWithName(char const *name, Args &&... args)
   {
+    if (QueueEntry(DefaultLogger::Level::INFO, name, args...))
+    {
+      return;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
     if (this->log_ != nullptr)
     {
@@ -343,6 +495,11 @@ public:
   template <typename... Args>
   void Warn(Args &&... args)
   {
+    if (QueueEntry(DefaultLogger::Level::WARNING, nullptr, args...))
+    {
+      return;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
     if (this->log_ != nullptr)
     {
@@ -355,6 +512,11 @@ public:
   template <typename... Args>
   void WarnWithName(char const *name, Args &&... args)
   {
+    if (QueueEntry(DefaultLogger::Level::WARNING, name, args...))
+    {
+      return;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
     if (this->log_ != nullptr)
     {
@@ -367,6 +529,11 @@ public:
   template <typename... Args>
   void Highlight(Args &&... args)
   {
+    if (QueueEntry(DefaultLogger::Level::HIGHLIGHT, nullptr, args...))
+    {
+      return;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
     if (this->log_ != nullptr)
     {
@@ -379,6 +546,11 @@ public:
   template <typename... Args>
   void HighlightWithName(char const *name, Args &&... args)
   {
+    if (QueueEntry(DefaultLogger::Level::HIGHLIGHT, name, args...))
+    {
+      return;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
     if (this->log_ != nullptr)
     {
@@ -391,6 +563,13 @@ public:
   template <typename... Args>
   void Error(Args &&... args)
   {
+    if (QueueEntry(DefaultLogger::Level::ERROR, nullptr, args...))
+    {
+      // the entry is written before the stack trace
+      FlushAndTrace();
+      return;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
     if (this->log_ != nullptr)
     {
@@ -407,6 +586,13 @@ public:
   template <typename... Args>
   void ErrorWithName(char const *name, Args &&... args)
   {
+    if (QueueEntry(DefaultLogger::Level::ERROR, name, args...))
+    {
+      // the entry is written before the stack trace
+      FlushAndTrace();
+      return;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
     if (this->log_ != nullptr)
     {
@@ -423,6 +609,11 @@ public:
   template <typename... Args>
   void Debug(Args &&... args)
   {
+    if (QueueEntry(DefaultLogger::Level::DEBUG, nullptr, args...))
+    {
+      return;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
     if (this->log_ != nullptr)
     {
@@ -435,6 +626,11 @@ public:
   template <typename... Args>
   void DebugWithName(char const *name, Args const &... args)
   {
+    if (QueueEntry(DefaultLogger::Level::DEBUG, name, args...))
+    {
+      return;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
     if (this->log_ != nullptr)
     {
@@ -446,6 +642,11 @@ public:
 
   void Debug(std::vector<std::string> const &items)
   {
+    if (QueueEntry(DefaultLogger::Level::DEBUG, nullptr, items))
+    {
+      return;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
     if (this->log_ != nullptr)
     {
@@ -460,6 +661,8 @@ public:
 
   void SetContext(shared_context_type ctx)
   {
+    LocalContext() = ctx;
+
     std::thread::id             id = std::this_thread::get_id();
     std::lock_guard<std::mutex> lock(mutex_);
     if (this->log_ != nullptr)
@@ -667,6 +870,66 @@ private:
 
   mutable std::mutex timing_mutex_;
 
+  /**
+   * Formats the entry on the calling thread and queues it on the asynchronous backend, if enabled
+   * @return true if the entry has been queued, false if it has to be written synchronously
+   */
+  template <typename... Args>
+  bool QueueEntry(DefaultLogger::Level level, char const *name, Args const &... args)
+  {
+    AsyncLogger *async_logger = async_.load();
+    if (async_logger == nullptr)
+    {
+      return false;
+    }
+
+    static thread_local std::ostringstream stream;
+    stream.str(std::string{});
+    stream.clear();
+
+    DefaultLogger::WriteSource(stream, level, name, LocalContext().get());
+    AppendTo(stream, args...);
+
+    async_logger->Push(level, stream.str());
+    return true;
+  }
+
+  void FlushAndTrace()
+  {
+    Flush();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (this->log_ != nullptr)
+    {
+      StackTrace();
+    }
+  }
+
+  static void AppendTo(std::ostream &)
+  {}
+
+  template <typename T, typename... Args>
+  static void AppendTo(std::ostream &stream, T const &value, Args const &... args)
+  {
+    stream << value;
+    AppendTo(stream, args...);
+  }
+
+  static void AppendTo(std::ostream &stream, std::vector<std::string> const &items)
+  {
+    for (auto const &item : items)
+    {
+      stream << item;
+    }
+  }
+
+  /// The context of the calling thread, mirrored so the asynchronous path does not take the lock
+  static shared_context_type &LocalContext()
+  {
+    static thread_local shared_context_type context;
+    return context;
+  }
+
   shared_context_type TopContextImpl()
   {
     std::thread::id id = std::this_thread::get_id();
@@ -736,6 +999,8 @@ private:
   }
 
   std::unique_ptr<DefaultLogger>                           log_;
+  std::unique_ptr<AsyncLogger>                             async_logger_;
+  std::atomic<AsyncLogger *>                               async_{nullptr};
   mutable std::mutex                                       mutex_;
   std::unordered_map<std::thread::id, shared_context_type> context_;
 };
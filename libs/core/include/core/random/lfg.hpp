@@ -18,6 +18,8 @@
 //------------------------------------------------------------------------------
 
 #include "lcg.hpp"
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 
@@ -73,6 +75,58 @@ public:
     return double(this->operator()()) * inv_double_max_;
   }
 
+  /**
+   * Fill a buffer with the next random numbers of the sequence, the same values as successive
+   * calls to operator() but copied a whole generated buffer at a time
+   *
+   * @param values The buffer to be filled
+   * @param count The number of values to be generated
+   */
+  void Fill(random_type *values, std::size_t count)
+  {
+    while (count > 0)
+    {
+      if (index_ == (Q - 1))
+      {
+        FillBuffer();
+      }
+
+      std::size_t const available = std::min(count, Q - 1 - index_);
+      std::copy(buffer_ + index_ + 1, buffer_ + index_ + 1 + available, values);
+
+      index_ += available;
+      values += available;
+      count -= available;
+    }
+  }
+
+  /**
+   * Fill a buffer with the same values as successive calls to AsDouble()
+   *
+   * @param values The buffer to be filled
+   * @param count The number of values to be generated
+   */
+  void FillUniform(double *values, std::size_t count)
+  {
+    while (count > 0)
+    {
+      if (index_ == (Q - 1))
+      {
+        FillBuffer();
+      }
+
+      std::size_t const available = std::min(count, Q - 1 - index_);
+      for (std::size_t i = 0; i < available; ++i)
+      {
+        values[i] = double(buffer_[index_ + 1 + i]) * inv_double_max_;
+      }
+
+      index_ += available;
+      values += available;
+      count -= available;
+    }
+  }
+
   static constexpr random_type min()
   {
     return static_cast<random_type>(0);
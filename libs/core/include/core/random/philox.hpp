@@ -0,0 +1,283 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace fetch {
+namespace random {
+
+/**
+ * The Philox4x32-10 counter based generator of Salmon et al.
+ *
+ * Every block of four 32 bit words is a pure function of a key (the seed) and a counter (the
+ * stream and the index of the block), so any position of any stream can be generated directly.
+ * This gives reproducible parallel generation, e.g. one stream per thread or per tensor slice,
+ * whatever the number of threads or the order in which they run.
+ *
+ * Since the blocks are independent of each other, a batch fill generates several blocks at once
+ * in lanes which the compiler is able to vectorise.
+ */
+class Philox4x32
+{
+public:
+  using random_type = uint64_t;
+  using Counter     = std::array<uint32_t, 4>;
+  using Key         = std::array<uint32_t, 2>;
+
+  Philox4x32(random_type seed = 42, random_type stream = 0)
+    : stream_{stream}
+  {
+    Seed(seed);
+  }
+
+  random_type Seed() const
+  {
+    return seed_;
+  }
+
+  /**
+   * Seed the generator, restarting its stream from the beginning
+   *
+   * @param s The seed
+   * @return The seed
+   */
+  random_type Seed(random_type const &s)
+  {
+    seed_     = s;
+    position_ = 0;
+
+    return seed_;
+  }
+
+  random_type Stream() const
+  {
+    return stream_;
+  }
+
+  /**
+   * Switch to another stream of the same seed, starting from its beginning
+   *
+   * @param stream The index of the stream
+   */
+  void SetStream(random_type stream)
+  {
+    stream_   = stream;
+    position_ = 0;
+  }
+
+  void Reset()
+  {
+    Seed(Seed());
+  }
+
+  /**
+   * Move to an arbitrary position in the stream
+   *
+   * @param position The number of values preceding the next one to be generated
+   */
+  void Seek(random_type position)
+  {
+    position_ = position;
+  }
+
+  random_type Position() const
+  {
+    return position_;
+  }
+
+  random_type operator()()
+  {
+    Counter const     block = Block(MakeCounter(position_ / 2), MakeKey());
+    std::size_t const half  = 2 * (position_ % 2);
+    ++position_;
+
+    return Combine(block[half], block[half + 1]);
+  }
+
+  /**
+   * @return A uniform random number in [0, 1)
+   */
+  double AsDouble()
+  {
+    return ToDouble(this->operator()());
+  }
+
+  /**
+   * Fill a buffer with the next random numbers of the stream, the same values as successive calls
+   * to operator()
+   *
+   * @param values The buffer to be filled
+   * @param count The number of values to be generated
+   */
+  void Fill(random_type *values, std::size_t count)
+  {
+    Generate(values, count, [](random_type x) { return x; });
+  }
+
+  /**
+   * Fill a buffer with uniform random numbers in [0, 1), the same values as successive calls to
+   * AsDouble()
+   *
+   * @param values The buffer to be filled
+   * @param count The number of values to be generated
+   */
+  void FillUniform(double *values, std::size_t count)
+  {
+    Generate(values, count, [](random_type x) { return ToDouble(x); });
+  }
+
+  /**
+   * Compute a single block of the generator
+   *
+   * @param counter The counter of the block
+   * @param key The key of the block
+   * @return The four random words of the block
+   */
+  static Counter Block(Counter counter, Key key)
+  {
+    for (std::size_t round = 0; round < ROUNDS; ++round)
+    {
+      uint64_t const p0 = uint64_t{MULTIPLIER_0} * counter[0];
+      uint64_t const p1 = uint64_t{MULTIPLIER_1} * counter[2];
+
+      counter = {{static_cast<uint32_t>(p1 >> 32) ^ counter[1] ^ key[0], static_cast<uint32_t>(p1),
+                  static_cast<uint32_t>(p0 >> 32) ^ counter[3] ^ key[1], static_cast<uint32_t>(p0)}};
+
+      key[0] += WEYL_0;
+      key[1] += WEYL_1;
+    }
+
+    return counter;
+  }
+
+  static constexpr random_type min()
+  {
+    return std::numeric_limits<random_type>::min();
+  }
+
+  static constexpr random_type max()
+  {
+    return std::numeric_limits<random_type>::max();
+  }
+
+private:
+  static constexpr std::size_t ROUNDS       = 10;
+  static constexpr std::size_t LANES        = 8;  ///< The blocks generated together in a batch
+  static constexpr uint32_t    MULTIPLIER_0 = 0xD2511F53;
+  static constexpr uint32_t    MULTIPLIER_1 = 0xCD9E8D57;
+  static constexpr uint32_t    WEYL_0       = 0x9E3779B9;
+  static constexpr uint32_t    WEYL_1       = 0xBB67AE85;
+
+  static random_type Combine(uint32_t low, uint32_t high)
+  {
+    return random_type{low} | (random_type{high} << 32);
+  }
+
+  static double ToDouble(random_type x)
+  {
+    // the upper 53 bits fill the mantissa exactly
+    return static_cast<double>(x >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+  Counter MakeCounter(random_type block) const
+  {
+    return {{static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32),
+             static_cast<uint32_t>(stream_), static_cast<uint32_t>(stream_ >> 32)}};
+  }
+
+  Key MakeKey() const
+  {
+    return {{static_cast<uint32_t>(seed_), static_cast<uint32_t>(seed_ >> 32)}};
+  }
+
+  template <typename T, typename Transform>
+  void Generate(T *values, std::size_t count, Transform const &transform)
+  {
+    std::size_t i = 0;
+
+    // finish a partially consumed block one value at a time
+    for (; (i < count) && ((position_ % 2) != 0); ++i)
+    {
+      values[i] = transform(this->operator()());
+    }
+
+    // then whole batches of blocks, computed lane wise in structure of arrays form
+    Key const         key        = MakeKey();
+    std::size_t const batch_size = 2 * LANES;
+    for (; (count - i) >= batch_size; i += batch_size)
+    {
+      uint32_t x0[LANES];
+      uint32_t x1[LANES];
+      uint32_t x2[LANES];
+      uint32_t x3[LANES];
+
+      random_type const first = position_ / 2;
+      for (std::size_t lane = 0; lane < LANES; ++lane)
+      {
+        x0[lane] = static_cast<uint32_t>(first + lane);
+        x1[lane] = static_cast<uint32_t>((first + lane) >> 32);
+        x2[lane] = static_cast<uint32_t>(stream_);
+        x3[lane] = static_cast<uint32_t>(stream_ >> 32);
+      }
+
+      uint32_t k0 = key[0];
+      uint32_t k1 = key[1];
+      for (std::size_t round = 0; round < ROUNDS; ++round)
+      {
+        for (std::size_t lane = 0; lane < LANES; ++lane)
+        {
+          uint64_t const p0 = uint64_t{MULTIPLIER_0} * x0[lane];
+          uint64_t const p1 = uint64_t{MULTIPLIER_1} * x2[lane];
+
+          x0[lane] = static_cast<uint32_t>(p1 >> 32) ^ x1[lane] ^ k0;
+          x1[lane] = static_cast<uint32_t>(p1);
+          x2[lane] = static_cast<uint32_t>(p0 >> 32) ^ x3[lane] ^ k1;
+          x3[lane] = static_cast<uint32_t>(p0);
+        }
+
+        k0 += WEYL_0;
+        k1 += WEYL_1;
+      }
+
+      for (std::size_t lane = 0; lane < LANES; ++lane)
+      {
+        values[i + (2 * lane)]     = transform(Combine(x0[lane], x1[lane]));
+        values[i + (2 * lane) + 1] = transform(Combine(x2[lane], x3[lane]));
+      }
+
+      position_ += batch_size;
+    }
+
+    // and the remainder one value at a time
+    for (; i < count; ++i)
+    {
+      values[i] = transform(this->operator()());
+    }
+  }
+
+  random_type seed_     = 42;
+  random_type stream_   = 0;
+  random_type position_ = 0;  ///< The index of the next value in the stream
+};
+
+}  // namespace random
+}  // namespace fetch
@@ -0,0 +1,206 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace fetch {
+namespace random {
+
+/**
+ * The xoshiro256++ generator of Blackman and Vigna: a small, fast generator with a period of
+ * 2^256 - 1, well suited to filling large buffers.
+ *
+ * Independent streams for parallel generation are made by seeding every stream identically and
+ * then calling Jump() once per stream index, each jump advancing the generator by 2^128 numbers.
+ */
+class Xoshiro256PlusPlus
+{
+public:
+  using random_type = uint64_t;
+
+  Xoshiro256PlusPlus(random_type seed = 42)
+  {
+    Seed(seed);
+  }
+
+  random_type Seed() const
+  {
+    return seed_;
+  }
+
+  random_type Seed(random_type const &s)
+  {
+    // expand the seed into the state with splitmix64, as recommended by the authors
+    random_type x = seed_ = s;
+    for (auto &word : state_)
+    {
+      x += 0x9e3779b97f4a7c15ull;
+
+      random_type z = x;
+      z             = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+      z             = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+      word          = z ^ (z >> 31);
+    }
+
+    return seed_;
+  }
+
+  void Reset()
+  {
+    Seed(Seed());
+  }
+
+  random_type operator()()
+  {
+    random_type const result = Rotate(state_[0] + state_[3], 23) + state_[0];
+    random_type const t      = state_[1] << 17;
+
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = Rotate(state_[3], 45);
+
+    return result;
+  }
+
+  /**
+   * @return A uniform random number in [0, 1)
+   */
+  double AsDouble()
+  {
+    return ToDouble(this->operator()());
+  }
+
+  /**
+   * Fill a buffer with the next random numbers of the sequence
+   *
+   * @param values The buffer to be filled
+   * @param count The number of values to be generated
+   */
+  void Fill(random_type *values, std::size_t count)
+  {
+    // work on a local copy of the state so that it can be kept in registers
+    Xoshiro256PlusPlus local{*this};
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      values[i] = local();
+    }
+
+    *this = local;
+  }
+
+  /**
+   * Fill a buffer with uniform random numbers in [0, 1), the same values as successive calls to
+   * AsDouble()
+   *
+   * @param values The buffer to be filled
+   * @param count The number of values to be generated
+   */
+  void FillUniform(double *values, std::size_t count)
+  {
+    Xoshiro256PlusPlus local{*this};
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      values[i] = ToDouble(local());
+    }
+
+    *this = local;
+  }
+
+  /**
+   * Advance the generator by 2^128 numbers, equivalent to that many calls to operator()
+   */
+  void Jump()
+  {
+    static constexpr random_type JUMP[] = {0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull,
+                                           0xa9582618e03fc9aaull, 0x39abdc4529b1661cull};
+    Advance(JUMP);
+  }
+
+  /**
+   * Advance the generator by 2^192 numbers, used to make streams of streams
+   */
+  void LongJump()
+  {
+    static constexpr random_type LONG_JUMP[] = {0x76e15d3efefdcbbfull, 0xc5004e441c522fb3ull,
+                                                0x77710069854ee241ull, 0x39109bb02acbe635ull};
+    Advance(LONG_JUMP);
+  }
+
+  static constexpr random_type min()
+  {
+    return std::numeric_limits<random_type>::min();
+  }
+
+  static constexpr random_type max()
+  {
+    return std::numeric_limits<random_type>::max();
+  }
+
+private:
+  static random_type Rotate(random_type x, int k)
+  {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  static double ToDouble(random_type x)
+  {
+    // the upper 53 bits fill the mantissa exactly
+    return static_cast<double>(x >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+  void Advance(random_type const (&polynomial)[4])
+  {
+    random_type s0 = 0;
+    random_type s1 = 0;
+    random_type s2 = 0;
+    random_type s3 = 0;
+
+    for (auto const word : polynomial)
+    {
+      for (int b = 0; b < 64; ++b)
+      {
+        if (word & (random_type{1} << b))
+        {
+          s0 ^= state_[0];
+          s1 ^= state_[1];
+          s2 ^= state_[2];
+          s3 ^= state_[3];
+        }
+
+        this->operator()();
+      }
+    }
+
+    state_[0] = s0;
+    state_[1] = s1;
+    state_[2] = s2;
+    state_[3] = s3;
+  }
+
+  random_type seed_ = 42;
+  random_type state_[4]{};
+};
+
+}  // namespace random
+}  // namespace fetch
@@ -21,6 +21,7 @@
 #include "core/runnable.hpp"
 
 #include <atomic>
+#include <condition_variable>
 #include <map>
 #include <memory>
 #include <thread>
@@ -37,13 +38,14 @@ public:
   explicit Reactor(std::string name);
   Reactor(Reactor const &) = delete;
   Reactor(Reactor &&)      = delete;
-  ~Reactor()               = default;
+  ~Reactor();
 
   bool Attach(WeakRunnable runnable);
   bool Detach(Runnable const &runnable);
 
   void Start();
   void Stop();
+  void Wake();
 
   // Operators
   Reactor &operator=(Reactor const &) = delete;
@@ -67,6 +69,10 @@ private:
 
   Mutex     worker_mutex_{__LINE__, __FILE__};
   ThreadPtr worker_{};
+
+  std::mutex              wake_mutex_;
+  std::condition_variable wake_condition_;
+  bool                    wake_pending_{false};  ///< Guarded by `wake_mutex_`
 };
 
 }  // namespace core
@@ -17,7 +17,10 @@
 //
 //------------------------------------------------------------------------------
 
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
 
 namespace fetch {
 namespace core {
@@ -28,6 +31,9 @@ namespace core {
 class Runnable
 {
 public:
+  using Clock     = std::chrono::steady_clock;
+  using Timepoint = Clock::time_point;
+
   // Construction / Destruction
   Runnable()          = default;
   virtual ~Runnable() = default;
@@ -39,13 +45,56 @@ public:
     return true;
   }
   virtual void Execute() = 0;
+
+  /**
+   * Determine when a runnable which is not ready to execute should next be evaluated, assuming it
+   * is not woken before then. Runnables which are unable to tell are polled by their reactor.
+   *
+   * @return The time of the next evaluation, Timepoint::max() if the runnable only becomes ready
+   * when woken, or Timepoint::min() if it must be polled
+   */
+  virtual Timepoint NextEvaluation() const
+  {
+    return Timepoint::min();
+  }
   /// @}
 
+  using WakeCallback = std::function<void()>;
+
+  /**
+   * Configure the callback used to signal that the runnable has become ready to execute. This is
+   * set by the reactor to which the runnable is attached.
+   *
+   * @param cb The callback to be triggered
+   */
+  void SetWakeCallback(WakeCallback cb)
+  {
+    std::lock_guard<std::mutex> lock(wake_lock_);
+    wake_callback_ = std::move(cb);
+  }
+
+  /**
+   * Signal that the runnable should be executed as soon as possible, rather than waiting for the
+   * next poll of its reactor. Safe to be called from any thread.
+   */
+  virtual void Wake()
+  {
+    std::lock_guard<std::mutex> lock(wake_lock_);
+    if (wake_callback_)
+    {
+      wake_callback_();
+    }
+  }
+
   // Helper operators
   void operator()()
   {
     Execute();
   }
+
+private:
+  std::mutex   wake_lock_;
+  WakeCallback wake_callback_{};
 };
 
 using WeakRunnable = std::weak_ptr<Runnable>;
@@ -18,6 +18,7 @@
 //------------------------------------------------------------------------------
 
 #include "core/assert.hpp"
+#include "core/byte_array/byte_array.hpp"
 #include "core/byte_array/const_byte_array.hpp"
 
 #include <type_traits>
@@ -47,5 +48,18 @@ inline void Deserialize(T &serializer, byte_array::ConstByteArray &s)
   serializer.ReadByteArray(s, size);
 }
 
+/**
+ * Deserialize a mutable byte array. Unlike the immutable case, which produces a view into the
+ * serializer's buffer, the contents are copied since the result may be modified.
+ */
+template <typename T>
+inline void Deserialize(T &serializer, byte_array::ByteArray &s)
+{
+  byte_array::ConstByteArray view;
+  Deserialize(serializer, view);
+
+  s = view.Copy();
+}
+
 }  // namespace serializers
 }  // namespace fetch
@@ -23,6 +23,8 @@
 #include "core/serializers/counter.hpp"
 
 #include "core/logger.hpp"
+
+#include <algorithm>
 #include <type_traits>
 
 namespace fetch {
@@ -58,6 +60,24 @@ public:
     : data_{s.Copy()}
   {}
 
+  /**
+   * @brief Constructing from IMMUTABLE ConstByteArray.
+   *
+   * No copy is made, the buffer is a view of the contents of @ref s. Byte arrays deserialised from
+   * the buffer are in turn sub-array views of the same memory, call Copy() on them where an
+   * independent copy is required (for example to avoid keeping a large message alive).
+   *
+   * The view is detached (copied) before the first modification of the buffer, so writing to the
+   * buffer never modifies @ref s.
+   *
+   * @param s Input immutable instance of ConstByteArray to be viewed
+   */
+  ByteArrayBufferEx(byte_array::ConstByteArray const &s)
+    : shared_{true}
+  {
+    data_.FromByteArray(s, 0, s.size());
+  }
+
   ByteArrayBufferEx(ByteArrayBufferEx const &from)
     : data_{from.data_.Copy()}
     , pos_{from.pos_}
@@ -85,6 +105,7 @@ public:
               ResizeParadigm const &resize_paradigm     = ResizeParadigm::RELATIVE,
               bool const            zero_reserved_space = true)
   {
+    Detach((resize_paradigm == ResizeParadigm::RELATIVE) ? data_.size() + size : size);
     data_.Resize(size, resize_paradigm, zero_reserved_space);
 
     switch (resize_paradigm)
@@ -105,11 +126,13 @@ public:
                ResizeParadigm const &resize_paradigm     = ResizeParadigm::RELATIVE,
                bool const            zero_reserved_space = true)
   {
+    Detach((resize_paradigm == ResizeParadigm::RELATIVE) ? capacity() + size : size);
     data_.Reserve(size, resize_paradigm, zero_reserved_space);
   }
 
   void WriteBytes(uint8_t const *arr, std::size_t const &size)
   {
+    Detach();
     data_.WriteBytes(arr, size, pos_);
     pos_ += size;
   }
@@ -122,7 +145,9 @@ public:
 
   void ReadByteArray(byte_array::ConstByteArray &b, std::size_t const &size)
   {
-    b = data_.SubArray(pos_, size);
+    // the immutable sub array copies small arrays, rather than keeping the buffer alive
+    byte_array::ConstByteArray const &data = data_;
+    b = data.SubArray(pos_, size);
     pos_ += size;
   }
 
@@ -187,7 +212,8 @@ public:
 
   std::size_t capacity() const
   {
-    return data_.capacity();
+    // a view can not be written to in place, so has no usable spare capacity
+    return shared_ ? data_.size() : data_.capacity();
   }
 
   int64_t bytes_left() const
@@ -199,6 +225,15 @@ public:
     return data_;
   }
 
+  /**
+   * Serialise a sequence of objects in two passes: the first pass measures the exact number of
+   * bytes required with the size counter, the buffer is then reserved once to that size and the
+   * second pass writes the data. Nested Append calls made while serialising the objects reuse the
+   * outer measurement rather than counting again.
+   *
+   * @param args The objects to be serialised
+   * @return The buffer
+   */
   template <typename... ARGS>
   self_type &Append(ARGS const &... args)
   {
@@ -209,9 +244,12 @@ public:
       size_counter_.seek(tell());
 
       size_counter_.Append(args...);
-      if (size() < size_counter_.size())
+
+      // the reservation is absolute so that spare capacity already present in the buffer is used
+      // rather than grown on top of
+      if (capacity() < size_counter_.size())
       {
-        Reserve(size_counter_.size() - size());
+        Reserve(size_counter_.size(), ResizeParadigm::ABSOLUTE);
       }
     }
 
@@ -230,8 +268,28 @@ private:
   void AppendInternal()
   {}
 
+  /**
+   * Replace a view of a shared array with an owned copy of its contents, ready to be modified
+   *
+   * @param capacity The minimum capacity of the copy
+   */
+  void Detach(std::size_t capacity = 0)
+  {
+    if (shared_)
+    {
+      byte_array_type owned;
+      owned.Reserve(std::max(capacity, data_.size()));
+      owned.Resize(data_.size());
+      owned.WriteBytes(data_.pointer(), data_.size());
+
+      data_   = std::move(owned);
+      shared_ = false;
+    }
+  }
+
   byte_array_type   data_;
-  std::size_t       pos_ = 0;
+  std::size_t       pos_    = 0;
+  bool              shared_ = false;
   size_counter_type size_counter_;
 };
 
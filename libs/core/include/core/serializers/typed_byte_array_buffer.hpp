@@ -73,6 +73,15 @@ TypedByteArrayBuffer &TypedByteArrayBuffer::operator>>(T &val)
   return *this;
 }
 
+template <>
+template <typename T>
+SizeCounter<TypedByteArrayBuffer> &SizeCounter<TypedByteArrayBuffer>::operator<<(T const *val)
+{
+  Serialize(*this, TypeRegister<void>::value_type(TypeRegister<T const *>::value));
+  Serialize(*this, val);
+  return *this;
+}
+
 template <>
 template <typename T>
 SizeCounter<TypedByteArrayBuffer> &SizeCounter<TypedByteArrayBuffer>::operator<<(T const &val)
@@ -109,7 +118,9 @@ inline void TypedByteArrayBuffer::ReadByteArray(byte_array::ConstByteArray &b,
                                     std::to_string(bytes_left()) + " not  " + std::to_string(size));
   }
 
-  b = data_.SubArray(pos_, size);
+  // the immutable sub array copies small arrays, rather than keeping the buffer alive
+  byte_array::ConstByteArray const &data = data_;
+  b = data.SubArray(pos_, size);
   pos_ += size;
 }
 
@@ -35,12 +35,16 @@ static constexpr uint16_t CHANNEL_RPC = 1;  // for convience we essentially
                                             // potential RPC interface
 
 // Muddle Service Channels
-static constexpr uint16_t CHANNEL_ROUTING = 1;
+static constexpr uint16_t CHANNEL_ROUTING    = 1;
+static constexpr uint16_t CHANNEL_BATCH      = 2;
+static constexpr uint16_t CHANNEL_COMPRESSED = 3;
 
 // P2P Service Channels
 
 // Main Chain Service Channels
-static constexpr uint16_t CHANNEL_BLOCKS = 2;
+static constexpr uint16_t CHANNEL_BLOCKS         = 2;
+static constexpr uint16_t CHANNEL_BLOCK_STREAM   = 3;
+static constexpr uint16_t CHANNEL_COMPACT_BLOCKS = 4;
 
 // RPC Protocol identifiers
 static constexpr uint64_t RPC_MAIN_CHAIN = 128;
@@ -55,5 +59,6 @@ static constexpr uint64_t RPC_CONTROLLER        = 206;
 static constexpr uint64_t RPC_EXECUTION_MANAGER = 207;
 static constexpr uint64_t RPC_EXECUTOR          = 208;
 static constexpr uint64_t RPC_P2P_RESOLVER      = 209;
+static constexpr uint64_t RPC_STATE_SNAPSHOT    = 210;
 
 }  // namespace fetch
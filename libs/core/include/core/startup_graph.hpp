@@ -0,0 +1,314 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/logger.hpp"
+#include "core/threading.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace fetch {
+namespace core {
+
+/**
+ * Starts a set of subsystems, each as soon as all of the subsystems it depends on are ready
+ *
+ * Every stage runs on its own thread and returns once its subsystem is ready (or has failed), so
+ * independent subsystems start concurrently. Stages whose dependencies failed are skipped.
+ */
+class StartupGraph
+{
+public:
+  using Stage = std::function<bool()>;  ///< Starts a subsystem, true once it is ready
+  using Names = std::vector<std::string>;
+
+  static constexpr char const *LOGGING_NAME = "StartupGraph";
+
+  // Construction / Destruction
+  StartupGraph()                     = default;
+  StartupGraph(StartupGraph const &) = delete;
+  StartupGraph(StartupGraph &&)      = delete;
+  ~StartupGraph()                    = default;
+
+  void Add(std::string name, Names dependencies, Stage stage);
+  bool Run();
+
+  // Operators
+  StartupGraph &operator=(StartupGraph const &) = delete;
+  StartupGraph &operator=(StartupGraph &&) = delete;
+
+private:
+  enum class Status
+  {
+    PENDING,
+    RUNNING,
+    READY,
+    FAILED,
+    SKIPPED
+  };
+
+  struct Node
+  {
+    std::string              name{};
+    Names                    dependencies{};
+    Stage                    stage{};
+    Status                   status{Status::PENDING};
+    std::size_t              remaining{0};  ///< The number of dependencies not yet ready
+    std::vector<std::size_t> dependents{};  ///< The nodes which depend on this one
+  };
+
+  using Nodes   = std::vector<Node>;
+  using Threads = std::vector<std::thread>;
+
+  void        Link();
+  std::size_t Lookup(std::string const &name) const;
+  void        Launch(std::size_t index, Threads &threads);
+  void        Skip(std::size_t index);
+
+  Nodes                    nodes_;
+  std::mutex               lock_;
+  std::condition_variable  completed_cv_;
+  std::vector<std::size_t> completed_;  ///< The nodes which have finished but not been processed
+};
+
+/**
+ * Add a stage to the graph
+ *
+ * @param name The unique name of the subsystem
+ * @param dependencies The names of the subsystems which must be ready before this one starts
+ * @param stage The function starting the subsystem, returning once it is ready
+ */
+inline void StartupGraph::Add(std::string name, Names dependencies, Stage stage)
+{
+  Node node{};
+  node.name         = std::move(name);
+  node.dependencies = std::move(dependencies);
+  node.stage        = std::move(stage);
+
+  nodes_.push_back(std::move(node));
+}
+
+/**
+ * Run every stage of the graph, each as soon as its dependencies are ready. Throws if a dependency
+ * is unknown or the dependencies form a cycle.
+ *
+ * @return true if every subsystem is ready, false if any of them failed
+ */
+inline bool StartupGraph::Run()
+{
+  Link();
+
+  Threads     threads;
+  std::size_t running{0};
+  bool        success{true};
+
+  {
+    std::unique_lock<std::mutex> lock(lock_);
+
+    for (std::size_t i = 0; i < nodes_.size(); ++i)
+    {
+      if (nodes_[i].remaining == 0)
+      {
+        Launch(i, threads);
+        ++running;
+      }
+    }
+
+    while (running > 0)
+    {
+      completed_cv_.wait(lock, [this]() { return !completed_.empty(); });
+
+      std::vector<std::size_t> completed;
+      std::swap(completed, completed_);
+
+      for (auto const index : completed)
+      {
+        --running;
+
+        Node &node = nodes_[index];
+        if (node.status == Status::FAILED)
+        {
+          success = false;
+          Skip(index);
+          continue;
+        }
+
+        for (auto const dependent : node.dependents)
+        {
+          Node &next = nodes_[dependent];
+          if ((next.status == Status::PENDING) && (--next.remaining == 0))
+          {
+            Launch(dependent, threads);
+            ++running;
+          }
+        }
+      }
+    }
+  }
+
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  return success;
+}
+
+/**
+ * Internal: Resolve the dependencies of every node, checking that they form no cycle
+ */
+inline void StartupGraph::Link()
+{
+  for (std::size_t i = 0; i < nodes_.size(); ++i)
+  {
+    nodes_[i].remaining = nodes_[i].dependencies.size();
+
+    for (auto const &dependency : nodes_[i].dependencies)
+    {
+      nodes_[Lookup(dependency)].dependents.push_back(i);
+    }
+  }
+
+  // every node can only be ordered if the dependencies are acyclic
+  std::vector<std::size_t> remaining(nodes_.size());
+  std::vector<std::size_t> ready;
+  for (std::size_t i = 0; i < nodes_.size(); ++i)
+  {
+    remaining[i] = nodes_[i].remaining;
+    if (remaining[i] == 0)
+    {
+      ready.push_back(i);
+    }
+  }
+
+  std::size_t ordered{0};
+  while (!ready.empty())
+  {
+    std::size_t const index = ready.back();
+    ready.pop_back();
+    ++ordered;
+
+    for (auto const dependent : nodes_[index].dependents)
+    {
+      if (--remaining[dependent] == 0)
+      {
+        ready.push_back(dependent);
+      }
+    }
+  }
+
+  if (ordered != nodes_.size())
+  {
+    throw std::runtime_error("The startup dependencies form a cycle");
+  }
+}
+
+inline std::size_t StartupGraph::Lookup(std::string const &name) const
+{
+  for (std::size_t i = 0; i < nodes_.size(); ++i)
+  {
+    if (nodes_[i].name == name)
+    {
+      return i;
+    }
+  }
+
+  throw std::runtime_error("Unknown startup dependency: " + name);
+}
+
+/**
+ * Internal: Start the stage of a node on its own thread (called with the lock held)
+ *
+ * @param index The index of the node
+ * @param threads The threads of the stages
+ */
+inline void StartupGraph::Launch(std::size_t index, Threads &threads)
+{
+  nodes_[index].status = Status::RUNNING;
+
+  threads.emplace_back([this, index]() {
+    Node &node = nodes_[index];
+
+    SetThreadName("Startup", index);
+
+    auto const start = std::chrono::steady_clock::now();
+
+    bool ready{false};
+    try
+    {
+      ready = node.stage();
+    }
+    catch (std::exception const &ex)
+    {
+      FETCH_LOG_ERROR(LOGGING_NAME, "Starting ", node.name, " failed: ", ex.what());
+    }
+
+    auto const elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    if (ready)
+    {
+      FETCH_LOG_INFO(LOGGING_NAME, "Started ", node.name, " in ", elapsed.count(), " ms");
+    }
+    else
+    {
+      FETCH_LOG_ERROR(LOGGING_NAME, "Unable to start ", node.name);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      node.status = ready ? Status::READY : Status::FAILED;
+      completed_.push_back(index);
+    }
+
+    completed_cv_.notify_one();
+  });
+}
+
+/**
+ * Internal: Skip every node which (transitively) depends on a failed node
+ *
+ * @param index The index of the failed node
+ */
+inline void StartupGraph::Skip(std::size_t index)
+{
+  for (auto const dependent : nodes_[index].dependents)
+  {
+    Node &next = nodes_[dependent];
+    if (next.status == Status::PENDING)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Skipping ", next.name, " since ", nodes_[index].name,
+                     " failed");
+
+      next.status = Status::SKIPPED;
+      Skip(dependent);
+    }
+  }
+}
+
+}  // namespace core
+}  // namespace fetch
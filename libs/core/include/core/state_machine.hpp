@@ -24,57 +24,109 @@
 
 #include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 namespace fetch {
 namespace core {
 
+/**
+ * An entry of a compile time state table: the handler of a single state, which is a member
+ * function of the owner of the state machine taking either no arguments or the current and
+ * previous states.
+ *
+ * @tparam C The type of the owner of the handlers
+ * @tparam S The type of the state
+ */
+template <typename C, typename S>
+struct StateHandler
+{
+  using Simple     = S (C::*)();
+  using Transition = S (C::*)(S /*current*/, S /*previous*/);
+
+  constexpr StateHandler(S s, Simple handler)
+    : state{s}
+    , simple{handler}
+    , transition{nullptr}
+  {}
+
+  constexpr StateHandler(S s, Transition handler)
+    : state{s}
+    , simple{nullptr}
+    , transition{handler}
+  {}
+
+  S          state;
+  Simple     simple;
+  Transition transition;
+};
+
+/**
+ * Check that each entry of a state table is found at the index of its state, so that the table
+ * can be indexed directly by the state. Intended to be used in a static_assert by the owner of the
+ * table.
+ *
+ * @param table The state table
+ * @return true if the table is ordered by state, otherwise false
+ */
+template <typename C, typename S, std::size_t N>
+constexpr bool IsStateTableOrdered(StateHandler<C, S> const (&table)[N])
+{
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    if (static_cast<std::size_t>(table[i].state) != i)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * The parts of a state machine which do not depend on how the handlers are dispatched: delays,
+ * wake ups, the state change callback and the time spent in each state.
+ *
+ * @tparam State The type of the state
+ */
 template <typename State>
-class StateMachine : public StateMachineInterface, public Runnable
+class StateMachineBase : public StateMachineInterface, public Runnable
 {
 public:
   static_assert(std::is_enum<State>::value, "");
 
-  using Callback            = std::function<State(State /*current*/, State /*previous*/)>;
   using StateChangeCallback = std::function<void(State /*current*/, State /*previous*/)>;
   using StateMapper         = std::function<char const *(State)>;
 
   // Construction / Destruction
-  explicit StateMachine(std::string name, State initial, StateMapper mapper = StateMapper{});
-  StateMachine(StateMachine const &)     = delete;
-  StateMachine(StateMachine &&) noexcept = delete;
-  ~StateMachine() override               = default;
+  StateMachineBase(std::string name, State initial, StateMapper mapper);
+  StateMachineBase(StateMachineBase const &)     = delete;
+  StateMachineBase(StateMachineBase &&) noexcept = delete;
+  ~StateMachineBase() override                   = default;
 
   /// @name State Control
   /// @{
-  template <typename C>
-  void RegisterHandler(State state, C *instance,
-                       State (C::*func)(State /*current*/, State /*previous*/));
-  template <typename C>
-  void RegisterHandler(State state, C *instance, State (C::*func)(State /*current*/));
-  template <typename C>
-  void RegisterHandler(State state, C *instance, State (C::*func)());
-
-  void Reset();
-
   void OnStateChange(StateChangeCallback cb);
   /// @}
 
   /// @name State Machine Interface
   /// @{
-  char const *GetName() const override;
-  uint64_t    GetStateCode() const override;
-  char const *GetStateName() const override;
+  char const * GetName() const override;
+  uint64_t     GetStateCode() const override;
+  char const * GetStateName() const override;
+  StateTimings GetStateTimings() const override;
   /// @}
 
   /// @name Runnable Interface
   /// @{
-  bool IsReadyToExecute() const override;
-  void Execute() override;
+  bool      IsReadyToExecute() const override;
+  Timepoint NextEvaluation() const override;
+  void      Wake() override;
   /// @}
 
   State state() const
@@ -86,94 +138,168 @@ public:
   void Delay(std::chrono::duration<R, P> const &delay);
 
   // Operators
-  StateMachine &operator=(StateMachine const &) = delete;
-  StateMachine &operator=(StateMachine &&) = delete;
+  StateMachineBase &operator=(StateMachineBase const &) = delete;
+  StateMachineBase &operator=(StateMachineBase &&) = delete;
+
+protected:
+  using Mutex = std::mutex;
+
+  void BeginExecution();
+  void CompleteExecution(State next, Timepoint started);
+  void ClearStateChangeCallback();
+
+  mutable Mutex      callbacks_mutex_;
+  std::atomic<State> current_state_;
+  std::atomic<State> previous_state_{current_state_.load()};
 
 private:
-  using Clock       = std::chrono::steady_clock;
-  using Timepoint   = Clock::time_point;
-  using Duration    = Clock::duration;
-  using CallbackMap = std::unordered_map<State, Callback>;
-  using Mutex       = std::mutex;
+  using Duration = Clock::duration;
+
+  struct Timing
+  {
+    uint64_t entries{0};
+    uint64_t executions{0};
+    Duration execution{};
+    Duration residence{};
+  };
+
+  using Timings = std::vector<Timing>;
+
+  Timing &TimingOf(State state);
+
+  static double ToSeconds(Duration const &duration)
+  {
+    return std::chrono::duration_cast<std::chrono::duration<double>>(duration).count();
+  }
 
   std::string const   name_;
   StateMapper         mapper_;
-  mutable Mutex       callbacks_mutex_;
-  CallbackMap         callbacks_{};
-  Duration            stall_duration_{};
-  std::atomic<State>  current_state_;
-  std::atomic<State>  previous_state_{current_state_.load()};
   Timepoint           next_execution_{};
+  std::atomic<bool>   woken_{false};  ///< Set when the machine should execute despite any delay
   StateChangeCallback state_change_callback_{};
+  mutable Mutex       timings_mutex_;
+  Timings             timings_{};              ///< Indexed by state
+  Timepoint           entered_{Clock::now()};  ///< When the current state was entered
 };
 
-template <typename S>
-StateMachine<S>::StateMachine(std::string name, S initial, StateMapper mapper)
-  : name_{std::move(name)}
-  , mapper_{std::move(mapper)}
-  , current_state_{initial}
-{}
-
-template <typename S>
-template <typename C>
-void StateMachine<S>::RegisterHandler(S state, C *instance,
-                                      S (C::*func)(S /*current*/, S /*previous*/))
+/**
+ * A state machine dispatching through a compile time table of the member functions of its owner,
+ * indexed directly by the state. States beyond the end of the table have no handler.
+ *
+ * The table is expected to be a constexpr static member of the owner, checked with
+ * IsStateTableOrdered.
+ *
+ * @tparam State The type of the state
+ * @tparam Owner The type of the owner of the handlers, void for runtime registered handlers
+ */
+template <typename State, typename Owner = void>
+class StateMachine : public StateMachineBase<State>
 {
-  FETCH_LOCK(callbacks_mutex_);
-  callbacks_[state] = [instance, func](S state, S prev) { return (instance->*func)(state, prev); };
-}
+public:
+  using Handler     = StateHandler<Owner, State>;
+  using StateMapper = typename StateMachineBase<State>::StateMapper;
 
-template <typename S>
-template <typename C>
-void StateMachine<S>::RegisterHandler(S state, C *instance, S (C::*func)(S /*current*/))
-{
-  FETCH_LOCK(callbacks_mutex_);
-  callbacks_[state] = [instance, func](S state, S prev) {
-    FETCH_UNUSED(prev);
-    return (instance->*func)(state);
-  };
-}
+  // Construction / Destruction
+  template <std::size_t N>
+  StateMachine(std::string name, State initial, Owner *owner, Handler const (&table)[N],
+               StateMapper mapper = StateMapper{});
+  StateMachine(StateMachine const &)     = delete;
+  StateMachine(StateMachine &&) noexcept = delete;
+  ~StateMachine() override               = default;
 
-template <typename S>
-template <typename C>
-void StateMachine<S>::RegisterHandler(S state, C *instance, S (C::*func)())
+  void Reset();
+
+  /// @name Runnable Interface
+  /// @{
+  void Execute() override;
+  /// @}
+
+  // Operators
+  StateMachine &operator=(StateMachine const &) = delete;
+  StateMachine &operator=(StateMachine &&) = delete;
+
+private:
+  Owner *              owner_;
+  Handler const *const table_;
+  std::size_t const    table_size_;
+};
+
+/**
+ * A state machine whose handlers are registered at runtime
+ *
+ * @tparam State The type of the state
+ */
+template <typename State>
+class StateMachine<State, void> : public StateMachineBase<State>
 {
-  FETCH_LOCK(callbacks_mutex_);
-  callbacks_[state] = [instance, func](S state, S prev) {
-    FETCH_UNUSED(state);
-    FETCH_UNUSED(prev);
-    return (instance->*func)();
-  };
-}
+public:
+  using Callback    = std::function<State(State /*current*/, State /*previous*/)>;
+  using StateMapper = typename StateMachineBase<State>::StateMapper;
+
+  // Construction / Destruction
+  explicit StateMachine(std::string name, State initial, StateMapper mapper = StateMapper{});
+  StateMachine(StateMachine const &)     = delete;
+  StateMachine(StateMachine &&) noexcept = delete;
+  ~StateMachine() override               = default;
+
+  /// @name State Control
+  /// @{
+  template <typename C>
+  void RegisterHandler(State state, C *instance,
+                       State (C::*func)(State /*current*/, State /*previous*/));
+  template <typename C>
+  void RegisterHandler(State state, C *instance, State (C::*func)(State /*current*/));
+  template <typename C>
+  void RegisterHandler(State state, C *instance, State (C::*func)());
+
+  void Reset();
+  /// @}
+
+  /// @name Runnable Interface
+  /// @{
+  void Execute() override;
+  /// @}
+
+  // Operators
+  StateMachine &operator=(StateMachine const &) = delete;
+  StateMachine &operator=(StateMachine &&) = delete;
+
+private:
+  using CallbackMap = std::unordered_map<State, Callback>;
+
+  CallbackMap callbacks_{};
+};
 
 template <typename S>
-void StateMachine<S>::Reset()
+StateMachineBase<S>::StateMachineBase(std::string name, S initial, StateMapper mapper)
+  : current_state_{initial}
+  , name_{std::move(name)}
+  , mapper_{std::move(mapper)}
 {
-  FETCH_LOCK(callbacks_mutex_);
-  callbacks_.clear();
-  state_change_callback_ = StateChangeCallback{};
+  ++TimingOf(initial).entries;
 }
+
 template <typename S>
-void StateMachine<S>::OnStateChange(StateChangeCallback cb)
+void StateMachineBase<S>::OnStateChange(StateChangeCallback cb)
 {
   FETCH_LOCK(callbacks_mutex_);
   state_change_callback_ = std::move(cb);
 }
 
 template <typename S>
-char const *StateMachine<S>::GetName() const
+char const *StateMachineBase<S>::GetName() const
 {
   return name_.c_str();
 }
 
 template <typename S>
-uint64_t StateMachine<S>::GetStateCode() const
+uint64_t StateMachineBase<S>::GetStateCode() const
 {
   return static_cast<uint64_t>(state());
 }
 
 template <typename S>
-char const *StateMachine<S>::GetStateName() const
+char const *StateMachineBase<S>::GetStateName() const
 {
   char const *text = "Unknown";
 
@@ -185,17 +311,61 @@ char const *StateMachine<S>::GetStateName() const
   return text;
 }
 
+/**
+ * Report the time spent in each of the states which have been entered. The time in the current
+ * state is included up to now.
+ *
+ * @tparam S The type of the state
+ * @return The timings of each state, ordered by state
+ */
+template <typename S>
+StateTimings StateMachineBase<S>::GetStateTimings() const
+{
+  Timepoint const now = Clock::now();
+
+  FETCH_LOCK(timings_mutex_);
+
+  StateTimings timings{};
+  for (std::size_t code = 0; code < timings_.size(); ++code)
+  {
+    Timing const &timing = timings_[code];
+    if (timing.entries == 0)
+    {
+      continue;
+    }
+
+    S const state = static_cast<S>(code);
+
+    StateTiming entry{};
+    entry.name              = mapper_ ? mapper_(state) : "Unknown";
+    entry.code              = code;
+    entry.entries           = timing.entries;
+    entry.executions        = timing.executions;
+    entry.execution_seconds = ToSeconds(timing.execution);
+    entry.residence_seconds = ToSeconds(timing.residence);
+
+    if (state == current_state_)
+    {
+      entry.residence_seconds += ToSeconds(now - entered_);
+    }
+
+    timings.push_back(std::move(entry));
+  }
+
+  return timings;
+}
+
 /**
  * Determine if the runnable is ready to the run again
  * @tparam S
  * @return
  */
 template <typename S>
-bool StateMachine<S>::IsReadyToExecute() const
+bool StateMachineBase<S>::IsReadyToExecute() const
 {
   bool ready{true};
 
-  if (next_execution_.time_since_epoch().count())
+  if (!woken_ && next_execution_.time_since_epoch().count())
   {
     ready = (Clock::now() >= next_execution_);
   }
@@ -203,32 +373,36 @@ bool StateMachine<S>::IsReadyToExecute() const
   return ready;
 }
 
+/**
+ * Determine when the state machine should next be evaluated. A state machine is only ever not
+ * ready when it has been delayed, at which point it becomes ready at the end of the delay (or
+ * when woken).
+ *
+ * @tparam S The type of the state
+ * @return The end of the current delay
+ */
 template <typename S>
-void StateMachine<S>::Execute()
+typename StateMachineBase<S>::Timepoint StateMachineBase<S>::NextEvaluation() const
 {
-  FETCH_LOCK(callbacks_mutex_);
-
-  // loop up the current state event callback map
-  auto it = callbacks_.find(current_state_);
-  if (it != callbacks_.end())
+  if (next_execution_.time_since_epoch().count())
   {
-    // execute the state handler
-    S const next_state = it->second(current_state_, previous_state_);
+    return next_execution_;
+  }
 
-    // perform the state updates
-    previous_state_ = current_state_.load();
-    current_state_  = next_state;
+  return Clock::now();
+}
 
-    // detect a state change
-    if (current_state_ != previous_state_)
-    {
-      // trigger the state change callback if configured
-      if (state_change_callback_)
-      {
-        state_change_callback_(current_state_, previous_state_);
-      }
-    }
-  }
+/**
+ * Signal that the state machine should be executed as soon as possible, cancelling any pending
+ * delay. Typically triggered by the components on which the current state is waiting.
+ *
+ * @tparam S The type of the state
+ */
+template <typename S>
+void StateMachineBase<S>::Wake()
+{
+  woken_ = true;
+  Runnable::Wake();
 }
 
 /**
@@ -243,10 +417,206 @@ void StateMachine<S>::Execute()
  */
 template <typename S>
 template <typename R, typename P>
-void StateMachine<S>::Delay(std::chrono::duration<R, P> const &delay)
+void StateMachineBase<S>::Delay(std::chrono::duration<R, P> const &delay)
 {
   next_execution_ = Clock::now() + delay;
 }
 
+/**
+ * Internal: Called at the start of each execution, with the callbacks lock held
+ *
+ * @tparam S The type of the state
+ */
+template <typename S>
+void StateMachineBase<S>::BeginExecution()
+{
+  // any delay or wake up only applies until the next execution
+  woken_          = false;
+  next_execution_ = Timepoint{};
+}
+
+/**
+ * Internal: Record the execution of the handler of the current state and move to the next state,
+ * with the callbacks lock held
+ *
+ * @tparam S The type of the state
+ * @param next The state returned by the handler
+ * @param started When the handler was started
+ */
+template <typename S>
+void StateMachineBase<S>::CompleteExecution(S next, Timepoint started)
+{
+  Timepoint const now = Clock::now();
+
+  {
+    FETCH_LOCK(timings_mutex_);
+
+    // perform the state updates
+    previous_state_ = current_state_.load();
+    current_state_  = next;
+
+    Timing &timing = TimingOf(previous_state_);
+    ++timing.executions;
+    timing.execution += now - started;
+
+    if (current_state_ != previous_state_)
+    {
+      timing.residence += now - entered_;
+      entered_ = now;
+
+      ++TimingOf(current_state_).entries;
+    }
+  }
+
+  // detect a state change
+  if (current_state_ != previous_state_)
+  {
+    // trigger the state change callback if configured
+    if (state_change_callback_)
+    {
+      state_change_callback_(current_state_, previous_state_);
+    }
+  }
+}
+
+template <typename S>
+void StateMachineBase<S>::ClearStateChangeCallback()
+{
+  state_change_callback_ = StateChangeCallback{};
+}
+
+/**
+ * Internal: Lookup the timing of a state, with the timings lock held
+ *
+ * @tparam S The type of the state
+ * @param state The state
+ * @return The timing of the state
+ */
+template <typename S>
+typename StateMachineBase<S>::Timing &StateMachineBase<S>::TimingOf(S state)
+{
+  auto const index = static_cast<std::size_t>(state);
+
+  if (index >= timings_.size())
+  {
+    timings_.resize(index + 1);
+  }
+
+  return timings_[index];
+}
+
+template <typename S, typename C>
+template <std::size_t N>
+StateMachine<S, C>::StateMachine(std::string name, S initial, C *owner, Handler const (&table)[N],
+                                 StateMapper mapper)
+  : StateMachineBase<S>(std::move(name), initial, std::move(mapper))
+  , owner_{owner}
+  , table_{table}
+  , table_size_{N}
+{}
+
+/**
+ * Stop dispatching to the owner, typically called as the owner is being destroyed
+ *
+ * @tparam S The type of the state
+ * @tparam C The type of the owner of the handlers
+ */
+template <typename S, typename C>
+void StateMachine<S, C>::Reset()
+{
+  FETCH_LOCK(this->callbacks_mutex_);
+  owner_ = nullptr;
+  this->ClearStateChangeCallback();
+}
+
+template <typename S, typename C>
+void StateMachine<S, C>::Execute()
+{
+  FETCH_LOCK(this->callbacks_mutex_);
+
+  this->BeginExecution();
+
+  auto const index = static_cast<std::size_t>(this->current_state_.load());
+  if ((owner_ == nullptr) || (index >= table_size_))
+  {
+    return;
+  }
+
+  Handler const &handler = table_[index];
+
+  // execute the state handler
+  auto const started    = StateMachineBase<S>::Clock::now();
+  S const    next_state = (handler.simple != nullptr)
+                           ? (owner_->*handler.simple)()
+                           : (owner_->*handler.transition)(this->current_state_,
+                                                            this->previous_state_);
+
+  this->CompleteExecution(next_state, started);
+}
+
+template <typename S>
+StateMachine<S, void>::StateMachine(std::string name, S initial, StateMapper mapper)
+  : StateMachineBase<S>(std::move(name), initial, std::move(mapper))
+{}
+
+template <typename S>
+template <typename C>
+void StateMachine<S, void>::RegisterHandler(S state, C *instance,
+                                            S (C::*func)(S /*current*/, S /*previous*/))
+{
+  FETCH_LOCK(this->callbacks_mutex_);
+  callbacks_[state] = [instance, func](S state, S prev) { return (instance->*func)(state, prev); };
+}
+
+template <typename S>
+template <typename C>
+void StateMachine<S, void>::RegisterHandler(S state, C *instance, S (C::*func)(S /*current*/))
+{
+  FETCH_LOCK(this->callbacks_mutex_);
+  callbacks_[state] = [instance, func](S state, S prev) {
+    FETCH_UNUSED(prev);
+    return (instance->*func)(state);
+  };
+}
+
+template <typename S>
+template <typename C>
+void StateMachine<S, void>::RegisterHandler(S state, C *instance, S (C::*func)())
+{
+  FETCH_LOCK(this->callbacks_mutex_);
+  callbacks_[state] = [instance, func](S state, S prev) {
+    FETCH_UNUSED(state);
+    FETCH_UNUSED(prev);
+    return (instance->*func)();
+  };
+}
+
+template <typename S>
+void StateMachine<S, void>::Reset()
+{
+  FETCH_LOCK(this->callbacks_mutex_);
+  callbacks_.clear();
+  this->ClearStateChangeCallback();
+}
+
+template <typename S>
+void StateMachine<S, void>::Execute()
+{
+  FETCH_LOCK(this->callbacks_mutex_);
+
+  this->BeginExecution();
+
+  // loop up the current state event callback map
+  auto it = callbacks_.find(this->current_state_);
+  if (it != callbacks_.end())
+  {
+    // execute the state handler
+    auto const started    = StateMachineBase<S>::Clock::now();
+    S const    next_state = it->second(this->current_state_, this->previous_state_);
+
+    this->CompleteExecution(next_state, started);
+  }
+}
+
 }  // namespace core
 }  // namespace fetch
@@ -17,9 +17,28 @@
 //
 //------------------------------------------------------------------------------
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 namespace fetch {
 namespace core {
 
+/**
+ * The time spent by a state machine in one of its states
+ */
+struct StateTiming
+{
+  std::string name{};
+  uint64_t    code{0};
+  uint64_t    entries{0};            ///< The number of times the state has been entered
+  uint64_t    executions{0};         ///< The number of times the handler has been executed
+  double      execution_seconds{0};  ///< The total time spent executing the handler
+  double      residence_seconds{0};  ///< The total time spent in the state, including delays
+};
+
+using StateTimings = std::vector<StateTiming>;
+
 class StateMachineInterface
 {
 public:
@@ -31,6 +50,8 @@ public:
   virtual char const *GetName() const      = 0;
   virtual uint64_t    GetStateCode() const = 0;
   virtual char const *GetStateName() const = 0;
+
+  virtual StateTimings GetStateTimings() const = 0;
   /// @}
 };
 
@@ -40,8 +40,10 @@ public:
 
   void Post();
   void Post(Count &count);
+  void PostBulk(Count num);
 
-  void Wait();
+  void  Wait();
+  Count WaitBulk(Count max);
   template <typename R, typename P>
   bool Wait(std::chrono::duration<R, P> const &duration);
 
@@ -86,6 +88,28 @@ inline void Tickets::Post(Count &count)
   cv_.notify_one();
 }
 
+/**
+ * Post / increment the internal counter by a number of tickets at once
+ *
+ * @param num The number of tickets to be posted
+ */
+inline void Tickets::PostBulk(Count num)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    count_ += num;
+  }
+
+  if (num == 1)
+  {
+    cv_.notify_one();
+  }
+  else if (num > 1)
+  {
+    cv_.notify_all();
+  }
+}
+
 /**
  * Wait / decrement the internal counter
  *
@@ -102,6 +126,33 @@ inline void Tickets::Wait()
   --count_;
 }
 
+/**
+ * Wait / decrement the internal counter by as many tickets as are available, up to a maximum
+ *
+ * This function will block until at least one ticket can be claimed
+ *
+ * @param max The maximum number of tickets to be claimed
+ * @return The number of tickets claimed
+ */
+inline Tickets::Count Tickets::WaitBulk(Count max)
+{
+  if (max == 0)
+  {
+    return 0;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (count_ == 0)
+  {
+    cv_.wait(lock);
+  }
+
+  Count const claimed = (count_ < max) ? count_ : max;
+  count_ -= claimed;
+
+  return claimed;
+}
+
 /**
  * Wait / decrement the internal counter
  *
@@ -0,0 +1,307 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(FETCH_PLATFORM_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#endif
+
+namespace fetch {
+namespace core {
+
+/**
+ * Process wide placement of threads onto cores
+ *
+ * Each subsystem of the process (networking, verification, execution, ...) is identified by the
+ * prefixes of the names of its threads. Once a subsystem has been assigned a set of cores, every
+ * thread which starts with a matching name is pinned to that set. Every named thread is also
+ * recorded, so that the CPU time consumed by each subsystem can be reported. Threads which match
+ * no subsystem are reported as "other" and are left unpinned.
+ *
+ * Pinning and CPU accounting are only available on Linux, elsewhere threads are only counted.
+ */
+class ThreadPlacement
+{
+public:
+  using Cores    = std::vector<std::size_t>;
+  using Prefixes = std::vector<std::string>;
+
+  struct Usage
+  {
+    std::string subsystem{};
+    Cores       cores{};         ///< The cores assigned, empty if unpinned
+    std::size_t threads{0};      ///< The number of threads started
+    double      cpu_seconds{0};  ///< The CPU time consumed by the threads
+  };
+
+  using UsageList = std::vector<Usage>;
+
+  static constexpr char const *OTHER = "other";
+
+  static ThreadPlacement &Instance()
+  {
+    static ThreadPlacement instance;
+    return instance;
+  }
+
+  // Construction / Destruction
+  ThreadPlacement(ThreadPlacement const &) = delete;
+  ThreadPlacement(ThreadPlacement &&)      = delete;
+  ~ThreadPlacement()                       = default;
+
+  void      Assign(std::string const &subsystem, Prefixes prefixes, Cores cores);
+  void      OnThreadStart(std::string const &name);
+  Cores     CurrentCores() const;
+  UsageList Report() const;
+
+  static bool Pin(Cores const &cores);
+
+  // Operators
+  ThreadPlacement &operator=(ThreadPlacement const &) = delete;
+  ThreadPlacement &operator=(ThreadPlacement &&) = delete;
+
+private:
+  struct Thread
+  {
+#if defined(FETCH_PLATFORM_LINUX)
+    clockid_t clock{};
+#endif
+    bool   has_clock{false};
+    double cpu_seconds{0};  ///< The last CPU time read, kept once the thread has exited
+  };
+
+  struct Subsystem
+  {
+    std::string         name{};
+    Prefixes            prefixes{};
+    Cores               cores{};
+    std::vector<Thread> threads{};
+  };
+
+  using SubsystemPtr = std::shared_ptr<Subsystem>;
+  using Subsystems   = std::vector<SubsystemPtr>;
+
+  ThreadPlacement()
+  {
+    subsystems_.emplace_back(std::make_shared<Subsystem>());
+    subsystems_.back()->name = OTHER;
+  }
+
+  static Subsystem *&CurrentSubsystem()
+  {
+    static thread_local Subsystem *current{nullptr};
+    return current;
+  }
+
+  static void Sample(Thread &thread);
+
+  Subsystem &Lookup(std::string const &name) const;
+
+  mutable std::mutex lock_;
+  Subsystems         subsystems_;  ///< The subsystems, "other" first
+};
+
+/**
+ * Assign a set of cores to a subsystem. Only threads started after the assignment are pinned.
+ *
+ * @param subsystem The name of the subsystem
+ * @param prefixes The prefixes of the names of the threads of the subsystem
+ * @param cores The cores the threads of the subsystem are pinned to
+ */
+inline void ThreadPlacement::Assign(std::string const &subsystem, Prefixes prefixes, Cores cores)
+{
+  std::lock_guard<std::mutex> lock(lock_);
+
+  SubsystemPtr entry;
+  for (auto const &existing : subsystems_)
+  {
+    if (existing->name == subsystem)
+    {
+      entry = existing;
+      break;
+    }
+  }
+
+  if (!entry)
+  {
+    entry       = std::make_shared<Subsystem>();
+    entry->name = subsystem;
+    subsystems_.push_back(entry);
+  }
+
+  entry->prefixes = std::move(prefixes);
+  entry->cores    = std::move(cores);
+}
+
+/**
+ * Called by every named thread as it starts: records the thread against its subsystem and pins it
+ * to the cores of that subsystem. Later calls from the same thread are ignored.
+ *
+ * @param name The full (untruncated) name of the thread
+ */
+inline void ThreadPlacement::OnThreadStart(std::string const &name)
+{
+  if (CurrentSubsystem() != nullptr)
+  {
+    return;
+  }
+
+  Cores cores{};
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+
+    Subsystem &subsystem = Lookup(name);
+
+    Thread thread{};
+#if defined(FETCH_PLATFORM_LINUX)
+    thread.has_clock = (pthread_getcpuclockid(pthread_self(), &thread.clock) == 0);
+#endif
+    subsystem.threads.push_back(thread);
+
+    CurrentSubsystem() = &subsystem;
+    cores              = subsystem.cores;
+  }
+
+  if (!cores.empty())
+  {
+    Pin(cores);
+  }
+}
+
+/**
+ * Get the cores assigned to the subsystem of the calling thread
+ *
+ * @return The cores, empty if the thread is not pinned
+ */
+inline ThreadPlacement::Cores ThreadPlacement::CurrentCores() const
+{
+  std::lock_guard<std::mutex> lock(lock_);
+
+  Subsystem const *subsystem = CurrentSubsystem();
+  return (subsystem != nullptr) ? subsystem->cores : Cores{};
+}
+
+/**
+ * Report the threads and CPU time of every subsystem. The CPU time of threads which have exited
+ * is the last value read for them.
+ *
+ * @return The usage of each subsystem
+ */
+inline ThreadPlacement::UsageList ThreadPlacement::Report() const
+{
+  std::lock_guard<std::mutex> lock(lock_);
+
+  UsageList report;
+  for (auto const &subsystem : subsystems_)
+  {
+    Usage usage{};
+    usage.subsystem = subsystem->name;
+    usage.cores     = subsystem->cores;
+    usage.threads   = subsystem->threads.size();
+
+    for (auto &thread : subsystem->threads)
+    {
+      Sample(thread);
+      usage.cpu_seconds += thread.cpu_seconds;
+    }
+
+    report.push_back(std::move(usage));
+  }
+
+  return report;
+}
+
+/**
+ * Pin the calling thread to a set of cores
+ *
+ * @param cores The cores the thread may run on
+ * @return true if the thread was pinned, otherwise false
+ */
+inline bool ThreadPlacement::Pin(Cores const &cores)
+{
+#if defined(FETCH_PLATFORM_LINUX)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+
+  for (auto const core : cores)
+  {
+    if (core < CPU_SETSIZE)
+    {
+      CPU_SET(core, &cpu_set);
+    }
+  }
+
+  return (CPU_COUNT(&cpu_set) > 0) &&
+         (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0);
+#else
+  (void)cores;
+  return false;
+#endif
+}
+
+inline void ThreadPlacement::Sample(Thread &thread)
+{
+#if defined(FETCH_PLATFORM_LINUX)
+  timespec value{};
+  if (thread.has_clock && (clock_gettime(thread.clock, &value) == 0))
+  {
+    thread.cpu_seconds =
+        static_cast<double>(value.tv_sec) + (static_cast<double>(value.tv_nsec) * 1e-9);
+  }
+#else
+  (void)thread;
+#endif
+}
+
+/**
+ * Internal: Find the subsystem with the longest prefix matching the name of a thread
+ *
+ * @param name The name of the thread
+ * @return The matching subsystem, "other" if there is none
+ */
+inline ThreadPlacement::Subsystem &ThreadPlacement::Lookup(std::string const &name) const
+{
+  Subsystem * best        = subsystems_.front().get();
+  std::size_t best_length = 0;
+
+  for (auto const &subsystem : subsystems_)
+  {
+    for (auto const &prefix : subsystem->prefixes)
+    {
+      if ((prefix.size() > best_length) && (name.compare(0, prefix.size(), prefix) == 0))
+      {
+        best        = subsystem.get();
+        best_length = prefix.size();
+      }
+    }
+  }
+
+  return *best;
+}
+
+}  // namespace core
+}  // namespace fetch
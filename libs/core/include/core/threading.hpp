@@ -17,8 +17,17 @@
 //
 //------------------------------------------------------------------------------
 
+#include "core/thread_placement.hpp"
+
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <thread>
+
+#if defined(FETCH_PLATFORM_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace fetch {
 
@@ -26,6 +35,9 @@ static constexpr std::size_t MAX_THREAD_NAME_LEN = 16;  // posix limit
 
 inline void SetThreadName(std::string name)
 {
+  // every subsystem names its threads as they start, which is when they are placed
+  core::ThreadPlacement::Instance().OnThreadStart(name);
+
   if (name.size() > MAX_THREAD_NAME_LEN)
   {
     name = name.substr(0, MAX_THREAD_NAME_LEN);
@@ -62,4 +74,24 @@ inline void SetThreadName(std::string const &prefix, std::size_t index)
   SetThreadName(oss.str());
 }
 
+/**
+ * Pin the calling thread to a single core. The index wraps around the cores assigned to the
+ * subsystem of the thread (see `core::ThreadPlacement`), or else all the cores available. On
+ * platforms without thread affinity support this is a no-op
+ *
+ * @param index The index of the core
+ * @return true if the thread was pinned, otherwise false
+ */
+inline bool SetThreadAffinity(std::size_t index)
+{
+  auto const assigned = core::ThreadPlacement::Instance().CurrentCores();
+  if (!assigned.empty())
+  {
+    return core::ThreadPlacement::Pin({assigned[index % assigned.size()]});
+  }
+
+  std::size_t const num_cores = std::max(std::thread::hardware_concurrency(), 1u);
+  return core::ThreadPlacement::Pin({index % num_cores});
+}
+
 }  // namespace fetch
\ No newline at end of file
@@ -22,6 +22,8 @@
 namespace fetch {
 namespace byte_array {
 
+constexpr std::size_t ConstByteArray::INLINE_CAPACITY;
+
 ConstByteArray ConstByteArray::ToBase64() const
 {
   return ::fetch::byte_array::ToBase64(*this);
@@ -19,9 +19,80 @@
 #include "core/byte_array/decoders.hpp"
 #include "core/assert.hpp"
 #include "core/byte_array/details/encode_decode.hpp"
+#include "vectorise/info.hpp"
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define FETCH_BYTE_ARRAY_DECODERS_SSE2
+#endif
 
 namespace fetch {
 namespace byte_array {
+namespace {
+
+#ifdef FETCH_BYTE_ARRAY_DECODERS_SSE2
+/**
+ * Convert 16 hex characters (of either case) into their values
+ *
+ * @param chars The characters to be converted
+ * @param valid Set for each character which is a hex digit
+ * @return The value of each valid character
+ */
+__m128i HexCharsToNibbles(__m128i chars, __m128i &valid)
+{
+  // unsigned comparison against the upper bound of each range
+  __m128i const digits   = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+  __m128i const is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+
+  __m128i const letters =
+      _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+  __m128i const is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letters, _mm_set1_epi8(5)), letters);
+
+  valid = _mm_or_si128(is_digit, is_letter);
+
+  return _mm_or_si128(_mm_and_si128(is_digit, digits),
+                      _mm_and_si128(is_letter, _mm_add_epi8(letters, _mm_set1_epi8(10))));
+}
+
+/**
+ * Hex decode the start of the input, 32 characters at a time. Decoding stops before the first
+ * block containing an invalid character, which is left to the scalar implementation to report.
+ *
+ * @return The number of input characters which have been decoded
+ */
+std::size_t DecodeHexSse2(uint8_t const *src, std::size_t size, uint8_t *dest)
+{
+  __m128i const low_byte = _mm_set1_epi16(0x00FF);
+
+  std::size_t consumed = 0;
+  for (; (consumed + 32) <= size; consumed += 32)
+  {
+    __m128i const *input = reinterpret_cast<__m128i const *>(src + consumed);
+
+    __m128i       valid_first, valid_second;
+    __m128i const first  = HexCharsToNibbles(_mm_loadu_si128(input), valid_first);
+    __m128i const second = HexCharsToNibbles(_mm_loadu_si128(input + 1), valid_second);
+
+    if (_mm_movemask_epi8(_mm_and_si128(valid_first, valid_second)) != 0xFFFF)
+    {
+      break;
+    }
+
+    // each 16 bit lane holds the high nibble in its first byte and the low nibble in its second
+    __m128i const first_bytes = _mm_and_si128(
+        _mm_or_si128(_mm_slli_epi16(first, 4), _mm_srli_epi16(first, 8)), low_byte);
+    __m128i const second_bytes = _mm_and_si128(
+        _mm_or_si128(_mm_slli_epi16(second, 4), _mm_srli_epi16(second, 8)), low_byte);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + (consumed / 2)),
+                     _mm_packus_epi16(first_bytes, second_bytes));
+  }
+
+  return consumed;
+}
+#endif
+
+}  // namespace
 
 ConstByteArray FromBase64(ConstByteArray const &str) noexcept
 {
@@ -41,6 +112,13 @@ ConstByteArray FromBase64(ConstByteArray const &str) noexcept
   uint32_t    buf = 0;
   std::size_t i   = 0;
 
+  if (vectorize::GetCpuFeatures().ssse3 && details::HasBase64Ssse3Kernels())
+  {
+    // the bulk of the input is decoded 16 characters at a time, the padded end is handled below
+    i = details::DecodeBase64Ssse3(str.pointer(), str.size(), ret.pointer(), ret.size());
+    j = (i / 4) * 3;
+  }
+
   for (; i < str.size(); ++i)
   {
     uint8_t c = details::base64decode[str[i]];
@@ -87,11 +165,17 @@ ConstByteArray FromHex(ConstByteArray const &str) noexcept
   ret.Resize(str.size() >> 1);
 
   std::size_t n = str.size();
-  std::size_t j = 0;
+  std::size_t i = 0;
+
+#ifdef FETCH_BYTE_ARRAY_DECODERS_SSE2
+  i = DecodeHexSse2(str.pointer(), n, ret.pointer());
+#endif
+
+  std::size_t j = i >> 1;
   try
   {
 
-    for (std::size_t i = 0; i < n; i += 2)
+    for (; i < n; i += 2)
     {
       uint8_t next = uint8_t(details::DecodeHexChar(data[i]));
       if (i + 1 < n)
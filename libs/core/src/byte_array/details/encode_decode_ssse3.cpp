@@ -0,0 +1,163 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/details/encode_decode.hpp"
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+namespace fetch {
+namespace byte_array {
+namespace details {
+
+#if defined(__SSSE3__)
+
+// Note: this translation unit is compiled with SSSE3 enabled (see CMakeLists.txt). It must only be
+// called once the CPU has been checked for support.
+
+namespace {
+
+/**
+ * Convert 16 indices (0 to 63) into their base64 characters
+ *
+ * The indices are reduced to one of 14 classes (A-Z, a-z, each of the digits, '+' and '/') and the
+ * offset between the index and the character of each class is then looked up.
+ */
+__m128i IndicesToChars(__m128i indices)
+{
+  __m128i const shifts =
+      _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                    '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+  // 0 for a-z, 1 to 10 for the digits, 11 for '+' and 12 for '/' ...
+  __m128i classes = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+
+  // ... and 13 for A-Z
+  __m128i const upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  classes             = _mm_or_si128(classes, _mm_and_si128(upper, _mm_set1_epi8(13)));
+
+  return _mm_add_epi8(indices, _mm_shuffle_epi8(shifts, classes));
+}
+
+}  // namespace
+
+bool HasBase64Ssse3Kernels()
+{
+  return true;
+}
+
+std::size_t EncodeBase64Ssse3(uint8_t const *src, std::size_t size, uint8_t *dest)
+{
+  std::size_t consumed = 0;
+
+  // each iteration encodes 12 bytes, but loads 16
+  for (; (consumed + 16) <= size; consumed += 12)
+  {
+    __m128i input = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + consumed));
+
+    // place each group of 3 bytes (a, b, c) into a 32 bit lane as b, a, c, b
+    input = _mm_shuffle_epi8(input,
+                             _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+    // extract the 6 bit indices into their own bytes, with multiplications as variable shifts
+    __m128i const first_third  = _mm_mulhi_epu16(_mm_and_si128(input, _mm_set1_epi32(0x0FC0FC00)),
+                                                _mm_set1_epi32(0x04000040));
+    __m128i const second_fourth = _mm_mullo_epi16(_mm_and_si128(input, _mm_set1_epi32(0x003F03F0)),
+                                                  _mm_set1_epi32(0x01000010));
+
+    __m128i const chars = IndicesToChars(_mm_or_si128(first_third, second_fourth));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + ((consumed / 3) * 4)), chars);
+  }
+
+  return consumed;
+}
+
+std::size_t DecodeBase64Ssse3(uint8_t const *src, std::size_t size, uint8_t *dest,
+                              std::size_t dest_size)
+{
+  // each nibble is mapped to a set of bits from the lookup tables, a character is valid when the
+  // sets of its two nibbles do not intersect
+  __m128i const lut_low  = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                         0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+  __m128i const lut_high = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10,
+                                         0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+
+  // the offset of each character from its value for each high nibble ('/' is handled separately)
+  __m128i const lut_offset =
+      _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+
+  std::size_t consumed = 0;
+  std::size_t produced = 0;
+
+  // each iteration decodes 16 characters into 12 bytes, but stores 16
+  for (; ((consumed + 16) <= size) && ((produced + 16) <= dest_size);
+       consumed += 16, produced += 12)
+  {
+    __m128i const input = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + consumed));
+
+    __m128i const high = _mm_and_si128(_mm_srli_epi32(input, 4), _mm_set1_epi8(0x0F));
+    __m128i const low  = _mm_and_si128(input, _mm_set1_epi8(0x0F));
+
+    __m128i const invalid =
+        _mm_and_si128(_mm_shuffle_epi8(lut_low, low), _mm_shuffle_epi8(lut_high, high));
+    if (_mm_movemask_epi8(_mm_cmpgt_epi8(invalid, _mm_setzero_si128())) != 0)
+    {
+      // padding, whitespace or an invalid character, which is left to the scalar implementation
+      break;
+    }
+
+    __m128i const is_slash = _mm_cmpeq_epi8(input, _mm_set1_epi8('/'));
+    __m128i const offsets  = _mm_shuffle_epi8(lut_offset, _mm_add_epi8(is_slash, high));
+    __m128i const values   = _mm_add_epi8(input, offsets);
+
+    // merge the 6 bit values into 24 bit groups, a 32 bit lane at a time, and then compact them
+    __m128i const pairs  = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    __m128i const groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    __m128i const output = _mm_shuffle_epi8(
+        groups, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + produced), output);
+  }
+
+  return consumed;
+}
+
+#else
+
+bool HasBase64Ssse3Kernels()
+{
+  // this file has been built without SSSE3 enabled
+  return false;
+}
+
+std::size_t EncodeBase64Ssse3(uint8_t const *, std::size_t, uint8_t *)
+{
+  return 0;
+}
+
+std::size_t DecodeBase64Ssse3(uint8_t const *, std::size_t, uint8_t *, std::size_t)
+{
+  return 0;
+}
+
+#endif
+
+}  // namespace details
+}  // namespace byte_array
+}  // namespace fetch
@@ -18,9 +18,56 @@
 
 #include "core/byte_array/encoders.hpp"
 #include "core/byte_array/details/encode_decode.hpp"
+#include "vectorise/info.hpp"
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define FETCH_BYTE_ARRAY_ENCODERS_SSE2
+#endif
 
 namespace fetch {
 namespace byte_array {
+namespace {
+
+#ifdef FETCH_BYTE_ARRAY_ENCODERS_SSE2
+/**
+ * Convert 16 nibbles into their hex characters
+ */
+__m128i NibblesToHexChars(__m128i nibbles)
+{
+  __m128i const letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)),
+                                        _mm_set1_epi8('a' - '0' - 10));
+
+  return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+/**
+ * Hex encode the start of the input, 16 bytes at a time
+ *
+ * @return The number of input bytes which have been encoded
+ */
+std::size_t EncodeHexSse2(uint8_t const *src, std::size_t size, uint8_t *dest)
+{
+  __m128i const mask = _mm_set1_epi8(0x0F);
+
+  std::size_t consumed = 0;
+  for (; (consumed + 16) <= size; consumed += 16)
+  {
+    __m128i const input = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + consumed));
+
+    __m128i const high = NibblesToHexChars(_mm_and_si128(_mm_srli_epi16(input, 4), mask));
+    __m128i const low  = NibblesToHexChars(_mm_and_si128(input, mask));
+
+    __m128i *output = reinterpret_cast<__m128i *>(dest + (consumed * 2));
+    _mm_storeu_si128(output, _mm_unpacklo_epi8(high, low));
+    _mm_storeu_si128(output + 1, _mm_unpackhi_epi8(high, low));
+  }
+
+  return consumed;
+}
+#endif
+
+}  // namespace
 
 ConstByteArray ToBase64(ConstByteArray const &str)
 {
@@ -45,8 +92,16 @@ ConstByteArray ToBase64(ConstByteArray const &str)
   ByteArray ret;
   ret.Resize(size);
 
+  std::size_t x = 0;
+  if (vectorize::GetCpuFeatures().ssse3 && details::HasBase64Ssse3Kernels())
+  {
+    // the bulk of the input is encoded 12 bytes at a time, and the remainder below
+    x   = details::EncodeBase64Ssse3(data, N, ret.pointer());
+    idx = (x / 3) * 4;
+  }
+
   uint8_t n0, n1, n2, n3;
-  for (std::size_t x = 0; x < N; x += 3)
+  for (; x < N; x += 3)
   {
     uint32_t temp = static_cast<uint32_t>(data[x]) << 16;
     if ((x + 1) < N)
@@ -93,8 +148,13 @@ ConstByteArray ToHex(ConstByteArray const &str)
   ByteArray      ret;
   ret.Resize(str.size() << 1);
 
-  std::size_t j = 0;
-  for (std::size_t i = 0; i < str.size(); ++i)
+  std::size_t i = 0;
+#ifdef FETCH_BYTE_ARRAY_ENCODERS_SSE2
+  i = EncodeHexSse2(data, str.size(), ret.pointer());
+#endif
+
+  std::size_t j = i << 1;
+  for (; i < str.size(); ++i)
   {
     uint8_t c = data[i];
     ret[j++]  = uint8_t(details::hexChars[(c >> 4) & 0xF]);
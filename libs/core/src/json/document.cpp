@@ -17,11 +17,164 @@
 //------------------------------------------------------------------------------
 
 #include "core/json/document.hpp"
+#include "variant/object_builder.hpp"
 
+#include <cassert>
 #include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define FETCH_JSON_SSE2
+#endif
 
 namespace fetch {
 namespace json {
+namespace {
+
+constexpr std::size_t BLOCK_SIZE = 64;
+constexpr uint64_t    EVEN_BITS  = 0x5555555555555555ull;
+constexpr uint64_t    ODD_BITS   = ~EVEN_BITS;
+
+/**
+ * The masks of the characters of interest in a block of the document, bit i corresponding to the
+ * i-th character of the block
+ */
+struct BlockMasks
+{
+  uint64_t quotes{0};
+  uint64_t backslashes{0};
+  uint64_t operators{0};  ///< The characters {}[]:,
+  uint64_t whitespace{0};
+};
+
+#ifdef FETCH_JSON_SSE2
+__m128i Equal(__m128i chars, char c)
+{
+  return _mm_cmpeq_epi8(chars, _mm_set1_epi8(c));
+}
+
+uint64_t Bits(__m128i matches, unsigned part)
+{
+  return uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(matches))) << (16u * part);
+}
+
+BlockMasks Classify(uint8_t const *block)
+{
+  BlockMasks masks;
+
+  for (unsigned part = 0; part < 4; ++part)
+  {
+    __m128i const chars = _mm_loadu_si128(reinterpret_cast<__m128i const *>(block) + part);
+
+    // setting bit 5 folds the square brackets onto the curly ones (and nothing else onto them)
+    __m128i const folded    = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+    __m128i const operators = _mm_or_si128(_mm_or_si128(Equal(folded, '{'), Equal(folded, '}')),
+                                           _mm_or_si128(Equal(chars, ':'), Equal(chars, ',')));
+    __m128i const whitespace =
+        _mm_or_si128(_mm_or_si128(Equal(chars, ' '), Equal(chars, '\t')),
+                     _mm_or_si128(Equal(chars, '\n'), Equal(chars, '\r')));
+
+    masks.quotes |= Bits(Equal(chars, '"'), part);
+    masks.backslashes |= Bits(Equal(chars, '\\'), part);
+    masks.operators |= Bits(operators, part);
+    masks.whitespace |= Bits(whitespace, part);
+  }
+
+  return masks;
+}
+#else
+BlockMasks Classify(uint8_t const *block)
+{
+  BlockMasks masks;
+
+  for (std::size_t i = 0; i < BLOCK_SIZE; ++i)
+  {
+    uint64_t const bit = uint64_t{1} << i;
+
+    switch (block[i])
+    {
+    case '"':
+      masks.quotes |= bit;
+      break;
+    case '\\':
+      masks.backslashes |= bit;
+      break;
+    case '{':
+    case '}':
+    case '[':
+    case ']':
+    case ':':
+    case ',':
+      masks.operators |= bit;
+      break;
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+      masks.whitespace |= bit;
+      break;
+    default:
+      break;
+    }
+  }
+
+  return masks;
+}
+#endif
+
+/**
+ * Determine the characters which are escaped, that is which follow an odd length run of
+ * backslashes, without looping over the runs
+ *
+ * @param backslashes The mask of the backslashes in the block
+ * @param prev_ends_odd Is 1 when the previous block ends with an odd length run, updated for the
+ * next block
+ * @return The mask of the escaped characters
+ */
+uint64_t FindEscaped(uint64_t backslashes, uint64_t &prev_ends_odd)
+{
+  uint64_t const start_edges     = backslashes & ~(backslashes << 1u);
+  uint64_t const even_start_mask = EVEN_BITS ^ prev_ends_odd;
+  uint64_t const even_starts     = start_edges & even_start_mask;
+  uint64_t const odd_starts      = start_edges & ~even_start_mask;
+
+  // adding the start of a run to it carries into the character after the run
+  uint64_t const even_carries = backslashes + even_starts;
+  uint64_t       odd_carries  = backslashes + odd_starts;
+
+  // a carry out of the block means that an odd length run continues into the next block
+  bool const ends_odd = odd_carries < backslashes;
+  odd_carries |= prev_ends_odd;
+  prev_ends_odd = ends_odd ? 1u : 0u;
+
+  uint64_t const even_carry_ends = even_carries & ~backslashes;
+  uint64_t const odd_carry_ends  = odd_carries & ~backslashes;
+
+  return (even_carry_ends & ODD_BITS) | (odd_carry_ends & EVEN_BITS);
+}
+
+/// Each bit of the result is the exclusive or of the input bits up to and including it
+uint64_t PrefixXor(uint64_t bits)
+{
+  bits ^= bits << 1u;
+  bits ^= bits << 2u;
+  bits ^= bits << 4u;
+  bits ^= bits << 8u;
+  bits ^= bits << 16u;
+  bits ^= bits << 32u;
+
+  return bits;
+}
+
+bool IsOpening(uint8_t type)
+{
+  return (type == JSONDocument::OPEN_OBJECT) || (type == JSONDocument::OPEN_ARRAY);
+}
+
+}  // namespace
 
 /**
  * Extract a primitive value from a JSONToken
@@ -88,10 +241,55 @@ void JSONDocument::ExtractPrimitive(Variant &variant, JSONToken const &token,
  */
 void JSONDocument::Parse(ConstByteArray const &document)
 {
-  using VariantStack = std::vector<Variant *>;
+  document_ = document;
+
+  Tokenise(document_);
+  Build(variant_, 0, tokens_.size());
+}
+
+/**
+ * Tokenise a JSON document without building its variant tree, the values are then accessed on
+ * demand through lazy_root(). The root() of the document is reset to null.
+ *
+ * @param document The input document
+ */
+void JSONDocument::ParseLazy(ConstByteArray const &document)
+{
+  document_ = document;
+  variant_  = Variant::Null();
+
+  Tokenise(document_);
+
+  if (tokens_.empty() || !IsOpening(tokens_.front().type))
+  {
+    throw JSONParseException("Expecting a list or object as initial element");
+  }
+}
+
+/**
+ * @return The lazily evaluated view of the root of the last parsed document
+ */
+JSONDocument::LazyValue JSONDocument::lazy_root() const
+{
+  if (tokens_.empty())
+  {
+    throw std::runtime_error("No document has been parsed");
+  }
+
+  return {*this, 0};
+}
 
-  // tokenise the document
-  Tokenise(document);
+/**
+ * Build the variant tree of the values of a range of tokens
+ *
+ * @param root The output variant, set when the first object or array is opened
+ * @param begin The index of the first token
+ * @param end The index after the last token
+ */
+void JSONDocument::Build(Variant &root, std::size_t begin, std::size_t end) const
+{
+  using VariantStack = std::vector<Variant *>;
+  using BuilderStack = std::vector<variant::ObjectBuilder>;
 
   enum class ObjectState
   {
@@ -100,12 +298,18 @@ void JSONDocument::Parse(ConstByteArray const &document)
     VALUE,
   };
 
+  // the number of members of the object opened by a token
+  auto const num_members = [this](JSONToken const &open) -> std::size_t {
+    return (open.second < tokens_.size()) ? (tokens_[open.second].second / 2) : 0;
+  };
+
   ConstByteArray key;
   ObjectState    state{ObjectState::NA};
   VariantStack   variant_stack = {};
+  BuilderStack   builder_stack = {};  // the objects being populated, appended and sorted once
 
   // process all the token
-  for (std::size_t idx = 0, end = tokens_.size(); idx < end; ++idx)
+  for (std::size_t idx = begin; idx < end; ++idx)
   {
     JSONToken const &token = tokens_[idx];
 
@@ -125,7 +329,7 @@ void JSONDocument::Parse(ConstByteArray const &document)
         }
 
         // since the token is a key
-        key   = document.SubArray(token.first, token.second - token.first);
+        key   = document_.SubArray(token.first, token.second - token.first);
         state = ObjectState::VALUE;
 
         continue;
@@ -140,7 +344,7 @@ void JSONDocument::Parse(ConstByteArray const &document)
 
       if (state == ObjectState::VALUE)
       {
-        ExtractPrimitive((*current)[key], token, document);
+        ExtractPrimitive(builder_stack.back().Add(key), token, document_);
         state = ObjectState::KEY;
       }
       else if (current->IsArray())
@@ -149,7 +353,7 @@ void JSONDocument::Parse(ConstByteArray const &document)
         current->ResizeArray(next_idx + 1);
 
         // extract the primitive value
-        ExtractPrimitive((*current)[next_idx], token, document);
+        ExtractPrimitive((*current)[next_idx], token, document_);
       }
       else
       {
@@ -162,8 +366,8 @@ void JSONDocument::Parse(ConstByteArray const &document)
       if (variant_stack.empty())
       {
         // define the initial object and add it to the stack
-        variant_ = Variant::Object();
-        variant_stack.push_back(&variant_);
+        builder_stack.emplace_back(root, num_members(token));
+        variant_stack.push_back(&root);
       }
       else
       {
@@ -173,8 +377,8 @@ void JSONDocument::Parse(ConstByteArray const &document)
         {
           assert(context->IsObject());
 
-          Variant &next_element = (*context)[key];
-          next_element          = Variant::Object();
+          Variant &next_element = builder_stack.back().Add(key);
+          builder_stack.emplace_back(next_element, num_members(token));
 
           variant_stack.push_back(&next_element);
         }
@@ -185,7 +389,7 @@ void JSONDocument::Parse(ConstByteArray const &document)
 
           // create the object inside of the array
           Variant &next_element = (*context)[next_idx];
-          next_element          = Variant::Object();
+          builder_stack.emplace_back(next_element, num_members(token));
 
           // add it to the stack
           variant_stack.push_back(&next_element);
@@ -203,6 +407,10 @@ void JSONDocument::Parse(ConstByteArray const &document)
     {
       assert(variant_stack.back()->IsObject());
 
+      // sort the members of the completed object
+      builder_stack.back().Finish();
+      builder_stack.pop_back();
+
       // drop this current object from the stack
       variant_stack.pop_back();
 
@@ -222,8 +430,8 @@ void JSONDocument::Parse(ConstByteArray const &document)
     {
       if (variant_stack.empty())
       {
-        variant_ = Variant::Array(0);
-        variant_stack.push_back(&variant_);
+        root = Variant::Array(0);
+        variant_stack.push_back(&root);
       }
       else
       {
@@ -233,7 +441,7 @@ void JSONDocument::Parse(ConstByteArray const &document)
         {
           assert(context->IsObject());
 
-          Variant &next_element = (*context)[key];
+          Variant &next_element = builder_stack.back().Add(key);
           next_element          = Variant::Array(0);
 
           variant_stack.push_back(&next_element);
@@ -284,15 +492,72 @@ void JSONDocument::Parse(ConstByteArray const &document)
 }
 
 /**
- * Tokenise the input document to be parsed
+ * Index the structural elements of the document (stage one): the operators outside of strings,
+ * the opening and closing quotes of the strings and the first character of every scalar
+ *
+ * @param document The document to index
+ */
+void JSONDocument::IndexStructurals(ConstByteArray const &document)
+{
+  structurals_.clear();
+  structurals_.reserve(document.size() / 4 + 16);
+
+  uint8_t const *const data = document.pointer();
+  std::size_t const    size = document.size();
+
+  uint64_t prev_ends_odd{0};
+  uint64_t prev_in_string{0};
+  uint64_t prev_scalar{0};
+
+  for (std::size_t offset = 0; offset < size; offset += BLOCK_SIZE)
+  {
+    BlockMasks masks;
+    if ((size - offset) >= BLOCK_SIZE)
+    {
+      masks = Classify(data + offset);
+    }
+    else
+    {
+      // pad the final block with whitespace
+      uint8_t block[BLOCK_SIZE];
+      std::memset(block, ' ', BLOCK_SIZE);
+      std::memcpy(block, data + offset, size - offset);
+
+      masks = Classify(block);
+    }
+
+    uint64_t const escaped = FindEscaped(masks.backslashes, prev_ends_odd);
+    uint64_t const quotes  = masks.quotes & ~escaped;
+
+    // a string starts at its opening quote and ends before its closing one
+    uint64_t const in_string = PrefixXor(quotes) ^ prev_in_string;
+    prev_in_string           = uint64_t{0} - (in_string >> 63u);
+
+    uint64_t const scalars       = ~(masks.operators | masks.whitespace | quotes | in_string);
+    uint64_t const scalar_starts = scalars & ~((scalars << 1u) | prev_scalar);
+    prev_scalar                  = scalars >> 63u;
+
+    uint64_t bits = (masks.operators & ~in_string) | quotes | scalar_starts;
+    while (bits != 0)
+    {
+      structurals_.push_back(static_cast<uint32_t>(offset) +
+                             static_cast<uint32_t>(__builtin_ctzll(bits)));
+      bits &= bits - 1u;
+    }
+  }
+}
+
+/**
+ * Tokenise the input document to be parsed (stage two)
+ *
+ * The index of the structural elements is walked to build the tokens. Only the scalars are
+ * examined character by character, using the same rules as TokeniseRange, which takes over for
+ * the rest of the document in the (malformed) cases where the index is out of step.
  *
  * @param document The document to tokenise
  */
 void JSONDocument::Tokenise(ConstByteArray const &document)
 {
-  int      line = 0;
-  uint64_t pos  = 0;
-
   objects_ = 0;
 
   brace_stack_.reserve(32);
@@ -300,13 +565,97 @@ void JSONDocument::Tokenise(ConstByteArray const &document)
 
   counters_.reserve(32);
   counters_.clear();
+  open_tokens_.reserve(32);
+  open_tokens_.clear();
   tokens_.reserve(1024);
   tokens_.clear();
 
-  uint16_t element_counter = 0;
+  uint64_t element_counter = 0;
+
+  // the positions in the index are 32 bit
+  if (document.size() >= std::numeric_limits<uint32_t>::max())
+  {
+    TokeniseRange(document, 0, document.size(), element_counter);
+  }
+  else
+  {
+    IndexStructurals(document);
+
+    // every character before this position has been tokenised
+    uint64_t pos = 0;
+
+    for (std::size_t i = 0, count = structurals_.size(); i < count; ++i)
+    {
+      uint64_t const index = structurals_[i];
+
+      if (index < pos)
+      {
+        // a keyword has consumed the character following it
+        TokeniseRange(document, pos, document.size(), element_counter);
+        break;
+      }
+
+      char const c = static_cast<char>(document[index]);
+
+      if (c == '"')
+      {
+        if ((i + 1) == count)
+        {
+          // the string is not terminated
+          TokeniseRange(document, index, document.size(), element_counter);
+          break;
+        }
+
+        // the closing quote always follows the opening one in the index
+        uint64_t const closing = structurals_[++i];
+        assert(document[closing] == '"');
+
+        ++objects_;
+        ++element_counter;
+        tokens_.push_back({index + 1, closing, STRING});
+
+        pos = closing + 1;
+      }
+      else if ((c == '{') || (c == '}') || (c == '[') || (c == ']') || (c == ':') || (c == ','))
+      {
+        AddOperator(c, index, element_counter);
+
+        pos = index + 1;
+      }
+      else
+      {
+        // a scalar, the characters up to the next structural element are either part of it or
+        // are whitespace
+        uint64_t const end = ((i + 1) < count) ? structurals_[i + 1] : document.size();
+
+        pos = TokeniseRange(document, index, end, element_counter);
+      }
+    }
+  }
+
+  if (!brace_stack_.empty())
+  {
+    throw JSONParseException("Object or array indicators are unbalanced.");
+  }
+}
 
+/**
+ * Tokenise a range of the document character by character
+ *
+ * The last token is the one which starts before the end of the range, so the returned position
+ * might be beyond it.
+ *
+ * @param document The document to tokenise
+ * @param pos The start of the range
+ * @param end The end of the range
+ * @param element_counter The number of elements seen in the current object or array
+ * @return The position after the last token
+ */
+uint64_t JSONDocument::TokeniseRange(ConstByteArray const &document, uint64_t pos, uint64_t end,
+                                     uint64_t &element_counter)
+{
   char const *ptr = reinterpret_cast<char const *>(document.pointer());
-  while (pos < document.size())
+  while (pos < end)
   {
     uint16_t const *words16 = reinterpret_cast<uint16_t const *>(ptr + pos);
     uint32_t const *words   = reinterpret_cast<uint32_t const *>(ptr + pos);
@@ -340,8 +689,6 @@ void JSONDocument::Tokenise(ConstByteArray const &document)
     switch (c)
     {
     case '\n':
-      ++line;
-      // Falls through.
     case '\t':
     case ' ':
     case '\r':
@@ -355,7 +702,7 @@ void JSONDocument::Tokenise(ConstByteArray const &document)
       {
       case 0x65757274:  // true
         ++objects_;
-        tokens_.push_back({uint32_t(pos), pos + 4, KEYWORD_TRUE});
+        tokens_.push_back({pos, pos + 4, KEYWORD_TRUE});
         pos += 4;
         ++element_counter;
         continue;
@@ -385,65 +732,14 @@ void JSONDocument::Tokenise(ConstByteArray const &document)
       byte_array::consumers::StringConsumer<STRING>(document, pos);
       tokens_.push_back({oldpos + 1, pos - 1, STRING});
       break;
-    case '{':
-      brace_stack_.push_back('}');
-      counters_.emplace_back(element_counter);
-      element_counter = 0;
-      tokens_.push_back({pos, 0, OPEN_OBJECT});
 
-      ++pos;
-      break;
+    case '{':
     case '}':
-      if (brace_stack_.back() != '}')
-      {
-        throw JSONParseException("Expected '}', but found ']'");
-      }
-      brace_stack_.pop_back();
-      tokens_.push_back({pos, uint64_t(element_counter), CLOSE_OBJECT});
-
-      element_counter = counters_.back();
-      counters_.pop_back();
-      ++element_counter;
-      ++pos;
-      ++objects_;
-      break;
     case '[':
-      brace_stack_.push_back(']');
-      counters_.emplace_back(element_counter);
-
-      element_counter = 0;
-      tokens_.push_back({pos, 0, OPEN_ARRAY});
-
-      ++pos;
-      break;
     case ']':
-      if (brace_stack_.back() != ']')
-      {
-        throw JSONParseException("Expected ']', but found '}'.");
-      }
-      brace_stack_.pop_back();
-      tokens_.push_back({pos, element_counter, CLOSE_ARRAY});
-
-      element_counter = counters_.back();
-      ++element_counter;
-      counters_.pop_back();
-
-      ++pos;
-      ++objects_;
-
-      break;
-
     case ':':
-      if (brace_stack_.back() != '}')
-      {
-        throw JSONParseException("Cannot set property outside of object context");
-      }
-      //        tokens_.back().type = KEY;
-      ++pos;
-      break;
-
     case ',':
-      //        tokens_.push_back({pos, 0, NEW_ENTRY});
+      AddOperator(c, pos, element_counter);
       ++pos;
       break;
 
@@ -461,10 +757,271 @@ void JSONDocument::Tokenise(ConstByteArray const &document)
     }
   }
 
-  if (!brace_stack_.empty())
+  return pos;
+}
+
+/**
+ * Add the token of a structural character, if it has one
+ *
+ * @param c The character
+ * @param pos The position of the character
+ * @param element_counter The number of elements seen in the current object or array
+ */
+void JSONDocument::AddOperator(char c, uint64_t pos, uint64_t &element_counter)
+{
+  switch (c)
   {
-    throw JSONParseException("Object or array indicators are unbalanced.");
+  case '{':
+    brace_stack_.push_back('}');
+    counters_.emplace_back(element_counter);
+    element_counter = 0;
+    open_tokens_.push_back(tokens_.size());
+    tokens_.push_back({pos, 0, OPEN_OBJECT});
+    break;
+
+  case '}':
+    if (brace_stack_.empty())
+    {
+      throw JSONParseException("Object or array indicators are unbalanced.");
+    }
+    if (brace_stack_.back() != '}')
+    {
+      throw JSONParseException("Expected '}', but found ']'");
+    }
+    brace_stack_.pop_back();
+    tokens_[open_tokens_.back()].second = tokens_.size();
+    open_tokens_.pop_back();
+    tokens_.push_back({pos, element_counter, CLOSE_OBJECT});
+
+    element_counter = counters_.back();
+    counters_.pop_back();
+    ++element_counter;
+    ++objects_;
+    break;
+
+  case '[':
+    brace_stack_.push_back(']');
+    counters_.emplace_back(element_counter);
+
+    element_counter = 0;
+    open_tokens_.push_back(tokens_.size());
+    tokens_.push_back({pos, 0, OPEN_ARRAY});
+    break;
+
+  case ']':
+    if (brace_stack_.empty())
+    {
+      throw JSONParseException("Object or array indicators are unbalanced.");
+    }
+    if (brace_stack_.back() != ']')
+    {
+      throw JSONParseException("Expected ']', but found '}'.");
+    }
+    brace_stack_.pop_back();
+    tokens_[open_tokens_.back()].second = tokens_.size();
+    open_tokens_.pop_back();
+    tokens_.push_back({pos, element_counter, CLOSE_ARRAY});
+
+    element_counter = counters_.back();
+    ++element_counter;
+    counters_.pop_back();
+    ++objects_;
+    break;
+
+  case ':':
+    if (brace_stack_.empty() || (brace_stack_.back() != '}'))
+    {
+      throw JSONParseException("Cannot set property outside of object context");
+    }
+    break;
+
+  default:
+    break;
+  }
+}
+
+constexpr std::size_t JSONDocument::LazyValue::NPOS;
+
+JSONDocument::LazyValue::LazyValue(JSONDocument const &document, std::size_t token)
+  : document_{&document}
+  , token_{token}
+{}
+
+bool JSONDocument::LazyValue::IsObject() const
+{
+  return token().type == OPEN_OBJECT;
+}
+
+bool JSONDocument::LazyValue::IsArray() const
+{
+  return token().type == OPEN_ARRAY;
+}
+
+bool JSONDocument::LazyValue::IsString() const
+{
+  return token().type == STRING;
+}
+
+bool JSONDocument::LazyValue::IsInteger() const
+{
+  return token().type == NUMBER_INT;
+}
+
+bool JSONDocument::LazyValue::IsFloatingPoint() const
+{
+  return token().type == NUMBER_FLOAT;
+}
+
+bool JSONDocument::LazyValue::IsBoolean() const
+{
+  return (token().type == KEYWORD_TRUE) || (token().type == KEYWORD_FALSE);
+}
+
+bool JSONDocument::LazyValue::IsNull() const
+{
+  return token().type == KEYWORD_NULL;
+}
+
+/**
+ * @return The number of elements of an array, or of members of an object (counting repeated keys)
+ * @throws std::runtime_error if the value is neither an array nor an object
+ */
+std::size_t JSONDocument::LazyValue::size() const
+{
+  if (!IsOpening(token().type))
+  {
+    throw std::runtime_error("Unable to determine the size of a primitive value");
+  }
+
+  // the keys of an object are counted as elements
+  std::size_t const elements = document_->tokens_[token().second].second;
+
+  return IsObject() ? (elements / 2) : elements;
+}
+
+/**
+ * @param key The key to lookup
+ * @return true if the object has a member with the key, otherwise false
+ * @throws std::runtime_error if the value is not an object
+ */
+bool JSONDocument::LazyValue::Has(ConstByteArray const &key) const
+{
+  return Find(key) != NPOS;
+}
+
+/**
+ * @param key The key to lookup
+ * @return The view of the member with the key, the last one if it is repeated (as when parsed)
+ * @throws std::runtime_error if the value is not an object
+ * @throws std::out_of_range if the key is not present
+ */
+JSONDocument::LazyValue JSONDocument::LazyValue::operator[](ConstByteArray const &key) const
+{
+  std::size_t const value = Find(key);
+  if (value == NPOS)
+  {
+    throw std::out_of_range("Key not present in object");
+  }
+
+  return {*document_, value};
+}
+
+/**
+ * @param index The index of the element
+ * @return The view of the element
+ * @throws std::runtime_error if the value is not an array
+ * @throws std::out_of_range if the index is past the end of the array
+ */
+JSONDocument::LazyValue JSONDocument::LazyValue::operator[](std::size_t index) const
+{
+  if (!IsArray())
+  {
+    throw std::runtime_error("Unable to access index of non-array variant");
+  }
+
+  std::size_t const closing = token().second;
+
+  std::size_t element = token_ + 1;
+  for (std::size_t i = 0; (i < index) && (element < closing); ++i)
+  {
+    element = Next(element);
   }
+
+  if (element >= closing)
+  {
+    throw std::out_of_range("Index past the end of the array");
+  }
+
+  return {*document_, element};
+}
+
+/**
+ * @return The variant (tree) of the value
+ */
+JSONDocument::Variant JSONDocument::LazyValue::ToVariant() const
+{
+  Variant variant;
+
+  if (IsOpening(token().type))
+  {
+    document_->Build(variant, token_, token().second + 1);
+  }
+  else
+  {
+    ExtractPrimitive(variant, token(), document_->document_);
+  }
+
+  return variant;
+}
+
+JSONDocument::JSONToken const &JSONDocument::LazyValue::token() const
+{
+  return document_->tokens_[token_];
+}
+
+/**
+ * @param token The index of the first token of a value
+ * @return The index of the token after the value
+ */
+std::size_t JSONDocument::LazyValue::Next(std::size_t token) const
+{
+  JSONToken const &first = document_->tokens_[token];
+
+  return IsOpening(first.type) ? (first.second + 1) : (token + 1);
+}
+
+/**
+ * @param key The key to lookup
+ * @return The index of the first token of the last member with the key, or NPOS
+ * @throws std::runtime_error if the value is not an object
+ */
+std::size_t JSONDocument::LazyValue::Find(ConstByteArray const &key) const
+{
+  if (!IsObject())
+  {
+    throw std::runtime_error("Unable to access keys of non-object variant");
+  }
+
+  auto const &      tokens  = document_->tokens_;
+  uint8_t const *   data    = document_->document_.pointer();
+  std::size_t const closing = token().second;
+  std::size_t       found   = NPOS;
+
+  for (std::size_t member = token_ + 1; (member + 1) < closing;)
+  {
+    JSONToken const & name  = tokens[member];
+    std::size_t const value = member + 1;
+
+    if ((name.type == STRING) && ((name.second - name.first) == key.size()) &&
+        (std::memcmp(data + name.first, key.pointer(), key.size()) == 0))
+    {
+      found = value;
+    }
+
+    member = Next(value);
+  }
+
+  return found;
 }
 
 }  // namespace json
@@ -17,6 +17,9 @@
 //------------------------------------------------------------------------------
 
 #include "core/logger.hpp"
+#include "core/containers/lock_free_queue.hpp"
+
+#include <algorithm>
 
 namespace fetch {
 std::map<std::thread::id, int> fetch::log::ReadableThread::thread_number_ =
@@ -65,6 +68,221 @@ Context::~Context()
     fetch::logger.SetContext(details_->parent());
   }
 }
+
+constexpr std::size_t               AsyncLogger::QUEUE_CAPACITY;
+constexpr std::chrono::milliseconds AsyncLogger::WRITE_INTERVAL;
+
+/**
+ * The entries of one thread, only ever pushed by that thread and popped by the writer
+ */
+struct AsyncLogger::Queue
+{
+  core::LockFreeMPMCQueue<Entry, QUEUE_CAPACITY> entries;
+
+  /// Set once the owning thread has exited, the writer drops the queue after emptying it
+  std::atomic<bool> orphaned{false};
+};
+
+/**
+ * Reference of a thread to its queue, the queue is orphaned when the thread exits
+ */
+struct AsyncLogger::QueueRef
+{
+  uint64_t logger = 0;
+  QueuePtr queue;
+
+  ~QueueRef()
+  {
+    if (queue)
+    {
+      queue->orphaned = true;
+    }
+  }
+};
+
+namespace {
+
+std::atomic<uint64_t> next_logger_id{1};
+
+}  // namespace
+
+AsyncLogger::AsyncLogger()
+  : id_(next_logger_id++)
+{
+  thread_ = std::thread([this]() { Run(); });
+}
+
+/**
+ * Stops the writer, once it has written the entries which are still queued
+ */
+AsyncLogger::~AsyncLogger()
+{
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    running_ = false;
+  }
+  wake_.notify_one();
+  thread_.join();
+}
+
+/**
+ * Queues an entry of the calling thread. Only waits if the queue of the thread is full
+ * @param level the level of the entry
+ * @param text the source column and the message of the entry
+ */
+void AsyncLogger::Push(Level level, std::string text)
+{
+  static thread_local int const thread_number =
+      ReadableThread::GetThreadID(std::this_thread::get_id());
+
+  Entry entry;
+  entry.level         = level;
+  entry.thread_number = thread_number;
+  entry.time          = DefaultLogger::Clock::now();
+  entry.text          = std::move(text);
+
+  Queue &queue = LocalQueue();
+  while (!queue.entries.TryPush(std::move(entry)))
+  {
+    Wake();
+    std::this_thread::yield();
+  }
+
+  // wake the writer early rather than let the thread stall on a full queue
+  if (queue.entries.size() >= QUEUE_CAPACITY / 2)
+  {
+    Wake();
+  }
+}
+
+/**
+ * Waits until the writer has written every entry queued before the call
+ */
+void AsyncLogger::Flush()
+{
+  std::unique_lock<std::mutex> lock(wake_mutex_);
+  uint64_t const               request = ++flush_requested_;
+  wake_.notify_one();
+  flushed_.wait(lock, [this, request]() { return (flush_completed_ >= request) || !running_; });
+}
+
+AsyncLogger::Queue &AsyncLogger::LocalQueue()
+{
+  static thread_local QueueRef local;
+
+  if (local.logger != id_)
+  {
+    // a queue of a previous logger is left for that one to drop
+    if (local.queue)
+    {
+      local.queue->orphaned = true;
+    }
+
+    local.logger = id_;
+    local.queue  = std::make_shared<Queue>();
+
+    std::lock_guard<std::mutex> lock(queues_mutex_);
+    queues_.push_back(local.queue);
+  }
+
+  return *local.queue;
+}
+
+void AsyncLogger::Wake()
+{
+  if (!pending_.exchange(true))
+  {
+    wake_.notify_one();
+  }
+}
+
+void AsyncLogger::Run()
+{
+  std::vector<Entry> entries;
+
+  std::unique_lock<std::mutex> lock(wake_mutex_);
+  for (;;)
+  {
+    wake_.wait_for(lock, WRITE_INTERVAL, [this]() {
+      return !running_ || pending_ || (flush_requested_ != flush_completed_);
+    });
+
+    bool const     stopping = !running_;
+    uint64_t const request  = flush_requested_;
+    pending_                = false;
+    lock.unlock();
+
+    Drain(entries);
+    Write(entries);
+
+    lock.lock();
+    flush_completed_ = request;
+    flushed_.notify_all();
+
+    if (stopping)
+    {
+      break;
+    }
+  }
+}
+
+/**
+ * Collects the queued entries of all the threads, in the order they were logged
+ */
+void AsyncLogger::Drain(std::vector<Entry> &entries)
+{
+  entries.clear();
+
+  std::lock_guard<std::mutex> lock(queues_mutex_);
+  for (auto it = queues_.begin(); it != queues_.end();)
+  {
+    // read before emptying the queue, nothing is pushed once the thread has exited
+    bool const orphaned = (*it)->orphaned;
+
+    Entry entry;
+    while ((*it)->entries.TryPop(entry))
+    {
+      entries.push_back(std::move(entry));
+    }
+
+    if (orphaned)
+    {
+      it = queues_.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  // the entries of each thread are in order already
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](Entry const &a, Entry const &b) { return a.time < b.time; });
+}
+
+void AsyncLogger::Write(std::vector<Entry> &entries)
+{
+  if (entries.empty())
+  {
+    return;
+  }
+
+#ifndef FETCH_DISABLE_COUT_LOGGING
+  using namespace fetch::commandline::VT100;
+
+  std::ostringstream batch;
+  for (auto const &entry : entries)
+  {
+    DefaultLogger::WritePrefix(batch, entry.level, entry.time, entry.thread_number);
+    batch << entry.text << DefaultAttributes() << '\n';
+  }
+
+  std::cout << batch.str() << std::flush;
+#endif
+
+  entries.clear();
+}
+
 }  // namespace log
 
 }  // namespace fetch
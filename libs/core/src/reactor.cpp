@@ -21,10 +21,12 @@
 #include "core/runnable.hpp"
 #include "core/threading.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <deque>
 
 static const std::chrono::milliseconds POLL_INTERVAL{15};
+static const std::chrono::seconds      MAX_SLEEP{1};  ///< Bounds the effect of a missed wake up
 
 using WorkQueue = std::deque<fetch::core::WeakRunnable>;
 
@@ -35,6 +37,22 @@ Reactor::Reactor(std::string name)
   : name_{std::move(name)}
 {}
 
+Reactor::~Reactor()
+{
+  Stop();
+
+  // ensure that none of the remaining runnables are able to signal this reactor
+  FETCH_LOCK(work_map_mutex_);
+  for (auto const &element : work_map_)
+  {
+    auto concrete_runnable = element.second.lock();
+    if (concrete_runnable)
+    {
+      concrete_runnable->SetWakeCallback(Runnable::WakeCallback{});
+    }
+  }
+}
+
 bool Reactor::Attach(WeakRunnable runnable)
 {
   bool success{false};
@@ -50,6 +68,12 @@ bool Reactor::Attach(WeakRunnable runnable)
 
     // signal success if the insertion was successful
     success = result.second;
+
+    // allow the runnable to trigger the reactor when it becomes ready
+    if (success)
+    {
+      concrete_runnable->SetWakeCallback([this]() { Wake(); });
+    }
   }
 
   return success;
@@ -58,7 +82,21 @@ bool Reactor::Attach(WeakRunnable runnable)
 bool Reactor::Detach(Runnable const &runnable)
 {
   FETCH_LOCK(work_map_mutex_);
-  return (work_map_.erase(&runnable) > 0);
+
+  auto it = work_map_.find(&runnable);
+  if (it == work_map_.end())
+  {
+    return false;
+  }
+
+  auto concrete_runnable = it->second.lock();
+  if (concrete_runnable)
+  {
+    concrete_runnable->SetWakeCallback(Runnable::WakeCallback{});
+  }
+
+  work_map_.erase(it);
+  return true;
 }
 
 void Reactor::Start()
@@ -78,6 +116,20 @@ void Reactor::Stop()
   StopWorker();
 }
 
+/**
+ * Trigger the reactor to re-evaluate its runnables immediately rather than at the next deadline.
+ * Safe to be called from any thread.
+ */
+void Reactor::Wake()
+{
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    wake_pending_ = true;
+  }
+
+  wake_condition_.notify_one();
+}
+
 void Reactor::StartWorker()
 {
   if (worker_)
@@ -96,6 +148,7 @@ void Reactor::StartWorker()
 void Reactor::StopWorker()
 {
   running_ = false;
+  Wake();
 
   if (worker_)
   {
@@ -109,7 +162,8 @@ void Reactor::Monitor()
   // set the thread name
   SetThreadName(name_);
 
-  WorkQueue work_queue;
+  WorkQueue           work_queue;
+  Runnable::Timepoint next_evaluation{};
 
   while (running_)
   {
@@ -118,6 +172,9 @@ void Reactor::Monitor()
     {
       FETCH_LOCK(work_map_mutex_);
 
+      auto const now  = Runnable::Clock::now();
+      next_evaluation = now + MAX_SLEEP;
+
       // loop through and evaluate the map
       auto it = work_map_.begin();
       while (it != work_map_.end())
@@ -132,6 +189,18 @@ void Reactor::Monitor()
           {
             work_queue.emplace_back(it->second);
           }
+          else
+          {
+            // otherwise keep track of the earliest point at which a runnable becomes ready,
+            // polling those runnables which are unable to tell
+            auto deadline = concrete_runnable->NextEvaluation();
+            if (deadline == Runnable::Timepoint::min())
+            {
+              deadline = now + POLL_INTERVAL;
+            }
+
+            next_evaluation = std::min(next_evaluation, deadline);
+          }
 
           // advance to the next element in the map
           ++it;
@@ -144,10 +213,13 @@ void Reactor::Monitor()
       }
     }
 
-    // If the work queue is still empty then there is no work to do. Sleep the worker and try again
+    // If the work queue is still empty then there is no work to do. Sleep the worker until either
+    // a runnable signals that it is ready or the earliest deadline of the runnables expires
     if (work_queue.empty())
     {
-      std::this_thread::sleep_for(POLL_INTERVAL);
+      std::unique_lock<std::mutex> lock(wake_mutex_);
+      wake_condition_.wait_until(lock, next_evaluation, [this]() { return wake_pending_; });
+      wake_pending_ = false;
       continue;
     }
 
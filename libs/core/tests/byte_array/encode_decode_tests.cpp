@@ -22,7 +22,11 @@
 #include "core/byte_array/decoders.hpp"
 #include "core/byte_array/encoders.hpp"
 
+#include <algorithm>
+#include <cctype>
 #include <iostream>
+#include <string>
+
 using namespace fetch::byte_array;
 void Test(ByteArray val)
 {
@@ -88,4 +92,111 @@ TEST(core_encode_decode_gtest, some_simple_cases_for_base_64)
   EXPECT_EQ(FromBase64(ToBase64("ab")), "ab");
   EXPECT_EQ(FromBase64(ToBase64("abc")), "abc");
   EXPECT_EQ(FromBase64(ToBase64("abcd")), "abcd");
-}
\ No newline at end of file
+}
+namespace {
+
+// straightforward reference implementations, the library processes long inputs in blocks
+std::string ReferenceHex(ConstByteArray const &data)
+{
+  static char const digits[] = "0123456789abcdef";
+
+  std::string ret;
+  for (std::size_t i = 0; i < data.size(); ++i)
+  {
+    ret.push_back(digits[data[i] >> 4]);
+    ret.push_back(digits[data[i] & 0xF]);
+  }
+  return ret;
+}
+
+std::string ReferenceBase64(ConstByteArray const &data)
+{
+  static char const chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+  std::string ret;
+  for (std::size_t i = 0; i < data.size(); i += 3)
+  {
+    uint32_t    group = uint32_t(data[i]) << 16;
+    std::size_t count = std::min<std::size_t>(3, data.size() - i);
+    if (count > 1)
+    {
+      group |= uint32_t(data[i + 1]) << 8;
+    }
+    if (count > 2)
+    {
+      group |= uint32_t(data[i + 2]);
+    }
+
+    for (std::size_t k = 0; k < 4; ++k)
+    {
+      ret.push_back((k <= count) ? chars[(group >> (18 - (6 * k))) & 0x3F] : '=');
+    }
+  }
+  return ret;
+}
+
+ByteArray GenerateData(std::size_t size)
+{
+  ByteArray data;
+  data.Resize(size);
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    data[i] = uint8_t((i * 131) + (size * 7));
+  }
+  return data;
+}
+
+}  // namespace
+
+TEST(core_encode_decode_gtest, long_inputs_match_reference_encodings)
+{
+  for (std::size_t size = 0; size <= 200; ++size)
+  {
+    ConstByteArray const data = GenerateData(size);
+
+    ConstByteArray const hex = ToHex(data);
+    EXPECT_EQ(hex, ConstByteArray(ReferenceHex(data))) << "size: " << size;
+    EXPECT_EQ(FromHex(hex), data) << "size: " << size;
+
+    ConstByteArray const base64 = ToBase64(data);
+    EXPECT_EQ(base64, ConstByteArray(ReferenceBase64(data))) << "size: " << size;
+    EXPECT_EQ(FromBase64(base64), data) << "size: " << size;
+  }
+}
+
+TEST(core_encode_decode_gtest, hex_decoding_is_case_insensitive)
+{
+  ConstByteArray const data = GenerateData(100);
+
+  std::string upper = ReferenceHex(data);
+  std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+
+  EXPECT_EQ(FromHex(upper), data);
+}
+
+TEST(core_encode_decode_gtest, invalid_characters_in_long_inputs_are_rejected)
+{
+  ConstByteArray const data = GenerateData(96);
+
+  std::string const hex = ReferenceHex(data);
+  for (std::size_t pos : {0u, 17u, 31u, 100u, 191u})
+  {
+    for (char c : {'g', 'G', '/', ':', '@', '`', ' '})
+    {
+      std::string invalid = hex;
+      invalid[pos]        = c;
+      EXPECT_EQ(FromHex(invalid), ConstByteArray{}) << "pos: " << pos << " char: " << c;
+    }
+  }
+
+  std::string const base64 = ReferenceBase64(data);
+  for (std::size_t pos : {0u, 15u, 42u, 127u})
+  {
+    for (char c : {'-', '_', '.', '*', '\x80'})
+    {
+      std::string invalid = base64;
+      invalid[pos]        = c;
+      EXPECT_EQ(FromBase64(invalid), ConstByteArray{}) << "pos: " << pos << " char: " << c;
+    }
+  }
+}
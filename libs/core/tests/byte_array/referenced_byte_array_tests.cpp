@@ -89,7 +89,8 @@ TEST(reference_byte_array_gtest, testing_that_ConstByteArray_r_value_moved_if_un
 
 TEST(reference_byte_array_gtest, testing_that_ConstByteArray_r_value_not_moved_if_not_unique)
 {
-  char const *   base = "hello world";
+  // long enough not to be stored inline, so that the copies share the contents
+  char const *   base = "hello world, this is long enough to be stored in a shared array";
   ConstByteArray expected_to_remain_unchanged{base};
   ConstByteArray expected_to_remain_unchanged_2{expected_to_remain_unchanged};
   EXPECT_EQ(expected_to_remain_unchanged.UseCount(), 2);
@@ -104,7 +105,7 @@ TEST(reference_byte_array_gtest, testing_that_ConstByteArray_r_value_not_moved_i
   copy[3] = 't';
   copy[4] = 'y';
 
-  EXPECT_EQ(copy, "kitty world");
+  EXPECT_EQ(copy, "kitty world, this is long enough to be stored in a shared array");
   EXPECT_EQ(expected_to_remain_unchanged, base);
   EXPECT_EQ(expected_to_remain_unchanged_2, base);  // NOLINT(bugprone-use-after-move)
 }
@@ -239,3 +240,61 @@ TEST(reference_byte_array_gtest, size_of_loaded_C_strings)
   EXPECT_EQ(ByteArray("any carnal pleasure").size(), 19);
   EXPECT_EQ(ByteArray("any carnal pleasure.").size(), 20);
 }
+
+TEST(reference_byte_array_gtest, small_ConstByteArray_is_stored_inline)
+{
+  ConstByteArray const small{"hello world"};
+  ConstByteArray const large{std::string(2 * ConstByteArray::INLINE_CAPACITY, 'x')};
+
+  EXPECT_TRUE(small.IsInline());
+  EXPECT_FALSE(large.IsInline());
+
+  // copies of inline arrays are independent copies of the same value
+  ConstByteArray const copy{small};
+  EXPECT_TRUE(copy.IsInline());
+  EXPECT_NE(copy.pointer(), small.pointer());
+  EXPECT_EQ(copy, small);
+  EXPECT_EQ(copy.UseCount(), 1);
+
+  ConstByteArray copy_2{small};
+  ConstByteArray moved{std::move(copy_2)};
+  EXPECT_EQ(moved, "hello world");
+
+  ConstByteArray assigned{large};
+  assigned = small;
+  EXPECT_TRUE(assigned.IsInline());
+  EXPECT_EQ(assigned, small);
+
+  assigned = ConstByteArray{"kitty"};
+  EXPECT_EQ(assigned, "kitty");
+
+  // small sub arrays are copied, large ones are views
+  EXPECT_TRUE(large.SubArray(1, 32).IsInline());
+  EXPECT_EQ(large.SubArray(1, 32), std::string(32, 'x'));
+  ConstByteArray const view{large.SubArray(1)};
+  EXPECT_EQ(view.pointer(), large.pointer() + 1);
+  EXPECT_EQ(small.SubArray(6), "world");
+}
+
+TEST(reference_byte_array_gtest, ByteArray_is_never_stored_inline)
+{
+  ConstByteArray const small{"hello world"};
+
+  ByteArray from_const{small};
+  ByteArray from_moved{ConstByteArray{small}};
+  ByteArray from_string{"hello world"};
+
+  EXPECT_FALSE(from_const.IsInline());
+  EXPECT_FALSE(from_moved.IsInline());
+  EXPECT_FALSE(from_string.IsInline());
+
+  // so that the copies continue to share the contents
+  ByteArray copy{from_moved};
+  copy[0] = 'j';
+  EXPECT_EQ(from_moved, "jello world");
+  EXPECT_EQ(small, "hello world");
+
+  // growing the array keeps the contents
+  from_const.Resize(small.size() + ConstByteArray::INLINE_CAPACITY);
+  EXPECT_EQ(from_const.SubArray(0, small.size()), small);
+}
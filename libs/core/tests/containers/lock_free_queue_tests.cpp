@@ -0,0 +1,155 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/containers/lock_free_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using fetch::core::LockFreeMPMCQueue;
+
+TEST(LockFreeQueueTests, PushAndPopInOrder)
+{
+  LockFreeMPMCQueue<std::size_t, 8> queue;
+
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    EXPECT_TRUE(queue.TryPush(std::size_t{i}));
+  }
+
+  // the queue is now full
+  EXPECT_FALSE(queue.TryPush(std::size_t{8}));
+  EXPECT_EQ(queue.size(), 8);
+
+  std::size_t value = 0;
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    ASSERT_TRUE(queue.TryPop(value));
+    EXPECT_EQ(value, i);
+  }
+
+  // the queue is now empty
+  EXPECT_FALSE(queue.TryPop(value));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(LockFreeQueueTests, WrapsAroundTheRing)
+{
+  LockFreeMPMCQueue<std::size_t, 4> queue;
+
+  std::size_t value = 0;
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    ASSERT_TRUE(queue.TryPush(std::size_t{i}));
+    ASSERT_TRUE(queue.TryPop(value));
+    EXPECT_EQ(value, i);
+  }
+}
+
+TEST(LockFreeQueueTests, BulkPushAndPop)
+{
+  LockFreeMPMCQueue<std::size_t, 8> queue;
+
+  // only as many elements as there is space for are pushed
+  std::vector<std::size_t> const input{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  auto                           it = input.begin();
+  EXPECT_EQ(queue.TryPushBulk(it, input.end()), 8);
+  EXPECT_EQ(it, input.begin() + 8);
+  EXPECT_EQ(queue.TryPushBulk(it, input.end()), 0);
+
+  std::vector<std::size_t> output;
+  EXPECT_EQ(queue.TryPopBulk(output, 5), 5);
+  EXPECT_EQ(queue.TryPushBulk(it, input.end()), 2);
+  EXPECT_EQ(queue.TryPopBulk(output, 16), 5);
+  EXPECT_EQ(queue.TryPopBulk(output, 16), 0);
+
+  EXPECT_EQ(output, input);
+}
+
+TEST(LockFreeQueueTests, MultipleProducersAndConsumers)
+{
+  static constexpr std::size_t NUM_PRODUCERS      = 4;
+  static constexpr std::size_t NUM_CONSUMERS      = 4;
+  static constexpr std::size_t ITEMS_PER_PRODUCER = 100000;
+  static constexpr std::size_t TOTAL_ITEMS        = NUM_PRODUCERS * ITEMS_PER_PRODUCER;
+
+  using ThreadPtr  = std::unique_ptr<std::thread>;
+  using ThreadList = std::vector<ThreadPtr>;
+
+  LockFreeMPMCQueue<std::size_t, 1024> queue;
+  std::vector<std::atomic<std::size_t>> seen(TOTAL_ITEMS);
+  std::atomic<std::size_t>             consumed{0};
+
+  for (auto &entry : seen)
+  {
+    entry = 0;
+  }
+
+  ThreadList threads;
+  for (std::size_t p = 0; p < NUM_PRODUCERS; ++p)
+  {
+    threads.emplace_back(std::make_unique<std::thread>([&queue, p]() {
+      for (std::size_t i = 0; i < ITEMS_PER_PRODUCER; ++i)
+      {
+        std::size_t const value = (p * ITEMS_PER_PRODUCER) + i;
+        while (!queue.TryPush(std::size_t{value}))
+        {
+          std::this_thread::yield();
+        }
+      }
+    }));
+  }
+
+  for (std::size_t c = 0; c < NUM_CONSUMERS; ++c)
+  {
+    threads.emplace_back(std::make_unique<std::thread>([&queue, &seen, &consumed]() {
+      std::size_t value = 0;
+      while (consumed < TOTAL_ITEMS)
+      {
+        if (queue.TryPop(value))
+        {
+          ++seen[value];
+          ++consumed;
+        }
+        else
+        {
+          std::this_thread::yield();
+        }
+      }
+    }));
+  }
+
+  for (auto &thread : threads)
+  {
+    thread->join();
+  }
+
+  // every item must have been received exactly once
+  for (auto const &entry : seen)
+  {
+    ASSERT_EQ(entry, 1);
+  }
+}
+
+}  // namespace
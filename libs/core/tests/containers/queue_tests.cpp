@@ -18,6 +18,7 @@
 
 #include "core/containers/queue.hpp"
 
+#include <array>
 #include <atomic>
 #include <gtest/gtest.h>
 #include <memory>
@@ -221,4 +222,110 @@ TEST_F(QueueTests, ProducerConsumer_1p_50c_1000x__MPMCQueue)
   ProducerConsumerTest<1, 50, 1000>(queue);
 }
 
+TEST_F(QueueTests, BulkPushLargerThanTheQueue)
+{
+  static constexpr std::size_t QUEUE_SIZE    = 16;
+  static constexpr std::size_t NUM_PRODUCERS = 4;
+  static constexpr std::size_t NUM_ELEMENTS  = 1000;
+  static constexpr std::size_t BATCH_SIZE    = 100;
+
+  fetch::core::MPMCQueue<uint32_t, QUEUE_SIZE> queue;
+
+  std::vector<std::unique_ptr<std::thread>> producers(NUM_PRODUCERS);
+  for (std::size_t producer = 0; producer < NUM_PRODUCERS; ++producer)
+  {
+    producers[producer] = std::make_unique<std::thread>([&queue, producer]() {
+      std::vector<uint32_t> batch(BATCH_SIZE);
+      for (std::size_t i = 0; i < NUM_ELEMENTS; i += BATCH_SIZE)
+      {
+        for (std::size_t j = 0; j < BATCH_SIZE; ++j)
+        {
+          batch[j] = static_cast<uint32_t>((producer << 16u) | (i + j));
+        }
+
+        queue.PushBulk(batch.begin(), batch.end());
+      }
+    });
+  }
+
+  // the elements of each producer are received in the order they were pushed
+  std::array<uint32_t, NUM_PRODUCERS> next{};
+  for (std::size_t i = 0; i < NUM_PRODUCERS * NUM_ELEMENTS; ++i)
+  {
+    uint32_t value{0};
+    ASSERT_TRUE(queue.Pop(value, std::chrono::seconds{4}));
+
+    auto const producer = value >> 16u;
+    ASSERT_LT(producer, NUM_PRODUCERS);
+    EXPECT_EQ(value & 0xFFFFu, next[producer]++);
+  }
+
+  for (auto &producer : producers)
+  {
+    producer->join();
+  }
+
+  for (auto const &count : next)
+  {
+    EXPECT_EQ(count, NUM_ELEMENTS);
+  }
+}
+
+TEST_F(QueueTests, BulkPopReturnsAvailableElements)
+{
+  static constexpr std::size_t QUEUE_SIZE = 16;
+
+  fetch::core::MPMCQueue<uint32_t, QUEUE_SIZE> queue;
+  std::vector<uint32_t>                        values;
+
+  // nothing is available, the pop gives up after the duration
+  EXPECT_EQ(queue.PopBulk(values, 4, std::chrono::milliseconds{10}), 0);
+
+  std::vector<uint32_t> const batch{1, 2, 3, 4, 5, 6};
+  queue.PushBulk(batch.begin(), batch.end());
+
+  // at most the requested number of elements are extracted, in order
+  EXPECT_EQ(queue.PopBulk(values, 4, std::chrono::milliseconds{10}), 4);
+  EXPECT_EQ(queue.PopBulk(values, 4, std::chrono::milliseconds{10}), 2);
+  EXPECT_EQ(values, batch);
+  EXPECT_EQ(queue.size(), 0);
+}
+
+TEST_F(QueueTests, ParkedConsumerIsWokenByProducer)
+{
+  static constexpr std::size_t QUEUE_SIZE = 16;
+
+  fetch::core::MPMCQueue<uint32_t, QUEUE_SIZE> queue;
+
+  // the consumer will have parked long before the element arrives
+  std::thread consumer([&queue]() { EXPECT_EQ(queue.Pop(), 42u); });
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+
+  queue.Push(uint32_t{42});
+  consumer.join();
+
+  // fill the queue, the next push must wait for a free slot
+  for (uint32_t i = 0; i < QUEUE_SIZE; ++i)
+  {
+    queue.Push(uint32_t{i});
+  }
+
+  std::size_t count{0};
+  EXPECT_FALSE(queue.Push(uint32_t{99}, count, std::chrono::milliseconds{10}));
+
+  std::thread producer([&queue]() { queue.Push(uint32_t{99}); });
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+
+  uint32_t value{0};
+  for (uint32_t i = 0; i < QUEUE_SIZE; ++i)
+  {
+    ASSERT_TRUE(queue.Pop(value, std::chrono::seconds{4}));
+    EXPECT_EQ(value, i);
+  }
+
+  producer.join();
+  ASSERT_TRUE(queue.Pop(value, std::chrono::seconds{4}));
+  EXPECT_EQ(value, 99u);
+}
+
 }  // namespace
@@ -0,0 +1,213 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "core/fixed_point/fixed_point_kernels.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using namespace fetch::fixed_point;
+
+template <typename T>
+class FixedPointKernelsTest : public ::testing::Test
+{
+};
+
+using FixedPointTypes = ::testing::Types<FixedPoint<16, 16>, FixedPoint<32, 32>>;
+TYPED_TEST_CASE(FixedPointKernelsTest, FixedPointTypes);
+
+template <typename T>
+std::vector<T> Range(double begin, double end, std::size_t count)
+{
+  std::vector<T> values;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    values.emplace_back(begin + ((end - begin) * double(i) / double(count - 1)));
+  }
+
+  return values;
+}
+
+template <typename T>
+long double ToLongDouble(T const &value)
+{
+  return std::ldexp(static_cast<long double>(value.Data()), -static_cast<int>(T::FRACTIONAL_BITS));
+}
+
+template <typename T>
+double Ulp()
+{
+  return std::ldexp(1.0, -static_cast<int>(T::FRACTIONAL_BITS));
+}
+
+TYPED_TEST(FixedPointKernelsTest, arithmetic_matches_scalar_operators)
+{
+  using T = TypeParam;
+
+  auto const a = Range<T>(-100.0, 100.0, 1001);
+  auto       b = Range<T>(-7.3, 9.1, 1001);
+  std::vector<T> out(a.size());
+
+  batch::Add(a.data(), b.data(), out.data(), a.size());
+  for (std::size_t i = 0; i < a.size(); ++i)
+  {
+    EXPECT_EQ(a[i] + b[i], out[i]);
+  }
+
+  batch::Subtract(a.data(), b.data(), out.data(), a.size());
+  for (std::size_t i = 0; i < a.size(); ++i)
+  {
+    EXPECT_EQ(a[i] - b[i], out[i]);
+  }
+
+  batch::Multiply(a.data(), b.data(), out.data(), a.size());
+  for (std::size_t i = 0; i < a.size(); ++i)
+  {
+    EXPECT_EQ(a[i] * b[i], out[i]);
+  }
+
+  batch::Multiply(a.data(), T{0.75}, out.data(), a.size());
+  for (std::size_t i = 0; i < a.size(); ++i)
+  {
+    EXPECT_EQ(a[i] * T{0.75}, out[i]);
+  }
+
+  for (auto &value : b)
+  {
+    if (value == T::CONST_ZERO)
+    {
+      value = T::CONST_ONE;
+    }
+  }
+
+  batch::Divide(a.data(), b.data(), out.data(), a.size());
+  for (std::size_t i = 0; i < a.size(); ++i)
+  {
+    EXPECT_EQ(a[i] / b[i], out[i]);
+  }
+
+  b[17] = T::CONST_ZERO;
+  EXPECT_THROW(batch::Divide(a.data(), b.data(), out.data(), a.size()), std::overflow_error);
+}
+
+TYPED_TEST(FixedPointKernelsTest, exp_is_within_bounds)
+{
+  using T = TypeParam;
+
+  auto const values =
+      Range<T>(static_cast<double>(T::MIN_EXP), static_cast<double>(T::MAX_EXP), 20001);
+  std::vector<T> out(values.size());
+
+  batch::Exp(values.data(), out.data(), values.size());
+
+  // the reference is computed in extended precision, since large results of the 32.32 type have
+  // more significant bits than a double
+  long double const relative = std::ldexp(1.0L, -(static_cast<int>(T::TOTAL_BITS) - 6)) +
+                               std::numeric_limits<long double>::epsilon();
+  for (std::size_t i = 0; i < values.size(); ++i)
+  {
+    // the result saturates at the largest value
+    long double const expected =
+        std::min(std::exp(ToLongDouble(values[i])), ToLongDouble(T::FromBase(T::MAX)));
+
+    EXPECT_LE(std::fabs(expected - ToLongDouble(out[i])), Ulp<T>() + (relative * expected))
+        << "x = " << values[i];
+  }
+
+  T const exact[] = {T::CONST_ZERO, T::CONST_ONE, T{-1}};
+  T       result[3];
+  batch::Exp(exact, result, 3);
+  EXPECT_EQ(T::CONST_ONE, result[0]);
+  EXPECT_NEAR(std::exp(1.0), static_cast<double>(result[1]), Ulp<T>());
+  EXPECT_NEAR(std::exp(-1.0), static_cast<double>(result[2]), Ulp<T>());
+
+  T const too_large = T::MAX_EXP + T::CONST_ONE;
+  EXPECT_THROW(batch::Exp(&too_large, result, 1), std::overflow_error);
+}
+
+TYPED_TEST(FixedPointKernelsTest, log_is_within_bounds)
+{
+  using T = TypeParam;
+
+  std::vector<T> values = Range<T>(0.001, 1000.0, 20001);
+  values.push_back(T::CONST_SMALLEST_FRACTION);
+  values.push_back(T::FromBase(T::MAX));
+
+  std::vector<T> out(values.size());
+
+  batch::Log2(values.data(), out.data(), values.size());
+  for (std::size_t i = 0; i < values.size(); ++i)
+  {
+    EXPECT_NEAR(std::log2(static_cast<double>(values[i])), static_cast<double>(out[i]), Ulp<T>())
+        << "x = " << values[i];
+  }
+
+  batch::Log(values.data(), out.data(), values.size());
+  for (std::size_t i = 0; i < values.size(); ++i)
+  {
+    EXPECT_NEAR(std::log(static_cast<double>(values[i])), static_cast<double>(out[i]),
+                2 * Ulp<T>())
+        << "x = " << values[i];
+  }
+
+  T const one = T::CONST_ONE;
+  T       result;
+  batch::Log2(&one, &result, 1);
+  EXPECT_EQ(T::CONST_ZERO, result);
+
+  T const zero = T::CONST_ZERO;
+  EXPECT_THROW(batch::Log2(&zero, &result, 1), std::runtime_error);
+}
+
+TYPED_TEST(FixedPointKernelsTest, sqrt_is_correctly_rounded)
+{
+  using T = TypeParam;
+
+  std::vector<T> values = Range<T>(0.0, 30000.0, 20001);
+  values.push_back(T::CONST_SMALLEST_FRACTION);
+  values.push_back(T::FromBase(T::MAX));
+
+  std::vector<T> out(values.size());
+  batch::Sqrt(values.data(), out.data(), values.size());
+
+  for (std::size_t i = 0; i < values.size(); ++i)
+  {
+    EXPECT_NEAR(std::sqrt(static_cast<double>(values[i])), static_cast<double>(out[i]),
+                0.5 * Ulp<T>())
+        << "x = " << values[i];
+  }
+
+  T const four = T{4};
+  T       result;
+  batch::Sqrt(&four, &result, 1);
+  EXPECT_EQ(T{2}, result);
+
+  T const negative = T{-1};
+  EXPECT_THROW(batch::Sqrt(&negative, &result, 1), std::runtime_error);
+}
+
+}  // namespace
@@ -160,3 +160,88 @@ TEST(JsonTests, LargeArray)
     EXPECT_EQ(element.As<std::size_t>(), i);
   }
 }
+
+TEST(JsonTests, EscapesAcrossBlockBoundaries)
+{
+  // move the escape sequences across the 64 character blocks of the structural index
+  for (std::size_t padding = 0; padding < 70; ++padding)
+  {
+    std::string const value = std::string(padding, 'x') + R"(\\\"{[\\)";
+    std::string const text  = R"({"key": ")" + value + R"(", "next": [true]})";
+
+    JSONDocument doc;
+    ASSERT_NO_THROW(doc.Parse(text));
+
+    auto const &root = doc.root();
+    ASSERT_TRUE(root.IsObject());
+    ASSERT_EQ(root.size(), 2);
+
+    // the contents of the string keep their escapes
+    EXPECT_EQ(root["key"].As<fetch::byte_array::ConstByteArray>(), value);
+    ASSERT_TRUE(root["next"].IsArray());
+    EXPECT_TRUE(root["next"][0].As<bool>());
+  }
+}
+
+TEST(JsonTests, LazyAccess)
+{
+  char const *text = R"({
+    "count": 42,
+    "name": "fetch",
+    "nested": {"values": [1, 2.5, [3], {"a": null}], "flag": false},
+    "count": 43
+  })";
+
+  JSONDocument doc;
+  ASSERT_NO_THROW(doc.ParseLazy(text));
+
+  // the tree is not built
+  EXPECT_TRUE(doc.root().IsNull());
+
+  auto const root = doc.lazy_root();
+  ASSERT_TRUE(root.IsObject());
+  EXPECT_EQ(root.size(), 4);
+  EXPECT_TRUE(root.Has("name"));
+  EXPECT_FALSE(root.Has("missing"));
+  EXPECT_THROW(root["missing"], std::out_of_range);
+
+  // repeated keys resolve to the last value, as when parsing fully
+  ASSERT_TRUE(root["count"].IsInteger());
+  EXPECT_EQ(root["count"].As<int>(), 43);
+  EXPECT_EQ(root["name"].As<fetch::byte_array::ConstByteArray>(), "fetch");
+
+  auto const nested = root["nested"];
+  ASSERT_TRUE(nested.IsObject());
+  EXPECT_TRUE(nested["flag"].IsBoolean());
+  EXPECT_FALSE(nested["flag"].As<bool>());
+
+  auto const values = nested["values"];
+  ASSERT_TRUE(values.IsArray());
+  ASSERT_EQ(values.size(), 4);
+  EXPECT_TRUE(values[0].IsInteger());
+  EXPECT_TRUE(values[1].IsFloatingPoint());
+  EXPECT_TRUE(values[2].IsArray());
+  EXPECT_TRUE(values[3]["a"].IsNull());
+  EXPECT_THROW(values[4], std::out_of_range);
+  EXPECT_THROW(values["a"], std::runtime_error);
+  EXPECT_THROW(values[0].size(), std::runtime_error);
+
+  // sub trees convert to the same variant as a full parse
+  Variant const converted = nested.ToVariant();
+  ASSERT_TRUE(converted.IsObject());
+  EXPECT_EQ(converted["values"].size(), 4);
+  EXPECT_EQ(converted["values"][2][0].As<int>(), 3);
+
+  JSONDocument full;
+  ASSERT_NO_THROW(full.Parse(text));
+  EXPECT_EQ(root.ToVariant(), full.root());
+}
+
+TEST(JsonTests, LazyParsingExceptions)
+{
+  JSONDocument doc;
+  EXPECT_THROW(doc.lazy_root(), std::runtime_error);
+  EXPECT_THROW(doc.ParseLazy("{"), fetch::json::JSONParseException);
+  EXPECT_THROW(doc.ParseLazy("]"), fetch::json::JSONParseException);
+  EXPECT_THROW(doc.ParseLazy("42"), fetch::json::JSONParseException);
+}
@@ -271,7 +271,7 @@ static const TestCase
                 {R"([1e-2])", true, R"([0.01])", false},
                 {R"([1e+2])", true, R"([100])", false},
                 {R"([123])", true, R"([123])", false},
-                {R"({"asd":"sdf", "dfg":"fgh"})", true, R"({"dfg": "fgh", "asd": "sdf"})", false},
+                {R"({"asd":"sdf", "dfg":"fgh"})", true, R"({"asd": "sdf", "dfg": "fgh"})", false},
                 {R"({"asd":"sdf"})", true, R"({"asd": "sdf"})", false},
                 {R"({"a":"b","a":"c"})", true, R"({"a": "c"})", false},
                 {R"({"a":"b","a":"b"})", true, R"({"a": "b"})", false},
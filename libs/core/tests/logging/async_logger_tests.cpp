@@ -0,0 +1,132 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/logger.hpp"
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class AsyncLoggerTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    previous_ = std::cout.rdbuf(output_.rdbuf());
+    fetch::logger.EnableAsync();
+  }
+
+  void TearDown() override
+  {
+    fetch::logger.DisableAsync();
+    std::cout.rdbuf(previous_);
+  }
+
+  std::vector<std::string> Lines()
+  {
+    std::vector<std::string> lines;
+    std::string              line;
+    std::istringstream       stream(output_.str());
+    while (std::getline(stream, line))
+    {
+      lines.push_back(line);
+    }
+    return lines;
+  }
+
+  std::ostringstream output_;
+  std::streambuf *   previous_ = nullptr;
+};
+
+TEST_F(AsyncLoggerTests, EntriesAreWrittenOnFlush)
+{
+  fetch::logger.InfoWithName("AsyncTest", "the answer is ", 42);
+  fetch::logger.WarnWithName("AsyncTest", "a warning");
+  fetch::logger.Flush();
+
+  auto const lines = Lines();
+  ASSERT_EQ(lines.size(), 2);
+  EXPECT_NE(lines[0].find("INFO"), std::string::npos);
+  EXPECT_NE(lines[0].find("AsyncTest"), std::string::npos);
+  EXPECT_NE(lines[0].find("the answer is 42"), std::string::npos);
+  EXPECT_NE(lines[1].find("WARN"), std::string::npos);
+  EXPECT_NE(lines[1].find("a warning"), std::string::npos);
+}
+
+TEST_F(AsyncLoggerTests, EntriesOfEachThreadStayInOrder)
+{
+  std::size_t const num_threads = 4;
+  std::size_t const num_entries = 3 * fetch::log::AsyncLogger::QUEUE_CAPACITY;
+
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < num_threads; ++t)
+  {
+    threads.emplace_back([t, num_entries]() {
+      for (std::size_t i = 0; i < num_entries; ++i)
+      {
+        fetch::logger.InfoWithName("AsyncTest", "thread ", t, " entry ", i, ';');
+      }
+    });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  fetch::logger.Flush();
+
+  std::vector<std::size_t> next(num_threads, 0);
+  for (auto const &line : Lines())
+  {
+    std::size_t const pos = line.find("thread ");
+    ASSERT_NE(pos, std::string::npos);
+
+    std::size_t t = 0, i = 0;
+    std::string word;
+    std::istringstream(line.substr(pos)) >> word >> t >> word >> i;
+    ASSERT_LT(t, num_threads);
+    EXPECT_EQ(i, next[t]);
+    next[t] = i + 1;
+  }
+
+  for (std::size_t t = 0; t < num_threads; ++t)
+  {
+    EXPECT_EQ(next[t], num_entries);
+  }
+}
+
+TEST_F(AsyncLoggerTests, DisablingWritesSynchronously)
+{
+  fetch::logger.InfoWithName("AsyncTest", "queued");
+  fetch::logger.DisableAsync();
+
+  // the queued entry has been written out
+  ASSERT_EQ(Lines().size(), 1);
+
+  fetch::logger.InfoWithName("AsyncTest", "written");
+  auto const lines = Lines();
+  ASSERT_EQ(lines.size(), 2);
+  EXPECT_NE(lines[1].find("written"), std::string::npos);
+}
+
+}  // namespace
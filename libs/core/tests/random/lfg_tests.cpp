@@ -34,3 +34,26 @@ TEST(lfg_gtest, basic_test)
   }
   std::cout << std::endl;
 }
+
+TEST(lfg_gtest, fill_matches_sequence)
+{
+  fetch::random::LaggedFibonacciGenerator<> sequential{7};
+  fetch::random::LaggedFibonacciGenerator<> batched{7};
+
+  // spans several of the internal buffers
+  std::vector<uint64_t> values(3001);
+  batched.Fill(values.data(), values.size());
+
+  for (auto const value : values)
+  {
+    EXPECT_EQ(sequential(), value);
+  }
+
+  std::vector<double> uniform(2001);
+  batched.FillUniform(uniform.data(), uniform.size());
+
+  for (auto const value : uniform)
+  {
+    EXPECT_EQ(sequential.AsDouble(), value);
+  }
+}
@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "bit_statistics.hpp"
+#include "core/random/philox.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+using fetch::random::Philox4x32;
+
+TEST(philox_gtest, bit_statistics)
+{
+  BitStatistics<Philox4x32> bst;
+
+  EXPECT_TRUE(bst.TestAccuracy(1000000, 0.002));
+}
+
+// known answers from the reference implementation (Random123)
+TEST(philox_gtest, known_answers)
+{
+  EXPECT_EQ((Philox4x32::Counter{{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}}),
+            Philox4x32::Block({{0, 0, 0, 0}}, {{0, 0}}));
+  EXPECT_EQ((Philox4x32::Counter{{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}}),
+            Philox4x32::Block({{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}},
+                              {{0xffffffff, 0xffffffff}}));
+  EXPECT_EQ((Philox4x32::Counter{{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}}),
+            Philox4x32::Block({{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}},
+                              {{0xa4093822, 0x299f31d0}}));
+}
+
+TEST(philox_gtest, fill_matches_sequence)
+{
+  Philox4x32 sequential{7, 3};
+  Philox4x32 batched{7, 3};
+
+  // start from an odd position so that the fill begins part way through a block
+  sequential();
+  batched();
+
+  std::vector<uint64_t> values(1001);
+  batched.Fill(values.data(), values.size());
+
+  for (auto const value : values)
+  {
+    EXPECT_EQ(sequential(), value);
+  }
+
+  std::vector<double> uniform(513);
+  batched.FillUniform(uniform.data(), uniform.size());
+
+  for (auto const value : uniform)
+  {
+    EXPECT_EQ(sequential.AsDouble(), value);
+    EXPECT_GE(value, 0.0);
+    EXPECT_LT(value, 1.0);
+  }
+
+  EXPECT_EQ(sequential.Position(), batched.Position());
+}
+
+TEST(philox_gtest, streams_are_random_access)
+{
+  Philox4x32 stream{5, 1};
+
+  std::vector<uint64_t> values(64);
+  stream.Fill(values.data(), values.size());
+
+  // any position of a stream can be generated directly
+  Philox4x32 other{5, 1};
+  other.Seek(37);
+  EXPECT_EQ(values[37], other());
+
+  // while other streams of the same seed differ
+  Philox4x32 second{5, 2};
+  for (auto const value : values)
+  {
+    EXPECT_NE(second(), value);
+  }
+
+  second.SetStream(1);
+  EXPECT_EQ(values[0], second());
+}
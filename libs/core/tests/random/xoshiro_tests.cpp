@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "bit_statistics.hpp"
+#include "core/random/xoshiro.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+using fetch::random::Xoshiro256PlusPlus;
+
+TEST(xoshiro_gtest, bit_statistics)
+{
+  BitStatistics<Xoshiro256PlusPlus> bst;
+
+  EXPECT_TRUE(bst.TestAccuracy(1000000, 0.002));
+}
+
+TEST(xoshiro_gtest, known_sequence)
+{
+  Xoshiro256PlusPlus rng{42};
+
+  EXPECT_EQ(0xd0764d4f4476689full, rng());
+  EXPECT_EQ(0x519e4174576f3791ull, rng());
+  EXPECT_EQ(0xfbe07cfb0c24ed8cull, rng());
+  EXPECT_EQ(0xb37d9f600cd835b8ull, rng());
+
+  rng.Reset();
+  EXPECT_EQ(0xd0764d4f4476689full, rng());
+}
+
+TEST(xoshiro_gtest, fill_matches_sequence)
+{
+  Xoshiro256PlusPlus sequential{7};
+  Xoshiro256PlusPlus batched{7};
+
+  std::vector<uint64_t> values(1001);
+  batched.Fill(values.data(), values.size());
+
+  for (auto const value : values)
+  {
+    EXPECT_EQ(sequential(), value);
+  }
+
+  std::vector<double> uniform(513);
+  batched.FillUniform(uniform.data(), uniform.size());
+
+  for (auto const value : uniform)
+  {
+    EXPECT_EQ(sequential.AsDouble(), value);
+    EXPECT_GE(value, 0.0);
+    EXPECT_LT(value, 1.0);
+  }
+}
+
+TEST(xoshiro_gtest, jumped_streams_are_distinct)
+{
+  Xoshiro256PlusPlus first{11};
+  Xoshiro256PlusPlus second{11};
+  Xoshiro256PlusPlus second_again{11};
+  second.Jump();
+  second_again.Jump();
+
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    auto const value = second();
+    EXPECT_NE(first(), value);
+    EXPECT_EQ(second_again(), value);
+  }
+
+  Xoshiro256PlusPlus third{11};
+  third.LongJump();
+  EXPECT_NE(third(), Xoshiro256PlusPlus{11}());
+}
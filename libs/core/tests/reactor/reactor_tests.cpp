@@ -0,0 +1,197 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/reactor.hpp"
+#include "core/state_machine.hpp"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+enum class State
+{
+  WAITING,
+  COMPLETE
+};
+
+using StateMachine = fetch::core::StateMachine<State>;
+using Clock        = std::chrono::steady_clock;
+
+class DelayedMachine
+{
+public:
+  DelayedMachine()
+  {
+    state_machine_->RegisterHandler(State::WAITING, this, &DelayedMachine::OnWaiting);
+    state_machine_->RegisterHandler(State::COMPLETE, this, &DelayedMachine::OnComplete);
+  }
+
+  ~DelayedMachine()
+  {
+    state_machine_->Reset();
+  }
+
+  std::shared_ptr<StateMachine> state_machine_{
+      std::make_shared<StateMachine>("Delayed", State::WAITING)};
+  std::atomic<std::size_t> executions_{0};
+  std::atomic<bool>        event_{false};
+
+private:
+  State OnWaiting()
+  {
+    ++executions_;
+
+    if (event_)
+    {
+      return State::COMPLETE;
+    }
+
+    // wait for much longer than the test is expected to take
+    state_machine_->Delay(1h);
+    return State::WAITING;
+  }
+
+  State OnComplete()
+  {
+    state_machine_->Delay(1h);
+    return State::COMPLETE;
+  }
+};
+
+bool WaitFor(std::function<bool()> const &condition, std::chrono::milliseconds timeout)
+{
+  auto const deadline = Clock::now() + timeout;
+  while (!condition())
+  {
+    if (Clock::now() >= deadline)
+    {
+      return false;
+    }
+
+    std::this_thread::sleep_for(1ms);
+  }
+
+  return true;
+}
+
+TEST(ReactorTests, CheckWakeCancelsDelay)
+{
+  DelayedMachine       machine{};
+  fetch::core::Reactor reactor{"Reactor"};
+
+  ASSERT_TRUE(reactor.Attach(machine.state_machine_));
+  reactor.Start();
+
+  // the first execution delays the machine
+  ASSERT_TRUE(WaitFor([&machine]() { return machine.executions_ == 1; }, 5s));
+  std::this_thread::sleep_for(50ms);
+  EXPECT_EQ(1u, machine.executions_);
+  EXPECT_FALSE(machine.state_machine_->IsReadyToExecute());
+
+  // signal the event and wake the machine, it should then be evaluated straight away
+  machine.event_ = true;
+  machine.state_machine_->Wake();
+
+  EXPECT_TRUE(WaitFor([&machine]() { return machine.state_machine_->state() == State::COMPLETE; },
+                      5s));
+
+  reactor.Stop();
+}
+
+TEST(ReactorTests, CheckReactorSleepsUntilDeadline)
+{
+  class PeriodicMachine
+  {
+  public:
+    PeriodicMachine()
+    {
+      state_machine_->RegisterHandler(State::WAITING, this, &PeriodicMachine::OnWaiting);
+    }
+
+    ~PeriodicMachine()
+    {
+      state_machine_->Reset();
+    }
+
+    std::shared_ptr<StateMachine> state_machine_{
+        std::make_shared<StateMachine>("Periodic", State::WAITING)};
+    std::vector<Clock::time_point> executions_{};
+    std::mutex                     lock_;
+
+  private:
+    State OnWaiting()
+    {
+      {
+        std::lock_guard<std::mutex> lock(lock_);
+        executions_.push_back(Clock::now());
+      }
+
+      state_machine_->Delay(100ms);
+      return State::WAITING;
+    }
+  };
+
+  PeriodicMachine      machine{};
+  fetch::core::Reactor reactor{"Reactor"};
+
+  ASSERT_TRUE(reactor.Attach(machine.state_machine_));
+  reactor.Start();
+
+  ASSERT_TRUE(WaitFor(
+      [&machine]() {
+        std::lock_guard<std::mutex> lock(machine.lock_);
+        return machine.executions_.size() >= 3;
+      },
+      5s));
+
+  reactor.Stop();
+
+  // the machine is only executed once its delay has expired
+  std::lock_guard<std::mutex> lock(machine.lock_);
+  for (std::size_t i = 1; i < machine.executions_.size(); ++i)
+  {
+    EXPECT_GE(machine.executions_[i] - machine.executions_[i - 1], 100ms);
+  }
+}
+
+TEST(ReactorTests, CheckWakeWithoutReactor)
+{
+  DelayedMachine machine{};
+
+  machine.state_machine_->Execute();
+  EXPECT_FALSE(machine.state_machine_->IsReadyToExecute());
+
+  // waking a detached machine only cancels the delay
+  machine.state_machine_->Wake();
+  EXPECT_TRUE(machine.state_machine_->IsReadyToExecute());
+
+  machine.state_machine_->Execute();
+  EXPECT_EQ(2u, machine.executions_);
+  EXPECT_FALSE(machine.state_machine_->IsReadyToExecute());
+}
+
+}  // namespace
@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/state_machine.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+enum class State
+{
+  IDLE,
+  WORKING,
+  DONE
+};
+
+char const *ToString(State state)
+{
+  switch (state)
+  {
+  case State::IDLE:
+    return "Idle";
+  case State::WORKING:
+    return "Working";
+  case State::DONE:
+    return "Done";
+  }
+
+  return "Unknown";
+}
+
+class TableMachine
+{
+public:
+  using StateMachine = fetch::core::StateMachine<State, TableMachine>;
+  using StateHandler = fetch::core::StateHandler<TableMachine, State>;
+
+  TableMachine()
+  {
+    static_assert(fetch::core::IsStateTableOrdered(STATE_TABLE), "");
+  }
+
+  ~TableMachine()
+  {
+    state_machine_->Reset();
+  }
+
+  std::shared_ptr<StateMachine> state_machine_{std::make_shared<StateMachine>(
+      "Table", State::IDLE, this, STATE_TABLE, [](State state) { return ToString(state); })};
+  std::size_t work_remaining_{2};
+  State       last_previous_{State::DONE};
+
+private:
+  State OnIdle()
+  {
+    return State::WORKING;
+  }
+
+  State OnWorking()
+  {
+    std::this_thread::sleep_for(1ms);
+    return (--work_remaining_ == 0) ? State::DONE : State::WORKING;
+  }
+
+  State OnDone(State current, State previous)
+  {
+    last_previous_ = previous;
+    return current;
+  }
+
+  static constexpr StateHandler STATE_TABLE[] = {
+      {State::IDLE, &TableMachine::OnIdle},
+      {State::WORKING, &TableMachine::OnWorking},
+      {State::DONE, &TableMachine::OnDone},
+  };
+};
+
+constexpr TableMachine::StateHandler TableMachine::STATE_TABLE[];
+
+struct Unordered
+{
+  State OnIdle()
+  {
+    return State::IDLE;
+  }
+};
+
+constexpr fetch::core::StateHandler<Unordered, State> UNORDERED_TABLE[] = {
+    {State::WORKING, &Unordered::OnIdle},
+    {State::IDLE, &Unordered::OnIdle},
+};
+
+static_assert(!fetch::core::IsStateTableOrdered(UNORDERED_TABLE), "");
+
+TEST(StateMachineTests, CheckTableDispatch)
+{
+  TableMachine machine{};
+  auto &       state_machine = *machine.state_machine_;
+
+  EXPECT_EQ(State::IDLE, state_machine.state());
+
+  state_machine.Execute();
+  EXPECT_EQ(State::WORKING, state_machine.state());
+
+  state_machine.Execute();
+  EXPECT_EQ(State::WORKING, state_machine.state());
+
+  state_machine.Execute();
+  EXPECT_EQ(State::DONE, state_machine.state());
+
+  // the transition handler is passed the current and previous states
+  state_machine.Execute();
+  EXPECT_EQ(State::DONE, state_machine.state());
+  EXPECT_EQ(State::WORKING, machine.last_previous_);
+}
+
+TEST(StateMachineTests, CheckResetStopsDispatch)
+{
+  TableMachine machine{};
+  machine.state_machine_->Reset();
+
+  machine.state_machine_->Execute();
+  EXPECT_EQ(State::IDLE, machine.state_machine_->state());
+}
+
+TEST(StateMachineTests, CheckStateTimings)
+{
+  TableMachine machine{};
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    machine.state_machine_->Execute();
+  }
+
+  auto const timings = machine.state_machine_->GetStateTimings();
+  ASSERT_EQ(3u, timings.size());
+
+  EXPECT_EQ("Idle", timings[0].name);
+  EXPECT_EQ(1u, timings[0].entries);
+  EXPECT_EQ(1u, timings[0].executions);
+
+  EXPECT_EQ("Working", timings[1].name);
+  EXPECT_EQ(1u, timings[1].entries);
+  EXPECT_EQ(2u, timings[1].executions);
+  EXPECT_GE(timings[1].execution_seconds, 0.002);
+  EXPECT_GE(timings[1].residence_seconds, timings[1].execution_seconds);
+
+  EXPECT_EQ("Done", timings[2].name);
+  EXPECT_EQ(static_cast<uint64_t>(State::DONE), timings[2].code);
+  EXPECT_EQ(1u, timings[2].entries);
+  EXPECT_EQ(1u, timings[2].executions);
+}
+
+TEST(StateMachineTests, CheckRegisteredHandlerTimings)
+{
+  using StateMachine = fetch::core::StateMachine<State>;
+
+  StateMachine state_machine{"Registered", State::IDLE};
+
+  struct Handlers
+  {
+    State OnIdle()
+    {
+      return State::DONE;
+    }
+  } handlers;
+
+  state_machine.RegisterHandler(State::IDLE, &handlers, &Handlers::OnIdle);
+  state_machine.Execute();
+  state_machine.Execute();  // no handler for the done state
+
+  auto const timings = state_machine.GetStateTimings();
+  ASSERT_EQ(2u, timings.size());
+  EXPECT_EQ(static_cast<uint64_t>(State::IDLE), timings[0].code);
+  EXPECT_EQ(1u, timings[0].executions);
+  EXPECT_EQ(static_cast<uint64_t>(State::DONE), timings[1].code);
+  EXPECT_EQ(1u, timings[1].entries);
+  EXPECT_EQ(0u, timings[1].executions);
+}
+
+}  // namespace
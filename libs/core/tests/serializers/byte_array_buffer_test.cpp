@@ -288,6 +288,127 @@ TEST_F(ByteArrayBufferTest, test_stream_absolute_resize_with_preexisting_offset)
   EXPECT_EQ(small_size, stream.tell());
 }
 
+TEST_F(ByteArrayBufferTest, test_append_reserves_exact_size)
+{
+  B const b0{"b0x", "b0y"};
+  B const b1{"b1x", "b1y"};
+
+  //* Expectations
+  SizeCounter<ByteArrayBuffer> counter;
+  counter << b0 << b1;
+
+  //* Production code under test
+  ByteArrayBuffer stream;
+  stream.Append(b0, b1);
+
+  //* Expectations
+  EXPECT_EQ(counter.size(), stream.size());
+  EXPECT_EQ(counter.size(), stream.data().capacity());
+}
+
+TEST_F(ByteArrayBufferTest, test_append_uses_existing_capacity)
+{
+  B const b0{"b0x", "b0y"};
+
+  SizeCounter<ByteArrayBuffer> counter;
+  counter << b0;
+
+  //* Setup
+  std::size_t const preallocated_ammount = 2 * counter.size();
+
+  ByteArrayBuffer stream;
+  stream.Reserve(preallocated_ammount, ResizeParadigm::ABSOLUTE);
+  auto const *const data = stream.data().pointer();
+
+  //* Production code under test
+  stream.Append(b0);
+
+  //* Expectations
+  EXPECT_EQ(counter.size(), stream.size());
+  EXPECT_EQ(preallocated_ammount, stream.data().capacity());
+  EXPECT_EQ(data, stream.data().pointer());
+}
+
+TEST_F(ByteArrayBufferTest, test_deserialization_from_const_byte_array_is_a_view)
+{
+  // too large to be stored inline
+  constexpr std::size_t            size = byte_array::ConstByteArray::INLINE_CAPACITY + 1;
+  byte_array::ConstByteArray const x{std::string(size, 'v')};
+
+  ByteArrayBuffer source;
+  source << x;
+  byte_array::ConstByteArray const payload{source.data()};
+
+  //* Production code under test
+  ByteArrayBuffer            stream{payload};
+  byte_array::ConstByteArray y;
+  stream >> y;
+
+  //* Expectations
+  byte_array::ConstByteArray const &view{y};
+  EXPECT_EQ(x, view);
+  EXPECT_EQ(payload.pointer(), stream.data().pointer());
+  EXPECT_EQ(payload.pointer() + sizeof(uint64_t), view.pointer());
+}
+
+TEST_F(ByteArrayBufferTest, test_deserialization_into_byte_array_is_a_copy)
+{
+  byte_array::ConstByteArray const x{"some value"};
+
+  ByteArrayBuffer source;
+  source << x;
+  byte_array::ConstByteArray const payload{source.data()};
+
+  //* Production code under test
+  ByteArrayBuffer       stream{payload};
+  byte_array::ByteArray y;
+  stream >> y;
+  y[0] = 'S';
+
+  //* Expectations
+  EXPECT_EQ(byte_array::ConstByteArray{"Some value"}, y);
+  EXPECT_EQ(x, payload.SubArray(sizeof(uint64_t)));
+}
+
+TEST_F(ByteArrayBufferTest, test_writing_to_a_view_does_not_modify_the_source)
+{
+  byte_array::ConstByteArray const source{"0123456789"};
+  byte_array::ConstByteArray const payload{source.SubArray(2, 4)};
+
+  //* Production code under test
+  ByteArrayBuffer stream{payload};
+  stream.seek(stream.size());
+  stream << uint8_t{'x'};
+
+  uint8_t const y{'y'};
+  stream.seek(0);
+  stream.WriteBytes(&y, 1);
+
+  //* Expectations
+  EXPECT_EQ(byte_array::ConstByteArray{"0123456789"}, source);
+  EXPECT_EQ(byte_array::ConstByteArray{"y345x"}, stream.data());
+}
+
+TEST_F(ByteArrayBufferTest, test_deserialization_of_small_const_byte_array_is_inline)
+{
+  byte_array::ConstByteArray const x{"some value"};
+
+  ByteArrayBuffer source;
+  source << x;
+  byte_array::ConstByteArray const payload{source.data()};
+
+  //* Production code under test
+  ByteArrayBuffer            stream{payload};
+  byte_array::ConstByteArray y;
+  stream >> y;
+
+  //* Expectations: the value does not refer to (and keep alive) the whole of the payload
+  EXPECT_EQ(x, y);
+  EXPECT_TRUE(y.IsInline());
+  byte_array::ConstByteArray const &value{y};
+  EXPECT_NE(payload.pointer() + sizeof(uint64_t), value.pointer());
+}
+
 }  // namespace
 
 }  // namespace serializers
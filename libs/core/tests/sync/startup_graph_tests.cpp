@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/startup_graph.hpp"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fetch {
+namespace core {
+namespace {
+
+using Order = std::vector<std::string>;
+
+class StartupGraphTests : public ::testing::Test
+{
+protected:
+  StartupGraph::Stage Record(std::string const &name, bool ready = true)
+  {
+    return [this, name, ready]() {
+      std::lock_guard<std::mutex> lock(lock_);
+      order_.push_back(name);
+      return ready;
+    };
+  }
+
+  std::size_t Position(std::string const &name)
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    for (std::size_t i = 0; i < order_.size(); ++i)
+    {
+      if (order_[i] == name)
+      {
+        return i;
+      }
+    }
+    return order_.size();
+  }
+
+  std::mutex lock_;
+  Order      order_;
+};
+
+TEST_F(StartupGraphTests, StagesStartAfterTheirDependencies)
+{
+  StartupGraph graph;
+  graph.Add("http", {"storage", "network"}, Record("http"));
+  graph.Add("storage", {"network"}, Record("storage"));
+  graph.Add("network", {}, Record("network"));
+  graph.Add("reactor", {}, Record("reactor"));
+
+  EXPECT_TRUE(graph.Run());
+  ASSERT_EQ(order_.size(), 4);
+  EXPECT_LT(Position("network"), Position("storage"));
+  EXPECT_LT(Position("storage"), Position("http"));
+}
+
+TEST_F(StartupGraphTests, IndependentStagesRunConcurrently)
+{
+  std::atomic<std::size_t> arrived{0};
+
+  // each stage only completes once the other has started, which deadlocks if run in sequence
+  auto rendezvous = [&arrived]() {
+    ++arrived;
+
+    auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+    while ((arrived < 2) && (std::chrono::steady_clock::now() < deadline))
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    return arrived >= 2;
+  };
+
+  StartupGraph graph;
+  graph.Add("lanes", {}, rendezvous);
+  graph.Add("muddle", {}, rendezvous);
+
+  EXPECT_TRUE(graph.Run());
+}
+
+TEST_F(StartupGraphTests, FailureSkipsTheDependents)
+{
+  StartupGraph graph;
+  graph.Add("lanes", {}, Record("lanes", false));
+  graph.Add("execution", {"lanes"}, Record("execution"));
+  graph.Add("http", {"execution"}, Record("http"));
+  graph.Add("reactor", {}, Record("reactor"));
+
+  EXPECT_FALSE(graph.Run());
+  EXPECT_EQ(order_.size(), 2);
+  EXPECT_EQ(Position("execution"), order_.size());
+  EXPECT_EQ(Position("http"), order_.size());
+}
+
+TEST_F(StartupGraphTests, ExceptionsFailTheStage)
+{
+  StartupGraph graph;
+  graph.Add("lanes", {}, []() -> bool { throw std::runtime_error("no port"); });
+  graph.Add("execution", {"lanes"}, Record("execution"));
+
+  EXPECT_FALSE(graph.Run());
+  EXPECT_TRUE(order_.empty());
+}
+
+TEST_F(StartupGraphTests, InvalidDependenciesThrow)
+{
+  StartupGraph unknown;
+  unknown.Add("http", {"storage"}, Record("http"));
+  EXPECT_THROW(unknown.Run(), std::runtime_error);
+
+  StartupGraph cycle;
+  cycle.Add("a", {"b"}, Record("a"));
+  cycle.Add("b", {"a"}, Record("b"));
+  EXPECT_THROW(cycle.Run(), std::runtime_error);
+  EXPECT_TRUE(order_.empty());
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace fetch
@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/byte_array.hpp"
+#include "core/byte_array/const_byte_array.hpp"
+#include "core/random/lcg.hpp"
+#include "crypto/fnv.hpp"
+#include "crypto/hash.hpp"
+#include "crypto/sha256.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+
+using fetch::crypto::FNV;
+using fetch::crypto::Hash;
+using fetch::byte_array::ConstByteArray;
+using fetch::byte_array::ByteArray;
+using fetch::random::LinearCongruentialGenerator;
+
+namespace {
+
+using RNG = LinearCongruentialGenerator;
+
+ConstByteArray GenerateRandomData(std::size_t length, RNG::random_type seed = 42)
+{
+  RNG rng{seed};
+
+  ByteArray buffer;
+  buffer.Resize(length);
+
+  for (std::size_t i = 0; i < length; ++i)
+  {
+    buffer[i] = static_cast<uint8_t>(rng());
+  }
+
+  return ConstByteArray{buffer};
+}
+
+// Hashing of a single message, the argument is the size of the message in bytes
+template <typename HASHER>
+void HashMessage(benchmark::State &state)
+{
+  auto const     size = static_cast<std::size_t>(state.range(0));
+  ConstByteArray msg  = GenerateRandomData(size);
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(Hash<HASHER>(msg));
+  }
+
+  state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+
+// Hashing of many (transaction sized) messages in one pass, the argument is the number of messages
+void Sha256HashMultiple(benchmark::State &state)
+{
+  static constexpr std::size_t MESSAGE_SIZE = 256;
+
+  auto const num_messages = static_cast<std::size_t>(state.range(0));
+
+  fetch::crypto::SHA256::Messages messages{};
+  for (std::size_t i = 0; i < num_messages; ++i)
+  {
+    messages.emplace_back(GenerateRandomData(MESSAGE_SIZE, i));
+  }
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(fetch::crypto::SHA256::HashMultiple(messages));
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(num_messages));
+}
+
+// The same messages as above, but hashed one at a time
+void Sha256HashSequential(benchmark::State &state)
+{
+  static constexpr std::size_t MESSAGE_SIZE = 256;
+
+  auto const num_messages = static_cast<std::size_t>(state.range(0));
+
+  fetch::crypto::SHA256::Messages messages{};
+  for (std::size_t i = 0; i < num_messages; ++i)
+  {
+    messages.emplace_back(GenerateRandomData(MESSAGE_SIZE, i));
+  }
+
+  for (auto _ : state)
+  {
+    for (auto const &msg : messages)
+    {
+      benchmark::DoNotOptimize(Hash<fetch::crypto::SHA256>(msg));
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(num_messages));
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(HashMessage, fetch::crypto::SHA256)->Arg(32)->Arg(256)->Arg(4096)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(HashMessage, fetch::crypto::SHA256)->Arg(256)->ThreadRange(1, 8);
+BENCHMARK_TEMPLATE(HashMessage, FNV)->Arg(32)->Arg(256)->Arg(4096)->Arg(1 << 20);
+BENCHMARK(Sha256HashMultiple)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK(Sha256HashSequential)->Arg(8)->Arg(64)->Arg(1024);
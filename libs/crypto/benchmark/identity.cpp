@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "core/serializers/byte_array.hpp"
+#include "core/serializers/byte_array_buffer.hpp"
+#include "crypto/ecdsa.hpp"
+#include "crypto/identity.hpp"
+
+#include <benchmark/benchmark.h>
+
+using fetch::crypto::ECDSASigner;
+using fetch::crypto::Identity;
+using fetch::serializers::ByteArrayBuffer;
+
+namespace {
+
+void SerializeIdentity(benchmark::State &state)
+{
+  ECDSASigner    signer;
+  Identity const identity = signer.identity();
+
+  for (auto _ : state)
+  {
+    ByteArrayBuffer buffer;
+    buffer << identity;
+
+    benchmark::DoNotOptimize(buffer.data());
+  }
+}
+
+void DeserializeIdentity(benchmark::State &state)
+{
+  ECDSASigner signer;
+
+  ByteArrayBuffer buffer;
+  buffer << signer.identity();
+
+  for (auto _ : state)
+  {
+    Identity identity;
+
+    buffer.seek(0);
+    buffer >> identity;
+
+    benchmark::DoNotOptimize(identity);
+  }
+}
+
+}  // namespace
+
+BENCHMARK(SerializeIdentity);
+BENCHMARK(DeserializeIdentity);
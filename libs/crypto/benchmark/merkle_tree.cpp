@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/byte_array.hpp"
+#include "core/byte_array/const_byte_array.hpp"
+#include "core/random/lcg.hpp"
+#include "crypto/merkle_tree.hpp"
+#include "vectorise/threading/pool.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+
+using fetch::crypto::MerkleTree;
+using fetch::byte_array::ConstByteArray;
+using fetch::byte_array::ByteArray;
+using fetch::random::LinearCongruentialGenerator;
+using fetch::threading::Pool;
+
+namespace {
+
+using RNG = LinearCongruentialGenerator;
+
+constexpr std::size_t DIGEST_SIZE = 32;
+
+ConstByteArray GenerateRandomData(std::size_t length, RNG::random_type seed = 42)
+{
+  RNG rng{seed};
+
+  ByteArray buffer;
+  buffer.Resize(length);
+
+  for (std::size_t i = 0; i < length; ++i)
+  {
+    buffer[i] = static_cast<uint8_t>(rng());
+  }
+
+  return ConstByteArray{buffer};
+}
+
+void PopulateTree(MerkleTree &tree)
+{
+  for (std::size_t i = 0; i < tree.size(); ++i)
+  {
+    tree[i] = GenerateRandomData(DIGEST_SIZE, i);
+  }
+}
+
+// Calculation of the root of a tree, the argument is the number of leaves
+void MerkleTreeRoot(benchmark::State &state)
+{
+  auto const num_leaves = static_cast<std::size_t>(state.range(0));
+
+  MerkleTree tree{num_leaves};
+  PopulateTree(tree);
+
+  auto const leaf = tree[0];
+
+  for (auto _ : state)
+  {
+    // mutable access to a leaf clears the cached levels, so the whole tree is rebuilt
+    tree[0] = leaf;
+    tree.CalculateRoot();
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(num_leaves));
+}
+
+// Calculation of the root of a tree using a thread pool, the arguments are the number of leaves
+// and the number of threads in the pool
+void MerkleTreeRootParallel(benchmark::State &state)
+{
+  auto const num_leaves  = static_cast<std::size_t>(state.range(0));
+  auto const num_threads = static_cast<std::size_t>(state.range(1));
+
+  MerkleTree tree{num_leaves};
+  PopulateTree(tree);
+
+  Pool pool{num_threads};
+
+  auto const leaf = tree[0];
+
+  for (auto _ : state)
+  {
+    tree[0] = leaf;
+    tree.CalculateRoot(pool);
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(num_leaves));
+}
+
+}  // namespace
+
+BENCHMARK(MerkleTreeRoot)->Arg(16)->Arg(1024)->Arg(65536);
+BENCHMARK(MerkleTreeRootParallel)
+    ->Args({65536, 1})
+    ->Args({65536, 2})
+    ->Args({65536, 4})
+    ->Args({65536, 8});
@@ -0,0 +1,137 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/byte_array.hpp"
+#include "core/byte_array/const_byte_array.hpp"
+#include "core/random/lcg.hpp"
+#include "crypto/ecdsa.hpp"
+#include "crypto/ecdsa_batch_verifier.hpp"
+#include "crypto/hash.hpp"
+#include "crypto/sha256.hpp"
+#include "crypto/verifier.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+using fetch::crypto::ECDSABatchVerifier;
+using fetch::crypto::ECDSASigner;
+using fetch::crypto::Hash;
+using fetch::crypto::Verifier;
+using fetch::byte_array::ConstByteArray;
+using fetch::byte_array::ByteArray;
+using fetch::random::LinearCongruentialGenerator;
+
+namespace {
+
+using RNG = LinearCongruentialGenerator;
+
+constexpr std::size_t MESSAGE_SIZE = 2048;
+
+ConstByteArray GenerateRandomData(std::size_t length, RNG::random_type seed = 42)
+{
+  RNG rng{seed};
+
+  ByteArray buffer;
+  buffer.Resize(length);
+
+  for (std::size_t i = 0; i < length; ++i)
+  {
+    buffer[i] = static_cast<uint8_t>(rng());
+  }
+
+  return ConstByteArray{buffer};
+}
+
+ConstByteArray SignMessage(ECDSASigner &signer, ConstByteArray const &msg)
+{
+  auto const signature = signer.Sign(msg);
+  if (signature.empty())
+  {
+    throw std::runtime_error("Unable to sign the message");
+  }
+
+  return signature;
+}
+
+// Verification through the static helper, the public key of the signer is looked up in the cache of
+// decoded keys
+void VerifyCachedKey(benchmark::State &state)
+{
+  ConstByteArray msg = GenerateRandomData(MESSAGE_SIZE);
+
+  ECDSASigner signer;
+  auto const  identity  = signer.identity();
+  auto const  signature = SignMessage(signer, msg);
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(Verifier::Verify(identity, msg, signature));
+  }
+}
+
+// Verification which decodes the public key of the signer each time
+void VerifyUncachedKey(benchmark::State &state)
+{
+  ConstByteArray msg = GenerateRandomData(MESSAGE_SIZE);
+
+  ECDSASigner signer;
+  auto const  identity  = signer.identity();
+  auto const  signature = SignMessage(signer, msg);
+
+  for (auto _ : state)
+  {
+    auto verifier = Verifier::Build(identity);
+    benchmark::DoNotOptimize(verifier->Verify(msg, signature));
+  }
+}
+
+// Verification of a batch of signatures (from a small set of signers), the argument is the size of
+// the batch
+void VerifyBatch(benchmark::State &state)
+{
+  static constexpr std::size_t NUM_SIGNERS = 4;
+
+  auto const batch_size = static_cast<std::size_t>(state.range(0));
+
+  std::vector<ECDSASigner> signers(NUM_SIGNERS);
+
+  ECDSABatchVerifier verifier;
+  for (std::size_t i = 0; i < batch_size; ++i)
+  {
+    auto &signer = signers[i % NUM_SIGNERS];
+
+    ConstByteArray const msg = GenerateRandomData(MESSAGE_SIZE, i);
+    verifier.Add(signer.public_key(), Hash<fetch::crypto::SHA256>(msg), SignMessage(signer, msg));
+  }
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(verifier.Verify());
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch_size));
+}
+
+}  // namespace
+
+BENCHMARK(VerifyCachedKey)->ThreadRange(1, 8);
+BENCHMARK(VerifyUncachedKey)->ThreadRange(1, 8);
+BENCHMARK(VerifyBatch)->Arg(1)->Arg(16)->Arg(256);
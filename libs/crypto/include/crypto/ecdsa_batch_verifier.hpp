@@ -0,0 +1,89 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "crypto/openssl_common.hpp"
+#include "crypto/openssl_context_session.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace fetch {
+namespace crypto {
+
+/**
+ * Verifies a batch of secp256k1 ECDSA signatures in one pass.
+ *
+ * All the modular inversions of the signature `s` values are folded into a single inversion
+ * (Montgomery's trick) and a single big number context session is shared between all the
+ * verifications in the batch. The result only signals whether every entry in the batch was
+ * valid, callers that need to identify the offending entries are expected to fall back to
+ * verifying the entries individually.
+ */
+class ECDSABatchVerifier
+{
+public:
+  using ConstByteArray = byte_array::ConstByteArray;
+
+  // Construction / Destruction
+  ECDSABatchVerifier();
+  ECDSABatchVerifier(ECDSABatchVerifier const &) = delete;
+  ECDSABatchVerifier(ECDSABatchVerifier &&)      = delete;
+  ~ECDSABatchVerifier()                          = default;
+
+  /// @name Batch Contents
+  /// @{
+  void        Add(ConstByteArray public_key, ConstByteArray hash, ConstByteArray signature);
+  void        Clear();
+  std::size_t size() const;
+  /// @}
+
+  bool Verify();
+
+  // Operators
+  ECDSABatchVerifier &operator=(ECDSABatchVerifier const &) = delete;
+  ECDSABatchVerifier &operator=(ECDSABatchVerifier &&) = delete;
+
+private:
+  using Group   = openssl::uniq_ptr_type<EC_GROUP>;
+  using Session = openssl::context::Session<BN_CTX>;
+
+  struct Entry
+  {
+    ConstByteArray public_key;  ///< The canonical public key of the signer
+    ConstByteArray hash;        ///< The hash that was signed
+    ConstByteArray signature;   ///< The canonical (r, s) signature
+  };
+
+  using Entries = std::vector<Entry>;
+
+  bool VerifyEntries();
+
+  Entries entries_;
+  Group   group_;
+  Session session_;
+};
+
+inline std::size_t ECDSABatchVerifier::size() const
+{
+  return entries_.size();
+}
+
+}  // namespace crypto
+}  // namespace fetch
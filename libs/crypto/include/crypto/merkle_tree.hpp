@@ -22,6 +22,12 @@
 #include <vector>
 
 namespace fetch {
+namespace threading {
+
+class Pool;
+
+}  // namespace threading
+
 namespace crypto {
 
 class MerkleTree
@@ -31,6 +37,7 @@ public:
   using Container     = std::vector<Digest>;
   using Iterator      = Container::iterator;
   using ConstIterator = Container::const_iterator;
+  using Pool          = threading::Pool;
 
   explicit MerkleTree(std::size_t count);
   MerkleTree(MerkleTree const &rhs) = delete;
@@ -54,12 +61,22 @@ public:
   std::size_t      size() const;
 
   void CalculateRoot() const;
+  void CalculateRoot(Pool &pool) const;
+  void UpdateLeaf(std::size_t n, Digest const &digest);
 
   Digest &operator[](std::size_t n);
 
 private:
+  using Levels = std::vector<Container>;
+
+  /// The minimum number of parent nodes hashed by each task in a parallel root calculation
+  static constexpr std::size_t PARALLEL_CHUNK_SIZE = 256;
+
+  void BuildLevels(Pool *pool) const;
+
   Container      leaf_nodes_;
   mutable Digest root_;
+  mutable Levels levels_;  ///< The cached levels of the tree, cleared on any leaf modification
 
   template <typename T>
   friend void Serialize(T &serializer, MerkleTree const &);
@@ -85,6 +102,8 @@ inline std::size_t MerkleTree::size() const
 
 inline MerkleTree::Iterator MerkleTree::begin()
 {
+  // mutable access to the leaves invalidates the cached tree
+  levels_.clear();
   return leaf_nodes_.begin();
 }
 
@@ -100,6 +119,7 @@ inline MerkleTree::ConstIterator MerkleTree::cbegin()
 
 inline MerkleTree::Iterator MerkleTree::end()
 {
+  levels_.clear();
   return leaf_nodes_.end();
 }
 
@@ -123,6 +143,7 @@ template <typename T>
 void Deserialize(T &serializer, MerkleTree &tree)
 {
   serializer >> tree.leaf_nodes_ >> tree.root_;
+  tree.levels_.clear();
 }
 
 }  // namespace crypto
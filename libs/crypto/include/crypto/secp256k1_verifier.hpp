@@ -0,0 +1,66 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "crypto/identity.hpp"
+#include "crypto/verifier.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace fetch {
+namespace crypto {
+
+/**
+ * ECDSA (secp256k1) verifier backed by libsecp256k1.
+ *
+ * Only available when the project is configured with FETCH_ENABLE_SECP256K1, in which case it is
+ * used in place of the OpenSSL based ECDSAVerifier. The public key and signature formats are the
+ * canonical (64 byte) formats used by the rest of the crypto library. All the verifiers share a
+ * single verification context which holds the precomputed tables of the library.
+ */
+class Secp256k1Verifier : public Verifier
+{
+public:
+  // Construction / Destruction
+  explicit Secp256k1Verifier(Identity identity);
+  Secp256k1Verifier(Secp256k1Verifier const &) = delete;
+  Secp256k1Verifier(Secp256k1Verifier &&)      = delete;
+  ~Secp256k1Verifier() override                = default;
+
+  Identity identity() override;
+  bool     Verify(ConstByteArray const &data, ConstByteArray const &signature) override;
+
+  static bool VerifyHash(ConstByteArray const &public_key, ConstByteArray const &hash,
+                         ConstByteArray const &signature);
+
+  // Operators
+  Secp256k1Verifier &operator=(Secp256k1Verifier const &) = delete;
+  Secp256k1Verifier &operator=(Secp256k1Verifier &&) = delete;
+
+private:
+  using ParsedKey = std::array<uint8_t, 64>;  // the opaque contents of a secp256k1_pubkey
+
+  Identity  identity_;
+  ParsedKey public_key_{};    ///< The parsed public key of the identity
+  bool      valid_{false};  ///< Signal that the public key could be parsed
+};
+
+}  // namespace crypto
+}  // namespace fetch
@@ -21,6 +21,8 @@
 #include "crypto/stream_hasher.hpp"
 #include <openssl/sha.h>
 
+#include <vector>
+
 namespace fetch {
 namespace crypto {
 
@@ -29,6 +31,8 @@ class SHA256 : public StreamHasher
 public:
   using StreamHasher::Update;
   using StreamHasher::Final;
+  using Messages = std::vector<byte_array::ConstByteArray>;
+  using Digests  = std::vector<byte_array::ByteArray>;
 
   // Construction / Destruction
   SHA256();
@@ -47,6 +51,11 @@ public:
   std::size_t GetSizeInBytes() const override;
   /// @}
 
+  /// @name Multi-buffer Hashing
+  /// @{
+  static Digests HashMultiple(Messages const &messages);
+  /// @}
+
 private:
   SHA256_CTX context_;
 };
@@ -56,5 +65,15 @@ inline std::size_t SHA256::GetSizeInBytes() const
   return size_in_bytes();
 }
 
+namespace details {
+
+#if defined(__SSE2__)
+// Explicit multi-buffer implementations, only to be called once the CPU has been checked
+void Sha256HashMultipleSse2(SHA256::Messages const &messages, SHA256::Digests &digests);
+void Sha256HashMultipleAvx2(SHA256::Messages const &messages, SHA256::Digests &digests);
+#endif
+
+}  // namespace details
+
 }  // namespace crypto
 }  // namespace fetch
@@ -0,0 +1,133 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fetch {
+namespace crypto {
+namespace details {
+
+/**
+ * Multi-buffer SHA-256 kernel: process a single 64 byte block for each of the lanes
+ *
+ * @param state The hash state for each of the lanes, stored word major i.e. word w of lane l is at
+ *              state[(w * LANES) + l]
+ * @param blocks The block to be processed for each lane
+ */
+using Sha256LaneKernel = void (*)(uint32_t *state, uint8_t const *const *blocks);
+
+// Note: this header is also included into the translation unit compiled with AVX2 enabled and
+// therefore must not pull in any other (inline) library code.
+
+#if defined(__SSE2__)
+bool HasSha256Avx2Kernel();
+void Sha256CompressSse2(uint32_t *state, uint8_t const *const *blocks);  ///< 4 lanes
+void Sha256CompressAvx2(uint32_t *state, uint8_t const *const *blocks);  ///< 8 lanes
+#endif
+
+/**
+ * The lane parallel SHA-256 compression function
+ *
+ * The vector operations are supplied by the policy V so that the same algorithm can be compiled
+ * for each instruction set. Note: the policy must have internal linkage in the translation unit it
+ * is instantiated from, since those translation units are compiled with different target flags.
+ *
+ * @tparam V The vector operations policy
+ */
+template <typename V>
+inline void Sha256CompressLanes(uint32_t *state, uint8_t const *const *blocks)
+{
+  using Vec = typename V::Vec;
+
+  static constexpr std::size_t LANES = V::LANES;
+
+  static constexpr uint32_t K[64] = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+      0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+      0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+      0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+      0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+      0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+      0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+      0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+      0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+      0xc67178f2};
+
+  Vec a = V::Load(state + (0 * LANES));
+  Vec b = V::Load(state + (1 * LANES));
+  Vec c = V::Load(state + (2 * LANES));
+  Vec d = V::Load(state + (3 * LANES));
+  Vec e = V::Load(state + (4 * LANES));
+  Vec f = V::Load(state + (5 * LANES));
+  Vec g = V::Load(state + (6 * LANES));
+  Vec h = V::Load(state + (7 * LANES));
+
+  Vec w[16];
+
+  for (std::size_t t = 0; t < 64; ++t)
+  {
+    Vec &wt = w[t & 15u];
+
+    if (t < 16)
+    {
+      wt = V::LoadWord(blocks, t);
+    }
+    else
+    {
+      Vec const w2  = w[(t - 2) & 15u];
+      Vec const w15 = w[(t - 15) & 15u];
+
+      Vec const s0 = V::Xor(V::Xor(V::Rotr(w15, 7), V::Rotr(w15, 18)), V::Shr(w15, 3));
+      Vec const s1 = V::Xor(V::Xor(V::Rotr(w2, 17), V::Rotr(w2, 19)), V::Shr(w2, 10));
+
+      wt = V::Add(V::Add(wt, s0), V::Add(w[(t - 7) & 15u], s1));
+    }
+
+    Vec const sigma1 = V::Xor(V::Xor(V::Rotr(e, 6), V::Rotr(e, 11)), V::Rotr(e, 25));
+    Vec const ch     = V::Xor(V::And(e, f), V::AndNot(e, g));
+    Vec const t1     = V::Add(V::Add(V::Add(h, sigma1), V::Add(ch, V::Set(K[t]))), wt);
+
+    Vec const sigma0 = V::Xor(V::Xor(V::Rotr(a, 2), V::Rotr(a, 13)), V::Rotr(a, 22));
+    Vec const maj    = V::Xor(V::Xor(V::And(a, b), V::And(a, c)), V::And(b, c));
+    Vec const t2     = V::Add(sigma0, maj);
+
+    h = g;
+    g = f;
+    f = e;
+    e = V::Add(d, t1);
+    d = c;
+    c = b;
+    b = a;
+    a = V::Add(t1, t2);
+  }
+
+  V::Store(state + (0 * LANES), V::Add(a, V::Load(state + (0 * LANES))));
+  V::Store(state + (1 * LANES), V::Add(b, V::Load(state + (1 * LANES))));
+  V::Store(state + (2 * LANES), V::Add(c, V::Load(state + (2 * LANES))));
+  V::Store(state + (3 * LANES), V::Add(d, V::Load(state + (3 * LANES))));
+  V::Store(state + (4 * LANES), V::Add(e, V::Load(state + (4 * LANES))));
+  V::Store(state + (5 * LANES), V::Add(f, V::Load(state + (5 * LANES))));
+  V::Store(state + (6 * LANES), V::Add(g, V::Load(state + (6 * LANES))));
+  V::Store(state + (7 * LANES), V::Add(h, V::Load(state + (7 * LANES))));
+}
+
+}  // namespace details
+}  // namespace crypto
+}  // namespace fetch
@@ -0,0 +1,87 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "core/mutex.hpp"
+#include "crypto/fnv.hpp"  // needed for std::hash<ConstByteArray>
+#include "crypto/identity.hpp"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace fetch {
+namespace crypto {
+
+class Verifier;
+
+/**
+ * A bounded cache of verifiers, keyed by the public key of the signer.
+ *
+ * Building a verifier decodes the public key of the identity, which involves converting the point
+ * and checking that it is on the curve. Many transactions are signed by a small set of high volume
+ * signers, so the decoded verifiers are kept and the least recently used one is evicted when the
+ * cache is full. The cached verifiers are shared between threads, the verification itself is
+ * performed outside of the lock of the cache.
+ */
+class VerifierCache
+{
+public:
+  using VerifierPtr = std::shared_ptr<Verifier>;
+
+  static constexpr std::size_t DEFAULT_CAPACITY = 4096;
+
+  // Construction / Destruction
+  explicit VerifierCache(std::size_t capacity = DEFAULT_CAPACITY);
+  VerifierCache(VerifierCache const &) = delete;
+  VerifierCache(VerifierCache &&)      = delete;
+  ~VerifierCache()                     = default;
+
+  VerifierPtr Lookup(Identity const &identity);
+  std::size_t size() const;
+
+  // Operators
+  VerifierCache &operator=(VerifierCache const &) = delete;
+  VerifierCache &operator=(VerifierCache &&) = delete;
+
+private:
+  using ConstByteArray = byte_array::ConstByteArray;
+  using Mutex          = mutex::Mutex;
+  using RecentList     = std::list<ConstByteArray>;
+
+  struct Element
+  {
+    VerifierPtr          verifier;
+    RecentList::iterator recent;
+  };
+
+  using UnderlyingCache = std::unordered_map<ConstByteArray, Element>;
+
+  VerifierPtr FindInCache(ConstByteArray const &public_key);
+  void        AddToCache(ConstByteArray const &public_key, VerifierPtr const &verifier);
+
+  std::size_t const capacity_;
+  mutable Mutex     lock_{__LINE__, __FILE__};
+  UnderlyingCache   cache_;   ///< The cached verifiers
+  RecentList        recent_;  ///< The public keys of the cached verifiers, most recently used first
+};
+
+}  // namespace crypto
+}  // namespace fetch
@@ -0,0 +1,294 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "crypto/ecdsa_batch_verifier.hpp"
+#include "crypto/secp256k1_verifier.hpp"
+
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/obj_mac.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace fetch {
+namespace crypto {
+namespace {
+
+using BigNum    = openssl::uniq_ptr_type<BIGNUM>;
+using BigNums   = std::vector<BigNum>;
+using Point     = openssl::uniq_ptr_type<EC_POINT>;
+using Curve     = openssl::ECDSACurve<NID_secp256k1>;
+using Canonical = openssl::ECDSAAffineCoordinatesConversion<NID_secp256k1>;
+
+/**
+ * Convert a message hash into the integer used by ECDSA, truncating it to the bit length of the
+ * group order as required by the standard
+ *
+ * @param hash The input hash
+ * @param order_bits The number of bits in the group order
+ * @param output The output big number
+ * @return true if successful, otherwise false
+ */
+bool HashToBigNum(byte_array::ConstByteArray const &hash, int order_bits, BIGNUM *output)
+{
+  auto const max_bytes = static_cast<std::size_t>((order_bits + 7) / 8);
+  auto const num_bytes = std::min(hash.size(), max_bytes);
+
+  if (!BN_bin2bn(hash.pointer(), static_cast<int>(num_bytes), output))
+  {
+    return false;
+  }
+
+  // remove any excess bits when the order is not a whole number of bytes
+  int const excess_bits = static_cast<int>(num_bytes * 8) - order_bits;
+  if (excess_bits > 0)
+  {
+    return BN_rshift(output, output, excess_bits) == 1;
+  }
+
+  return true;
+}
+
+}  // namespace
+
+ECDSABatchVerifier::ECDSABatchVerifier()
+  : group_{EC_GROUP_new_by_curve_name(NID_secp256k1)}
+{
+  if (!group_)
+  {
+    throw std::runtime_error("ECDSABatchVerifier: Unable to create secp256k1 group");
+  }
+}
+
+/**
+ * Add a signature to the current batch
+ *
+ * @param public_key The canonical encoded public key of the signer
+ * @param hash The hash which was signed
+ * @param signature The canonical encoded signature
+ */
+void ECDSABatchVerifier::Add(ConstByteArray public_key, ConstByteArray hash,
+                             ConstByteArray signature)
+{
+  entries_.emplace_back(Entry{std::move(public_key), std::move(hash), std::move(signature)});
+}
+
+/**
+ * Remove all the entries from the current batch
+ */
+void ECDSABatchVerifier::Clear()
+{
+  entries_.clear();
+}
+
+/**
+ * Verify all the signatures in the current batch
+ *
+ * @return true if every signature in the batch is valid, otherwise false
+ */
+bool ECDSABatchVerifier::Verify()
+{
+  if (entries_.empty())
+  {
+    return false;
+  }
+
+#ifdef FETCH_ENABLE_SECP256K1
+  // the library has no batch verification of ECDSA signatures, but verifying each of the entries
+  // with its precomputed context is still quicker than the batched OpenSSL path
+  if (std::all_of(entries_.begin(), entries_.end(),
+                  [](Entry const &entry) { return entry.hash.size() == 32; }))
+  {
+    return std::all_of(entries_.begin(), entries_.end(), [](Entry const &entry) {
+      return Secp256k1Verifier::VerifyHash(entry.public_key, entry.hash, entry.signature);
+    });
+  }
+#endif
+
+  bool success{false};
+
+  session_.start();
+  try
+  {
+    success = VerifyEntries();
+  }
+  catch (std::exception const &)
+  {
+    success = false;
+  }
+  session_.end();
+
+  return success;
+}
+
+bool ECDSABatchVerifier::VerifyEntries()
+{
+  std::size_t const num_entries = entries_.size();
+  BN_CTX *const     ctx         = session_.context().get();
+
+  BigNum order{BN_new()};
+  if (!EC_GROUP_get_order(group_.get(), order.get(), ctx))
+  {
+    return false;
+  }
+
+  int const order_bits = BN_num_bits(order.get());
+
+  // Step 1. Decode all the signatures and check that they are in range
+  BigNums r_values(num_entries);
+  BigNums s_values(num_entries);
+  for (std::size_t i = 0; i < num_entries; ++i)
+  {
+    auto const &entry = entries_[i];
+
+    if (entry.signature.size() != Curve::signatureSize)
+    {
+      return false;
+    }
+
+    r_values[i].reset(BN_new());
+    s_values[i].reset(BN_new());
+    Canonical::ConvertFromCanonical(entry.signature, r_values[i].get(), s_values[i].get());
+
+    for (auto const *value : {r_values[i].get(), s_values[i].get()})
+    {
+      if (BN_is_zero(value) || BN_is_negative(value) || (BN_cmp(value, order.get()) >= 0))
+      {
+        return false;
+      }
+    }
+  }
+
+  // Step 2. Invert all the s values with a single modular inversion. The prefix products are
+  // computed first and then unwound in reverse order
+  BigNums prefix(num_entries);
+  for (std::size_t i = 0; i < num_entries; ++i)
+  {
+    prefix[i].reset(BN_new());
+
+    if (i == 0)
+    {
+      if (!BN_copy(prefix[i].get(), s_values[i].get()))
+      {
+        return false;
+      }
+    }
+    else if (!BN_mod_mul(prefix[i].get(), prefix[i - 1].get(), s_values[i].get(), order.get(),
+                         ctx))
+    {
+      return false;
+    }
+  }
+
+  BigNum inverse{BN_mod_inverse(nullptr, prefix.back().get(), order.get(), ctx)};
+  if (!inverse)
+  {
+    return false;
+  }
+
+  BigNums s_inverses(num_entries);
+  for (std::size_t i = num_entries; i > 0; --i)
+  {
+    std::size_t const index = i - 1;
+
+    s_inverses[index].reset(BN_new());
+
+    if (index == 0)
+    {
+      if (!BN_copy(s_inverses[index].get(), inverse.get()))
+      {
+        return false;
+      }
+    }
+    else
+    {
+      if (!BN_mod_mul(s_inverses[index].get(), inverse.get(), prefix[index - 1].get(),
+                      order.get(), ctx))
+      {
+        return false;
+      }
+
+      if (!BN_mod_mul(inverse.get(), inverse.get(), s_values[index].get(), order.get(), ctx))
+      {
+        return false;
+      }
+    }
+  }
+
+  // Step 3. Check each of the signatures: R = (e * w) * G + (r * w) * Q, R.x == r (mod n)
+  BigNum e{BN_new()};
+  BigNum u1{BN_new()};
+  BigNum u2{BN_new()};
+  BigNum x{BN_new()};
+  BigNum y{BN_new()};
+  Point  public_key{EC_POINT_new(group_.get())};
+  Point  point{EC_POINT_new(group_.get())};
+
+  for (std::size_t i = 0; i < num_entries; ++i)
+  {
+    auto const &entry = entries_[i];
+
+    // decode the public key
+    if (entry.public_key.size() != Curve::publicKeySize)
+    {
+      return false;
+    }
+
+    Canonical::ConvertFromCanonical(entry.public_key, x.get(), y.get());
+
+    if (!EC_POINT_set_affine_coordinates_GFp(group_.get(), public_key.get(), x.get(), y.get(),
+                                             ctx) ||
+        (EC_POINT_is_on_curve(group_.get(), public_key.get(), ctx) != 1))
+    {
+      return false;
+    }
+
+    // compute the scalars
+    if (!HashToBigNum(entry.hash, order_bits, e.get()) ||
+        !BN_mod_mul(u1.get(), e.get(), s_inverses[i].get(), order.get(), ctx) ||
+        !BN_mod_mul(u2.get(), r_values[i].get(), s_inverses[i].get(), order.get(), ctx))
+    {
+      return false;
+    }
+
+    // compute the point and compare its x coordinate against r
+    if (!EC_POINT_mul(group_.get(), point.get(), u1.get(), public_key.get(), u2.get(), ctx) ||
+        EC_POINT_is_at_infinity(group_.get(), point.get()))
+    {
+      return false;
+    }
+
+    if (!EC_POINT_get_affine_coordinates_GFp(group_.get(), point.get(), x.get(), nullptr, ctx) ||
+        !BN_nnmod(x.get(), x.get(), order.get(), ctx))
+    {
+      return false;
+    }
+
+    if (BN_cmp(x.get(), r_values[i].get()) != 0)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace crypto
+}  // namespace fetch
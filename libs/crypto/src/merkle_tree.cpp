@@ -20,6 +20,9 @@
 #include "crypto/hash.hpp"
 #include "crypto/sha256.hpp"
 #include "vectorise/platform.hpp"
+#include "vectorise/threading/pool.hpp"
+
+#include <algorithm>
 
 namespace fetch {
 namespace crypto {
@@ -27,6 +30,8 @@ namespace crypto {
 using HashArray = MerkleTree::Digest;
 using Container = MerkleTree::Container;
 
+constexpr std::size_t MerkleTree::PARALLEL_CHUNK_SIZE;
+
 MerkleTree::MerkleTree(std::size_t count)
   : leaf_nodes_{count}
   , root_{}
@@ -34,25 +39,101 @@ MerkleTree::MerkleTree(std::size_t count)
 
 HashArray &MerkleTree::operator[](std::size_t n)
 {
+  // mutable access to the leaves invalidates the cached tree
+  levels_.clear();
   return leaf_nodes_.at(n);
 }
 
+/**
+ * Calculate the root of the tree on the calling thread
+ */
 void MerkleTree::CalculateRoot() const
 {
-  if (leaf_nodes_.empty())
+  BuildLevels(nullptr);
+}
+
+/**
+ * Calculate the root of the tree, hashing large levels of the tree in parallel
+ *
+ * @param pool The thread pool used to hash each of the levels
+ */
+void MerkleTree::CalculateRoot(Pool &pool) const
+{
+  BuildLevels(&pool);
+}
+
+/**
+ * Update a single leaf of the tree
+ *
+ * If the root has previously been calculated (and the leaves have not been modified since) only
+ * the path from the leaf to the root is recomputed. Otherwise the root will be computed by the
+ * next call to CalculateRoot.
+ *
+ * @param n The index of the leaf
+ * @param digest The new value of the leaf
+ */
+void MerkleTree::UpdateLeaf(std::size_t n, Digest const &digest)
+{
+  leaf_nodes_.at(n) = digest;
+
+  if (levels_.empty())
   {
-    root_ = Hash<crypto::SHA256>(Digest{});
     return;
   }
-  else if (leaf_nodes_.size() == 1)
+
+  levels_[0][n] = digest;
+
+  std::size_t index = n;
+  for (std::size_t level = 1; level < levels_.size(); ++level)
   {
-    // special case if there is only one node in the tree it is its own merkle root
-    root_ = leaf_nodes_[0];
+    index /= 2;
+
+    auto const &children  = levels_[level - 1];
+    levels_[level][index] = Hash<crypto::SHA256>(children[2 * index] + children[(2 * index) + 1]);
+  }
+
+  root_ = levels_.back()[0];
+}
+
+namespace {
+
+/**
+ * Compute the parent nodes in the range [begin, end) from the child level
+ *
+ * @param children The child level of the tree
+ * @param parents The parent level of the tree
+ * @param begin The index of the first parent to compute
+ * @param end The index after the last parent to compute
+ */
+void HashLevel(Container const &children, Container &parents, std::size_t begin, std::size_t end)
+{
+  SHA256::Messages concatenated_hashes;
+  concatenated_hashes.reserve(end - begin);
+
+  for (std::size_t i = begin; i < end; ++i)
+  {
+    concatenated_hashes.emplace_back(children[2 * i] + children[(2 * i) + 1]);
+  }
+
+  auto const digests = SHA256::HashMultiple(concatenated_hashes);
+
+  std::copy(digests.begin(), digests.end(), parents.begin() + static_cast<std::ptrdiff_t>(begin));
+}
+
+}  // namespace
+
+void MerkleTree::BuildLevels(Pool *pool) const
+{
+  levels_.clear();
+
+  if (leaf_nodes_.empty())
+  {
+    root_ = Hash<crypto::SHA256>(Digest{});
     return;
   }
 
   // make a copy of the leaf nodes which are then condensed
-  std::vector<Digest> hashes = leaf_nodes_;
+  Container hashes = leaf_nodes_;
 
   // If necessary bump the 'leaves' up to a power of 2
   while (!platform::IsLog2(uint64_t(hashes.size())))
@@ -60,21 +141,31 @@ void MerkleTree::CalculateRoot() const
     hashes.push_back(Digest{});
   }
 
-  // Now, repeatedly condense the vector by calculating the parents of each of the roots
-  while (hashes.size() > 1)
+  levels_.emplace_back(std::move(hashes));
+
+  // Now, repeatedly condense the levels by calculating the parents of each of the nodes. In the
+  // special case where there is only one node in the tree it is its own merkle root.
+  while (levels_.back().size() > 1)
   {
-    for (std::size_t i = 0, j = 0; i < hashes.size(); i += 2, ++j)
+    Container const &children = levels_.back();
+    Container        parents(children.size() / 2);
+
+    if (pool && (parents.size() >= (2 * PARALLEL_CHUNK_SIZE)))
+    {
+      pool->ParallelFor(0, parents.size(), PARALLEL_CHUNK_SIZE,
+                        [&children, &parents](std::size_t begin, std::size_t end) {
+                          HashLevel(children, parents, begin, end);
+                        });
+    }
+    else
     {
-      Digest concantenated_hash = hashes[i] + hashes[i + 1];
-      concantenated_hash        = Hash<crypto::SHA256>(concantenated_hash);
-      hashes[j]                 = concantenated_hash;
+      HashLevel(children, parents, 0, parents.size());
     }
 
-    hashes.resize(hashes.size() / 2);
+    levels_.emplace_back(std::move(parents));
   }
 
-  assert(hashes.size() == 1);
-  root_ = hashes[0];
+  root_ = levels_.back()[0];
 }
 
 }  // namespace crypto
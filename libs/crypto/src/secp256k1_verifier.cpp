@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#ifdef FETCH_ENABLE_SECP256K1
+
+#include "crypto/hash.hpp"
+#include "crypto/secp256k1_verifier.hpp"
+#include "crypto/sha256.hpp"
+
+#include <secp256k1.h>
+
+#include <cstring>
+#include <utility>
+
+namespace fetch {
+namespace crypto {
+namespace {
+
+using byte_array::ConstByteArray;
+
+constexpr std::size_t PUBLIC_KEY_SIZE = 64;
+constexpr std::size_t SIGNATURE_SIZE  = 64;
+constexpr std::size_t HASH_SIZE       = 32;
+
+static_assert(sizeof(secp256k1_pubkey) == PUBLIC_KEY_SIZE,
+              "Unexpected size of the libsecp256k1 public key");
+
+/**
+ * Get the verification context shared by all the verifiers. The context is only ever used for
+ * verification after it has been created, which is safe to do from multiple threads.
+ *
+ * @return The verification context
+ */
+secp256k1_context const *Context()
+{
+  static secp256k1_context *const context = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+  return context;
+}
+
+/**
+ * Parse a canonical public key (the x and y coordinates) into the format used by the library
+ *
+ * @param canonical The canonical public key
+ * @param key The output parsed key
+ * @return true if successful, otherwise false
+ */
+bool ParsePublicKey(ConstByteArray const &canonical, secp256k1_pubkey &key)
+{
+  if (canonical.size() != PUBLIC_KEY_SIZE)
+  {
+    return false;
+  }
+
+  // the uncompressed SEC encoding is the canonical key prefixed with 0x04
+  uint8_t serialized[PUBLIC_KEY_SIZE + 1];
+  serialized[0] = 0x04;
+  std::memcpy(serialized + 1, canonical.pointer(), PUBLIC_KEY_SIZE);
+
+  return secp256k1_ec_pubkey_parse(Context(), &key, serialized, sizeof(serialized)) == 1;
+}
+
+/**
+ * Verify a canonical signature against a hash
+ *
+ * @param key The parsed public key
+ * @param hash The hash which was signed
+ * @param signature The canonical (r, s) signature
+ * @return true if the signature is valid, otherwise false
+ */
+bool VerifyParsed(secp256k1_pubkey const &key, ConstByteArray const &hash,
+                  ConstByteArray const &signature)
+{
+  if ((hash.size() != HASH_SIZE) || (signature.size() != SIGNATURE_SIZE))
+  {
+    return false;
+  }
+
+  secp256k1_ecdsa_signature sig;
+  if (secp256k1_ecdsa_signature_parse_compact(Context(), &sig, signature.pointer()) != 1)
+  {
+    return false;
+  }
+
+  // OpenSSL accepts both of the equivalent s values while the library only accepts the lower one,
+  // normalise the signature so that both backends accept the same signatures
+  secp256k1_ecdsa_signature_normalize(Context(), &sig, &sig);
+
+  return secp256k1_ecdsa_verify(Context(), &sig, hash.pointer(), &key) == 1;
+}
+
+}  // namespace
+
+/**
+ * Construct the verifier from the identity of the signer
+ *
+ * @param identity The identity of the signer
+ */
+Secp256k1Verifier::Secp256k1Verifier(Identity identity)
+  : identity_{std::move(identity)}
+{
+  secp256k1_pubkey key;
+  if (identity_ && ParsePublicKey(identity_.identifier(), key))
+  {
+    std::memcpy(public_key_.data(), key.data, public_key_.size());
+    valid_ = true;
+  }
+}
+
+Identity Secp256k1Verifier::identity()
+{
+  return identity_;
+}
+
+/**
+ * Verify the signature of the specified data
+ *
+ * @param data The data which was signed
+ * @param signature The canonical signature
+ * @return true if the signature is valid, otherwise false
+ */
+bool Secp256k1Verifier::Verify(ConstByteArray const &data, ConstByteArray const &signature)
+{
+  if (!valid_)
+  {
+    return false;
+  }
+
+  secp256k1_pubkey key;
+  std::memcpy(key.data, public_key_.data(), public_key_.size());
+
+  return VerifyParsed(key, Hash<SHA256>(data), signature);
+}
+
+/**
+ * Verify the signature of a hash
+ *
+ * @param public_key The canonical public key of the signer
+ * @param hash The (32 byte) hash which was signed
+ * @param signature The canonical signature
+ * @return true if the signature is valid, otherwise false
+ */
+bool Secp256k1Verifier::VerifyHash(ConstByteArray const &public_key, ConstByteArray const &hash,
+                                   ConstByteArray const &signature)
+{
+  secp256k1_pubkey key;
+  if (!ParsePublicKey(public_key, key))
+  {
+    return false;
+  }
+
+  return VerifyParsed(key, hash, signature);
+}
+
+}  // namespace crypto
+}  // namespace fetch
+
+#endif  // FETCH_ENABLE_SECP256K1
@@ -17,8 +17,19 @@
 //------------------------------------------------------------------------------
 
 #include "crypto/sha256.hpp"
+#include "crypto/sha256_detail.hpp"
+#include "vectorise/info.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
 #include <stdexcept>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace fetch {
 namespace crypto {
 
@@ -31,8 +42,255 @@ void ResetContext(SHA256_CTX &context)
     throw std::runtime_error("could not intialialise SHA256.");
   }
 }
+
+using Messages = SHA256::Messages;
+using Digests  = SHA256::Digests;
+
+constexpr std::size_t BLOCK_SIZE = 64;
+constexpr std::size_t STATE_SIZE = 8;
+
+constexpr uint32_t INITIAL_STATE[STATE_SIZE] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                                0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+/**
+ * A single message being hashed in one of the lanes. The complete blocks of the message are read
+ * in place, only the final (padded) block(s) are copied.
+ */
+struct LaneInput
+{
+  uint8_t const *data{nullptr};
+  std::size_t    full_blocks{0};
+  std::size_t    num_blocks{0};
+  uint8_t        tail[2 * BLOCK_SIZE];
+
+  void Reset(byte_array::ConstByteArray const &message)
+  {
+    std::size_t const size      = message.size();
+    std::size_t const remainder = size % BLOCK_SIZE;
+
+    // the padding requires a single 0x80 byte and the 64 bit message length
+    std::size_t const tail_blocks = ((remainder + 9) > BLOCK_SIZE) ? 2 : 1;
+
+    data        = message.pointer();
+    full_blocks = size / BLOCK_SIZE;
+    num_blocks  = full_blocks + tail_blocks;
+
+    std::memset(tail, 0, sizeof(tail));
+    if (remainder)
+    {
+      std::memcpy(tail, data + (full_blocks * BLOCK_SIZE), remainder);
+    }
+    tail[remainder] = 0x80;
+
+    uint64_t const bit_length = static_cast<uint64_t>(size) * 8u;
+    uint8_t *const end        = tail + (tail_blocks * BLOCK_SIZE);
+    for (std::size_t i = 0; i < sizeof(uint64_t); ++i)
+    {
+      end[-1 - static_cast<std::ptrdiff_t>(i)] = static_cast<uint8_t>(bit_length >> (8u * i));
+    }
+  }
+
+  uint8_t const *Block(std::size_t index) const
+  {
+    if (index < full_blocks)
+    {
+      return data + (index * BLOCK_SIZE);
+    }
+
+    return tail + ((index - full_blocks) * BLOCK_SIZE);
+  }
+};
+
+template <std::size_t LANES>
+byte_array::ByteArray ExtractDigest(uint32_t const *state, std::size_t lane)
+{
+  byte_array::ByteArray digest;
+  digest.Resize(STATE_SIZE * sizeof(uint32_t));
+
+  for (std::size_t i = 0; i < STATE_SIZE; ++i)
+  {
+    uint32_t const word = state[(i * LANES) + lane];
+
+    digest[(i * 4u) + 0] = static_cast<uint8_t>(word >> 24u);
+    digest[(i * 4u) + 1] = static_cast<uint8_t>(word >> 16u);
+    digest[(i * 4u) + 2] = static_cast<uint8_t>(word >> 8u);
+    digest[(i * 4u) + 3] = static_cast<uint8_t>(word);
+  }
+
+  return digest;
+}
+
+/**
+ * Hash a set of messages, LANES messages at a time, using the specified kernel
+ *
+ * @tparam LANES The number of lanes supported by the kernel
+ * @param messages The messages to be hashed
+ * @param digests The output digests (must be the same size as the messages)
+ * @param kernel The compression kernel
+ */
+template <std::size_t LANES>
+void HashLanes(Messages const &messages, Digests &digests, details::Sha256LaneKernel kernel)
+{
+  assert(messages.size() == digests.size());
+
+  // group messages of a similar length together, so that the lanes finish at the same time
+  std::vector<std::size_t> order(messages.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&messages](std::size_t a, std::size_t b) {
+    return messages[a].size() < messages[b].size();
+  });
+
+  std::array<LaneInput, LANES>      lanes;
+  std::array<uint8_t const *, LANES> blocks;
+  uint32_t                           state[STATE_SIZE * LANES];
+
+  for (std::size_t offset = 0; offset < order.size(); offset += LANES)
+  {
+    std::size_t const count      = std::min(LANES, order.size() - offset);
+    std::size_t       max_blocks = 0;
+
+    for (std::size_t lane = 0; lane < LANES; ++lane)
+    {
+      // any unused lanes simply duplicate the first message of the group
+      lanes[lane].Reset(messages[order[offset + ((lane < count) ? lane : 0)]]);
+      max_blocks = std::max(max_blocks, lanes[lane].num_blocks);
+
+      for (std::size_t i = 0; i < STATE_SIZE; ++i)
+      {
+        state[(i * LANES) + lane] = INITIAL_STATE[i];
+      }
+    }
+
+    for (std::size_t block = 0; block < max_blocks; ++block)
+    {
+      // lanes which have completed repeat their last block, their digest has already been taken
+      for (std::size_t lane = 0; lane < LANES; ++lane)
+      {
+        blocks[lane] = lanes[lane].Block(std::min(block, lanes[lane].num_blocks - 1));
+      }
+
+      kernel(state, blocks.data());
+
+      for (std::size_t lane = 0; lane < count; ++lane)
+      {
+        if ((block + 1) == lanes[lane].num_blocks)
+        {
+          digests[order[offset + lane]] = ExtractDigest<LANES>(state, lane);
+        }
+      }
+    }
+  }
+}
+
+#if defined(__SSE2__)
+
+struct Sse2Ops
+{
+  using Vec = __m128i;
+
+  static constexpr std::size_t LANES = 4;
+
+  static Vec Load(uint32_t const *p)
+  {
+    return _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+  }
+
+  static void Store(uint32_t *p, Vec v)
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+  }
+
+  static Vec LoadWord(uint8_t const *const *blocks, std::size_t t)
+  {
+    return _mm_set_epi32(Word(blocks[3], t), Word(blocks[2], t), Word(blocks[1], t),
+                         Word(blocks[0], t));
+  }
+
+  static Vec Set(uint32_t value)
+  {
+    return _mm_set1_epi32(static_cast<int>(value));
+  }
+
+  static Vec Add(Vec a, Vec b)
+  {
+    return _mm_add_epi32(a, b);
+  }
+
+  static Vec Xor(Vec a, Vec b)
+  {
+    return _mm_xor_si128(a, b);
+  }
+
+  static Vec And(Vec a, Vec b)
+  {
+    return _mm_and_si128(a, b);
+  }
+
+  static Vec AndNot(Vec a, Vec b)
+  {
+    return _mm_andnot_si128(a, b);
+  }
+
+  static Vec Shr(Vec a, int n)
+  {
+    return _mm_srli_epi32(a, n);
+  }
+
+  static Vec Rotr(Vec a, int n)
+  {
+    return _mm_or_si128(_mm_srli_epi32(a, n), _mm_slli_epi32(a, 32 - n));
+  }
+
+private:
+  static int Word(uint8_t const *block, std::size_t t)
+  {
+    uint8_t const *p = block + (t * 4u);
+
+    return static_cast<int>((static_cast<uint32_t>(p[0]) << 24u) |
+                            (static_cast<uint32_t>(p[1]) << 16u) |
+                            (static_cast<uint32_t>(p[2]) << 8u) | static_cast<uint32_t>(p[3]));
+  }
+};
+
+#endif
+
+void HashSingle(Messages const &messages, Digests &digests)
+{
+  SHA256 hasher;
+
+  for (std::size_t i = 0; i < messages.size(); ++i)
+  {
+    hasher.Reset();
+    hasher.Update(messages[i]);
+    digests[i] = hasher.Final();
+  }
+}
+
 }  // namespace
 
+namespace details {
+
+#if defined(__SSE2__)
+
+void Sha256CompressSse2(uint32_t *state, uint8_t const *const *blocks)
+{
+  Sha256CompressLanes<Sse2Ops>(state, blocks);
+}
+
+void Sha256HashMultipleSse2(Messages const &messages, Digests &digests)
+{
+  HashLanes<Sse2Ops::LANES>(messages, digests, &Sha256CompressSse2);
+}
+
+void Sha256HashMultipleAvx2(Messages const &messages, Digests &digests)
+{
+  HashLanes<8>(messages, digests, &Sha256CompressAvx2);
+}
+
+#endif
+
+}  // namespace details
+
 SHA256::SHA256()
 {
   ResetContext(context_);
@@ -52,6 +310,44 @@ bool SHA256::Update(uint8_t const *data_to_hash, std::size_t const &size)
   return true;
 }
 
+/**
+ * Hash a number of independent messages
+ *
+ * Where the CPU supports it (and does not have the dedicated SHA extensions, which are already
+ * used by the single buffer implementation) the messages are hashed in parallel, one message per
+ * vector lane: 8 at a time with AVX2, otherwise 4 at a time with SSE2.
+ *
+ * @param messages The messages to be hashed
+ * @return The digest of each message, in the same order as the input messages
+ */
+SHA256::Digests SHA256::HashMultiple(Messages const &messages)
+{
+  Digests digests(messages.size());
+
+#if defined(__SSE2__)
+  auto const &cpu = vectorize::GetCpuFeatures();
+
+  if ((messages.size() > 1) && !cpu.sha)
+  {
+    if (cpu.avx2 && details::HasSha256Avx2Kernel())
+    {
+      details::Sha256HashMultipleAvx2(messages, digests);
+      return digests;
+    }
+
+    if (cpu.sse2)
+    {
+      details::Sha256HashMultipleSse2(messages, digests);
+      return digests;
+    }
+  }
+#endif
+
+  HashSingle(messages, digests);
+
+  return digests;
+}
+
 void SHA256::Final(uint8_t *hash, std::size_t const &size)
 {
   if (size < size_in_bytes())
@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "crypto/sha256_detail.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace fetch {
+namespace crypto {
+namespace details {
+
+#if defined(__AVX2__)
+
+// Note: this translation unit is compiled with AVX2 enabled (see CMakeLists.txt). It must only be
+// called once the CPU has been checked for support. To avoid AVX2 code leaking into the rest of
+// the library through inline functions, keep everything in here internally linked.
+
+namespace {
+
+struct Avx2Ops
+{
+  using Vec = __m256i;
+
+  static constexpr std::size_t LANES = 8;
+
+  static Vec Load(uint32_t const *p)
+  {
+    return _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p));
+  }
+
+  static void Store(uint32_t *p, Vec v)
+  {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+  }
+
+  static Vec LoadWord(uint8_t const *const *blocks, std::size_t t)
+  {
+    return _mm256_set_epi32(Word(blocks[7], t), Word(blocks[6], t), Word(blocks[5], t),
+                            Word(blocks[4], t), Word(blocks[3], t), Word(blocks[2], t),
+                            Word(blocks[1], t), Word(blocks[0], t));
+  }
+
+  static Vec Set(uint32_t value)
+  {
+    return _mm256_set1_epi32(static_cast<int>(value));
+  }
+
+  static Vec Add(Vec a, Vec b)
+  {
+    return _mm256_add_epi32(a, b);
+  }
+
+  static Vec Xor(Vec a, Vec b)
+  {
+    return _mm256_xor_si256(a, b);
+  }
+
+  static Vec And(Vec a, Vec b)
+  {
+    return _mm256_and_si256(a, b);
+  }
+
+  static Vec AndNot(Vec a, Vec b)
+  {
+    return _mm256_andnot_si256(a, b);
+  }
+
+  static Vec Shr(Vec a, int n)
+  {
+    return _mm256_srli_epi32(a, n);
+  }
+
+  static Vec Rotr(Vec a, int n)
+  {
+    return _mm256_or_si256(_mm256_srli_epi32(a, n), _mm256_slli_epi32(a, 32 - n));
+  }
+
+private:
+  static int Word(uint8_t const *block, std::size_t t)
+  {
+    uint8_t const *p = block + (t * 4u);
+
+    return static_cast<int>((static_cast<uint32_t>(p[0]) << 24u) |
+                            (static_cast<uint32_t>(p[1]) << 16u) |
+                            (static_cast<uint32_t>(p[2]) << 8u) | static_cast<uint32_t>(p[3]));
+  }
+};
+
+}  // namespace
+
+bool HasSha256Avx2Kernel()
+{
+  return true;
+}
+
+void Sha256CompressAvx2(uint32_t *state, uint8_t const *const *blocks)
+{
+  Sha256CompressLanes<Avx2Ops>(state, blocks);
+}
+
+#elif defined(__SSE2__)
+
+bool HasSha256Avx2Kernel()
+{
+  // this file has been built without AVX2 enabled
+  return false;
+}
+
+void Sha256CompressAvx2(uint32_t *, uint8_t const *const *)
+{}
+
+#endif
+
+}  // namespace details
+}  // namespace crypto
+}  // namespace fetch
@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "crypto/verifier_cache.hpp"
+#include "crypto/verifier.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace fetch {
+namespace crypto {
+
+constexpr std::size_t VerifierCache::DEFAULT_CAPACITY;
+
+/**
+ * Construct the verifier cache
+ *
+ * @param capacity The maximum number of verifiers to be cached
+ */
+VerifierCache::VerifierCache(std::size_t capacity)
+  : capacity_{std::max<std::size_t>(capacity, 1)}
+{}
+
+/**
+ * Lookup (or build) the verifier for the specified identity
+ *
+ * @param identity The identity of the signer
+ * @return The verifier for the identity
+ */
+VerifierCache::VerifierPtr VerifierCache::Lookup(Identity const &identity)
+{
+  ConstByteArray const &public_key = identity.identifier();
+
+  VerifierPtr verifier = FindInCache(public_key);
+
+  if (!verifier)
+  {
+    // decoding the public key is the expensive part, so it is done outside of the lock. It is
+    // expected that the build function will throw on errors
+    verifier = Verifier::Build(identity);
+
+    AddToCache(public_key, verifier);
+  }
+
+  return verifier;
+}
+
+/**
+ * Get the number of verifiers in the cache
+ *
+ * @return The number of verifiers
+ */
+std::size_t VerifierCache::size() const
+{
+  FETCH_LOCK(lock_);
+  return cache_.size();
+}
+
+VerifierCache::VerifierPtr VerifierCache::FindInCache(ConstByteArray const &public_key)
+{
+  VerifierPtr verifier;
+
+  FETCH_LOCK(lock_);
+
+  auto it = cache_.find(public_key);
+  if (it != cache_.end())
+  {
+    // extract the verifier and mark it as the most recently used
+    verifier = it->second.verifier;
+    recent_.splice(recent_.begin(), recent_, it->second.recent);
+  }
+
+  return verifier;
+}
+
+void VerifierCache::AddToCache(ConstByteArray const &public_key, VerifierPtr const &verifier)
+{
+  // the public key might reference a much larger buffer (for example a block of transactions),
+  // therefore an owned copy is stored
+  ConstByteArray key = public_key.Copy();
+
+  FETCH_LOCK(lock_);
+
+  // another thread might have added the same verifier in the meantime
+  if (cache_.find(key) != cache_.end())
+  {
+    return;
+  }
+
+  // evict the least recently used verifiers to make space
+  while (cache_.size() >= capacity_)
+  {
+    cache_.erase(recent_.back());
+    recent_.pop_back();
+  }
+
+  recent_.push_front(key);
+  cache_.emplace(std::move(key), Element{verifier, recent_.begin()});
+}
+
+}  // namespace crypto
+}  // namespace fetch
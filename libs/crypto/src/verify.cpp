@@ -17,7 +17,9 @@
 //------------------------------------------------------------------------------
 
 #include "crypto/ecdsa.hpp"
+#include "crypto/secp256k1_verifier.hpp"
 #include "crypto/verifier.hpp"
+#include "crypto/verifier_cache.hpp"
 
 namespace fetch {
 namespace crypto {
@@ -33,7 +35,11 @@ std::unique_ptr<Verifier> Verifier::Build(Identity const &identity)
   std::unique_ptr<Verifier> verifier;
 
   // only supported signature scheme currently
+#ifdef FETCH_ENABLE_SECP256K1
+  verifier = std::make_unique<Secp256k1Verifier>(identity);
+#else
   verifier = std::make_unique<ECDSAVerifier>(identity);
+#endif
 
   return verifier;
 }
@@ -49,8 +55,11 @@ std::unique_ptr<Verifier> Verifier::Build(Identity const &identity)
 bool Verifier::Verify(Identity const &identity, ConstByteArray const &data,
                       ConstByteArray const &signature)
 {
-  // build a compatible verifier
-  auto verifier = Build(identity);
+  // the verifiers of recently seen signers are shared between all the callers
+  static VerifierCache cache{};
+
+  // lookup (or build) a compatible verifier
+  auto verifier = cache.Lookup(identity);
 
   // determine if the signature is valid
   return verifier->Verify(data, signature);
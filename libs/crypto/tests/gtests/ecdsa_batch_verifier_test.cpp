@@ -0,0 +1,161 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "crypto/ecdsa.hpp"
+#include "crypto/ecdsa_batch_verifier.hpp"
+#include "crypto/hash.hpp"
+#include "crypto/sha256.hpp"
+
+#include "gmock/gmock.h"
+
+#include <array>
+#include <string>
+
+namespace fetch {
+namespace crypto {
+
+namespace {
+
+using ConstByteArray = fetch::byte_array::ConstByteArray;
+using ByteArray      = fetch::byte_array::ByteArray;
+
+class ECDSABatchVerifierTest : public testing::Test
+{
+protected:
+  static constexpr std::size_t NUM_SIGNERS  = 4;
+  static constexpr std::size_t NUM_MESSAGES = 16;
+
+  void SetUp() override
+  {
+    for (auto &signer : signers_)
+    {
+      signer.GenerateKeys();
+    }
+  }
+
+  void AddValidEntries()
+  {
+    for (std::size_t i = 0; i < NUM_MESSAGES; ++i)
+    {
+      auto &signer = signers_[i % NUM_SIGNERS];
+
+      ConstByteArray const message{"message " + std::to_string(i)};
+      ConstByteArray const signature = signer.Sign(message);
+
+      verifier_.Add(signer.public_key(), Hash<SHA256>(message), signature);
+    }
+  }
+
+  std::array<ECDSASigner, NUM_SIGNERS> signers_;
+  ECDSABatchVerifier                   verifier_;
+};
+
+TEST_F(ECDSABatchVerifierTest, EmptyBatchIsNotValid)
+{
+  EXPECT_EQ(0u, verifier_.size());
+  EXPECT_FALSE(verifier_.Verify());
+}
+
+TEST_F(ECDSABatchVerifierTest, ValidBatchVerifies)
+{
+  AddValidEntries();
+
+  EXPECT_EQ(static_cast<std::size_t>(NUM_MESSAGES), verifier_.size());
+  EXPECT_TRUE(verifier_.Verify());
+
+  // the batch should be reusable
+  EXPECT_TRUE(verifier_.Verify());
+}
+
+TEST_F(ECDSABatchVerifierTest, SingleEntryBatchVerifies)
+{
+  ConstByteArray const message{"single"};
+
+  verifier_.Add(signers_.front().public_key(), Hash<SHA256>(message),
+                signers_.front().Sign(message));
+
+  EXPECT_TRUE(verifier_.Verify());
+}
+
+TEST_F(ECDSABatchVerifierTest, WrongMessageFailsBatch)
+{
+  AddValidEntries();
+
+  ConstByteArray const message{"signed message"};
+  verifier_.Add(signers_.front().public_key(), Hash<SHA256>(ConstByteArray{"other message"}),
+                signers_.front().Sign(message));
+
+  EXPECT_FALSE(verifier_.Verify());
+}
+
+TEST_F(ECDSABatchVerifierTest, WrongSignerFailsBatch)
+{
+  AddValidEntries();
+
+  ConstByteArray const message{"signed message"};
+  verifier_.Add(signers_[1].public_key(), Hash<SHA256>(message), signers_[0].Sign(message));
+
+  EXPECT_FALSE(verifier_.Verify());
+}
+
+TEST_F(ECDSABatchVerifierTest, MalformedEntriesFailBatch)
+{
+  ConstByteArray const message{"signed message"};
+  ConstByteArray const hash = Hash<SHA256>(message);
+
+  // truncated signature
+  verifier_.Add(signers_[0].public_key(), hash, signers_[0].Sign(message).SubArray(0, 10));
+  EXPECT_FALSE(verifier_.Verify());
+
+  // zero signature
+  ByteArray zero_signature;
+  zero_signature.Resize(64);
+  for (std::size_t i = 0; i < zero_signature.size(); ++i)
+  {
+    zero_signature[i] = 0;
+  }
+
+  verifier_.Clear();
+  verifier_.Add(signers_[0].public_key(), hash, zero_signature);
+  EXPECT_FALSE(verifier_.Verify());
+
+  // public key which is not on the curve
+  ByteArray bad_key = signers_[0].public_key().Copy();
+  bad_key[63]       = static_cast<uint8_t>(bad_key[63] ^ 0x01);
+
+  verifier_.Clear();
+  verifier_.Add(bad_key, hash, signers_[0].Sign(message));
+  EXPECT_FALSE(verifier_.Verify());
+}
+
+TEST_F(ECDSABatchVerifierTest, ClearResetsBatch)
+{
+  AddValidEntries();
+
+  verifier_.Clear();
+  EXPECT_EQ(0u, verifier_.size());
+
+  AddValidEntries();
+  EXPECT_TRUE(verifier_.Verify());
+}
+
+}  // namespace
+
+}  // namespace crypto
+}  // namespace fetch
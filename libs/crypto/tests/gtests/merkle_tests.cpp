@@ -23,6 +23,7 @@
 #include "crypto/hash.hpp"
 #include "crypto/merkle_tree.hpp"
 #include "crypto/sha256.hpp"
+#include "vectorise/threading/pool.hpp"
 
 #include <gtest/gtest.h>
 #include <iostream>
@@ -199,3 +200,83 @@ TEST(crypto_merkle_tree, same_result_after_move)
   EXPECT_EQ(tree.root().size(), 256 / 8);
   EXPECT_EQ(tree.root(), root_before);
 }
+
+TEST(crypto_merkle_tree, parallel_root_matches_serial_root)
+{
+  threading::Pool pool{4};
+
+  for (std::size_t count : {1u, 2u, 3u, 511u, 1024u, 3000u})
+  {
+    MerkleTree serial{count};
+    MerkleTree parallel{count};
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      auto const leaf = Hash<crypto::SHA256>(std::to_string(i));
+
+      serial[i]   = leaf;
+      parallel[i] = leaf;
+    }
+
+    serial.CalculateRoot();
+    parallel.CalculateRoot(pool);
+
+    EXPECT_EQ(serial.root(), parallel.root()) << "count: " << count;
+  }
+}
+
+TEST(crypto_merkle_tree, incremental_update_matches_full_recalculation)
+{
+  for (std::size_t count : {1u, 5u, 16u, 100u})
+  {
+    MerkleTree incremental{count};
+    MerkleTree reference{count};
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      auto const leaf = Hash<crypto::SHA256>(std::to_string(i));
+
+      incremental[i] = leaf;
+      reference[i]   = leaf;
+    }
+
+    incremental.CalculateRoot();
+
+    for (std::size_t i = 0; i < count; i += 3)
+    {
+      auto const leaf = Hash<crypto::SHA256>("updated " + std::to_string(i));
+
+      incremental.UpdateLeaf(i, leaf);
+      reference[i] = leaf;
+      reference.CalculateRoot();
+
+      EXPECT_EQ(incremental.root(), reference.root()) << "count: " << count << " leaf: " << i;
+    }
+  }
+}
+
+TEST(crypto_merkle_tree, update_after_leaf_access_recalculates)
+{
+  MerkleTree tree{8};
+  for (std::size_t i = 0; i < tree.size(); ++i)
+  {
+    tree[i] = Hash<crypto::SHA256>(std::to_string(i));
+  }
+  tree.CalculateRoot();
+
+  // modifying a leaf directly invalidates the cached tree, the root is then left unchanged by the
+  // update until it is recalculated
+  tree[0] = Hash<crypto::SHA256>("direct");
+  auto const previous_root = tree.root();
+  tree.UpdateLeaf(1, Hash<crypto::SHA256>("update"));
+  EXPECT_EQ(tree.root(), previous_root);
+
+  MerkleTree reference{8};
+  for (std::size_t i = 0; i < reference.size(); ++i)
+  {
+    reference[i] = tree.leaf_nodes()[i];
+  }
+  reference.CalculateRoot();
+  tree.CalculateRoot();
+  EXPECT_EQ(tree.root(), reference.root());
+}
@@ -19,6 +19,8 @@
 #include "core/byte_array/encoders.hpp"
 #include "crypto/hash.hpp"
 #include "crypto/sha256.hpp"
+#include "crypto/sha256_detail.hpp"
+#include "vectorise/info.hpp"
 #include <iostream>
 
 using namespace fetch;
@@ -35,4 +37,75 @@ TEST(crypto_SHA_gtest, The_SHA256_implmentation_differs_from_other_libraries)
   EXPECT_EQ(hash(input), "64ec88ca00b268e5ba1a35678a1b5316d212f4f366b2477232534a8aeca37f3c");
   input = "some RandSom byte_array!! With !@#$%^&*() Symbols!";
   EXPECT_EQ(hash(input), "3d4e08bae43f19e146065b7de2027f9a611035ae138a4ac1978f03cf43b61029");
-}
\ No newline at end of file
+}
+namespace {
+
+SHA256::Messages GenerateMessages()
+{
+  SHA256::Messages messages;
+
+  // cover all the padding edge cases, in a mixed order of message lengths
+  for (std::size_t length = 0; length < 200; ++length)
+  {
+    byte_array_type message;
+    message.Resize((length * 37) % 200);
+    for (std::size_t i = 0; i < message.size(); ++i)
+    {
+      message[i] = static_cast<uint8_t>((i * 7) + length);
+    }
+
+    messages.push_back(message);
+  }
+
+  return messages;
+}
+
+void CheckDigests(SHA256::Messages const &messages, SHA256::Digests const &digests)
+{
+  ASSERT_EQ(messages.size(), digests.size());
+
+  for (std::size_t i = 0; i < messages.size(); ++i)
+  {
+    EXPECT_EQ(digests[i], Hash<crypto::SHA256>(messages[i])) << "message: " << i;
+  }
+}
+
+}  // namespace
+
+TEST(crypto_SHA_gtest, HashMultipleMatchesSingleBufferHashing)
+{
+  auto const messages = GenerateMessages();
+
+  CheckDigests(messages, SHA256::HashMultiple(messages));
+  CheckDigests({}, SHA256::HashMultiple({}));
+  CheckDigests({messages[3]}, SHA256::HashMultiple({messages[3]}));
+}
+
+#if defined(__SSE2__)
+
+TEST(crypto_SHA_gtest, HashMultipleSse2MatchesSingleBufferHashing)
+{
+  auto const messages = GenerateMessages();
+
+  SHA256::Digests digests(messages.size());
+  details::Sha256HashMultipleSse2(messages, digests);
+
+  CheckDigests(messages, digests);
+}
+
+TEST(crypto_SHA_gtest, HashMultipleAvx2MatchesSingleBufferHashing)
+{
+  if (!vectorize::GetCpuFeatures().avx2 || !details::HasSha256Avx2Kernel())
+  {
+    return;
+  }
+
+  auto const messages = GenerateMessages();
+
+  SHA256::Digests digests(messages.size());
+  details::Sha256HashMultipleAvx2(messages, digests);
+
+  CheckDigests(messages, digests);
+}
+
+#endif
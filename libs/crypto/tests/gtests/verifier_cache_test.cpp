@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "crypto/ecdsa.hpp"
+#include "crypto/verifier.hpp"
+#include "crypto/verifier_cache.hpp"
+
+#include "gtest/gtest.h"
+
+#include <array>
+
+namespace fetch {
+namespace crypto {
+namespace {
+
+using ConstByteArray = byte_array::ConstByteArray;
+
+TEST(VerifierCacheTest, CheckVerifiersAreReused)
+{
+  ECDSASigner signer{};
+  signer.GenerateKeys();
+
+  VerifierCache cache{};
+
+  auto const first  = cache.Lookup(signer.identity());
+  auto const second = cache.Lookup(signer.identity());
+
+  ASSERT_TRUE(static_cast<bool>(first));
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_EQ(1u, cache.size());
+
+  ConstByteArray const message{"hello world"};
+  EXPECT_TRUE(second->Verify(message, signer.Sign(message)));
+  EXPECT_FALSE(second->Verify(ConstByteArray{"other"}, signer.Sign(message)));
+}
+
+TEST(VerifierCacheTest, CheckLeastRecentlyUsedIsEvicted)
+{
+  std::array<ECDSASigner, 3> signers{};
+  for (auto &signer : signers)
+  {
+    signer.GenerateKeys();
+  }
+
+  VerifierCache cache{2};
+
+  auto const first = cache.Lookup(signers[0].identity());
+  cache.Lookup(signers[1].identity());
+
+  // use the first signer again, so that the second is the least recently used
+  EXPECT_EQ(first.get(), cache.Lookup(signers[0].identity()).get());
+
+  cache.Lookup(signers[2].identity());
+  EXPECT_EQ(2u, cache.size());
+
+  // the first signer is still cached
+  EXPECT_EQ(first.get(), cache.Lookup(signers[0].identity()).get());
+}
+
+}  // namespace
+}  // namespace crypto
+}  // namespace fetch
@@ -15,17 +15,16 @@
 //   See the License for the specific language governing permissions and
 //   limitations under the License.
 //
-//------------------------------------------------------------------------------
 
 #include "core/assert.hpp"
 #include "core/byte_array/byte_array.hpp"
 #include "core/logger.hpp"
-#include "core/mutex.hpp"
 #include "http/abstract_connection.hpp"
 #include "http/http_connection_manager.hpp"
 #include "http/request.hpp"
 #include "http/response.hpp"
 #include "network/fetch_asio.hpp"
+#include "network/management/network_manager.hpp"
 
 #include <deque>
 #include <memory>
@@ -33,22 +32,34 @@
 namespace fetch {
 namespace http {
 
+/**
+ * A persistent (HTTP/1.1 keep-alive) connection to a client. Requests are read one after another
+ * from the same buffer, so pipelined requests are served in order, and the connection is closed
+ * once the client asks for it, it has been idle for too long or the server is at capacity.
+ *
+ * All the handlers of the connection run on its strand.
+ */
 class HTTPConnection : public AbstractHTTPConnection,
                        public std::enable_shared_from_this<HTTPConnection>
 {
 public:
-  using response_queue_type = std::deque<HTTPResponse>;
-  using connection_type     = typename AbstractHTTPConnection::shared_type;
-  using handle_type         = HTTPConnectionManager::handle_type;
-  using shared_request_type = std::shared_ptr<HTTPRequest>;
-  using buffer_ptr_type     = std::shared_ptr<asio::streambuf>;
+  using response_queue_type  = std::deque<HTTPResponse>;
+  using connection_type      = typename AbstractHTTPConnection::shared_type;
+  using handle_type          = HTTPConnectionManager::handle_type;
+  using shared_request_type  = std::shared_ptr<HTTPRequest>;
+  using buffer_ptr_type      = std::shared_ptr<asio::streambuf>;
+  using network_manager_type = network::NetworkManager;
+  using strand_type          = asio::io_service::strand;
+  using timer_type           = asio::steady_timer;
 
   static constexpr char const *LOGGING_NAME = "HTTPConnection";
 
-  HTTPConnection(asio::ip::tcp::tcp::socket socket, HTTPConnectionManager &manager)
+  HTTPConnection(asio::ip::tcp::tcp::socket socket, HTTPConnectionManager &manager,
+                 network_manager_type network_manager)
     : socket_(std::move(socket))
     , manager_(manager)
-    , write_mutex_(__LINE__, __FILE__)
+    , strand_(network_manager.CreateIO<strand_type>())
+    , idle_timer_(network_manager.CreateIO<timer_type>())
   {
     LOG_STACK_TRACE_POINT;
 
@@ -69,7 +80,13 @@ public:
 
     is_open_ = true;
     handle_  = manager_.Join(shared_from_this());
-    if (is_open_)
+
+    if (manager_.connection_count() > manager_.max_connections())
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Connection limit reached, rejecting connection");
+      Reject(Status::SERVER_ERROR_SERVICE_UNAVAILABLE, "too many connections");
+    }
+    else if (is_open_)
     {
       ReadHeader();
     }
@@ -79,15 +96,8 @@ public:
   {
     LOG_STACK_TRACE_POINT;
 
-    write_mutex_.lock();
-    bool write_in_progress = !write_queue_.empty();
-    write_queue_.push_back(response);
-    write_mutex_.unlock();
-
-    if (!write_in_progress)
-    {
-      Write();
-    }
+    auto self = shared_from_this();
+    strand_->dispatch([this, self, response]() { QueueResponse(response); });
   }
 
   std::string Address() override
@@ -136,11 +146,20 @@ public:
               ReadBody(buffer_ptr, request);
             }
           }
+          else
+          {
+            // the stream can not be resynchronised after a malformed request
+            Reject(Status::CLIENT_ERROR_BAD_REQUEST, "malformed request");
+          }
         }
       }
     };
 
-    asio::async_read_until(socket_, *buffer_ptr, "\r\n\r\n", cb);
+    // the connection is idle until the next request arrives
+    ArmIdleTimer();
+
+    // any pipelined requests which have already been received are consumed from the buffer first
+    asio::async_read_until(socket_, *buffer_ptr, "\r\n\r\n", strand_->wrap(cb));
   }
 
   void ReadBody(buffer_ptr_type buffer_ptr, shared_request_type request)
@@ -158,10 +177,17 @@ public:
       auto const &remote_endpoint = socket_.remote_endpoint();
       request->SetOriginatingAddress(remote_endpoint.address().to_string(), remote_endpoint.port());
 
+      // once the client has asked for the connection to be closed no further requests are read
+      if (!request->keep_alive())
+      {
+        keep_alive_ = false;
+      }
+
       // push the request to the main server
+      ++pending_requests_;
       manager_.PushRequest(handle_, *request);
 
-      if (is_open_)
+      if (is_open_ && keep_alive_)
       {
         ReadHeader(buffer_ptr);
       }
@@ -188,8 +214,11 @@ public:
       }
     };
 
+    ArmIdleTimer();
+
     asio::async_read(socket_, *buffer_ptr,
-                     asio::transfer_exactly(request->content_length() - buffer_ptr->size()), cb);
+                     asio::transfer_exactly(request->content_length() - buffer_ptr->size()),
+                     strand_->wrap(cb));
   }
 
   void HandleError(std::error_code const &ec, shared_request_type /*req*/)
@@ -209,49 +238,176 @@ public:
 
     buffer_ptr_type buffer_ptr =
         std::make_shared<asio::streambuf>(std::numeric_limits<std::size_t>::max());
-    write_mutex_.lock();
-    HTTPResponse res = write_queue_.front();
+    auto res = std::make_shared<HTTPResponse>(std::move(write_queue_.front()));
     write_queue_.pop_front();
-    write_mutex_.unlock();
+    write_in_progress_ = true;
+
+    res->ToStream(*buffer_ptr);
 
-    res.ToStream(*buffer_ptr);
+    // the body of a streamed response is written after the header, one chunk at a time
+    WriteBuffer(buffer_ptr, res->is_streamed() ? res : nullptr);
+  }
+
+  void WriteBuffer(buffer_ptr_type buffer_ptr, std::shared_ptr<HTTPResponse> streamed)
+  {
     auto self = shared_from_this();
-    auto cb   = [this, self, buffer_ptr](std::error_code ec, std::size_t) {
-      if (!ec)
+    auto cb   = [this, self, buffer_ptr, streamed](std::error_code ec, std::size_t) {
+      if (ec || !is_open_)
       {
-        write_mutex_.lock();
-        bool write_more = !write_queue_.empty();
-        write_mutex_.unlock();
-        if (is_open_ && write_more)
-        {
-          Write();
-        }
+        write_in_progress_ = false;
+        Close();
+        return;
       }
-      else
+
+      if (streamed)
+      {
+        WriteChunk(streamed);
+        return;
+      }
+
+      write_in_progress_ = false;
+
+      if (!write_queue_.empty())
+      {
+        Write();
+      }
+      else if (close_after_write_)
       {
-        manager_.Leave(handle_);
+        // the final response has been delivered
+        Close();
       }
     };
 
-    asio::async_write(socket_, *buffer_ptr, cb);
+    asio::async_write(socket_, *buffer_ptr, strand_->wrap(cb));
+  }
+
+  void WriteChunk(std::shared_ptr<HTTPResponse> streamed)
+  {
+    buffer_ptr_type buffer_ptr =
+        std::make_shared<asio::streambuf>(std::numeric_limits<std::size_t>::max());
+
+    bool more = false;
+    try
+    {
+      more = streamed->NextChunkToStream(*buffer_ptr);
+    }
+    catch (std::exception const &ex)
+    {
+      // the response can not be completed, the client detects this from the connection closing
+      FETCH_LOG_WARN(LOGGING_NAME, "Failed to produce HTTP response chunk: ", ex.what());
+      write_in_progress_ = false;
+      Close();
+      return;
+    }
+
+    // a long running stream is activity on the connection
+    ArmIdleTimer();
+
+    WriteBuffer(buffer_ptr, more ? streamed : nullptr);
   }
 
   void Close()
   {
     LOG_STACK_TRACE_POINT;
 
+    if (!is_open_)
+    {
+      return;
+    }
+
     is_open_ = false;
+
+    // pending operations are aborted, releasing their references to the connection
+    std::error_code ignored;
+    idle_timer_->cancel(ignored);
+    socket_.shutdown(asio::ip::tcp::socket::shutdown_both, ignored);
+    socket_.close(ignored);
+
     manager_.Leave(handle_);
   }
 
 private:
-  asio::ip::tcp::tcp::socket socket_;
-  HTTPConnectionManager &    manager_;
-  response_queue_type        write_queue_;
-  fetch::mutex::Mutex        write_mutex_;
+  using Clock = timer_type::clock_type;
+
+  void QueueResponse(HTTPResponse response)
+  {
+    LOG_STACK_TRACE_POINT;
+
+    if (!is_open_)
+    {
+      return;
+    }
+
+    if (pending_requests_ > 0)
+    {
+      --pending_requests_;
+    }
+
+    // the response to the last request of a closing connection signals the close to the client
+    bool const last = !keep_alive_ && (pending_requests_ == 0);
+    if (!response.header().Has("connection"))
+    {
+      response.AddHeader("connection", last ? "close" : "keep-alive");
+    }
+
+    if (last)
+    {
+      close_after_write_ = true;
+    }
+
+    write_queue_.push_back(std::move(response));
+
+    if (!write_in_progress_)
+    {
+      Write();
+    }
+  }
+
+  void Reject(Status status, byte_array::ConstByteArray const &reason)
+  {
+    keep_alive_ = false;
+
+    HTTPResponse response(reason, mime_types::GetMimeTypeFromExtension(".html"), status);
+    Send(response);
+  }
+
+  void ArmIdleTimer()
+  {
+    auto const timeout = manager_.idle_timeout();
+    if (timeout.count() <= 0)
+    {
+      return;
+    }
+
+    // re-arming the timer aborts the previous wait
+    idle_timer_->expires_from_now(timeout);
+
+    auto self = shared_from_this();
+    idle_timer_->async_wait(strand_->wrap([this, self](std::error_code const &ec) {
+      // a wait which completed just before the timer was re-armed is ignored as well
+      if ((ec == asio::error::operation_aborted) || !is_open_ ||
+          (idle_timer_->expires_at() > Clock::now()))
+      {
+        return;
+      }
+
+      FETCH_LOG_DEBUG(LOGGING_NAME, "Closing idle HTTP connection");
+      Close();
+    }));
+  }
+
+  asio::ip::tcp::tcp::socket   socket_;
+  HTTPConnectionManager &      manager_;
+  std::shared_ptr<strand_type> strand_;
+  std::shared_ptr<timer_type>  idle_timer_;
+  response_queue_type          write_queue_;
 
   handle_type handle_;
-  bool        is_open_ = false;
+  bool        is_open_           = false;
+  bool        keep_alive_        = true;
+  bool        write_in_progress_ = false;
+  bool        close_after_write_ = false;
+  std::size_t pending_requests_  = 0;
 };
 }  // namespace http
 }  // namespace fetch
@@ -0,0 +1,44 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include <string>
+
+namespace fetch {
+namespace byte_array {
+
+class ConstByteArray;
+
+}  // namespace byte_array
+namespace http {
+
+/**
+ * The encodings which can be applied to a response body (RFC 7231 section 3.1.2.1)
+ */
+enum class ContentEncoding
+{
+  IDENTITY = 0,
+  GZIP     = 1,
+  DEFLATE  = 2  ///< zlib stream, as specified by RFC 7230
+};
+
+char const *    ToString(ContentEncoding encoding);
+ContentEncoding NegotiateEncoding(byte_array::ConstByteArray const &accept_encoding);
+
+}  // namespace http
+}  // namespace fetch
@@ -22,6 +22,10 @@
 #include "http/abstract_connection.hpp"
 #include "http/abstract_server.hpp"
 
+#include <chrono>
+#include <cstddef>
+#include <map>
+
 namespace fetch {
 namespace http {
 
@@ -30,14 +34,30 @@ class HTTPConnectionManager
 public:
   using connection_type = typename AbstractHTTPConnection::shared_type;
   using handle_type     = uint64_t;
+  using Duration        = std::chrono::milliseconds;
 
   static constexpr char const *LOGGING_NAME = "HTTPConnectionManager";
 
+  static constexpr std::size_t DEFAULT_MAX_CONNECTIONS = 1024;
+  static constexpr uint64_t    DEFAULT_IDLE_TIMEOUT_MS = 30000;
+
   HTTPConnectionManager(AbstractHTTPServer &server)
     : server_(server)
     , clients_mutex_(__LINE__, __FILE__)
+    , idle_timeout_(static_cast<Duration::rep>(DEFAULT_IDLE_TIMEOUT_MS))
   {}
 
+  ~HTTPConnectionManager()
+  {
+    // the remaining connections leave the manager as they are destroyed, which must happen while
+    // the mutex is still alive
+    std::map<handle_type, connection_type> clients;
+    {
+      std::lock_guard<fetch::mutex::Mutex> lock(clients_mutex_);
+      clients.swap(clients_);
+    }
+  }
+
   handle_type Join(connection_type client)
   {
     LOG_STACK_TRACE_POINT;
@@ -109,10 +129,42 @@ public:
     return "0.0.0.0";
   }
 
+  std::size_t connection_count()
+  {
+    std::lock_guard<fetch::mutex::Mutex> lock(clients_mutex_);
+    return clients_.size();
+  }
+
+  /// @name Connection Limits
+  /// These are expected to be configured before the server starts accepting connections
+  /// @{
+  std::size_t max_connections() const
+  {
+    return max_connections_;
+  }
+
+  void SetMaxConnections(std::size_t max_connections)
+  {
+    max_connections_ = max_connections;
+  }
+
+  Duration idle_timeout() const
+  {
+    return idle_timeout_;
+  }
+
+  void SetIdleTimeout(Duration const &timeout)
+  {
+    idle_timeout_ = timeout;
+  }
+  /// @}
+
 private:
   AbstractHTTPServer &                   server_;
   std::map<handle_type, connection_type> clients_;
   fetch::mutex::Mutex                    clients_mutex_;
+  std::size_t                            max_connections_{DEFAULT_MAX_CONNECTIONS};
+  Duration                               idle_timeout_;
 };
 }  // namespace http
 }  // namespace fetch
@@ -104,6 +104,13 @@ public:
     }
   }
 
+  void Remove(byte_array_type const &key)
+  {
+    LOG_STACK_TRACE_POINT;
+
+    this->erase(key);
+  }
+
   void Clear()
   {
     LOG_STACK_TRACE_POINT;
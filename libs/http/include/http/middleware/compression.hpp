@@ -0,0 +1,61 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "http/content_encoding.hpp"
+#include "http/server.hpp"
+
+#include <cstddef>
+#include <string>
+
+namespace fetch {
+namespace http {
+namespace middleware {
+
+/**
+ * Compress the responses with the encoding accepted by the client. Small bodies, which would
+ * barely shrink, and media types which are usually compressed already are left as they are.
+ *
+ * @param min_size The size below which buffered bodies are not compressed
+ * @param level The zlib compression level (1 - 9)
+ */
+inline typename HTTPServer::response_middleware_type Compression(
+    std::size_t min_size = 1024, int level = HTTPResponse::DEFAULT_COMPRESSION_LEVEL)
+{
+  return [min_size, level](HTTPResponse &res, HTTPRequest const &req) {
+    if (!res.is_streamed() && (res.body().size() < min_size))
+    {
+      return;
+    }
+
+    std::string const &type = res.mime_type().type;
+
+    bool const compressible =
+        (type.compare(0, 5, "text/") == 0) || (type.find("json") != std::string::npos) ||
+        (type.find("javascript") != std::string::npos) || (type.find("xml") != std::string::npos);
+
+    if (compressible)
+    {
+      res.Compress(NegotiateEncoding(req.header()["accept-encoding"]), level);
+    }
+  };
+}
+
+}  // namespace middleware
+}  // namespace http
+}  // namespace fetch
@@ -23,6 +23,7 @@
 #include "http/response.hpp"
 #include "http/view_parameters.hpp"
 
+#include <functional>
 #include <vector>
 namespace fetch {
 namespace http {
@@ -36,13 +37,17 @@ public:
   HTTPModule &operator=(HTTPModule const &rhs) = delete;
   HTTPModule &operator=(HTTPModule &&rhs) = delete;
 
-  using view_type = std::function<HTTPResponse(ViewParameters, HTTPRequest)>;
+  using view_type      = std::function<HTTPResponse(ViewParameters, HTTPRequest)>;
+  using responder_type = std::function<void(HTTPResponse)>;
+  using deferred_view_type =
+      std::function<void(ViewParameters const &, HTTPRequest const &, responder_type)>;
 
   struct UnmountedView
   {
     Method                method;
     byte_array::ByteArray route;
     view_type             view;
+    deferred_view_type    deferred{};  ///< Set instead of the view for deferred views
   };
 
   void Post(byte_array::ByteArray const &path, view_type const &view)
@@ -87,6 +92,23 @@ public:
     views_.push_back({method, path, view});
   }
 
+  /**
+   * Mount a view which completes its response later, by calling the responder it is given exactly
+   * once, from any thread. This allows a response to wait on an event (long polling) without
+   * holding on to a thread of the server. Deferred views must be thread safe.
+   *
+   * @param method The method of the view
+   * @param path The path of the view
+   * @param view The deferred view
+   */
+  void AddDeferredView(Method method, byte_array::ByteArray const &path,
+                       deferred_view_type const &view)
+  {
+    LOG_STACK_TRACE_POINT;
+
+    views_.push_back({method, path, view_type{}, view});
+  }
+
   std::vector<UnmountedView> const &views() const
   {
     LOG_STACK_TRACE_POINT;
@@ -71,6 +71,14 @@ public:
     return is_valid_;
   }
 
+  /**
+   * Determine if the client expects the connection to persist once this request has been served
+   */
+  bool keep_alive() const
+  {
+    return keep_alive_;
+  }
+
   QuerySet const &query() const
   {
     return query_;
@@ -153,7 +161,8 @@ private:
   byte_array_type uri_;
   byte_array_type protocol_;
 
-  bool is_valid_ = true;
+  bool is_valid_   = true;
+  bool keep_alive_ = true;
 
   std::size_t content_length_ = 0;
 };
@@ -17,10 +17,12 @@
 //
 //------------------------------------------------------------------------------
 
+#include "http/content_encoding.hpp"
 #include "http/header.hpp"
 #include "http/mime_types.hpp"
 #include "http/status.hpp"
 #include "network/fetch_asio.hpp"
+#include <functional>
 #include <ostream>
 #include <utility>
 
@@ -30,6 +32,14 @@ namespace http {
 class HTTPResponse : public std::enable_shared_from_this<HTTPResponse>
 {
 public:
+  /**
+   * Generates the body of a streamed response one chunk at a time, an empty chunk marks the end of
+   * the body. It is called from the network threads as the previous chunk is sent.
+   */
+  using BodyProducer = std::function<byte_array::ConstByteArray()>;
+
+  static constexpr int DEFAULT_COMPRESSION_LEVEL = 6;
+
   HTTPResponse() = default;
 
   explicit HTTPResponse(byte_array::ConstByteArray const &body,
@@ -45,6 +55,15 @@ public:
   bool ParseHeader(asio::streambuf &buffer, std::size_t length);
   bool ParseBody(asio::streambuf &buffer, std::size_t length);
   bool ToStream(asio::streambuf &buffer) const;
+  bool NextChunkToStream(asio::streambuf &buffer);
+
+  void SetBodyProducer(BodyProducer producer);
+  bool Compress(ContentEncoding encoding, int level = DEFAULT_COMPRESSION_LEVEL);
+
+  bool is_streamed() const
+  {
+    return static_cast<bool>(producer_);
+  }
 
   byte_array::ConstByteArray const &body() const
   {
@@ -78,6 +97,7 @@ private:
   bool ParseHeaderLine(std::size_t line_idx, char const *begin, char const *end);
 
   byte_array::ConstByteArray body_;
+  BodyProducer               producer_;
   MimeType                   mime_;
   Status                     status_;
   Header                     header_;
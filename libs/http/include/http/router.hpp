@@ -0,0 +1,130 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "http/method.hpp"
+#include "http/module.hpp"
+#include "http/view_parameters.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fetch {
+namespace http {
+
+/**
+ * Maps request paths to views with a radix trie, so that the cost of routing a request depends
+ * on the length of its path rather than on the number of views which have been mounted.
+ *
+ * Paths use the same syntax as Route, i.e. literal text interleaved with parameters of the form
+ * (name=pattern). Common patterns (\d+, \w+, .+ and hex digits of a fixed length) are matched
+ * directly, any other pattern falls back to a regular expression compiled when it is added.
+ *
+ * When several views match a path, the first one mounted for the request method is selected. If
+ * no view has been mounted for the method, the first matching view is used regardless. A trailing
+ * '/' on a mounted path is optional in requests.
+ */
+class Router
+{
+public:
+  using ConstByteArray = byte_array::ConstByteArray;
+  using View           = HTTPModule::view_type;
+  using DeferredView   = HTTPModule::deferred_view_type;
+
+  /**
+   * Counts the requests being served by a view, against an optional limit
+   */
+  class ConcurrencyLimit
+  {
+  public:
+    bool TryAcquire();
+    void Release();
+
+    std::size_t active() const
+    {
+      return active_;
+    }
+
+    std::size_t limit() const
+    {
+      return limit_;
+    }
+
+    void SetLimit(std::size_t limit)
+    {
+      limit_ = limit;
+    }
+
+  private:
+    std::atomic<std::size_t> active_{0};
+    std::atomic<std::size_t> limit_{0};  ///< Zero when there is no limit
+  };
+
+  using ConcurrencyLimitPtr = std::shared_ptr<ConcurrencyLimit>;
+
+  struct Handler
+  {
+    View                view;
+    ConcurrencyLimitPtr concurrency;
+    DeferredView        deferred{};  ///< Set instead of the view for deferred views
+  };
+
+  Router();
+  Router(Router const &) = delete;
+  Router(Router &&)      = delete;
+  ~Router();
+
+  void           Add(Method method, ConstByteArray const &path, View const &view,
+                     DeferredView const &deferred = DeferredView{});
+  Handler const *Match(Method method, ConstByteArray const &path, ViewParameters &params) const;
+  bool SetConcurrencyLimit(Method method, ConstByteArray const &path, std::size_t limit);
+
+  std::size_t size() const
+  {
+    return size_;
+  }
+
+  Router &operator=(Router const &) = delete;
+  Router &operator=(Router &&) = delete;
+
+private:
+  struct Node;
+  struct Parameter;
+  struct Endpoint;
+  struct Capture;
+  struct Candidate;
+
+  using Captures = std::vector<Capture>;
+
+  void Search(Node const &node, Method method, ConstByteArray const &path, std::size_t pos,
+              Captures &captures, Candidate &best) const;
+
+  using LimitKey = std::pair<Method, std::string>;
+
+  std::unique_ptr<Node>                   root_;
+  std::size_t                             size_{0};
+  std::map<LimitKey, ConcurrencyLimitPtr> limits_;
+};
+
+}  // namespace http
+}  // namespace fetch
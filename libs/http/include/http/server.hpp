@@ -20,13 +20,15 @@
 #include "http/connection.hpp"
 #include "http/http_connection_manager.hpp"
 #include "http/module.hpp"
-#include "http/route.hpp"
+#include "http/router.hpp"
+#include "network/details/thread_pool.hpp"
 #include "network/management/network_manager.hpp"
 
+#include <atomic>
 #include <deque>
 #include <functional>
 #include <map>
-#include <regex>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -45,17 +47,12 @@ public:
 
   using request_middleware_type  = std::function<void(HTTPRequest &)>;
   using view_type                = typename HTTPModule::view_type;
+  using deferred_view_type       = typename HTTPModule::deferred_view_type;
   using response_middleware_type = std::function<void(HTTPResponse &, HTTPRequest const &)>;
+  using thread_pool_type         = network::ThreadPool;
 
   static constexpr char const *LOGGING_NAME = "HTTPServer";
 
-  struct MountedView
-  {
-    Method    method;
-    Route     route;
-    view_type view;
-  };
-
   explicit HTTPServer(network_manager_type const &network_manager)
     : networkManager_(network_manager)
   {
@@ -66,6 +63,12 @@ public:
   {
     LOG_STACK_TRACE_POINT;
 
+    // wait for the views being executed, queued requests are dropped
+    if (handler_pool_)
+    {
+      handler_pool_->Stop();
+    }
+
     auto socketWeak = socket_;
     auto accepWeak  = acceptor_;
 
@@ -108,13 +111,70 @@ public:
       accepRef = accep;
 
       FETCH_LOG_DEBUG(LOGGING_NAME, "Starting HTTPServer Accept");
-      HTTPServer::Accept(soc, accep, manager);
+      HTTPServer::Accept(soc, accep, manager, threadMan);
     });
   }
 
   void Stop()
   {}
 
+  /**
+   * Limit the number of concurrent connections, further clients are sent a 503 response
+   *
+   * @param max_connections The maximum number of open connections
+   */
+  void SetMaxConnections(std::size_t max_connections)
+  {
+    manager_->SetMaxConnections(max_connections);
+  }
+
+  /**
+   * Set how long a persistent connection may wait for its next request before being closed
+   *
+   * @param timeout The idle timeout, zero to disable it
+   */
+  void SetIdleTimeout(manager_type::Duration const &timeout)
+  {
+    manager_->SetIdleTimeout(timeout);
+  }
+
+  /**
+   * Execute the views on a pool of worker threads, rather than on the network threads. Since the
+   * views are then executed concurrently, they must be thread safe. The middleware is still
+   * executed under a single lock, and the responses to pipelined requests are still sent in
+   * order. Must be called before the server is started.
+   *
+   * @param threads The number of worker threads
+   * @param max_pending The maximum number of queued and executing requests, further requests are
+   *                    sent a 503 response
+   */
+  void SetHandlerPool(std::size_t threads, std::size_t max_pending)
+  {
+    max_pending_  = max_pending;
+    handler_pool_ = network::MakeThreadPool(threads, "HTTP");
+    handler_pool_->Start();
+  }
+
+  /**
+   * Limit the number of requests being served concurrently by the views mounted on a path,
+   * further requests are sent a 503 response
+   *
+   * @param method The method of the views
+   * @param path The path, exactly as the views were mounted with
+   * @param limit The maximum number of concurrent requests, zero for no limit
+   * @return true if views have been mounted on the path, otherwise false
+   */
+  bool SetConcurrencyLimit(Method method, byte_array::ConstByteArray const &path,
+                           std::size_t limit)
+  {
+    return router_.SetConcurrencyLimit(method, path, limit);
+  }
+
+  std::size_t pending_requests() const
+  {
+    return pending_;
+  }
+
   void PushRequest(handle_type client, HTTPRequest req) override
   {
     LOG_STACK_TRACE_POINT;
@@ -134,48 +194,71 @@ public:
       return;
     }
 
-    // TODO(issue 28): improve such that it works for multiple threads.
-    eval_mutex_.lock();
-    for (auto &m : pre_view_middleware_)
     {
-      m(req);
+      std::lock_guard<std::mutex> lock(eval_mutex_);
+      for (auto &m : pre_view_middleware_)
+      {
+        m(req);
+      }
     }
 
-    HTTPResponse   res("page not found", mime_types::GetMimeTypeFromExtension(".html"),
-                     Status::CLIENT_ERROR_NOT_FOUND);
-    ViewParameters params;
+    // the position of the response amongst the responses to the client
+    uint64_t const sequence = handler_pool_ ? ReserveResponse(client) : 0;
+
+    auto params = std::make_shared<ViewParameters>();
 
-    for (auto &v : views_)
+    Router::Handler const *handler = router_.Match(req.method(), req.uri(), *params);
+    if (handler == nullptr)
     {
-      if (v.route.Match(req.uri(), params))
-      {
-        res = v.view(params, req);
-        break;
-      }
+      Respond(client, sequence,
+              HTTPResponse("page not found", mime_types::GetMimeTypeFromExtension(".html"),
+                           Status::CLIENT_ERROR_NOT_FOUND),
+              req);
+      return;
     }
 
-    for (auto &m : post_view_middleware_)
+    if (!handler->concurrency->TryAcquire())
     {
-      m(res, req);
+      Respond(client, sequence, CreateBusyResponse(), req);
+      return;
     }
 
-    eval_mutex_.unlock();
+    if (!handler_pool_)
+    {
+      // TODO(issue 28): improve such that it works for multiple threads.
+      ExecuteView(client, sequence, *handler, *params, req);
+      return;
+    }
 
-    manager_->Send(client, res);
+    if (pending_++ >= max_pending_)
+    {
+      --pending_;
+      handler->concurrency->Release();
+
+      FETCH_LOG_WARN(LOGGING_NAME, "Rejecting request, too many pending requests");
+      Respond(client, sequence, CreateBusyResponse(), req);
+      return;
+    }
+
+    auto request = std::make_shared<HTTPRequest>(std::move(req));
+    handler_pool_->Post([this, client, sequence, handler = *handler, params, request]() {
+      ExecuteView(client, sequence, handler, *params, *request);
+      --pending_;
+    });
   }
 
   // Accept static void to avoid having to create shared ptr to this class
   static void Accept(std::shared_ptr<socket_type> soc, std::shared_ptr<acceptor_type> accep,
-                     std::shared_ptr<manager_type> manager)
+                     std::shared_ptr<manager_type> manager, network_manager_type network_manager)
   {
     LOG_STACK_TRACE_POINT;
 
-    auto cb = [soc, accep, manager](std::error_code ec) {
+    auto cb = [soc, accep, manager, network_manager](std::error_code ec) {
       // LOG_LAMBDA_STACK_TRACE_POINT; // TODO(issue 28) : sort this
 
       if (!ec)
       {
-        std::make_shared<HTTPConnection>(std::move(*soc), *manager)->Start();
+        std::make_shared<HTTPConnection>(std::move(*soc), *manager, network_manager)->Start();
       }
       else
       {
@@ -187,7 +270,7 @@ public:
       std::shared_ptr<acceptor_type> a = accep;
       std::shared_ptr<manager_type>  m = manager;
 
-      HTTPServer::Accept(s, a, m);
+      HTTPServer::Accept(s, a, m, network_manager);
     };
 
     FETCH_LOG_DEBUG(LOGGING_NAME, "Starting HTTPServer async accept");
@@ -204,9 +287,10 @@ public:
     post_view_middleware_.push_back(middleware);
   }
 
-  void AddView(Method method, byte_array::ByteArray const &path, view_type const &view)
+  void AddView(Method method, byte_array::ByteArray const &path, view_type const &view,
+               deferred_view_type const &deferred = deferred_view_type{})
   {
-    views_.push_back({method, Route::FromString(path), view});
+    router_.Add(method, path, view, deferred);
   }
 
   void AddModule(HTTPModule const &module)
@@ -214,15 +298,155 @@ public:
     LOG_STACK_TRACE_POINT;
     for (auto const &view : module.views())
     {
-      this->AddView(view.method, view.route, view.view);
+      this->AddView(view.method, view.route, view.view, view.deferred);
     }
   }
 
 private:
+  static HTTPResponse CreateBusyResponse()
+  {
+    HTTPResponse res("server busy", mime_types::GetMimeTypeFromExtension(".html"),
+                     Status::SERVER_ERROR_SERVICE_UNAVAILABLE);
+    res.AddHeader("retry-after", "1");
+    return res;
+  }
+
+  /**
+   * Execute the view of a handler, whose concurrency has been acquired, and send the response
+   */
+  void ExecuteView(handle_type client, uint64_t sequence, Router::Handler const &handler,
+                   ViewParameters const &params, HTTPRequest const &req)
+  {
+    if (handler.deferred)
+    {
+      ExecuteDeferredView(client, sequence, handler, params, req);
+      return;
+    }
+
+    HTTPResponse res("internal server error", mime_types::GetMimeTypeFromExtension(".html"),
+                     Status::SERVER_ERROR_INTERNAL_SERVER_ERROR);
+
+    try
+    {
+      if (handler_pool_)
+      {
+        res = handler.view(params, req);
+      }
+      else
+      {
+        std::lock_guard<std::mutex> lock(eval_mutex_);
+        res = handler.view(params, req);
+      }
+    }
+    catch (std::exception const &ex)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "View for ", req.uri(), " failed: ", ex.what());
+    }
+
+    handler.concurrency->Release();
+
+    Respond(client, sequence, std::move(res), req);
+  }
+
+  /**
+   * Execute a deferred view, whose concurrency has been acquired. The concurrency is released and
+   * the response sent once the view calls its responder, which may be after this returns.
+   */
+  void ExecuteDeferredView(handle_type client, uint64_t sequence, Router::Handler const &handler,
+                           ViewParameters const &params, HTTPRequest const &req)
+  {
+    auto request     = std::make_shared<HTTPRequest>(req);
+    auto concurrency = handler.concurrency;
+    auto completed   = std::make_shared<std::atomic<bool>>(false);
+
+    auto responder = [this, client, sequence, request, concurrency, completed](HTTPResponse res) {
+      if (completed->exchange(true))
+      {
+        FETCH_LOG_WARN(LOGGING_NAME, "Deferred view for ", request->uri(), " responded twice");
+        return;
+      }
+
+      concurrency->Release();
+      Respond(client, sequence, std::move(res), *request);
+    };
+
+    // deferred views are thread safe, they are not executed under the evaluation lock since they
+    // may respond straight away
+    try
+    {
+      handler.deferred(params, *request, responder);
+    }
+    catch (std::exception const &ex)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Deferred view for ", req.uri(), " failed: ", ex.what());
+
+      responder(HTTPResponse("internal server error",
+                             mime_types::GetMimeTypeFromExtension(".html"),
+                             Status::SERVER_ERROR_INTERNAL_SERVER_ERROR));
+    }
+  }
+
+  void Respond(handle_type client, uint64_t sequence, HTTPResponse res, HTTPRequest const &req)
+  {
+    {
+      std::lock_guard<std::mutex> lock(eval_mutex_);
+      for (auto &m : post_view_middleware_)
+      {
+        m(res, req);
+      }
+    }
+
+    if (handler_pool_)
+    {
+      CompleteResponse(client, sequence, std::move(res));
+    }
+    else
+    {
+      manager_->Send(client, res);
+    }
+  }
+
+  /**
+   * The responses to a client which have been completed out of order
+   */
+  struct ResponseQueue
+  {
+    uint64_t                         next_reserved{0};
+    uint64_t                         next_sent{0};
+    std::map<uint64_t, HTTPResponse> completed;
+  };
+
+  uint64_t ReserveResponse(handle_type client)
+  {
+    std::lock_guard<std::mutex> lock(responses_mutex_);
+    return responses_[client].next_reserved++;
+  }
+
+  void CompleteResponse(handle_type client, uint64_t sequence, HTTPResponse res)
+  {
+    std::lock_guard<std::mutex> lock(responses_mutex_);
+
+    auto &queue = responses_[client];
+    queue.completed.emplace(sequence, std::move(res));
+
+    // send the responses which are next in line, the lock keeps them in order
+    auto it = queue.completed.begin();
+    for (; (it != queue.completed.end()) && (it->first == queue.next_sent); ++queue.next_sent)
+    {
+      manager_->Send(client, it->second);
+      it = queue.completed.erase(it);
+    }
+
+    if (queue.next_sent == queue.next_reserved)
+    {
+      responses_.erase(client);
+    }
+  }
+
   std::mutex eval_mutex_;
 
   std::vector<request_middleware_type>  pre_view_middleware_;
-  std::vector<MountedView>              views_;
+  Router                                router_;
   std::vector<response_middleware_type> post_view_middleware_;
 
   network_manager_type          networkManager_;
@@ -230,6 +454,13 @@ private:
   std::weak_ptr<acceptor_type>  acceptor_;
   std::weak_ptr<socket_type>    socket_;
   std::shared_ptr<manager_type> manager_{std::make_shared<manager_type>(*this)};
+
+  thread_pool_type         handler_pool_;
+  std::size_t              max_pending_{0};
+  std::atomic<std::size_t> pending_{0};
+
+  std::mutex                                     responses_mutex_;
+  std::unordered_map<handle_type, ResponseQueue> responses_;
 };
 }  // namespace http
 }  // namespace fetch
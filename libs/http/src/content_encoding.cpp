@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "http/content_encoding.hpp"
+#include "core/byte_array/const_byte_array.hpp"
+#include "core/string/to_lower.hpp"
+#include "core/string/trim.hpp"
+
+#include <cstdlib>
+
+namespace fetch {
+namespace http {
+namespace {
+
+/**
+ * Parse the quality value of an element of an Accept-Encoding header, e.g. "gzip;q=0.5"
+ *
+ * @param element The element, which is split into its coding and quality
+ * @return The quality, between 0 and 1
+ */
+double ParseQuality(std::string &element)
+{
+  double quality = 1.0;
+
+  std::size_t const separator = element.find(';');
+  if (separator != std::string::npos)
+  {
+    std::string parameter = element.substr(separator + 1);
+    string::Trim(parameter);
+
+    if ((parameter.size() > 2) && (parameter.compare(0, 2, "q=") == 0))
+    {
+      quality = std::strtod(parameter.c_str() + 2, nullptr);
+    }
+
+    element = element.substr(0, separator);
+    string::Trim(element);
+  }
+
+  return quality;
+}
+
+}  // namespace
+
+char const *ToString(ContentEncoding encoding)
+{
+  char const *text = "identity";
+  switch (encoding)
+  {
+  case ContentEncoding::IDENTITY:
+    text = "identity";
+    break;
+  case ContentEncoding::GZIP:
+    text = "gzip";
+    break;
+  case ContentEncoding::DEFLATE:
+    text = "deflate";
+    break;
+  }
+
+  return text;
+}
+
+/**
+ * Select the encoding of a response from the Accept-Encoding header of the request. The supported
+ * encoding with the highest quality is selected, gzip being preferred when they are equal.
+ *
+ * @param accept_encoding The value of the header, empty if it was not present
+ * @return The selected encoding, identity when no compression has been accepted
+ */
+ContentEncoding NegotiateEncoding(byte_array::ConstByteArray const &accept_encoding)
+{
+  std::string codings = static_cast<std::string>(accept_encoding);
+  string::ToLower(codings);
+
+  double gzip     = -1.0;
+  double deflate  = -1.0;
+  double wildcard = -1.0;
+
+  std::size_t start = 0;
+  while (start < codings.size())
+  {
+    std::size_t end = codings.find(',', start);
+    if (end == std::string::npos)
+    {
+      end = codings.size();
+    }
+
+    std::string element = codings.substr(start, end - start);
+    string::Trim(element);
+
+    double const quality = ParseQuality(element);
+    if ((element == "gzip") || (element == "x-gzip"))
+    {
+      gzip = quality;
+    }
+    else if (element == "deflate")
+    {
+      deflate = quality;
+    }
+    else if (element == "*")
+    {
+      wildcard = quality;
+    }
+
+    start = end + 1;
+  }
+
+  // codings which are not listed are covered by the wildcard
+  gzip    = (gzip < 0.0) ? wildcard : gzip;
+  deflate = (deflate < 0.0) ? wildcard : deflate;
+
+  if ((gzip > 0.0) && (gzip >= deflate))
+  {
+    return ContentEncoding::GZIP;
+  }
+
+  if (deflate > 0.0)
+  {
+    return ContentEncoding::DEFLATE;
+  }
+
+  return ContentEncoding::IDENTITY;
+}
+
+}  // namespace http
+}  // namespace fetch
@@ -17,9 +17,51 @@
 //------------------------------------------------------------------------------
 
 #include "http/request.hpp"
+#include "core/string/to_lower.hpp"
+#include "core/string/trim.hpp"
+
+#include <string>
 
 namespace fetch {
 namespace http {
+namespace {
+
+/**
+ * Determine if a comma separated connection header contains the specified option
+ *
+ * @param value The value of the header
+ * @param option The lower case option to search for
+ * @return true if the option is present, otherwise false
+ */
+bool HasConnectionOption(byte_array::ConstByteArray const &value, std::string const &option)
+{
+  std::string options = static_cast<std::string>(value);
+  string::ToLower(options);
+
+  std::size_t start = 0;
+  while (start <= options.size())
+  {
+    std::size_t end = options.find(',', start);
+    if (end == std::string::npos)
+    {
+      end = options.size();
+    }
+
+    std::string current = options.substr(start, end - start);
+    string::Trim(current);
+
+    if (current == option)
+    {
+      return true;
+    }
+
+    start = end + 1;
+  }
+
+  return false;
+}
+
+}  // namespace
 
 bool HTTPRequest::ParseBody(asio::streambuf &buffer)
 {
@@ -157,6 +199,23 @@ bool HTTPRequest::ParseHeader(asio::streambuf &buffer, std::size_t const &end)
     success = ParseStartLine(start_line);
   }
 
+  // HTTP/1.1 connections are persistent unless the client opts out, earlier versions only persist
+  // if the client opts in
+  keep_alive_ = (protocol_ == "http/1.1");
+  if (header_.Has("connection"))
+  {
+    auto const connection = static_cast<Header const &>(header_)["connection"];
+
+    if (HasConnectionOption(connection, "close"))
+    {
+      keep_alive_ = false;
+    }
+    else if (HasConnectionOption(connection, "keep-alive"))
+    {
+      keep_alive_ = true;
+    }
+  }
+
   return success;
 }
 
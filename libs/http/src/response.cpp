@@ -21,9 +21,14 @@
 #include "core/string/to_lower.hpp"
 #include "core/string/trim.hpp"
 
+#include <zlib.h>
+
 #include <cstdlib>
 #include <cstring>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
 
 namespace fetch {
 namespace http {
@@ -45,8 +50,176 @@ byte_array::ByteArray CopyBuffer(asio::streambuf &buffer, std::size_t length)
   return data;
 }
 
+/**
+ * Incrementally compresses a body into a gzip or zlib stream
+ */
+class Deflater
+{
+public:
+  Deflater(ContentEncoding encoding, int level)
+  {
+    // zlib selects the gzip wrapper for window sizes offset by 16
+    int const window_bits = (encoding == ContentEncoding::GZIP) ? (MAX_WBITS + 16) : MAX_WBITS;
+
+    std::memset(&stream_, 0, sizeof(stream_));
+    if (deflateInit2(&stream_, level, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+      throw std::runtime_error("Unable to initialise the deflate stream");
+    }
+  }
+
+  Deflater(Deflater const &) = delete;
+  Deflater(Deflater &&)      = delete;
+
+  ~Deflater()
+  {
+    deflateEnd(&stream_);
+  }
+
+  /**
+   * Compress the next part of the body
+   *
+   * @param input The uncompressed data
+   * @param flush Z_SYNC_FLUSH to emit all the data compressed so far, Z_FINISH to end the stream
+   * @return The compressed data
+   */
+  byte_array::ConstByteArray Process(byte_array::ConstByteArray const &input, int flush)
+  {
+    byte_array::ByteArray output;
+    output.Resize(deflateBound(&stream_, static_cast<uLong>(input.size())) + 16);
+
+    stream_.next_in  = const_cast<Bytef *>(input.pointer());
+    stream_.avail_in = static_cast<uInt>(input.size());
+
+    std::size_t produced = 0;
+    do
+    {
+      if (produced == output.size())
+      {
+        output.Resize(output.size() * 2);
+      }
+
+      stream_.next_out  = output.pointer() + produced;
+      stream_.avail_out = static_cast<uInt>(output.size() - produced);
+
+      deflate(&stream_, flush);
+
+      produced = output.size() - stream_.avail_out;
+    } while (stream_.avail_out == 0);
+
+    output.Resize(produced);
+    return output;
+  }
+
+  Deflater &operator=(Deflater const &) = delete;
+  Deflater &operator=(Deflater &&) = delete;
+
+private:
+  z_stream stream_;
+};
+
 }  // namespace
 
+constexpr int HTTPResponse::DEFAULT_COMPRESSION_LEVEL;
+
+/**
+ * Stream the body from a producer rather than from memory. The body is sent with chunked transfer
+ * encoding as it is produced, which replaces any body and content length already set.
+ *
+ * @param producer The generator of the chunks of the body
+ */
+void HTTPResponse::SetBodyProducer(BodyProducer producer)
+{
+  body_     = byte_array::ConstByteArray{};
+  producer_ = std::move(producer);
+
+  header_.Remove("content-length");
+  header_["transfer-encoding"] = "chunked";
+}
+
+/**
+ * Compress the body of the response, unless it has already been encoded or it would not shrink
+ *
+ * @param encoding The encoding negotiated with the client
+ * @param level The zlib compression level (1 - 9)
+ * @return true if the body has been compressed, otherwise false
+ */
+bool HTTPResponse::Compress(ContentEncoding encoding, int level)
+{
+  if ((encoding == ContentEncoding::IDENTITY) || header_.Has("content-encoding"))
+  {
+    return false;
+  }
+
+  auto deflater = std::make_shared<Deflater>(encoding, level);
+
+  if (producer_)
+  {
+    // each chunk is flushed so the client receives it as soon as it is produced
+    auto producer = std::move(producer_);
+    auto finished = std::make_shared<bool>(false);
+
+    producer_ = [producer, deflater, finished]() -> byte_array::ConstByteArray {
+      if (*finished)
+      {
+        return {};
+      }
+
+      auto const chunk = producer();
+      if (chunk.empty())
+      {
+        *finished = true;
+        return deflater->Process(chunk, Z_FINISH);
+      }
+
+      return deflater->Process(chunk, Z_SYNC_FLUSH);
+    };
+  }
+  else
+  {
+    auto compressed = deflater->Process(body_, Z_FINISH);
+    if (compressed.size() >= body_.size())
+    {
+      return false;
+    }
+
+    body_                     = std::move(compressed);
+    header_["content-length"] = std::to_string(body_.size());
+  }
+
+  header_["content-encoding"] = ToString(encoding);
+  header_["vary"]             = "accept-encoding";
+
+  return true;
+}
+
+/**
+ * Produce the next chunk of a streamed body and write it to the buffer
+ *
+ * @param buffer The buffer to be written to
+ * @return true if there are further chunks, false once the last chunk has been written
+ */
+bool HTTPResponse::NextChunkToStream(asio::streambuf &buffer)
+{
+  static const char *NEW_LINE = "\r\n";
+
+  std::ostream stream(&buffer);
+
+  auto const chunk = producer_ ? producer_() : byte_array::ConstByteArray{};
+  if (chunk.empty())
+  {
+    producer_ = BodyProducer{};
+
+    stream << '0' << NEW_LINE << NEW_LINE;
+    return false;
+  }
+
+  stream << std::hex << chunk.size() << std::dec << NEW_LINE;
+  stream.write(chunk.char_pointer(), static_cast<std::streamsize>(chunk.size()));
+  stream << NEW_LINE;
+  return true;
+}
+
 bool HTTPResponse::ToStream(asio::streambuf &buffer) const
 {
   static const char *NEW_LINE = "\r\n";
@@ -62,6 +235,13 @@ bool HTTPResponse::ToStream(asio::streambuf &buffer) const
     stream << field.first << ": " << field.second << NEW_LINE;
   }
 
+  if (producer_)
+  {
+    // the chunks of the body follow the header
+    stream << NEW_LINE;
+    return true;
+  }
+
   if (!header_.Has("content-length"))
   {
     stream << "content-length: " << body_.size() << NEW_LINE;
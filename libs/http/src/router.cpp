@@ -0,0 +1,522 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "http/router.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace fetch {
+namespace http {
+namespace {
+
+enum class ParameterType
+{
+  DIGITS,  ///< \d+
+  WORD,    ///< \w+
+  HEX,     ///< a hex character class, of a fixed length or repeated
+  ANY,     ///< .+
+  REGEX    ///< everything else
+};
+
+bool IsWordChar(char c)
+{
+  return (('a' <= c) && (c <= 'z')) || (('A' <= c) && (c <= 'Z')) || (('0' <= c) && (c <= '9')) ||
+         (c == '_');
+}
+
+bool IsDigit(char c)
+{
+  return ('0' <= c) && (c <= '9');
+}
+
+bool IsHexChar(char c)
+{
+  return IsDigit(c) || (('a' <= c) && (c <= 'f')) || (('A' <= c) && (c <= 'F'));
+}
+
+/**
+ * Determine if the pattern is a hex character class (of either case) followed by either a fixed
+ * repetition or '+'
+ *
+ * @param pattern The parameter pattern
+ * @param length Set to the required length, or zero for one or more characters
+ * @return true if the pattern is a hex pattern, otherwise false
+ */
+bool ParseHexPattern(std::string const &pattern, std::size_t &length)
+{
+  static std::string const CLASSES[] = {"[a-fA-F0-9]", "[0-9a-fA-F]", "[A-Fa-f0-9]",
+                                        "[0-9A-Fa-f]"};
+
+  for (auto const &char_class : CLASSES)
+  {
+    if (pattern.compare(0, char_class.size(), char_class) != 0)
+    {
+      continue;
+    }
+
+    std::string const repetition = pattern.substr(char_class.size());
+    if (repetition == "+")
+    {
+      length = 0;
+      return true;
+    }
+
+    if ((repetition.size() > 2) && (repetition.front() == '{') && (repetition.back() == '}') &&
+        std::all_of(repetition.begin() + 1, repetition.end() - 1, IsDigit))
+    {
+      length = std::stoul(repetition.substr(1, repetition.size() - 2));
+      return length > 0;
+    }
+  }
+
+  return false;
+}
+
+std::size_t CommonPrefix(std::string const &a, char const *b, std::size_t b_size)
+{
+  std::size_t const limit = std::min(a.size(), b_size);
+
+  std::size_t i = 0;
+  while ((i < limit) && (a[i] == b[i]))
+  {
+    ++i;
+  }
+
+  return i;
+}
+
+}  // namespace
+
+struct Router::Endpoint
+{
+  Method      method;
+  std::size_t order;
+  Handler     handler;
+};
+
+struct Router::Parameter
+{
+  ConstByteArray              name;
+  std::string                 pattern;
+  ParameterType               type;
+  std::size_t                 length;
+  std::shared_ptr<std::regex> regex;
+  std::unique_ptr<Node>       next;
+
+  bool Consume(ConstByteArray const &path, std::size_t pos, std::size_t &matched) const;
+};
+
+struct Router::Node
+{
+  struct Edge
+  {
+    std::string           label;
+    std::unique_ptr<Node> next;
+  };
+
+  std::vector<Edge>      edges;  ///< The first characters of the labels are unique
+  std::vector<Parameter> parameters;
+  std::vector<Endpoint>  endpoints;
+
+  Node &AddLiteral(std::string const &literal);
+  Node &AddParameter(ConstByteArray const &name, std::string const &pattern);
+};
+
+struct Router::Capture
+{
+  ConstByteArray const *name;
+  std::size_t           pos;
+  std::size_t           length;
+};
+
+struct Router::Candidate
+{
+  Endpoint const *endpoint{nullptr};
+  bool            method_match{false};
+  Captures        captures{};
+};
+
+/**
+ * Match the parameter against the start of the remaining path
+ *
+ * @param path The request path
+ * @param pos The position in the path to match from
+ * @param matched Set to the number of characters matched
+ * @return true if the parameter matches, otherwise false
+ */
+bool Router::Parameter::Consume(ConstByteArray const &path, std::size_t pos,
+                                std::size_t &matched) const
+{
+  char const *      data = path.char_pointer() + pos;
+  std::size_t const size = path.size() - pos;
+
+  std::size_t i = 0;
+  switch (type)
+  {
+  case ParameterType::DIGITS:
+    while ((i < size) && IsDigit(data[i]))
+    {
+      ++i;
+    }
+    break;
+  case ParameterType::WORD:
+    while ((i < size) && IsWordChar(data[i]))
+    {
+      ++i;
+    }
+    break;
+  case ParameterType::HEX:
+    while ((i < size) && ((length == 0) || (i < length)) && IsHexChar(data[i]))
+    {
+      ++i;
+    }
+
+    if ((length != 0) && (i != length))
+    {
+      return false;
+    }
+    break;
+  case ParameterType::ANY:
+    while ((i < size) && (data[i] != '\n') && (data[i] != '\r'))
+    {
+      ++i;
+    }
+    break;
+  case ParameterType::REGEX:
+  {
+    std::cmatch match;
+    if (!std::regex_search(data, data + size, match, *regex))
+    {
+      return false;
+    }
+
+    // unlike the typed parameters, a regular expression might match nothing
+    matched = static_cast<std::size_t>(match.length(0));
+    return true;
+  }
+  }
+
+  matched = i;
+  return i > 0;
+}
+
+/**
+ * Add a literal to the trie below this node, splitting edges as required
+ *
+ * @param literal The literal text
+ * @return The node at the end of the literal
+ */
+Router::Node &Router::Node::AddLiteral(std::string const &literal)
+{
+  if (literal.empty())
+  {
+    return *this;
+  }
+
+  auto it = std::find_if(edges.begin(), edges.end(),
+                         [&literal](Edge const &edge) { return edge.label[0] == literal[0]; });
+
+  if (it == edges.end())
+  {
+    edges.push_back({literal, std::make_unique<Node>()});
+    return *edges.back().next;
+  }
+
+  std::size_t const common = CommonPrefix(it->label, literal.data(), literal.size());
+
+  // split the edge when the literal diverges from it part way through
+  if (common < it->label.size())
+  {
+    auto split = std::make_unique<Node>();
+    split->edges.push_back({it->label.substr(common), std::move(it->next)});
+
+    it->label = it->label.substr(0, common);
+    it->next  = std::move(split);
+  }
+
+  return it->next->AddLiteral(literal.substr(common));
+}
+
+/**
+ * Add a parameter below this node, parameters with the same name and pattern are shared
+ *
+ * @param name The name of the parameter
+ * @param pattern The pattern the parameter matches
+ * @return The node following the parameter
+ */
+Router::Node &Router::Node::AddParameter(ConstByteArray const &name, std::string const &pattern)
+{
+  for (auto &parameter : parameters)
+  {
+    if ((parameter.name == name) && (parameter.pattern == pattern))
+    {
+      return *parameter.next;
+    }
+  }
+
+  Parameter parameter{name, pattern, ParameterType::REGEX, 0, nullptr, std::make_unique<Node>()};
+
+  if ((pattern == "\\d+") || (pattern == "[0-9]+"))
+  {
+    parameter.type = ParameterType::DIGITS;
+  }
+  else if (pattern == "\\w+")
+  {
+    parameter.type = ParameterType::WORD;
+  }
+  else if (pattern == ".+")
+  {
+    parameter.type = ParameterType::ANY;
+  }
+  else if (ParseHexPattern(pattern, parameter.length))
+  {
+    parameter.type = ParameterType::HEX;
+  }
+  else
+  {
+    parameter.regex = std::make_shared<std::regex>("^" + pattern);
+  }
+
+  parameters.push_back(std::move(parameter));
+  return *parameters.back().next;
+}
+
+/**
+ * Register a request being served, unless the limit has been reached
+ *
+ * @return true if the request may be served, otherwise false
+ */
+bool Router::ConcurrencyLimit::TryAcquire()
+{
+  std::size_t const previous = active_++;
+
+  std::size_t const limit = limit_;
+  if ((limit != 0) && (previous >= limit))
+  {
+    --active_;
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Signal that a request acquired with TryAcquire has been served
+ */
+void Router::ConcurrencyLimit::Release()
+{
+  --active_;
+}
+
+Router::Router()
+  : root_{std::make_unique<Node>()}
+{}
+
+Router::~Router() = default;
+
+/**
+ * Mount a view on the specified path
+ *
+ * @param method The method of the view
+ * @param path The path, made up of literals and (name=pattern) parameters
+ * @param view The view
+ * @param deferred The deferred view, mounted instead of the view when set
+ */
+void Router::Add(Method method, ConstByteArray const &path, View const &view,
+                 DeferredView const &deferred)
+{
+  std::string const text = static_cast<std::string>(path);
+
+  Node *      node    = root_.get();
+  std::size_t literal = 0;
+  std::size_t i       = 0;
+
+  while (i < text.size())
+  {
+    if (text[i] != '(')
+    {
+      ++i;
+      continue;
+    }
+
+    // find the matching bracket, allowing for groups within the pattern
+    std::size_t depth = 1;
+    std::size_t j     = i + 1;
+    for (; (j < text.size()) && (depth != 0); ++j)
+    {
+      depth += static_cast<std::size_t>(text[j] == '(');
+      depth -= static_cast<std::size_t>(text[j] == ')');
+    }
+
+    if (depth != 0)
+    {
+      throw std::runtime_error("Unclosed parameter in route: " + text);
+    }
+
+    std::string const parameter = text.substr(i + 1, j - i - 2);
+    std::size_t const equals    = parameter.find('=');
+    if (equals == std::string::npos)
+    {
+      throw std::runtime_error("No pattern for parameter in route: " + text);
+    }
+
+    node = &node->AddLiteral(text.substr(literal, i - literal));
+    node = &node->AddParameter(ConstByteArray{parameter.substr(0, equals)},
+                               parameter.substr(equals + 1));
+
+    literal = i = j;
+  }
+
+  // views mounted on the same path with the same method share their limit
+  auto &concurrency = limits_[LimitKey{method, text}];
+  if (!concurrency)
+  {
+    concurrency = std::make_shared<ConcurrencyLimit>();
+  }
+
+  Handler const handler{view, concurrency, deferred};
+
+  std::string trailing = text.substr(literal);
+  std::size_t order    = size_++;
+
+  // a trailing separator is optional, since the previous matching ignored it
+  if ((text.size() > 1) && (text.back() == '/'))
+  {
+    trailing.pop_back();
+
+    node = &node->AddLiteral(trailing);
+    node->endpoints.push_back({method, order, handler});
+
+    trailing = "/";
+  }
+
+  node = &node->AddLiteral(trailing);
+  node->endpoints.push_back({method, order, handler});
+}
+
+/**
+ * Limit the number of requests which can be served concurrently by the views mounted on a path
+ *
+ * @param method The method of the views
+ * @param path The path, exactly as the views were mounted with
+ * @param limit The maximum number of concurrent requests, zero for no limit
+ * @return true if views have been mounted on the path, otherwise false
+ */
+bool Router::SetConcurrencyLimit(Method method, ConstByteArray const &path, std::size_t limit)
+{
+  auto it = limits_.find(LimitKey{method, static_cast<std::string>(path)});
+  if (it == limits_.end())
+  {
+    return false;
+  }
+
+  it->second->SetLimit(limit);
+  return true;
+}
+
+/**
+ * Find the view for a request
+ *
+ * @param method The method of the request
+ * @param path The path of the request
+ * @param params Populated with the parameters of the selected view
+ * @return The handler of the selected view if there is one, otherwise nullptr
+ */
+Router::Handler const *Router::Match(Method method, ConstByteArray const &path,
+                                     ViewParameters &params) const
+{
+  params.Clear();
+
+  Captures  captures;
+  Candidate best;
+  Search(*root_, method, path, 0, captures, best);
+
+  if (best.endpoint == nullptr)
+  {
+    return nullptr;
+  }
+
+  for (auto const &capture : best.captures)
+  {
+    params[*capture.name] = path.SubArray(capture.pos, capture.length);
+  }
+
+  return &best.endpoint->handler;
+}
+
+void Router::Search(Node const &node, Method method, ConstByteArray const &path, std::size_t pos,
+                    Captures &captures, Candidate &best) const
+{
+  if (pos == path.size())
+  {
+    for (auto const &endpoint : node.endpoints)
+    {
+      bool const method_match = (endpoint.method == method);
+
+      if ((best.endpoint == nullptr) || (method_match && !best.method_match) ||
+          ((method_match == best.method_match) && (endpoint.order < best.endpoint->order)))
+      {
+        best.endpoint     = &endpoint;
+        best.method_match = method_match;
+        best.captures     = captures;
+      }
+    }
+  }
+
+  if (pos < path.size())
+  {
+    char const *      remaining = path.char_pointer() + pos;
+    std::size_t const size      = path.size() - pos;
+
+    for (auto const &edge : node.edges)
+    {
+      if (edge.label[0] != remaining[0])
+      {
+        continue;
+      }
+
+      if ((edge.label.size() <= size) &&
+          (std::memcmp(edge.label.data(), remaining, edge.label.size()) == 0))
+      {
+        Search(*edge.next, method, path, pos + edge.label.size(), captures, best);
+      }
+
+      // the first characters of the edges are unique
+      break;
+    }
+  }
+
+  for (auto const &parameter : node.parameters)
+  {
+    std::size_t matched = 0;
+    if ((pos <= path.size()) && parameter.Consume(path, pos, matched))
+    {
+      captures.push_back({&parameter.name, pos, matched});
+      Search(*parameter.next, method, path, pos + matched, captures, best);
+      captures.pop_back();
+    }
+  }
+}
+
+}  // namespace http
+}  // namespace fetch
@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "http/request.hpp"
+#include "network/fetch_asio.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+class RequestTests : public ::testing::Test
+{
+protected:
+  using Request    = fetch::http::HTTPRequest;
+  using RequestPtr = std::unique_ptr<Request>;
+
+  void SetUp() override
+  {
+    request_ = std::make_unique<Request>();
+  }
+
+  void ConvertToBuffer(char const *text, asio::streambuf &buffer)
+  {
+    std::ostream stream(&buffer);
+    stream << text;
+  }
+
+  static std::size_t HeaderLength(asio::streambuf &buffer)
+  {
+    std::string const contents{asio::buffers_begin(buffer.data()),
+                               asio::buffers_end(buffer.data())};
+    return contents.find("\r\n\r\n") + 4;
+  }
+
+  bool ParseHeader(char const *text)
+  {
+    asio::streambuf buffer;
+    ConvertToBuffer(text, buffer);
+
+    return request_->ParseHeader(buffer, HeaderLength(buffer));
+  }
+
+  RequestPtr request_;
+};
+
+TEST_F(RequestTests, Http11ConnectionsPersistByDefault)
+{
+  ASSERT_TRUE(ParseHeader("GET /api/status HTTP/1.1\r\n"
+                          "Host: localhost\r\n"
+                          "\r\n"));
+
+  EXPECT_TRUE(request_->keep_alive());
+}
+
+TEST_F(RequestTests, Http11ConnectionsCanBeClosed)
+{
+  ASSERT_TRUE(ParseHeader("GET /api/status HTTP/1.1\r\n"
+                          "Host: localhost\r\n"
+                          "Connection: Close\r\n"
+                          "\r\n"));
+
+  EXPECT_FALSE(request_->keep_alive());
+}
+
+TEST_F(RequestTests, Http10ConnectionsCloseByDefault)
+{
+  ASSERT_TRUE(ParseHeader("GET /api/status HTTP/1.0\r\n"
+                          "\r\n"));
+
+  EXPECT_FALSE(request_->keep_alive());
+}
+
+TEST_F(RequestTests, Http10ConnectionsCanBeKeptAlive)
+{
+  ASSERT_TRUE(ParseHeader("GET /api/status HTTP/1.0\r\n"
+                          "Connection: Upgrade, Keep-Alive\r\n"
+                          "\r\n"));
+
+  EXPECT_TRUE(request_->keep_alive());
+}
+
+TEST_F(RequestTests, PipelinedRequestsAreParsedFromTheSameBuffer)
+{
+  asio::streambuf buffer;
+  ConvertToBuffer("POST /api/wallet/balance HTTP/1.1\r\n"
+                  "Content-Length: 4\r\n"
+                  "\r\n"
+                  "abcd"
+                  "GET /api/status HTTP/1.1\r\n"
+                  "Connection: close\r\n"
+                  "\r\n",
+                  buffer);
+
+  ASSERT_TRUE(request_->ParseHeader(buffer, HeaderLength(buffer)));
+  ASSERT_TRUE(request_->ParseBody(buffer));
+  EXPECT_EQ(request_->uri(), "/api/wallet/balance");
+  EXPECT_EQ(request_->body(), "abcd");
+  EXPECT_TRUE(request_->keep_alive());
+
+  Request second;
+  ASSERT_TRUE(second.ParseHeader(buffer, HeaderLength(buffer)));
+  EXPECT_EQ(second.uri(), "/api/status");
+  EXPECT_FALSE(second.keep_alive());
+  EXPECT_EQ(buffer.size(), 0u);
+}
@@ -21,8 +21,13 @@
 #include "network/fetch_asio.hpp"
 
 #include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <cstring>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <vector>
 
 class ResponseTests : public ::testing::Test
 {
@@ -48,6 +53,53 @@ protected:
     EXPECT_EQ(response_->header()[key], value);
   }
 
+  static std::string ToString(asio::streambuf &buffer)
+  {
+    std::string const text{asio::buffers_begin(buffer.data()), asio::buffers_end(buffer.data())};
+    buffer.consume(buffer.size());
+    return text;
+  }
+
+  static std::string Inflate(std::string const &input)
+  {
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+
+    // detect either the gzip or zlib wrapper
+    EXPECT_EQ(inflateInit2(&stream, MAX_WBITS + 32), Z_OK);
+
+    std::string output(input.size() * 16 + 1024, '\0');
+    stream.next_in   = reinterpret_cast<Bytef *>(const_cast<char *>(input.data()));
+    stream.avail_in  = static_cast<uInt>(input.size());
+    stream.next_out  = reinterpret_cast<Bytef *>(&output[0]);
+    stream.avail_out = static_cast<uInt>(output.size());
+
+    EXPECT_EQ(inflate(&stream, Z_FINISH), Z_STREAM_END);
+
+    output.resize(stream.total_out);
+    inflateEnd(&stream);
+
+    return output;
+  }
+
+  /// Decode a chunked body, returning the chunks as they were framed
+  static std::vector<std::string> Dechunk(std::string const &body)
+  {
+    std::vector<std::string> chunks;
+
+    std::size_t pos = 0;
+    while (pos < body.size())
+    {
+      std::size_t const line_end = body.find("\r\n", pos);
+      std::size_t const size     = std::stoul(body.substr(pos, line_end - pos), nullptr, 16);
+
+      chunks.push_back(body.substr(line_end + 2, size));
+      pos = line_end + 2 + size + 2;
+    }
+
+    return chunks;
+  }
+
   ResponsePtr response_;
 };
 
@@ -91,4 +143,132 @@ TEST_F(ResponseTests, HeaderCase2)
 
   VerifyHeaderValue("content-type", "application/json");
   VerifyHeaderValue("content-length", "10");
-}
\ No newline at end of file
+}
+
+TEST_F(ResponseTests, EncodingNegotiation)
+{
+  using fetch::http::ContentEncoding;
+  using fetch::http::NegotiateEncoding;
+
+  EXPECT_EQ(NegotiateEncoding(""), ContentEncoding::IDENTITY);
+  EXPECT_EQ(NegotiateEncoding("br"), ContentEncoding::IDENTITY);
+  EXPECT_EQ(NegotiateEncoding("gzip, deflate"), ContentEncoding::GZIP);
+  EXPECT_EQ(NegotiateEncoding("Deflate, GZIP;q=0.5"), ContentEncoding::DEFLATE);
+  EXPECT_EQ(NegotiateEncoding("gzip;q=0, deflate"), ContentEncoding::DEFLATE);
+  EXPECT_EQ(NegotiateEncoding("*"), ContentEncoding::GZIP);
+  EXPECT_EQ(NegotiateEncoding("*;q=0, identity"), ContentEncoding::IDENTITY);
+}
+
+TEST_F(ResponseTests, CompressedBody)
+{
+  std::string body;
+  for (std::size_t i = 0; i < 200; ++i)
+  {
+    body += R"({"block": ")" + std::to_string(i) + R"(", "transactions": []},)";
+  }
+
+  for (auto encoding : {fetch::http::ContentEncoding::GZIP, fetch::http::ContentEncoding::DEFLATE})
+  {
+    Response response{ConstByteArray{body}};
+    ASSERT_TRUE(response.Compress(encoding));
+
+    // already encoded
+    EXPECT_FALSE(response.Compress(encoding));
+
+    auto const compressed = static_cast<std::string>(response.body());
+    EXPECT_LT(compressed.size(), body.size());
+    EXPECT_EQ(Inflate(compressed), body);
+
+    EXPECT_EQ(response.header()["content-length"], std::to_string(compressed.size()));
+    EXPECT_EQ(response.header()["content-encoding"], fetch::http::ToString(encoding));
+  }
+
+  // bodies that would not shrink are left as they are
+  Response small{"a"};
+  EXPECT_FALSE(small.Compress(fetch::http::ContentEncoding::GZIP));
+  EXPECT_EQ(small.body(), "a");
+  EXPECT_FALSE(small.header().Has("content-encoding"));
+}
+
+TEST_F(ResponseTests, StreamedBody)
+{
+  std::size_t produced = 0;
+
+  Response response{"ignored"};
+  response.SetBodyProducer([&produced]() -> ConstByteArray {
+    return (produced < 3) ? ConstByteArray{std::string(100 * ++produced, 'x')} : ConstByteArray{};
+  });
+
+  ASSERT_TRUE(response.is_streamed());
+
+  asio::streambuf buffer;
+  response.ToStream(buffer);
+
+  std::string const header = ToString(buffer);
+  EXPECT_NE(header.find("transfer-encoding: chunked\r\n"), std::string::npos);
+  EXPECT_EQ(header.find("content-length"), std::string::npos);
+  EXPECT_EQ(header.find("ignored"), std::string::npos);
+  EXPECT_EQ(header.substr(header.size() - 4), "\r\n\r\n");
+
+  // chunks are only produced as they are requested
+  EXPECT_EQ(produced, 0u);
+
+  std::string body;
+  while (response.NextChunkToStream(buffer))
+  {
+    body += ToString(buffer);
+  }
+  body += ToString(buffer);
+
+  EXPECT_EQ(produced, 3u);
+  EXPECT_FALSE(response.is_streamed());
+
+  auto const chunks = Dechunk(body);
+  ASSERT_EQ(chunks.size(), 4u);
+  EXPECT_EQ(chunks[0], std::string(100, 'x'));
+  EXPECT_EQ(chunks[1], std::string(200, 'x'));
+  EXPECT_EQ(chunks[2], std::string(300, 'x'));
+  EXPECT_EQ(chunks[3], "");
+}
+
+TEST_F(ResponseTests, CompressedStreamedBody)
+{
+  std::size_t produced = 0;
+
+  Response response;
+  response.SetBodyProducer([&produced]() -> ConstByteArray {
+    return (produced++ < 5) ? ConstByteArray{"[1, 2, 3, 4, 5, 6, 7, 8, 9]"} : ConstByteArray{};
+  });
+
+  ASSERT_TRUE(response.Compress(fetch::http::ContentEncoding::GZIP));
+  EXPECT_EQ(response.header()["content-encoding"], "gzip");
+
+  asio::streambuf buffer;
+  response.ToStream(buffer);
+  ToString(buffer);
+
+  std::string body;
+  std::size_t chunk_count = 0;
+  while (response.NextChunkToStream(buffer))
+  {
+    body += ToString(buffer);
+
+    // every chunk is flushed so that it can be decoded on arrival
+    EXPECT_EQ(produced, ++chunk_count);
+  }
+  body += ToString(buffer);
+
+  std::string compressed;
+  for (auto const &chunk : Dechunk(body))
+  {
+    compressed += chunk;
+  }
+
+  std::string expected;
+  for (std::size_t i = 0; i < 5; ++i)
+  {
+    expected += "[1, 2, 3, 4, 5, 6, 7, 8, 9]";
+  }
+
+  EXPECT_EQ(Inflate(compressed), expected);
+}
@@ -0,0 +1,231 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "http/router.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace {
+
+using fetch::byte_array::ConstByteArray;
+using fetch::http::HTTPRequest;
+using fetch::http::HTTPResponse;
+using fetch::http::Method;
+using fetch::http::Router;
+using fetch::http::ViewParameters;
+
+class RouterTests : public ::testing::Test
+{
+protected:
+  void Add(Method method, ConstByteArray const &path, std::string const &name)
+  {
+    router_.Add(method, path,
+                [name](ViewParameters const &, HTTPRequest const &) { return HTTPResponse(name); });
+  }
+
+  // returns the name of the selected view or an empty string if there is none
+  std::string Match(Method method, ConstByteArray const &path)
+  {
+    auto const *handler = router_.Match(method, path, params_);
+    if (handler == nullptr)
+    {
+      return {};
+    }
+
+    return static_cast<std::string>(handler->view(params_, HTTPRequest{}).body());
+  }
+
+  Router         router_;
+  ViewParameters params_;
+};
+
+TEST_F(RouterTests, LiteralsWithCommonPrefixes)
+{
+  Add(Method::GET, "/api/status", "status");
+  Add(Method::GET, "/api/status/chain", "chain");
+  Add(Method::GET, "/api/statistics", "statistics");
+  Add(Method::GET, "/api/stat", "stat");
+
+  EXPECT_EQ(router_.size(), 4u);
+  EXPECT_EQ(Match(Method::GET, "/api/status"), "status");
+  EXPECT_EQ(Match(Method::GET, "/api/status/chain"), "chain");
+  EXPECT_EQ(Match(Method::GET, "/api/statistics"), "statistics");
+  EXPECT_EQ(Match(Method::GET, "/api/stat"), "stat");
+
+  EXPECT_EQ(Match(Method::GET, "/api/sta"), "");
+  EXPECT_EQ(Match(Method::GET, "/api/status/"), "");
+  EXPECT_EQ(Match(Method::GET, "/api/status/chains"), "");
+  EXPECT_EQ(Match(Method::GET, ""), "");
+}
+
+TEST_F(RouterTests, TypedParameters)
+{
+  Add(Method::GET, "/pages/(id=\\d+)/", "page");
+  Add(Method::GET, "/other/(name=\\w+)", "name");
+  Add(Method::GET, "/other/(name=\\w+)/(number=\\d+)", "name_number");
+  Add(Method::GET, "/static/(filename=.+)", "static");
+  Add(Method::GET, "/api/tx/(digest=[a-fA-F0-9]{64})/", "tx");
+
+  EXPECT_EQ(Match(Method::GET, "/pages/42/"), "page");
+  EXPECT_EQ(params_["id"], "42");
+  EXPECT_EQ(Match(Method::GET, "/pages/4a/"), "");
+
+  EXPECT_EQ(Match(Method::GET, "/other/some_name"), "name");
+  EXPECT_EQ(params_["name"], "some_name");
+
+  EXPECT_EQ(Match(Method::GET, "/other/some_name/7"), "name_number");
+  EXPECT_EQ(params_["name"], "some_name");
+  EXPECT_EQ(params_["number"], "7");
+
+  EXPECT_EQ(Match(Method::GET, "/static/css/main.css"), "static");
+  EXPECT_EQ(params_["filename"], "css/main.css");
+  EXPECT_EQ(Match(Method::GET, "/static/"), "");
+
+  std::string const digest(64, 'A');
+  EXPECT_EQ(Match(Method::GET, ConstByteArray{"/api/tx/" + digest + "/"}), "tx");
+  EXPECT_EQ(params_["digest"], ConstByteArray{digest});
+  EXPECT_EQ(Match(Method::GET, ConstByteArray{"/api/tx/" + digest.substr(1) + "/"}), "");
+  EXPECT_EQ(Match(Method::GET, ConstByteArray{"/api/tx/" + digest + "0/"}), "");
+}
+
+TEST_F(RouterTests, RegularExpressionParameters)
+{
+  Add(Method::GET, "/api/(code=[a-z]{3})/(rest=(x|y)+)", "regex");
+
+  EXPECT_EQ(Match(Method::GET, "/api/abc/xyx"), "regex");
+  EXPECT_EQ(params_["code"], "abc");
+  EXPECT_EQ(params_["rest"], "xyx");
+
+  EXPECT_EQ(Match(Method::GET, "/api/ab/xyx"), "");
+  EXPECT_EQ(Match(Method::GET, "/api/abc/xyz"), "");
+}
+
+TEST_F(RouterTests, LiteralsAndParametersAtTheSameLevel)
+{
+  Add(Method::POST, "/api/contract/(digest=[a-fA-F0-9]{64})/(query=.+)", "generic");
+  Add(Method::POST, "/api/contract/fetch/token/balance", "balance");
+  Add(Method::POST, "/api/contract/submit", "submit");
+
+  EXPECT_EQ(Match(Method::POST, "/api/contract/fetch/token/balance"), "balance");
+  EXPECT_EQ(Match(Method::POST, "/api/contract/submit"), "submit");
+
+  std::string const digest(64, 'f');
+  EXPECT_EQ(Match(Method::POST, ConstByteArray{"/api/contract/" + digest + "/balance"}),
+            "generic");
+  EXPECT_EQ(params_["query"], "balance");
+}
+
+TEST_F(RouterTests, FirstMountedViewForTheMethodIsSelected)
+{
+  Add(Method::GET, "/api/item/(id=\\d+)", "get_any");
+  Add(Method::POST, "/api/item/(id=\\d+)", "post_any");
+  Add(Method::POST, "/api/item/1", "post_one");
+  Add(Method::GET, "/api/item/1", "get_one");
+
+  EXPECT_EQ(Match(Method::GET, "/api/item/1"), "get_any");
+  EXPECT_EQ(Match(Method::POST, "/api/item/1"), "post_any");
+  EXPECT_EQ(Match(Method::POST, "/api/item/2"), "post_any");
+
+  // views are still found for other methods
+  EXPECT_EQ(Match(Method::PUT, "/api/item/2"), "get_any");
+}
+
+TEST_F(RouterTests, TrailingSeparatorIsOptional)
+{
+  Add(Method::GET, "/", "root");
+  Add(Method::GET, "/pages/sub", "sub");
+  Add(Method::GET, "/pages/sub/", "sub_separator");
+  Add(Method::GET, "/pages/(id=\\d+)/", "page");
+
+  EXPECT_EQ(Match(Method::GET, "/"), "root");
+  EXPECT_EQ(Match(Method::GET, ""), "");
+
+  EXPECT_EQ(Match(Method::GET, "/pages/sub"), "sub");
+  EXPECT_EQ(Match(Method::GET, "/pages/sub/"), "sub_separator");
+
+  EXPECT_EQ(Match(Method::GET, "/pages/12/"), "page");
+  EXPECT_EQ(params_["id"], "12");
+  EXPECT_EQ(Match(Method::GET, "/pages/12"), "page");
+  EXPECT_EQ(params_["id"], "12");
+}
+
+TEST_F(RouterTests, ConcurrencyLimitsAreSharedByThePath)
+{
+  Add(Method::GET, "/api/tx/(digest=[a-fA-F0-9]{64})/", "tx");
+  Add(Method::GET, "/api/status", "status");
+
+  EXPECT_TRUE(router_.SetConcurrencyLimit(Method::GET, "/api/tx/(digest=[a-fA-F0-9]{64})/", 2));
+  EXPECT_FALSE(router_.SetConcurrencyLimit(Method::POST, "/api/status", 2));
+
+  std::string const path = "/api/tx/" + std::string(64, 'a');
+
+  auto const *first  = router_.Match(Method::GET, ConstByteArray{path}, params_);
+  auto const *second = router_.Match(Method::GET, ConstByteArray{path + "/"}, params_);
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  ASSERT_EQ(first->concurrency, second->concurrency);
+
+  auto &limit = *first->concurrency;
+  EXPECT_TRUE(limit.TryAcquire());
+  EXPECT_TRUE(limit.TryAcquire());
+  EXPECT_FALSE(limit.TryAcquire());
+  EXPECT_EQ(limit.active(), 2u);
+
+  limit.Release();
+  EXPECT_TRUE(limit.TryAcquire());
+
+  // other paths are not limited
+  auto const *status = router_.Match(Method::GET, "/api/status", params_);
+  ASSERT_NE(status, nullptr);
+  for (std::size_t i = 0; i < 10; ++i)
+  {
+    EXPECT_TRUE(status->concurrency->TryAcquire());
+  }
+}
+
+TEST_F(RouterTests, DeferredViews)
+{
+  Add(Method::GET, "/api/status", "status");
+
+  router_.Add(Method::POST, "/api/status/watch", Router::View{},
+              [](ViewParameters const &, HTTPRequest const &,
+                 fetch::http::HTTPModule::responder_type const &respond) {
+                respond(HTTPResponse("watched"));
+              });
+
+  auto const *watch = router_.Match(Method::POST, "/api/status/watch", params_);
+  ASSERT_NE(watch, nullptr);
+  ASSERT_TRUE(static_cast<bool>(watch->deferred));
+  EXPECT_FALSE(static_cast<bool>(watch->view));
+
+  std::string body{};
+  watch->deferred(params_, HTTPRequest{}, [&body](HTTPResponse response) {
+    body = static_cast<std::string>(response.body());
+  });
+  EXPECT_EQ(body, "watched");
+
+  // plain views are not deferred
+  auto const *status = router_.Match(Method::GET, "/api/status", params_);
+  ASSERT_NE(status, nullptr);
+  EXPECT_FALSE(static_cast<bool>(status->deferred));
+}
+
+}  // namespace
@@ -30,12 +30,14 @@ using fetch::ledger::MainChain;
 using fetch::ledger::testing::BlockGenerator;
 
 using MainChainPtr = std::unique_ptr<MainChain>;
-using BlockArray   = std::vector<BlockGenerator::BlockPtr>;
+using BlockPtr     = BlockGenerator::BlockPtr;
+using BlockArray   = std::vector<BlockPtr>;
+
+constexpr std::size_t NUM_LANES  = 1;
+constexpr std::size_t NUM_SLICES = 2;
 
 BlockArray GenerateBlocks(benchmark::State const &state)
 {
-  static constexpr std::size_t NUM_LANES       = 1;
-  static constexpr std::size_t NUM_SLICES      = 2;
   static constexpr std::size_t ITERATION_MULTI = 10;
 
   std::size_t const total_blocks = (ITERATION_MULTI * state.max_iterations) + 1;
@@ -57,6 +59,38 @@ BlockArray GenerateBlocks(benchmark::State const &state)
   return array;
 }
 
+/**
+ * Generate a branch of blocks on top of the specified block
+ *
+ * @param gen The block generator
+ * @param from The block to branch from
+ * @param length The number of blocks in the branch
+ * @param weight The weight of each block in the branch
+ * @return The blocks of the branch, in order
+ */
+BlockArray GenerateBranch(BlockGenerator &gen, BlockPtr const &from, std::size_t length,
+                          uint64_t weight = 1u)
+{
+  BlockArray branch(length);
+
+  BlockPtr previous = from;
+  for (auto &block : branch)
+  {
+    block    = gen.Generate(previous, weight);
+    previous = block;
+  }
+
+  return branch;
+}
+
+void AddBlocks(MainChain &chain, BlockArray const &blocks)
+{
+  for (auto const &block : blocks)
+  {
+    chain.AddBlock(*block);
+  }
+}
+
 void MainChain_InMemory_AddBlocksSequentially(benchmark::State &state)
 {
   auto array = GenerateBlocks(state);
@@ -125,9 +159,106 @@ void MainChain_Persistent_AddBlocksOutOfOrder(benchmark::State &state)
   }
 }
 
+void MainChain_InMemory_SwitchToDeepFork(benchmark::State &state)
+{
+  auto const depth = static_cast<std::size_t>(state.range(0));
+
+  BlockGenerator gen{NUM_LANES, NUM_SLICES};
+  auto const     genesis = gen.Generate();
+
+  // the fork is heavier than the original chain, so it becomes the heaviest chain as it is added
+  auto const original = GenerateBranch(gen, genesis, depth);
+  auto const fork     = GenerateBranch(gen, genesis, depth, 2u);
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    auto chain = std::make_unique<MainChain>(MainChain::Mode::IN_MEMORY_DB);
+    AddBlocks(*chain, original);
+    state.ResumeTiming();
+
+    AddBlocks(*chain, fork);
+  }
+}
+
+void MainChain_InMemory_CompleteLooseBlocks(benchmark::State &state)
+{
+  static constexpr std::size_t BRANCH_LENGTH = 16;
+
+  auto const num_branches = static_cast<std::size_t>(state.range(0));
+
+  BlockGenerator gen{NUM_LANES, NUM_SLICES};
+  auto const     genesis = gen.Generate();
+  auto const     root    = gen.Generate(genesis);
+
+  // all the blocks of the branches arrive (newest first) before the root they all build on
+  BlockArray loose;
+  for (std::size_t i = 0; i < num_branches; ++i)
+  {
+    auto const branch = GenerateBranch(gen, root, BRANCH_LENGTH);
+    loose.insert(loose.end(), branch.rbegin(), branch.rend());
+  }
+
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    auto chain = std::make_unique<MainChain>(MainChain::Mode::IN_MEMORY_DB);
+    AddBlocks(*chain, loose);
+    state.ResumeTiming();
+
+    // adding the root resolves all of the loose blocks
+    chain->AddBlock(*root);
+  }
+}
+
+void MainChain_InMemory_GetPathToCommonAncestor(benchmark::State &state)
+{
+  auto const depth = static_cast<std::size_t>(state.range(0));
+
+  BlockGenerator gen{NUM_LANES, NUM_SLICES};
+  auto const     genesis = gen.Generate();
+  auto const     left    = GenerateBranch(gen, genesis, depth);
+  auto const     right   = GenerateBranch(gen, genesis, depth);
+
+  MainChain chain{MainChain::Mode::IN_MEMORY_DB};
+  AddBlocks(chain, left);
+  AddBlocks(chain, right);
+
+  for (auto _ : state)
+  {
+    MainChain::Blocks blocks;
+    benchmark::DoNotOptimize(chain.GetPathToCommonAncestor(blocks, left.back()->body.hash,
+                                                           right.back()->body.hash));
+  }
+}
+
+void MainChain_Persistent_RecoverFromFile(benchmark::State &state)
+{
+  auto const length = static_cast<std::size_t>(state.range(0));
+
+  BlockGenerator gen{NUM_LANES, NUM_SLICES};
+  auto const     genesis = gen.Generate();
+
+  // build the persistent chain which is recovered on every iteration
+  {
+    MainChain chain{MainChain::Mode::CREATE_PERSISTENT_DB};
+    AddBlocks(chain, GenerateBranch(gen, genesis, length));
+  }
+
+  for (auto _ : state)
+  {
+    MainChain chain{MainChain::Mode::LOAD_PERSISTENT_DB};
+    benchmark::DoNotOptimize(chain.GetHeaviestBlockHash());
+  }
+}
+
 }  // namespace
 
 BENCHMARK(MainChain_InMemory_AddBlocksSequentially);
 BENCHMARK(MainChain_Persistent_AddBlocksSequentially);
 BENCHMARK(MainChain_InMemory_AddBlocksOutOfOrder);
 BENCHMARK(MainChain_Persistent_AddBlocksOutOfOrder);
+BENCHMARK(MainChain_InMemory_SwitchToDeepFork)->Range(16, 1024);
+BENCHMARK(MainChain_InMemory_CompleteLooseBlocks)->Range(1, 256);
+BENCHMARK(MainChain_InMemory_GetPathToCommonAncestor)->Range(16, 4096);
+BENCHMARK(MainChain_Persistent_RecoverFromFile)->Range(512, 8192);
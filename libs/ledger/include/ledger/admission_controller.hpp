@@ -0,0 +1,161 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "core/mutex.hpp"
+#include "crypto/fnv.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * Admission control for transactions submitted to the node
+ *
+ * Each client (originating address) and each signer has a token bucket, refilled at a fixed rate
+ * up to a burst size. A submission is admitted if the client has a token for every transaction
+ * in it, and each transaction then needs a token from the bucket of its signer. This way a flood
+ * from a single client or a single key only throttles that sender.
+ *
+ * The depth of the ingest pipeline (verifier queues and miner backlog) is taken into account as
+ * well. Once the depth passes the shedding threshold the refill rates of all the buckets are
+ * scaled down linearly, reaching zero at the maximum depth, so that the heaviest senders are the
+ * first to be shed. Submissions which would take the depth past the maximum are rejected outright.
+ */
+class AdmissionController
+{
+public:
+  using ConstByteArray = byte_array::ConstByteArray;
+  using Clock          = std::chrono::steady_clock;
+  using Timepoint      = Clock::time_point;
+  using DepthFunction  = std::function<std::size_t()>;
+
+  enum class Decision
+  {
+    ADMITTED,      ///< The transactions can be processed
+    RATE_LIMITED,  ///< The sender has exceeded its rate
+    OVERLOADED,    ///< The ingest pipeline is full
+  };
+
+  struct Config
+  {
+    double      client_rate{2000.0};    ///< Transactions per second for each client
+    double      client_burst{10000.0};  ///< The maximum burst of transactions for each client
+    double      signer_rate{500.0};     ///< Transactions per second for each signer
+    double      signer_burst{2000.0};   ///< The maximum burst of transactions for each signer
+    std::size_t shed_depth{50000};      ///< The depth from which the rates are scaled down
+    std::size_t max_depth{200000};      ///< The depth from which everything is rejected
+  };
+
+  struct Counters
+  {
+    using Counter = std::atomic<uint64_t>;
+
+    Counter admitted{0};             ///< Transactions admitted
+    Counter rate_limited_client{0};  ///< Transactions rejected by the rate of their client
+    Counter rate_limited_signer{0};  ///< Transactions rejected by the rate of their signer
+    Counter overloaded{0};           ///< Transactions rejected because of the pipeline depth
+  };
+
+  // Construction / Destruction
+  explicit AdmissionController(DepthFunction depth);
+  AdmissionController(Config const &config, DepthFunction depth);
+  AdmissionController(AdmissionController const &) = delete;
+  AdmissionController(AdmissionController &&)      = delete;
+  ~AdmissionController()                           = default;
+
+  /// @name Admission
+  /// @{
+  bool     IsOverloaded() const;
+  Decision AdmitClient(ConstByteArray const &client, std::size_t count,
+                       Timepoint const &now = Clock::now());
+  Decision AdmitSigner(ConstByteArray const &signer, Timepoint const &now = Clock::now());
+  /// @}
+
+  /// @name Status
+  /// @{
+  Config const &  config() const;
+  Counters const &counters() const;
+  std::size_t     GetDepth() const;
+  double          GetPressure() const;
+  std::size_t     GetNumClients() const;
+  std::size_t     GetNumSigners() const;
+  /// @}
+
+  // Operators
+  AdmissionController &operator=(AdmissionController const &) = delete;
+  AdmissionController &operator=(AdmissionController &&) = delete;
+
+private:
+  using Mutex = mutex::Mutex;
+
+  struct Bucket
+  {
+    double    tokens{0};
+    Timepoint last_update{};
+  };
+
+  using Buckets = std::unordered_map<ConstByteArray, Bucket>;
+
+  /**
+   * A set of token buckets sharing the same rate and burst size
+   */
+  struct BucketTable
+  {
+    BucketTable(double rate, double burst);
+
+    bool        Take(ConstByteArray const &key, double tokens, double scale, Timepoint const &now);
+    std::size_t size() const;
+
+    double const  rate;
+    double const  burst;
+    mutable Mutex lock{__LINE__, __FILE__};
+    Buckets       buckets{};
+    Timepoint     last_prune{Clock::now()};
+  };
+
+  double Scale(std::size_t depth) const;
+
+  Config const  config_;
+  DepthFunction depth_;
+  BucketTable   clients_;
+  BucketTable   signers_;
+  Counters      counters_{};
+};
+
+char const *ToString(AdmissionController::Decision decision);
+
+inline AdmissionController::Config const &AdmissionController::config() const
+{
+  return config_;
+}
+
+inline AdmissionController::Counters const &AdmissionController::counters() const
+{
+  return counters_;
+}
+
+}  // namespace ledger
+}  // namespace fetch
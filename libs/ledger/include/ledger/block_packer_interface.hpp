@@ -17,8 +17,11 @@
 //
 //------------------------------------------------------------------------------
 
+#include "ledger/chain/mutable_transaction.hpp"
+
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 namespace fetch {
 namespace ledger {
@@ -26,7 +29,6 @@ namespace ledger {
 // forward declarations
 class Block;
 class MainChain;
-struct TransactionSummary;
 
 /**
  * Interface that generalises all mining / block packing algorithms in the system
@@ -34,6 +36,8 @@ struct TransactionSummary;
 class BlockPackerInterface
 {
 public:
+  using TransactionSummaries = std::vector<TransactionSummary>;
+
   // Construction / Destruction
   BlockPackerInterface()          = default;
   virtual ~BlockPackerInterface() = default;
@@ -48,6 +52,20 @@ public:
    */
   virtual void EnqueueTransaction(TransactionSummary const &tx) = 0;
 
+  /**
+   * Add a batch of transactions (summaries) to the internal queue. Packers should override this
+   * to take their locks once for the whole batch.
+   *
+   * @param txs The transactions to be added
+   */
+  virtual void EnqueueTransactions(TransactionSummaries const &txs)
+  {
+    for (auto const &tx : txs)
+    {
+      EnqueueTransaction(tx);
+    }
+  }
+
   /**
    * Generate a new block based on the current queue of transactions
    *
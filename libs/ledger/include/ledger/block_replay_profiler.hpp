@@ -0,0 +1,103 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/chain/block.hpp"
+#include "ledger/executor_interface.hpp"
+#include "ledger/storage_unit/storage_unit_interface.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * Replays a stored block on a fork of the state of its parent and records the cost of each of its
+ * transactions, so that a slow block can be attributed to the transactions and contracts which
+ * were responsible for it.
+ *
+ * The block is run through an ExecutionManager with a single executor, so that the figures of one
+ * transaction are not disturbed by the others, and without state prefetching, so that all the
+ * storage traffic is attributed to the transaction which caused it. The fork is discarded
+ * afterwards, i.e. the state of the storage unit is left untouched. The storage unit must not be
+ * used for anything else while a block is being replayed.
+ *
+ * Smart contracts are run with the instrumenting VM profiler attached, so their wall times include
+ * the cost of counting their instructions.
+ */
+class BlockReplayProfiler
+{
+public:
+  using StorageUnitPtr = std::shared_ptr<StorageUnitInterface>;
+  using Clock          = std::chrono::steady_clock;
+  using Duration       = Clock::duration;
+  using Digest         = Block::Digest;
+  using Status         = ExecutorInterface::Status;
+
+  static constexpr std::size_t DEFAULT_MAX_ENTRIES = 20;
+
+  struct TransactionProfile
+  {
+    Digest      digest{};
+    std::string contract{};
+    std::size_t slice{0};
+    Status      status{Status::NOT_RUN};
+    Duration    wall_time{};
+    uint64_t    storage_calls{0};    ///< The calls which reached the storage unit
+    uint64_t    bytes_read{0};       ///< The size of the state values read
+    uint64_t    bytes_written{0};    ///< The size of the state values written
+    uint64_t    vm_instructions{0};  ///< The VM opcodes executed, zero for native chain code
+  };
+
+  using TransactionProfiles = std::vector<TransactionProfile>;
+
+  struct Report
+  {
+    Digest              block{};
+    uint64_t            block_number{0};
+    Duration            wall_time{};     ///< The time taken by the whole block
+    TransactionProfiles transactions{};  ///< By decreasing wall time
+  };
+
+  // Construction / Destruction
+  explicit BlockReplayProfiler(StorageUnitPtr storage);
+  BlockReplayProfiler(BlockReplayProfiler const &) = delete;
+  BlockReplayProfiler(BlockReplayProfiler &&)      = delete;
+  ~BlockReplayProfiler()                           = default;
+
+  bool Replay(Block const &block, Block const &parent, Report &report);
+
+  static void WriteReport(std::ostream &stream, Report const &report,
+                          std::size_t max_entries = DEFAULT_MAX_ENTRIES);
+
+  // Operators
+  BlockReplayProfiler &operator=(BlockReplayProfiler const &) = delete;
+  BlockReplayProfiler &operator=(BlockReplayProfiler &&) = delete;
+
+private:
+  StorageUnitPtr storage_;
+};
+
+}  // namespace ledger
+}  // namespace fetch
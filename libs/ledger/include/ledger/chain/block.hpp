@@ -25,6 +25,12 @@
 #include <memory>
 
 namespace fetch {
+namespace threading {
+
+class Pool;
+
+}  // namespace threading
+
 namespace ledger {
 
 /**
@@ -69,11 +75,14 @@ public:
   uint64_t weight       = 1;
   uint64_t total_weight = 1;
   bool     is_loose     = false;
+  bool     has_body     = true;  ///< False when only the header is held, e.g. by the main chain
   /// @}
 
   // Helper functions
-  std::size_t GetTransactionCount() const;
-  void        UpdateDigest();
+  std::size_t           GetTransactionCount() const;
+  byte_array::ByteArray GetDigestPrefix(threading::Pool *pool = nullptr) const;
+  Digest                CalculateDigest(threading::Pool *pool = nullptr) const;
+  void                  UpdateDigest();
 };
 
 /**
@@ -23,10 +23,12 @@
 #include "core/threading/synchronised_state.hpp"
 #include "ledger/chain/block.hpp"
 #include "ledger/chain/main_chain.hpp"
+#include "vectorise/threading/pool.hpp"
 
 #include <atomic>
 #include <chrono>
 #include <deque>
+#include <functional>
 #include <thread>
 #include <unordered_set>
 
@@ -37,6 +39,7 @@ class ConsensusMinerInterface;
 }
 
 class TransactionStatusCache;
+class TransactionAddressIndex;
 class BlockPackerInterface;
 class ExecutionManagerInterface;
 class MainChain;
@@ -115,6 +118,11 @@ class BlockSinkInterface;
  *                           │                  │────────────────────────────────┘
  *                           └──────────────────┘
  *
+ * When speculative execution is enabled, a synchronised coordinator with nothing else to do will
+ * execute the strongest competing sibling of the current block on a fork of the state of their
+ * common parent. Should the chain later reorganise onto that block, the changes of the fork are
+ * applied in place of executing it (before post execution validation as normal). Otherwise the
+ * fork is simply dropped.
  */
 class BlockCoordinator
 {
@@ -124,25 +132,30 @@ public:
   using ConstByteArray = byte_array::ConstByteArray;
   using Identity       = ConstByteArray;
 
+  /// Called with the merkle root once the state is settled, or an empty root before it changes
+  using WorldStateCallback = std::function<void(ConstByteArray const &merkle_root)>;
+
   enum class State
   {
-    RELOAD_STATE,                  ///< Recovering previous state
-    SYNCHRONIZING,                 ///< Catch up with the outstanding blocks
-    SYNCHRONIZED,                  ///< Caught up waiting to generate a new block
-    PRE_EXEC_BLOCK_VALIDATION,     ///< Validation stage before block execution
-    WAIT_FOR_TRANSACTIONS,         ///< Halts the state machine until all the block transactions are
-                                   ///< present
-    SCHEDULE_BLOCK_EXECUTION,      ///< Schedule the block to be executed
-    WAIT_FOR_EXECUTION,            ///< Wait for the execution to be completed
-    POST_EXEC_BLOCK_VALIDATION,    ///< Perform final block validation
-    PACK_NEW_BLOCK,                ///< Mine a new block from the head of the chain
-    EXECUTE_NEW_BLOCK,             ///< Schedule the execution of the new block
-    WAIT_FOR_NEW_BLOCK_EXECUTION,  ///< Wait for the new block to be executed
-    PROOF_SEARCH,                  ///< New Block: Waiting until a hash can be found
-    TRANSMIT_BLOCK,                ///< Transmit the new block to
-    RESET                          ///< Cycle complete
+    RELOAD_STATE,                    ///< Recovering previous state
+    SYNCHRONIZING,                   ///< Catch up with the outstanding blocks
+    SYNCHRONIZED,                    ///< Caught up waiting to generate a new block
+    PRE_EXEC_BLOCK_VALIDATION,       ///< Validation stage before block execution
+    WAIT_FOR_TRANSACTIONS,           ///< Halts the state machine until all the block transactions
+                                     ///< are present
+    SCHEDULE_BLOCK_EXECUTION,        ///< Schedule the block to be executed
+    WAIT_FOR_EXECUTION,              ///< Wait for the execution to be completed
+    POST_EXEC_BLOCK_VALIDATION,      ///< Perform final block validation
+    PACK_NEW_BLOCK,                  ///< Mine a new block from the head of the chain
+    EXECUTE_NEW_BLOCK,               ///< Schedule the execution of the new block
+    WAIT_FOR_NEW_BLOCK_EXECUTION,    ///< Wait for the new block to be executed
+    PROOF_SEARCH,                    ///< New Block: Waiting until a hash can be found
+    TRANSMIT_BLOCK,                  ///< Transmit the new block to
+    SCHEDULE_SPECULATIVE_EXECUTION,  ///< Schedule a competing block to be executed on a fork
+    WAIT_FOR_SPECULATIVE_EXECUTION,  ///< Wait for the competing block to be executed
+    RESET                            ///< Cycle complete
   };
-  using StateMachine = core::StateMachine<State>;
+  using StateMachine = core::StateMachine<State, BlockCoordinator>;
 
   // Construction / Destruction
   BlockCoordinator(MainChain &chain, ExecutionManagerInterface &execution_manager,
@@ -157,7 +170,11 @@ public:
   template <typename R, typename P>
   void SetBlockPeriod(std::chrono::duration<R, P> const &period);
   void EnableMining(bool enable = true);
+  void EnableSpeculativeExecution(bool enable = true);
+  void SetAddressIndex(TransactionAddressIndex *address_index);
+  void OnWorldStateChange(WorldStateCallback callback);
   void TriggerBlockGeneration();  // useful in tests
+  void Wake();
 
   std::weak_ptr<core::Runnable> GetWeakRunnable()
   {
@@ -214,10 +231,12 @@ private:
   using Clock             = std::chrono::system_clock;
   using Timepoint         = Clock::time_point;
   using StateMachinePtr   = std::shared_ptr<StateMachine>;
+  using StateHandler      = core::StateHandler<BlockCoordinator, State>;
   using MinerPtr          = std::shared_ptr<consensus::ConsensusMinerInterface>;
   using TxSet             = std::unordered_set<TransactionSummary::TxDigest>;
   using TxSetPtr          = std::unique_ptr<TxSet>;
   using LastExecutedBlock = SynchronisedState<ConstByteArray>;
+  using Pool              = threading::Pool;
 
   /// @name Monitor State
   /// @{
@@ -234,7 +253,30 @@ private:
   State OnWaitForNewBlockExecution();
   State OnProofSearch();
   State OnTransmitBlock();
+  State OnScheduleSpeculativeExecution();
+  State OnWaitForSpeculativeExecution();
   State OnReset();
+
+  // clang-format off
+  static constexpr StateHandler STATE_TABLE[] = {
+      {State::RELOAD_STATE,                   &BlockCoordinator::OnReloadState},
+      {State::SYNCHRONIZING,                  &BlockCoordinator::OnSynchronizing},
+      {State::SYNCHRONIZED,                   &BlockCoordinator::OnSynchronized},
+      {State::PRE_EXEC_BLOCK_VALIDATION,      &BlockCoordinator::OnPreExecBlockValidation},
+      {State::WAIT_FOR_TRANSACTIONS,          &BlockCoordinator::OnWaitForTransactions},
+      {State::SCHEDULE_BLOCK_EXECUTION,       &BlockCoordinator::OnScheduleBlockExecution},
+      {State::WAIT_FOR_EXECUTION,             &BlockCoordinator::OnWaitForExecution},
+      {State::POST_EXEC_BLOCK_VALIDATION,     &BlockCoordinator::OnPostExecBlockValidation},
+      {State::PACK_NEW_BLOCK,                 &BlockCoordinator::OnPackNewBlock},
+      {State::EXECUTE_NEW_BLOCK,              &BlockCoordinator::OnExecuteNewBlock},
+      {State::WAIT_FOR_NEW_BLOCK_EXECUTION,   &BlockCoordinator::OnWaitForNewBlockExecution},
+      {State::PROOF_SEARCH,                   &BlockCoordinator::OnProofSearch},
+      {State::TRANSMIT_BLOCK,                 &BlockCoordinator::OnTransmitBlock},
+      {State::SCHEDULE_SPECULATIVE_EXECUTION, &BlockCoordinator::OnScheduleSpeculativeExecution},
+      {State::WAIT_FOR_SPECULATIVE_EXECUTION, &BlockCoordinator::OnWaitForSpeculativeExecution},
+      {State::RESET,                          &BlockCoordinator::OnReset},
+  };
+  // clang-format on
   /// @}
 
   bool            ScheduleCurrentBlock();
@@ -243,18 +285,25 @@ private:
   ExecutionStatus QueryExecutorStatus();
   void            UpdateNextBlockTime();
   void            UpdateTxStatus(Block const &block);
+  bool            SelectSpeculativeBlock();
+  bool            ApplySpeculativeExecution();
+  bool            ValidateBlockContents(Block const &block);
+  void            NotifyStateUpdate();
+  void            NotifyStateSettled(ConstByteArray const &merkle_root);
 
   static char const *ToString(State state);
   static char const *ToString(ExecutionStatus state);
 
   /// @name External Components
   /// @{
-  MainChain &                chain_;              ///< Ref to system chain
-  ExecutionManagerInterface &execution_manager_;  ///< Ref to system execution manager
-  StorageUnitInterface &     storage_unit_;       ///< Ref to the storage unit
-  BlockPackerInterface &     block_packer_;       ///< Ref to the block packer
-  BlockSinkInterface &       block_sink_;         ///< Ref to the output sink interface
-  TransactionStatusCache &   status_cache_;       ///< Ref to the tx status cache
+  MainChain &                chain_;                   ///< Ref to system chain
+  ExecutionManagerInterface &execution_manager_;       ///< Ref to system execution manager
+  StorageUnitInterface &     storage_unit_;            ///< Ref to the storage unit
+  BlockPackerInterface &     block_packer_;            ///< Ref to the block packer
+  BlockSinkInterface &       block_sink_;              ///< Ref to the output sink interface
+  TransactionStatusCache &   status_cache_;            ///< Ref to the tx status cache
+  TransactionAddressIndex *  address_index_{nullptr};  ///< Optional index of executed txs
+  WorldStateCallback         world_state_callback_{};
   PeriodicAction             periodic_print_;
   MinerPtr                   miner_;
   /// @}
@@ -284,6 +333,18 @@ private:
   PeriodicAction exec_wait_periodic_;  ///< Periodic print for execution
   PeriodicAction syncing_periodic_;
   /// @}
+
+  /// @name Speculative Execution
+  /// @{
+  Flag     speculation_enabled_{false};  ///< Flag to signal if competing blocks are executed
+  BlockPtr speculative_block_{};         ///< The last competing block to be executed
+  bool     speculative_result_{false};   ///< The changes of the competing block are held
+  /// @}
+
+  /// @name Validation
+  /// @{
+  Pool validation_pool_;  ///< Splits the checks of large blocks across cores
+  /// @}
 };
 
 template <typename R, typename P>
@@ -304,5 +365,42 @@ inline void BlockCoordinator::EnableMining(bool enable)
   mining_enabled_ = enable;
 }
 
+inline void BlockCoordinator::EnableSpeculativeExecution(bool enable)
+{
+  speculation_enabled_ = enable;
+}
+
+/**
+ * Set the index which the transactions of every executed block are added to
+ *
+ * @param address_index The address index, or nullptr to disable indexing
+ */
+inline void BlockCoordinator::SetAddressIndex(TransactionAddressIndex *address_index)
+{
+  address_index_ = address_index;
+}
+
+/**
+ * Set the callback which follows the changes of the world state: it is called with an empty root
+ * before the state is modified (by execution, a revert or a fork) and with the merkle root of the
+ * state once it is settled again. Must be set before the coordinator is started.
+ *
+ * @param callback The callback to be invoked from the coordinator thread
+ */
+inline void BlockCoordinator::OnWorldStateChange(WorldStateCallback callback)
+{
+  world_state_callback_ = std::move(callback);
+}
+
+/**
+ * Signal that an event the coordinator may be waiting on has occurred (a block has been added to
+ * the chain or the execution of a block has finished) so that it is re-evaluated immediately rather
+ * than at the end of its current delay
+ */
+inline void BlockCoordinator::Wake()
+{
+  state_machine_->Wake();
+}
+
 }  // namespace ledger
 }  // namespace fetch
@@ -0,0 +1,96 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/chain/block.hpp"
+#include "storage/mmap_random_access_stack.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * The block index is a persistent, memory mapped summary of the blocks that have been written to
+ * the block store. Since the part of the chain that is persisted is always linear, the records are
+ * addressed by block number. Each record stores the hash, previous hash and weights of the block
+ * which means that the consistency of the persisted chain can be checked in constant time rather
+ * than by loading every block back from the block store.
+ *
+ * Records can only be appended if they extend the current head of the index.
+ */
+class BlockIndex
+{
+public:
+  static constexpr char const *LOGGING_NAME = "BlockIndex";
+  static constexpr std::size_t HASH_SIZE    = 32;
+
+  using BlockHash = Block::Digest;
+
+  struct Record
+  {
+    uint8_t  hash[HASH_SIZE];
+    uint8_t  previous_hash[HASH_SIZE];
+    uint64_t block_number;
+    uint64_t weight;
+    uint64_t total_weight;
+
+    BlockHash GetHash() const;
+    BlockHash GetPreviousHash() const;
+  };
+
+  static bool CreateRecord(Block const &block, Record &record);
+
+  // Construction / Destruction
+  BlockIndex()                   = default;
+  BlockIndex(BlockIndex const &) = delete;
+  BlockIndex(BlockIndex &&)      = delete;
+  ~BlockIndex()                  = default;
+
+  /// @name Persistence
+  /// @{
+  void New(std::string const &filename);
+  bool Load(std::string const &filename);
+  void Flush();
+  /// @}
+
+  /// @name Record Access
+  /// @{
+  bool        Get(uint64_t block_number, Record &record);
+  bool        GetHead(Record &record);
+  bool        Append(Record const &record);
+  void        Truncate(uint64_t block_number);
+  std::size_t size() const;
+  /// @}
+
+  // Operators
+  BlockIndex &operator=(BlockIndex const &) = delete;
+  BlockIndex &operator=(BlockIndex &&) = delete;
+
+private:
+  static constexpr uint64_t VERSION = 1;
+
+  using Stack = storage::MMapRandomAccessStack<Record>;
+
+  Stack stack_;
+};
+
+}  // namespace ledger
+}  // namespace fetch
@@ -18,6 +18,7 @@
 //------------------------------------------------------------------------------
 
 #include "ledger/chain/consensus/consensus_miner_interface.hpp"
+#include "ledger/chain/consensus/proof_of_work_search.hpp"
 
 namespace fetch {
 namespace ledger {
@@ -41,6 +42,9 @@ public:
   // Operators
   DummyMiner &operator=(DummyMiner const &) = delete;
   DummyMiner &operator=(DummyMiner &&) = delete;
+
+private:
+  ProofOfWorkSearch search_{};
 };
 }  // namespace consensus
 }  // namespace ledger
@@ -19,6 +19,7 @@
 
 #include "core/byte_array/const_byte_array.hpp"
 #include "math/bignumber.hpp"
+#include "math/uint256.hpp"
 
 namespace fetch {
 namespace ledger {
@@ -46,8 +47,12 @@ public:
   math::BigUnsigned const &target() const;
 
 private:
+  void UpdateFastTarget();
+
   math::BigUnsigned          digest_;
   math::BigUnsigned          target_;
+  math::UInt256              fast_target_{};            ///< The target as a fixed width value
+  bool                       unbounded_target_{false};  ///< The target exceeds all 256-bit digests
   byte_array::ConstByteArray header_;
 };
 
@@ -0,0 +1,68 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fetch {
+namespace ledger {
+
+class Block;
+
+namespace consensus {
+
+/**
+ * Searches a range of nonces for one which satisfies the proof of work of a block.
+ *
+ * The fields of the block covered by its hash (including the root of the transaction merkle tree)
+ * are serialized and hashed once, and each candidate nonce only finishes the hash from that
+ * midstate. The two hashes of the proof itself are then calculated for a batch of candidates at a
+ * time with the multi-buffer SHA-256, and compared against the target as 64-bit words. Large
+ * ranges are split between a number of threads.
+ */
+class ProofOfWorkSearch
+{
+public:
+  static constexpr std::size_t BATCH_SIZE                = 8;
+  static constexpr uint64_t    MIN_ITERATIONS_PER_THREAD = 4096;
+
+  // Construction / Destruction
+  explicit ProofOfWorkSearch(std::size_t num_threads = 0);
+  ProofOfWorkSearch(ProofOfWorkSearch const &) = delete;
+  ProofOfWorkSearch(ProofOfWorkSearch &&)      = delete;
+  ~ProofOfWorkSearch()                         = default;
+
+  bool Search(Block &block, uint64_t start_nonce, uint64_t iterations) const;
+
+  std::size_t num_threads() const
+  {
+    return num_threads_;
+  }
+
+  // Operators
+  ProofOfWorkSearch &operator=(ProofOfWorkSearch const &) = delete;
+  ProofOfWorkSearch &operator=(ProofOfWorkSearch &&) = delete;
+
+private:
+  std::size_t const num_threads_;
+};
+
+}  // namespace consensus
+}  // namespace ledger
+}  // namespace fetch
@@ -22,14 +22,18 @@
 #include "core/mutex.hpp"
 #include "crypto/fnv.hpp"
 #include "ledger/chain/block.hpp"
+#include "ledger/chain/block_index.hpp"
 #include "ledger/chain/consensus/proof_of_work.hpp"
 #include "ledger/chain/constants.hpp"
 #include "ledger/chain/transaction.hpp"
+#include "ledger/chain/transaction_filter.hpp"
 #include "network/generics/milli_timer.hpp"
 #include "storage/object_store.hpp"
 #include "storage/resource_mapper.hpp"
 
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -79,6 +83,7 @@ public:
   using BlockHash    = Block::Digest;
   using BlockHashs   = std::vector<BlockHash>;
   using BlockHashSet = std::unordered_set<BlockHash>;
+  using AddCallback  = std::function<void()>;
 
   static constexpr char const *LOGGING_NAME = "MainChain";
   static constexpr uint64_t    ALL          = std::numeric_limits<uint64_t>::max();
@@ -126,6 +131,17 @@ public:
   bool         HasMissingBlocks() const;
   /// @}
 
+  /**
+   * Configure the callback triggered each time a (non loose) block is added to the chain. Must be
+   * configured before any blocks are added.
+   *
+   * @param cb The callback to be triggered
+   */
+  void OnBlockAdded(AddCallback cb)
+  {
+    add_callback_ = std::move(cb);
+  }
+
   template <typename T>
   bool StripAlreadySeenTx(BlockHash starting_hash, T &container) const;
 
@@ -138,10 +154,14 @@ private:
   using BlockMap      = std::unordered_map<BlockHash, IntBlockPtr>;
   using Proof         = Block::Proof;
   using TipsMap       = std::unordered_map<BlockHash, Tip>;
+  using TipRank       = std::pair<uint64_t, BlockHash>;  ///< (total weight, hash)
+  using TipRanking    = std::set<TipRank>;
   using BlockHashList = std::list<BlockHash>;
   using LooseBlockMap = std::unordered_map<BlockHash, BlockHashList>;
   using BlockStore    = fetch::storage::ObjectStore<Block>;
   using BlockStorePtr = std::unique_ptr<BlockStore>;
+  using BlockIndexPtr = std::unique_ptr<BlockIndex>;
+  using IntBlockPtrs  = std::vector<IntBlockPtr>;
   using RMutex        = std::recursive_mutex;
   using RLock         = std::unique_lock<RMutex>;
 
@@ -156,9 +176,13 @@ private:
   /// @name Persistence Management
   /// @{
   void RecoverFromFile(Mode mode);
+  bool RecoverFromIndex(Block const &head);
+  bool RecoverByWalkingChain(Block const &head);
   void WriteToFile();
+  void UpdateIndex(IntBlockPtrs const &written_blocks);
   void TrimCache();
   void FlushBlock(IntBlockPtr const &block);
+  void ReleaseBodies(IntBlockPtrs const &written_blocks);
   /// @}
 
   /// @name Loose Blocks
@@ -171,6 +195,7 @@ private:
   /// @{
   BlockStatus InsertBlock(IntBlockPtr const &block, bool evaluate_loose_blocks = true);
   bool        LookupBlock(BlockHash hash, IntBlockPtr &block, bool add_to_cache = false) const;
+  bool        LookupFullBlock(BlockHash hash, IntBlockPtr &block) const;
   bool        LookupBlockFromCache(BlockHash hash, IntBlockPtr &block) const;
   bool        LookupBlockFromStorage(BlockHash hash, IntBlockPtr &block, bool add_to_cache) const;
   bool        IsBlockInCache(BlockHash hash) const;
@@ -182,21 +207,30 @@ private:
   bool AddTip(IntBlockPtr const &block);
   bool UpdateTips(IntBlockPtr const &block);
   bool DetermineHeaviestTip();
+  void SetTip(BlockHash const &hash, uint64_t total_weight);
+  void RemoveTip(BlockHash const &hash);
   /// @}
 
   static IntBlockPtr CreateGenesisBlock();
+  static IntBlockPtr CreateHeader(Block const &block);
 
   BlockHash GetHeadHash();
   void      SetHeadHash(BlockHash const &hash);
 
   BlockStorePtr block_store_;  /// < Long term storage and backup
+  BlockIndexPtr block_index_;  /// < Persistent index of the blocks in the block store
   std::fstream  head_store_;
 
   mutable RMutex   lock_;          ///< Mutex protecting block_chain_, tips_ & heaviest_
-  mutable BlockMap block_chain_;   ///< All recent blocks are kept in memory
+  mutable BlockMap block_chain_;   ///< All recent blocks (only headers once stored) in memory
   TipsMap          tips_;          ///< Keep track of the tips
+  TipRanking       tip_ranking_;   ///< The tips ordered by total weight (heaviest last)
   HeaviestTip      heaviest_;      ///< Heaviest block/tip
   LooseBlockMap    loose_blocks_;  ///< Waiting (loose) blocks
+  AddCallback      add_callback_;  ///< Triggered when a block is added to the chain
+
+  mutable TransactionFilter tx_filter_;           ///< Filter of the transactions in the chain
+  mutable uint64_t          tx_filter_floor_{0};  ///< Blocks below this are not in the filter
 };
 
 /**
@@ -219,7 +253,7 @@ bool MainChain::StripAlreadySeenTx(BlockHash starting_hash, T &container) const
   auto const  start_time     = Clock::now();
 
   IntBlockPtr block;
-  if (!LookupBlock(starting_hash, block, false) || block->is_loose)
+  if (!LookupFullBlock(starting_hash, block) || block->is_loose)
   {
     FETCH_LOG_WARN(LOGGING_NAME, "TX uniqueness verify on bad block hash");
     return false;
@@ -229,15 +263,44 @@ bool MainChain::StripAlreadySeenTx(BlockHash starting_hash, T &container) const
   std::set<TransactionSummary>    transactions_to_check;
   std::vector<TransactionSummary> transactions_duplicated;
 
-  for (auto const &tx : container)
+  // Use the transaction filter to discard all the transactions which have definitely not been
+  // seen. Additionally, determine the lowest block which needs to be checked for the remainder
+  uint64_t lowest_block_number = ALL;
+  uint64_t filter_floor{0};
+
   {
-    transactions_to_check.insert(tx.transaction);
+    FETCH_LOCK(lock_);
+    filter_floor = tx_filter_floor_;
+
+    for (auto const &tx : container)
+    {
+      uint64_t earliest_block_number{0};
+
+      if (filter_floor > 0)
+      {
+        // part of the chain is not covered by the filter so all transactions must be checked
+        transactions_to_check.insert(tx.transaction);
+        lowest_block_number = 0;
+      }
+      else if (tx_filter_.Query(tx.transaction.transaction_hash, earliest_block_number))
+      {
+        transactions_to_check.insert(tx.transaction);
+        lowest_block_number = std::min(lowest_block_number, earliest_block_number);
+      }
+    }
   }
 
-  for (;;)
+  while (!transactions_to_check.empty() && (block->body.block_number >= lowest_block_number))
   {
     ++blocks_checked;
 
+    // blocks which are not covered by the filter are added to it as they are encountered
+    if (block->body.block_number < filter_floor)
+    {
+      FETCH_LOCK(lock_);
+      tx_filter_.Add(*block);
+    }
+
     for (auto const &slice : block->body.slices)
     {
       for (auto const &tx : slice)
@@ -252,8 +315,16 @@ bool MainChain::StripAlreadySeenTx(BlockHash starting_hash, T &container) const
       }
     }
 
+    // once the complete history has been walked the filter covers the whole chain
+    if (block->body.block_number == 0)
+    {
+      FETCH_LOCK(lock_);
+      tx_filter_floor_ = 0;
+      break;
+    }
+
     // exit the loop once we can no longer find the block
-    if (!LookupBlock(block->body.previous_hash, block, false))
+    if (!LookupFullBlock(block->body.previous_hash, block))
     {
       break;
     }
@@ -101,6 +101,22 @@ public:
     return ret;
   }
 
+  /**
+   * Create a verified transaction from a mutable transaction whose signatures have already been
+   * checked by the caller (for example as part of a batch verification). No signature checks are
+   * performed by this function.
+   *
+   * @param trans The mutable transaction which has already been verified
+   * @return The verified transaction
+   */
+  static VerifiedTransaction CreatePreVerified(fetch::ledger::MutableTransaction const &trans)
+  {
+    VerifiedTransaction ret;
+    ret = trans;
+    ret.UpdateDigest();
+    return ret;
+  }
+
   static VerifiedTransaction Create(UnverifiedTransaction &&trans)
   {
     return VerifiedTransaction::Create(trans);
@@ -0,0 +1,82 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/chain/block.hpp"
+#include "ledger/chain/mutable_transaction.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * Probabilistic filter of the transactions that have been included in blocks.
+ *
+ * The filter is split into windows of consecutive block heights, each with its own Bloom filter.
+ * A negative query result guarantees that the transaction has not been seen in any of the blocks
+ * added to the filter, while a positive result additionally reports the lowest block height at
+ * which the transaction might have been included. This allows searches of the block history to be
+ * avoided entirely in the common case and, otherwise, to be limited in depth.
+ */
+class TransactionFilter
+{
+public:
+  using Digest = TransactionSummary::TxDigest;
+
+  static constexpr uint64_t    WINDOW_SIZE     = 10000;    ///< Block heights per window
+  static constexpr std::size_t BITS_PER_WINDOW = 1u << 20;  ///< The size of each bloom filter
+  static constexpr std::size_t NUM_HASHES      = 4;
+
+  // Construction / Destruction
+  TransactionFilter()                          = default;
+  TransactionFilter(TransactionFilter const &) = delete;
+  TransactionFilter(TransactionFilter &&)      = delete;
+  ~TransactionFilter()                         = default;
+
+  /// @name Filter Updates
+  /// @{
+  void Add(Block const &block);
+  void Add(Digest const &digest, uint64_t block_number);
+  /// @}
+
+  /// @name Filter Queries
+  /// @{
+  bool        Query(Digest const &digest, uint64_t &earliest_block_number) const;
+  std::size_t num_windows() const;
+  /// @}
+
+  // Operators
+  TransactionFilter &operator=(TransactionFilter const &) = delete;
+  TransactionFilter &operator=(TransactionFilter &&) = delete;
+
+private:
+  using Word    = uint64_t;
+  using Window  = std::vector<Word>;
+  using Windows = std::map<uint64_t, Window>;  ///< Window index -> bloom filter
+
+  static constexpr std::size_t BITS_PER_WORD = sizeof(Word) * 8u;
+
+  Windows windows_;
+};
+
+}  // namespace ledger
+}  // namespace fetch
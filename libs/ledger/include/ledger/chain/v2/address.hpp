@@ -75,6 +75,8 @@ public:
   Address(Address &&)      = default;
   ~Address()               = default;
 
+  static Address FromRawBytes(ConstByteArray raw_address);
+
   /// @name Accessors
   /// @{
   ConstByteArray address() const;
@@ -90,7 +92,6 @@ public:
 
 private:
   ConstByteArray address_;  ///< The address representation
-  ConstByteArray display_;  ///< The display representation
 };
 
 /**
@@ -103,16 +104,6 @@ inline Address::ConstByteArray Address::address() const
   return address_;
 }
 
-/**
- * Get the raw bytes of the display variant of the address (with checksum)
- *
- * @return The display address
- */
-inline Address::ConstByteArray Address::display() const
-{
-  return display_;
-}
-
 /**
  * Equality operator for the address
  *
@@ -158,6 +158,7 @@ private:
   /// @name Metadata
   /// @{
   ConstByteArray digest_{};                       ///< The digest of the transaction
+  ConstByteArray payload_{};                      ///< The cached serialized payload (when known)
   bool           verification_completed_{false};  ///< Signal that the verification has been done
   bool           verified_{false};                ///< The cached result of the verification
   /// @}
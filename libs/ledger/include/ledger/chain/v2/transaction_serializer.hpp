@@ -19,6 +19,8 @@
 
 #include "core/byte_array/byte_array.hpp"
 
+#include <cstddef>
+
 namespace fetch {
 namespace ledger {
 namespace v2 {
@@ -57,6 +59,7 @@ public:
   /// @{
   bool Serialize(Transaction const &tx);
   bool Deserialize(Transaction &tx) const;
+  bool Deserialize(Transaction &tx, std::size_t &consumed) const;
 
   // Operators (throw on error)
   TransactionSerializer &operator<<(Transaction const &tx);
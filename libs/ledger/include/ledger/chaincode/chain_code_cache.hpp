@@ -20,57 +20,71 @@
 #include "crypto/fnv.hpp"  // needed for std::hash<ConstByteArray>
 #include "ledger/chaincode/factory.hpp"
 #include "ledger/identifier.hpp"
-#include "meta/is_log2.hpp"
 
-#include <algorithm>
-#include <chrono>
+#include <cstddef>
+#include <list>
 #include <unordered_map>
-#include <utility>
 
 namespace fetch {
 namespace ledger {
 
+/**
+ * Per executor cache of chain code instances.
+ *
+ * The instances are lightweight handles, the compiled scripts of smart contracts are shared
+ * between all the executors through the process wide CompiledScriptCache. The cache is bounded in
+ * size and the least recently used instance is evicted when it is full.
+ */
 class ChainCodeCache
 {
 public:
   using ContractPtr = ChainCodeFactory::ContractPtr;
   using StoragePtr  = ledger::StorageInterface;
 
+  static constexpr std::size_t DEFAULT_CAPACITY = 32;
+
+  // Construction / Destruction
+  explicit ChainCodeCache(std::size_t capacity = DEFAULT_CAPACITY);
+  ChainCodeCache(ChainCodeCache const &) = delete;
+  ChainCodeCache(ChainCodeCache &&)      = delete;
+  ~ChainCodeCache()                      = default;
+
   ContractPtr Lookup(Identifier const &contract_id, StorageInterface &storage);
 
+  std::size_t size() const
+  {
+    return cache_.size();
+  }
+
   ChainCodeFactory const &factory() const
   {
     return factory_;
   }
 
+  // Operators
+  ChainCodeCache &operator=(ChainCodeCache const &) = delete;
+  ChainCodeCache &operator=(ChainCodeCache &&) = delete;
+
 private:
-  using Clock     = std::chrono::high_resolution_clock;
-  using Timepoint = Clock::time_point;
+  using ConstByteArray = byte_array::ConstByteArray;
+  using RecentList     = std::list<ConstByteArray>;
 
   struct Element
   {
-    explicit Element(ContractPtr c)
-      : chain_code{std::move(c)}
-    {}
-
-    ContractPtr chain_code;
-    Timepoint   timestamp{Clock::now()};
+    ContractPtr          chain_code;
+    RecentList::iterator recent;
   };
 
-  using UnderlyingCache = std::unordered_map<byte_array::ConstByteArray, Element>;
-
-  static constexpr uint64_t CLEANUP_PERIOD = 16;
-  static constexpr uint64_t CLEANUP_MASK   = CLEANUP_PERIOD - 1u;
+  using UnderlyingCache = std::unordered_map<ConstByteArray, Element>;
 
   // Utils
   ContractPtr FindInCache(Identifier const &name);
-  void        RunMaintenance();
-
-  std::size_t      counter_;
-  UnderlyingCache  cache_;
-  ChainCodeFactory factory_;
+  void        AddToCache(Identifier const &name, ContractPtr const &contract);
 
-  static_assert(meta::IsLog2<CLEANUP_PERIOD>::value, "Clean up period must be a valid power of 2");
+  std::size_t const capacity_;
+  UnderlyingCache   cache_;   ///< The cached instances
+  RecentList        recent_;  ///< The names of the cached instances, most recently used first
+  ChainCodeFactory  factory_;
 };
 
 }  // namespace ledger
@@ -0,0 +1,121 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "core/mutex.hpp"
+#include "crypto/fnv.hpp"  // needed for std::hash<ConstByteArray>
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace fetch {
+
+namespace vm {
+struct Script;
+class Module;
+}  // namespace vm
+
+namespace ledger {
+
+/**
+ * Process wide, content addressed cache of compiled smart contract scripts.
+ *
+ * Scripts are keyed by the digest of the contract source combined with the layout of the VM module
+ * they were compiled against, so the cache can be shared by all of the executors. The most recently
+ * used scripts are kept in memory, and once a backing store has been loaded every compiled script
+ * is also persisted so that it survives restarts.
+ */
+class CompiledScriptCache
+{
+public:
+  using ConstByteArray = byte_array::ConstByteArray;
+  using ScriptPtr      = std::shared_ptr<vm::Script>;
+
+  static constexpr char const *LOGGING_NAME     = "CompiledScriptCache";
+  static constexpr std::size_t DEFAULT_CAPACITY = 256;
+
+  /// The version of the serialised script format, part of every key
+  static constexpr uint32_t FORMAT_VERSION = 1;
+
+  struct Counters
+  {
+    std::size_t hits{0};        ///< Lookups served from memory
+    std::size_t store_hits{0};  ///< Lookups served from the backing store
+    std::size_t misses{0};      ///< Lookups which required compilation
+  };
+
+  static CompiledScriptCache &Instance();
+
+  // Construction / Destruction
+  explicit CompiledScriptCache(std::size_t capacity = DEFAULT_CAPACITY);
+  CompiledScriptCache(CompiledScriptCache const &) = delete;
+  CompiledScriptCache(CompiledScriptCache &&)      = delete;
+  ~CompiledScriptCache();
+
+  /// @name Persistence
+  /// @{
+  void Load(std::string const &doc_file, std::string const &index_file);
+  bool is_persistent() const;
+  /// @}
+
+  /// @name Cache Access
+  /// @{
+  static ConstByteArray CreateKey(ConstByteArray const &source_digest, vm::Module const &module);
+
+  ScriptPtr Lookup(ConstByteArray const &key);
+  void      Add(ConstByteArray const &key, ScriptPtr const &script);
+  /// @}
+
+  std::size_t size() const;
+  Counters    counters() const;
+
+  // Operators
+  CompiledScriptCache &operator=(CompiledScriptCache const &) = delete;
+  CompiledScriptCache &operator=(CompiledScriptCache &&) = delete;
+
+private:
+  class BackingStore;
+
+  using Mutex           = mutex::Mutex;
+  using BackingStorePtr = std::unique_ptr<BackingStore>;
+  using RecentList      = std::list<ConstByteArray>;
+
+  struct Entry
+  {
+    ScriptPtr            script;
+    RecentList::iterator recent;
+  };
+
+  using Entries = std::unordered_map<ConstByteArray, Entry>;
+
+  void AddToMemory(ConstByteArray const &key, ScriptPtr const &script);
+
+  std::size_t const capacity_;
+  mutable Mutex     lock_{__LINE__, __FILE__};
+  Entries           entries_;  ///< The in memory scripts
+  RecentList        recent_;   ///< The keys of the in memory scripts, most recently used first
+  BackingStorePtr   store_;    ///< The optional persistent store
+  Counters          counters_;
+};
+
+}  // namespace ledger
+}  // namespace fetch
@@ -36,6 +36,9 @@ namespace fetch {
 namespace variant {
 class Variant;
 }
+namespace vm {
+class Profiler;
+}
 namespace ledger {
 
 /**
@@ -77,6 +80,7 @@ public:
   /// @{
   void Attach(ledger::StateAdapter &state);
   void Detach();
+  void SetProfiler(vm::Profiler *profiler);
 
   Status DispatchInitialise(Identity const &owner);
   Status DispatchQuery(ContractName const &name, Query const &query, Query &response);
@@ -117,7 +121,7 @@ protected:
 
   /// @name Chain Code State Utils
   /// @{
-  bool ParseAsJson(Transaction const &tx, variant::Variant &output);
+  static bool ParseAsJson(Transaction const &tx, variant::Variant &output);
 
   template <typename T>
   bool GetStateRecord(T &record, ConstByteArray const &key);
@@ -125,6 +129,7 @@ protected:
   void SetStateRecord(T const &record, ConstByteArray const &key);
 
   ledger::StateAdapter &state();
+  vm::Profiler *        profiler() const;
   /// @}
 
 private:
@@ -144,7 +149,8 @@ private:
 
   /// @name State
   /// @{
-  ledger::StateAdapter *state_ = nullptr;
+  ledger::StateAdapter *state_    = nullptr;
+  vm::Profiler *        profiler_ = nullptr;  ///< Records the VM instructions executed, if set
   /// @}
 };
 
@@ -166,6 +172,17 @@ inline void Contract::Detach()
   state_ = nullptr;
 }
 
+/**
+ * Attach a profiler which records the VM instructions executed by the following transactions.
+ * Only smart contracts run on the VM, the profiler is ignored by native chain code.
+ *
+ * @param profiler The profiler, or nullptr to stop profiling
+ */
+inline void Contract::SetProfiler(vm::Profiler *profiler)
+{
+  profiler_ = profiler;
+}
+
 /**
  * Query Handler Map Accessor
  *
@@ -243,26 +260,11 @@ void Contract::OnQuery(std::string const &name, C *instance,
 template <typename T>
 bool Contract::GetStateRecord(T &record, ConstByteArray const &key)
 {
-  using fetch::byte_array::ByteArray;
-
   bool success{false};
 
-  ByteArray buffer;
-  buffer.Resize(std::size_t{DEFAULT_BUFFER_SIZE});  // initial guess, can be tuned over time
-
-  uint64_t buffer_length = buffer.size();
-  auto     status        = state().Read(std::string{key}, buffer.pointer(), buffer_length);
-
-  // in rare cases the initial buffer might be too small in this case we need to reallocate and then
-  // re-query
-  if (vm::IoObserverInterface::Status::BUFFER_TOO_SMALL == status)
-  {
-    // reallocate the buffer
-    buffer.Resize(buffer_length);
-
-    // retry the read
-    status = state().Read(std::string{key}, buffer.pointer(), buffer_length);
-  }
+  // the record is deserialized directly from the buffer held by the state
+  ConstByteArray buffer;
+  auto const     status = state().ReadView(std::string{key}, buffer);
 
   switch (status)
   {
@@ -300,11 +302,8 @@ void Contract::SetStateRecord(T const &record, ConstByteArray const &key)
   serializers::ByteArrayBuffer buffer;
   buffer << record;
 
-  // lookup reference to the underlying buffer
-  auto const &data = buffer.data();
-
-  // store the buffer
-  state().Write(std::string{key}, data.pointer(), data.size());
+  // hand the serialized buffer over to the state without copying it
+  state().WriteView(std::string{key}, buffer.data());
 }
 
 }  // namespace ledger
@@ -0,0 +1,106 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "core/mutex.hpp"
+#include "crypto/fnv.hpp"  // needed for std::hash<ConstByteArray>
+#include "network/details/thread_pool.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace fetch {
+
+namespace vm {
+struct Script;
+class Module;
+}  // namespace vm
+
+namespace ledger {
+
+class CompiledScriptCache;
+
+/**
+ * Compiles smart contract sources on a pool of worker threads.
+ *
+ * Contracts which are known to be needed soon, for example the ones deployed by a block which is
+ * about to be executed, can be submitted ahead of time. The first execution of the contract then
+ * only waits for the compilation which is already in flight, rather than compiling it serially on
+ * the executing thread. The compiled scripts are shared through the compiled script cache.
+ */
+class ContractCompiler
+{
+public:
+  using ConstByteArray = byte_array::ConstByteArray;
+  using ScriptPtr      = std::shared_ptr<vm::Script>;
+  using ModulePtr      = std::shared_ptr<vm::Module>;
+
+  static constexpr char const *LOGGING_NAME        = "ContractCompiler";
+  static constexpr std::size_t DEFAULT_NUM_THREADS = 4;
+
+  static ContractCompiler &Instance();
+
+  // Construction / Destruction
+  explicit ContractCompiler(CompiledScriptCache &cache,
+                            std::size_t          num_threads = DEFAULT_NUM_THREADS);
+  ContractCompiler(ContractCompiler const &) = delete;
+  ContractCompiler(ContractCompiler &&)      = delete;
+  ~ContractCompiler();
+
+  /// @name Compilation
+  /// @{
+  bool      Submit(std::string const &source);
+  ScriptPtr Compile(std::string const &source, ConstByteArray const &digest,
+                    ModulePtr const &module);
+  /// @}
+
+  std::size_t pending() const;
+  std::size_t submitted() const
+  {
+    return submitted_;
+  }
+
+  // Operators
+  ContractCompiler &operator=(ContractCompiler const &) = delete;
+  ContractCompiler &operator=(ContractCompiler &&) = delete;
+
+private:
+  using Mutex      = mutex::Mutex;
+  using Result     = std::shared_future<ScriptPtr>;
+  using Pending    = std::unordered_map<ConstByteArray, Result>;
+  using ThreadPool = network::ThreadPool;
+  using Counter    = std::atomic<std::size_t>;
+
+  ScriptPtr CompileScript(ConstByteArray const &key, std::string const &source,
+                          ModulePtr const &module);
+
+  CompiledScriptCache &cache_;
+  ModulePtr            module_;  ///< The module used for compilations submitted ahead of time
+  mutable Mutex        lock_{__LINE__, __FILE__};
+  Pending              pending_;  ///< The compilation results which are still in flight
+  Counter              submitted_{0};
+  ThreadPool           pool_;
+};
+
+}  // namespace ledger
+}  // namespace fetch
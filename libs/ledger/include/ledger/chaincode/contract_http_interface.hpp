@@ -19,10 +19,13 @@
 
 #include "core/mutex.hpp"
 #include "http/module.hpp"
+#include "ledger/admission_controller.hpp"
+#include "ledger/chain/v2/transaction.hpp"
 #include "ledger/chaincode/chain_code_cache.hpp"
 
 #include <algorithm>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <sstream>
 #include <vector>
@@ -35,6 +38,7 @@ class Variant;
 
 namespace ledger {
 
+class QueryResultCache;
 class StorageInterface;
 class TransactionProcessor;
 
@@ -42,22 +46,43 @@ class ContractHttpInterface : public http::HTTPModule
 {
 
 public:
+  using V2TransactionList    = std::vector<v2::Transaction>;
+  using V2TransactionHandler = std::function<void(V2TransactionList &&)>;
+
   static constexpr char const *LOGGING_NAME = "ContractHttpInterface";
 
   // Construction / Destruction
-  ContractHttpInterface(StorageInterface &storage, TransactionProcessor &processor);
+  ContractHttpInterface(StorageInterface &storage, TransactionProcessor &processor,
+                        QueryResultCache *query_cache = nullptr);
   ContractHttpInterface(ContractHttpInterface const &) = delete;
   ContractHttpInterface(ContractHttpInterface &&)      = delete;
   ~ContractHttpInterface()                             = default;
 
+  /**
+   * Accept binary (application/octet-stream) v2 transactions, which are passed to the handler once
+   * their signatures have been verified. Without a handler they are rejected.
+   *
+   * @param handler The consumer of the verified transactions
+   */
+  void SetV2TransactionHandler(V2TransactionHandler handler)
+  {
+    v2_handler_ = std::move(handler);
+  }
+
   // Operators
   ContractHttpInterface &operator=(ContractHttpInterface const &) = delete;
   ContractHttpInterface &operator=(ContractHttpInterface &&) = delete;
 
+  AdmissionController &admission()
+  {
+    return admission_;
+  }
+
 private:
   using Mutex          = mutex::Mutex;
   using ConstByteArray = byte_array::ConstByteArray;
   using TxHashes       = std::vector<ConstByteArray>;
+  using Decision       = AdmissionController::Decision;
 
   /**
    * Structure containing status of of multi-transaction submission.
@@ -72,11 +97,13 @@ private:
    *
    * @see SubmitJsonTx
    * @see SubmitNativeTx
+   * @see SubmitBinaryTx
    */
   struct SubmitTxStatus
   {
     std::size_t processed{0};
     std::size_t received{0};
+    Decision    decision{Decision::ADMITTED};  ///< Set when transactions were not admitted
   };
 
   /// @name Query Handler
@@ -92,6 +119,14 @@ private:
                                   TxHashes &txs);
   SubmitTxStatus     SubmitNativeTx(http::HTTPRequest const &req, ConstByteArray expected_contract,
                                     TxHashes &txs);
+  SubmitTxStatus     SubmitBinaryTx(http::HTTPRequest const &req, ConstByteArray expected_contract,
+                                    TxHashes &txs);
+  /// @}
+
+  /// @name Admission Control
+  /// @{
+  template <typename TxList>
+  void Admit(http::HTTPRequest const &request, TxList &batch, SubmitTxStatus &status);
   /// @}
 
   /// @name Access Log
@@ -105,9 +140,12 @@ private:
 
   StorageInterface &    storage_;
   TransactionProcessor &processor_;
+  QueryResultCache *    query_cache_;  ///< Optional cache of the query results
   ChainCodeCache        contract_cache_{};
   Mutex                 access_log_lock_{__LINE__, __FILE__};
   std::ofstream         access_log_;
+  V2TransactionHandler  v2_handler_;
+  AdmissionController   admission_;
 };
 
 }  // namespace ledger
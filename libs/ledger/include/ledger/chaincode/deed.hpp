@@ -65,7 +65,10 @@ private:
   friend void Deserialize(T &serializer, Deed &b)
   {
     serializer >> b.signees_ >> b.operation_thresholds_;
+    b.UpdateFullWeight();
   }
+
+  void UpdateFullWeight();
 };
 
 }  // namespace ledger
@@ -0,0 +1,125 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "core/mutex.hpp"
+#include "crypto/fnv.hpp"  // needed for std::hash<ConstByteArray>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * Cache of the results of read-only contract queries.
+ *
+ * Results are keyed by the contract, the query, its arguments and the state they were computed
+ * from. Only the results computed from the current state are kept: the whole cache is dropped
+ * whenever the state is committed to a new root, and nothing is cached while the state is being
+ * modified (a block is being executed or the state is being reverted).
+ *
+ * A query which started before the state changed must not populate the cache with its result,
+ * so each lookup returns the generation of the cache, which the insertion must match.
+ *
+ * The cache is bounded both in the number of results and in their total size, the least recently
+ * used results being evicted first.
+ */
+class QueryResultCache
+{
+public:
+  using ConstByteArray = byte_array::ConstByteArray;
+  using Generation     = uint64_t;
+
+  static constexpr std::size_t DEFAULT_MAX_ENTRIES = 10000;
+  static constexpr std::size_t DEFAULT_MAX_BYTES   = 16 * 1024 * 1024;
+
+  struct Counters
+  {
+    uint64_t hits{0};
+    uint64_t misses{0};
+    uint64_t evictions{0};
+    uint64_t invalidations{0};
+  };
+
+  // Construction / Destruction
+  explicit QueryResultCache(std::size_t max_entries = DEFAULT_MAX_ENTRIES,
+                            std::size_t max_bytes   = DEFAULT_MAX_BYTES);
+  QueryResultCache(QueryResultCache const &) = delete;
+  QueryResultCache(QueryResultCache &&)      = delete;
+  ~QueryResultCache()                        = default;
+
+  /// @name State Changes
+  /// @{
+  void SetState(ConstByteArray const &state_root);
+  void BeginStateUpdate();
+  /// @}
+
+  /// @name Results
+  /// @{
+  bool Lookup(ConstByteArray const &contract, ConstByteArray const &query,
+              ConstByteArray const &args, ConstByteArray &result, Generation &generation);
+  bool Insert(ConstByteArray const &contract, ConstByteArray const &query,
+              ConstByteArray const &args, ConstByteArray const &result, Generation generation);
+  /// @}
+
+  /// @name Status
+  /// @{
+  ConstByteArray state() const;
+  std::size_t    size() const;
+  std::size_t    bytes() const;
+  Counters       counters() const;
+  /// @}
+
+  // Operators
+  QueryResultCache &operator=(QueryResultCache const &) = delete;
+  QueryResultCache &operator=(QueryResultCache &&) = delete;
+
+private:
+  using Mutex      = mutex::Mutex;
+  using RecentList = std::list<ConstByteArray>;
+
+  struct Element
+  {
+    ConstByteArray       result;
+    RecentList::iterator recent;
+  };
+
+  using Results = std::unordered_map<ConstByteArray, Element>;
+
+  static ConstByteArray Key(ConstByteArray const &contract, ConstByteArray const &query,
+                            ConstByteArray const &args);
+
+  void ClearLocked();
+
+  std::size_t const max_entries_;
+  std::size_t const max_bytes_;
+  mutable Mutex     lock_{__LINE__, __FILE__};
+  ConstByteArray    state_;          ///< The state root of the results, empty while updating
+  Generation        generation_{0};  ///< Incremented on every change of the state
+  Results           results_;
+  RecentList        recent_;    ///< The keys of the results, most recently used first
+  std::size_t       bytes_{0};  ///< The total size of the keys and results
+  Counters          counters_;
+};
+
+}  // namespace ledger
+}  // namespace fetch
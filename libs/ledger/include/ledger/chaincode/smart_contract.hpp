@@ -20,6 +20,7 @@
 #include "crypto/fnv.hpp"  // needed for std::hash<ConstByteArray> !!!
 #include "ledger/chaincode/contract.hpp"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -46,6 +47,9 @@ public:
 
   static constexpr char const *LOGGING_NAME = "SmartContract";
 
+  /// The maximum VM charge that a single action, query or initialisation may use
+  static constexpr uint64_t CHARGE_LIMIT = 10000000;
+
   // Construction / Destruction
   explicit SmartContract(std::string const &source);
   ~SmartContract() override = default;
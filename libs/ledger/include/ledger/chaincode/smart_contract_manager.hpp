@@ -37,6 +37,7 @@ public:
   static constexpr char const *LOGGING_NAME = "SmartContractManager";
 
   static storage::ResourceAddress CreateAddressForContract(Identifier const &contract_id);
+  static bool ExtractSource(Transaction const &tx, ConstByteArray &source, ConstByteArray &digest);
 
   SmartContractManager();
   ~SmartContractManager() override = default;
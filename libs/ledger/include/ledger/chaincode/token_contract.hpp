@@ -17,7 +17,13 @@
 //
 //------------------------------------------------------------------------------
 
+#include "core/mutex.hpp"
 #include "ledger/chaincode/contract.hpp"
+#include "ledger/chaincode/deed.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
 
 namespace fetch {
 namespace ledger {
@@ -40,6 +46,25 @@ private:
 
   // queries
   Status Balance(Query const &query, Query &response);
+
+  using DeedPtr = std::shared_ptr<ledger::Deed const>;
+
+  DeedPtr LookupDeed(ConstByteArray const &address, ConstByteArray const &record);
+
+  /// A deed decoded from a wallet record, along with the serialized form it was decoded from
+  struct CachedDeed
+  {
+    ConstByteArray encoded;
+    DeedPtr        deed;
+  };
+
+  using DeedCache = std::unordered_map<ConstByteArray, CachedDeed>;
+  using Mutex     = mutex::Mutex;
+
+  static constexpr std::size_t MAX_CACHED_DEEDS = 4096;
+
+  Mutex     deed_cache_lock_{__LINE__, __FILE__};
+  DeedCache deed_cache_{};  ///< The decoded deeds of the recently used wallets, by address
 };
 
 }  // namespace ledger
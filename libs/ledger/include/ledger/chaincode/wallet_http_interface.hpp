@@ -24,8 +24,14 @@
 #include <cstdint>
 
 namespace fetch {
+namespace variant {
+
+class Variant;
+
+}  // namespace variant
 namespace ledger {
 
+class MutableTransaction;
 class StorageInterface;
 class TransactionProcessor;
 
@@ -54,11 +60,20 @@ public:
 private:
   using KeyStore = storage::ObjectStore<byte_array::ConstByteArray>;
 
+  enum class TransferStatus
+  {
+    OK,
+    INVALID_REQUEST,
+    UNKNOWN_ADDRESS
+  };
+
   http::HTTPResponse OnRegister(http::HTTPRequest const &request);
   http::HTTPResponse OnBalance(http::HTTPRequest const &request);
   http::HTTPResponse OnTransfer(http::HTTPRequest const &request);
   http::HTTPResponse OnTransactions(http::HTTPRequest const &request);
 
+  TransferStatus CreateTransfer(variant::Variant const &transfer, MutableTransaction &mtx);
+
   static http::HTTPResponse BadJsonResponse(ErrorCode error_code);
   static const char *       ToString(ErrorCode error_code);
 
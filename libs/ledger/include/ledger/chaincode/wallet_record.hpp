@@ -17,8 +17,13 @@
 //
 //------------------------------------------------------------------------------
 
+#include "core/byte_array/byte_array.hpp"
 #include "ledger/chaincode/deed.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
 // TODO(HUT): doesn't putting this here pollute the namespace?
 using fetch::variant::Variant;
 using fetch::byte_array::ConstByteArray;
@@ -174,6 +179,64 @@ struct WalletRecord
   }
 };
 
+/**
+ * Native access to the balance of a serialized wallet record.
+ *
+ * A serialized record always starts with a fixed layout header: the balance (8 bytes, host byte
+ * order) followed by the deed flag (1 byte), with any deed following the header. The balance can
+ * therefore be read and updated in place, without deserializing the deed, producing exactly the
+ * same bytes as serializing the full record.
+ */
+struct WalletRecordHeader
+{
+  static constexpr std::size_t DEED_FLAG_OFFSET = sizeof(uint64_t);
+  static constexpr std::size_t SIZE             = DEED_FLAG_OFFSET + sizeof(bool);
+
+  uint64_t balance{0};
+  bool     has_deed{false};
+
+  /**
+   * Read the header from a serialized wallet record
+   *
+   * @param record The serialized wallet record
+   * @return true if successful, otherwise false
+   */
+  bool Read(ConstByteArray const &record)
+  {
+    if (record.size() < SIZE)
+    {
+      return false;
+    }
+
+    std::memcpy(&balance, record.pointer(), sizeof(balance));
+    has_deed = (record.pointer()[DEED_FLAG_OFFSET] != 0);
+
+    return true;
+  }
+
+  /**
+   * Build the updated serialized wallet record. The contents following the header (the deed) are
+   * preserved.
+   *
+   * @param record The current serialized wallet record, empty if the record does not exist
+   * @return The updated serialized wallet record
+   */
+  ConstByteArray Write(ConstByteArray const &record) const
+  {
+    byte_array::ByteArray updated{record};
+
+    if (updated.size() < SIZE)
+    {
+      updated.Resize(std::size_t{SIZE});
+      updated.pointer()[DEED_FLAG_OFFSET] = static_cast<uint8_t>(has_deed);
+    }
+
+    std::memcpy(updated.pointer(), &balance, sizeof(balance));
+
+    return {updated};
+  }
+};
+
 }  // namespace
 
 }  // namespace ledger
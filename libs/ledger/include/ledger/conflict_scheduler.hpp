@@ -0,0 +1,71 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "storage/resource_mapper.hpp"
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * Builds a parallel schedule for the transactions of a block from the resources they access,
+ * independently of the way in which the miner sliced the block.
+ *
+ * Transactions are presented in block order and each one is placed in the earliest slice after all
+ * of the preceding transactions with which it shares a resource. Two transactions in the same slice
+ * therefore never conflict, and every pair of conflicting transactions is executed in the same
+ * order as in the block, so executing the schedule is equivalent to executing the block. Since the
+ * original slicing is itself a valid schedule, the result never has more slices than the block.
+ */
+class ConflictScheduler
+{
+public:
+  using ResourceAddresses = std::vector<storage::ResourceAddress>;
+
+  // Construction / Destruction
+  ConflictScheduler()                          = default;
+  ConflictScheduler(ConflictScheduler const &) = delete;
+  ConflictScheduler(ConflictScheduler &&)      = delete;
+  ~ConflictScheduler()                         = default;
+
+  std::size_t Schedule(ResourceAddresses const &resources);
+  void        Reset();
+
+  std::size_t num_slices() const
+  {
+    return num_slices_;
+  }
+
+  // Operators
+  ConflictScheduler &operator=(ConflictScheduler const &) = delete;
+  ConflictScheduler &operator=(ConflictScheduler &&) = delete;
+
+private:
+  using ResourceID = storage::ResourceID;
+  using LastAccess = std::unordered_map<ResourceID, std::size_t>;
+
+  LastAccess  last_access_{};  ///< The slice of the last transaction to access each resource
+  std::size_t num_slices_{0};
+};
+
+}  // namespace ledger
+}  // namespace fetch
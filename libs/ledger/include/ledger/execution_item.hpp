@@ -19,11 +19,13 @@
 
 #include "ledger/chain/transaction.hpp"
 #include "ledger/executor_interface.hpp"
+#include "ledger/lane_bitmap.hpp"
 
 #include <atomic>
 #include <cstdint>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <utility>
 
 namespace fetch {
@@ -32,10 +34,13 @@ namespace ledger {
 class ExecutionItem
 {
 public:
-  using LaneIndex = uint32_t;
-  using TxDigest  = Transaction::TxDigest;
-  using LaneSet   = std::unordered_set<LaneIndex>;
-  using Status    = ExecutorInterface::Status;
+  using LaneIndex         = uint32_t;
+  using TxDigest          = Transaction::TxDigest;
+  using LaneSet           = std::unordered_set<LaneIndex>;
+  using Status            = ExecutorInterface::Status;
+  using ResourceAddress   = StorageInterface::ResourceAddress;
+  using ResourceAddresses = StorageInterface::ResourceAddresses;
+  using PrefetchedState   = ExecutorInterface::PrefetchedState;
 
   static constexpr char const *LOGGING_NAME = "ExecutionItem";
 
@@ -47,6 +52,7 @@ public:
   ExecutionItem(TxDigest hash, LaneIndex lane, std::size_t slice)
     : hash_(std::move(hash))
     , lanes_{lane}
+    , lane_bitmap_{lane}
     , slice_(slice)
   {}
 
@@ -60,6 +66,11 @@ public:
     return lanes_;
   }
 
+  LaneBitmap const &lane_bitmap() const
+  {
+    return lane_bitmap_;
+  }
+
   std::size_t slice() const
   {
     return slice_;
@@ -70,11 +81,41 @@ public:
     return status_;
   }
 
+  bool completed() const
+  {
+    return completed_;
+  }
+
+  ResourceAddresses const &resources() const
+  {
+    return resources_;
+  }
+
+  bool has_prefetched_state() const
+  {
+    std::lock_guard<std::mutex> guard(state_lock_);
+    return static_cast<bool>(state_);
+  }
+
   void Execute(ExecutorInterface &executor)
   {
     try
     {
-      status_ = executor.Execute(hash_, slice_, lanes_);
+      // take the prefetched state (if any) once, a late prefetch must not change the execution
+      StatePtr state{};
+      {
+        std::lock_guard<std::mutex> guard(state_lock_);
+        state = state_;
+      }
+
+      if (state)
+      {
+        status_ = executor.ExecuteWithState(hash_, slice_, lanes_, *state);
+      }
+      else
+      {
+        status_ = executor.Execute(hash_, slice_, lanes_);
+      }
     }
     catch (std::exception const &ex)
     {
@@ -82,20 +123,59 @@ public:
 
       status_ = Status::RESOURCE_FAILURE;
     }
+
+    completed_ = true;
+  }
+
+  /**
+   * Record the result of an execution which took place elsewhere, e.g. on a remote executor
+   *
+   * @param status The status of the execution
+   */
+  void Complete(Status status)
+  {
+    status_    = status;
+    completed_ = true;
   }
 
   void AddLane(LaneIndex lane)
   {
     lanes_.insert(lane);
+    lane_bitmap_.Set(lane);
+  }
+
+  void SetSlice(std::size_t slice)
+  {
+    slice_ = slice;
+  }
+
+  void AddResource(ResourceAddress address)
+  {
+    resources_.emplace_back(std::move(address));
+  }
+
+  void SetPrefetchedState(PrefetchedState state)
+  {
+    auto ptr = std::make_shared<PrefetchedState const>(std::move(state));
+
+    std::lock_guard<std::mutex> guard(state_lock_);
+    state_ = std::move(ptr);
   }
 
 private:
   using AtomicStatus = std::atomic<Status>;
-
-  TxDigest     hash_;
-  LaneSet      lanes_;
-  std::size_t  slice_;
-  AtomicStatus status_{Status::NOT_RUN};
+  using Flag         = std::atomic<bool>;
+  using StatePtr     = std::shared_ptr<PrefetchedState const>;
+
+  TxDigest           hash_;
+  LaneSet            lanes_;
+  LaneBitmap         lane_bitmap_;  ///< The lanes as a bitmap, for the conflict checks
+  ResourceAddresses  resources_;  ///< The state addresses declared by the transaction
+  std::size_t        slice_;
+  AtomicStatus       status_{Status::NOT_RUN};
+  Flag               completed_{false};
+  mutable std::mutex state_lock_;  ///< guards `state_`
+  StatePtr           state_{};     ///< The (optional) prefetched resource values
 };
 
 }  // namespace ledger
@@ -23,8 +23,10 @@
 #include "ledger/execution_item.hpp"
 #include "ledger/execution_manager_interface.hpp"
 #include "ledger/executor.hpp"
+#include "ledger/executor_farm.hpp"
+#include "ledger/executor_pool.hpp"
+#include "ledger/identifier.hpp"
 #include "ledger/storage_unit/storage_unit_interface.hpp"
-#include "network/details/thread_pool.hpp"
 #include "storage/object_store.hpp"
 
 #include "core/byte_array/encoders.hpp"
@@ -52,10 +54,22 @@ public:
   using StorageUnitPtr  = std::shared_ptr<StorageUnitInterface>;
   using ExecutorPtr     = std::shared_ptr<ExecutorInterface>;
   using ExecutorFactory = std::function<ExecutorPtr()>;
+  using FinishCallback  = std::function<void()>;
+  using RemoteExecutors = ExecutorFarm::Members;
+
+  /**
+   * Controls how the slices of a block are scheduled across the executors
+   */
+  enum class Mode
+  {
+    SERIAL,     ///< Each slice is executed to completion before the next is started
+    OPTIMISTIC  ///< Items from the next slice are started when their lanes become free
+  };
 
   // Construction / Destruction
   ExecutionManager(std::size_t num_executors, StorageUnitPtr storage,
-                   ExecutorFactory const &factory);
+                   ExecutorFactory const &factory, Mode mode = Mode::SERIAL);
+  ExecutionManager(RemoteExecutors remotes, StorageUnitPtr storage, Mode mode = Mode::SERIAL);
 
   /// @name Execution Manager Interface
   /// @{
@@ -70,28 +84,97 @@ public:
   void Start();
   void Stop();
 
+  /**
+   * Configure the callback triggered each time the execution of a block finishes (successfully or
+   * not). Must be configured before the execution manager is started.
+   *
+   * @param cb The callback to be triggered
+   */
+  void OnExecutionFinished(FinishCallback cb)
+  {
+    finish_callback_ = std::move(cb);
+  }
+
   // statistics
   std::size_t completed_executions() const
   {
     return completed_executions_;
   }
 
+  Mode mode() const
+  {
+    return mode_;
+  }
+
+  bool is_remote() const
+  {
+    return static_cast<bool>(executor_farm_);
+  }
+
+  std::size_t prefetched_resources() const
+  {
+    return prefetched_resources_;
+  }
+
+  /// @name State Prefetching
+  /// @{
+  void SetPrefetchEnabled(bool enabled)
+  {
+    prefetch_enabled_ = enabled;
+  }
+
+  bool prefetch_enabled() const
+  {
+    return prefetch_enabled_;
+  }
+  /// @}
+
+  /// @name Contract Precompilation
+  /// @{
+  void SetPrecompileEnabled(bool enabled)
+  {
+    precompile_enabled_ = enabled;
+  }
+
+  bool precompile_enabled() const
+  {
+    return precompile_enabled_;
+  }
+
+  std::size_t precompiled_contracts() const
+  {
+    return precompiled_contracts_;
+  }
+  /// @}
+
+  /// @name Conflict Scheduling
+  /// @{
+  void SetConflictSchedulingEnabled(bool enabled)
+  {
+    conflict_scheduling_enabled_ = enabled;
+  }
+
+  bool conflict_scheduling_enabled() const
+  {
+    return conflict_scheduling_enabled_;
+  }
+  /// @}
+
 private:
   struct Counters
   {
     std::size_t active{0};
     std::size_t remaining{0};
+    std::size_t completed{0};  ///< monotonic count used to detect individual completions
   };
 
   using ExecutionItemPtr  = std::unique_ptr<ExecutionItem>;
   using ExecutionItemList = std::vector<ExecutionItemPtr>;
   using ExecutionPlan     = std::vector<ExecutionItemList>;
-  using ThreadPool        = fetch::network::ThreadPool;
   using Mutex             = std::mutex;
   using Counter           = std::atomic<std::size_t>;
   using Flag              = std::atomic<bool>;
   using StateHash         = StorageUnitInterface::Hash;
-  using ExecutorList      = std::vector<ExecutorPtr>;
   using StateHashCache    = storage::ObjectStore<StateHash>;
   using ThreadPtr         = std::unique_ptr<std::thread>;
   using BlockSliceList    = ledger::Block::Slices;
@@ -100,12 +183,24 @@ private:
   using AtomicState       = std::atomic<State>;
   using SyncCounters      = SynchronisedState<Counters>;
   using SyncedState       = SynchronisedState<State>;
+  using DispatchFlags     = std::vector<bool>;
+  using LaneSet           = ExecutionItem::LaneSet;
+  using PrefetchItems     = std::vector<ExecutionItem *>;
+  using PrefetchTask      = std::future<void>;
+  using TxDigests         = std::vector<ExecutionItem::TxDigest>;
+  using ConstByteArray    = byte_array::ConstByteArray;
+  using ExecutorPoolPtr   = std::unique_ptr<ExecutorPool>;
+  using ExecutorFarmPtr   = std::unique_ptr<ExecutorFarm>;
+
+  Mode const mode_;
 
   Flag running_{false};
   Flag monitor_ready_{false};
 
   SyncedState state_{State::IDLE};
 
+  FinishCallback finish_callback_{};  ///< Triggered when the execution of a block finishes
+
   StorageUnitPtr storage_;
 
   Mutex         execution_plan_lock_;  ///< guards `execution_plan_`
@@ -117,21 +212,57 @@ private:
   Condition monitor_wake_;
   Condition monitor_notify_;
 
-  Mutex        idle_executors_lock_;  ///< guards `idle_executors`
-  ExecutorList idle_executors_;
-
   Counter completed_executions_{0};
   Counter num_slices_{0};
+  Counter prefetched_resources_{0};
+
+  Flag         prefetch_enabled_{true};
+  Mutex        prefetch_lock_;  ///< guards `prefetch_task_`
+  PrefetchTask prefetch_task_;
+
+  Flag    precompile_enabled_{true};
+  Counter precompiled_contracts_{0};
+
+  Flag conflict_scheduling_enabled_{false};
 
   SyncCounters counters_{};
 
-  ThreadPool thread_pool_;
-  ThreadPtr  monitor_thread_;
+  ThreadPtr monitor_thread_;
+
+  /// @name Executors (must be last so that the workers are stopped first)
+  /// @{
+  ExecutorPoolPtr executor_pool_;  ///< The local executors (unless remote)
+  ExecutorFarmPtr executor_farm_;  ///< The remote executors (if configured)
+  /// @}
 
   void MonitorThreadEntrypoint();
+  void SignalFinished();
 
   bool PlanExecution(Block::Body const &block);
-  void DispatchExecution(ExecutionItem &item);
+  void RescheduleExecution();
+  void DispatchExecution(ExecutionItem &item, ExecutorInterface &executor);
+  void CompleteExecution(ExecutionItem &item);
+  void Post(ExecutionItem &item);
+
+  /// @name Optimistic Scheduling
+  /// @{
+  bool        WaitForSliceOptimistically(std::size_t slice, DispatchFlags &lookahead);
+  bool        IsSliceComplete(std::size_t slice) const;
+  std::size_t ScheduleLookahead(std::size_t slice, DispatchFlags &lookahead);
+  /// @}
+
+  /// @name State Prefetching
+  /// @{
+  void StartPrefetch(std::size_t slice);
+  void WaitForPrefetch();
+  void PrefetchState(PrefetchItems const &items);
+  /// @}
+
+  /// @name Contract Precompilation
+  /// @{
+  static bool IsContractDeployment(Identifier const &contract_id);
+  void        PrecompileContracts(TxDigests const &deployments);
+  /// @}
 };
 
 }  // namespace ledger
@@ -27,6 +27,10 @@
 #include <vector>
 
 namespace fetch {
+namespace vm {
+class Profiler;
+}  // namespace vm
+
 namespace ledger {
 
 /**
@@ -46,11 +50,26 @@ public:
   /// @name Executor Interface
   /// @{
   Status Execute(TxDigest const &hash, std::size_t slice, LaneSet const &lanes) override;
+  Status ExecuteWithState(TxDigest const &hash, std::size_t slice, LaneSet const &lanes,
+                          PrefetchedState const &state) override;
   /// @}
 
+  /**
+   * Attach a profiler which records the VM instructions executed by the following transactions
+   *
+   * @param profiler The profiler, or nullptr to stop profiling
+   */
+  void SetProfiler(vm::Profiler *profiler)
+  {
+    profiler_ = profiler;
+  }
+
 private:
+  Status ExecuteTransaction(TxDigest const &hash, PrefetchedState const *state);
+
   Resources      resources_;         ///< The collection of resources
   ChainCodeCache chain_code_cache_;  //< The factory to create new chain code instances
+  vm::Profiler * profiler_{nullptr};
 };
 
 }  // namespace ledger
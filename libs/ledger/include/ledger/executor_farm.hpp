@@ -0,0 +1,159 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/execution_item.hpp"
+#include "ledger/remote_executor_interface.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * Schedules execution items across a set of remote executors, typically running in other
+ * processes or on other hosts.
+ *
+ * Each executor is declared with the lanes it is close to (e.g. the lanes served from the same
+ * host) and items are placed on the executor sharing the most lanes with them, falling back to the
+ * least loaded executor. Each executor has a dispatch thread which sends the items in batches and
+ * keeps several batches in flight, so that the round trip is not paid per item.
+ *
+ * Should an executor fail (an error or time out on one of its batches), it is removed from the
+ * farm and all of its outstanding items are placed on the remaining executors. Once no executors
+ * remain the items are completed with a resource failure.
+ */
+class ExecutorFarm
+{
+public:
+  using RemoteExecutorPtr = std::shared_ptr<RemoteExecutorInterface>;
+  using LaneSet           = ExecutionItem::LaneSet;
+  using Handler           = std::function<void(ExecutionItem &)>;
+
+  struct Member
+  {
+    RemoteExecutorPtr executor{};
+    LaneSet           lanes{};  ///< The lanes which are close to the executor
+  };
+
+  using Members = std::vector<Member>;
+
+  static constexpr char const *LOGGING_NAME           = "ExecutorFarm";
+  static constexpr std::size_t DEFAULT_BATCH_SIZE     = 32;
+  static constexpr std::size_t DEFAULT_PIPELINE_DEPTH = 4;
+
+  // Construction / Destruction
+  ExecutorFarm(Members members, Handler handler, std::string name,
+               std::size_t batch_size     = DEFAULT_BATCH_SIZE,
+               std::size_t pipeline_depth = DEFAULT_PIPELINE_DEPTH);
+  ExecutorFarm(ExecutorFarm const &) = delete;
+  ExecutorFarm(ExecutorFarm &&)      = delete;
+  ~ExecutorFarm();
+
+  /// @name Farm Control
+  /// @{
+  void Start();
+  void Stop();
+  /// @}
+
+  void Post(ExecutionItem &item);
+
+  std::size_t num_executors() const
+  {
+    return remotes_.size();
+  }
+
+  std::size_t num_available() const;
+
+  std::size_t failover_count() const
+  {
+    return failover_count_;
+  }
+
+  // Operators
+  ExecutorFarm &operator=(ExecutorFarm const &) = delete;
+  ExecutorFarm &operator=(ExecutorFarm &&) = delete;
+
+private:
+  using Mutex        = std::mutex;
+  using Condition    = std::condition_variable;
+  using Flag         = std::atomic<bool>;
+  using Counter      = std::atomic<std::size_t>;
+  using Items        = std::vector<ExecutionItem *>;
+  using ItemQueue    = std::deque<ExecutionItem *>;
+  using ThreadPtr    = std::unique_ptr<std::thread>;
+  using PendingBatch = RemoteExecutorInterface::PendingBatch;
+
+  struct Remote
+  {
+    Mutex             lock;             ///< Guards the queue and the availability
+    ItemQueue         queue;            ///< The items waiting to be sent
+    RemoteExecutorPtr executor;         ///< The remote executor
+    LaneSet           lanes;            ///< The lanes which are close to the executor
+    Flag              available{true};  ///< Cleared once the executor has failed
+    Counter           load{0};          ///< The number of items queued or in flight
+    ThreadPtr         thread;           ///< The dispatch thread
+  };
+
+  struct Batch
+  {
+    Items        items;
+    PendingBatch result;
+  };
+
+  using RemotePtr  = std::unique_ptr<Remote>;
+  using RemoteList = std::vector<RemotePtr>;
+  using Batches    = std::deque<Batch>;
+
+  void DispatchLoop(std::size_t index);
+
+  bool  Place(ExecutionItem &item);
+  Items TakeBatch(Remote &remote);
+  bool  Send(Remote &remote, Batches &in_flight);
+  bool  Complete(Remote &remote, Batch &batch);
+  void  Failover(std::size_t index, Batches &in_flight);
+  void  Fail(ExecutionItem &item);
+  void  WaitForWork(Remote &remote);
+
+  static std::size_t Score(Remote const &remote, ExecutionItem const &item);
+
+  RemoteList        remotes_;
+  Handler           handler_;
+  std::string const name_;
+  std::size_t const batch_size_;
+  std::size_t const pipeline_depth_;
+
+  Flag    running_{false};
+  Counter sleeping_{0};        ///< The number of dispatch threads waiting for work
+  Counter failover_count_{0};  ///< The number of items moved away from a failed executor
+
+  Mutex     work_lock_;  ///< Associated mutex for the work available condition
+  Condition work_available_;
+};
+
+}  // namespace ledger
+}  // namespace fetch
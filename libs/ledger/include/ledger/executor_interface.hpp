@@ -17,7 +17,9 @@
 //
 //------------------------------------------------------------------------------
 
+#include "core/macros.hpp"
 #include "ledger/chain/transaction.hpp"
+#include "ledger/storage_unit/storage_unit_interface.hpp"
 
 namespace fetch {
 namespace ledger {
@@ -25,9 +27,10 @@ namespace ledger {
 class ExecutorInterface
 {
 public:
-  using TxDigest  = Transaction::TxDigest;
-  using LaneIndex = uint32_t;
-  using LaneSet   = std::unordered_set<LaneIndex>;
+  using TxDigest        = Transaction::TxDigest;
+  using LaneIndex       = uint32_t;
+  using LaneSet         = std::unordered_set<LaneIndex>;
+  using PrefetchedState = StorageInterface::KeyValues;
 
   enum class Status
   {
@@ -48,6 +51,25 @@ public:
   /// @name Executor Interface
   /// @{
   virtual Status Execute(TxDigest const &hash, std::size_t slice, LaneSet const &lanes) = 0;
+
+  /**
+   * Execute a transaction with some of its declared resources already retrieved from storage.
+   *
+   * The caller guarantees that the values are current, i.e. nothing can have modified them since
+   * they were read. Executors which are unable to make use of the state simply ignore it.
+   *
+   * @param hash The transaction hash
+   * @param slice The current block slice
+   * @param lanes The affected lanes for the transaction
+   * @param state The prefetched resource values
+   * @return The status code for the operation
+   */
+  virtual Status ExecuteWithState(TxDigest const &hash, std::size_t slice, LaneSet const &lanes,
+                                  PrefetchedState const &state)
+  {
+    FETCH_UNUSED(state);
+    return Execute(hash, slice, lanes);
+  }
   /// @}
 
   virtual ~ExecutorInterface() = default;
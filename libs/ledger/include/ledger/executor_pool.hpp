@@ -0,0 +1,120 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/execution_item.hpp"
+#include "ledger/executor_interface.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * A fixed size pool of worker threads, each of which owns a dedicated executor.
+ *
+ * Every worker has its own queue of execution items. Items are distributed across the workers in
+ * a round robin fashion and a worker that runs out of work will steal items from the other
+ * queues. Since workers never share executors, no global lock is taken per transaction.
+ */
+class ExecutorPool
+{
+public:
+  using ExecutorPtr     = std::shared_ptr<ExecutorInterface>;
+  using ExecutorFactory = std::function<ExecutorPtr()>;
+  using Handler         = std::function<void(ExecutionItem &, ExecutorInterface &)>;
+
+  // Construction / Destruction
+  ExecutorPool(std::size_t num_workers, ExecutorFactory const &factory, Handler handler,
+               std::string name);
+  ExecutorPool(ExecutorPool const &) = delete;
+  ExecutorPool(ExecutorPool &&)      = delete;
+  ~ExecutorPool();
+
+  /// @name Pool Control
+  /// @{
+  void Start();
+  void Stop();
+  /// @}
+
+  void Post(ExecutionItem &item);
+
+  std::size_t num_workers() const
+  {
+    return workers_.size();
+  }
+
+  std::size_t steal_count() const
+  {
+    return steal_count_;
+  }
+
+  // Operators
+  ExecutorPool &operator=(ExecutorPool const &) = delete;
+  ExecutorPool &operator=(ExecutorPool &&) = delete;
+
+private:
+  using Mutex     = std::mutex;
+  using Condition = std::condition_variable;
+  using Flag      = std::atomic<bool>;
+  using Counter   = std::atomic<std::size_t>;
+  using ItemQueue = std::deque<ExecutionItem *>;
+  using ThreadPtr = std::unique_ptr<std::thread>;
+
+  struct Worker
+  {
+    Mutex       lock;      ///< Guards the queue (only contended while stealing)
+    ItemQueue   queue;     ///< The queue of pending items for this worker
+    ExecutorPtr executor;  ///< The executor dedicated to this worker
+    ThreadPtr   thread;    ///< The worker thread
+  };
+
+  using WorkerPtr  = std::unique_ptr<Worker>;
+  using WorkerList = std::vector<WorkerPtr>;
+
+  void WorkerLoop(std::size_t index);
+
+  ExecutionItem *PopLocal(std::size_t index);
+  ExecutionItem *Steal(std::size_t index);
+  void           WaitForWork();
+
+  WorkerList        workers_;
+  Handler           handler_;
+  std::string const name_;
+
+  Flag    running_{false};
+  Counter next_worker_{0};  ///< Round robin index for new items
+  Counter pending_{0};      ///< The number of items queued but not yet started
+  Counter sleeping_{0};     ///< The number of workers waiting for work
+  Counter steal_count_{0};  ///< The number of items that have been stolen
+
+  Mutex     sleep_lock_;  ///< Associated mutex for the work available condition
+  Condition work_available_;
+};
+
+}  // namespace ledger
+}  // namespace fetch
@@ -18,6 +18,10 @@
 //------------------------------------------------------------------------------
 
 #include <core/byte_array/byte_array.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <vector>
 
 namespace fetch {
@@ -30,6 +34,10 @@ namespace ledger {
  * For example:
  *
  *   `foo.bar` & `foo.baz` are in the same logical `foo` group
+ *
+ * Identifiers are interned in a process wide table. Each distinct name is parsed only once and
+ * carries its precomputed tokens, namespace, hash and parent, so copying an identifier, taking its
+ * parent and comparing two identifiers are all pointer operations.
  */
 class Identifier
 {
@@ -45,7 +53,7 @@ public:
   using Tokens         = std::vector<ConstByteArray>;
 
   // Construction / Destruction
-  Identifier() = default;
+  Identifier();
   explicit Identifier(ConstByteArray identifier);
   Identifier(Identifier const &) = default;
   Identifier(Identifier &&)      = default;
@@ -54,11 +62,12 @@ public:
   // Accessors
   Type                  type() const;
   ConstByteArray        name() const;
-  ConstByteArray        name_space() const;
+  ConstByteArray const &name_space() const;
   ConstByteArray const &full_name() const;
   ConstByteArray        qualifier() const;
   std::size_t           size() const;
   bool                  empty() const;
+  std::size_t           hash() const;
 
   Identifier GetParent() const;
 
@@ -80,16 +89,33 @@ public:
   bool                  operator!=(Identifier const &other) const;
 
 private:
-  Identifier(Tokens const &tokens, std::size_t count);
+  class Table;
+
+  struct Entry;
+  using EntryPtr = std::shared_ptr<Entry const>;
+
+  /**
+   * The interned representation of an identifier
+   */
+  struct Entry
+  {
+    Type           type{Type::INVALID};
+    ConstByteArray full{};        ///< The fully qualified name
+    Tokens         tokens{};      ///< The individual elements of the name
+    ConstByteArray name_space{};  ///< The fully qualified name without the last token
+    std::size_t    hash{0};       ///< The hash of the fully qualified name
+    EntryPtr       parent{};      ///< The parent identifier (null for the empty identifier)
+  };
+
+  explicit Identifier(EntryPtr entry);
 
   static const char SEPARATOR;
 
-  bool Tokenise();
-  void UpdateType();
+  static EntryPtr const &EmptyEntry();
+  static EntryPtr        CreateEntry(ConstByteArray const &full, std::size_t hash);
+  static Type            DetermineType(Tokens const &tokens);
 
-  Type           type_{Type::INVALID};
-  ConstByteArray full_{};    ///< The fully qualified name
-  Tokens         tokens_{};  ///< The individual elements of the name
+  EntryPtr entry_;  ///< The interned identifier, never null
 };
 
 /**
@@ -99,7 +125,7 @@ private:
  */
 inline Identifier::Type Identifier::type() const
 {
-  return type_;
+  return entry_->type;
 }
 
 /**
@@ -110,13 +136,13 @@ inline Identifier::Type Identifier::type() const
  */
 inline Identifier::ConstByteArray Identifier::name() const
 {
-  if (tokens_.empty())
+  if (entry_->tokens.empty())
   {
     return {};
   }
   else
   {
-    return tokens_.back();
+    return entry_->tokens.back();
   }
 }
 
@@ -126,16 +152,9 @@ inline Identifier::ConstByteArray Identifier::name() const
  *
  * @return The namespace for the identifier
  */
-inline Identifier::ConstByteArray Identifier::name_space() const
+inline Identifier::ConstByteArray const &Identifier::name_space() const
 {
-  if (tokens_.size() >= 2)
-  {
-    return full_.SubArray(0, full_.size() - (tokens_.back().size() + 1));
-  }
-  else
-  {
-    return {};
-  }
+  return entry_->name_space;
 }
 
 /**
@@ -145,7 +164,7 @@ inline Identifier::ConstByteArray Identifier::name_space() const
  */
 inline Identifier::ConstByteArray const &Identifier::full_name() const
 {
-  return full_;
+  return entry_->full;
 }
 
 /**
@@ -157,7 +176,7 @@ inline Identifier::ConstByteArray Identifier::qualifier() const
 {
   ConstByteArray identifier{};
 
-  switch (type_)
+  switch (entry_->type)
   {
   case Type::INVALID:
     break;
@@ -165,7 +184,7 @@ inline Identifier::ConstByteArray Identifier::qualifier() const
     identifier = full_name();
     break;
   case Type::SMART_CONTRACT:
-    identifier = tokens_[0];
+    identifier = entry_->tokens[0];
     break;
   }
 
@@ -174,23 +193,22 @@ inline Identifier::ConstByteArray Identifier::qualifier() const
 
 inline std::size_t Identifier::size() const
 {
-  return tokens_.size();
+  return entry_->tokens.size();
 }
 
 inline bool Identifier::empty() const
 {
-  return tokens_.empty();
+  return entry_->tokens.empty();
 }
 
 /**
- * Parses an fully qualified name
+ * Gets the precomputed hash of the identifier
  *
- * @param name The fully qualified name
+ * @return The hash of the fully qualified name
  */
-inline bool Identifier::Parse(ConstByteArray const &name)
+inline std::size_t Identifier::hash() const
 {
-  full_ = name;
-  return Tokenise();
+  return entry_->hash;
 }
 
 /**
@@ -200,8 +218,7 @@ inline bool Identifier::Parse(ConstByteArray const &name)
  */
 inline bool Identifier::Parse(ConstByteArray &&name)
 {
-  full_ = std::move(name);
-  return Tokenise();
+  return Parse(static_cast<ConstByteArray const &>(name));
 }
 
 /**
@@ -213,9 +230,9 @@ inline bool Identifier::Parse(ConstByteArray &&name)
 inline Identifier::ConstByteArray const &Identifier::operator[](std::size_t index) const
 {
 #ifndef NDEBUG
-  return tokens_.at(index);
+  return entry_->tokens.at(index);
 #else   // !NDEBUG
-  return tokens_[index];
+  return entry_->tokens[index];
 #endif  // NDEBUG
 }
 
@@ -227,7 +244,7 @@ inline Identifier::ConstByteArray const &Identifier::operator[](std::size_t inde
  */
 inline bool Identifier::operator==(Identifier const &other) const
 {
-  return (full_ == other.full_);
+  return (entry_ == other.entry_);
 }
 
 /**
@@ -238,8 +255,21 @@ inline bool Identifier::operator==(Identifier const &other) const
  */
 inline bool Identifier::operator!=(Identifier const &other) const
 {
-  return (full_ != other.full_);
+  return (entry_ != other.entry_);
 }
 
 }  // namespace ledger
 }  // namespace fetch
+
+namespace std {
+
+template <>
+struct hash<fetch::ledger::Identifier>
+{
+  std::size_t operator()(fetch::ledger::Identifier const &identifier) const
+  {
+    return identifier.hash();
+  }
+};
+
+}  // namespace std
@@ -0,0 +1,283 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * A fixed width set of lanes, stored as a bitmap. The lanes of a transaction are determined once
+ * and then checked against the lanes of other transactions (or of a whole slice) with a handful of
+ * word-wise AND operations, rather than by looking up each lane in a hash set.
+ */
+class LaneBitmap
+{
+public:
+  using LaneIndex = uint32_t;
+
+  static constexpr uint32_t    MAX_LOG2_LANES = 10;
+  static constexpr std::size_t MAX_LANES      = std::size_t{1} << MAX_LOG2_LANES;
+
+  // Construction / Destruction
+  LaneBitmap() = default;
+  LaneBitmap(std::initializer_list<LaneIndex> lanes);
+  LaneBitmap(LaneBitmap const &) = default;
+  ~LaneBitmap()                  = default;
+
+  static LaneBitmap Range(LaneIndex begin, LaneIndex end);
+
+  /// @name Lanes
+  /// @{
+  void Set(LaneIndex lane);
+  void Reset(LaneIndex lane);
+  bool Test(LaneIndex lane) const;
+  /// @}
+
+  /// @name Set Operations
+  /// @{
+  bool Overlaps(LaneBitmap const &other) const;
+  void Remove(LaneBitmap const &other);
+  /// @}
+
+  bool        empty() const;
+  std::size_t count() const;
+  LaneIndex   lowest() const;
+
+  template <typename Visitor>
+  void ForEach(Visitor &&visitor) const;
+
+  // Operators
+  LaneBitmap &operator=(LaneBitmap const &) = default;
+  LaneBitmap &operator|=(LaneBitmap const &other);
+  LaneBitmap &operator&=(LaneBitmap const &other);
+  bool        operator==(LaneBitmap const &other) const;
+  bool        operator!=(LaneBitmap const &other) const;
+
+private:
+  using Word = uint64_t;
+
+  static constexpr std::size_t BITS_PER_WORD = 64;
+  static constexpr std::size_t NUM_WORDS     = MAX_LANES / BITS_PER_WORD;
+
+  using Words = std::array<Word, NUM_WORDS>;
+
+  static void CheckLane(LaneIndex lane);
+
+  Words words_{};
+};
+
+inline LaneBitmap::LaneBitmap(std::initializer_list<LaneIndex> lanes)
+{
+  for (auto const lane : lanes)
+  {
+    Set(lane);
+  }
+}
+
+/**
+ * Create the bitmap of a contiguous range of lanes
+ *
+ * @param begin The first lane of the range
+ * @param end The lane after the last lane of the range (at most MAX_LANES)
+ * @return The bitmap of the lanes
+ */
+inline LaneBitmap LaneBitmap::Range(LaneIndex begin, LaneIndex end)
+{
+  LaneBitmap bitmap{};
+  for (LaneIndex lane = begin; lane < end; ++lane)
+  {
+    bitmap.Set(lane);
+  }
+
+  return bitmap;
+}
+
+/**
+ * Add a lane to the set
+ *
+ * @param lane The index of the lane, which must be less than MAX_LANES
+ */
+inline void LaneBitmap::Set(LaneIndex lane)
+{
+  CheckLane(lane);
+  words_[lane / BITS_PER_WORD] |= Word{1} << (lane % BITS_PER_WORD);
+}
+
+/**
+ * Remove a lane from the set
+ *
+ * @param lane The index of the lane, which must be less than MAX_LANES
+ */
+inline void LaneBitmap::Reset(LaneIndex lane)
+{
+  CheckLane(lane);
+  words_[lane / BITS_PER_WORD] &= ~(Word{1} << (lane % BITS_PER_WORD));
+}
+
+/**
+ * Determine if a lane is in the set
+ *
+ * @param lane The index of the lane
+ * @return true if the lane is in the set, otherwise false
+ */
+inline bool LaneBitmap::Test(LaneIndex lane) const
+{
+  if (lane >= MAX_LANES)
+  {
+    return false;
+  }
+
+  return ((words_[lane / BITS_PER_WORD] >> (lane % BITS_PER_WORD)) & 1u) != 0;
+}
+
+/**
+ * Determine if the two sets have any lanes in common
+ *
+ * @param other The other set of lanes
+ * @return true if any lane is in both sets, otherwise false
+ */
+inline bool LaneBitmap::Overlaps(LaneBitmap const &other) const
+{
+  Word common{0};
+  for (std::size_t i = 0; i < NUM_WORDS; ++i)
+  {
+    common |= words_[i] & other.words_[i];
+  }
+
+  return common != 0;
+}
+
+/**
+ * Remove all the lanes of another set from this set
+ *
+ * @param other The lanes to be removed
+ */
+inline void LaneBitmap::Remove(LaneBitmap const &other)
+{
+  for (std::size_t i = 0; i < NUM_WORDS; ++i)
+  {
+    words_[i] &= ~other.words_[i];
+  }
+}
+
+inline bool LaneBitmap::empty() const
+{
+  Word any{0};
+  for (auto const word : words_)
+  {
+    any |= word;
+  }
+
+  return any == 0;
+}
+
+/**
+ * @return The number of lanes in the set
+ */
+inline std::size_t LaneBitmap::count() const
+{
+  std::size_t total{0};
+  for (auto const word : words_)
+  {
+    total += static_cast<std::size_t>(__builtin_popcountll(word));
+  }
+
+  return total;
+}
+
+/**
+ * @return The lowest lane in the set, or MAX_LANES if the set is empty
+ */
+inline LaneBitmap::LaneIndex LaneBitmap::lowest() const
+{
+  for (std::size_t i = 0; i < NUM_WORDS; ++i)
+  {
+    if (words_[i] != 0)
+    {
+      return static_cast<LaneIndex>((i * BITS_PER_WORD) +
+                                    static_cast<std::size_t>(__builtin_ctzll(words_[i])));
+    }
+  }
+
+  return static_cast<LaneIndex>(MAX_LANES);
+}
+
+/**
+ * Visit each of the lanes in the set, in ascending order
+ *
+ * @param visitor The callable to be invoked with the index of each lane
+ */
+template <typename Visitor>
+void LaneBitmap::ForEach(Visitor &&visitor) const
+{
+  for (std::size_t i = 0; i < NUM_WORDS; ++i)
+  {
+    for (Word word = words_[i]; word != 0; word &= word - 1)
+    {
+      visitor(static_cast<LaneIndex>((i * BITS_PER_WORD) +
+                                     static_cast<std::size_t>(__builtin_ctzll(word))));
+    }
+  }
+}
+
+inline LaneBitmap &LaneBitmap::operator|=(LaneBitmap const &other)
+{
+  for (std::size_t i = 0; i < NUM_WORDS; ++i)
+  {
+    words_[i] |= other.words_[i];
+  }
+
+  return *this;
+}
+
+inline LaneBitmap &LaneBitmap::operator&=(LaneBitmap const &other)
+{
+  for (std::size_t i = 0; i < NUM_WORDS; ++i)
+  {
+    words_[i] &= other.words_[i];
+  }
+
+  return *this;
+}
+
+inline bool LaneBitmap::operator==(LaneBitmap const &other) const
+{
+  return words_ == other.words_;
+}
+
+inline bool LaneBitmap::operator!=(LaneBitmap const &other) const
+{
+  return words_ != other.words_;
+}
+
+inline void LaneBitmap::CheckLane(LaneIndex lane)
+{
+  if (lane >= MAX_LANES)
+  {
+    throw std::out_of_range("Lane index exceeds the capacity of the lane bitmap");
+  }
+}
+
+}  // namespace ledger
+}  // namespace fetch
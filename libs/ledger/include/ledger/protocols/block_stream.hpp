@@ -0,0 +1,112 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/chain/block.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * The message exchanged between nodes during a streaming block sync.
+ *
+ * The requesting node sends a REQUEST message, granting the remote an initial number of credits.
+ * The remote then pushes one BLOCK message per block (oldest first) for every credit it holds and
+ * the requesting node grants further credits (CREDIT) as it processes the received blocks. Once all
+ * the blocks have been sent the remote signals the end (END) of the stream.
+ */
+struct BlockStreamMessage
+{
+  using BlockHash = Block::Digest;
+
+  enum class Type : uint8_t
+  {
+    REQUEST = 0,  ///< Request a stream of blocks from a peer
+    BLOCK,        ///< A single block of the stream
+    CREDIT,       ///< Additional flow control credits for the remote
+    END           ///< The end of the stream
+  };
+
+  Type      type{Type::REQUEST};
+  uint64_t  stream_id{0};
+  BlockHash start{};      ///< (REQUEST) The hash of the most recent block required
+  BlockHash last_seen{};  ///< (REQUEST) The hash of the heaviest block of the requester
+  uint64_t  limit{0};     ///< (REQUEST) The maximum number of blocks to be streamed
+  uint64_t  credits{0};   ///< (REQUEST, CREDIT) The number of credits being granted
+  uint64_t  total{0};     ///< (END) The total number of blocks that have been streamed
+  Block     block{};      ///< (BLOCK) The block being streamed
+};
+
+template <typename T>
+void Serialize(T &serializer, BlockStreamMessage const &msg)
+{
+  using Type = BlockStreamMessage::Type;
+
+  serializer << static_cast<uint8_t>(msg.type) << msg.stream_id;
+
+  switch (msg.type)
+  {
+  case Type::REQUEST:
+    serializer << msg.start << msg.last_seen << msg.limit << msg.credits;
+    break;
+  case Type::BLOCK:
+    serializer << msg.block;
+    break;
+  case Type::CREDIT:
+    serializer << msg.credits;
+    break;
+  case Type::END:
+    serializer << msg.total;
+    break;
+  }
+}
+
+template <typename T>
+void Deserialize(T &serializer, BlockStreamMessage &msg)
+{
+  using Type = BlockStreamMessage::Type;
+
+  uint8_t type{0};
+  serializer >> type >> msg.stream_id;
+
+  msg.type = static_cast<Type>(type);
+
+  switch (msg.type)
+  {
+  case Type::REQUEST:
+    serializer >> msg.start >> msg.last_seen >> msg.limit >> msg.credits;
+    break;
+  case Type::BLOCK:
+    serializer >> msg.block;
+    break;
+  case Type::CREDIT:
+    serializer >> msg.credits;
+    break;
+  case Type::END:
+    serializer >> msg.total;
+    break;
+  default:
+    throw std::runtime_error("Unknown block stream message type");
+  }
+}
+
+}  // namespace ledger
+}  // namespace fetch
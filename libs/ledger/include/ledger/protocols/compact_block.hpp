@@ -0,0 +1,68 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/serializers/stl_types.hpp"
+#include "ledger/chain/block.hpp"
+#include "ledger/transaction_summary_cache.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * The compact form of a block used when relaying blocks across the network. The transaction
+ * summaries of the block are replaced with their short ids, so that a receiver which has already
+ * seen the transactions can rebuild the block locally and only needs to request the summaries
+ * which it is missing from the sender.
+ */
+struct CompactBlock
+{
+  using ShortId     = TransactionSummaryCache::ShortId;
+  using ShortIds    = std::vector<ShortId>;
+  using Slices      = std::vector<ShortIds>;
+  using Indices     = std::vector<uint64_t>;
+  using TxSummaries = std::vector<TransactionSummary>;
+
+  Block  header{};  ///< The block with its transactions removed
+  Slices slices{};  ///< The short ids of the transactions in each slice
+
+  CompactBlock() = default;
+  explicit CompactBlock(Block const &block);
+
+  Indices Reconstruct(TransactionSummaryCache const *cache, Block &block) const;
+
+  static bool Fill(Block &block, Indices const &indices, TxSummaries const &summaries);
+};
+
+template <typename T>
+void Serialize(T &serializer, CompactBlock const &block)
+{
+  serializer << block.header << block.slices;
+}
+
+template <typename T>
+void Deserialize(T &serializer, CompactBlock &block)
+{
+  serializer >> block.header >> block.slices;
+}
+
+}  // namespace ledger
+}  // namespace fetch
@@ -23,6 +23,7 @@
 #include "core/service_ids.hpp"
 #include "ledger/executor_interface.hpp"
 #include "ledger/protocols/executor_rpc_protocol.hpp"
+#include "ledger/remote_executor_interface.hpp"
 #include "network/generics/backgrounded_work.hpp"
 #include "network/generics/future_timepoint.hpp"
 #include "network/generics/has_worker_thread.hpp"
@@ -37,7 +38,7 @@ namespace ledger {
 
 class ExecutorConnectorWorker;
 
-class ExecutorRpcClient : public ExecutorInterface
+class ExecutorRpcClient : public ExecutorInterface, public RemoteExecutorInterface
 {
 public:
   using MuddleEp        = muddle::MuddleEndpoint;
@@ -62,7 +63,8 @@ public:
   void Connect(Muddle &muddle, Uri uri,
                std::chrono::milliseconds timeout = std::chrono::milliseconds(10000));
 
-  Status Execute(TxDigest const &hash, std::size_t slice, LaneSet const &lanes) override;
+  Status       Execute(TxDigest const &hash, std::size_t slice, LaneSet const &lanes) override;
+  PendingBatch ExecuteBatch(Requests const &requests) override;
 
   bool GetAddress(Address &address) const
   {
@@ -85,6 +87,8 @@ public:
   }
 
 private:
+  static constexpr uint32_t BATCH_TIMEOUT_MS = 30000;
+
   void WorkCycle();
 
   friend class ExecutorConnectorWorker;
@@ -18,6 +18,7 @@
 //------------------------------------------------------------------------------
 
 #include "ledger/executor.hpp"
+#include "ledger/remote_executor_interface.hpp"
 #include "network/service/protocol.hpp"
 
 namespace fetch {
@@ -28,16 +29,40 @@ class ExecutorRpcProtocol : public service::Protocol
 public:
   enum
   {
-    EXECUTE = 1
+    EXECUTE       = 1,
+    EXECUTE_BATCH = 2
   };
 
+  using Requests = RemoteExecutorInterface::Requests;
+  using Statuses = RemoteExecutorInterface::Statuses;
+
   explicit ExecutorRpcProtocol(ExecutorInterface &executor)
     : executor_{executor}
   {
     Expose(EXECUTE, &executor_, &ExecutorInterface::Execute);
+    Expose(EXECUTE_BATCH, this, &ExecutorRpcProtocol::ExecuteBatch);
   }
 
 private:
+  /**
+   * Execute a batch of transactions in order, so that a single round trip covers them all
+   *
+   * @param requests The transactions to be executed
+   * @return The status of each of the transactions
+   */
+  Statuses ExecuteBatch(Requests const &requests)
+  {
+    Statuses statuses{};
+    statuses.reserve(requests.size());
+
+    for (auto const &request : requests)
+    {
+      statuses.push_back(executor_.Execute(request.digest, request.slice, request.lanes));
+    }
+
+    return statuses;
+  }
+
   ExecutorInterface &executor_;
 };
 
@@ -30,14 +30,17 @@ namespace ledger {
 class MainChainProtocol : public service::Protocol
 {
 public:
-  using Blocks    = std::vector<Block>;
-  using BlockHash = Block::Digest;
+  using Blocks      = std::vector<Block>;
+  using BlockHash   = Block::Digest;
+  using Indices     = std::vector<uint64_t>;
+  using TxSummaries = std::vector<TransactionSummary>;
 
   enum
   {
-    HEAVIEST_CHAIN   = 1,
-    CHAIN_PRECEDING  = 2,
-    COMMON_SUB_CHAIN = 3
+    HEAVIEST_CHAIN     = 1,
+    CHAIN_PRECEDING    = 2,
+    COMMON_SUB_CHAIN   = 3,
+    BLOCK_TRANSACTIONS = 4
   };
 
   explicit MainChainProtocol(MainChain &chain)
@@ -46,6 +49,7 @@ public:
     Expose(HEAVIEST_CHAIN, this, &MainChainProtocol::GetHeaviestChain);
     Expose(CHAIN_PRECEDING, this, &MainChainProtocol::GetChainPreceding);
     Expose(COMMON_SUB_CHAIN, this, &MainChainProtocol::GetCommonSubChain);
+    Expose(BLOCK_TRANSACTIONS, this, &MainChainProtocol::GetBlockTransactions);
   }
 
 private:
@@ -76,6 +80,52 @@ private:
     return Copy(blocks);
   }
 
+  /**
+   * Get a subset of the transaction summaries of a block, used by peers to complete a compact block
+   *
+   * @param hash The hash of the block
+   * @param indices The (flattened) indices of the transactions required
+   * @return The requested summaries, or an empty list if the block or a transaction is not known
+   */
+  TxSummaries GetBlockTransactions(BlockHash const &hash, Indices const &indices)
+  {
+    LOG_STACK_TRACE_POINT;
+
+    TxSummaries summaries{};
+
+    auto const block = chain_.GetBlock(hash);
+    if (!block)
+    {
+      return summaries;
+    }
+
+    // flatten the slices of the block to make random access possible
+    std::vector<TransactionSummary const *> transactions{};
+    transactions.reserve(block->GetTransactionCount());
+
+    for (auto const &slice : block->body.slices)
+    {
+      for (auto const &tx : slice)
+      {
+        transactions.push_back(&tx);
+      }
+    }
+
+    summaries.reserve(indices.size());
+    for (auto const index : indices)
+    {
+      if (index >= transactions.size())
+      {
+        summaries.clear();
+        break;
+      }
+
+      summaries.push_back(*transactions[index]);
+    }
+
+    return summaries;
+  }
+
   static Blocks Copy(MainChain::Blocks const &blocks)
   {
     Blocks output{};
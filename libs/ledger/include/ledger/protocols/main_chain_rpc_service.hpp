@@ -21,6 +21,8 @@
 #include "core/random/lcg.hpp"
 #include "core/state_machine.hpp"
 #include "ledger/chain/main_chain.hpp"
+#include "ledger/protocols/block_stream.hpp"
+#include "ledger/protocols/compact_block.hpp"
 #include "ledger/protocols/main_chain_rpc_protocol.hpp"
 #include "network/generics/backgrounded_work.hpp"
 #include "network/generics/future_timepoint.hpp"
@@ -31,7 +33,10 @@
 #include "network/muddle/subscription.hpp"
 #include "network/p2pservice/p2ptrust_interface.hpp"
 
+#include <chrono>
+#include <map>
 #include <memory>
+#include <utility>
 
 namespace fetch {
 namespace ledger {
@@ -39,6 +44,7 @@ namespace ledger {
 class BlockCoordinator;
 class MainChain;
 class MainChainSyncWorker;
+class TransactionSummaryCache;
 
 class MainChainRpcService : public muddle::rpc::Server,
                             public std::enable_shared_from_this<MainChainRpcService>
@@ -50,9 +56,16 @@ public:
     WAIT_FOR_HEAVIEST_CHAIN,
     SYNCHRONISING,
     WAITING_FOR_RESPONSE,
+    STREAMING,
     SYNCHRONISED,
   };
 
+  enum class SyncMode
+  {
+    REQUEST_RESPONSE,  ///< Missing blocks are requested from peers in batches
+    STREAMING,         ///< Missing blocks are pushed by peers as a flow controlled stream
+  };
+
   using MuddleEndpoint  = muddle::MuddleEndpoint;
   using MainChain       = ledger::MainChain;
   using Subscription    = muddle::Subscription;
@@ -75,7 +88,8 @@ public:
 
   // Construction / Destruction
   MainChainRpcService(MuddleEndpoint &endpoint, MainChain &chain, TrustSystem &trust,
-                      bool standalone);
+                      bool standalone, SyncMode sync_mode = SyncMode::REQUEST_RESPONSE,
+                      TransactionSummaryCache *tx_summary_cache = nullptr);
   MainChainRpcService(MainChainRpcService const &) = delete;
   MainChainRpcService(MainChainRpcService &&)      = delete;
   ~MainChainRpcService() override;
@@ -102,6 +116,13 @@ public:
     return (State::SYNCHRONISED == state());
   }
 
+  SyncMode sync_mode() const
+  {
+    return sync_mode_;
+  }
+
+  std::size_t GetStreamBacklog() const;
+
   // Operators
   MainChainRpcService &operator=(MainChainRpcService const &) = delete;
   MainChainRpcService &operator=(MainChainRpcService &&) = delete;
@@ -110,12 +131,66 @@ private:
   static constexpr std::size_t BLOCK_CATCHUP_STEP_SIZE = 30;
 
   using BlockList       = fetch::ledger::MainChainProtocol::Blocks;
-  using StateMachine    = core::StateMachine<State>;
+  using StateMachine    = core::StateMachine<State, MainChainRpcService>;
   using StateMachinePtr = std::shared_ptr<StateMachine>;
+  using StateHandler    = core::StateHandler<MainChainRpcService, State>;
+  using StreamMessage   = BlockStreamMessage;
+  using StreamKey       = std::pair<Address, uint64_t>;
+  using Clock           = std::chrono::steady_clock;
+  using Timepoint       = Clock::time_point;
+  using Mutex           = mutex::Mutex;
+
+  struct SyncSummary
+  {
+    std::size_t added{0};
+    std::size_t loose{0};
+    std::size_t duplicate{0};
+    std::size_t invalid{0};
+  };
+
+  /// The stream of blocks being received by this node
+  struct InboundStream
+  {
+    uint64_t  id{0};
+    Address   peer{};
+    uint64_t  received{0};
+    bool      complete{false};
+    Timepoint last_activity{Clock::now()};
+  };
+
+  /// A stream of blocks being sent to a peer
+  struct OutboundStream
+  {
+    MainChain::Blocks blocks{};
+    std::size_t       next{0};
+    uint64_t          credits{0};
+  };
+
+  using OutboundStreams = std::map<StreamKey, OutboundStream>;
 
   /// @name Subscription Handlers
   /// @{
   void OnNewBlock(Address const &from, Block &block, Address const &transmitter);
+  void OnNewCompactBlock(Address const &from, CompactBlock const &compact,
+                         Address const &transmitter);
+  /// @}
+
+  /// @name Compact Blocks
+  /// @{
+  void RequestMissingTransactions(Address const &from, Block const &block,
+                                  CompactBlock::Indices indices, Address const &transmitter);
+  bool CompleteCompactBlock(Address const &from, Block &block, Address const &transmitter);
+  void OnStreamMessage(Address const &from, StreamMessage &msg);
+  /// @}
+
+  /// @name Block Streaming
+  /// @{
+  void OnStreamRequest(Address const &from, StreamMessage const &msg);
+  void OnStreamCredit(Address const &from, StreamMessage const &msg);
+  void OnStreamBlock(Address const &from, StreamMessage &msg);
+  void OnStreamEnd(Address const &from, StreamMessage const &msg);
+  void SendStreamBlocks(StreamKey const &key, OutboundStream &stream);
+  void SendStreamMessage(Address const &address, StreamMessage const &msg);
   /// @}
 
   /// @name Utilities
@@ -123,6 +198,8 @@ private:
   static char const *ToString(State state);
   Address            GetRandomTrustedPeer() const;
   void               HandleChainResponse(Address const &peer, BlockList block_list);
+  void               AddSyncedBlock(Address const &peer, Block &block, SyncSummary &summary);
+  static void        LogSyncSummary(Address const &peer, SyncSummary const &summary);
   /// @}
 
   /// @name State Machine Handlers
@@ -131,7 +208,19 @@ private:
   State OnWaitForHeaviestChain();
   State OnSynchronising();
   State OnWaitingForResponse();
+  State OnStreaming();
   State OnSynchronised(State current, State previous);
+
+  // clang-format off
+  static constexpr StateHandler STATE_TABLE[] = {
+      {State::REQUEST_HEAVIEST_CHAIN,  &MainChainRpcService::OnRequestHeaviestChain},
+      {State::WAIT_FOR_HEAVIEST_CHAIN, &MainChainRpcService::OnWaitForHeaviestChain},
+      {State::SYNCHRONISING,           &MainChainRpcService::OnSynchronising},
+      {State::WAITING_FOR_RESPONSE,    &MainChainRpcService::OnWaitingForResponse},
+      {State::STREAMING,               &MainChainRpcService::OnStreaming},
+      {State::SYNCHRONISED,            &MainChainRpcService::OnSynchronised},
+  };
+  // clang-format on
   /// @}
 
   /// @name System Components
@@ -144,6 +233,8 @@ private:
   /// @name RPC Server
   /// @{
   SubscriptionPtr   block_subscription_;
+  SubscriptionPtr   stream_subscription_;
+  SubscriptionPtr   compact_subscription_;
   MainChainProtocol main_chain_protocol_;
   /// @}
 
@@ -154,6 +245,22 @@ private:
   Address         current_peer_address_;
   BlockHash       current_missing_block_;
   Promise         current_request_;
+  SyncMode        sync_mode_;
+  /// @}
+
+  /// @name Compact Block Data
+  /// @{
+  TransactionSummaryCache *summary_cache_;  ///< The recently seen transactions (can be null)
+  RpcClient                tx_client_;      ///< The client for missing transaction requests
+  /// @}
+
+  /// @name Streaming Data
+  /// @{
+  Mutex           inbound_lock_{__LINE__, __FILE__};
+  InboundStream   inbound_stream_{};  ///< The (single) stream being received
+  uint64_t        next_stream_id_{1};
+  mutable Mutex   outbound_lock_{__LINE__, __FILE__};
+  OutboundStreams outbound_streams_{};  ///< The streams being served to peers
   /// @}
 };
 
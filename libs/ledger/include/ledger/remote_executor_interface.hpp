@@ -0,0 +1,82 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/executor_interface.hpp"
+
+#include <cstdint>
+#include <future>
+#include <vector>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * A single transaction to be executed as part of a batch
+ */
+struct ExecutionRequest
+{
+  using TxDigest = ExecutorInterface::TxDigest;
+  using LaneSet  = ExecutorInterface::LaneSet;
+
+  TxDigest digest{};
+  uint64_t slice{0};
+  LaneSet  lanes{};
+};
+
+/**
+ * An executor, typically in another process or on another host, which executes transactions in
+ * batches. Several batches may be in flight at the same time.
+ */
+class RemoteExecutorInterface
+{
+public:
+  using Requests     = std::vector<ExecutionRequest>;
+  using Statuses     = std::vector<ExecutorInterface::Status>;
+  using PendingBatch = std::future<Statuses>;
+
+  /// @name Remote Executor Interface
+  /// @{
+
+  /**
+   * Send a batch of transactions to be executed, without waiting for the result
+   *
+   * @param requests The transactions to be executed, in order
+   * @return The pending statuses of the transactions in the same order, which raises an error if
+   * the executor could not be reached
+   */
+  virtual PendingBatch ExecuteBatch(Requests const &requests) = 0;
+  /// @}
+
+  virtual ~RemoteExecutorInterface() = default;
+};
+
+template <typename T>
+void Serialize(T &stream, ExecutionRequest const &request)
+{
+  stream << request.digest << request.slice << request.lanes;
+}
+
+template <typename T>
+void Deserialize(T &stream, ExecutionRequest &request)
+{
+  stream >> request.digest >> request.slice >> request.lanes;
+}
+
+}  // namespace ledger
+}  // namespace fetch
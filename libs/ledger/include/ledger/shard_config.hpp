@@ -19,6 +19,7 @@
 
 #include "crypto/prover.hpp"
 #include "network/muddle/network_id.hpp"
+#include "network/muddle/packet_compressor.hpp"
 
 #include <chrono>
 #include <vector>
@@ -26,6 +27,8 @@
 namespace fetch {
 namespace ledger {
 
+class VerifiedDigestCache;
+
 struct ShardConfig
 {
   using Timeperiod     = std::chrono::milliseconds;
@@ -41,9 +44,10 @@ struct ShardConfig
 
   /// @name External Network
   /// @{
-  CertificatePtr external_identity;    ///< The identity for the external network
-  uint16_t       external_port;        ///< The server port for the external network
-  NetworkId      external_network_id;  ///< The ID of the external network
+  CertificatePtr             external_identity;       ///< The identity for the external network
+  uint16_t                   external_port;           ///< The server port for the external network
+  NetworkId                  external_network_id;     ///< The ID of the external network
+  muddle::CompressionOptions external_compression{};  ///< Compression of the traffic to peers
   /// @}
 
   /// @name Internal Network
@@ -55,10 +59,18 @@ struct ShardConfig
 
   /// @name Tx Sync Configuration
   /// @{
-  std::size_t verification_threads{1};  ///< Num threads for tx verification
-  Timeperiod  sync_service_timeout{5000};
-  Timeperiod  sync_service_promise_timeout{2000};
-  Timeperiod  sync_service_fetch_period{5000};
+  std::size_t          verification_threads{1};  ///< Num threads for tx verification
+  Timeperiod           sync_service_timeout{5000};
+  Timeperiod           sync_service_promise_timeout{2000};
+  Timeperiod           sync_service_fetch_period{5000};
+  bool                 sync_service_pipelined{false};  ///< Pipeline the subtree requests of the sync
+  bool                 sync_service_reconcile{false};  ///< Reconcile sketches of recent transactions
+  VerifiedDigestCache *verified_cache{nullptr};        ///< The digests verified before (optional)
+  /// @}
+
+  /// @name State Configuration
+  /// @{
+  bool state_forks{false};  ///< Allow speculative execution on forks of the state
   /// @}
 };
 
@@ -53,6 +53,8 @@ public:
   Status Read(std::string const &key, void *data, uint64_t &size) override;
   Status Write(std::string const &key, void const *data, uint64_t size) override;
   Status Exists(std::string const &key) override;
+  Status ReadView(std::string const &key, ConstByteArray &value) override;
+  Status WriteView(std::string const &key, ConstByteArray const &value) override;
   /// @}
 
   void        PushContext(Identifier const &scope);
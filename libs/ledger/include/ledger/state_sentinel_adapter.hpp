@@ -19,17 +19,28 @@
 
 #include "ledger/state_adapter.hpp"
 
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
 namespace fetch {
 namespace ledger {
 
 /**
  * Read / Write interface between the VM IO interface the and main ledger state database. Will
  * actively check to ensure reads and writes occur on permissible resources.
+ *
+ * The adapter lives for the duration of a single transaction. Each key is resolved (checked and
+ * mapped to its resource address) once, the values which have been read are cached and the writes
+ * are buffered, to be flushed to the storage engine as a single batch at the end of the
+ * transaction.
  */
 class StateSentinelAdapter : public StateAdapter
 {
 public:
-  using ResourceSet = TransactionSummary::ResourceSet;
+  using ResourceSet       = TransactionSummary::ResourceSet;
+  using ResourceAddresses = StorageInterface::ResourceAddresses;
 
   static constexpr char const *LOGGING_NAME = "StateSentinelAdapter";
 
@@ -40,16 +51,40 @@ public:
 
   ~StateSentinelAdapter() override;
 
+  void Flush();
+
   /// @name IO Observer Interface
   /// @{
-  Status Read(std::string const &key, void *data, uint64_t &size) override;
-  Status Write(std::string const &key, void const *data, uint64_t size) override;
   Status Exists(std::string const &key) override;
+  Status ReadView(std::string const &key, ConstByteArray &value) override;
+  Status WriteView(std::string const &key, ConstByteArray const &value) override;
   /// @}
 
 private:
-  bool                  IsAllowedResource(std::string const &key) const;
+  /// The state of a key which has been accessed by the transaction
+  struct Access
+  {
+    explicit Access(ResourceAddress resource_address)
+      : address{std::move(resource_address)}
+    {}
+
+    ResourceAddress address;
+    ConstByteArray  value{};
+    bool            loaded{false};  ///< Whether the value (or its absence) is known
+    bool            exists{false};  ///< Whether the key has a value
+    bool            dirty{false};   ///< Whether the value must be written back to the storage
+  };
+
+  using Accesses  = std::unordered_map<std::string, Access>;
+  using KeyValues = StorageInterface::KeyValues;
+
+  bool              IsAllowedResource(std::string const &key) const;
+  ResourceAddresses LockedAddresses() const;
+  Access *          LookupAccess(std::string const &key);
+  void              Load(Access &access);
+
   std::set<std::string> allowed_accesses_;
+  Accesses              accesses_{};  ///< The keys accessed so far, by scoped key
 };
 
 }  // namespace ledger
@@ -39,6 +39,8 @@ public:
   ~CachedStorageAdapter();
 
   void Flush();
+  void Prefetch(ResourceAddresses const &keys);
+  void Prefill(KeyValues const &values);
 
   /// @name State Interface
   /// @{
@@ -49,6 +51,12 @@ public:
   bool     Unlock(ResourceAddress const &key) override;
   /// @}
 
+  /// @name Bulk State Interface
+  /// @{
+  bool LockBulk(ResourceAddresses const &keys) override;
+  bool UnlockBulk(ResourceAddresses const &keys) override;
+  /// @}
+
 private:
   struct CacheEntry
   {
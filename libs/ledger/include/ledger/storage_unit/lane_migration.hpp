@@ -0,0 +1,42 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/storage_unit/local_lane.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * The outcome of migrating the objects of one lane into another
+ */
+struct LaneMigrationReport
+{
+  bool        success{false};
+  std::size_t state_entries{0};  ///< The state entries merged into the target lane
+  std::size_t transactions{0};   ///< The transactions copied into the target lane
+};
+
+LaneMigrationReport MigrateLane(LocalLane const &source, LocalLane const &target,
+                                uint32_t log2_num_lanes);
+
+}  // namespace ledger
+}  // namespace fetch
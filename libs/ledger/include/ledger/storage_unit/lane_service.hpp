@@ -20,6 +20,7 @@
 #include "core/reactor.hpp"
 #include "ledger/chain/transaction.hpp"
 #include "ledger/shard_config.hpp"
+#include "ledger/storage_unit/local_lane.hpp"
 #include "network/generics/backgrounded_work.hpp"
 #include "network/generics/has_worker_thread.hpp"
 #include "network/muddle/muddle.hpp"
@@ -34,7 +35,8 @@ namespace fetch {
 namespace muddle {
 namespace rpc {
 class Server;
-}
+class Client;
+}  // namespace rpc
 }  // namespace muddle
 
 namespace storage {
@@ -58,6 +60,7 @@ class LaneController;
 class LaneControllerProtocol;
 class LaneIdentity;
 class LaneIdentityProtocol;
+class StateSnapshotProtocol;
 
 class LaneService
 {
@@ -67,6 +70,8 @@ public:
   using Muddle         = muddle::Muddle;
   using CertificatePtr = Muddle::CertificatePtr;
   using NetworkManager = network::NetworkManager;
+  using Address        = Muddle::Address;
+  using Hash           = byte_array::ConstByteArray;
 
   enum class Mode
   {
@@ -87,6 +92,12 @@ public:
 
   bool SyncIsReady();
 
+  // State Snapshots
+  bool SyncStateSnapshot(Address const &peer, Hash const &state_hash);
+
+  // In-process access
+  LocalLane AsLocalLane() const;
+
   ShardConfig const &config() const
   {
     return cfg_;
@@ -100,6 +111,8 @@ private:
   using MuddlePtr                 = std::shared_ptr<Muddle>;
   using Server                    = fetch::muddle::rpc::Server;
   using ServerPtr                 = std::shared_ptr<Server>;
+  using Client                    = fetch::muddle::rpc::Client;
+  using ClientPtr                 = std::shared_ptr<Client>;
   using StateDb                   = storage::NewRevertibleDocumentStore;
   using StateDbProto              = storage::RevertibleDocumentStoreProtocol;
   using TxStore                   = storage::TransientObjectStore<VerifiedTransaction>;
@@ -111,6 +124,7 @@ private:
   using LaneControllerProtocolPtr = std::shared_ptr<LaneControllerProtocol>;
   using StateDbPtr                = std::shared_ptr<StateDb>;
   using StateDbProtoPtr           = std::shared_ptr<StateDbProto>;
+  using SnapshotProtoPtr          = std::shared_ptr<StateSnapshotProtocol>;
   using TxStorePtr                = std::shared_ptr<TxStore>;
   using TxStoreProtoPtr           = std::shared_ptr<TxStoreProto>;
   using TxSyncProtoPtr            = std::shared_ptr<TransactionStoreSyncProtocol>;
@@ -118,7 +132,8 @@ private:
   using LaneIdentityPtr           = std::shared_ptr<LaneIdentity>;
   using LaneIdentityProtocolPtr   = std::shared_ptr<LaneIdentityProtocol>;
 
-  static constexpr unsigned int SYNC_PERIOD_MS = 500;
+  static constexpr unsigned int SYNC_PERIOD_MS     = 500;
+  static constexpr uint32_t     SNAPSHOT_TIMEOUT_MS = 30000;
 
   TxStorePtr tx_store_;
 
@@ -158,6 +173,12 @@ private:
   StateDbProtoPtr state_db_protocol_;
   /// @}
 
+  /// @name State Snapshots
+  /// @{
+  SnapshotProtoPtr snapshot_protocol_;
+  ClientPtr        snapshot_client_;
+  /// @}
+
   /// @name Transaction Store
   /// @{
   TxStoreProtoPtr  tx_store_protocol_;
@@ -0,0 +1,51 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/chain/transaction.hpp"
+#include "storage/document_store_protocol.hpp"
+#include "storage/new_revertible_document_store.hpp"
+#include "storage/transient_object_store.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * The stores of a lane running in the same process as its clients. Clients call into these
+ * directly rather than serialising their requests over the internal muddle.
+ */
+struct LocalLane
+{
+  using StateDb      = storage::NewRevertibleDocumentStore;
+  using StateDbProto = storage::RevertibleDocumentStoreProtocol;
+  using TxStore      = storage::TransientObjectStore<VerifiedTransaction>;
+
+  uint32_t                      lane{0};
+  std::shared_ptr<StateDb>      state_db{};
+  std::shared_ptr<StateDbProto> state_db_protocol{};  ///< Owns the resource locks of the lane
+  std::shared_ptr<TxStore>      tx_store{};
+};
+
+using LocalLanes = std::vector<LocalLane>;
+
+}  // namespace ledger
+}  // namespace fetch
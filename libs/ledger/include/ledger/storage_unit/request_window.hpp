@@ -0,0 +1,80 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include <chrono>
+#include <cstddef>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * An adaptive limit on the number of requests in flight to a single peer.
+ *
+ * The window grows by one for every response which arrives while the smoothed round trip time is
+ * close to the lowest observed round trip time, i.e. while the peer is not queuing the requests.
+ * When the smoothed round trip time shows the peer is queuing requests the window shrinks by one,
+ * and it is halved when a request fails or times out.
+ */
+class RequestWindow
+{
+public:
+  using Clock    = std::chrono::steady_clock;
+  using Duration = Clock::duration;
+
+  /// The ratio of the smoothed to the lowest round trip time above which requests are queuing
+  static constexpr std::size_t QUEUING_FACTOR = 2;
+
+  // Construction / Destruction
+  RequestWindow(std::size_t initial, std::size_t maximum);
+  RequestWindow(RequestWindow const &) = default;
+  RequestWindow(RequestWindow &&)      = default;
+  ~RequestWindow()                     = default;
+
+  /// @name Request Lifecycle
+  /// @{
+  bool CanSend() const;
+  void OnSent();
+  void OnResponse(Duration const &rtt);
+  void OnFailure();
+  /// @}
+
+  /// @name Accessors
+  /// @{
+  std::size_t window() const;
+  std::size_t in_flight() const;
+  Duration    smoothed_rtt() const;
+  /// @}
+
+  // Operators
+  RequestWindow &operator=(RequestWindow const &) = default;
+  RequestWindow &operator=(RequestWindow &&) = default;
+
+private:
+  void OnCompleted();
+
+  std::size_t window_;                          ///< The number of requests allowed in flight
+  std::size_t maximum_;                         ///< The upper bound of the window
+  std::size_t in_flight_{0};                    ///< The number of requests currently in flight
+  Duration    min_rtt_{Duration::max()};        ///< The lowest observed round trip time
+  Duration    smoothed_rtt_{Duration::zero()};  ///< The moving average of the round trip time
+};
+
+}  // namespace ledger
+}  // namespace fetch
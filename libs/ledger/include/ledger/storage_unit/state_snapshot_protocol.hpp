@@ -0,0 +1,75 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "core/mutex.hpp"
+#include "network/service/protocol.hpp"
+#include "storage/state_snapshot.hpp"
+
+namespace fetch {
+namespace storage {
+class NewRevertibleDocumentStore;
+}  // namespace storage
+
+namespace ledger {
+
+/**
+ * Serves snapshots of the lane state to peers so that they can fast sync the state of the lane
+ * without re-executing the chain. Peers first request the manifest for a given state hash and then
+ * pull each of the chunks in turn.
+ */
+class StateSnapshotProtocol : public fetch::service::Protocol
+{
+public:
+  enum
+  {
+    GET_MANIFEST = 1,
+    GET_CHUNK    = 2
+  };
+
+  using StateDb  = storage::NewRevertibleDocumentStore;
+  using Hash     = byte_array::ConstByteArray;
+  using Manifest = storage::StateSnapshotManifest;
+  using Chunk    = storage::StateSnapshotChunk;
+
+  static constexpr char const *LOGGING_NAME      = "StateSnapshotProtocol";
+  static constexpr std::size_t ENTRIES_PER_CHUNK = 1000;
+
+  // Construction / Destruction
+  explicit StateSnapshotProtocol(StateDb &state_db);
+  StateSnapshotProtocol(StateSnapshotProtocol const &) = delete;
+  StateSnapshotProtocol(StateSnapshotProtocol &&)      = delete;
+  ~StateSnapshotProtocol() override                    = default;
+
+  // Operators
+  StateSnapshotProtocol &operator=(StateSnapshotProtocol const &) = delete;
+  StateSnapshotProtocol &operator=(StateSnapshotProtocol &&) = delete;
+
+private:
+  Manifest GetManifest(Hash const &hash);
+  Chunk    GetChunk(Hash const &hash, uint64_t index);
+
+  StateDb &state_db_;
+
+  mutex::Mutex           lock_{__LINE__, __FILE__};
+  storage::StateSnapshot snapshot_;  ///< The most recently requested snapshot
+};
+
+}  // namespace ledger
+}  // namespace fetch
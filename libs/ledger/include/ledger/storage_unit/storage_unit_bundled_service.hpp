@@ -27,6 +27,7 @@
 
 #include "ledger/shard_config.hpp"
 #include "ledger/storage_unit/lane_service.hpp"
+#include "ledger/storage_unit/local_lane.hpp"
 #include "ledger/storage_unit/storage_unit_interface.hpp"
 
 namespace fetch {
@@ -78,6 +79,24 @@ public:
     }
   }
 
+  /**
+   * Get the stores of all the lanes, so that clients in the same process can call them directly
+   *
+   * @return The stores of each of the lanes
+   */
+  LocalLanes GetLocalLanes() const
+  {
+    LocalLanes local_lanes;
+    local_lanes.reserve(lanes_.size());
+
+    for (auto const &lane : lanes_)
+    {
+      local_lanes.push_back(lane->AsLocalLane());
+    }
+
+    return local_lanes;
+  }
+
 private:
   using LaneServicePtr  = std::shared_ptr<LaneService>;
   using LaneServiceList = std::vector<LaneServicePtr>;
@@ -24,11 +24,13 @@
 #include "ledger/storage_unit/lane_identity.hpp"
 #include "ledger/storage_unit/lane_identity_protocol.hpp"
 #include "ledger/storage_unit/lane_service.hpp"
+#include "ledger/storage_unit/local_lane.hpp"
 #include "ledger/storage_unit/storage_unit_interface.hpp"
 #include "network/generics/backgrounded_work.hpp"
 #include "network/generics/future_timepoint.hpp"
 #include "network/generics/has_worker_thread.hpp"
 #include "network/management/connection_register.hpp"
+#include "network/service/call_context.hpp"
 #include "network/service/service_client.hpp"
 
 #include "ledger/chain/transaction.hpp"
@@ -42,9 +44,12 @@
 #include "core/serializers/typed_byte_array_buffer.hpp"
 #include "crypto/merkle_tree.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <functional>
 #include <thread>
 #include <utility>
+#include <vector>
 
 namespace fetch {
 namespace ledger {
@@ -66,6 +71,9 @@ public:
   // Helpers
   uint32_t num_lanes() const;
 
+  void AttachLocalLanes(LocalLanes const &lanes, Address const &identity);
+  bool Reshard(uint32_t log2_num_lanes);
+
   /// @name Storage Unit Interface
   /// @{
   void AddTransaction(VerifiedTransaction const &tx) override;
@@ -73,13 +81,19 @@ public:
 
   TxSummaries PollRecentTx(uint32_t max_to_poll) override;
 
-  bool GetTransaction(ConstByteArray const &digest, Transaction &tx) override;
-  bool HasTransaction(ConstByteArray const &digest) override;
+  bool      GetTransaction(ConstByteArray const &digest, Transaction &tx) override;
+  bool      HasTransaction(ConstByteArray const &digest) override;
+  TxDigests GetMissingTransactions(TxDigests const &digests) override;
 
   Document GetOrCreate(ResourceAddress const &key) override;
   Document Get(ResourceAddress const &key) override;
   void     Set(ResourceAddress const &key, StateValue const &value) override;
 
+  Documents GetBulk(ResourceAddresses const &keys) override;
+  void      SetBulk(KeyValues const &values) override;
+  bool      LockBulk(ResourceAddresses const &keys) override;
+  bool      UnlockBulk(ResourceAddresses const &keys) override;
+
   // state hash functions
   byte_array::ConstByteArray CurrentHash() override;
   byte_array::ConstByteArray LastCommitHash() override;
@@ -88,6 +102,12 @@ public:
   bool                       HashExists(Hash const &hash, uint64_t index) override;
   bool                       Lock(ResourceAddress const &key) override;
   bool                       Unlock(ResourceAddress const &key) override;
+
+  // state fork functions
+  bool BeginFork(Hash const &hash, uint64_t index) override;
+  void EndFork() override;
+  bool ApplyFork() override;
+  void DiscardFork() override;
   /// @}
 
   StorageUnitClient &operator=(StorageUnitClient const &) = delete;
@@ -99,6 +119,8 @@ private:
    */
   struct MerkleTreeBlock
   {
+    static constexpr std::size_t CAPACITY = 4096;  ///< Enough for the trees of 64 lanes
+
     MerkleTreeBlock()
     {
       std::memset(this, -1, sizeof(*this));
@@ -109,7 +131,12 @@ private:
       serializers::TypedByteArrayBuffer buff;
       buff << tree;
 
-      assert(buff.data().size() == 92 || buff.data().size() == 60);
+      if (buff.data().size() > CAPACITY)
+      {
+        FETCH_LOG_ERROR(LOGGING_NAME, "Merkle tree of ", tree.size(),
+                        " lanes is too large to be stored");
+        return;
+      }
 
       size_ = buff.data().size();
       std::memcpy((uint8_t *)data_, (uint8_t *)buff.data().pointer(), size_);
@@ -139,7 +166,7 @@ private:
     }
 
     uint64_t size_{0};
-    uint8_t  data_[92];
+    uint8_t  data_[CAPACITY];
   };
 
   using Client               = muddle::rpc::Client;
@@ -149,19 +176,37 @@ private:
   using MerkleTree           = crypto::MerkleTree;
   using PermanentMerkleStack = storage::RandomAccessStack<MerkleTreeBlock>;
   using Mutex                = fetch::mutex::Mutex;
+  using LaneFlags            = std::vector<bool>;
+  using Hashes               = std::vector<Hash>;
+  using LocalCall            = std::function<void(LocalLane::StateDb &)>;
 
   static constexpr char const *MERKLE_FILENAME = "merkle_stack.db";
 
   Address const &LookupAddress(LaneIndex lane) const;
   Address const &LookupAddress(storage::ResourceID const &resource) const;
+  LocalLane const *LookupLocal(LaneIndex lane) const;
+  LocalLane const *LookupLocal(storage::ResourceID const &resource) const;
 
   bool HashInStack(Hash const &hash, uint64_t index);
 
+  void      MarkDirty(LaneIndex lane);
+  void      MarkDirty(ResourceAddress const &key);
+  LaneFlags TakeDirtyLanes();
+
+  bool CallLockBulk(ResourceAddresses const &keys, bool lock);
+  void CallAllLanes(service::function_handler_type function, LocalCall const &local_call);
+
   /// @name Client Information
   /// @{
-  AddressList const addresses_;
-  uint32_t const    log2_num_lanes_ = 0;
-  Client            rpc_client_;
+  AddressList const     addresses_;       ///< One for each of the lanes provisioned
+  std::atomic<uint32_t> log2_num_lanes_;  ///< The lanes in use, may be fewer than provisioned
+  Client                rpc_client_;
+  /// @}
+
+  /// @name In-process Lanes
+  /// @{
+  LocalLanes           local_lanes_;      ///< Indexed by lane, empty for the remote lanes
+  service::CallContext local_context_{};  ///< Identifies this client to the local lane locks
   /// @}
 
   /// @name State Hash Support
@@ -169,6 +214,15 @@ private:
   mutable Mutex        merkle_mutex_{__LINE__, __FILE__};
   MerkleTree           current_merkle_;
   PermanentMerkleStack permanent_state_merkle_stack_{};
+  bool                 lane_roots_valid_{false};      ///< Leaves match the current lane states
+  bool                 merkle_levels_cached_{false};  ///< Tree levels are cached for leaf updates
+  Hashes               fork_bases_{};  ///< The lane states the current fork was made from
+  /// @}
+
+  /// @name Lane Modification Tracking
+  /// @{
+  Mutex     dirty_mutex_{__LINE__, __FILE__};
+  LaneFlags dirty_lanes_;  ///< The lanes modified since their last commit or revert
   /// @}
 };
 
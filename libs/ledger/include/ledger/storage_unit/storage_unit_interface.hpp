@@ -22,6 +22,7 @@
 #include "storage/document.hpp"
 #include "storage/resource_mapper.hpp"
 
+#include <utility>
 #include <vector>
 
 namespace fetch {
@@ -30,9 +31,12 @@ namespace ledger {
 class StorageInterface
 {
 public:
-  using Document        = storage::Document;
-  using ResourceAddress = storage::ResourceAddress;
-  using StateValue      = byte_array::ConstByteArray;
+  using Document          = storage::Document;
+  using ResourceAddress   = storage::ResourceAddress;
+  using StateValue        = byte_array::ConstByteArray;
+  using ResourceAddresses = std::vector<ResourceAddress>;
+  using Documents         = std::vector<Document>;
+  using KeyValues         = std::vector<std::pair<ResourceAddress, StateValue>>;
 
   /// @name State Interface
   /// @{
@@ -42,6 +46,54 @@ public:
   virtual bool     Lock(ResourceAddress const &key)                         = 0;
   virtual bool     Unlock(ResourceAddress const &key)                       = 0;
   /// @}
+
+  /// @name Bulk State Interface
+  /// @{
+  virtual Documents GetBulk(ResourceAddresses const &keys)
+  {
+    Documents documents;
+    documents.reserve(keys.size());
+
+    for (auto const &key : keys)
+    {
+      documents.emplace_back(Get(key));
+    }
+
+    return documents;
+  }
+
+  virtual void SetBulk(KeyValues const &values)
+  {
+    for (auto const &value : values)
+    {
+      Set(value.first, value.second);
+    }
+  }
+
+  virtual bool LockBulk(ResourceAddresses const &keys)
+  {
+    bool success{true};
+
+    for (auto const &key : keys)
+    {
+      success &= Lock(key);
+    }
+
+    return success;
+  }
+
+  virtual bool UnlockBulk(ResourceAddresses const &keys)
+  {
+    bool success{true};
+
+    for (auto const &key : keys)
+    {
+      success &= Unlock(key);
+    }
+
+    return success;
+  }
+  /// @}
 };
 
 class StorageUnitInterface : public StorageInterface
@@ -51,6 +103,7 @@ public:
   using TransactionList = std::vector<Transaction>;
   using ConstByteArray  = byte_array::ConstByteArray;
   using TxSummaries     = std::vector<TransactionSummary>;
+  using TxDigests       = std::vector<ConstByteArray>;
 
   // Construction / Destruction
   StorageUnitInterface()          = default;
@@ -69,6 +122,26 @@ public:
       AddTransaction(tx);
     }
   }
+
+  /**
+   * Determine which of a set of transactions are not present in storage
+   *
+   * @param digests The digests of the transactions to be checked
+   * @return The digests of the missing transactions
+   */
+  virtual TxDigests GetMissingTransactions(TxDigests const &digests)
+  {
+    TxDigests missing{};
+    for (auto const &digest : digests)
+    {
+      if (!HasTransaction(digest))
+      {
+        missing.push_back(digest);
+      }
+    }
+
+    return missing;
+  }
   /// @}
 
   virtual TxSummaries PollRecentTx(uint32_t) = 0;
@@ -81,6 +154,46 @@ public:
   virtual Hash Commit(uint64_t index)                         = 0;
   virtual bool HashExists(Hash const &hash, uint64_t index)   = 0;
   /// @}
+
+  /// @name State Forks
+  /// @{
+
+  /**
+   * Start executing on a fork of a previous state, without modifying the current state. Storage
+   * units which do not support forks always fail.
+   *
+   * @param hash The merkle hash of the state to fork from
+   * @param index The block index of the state
+   * @return true if successful, otherwise false
+   */
+  virtual bool BeginFork(Hash const & /*hash*/, uint64_t /*index*/)
+  {
+    return false;
+  }
+
+  /**
+   * Stop executing on the fork, keeping its changes
+   */
+  virtual void EndFork()
+  {}
+
+  /**
+   * Apply the changes of the fork on top of the current state, which must have been reverted to
+   * the state the fork was made from
+   *
+   * @return true if successful, otherwise false
+   */
+  virtual bool ApplyFork()
+  {
+    return false;
+  }
+
+  /**
+   * Drop the fork and its changes
+   */
+  virtual void DiscardFork()
+  {}
+  /// @}
 };
 
 }  // namespace ledger
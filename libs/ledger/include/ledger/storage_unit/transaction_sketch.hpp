@@ -0,0 +1,114 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/serializers/stl_types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * An invertible bloom lookup table of the short ids of a set of transactions.
+ *
+ * Two peers which each build a sketch of their recent transactions can subtract one from the other
+ * and decode the result, which yields the short ids present on only one side. The size of the
+ * sketch is fixed by the number of cells, not by the size of the set, and decoding succeeds with
+ * high probability as long as the size of the difference is below roughly two thirds of the
+ * number of cells.
+ */
+class TransactionSketch
+{
+public:
+  using ShortId  = uint64_t;
+  using ShortIds = std::vector<ShortId>;
+
+  /// The number of cells each short id is added to
+  static constexpr std::size_t NUM_HASHES = 3;
+
+  struct Cell
+  {
+    int64_t  count{0};     ///< The number of short ids added less the number removed
+    uint64_t id_sum{0};    ///< The XOR of the short ids in the cell
+    uint64_t hash_sum{0};  ///< The XOR of the check hashes of the short ids in the cell
+  };
+
+  using Cells = std::vector<Cell>;
+
+  // Construction / Destruction
+  explicit TransactionSketch(std::size_t num_cells = 0);
+  TransactionSketch(TransactionSketch const &) = default;
+  TransactionSketch(TransactionSketch &&)      = default;
+  ~TransactionSketch()                         = default;
+
+  void Insert(ShortId id);
+  void Erase(ShortId id);
+  bool Subtract(TransactionSketch const &other);
+  bool Decode(ShortIds &positive, ShortIds &negative) const;
+
+  /// @name Accessors
+  /// @{
+  std::size_t  num_cells() const;
+  bool         empty() const;
+  Cells const &cells() const;
+  /// @}
+
+  // Operators
+  TransactionSketch &operator=(TransactionSketch const &) = default;
+  TransactionSketch &operator=(TransactionSketch &&) = default;
+
+private:
+  void Update(ShortId id, int64_t delta);
+
+  Cells cells_;
+
+  template <typename T>
+  friend void Serialize(T &serializer, TransactionSketch const &sketch);
+  template <typename T>
+  friend void Deserialize(T &serializer, TransactionSketch &sketch);
+};
+
+template <typename T>
+void Serialize(T &serializer, TransactionSketch::Cell const &cell)
+{
+  serializer << cell.count << cell.id_sum << cell.hash_sum;
+}
+
+template <typename T>
+void Deserialize(T &serializer, TransactionSketch::Cell &cell)
+{
+  serializer >> cell.count >> cell.id_sum >> cell.hash_sum;
+}
+
+template <typename T>
+void Serialize(T &serializer, TransactionSketch const &sketch)
+{
+  serializer << sketch.cells_;
+}
+
+template <typename T>
+void Deserialize(T &serializer, TransactionSketch &sketch)
+{
+  serializer >> sketch.cells_;
+}
+
+}  // namespace ledger
+}  // namespace fetch
@@ -20,7 +20,9 @@
 #include "core/logger.hpp"
 #include "ledger/chain/transaction.hpp"
 #include "ledger/storage_unit/lane_connectivity_details.hpp"
+#include "ledger/storage_unit/transaction_sketch.hpp"
 #include "ledger/storage_unit/transaction_sinks.hpp"
+#include "ledger/transaction_summary_cache.hpp"
 #include "ledger/transaction_verifier.hpp"
 #include "metrics/metrics.hpp"
 #include "network/details/thread_pool.hpp"
@@ -46,23 +48,31 @@ class TransactionStoreSyncProtocol : public fetch::service::Protocol
 public:
   enum
   {
-    OBJECT_COUNT = 1,
-    PULL_OBJECTS = 2,
-    PULL_SUBTREE = 3
+    OBJECT_COUNT          = 1,
+    PULL_OBJECTS          = 2,
+    PULL_SUBTREE          = 3,
+    PULL_SKETCH           = 4,
+    PULL_SPECIFIC_OBJECTS = 5
   };
 
   using ObjectStore = storage::TransientObjectStore<VerifiedTransaction>;
+  using ShortIds    = TransactionSketch::ShortIds;
 
   static constexpr char const *LOGGING_NAME = "ObjectStoreSyncProtocol";
 
+  /// The number of cells of the sketch of the recent transactions, enough to reconcile a
+  /// difference of about two hundred transactions
+  static constexpr std::size_t SKETCH_CELLS = 300;
+
   // Construction / Destruction
   TransactionStoreSyncProtocol(ObjectStore *store, int lane_id);
   TransactionStoreSyncProtocol(TransactionStoreSyncProtocol const &) = delete;
   TransactionStoreSyncProtocol(TransactionStoreSyncProtocol &&)      = delete;
   ~TransactionStoreSyncProtocol() override                           = default;
 
-  void OnNewTx(VerifiedTransaction const &o);
-  void TrimCache();
+  void              OnNewTx(VerifiedTransaction const &o);
+  void              TrimCache();
+  TransactionSketch RecentSketch();
 
   // Operators
   TransactionStoreSyncProtocol &operator=(TransactionStoreSyncProtocol const &) = delete;
@@ -86,6 +96,7 @@ private:
     {}
 
     UnverifiedTransaction data;
+    uint64_t              short_id{TransactionSummaryCache::ComputeShortId(data.digest())};
     AddressSet            delivered_to;
     Timepoint             created{Clock::now()};
   };
@@ -98,14 +109,17 @@ private:
 
   TxList PullSubtree(byte_array::ConstByteArray const &rid, uint64_t mask);
 
+  TxList PullSpecificObjects(service::CallContext const *call_context, ShortIds const &ids);
+
   // TODO(issue 7): Make cache configurable
   static constexpr uint32_t MAX_CACHE_ELEMENTS    = 2000;  // really a "max"?
   static constexpr uint32_t MAX_CACHE_LIFETIME_MS = 20000;
 
   ObjectStore *store_;  ///< The pointer to the object store
 
-  mutex::Mutex cache_mutex_{__LINE__, __FILE__};  ///< The mutex protecting cache_
-  Cache        cache_;
+  mutex::Mutex      cache_mutex_{__LINE__, __FILE__};  ///< The mutex protecting cache_
+  Cache             cache_;
+  TransactionSketch sketch_{SKETCH_CELLS};  ///< The sketch of the short ids in the cache
 
   int id_;
 };
@@ -21,6 +21,7 @@
 #include "core/state_machine.hpp"
 #include "ledger/chain/transaction.hpp"
 #include "ledger/storage_unit/lane_controller.hpp"
+#include "ledger/storage_unit/request_window.hpp"
 #include "ledger/storage_unit/transaction_sinks.hpp"
 #include "ledger/transaction_verifier.hpp"
 #include "network/generics/future_timepoint.hpp"
@@ -32,6 +33,7 @@
 #include "transaction_store_sync_protocol.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <unordered_map>
 
 namespace fetch {
@@ -45,7 +47,9 @@ enum class State
   RESOLVING_OBJECT_COUNTS,
   QUERY_SUBTREE,
   RESOLVING_SUBTREE,
+  PIPELINED_SUBTREE,
   QUERY_OBJECTS,
+  RESOLVING_SKETCHES,
   RESOLVING_OBJECTS,
   TRIM_CACHE
 };
@@ -71,6 +75,9 @@ public:
   using Mutex                 = mutex::Mutex;
   using EventNewTransaction   = std::function<void(VerifiedTransaction const &)>;
   using TrimCacheCallback     = std::function<void()>;
+  using RecentSketchCallback  = std::function<TransactionSketch()>;
+  using RequestingSketch      = network::RequestingQueueOf<Address, TransactionSketch>;
+  using PromiseOfSketch       = network::PromiseOf<TransactionSketch>;
   using State                 = tx_sync::State;
   using StateMachine          = core::StateMachine<State>;
   using ObjectStorePtr        = std::shared_ptr<ObjectStore>;
@@ -80,9 +87,19 @@ public:
   static constexpr std::size_t MAX_OBJECT_COUNT_RESOLUTION_PER_CYCLE = 128;
   static constexpr std::size_t MAX_SUBTREE_RESOLUTION_PER_CYCLE      = 128;
   static constexpr std::size_t MAX_OBJECT_RESOLUTION_PER_CYCLE       = 128;
+  static constexpr std::size_t MAX_SKETCH_RESOLUTION_PER_CYCLE       = 128;
   static constexpr uint64_t PULL_LIMIT_ = 10000;  // Limit the amount a single rpc call will provide
   static const std::size_t  BATCH_SIZE;
 
+  /// The number of bits of the prefix of a subtree, which is a single byte
+  static constexpr uint64_t MAX_SUBTREE_ROOT_BITS = 8;
+
+  enum class SyncMode
+  {
+    BATCHED,    ///< The subtrees are requested in rounds of one request per peer
+    PIPELINED,  ///< Each peer is kept busy with an adaptive window of subtree requests
+  };
+
   struct Config
   {
     uint32_t                  lane_id{0};
@@ -90,6 +107,10 @@ public:
     std::chrono::milliseconds main_timeout{5000};
     std::chrono::milliseconds promise_wait_timeout{2000};
     std::chrono::milliseconds fetch_object_wait_duration{5000};
+    SyncMode                  sync_mode{SyncMode::BATCHED};
+    std::size_t               max_requests_per_peer{16};  ///< The (pipelined) window limit
+    bool                      reconcile_recent{false};    ///< Reconcile sketches of recent objects
+    VerifiedDigestCache *     verified_cache{nullptr};    ///< The digests verified before
   };
 
   TransactionStoreSyncService(Config const &cfg, MuddlePtr muddle, ObjectStorePtr store);
@@ -110,6 +131,11 @@ public:
     trim_cache_callback_ = callback;
   }
 
+  void SetRecentSketchCallback(RecentSketchCallback const &callback)
+  {
+    recent_sketch_callback_ = callback;
+  }
+
   // We need this for the testing.
   bool IsReady()
   {
@@ -151,7 +177,9 @@ private:
   State OnResolvingObjectCounts();
   State OnQuerySubtree();
   State OnResolvingSubtree();
+  State OnPipelinedSubtree();
   State OnQueryObjects();
+  State OnResolvingSketches();
   State OnResolvingObjects();
   State OnTrimCache();
 
@@ -172,12 +200,28 @@ private:
 
   RequestingSubTreeList pending_subtree_;
   RequestingTxList      pending_objects_;
+  RequestingSketch      pending_sketches_;
 
   std::queue<uint8_t>                                          roots_to_sync_;
   uint64_t                                                     root_size_ = 0;
   std::unordered_map<PromiseOfTxList::PromiseCounter, uint8_t> promise_id_to_roots_;
 
-  TrimCacheCallback trim_cache_callback_;
+  /// A subtree request of the pipelined sync
+  struct SubtreeRequest
+  {
+    Address                          peer;
+    PromiseOfTxList                  promise;
+    RequestWindow::Clock::time_point sent;
+  };
+
+  using SubtreeRequests = std::unordered_map<uint8_t, SubtreeRequest>;
+  using PeerWindows     = std::unordered_map<Address, RequestWindow>;
+
+  SubtreeRequests subtree_requests_;  ///< The (pipelined) subtree requests in flight, by root
+  PeerWindows     peer_windows_;      ///< The request window of each peer
+
+  TrimCacheCallback    trim_cache_callback_;
+  RecentSketchCallback recent_sketch_callback_;
 
   Mutex mutex_{__LINE__, __FILE__};
 
@@ -0,0 +1,125 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/mutex.hpp"
+#include "crypto/fnv.hpp"
+#include "ledger/chain/block.hpp"
+#include "storage/mmap_random_access_stack.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * A secondary index of the executed transactions, keyed by the addresses (resources) that each
+ * transaction touches.
+ *
+ * The index is append-only. Every (address, transaction) pair is written as a fixed size record to
+ * a memory mapped log, while an in memory table maps each address to the positions of its records
+ * sorted by block number. The table is rebuilt from the log when the index is loaded, so that
+ * range queries never need to scan the transaction store.
+ *
+ * Since records are never removed, transactions of blocks that were executed and later abandoned
+ * by a fork remain in the index. Adding the same transaction at the same block number twice (for
+ * example when a block is executed again) is a no-op.
+ */
+class TransactionAddressIndex
+{
+public:
+  static constexpr char const *LOGGING_NAME = "TxAddressIndex";
+  static constexpr std::size_t HASH_SIZE    = 32;
+
+  using Address   = byte_array::ConstByteArray;
+  using TxDigest  = TransactionSummary::TxDigest;
+  using Addresses = std::vector<Address>;
+
+  struct Entry
+  {
+    TxDigest digest;
+    uint64_t block_number{0};
+  };
+
+  using Entries = std::vector<Entry>;
+
+  // Construction / Destruction
+  TransactionAddressIndex()                                = default;
+  TransactionAddressIndex(TransactionAddressIndex const &) = delete;
+  TransactionAddressIndex(TransactionAddressIndex &&)      = delete;
+  ~TransactionAddressIndex()                               = default;
+
+  /// @name Persistence
+  /// @{
+  void New(std::string const &filename);
+  bool Load(std::string const &filename);
+  void Flush();
+  /// @}
+
+  /// @name Indexing
+  /// @{
+  void        Add(Block const &block);
+  void        Add(TxDigest const &digest, Addresses const &addresses, uint64_t block_number);
+  std::size_t Query(Address const &address, uint64_t from, uint64_t to, std::size_t offset,
+                    std::size_t limit, Entries &entries) const;
+  std::size_t size() const;
+  /// @}
+
+  // Operators
+  TransactionAddressIndex &operator=(TransactionAddressIndex const &) = delete;
+  TransactionAddressIndex &operator=(TransactionAddressIndex &&) = delete;
+
+private:
+  static constexpr uint64_t VERSION = 1;
+
+  struct Record
+  {
+    uint8_t  address[HASH_SIZE];  ///< The hash of the address
+    uint8_t  digest[HASH_SIZE];   ///< The digest of the transaction
+    uint64_t block_number;
+  };
+
+  struct Position
+  {
+    uint64_t block_number;
+    uint64_t record;  ///< The index of the record in the log
+  };
+
+  using Positions = std::vector<Position>;
+  using Table     = std::unordered_map<byte_array::ConstByteArray, Positions>;
+  using Indexed   = std::unordered_multimap<TxDigest, uint64_t>;
+  using Stack     = storage::MMapRandomAccessStack<Record>;
+  using Mutex     = mutex::Mutex;
+
+  static byte_array::ConstByteArray Key(Address const &address);
+
+  bool AddLocked(TxDigest const &digest, Addresses const &addresses, uint64_t block_number);
+  bool MarkIndexed(TxDigest const &digest, uint64_t block_number);
+
+  mutable Mutex lock_{__LINE__, __FILE__};
+  mutable Stack stack_;    ///< The log of records
+  Table         table_;    ///< The positions of the records of each address
+  Indexed       indexed_;  ///< The block numbers each transaction has been indexed at
+};
+
+}  // namespace ledger
+}  // namespace fetch
@@ -29,18 +29,23 @@ namespace ledger {
 class StorageUnitInterface;
 class BlockPackerInterface;
 class TransactionStatusCache;
+class TransactionSummaryCache;
+class VerifiedDigestCache;
 
 class TransactionProcessor : public UnverifiedTransactionSink, public VerifiedTransactionSink
 {
 public:
   using ThreadPtr       = std::unique_ptr<std::thread>;
   using TransactionList = std::vector<Transaction>;
+  using MutableTxList   = TransactionVerifier::MutableTxList;
 
   static constexpr char const *LOGGING_NAME = "TransactionProcessor";
 
   // Construction / Destruction
   TransactionProcessor(StorageUnitInterface &storage, BlockPackerInterface &packer,
-                       TransactionStatusCache &tx_status_cache, std::size_t num_threads);
+                       TransactionStatusCache &tx_status_cache, std::size_t num_threads,
+                       TransactionSummaryCache *tx_summary_cache = nullptr,
+                       VerifiedDigestCache *    verified_cache   = nullptr);
   TransactionProcessor(TransactionProcessor const &) = delete;
   TransactionProcessor(TransactionProcessor &&)      = delete;
   ~TransactionProcessor() override;
@@ -55,8 +60,12 @@ public:
   /// @{
   void AddTransaction(MutableTransaction const &mtx);
   void AddTransaction(MutableTransaction &&mtx);
+  void AddTransactions(MutableTxList &&txs);
   /// @}
 
+  std::size_t GetBacklog() const;
+  std::size_t GetVerifierBacklog() const;
+
   // Operators
   TransactionProcessor &operator=(TransactionProcessor const &) = delete;
   TransactionProcessor &operator=(TransactionProcessor &&) = delete;
@@ -74,16 +83,20 @@ protected:
   /// @}
 
 private:
-  using Flag = std::atomic<bool>;
-
-  StorageUnitInterface &  storage_;
-  BlockPackerInterface &  packer_;
-  TransactionStatusCache &status_cache_;
-  TransactionVerifier     verifier_;
-  ThreadPtr               poll_new_tx_thread_;
-  Flag                    running_{false};
+  using Flag      = std::atomic<bool>;
+  using Summaries = std::vector<TransactionSummary>;
+  using Digests   = std::vector<TransactionSummary::TxDigest>;
+
+  StorageUnitInterface &   storage_;
+  BlockPackerInterface &   packer_;
+  TransactionStatusCache & status_cache_;
+  TransactionSummaryCache *summary_cache_;
+  TransactionVerifier      verifier_;
+  ThreadPtr                poll_new_tx_thread_;
+  Flag                     running_{false};
 
   void ThreadEntryPoint();
+  void Enqueue(Summaries const &summaries);
 };
 
 /**
@@ -132,5 +145,15 @@ inline void TransactionProcessor::AddTransaction(MutableTransaction &&mtx)
   verifier_.AddTransaction(std::move(mtx));
 }
 
+/**
+ * Add a batch of transactions to the processor
+ *
+ * @param txs The transactions to be processed, which are moved from
+ */
+inline void TransactionProcessor::AddTransactions(MutableTxList &&txs)
+{
+  verifier_.AddTransactions(std::move(txs));
+}
+
 }  // namespace ledger
 }  // namespace fetch
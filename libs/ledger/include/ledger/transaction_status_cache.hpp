@@ -21,8 +21,15 @@
 #include "core/threading/synchronised_state.hpp"
 #include "ledger/chain/mutable_transaction.hpp"
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace fetch {
 namespace ledger {
@@ -36,14 +43,28 @@ enum class TransactionStatus
 };
 
 char const *ToString(TransactionStatus status);
+bool        FromString(std::string const &text, TransactionStatus &status);
 
 class TransactionStatusCache
 {
 public:
   using TxDigest  = TransactionSummary::TxDigest;
+  using TxDigests = std::vector<TxDigest>;
   using Clock     = std::chrono::steady_clock;
   using Timepoint = Clock::time_point;
 
+  /// Called once, outside of the locks of the cache, with the first change to a subscribed status
+  using Notification = std::function<void(TxDigest const &digest, TransactionStatus status)>;
+
+  struct Subscription
+  {
+    TxDigests         digests;
+    Notification      notification;
+    std::atomic<bool> active{true};
+  };
+
+  using SubscriptionPtr = std::shared_ptr<Subscription>;
+
   // Construction / Destruction
   TransactionStatusCache()                               = default;
   TransactionStatusCache(TransactionStatusCache const &) = delete;
@@ -52,13 +73,25 @@ public:
 
   TransactionStatus Query(TxDigest digest) const;
   void Update(TxDigest digest, TransactionStatus status, Timepoint const &now = Clock::now());
+  void Update(TxDigests const &digests, TransactionStatus status,
+              Timepoint const &now = Clock::now());
+
+  /// @name Subscriptions
+  /// @{
+  SubscriptionPtr Subscribe(TxDigests digests, Notification notification);
+  void            Unsubscribe(SubscriptionPtr const &subscription);
+  /// @}
 
   // Operators
   TransactionStatusCache &operator=(TransactionStatusCache const &) = delete;
   TransactionStatusCache &operator=(TransactionStatusCache &&) = delete;
 
 private:
-  using Mutex = mutex::Mutex;
+  static constexpr std::size_t NUM_SHARDS = 16;
+
+  using Mutex       = mutex::Mutex;
+  using Ticks       = Clock::rep;
+  using AtomicTicks = std::atomic<Ticks>;
 
   struct Element
   {
@@ -66,13 +99,53 @@ private:
     Timepoint         timestamp{Clock::now()};
   };
 
-  using Cache = std::unordered_map<TxDigest, Element>;
+  /**
+   * A bucket collects all the digests which were updated during a single pruning interval. Once
+   * the whole interval has expired all the elements which have not been updated since can be
+   * evicted without having to walk the complete cache.
+   */
+  struct Bucket
+  {
+    using Digests = std::vector<TxDigest>;
+
+    Timepoint start;
+    Digests   digests;
+  };
 
+  /// A status change which has triggered a subscription
+  struct Event
+  {
+    SubscriptionPtr   subscription;
+    TxDigest          digest;
+    TransactionStatus status;
+  };
+
+  using Cache       = std::unordered_map<TxDigest, Element>;
+  using Buckets     = std::deque<Bucket>;
+  using Subscribers = std::unordered_map<TxDigest, std::vector<SubscriptionPtr>>;
+  using Events      = std::vector<Event>;
+
+  struct Shard
+  {
+    mutable Mutex mtx{__LINE__, __FILE__};
+    Cache         cache{};
+    Buckets       buckets{};
+    Subscribers   subscribers{};  ///< The subscriptions waiting on the digests of the shard
+  };
+
+  using Shards = std::array<Shard, NUM_SHARDS>;
+
+  void UpdateShard(Shard &shard, TxDigest digest, TransactionStatus status, Timepoint const &now,
+                   Events &events);
+  void Notify(Events const &events);
+  void PruneIfRequired(Timepoint const &now);
   void PruneCache(Timepoint const &now);
 
-  mutable Mutex mtx_{__LINE__, __FILE__};
-  Cache         cache_{};
-  Timepoint     last_clean_{Clock::now()};
+  static std::size_t ShardIndex(TxDigest const &digest);
+  static Ticks       ToTicks(Timepoint const &timepoint);
+
+  Shards      shards_{};
+  AtomicTicks last_clean_{ToTicks(Clock::now())};
 };
 
 }  // namespace ledger
@@ -0,0 +1,78 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/mutex.hpp"
+#include "ledger/chain/mutable_transaction.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * A bounded cache of the summaries of the transactions most recently seen by this node. The
+ * summaries are indexed by their short identifier so that compact blocks, which only reference
+ * the short identifiers of their transactions, can be rebuilt locally.
+ */
+class TransactionSummaryCache
+{
+public:
+  using TxDigest             = TransactionSummary::TxDigest;
+  using TransactionSummaries = std::vector<TransactionSummary>;
+  using ShortId              = uint64_t;
+
+  static constexpr std::size_t DEFAULT_CAPACITY = 100000;
+
+  // Construction / Destruction
+  explicit TransactionSummaryCache(std::size_t capacity = DEFAULT_CAPACITY);
+  TransactionSummaryCache(TransactionSummaryCache const &) = delete;
+  TransactionSummaryCache(TransactionSummaryCache &&)      = delete;
+  ~TransactionSummaryCache()                               = default;
+
+  void        Add(TransactionSummary const &summary);
+  void        Add(TransactionSummaries const &summaries);
+  bool        Lookup(ShortId id, TransactionSummary &summary) const;
+  std::size_t size() const;
+
+  static ShortId ComputeShortId(TxDigest const &digest);
+
+  // Operators
+  TransactionSummaryCache &operator=(TransactionSummaryCache const &) = delete;
+  TransactionSummaryCache &operator=(TransactionSummaryCache &&) = delete;
+
+private:
+  using Mutex     = mutex::Mutex;
+  using Summaries = std::unordered_map<ShortId, TransactionSummary>;
+  using Order     = std::deque<ShortId>;
+
+  std::size_t const capacity_;
+  mutable Mutex     lock_{__LINE__, __FILE__};
+  Summaries         summaries_{};  ///< The cached summaries indexed by short id
+  Order             order_{};      ///< The insertion order of the summaries, oldest first
+
+  void AddLocked(TransactionSummary const &summary);
+  void EvictLocked();
+};
+
+}  // namespace ledger
+}  // namespace fetch
@@ -18,26 +18,34 @@
 //------------------------------------------------------------------------------
 
 #include "core/containers/queue.hpp"
+#include "crypto/ecdsa_batch_verifier.hpp"
 #include "ledger/chain/transaction.hpp"
 #include "ledger/storage_unit/transaction_sinks.hpp"
 
 #include <cstddef>
+#include <iterator>
 #include <thread>
+#include <vector>
 
 namespace fetch {
 namespace ledger {
 
+class VerifiedDigestCache;
+
 class TransactionVerifier
 {
 public:
+  using MutableTxList = std::vector<MutableTransaction>;
+
   static constexpr char const *LOGGING_NAME = "TxVerifier";
 
   // Construction / Destruction
   explicit TransactionVerifier(VerifiedTransactionSink &sink, std::size_t verifying_threads,
-                               std::string name)
+                               std::string name, VerifiedDigestCache *verified_cache = nullptr)
     : verifying_threads_(verifying_threads)
     , name_(std::move(name))
     , sink_(sink)
+    , verified_cache_(verified_cache)
   {}
   TransactionVerifier(TransactionVerifier const &) = delete;
   TransactionVerifier(TransactionVerifier &&)      = delete;
@@ -53,8 +61,11 @@ public:
   /// @{
   void AddTransaction(MutableTransaction const &mtx);
   void AddTransaction(MutableTransaction &&mtx);
+  void AddTransactions(MutableTxList &&txs);
   /// @}
 
+  std::size_t GetBacklog() const;
+
   // Operators
   TransactionVerifier &operator=(TransactionVerifier const &) = delete;
   TransactionVerifier &operator=(TransactionVerifier &&) = delete;
@@ -69,20 +80,26 @@ private:
   using ThreadPtr       = std::unique_ptr<std::thread>;
   using Threads         = std::vector<ThreadPtr>;
   using Sink            = VerifiedTransactionSink;
+  using BatchVerifier   = crypto::ECDSABatchVerifier;
 
   void Verifier();
   void Dispatcher();
 
+  void VerifyBatch(MutableTxList const &batch, BatchVerifier &verifier);
+  void VerifyIndividually(MutableTransaction const &mtx);
+  bool DispatchIfVerified(MutableTransaction const &mtx);
+
   std::size_t batch_size_{DEFAULT_BATCH_SIZE};
   std::size_t verifying_threads_;
 
-  std::string const name_;
-  std::string const logging_name_;
-  Sink &            sink_;
-  Flag              active_{true};
-  Threads           threads_;
-  VerifiedQueue     verified_queue_;
-  UnverifiedQueue   unverified_queue_;
+  std::string const    name_;
+  std::string const    logging_name_;
+  Sink &               sink_;
+  VerifiedDigestCache *verified_cache_;  ///< The digests verified before (optional)
+  Flag                 active_{true};
+  Threads              threads_;
+  VerifiedQueue        verified_queue_;
+  UnverifiedQueue      unverified_queue_;
 };
 
 inline void TransactionVerifier::AddTransaction(MutableTransaction const &mtx)
@@ -95,5 +112,28 @@ inline void TransactionVerifier::AddTransaction(MutableTransaction &&mtx)
   unverified_queue_.Push(std::move(mtx));
 }
 
+/**
+ * Get the number of transactions waiting to be verified or dispatched
+ *
+ * @return The number of queued transactions
+ */
+inline std::size_t TransactionVerifier::GetBacklog() const
+{
+  return unverified_queue_.size() + verified_queue_.size();
+}
+
+/**
+ * Add a set of transactions to be verified, with a single synchronisation with the verifying
+ * threads rather than one per transaction
+ *
+ * @param txs The transactions, which are moved into the queue
+ */
+inline void TransactionVerifier::AddTransactions(MutableTxList &&txs)
+{
+  unverified_queue_.PushBulk(std::make_move_iterator(txs.begin()),
+                             std::make_move_iterator(txs.end()));
+  txs.clear();
+}
+
 }  // namespace ledger
 }  // namespace fetch
@@ -19,16 +19,21 @@
 
 #include "http/module.hpp"
 
+#include <cstddef>
+#include <cstdint>
+
 namespace fetch {
 namespace ledger {
 
 class StorageUnitInterface;
+class TransactionAddressIndex;
 
 class TxQueryHttpInterface : public http::HTTPModule
 {
 public:
   // Construction / Destruction
-  TxQueryHttpInterface(StorageUnitInterface &storage_unit, uint32_t log2_num_lanes);
+  TxQueryHttpInterface(StorageUnitInterface &storage_unit, uint32_t log2_num_lanes,
+                       TransactionAddressIndex *address_index = nullptr);
   TxQueryHttpInterface(TxQueryHttpInterface const &) = delete;
   TxQueryHttpInterface(TxQueryHttpInterface &&)      = delete;
   ~TxQueryHttpInterface()                            = default;
@@ -38,8 +43,15 @@ public:
   TxQueryHttpInterface &operator=(TxQueryHttpInterface &&) = delete;
 
 private:
-  StorageUnitInterface &storage_unit_;
-  uint32_t              log2_num_lanes_{0};
+  static constexpr std::size_t DEFAULT_LIMIT = 100;
+  static constexpr std::size_t MAX_LIMIT     = 1000;
+
+  http::HTTPResponse QueryAddress(http::ViewParameters const &params,
+                                  http::HTTPRequest const &   request);
+
+  StorageUnitInterface &   storage_unit_;
+  uint32_t                 log2_num_lanes_{0};
+  TransactionAddressIndex *address_index_;  ///< Optional, disables the address queries if null
 };
 
 }  // namespace ledger
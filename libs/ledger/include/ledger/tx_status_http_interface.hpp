@@ -18,27 +18,61 @@
 //------------------------------------------------------------------------------
 
 #include "http/module.hpp"
+#include "ledger/transaction_status_cache.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace fetch {
 namespace ledger {
 
-class TransactionStatusCache;
-
+/**
+ * Serves the status of transactions. Besides the single status query, clients can watch a set of
+ * transactions: the request is answered as soon as the status of any of them differs from the one
+ * the client last saw, or once the timeout of the request expires (long polling). This replaces
+ * repeated polling of each transaction.
+ */
 class TxStatusHttpInterface : public http::HTTPModule
 {
 public:
+  static constexpr std::size_t MAX_WATCHED_TXS       = 1000;
+  static constexpr uint64_t    DEFAULT_WATCH_TIMEOUT = 15;  ///< seconds
+  static constexpr uint64_t    MAX_WATCH_TIMEOUT     = 25;  ///< seconds, below the idle timeout
+
   // Construction / Destruction
   explicit TxStatusHttpInterface(TransactionStatusCache &status_cache);
   TxStatusHttpInterface(TxStatusHttpInterface const &) = delete;
   TxStatusHttpInterface(TxStatusHttpInterface &&)      = delete;
-  ~TxStatusHttpInterface()                             = default;
+  ~TxStatusHttpInterface();
 
   // Operators
   TxStatusHttpInterface &operator=(TxStatusHttpInterface const &) = delete;
   TxStatusHttpInterface &operator=(TxStatusHttpInterface &&) = delete;
 
 private:
+  using Clock     = std::chrono::steady_clock;
+  using Timepoint = Clock::time_point;
+  using Responder = http::HTTPModule::responder_type;
+
+  struct Watch;
+
+  using WatchPtr  = std::shared_ptr<Watch>;
+  using Deadlines = std::multimap<Timepoint, WatchPtr>;
+
+  void OnWatch(http::HTTPRequest const &request, Responder const &responder);
+  void ExpireWatches();
+
   TransactionStatusCache &status_cache_;
+  std::mutex              lock_;
+  std::condition_variable wake_;
+  Deadlines               deadlines_;  ///< The watches waiting on a change, by their timeout
+  bool                    running_{true};
+  std::thread             expiry_thread_;
 };
 
 }  // namespace ledger
@@ -0,0 +1,107 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/mutex.hpp"
+#include "ledger/chain/mutable_transaction.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_set>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * A bounded set of the digests of the transactions whose signatures have already been verified by
+ * this node. It is shared between all the transaction verifiers of the node, so that a transaction
+ * which arrives more than once (for example submitted locally and then pulled again from a peer) is
+ * only verified once.
+ *
+ * Only the first 128 bits of each digest are kept. Since the digest covers the signatures as well
+ * as the contents of the transaction, a transaction whose (recomputed) digest is present has been
+ * verified before. The set is split into shards, each with its own lock, so that the verifying
+ * threads rarely contend.
+ */
+class VerifiedDigestCache
+{
+public:
+  using TxDigest = TransactionSummary::TxDigest;
+
+  static constexpr std::size_t DEFAULT_CAPACITY = 1u << 18u;  // 256K
+  static constexpr std::size_t NUM_SHARDS       = 16;
+
+  // Construction / Destruction
+  explicit VerifiedDigestCache(std::size_t capacity = DEFAULT_CAPACITY);
+  VerifiedDigestCache(VerifiedDigestCache const &) = delete;
+  VerifiedDigestCache(VerifiedDigestCache &&)      = delete;
+  ~VerifiedDigestCache()                           = default;
+
+  void        Add(TxDigest const &digest);
+  bool        Contains(TxDigest const &digest) const;
+  std::size_t size() const;
+
+  // Operators
+  VerifiedDigestCache &operator=(VerifiedDigestCache const &) = delete;
+  VerifiedDigestCache &operator=(VerifiedDigestCache &&) = delete;
+
+private:
+  struct Key
+  {
+    uint64_t high{0};
+    uint64_t low{0};
+
+    bool operator==(Key const &other) const
+    {
+      return (high == other.high) && (low == other.low);
+    }
+  };
+
+  struct KeyHash
+  {
+    std::size_t operator()(Key const &key) const
+    {
+      return static_cast<std::size_t>(key.high ^ key.low);
+    }
+  };
+
+  using Mutex = mutex::Mutex;
+  using Keys  = std::unordered_set<Key, KeyHash>;
+  using Order = std::deque<Key>;
+
+  struct Shard
+  {
+    mutable Mutex lock{__LINE__, __FILE__};
+    Keys          keys{};   ///< The digests in the shard
+    Order         order{};  ///< The insertion order of the digests, oldest first
+  };
+
+  using Shards = std::array<Shard, NUM_SHARDS>;
+
+  static Key   ToKey(TxDigest const &digest);
+  Shard &      LookupShard(Key const &key);
+  Shard const &LookupShard(Key const &key) const;
+
+  std::size_t const shard_capacity_;
+  Shards            shards_;
+};
+
+}  // namespace ledger
+}  // namespace fetch
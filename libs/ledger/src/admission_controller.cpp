@@ -0,0 +1,249 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/admission_controller.hpp"
+
+#include <algorithm>
+#include <utility>
+
+static const std::chrono::seconds PRUNE_INTERVAL{60};
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * Construct the admission controller with the default configuration
+ *
+ * @param depth The function returning the current depth of the ingest pipeline
+ */
+AdmissionController::AdmissionController(DepthFunction depth)
+  : AdmissionController(Config{}, std::move(depth))
+{}
+
+/**
+ * Construct the admission controller
+ *
+ * @param config The rates and thresholds to be applied
+ * @param depth The function returning the current depth of the ingest pipeline
+ */
+AdmissionController::AdmissionController(Config const &config, DepthFunction depth)
+  : config_{config}
+  , depth_{std::move(depth)}
+  , clients_{config.client_rate, config.client_burst}
+  , signers_{config.signer_rate, config.signer_burst}
+{}
+
+/**
+ * Determine if the ingest pipeline is full, in which case nothing will be admitted
+ *
+ * @return true if the pipeline is full, otherwise false
+ */
+bool AdmissionController::IsOverloaded() const
+{
+  return GetDepth() >= config_.max_depth;
+}
+
+/**
+ * Admit a submission of transactions from a client, taking a token per transaction
+ *
+ * @param client The identifier of the client (originating address)
+ * @param count The number of transactions submitted
+ * @param now The current time
+ * @return The admission decision for the whole submission
+ */
+AdmissionController::Decision AdmissionController::AdmitClient(ConstByteArray const &client,
+                                                               std::size_t           count,
+                                                               Timepoint const &     now)
+{
+  std::size_t const depth = GetDepth();
+
+  if ((depth + count) > config_.max_depth)
+  {
+    counters_.overloaded.fetch_add(count, std::memory_order_relaxed);
+    return Decision::OVERLOADED;
+  }
+
+  if (!clients_.Take(client, static_cast<double>(count), Scale(depth), now))
+  {
+    counters_.rate_limited_client.fetch_add(count, std::memory_order_relaxed);
+    return Decision::RATE_LIMITED;
+  }
+
+  return Decision::ADMITTED;
+}
+
+/**
+ * Admit a single transaction from a signer, after its submission has been admitted
+ *
+ * @param signer The identifier of the signer (public key), empty if the transaction is unsigned
+ * @param now The current time
+ * @return The admission decision for the transaction
+ */
+AdmissionController::Decision AdmissionController::AdmitSigner(ConstByteArray const &signer,
+                                                               Timepoint const &     now)
+{
+  // unsigned transactions are only limited by their client, the verifier will reject them
+  if (!signer.empty() && !signers_.Take(signer, 1.0, Scale(GetDepth()), now))
+  {
+    counters_.rate_limited_signer.fetch_add(1, std::memory_order_relaxed);
+    return Decision::RATE_LIMITED;
+  }
+
+  counters_.admitted.fetch_add(1, std::memory_order_relaxed);
+  return Decision::ADMITTED;
+}
+
+/**
+ * Get the current depth of the ingest pipeline
+ *
+ * @return The number of transactions waiting to be verified or packed
+ */
+std::size_t AdmissionController::GetDepth() const
+{
+  return depth_ ? depth_() : 0;
+}
+
+/**
+ * Get the current pressure on the ingest pipeline
+ *
+ * @return 0 while below the shedding threshold, rising to 1 at the maximum depth
+ */
+double AdmissionController::GetPressure() const
+{
+  return 1.0 - Scale(GetDepth());
+}
+
+std::size_t AdmissionController::GetNumClients() const
+{
+  return clients_.size();
+}
+
+std::size_t AdmissionController::GetNumSigners() const
+{
+  return signers_.size();
+}
+
+/**
+ * Internal: Determine the factor applied to the refill rates for a given pipeline depth
+ *
+ * @param depth The depth of the ingest pipeline
+ * @return 1 below the shedding threshold, falling linearly to 0 at the maximum depth
+ */
+double AdmissionController::Scale(std::size_t depth) const
+{
+  if (depth <= config_.shed_depth)
+  {
+    return 1.0;
+  }
+
+  if ((depth >= config_.max_depth) || (config_.max_depth <= config_.shed_depth))
+  {
+    return 0.0;
+  }
+
+  return static_cast<double>(config_.max_depth - depth) /
+         static_cast<double>(config_.max_depth - config_.shed_depth);
+}
+
+char const *ToString(AdmissionController::Decision decision)
+{
+  char const *text = "Unknown";
+
+  switch (decision)
+  {
+  case AdmissionController::Decision::ADMITTED:
+    text = "Admitted";
+    break;
+  case AdmissionController::Decision::RATE_LIMITED:
+    text = "Rate Limited";
+    break;
+  case AdmissionController::Decision::OVERLOADED:
+    text = "Overloaded";
+    break;
+  }
+
+  return text;
+}
+
+AdmissionController::BucketTable::BucketTable(double rate, double burst)
+  : rate{rate}
+  , burst{burst}
+{}
+
+/**
+ * Take tokens from the bucket of a key, refilling it first. New keys start with a full bucket.
+ *
+ * @param key The key of the bucket
+ * @param tokens The number of tokens required
+ * @param scale The factor applied to the refill rate
+ * @param now The current time
+ * @return true if the tokens were taken, otherwise false
+ */
+bool AdmissionController::BucketTable::Take(ConstByteArray const &key, double tokens, double scale,
+                                            Timepoint const &now)
+{
+  FETCH_LOCK(lock);
+
+  // buckets which have been idle long enough to have refilled are the same as new ones
+  if ((now - last_prune) >= PRUNE_INTERVAL)
+  {
+    auto const refill = std::chrono::duration<double>{(rate > 0) ? (burst / rate) : 0.0};
+
+    for (auto it = buckets.begin(); it != buckets.end();)
+    {
+      if ((now - it->second.last_update) > refill)
+      {
+        it = buckets.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+
+    last_prune = now;
+  }
+
+  auto  result = buckets.emplace(key, Bucket{burst, now});
+  auto &bucket = result.first->second;
+
+  if (!result.second && (now > bucket.last_update))
+  {
+    double const elapsed = std::chrono::duration<double>{now - bucket.last_update}.count();
+
+    bucket.tokens      = std::min(burst, bucket.tokens + (elapsed * rate * scale));
+    bucket.last_update = now;
+  }
+
+  if (bucket.tokens < tokens)
+  {
+    return false;
+  }
+
+  bucket.tokens -= tokens;
+  return true;
+}
+
+std::size_t AdmissionController::BucketTable::size() const
+{
+  FETCH_LOCK(lock);
+  return buckets.size();
+}
+
+}  // namespace ledger
+}  // namespace fetch
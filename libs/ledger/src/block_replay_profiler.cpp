@@ -0,0 +1,496 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/block_replay_profiler.hpp"
+#include "core/byte_array/encoders.hpp"
+#include "core/logger.hpp"
+#include "ledger/execution_manager.hpp"
+#include "ledger/executor.hpp"
+#include "vm/profiler.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace fetch {
+namespace ledger {
+namespace {
+
+constexpr char const *LOGGING_NAME = "BlockReplayProfiler";
+
+using TransactionProfile  = BlockReplayProfiler::TransactionProfile;
+using TransactionProfiles = BlockReplayProfiler::TransactionProfiles;
+using StorageUnitPtr      = BlockReplayProfiler::StorageUnitPtr;
+using Clock               = BlockReplayProfiler::Clock;
+using Microseconds        = std::chrono::duration<double, std::micro>;
+
+/**
+ * A storage unit which forwards every call to the storage unit of the node, counting the state
+ * accesses made by the transaction being executed. Only used from the thread of its executor.
+ */
+class CountingStorageUnit : public StorageUnitInterface
+{
+public:
+  struct Counters
+  {
+    uint64_t calls{0};
+    uint64_t bytes_read{0};
+    uint64_t bytes_written{0};
+  };
+
+  // Construction / Destruction
+  explicit CountingStorageUnit(StorageUnitPtr storage)
+    : storage_{std::move(storage)}
+  {}
+  ~CountingStorageUnit() override = default;
+
+  /**
+   * Get the counters accumulated since the last call and reset them
+   *
+   * @return The counters
+   */
+  Counters TakeCounters()
+  {
+    Counters counters{};
+    std::swap(counters, counters_);
+    return counters;
+  }
+
+  /// @name State Interface
+  /// @{
+  Document Get(ResourceAddress const &key) override
+  {
+    return Read(storage_->Get(key));
+  }
+
+  Document GetOrCreate(ResourceAddress const &key) override
+  {
+    return Read(storage_->GetOrCreate(key));
+  }
+
+  void Set(ResourceAddress const &key, StateValue const &value) override
+  {
+    ++counters_.calls;
+    counters_.bytes_written += value.size();
+    storage_->Set(key, value);
+  }
+
+  bool Lock(ResourceAddress const &key) override
+  {
+    ++counters_.calls;
+    return storage_->Lock(key);
+  }
+
+  bool Unlock(ResourceAddress const &key) override
+  {
+    ++counters_.calls;
+    return storage_->Unlock(key);
+  }
+  /// @}
+
+  /// @name Bulk State Interface
+  /// @{
+  Documents GetBulk(ResourceAddresses const &keys) override
+  {
+    ++counters_.calls;
+
+    Documents documents = storage_->GetBulk(keys);
+    for (auto const &document : documents)
+    {
+      counters_.bytes_read += document.document.size();
+    }
+
+    return documents;
+  }
+
+  void SetBulk(KeyValues const &values) override
+  {
+    ++counters_.calls;
+    for (auto const &value : values)
+    {
+      counters_.bytes_written += value.second.size();
+    }
+
+    storage_->SetBulk(values);
+  }
+
+  bool LockBulk(ResourceAddresses const &keys) override
+  {
+    ++counters_.calls;
+    return storage_->LockBulk(keys);
+  }
+
+  bool UnlockBulk(ResourceAddresses const &keys) override
+  {
+    ++counters_.calls;
+    return storage_->UnlockBulk(keys);
+  }
+  /// @}
+
+  /// @name Transaction Interface
+  /// @{
+  void AddTransaction(Transaction const &tx) override
+  {
+    storage_->AddTransaction(tx);
+  }
+
+  bool GetTransaction(ConstByteArray const &digest, Transaction &tx) override
+  {
+    ++counters_.calls;
+    return storage_->GetTransaction(digest, tx);
+  }
+
+  bool HasTransaction(ConstByteArray const &digest) override
+  {
+    return storage_->HasTransaction(digest);
+  }
+  /// @}
+
+  TxSummaries PollRecentTx(uint32_t max_to_poll) override
+  {
+    return storage_->PollRecentTx(max_to_poll);
+  }
+
+  /// @name Revertible Document Store Interface
+  /// @{
+  Hash CurrentHash() override
+  {
+    return storage_->CurrentHash();
+  }
+
+  Hash LastCommitHash() override
+  {
+    return storage_->LastCommitHash();
+  }
+
+  bool RevertToHash(Hash const &hash, uint64_t index) override
+  {
+    return storage_->RevertToHash(hash, index);
+  }
+
+  Hash Commit(uint64_t index) override
+  {
+    return storage_->Commit(index);
+  }
+
+  bool HashExists(Hash const &hash, uint64_t index) override
+  {
+    return storage_->HashExists(hash, index);
+  }
+  /// @}
+
+private:
+  Document Read(Document document)
+  {
+    ++counters_.calls;
+    counters_.bytes_read += document.document.size();
+    return document;
+  }
+
+  StorageUnitPtr storage_;
+  Counters       counters_{};
+};
+
+/**
+ * Collects the profiles of the transactions from the executors
+ */
+class Recorder
+{
+public:
+  void Add(TransactionProfile profile)
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    profiles_.push_back(std::move(profile));
+  }
+
+  TransactionProfiles Take()
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    return std::move(profiles_);
+  }
+
+private:
+  std::mutex          lock_;
+  TransactionProfiles profiles_;
+};
+
+/**
+ * An executor which measures each of the transactions it executes
+ */
+class ProfilingExecutor : public ExecutorInterface
+{
+public:
+  // Construction / Destruction
+  ProfilingExecutor(StorageUnitPtr const &storage, Recorder &recorder)
+    : storage_{std::make_shared<CountingStorageUnit>(storage)}
+    , executor_{storage_}
+    , recorder_{recorder}
+  {
+    executor_.SetProfiler(&profiler_);
+  }
+  ~ProfilingExecutor() override = default;
+
+  /// @name Executor Interface
+  /// @{
+  Status Execute(TxDigest const &hash, std::size_t slice, LaneSet const &lanes) override
+  {
+    storage_->TakeCounters();
+    profiler_.Reset();
+
+    Clock::time_point const started = Clock::now();
+    Status const            status  = executor_.Execute(hash, slice, lanes);
+    Clock::duration const   elapsed = Clock::now() - started;
+
+    auto const counters = storage_->TakeCounters();
+
+    TransactionProfile profile{};
+    profile.digest          = hash;
+    profile.slice           = slice;
+    profile.status          = status;
+    profile.wall_time       = elapsed;
+    profile.storage_calls   = counters.calls;
+    profile.bytes_read      = counters.bytes_read;
+    profile.bytes_written   = counters.bytes_written;
+    profile.vm_instructions = profiler_.instruction_count();
+
+    recorder_.Add(std::move(profile));
+
+    return status;
+  }
+  /// @}
+
+private:
+  std::shared_ptr<CountingStorageUnit> storage_;
+  Executor                             executor_;
+  vm::Profiler                         profiler_;
+  Recorder &                           recorder_;
+};
+
+}  // namespace
+
+constexpr std::size_t BlockReplayProfiler::DEFAULT_MAX_ENTRIES;
+
+/**
+ * Construct the profiler
+ *
+ * @param storage The storage unit holding the transactions and the state of the chain
+ */
+BlockReplayProfiler::BlockReplayProfiler(StorageUnitPtr storage)
+  : storage_{std::move(storage)}
+{}
+
+/**
+ * Replay a block on a fork of the state of its parent
+ *
+ * @param block The block to be replayed
+ * @param parent The parent of the block
+ * @param report The report to be populated
+ * @return true if the block was executed to completion, otherwise false
+ */
+bool BlockReplayProfiler::Replay(Block const &block, Block const &parent, Report &report)
+{
+  if (block.body.previous_hash != parent.body.hash)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Block ", byte_array::ToBase64(block.body.hash),
+                   " is not a child of ", byte_array::ToBase64(parent.body.hash));
+    return false;
+  }
+
+  // must outlive the execution manager, which owns the executors
+  Recorder recorder{};
+
+  using State = ExecutionManager::State;
+
+  auto manager = std::make_shared<ExecutionManager>(
+      1u, storage_, [this, &recorder]() -> ExecutionManager::ExecutorPtr {
+        return std::make_shared<ProfilingExecutor>(storage_, recorder);
+      });
+
+  // all the reads are made by the executor on behalf of the transaction, and contracts are
+  // compiled by the transaction which first uses them
+  manager->SetPrefetchEnabled(false);
+  manager->SetPrecompileEnabled(false);
+
+  std::mutex              finished_lock;
+  std::condition_variable finished_cv;
+  bool                    finished{false};
+  State                   final_state{State::IDLE};
+
+  ExecutionManager *const raw_manager = manager.get();
+  manager->OnExecutionFinished([&, raw_manager]() {
+    // the state must be read here, the manager returns to idle as soon as the callback completes
+    State const state = raw_manager->GetState();
+    {
+      std::lock_guard<std::mutex> lock(finished_lock);
+      final_state = state;
+      finished    = true;
+    }
+    finished_cv.notify_all();
+  });
+
+  manager->Start();
+  manager->SetLastProcessedBlock(parent.body.hash);
+
+  if (!storage_->BeginFork(parent.body.merkle_hash, parent.body.block_number))
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to fork the state of block ",
+                   byte_array::ToBase64(parent.body.hash));
+    manager->Stop();
+    return false;
+  }
+
+  Clock::time_point const started = Clock::now();
+
+  auto const status = manager->Execute(block.body);
+  if (status == ExecutionManager::ScheduleStatus::SCHEDULED)
+  {
+    std::unique_lock<std::mutex> lock(finished_lock);
+    finished_cv.wait(lock, [&finished]() { return finished; });
+  }
+  else
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to schedule block: ", ToString(status));
+  }
+
+  Clock::duration const elapsed = Clock::now() - started;
+
+  storage_->EndFork();
+  storage_->DiscardFork();
+  manager->Stop();
+
+  bool const success =
+      (status == ExecutionManager::ScheduleStatus::SCHEDULED) && (final_state == State::IDLE);
+
+  // label the transactions with their contracts
+  std::unordered_map<Digest, std::string> contracts{};
+  for (auto const &slice : block.body.slices)
+  {
+    for (auto const &tx : slice)
+    {
+      contracts[tx.transaction_hash] = static_cast<std::string>(tx.contract_name);
+    }
+  }
+
+  report.block        = block.body.hash;
+  report.block_number = block.body.block_number;
+  report.wall_time    = elapsed;
+  report.transactions = recorder.Take();
+
+  for (auto &profile : report.transactions)
+  {
+    auto const it = contracts.find(profile.digest);
+    if (it != contracts.end())
+    {
+      profile.contract = it->second;
+    }
+  }
+
+  std::sort(report.transactions.begin(), report.transactions.end(),
+            [](TransactionProfile const &a, TransactionProfile const &b) {
+              return a.wall_time > b.wall_time;
+            });
+
+  return success;
+}
+
+/**
+ * Write a human readable report of the costliest transactions, and of the total cost of each
+ * contract
+ *
+ * @param stream The stream to be written to
+ * @param report The report of a replay
+ * @param max_entries The maximum number of entries in each section
+ */
+void BlockReplayProfiler::WriteReport(std::ostream &stream, Report const &report,
+                                      std::size_t max_entries)
+{
+  struct ContractTotals
+  {
+    std::size_t transactions{0};
+    Duration    wall_time{};
+    uint64_t    storage_calls{0};
+    uint64_t    bytes_read{0};
+    uint64_t    bytes_written{0};
+    uint64_t    vm_instructions{0};
+  };
+
+  auto const write_row = [&stream](std::string const &name, Duration wall_time,
+                                   uint64_t storage_calls, uint64_t bytes_read,
+                                   uint64_t bytes_written, uint64_t vm_instructions) {
+    stream << "  " << std::left << std::setw(48) << name << std::right << std::setw(14)
+           << std::fixed << std::setprecision(1) << Microseconds(wall_time).count()
+           << std::setw(10) << storage_calls << std::setw(12) << bytes_read << std::setw(12)
+           << bytes_written << std::setw(14) << vm_instructions;
+  };
+
+  auto const write_header = [&stream](char const *title) {
+    stream << '\n'
+           << title << ":\n  " << std::left << std::setw(48) << "" << std::right << std::setw(14)
+           << "time (us)" << std::setw(10) << "calls" << std::setw(12) << "read" << std::setw(12)
+           << "written" << std::setw(14) << "opcodes" << '\n';
+  };
+
+  stream << "Block: " << byte_array::ToBase64(report.block) << " (#" << report.block_number
+         << ")\nTransactions: " << report.transactions.size() << "\nWall time: " << std::fixed
+         << std::setprecision(1) << Microseconds(report.wall_time).count() << " us\n";
+
+  write_header("Transactions");
+  for (std::size_t i = 0, end = std::min(report.transactions.size(), max_entries); i < end; ++i)
+  {
+    auto const &tx = report.transactions[i];
+    write_row(static_cast<std::string>(byte_array::ToBase64(tx.digest)), tx.wall_time,
+              tx.storage_calls, tx.bytes_read, tx.bytes_written, tx.vm_instructions);
+    stream << "  " << tx.contract << " (slice " << tx.slice << ", " << ToString(tx.status)
+           << ")\n";
+  }
+
+  std::map<std::string, ContractTotals> totals{};
+  for (auto const &tx : report.transactions)
+  {
+    auto &entry = totals[tx.contract];
+    ++entry.transactions;
+    entry.wall_time += tx.wall_time;
+    entry.storage_calls += tx.storage_calls;
+    entry.bytes_read += tx.bytes_read;
+    entry.bytes_written += tx.bytes_written;
+    entry.vm_instructions += tx.vm_instructions;
+  }
+
+  std::vector<std::pair<std::string, ContractTotals>> contracts(totals.begin(), totals.end());
+  std::sort(contracts.begin(), contracts.end(),
+            [](std::pair<std::string, ContractTotals> const &a,
+               std::pair<std::string, ContractTotals> const &b) {
+              return a.second.wall_time > b.second.wall_time;
+            });
+
+  write_header("Contracts");
+  for (std::size_t i = 0, end = std::min(contracts.size(), max_entries); i < end; ++i)
+  {
+    auto const &entry = contracts[i].second;
+    write_row(contracts[i].first, entry.wall_time, entry.storage_calls, entry.bytes_read,
+              entry.bytes_written, entry.vm_instructions);
+    stream << "  " << entry.transactions << " tx\n";
+  }
+}
+
+}  // namespace ledger
+}  // namespace fetch
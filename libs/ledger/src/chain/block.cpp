@@ -42,9 +42,13 @@ std::size_t Block::GetTransactionCount() const
 }
 
 /**
- * Populate the block hash field based on the contents of the current block
+ * Serialize the fields of the block which are covered by the block hash, except for the nonce which
+ * always comes last. This allows the nonce search to hash the prefix only once.
+ *
+ * @param pool The (optional) thread pool used to compute the merkle root of the transactions
+ * @return The serialized prefix of the block hash
  */
-void Block::UpdateDigest()
+byte_array::ByteArray Block::GetDigestPrefix(threading::Pool *pool) const
 {
   crypto::MerkleTree tx_merkle_tree{GetTransactionCount()};
 
@@ -59,18 +63,45 @@ void Block::UpdateDigest()
   }
 
   // Calculate the root
-  tx_merkle_tree.CalculateRoot();
+  if (pool != nullptr)
+  {
+    tx_merkle_tree.CalculateRoot(*pool);
+  }
+  else
+  {
+    tx_merkle_tree.CalculateRoot();
+  }
 
   // Generate hash stream
   serializers::ByteArrayBuffer buf;
-  buf << body.previous_hash << body.merkle_hash << body.block_number << body.miner
-      << body.log2_num_lanes << tx_merkle_tree.root() << nonce;
+  buf.Append(body.previous_hash, body.merkle_hash, body.block_number, body.miner,
+             body.log2_num_lanes, tx_merkle_tree.root());
+
+  return buf.data();
+}
 
-  // Generate the hash
+/**
+ * Calculate the block hash from the contents of the current block, without updating it
+ *
+ * @param pool The (optional) thread pool used to compute the merkle root of the transactions
+ * @return The block hash
+ */
+Block::Digest Block::CalculateDigest(threading::Pool *pool) const
+{
   crypto::SHA256 hash;
   hash.Reset();
-  hash.Update(buf.data());
-  body.hash = hash.Final();
+  hash.Update(GetDigestPrefix(pool));
+  hash.Update(nonce);
+
+  return hash.Final();
+}
+
+/**
+ * Populate the block hash field based on the contents of the current block
+ */
+void Block::UpdateDigest()
+{
+  body.hash = CalculateDigest();
 
   proof.SetHeader(body.hash);
 }
@@ -25,8 +25,10 @@
 #include "ledger/chain/main_chain.hpp"
 #include "ledger/execution_manager_interface.hpp"
 #include "ledger/storage_unit/storage_unit_interface.hpp"
+#include "ledger/transaction_address_index.hpp"
 #include "ledger/transaction_status_cache.hpp"
 
+#include <algorithm>
 #include <chrono>
 
 using fetch::byte_array::ToBase64;
@@ -37,12 +39,16 @@ using ExecutionState = fetch::ledger::ExecutionManagerInterface::State;
 static const std::chrono::milliseconds TX_SYNC_NOTIFY_INTERVAL{1000};
 static const std::chrono::milliseconds EXEC_NOTIFY_INTERVAL{500};
 static const std::chrono::seconds      NOTIFY_INTERVAL{10};
+static const std::chrono::milliseconds SYNCHRONIZED_POLL_INTERVAL{100};
 static const std::size_t               DIGEST_LENGTH_BYTES{32};
 static const std::size_t               IDENTITY_LENGTH_BYTES{64};
+static const std::size_t               VALIDATION_GRAIN{1024};
 
 namespace fetch {
 namespace ledger {
 
+constexpr BlockCoordinator::StateHandler BlockCoordinator::STATE_TABLE[];
+
 /**
  * Construct the Block Coordinator
  *
@@ -65,7 +71,8 @@ BlockCoordinator::BlockCoordinator(MainChain &chain, ExecutionManagerInterface &
   , miner_{std::make_shared<consensus::DummyMiner>()}
   , last_executed_block_{GENESIS_DIGEST}
   , identity_{std::move(identity)}
-  , state_machine_{std::make_shared<StateMachine>("BlockCoordinator", State::RELOAD_STATE,
+  , state_machine_{std::make_shared<StateMachine>("BlockCoordinator", State::RELOAD_STATE, this,
+                                                  STATE_TABLE,
                                                   [](State state) { return ToString(state); })}
   , block_difficulty_{block_difficulty}
   , num_lanes_{num_lanes}
@@ -73,24 +80,9 @@ BlockCoordinator::BlockCoordinator(MainChain &chain, ExecutionManagerInterface &
   , tx_wait_periodic_{TX_SYNC_NOTIFY_INTERVAL}
   , exec_wait_periodic_{EXEC_NOTIFY_INTERVAL}
   , syncing_periodic_{NOTIFY_INTERVAL}
+  , validation_pool_{std::max<std::size_t>(std::thread::hardware_concurrency(), 1), "BC:Valid"}
 {
-  // configure the state machine
-  // clang-format off
-  state_machine_->RegisterHandler(State::RELOAD_STATE,                 this, &BlockCoordinator::OnReloadState);
-  state_machine_->RegisterHandler(State::SYNCHRONIZING,                this, &BlockCoordinator::OnSynchronizing);
-  state_machine_->RegisterHandler(State::SYNCHRONIZED,                 this, &BlockCoordinator::OnSynchronized);
-  state_machine_->RegisterHandler(State::PRE_EXEC_BLOCK_VALIDATION,    this, &BlockCoordinator::OnPreExecBlockValidation);
-  state_machine_->RegisterHandler(State::WAIT_FOR_TRANSACTIONS,        this, &BlockCoordinator::OnWaitForTransactions);
-  state_machine_->RegisterHandler(State::SCHEDULE_BLOCK_EXECUTION,     this, &BlockCoordinator::OnScheduleBlockExecution);
-  state_machine_->RegisterHandler(State::WAIT_FOR_EXECUTION,           this, &BlockCoordinator::OnWaitForExecution);
-  state_machine_->RegisterHandler(State::POST_EXEC_BLOCK_VALIDATION,   this, &BlockCoordinator::OnPostExecBlockValidation);
-  state_machine_->RegisterHandler(State::PACK_NEW_BLOCK,               this, &BlockCoordinator::OnPackNewBlock);
-  state_machine_->RegisterHandler(State::EXECUTE_NEW_BLOCK,            this, &BlockCoordinator::OnExecuteNewBlock);
-  state_machine_->RegisterHandler(State::WAIT_FOR_NEW_BLOCK_EXECUTION, this, &BlockCoordinator::OnWaitForNewBlockExecution);
-  state_machine_->RegisterHandler(State::PROOF_SEARCH,                 this, &BlockCoordinator::OnProofSearch);
-  state_machine_->RegisterHandler(State::TRANSMIT_BLOCK,               this, &BlockCoordinator::OnTransmitBlock);
-  state_machine_->RegisterHandler(State::RESET,                        this, &BlockCoordinator::OnReset);
-  // clang-format on
+  static_assert(core::IsStateTableOrdered(STATE_TABLE), "State table must be ordered by state");
 
   // for debug purposes
 #if 0
@@ -129,6 +121,7 @@ void BlockCoordinator::TriggerBlockGeneration()
   if (mining_)
   {
     next_block_time_ = Clock::now();
+    Wake();
   }
 }
 
@@ -150,6 +143,7 @@ BlockCoordinator::State BlockCoordinator::OnReloadState()
   if (GENESIS_DIGEST != current_block_->body.previous_hash)
   {
     // normal case we have found a block from which point we want to revert. Attempt to revert to it
+    NotifyStateUpdate();
     bool const revert_success = storage_unit_.RevertToHash(current_block_->body.merkle_hash,
                                                            current_block_->body.block_number);
 
@@ -159,6 +153,8 @@ BlockCoordinator::State BlockCoordinator::OnReloadState()
       // last block that has been executed
       execution_manager_.SetLastProcessedBlock(current_block_->body.hash);
       last_executed_block_.Set(current_block_->body.hash);
+
+      NotifyStateSettled(current_block_->body.merkle_hash);
     }
   }
 
@@ -277,6 +273,7 @@ BlockCoordinator::State BlockCoordinator::OnSynchronizing()
 
       // this is a bad situation so the easiest solution is to revert back to genesis
       execution_manager_.SetLastProcessedBlock(GENESIS_DIGEST);
+      NotifyStateUpdate();
       if (!storage_unit_.RevertToHash(GENESIS_MERKLE_ROOT, 0))
       {
         FETCH_LOG_ERROR(LOGGING_NAME, "Unable to revert back to genesis");
@@ -286,6 +283,7 @@ BlockCoordinator::State BlockCoordinator::OnSynchronizing()
     }
 
     // revert the storage back to the known state
+    NotifyStateUpdate();
     if (!storage_unit_.RevertToHash(common_parent->body.merkle_hash,
                                     common_parent->body.block_number))
     {
@@ -337,6 +335,24 @@ BlockCoordinator::State BlockCoordinator::OnSynchronized(State current, State pr
                    " (block: ", current_block_->body.block_number,
                    " prev: ", ToBase64(current_block_->body.previous_hash), ")");
   }
+  else if (speculation_enabled_ && SelectSpeculativeBlock())
+  {
+    // with nothing else to do, execute a competing block ahead of a possible reorg
+    next_state = State::SCHEDULE_SPECULATIVE_EXECUTION;
+  }
+
+  if (State::SYNCHRONIZED == next_state)
+  {
+    // nothing to do until a block is added to the chain (which wakes the state machine) or it is
+    // time to mine the next block
+    auto delay = std::chrono::duration_cast<Clock::duration>(SYNCHRONIZED_POLL_INTERVAL);
+    if (mining_ && mining_enabled_)
+    {
+      delay = std::min(delay, next_block_time_ - Clock::now());
+    }
+
+    state_machine_->Delay(delay);
+  }
 
   return next_state;
 }
@@ -405,6 +421,13 @@ BlockCoordinator::State BlockCoordinator::OnPreExecBlockValidation()
     return State::RESET;
   }
 
+  // Check: Ensure the transactions are well formed and covered by the block hash
+  if (!ValidateBlockContents(*current_block_))
+  {
+    chain_.RemoveBlock(current_block_->body.hash);
+    return State::RESET;
+  }
+
   // reset the tx wait period
   tx_wait_periodic_.Reset();
 
@@ -430,20 +453,15 @@ BlockCoordinator::State BlockCoordinator::OnWaitForTransactions()
     }
   }
 
-  // evaluate if the transactions have arrived
-  auto it = pending_txs_->begin();
-  while (it != pending_txs_->end())
+  // evaluate if the transactions have arrived, querying all the lanes at once
+  if (!pending_txs_->empty())
   {
-    if (storage_unit_.HasTransaction(*it))
-    {
-      // success - remove this element from the set
-      it = pending_txs_->erase(it);
-    }
-    else
-    {
-      // otherwise advance on to the next one
-      ++it;
-    }
+    StorageUnitInterface::TxDigests const digests(pending_txs_->begin(), pending_txs_->end());
+
+    auto const missing = storage_unit_.GetMissingTransactions(digests);
+
+    pending_txs_->clear();
+    pending_txs_->insert(missing.begin(), missing.end());
   }
 
   // once all the transactions are present we can then move to scheduling the block. This makes life
@@ -476,6 +494,12 @@ BlockCoordinator::State BlockCoordinator::OnScheduleBlockExecution()
 {
   State next_state{State::RESET};
 
+  // the block might already have been executed speculatively
+  if (ApplySpeculativeExecution())
+  {
+    return State::POST_EXEC_BLOCK_VALIDATION;
+  }
+
   // schedule the current block for execution
   if (ScheduleCurrentBlock())
   {
@@ -563,6 +587,7 @@ BlockCoordinator::State BlockCoordinator::OnPostExecBlockValidation()
                                      previous_block->body.block_number))
       {
         execution_manager_.SetLastProcessedBlock(previous_block->body.hash);
+        NotifyStateSettled(previous_block->body.merkle_hash);
         revert_successful = true;
       }
     }
@@ -583,7 +608,7 @@ BlockCoordinator::State BlockCoordinator::OnPostExecBlockValidation()
     UpdateTxStatus(*current_block_);
 
     // Commit this state
-    storage_unit_.Commit(current_block_->body.block_number);
+    NotifyStateSettled(storage_unit_.Commit(current_block_->body.block_number));
 
     // signal the last block that has been executed
     last_executed_block_.Set(current_block_->body.hash);
@@ -645,7 +670,7 @@ BlockCoordinator::State BlockCoordinator::OnWaitForNewBlockExecution()
     FETCH_LOG_DEBUG(LOGGING_NAME, "Merkle Hash: ", ToBase64(next_block_->body.merkle_hash));
 
     // Commit the state generated by this block
-    storage_unit_.Commit(next_block_->body.block_number);
+    NotifyStateSettled(storage_unit_.Commit(next_block_->body.block_number));
 
     next_state = State::PROOF_SEARCH;
     break;
@@ -723,6 +748,77 @@ BlockCoordinator::State BlockCoordinator::OnTransmitBlock()
   return next_state;
 }
 
+BlockCoordinator::State BlockCoordinator::OnScheduleSpeculativeExecution()
+{
+  State next_state{State::SYNCHRONIZED};
+
+  // the competing block is executed on a fork of the state of its parent
+  BlockPtr parent = chain_.GetBlock(speculative_block_->body.previous_hash);
+  if (parent && storage_unit_.BeginFork(parent->body.merkle_hash, parent->body.block_number))
+  {
+    if (ScheduleBlock(*speculative_block_))
+    {
+      FETCH_LOG_DEBUG(LOGGING_NAME, "Speculatively executing block: ",
+                      ToBase64(speculative_block_->body.hash));
+
+      exec_wait_periodic_.Reset();
+
+      next_state = State::WAIT_FOR_SPECULATIVE_EXECUTION;
+    }
+    else
+    {
+      storage_unit_.EndFork();
+      storage_unit_.DiscardFork();
+      NotifyStateSettled(current_block_->body.merkle_hash);
+    }
+  }
+
+  return next_state;
+}
+
+BlockCoordinator::State BlockCoordinator::OnWaitForSpeculativeExecution()
+{
+  State next_state{State::WAIT_FOR_SPECULATIVE_EXECUTION};
+
+  auto const status = QueryExecutorStatus();
+  switch (status)
+  {
+  case ExecutionStatus::IDLE:
+    storage_unit_.EndFork();
+    NotifyStateSettled(current_block_->body.merkle_hash);
+    speculative_result_ = true;
+    next_state          = State::SYNCHRONIZED;
+    break;
+
+  case ExecutionStatus::RUNNING:
+    if (exec_wait_periodic_.Poll())
+    {
+      FETCH_LOG_INFO(LOGGING_NAME, "Waiting for speculative execution of block: ",
+                     speculative_block_->body.hash.ToBase64());
+    }
+
+    // signal that the next execution should not happen immediately
+    state_machine_->Delay(std::chrono::milliseconds{20});
+    break;
+
+  case ExecutionStatus::STALLED:
+  case ExecutionStatus::ERROR:
+    storage_unit_.EndFork();
+    storage_unit_.DiscardFork();
+    NotifyStateSettled(current_block_->body.merkle_hash);
+    next_state = State::SYNCHRONIZED;
+    break;
+  }
+
+  // the current block remains the last one to be executed on the state
+  if (State::SYNCHRONIZED == next_state)
+  {
+    execution_manager_.SetLastProcessedBlock(current_block_->body.hash);
+  }
+
+  return next_state;
+}
+
 BlockCoordinator::State BlockCoordinator::OnReset()
 {
   current_block_.reset();
@@ -776,6 +872,7 @@ bool BlockCoordinator::ScheduleBlock(Block const &block)
   FETCH_LOG_DEBUG(LOGGING_NAME, "Attempting exec on block: ", ToBase64(block.body.hash));
 
   // instruct the execution manager to execute the current block
+  NotifyStateUpdate();
   auto const execution_status = execution_manager_.Execute(block.body);
 
   if (execution_status == ScheduleStatus::SCHEDULED)
@@ -835,13 +932,188 @@ void BlockCoordinator::UpdateNextBlockTime()
 
 void BlockCoordinator::UpdateTxStatus(Block const &block)
 {
+  TransactionStatusCache::TxDigests digests{};
+  digests.reserve(block.GetTransactionCount());
+
+  for (auto const &slice : block.body.slices)
+  {
+    for (auto const &tx : slice)
+    {
+      digests.push_back(tx.transaction_hash);
+    }
+  }
+
+  // the subscribers waiting on these transactions are notified by the cache
+  status_cache_.Update(digests, TransactionStatus::EXECUTED);
+
+  if (address_index_ != nullptr)
+  {
+    address_index_->Add(block);
+  }
+}
+
+/**
+ * Select a competing block to be executed speculatively. Only the siblings of the current block
+ * are candidates, since the state of their parent is still available to fork from.
+ *
+ * @return true if the strongest sibling has all its transactions present, otherwise false
+ */
+bool BlockCoordinator::SelectSpeculativeBlock()
+{
+  auto const &current = current_block_->body;
+  if (GENESIS_DIGEST == current.previous_hash)
+  {
+    return false;
+  }
+
+  BlockPtr candidate{};
+  for (auto const &tip : chain_.GetTips())
+  {
+    // skip the current block and the block which was last executed speculatively
+    if ((tip == current.hash) || (speculative_block_ && (tip == speculative_block_->body.hash)))
+    {
+      continue;
+    }
+
+    BlockPtr block = chain_.GetBlock(tip);
+    if (!block || (block->body.previous_hash != current.previous_hash) ||
+        (block->body.slices.size() != num_slices_))
+    {
+      continue;
+    }
+
+    if (!candidate || (block->total_weight > candidate->total_weight))
+    {
+      candidate = std::move(block);
+    }
+  }
+
+  if (!candidate)
+  {
+    return false;
+  }
+
+  // the competing block is only executed when its transactions are present. Either way it is not
+  // considered again
+  speculative_block_  = std::move(candidate);
+  speculative_result_ = false;
+
+  StorageUnitInterface::TxDigests digests{};
+  for (auto const &slice : speculative_block_->body.slices)
+  {
+    for (auto const &tx : slice)
+    {
+      digests.push_back(tx.transaction_hash);
+    }
+  }
+
+  return storage_unit_.GetMissingTransactions(digests).empty();
+}
+
+/**
+ * Check the contents of a block: every transaction digest must be well formed and the block hash
+ * must match the transactions (through their merkle root). The checks are split across the
+ * validation pool and stop as soon as any of them fails.
+ *
+ * @param block The block to be checked
+ * @return true if the contents are valid, otherwise false
+ */
+bool BlockCoordinator::ValidateBlockContents(Block const &block)
+{
+  std::vector<TransactionSummary const *> summaries{};
+  summaries.reserve(block.GetTransactionCount());
   for (auto const &slice : block.body.slices)
   {
     for (auto const &tx : slice)
     {
-      status_cache_.Update(tx.transaction_hash, TransactionStatus::EXECUTED);
+      summaries.push_back(&tx);
     }
   }
+
+  // Check: Ensure the transaction digests are the correct size
+  std::atomic<bool> digests_valid{true};
+  validation_pool_.ParallelFor(
+      0, summaries.size(), VALIDATION_GRAIN,
+      [&summaries, &digests_valid](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; (i < end) && digests_valid; ++i)
+        {
+          if (DIGEST_LENGTH_BYTES != summaries[i]->transaction_hash.size())
+          {
+            digests_valid = false;
+          }
+        }
+      });
+
+  if (!digests_valid)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Block validation failed: Transaction hash size mismatch (",
+                   ToBase64(block.body.hash), ")");
+    return false;
+  }
+
+  // Check: Ensure the block hash matches the contents of the block
+  if (block.CalculateDigest(&validation_pool_) != block.body.hash)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Block validation failed: Block hash mismatch (",
+                   ToBase64(block.body.hash), ")");
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Use the changes of the speculative execution of the current block, if there are any
+ *
+ * @return true if the changes have been applied, otherwise false
+ */
+bool BlockCoordinator::ApplySpeculativeExecution()
+{
+  if (!speculative_result_ || !speculative_block_ ||
+      (speculative_block_->body.hash != current_block_->body.hash))
+  {
+    return false;
+  }
+
+  speculative_result_ = false;
+  speculative_block_.reset();
+
+  NotifyStateUpdate();
+  if (!storage_unit_.ApplyFork())
+  {
+    return false;
+  }
+
+  FETCH_LOG_INFO(LOGGING_NAME, "Using speculative execution of block: ",
+                 ToBase64(current_block_->body.hash));
+
+  execution_manager_.SetLastProcessedBlock(current_block_->body.hash);
+
+  return true;
+}
+
+/**
+ * Signal that the world state is about to be modified
+ */
+void BlockCoordinator::NotifyStateUpdate()
+{
+  if (world_state_callback_)
+  {
+    world_state_callback_(ConstByteArray{});
+  }
+}
+
+/**
+ * Signal that the world state has settled
+ *
+ * @param merkle_root The merkle root of the state
+ */
+void BlockCoordinator::NotifyStateSettled(ConstByteArray const &merkle_root)
+{
+  if (world_state_callback_ && !merkle_root.empty())
+  {
+    world_state_callback_(merkle_root);
+  }
 }
 
 char const *BlockCoordinator::ToString(State state)
@@ -889,6 +1161,12 @@ char const *BlockCoordinator::ToString(State state)
   case State::TRANSMIT_BLOCK:
     text = "Transmitting Block";
     break;
+  case State::SCHEDULE_SPECULATIVE_EXECUTION:
+    text = "Schedule Speculative Execution";
+    break;
+  case State::WAIT_FOR_SPECULATIVE_EXECUTION:
+    text = "Waiting for Speculative Execution";
+    break;
   case State::RESET:
     text = "Reset";
     break;
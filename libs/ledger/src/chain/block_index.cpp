@@ -0,0 +1,221 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "core/logger.hpp"
+#include "ledger/chain/block_index.hpp"
+#include "storage/storage_exception.hpp"
+
+#include <cstring>
+
+namespace fetch {
+namespace ledger {
+namespace {
+
+using BlockHash = BlockIndex::BlockHash;
+
+BlockHash ToHash(uint8_t const *data)
+{
+  byte_array::ByteArray hash;
+  hash.Resize(BlockIndex::HASH_SIZE);
+  std::memcpy(hash.pointer(), data, BlockIndex::HASH_SIZE);
+
+  return {hash};
+}
+
+}  // namespace
+
+constexpr std::size_t BlockIndex::HASH_SIZE;
+
+/**
+ * Get the hash of the block described by the record
+ *
+ * @return The block hash
+ */
+BlockIndex::BlockHash BlockIndex::Record::GetHash() const
+{
+  return ToHash(hash);
+}
+
+/**
+ * Get the hash of the parent of the block described by the record
+ *
+ * @return The previous block hash
+ */
+BlockIndex::BlockHash BlockIndex::Record::GetPreviousHash() const
+{
+  return ToHash(previous_hash);
+}
+
+/**
+ * Build an index record from the specified block
+ *
+ * @param block The input block
+ * @param record The output record to be populated
+ * @return true if successful, otherwise false
+ */
+bool BlockIndex::CreateRecord(Block const &block, Record &record)
+{
+  if ((block.body.hash.size() != HASH_SIZE) || (block.body.previous_hash.size() != HASH_SIZE))
+  {
+    return false;
+  }
+
+  std::memcpy(record.hash, block.body.hash.pointer(), HASH_SIZE);
+  std::memcpy(record.previous_hash, block.body.previous_hash.pointer(), HASH_SIZE);
+  record.block_number = block.body.block_number;
+  record.weight       = block.weight;
+  record.total_weight = block.total_weight;
+
+  return true;
+}
+
+/**
+ * Create a new (empty) index, removing any previous contents
+ *
+ * @param filename The path to the index file
+ */
+void BlockIndex::New(std::string const &filename)
+{
+  stack_.New(filename);
+  stack_.SetExtraHeader(VERSION);
+}
+
+/**
+ * Load a previously created index
+ *
+ * @param filename The path to the index file
+ * @return true if the index was loaded, false if it was missing or of an incompatible version
+ */
+bool BlockIndex::Load(std::string const &filename)
+{
+  bool success{false};
+
+  try
+  {
+    stack_.Load(filename, false);
+
+    success = (VERSION == stack_.header_extra());
+  }
+  catch (storage::StorageException const &ex)
+  {
+    FETCH_LOG_INFO(LOGGING_NAME, "Unable to load block index: ", ex.what());
+  }
+
+  return success;
+}
+
+/**
+ * Flush the contents of the index to disk
+ */
+void BlockIndex::Flush()
+{
+  if (stack_.is_open())
+  {
+    stack_.Flush(false);
+  }
+}
+
+/**
+ * Lookup the record for a specified block number
+ *
+ * @param block_number The block number to query
+ * @param record The output record to be populated
+ * @return true if successful, otherwise false
+ */
+bool BlockIndex::Get(uint64_t block_number, Record &record)
+{
+  if (block_number >= stack_.size())
+  {
+    return false;
+  }
+
+  stack_.Get(block_number, record);
+  return true;
+}
+
+/**
+ * Lookup the record of the most recently appended block
+ *
+ * @param record The output record to be populated
+ * @return true if successful, false if the index is empty
+ */
+bool BlockIndex::GetHead(Record &record)
+{
+  if (stack_.empty())
+  {
+    return false;
+  }
+
+  record = stack_.Top();
+  return true;
+}
+
+/**
+ * Append a record to the index. The record must be the direct child of the current head of the
+ * index, or the genesis block if the index is empty.
+ *
+ * @param record The record to be added
+ * @return true if successful, otherwise false
+ */
+bool BlockIndex::Append(Record const &record)
+{
+  if (record.block_number != stack_.size())
+  {
+    return false;
+  }
+
+  if (!stack_.empty())
+  {
+    Record const head = stack_.Top();
+
+    if (std::memcmp(head.hash, record.previous_hash, HASH_SIZE) != 0)
+    {
+      return false;
+    }
+  }
+
+  stack_.Push(record);
+  return true;
+}
+
+/**
+ * Remove all the records at or above the specified block number
+ *
+ * @param block_number The first block number to be removed
+ */
+void BlockIndex::Truncate(uint64_t block_number)
+{
+  while (stack_.size() > block_number)
+  {
+    stack_.Pop();
+  }
+}
+
+/**
+ * Get the number of records in the index
+ *
+ * @return The number of records
+ */
+std::size_t BlockIndex::size() const
+{
+  return stack_.size();
+}
+
+}  // namespace ledger
+}  // namespace fetch
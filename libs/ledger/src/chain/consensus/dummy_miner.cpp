@@ -51,18 +51,7 @@ void DummyMiner::Mine(Block &block)
 
 bool DummyMiner::Mine(Block &block, uint64_t iterations)
 {
-  block.nonce = GetRandom();
-
-  block.UpdateDigest();
-
-  while (!block.proof() && iterations > 0)
-  {
-    block.nonce++;
-    block.UpdateDigest();
-    iterations--;
-  }
-
-  bool const success = block.proof();
+  bool const success = search_.Search(block, GetRandom(), iterations);
   if (success)
   {
     FETCH_LOG_DEBUG(LOGGING_NAME, "Proof: Digest: ", ToHex(block.proof.digest()));
@@ -41,18 +41,23 @@ bool ProofOfWork::operator()()
 
   digest_ = hasher.Final();
 
-  return digest_ < target_;
+  // equivalent to comparing the digest and target as big numbers, but in 64-bit words
+  return unbounded_target_ || (math::UInt256::FromBytes(digest_) < fast_target_);
 }
 
 void ProofOfWork::SetTarget(std::size_t zeros)
 {
   target_ = 1;
   target_ <<= 8 * sizeof(uint8_t) * super_type::size() - 1 - zeros;
+
+  UpdateFastTarget();
 }
 
 void ProofOfWork::SetTarget(math::BigUnsigned &&target)
 {
   target_ = std::move(target);
+
+  UpdateFastTarget();
 }
 
 void ProofOfWork::SetHeader(byte_array::ByteArray header)
@@ -61,6 +66,12 @@ void ProofOfWork::SetHeader(byte_array::ByteArray header)
   assert(header_ == header);
 }
 
+void ProofOfWork::UpdateFastTarget()
+{
+  unbounded_target_ = !math::UInt256::Fits(target_);
+  fast_target_      = math::UInt256::FromBytes(target_);
+}
+
 }  // namespace consensus
 }  // namespace ledger
 }  // namespace fetch
@@ -0,0 +1,210 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/chain/consensus/proof_of_work_search.hpp"
+#include "crypto/sha256.hpp"
+#include "ledger/chain/block.hpp"
+#include "math/uint256.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace fetch {
+namespace ledger {
+namespace consensus {
+namespace {
+
+using byte_array::ByteArray;
+using byte_array::ConstByteArray;
+
+/**
+ * The target of the proof as a fixed width value
+ */
+struct Target
+{
+  bool          unbounded{false};  ///< Signal that every digest is below the target
+  math::UInt256 value{};           ///< The value of the target
+};
+
+Target MakeTarget(math::BigUnsigned const &value)
+{
+  return Target{!math::UInt256::Fits(value), math::UInt256::FromBytes(value)};
+}
+
+/**
+ * Determine if a digest is below the target, equivalent to the comparison of the values as
+ * math::BigUnsigned
+ *
+ * @param digest The digest to be checked
+ * @param target The target of the proof
+ * @return true if the digest is below the target, otherwise false
+ */
+bool IsBelowTarget(ConstByteArray const &digest, Target const &target)
+{
+  return target.unbounded || (math::UInt256::FromBytes(digest) < target.value);
+}
+
+/**
+ * The state shared between all the threads of a single search
+ */
+struct SearchState
+{
+  crypto::SHA256        midstate;     ///< The hash after the prefix of the block
+  ConstByteArray        proof_value;  ///< The value of the proof (hashed after the block hash)
+  Target                target;       ///< The target of the proof
+  std::atomic<bool>     found{false};
+  std::atomic<uint64_t> nonce{0};  ///< The nonce which was found
+};
+
+/**
+ * Search a range of nonces, stopping early when any thread has found a solution
+ *
+ * @param state The shared search state
+ * @param start The first nonce of the range
+ * @param count The number of nonces in the range
+ */
+void SearchRange(SearchState &state, uint64_t start, uint64_t count)
+{
+  crypto::SHA256::Messages messages{};
+  messages.reserve(ProofOfWorkSearch::BATCH_SIZE);
+
+  uint64_t offset{0};
+  while ((offset < count) && !state.found.load(std::memory_order_relaxed))
+  {
+    auto const batch_size = static_cast<std::size_t>(
+        std::min<uint64_t>(ProofOfWorkSearch::BATCH_SIZE, count - offset));
+    uint64_t const batch_start = start + offset;
+
+    // finish the block hash for each of the nonces and append the value of the proof
+    messages.clear();
+    for (std::size_t i = 0; i < batch_size; ++i)
+    {
+      uint64_t const nonce = batch_start + i;
+
+      crypto::SHA256 hasher{state.midstate};
+      hasher.Update(nonce);
+
+      ByteArray message = hasher.Final();
+      message.Append(state.proof_value);
+
+      messages.emplace_back(std::move(message));
+    }
+
+    // the proof is the double hash of the above
+    auto const digests = crypto::SHA256::HashMultiple(messages);
+
+    messages.clear();
+    for (auto const &digest : digests)
+    {
+      messages.emplace_back(digest);
+    }
+
+    auto const proofs = crypto::SHA256::HashMultiple(messages);
+
+    for (std::size_t i = 0; i < batch_size; ++i)
+    {
+      if (IsBelowTarget(proofs[i], state.target))
+      {
+        bool expected{false};
+        if (state.found.compare_exchange_strong(expected, true))
+        {
+          state.nonce = batch_start + i;
+        }
+
+        return;
+      }
+    }
+
+    offset += batch_size;
+  }
+}
+
+}  // namespace
+
+constexpr std::size_t ProofOfWorkSearch::BATCH_SIZE;
+constexpr uint64_t    ProofOfWorkSearch::MIN_ITERATIONS_PER_THREAD;
+
+/**
+ * Construct the proof of work search
+ *
+ * @param num_threads The maximum number of threads to search with (0 for one per CPU)
+ */
+ProofOfWorkSearch::ProofOfWorkSearch(std::size_t num_threads)
+  : num_threads_{std::max<std::size_t>(
+        (num_threads == 0) ? std::thread::hardware_concurrency() : num_threads, 1)}
+{}
+
+/**
+ * Search for a nonce which satisfies the proof of work of the block
+ *
+ * On success the block is updated with the nonce and its digest. Otherwise the block is left with
+ * the last nonce which was tried.
+ *
+ * @param block The block to be mined
+ * @param start_nonce The first nonce to be tried
+ * @param iterations The number of nonces to be tried
+ * @return true if a nonce was found, otherwise false
+ */
+bool ProofOfWorkSearch::Search(Block &block, uint64_t start_nonce, uint64_t iterations) const
+{
+  SearchState state{};
+  state.midstate.Update(block.GetDigestPrefix());
+  state.proof_value = block.proof.Copy();
+  state.target      = MakeTarget(block.proof.target());
+
+  // only large ranges are worth the cost of starting threads
+  auto const num_threads = static_cast<std::size_t>(std::min<uint64_t>(
+      num_threads_, std::max<uint64_t>(iterations / MIN_ITERATIONS_PER_THREAD, 1)));
+
+  if (num_threads == 1)
+  {
+    SearchRange(state, start_nonce, iterations);
+  }
+  else
+  {
+    uint64_t const chunk = iterations / num_threads;
+
+    std::vector<std::thread> threads{};
+    threads.reserve(num_threads);
+
+    for (std::size_t i = 0; i < num_threads; ++i)
+    {
+      uint64_t const count = (i + 1 == num_threads) ? (iterations - (chunk * i)) : chunk;
+      threads.emplace_back(SearchRange, std::ref(state), start_nonce + (chunk * i), count);
+    }
+
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+  }
+
+  bool const found = state.found;
+
+  block.nonce = found ? state.nonce.load() : (start_nonce + iterations);
+  block.UpdateDigest();
+
+  return found && block.proof();
+}
+
+}  // namespace consensus
+}  // namespace ledger
+}  // namespace fetch
@@ -27,6 +27,11 @@ using fetch::generics::MilliTimer;
 
 namespace fetch {
 namespace ledger {
+namespace {
+
+constexpr char const *BLOCK_INDEX_FILENAME = "chain.block_index.db";
+
+}  // namespace
 
 /**
  * Converts a block status into a human readable string
@@ -66,8 +71,9 @@ MainChain::MainChain(Mode mode)
 {
   if (Mode::IN_MEMORY_DB != mode)
   {
-    // create the block store
+    // create the block store and its index
     block_store_ = std::make_unique<BlockStore>();
+    block_index_ = std::make_unique<BlockIndex>();
 
     RecoverFromFile(mode);
   }
@@ -88,6 +94,11 @@ MainChain::~MainChain()
   {
     block_store_->Flush(false);
   }
+
+  if (block_index_)
+  {
+    block_index_->Flush();
+  }
 }
 
 /**
@@ -114,6 +125,12 @@ BlockStatus MainChain::AddBlock(Block const &blk)
   FETCH_LOG_DEBUG(LOGGING_NAME, "New Block: ", ToBase64(block->body.hash), " -> ", ToString(status),
                   " (weight: ", block->weight, " total: ", block->total_weight, ")");
 
+  // signal that the chain has changed
+  if ((BlockStatus::ADDED == status) && add_callback_)
+  {
+    add_callback_();
+  }
+
   return status;
 }
 
@@ -384,9 +401,9 @@ MainChain::BlockPtr MainChain::GetBlock(BlockHash hash) const
 
   BlockPtr output_block{};
 
-  // attempt to lookup the block
+  // attempt to lookup the block, loading its body from storage if only the header is cached
   auto internal_block = std::make_shared<Block>();
-  if (LookupBlock(std::move(hash), internal_block))
+  if (LookupFullBlock(std::move(hash), internal_block))
   {
     // convert the pointer type to per const
     output_block = std::static_pointer_cast<Block const>(internal_block);
@@ -479,9 +496,8 @@ MainChain::BlockHashSet MainChain::GetTips() const
  */
 void MainChain::RecoverFromFile(Mode mode)
 {
-  // TODO(private issue 667): Complete loading of chain on startup ill-advised
-
   assert(static_cast<bool>(block_store_));
+  assert(static_cast<bool>(block_index_));
 
   FETCH_LOCK(lock_);
 
@@ -489,6 +505,7 @@ void MainChain::RecoverFromFile(Mode mode)
   if (Mode::CREATE_PERSISTENT_DB == mode)
   {
     block_store_->New("chain.db", "chain.index.db");
+    block_index_->New(BLOCK_INDEX_FILENAME);
     head_store_.open("chain.head.db",
                      std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
     return;
@@ -504,53 +521,30 @@ void MainChain::RecoverFromFile(Mode mode)
   }
 
   // load the head block, and attempt verify that this block forms a complete chain to genesis
-  IntBlockPtr block = std::make_shared<Block>();
-  IntBlockPtr head  = std::make_shared<Block>();
+  IntBlockPtr head = std::make_shared<Block>();
 
   // retrieve the starting hash
   BlockHash head_block_hash = GetHeadHash();
 
   bool recovery_complete{false};
-  if (!head_block_hash.empty() && block_store_->Get(storage::ResourceID{head_block_hash}, *block))
+  if (!head_block_hash.empty() && block_store_->Get(storage::ResourceID{head_block_hash}, *head))
   {
-    auto block_index = block->body.block_number;
-
-    // Save the head
-    head = block;
-
-    // Copy head block so as to walk down the chain
-    IntBlockPtr next = std::make_shared<Block>(*block);
-
-    while (block_store_->Get(storage::ResourceID(next->body.previous_hash), *next))
-    {
-      if (next->body.block_number != block_index - 1)
-      {
-        FETCH_LOG_WARN(LOGGING_NAME,
-                       "Discontinuity found when walking main chain during recovery. Current: ",
-                       block_index, " prev: ", next->body.block_number, " Resetting");
-        break;
-      }
-
-      block_index = next->body.block_number;
-    }
-
-    if (block_index != 0)
-    {
-      FETCH_LOG_WARN(LOGGING_NAME,
-                     "Failed to walk main chain when recovering from disk. Got as far back as: ",
-                     block_index, ". Resetting.");
-    }
-    else
+    // the index allows the chain to be verified without loading it, otherwise (for example when
+    // the index is missing or stale) the chain is walked and the index is rebuilt
+    if (RecoverFromIndex(*head) || RecoverByWalkingChain(*head))
     {
       FETCH_LOG_INFO(LOGGING_NAME,
                      "Recovering main chain with heaviest block: ", head->body.block_number);
 
-      // Add heaviest to cache
-      block_chain_[head->body.hash] = head;
+      // Add heaviest to cache, its body is available from the block store
+      block_chain_[head->body.hash] = CreateHeader(*head);
+
+      // the transactions of the recovered blocks are added to the filter on demand
+      tx_filter_floor_ = head->body.block_number + 1;
 
       // Update this as our heaviest
       bool const result      = heaviest_.Update(*head);
-      tips_[head->body.hash] = Tip{head->total_weight};
+      SetTip(head->body.hash, head->total_weight);
 
       if (!result)
       {
@@ -580,6 +574,7 @@ void MainChain::RecoverFromFile(Mode mode)
   if (!recovery_complete)
   {
     block_store_->New("chain.db", "chain.index.db");
+    block_index_->New(BLOCK_INDEX_FILENAME);
 
     // reopen the file and clear the contents
     head_store_.close();
@@ -588,6 +583,103 @@ void MainChain::RecoverFromFile(Mode mode)
   }
 }
 
+/**
+ * Internal: Verify that the stored head forms a complete chain to genesis using the block index.
+ * Since records are only ever appended to the index when they extend its head, only the ends of
+ * the index need to be checked.
+ *
+ * @param head The head block read from the block store
+ * @return true if the index is consistent with the head, otherwise false
+ */
+bool MainChain::RecoverFromIndex(Block const &head)
+{
+  if (!block_index_->Load(BLOCK_INDEX_FILENAME))
+  {
+    return false;
+  }
+
+  BlockIndex::Record genesis{};
+  BlockIndex::Record index_head{};
+
+  bool const consistent = ((head.body.block_number + 1) == block_index_->size()) &&
+                          block_index_->Get(0, genesis) && block_index_->GetHead(index_head) &&
+                          (genesis.GetPreviousHash() == GENESIS_DIGEST) &&
+                          (index_head.GetHash() == head.body.hash);
+
+  if (!consistent)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Block index is inconsistent with the chain, rebuilding");
+  }
+
+  return consistent;
+}
+
+/**
+ * Internal: Verify that the stored head forms a complete chain to genesis by walking back through
+ * the block store. The block index is rebuilt in the process.
+ *
+ * @param head The head block read from the block store
+ * @return true if the chain is complete, otherwise false
+ */
+bool MainChain::RecoverByWalkingChain(Block const &head)
+{
+  std::vector<BlockIndex::Record> records{};
+  BlockIndex::Record              record{};
+
+  if (BlockIndex::CreateRecord(head, record))
+  {
+    records.push_back(record);
+  }
+
+  auto block_index = head.body.block_number;
+
+  // Copy head block so as to walk down the chain
+  IntBlockPtr next = std::make_shared<Block>(head);
+
+  while (block_store_->Get(storage::ResourceID(next->body.previous_hash), *next))
+  {
+    if (next->body.block_number != block_index - 1)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME,
+                     "Discontinuity found when walking main chain during recovery. Current: ",
+                     block_index, " prev: ", next->body.block_number, " Resetting");
+      break;
+    }
+
+    if (BlockIndex::CreateRecord(*next, record))
+    {
+      records.push_back(record);
+    }
+
+    block_index = next->body.block_number;
+  }
+
+  if (block_index != 0)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME,
+                   "Failed to walk main chain when recovering from disk. Got as far back as: ",
+                   block_index, ". Resetting.");
+    return false;
+  }
+
+  // rebuild the index from genesis upwards
+  block_index_->New(BLOCK_INDEX_FILENAME);
+  for (auto it = records.rbegin(); it != records.rend(); ++it)
+  {
+    if (!block_index_->Append(*it))
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Unable to rebuild block index at: ", it->block_number);
+
+      block_index_->Truncate(0);
+      break;
+    }
+  }
+
+  block_index_->Flush();
+
+  return true;
+}
+
 /**
  * Internal: Flush confirmed blocks to disk
  */
@@ -629,6 +721,8 @@ void MainChain::WriteToFile()
       FETCH_LOG_DEBUG(LOGGING_NAME, "Writing genesis. ");
 
       block_store_->Set(storage::ResourceID(block->body.hash), *block);
+      UpdateIndex({block});
+      ReleaseBodies({block});
       SetHeadHash(block->body.hash);
     }
     else
@@ -636,8 +730,9 @@ void MainChain::WriteToFile()
       FETCH_LOG_DEBUG(LOGGING_NAME, "Writing block. ", block->body.block_number);
 
       // Recover the current head block from the file
-      IntBlockPtr current_file_head = std::make_shared<Block>();
-      IntBlockPtr block_head        = block;
+      IntBlockPtr  current_file_head = std::make_shared<Block>();
+      IntBlockPtr  block_head        = block;
+      IntBlockPtrs written_blocks{};
 
       block_store_->Get(storage::ResourceID(GetHeadHash()), *current_file_head);
 
@@ -646,7 +741,13 @@ void MainChain::WriteToFile()
       // touch it or it's root.
       for (;;)
       {
-        block_store_->Set(storage::ResourceID(block->body.hash), *block);
+        // blocks which only have their header cached are already present in the store
+        if (block->has_body)
+        {
+          block_store_->Set(storage::ResourceID(block->body.hash), *block);
+        }
+
+        written_blocks.push_back(block);
 
         // Keep the current_file_head one block behind
         while (current_file_head->body.block_number != block->body.block_number - 1)
@@ -666,6 +767,8 @@ void MainChain::WriteToFile()
       }
 
       // Success - we kept a copy of the new head to write
+      UpdateIndex(written_blocks);
+      ReleaseBodies(written_blocks);
       SetHeadHash(block_head->body.hash);
     }
 
@@ -674,12 +777,61 @@ void MainChain::WriteToFile()
 
     // Force flush of the file object!
     block_store_->Flush(false);
+    block_index_->Flush();
 
     // as final step do some sanity checks
     TrimCache();
   }
 }
 
+/**
+ * Internal: Update the block index after a set of blocks has been written to the block store
+ *
+ * @param written_blocks The blocks that have been written, ordered from the new head downwards
+ */
+void MainChain::UpdateIndex(IntBlockPtrs const &written_blocks)
+{
+  assert(static_cast<bool>(block_index_));
+
+  if (written_blocks.empty())
+  {
+    return;
+  }
+
+  // remove any records which have been replaced by the newly written blocks
+  block_index_->Truncate(written_blocks.back()->body.block_number);
+
+  BlockIndex::Record record{};
+  for (auto it = written_blocks.rbegin(); it != written_blocks.rend(); ++it)
+  {
+    if (!(BlockIndex::CreateRecord(**it, record) && block_index_->Append(record)))
+    {
+      // the index will be rebuilt from the block store the next time the chain is loaded
+      FETCH_LOG_WARN(LOGGING_NAME, "Unable to update block index at: ", (*it)->body.block_number);
+      break;
+    }
+  }
+}
+
+/**
+ * Internal: Replace the cached copies of blocks which have been written to the block store with
+ * their headers. The bodies (i.e. the slices) are loaded back from the store when requested.
+ *
+ * @param written_blocks The blocks that have been written to the block store
+ */
+void MainChain::ReleaseBodies(IntBlockPtrs const &written_blocks)
+{
+  for (auto const &block : written_blocks)
+  {
+    auto const it = block_chain_.find(block->body.hash);
+    if ((it != block_chain_.end()) && it->second->has_body)
+    {
+      // the entry is replaced rather than modified, since the block might be shared with callers
+      it->second = CreateHeader(*it->second);
+    }
+  }
+}
+
 /**
  * Trim the in memory cache
  *
@@ -712,7 +864,7 @@ void MainChain::TrimCache()
         FETCH_LOG_INFO(LOGGING_NAME, "Removing loose block: ", block.hash.ToBase64());
 
         // remove the entry from the tips map
-        tips_.erase(block.hash);
+        RemoveTip(block.hash);
 
         // remove any reference in the loose map
         auto loose_it = loose_blocks_.find(block.previous_hash);
@@ -767,7 +919,7 @@ void MainChain::FlushBlock(IntBlockPtr const &block)
   block_chain_.erase(block->body.hash);
 
   // remove the block hash from the tips
-  tips_.erase(block->body.hash);
+  RemoveTip(block->body.hash);
 }
 
 // We have added a non-loose block. It is then safe to lock the loose blocks map and
@@ -853,8 +1005,8 @@ bool MainChain::UpdateTips(IntBlockPtr const &block)
   assert(block->total_weight != 0);
 
   // remove the tip if exists and add the new one
-  tips_.erase(block->body.previous_hash);
-  tips_[block->body.hash] = Tip{block->total_weight};
+  RemoveTip(block->body.previous_hash);
+  SetTip(block->body.hash, block->total_weight);
 
   // attempt to update the heaviest tip
   return heaviest_.Update(*block);
@@ -967,6 +1119,7 @@ BlockStatus MainChain::InsertBlock(IntBlockPtr const &block, bool evaluate_loose
   // Add block
   FETCH_LOG_DEBUG(LOGGING_NAME, "Adding block to chain: ", ToBase64(block->body.hash));
   AddBlockToCache(block);
+  tx_filter_.Add(*block);
 
   // If the heaviest branch has been updated we should determine if any blocks should be flushed
   // to disk
@@ -1001,6 +1154,26 @@ bool MainChain::LookupBlock(BlockHash hash, IntBlockPtr &block, bool add_to_cach
   return LookupBlockFromCache(hash, block) || LookupBlockFromStorage(hash, block, add_to_cache);
 }
 
+/**
+ * Attempt to lookup a block including its body.
+ *
+ * Blocks which have been written to the persistent storage only have their headers cached, in
+ * which case the complete block is read from storage (without being added to the cache)
+ *
+ * @param hash The hash of the block to search for
+ * @param block The output block to be populated
+ * @return true if successful, otherwise false
+ */
+bool MainChain::LookupFullBlock(BlockHash hash, IntBlockPtr &block) const
+{
+  if (LookupBlockFromCache(hash, block) && block->has_body)
+  {
+    return true;
+  }
+
+  return LookupBlockFromStorage(std::move(hash), block, false);
+}
+
 /**
  * Attempt to locate a block stored in the im memory cache
  *
@@ -1049,10 +1222,10 @@ bool MainChain::LookupBlockFromStorage(BlockHash hash, IntBlockPtr &block, bool
       // hash not serialised, needs to be recomputed
       output_block->UpdateDigest();
 
-      // add the newly loaded block to the cache (if required)
+      // add the newly loaded block to the cache (if required), the body remains in storage
       if (add_to_cache)
       {
-        AddBlockToCache(output_block);
+        AddBlockToCache(CreateHeader(*output_block));
       }
 
       // update the returned shared pointer
@@ -1100,7 +1273,7 @@ bool MainChain::AddTip(IntBlockPtr const &block)
   FETCH_LOCK(lock_);
 
   // record the tip weight
-  tips_[block->body.hash] = Tip{block->total_weight};
+  SetTip(block->body.hash, block->total_weight);
 
   return DetermineHeaviestTip();
 }
@@ -1116,27 +1289,57 @@ bool MainChain::DetermineHeaviestTip()
 
   FETCH_LOCK(lock_);
 
-  if (!tips_.empty())
+  if (!tip_ranking_.empty())
   {
-    // find the heaviest item in our tip selection
-    auto it = std::max_element(
-        tips_.begin(), tips_.end(), [](TipsMap::value_type const &a, TipsMap::value_type const &b) {
-          bool const is_heavier      = a.second.total_weight < b.second.total_weight;
-          bool const is_equal_weight = a.second.total_weight == b.second.total_weight;
-          bool const is_hash_larger  = a.first < b.first;
-
-          return (is_heavier || (is_equal_weight && is_hash_larger));
-        });
+    // the ranking is ordered by weight and then hash, so the heaviest tip is always the last
+    auto const &heaviest = *tip_ranking_.rbegin();
 
     // update the heaviest
-    heaviest_.hash   = it->first;
-    heaviest_.weight = it->second.total_weight;
+    heaviest_.hash   = heaviest.second;
+    heaviest_.weight = heaviest.first;
     success          = true;
   }
 
   return success;
 }
 
+/**
+ * Internal: Add or update a tip, keeping the tip ranking in sync
+ *
+ * @param hash The hash of the tip block
+ * @param total_weight The total weight of the tip block
+ */
+void MainChain::SetTip(BlockHash const &hash, uint64_t total_weight)
+{
+  auto const it = tips_.find(hash);
+  if (it != tips_.end())
+  {
+    tip_ranking_.erase(TipRank{it->second.total_weight, hash});
+    it->second.total_weight = total_weight;
+  }
+  else
+  {
+    tips_.emplace(hash, Tip{total_weight});
+  }
+
+  tip_ranking_.emplace(total_weight, hash);
+}
+
+/**
+ * Internal: Remove a tip (if it exists), keeping the tip ranking in sync
+ *
+ * @param hash The hash of the tip block
+ */
+void MainChain::RemoveTip(BlockHash const &hash)
+{
+  auto const it = tips_.find(hash);
+  if (it != tips_.end())
+  {
+    tip_ranking_.erase(TipRank{it->second.total_weight, hash});
+    tips_.erase(it);
+  }
+}
+
 /**
  * Reindex the tips
  *
@@ -1187,6 +1390,7 @@ bool MainChain::ReindexTips()
 
   // Step 4. Recreate the tips map index
   TipsMap     new_tips{};
+  TipRanking  new_ranking{};
   IntBlockPtr block;
   for (auto const &tip : tips)
   {
@@ -1197,10 +1401,12 @@ bool MainChain::ReindexTips()
 
     // add update the new tip
     new_tips[tip] = Tip{block->total_weight};
+    new_ranking.emplace(block->total_weight, tip);
   }
 
   // clear the existing tips
-  tips_ = std::move(new_tips);
+  tips_        = std::move(new_tips);
+  tip_ranking_ = std::move(new_ranking);
 
   // finally update the heaviest tip
   return DetermineHeaviestTip();
@@ -1221,6 +1427,31 @@ MainChain::IntBlockPtr MainChain::CreateGenesisBlock()
   return genesis;
 }
 
+/**
+ * Create a copy of the block which only contains its header, i.e. everything but the slices
+ *
+ * @param block The complete block
+ * @return The generated header block
+ */
+MainChain::IntBlockPtr MainChain::CreateHeader(Block const &block)
+{
+  auto header                 = std::make_shared<Block>();
+  header->body.hash           = block.body.hash;
+  header->body.previous_hash  = block.body.previous_hash;
+  header->body.merkle_hash    = block.body.merkle_hash;
+  header->body.block_number   = block.body.block_number;
+  header->body.miner          = block.body.miner;
+  header->body.log2_num_lanes = block.body.log2_num_lanes;
+  header->nonce               = block.nonce;
+  header->proof               = block.proof;
+  header->weight              = block.weight;
+  header->total_weight        = block.total_weight;
+  header->is_loose            = block.is_loose;
+  header->has_body            = false;
+
+  return header;
+}
+
 /**
  * Gets the current hash of the heaviest chain
  *
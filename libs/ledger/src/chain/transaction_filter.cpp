@@ -0,0 +1,149 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "crypto/fnv.hpp"
+#include "ledger/chain/transaction_filter.hpp"
+
+#include <array>
+#include <functional>
+
+namespace fetch {
+namespace ledger {
+namespace {
+
+using Digest  = TransactionFilter::Digest;
+using Indices = std::array<std::size_t, TransactionFilter::NUM_HASHES>;
+
+/**
+ * Compute the bit indices for a given digest using double hashing
+ *
+ * @param digest The transaction digest
+ * @return The array of bit indices
+ */
+Indices ComputeIndices(Digest const &digest)
+{
+  uint64_t const hash   = std::hash<Digest>{}(digest);
+  uint64_t const first  = hash & 0xFFFFFFFFu;
+  uint64_t const second = (hash >> 32u) | 1u;
+
+  Indices indices{};
+  for (std::size_t i = 0; i < indices.size(); ++i)
+  {
+    uint64_t const combined = first + (i * second);
+
+    indices[i] = static_cast<std::size_t>(combined % TransactionFilter::BITS_PER_WINDOW);
+  }
+
+  return indices;
+}
+
+}  // namespace
+
+constexpr uint64_t    TransactionFilter::WINDOW_SIZE;
+constexpr std::size_t TransactionFilter::BITS_PER_WINDOW;
+constexpr std::size_t TransactionFilter::NUM_HASHES;
+constexpr std::size_t TransactionFilter::BITS_PER_WORD;
+
+/**
+ * Add all the transactions of a block to the filter
+ *
+ * @param block The block to be added
+ */
+void TransactionFilter::Add(Block const &block)
+{
+  for (auto const &slice : block.body.slices)
+  {
+    for (auto const &tx : slice)
+    {
+      Add(tx.transaction_hash, block.body.block_number);
+    }
+  }
+}
+
+/**
+ * Add a transaction digest to the filter
+ *
+ * @param digest The transaction digest
+ * @param block_number The height of the block in which the transaction was included
+ */
+void TransactionFilter::Add(Digest const &digest, uint64_t block_number)
+{
+  auto &window = windows_[block_number / WINDOW_SIZE];
+
+  // lazily allocate the bloom filter for this window
+  if (window.empty())
+  {
+    window.resize(BITS_PER_WINDOW / BITS_PER_WORD, 0);
+  }
+
+  for (auto const index : ComputeIndices(digest))
+  {
+    window[index / BITS_PER_WORD] |= (Word{1} << (index % BITS_PER_WORD));
+  }
+}
+
+/**
+ * Query the filter for the presence of a transaction
+ *
+ * @param digest The transaction digest
+ * @param earliest_block_number The output lowest block height at which the transaction might have
+ * been included (only valid when the function returns true)
+ * @return false if the transaction has definitely not been added, true if it might have been
+ */
+bool TransactionFilter::Query(Digest const &digest, uint64_t &earliest_block_number) const
+{
+  auto const indices = ComputeIndices(digest);
+
+  // windows are ordered by height, so the first match is the earliest one
+  for (auto const &element : windows_)
+  {
+    auto const &window = element.second;
+
+    bool present{true};
+    for (auto const index : indices)
+    {
+      if ((window[index / BITS_PER_WORD] & (Word{1} << (index % BITS_PER_WORD))) == 0)
+      {
+        present = false;
+        break;
+      }
+    }
+
+    if (present)
+    {
+      earliest_block_number = element.first * WINDOW_SIZE;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Get the number of windows currently tracked by the filter
+ *
+ * @return The number of windows
+ */
+std::size_t TransactionFilter::num_windows() const
+{
+  return windows_.size();
+}
+
+}  // namespace ledger
+}  // namespace fetch
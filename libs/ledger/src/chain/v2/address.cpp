@@ -22,6 +22,10 @@
 #include "crypto/identity.hpp"
 #include "crypto/sha256.hpp"
 
+#include <cassert>
+#include <tuple>
+#include <utility>
+
 namespace fetch {
 namespace ledger {
 namespace v2 {
@@ -47,7 +51,6 @@ Address::ConstByteArray CalculateChecksum(Address::ConstByteArray const &raw_add
  */
 Address::Address(crypto::Identity const &identity)
   : address_(crypto::Hash<crypto::SHA256>(identity.identifier()))
-  , display_(address_ + CalculateChecksum(address_))
 {}
 
 /**
@@ -57,9 +60,43 @@ Address::Address(crypto::Identity const &identity)
  */
 Address::Address(RawAddress const &address)
   : address_(address.data(), address.size())
-  , display_(address_ + CalculateChecksum(address_))
 {}
 
+/**
+ * Create an address from the raw bytes of an address. Used when decoding addresses, so that the
+ * bytes can be taken directly from the input buffer rather than being copied out first.
+ *
+ * @param raw_address The raw bytes of the address (32 bytes)
+ * @return The created address
+ */
+Address Address::FromRawBytes(ConstByteArray raw_address)
+{
+  assert(raw_address.size() == std::tuple_size<RawAddress>::value);
+
+  Address address{};
+  address.address_ = std::move(raw_address);
+
+  return address;
+}
+
+/**
+ * Get the raw bytes of the display variant of the address (with checksum)
+ *
+ * The checksum is only needed when the address is shown on interfaces, therefore it is calculated
+ * on demand rather than each time an address is created or decoded.
+ *
+ * @return The display address
+ */
+Address::ConstByteArray Address::display() const
+{
+  if (address_.empty())
+  {
+    return {};
+  }
+
+  return address_ + CalculateChecksum(address_);
+}
+
 }  // namespace v2
 }  // namespace ledger
 }  // namespace fetch
@@ -36,8 +36,14 @@ bool Transaction::Verify()
     // clear the verified flag
     verified_ = false;
 
-    // generate the payload for this transaction
-    ConstByteArray payload = TransactionSerializer::SerializePayload(*this);
+    // generate the payload for this transaction, unless it is already known from when the
+    // transaction was built or deserialized
+    if (payload_.empty())
+    {
+      payload_ = TransactionSerializer::SerializePayload(*this);
+    }
+
+    ConstByteArray const &payload = payload_;
 
     // ensure that there are some signatories (otherwise it is invalid)
     if (!signatories_.empty())
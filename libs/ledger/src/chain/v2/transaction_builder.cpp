@@ -127,8 +127,10 @@ TransactionBuilder::TransactionPtr TransactionBuilder::Sealer::Build()
   TransactionPtr tx{};
   if (valid)
   {
-    // generate the final transaction
-    partial_transaction_->digest_ = hash_function.Final();
+    // generate the final transaction, keeping the payload for later verification and
+    // serialization
+    partial_transaction_->digest_  = hash_function.Final();
+    partial_transaction_->payload_ = serialized_payload_;
 
     tx = std::move(partial_transaction_);
   }
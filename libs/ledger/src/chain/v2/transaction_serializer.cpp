@@ -24,6 +24,9 @@
 #include "meta/type_traits.hpp"
 #include "vectorise/platform.hpp"
 
+#include <tuple>
+#include <utility>
+
 namespace fetch {
 namespace ledger {
 namespace v2 {
@@ -208,10 +211,16 @@ ConstByteArray Encode(Identity const &identity)
 
 void Decode(ByteArrayBuffer &buffer, Address &address)
 {
-  Address::RawAddress raw_address;
-  buffer.ReadBytes(raw_address.data(), raw_address.size());
+  // addresses are small enough to be held inline by the byte array, so no allocation is needed
+  ConstByteArray raw_address;
+  buffer.ReadByteArray(raw_address, std::tuple_size<Address::RawAddress>::value);
+
+  if (raw_address.size() != std::tuple_size<Address::RawAddress>::value)
+  {
+    throw std::runtime_error("Truncated address");
+  }
 
-  address = Address{raw_address};
+  address = Address::FromRawBytes(std::move(raw_address));
 }
 
 template <typename T>
@@ -344,7 +353,7 @@ void Decode(ByteArrayBuffer &buffer, Identity &identity)
     throw std::runtime_error("Unsupported signature scheme");
   }
 
-  // extract the public key
+  // extract the public key, this references the input buffer rather than copying it
   ConstByteArray public_key;
   buffer.ReadByteArray(public_key, 64u);
 
@@ -495,8 +504,16 @@ ByteArray TransactionSerializer::SerializePayload(Transaction const &tx)
 
 bool TransactionSerializer::Serialize(Transaction const &tx)
 {
-  // serialize the actual buffer
-  auto buffer = SerializePayload(tx);
+  // serialize the actual buffer, reusing the payload when it is already known
+  ByteArray buffer{};
+  if (tx.payload_.empty())
+  {
+    buffer = SerializePayload(tx);
+  }
+  else
+  {
+    buffer.Append(tx.payload_);
+  }
 
   for (auto const &signatory : tx.signatories())
   {
@@ -510,6 +527,20 @@ bool TransactionSerializer::Serialize(Transaction const &tx)
 }
 
 bool TransactionSerializer::Deserialize(Transaction &tx) const
+{
+  std::size_t consumed{0};
+  return Deserialize(tx, consumed);
+}
+
+/**
+ * Deserialize a transaction from the start of the data, which may be followed by further
+ * transactions
+ *
+ * @param tx The transaction to be populated
+ * @param consumed The number of bytes of the data which the transaction occupies
+ * @return true if successful, otherwise false
+ */
+bool TransactionSerializer::Deserialize(Transaction &tx, std::size_t &consumed) const
 {
   serializers::ByteArrayBuffer buffer{serial_data_};
 
@@ -692,8 +723,11 @@ bool TransactionSerializer::Deserialize(Transaction &tx) const
   std::size_t const payload_end  = buffer.tell();
   std::size_t const payload_size = payload_end - payload_start;
 
+  // keep the payload so that it does not need to be serialized again for verification
+  tx.payload_ = buffer.data().SubArray(payload_start, payload_size);
+
   crypto::SHA256 hash_function{};
-  hash_function.Update(buffer.data().SubArray(payload_start, payload_size));
+  hash_function.Update(tx.payload_);
 
   for (std::size_t i = 0; i < num_signatures; ++i)
   {
@@ -706,6 +740,12 @@ bool TransactionSerializer::Deserialize(Transaction &tx) const
   // compute the hash function
   tx.digest_ = hash_function.Final();
 
+  // the contents have changed so any previous verification no longer applies
+  tx.verification_completed_ = false;
+  tx.verified_               = false;
+
+  consumed = buffer.tell() - payload_start;
+
   return true;
 }
 
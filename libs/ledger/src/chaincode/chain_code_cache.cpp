@@ -18,16 +18,25 @@
 
 #include "ledger/chaincode/chain_code_cache.hpp"
 #include "ledger/chaincode/factory.hpp"
-#include "meta/is_log2.hpp"
 
 #include <algorithm>
-#include <chrono>
-#include <unordered_map>
+#include <cassert>
 #include <utility>
 
 namespace fetch {
 namespace ledger {
 
+constexpr std::size_t ChainCodeCache::DEFAULT_CAPACITY;
+
+/**
+ * Construct the chain code cache
+ *
+ * @param capacity The maximum number of chain code instances to be cached
+ */
+ChainCodeCache::ChainCodeCache(std::size_t capacity)
+  : capacity_{std::max<std::size_t>(capacity, 1)}
+{}
+
 ChainCodeCache::ContractPtr ChainCodeCache::Lookup(Identifier const &contract_id,
                                                    StorageInterface &storage)
 {
@@ -42,13 +51,7 @@ ChainCodeCache::ContractPtr ChainCodeCache::Lookup(Identifier const &contract_id
     assert(static_cast<bool>(contract));
 
     // update the cache
-    cache_.emplace(contract_id.qualifier(), contract);
-  }
-
-  // periodically run cache maintenance
-  if ((++counter_ & CLEANUP_MASK) == 0)
-  {
-    RunMaintenance();
+    AddToCache(contract_id, contract);
   }
 
   return contract;
@@ -62,32 +65,27 @@ ChainCodeCache::ContractPtr ChainCodeCache::FindInCache(Identifier const &contra
   auto it = cache_.find(contract_id.qualifier());
   if (it != cache_.end())
   {
-    // extract the contract and refresh the cache timestamp
-    contract             = it->second.chain_code;
-    it->second.timestamp = Clock::now();
+    // extract the contract and mark it as the most recently used
+    contract = it->second.chain_code;
+    recent_.splice(recent_.begin(), recent_, it->second.recent);
   }
 
   return contract;
 }
 
-void ChainCodeCache::RunMaintenance()
+void ChainCodeCache::AddToCache(Identifier const &contract_id, ContractPtr const &contract)
 {
-  static const std::chrono::hours CACHE_LIFETIME{1};
-
-  Timepoint const now = Clock::now();
+  auto const name = contract_id.qualifier();
 
-  for (auto it = cache_.begin(), end = cache_.end(); it != end;)
+  // evict the least recently used instances to make space
+  while (cache_.size() >= capacity_)
   {
-    auto const delta = now - it->second.timestamp;
-    if (delta >= CACHE_LIFETIME)
-    {
-      it = cache_.erase(it);
-    }
-    else
-    {
-      ++it;
-    }
+    cache_.erase(recent_.back());
+    recent_.pop_back();
   }
+
+  recent_.push_front(name);
+  cache_.emplace(name, Element{contract, recent_.begin()});
 }
 
 }  // namespace ledger
@@ -0,0 +1,276 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+#include "ledger/chaincode/compiled_script_cache.hpp"
+#include "core/logger.hpp"
+#include "crypto/sha256.hpp"
+#include "storage/object_store.hpp"
+#include "storage/resource_mapper.hpp"
+#include "vm/module.hpp"
+#include "vm/script_serializers.hpp"
+
+#include <exception>
+#include <utility>
+
+namespace fetch {
+namespace ledger {
+
+constexpr char const *CompiledScriptCache::LOGGING_NAME;
+constexpr std::size_t CompiledScriptCache::DEFAULT_CAPACITY;
+constexpr uint32_t    CompiledScriptCache::FORMAT_VERSION;
+
+/**
+ * The persistent store of the compiled scripts, kept out of the header to avoid leaking the storage
+ * and the VM serialisation headers into every user of the cache
+ */
+class CompiledScriptCache::BackingStore
+{
+public:
+  using Store = storage::ObjectStore<vm::Script>;
+
+  BackingStore(std::string const &doc_file, std::string const &index_file)
+  {
+    store_.Load(doc_file, index_file, true);
+  }
+
+  bool Get(ConstByteArray const &key, vm::Script &script)
+  {
+    return store_.Get(storage::ResourceID{key}, script);
+  }
+
+  void Set(ConstByteArray const &key, vm::Script const &script)
+  {
+    store_.Set(storage::ResourceID{key}, script);
+  }
+
+  void Flush()
+  {
+    store_.Flush(false);
+  }
+
+private:
+  Store store_;
+};
+
+/**
+ * Get the process wide instance of the cache, shared by all of the executors
+ *
+ * @return The cache instance
+ */
+CompiledScriptCache &CompiledScriptCache::Instance()
+{
+  static CompiledScriptCache instance;
+  return instance;
+}
+
+/**
+ * Construct an in memory only cache
+ *
+ * @param capacity The maximum number of scripts kept in memory
+ */
+CompiledScriptCache::CompiledScriptCache(std::size_t capacity)
+  : capacity_{(capacity > 0) ? capacity : 1}
+{}
+
+CompiledScriptCache::~CompiledScriptCache()
+{
+  FETCH_LOCK(lock_);
+
+  if (store_)
+  {
+    store_->Flush();
+  }
+}
+
+/**
+ * Open (or create) the backing store so that compiled scripts persist across restarts
+ *
+ * @param doc_file The path to the document file
+ * @param index_file The path to the index file
+ */
+void CompiledScriptCache::Load(std::string const &doc_file, std::string const &index_file)
+{
+  auto store = std::make_unique<BackingStore>(doc_file, index_file);
+
+  FETCH_LOCK(lock_);
+
+  if (store_)
+  {
+    store_->Flush();
+  }
+
+  store_ = std::move(store);
+}
+
+/**
+ * Determine if the cache has a backing store
+ *
+ * @return true if compiled scripts are persisted, otherwise false
+ */
+bool CompiledScriptCache::is_persistent() const
+{
+  FETCH_LOCK(lock_);
+  return static_cast<bool>(store_);
+}
+
+/**
+ * Create the cache key for a contract. As well as the source digest, the key covers the version of
+ * the serialised format and the layout of the module, since the opcodes and type ids in the
+ * bytecode are only meaningful for the module that it was compiled against.
+ *
+ * @param source_digest The digest of the contract source
+ * @param module The module the contract is compiled against
+ * @return The cache key
+ */
+CompiledScriptCache::ConstByteArray CompiledScriptCache::CreateKey(
+    ConstByteArray const &source_digest, vm::Module const &module)
+{
+  crypto::SHA256 hash;
+  hash.Update(FORMAT_VERSION);
+  hash.Update(module.LayoutId());
+  hash.Update(source_digest);
+
+  return hash.Final();
+}
+
+/**
+ * Lookup a compiled script, first in memory and then in the backing store
+ *
+ * @param key The key of the script (see CreateKey)
+ * @return The compiled script if present, otherwise nullptr
+ */
+CompiledScriptCache::ScriptPtr CompiledScriptCache::Lookup(ConstByteArray const &key)
+{
+  FETCH_LOCK(lock_);
+
+  auto it = entries_.find(key);
+  if (it != entries_.end())
+  {
+    // promote the script to the most recently used
+    recent_.splice(recent_.begin(), recent_, it->second.recent);
+
+    ++counters_.hits;
+    return it->second.script;
+  }
+
+  ScriptPtr script;
+
+  if (store_)
+  {
+    auto stored = std::make_shared<vm::Script>();
+
+    try
+    {
+      if (store_->Get(key, *stored))
+      {
+        script = std::move(stored);
+      }
+    }
+    catch (std::exception const &ex)
+    {
+      // a corrupt entry is simply compiled again and overwritten
+      FETCH_LOG_WARN(LOGGING_NAME, "Unable to load compiled script: ", ex.what());
+    }
+  }
+
+  if (script)
+  {
+    ++counters_.store_hits;
+    AddToMemory(key, script);
+  }
+  else
+  {
+    ++counters_.misses;
+  }
+
+  return script;
+}
+
+/**
+ * Add a compiled script to the cache, persisting it when a backing store has been loaded
+ *
+ * @param key The key of the script (see CreateKey)
+ * @param script The compiled script, which must not be modified afterwards
+ */
+void CompiledScriptCache::Add(ConstByteArray const &key, ScriptPtr const &script)
+{
+  if (!script)
+  {
+    return;
+  }
+
+  FETCH_LOCK(lock_);
+
+  AddToMemory(key, script);
+
+  if (store_)
+  {
+    store_->Set(key, *script);
+  }
+}
+
+/**
+ * Get the number of scripts held in memory
+ *
+ * @return The number of scripts
+ */
+std::size_t CompiledScriptCache::size() const
+{
+  FETCH_LOCK(lock_);
+  return entries_.size();
+}
+
+/**
+ * Get a snapshot of the cache counters
+ *
+ * @return The counters
+ */
+CompiledScriptCache::Counters CompiledScriptCache::counters() const
+{
+  FETCH_LOCK(lock_);
+  return counters_;
+}
+
+/**
+ * Insert (or replace) a script in memory, evicting the least recently used scripts as required.
+ * Must be called with the lock held.
+ *
+ * @param key The key of the script
+ * @param script The compiled script
+ */
+void CompiledScriptCache::AddToMemory(ConstByteArray const &key, ScriptPtr const &script)
+{
+  auto it = entries_.find(key);
+  if (it != entries_.end())
+  {
+    it->second.script = script;
+    recent_.splice(recent_.begin(), recent_, it->second.recent);
+    return;
+  }
+
+  while (entries_.size() >= capacity_)
+  {
+    entries_.erase(recent_.back());
+    recent_.pop_back();
+  }
+
+  recent_.push_front(key);
+  entries_.emplace(key, Entry{script, recent_.begin()});
+}
+
+}  // namespace ledger
+}  // namespace fetch
@@ -188,5 +188,15 @@ ledger::StateAdapter &Contract::state()
   return *state_;
 }
 
+/**
+ * Profiler Accessor
+ *
+ * @return The attached profiler, or nullptr if the contract is not being profiled
+ */
+vm::Profiler *Contract::profiler() const
+{
+  return profiler_;
+}
+
 }  // namespace ledger
 }  // namespace fetch
@@ -0,0 +1,203 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/chaincode/contract_compiler.hpp"
+#include "core/logger.hpp"
+#include "crypto/hash.hpp"
+#include "crypto/sha256.hpp"
+#include "ledger/chaincode/compiled_script_cache.hpp"
+#include "ledger/chaincode/smart_contract_exception.hpp"
+#include "vm/module.hpp"
+#include "vm_modules/vm_factory.hpp"
+
+#include <exception>
+#include <utility>
+
+namespace fetch {
+namespace ledger {
+
+constexpr char const *ContractCompiler::LOGGING_NAME;
+constexpr std::size_t ContractCompiler::DEFAULT_NUM_THREADS;
+
+/**
+ * Get the process wide instance of the compiler, which populates the process wide script cache
+ *
+ * @return The compiler instance
+ */
+ContractCompiler &ContractCompiler::Instance()
+{
+  static ContractCompiler instance{CompiledScriptCache::Instance()};
+  return instance;
+}
+
+/**
+ * Construct the compiler and start its workers
+ *
+ * @param cache The cache which the compiled scripts are added to
+ * @param num_threads The number of compilations which can run concurrently
+ */
+ContractCompiler::ContractCompiler(CompiledScriptCache &cache, std::size_t num_threads)
+  : cache_{cache}
+  , module_{vm_modules::VMFactory::GetModule()}
+  , pool_{network::MakeThreadPool((num_threads > 0) ? num_threads : 1, "ContractCompiler")}
+{
+  pool_->Start();
+}
+
+ContractCompiler::~ContractCompiler()
+{
+  // any compilations which have not started are abandoned, their waiters compile inline
+  pool_->Stop();
+}
+
+/**
+ * Start compiling a contract in the background, unless it is already compiled or being compiled
+ *
+ * @param source The source of the contract
+ * @return true if a new compilation was started, otherwise false
+ */
+bool ContractCompiler::Submit(std::string const &source)
+{
+  if (source.empty())
+  {
+    return false;
+  }
+
+  ConstByteArray const digest = crypto::Hash<crypto::SHA256>(source);
+  ConstByteArray const key    = CompiledScriptCache::CreateKey(digest, *module_);
+
+  auto promise = std::make_shared<std::promise<ScriptPtr>>();
+  {
+    FETCH_LOCK(lock_);
+
+    if (pending_.find(key) != pending_.end())
+    {
+      return false;
+    }
+
+    pending_.emplace(key, promise->get_future().share());
+  }
+
+  ++submitted_;
+
+  pool_->Post([this, key, source, promise]() {
+    try
+    {
+      promise->set_value(CompileScript(key, source, module_));
+    }
+    catch (...)
+    {
+      // the errors are raised again in whichever execution waits for the result
+      promise->set_exception(std::current_exception());
+    }
+
+    // all further lookups are served by the script cache
+    FETCH_LOCK(lock_);
+    pending_.erase(key);
+  });
+
+  return true;
+}
+
+/**
+ * Get the compiled script for a contract, waiting for a compilation which is in flight or otherwise
+ * compiling it on the calling thread
+ *
+ * @param source The source of the contract
+ * @param digest The SHA256 digest of the source
+ * @param module The module the contract is to be compiled against
+ * @return The compiled script
+ * @throws SmartContractException if the contract fails to compile
+ */
+ContractCompiler::ScriptPtr ContractCompiler::Compile(std::string const &   source,
+                                                      ConstByteArray const &digest,
+                                                      ModulePtr const &     module)
+{
+  ConstByteArray const key = CompiledScriptCache::CreateKey(digest, *module);
+
+  Result result;
+  {
+    FETCH_LOCK(lock_);
+
+    auto const it = pending_.find(key);
+    if (it != pending_.end())
+    {
+      result = it->second;
+    }
+  }
+
+  if (result.valid())
+  {
+    try
+    {
+      return result.get();
+    }
+    catch (std::future_error const &ex)
+    {
+      // the compilation was abandoned when the workers were stopped
+      FETCH_LOG_WARN(LOGGING_NAME, "Background compilation abandoned: ", ex.what());
+    }
+  }
+
+  return CompileScript(key, source, module);
+}
+
+/**
+ * Get the number of compilations which are still in flight
+ *
+ * @return The number of pending compilations
+ */
+std::size_t ContractCompiler::pending() const
+{
+  FETCH_LOCK(lock_);
+  return pending_.size();
+}
+
+/**
+ * Lookup a script in the cache, compiling and adding it on a miss
+ *
+ * @param key The cache key of the contract
+ * @param source The source of the contract
+ * @param module The module the contract is to be compiled against
+ * @return The compiled script
+ * @throws SmartContractException if the contract fails to compile
+ */
+ContractCompiler::ScriptPtr ContractCompiler::CompileScript(ConstByteArray const &key,
+                                                            std::string const &   source,
+                                                            ModulePtr const &     module)
+{
+  ScriptPtr script = cache_.Lookup(key);
+  if (script)
+  {
+    return script;
+  }
+
+  script      = std::make_shared<vm::Script>();
+  auto errors = vm_modules::VMFactory::Compile(module, source, *script);
+
+  if (!errors.empty())
+  {
+    throw SmartContractException(SmartContractException::Category::COMPILATION, std::move(errors));
+  }
+
+  cache_.Add(key, script);
+  return script;
+}
+
+}  // namespace ledger
+}  // namespace fetch
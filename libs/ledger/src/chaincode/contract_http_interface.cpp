@@ -25,12 +25,16 @@
 #include "http/json_response.hpp"
 #include "ledger/chain/mutable_transaction.hpp"
 #include "ledger/chain/transaction.hpp"
+#include "ledger/chain/v2/transaction_serializer.hpp"
 #include "ledger/chain/wire_transaction.hpp"
 #include "ledger/chaincode/contract.hpp"
+#include "ledger/chaincode/query_result_cache.hpp"
 #include "ledger/state_adapter.hpp"
 #include "ledger/transaction_processor.hpp"
+#include "metrics/tracer.hpp"
 #include "variant/variant.hpp"
 
+#include <algorithm>
 #include <string>
 
 namespace fetch {
@@ -81,6 +85,30 @@ http::HTTPResponse JsonBadRequest()
   return http::CreateJsonResponse("", http::Status::CLIENT_ERROR_BAD_REQUEST);
 }
 
+/**
+ * Get the signer a transaction is accounted to, the lowest of its identities if it has several
+ */
+ConstByteArray SignerOf(MutableTransaction const &tx)
+{
+  ConstByteArray signer{};
+  for (auto const &signature : tx.signatures())
+  {
+    ConstByteArray const &identifier = signature.first.identifier();
+    if (signer.empty() || (identifier < signer))
+    {
+      signer = identifier;
+    }
+  }
+
+  return signer;
+}
+
+ConstByteArray SignerOf(v2::Transaction const &tx)
+{
+  auto const &signatories = tx.signatories();
+  return signatories.empty() ? ConstByteArray{} : signatories.front().identity.identifier();
+}
+
 std::string GenerateTimestamp()
 {
   std::time_t now = std::time(nullptr);
@@ -100,12 +128,16 @@ constexpr char const *ContractHttpInterface::LOGGING_NAME;
  *
  * @param storage The reference to the storage engine
  * @param processor The reference to the (input) transaction processor
+ * @param query_cache The cache of the query results, or nullptr to always run the queries
  */
 ContractHttpInterface::ContractHttpInterface(StorageInterface &    storage,
-                                             TransactionProcessor &processor)
+                                             TransactionProcessor &processor,
+                                             QueryResultCache *    query_cache)
   : storage_{storage}
   , processor_{processor}
+  , query_cache_{query_cache}
   , access_log_{"access.log"}
+  , admission_{[&processor]() { return processor.GetBacklog(); }}
 {
   // create all the contracts
   auto const &contracts = contract_cache_.factory().GetChainCodeContracts();
@@ -174,6 +206,40 @@ ContractHttpInterface::ContractHttpInterface(StorageInterface &    storage,
          FETCH_UNUSED(params);
          return OnTransaction(request, ConstByteArray{});
        });
+
+  Get("/api/status/admission", [this](http::ViewParameters const &, http::HTTPRequest const &) {
+    auto const &counters = admission_.counters();
+
+    Variant response                = Variant::Object();
+    response["depth"]               = admission_.GetDepth();
+    response["pressure"]            = admission_.GetPressure();
+    response["clients"]             = admission_.GetNumClients();
+    response["signers"]             = admission_.GetNumSigners();
+    response["admitted"]            = counters.admitted.load();
+    response["rate_limited_client"] = counters.rate_limited_client.load();
+    response["rate_limited_signer"] = counters.rate_limited_signer.load();
+    response["overloaded"]          = counters.overloaded.load();
+
+    return http::CreateJsonResponse(response);
+  });
+
+  if (query_cache_ != nullptr)
+  {
+    Get("/api/status/query-cache", [this](http::ViewParameters const &, http::HTTPRequest const &) {
+      auto const counters = query_cache_->counters();
+
+      Variant response          = Variant::Object();
+      response["state"]         = ToBase64(query_cache_->state());
+      response["entries"]       = query_cache_->size();
+      response["bytes"]         = query_cache_->bytes();
+      response["hits"]          = counters.hits;
+      response["misses"]        = counters.misses;
+      response["evictions"]     = counters.evictions;
+      response["invalidations"] = counters.invalidations;
+
+      return http::CreateJsonResponse(response);
+    });
+  }
 }
 
 /**
@@ -199,6 +265,17 @@ http::HTTPResponse ContractHttpInterface::OnQuery(ConstByteArray const &   contr
     // record an entry in the access log
     RecordQuery(contract_name, query, request);
 
+    // queries are read only, the result is unchanged until the state is
+    QueryResultCache::Generation generation{0};
+    if (query_cache_ != nullptr)
+    {
+      ConstByteArray cached{};
+      if (query_cache_->Lookup(contract_name, query, request.body(), cached, generation))
+      {
+        return http::CreateJsonResponse(cached);
+      }
+    }
+
     // parse the incoming request
     json::JSONDocument doc;
     doc.Parse(request.body());
@@ -217,7 +294,18 @@ http::HTTPResponse ContractHttpInterface::OnQuery(ConstByteArray const &   contr
 
     if (Contract::Status::OK == status)
     {
-      return http::CreateJsonResponse(response);
+      if (query_cache_ == nullptr)
+      {
+        return http::CreateJsonResponse(response);
+      }
+
+      std::ostringstream oss;
+      oss << response;
+
+      ConstByteArray const result{oss.str()};
+      query_cache_->Insert(contract_name, query, request.body(), result, generation);
+
+      return http::CreateJsonResponse(result);
     }
     else
     {
@@ -244,9 +332,18 @@ http::HTTPResponse ContractHttpInterface::OnTransaction(http::HTTPRequest const
 {
   Variant json = Variant::Object();
 
+  SubmitTxStatus submitted{};
+
   try
   {
-    SubmitTxStatus submitted{};
+    auto const received = metrics::Tracer::Clock::now();
+
+    // avoid decoding anything while the ingest pipeline is full
+    if (admission_.IsOverloaded())
+    {
+      submitted.decision = Decision::OVERLOADED;
+      throw std::runtime_error("Node is overloaded, retry later");
+    }
 
     // detect the content format, defaulting to json
     byte_array::ConstByteArray content_type = "application/json";
@@ -263,6 +360,11 @@ http::HTTPResponse ContractHttpInterface::OnTransaction(http::HTTPRequest const
       submitted      = SubmitNativeTx(request, expected_contract, txs);
       unknown_format = false;
     }
+    else if (content_type == "application/octet-stream")
+    {
+      submitted      = SubmitBinaryTx(request, expected_contract, txs);
+      unknown_format = false;
+    }
     else if (content_type == "application/vnd+fetch.transaction+json" ||
              content_type == "application/json")
     {
@@ -270,6 +372,16 @@ http::HTTPResponse ContractHttpInterface::OnTransaction(http::HTTPRequest const
       unknown_format = false;
     }
 
+    // the submission is the root of the trace of each (sampled) transaction
+    auto &tracer = metrics::Tracer::Instance();
+    if (tracer.enabled())
+    {
+      for (auto const &digest : txs)
+      {
+        tracer.StartTransactionRootSpan("tx.submit", digest, received).End();
+      }
+    }
+
     // record the transaction in the access log
     RecordTransaction(submitted, request, expected_contract);
 
@@ -287,6 +399,11 @@ http::HTTPResponse ContractHttpInterface::OnTransaction(http::HTTPRequest const
     {
       json["error"] = "Unknown content type: " + Quoted(content_type);
     }
+    else if (Decision::ADMITTED != submitted.decision)
+    {
+      json["error"] = std::string{"Some transactions have NOT been admitted: "} +
+                      ToString(submitted.decision);
+    }
     else if (submitted.processed != submitted.received)
     {
       json["error"] =
@@ -299,10 +416,30 @@ http::HTTPResponse ContractHttpInterface::OnTransaction(http::HTTPRequest const
   }
 
   // based on the contents of the response determine the correct status code
-  http::Status const status_code =
-      json.Has("error") ? http::Status::CLIENT_ERROR_BAD_REQUEST : http::Status::SUCCESS_OK;
+  http::Status status_code = http::Status::SUCCESS_OK;
+  switch (submitted.decision)
+  {
+  case Decision::ADMITTED:
+    if (json.Has("error"))
+    {
+      status_code = http::Status::CLIENT_ERROR_BAD_REQUEST;
+    }
+    break;
+  case Decision::RATE_LIMITED:
+    status_code = http::Status::CLIENT_ERROR_TOO_MANY_REQUESTS;
+    break;
+  case Decision::OVERLOADED:
+    status_code = http::Status::SERVER_ERROR_SERVICE_UNAVAILABLE;
+    break;
+  }
 
-  return http::CreateJsonResponse(json, status_code);
+  auto response = http::CreateJsonResponse(json, status_code);
+  if (Decision::ADMITTED != submitted.decision)
+  {
+    response.AddHeader("retry-after", "1");
+  }
+
+  return response;
 }
 
 /**
@@ -324,62 +461,53 @@ http::HTTPResponse ContractHttpInterface::OnTransaction(http::HTTPRequest const
 ContractHttpInterface::SubmitTxStatus ContractHttpInterface::SubmitJsonTx(
     http::HTTPRequest const &request, ConstByteArray expected_contract, TxHashes &txs)
 {
-  std::size_t submitted{0};
-  std::size_t expected_count{0};
-
   // parse the JSON request
   json::JSONDocument doc{request.body()};
 
   FETCH_LOG_DEBUG(LOGGING_NAME, "NEW TRANSACTION RECEIVED");
   FETCH_LOG_DEBUG(LOGGING_NAME, request.body());
 
-  if (doc.root().IsArray())
-  {
-    expected_count = doc.root().size();
-    for (std::size_t i = 0, end = doc.root().size(); i < end; ++i)
-    {
-      auto const &tx_obj = doc[i];
-
-      MutableTransaction tx{FromWireTransaction(tx_obj)};
+  // the request is either a single transaction or an array of them
+  auto &            root           = doc.root();
+  bool const        is_array       = root.IsArray();
+  std::size_t const expected_count = is_array ? root.size() : 1;
 
-      if (!expected_contract.empty() && (tx.contract_name() != expected_contract))
-      {
-        continue;
-      }
+  TransactionProcessor::MutableTxList batch;
+  batch.reserve(expected_count);
 
-      tx.UpdateDigest();
-
-      // add the transaction to the processor
-      txs.emplace_back(tx.digest());
-      processor_.AddTransaction(std::move(tx));
-      ++submitted;
-    }
-  }
-  else
+  for (std::size_t i = 0; i < expected_count; ++i)
   {
-    expected_count = 1;
-    MutableTransaction tx{FromWireTransaction(doc.root())};
-
-    if (expected_contract.empty() || (tx.contract_name() == expected_contract))
-    {
-      tx.UpdateDigest();
+    MutableTransaction tx{FromWireTransaction(is_array ? root[i] : root)};
 
-      // add the transaction to the processor
-      txs.emplace_back(tx.digest());
-      processor_.AddTransaction(std::move(tx));
-      ++submitted;
-    }
-    else
+    if (!expected_contract.empty() && (tx.contract_name() != expected_contract))
     {
       FETCH_LOG_WARN(LOGGING_NAME, "Failed to match expected_contract_name: ", expected_contract,
                      " with ", tx.contract_name());
+      continue;
     }
+
+    tx.UpdateDigest();
+
+    batch.emplace_back(std::move(tx));
   }
 
-  FETCH_LOG_DEBUG(LOGGING_NAME, "Submitted ", submitted, " transactions from ",
+  SubmitTxStatus status{0, expected_count};
+  Admit(request, batch, status);
+
+  for (auto const &tx : batch)
+  {
+    txs.emplace_back(tx.digest());
+  }
+
+  status.processed = batch.size();
+
+  // hand all the transactions to the processor at once
+  processor_.AddTransactions(std::move(batch));
+
+  FETCH_LOG_DEBUG(LOGGING_NAME, "Submitted ", status.processed, " transactions from ",
                   request.originating_address(), ':', request.originating_port());
 
-  return SubmitTxStatus{submitted, expected_count};
+  return status;
 }
 
 /**
@@ -409,23 +537,160 @@ ContractHttpInterface::SubmitTxStatus ContractHttpInterface::SubmitNativeTx(
   serializers::ByteArrayBuffer buffer(request.body());
   buffer >> transactions;
 
-  std::size_t submitted{0};
-  for (auto const &input_tx : transactions)
+  TransactionProcessor::MutableTxList batch;
+  batch.reserve(transactions.size());
+
+  for (auto &input_tx : transactions)
   {
     if (!expected_contract.empty() && (input_tx.tx.contract_name() != expected_contract))
     {
       continue;
     }
 
-    processor_.AddTransaction(input_tx.tx);
-    txs.emplace_back(input_tx.tx.digest());
-    ++submitted;
+    batch.emplace_back(std::move(input_tx.tx));
   }
 
-  FETCH_LOG_DEBUG(LOGGING_NAME, "Submitted ", submitted, " transactions from ",
+  SubmitTxStatus status{0, transactions.size()};
+  Admit(request, batch, status);
+
+  for (auto const &tx : batch)
+  {
+    txs.emplace_back(tx.digest());
+  }
+
+  status.processed = batch.size();
+
+  // hand all the transactions to the processor at once
+  processor_.AddTransactions(std::move(batch));
+
+  FETCH_LOG_DEBUG(LOGGING_NAME, "Submitted ", status.processed, " transactions from ",
                   request.originating_address(), ':', request.originating_port());
 
-  return SubmitTxStatus{submitted, transactions.size()};
+  return status;
+}
+
+/**
+ * Method handles incoming http request containing one or more v2 transactions in the binary
+ * format of the TransactionSerializer, concatenated one after another.
+ *
+ * Compared to the JSON format, this avoids base64 encoding the payload and parsing text, the
+ * transactions are decoded straight from the request body.
+ *
+ * @param request https request containing the binary transaction(s)
+ * @param expected_contract_name Must be empty, v2 transactions identify their contract by digest
+ *        and so can not be submitted to the endpoints of a contract
+ *
+ * @return submit status, please see the `SubmitTxStatus` structure
+ * @see SubmitTxStatus
+ */
+ContractHttpInterface::SubmitTxStatus ContractHttpInterface::SubmitBinaryTx(
+    http::HTTPRequest const &request, ConstByteArray expected_contract, TxHashes &txs)
+{
+  if (!v2_handler_)
+  {
+    throw std::runtime_error("Binary transactions are not supported by this node");
+  }
+
+  ConstByteArray const &body = request.body();
+
+  V2TransactionList transactions;
+
+  std::size_t offset{0};
+  while (offset < body.size())
+  {
+    v2::TransactionSerializer const serializer{body.SubArray(offset, body.size() - offset)};
+
+    std::size_t consumed{0};
+    transactions.emplace_back();
+    if (!serializer.Deserialize(transactions.back(), consumed) || (consumed == 0))
+    {
+      throw std::runtime_error("Unable to decode binary transaction at offset " +
+                               std::to_string(offset));
+    }
+
+    offset += consumed;
+  }
+
+  std::size_t const received = transactions.size();
+
+  // only the transactions with valid signatures are accepted
+  V2TransactionList verified;
+  verified.reserve(received);
+
+  if (expected_contract.empty())
+  {
+    for (auto &tx : transactions)
+    {
+      if (tx.Verify())
+      {
+        verified.emplace_back(std::move(tx));
+      }
+      else
+      {
+        FETCH_LOG_WARN(LOGGING_NAME, "Rejecting binary transaction with invalid signature");
+      }
+    }
+  }
+
+  SubmitTxStatus status{0, received};
+  Admit(request, verified, status);
+
+  for (auto const &tx : verified)
+  {
+    txs.emplace_back(tx.digest());
+  }
+
+  status.processed = verified.size();
+  if (status.processed != 0)
+  {
+    v2_handler_(std::move(verified));
+  }
+
+  FETCH_LOG_DEBUG(LOGGING_NAME, "Submitted ", status.processed, " binary transactions from ",
+                  request.originating_address(), ':', request.originating_port());
+
+  return status;
+}
+
+/**
+ * Apply admission control to a batch of transactions: the batch is dropped if its client is over
+ * its rate (or the node is overloaded), otherwise the transactions whose signers are over their
+ * rate are removed from it
+ *
+ * @param request The originating HTTPRequest object
+ * @param batch The transactions to be admitted, updated to the admitted ones
+ * @param status The submission status, updated with the admission decision
+ */
+template <typename TxList>
+void ContractHttpInterface::Admit(http::HTTPRequest const &request, TxList &batch,
+                                  SubmitTxStatus &status)
+{
+  if (batch.empty())
+  {
+    return;
+  }
+
+  status.decision = admission_.AdmitClient(request.originating_address(), batch.size());
+  if (Decision::ADMITTED != status.decision)
+  {
+    FETCH_LOG_INFO(LOGGING_NAME, "Rejected ", batch.size(), " transactions from ",
+                   request.originating_address(), ": ", ToString(status.decision));
+
+    batch.clear();
+    return;
+  }
+
+  auto const now = AdmissionController::Clock::now();
+
+  auto const end = std::remove_if(batch.begin(), batch.end(), [this, &now](auto const &tx) {
+    return Decision::ADMITTED != admission_.AdmitSigner(SignerOf(tx), now);
+  });
+
+  if (end != batch.end())
+  {
+    status.decision = Decision::RATE_LIMITED;
+    batch.erase(end, batch.end());
+  }
 }
 
 /**
@@ -98,6 +98,14 @@ Deed::Deed(Signees signees, OperationTresholds thresholds)
   , full_weight_{SigneesFullWeight(signees_)}
 {}
 
+/**
+ * Recalculates the derived data after the signees have changed, e.g. on deserialization
+ */
+void Deed::UpdateFullWeight()
+{
+  full_weight_ = SigneesFullWeight(signees_);
+}
+
 /**
  * Checks sanity of current deed state
  *
@@ -158,17 +166,26 @@ bool Deed::Verify(VerifiedTransaction const &tx, DeedOperation const &operation)
     return false;
   }
 
+  Weight const threshold  = op->second;
+  auto const & signatures = tx.signatures();
+
+  // accumulate the votes until the threshold is reached
   Weight vote = 0;
   for (auto const &signee : signees_)
   {
-    if (tx.signatures().count(crypto::Identity{signee.first}) > 0)
+    if (signatures.count(crypto::Identity{signee.first}) > 0)
     {
       vote += signee.second;
+
+      if (vote >= threshold)
+      {
+        return true;
+      }
     }
   }
 
   // Evaluating sufficiency of accumulated vote:
-  return vote >= op->second;
+  return vote >= threshold;
 }
 
 /**
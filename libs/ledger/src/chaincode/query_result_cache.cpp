@@ -0,0 +1,231 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/byte_array.hpp"
+#include "ledger/chaincode/query_result_cache.hpp"
+
+namespace fetch {
+namespace ledger {
+
+constexpr std::size_t QueryResultCache::DEFAULT_MAX_ENTRIES;
+constexpr std::size_t QueryResultCache::DEFAULT_MAX_BYTES;
+
+/**
+ * Construct the query result cache
+ *
+ * @param max_entries The maximum number of results to be cached
+ * @param max_bytes The maximum total size of the cached results (and their keys)
+ */
+QueryResultCache::QueryResultCache(std::size_t max_entries, std::size_t max_bytes)
+  : max_entries_{max_entries}
+  , max_bytes_{max_bytes}
+{}
+
+/**
+ * Signal that the state has been committed (or restored) to a given root. Unless the state is
+ * unchanged, all the cached results are dropped.
+ *
+ * @param state_root The merkle root of the state
+ */
+void QueryResultCache::SetState(ConstByteArray const &state_root)
+{
+  FETCH_LOCK(lock_);
+
+  if (state_root == state_)
+  {
+    return;
+  }
+
+  ClearLocked();
+  state_ = state_root;
+}
+
+/**
+ * Signal that the state is about to be modified. All the cached results are dropped and no results
+ * are cached until the next call to SetState.
+ */
+void QueryResultCache::BeginStateUpdate()
+{
+  FETCH_LOCK(lock_);
+
+  ClearLocked();
+  state_ = ConstByteArray{};
+}
+
+/**
+ * Lookup the result of a query against the current state
+ *
+ * @param contract The name of the contract
+ * @param query The name of the query
+ * @param args The (serialised) arguments of the query
+ * @param result The output result, if found
+ * @param generation The output generation, to be passed to Insert if the result was not found
+ * @return true if the result was found, otherwise false
+ */
+bool QueryResultCache::Lookup(ConstByteArray const &contract, ConstByteArray const &query,
+                              ConstByteArray const &args, ConstByteArray &result,
+                              Generation &generation)
+{
+  auto const key = Key(contract, query, args);
+
+  FETCH_LOCK(lock_);
+
+  generation = generation_;
+
+  auto it = results_.find(key);
+  if (it == results_.end())
+  {
+    ++counters_.misses;
+    return false;
+  }
+
+  // move the result to the front of the recently used list
+  recent_.splice(recent_.begin(), recent_, it->second.recent);
+
+  result = it->second.result;
+  ++counters_.hits;
+
+  return true;
+}
+
+/**
+ * Cache the result of a query, unless the state has changed since the corresponding lookup
+ *
+ * @param contract The name of the contract
+ * @param query The name of the query
+ * @param args The (serialised) arguments of the query
+ * @param result The result of the query
+ * @param generation The generation returned by the lookup
+ * @return true if the result was cached, otherwise false
+ */
+bool QueryResultCache::Insert(ConstByteArray const &contract, ConstByteArray const &query,
+                              ConstByteArray const &args, ConstByteArray const &result,
+                              Generation generation)
+{
+  auto const        key  = Key(contract, query, args);
+  std::size_t const size = key.size() + result.size();
+
+  FETCH_LOCK(lock_);
+
+  if ((generation != generation_) || state_.empty() || (size > max_bytes_) ||
+      (max_entries_ == 0) || (results_.find(key) != results_.end()))
+  {
+    return false;
+  }
+
+  // evict the least recently used results until there is room
+  while (!recent_.empty() && ((results_.size() >= max_entries_) || ((bytes_ + size) > max_bytes_)))
+  {
+    auto it = results_.find(recent_.back());
+
+    bytes_ -= it->first.size() + it->second.result.size();
+    results_.erase(it);
+    recent_.pop_back();
+
+    ++counters_.evictions;
+  }
+
+  recent_.push_front(key);
+  results_.emplace(key, Element{result, recent_.begin()});
+  bytes_ += size;
+
+  return true;
+}
+
+/**
+ * Get the state root the cached results were computed from
+ *
+ * @return The state root, empty while the state is being modified
+ */
+QueryResultCache::ConstByteArray QueryResultCache::state() const
+{
+  FETCH_LOCK(lock_);
+  return state_;
+}
+
+/**
+ * Get the number of cached results
+ *
+ * @return The number of results
+ */
+std::size_t QueryResultCache::size() const
+{
+  FETCH_LOCK(lock_);
+  return results_.size();
+}
+
+/**
+ * Get the total size of the cached results and their keys
+ *
+ * @return The size in bytes
+ */
+std::size_t QueryResultCache::bytes() const
+{
+  FETCH_LOCK(lock_);
+  return bytes_;
+}
+
+/**
+ * Get the counters of the cache
+ *
+ * @return A copy of the counters
+ */
+QueryResultCache::Counters QueryResultCache::counters() const
+{
+  FETCH_LOCK(lock_);
+  return counters_;
+}
+
+/**
+ * Internal: Build the key of a query. Each part is prefixed with its length so that the keys of
+ * different queries never collide.
+ *
+ * @param contract The name of the contract
+ * @param query The name of the query
+ * @param args The (serialised) arguments of the query
+ * @return The key
+ */
+QueryResultCache::ConstByteArray QueryResultCache::Key(ConstByteArray const &contract,
+                                                       ConstByteArray const &query,
+                                                       ConstByteArray const &args)
+{
+  byte_array::ByteArray key;
+  key.Append(std::to_string(contract.size()), ':', contract, std::to_string(query.size()), ':',
+             query, args);
+
+  return {key};
+}
+
+/**
+ * Internal: Drop all the cached results. The lock must be held.
+ */
+void QueryResultCache::ClearLocked()
+{
+  if (!results_.empty())
+  {
+    ++counters_.invalidations;
+  }
+
+  results_.clear();
+  recent_.clear();
+  bytes_ = 0;
+  ++generation_;
+}
+
+}  // namespace ledger
+}  // namespace fetch
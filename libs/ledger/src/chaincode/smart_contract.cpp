@@ -22,6 +22,7 @@
 #include "crypto/fnv.hpp"
 #include "crypto/hash.hpp"
 #include "crypto/sha256.hpp"
+#include "ledger/chaincode/contract_compiler.hpp"
 #include "ledger/chaincode/smart_contract_exception.hpp"
 #include "ledger/chaincode/vm_definition.hpp"
 #include "ledger/state_adapter.hpp"
@@ -97,7 +98,6 @@ void ValidateAddressesInParams(Transaction const &tx, vm::ParameterPack const &p
 SmartContract::SmartContract(std::string const &source)
   : source_{source}
   , digest_{GenerateDigest(source)}
-  , script_{std::make_shared<Script>()}
   , module_{vm_modules::VMFactory::GetModule()}
 {
   if (source_.empty())
@@ -108,14 +108,9 @@ SmartContract::SmartContract(std::string const &source)
 
   FETCH_LOG_INFO(LOGGING_NAME, "Constructing contract: ", contract_digest().ToBase64());
 
-  // create and compile the script
-  auto errors = vm_modules::VMFactory::Compile(module_, source_, *script_);
-
-  // if there are any compilation errors
-  if (!errors.empty())
-  {
-    throw SmartContractException(SmartContractException::Category::COMPILATION, std::move(errors));
-  }
+  // the compiled script is shared between all the instances of this contract, and might already
+  // be being compiled in the background
+  script_ = ContractCompiler::Instance().Compile(source_, digest_, module_);
 
   // since we now have a fully compiled script we can evaluate the functions and assign the mapping
 
@@ -368,8 +363,14 @@ Contract::Status SmartContract::InvokeAction(std::string const &name, Transactio
   }
 
   // Get clean VM instance
-  auto vm = vm_modules::VMFactory::GetVM(module_);
+  auto vm = vm_modules::VMFactory::AcquireVM(module_);
   vm->SetIOObserver(state());
+  vm->SetChargeLimit(CHARGE_LIMIT);
+
+  if (profiler() != nullptr)
+  {
+    vm->SetProfiler(profiler());
+  }
 
   // lookup the function / entry point which will be executed
   Script::Function const *target_function = script_->FindFunction(name);
@@ -427,8 +428,9 @@ Contract::Status SmartContract::InvokeAction(std::string const &name, Transactio
 Contract::Status SmartContract::InvokeInit(Identity const &owner)
 {
   // Get clean VM instance
-  auto vm = vm_modules::VMFactory::GetVM(module_);
+  auto vm = vm_modules::VMFactory::AcquireVM(module_);
   vm->SetIOObserver(state());
+  vm->SetChargeLimit(CHARGE_LIMIT);
 
   FETCH_LOG_DEBUG(LOGGING_NAME, "Running SC init function: ", init_fn_name_);
 
@@ -488,8 +490,9 @@ SmartContract::Status SmartContract::InvokeQuery(std::string const &name, Query
                                                  Query &response)
 {
   // get clean VM instance
-  auto vm = vm_modules::VMFactory::GetVM(module_);
+  auto vm = vm_modules::VMFactory::AcquireVM(module_);
   vm->SetIOObserver(state());
+  vm->SetChargeLimit(CHARGE_LIMIT);
 
   // lookup the script
   Script::Function const *target_function = script_->FindFunction(name);
@@ -51,14 +51,23 @@ SmartContractManager::SmartContractManager()
   OnTransaction("create", this, &SmartContractManager::OnCreate);
 }
 
-Contract::Status SmartContractManager::OnCreate(Transaction const &tx)
+/**
+ * Extract and validate the source of the contract which is deployed by a create transaction
+ *
+ * @param tx The create transaction
+ * @param source The decoded contract source to be populated
+ * @param digest The (base64 encoded) digest of the source to be populated
+ * @return true if successful, otherwise false
+ */
+bool SmartContractManager::ExtractSource(Transaction const &tx, ConstByteArray &source,
+                                         ConstByteArray &digest)
 {
   // attempt to parse the transaction
   variant::Variant data;
   if (!ParseAsJson(tx, data))
   {
     FETCH_LOG_WARN(LOGGING_NAME, "FAILED TO PARSE TRANSACTION");
-    return Status::FAILED;
+    return false;
   }
 
   ConstByteArray contract_source;
@@ -72,7 +81,7 @@ Contract::Status SmartContractManager::OnCreate(Transaction const &tx)
   if (!extract_success)
   {
     FETCH_LOG_WARN(LOGGING_NAME, "Failed to parse contract source from transaction body");
-    return Status::FAILED;
+    return false;
   }
 
   // decode the contents of the contract
@@ -87,6 +96,20 @@ Contract::Status SmartContractManager::OnCreate(Transaction const &tx)
                    "Warning! Failed to match calculated hash with provided hash: ", calculated_hash,
                    " to ", contract_hash);
 
+    return false;
+  }
+
+  source = contract_source;
+  digest = calculated_hash;
+  return true;
+}
+
+Contract::Status SmartContractManager::OnCreate(Transaction const &tx)
+{
+  ConstByteArray contract_source;
+  ConstByteArray calculated_hash;
+  if (!ExtractSource(tx, contract_source, calculated_hash))
+  {
     return Status::FAILED;
   }
 
@@ -18,9 +18,11 @@
 
 #include "ledger/chaincode/token_contract.hpp"
 #include "core/byte_array/decoders.hpp"
+#include "core/serializers/byte_array_buffer.hpp"
 #include "crypto/fnv.hpp"
 #include "ledger/chaincode/deed.hpp"
 #include "ledger/chaincode/wallet_record.hpp"
+#include "ledger/state_adapter.hpp"
 #include "variant/variant.hpp"
 #include "variant/variant_utils.hpp"
 
@@ -28,9 +30,55 @@
 #include <memory>
 #include <set>
 #include <stdexcept>
+#include <string>
 
 namespace fetch {
 namespace ledger {
+namespace {
+
+/**
+ * Read the header of a serialized wallet record from the state
+ *
+ * @param state The state from which the record is read
+ * @param address The address of the wallet
+ * @param record The output serialized record, empty if it does not exist
+ * @param header The output header of the record, default if it does not exist
+ * @return true if the record exists, otherwise false
+ */
+bool ReadWalletRecord(StateAdapter &state, ConstByteArray const &address, ConstByteArray &record,
+                      WalletRecordHeader &header)
+{
+  header = WalletRecordHeader{};
+
+  if (vm::IoObserverInterface::Status::OK != state.ReadView(std::string{address}, record))
+  {
+    record = ConstByteArray{};
+    return false;
+  }
+
+  if (!header.Read(record))
+  {
+    throw std::runtime_error("Malformed wallet record");
+  }
+
+  return true;
+}
+
+/**
+ * Write a serialized wallet record back to the state with its balance updated in place
+ *
+ * @param state The state to which the record is written
+ * @param address The address of the wallet
+ * @param record The current serialized record, empty if it does not exist
+ * @param header The updated header of the record
+ */
+void WriteWalletRecord(StateAdapter &state, ConstByteArray const &address,
+                       ConstByteArray const &record, WalletRecordHeader const &header)
+{
+  state.WriteView(std::string{address}, header.Write(record));
+}
+
+}  // namespace
 
 TokenContract::TokenContract()
 {
@@ -57,13 +105,14 @@ Contract::Status TokenContract::CreateWealth(Transaction const &tx)
     address = FromBase64(address);  //  the address needs to be converted
 
     // retrieve the record (if it exists)
-    WalletRecord record{};
-    GetStateRecord(record, address);
+    ConstByteArray     record;
+    WalletRecordHeader header{};
+    ReadWalletRecord(state(), address, record, header);
 
-    // update the balance
-    record.balance += amount;
+    // update the balance in place, any deed is left untouched
+    header.balance += amount;
 
-    SetStateRecord(record, address);
+    WriteWalletRecord(state(), address, record, header);
   }
   else
   {
@@ -162,26 +211,27 @@ Contract::Status TokenContract::Transfer(Transaction const &tx)
   to_address   = byte_array::FromBase64(to_address);    //  the address needs to be converted
   from_address = byte_array::FromBase64(from_address);  //  the address needs to be converted
 
-  WalletRecord to_record{};
-  WalletRecord from_record{};
-
-  if (!GetStateRecord(from_record, from_address))
+  // only the headers of the records are needed, unless a deed is in effect
+  ConstByteArray     from_record;
+  WalletRecordHeader from_header{};
+  if (!ReadWalletRecord(state(), from_address, from_record, from_header))
   {
     return Status::FAILED;
   }
 
   // check the balance here to limit further reads if required
-  if (from_record.balance < amount)
+  if (from_header.balance < amount)
   {
     return Status::FAILED;
   }
 
-  if (from_record.deed)
+  if (from_header.has_deed)
   {
     // There is current deed in effect.
+    auto const deed = LookupDeed(from_address, from_record);
 
     // Verify that current transaction possesses authority to perform the transfer
-    if (!from_record.deed->Verify(tx, TRANSFER_NAME))
+    if (!deed || !deed->Verify(tx, TRANSFER_NAME))
     {
       return Status::FAILED;
     }
@@ -199,15 +249,17 @@ Contract::Status TokenContract::Transfer(Transaction const &tx)
   }
 
   // get the state record for the target address
-  GetStateRecord(to_record, to_address);
+  ConstByteArray     to_record;
+  WalletRecordHeader to_header{};
+  ReadWalletRecord(state(), to_address, to_record, to_header);
 
-  // update the records
-  from_record.balance -= amount;
-  to_record.balance += amount;
+  // update the balances in place
+  from_header.balance -= amount;
+  to_header.balance += amount;
 
   // write the records back to the state database
-  SetStateRecord(from_record, from_address);
-  SetStateRecord(to_record, to_address);
+  WriteWalletRecord(state(), from_address, from_record, from_header);
+  WriteWalletRecord(state(), to_address, to_record, to_header);
 
   return Status::OK;
 }
@@ -221,13 +273,14 @@ Contract::Status TokenContract::Balance(Query const &query, Query &response)
   {
     address = FromBase64(address);
 
-    // lookup the record
-    WalletRecord record{};
-    GetStateRecord(record, address);
+    // lookup the record, only the balance is required
+    ConstByteArray     record;
+    WalletRecordHeader header{};
+    ReadWalletRecord(state(), address, record, header);
 
     // formulate the response
     response            = Variant::Object();
-    response["balance"] = record.balance;
+    response["balance"] = header.balance;
 
     status = Status::OK;
   }
@@ -239,5 +292,44 @@ Contract::Status TokenContract::Balance(Query const &query, Query &response)
   return status;
 }
 
+/**
+ * Get the decoded deed of a wallet record. Decoding a deed is expensive, so the deeds of the
+ * recently used wallets are cached. A cached deed is only used while the serialized deed in the
+ * record is unchanged, therefore amending (or removing) the deed invalidates it.
+ *
+ * @param address The address of the wallet
+ * @param record The serialized wallet record, which must have a deed
+ * @return The deed of the wallet
+ */
+TokenContract::DeedPtr TokenContract::LookupDeed(ConstByteArray const &address,
+                                                 ConstByteArray const &record)
+{
+  auto const encoded = record.SubArray(WalletRecordHeader::SIZE);
+
+  FETCH_LOCK(deed_cache_lock_);
+
+  auto it = deed_cache_.find(address);
+  if ((it != deed_cache_.end()) && (it->second.encoded == encoded))
+  {
+    return it->second.deed;
+  }
+
+  auto deed = std::make_shared<ledger::Deed>();
+
+  serializers::ByteArrayBuffer buffer{encoded};
+  buffer >> *deed;
+
+  // keep the cache bounded, the deeds of the active wallets are quickly decoded again
+  if ((it == deed_cache_.end()) && (deed_cache_.size() >= MAX_CACHED_DEEDS))
+  {
+    deed_cache_.clear();
+  }
+
+  // the record holds a view of the state, the cache keeps its own copy
+  deed_cache_[address.Copy()] = CachedDeed{encoded.Copy(), deed};
+
+  return deed;
+}
+
 }  // namespace ledger
 }  // namespace fetch
@@ -93,12 +93,18 @@ http::HTTPResponse WalletHttpInterface::OnRegister(http::HTTPRequest const &requ
 
   try
   {
-    json::JSONDocument doc = request.JSON();
+    // only the count is needed, avoid building the whole tree
+    json::JSONDocument doc;
+    doc.ParseLazy(request.body());
 
-    auto const &count_v = doc["count"];
-    if (count_v.Is<uint64_t>())
+    auto const root = doc.lazy_root();
+    if (root.IsObject() && root.Has("count"))
     {
-      count = count_v.As<uint64_t>();
+      auto const count_v = root["count"].ToVariant();
+      if (count_v.Is<uint64_t>())
+      {
+        count = count_v.As<uint64_t>();
+      }
     }
   }
   catch (json::JSONParseException const &ex)
@@ -115,6 +121,8 @@ http::HTTPResponse WalletHttpInterface::OnRegister(http::HTTPRequest const &requ
 
   std::vector<crypto::ECDSASigner>          signers(count);
   std::vector<std::tuple<std::string, int>> return_info;
+  TransactionProcessor::MutableTxList       batch;
+  batch.reserve(count);
 
   std::random_device rd;
   std::mt19937       rng(rd());
@@ -150,16 +158,18 @@ http::HTTPResponse WalletHttpInterface::OnRegister(http::HTTPRequest const &requ
           std::make_tuple(std::string(byte_array::ToBase64(signer.public_key())), lane);
       return_info.push_back(tmp);
 
-      FETCH_LOG_DEBUG(LOGGING_NAME, "Submitting register transaction");
-
-      // dispatch the transaction
-      processor_.AddTransaction(std::move(mtx));
+      batch.emplace_back(std::move(mtx));
     }
 
     storage::ResourceID set_id = storage::ResourceAddress{address};
     key_store_.Set(set_id, signer.private_key());
   }
 
+  FETCH_LOG_DEBUG(LOGGING_NAME, "Submitting ", batch.size(), " register transactions");
+
+  // dispatch the transactions
+  processor_.AddTransactions(std::move(batch));
+
   variant::Variant   data;
   std::ostringstream oss;
 
@@ -225,6 +235,12 @@ http::HTTPResponse WalletHttpInterface::OnBalance(http::HTTPRequest const &reque
   return BadJsonResponse(ErrorCode::PARSE_FAILURE);
 }
 
+/**
+ * Submit one transfer, or an array of transfers, signed with the keys in the key store
+ *
+ * @param request The http request, containing the transfer object(s)
+ * @return The status of the submission wrapped as a HTTP response
+ */
 http::HTTPResponse WalletHttpInterface::OnTransfer(http::HTTPRequest const &request)
 {
   try
@@ -233,52 +249,38 @@ http::HTTPResponse WalletHttpInterface::OnTransfer(http::HTTPRequest const &requ
     json::JSONDocument doc;
     doc.Parse(request.body());
 
-    byte_array::ConstByteArray from;
-    byte_array::ConstByteArray to;
-    uint64_t                   amount = 0;
+    auto const &      root     = doc.root();
+    bool const        is_array = root.IsArray();
+    std::size_t const count    = is_array ? root.size() : 1;
 
-    // extract all the request parameters
-    if (variant::Extract(doc.root(), "from", from) && variant::Extract(doc.root(), "to", to) &&
-        variant::Extract(doc.root(), "amount", amount))
+    // the transfers are only submitted once they are all valid
+    TransactionProcessor::MutableTxList batch(count);
+    for (std::size_t i = 0; i < count; ++i)
     {
-
-      variant::Variant data = variant::Variant::Object();
-      data["from"]          = from;
-      data["to"]            = to;
-      data["amount"]        = amount;
-
-      // convert the data into json
-      std::ostringstream oss;
-      oss << data;
-
-      // build up the transfer transaction
-      ledger::MutableTransaction mtx;
-      mtx.set_contract_name("fetch.token.transfer");
-      mtx.set_data(oss.str());
-      mtx.PushResource(byte_array::FromBase64(from));
-      mtx.PushResource(byte_array::FromBase64(to));
-
-      storage::ResourceAddress get_id{byte_array::FromBase64(from)};
-
-      // query private key for signing
-      byte_array::ConstByteArray priv_key;
-      if (!key_store_.Get(get_id, priv_key))
+      switch (CreateTransfer(is_array ? root[i] : root, batch[i]))
       {
+      case TransferStatus::OK:
+        break;
+      case TransferStatus::INVALID_REQUEST:
+        return BadJsonResponse(ErrorCode::PARSE_FAILURE);
+      case TransferStatus::UNKNOWN_ADDRESS:
         return http::CreateJsonResponse(
             R"({"success": false, "error": "provided address/pub.key does not exist in key store"})",
             http::Status::CLIENT_ERROR_BAD_REQUEST);
       }
+    }
 
-      // sign the transaction
-      auto tx_sign_adapter{ledger::TxSigningAdapterFactory(mtx)};
-
-      mtx.Sign(priv_key, tx_sign_adapter);
-
-      // dispatch to the wider system
-      processor_.AddTransaction(std::move(mtx));
+    // dispatch to the wider system
+    processor_.AddTransactions(std::move(batch));
 
-      return http::CreateJsonResponse(R"({"success": true})", http::Status::SUCCESS_OK);
+    if (is_array)
+    {
+      return http::CreateJsonResponse(
+          R"({"success": true, "submitted": )" + std::to_string(count) + "}",
+          http::Status::SUCCESS_OK);
     }
+
+    return http::CreateJsonResponse(R"({"success": true})", http::Status::SUCCESS_OK);
   }
   catch (json::JSONParseException const &ex)
   {
@@ -288,6 +290,59 @@ http::HTTPResponse WalletHttpInterface::OnTransfer(http::HTTPRequest const &requ
   return BadJsonResponse(ErrorCode::PARSE_FAILURE);
 }
 
+/**
+ * Build and sign a transfer transaction
+ *
+ * @param transfer The transfer object, with the from, to and amount fields
+ * @param mtx The transaction to be populated
+ * @return The status of the transfer
+ */
+WalletHttpInterface::TransferStatus WalletHttpInterface::CreateTransfer(
+    variant::Variant const &transfer, MutableTransaction &mtx)
+{
+  byte_array::ConstByteArray from;
+  byte_array::ConstByteArray to;
+  uint64_t                   amount = 0;
+
+  // extract all the request parameters
+  if (!(variant::Extract(transfer, "from", from) && variant::Extract(transfer, "to", to) &&
+        variant::Extract(transfer, "amount", amount)))
+  {
+    return TransferStatus::INVALID_REQUEST;
+  }
+
+  variant::Variant data = variant::Variant::Object();
+  data["from"]          = from;
+  data["to"]            = to;
+  data["amount"]        = amount;
+
+  // convert the data into json
+  std::ostringstream oss;
+  oss << data;
+
+  // build up the transfer transaction
+  mtx.set_contract_name("fetch.token.transfer");
+  mtx.set_data(oss.str());
+  mtx.PushResource(byte_array::FromBase64(from));
+  mtx.PushResource(byte_array::FromBase64(to));
+
+  storage::ResourceAddress get_id{byte_array::FromBase64(from)};
+
+  // query private key for signing
+  byte_array::ConstByteArray priv_key;
+  if (!key_store_.Get(get_id, priv_key))
+  {
+    return TransferStatus::UNKNOWN_ADDRESS;
+  }
+
+  // sign the transaction
+  auto tx_sign_adapter{ledger::TxSigningAdapterFactory(mtx)};
+
+  mtx.Sign(priv_key, tx_sign_adapter);
+
+  return TransferStatus::OK;
+}
+
 http::HTTPResponse WalletHttpInterface::OnTransactions(http::HTTPRequest const & /*request*/)
 {
   return BadJsonResponse(ErrorCode::NOT_IMPLEMENTED);
@@ -0,0 +1,65 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/conflict_scheduler.hpp"
+
+#include <algorithm>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * Schedule the next transaction of the block
+ *
+ * @param resources The resources accessed by the transaction
+ * @return The index of the slice in which the transaction should be executed
+ */
+std::size_t ConflictScheduler::Schedule(ResourceAddresses const &resources)
+{
+  // the transaction must follow every preceding transaction which accesses any of its resources
+  std::size_t slice{0};
+  for (auto const &resource : resources)
+  {
+    auto it = last_access_.find(resource.as_resource_id());
+    if (it != last_access_.end())
+    {
+      slice = std::max(slice, it->second + 1);
+    }
+  }
+
+  for (auto const &resource : resources)
+  {
+    last_access_[resource.as_resource_id()] = slice;
+  }
+
+  num_slices_ = std::max(num_slices_, slice + 1);
+
+  return slice;
+}
+
+/**
+ * Reset the scheduler ready for the next block
+ */
+void ConflictScheduler::Reset()
+{
+  last_access_.clear();
+  num_slices_ = 0;
+}
+
+}  // namespace ledger
+}  // namespace fetch
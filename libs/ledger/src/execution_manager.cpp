@@ -21,7 +21,11 @@
 #include "core/logger.hpp"
 #include "core/mutex.hpp"
 #include "core/threading.hpp"
+#include "ledger/chaincode/contract_compiler.hpp"
+#include "ledger/chaincode/smart_contract_manager.hpp"
+#include "ledger/conflict_scheduler.hpp"
 #include "ledger/executor.hpp"
+#include "metrics/tracer.hpp"
 #include "storage/resource_mapper.hpp"
 
 #include "ledger/state_adapter.hpp"
@@ -29,6 +33,7 @@
 #include "core/byte_array/decoders.hpp"
 #include "core/byte_array/encoders.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <thread>
@@ -39,6 +44,7 @@
 static constexpr char const *LOGGING_NAME              = "ExecutionManager";
 static constexpr std::size_t MAX_STARTUP_ITERATIONS    = 20;
 static constexpr std::size_t STARTUP_ITERATION_TIME_MS = 100;
+static constexpr std::size_t SLICE_WAIT_TIMEOUT_MS     = 2000;
 
 namespace {
 
@@ -66,28 +72,40 @@ namespace ledger {
  * Constructs a execution manager instance
  *
  * @param num_executors The specified number of executors (and threads)
+ * @param storage The storage unit to be used
+ * @param factory The factory used to create the executors
+ * @param mode The slice scheduling mode
  */
-// std::make_shared<fetch::network::ThreadPool>(num_executors)
 ExecutionManager::ExecutionManager(std::size_t num_executors, StorageUnitPtr storage,
-                                   ExecutorFactory const &factory)
-  : storage_(std::move(storage))
-  , idle_executors_(num_executors)
-  , thread_pool_(network::MakeThreadPool(num_executors, "Executor"))
-{
-  // setup the executor pool
-  {
-    FETCH_LOCK(idle_executors_lock_);
+                                   ExecutorFactory const &factory, Mode mode)
+  : mode_(mode)
+  , storage_(std::move(storage))
+  , executor_pool_(std::make_unique<ExecutorPool>(
+        num_executors, factory,
+        [this](ExecutionItem &item, ExecutorInterface &executor) {
+          DispatchExecution(item, executor);
+        },
+        "Executor"))
+{}
 
-    // ensure lists are reserved
-    idle_executors_.reserve(num_executors);
-
-    // create the executor instances
-    for (std::size_t i = 0; i < num_executors; ++i)
-    {
-      idle_executors_.emplace_back(factory());
-    }
-  }
-}
+/**
+ * Constructs a execution manager instance which schedules the execution across a set of remote
+ * executors
+ *
+ * Since the remote executors read the state themselves, state prefetching is disabled.
+ *
+ * @param remotes The remote executors and the lanes each of them is close to
+ * @param storage The storage unit to be used
+ * @param mode The slice scheduling mode
+ */
+ExecutionManager::ExecutionManager(RemoteExecutors remotes, StorageUnitPtr storage, Mode mode)
+  : mode_(mode)
+  , storage_(std::move(storage))
+  , prefetch_enabled_{false}
+  , executor_farm_(std::make_unique<ExecutorFarm>(
+        std::move(remotes), [this](ExecutionItem &item) { CompleteExecution(item); },
+        "RemoteExec"))
+{}
 
 /**
  * Initiates the execution of a given block across the set of executors
@@ -120,7 +138,6 @@ ExecutionManager::ScheduleStatus ExecutionManager::Execute(Block::Body const &bl
 
   // update the last block hash
   last_block_hash_ = block.hash;
-  num_slices_      = block.slices.size();
 
   // update the state otherwise there is a race between when the executor thread wakes up
   state_.Set(State::ACTIVE);
@@ -143,12 +160,24 @@ ExecutionManager::ScheduleStatus ExecutionManager::Execute(Block::Body const &bl
  */
 bool ExecutionManager::PlanExecution(Block::Body const &block)
 {
+  // the lanes of each item are tracked in a fixed width bitmap
+  if (block.log2_num_lanes > LaneBitmap::MAX_LOG2_LANES)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to plan block with 2^", block.log2_num_lanes, " lanes");
+    return false;
+  }
+
+  // a prefetch from a previous block might still be referencing the plan
+  WaitForPrefetch();
+
   FETCH_LOCK(execution_plan_lock_);
 
   // clear and resize the execution plan
   execution_plan_.clear();
   execution_plan_.resize(block.slices.size());
 
+  TxDigests deployments{};
+
   std::size_t slice_index = 0;
   for (auto const &slice : block.slices)
   {
@@ -163,6 +192,12 @@ bool ExecutionManager::PlanExecution(Block::Body const &block)
         return false;
       }
 
+      // contracts which are deployed by this block are compiled ahead of their execution
+      if (precompile_enabled_ && IsContractDeployment(contract_id))
+      {
+        deployments.push_back(tx.transaction_hash);
+      }
+
       auto item = std::make_unique<ExecutionItem>(tx.transaction_hash, slice_index);
 
       // transform the resources into lane allocation
@@ -170,11 +205,15 @@ bool ExecutionManager::PlanExecution(Block::Body const &block)
       {
         item->AddLane(
             StateAdapter::CreateAddress(contract_id, resource).lane(block.log2_num_lanes));
+
+        // the state addresses as they will be accessed by the executor
+        item->AddResource(StateAdapter::CreateAddress(contract_id.GetParent(), resource));
       }
 
       for (auto const &contract_hash : tx.raw_resources)
       {
         item->AddLane(StateAdapter::CreateAddress(contract_hash).lane(block.log2_num_lanes));
+        item->AddResource(StateAdapter::CreateAddress(contract_hash));
       }
 
       // insert the item into the execution plan
@@ -184,64 +223,112 @@ bool ExecutionManager::PlanExecution(Block::Body const &block)
     ++slice_index;
   }
 
+  // replace the slicing of the miner with one derived from the resources of the transactions
+  if (conflict_scheduling_enabled_)
+  {
+    RescheduleExecution();
+  }
+
+  num_slices_ = execution_plan_.size();
+
+  PrecompileContracts(deployments);
+
   return true;
 }
 
 /**
- * Dispatches an execution item to the next available executor
+ * Rebuild the execution plan from the conflicts between the resources of the transactions, so
+ * that the available executors are used even when the block has been poorly sliced by the miner.
  *
- * This function should be called from a context of a thread pool
- *
- * @param item The execution item to dispatch
+ * Must be called with the `execution_plan_lock_` held
  */
-void ExecutionManager::DispatchExecution(ExecutionItem &item)
+void ExecutionManager::RescheduleExecution()
 {
-  ExecutorPtr executor;
+  ConflictScheduler scheduler{};
+  ExecutionPlan     plan{};
 
-  // lookup a free executor
+  // the items are visited in block order
+  for (auto &slice_plan : execution_plan_)
   {
-    FETCH_LOCK(idle_executors_lock_);
-    if (!idle_executors_.empty())
+    for (auto &item : slice_plan)
     {
-      executor = idle_executors_.back();
-      idle_executors_.pop_back();
+      std::size_t const slice = scheduler.Schedule(item->resources());
+      if (slice >= plan.size())
+      {
+        plan.resize(slice + 1);
+      }
+
+      item->SetSlice(slice);
+      plan[slice].emplace_back(std::move(item));
     }
   }
 
-  // We must have a executor present for this to work. This should always
-  // be the case provided num_executors == num_threads (in thread pool)
-  assert(executor);
+  FETCH_LOG_DEBUG(LOGGING_NAME, "Rescheduled ", execution_plan_.size(), " slices into ",
+                  plan.size());
+
+  execution_plan_ = std::move(plan);
+}
+
+/**
+ * Executes an item on the executor which is dedicated to the calling worker
+ *
+ * This function should be called from a context of the executor pool
+ *
+ * @param item The execution item to dispatch
+ * @param executor The executor owned by the current worker
+ */
+void ExecutionManager::DispatchExecution(ExecutionItem &item, ExecutorInterface &executor)
+{
+  // increment the active counters
+  counters_.Apply([](Counters &counters) { counters.active++; });
 
-  if (executor)
+  // execute the item
   {
-    // increment the active counters
-    counters_.Apply([](Counters &counters) { counters.active++; });
+    auto span = metrics::Tracer::Instance().StartTransactionSpan("tx.execute", item.hash());
+    item.Execute(executor);
+  }
 
-    // execute the item
-    item.Execute(*executor);
+  counters_.Apply([](Counters &counters) { counters.active--; });
 
-    // determine what the status is
-    if (ExecutorInterface::Status::SUCCESS != item.status())
-    {
-      FETCH_LOG_WARN(LOGGING_NAME, "Error executing tx: ", item.hash().ToBase64(),
-                     " slice: ", item.slice(), " status: ", ledger::ToString(item.status()));
-    }
+  CompleteExecution(item);
+}
 
-    counters_.Apply([](Counters &counters) {
-      counters.active--;
-      counters.remaining--;
-    });
+/**
+ * Record the completion of an item, executed either locally or remotely
+ *
+ * @param item The completed item
+ */
+void ExecutionManager::CompleteExecution(ExecutionItem &item)
+{
+  // determine what the status is
+  if (ExecutorInterface::Status::SUCCESS != item.status())
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Error executing tx: ", item.hash().ToBase64(),
+                   " slice: ", item.slice(), " status: ", ledger::ToString(item.status()));
+  }
 
-    ++completed_executions_;
+  counters_.Apply([](Counters &counters) {
+    counters.remaining--;
+    counters.completed++;
+  });
 
-    {
-      FETCH_LOCK(idle_executors_lock_);
-      idle_executors_.push_back(std::move(executor));
-    }
+  ++completed_executions_;
+}
+
+/**
+ * Hand an item to the executors
+ *
+ * @param item The item to be executed
+ */
+void ExecutionManager::Post(ExecutionItem &item)
+{
+  if (executor_farm_)
+  {
+    executor_farm_->Post(item);
   }
   else
   {
-    FETCH_LOG_ERROR(LOGGING_NAME, "Failed to secure an idle executor");
+    executor_pool_->Post(item);
   }
 }
 
@@ -271,8 +358,15 @@ void ExecutionManager::Start()
     throw std::runtime_error("Failed waiting for the monitor to start");
   }
 
-  // fire up the main worker thread pool
-  thread_pool_->Start();
+  // fire up the executor workers
+  if (executor_farm_)
+  {
+    executor_farm_->Start();
+  }
+  else
+  {
+    executor_pool_->Start();
+  }
 }
 
 /**
@@ -294,8 +388,17 @@ void ExecutionManager::Stop()
   monitor_thread_->join();
   monitor_thread_.reset();
 
-  // tear down the thread pool
-  thread_pool_->Stop();
+  WaitForPrefetch();
+
+  // tear down the executor workers
+  if (executor_farm_)
+  {
+    executor_farm_->Stop();
+  }
+  else
+  {
+    executor_pool_->Stop();
+  }
 }
 
 void ExecutionManager::SetLastProcessedBlock(BlockHash hash)
@@ -340,6 +443,9 @@ void ExecutionManager::MonitorThreadEntrypoint()
 
   std::size_t current_slice = 0;
 
+  // the set of items in the next slice which have already been dispatched (optimistic mode only)
+  DispatchFlags lookahead{};
+
   BlockHash current_block;
 
   while (running_)
@@ -352,6 +458,7 @@ void ExecutionManager::MonitorThreadEntrypoint()
       FETCH_LOG_WARN(LOGGING_NAME, "Execution Engine experience fatal error");
 
       state_.Set(State::EXECUTION_FAILED);
+      SignalFinished();
       monitor_state = MonitorState::IDLE;
       break;
 
@@ -359,6 +466,7 @@ void ExecutionManager::MonitorThreadEntrypoint()
       FETCH_LOG_DEBUG(LOGGING_NAME, "Now Stalled");
 
       state_.Set(State::TRANSACTIONS_UNAVAILABLE);
+      SignalFinished();
       monitor_state = MonitorState::IDLE;
       break;
 
@@ -366,6 +474,7 @@ void ExecutionManager::MonitorThreadEntrypoint()
       FETCH_LOG_DEBUG(LOGGING_NAME, "Now Complete");
 
       state_.Set(State::IDLE);
+      SignalFinished();
       monitor_state = MonitorState::IDLE;
       break;
 
@@ -391,6 +500,7 @@ void ExecutionManager::MonitorThreadEntrypoint()
       {
         monitor_state = MonitorState::SCHEDULE_NEXT_SLICE;
         current_slice = 0;
+        lookahead.clear();
       }
 
       break;
@@ -408,17 +518,32 @@ void ExecutionManager::MonitorThreadEntrypoint()
       {
         auto const &slice_plan = execution_plan_[current_slice];
 
+        // the state prefetched for this slice must be in place before any of its items start
+        WaitForPrefetch();
+
+        // any items that were started optimistically during the previous slice must not be
+        // dispatched a second time
+        DispatchFlags dispatched{};
+        std::swap(dispatched, lookahead);
+        dispatched.resize(slice_plan.size(), false);
+
         // determine the target number of executions being expected (must be
         // done before the thread pool dispatch)
-        counters_.Set(Counters{0, slice_plan.size()});
+        auto const num_pending =
+            static_cast<std::size_t>(std::count(dispatched.begin(), dispatched.end(), false));
+        counters_.Apply([num_pending](Counters &counters) { counters.remaining += num_pending; });
 
-        auto self = shared_from_this();
-        for (auto &item : slice_plan)
+        for (std::size_t i = 0; i < slice_plan.size(); ++i)
         {
-          // create the closure and dispatch to the thread pool
-          thread_pool_->Post([self, &item]() { self->DispatchExecution(*item); });
+          if (!dispatched[i])
+          {
+            Post(*slice_plan[i]);
+          }
         }
 
+        // overlap the storage reads for the next slice with the execution of this one
+        StartPrefetch(current_slice);
+
         monitor_state = MonitorState::RUNNING;
       }
 
@@ -429,8 +554,10 @@ void ExecutionManager::MonitorThreadEntrypoint()
     {
       // wait for the execution to complete
       bool const finished =
-          counters_.WaitFor(std::chrono::seconds{2},
-                            [](Counters const &counters) { return counters.remaining == 0; });
+          (Mode::OPTIMISTIC == mode_)
+              ? WaitForSliceOptimistically(current_slice, lookahead)
+              : counters_.WaitFor(std::chrono::milliseconds{SLICE_WAIT_TIMEOUT_MS},
+                                  [](Counters const &counters) { return counters.remaining == 0; });
 
       if (!finished)
       {
@@ -506,6 +633,13 @@ void ExecutionManager::MonitorThreadEntrypoint()
         {
           monitor_state = MonitorState::BOOKMARKING_STATE;
         }
+
+        // items from the next slice might still be in flight if it has been started early. These
+        // must all complete before the execution plan can be released.
+        if ((Mode::OPTIMISTIC == mode_) && (MonitorState::SCHEDULE_NEXT_SLICE != monitor_state))
+        {
+          counters_.WaitFor([](Counters const &counters) { return counters.remaining == 0; });
+        }
       }
 
       break;
@@ -513,11 +647,295 @@ void ExecutionManager::MonitorThreadEntrypoint()
 
     case MonitorState::BOOKMARKING_STATE:
       // finished processing the block
+      WaitForPrefetch();
       monitor_state = MonitorState::IDLE;
       break;
     }
   }
 }
 
+/**
+ * Notify any interested party that the execution of a block has finished
+ */
+void ExecutionManager::SignalFinished()
+{
+  if (finish_callback_)
+  {
+    finish_callback_();
+  }
+}
+
+/**
+ * Wait for the specified slice to complete, dispatching items from the next slice as soon as the
+ * lanes they require are no longer in use by the current slice.
+ *
+ * Since an item is only started early when none of the outstanding items of the current slice
+ * touch its lanes, the resulting state is identical to the one produced by serial execution.
+ *
+ * @param slice The index of the current slice
+ * @param lookahead The flags signalling which items in the next slice have been dispatched
+ * @return true if the slice completed, otherwise false if timed out
+ */
+bool ExecutionManager::WaitForSliceOptimistically(std::size_t slice, DispatchFlags &lookahead)
+{
+  using Clock = std::chrono::steady_clock;
+
+  auto const deadline = Clock::now() + std::chrono::milliseconds{SLICE_WAIT_TIMEOUT_MS};
+
+  for (;;)
+  {
+    // capture the completion count before examining the plan so that no completion can be missed
+    std::size_t const num_completed = counters_.Get().completed;
+
+    {
+      FETCH_LOCK(execution_plan_lock_);
+
+      if (IsSliceComplete(slice))
+      {
+        return true;
+      }
+
+      ScheduleLookahead(slice, lookahead);
+    }
+
+    auto const now = Clock::now();
+    if (now >= deadline)
+    {
+      return false;
+    }
+
+    // wait for the next item to complete
+    counters_.WaitFor(deadline - now, [num_completed](Counters const &counters) {
+      return counters.completed != num_completed;
+    });
+  }
+}
+
+/**
+ * Determine if all the items of a slice have finished executing
+ *
+ * Note: The caller must hold the `execution_plan_lock_`
+ *
+ * @param slice The index of the slice to check
+ * @return true if all items have completed, otherwise false
+ */
+bool ExecutionManager::IsSliceComplete(std::size_t slice) const
+{
+  auto const &slice_plan = execution_plan_[slice];
+
+  return std::all_of(slice_plan.begin(), slice_plan.end(),
+                     [](ExecutionItemPtr const &item) { return item->completed(); });
+}
+
+/**
+ * Dispatch all the items in the next slice whose lanes do not overlap with any outstanding item
+ * in the current slice.
+ *
+ * Note: The caller must hold the `execution_plan_lock_`
+ *
+ * @param slice The index of the current slice
+ * @param lookahead The flags signalling which items in the next slice have been dispatched
+ * @return The number of newly dispatched items
+ */
+std::size_t ExecutionManager::ScheduleLookahead(std::size_t slice, DispatchFlags &lookahead)
+{
+  std::size_t const next_slice = slice + 1;
+  if (next_slice >= execution_plan_.size())
+  {
+    return 0;
+  }
+
+  auto const &next_plan = execution_plan_[next_slice];
+  lookahead.resize(next_plan.size(), false);
+
+  // build up the set of lanes which are still in use by the current slice
+  LaneBitmap busy_lanes{};
+  for (auto const &item : execution_plan_[slice])
+  {
+    if (!item->completed())
+    {
+      busy_lanes |= item->lane_bitmap();
+    }
+  }
+
+  std::size_t num_dispatched{0};
+
+  for (std::size_t i = 0; i < next_plan.size(); ++i)
+  {
+    if (lookahead[i])
+    {
+      continue;
+    }
+
+    auto &item = next_plan[i];
+
+    bool const conflicts = busy_lanes.Overlaps(item->lane_bitmap());
+
+    if (!conflicts)
+    {
+      // must be updated before the dispatch
+      counters_.Apply([](Counters &counters) { counters.remaining++; });
+
+      Post(*item);
+
+      lookahead[i] = true;
+      ++num_dispatched;
+    }
+  }
+
+  return num_dispatched;
+}
+
+/**
+ * Start retrieving the state for the items of the next slice in the background
+ *
+ * Only the items whose lanes are not touched by any item of the current slice are considered. The
+ * values of their resources can not be modified until they are executed themselves, therefore the
+ * prefetched values are identical to the ones that would have been read on demand.
+ *
+ * Note: The caller must hold the `execution_plan_lock_`
+ *
+ * @param slice The index of the current slice
+ */
+void ExecutionManager::StartPrefetch(std::size_t slice)
+{
+  std::size_t const next_slice = slice + 1;
+  if (!prefetch_enabled_ || (next_slice >= execution_plan_.size()))
+  {
+    return;
+  }
+
+  // build up the set of lanes which can be modified by the current slice
+  LaneBitmap busy_lanes{};
+  for (auto const &item : execution_plan_[slice])
+  {
+    busy_lanes |= item->lane_bitmap();
+  }
+
+  PrefetchItems items{};
+  for (auto const &item : execution_plan_[next_slice])
+  {
+    bool const conflicts = busy_lanes.Overlaps(item->lane_bitmap());
+
+    if (!conflicts && !item->resources().empty())
+    {
+      items.push_back(item.get());
+    }
+  }
+
+  if (items.empty())
+  {
+    return;
+  }
+
+  FETCH_LOCK(prefetch_lock_);
+  prefetch_task_ = std::async(std::launch::async, [this, items]() { PrefetchState(items); });
+}
+
+/**
+ * Wait for any outstanding prefetch to complete
+ */
+void ExecutionManager::WaitForPrefetch()
+{
+  FETCH_LOCK(prefetch_lock_);
+
+  if (prefetch_task_.valid())
+  {
+    try
+    {
+      prefetch_task_.get();
+    }
+    catch (std::exception const &ex)
+    {
+      // the items will simply read their state on demand
+      FETCH_LOG_WARN(LOGGING_NAME, "Failed to prefetch state: ", ex.what());
+    }
+  }
+}
+
+/**
+ * Retrieve the declared resources for a set of execution items in a single batch and attach the
+ * values to each of the items
+ *
+ * @param items The items to prefetch the state for
+ */
+void ExecutionManager::PrefetchState(PrefetchItems const &items)
+{
+  StorageInterface::ResourceAddresses addresses{};
+  for (auto const *item : items)
+  {
+    addresses.insert(addresses.end(), item->resources().begin(), item->resources().end());
+  }
+
+  auto const documents = storage_->GetBulk(addresses);
+  if (documents.size() != addresses.size())
+  {
+    return;
+  }
+
+  // split the batch back up across the items
+  std::size_t index = 0;
+  for (auto *item : items)
+  {
+    ExecutionItem::PrefetchedState state{};
+    state.reserve(item->resources().size());
+
+    for (auto const &address : item->resources())
+    {
+      auto const &document = documents[index++];
+
+      // failed lookups are left to be retried by the executor
+      if (!document.failed)
+      {
+        state.emplace_back(address, document.document);
+      }
+    }
+
+    if (!state.empty())
+    {
+      prefetched_resources_ += state.size();
+      item->SetPrefetchedState(std::move(state));
+    }
+  }
+}
+
+/**
+ * Determine if a transaction deploys a new smart contract
+ *
+ * @param contract_id The contract and action targeted by the transaction
+ * @return true if the transaction creates a smart contract, otherwise false
+ */
+bool ExecutionManager::IsContractDeployment(Identifier const &contract_id)
+{
+  return (contract_id.name() == "create") &&
+         (contract_id.GetParent().full_name() == SmartContractManager::NAME);
+}
+
+/**
+ * Submit the contracts deployed by a set of transactions to the contract compiler, so that they
+ * are compiled in parallel rather than serially by the executors which deploy them. Any
+ * transactions which can not be read are simply compiled on demand.
+ *
+ * @param deployments The digests of the contract creation transactions
+ */
+void ExecutionManager::PrecompileContracts(TxDigests const &deployments)
+{
+  auto &compiler = ContractCompiler::Instance();
+
+  for (auto const &digest : deployments)
+  {
+    Transaction    tx;
+    ConstByteArray source;
+    ConstByteArray source_digest;
+
+    if (storage_->GetTransaction(digest, tx) &&
+        SmartContractManager::ExtractSource(tx, source, source_digest) &&
+        compiler.Submit(static_cast<std::string>(source)))
+    {
+      ++precompiled_contracts_;
+    }
+  }
+}
+
 }  // namespace ledger
 }  // namespace fetch
@@ -40,6 +40,34 @@ using fetch::metrics::Metrics;
 
 namespace fetch {
 namespace ledger {
+namespace {
+
+/**
+ * Build the state addresses of all the resources declared by a transaction
+ *
+ * @param scope The scope of the contract
+ * @param tx The transaction
+ * @return The list of resource addresses
+ */
+StorageInterface::ResourceAddresses DeclaredResources(Identifier const &scope, Transaction const &tx)
+{
+  StorageInterface::ResourceAddresses addresses;
+  addresses.reserve(tx.resources().size() + tx.raw_resources().size());
+
+  for (auto const &resource : tx.resources())
+  {
+    addresses.push_back(StateAdapter::CreateAddress(scope, resource));
+  }
+
+  for (auto const &resource : tx.raw_resources())
+  {
+    addresses.push_back(StateAdapter::CreateAddress(resource));
+  }
+
+  return addresses;
+}
+
+}  // namespace
 
 /**
  * Executes a given transaction across a series of lanes
@@ -50,15 +78,47 @@ namespace ledger {
  * @return The status code for the operation
  */
 Executor::Status Executor::Execute(TxDigest const &hash, std::size_t slice, LaneSet const &lanes)
+{
+  // TODO(issue 33): Add code to validate / check lane resources
+  FETCH_UNUSED(slice);
+  FETCH_UNUSED(lanes);
+
+  return ExecuteTransaction(hash, nullptr);
+}
+
+/**
+ * Executes a given transaction across a series of lanes, where some of the declared resources have
+ * already been retrieved from the storage engine
+ *
+ * @param hash The transaction hash
+ * @param slice The current block slice
+ * @param lanes The affected lanes for the transaction
+ * @param state The prefetched resource values
+ * @return The status code for the operation
+ */
+Executor::Status Executor::ExecuteWithState(TxDigest const &hash, std::size_t slice,
+                                            LaneSet const &lanes, PrefetchedState const &state)
+{
+  // TODO(issue 33): Add code to validate / check lane resources
+  FETCH_UNUSED(slice);
+  FETCH_UNUSED(lanes);
+
+  return ExecuteTransaction(hash, &state);
+}
+
+/**
+ * Executes a given transaction
+ *
+ * @param hash The transaction hash
+ * @param state The (optional) prefetched resource values
+ * @return The status code for the operation
+ */
+Executor::Status Executor::ExecuteTransaction(TxDigest const &hash, PrefetchedState const *state)
 {
   FETCH_LOG_DEBUG(LOGGING_NAME, "Executing tx ", byte_array::ToBase64(hash));
 
   try
   {
-    // TODO(issue 33): Add code to validate / check lane resources
-    FETCH_UNUSED(slice);
-    FETCH_UNUSED(lanes);
-
 #ifdef FETCH_ENABLE_METRICS
     Metrics::Timestamp const started = Metrics::Clock::now();
 #endif  // FETCH_ENABLE_METRICS
@@ -92,6 +152,15 @@ Executor::Status Executor::Execute(TxDigest const &hash, std::size_t slice, Lane
       StateSentinelAdapter storage_adapter{storage_cache, contract.GetParent(), tx.resources(),
                                            tx.raw_resources()};
 
+      // seed the cache with any values which were retrieved ahead of the execution
+      if (state)
+      {
+        storage_cache.Prefill(*state);
+      }
+
+      // now the resources are locked, fetch the remainder from the lanes in a single batch
+      storage_cache.Prefetch(DeclaredResources(contract.GetParent(), tx));
+
       // lookup or create the instance of the contract as is needed
       auto chain_code = chain_code_cache_.Lookup(contract.GetParent(), *resources_);
       if (!chain_code)
@@ -102,6 +171,7 @@ Executor::Status Executor::Execute(TxDigest const &hash, std::size_t slice, Lane
 
       // attach the chain code to the current working context
       chain_code->Attach(storage_adapter);
+      chain_code->SetProfiler(profiler_);
 
       // Dispatch the transaction to the contract
       FETCH_LOG_DEBUG(LOGGING_NAME, "Dispatch: ", contract.name());
@@ -109,10 +179,12 @@ Executor::Status Executor::Execute(TxDigest const &hash, std::size_t slice, Lane
 
       // detach the chain code from the current context
       chain_code->Detach();
+      chain_code->SetProfiler(nullptr);
 
       // force the flushing of the cache *** only if the contract was successful ***
       if (result == Contract::Status::OK)
       {
+        storage_adapter.Flush();
         storage_cache.Flush();
       }
     }
@@ -0,0 +1,431 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/executor_farm.hpp"
+#include "core/logger.hpp"
+#include "core/threading.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * Construct the executor farm
+ *
+ * @param members The remote executors and the lanes each of them is close to
+ * @param handler The handler which is invoked as each item completes
+ * @param name The name prefix for the dispatch threads
+ * @param batch_size The maximum number of items sent to an executor in a single batch
+ * @param pipeline_depth The maximum number of batches in flight to each executor
+ */
+ExecutorFarm::ExecutorFarm(Members members, Handler handler, std::string name,
+                           std::size_t batch_size, std::size_t pipeline_depth)
+  : handler_(std::move(handler))
+  , name_(std::move(name))
+  , batch_size_(std::max<std::size_t>(batch_size, 1))
+  , pipeline_depth_(std::max<std::size_t>(pipeline_depth, 1))
+{
+  if (members.empty())
+  {
+    throw std::runtime_error("Executor farm requires at least one executor");
+  }
+
+  remotes_.reserve(members.size());
+  for (auto &member : members)
+  {
+    remotes_.emplace_back(std::make_unique<Remote>());
+    remotes_.back()->executor = std::move(member.executor);
+    remotes_.back()->lanes    = std::move(member.lanes);
+  }
+}
+
+ExecutorFarm::~ExecutorFarm()
+{
+  Stop();
+}
+
+/**
+ * Start the dispatch threads
+ */
+void ExecutorFarm::Start()
+{
+  bool expected{false};
+  if (!running_.compare_exchange_strong(expected, true))
+  {
+    return;
+  }
+
+  for (std::size_t i = 0; i < remotes_.size(); ++i)
+  {
+    remotes_[i]->thread = std::make_unique<std::thread>(&ExecutorFarm::DispatchLoop, this, i);
+  }
+}
+
+/**
+ * Stop the dispatch threads. Items which have not completed are discarded.
+ */
+void ExecutorFarm::Stop()
+{
+  bool expected{true};
+  if (!running_.compare_exchange_strong(expected, false))
+  {
+    return;
+  }
+
+  {
+    std::lock_guard<Mutex> lock(work_lock_);
+    work_available_.notify_all();
+  }
+
+  for (auto &remote : remotes_)
+  {
+    if (remote->thread)
+    {
+      remote->thread->join();
+      remote->thread.reset();
+    }
+
+    std::lock_guard<Mutex> lock(remote->lock);
+    remote->queue.clear();
+    remote->load = 0;
+  }
+}
+
+/**
+ * Post an execution item to the farm. The item must outlive its execution.
+ *
+ * @param item The item to be executed
+ */
+void ExecutorFarm::Post(ExecutionItem &item)
+{
+  if (!Place(item))
+  {
+    Fail(item);
+  }
+}
+
+/**
+ * Get the number of executors which have not failed
+ *
+ * @return The number of available executors
+ */
+std::size_t ExecutorFarm::num_available() const
+{
+  std::size_t count{0};
+  for (auto const &remote : remotes_)
+  {
+    if (remote->available)
+    {
+      ++count;
+    }
+  }
+
+  return count;
+}
+
+void ExecutorFarm::DispatchLoop(std::size_t index)
+{
+  SetThreadName(name_, index);
+
+  auto &  remote = *remotes_[index];
+  Batches in_flight{};
+
+  while (running_)
+  {
+    // keep the pipeline to the executor full
+    if (!Send(remote, in_flight))
+    {
+      Failover(index, in_flight);
+      return;
+    }
+
+    if (in_flight.empty())
+    {
+      WaitForWork(remote);
+      continue;
+    }
+
+    // collect the oldest batch, the others are executed in the meantime
+    if (!Complete(remote, in_flight.front()))
+    {
+      Failover(index, in_flight);
+      return;
+    }
+
+    in_flight.pop_front();
+  }
+}
+
+/**
+ * Internal: Queue an item on the available executor closest to its lanes, breaking ties on the
+ * load of the executors
+ *
+ * @param item The item to be queued
+ * @return true if the item was queued, false if no executors are available
+ */
+bool ExecutorFarm::Place(ExecutionItem &item)
+{
+  for (;;)
+  {
+    Remote *    best{nullptr};
+    std::size_t best_score{0};
+    std::size_t best_load{0};
+
+    for (auto const &remote : remotes_)
+    {
+      if (!remote->available)
+      {
+        continue;
+      }
+
+      std::size_t const score = Score(*remote, item);
+      std::size_t const load  = remote->load;
+
+      if ((best == nullptr) || (score > best_score) || ((score == best_score) && (load < best_load)))
+      {
+        best       = remote.get();
+        best_score = score;
+        best_load  = load;
+      }
+    }
+
+    if (best == nullptr)
+    {
+      return false;
+    }
+
+    {
+      std::lock_guard<Mutex> lock(best->lock);
+
+      // the executor may have failed since it was selected, in which case select another
+      if (!best->available)
+      {
+        continue;
+      }
+
+      best->queue.push_back(&item);
+      ++best->load;
+    }
+
+    // only pay for the notification when there is somebody waiting for it
+    if (sleeping_ > 0)
+    {
+      std::lock_guard<Mutex> lock(work_lock_);
+      work_available_.notify_all();
+    }
+
+    return true;
+  }
+}
+
+/**
+ * Internal: Take the next batch of items from the queue of an executor
+ *
+ * @param remote The executor
+ * @return The items of the batch, empty if there are none queued
+ */
+ExecutorFarm::Items ExecutorFarm::TakeBatch(Remote &remote)
+{
+  Items items{};
+
+  std::lock_guard<Mutex> lock(remote.lock);
+  while (!remote.queue.empty() && (items.size() < batch_size_))
+  {
+    items.push_back(remote.queue.front());
+    remote.queue.pop_front();
+  }
+
+  return items;
+}
+
+/**
+ * Internal: Send batches to an executor until its pipeline is full or its queue is empty
+ *
+ * @param remote The executor
+ * @param in_flight The batches in flight to the executor
+ * @return true if successful, false if the executor could not be reached
+ */
+bool ExecutorFarm::Send(Remote &remote, Batches &in_flight)
+{
+  while (in_flight.size() < pipeline_depth_)
+  {
+    Items items = TakeBatch(remote);
+    if (items.empty())
+    {
+      break;
+    }
+
+    RemoteExecutorInterface::Requests requests{};
+    requests.reserve(items.size());
+    for (auto const *item : items)
+    {
+      requests.push_back(ExecutionRequest{item->hash(), item->slice(), item->lanes()});
+    }
+
+    in_flight.push_back(Batch{std::move(items), PendingBatch{}});
+
+    try
+    {
+      in_flight.back().result = remote.executor->ExecuteBatch(requests);
+    }
+    catch (std::exception const &ex)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Unable to send batch to executor: ", ex.what());
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Internal: Wait for the result of a batch and complete each of its items
+ *
+ * @param remote The executor the batch was sent to
+ * @param batch The batch
+ * @return true if successful, false if the executor failed to execute the batch
+ */
+bool ExecutorFarm::Complete(Remote &remote, Batch &batch)
+{
+  RemoteExecutorInterface::Statuses statuses{};
+
+  try
+  {
+    statuses = batch.result.get();
+  }
+  catch (std::exception const &ex)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Executor failed to execute batch: ", ex.what());
+    return false;
+  }
+
+  if (statuses.size() != batch.items.size())
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Executor returned ", statuses.size(), " statuses for a batch of ",
+                   batch.items.size());
+    return false;
+  }
+
+  for (std::size_t i = 0; i < statuses.size(); ++i)
+  {
+    batch.items[i]->Complete(statuses[i]);
+    --remote.load;
+
+    handler_(*batch.items[i]);
+  }
+
+  return true;
+}
+
+/**
+ * Internal: Remove a failed executor from the farm and place all of its outstanding items on the
+ * remaining executors
+ *
+ * @param index The index of the failed executor
+ * @param in_flight The batches in flight to the failed executor
+ */
+void ExecutorFarm::Failover(std::size_t index, Batches &in_flight)
+{
+  auto &remote = *remotes_[index];
+
+  Items items{};
+  for (auto &batch : in_flight)
+  {
+    items.insert(items.end(), batch.items.begin(), batch.items.end());
+  }
+  in_flight.clear();
+
+  {
+    std::lock_guard<Mutex> lock(remote.lock);
+
+    // no further items will be queued on the executor once it is unavailable
+    remote.available = false;
+
+    items.insert(items.end(), remote.queue.begin(), remote.queue.end());
+    remote.queue.clear();
+    remote.load = 0;
+  }
+
+  FETCH_LOG_WARN(LOGGING_NAME, "Executor ", index, " failed, moving ", items.size(),
+                 " items to the remaining executors");
+
+  failover_count_ += items.size();
+
+  for (auto *item : items)
+  {
+    Post(*item);
+  }
+}
+
+/**
+ * Internal: Complete an item which could not be executed
+ *
+ * @param item The item
+ */
+void ExecutorFarm::Fail(ExecutionItem &item)
+{
+  item.Complete(ExecutorInterface::Status::RESOURCE_FAILURE);
+  handler_(item);
+}
+
+/**
+ * Internal: Block the dispatch thread of an executor until there might be work for it
+ *
+ * @param remote The executor
+ */
+void ExecutorFarm::WaitForWork(Remote &remote)
+{
+  std::unique_lock<Mutex> lock(work_lock_);
+
+  ++sleeping_;
+
+  // the load only counts queued items here, since nothing is in flight
+  work_available_.wait_for(lock, std::chrono::milliseconds{10},
+                           [this, &remote]() { return (remote.load > 0) || !running_; });
+
+  --sleeping_;
+}
+
+/**
+ * Internal: Determine how close an executor is to the lanes of an item
+ *
+ * @param remote The executor
+ * @param item The item
+ * @return The number of lanes of the item which are close to the executor
+ */
+std::size_t ExecutorFarm::Score(Remote const &remote, ExecutionItem const &item)
+{
+  std::size_t score{0};
+  for (auto const lane : item.lanes())
+  {
+    if (remote.lanes.find(lane) != remote.lanes.end())
+    {
+      ++score;
+    }
+  }
+
+  return score;
+}
+
+}  // namespace ledger
+}  // namespace fetch
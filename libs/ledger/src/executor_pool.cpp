@@ -0,0 +1,235 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "ledger/executor_pool.hpp"
+#include "core/threading.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * Construct the executor pool
+ *
+ * @param num_workers The number of workers (and executors) to create
+ * @param factory The factory used to create the executor for each worker
+ * @param handler The handler which is invoked for each of the posted items
+ * @param name The name prefix for the worker threads
+ */
+ExecutorPool::ExecutorPool(std::size_t num_workers, ExecutorFactory const &factory,
+                           Handler handler, std::string name)
+  : handler_(std::move(handler))
+  , name_(std::move(name))
+{
+  if (num_workers == 0)
+  {
+    throw std::runtime_error("Executor pool requires at least one worker");
+  }
+
+  workers_.reserve(num_workers);
+  for (std::size_t i = 0; i < num_workers; ++i)
+  {
+    workers_.emplace_back(std::make_unique<Worker>());
+    workers_.back()->executor = factory();
+  }
+}
+
+ExecutorPool::~ExecutorPool()
+{
+  Stop();
+}
+
+/**
+ * Start all the worker threads
+ */
+void ExecutorPool::Start()
+{
+  bool expected{false};
+  if (!running_.compare_exchange_strong(expected, true))
+  {
+    return;
+  }
+
+  for (std::size_t i = 0; i < workers_.size(); ++i)
+  {
+    workers_[i]->thread = std::make_unique<std::thread>(&ExecutorPool::WorkerLoop, this, i);
+  }
+}
+
+/**
+ * Stop all the worker threads. Items which have not been started are discarded.
+ */
+void ExecutorPool::Stop()
+{
+  bool expected{true};
+  if (!running_.compare_exchange_strong(expected, false))
+  {
+    return;
+  }
+
+  {
+    std::lock_guard<Mutex> lock(sleep_lock_);
+    work_available_.notify_all();
+  }
+
+  for (auto &worker : workers_)
+  {
+    if (worker->thread)
+    {
+      worker->thread->join();
+      worker->thread.reset();
+    }
+
+    std::lock_guard<Mutex> lock(worker->lock);
+    worker->queue.clear();
+  }
+
+  pending_ = 0;
+}
+
+/**
+ * Post an execution item to the pool. The item must outlive its execution.
+ *
+ * @param item The item to be executed
+ */
+void ExecutorPool::Post(ExecutionItem &item)
+{
+  std::size_t const index = next_worker_++ % workers_.size();
+
+  // must be incremented before the item becomes visible to the workers
+  ++pending_;
+
+  {
+    auto &worker = *workers_[index];
+
+    std::lock_guard<Mutex> lock(worker.lock);
+    worker.queue.push_back(&item);
+  }
+
+  // only pay for the notification when there is somebody waiting for it
+  if (sleeping_ > 0)
+  {
+    std::lock_guard<Mutex> lock(sleep_lock_);
+    work_available_.notify_one();
+  }
+}
+
+void ExecutorPool::WorkerLoop(std::size_t index)
+{
+  SetThreadName(name_, index);
+
+  auto &executor = *workers_[index]->executor;
+
+  while (running_)
+  {
+    ExecutionItem *item = PopLocal(index);
+
+    if (item == nullptr)
+    {
+      item = Steal(index);
+    }
+
+    if (item == nullptr)
+    {
+      WaitForWork();
+      continue;
+    }
+
+    --pending_;
+
+    handler_(*item, executor);
+  }
+}
+
+/**
+ * Take the most recently posted item from the worker's own queue
+ *
+ * @param index The index of the worker
+ * @return The item if one was available, otherwise nullptr
+ */
+ExecutionItem *ExecutorPool::PopLocal(std::size_t index)
+{
+  auto &worker = *workers_[index];
+
+  std::lock_guard<Mutex> lock(worker.lock);
+
+  if (worker.queue.empty())
+  {
+    return nullptr;
+  }
+
+  ExecutionItem *item = worker.queue.back();
+  worker.queue.pop_back();
+
+  return item;
+}
+
+/**
+ * Take the oldest item from the queue of one of the other workers
+ *
+ * @param index The index of the worker which is stealing
+ * @return The item if one was available, otherwise nullptr
+ */
+ExecutionItem *ExecutorPool::Steal(std::size_t index)
+{
+  std::size_t const num_workers = workers_.size();
+
+  for (std::size_t offset = 1; offset < num_workers; ++offset)
+  {
+    auto &victim = *workers_[(index + offset) % num_workers];
+
+    // never block on a busy victim, simply move on to the next one
+    std::unique_lock<Mutex> lock(victim.lock, std::try_to_lock);
+    if (!lock.owns_lock() || victim.queue.empty())
+    {
+      continue;
+    }
+
+    ExecutionItem *item = victim.queue.front();
+    victim.queue.pop_front();
+
+    ++steal_count_;
+
+    return item;
+  }
+
+  return nullptr;
+}
+
+/**
+ * Block the calling worker until there might be work available
+ */
+void ExecutorPool::WaitForWork()
+{
+  std::unique_lock<Mutex> lock(sleep_lock_);
+
+  ++sleeping_;
+
+  // the timeout guards against pending items which were skipped over by a failed try lock
+  work_available_.wait_for(lock, std::chrono::milliseconds{10},
+                           [this]() { return (pending_ > 0) || !running_; });
+
+  --sleeping_;
+}
+
+}  // namespace ledger
+}  // namespace fetch
@@ -18,9 +18,15 @@
 
 #include "ledger/identifier.hpp"
 #include "core/byte_array/byte_array.hpp"
+#include "core/logger.hpp"
+#include "crypto/fnv.hpp"  // needed for std::hash<ConstByteArray>
 
+#include <algorithm>
+#include <array>
+#include <mutex>
 #include <regex>
 #include <stdexcept>
+#include <unordered_map>
 
 using fetch::byte_array::ConstByteArray;
 using fetch::byte_array::ByteArray;
@@ -78,56 +84,152 @@ bool IsIdentity(ConstByteArray const &value)
 
 }  // namespace
 
+/**
+ * The process wide table of interned identifiers. Only weak references are held by the table so
+ * that identifiers which are no longer in use are released, the table is split into shards to
+ * limit contention between the executors.
+ */
+class Identifier::Table
+{
+public:
+  static Table &Instance()
+  {
+    static Table instance;
+    return instance;
+  }
+
+  /**
+   * Lookup or create the interned entry for a fully qualified name
+   *
+   * @param full The fully qualified name
+   * @return The interned entry, or null if the name is invalid
+   */
+  EntryPtr Intern(ConstByteArray const &full)
+  {
+    std::size_t const hash  = std::hash<ConstByteArray>{}(full);
+    Shard &           shard = shards_[hash % NUM_SHARDS];
+
+    {
+      std::lock_guard<std::mutex> guard(shard.lock);
+
+      auto it = shard.entries.find(full);
+      if (it != shard.entries.end())
+      {
+        EntryPtr entry = it->second.lock();
+        if (entry)
+        {
+          return entry;
+        }
+      }
+    }
+
+    // the entry is created outside of the lock since creating it interns the parent identifiers
+    EntryPtr entry = CreateEntry(full, hash);
+    if (!entry)
+    {
+      return entry;
+    }
+
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    // another thread might have interned the same name in the meantime
+    auto &slot = shard.entries[entry->full];
+    if (auto existing = slot.lock())
+    {
+      return existing;
+    }
+
+    slot = entry;
+
+    // periodically release the slots of the identifiers which are no longer in use
+    if (shard.entries.size() >= shard.sweep_threshold)
+    {
+      for (auto it = shard.entries.begin(); it != shard.entries.end();)
+      {
+        if (it->second.expired())
+        {
+          it = shard.entries.erase(it);
+        }
+        else
+        {
+          ++it;
+        }
+      }
+
+      shard.sweep_threshold = std::max(MIN_SWEEP_THRESHOLD, shard.entries.size() * 2);
+    }
+
+    return entry;
+  }
+
+private:
+  static constexpr std::size_t NUM_SHARDS          = 16;
+  static constexpr std::size_t MIN_SWEEP_THRESHOLD = 64;
+
+  using Entries = std::unordered_map<ConstByteArray, std::weak_ptr<Entry const>>;
+
+  struct Shard
+  {
+    std::mutex  lock;
+    Entries     entries{};
+    std::size_t sweep_threshold{MIN_SWEEP_THRESHOLD};
+  };
+
+  std::array<Shard, NUM_SHARDS> shards_;
+};
+
+constexpr std::size_t Identifier::Table::NUM_SHARDS;
+constexpr std::size_t Identifier::Table::MIN_SWEEP_THRESHOLD;
+
 const char Identifier::SEPARATOR{'.'};
 
+/**
+ * Construct an empty identifier
+ */
+Identifier::Identifier()
+  : entry_{EmptyEntry()}
+{}
+
 /**
  * Construct an identifier from a fully qualified name
  *
  * @param identifier The fully qualified name to parse
  */
 Identifier::Identifier(ConstByteArray identifier)
-  : full_{std::move(identifier)}
+  : entry_{Table::Instance().Intern(identifier)}
 {
-  if (!Tokenise())
+  if (!entry_)
   {
     throw std::runtime_error("Unable to parse identifier");
   }
 }
 
 /**
- * Construct an identifier from another set of tokens
- * @param tokens
- * @param count
+ * Construct an identifier from an interned entry
+ *
+ * @param entry The interned entry
  */
-Identifier::Identifier(Tokens const &tokens, std::size_t count)
-{
-  if (count <= tokens.size())
-  {
-    ByteArray full;
+Identifier::Identifier(EntryPtr entry)
+  : entry_{std::move(entry)}
+{}
 
-    for (std::size_t i = 0; i < count; ++i)
-    {
-      // select the current token
-      auto const &current_token = tokens[i];
-
-      // add the token to the list
-      tokens_.push_back(current_token);
-
-      // regenerate the full name
-      if (i)
-      {
-        full.Append(".");
-      }
-
-      full.Append(current_token);
-    }
-
-    // regenerate the full name
-    full_ = std::move(full);
+/**
+ * Parses an fully qualified name
+ *
+ * @param name The fully qualified name
+ * @return true if successful, otherwise false (in which case the identifier is empty)
+ */
+bool Identifier::Parse(ConstByteArray const &name)
+{
+  entry_ = Table::Instance().Intern(name);
 
-    // update the type
-    UpdateType();
+  if (!entry_)
+  {
+    entry_ = EmptyEntry();
+    return false;
   }
+
+  return true;
 }
 
 /**
@@ -136,40 +238,57 @@ Identifier::Identifier(Tokens const &tokens, std::size_t count)
  */
 Identifier Identifier::GetParent() const
 {
-  std::size_t const num_tokens = tokens_.size();
+  return Identifier{entry_->parent ? entry_->parent : entry_};
+}
 
-  return Identifier{tokens_, (num_tokens) ? (num_tokens - 1) : 0};
+/**
+ * Internal: Get the entry shared by all the empty identifiers
+ *
+ * @return The empty entry
+ */
+Identifier::EntryPtr const &Identifier::EmptyEntry()
+{
+  static EntryPtr const empty = std::make_shared<Entry const>(
+      Entry{Type::INVALID, {}, {}, {}, std::hash<ConstByteArray>{}(ConstByteArray{}), {}});
+  return empty;
 }
 
 /**
- * Internal: Break up the fully qualified name into tokens
+ * Internal: Break up the fully qualified name into tokens and build the entry for it
+ *
+ * @param full The fully qualified name
+ * @param hash The hash of the fully qualified name
+ * @return The new entry, or null if the name is invalid
  */
-bool Identifier::Tokenise()
+Identifier::EntryPtr Identifier::CreateEntry(ConstByteArray const &full, std::size_t hash)
 {
-  // ensure the tokens storage is empty
-  tokens_.clear();
+  auto entry  = std::make_shared<Entry>();
+  entry->full = full.Copy();  // do not keep any larger buffer (e.g. the transaction) alive
+  entry->hash = hash;
+
+  auto &tokens = entry->tokens;
 
   std::size_t offset = 0;
   for (;;)
   {
     // find the next instance of the separator
-    std::size_t const index = full_.Find(SEPARATOR, offset);
+    std::size_t const index = entry->full.Find(SEPARATOR, offset);
 
     // determine if this is the last token
     bool const last_token = (ConstByteArray::NPOS == index);
 
     // calculate the size of the element
-    std::size_t const size = (last_token) ? (full_.size() - offset) : (index - offset);
+    std::size_t const size = (last_token) ? (entry->full.size() - offset) : (index - offset);
 
     // empty tokens are invalid
     if (size == 0)
     {
       FETCH_LOG_WARN(LOGGING_NAME, "Identifier contains empty tokens");
-      return false;
+      return {};
     }
 
     // add the new token to the array
-    tokens_.push_back(full_.SubArray(offset, size));
+    tokens.push_back(entry->full.SubArray(offset, size));
 
     if (last_token)
     {
@@ -180,32 +299,49 @@ bool Identifier::Tokenise()
     offset = index + 1;
   }
 
-  // update the type
-  UpdateType();
+  entry->type = DetermineType(tokens);
 
-  return true;
+  // the namespace is also the name of the parent identifier
+  if (tokens.size() >= 2)
+  {
+    entry->name_space = entry->full.SubArray(0, entry->full.size() - (tokens.back().size() + 1));
+    entry->parent     = Table::Instance().Intern(entry->name_space);
+  }
+  else
+  {
+    entry->parent = EmptyEntry();
+  }
+
+  return entry;
 }
 
-void Identifier::UpdateType()
+/**
+ * Internal: Decide if the tokens of a name match that of a smart contract
+ *
+ * @param tokens The tokens of the name
+ * @return The type of the identifier
+ */
+Identifier::Type Identifier::DetermineType(Tokens const &tokens)
 {
-  // successful parse
-  type_ = Type::NORMAL;
+  Type type{Type::NORMAL};
 
   // once the parse is complete decide if this identifier matches that of a smart contract
-  if ((1u <= tokens_.size()) && (3u >= tokens_.size()))
+  if ((1u <= tokens.size()) && (3u >= tokens.size()))
   {
-    bool is_smart_contract = IsDigest(tokens_[0]);
+    bool is_smart_contract = IsDigest(tokens[0]);
 
-    if (2u <= tokens_.size())
+    if (2u <= tokens.size())
     {
-      is_smart_contract &= IsIdentity(tokens_[1]);
+      is_smart_contract &= IsIdentity(tokens[1]);
     }
 
     if (is_smart_contract)
     {
-      type_ = Type::SMART_CONTRACT;
+      type = Type::SMART_CONTRACT;
     }
   }
+
+  return type;
 }
 
 /**
@@ -216,11 +352,14 @@ void Identifier::UpdateType()
  */
 bool Identifier::IsParentTo(Identifier const &other) const
 {
-  if (!tokens_.empty() && !other.tokens_.empty())
+  auto const &tokens       = entry_->tokens;
+  auto const &other_tokens = other.entry_->tokens;
+
+  if (!tokens.empty() && !other_tokens.empty())
   {
-    if (tokens_.size() < other.tokens_.size())
+    if (tokens.size() < other_tokens.size())
     {
-      return tokens_[0] == other.tokens_[0];
+      return tokens[0] == other_tokens[0];
     }
   }
   return false;
@@ -246,22 +385,8 @@ bool Identifier::IsChildTo(Identifier const &other) const
  */
 bool Identifier::IsDirectParentTo(Identifier const &other) const
 {
-  bool is_parent{false};
-
-  if ((tokens_.size() + 1) == other.tokens_.size())
-  {
-    is_parent = true;
-    for (std::size_t i = 0; i < tokens_.size(); ++i)
-    {
-      if (tokens_[i] != other.tokens_[i])
-      {
-        is_parent = false;
-        break;
-      }
-    }
-  }
-
-  return is_parent;
+  // the parent of an identifier is interned, so it is the same entry as this one if it matches
+  return (!other.empty()) && (other.entry_->parent == entry_);
 }
 
 /**
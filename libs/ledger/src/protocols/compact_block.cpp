@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/protocols/compact_block.hpp"
+
+namespace fetch {
+namespace ledger {
+
+/**
+ * Build the compact form of a block
+ *
+ * @param block The complete block
+ */
+CompactBlock::CompactBlock(Block const &block)
+  : header{block}
+{
+  header.body.slices.clear();
+
+  slices.reserve(block.body.slices.size());
+  for (auto const &slice : block.body.slices)
+  {
+    ShortIds ids;
+    ids.reserve(slice.size());
+
+    for (auto const &tx : slice)
+    {
+      ids.push_back(TransactionSummaryCache::ComputeShortId(tx.transaction_hash));
+    }
+
+    slices.push_back(std::move(ids));
+  }
+}
+
+/**
+ * Rebuild the complete block from the summaries which are available in the local cache
+ *
+ * @param cache The cache of recently seen transactions (can be null)
+ * @param block The output block to be populated
+ * @return The (flattened) indices of the transactions which could not be found in the cache
+ */
+CompactBlock::Indices CompactBlock::Reconstruct(TransactionSummaryCache const *cache,
+                                                Block &block) const
+{
+  Indices missing{};
+
+  block = header;
+  block.body.slices.clear();
+  block.body.slices.resize(slices.size());
+
+  uint64_t index{0};
+  for (std::size_t i = 0; i < slices.size(); ++i)
+  {
+    auto &slice = block.body.slices[i];
+    slice.resize(slices[i].size());
+
+    for (std::size_t j = 0; j < slices[i].size(); ++j, ++index)
+    {
+      if (!(cache && cache->Lookup(slices[i][j], slice[j])))
+      {
+        missing.push_back(index);
+      }
+    }
+  }
+
+  return missing;
+}
+
+/**
+ * Populate the missing transactions of a partially rebuilt block
+ *
+ * @param block The block to be updated
+ * @param indices The (flattened, ascending) indices of the missing transactions
+ * @param summaries The summaries of the missing transactions, in the same order as the indices
+ * @return true if successful, otherwise false
+ */
+bool CompactBlock::Fill(Block &block, Indices const &indices, TxSummaries const &summaries)
+{
+  if (indices.size() != summaries.size())
+  {
+    return false;
+  }
+
+  auto     index_it = indices.begin();
+  auto     tx_it    = summaries.begin();
+  uint64_t index{0};
+
+  for (auto &slice : block.body.slices)
+  {
+    for (auto &tx : slice)
+    {
+      if ((index_it != indices.end()) && (*index_it == index))
+      {
+        tx = *tx_it;
+
+        ++index_it;
+        ++tx_it;
+      }
+
+      ++index;
+    }
+  }
+
+  // all the summaries must have been consumed
+  return index_it == indices.end();
+}
+
+}  // namespace ledger
+}  // namespace fetch
@@ -19,7 +19,9 @@
 #include "ledger/protocols/executor_rpc_client.hpp"
 #include "core/state_machine.hpp"
 
+#include <future>
 #include <memory>
+#include <stdexcept>
 
 namespace fetch {
 namespace ledger {
@@ -158,6 +160,28 @@ ExecutorInterface::Status ExecutorRpcClient::Execute(TxDigest const &hash, std::
   return result->As<ExecutorInterface::Status>();
 }
 
+/**
+ * Send a batch of transactions to the remote executor. The call is made straight away, waiting on
+ * the returned batch only waits for the response.
+ *
+ * @param requests The transactions to be executed
+ * @return The pending statuses of the transactions
+ */
+RemoteExecutorInterface::PendingBatch ExecutorRpcClient::ExecuteBatch(Requests const &requests)
+{
+  auto promise = client_->CallSpecificAddress(address_, RPC_EXECUTOR,
+                                              ExecutorRpcProtocol::EXECUTE_BATCH, requests);
+
+  return std::async(std::launch::deferred, [promise]() {
+    if (!promise->Wait(BATCH_TIMEOUT_MS, false))
+    {
+      throw std::runtime_error("Executor batch timed out or failed");
+    }
+
+    return promise->As<Statuses>();
+  });
+}
+
 void ExecutorRpcClient::WorkCycle()
 {
   if (!bg_work_.WorkCycle())
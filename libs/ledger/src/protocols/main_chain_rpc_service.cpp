@@ -24,46 +24,56 @@
 #include "core/service_ids.hpp"
 #include "crypto/fetch_identity.hpp"
 #include "ledger/chain/block_coordinator.hpp"
+#include "ledger/transaction_summary_cache.hpp"
 #include "metrics/metrics.hpp"
 #include "network/muddle/packet.hpp"
 
+#include <algorithm>
+#include <chrono>
+
 using fetch::muddle::Packet;
 using fetch::byte_array::ToBase64;
 
-using BlockSerializer        = fetch::serializers::ByteArrayBuffer;
-using BlockSerializerCounter = fetch::serializers::SizeCounter<BlockSerializer>;
-using PromiseState           = fetch::service::PromiseState;
+using BlockSerializer = fetch::serializers::ByteArrayBuffer;
+using PromiseState    = fetch::service::PromiseState;
 
 static const uint32_t MAX_CHAIN_REQUEST_SIZE = 10000;
 static const uint64_t MAX_SUB_CHAIN_SIZE     = 1000;
+static const uint64_t MAX_STREAM_SIZE        = 10000;
+static const uint64_t STREAM_INITIAL_CREDITS = 64;
+static const uint64_t STREAM_CREDIT_BATCH    = 16;
+static const std::size_t MAX_OUTBOUND_STREAMS = 8;
+static const std::chrono::seconds STREAM_TIMEOUT{10};
 
 namespace fetch {
 namespace ledger {
 
+constexpr MainChainRpcService::StateHandler MainChainRpcService::STATE_TABLE[];
+
 MainChainRpcService::MainChainRpcService(MuddleEndpoint &endpoint, MainChain &chain,
-                                         TrustSystem &trust, bool standalone)
+                                         TrustSystem &trust, bool standalone,
+                                         SyncMode                 sync_mode,
+                                         TransactionSummaryCache *tx_summary_cache)
   : muddle::rpc::Server(endpoint, SERVICE_MAIN_CHAIN, CHANNEL_RPC)
   , endpoint_(endpoint)
   , chain_(chain)
   , trust_(trust)
   , block_subscription_(endpoint.Subscribe(SERVICE_MAIN_CHAIN, CHANNEL_BLOCKS))
+  , stream_subscription_(endpoint.Subscribe(SERVICE_MAIN_CHAIN, CHANNEL_BLOCK_STREAM))
+  , compact_subscription_(endpoint.Subscribe(SERVICE_MAIN_CHAIN, CHANNEL_COMPACT_BLOCKS))
   , main_chain_protocol_(chain_)
   , rpc_client_("R:MChain", endpoint, Address{}, SERVICE_MAIN_CHAIN, CHANNEL_RPC)
   , state_machine_{std::make_shared<StateMachine>(
-        "MainChain", standalone ? State::SYNCHRONISED : State::REQUEST_HEAVIEST_CHAIN,
-        [](State state) { return ToString(state); })}
+        "MainChain", standalone ? State::SYNCHRONISED : State::REQUEST_HEAVIEST_CHAIN, this,
+        STATE_TABLE, [](State state) { return ToString(state); })}
+  , sync_mode_{sync_mode}
+  , summary_cache_{tx_summary_cache}
+  , tx_client_("R:MChainTx", endpoint, Address{}, SERVICE_MAIN_CHAIN, CHANNEL_RPC)
 {
   // register the main chain protocol
   Add(RPC_MAIN_CHAIN, &main_chain_protocol_);
 
-  // configure the state machine
-  // clang-format off
-  state_machine_->RegisterHandler(State::REQUEST_HEAVIEST_CHAIN,  this, &MainChainRpcService::OnRequestHeaviestChain);
-  state_machine_->RegisterHandler(State::WAIT_FOR_HEAVIEST_CHAIN, this, &MainChainRpcService::OnWaitForHeaviestChain);
-  state_machine_->RegisterHandler(State::SYNCHRONISING,           this, &MainChainRpcService::OnSynchronising);
-  state_machine_->RegisterHandler(State::WAITING_FOR_RESPONSE,    this, &MainChainRpcService::OnWaitingForResponse);
-  state_machine_->RegisterHandler(State::SYNCHRONISED,            this, &MainChainRpcService::OnSynchronised);
-  // clang-format on
+  static_assert(core::IsStateTableOrdered(STATE_TABLE), "State table must be ordered by state");
 
   state_machine_->OnStateChange([](State current, State previous) {
     FETCH_LOG_INFO(LOGGING_NAME, "Changed state: ", ToString(previous), " -> ", ToString(current));
@@ -87,6 +97,50 @@ MainChainRpcService::MainChainRpcService(MuddleEndpoint &endpoint, MainChain &ch
     // dispatch the event
     OnNewBlock(from, block, transmitter);
   });
+
+  // compact blocks are always accepted, even if this node does not maintain a summary cache
+  compact_subscription_->SetMessageHandler([this](Address const &from, uint16_t, uint16_t,
+                                                  uint16_t, Packet::Payload const &payload,
+                                                  Address transmitter) {
+    try
+    {
+      BlockSerializer serialiser(payload);
+
+      // deserialize the compact block
+      CompactBlock compact;
+      serialiser >> compact;
+
+      // dispatch the event
+      OnNewCompactBlock(from, compact, transmitter);
+    }
+    catch (std::exception const &ex)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Unable to handle compact block from: muddle://",
+                     ToBase64(from), " error: ", ex.what());
+    }
+  });
+
+  // block streams are always served, regardless of the sync mode of this node
+  stream_subscription_->SetMessageHandler([this](Address const &from, uint16_t, uint16_t,
+                                                 uint16_t, Packet::Payload const &payload,
+                                                 Address const &) {
+    try
+    {
+      BlockSerializer serialiser(payload);
+
+      // deserialize the message
+      StreamMessage msg;
+      serialiser >> msg;
+
+      // dispatch the event
+      OnStreamMessage(from, msg);
+    }
+    catch (std::exception const &ex)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Unable to handle block stream message from: muddle://",
+                     ToBase64(from), " error: ", ex.what());
+    }
+  });
 }
 
 MainChainRpcService::~MainChainRpcService()
@@ -97,14 +151,22 @@ MainChainRpcService::~MainChainRpcService()
 
 void MainChainRpcService::BroadcastBlock(MainChainRpcService::Block const &block)
 {
-  // determine the serialised size of the block
-  BlockSerializerCounter counter;
-  counter << block;
+  // when this node maintains a cache of transactions its peers are expected to do the same, in
+  // which case only the compact form of the block is sent
+  if (summary_cache_)
+  {
+    CompactBlock const compact{block};
+
+    BlockSerializer serializer;
+    serializer.Append(compact);
+
+    endpoint_.Broadcast(SERVICE_MAIN_CHAIN, CHANNEL_COMPACT_BLOCKS, serializer.data());
+    return;
+  }
 
-  // allocate the buffer and serialise the block
+  // measure, allocate and serialise the block in a single exact reservation
   BlockSerializer serializer;
-  serializer.Reserve(counter.size());
-  serializer << block;
+  serializer.Append(block);
 
   // broadcast the block to the nodes on the network
   endpoint_.Broadcast(SERVICE_MAIN_CHAIN, CHANNEL_BLOCKS, serializer.data());
@@ -169,6 +231,135 @@ void MainChainRpcService::OnNewBlock(Address const &from, Block &block, Address
   }
 }
 
+void MainChainRpcService::OnNewCompactBlock(Address const &from, CompactBlock const &compact,
+                                            Address const &transmitter)
+{
+  // no need to rebuild blocks which have already been seen
+  if (chain_.GetBlock(compact.header.body.hash))
+  {
+    FETCH_LOG_DEBUG(LOGGING_NAME, "Duplicate compact block: ", ToBase64(compact.header.body.hash));
+    return;
+  }
+
+  Block block;
+  auto  missing = compact.Reconstruct(summary_cache_, block);
+
+  if (missing.empty())
+  {
+    if (CompleteCompactBlock(from, block, transmitter))
+    {
+      return;
+    }
+
+    // a short id collision has occurred, all of the transactions need to be requested
+    missing.resize(block.GetTransactionCount());
+    for (std::size_t i = 0; i < missing.size(); ++i)
+    {
+      missing[i] = i;
+    }
+  }
+
+  FETCH_LOG_INFO(LOGGING_NAME, "Compact block: ", ToBase64(compact.header.body.hash),
+                 " requesting ", missing.size(), " of ", block.GetTransactionCount(),
+                 " txs from: ", ToBase64(from));
+
+  RequestMissingTransactions(from, block, std::move(missing), transmitter);
+}
+
+/**
+ * Request the transactions of partially rebuilt compact block from the miner of the block
+ *
+ * @param from The address of the node which generated the block
+ * @param block The partially rebuilt block
+ * @param indices The (flattened, ascending) indices of the missing transactions
+ * @param transmitter The address of the node which relayed the block
+ */
+void MainChainRpcService::RequestMissingTransactions(Address const &from, Block const &block,
+                                                     CompactBlock::Indices indices,
+                                                     Address const &       transmitter)
+{
+  auto promise = tx_client_.CallSpecificAddress(from, RPC_MAIN_CHAIN,
+                                                MainChainProtocol::BLOCK_TRANSACTIONS,
+                                                block.body.hash, indices);
+
+  std::weak_ptr<MainChainRpcService>        weak_self    = shared_from_this();
+  std::weak_ptr<Promise::element_type> const weak_promise = promise;
+  auto                                       partial      = std::make_shared<Block>(block);
+
+  promise->WithHandlers()
+      .Then([weak_self, weak_promise, partial, indices, from, transmitter]() {
+        auto self          = weak_self.lock();
+        auto const promise = weak_promise.lock();
+        if (!(self && promise))
+        {
+          return;
+        }
+
+        CompactBlock::TxSummaries summaries;
+        if (!promise->As(summaries) || !CompactBlock::Fill(*partial, indices, summaries))
+        {
+          FETCH_LOG_WARN(LOGGING_NAME, "Unable to complete compact block: ",
+                         ToBase64(partial->body.hash), " from: ", ToBase64(from));
+          return;
+        }
+
+        if (!self->CompleteCompactBlock(from, *partial, transmitter))
+        {
+          FETCH_LOG_WARN(LOGGING_NAME, "Rebuilt compact block does not match: ",
+                         ToBase64(partial->body.hash), " from: ", ToBase64(from));
+        }
+      })
+      .Catch([partial, from]() {
+        FETCH_LOG_WARN(LOGGING_NAME, "Failed to request transactions for block: ",
+                       ToBase64(partial->body.hash), " from: ", ToBase64(from));
+      });
+}
+
+/**
+ * Validate a completely rebuilt compact block and if successful process it as a new block
+ *
+ * @param from The address of the node which generated the block
+ * @param block The rebuilt block
+ * @param transmitter The address of the node which relayed the block
+ * @return true if the rebuilt block matches the advertised digest, otherwise false
+ */
+bool MainChainRpcService::CompleteCompactBlock(Address const &from, Block &block,
+                                               Address const &transmitter)
+{
+  auto const expected_hash = block.body.hash;
+
+  // recalculate the block hash, this also verifies the transactions which have been filled in
+  block.UpdateDigest();
+
+  if (block.body.hash != expected_hash)
+  {
+    // restore the advertised hash so that any further requests reference the correct block
+    block.body.hash = expected_hash;
+    return false;
+  }
+
+  OnNewBlock(from, block, transmitter);
+  return true;
+}
+
+/**
+ * Get the number of blocks waiting to be streamed to peers which are synchronising from this node
+ *
+ * @return The number of blocks
+ */
+std::size_t MainChainRpcService::GetStreamBacklog() const
+{
+  std::size_t backlog{0};
+
+  FETCH_LOCK(outbound_lock_);
+  for (auto const &entry : outbound_streams_)
+  {
+    backlog += entry.second.blocks.size() - entry.second.next;
+  }
+
+  return backlog;
+}
+
 char const *MainChainRpcService::ToString(State state)
 {
   char const *text = "unknown";
@@ -187,6 +378,9 @@ char const *MainChainRpcService::ToString(State state)
   case State::WAITING_FOR_RESPONSE:
     text = "Waiting for Sync Response";
     break;
+  case State::STREAMING:
+    text = "Streaming";
+    break;
   case State::SYNCHRONISED:
     text = "Synchronised";
     break;
@@ -195,6 +389,178 @@ char const *MainChainRpcService::ToString(State state)
   return text;
 }
 
+void MainChainRpcService::OnStreamMessage(Address const &from, StreamMessage &msg)
+{
+  switch (msg.type)
+  {
+  case StreamMessage::Type::REQUEST:
+    OnStreamRequest(from, msg);
+    break;
+  case StreamMessage::Type::BLOCK:
+    OnStreamBlock(from, msg);
+    break;
+  case StreamMessage::Type::CREDIT:
+    OnStreamCredit(from, msg);
+    break;
+  case StreamMessage::Type::END:
+    OnStreamEnd(from, msg);
+    break;
+  }
+}
+
+void MainChainRpcService::OnStreamRequest(Address const &from, StreamMessage const &msg)
+{
+  StreamKey const key{from, msg.stream_id};
+
+  OutboundStream stream{};
+  stream.credits = msg.credits;
+
+  if (!chain_.GetPathToCommonAncestor(stream.blocks, msg.start, msg.last_seen,
+                                      std::min(msg.limit, MAX_STREAM_SIZE)))
+  {
+    // sanity check
+    stream.blocks.clear();
+  }
+
+  // the path is computed from the tip backwards, however, the blocks are streamed oldest first so
+  // that the requester is able to add each one to its chain as soon as it has been received
+  std::reverse(stream.blocks.begin(), stream.blocks.end());
+
+  FETCH_LOCK(outbound_lock_);
+
+  if ((outbound_streams_.size() >= MAX_OUTBOUND_STREAMS) && (outbound_streams_.count(key) == 0))
+  {
+    FETCH_LOG_INFO(LOGGING_NAME, "Rejecting block stream request from: muddle://",
+                   ToBase64(from), " (too many active streams)");
+
+    StreamMessage end{};
+    end.type      = StreamMessage::Type::END;
+    end.stream_id = msg.stream_id;
+    SendStreamMessage(from, end);
+
+    return;
+  }
+
+  auto &entry = outbound_streams_[key];
+  entry       = std::move(stream);
+
+  SendStreamBlocks(key, entry);
+}
+
+void MainChainRpcService::OnStreamCredit(Address const &from, StreamMessage const &msg)
+{
+  StreamKey const key{from, msg.stream_id};
+
+  FETCH_LOCK(outbound_lock_);
+
+  auto it = outbound_streams_.find(key);
+  if (it != outbound_streams_.end())
+  {
+    it->second.credits += msg.credits;
+
+    SendStreamBlocks(it->first, it->second);
+  }
+}
+
+void MainChainRpcService::OnStreamBlock(Address const &from, StreamMessage &msg)
+{
+  uint64_t received{0};
+
+  {
+    FETCH_LOCK(inbound_lock_);
+
+    // ignore blocks which are not part of the active stream
+    if ((inbound_stream_.id != msg.stream_id) || (inbound_stream_.peer != from) ||
+        inbound_stream_.complete)
+    {
+      return;
+    }
+
+    received                      = ++inbound_stream_.received;
+    inbound_stream_.last_activity = Clock::now();
+  }
+
+  SyncSummary summary{};
+  AddSyncedBlock(from, msg.block, summary);
+
+  if (summary.invalid)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Streamed invalid block: ", ToBase64(msg.block.body.hash),
+                   " from: muddle://", ToBase64(from));
+  }
+
+  // replenish the credits of the remote once a batch of blocks has been processed
+  if ((received % STREAM_CREDIT_BATCH) == 0)
+  {
+    StreamMessage credit{};
+    credit.type      = StreamMessage::Type::CREDIT;
+    credit.stream_id = msg.stream_id;
+    credit.credits   = STREAM_CREDIT_BATCH;
+    SendStreamMessage(from, credit);
+  }
+}
+
+void MainChainRpcService::OnStreamEnd(Address const &from, StreamMessage const &msg)
+{
+  FETCH_LOCK(inbound_lock_);
+
+  if ((inbound_stream_.id == msg.stream_id) && (inbound_stream_.peer == from))
+  {
+    FETCH_LOG_INFO(LOGGING_NAME, "Block stream from: muddle://", ToBase64(from),
+                   " complete. Received: ", inbound_stream_.received, " of ", msg.total,
+                   " blocks");
+
+    inbound_stream_.complete      = true;
+    inbound_stream_.last_activity = Clock::now();
+  }
+}
+
+/**
+ * Send as many blocks from the stream as the remote has granted credits for
+ *
+ * Once the stream has been exhausted the END message is sent and the stream is removed. Must be
+ * called with the outbound lock held.
+ *
+ * @param key The key of the stream in the outbound stream map
+ * @param stream The stream to be serviced
+ */
+void MainChainRpcService::SendStreamBlocks(StreamKey const &key, OutboundStream &stream)
+{
+  StreamMessage msg{};
+  msg.type      = StreamMessage::Type::BLOCK;
+  msg.stream_id = key.second;
+
+  while ((stream.credits > 0) && (stream.next < stream.blocks.size()))
+  {
+    msg.block = *stream.blocks[stream.next++];
+    SendStreamMessage(key.first, msg);
+
+    --stream.credits;
+  }
+
+  if (stream.next >= stream.blocks.size())
+  {
+    StreamMessage end{};
+    end.type      = StreamMessage::Type::END;
+    end.stream_id = key.second;
+    end.total     = stream.blocks.size();
+    SendStreamMessage(key.first, end);
+
+    // since the key might be a reference to the map entry, take a copy before removing it
+    StreamKey const stream_key{key};
+    outbound_streams_.erase(stream_key);
+  }
+}
+
+void MainChainRpcService::SendStreamMessage(Address const &address, StreamMessage const &msg)
+{
+  // measure, allocate and serialise the message in a single exact reservation
+  BlockSerializer serializer;
+  serializer.Append(msg);
+
+  endpoint_.Send(address, SERVICE_MAIN_CHAIN, CHANNEL_BLOCK_STREAM, serializer.data());
+}
+
 MainChainRpcService::Address MainChainRpcService::GetRandomTrustedPeer() const
 {
   static random::LinearCongruentialGenerator rng;
@@ -217,69 +583,80 @@ MainChainRpcService::Address MainChainRpcService::GetRandomTrustedPeer() const
 
 void MainChainRpcService::HandleChainResponse(Address const &address, BlockList block_list)
 {
-  std::size_t added{0};
-  std::size_t loose{0};
-  std::size_t duplicate{0};
-  std::size_t invalid{0};
+  SyncSummary summary{};
 
   for (auto it = block_list.rbegin(), end = block_list.rend(); it != end; ++it)
   {
-    // skip the geneis block
-    if (it->body.previous_hash == GENESIS_DIGEST)
-    {
-      continue;
-    }
+    AddSyncedBlock(address, *it, summary);
+  }
 
-    // recompute the digest
-    it->UpdateDigest();
+  LogSyncSummary(address, summary);
+}
 
-    // add the block
-    if (it->proof())
-    {
-      auto const status = chain_.AddBlock(*it);
+void MainChainRpcService::AddSyncedBlock(Address const &address, Block &block,
+                                         SyncSummary &summary)
+{
+  FETCH_UNUSED(address);  // only used in debug logging
 
-      switch (status)
-      {
-      case BlockStatus::ADDED:
-        FETCH_LOG_DEBUG(LOGGING_NAME, "Synced new block: ", ToBase64(it->body.hash),
-                        " from: muddle://", ToBase64(address));
-        ++added;
-        break;
-      case BlockStatus::LOOSE:
-        FETCH_LOG_DEBUG(LOGGING_NAME, "Synced loose block: ", ToBase64(it->body.hash),
-                        " from: muddle://", ToBase64(address));
-        ++loose;
-        break;
-      case BlockStatus::DUPLICATE:
-        FETCH_LOG_DEBUG(LOGGING_NAME, "Synced duplicate block: ", ToBase64(it->body.hash),
-                        " from: muddle://", ToBase64(address));
-        ++duplicate;
-        break;
-      case BlockStatus::INVALID:
-        FETCH_LOG_DEBUG(LOGGING_NAME, "Synced invalid block: ", ToBase64(it->body.hash),
-                        " from: muddle://", ToBase64(address));
-        ++invalid;
-        break;
-      }
-    }
-    else
+  // skip the geneis block
+  if (block.body.previous_hash == GENESIS_DIGEST)
+  {
+    return;
+  }
+
+  // recompute the digest
+  block.UpdateDigest();
+
+  // add the block
+  if (block.proof())
+  {
+    auto const status = chain_.AddBlock(block);
+
+    switch (status)
     {
-      FETCH_LOG_DEBUG(LOGGING_NAME, "Synced bad proof block: ", ToBase64(it->body.hash),
+    case BlockStatus::ADDED:
+      FETCH_LOG_DEBUG(LOGGING_NAME, "Synced new block: ", ToBase64(block.body.hash),
+                      " from: muddle://", ToBase64(address));
+      ++summary.added;
+      break;
+    case BlockStatus::LOOSE:
+      FETCH_LOG_DEBUG(LOGGING_NAME, "Synced loose block: ", ToBase64(block.body.hash),
+                      " from: muddle://", ToBase64(address));
+      ++summary.loose;
+      break;
+    case BlockStatus::DUPLICATE:
+      FETCH_LOG_DEBUG(LOGGING_NAME, "Synced duplicate block: ", ToBase64(block.body.hash),
                       " from: muddle://", ToBase64(address));
-      ++invalid;
+      ++summary.duplicate;
+      break;
+    case BlockStatus::INVALID:
+      FETCH_LOG_DEBUG(LOGGING_NAME, "Synced invalid block: ", ToBase64(block.body.hash),
+                      " from: muddle://", ToBase64(address));
+      ++summary.invalid;
+      break;
     }
   }
+  else
+  {
+    FETCH_LOG_DEBUG(LOGGING_NAME, "Synced bad proof block: ", ToBase64(block.body.hash),
+                    " from: muddle://", ToBase64(address));
+    ++summary.invalid;
+  }
+}
 
-  if (invalid)
+void MainChainRpcService::LogSyncSummary(Address const &address, SyncSummary const &summary)
+{
+  if (summary.invalid)
   {
-    FETCH_LOG_WARN(LOGGING_NAME, "Synced Summary: Invalid: ", invalid, " Added: ", added,
-                   " Loose: ", loose, " Duplicate: ", duplicate, " from: muddle://",
-                   ToBase64(address));
+    FETCH_LOG_WARN(LOGGING_NAME, "Synced Summary: Invalid: ", summary.invalid,
+                   " Added: ", summary.added, " Loose: ", summary.loose,
+                   " Duplicate: ", summary.duplicate, " from: muddle://", ToBase64(address));
   }
   else
   {
-    FETCH_LOG_INFO(LOGGING_NAME, "Synced Summary: Added: ", added, " Loose: ", loose,
-                   " Duplicate: ", duplicate, " from: muddle://", ToBase64(address));
+    FETCH_LOG_INFO(LOGGING_NAME, "Synced Summary: Added: ", summary.added,
+                   " Loose: ", summary.loose, " Duplicate: ", summary.duplicate,
+                   " from: muddle://", ToBase64(address));
   }
 }
 
@@ -363,6 +740,34 @@ MainChainRpcService::State MainChainRpcService::OnSynchronising()
       return State::SYNCHRONISING;
     }
 
+    if (SyncMode::STREAMING == sync_mode_)
+    {
+      FETCH_LOG_INFO(LOGGING_NAME, "Requesting block stream from muddle://",
+                     ToBase64(current_peer_address_), " for block ",
+                     ToBase64(current_missing_block_));
+
+      StreamMessage request{};
+      request.type      = StreamMessage::Type::REQUEST;
+      request.start     = current_missing_block_;
+      request.last_seen = chain_.GetHeaviestBlockHash();
+      request.limit     = MAX_STREAM_SIZE;
+      request.credits   = STREAM_INITIAL_CREDITS;
+
+      {
+        FETCH_LOCK(inbound_lock_);
+
+        request.stream_id = next_stream_id_++;
+
+        inbound_stream_      = InboundStream{};
+        inbound_stream_.id   = request.stream_id;
+        inbound_stream_.peer = current_peer_address_;
+      }
+
+      SendStreamMessage(current_peer_address_, request);
+
+      return State::STREAMING;
+    }
+
     FETCH_LOG_INFO(LOGGING_NAME, "Requesting chain from muddle://", ToBase64(current_peer_address_),
                    " for block ", ToBase64(current_missing_block_));
 
@@ -413,6 +818,33 @@ MainChainRpcService::State MainChainRpcService::OnWaitingForResponse()
   return next_state;
 }
 
+MainChainRpcService::State MainChainRpcService::OnStreaming()
+{
+  State next_state{State::STREAMING};
+
+  FETCH_LOCK(inbound_lock_);
+
+  bool const timed_out = (Clock::now() - inbound_stream_.last_activity) > STREAM_TIMEOUT;
+
+  if (inbound_stream_.complete || timed_out)
+  {
+    if (!inbound_stream_.complete)
+    {
+      FETCH_LOG_INFO(LOGGING_NAME, "Block stream from: ", ToBase64(inbound_stream_.peer),
+                     " timed out after ", inbound_stream_.received, " blocks");
+    }
+
+    // clear the state
+    inbound_stream_        = InboundStream{};
+    current_peer_address_  = Address{};
+    current_missing_block_ = BlockHash{};
+
+    next_state = State::SYNCHRONISED;
+  }
+
+  return next_state;
+}
+
 MainChainRpcService::State MainChainRpcService::OnSynchronised(State current, State previous)
 {
   State next_state{State::SYNCHRONISED};
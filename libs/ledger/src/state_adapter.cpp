@@ -46,34 +46,24 @@ StateAdapter::StateAdapter(StorageInterface &storage, Identifier scope)
  */
 StateAdapter::Status StateAdapter::Read(std::string const &key, void *data, uint64_t &size)
 {
-  FETCH_LOG_DEBUG(LOGGING_NAME, "Read: ", key);
-
-  Status status{Status::ERROR};
-
-  auto new_key = WrapKeyWithScope(key);
-
-  // make the request to the storage engine
-  auto const result = storage_.Get(CreateAddress(new_key));
+  ConstByteArray value;
+  Status         status = ReadView(key, value);
 
-  // ensure the check was not found
-  if (!result.failed)
+  if (Status::OK == status)
   {
     // ensure the buffer is the correct size
-    if (size < result.document.size())
+    if (size < value.size())
     {
-      size   = result.document.size();
       status = Status::BUFFER_TOO_SMALL;
     }
     else  // normal case the buffer is fine
     {
       // copy the contents of the buffer into the output buffer
-      result.document.ReadBytes(reinterpret_cast<uint8_t *>(data), result.document.size());
-
-      // update the output size
-      size = result.document.size();
-
-      status = Status::OK;
+      value.ReadBytes(reinterpret_cast<uint8_t *>(data), value.size());
     }
+
+    // update the output size
+    size = value.size();
   }
 
   return status;
@@ -90,21 +80,9 @@ StateAdapter::Status StateAdapter::Read(std::string const &key, void *data, uint
  */
 StateAdapter::Status StateAdapter::Write(std::string const &key, void const *data, uint64_t size)
 {
-  FETCH_LOG_DEBUG(LOGGING_NAME, "Write: ", key, " size: ", size);
-
-  if (!enable_writes_)
-  {
-    return Status::OK;
-  }
-
-  auto new_key = WrapKeyWithScope(key);
-
   auto write_val = ConstByteArray{reinterpret_cast<uint8_t const *>(data), size};
 
-  // set the value on the storage engine
-  storage_.Set(CreateAddress(new_key), write_val);
-
-  return Status::OK;
+  return WriteView(key, write_val);
 }
 
 /**
@@ -133,6 +111,59 @@ StateAdapter::Status StateAdapter::Exists(std::string const &key)
   return status;
 }
 
+/**
+ * Get a view of a value in the state store, the value is shared with the storage engine rather
+ * than being copied
+ *
+ * @param key The key to be accessed
+ * @param value The view to be populated
+ * @return OK if the read was successful, PERMISSION_DENIED if the key is incorrect, otherwise ERROR
+ */
+StateAdapter::Status StateAdapter::ReadView(std::string const &key, ConstByteArray &value)
+{
+  FETCH_LOG_DEBUG(LOGGING_NAME, "Read: ", key);
+
+  auto new_key = WrapKeyWithScope(key);
+
+  // make the request to the storage engine
+  auto const result = storage_.Get(CreateAddress(new_key));
+
+  // ensure the check was not found
+  if (result.failed)
+  {
+    return Status::ERROR;
+  }
+
+  value = result.document;
+  return Status::OK;
+}
+
+/**
+ * Write a value to the state store, the storage engine keeps a reference to the buffer rather than
+ * copying it
+ *
+ * @param key The key to be accessed
+ * @param value The value to be written
+ * @return OK if the write was successful, PERMISSION_DENIED if the key is incorrect, otherwise
+ * ERROR
+ */
+StateAdapter::Status StateAdapter::WriteView(std::string const &key, ConstByteArray const &value)
+{
+  FETCH_LOG_DEBUG(LOGGING_NAME, "Write: ", key, " size: ", value.size());
+
+  if (!enable_writes_)
+  {
+    return Status::OK;
+  }
+
+  auto new_key = WrapKeyWithScope(key);
+
+  // set the value on the storage engine
+  storage_.Set(CreateAddress(new_key), value);
+
+  return Status::OK;
+}
+
 /**
  * Creates a scoped address from a string based key
  *
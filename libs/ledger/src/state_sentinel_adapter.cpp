@@ -53,77 +53,187 @@ StateSentinelAdapter::StateSentinelAdapter(StorageInterface &storage, Identifier
 #endif
   }
 
-  // Lock resources
-  for (auto const &full_resource : allowed_accesses_)
+  // Lock resources, with a single request to each lane involved
+  storage_.LockBulk(LockedAddresses());
+}
+
+StateSentinelAdapter::~StateSentinelAdapter()
+{
+  // any writes which have not been explicitly flushed are applied before the resources are unlocked
+  try
   {
-    storage_.Lock(CreateAddress(full_resource));
+    Flush();
   }
+  catch (std::exception const &ex)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to flush the buffered writes: ", ex.what());
+  }
+
+  storage_.UnlockBulk(LockedAddresses());
 }
 
-StateSentinelAdapter::~StateSentinelAdapter()
+/**
+ * Write all of the buffered values to the storage engine in a single batch
+ */
+void StateSentinelAdapter::Flush()
+{
+  KeyValues values{};
+
+  for (auto &element : accesses_)
+  {
+    auto &access = element.second;
+
+    if (access.dirty)
+    {
+      values.emplace_back(access.address, access.value);
+      access.dirty = false;
+    }
+  }
+
+  if (!values.empty())
+  {
+    storage_.SetBulk(values);
+  }
+}
+
+/**
+ * Build the addresses of all the resources which this adapter locks
+ *
+ * @return The addresses of the allowed resources
+ */
+StateSentinelAdapter::ResourceAddresses StateSentinelAdapter::LockedAddresses() const
 {
+  ResourceAddresses addresses;
+  addresses.reserve(allowed_accesses_.size());
+
   for (auto const &full_resource : allowed_accesses_)
   {
-    storage_.Unlock(CreateAddress(full_resource));
+    addresses.emplace_back(CreateAddress(full_resource));
+  }
+
+  return addresses;
+}
+
+/**
+ * Checks to see if the specified key exists in the database
+ *
+ * @param key The key to be checked
+ * @return OK if the key exists, PERMISSION_DENIED if the key is incorrect, ERROR is the key does
+ * not exist
+ */
+StateSentinelAdapter::Status StateSentinelAdapter::Exists(std::string const &key)
+{
+  auto access = LookupAccess(key);
+  if (!access)
+  {
+    return Status::PERMISSION_DENIED;
   }
+
+  Load(*access);
+
+  return access->exists ? Status::OK : Status::ERROR;
 }
 
 /**
- * Read a value from the state store
+ * Get a view of a value in the state store. Only the first read of a key is made from the storage
+ * engine, subsequent reads (and reads of values written by the transaction) are served locally.
  *
  * @param key The key to be accessed
- * @param data The pointer to the output buffer to be populated
- * @param size The size of the output buffer, if successful the size of the data will be written
- * back
+ * @param value The view to be populated
  * @return OK if the read was successful, PERMISSION_DENIED if the key is incorrect, otherwise ERROR
  */
-StateSentinelAdapter::Status StateSentinelAdapter::Read(std::string const &key, void *data,
-                                                        uint64_t &size)
+StateSentinelAdapter::Status StateSentinelAdapter::ReadView(std::string const &key,
+                                                            ConstByteArray &   value)
 {
-  if (!IsAllowedResource(WrapKeyWithScope(key)))
+  auto access = LookupAccess(key);
+  if (!access)
   {
     return Status::PERMISSION_DENIED;
   }
 
-  return StateAdapter::Read(key, data, size);
+  Load(*access);
+
+  if (!access->exists)
+  {
+    return Status::ERROR;
+  }
+
+  value = access->value;
+  return Status::OK;
 }
 
 /**
- * Write a value to the state store
+ * Write a value to the state store. The value is buffered until the adapter is flushed.
  *
  * @param key The key to be accessed
- * @param data The pointer to the input buffer for the data
- * @param size The size in bytes of the input buffer
+ * @param value The value to be written
  * @return OK if the write was successful, PERMISSION_DENIED if the key is incorrect, otherwise
  * ERROR
  */
-StateSentinelAdapter::Status StateSentinelAdapter::Write(std::string const &key, void const *data,
-                                                         uint64_t size)
+StateSentinelAdapter::Status StateSentinelAdapter::WriteView(std::string const &   key,
+                                                             ConstByteArray const &value)
 {
-  if (!IsAllowedResource(WrapKeyWithScope(key)))
+  auto access = LookupAccess(key);
+  if (!access)
   {
     FETCH_LOG_WARN(LOGGING_NAME, "Unable to write to resource: ", WrapKeyWithScope(key));
     return Status::PERMISSION_DENIED;
   }
 
-  return StateAdapter::Write(key, data, size);
+  access->value  = value;
+  access->loaded = true;
+  access->exists = true;
+  access->dirty  = true;
+
+  return Status::OK;
 }
 
 /**
- * Checks to see if the specified key exists in the database
+ * Lookup the state of a key, resolving it on the first access
  *
- * @param key The key to be checked
- * @return OK if the key exists, PERMISSION_DENIED if the key is incorrect, ERROR is the key does
- * not exist
+ * @param key The (unscoped) key to be accessed
+ * @return The state of the key, or nullptr if the key may not be accessed
  */
-StateSentinelAdapter::Status StateSentinelAdapter::Exists(std::string const &key)
+StateSentinelAdapter::Access *StateSentinelAdapter::LookupAccess(std::string const &key)
 {
-  if (!IsAllowedResource(WrapKeyWithScope(key)))
+  auto scoped_key = WrapKeyWithScope(key);
+
+  auto it = accesses_.find(scoped_key);
+  if (it == accesses_.end())
   {
-    return Status::PERMISSION_DENIED;
+    if (!IsAllowedResource(scoped_key))
+    {
+      return nullptr;
+    }
+
+    auto address = CreateAddress(scoped_key);
+    it = accesses_.emplace(std::move(scoped_key), Access{std::move(address)}).first;
+  }
+
+  return &it->second;
+}
+
+/**
+ * Retrieve the value of a key from the storage engine, unless it is already known
+ *
+ * @param access The state of the key
+ */
+void StateSentinelAdapter::Load(Access &access)
+{
+  if (access.loaded)
+  {
+    return;
   }
 
-  return StateAdapter::Exists(key);
+  auto const document = storage_.Get(access.address);
+
+  access.loaded = true;
+  access.exists = !document.failed;
+
+  if (access.exists)
+  {
+    access.value = document.document;
+  }
 }
 
 /**
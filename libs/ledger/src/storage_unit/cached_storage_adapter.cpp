@@ -18,6 +18,8 @@
 
 #include "ledger/storage_unit/cached_storage_adapter.hpp"
 
+#include <algorithm>
+
 namespace fetch {
 namespace ledger {
 
@@ -45,23 +47,92 @@ void CachedStorageAdapter::Flush()
 
   if (flush_required_)
   {
+    KeyValues values;
+
     for (auto &entry : cache_)
     {
       if (!entry.second.flushed)
       {
-        // set the value on the storage engine
-        storage_.Set(entry.first, entry.second.value);
+        values.emplace_back(entry.first, entry.second.value);
 
         // signal the entry as flushed
         entry.second.flushed = true;
       }
     }
 
+    // set all the values on the storage engine in a single batch
+    storage_.SetBulk(values);
+
     // reset the top level flush flag
     flush_required_ = false;
   }
 }
 
+/**
+ * Retrieve a set of resources from the storage engine in a single batch, so that subsequent reads
+ * are served from the cache. Typically called with the resources declared by a transaction.
+ *
+ * @param keys The keys of the resources to be fetched
+ */
+void CachedStorageAdapter::Prefetch(ResourceAddresses const &keys)
+{
+  ResourceAddresses missing;
+  missing.reserve(keys.size());
+
+  for (auto const &key : keys)
+  {
+    if (!HasCacheEntry(key))
+    {
+      missing.push_back(key);
+    }
+  }
+
+  if (missing.empty())
+  {
+    return;
+  }
+
+  auto const documents = storage_.GetBulk(missing);
+
+  FETCH_LOCK(lock_);
+  for (std::size_t i = 0, end = std::min(missing.size(), documents.size()); i < end; ++i)
+  {
+    // failed lookups are left to be retried on access
+    if (!documents[i].failed && (cache_.find(missing[i]) == cache_.end()))
+    {
+      // the value matches the storage engine, it does not need to be flushed
+      CacheEntry entry{documents[i].document};
+      entry.flushed = true;
+
+      cache_.emplace(missing[i], std::move(entry));
+    }
+  }
+}
+
+/**
+ * Populate the cache with values which have already been retrieved from the storage engine, for
+ * example by a prefetch stage which ran ahead of the execution. Entries already present in the
+ * cache take precedence.
+ *
+ * @param values The resource values which match the contents of the storage engine
+ */
+void CachedStorageAdapter::Prefill(KeyValues const &values)
+{
+  FETCH_LOCK(lock_);
+
+  for (auto const &value : values)
+  {
+    if (cache_.find(value.first) == cache_.end())
+    {
+      // the value matches the storage engine, it does not need to be flushed
+      CacheEntry entry{value.second};
+      entry.flushed = true;
+
+      cache_.emplace(value.first, std::move(entry));
+    }
+  }
+}
+
 /**
  * Get a resource from the storage engine or cache
  *
@@ -81,15 +152,12 @@ CachedStorageAdapter::Document CachedStorageAdapter::Get(ResourceAddress const &
   else
   {
     // not in the cache need to retrieve
-    auto const storage_result = storage_.Get(key);
+    result = storage_.Get(key);
 
+    // only successful lookups are cached
     if (!result.failed)
     {
-      // update the result
-      AddCacheEntry(key, storage_result.document);
-
-      // update the result
-      result = storage_result;
+      AddCacheEntry(key, result.document);
     }
   }
 
@@ -115,15 +183,12 @@ CachedStorageAdapter::Document CachedStorageAdapter::GetOrCreate(ResourceAddress
   else
   {
     // not in the cache need to retrieve
-    auto const storage_result = storage_.GetOrCreate(key);
+    result = storage_.GetOrCreate(key);
 
+    // only successful lookups are cached
     if (!result.failed)
     {
-      // update the result
-      AddCacheEntry(key, storage_result.document);
-
-      // update the result
-      result = storage_result;
+      AddCacheEntry(key, result.document);
     }
   }
 
@@ -166,6 +231,30 @@ bool CachedStorageAdapter::Unlock(ResourceAddress const &key)
   return storage_.Unlock(key);
 }
 
+/**
+ * Lock a set of resources on the storage engine
+ *
+ * @param keys The keys of the resources to be locked
+ * @return true if all the resources were locked, otherwise false
+ */
+bool CachedStorageAdapter::LockBulk(ResourceAddresses const &keys)
+{
+  // proxy this call directly to the underlying storage engine
+  return storage_.LockBulk(keys);
+}
+
+/**
+ * Unlock a set of resources on the storage engine
+ *
+ * @param keys The keys of the resources to be unlocked
+ * @return true if all the resources were unlocked, otherwise false
+ */
+bool CachedStorageAdapter::UnlockBulk(ResourceAddresses const &keys)
+{
+  // proxy this call directly to the underlying storage engine
+  return storage_.UnlockBulk(keys);
+}
+
 /**
  * Add an entry to the cache
  *
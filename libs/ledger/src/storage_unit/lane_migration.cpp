@@ -0,0 +1,91 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/storage_unit/lane_migration.hpp"
+#include "core/logger.hpp"
+#include "ledger/chain/transaction_serialization.hpp"
+#include "storage/resource_mapper.hpp"
+#include "storage/state_snapshot.hpp"
+
+namespace fetch {
+namespace ledger {
+namespace {
+
+constexpr char const *LOGGING_NAME      = "LaneMigration";
+constexpr std::size_t ENTRIES_PER_CHUNK = 1024;
+
+}  // namespace
+
+/**
+ * Copy the state and the transactions of a lane which belong to another lane, once the number of
+ * lanes has changed. When a lane is split, the part of its key space which now maps to the new lane
+ * is copied into it. When lanes are merged, the whole of the retired lane is copied into the lane
+ * which takes over its keys.
+ *
+ * The source lane must have no uncommitted changes. The state is merged into the uncommitted
+ * changes of the target lane, so becomes part of the state of the target once it is next committed.
+ * The objects copied are left in the source lane, since the stores have no means of removing them.
+ *
+ * @param source The lane the objects are copied from
+ * @param target The lane the objects are copied into
+ * @param log2_num_lanes The log2 of the new number of lanes
+ * @return The report of the migration
+ */
+LaneMigrationReport MigrateLane(LocalLane const &source, LocalLane const &target,
+                                uint32_t log2_num_lanes)
+{
+  LaneMigrationReport report{};
+
+  auto const filter = [&target, log2_num_lanes](storage::ResourceID const &rid) {
+    return rid.lane(log2_num_lanes) == target.lane;
+  };
+
+  // the state is taken from the last commit of the source lane
+  storage::StateSnapshot snapshot;
+  if (!source.state_db->CreateSnapshot(source.state_db->CurrentHash(), ENTRIES_PER_CHUNK, snapshot,
+                                       filter))
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to snapshot lane ", source.lane, " for lane ",
+                   target.lane);
+    return report;
+  }
+
+  for (auto const &chunk : snapshot.chunks)
+  {
+    if (!target.state_db->MergeSnapshotChunk(chunk))
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Unable to merge the state of lane ", source.lane,
+                     " into lane ", target.lane);
+      return report;
+    }
+
+    report.state_entries += chunk.entries.size();
+  }
+
+  report.transactions = source.tx_store->CopyTo(*target.tx_store, filter);
+  report.success      = true;
+
+  FETCH_LOG_INFO(LOGGING_NAME, "Migrated ", report.state_entries, " state entries and ",
+                 report.transactions, " transactions from lane ", source.lane, " to lane ",
+                 target.lane);
+
+  return report;
+}
+
+}  // namespace ledger
+}  // namespace fetch
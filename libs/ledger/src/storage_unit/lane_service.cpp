@@ -23,9 +23,11 @@
 #include "ledger/storage_unit/lane_controller_protocol.hpp"
 #include "ledger/storage_unit/lane_identity.hpp"
 #include "ledger/storage_unit/lane_identity_protocol.hpp"
+#include "ledger/storage_unit/state_snapshot_protocol.hpp"
 #include "ledger/storage_unit/transaction_store_sync_protocol.hpp"
 #include "ledger/storage_unit/transaction_store_sync_service.hpp"
 #include "network/muddle/muddle.hpp"
+#include "network/muddle/rpc/client.hpp"
 #include "network/muddle/rpc/server.hpp"
 #include "storage/document_store_protocol.hpp"
 #include "storage/new_revertible_document_store.hpp"
@@ -56,6 +58,15 @@ LaneService::LaneService(NetworkManager nm, ShardConfig config, bool sign_packet
   external_rpc_server_ =
       std::make_shared<Server>(external_muddle_->AsEndpoint(), SERVICE_LANE, CHANNEL_RPC);
 
+  // amortise the cost of the packet signatures over bursts of small messages
+  if (sign_packets)
+  {
+    external_muddle_->SetBatchWindow(muddle::Router::DEFAULT_BATCH_WINDOW_MS);
+  }
+
+  // transaction sync with remote peers is bulk traffic, which compresses well
+  external_muddle_->SetCompression(cfg_.external_compression);
+
   // Internal muddle network
   internal_muddle_ = std::make_shared<Muddle>(cfg_.internal_network_id, cfg_.internal_identity, nm);
   internal_rpc_server_ =
@@ -99,12 +110,22 @@ LaneService::LaneService(NetworkManager nm, ShardConfig config, bool sign_packet
   sync_cfg.promise_wait_timeout       = cfg_.sync_service_promise_timeout;
   sync_cfg.fetch_object_wait_duration = cfg_.sync_service_fetch_period;
 
+  if (cfg_.sync_service_pipelined)
+  {
+    sync_cfg.sync_mode = TransactionStoreSyncService::SyncMode::PIPELINED;
+  }
+
+  sync_cfg.reconcile_recent = cfg_.sync_service_reconcile;
+  sync_cfg.verified_cache   = cfg_.verified_cache;
+
   tx_sync_service_ =
       std::make_shared<TransactionStoreSyncService>(sync_cfg, external_muddle_, tx_store_);
 
   tx_store_->SetCallback([this](VerifiedTransaction const &tx) { tx_sync_protocol_->OnNewTx(tx); });
 
   tx_sync_service_->SetTrimCacheCallback([this]() { tx_sync_protocol_->TrimCache(); });
+  tx_sync_service_->SetRecentSketchCallback(
+      [this]() { return tx_sync_protocol_->RecentSketch(); });
 
   // TX Sync protocol
   external_rpc_server_->Add(RPC_TX_STORE_SYNC, tx_sync_protocol_.get());
@@ -123,10 +144,21 @@ LaneService::LaneService(NetworkManager nm, ShardConfig config, bool sign_packet
     break;
   }
 
+  // speculative execution of blocks is made on forks of the state
+  state_db_->EnableForks(cfg_.state_forks);
+
   state_db_protocol_ =
       std::make_shared<StateDbProto>(state_db_.get(), cfg_.lane_id, cfg_.num_lanes);
   internal_rpc_server_->Add(RPC_STATE, state_db_protocol_.get());
 
+  // State snapshots, served to the other lane peers
+  snapshot_protocol_ = std::make_shared<StateSnapshotProtocol>(*state_db_);
+  external_rpc_server_->Add(RPC_STATE_SNAPSHOT, snapshot_protocol_.get());
+
+  snapshot_client_ =
+      std::make_shared<Client>("R:Snapshot-L" + std::to_string(cfg_.lane_id),
+                               external_muddle_->AsEndpoint(), Address(), SERVICE_LANE, CHANNEL_RPC);
+
   FETCH_LOG_INFO(LOGGING_NAME, "Lane ", cfg_.lane_id, " Initialised.");
 
   reactor_.Start();
@@ -147,6 +179,9 @@ LaneService::~LaneService()
   lane_identity_protocol_.reset();
   lane_identity_.reset();
 
+  snapshot_client_.reset();
+  snapshot_protocol_.reset();
+
   // TODO(issue 24): Remove protocol
   state_db_protocol_.reset();
   state_db_.reset();
@@ -198,5 +233,80 @@ bool LaneService::SyncIsReady()
   return tx_sync_service_->IsReady();
 }
 
+/**
+ * Get the stores of the lane, for clients running in the same process to call directly
+ *
+ * @return The stores of the lane
+ */
+LocalLane LaneService::AsLocalLane() const
+{
+  LocalLane local{};
+  local.lane              = cfg_.lane_id;
+  local.state_db          = state_db_;
+  local.state_db_protocol = state_db_protocol_;
+  local.tx_store          = tx_store_;
+
+  return local;
+}
+
+/**
+ * Replace the state of the lane with a snapshot of the specified state, streamed from a peer
+ *
+ * @param peer The address of the peer (on the lane network) serving the snapshot
+ * @param state_hash The hash of the requested state
+ * @return true if the state was successfully restored, otherwise false
+ */
+bool LaneService::SyncStateSnapshot(Address const &peer, Hash const &state_hash)
+{
+  using Manifest = StateSnapshotProtocol::Manifest;
+  using Chunk    = StateSnapshotProtocol::Chunk;
+
+  try
+  {
+    // request the manifest for the snapshot
+    auto promise = snapshot_client_->CallSpecificAddress(
+        peer, RPC_STATE_SNAPSHOT, StateSnapshotProtocol::GET_MANIFEST, state_hash);
+
+    Manifest manifest{};
+    if (!promise->Wait(SNAPSHOT_TIMEOUT_MS) || !promise->As(manifest) ||
+        (manifest.state_hash != state_hash) || !state_db_->BeginSnapshotRestore(manifest))
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Lane ", cfg_.lane_id, ": Snapshot not available from peer");
+      return false;
+    }
+
+    // stream through each of the chunks
+    for (uint64_t index = 0; index < manifest.num_chunks; ++index)
+    {
+      promise = snapshot_client_->CallSpecificAddress(
+          peer, RPC_STATE_SNAPSHOT, StateSnapshotProtocol::GET_CHUNK, state_hash, index);
+
+      Chunk chunk{};
+      if (!promise->Wait(SNAPSHOT_TIMEOUT_MS) || !promise->As(chunk) ||
+          !state_db_->RestoreSnapshotChunk(chunk))
+      {
+        FETCH_LOG_WARN(LOGGING_NAME, "Lane ", cfg_.lane_id, ": Failed to restore snapshot chunk ",
+                       index, " of ", manifest.num_chunks);
+        break;
+      }
+    }
+  }
+  catch (std::exception const &ex)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Lane ", cfg_.lane_id, ": Snapshot sync failed: ", ex.what());
+  }
+
+  // validates that the complete state was restored
+  bool const success = state_db_->CompleteSnapshotRestore();
+
+  if (success)
+  {
+    FETCH_LOG_INFO(LOGGING_NAME, "Lane ", cfg_.lane_id,
+                   ": Restored state from snapshot: 0x", state_hash.ToHex());
+  }
+
+  return success;
+}
+
 }  // namespace ledger
 }  // namespace fetch
@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/storage_unit/request_window.hpp"
+
+#include <algorithm>
+
+namespace fetch {
+namespace ledger {
+
+constexpr std::size_t RequestWindow::QUEUING_FACTOR;
+
+/**
+ * Construct a request window
+ *
+ * @param initial The initial number of requests allowed in flight
+ * @param maximum The maximum number of requests allowed in flight
+ */
+RequestWindow::RequestWindow(std::size_t initial, std::size_t maximum)
+  : window_{std::max<std::size_t>(std::min(initial, maximum), 1)}
+  , maximum_{std::max<std::size_t>(maximum, 1)}
+{}
+
+/**
+ * Determine if another request can be sent to the peer
+ *
+ * @return true if the window is not full, otherwise false
+ */
+bool RequestWindow::CanSend() const
+{
+  return in_flight_ < window_;
+}
+
+/**
+ * Record that a request has been sent to the peer
+ */
+void RequestWindow::OnSent()
+{
+  ++in_flight_;
+}
+
+/**
+ * Record the response to a request, adapting the window to the round trip time
+ *
+ * @param rtt The time between the request being sent and the response being received
+ */
+void RequestWindow::OnResponse(Duration const &rtt)
+{
+  OnCompleted();
+
+  min_rtt_ = std::min(min_rtt_, rtt);
+
+  // exponentially weighted moving average, with a weight of 1/8 for the new sample
+  if (smoothed_rtt_ == Duration::zero())
+  {
+    smoothed_rtt_ = rtt;
+  }
+  else
+  {
+    smoothed_rtt_ = ((smoothed_rtt_ * 7) + rtt) / 8;
+  }
+
+  if (smoothed_rtt_ <= (min_rtt_ * static_cast<Duration::rep>(QUEUING_FACTOR)))
+  {
+    window_ = std::min(window_ + 1, maximum_);
+  }
+  else if (window_ > 1)
+  {
+    --window_;
+  }
+}
+
+/**
+ * Record the failure (or time out) of a request
+ */
+void RequestWindow::OnFailure()
+{
+  OnCompleted();
+
+  window_ = std::max<std::size_t>(window_ / 2, 1);
+}
+
+std::size_t RequestWindow::window() const
+{
+  return window_;
+}
+
+std::size_t RequestWindow::in_flight() const
+{
+  return in_flight_;
+}
+
+RequestWindow::Duration RequestWindow::smoothed_rtt() const
+{
+  return smoothed_rtt_;
+}
+
+void RequestWindow::OnCompleted()
+{
+  if (in_flight_ > 0)
+  {
+    --in_flight_;
+  }
+}
+
+}  // namespace ledger
+}  // namespace fetch
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "ledger/storage_unit/state_snapshot_protocol.hpp"
+#include "core/byte_array/encoders.hpp"
+#include "core/logger.hpp"
+#include "core/serializers/exception.hpp"
+#include "storage/new_revertible_document_store.hpp"
+
+namespace fetch {
+namespace ledger {
+
+constexpr std::size_t StateSnapshotProtocol::ENTRIES_PER_CHUNK;
+
+/**
+ * Construct the snapshot protocol for a state database
+ *
+ * @param state_db The state database to be served
+ */
+StateSnapshotProtocol::StateSnapshotProtocol(StateDb &state_db)
+  : state_db_(state_db)
+{
+  this->Expose(GET_MANIFEST, this, &StateSnapshotProtocol::GetManifest);
+  this->Expose(GET_CHUNK, this, &StateSnapshotProtocol::GetChunk);
+}
+
+/**
+ * Get the manifest for the snapshot of a given state. The snapshot is built on the first request
+ * and retained until a snapshot of a different state is requested.
+ *
+ * @param hash The hash of the requested state
+ * @return The manifest, empty if the snapshot is not available
+ */
+StateSnapshotProtocol::Manifest StateSnapshotProtocol::GetManifest(Hash const &hash)
+{
+  FETCH_LOCK(lock_);
+
+  if (snapshot_.manifest.state_hash != hash)
+  {
+    storage::StateSnapshot snapshot;
+    if (!state_db_.CreateSnapshot(hash, ENTRIES_PER_CHUNK, snapshot))
+    {
+      FETCH_LOG_INFO(LOGGING_NAME, "Unable to provide snapshot for state: 0x", hash.ToHex());
+      return {};
+    }
+
+    FETCH_LOG_INFO(LOGGING_NAME, "Created snapshot for state: 0x", hash.ToHex(),
+                   " entries: ", snapshot.manifest.num_entries,
+                   " chunks: ", snapshot.manifest.num_chunks);
+
+    snapshot_ = std::move(snapshot);
+  }
+
+  return snapshot_.manifest;
+}
+
+/**
+ * Get a chunk of a snapshot, the manifest must have been requested first
+ *
+ * @param hash The hash of the requested state
+ * @param index The index of the chunk
+ * @return The requested chunk
+ */
+StateSnapshotProtocol::Chunk StateSnapshotProtocol::GetChunk(Hash const &hash, uint64_t index)
+{
+  FETCH_LOCK(lock_);
+
+  if ((snapshot_.manifest.state_hash != hash) || (index >= snapshot_.chunks.size()))
+  {
+    throw serializers::SerializableException(  // TODO(issue 11): set exception number
+        0, byte_array::ConstByteArray("Requested snapshot chunk is not available"));
+  }
+
+  return snapshot_.chunks[index];
+}
+
+}  // namespace ledger
+}  // namespace fetch
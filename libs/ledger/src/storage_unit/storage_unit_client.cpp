@@ -19,6 +19,9 @@
 #include "ledger/storage_unit/storage_unit_client.hpp"
 #include "ledger/chain/constants.hpp"
 #include "ledger/chain/transaction_serialization.hpp"
+#include "ledger/storage_unit/lane_migration.hpp"
+
+#include <future>
 
 using fetch::storage::ResourceID;
 using fetch::storage::RevertibleDocumentStoreProtocol;
@@ -55,8 +58,11 @@ StorageUnitClient::StorageUnitClient(MuddleEndpoint &muddle, ShardConfigs const
   , log2_num_lanes_(log2_num_lanes)
   , rpc_client_("STUC", muddle, MuddleEndpoint::Address{}, SERVICE_LANE_CTRL, CHANNEL_RPC)
   , current_merkle_{num_lanes()}
+  , dirty_lanes_(num_lanes(), true)
 {
-  if (num_lanes() != shards.size())
+  // the shards are the lanes provisioned, of which the first num_lanes() are in use
+  bool const power_of_two = (shards.size() & (shards.size() - 1)) == 0;
+  if ((num_lanes() > shards.size()) || !power_of_two)
   {
     throw std::logic_error("Incorrect number of shard configs");
   }
@@ -66,32 +72,250 @@ StorageUnitClient::StorageUnitClient(MuddleEndpoint &muddle, ShardConfigs const
                  "After recovery, size of merkle stack is: ", permanent_state_merkle_stack_.size());
 }
 
+/**
+ * Call the lanes which run in this process directly, rather than serialising the requests to them
+ * over the internal muddle. Must be called before the client is used.
+ *
+ * @param lanes The stores of the local lanes
+ * @param identity The identity of this client on the internal muddle, used by the lanes to identify
+ *                 the holder of each resource lock
+ */
+void StorageUnitClient::AttachLocalLanes(LocalLanes const &lanes, Address const &identity)
+{
+  local_lanes_.assign(addresses_.size(), LocalLane{});
+
+  for (auto const &lane : lanes)
+  {
+    local_lanes_.at(lane.lane) = lane;
+  }
+
+  local_context_.sender_address = identity;
+
+  FETCH_LOG_INFO(LOGGING_NAME, "Calling ", lanes.size(), " of ", addresses_.size(),
+                 " lanes in process");
+}
+
+/**
+ * Change the number of lanes in use, splitting or merging lanes. The state and transactions which
+ * change lane are migrated with a thread for each lane receiving them, once they have all completed
+ * the routing switches to the new lanes. Must only be called at a block boundary, once the state
+ * has been committed and before any further execution. The merged state becomes part of the state
+ * of the lanes at the next commit.
+ *
+ * All the lanes involved must run in this process, and the new number of lanes must not be more
+ * than the number provisioned. States committed before the change can no longer be reverted to.
+ *
+ * @param log2_num_lanes The log2 of the new number of lanes
+ * @return true if successful, otherwise false
+ */
+bool StorageUnitClient::Reshard(uint32_t log2_num_lanes)
+{
+  using Move  = std::pair<LaneIndex, LaneIndex>;  ///< source and target lanes
+  using Moves = std::vector<Move>;
+
+  uint32_t const old_lanes = num_lanes();
+  uint32_t const new_lanes = 1u << log2_num_lanes;
+
+  if (new_lanes == old_lanes)
+  {
+    return true;
+  }
+
+  if (new_lanes > addresses_.size())
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to reshard to ", new_lanes, " lanes, only ",
+                   addresses_.size(), " are provisioned");
+    return false;
+  }
+
+  // a split fills each new lane from the lane which holds its keys, a merge empties each retired
+  // lane into the lane which takes over its keys
+  Moves moves;
+  if (new_lanes > old_lanes)
+  {
+    for (LaneIndex lane = old_lanes; lane < new_lanes; ++lane)
+    {
+      moves.emplace_back(lane & (old_lanes - 1), lane);
+    }
+  }
+  else
+  {
+    for (LaneIndex lane = new_lanes; lane < old_lanes; ++lane)
+    {
+      moves.emplace_back(lane, lane & (new_lanes - 1));
+    }
+  }
+
+  FETCH_LOCK(merkle_mutex_);
+
+  if (!fork_bases_.empty())
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to reshard while executing on a fork");
+    return false;
+  }
+
+  {
+    FETCH_LOCK(dirty_mutex_);
+
+    for (auto const &move : moves)
+    {
+      if ((LookupLocal(move.first) == nullptr) || (LookupLocal(move.second) == nullptr))
+      {
+        FETCH_LOG_WARN(LOGGING_NAME, "Unable to reshard, lanes ", move.first, " and ",
+                       move.second, " must both run in process");
+        return false;
+      }
+
+      // the lanes in use must have been committed, the others are untouched since their last use
+      for (auto const lane : {move.first, move.second})
+      {
+        if ((lane < old_lanes) && (!lane_roots_valid_ || dirty_lanes_[lane]))
+        {
+          FETCH_LOG_WARN(LOGGING_NAME, "Unable to reshard, lane ", lane, " has not been committed");
+          return false;
+        }
+      }
+    }
+  }
+
+  // record the state of the targets, so that a failed migration can be undone
+  Hashes target_states;
+  for (auto const &move : moves)
+  {
+    target_states.push_back(LookupLocal(move.second)->state_db->CurrentHash());
+  }
+
+  std::vector<std::future<LaneMigrationReport>> migrations;
+  for (auto const &move : moves)
+  {
+    migrations.emplace_back(std::async(std::launch::async, [this, move, log2_num_lanes]() {
+      return MigrateLane(*LookupLocal(move.first), *LookupLocal(move.second), log2_num_lanes);
+    }));
+  }
+
+  bool success{true};
+  for (auto &migration : migrations)
+  {
+    success &= migration.get().success;
+  }
+
+  if (!success)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to reshard to ", new_lanes, " lanes, restoring lanes");
+
+    for (std::size_t i = 0; i < moves.size(); ++i)
+    {
+      LookupLocal(moves[i].second)->state_db->RevertToHash(target_states[i]);
+    }
+
+    return false;
+  }
+
+  // switch the routing, every lane in use is committed as part of the next block
+  log2_num_lanes_       = log2_num_lanes;
+  current_merkle_       = MerkleTree{new_lanes};
+  lane_roots_valid_     = false;
+  merkle_levels_cached_ = false;
+
+  {
+    FETCH_LOCK(dirty_mutex_);
+    dirty_lanes_.assign(new_lanes, true);
+  }
+
+  // catch up with the transactions which arrived at the source lanes during the migration
+  for (auto const &move : moves)
+  {
+    LocalLane const &target = *LookupLocal(move.second);
+
+    LookupLocal(move.first)->tx_store->CopyCachedTo(
+        *target.tx_store, [&target, log2_num_lanes](storage::ResourceID const &rid) {
+          return rid.lane(log2_num_lanes) == target.lane;
+        });
+  }
+
+  FETCH_LOG_INFO(LOGGING_NAME, "Resharded from ", old_lanes, " to ", new_lanes, " lanes");
+
+  return true;
+}
+
 // Get the current hash of the world state (merkle tree root)
 byte_array::ConstByteArray StorageUnitClient::CurrentHash()
 {
-  MerkleTree                    tree{num_lanes()};
-  std::vector<service::Promise> promises;
+  LaneFlags dirty{};
+  {
+    FETCH_LOCK(dirty_mutex_);
+    dirty = dirty_lanes_;
+  }
+
+  MerkleTree tree{num_lanes()};
+  bool       incremental{false};
 
-  for (uint32_t i = 0; i < num_lanes(); ++i)
+  // the lanes which have not been modified since their last commit (or revert) are still in the
+  // state recorded in the current merkle tree, only the other lanes need to be queried
   {
-    auto promise = rpc_client_.CallSpecificAddress(LookupAddress(i), RPC_STATE,
-                                                   RevertibleDocumentStoreProtocol::CURRENT_HASH);
+    FETCH_LOCK(merkle_mutex_);
 
-    promises.push_back(promise);
+    if (lane_roots_valid_)
+    {
+      tree        = current_merkle_;
+      incremental = merkle_levels_cached_;
+    }
+    else
+    {
+      std::fill(dirty.begin(), dirty.end(), true);
+    }
   }
 
-  std::size_t index = 0;
-  for (auto &p : promises)
+  std::vector<std::pair<LaneIndex, Promise>> promises;
+  std::vector<LaneIndex>                     local_lanes;
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
   {
-    FETCH_LOG_PROMISE();
-    tree[index] = p->As<byte_array::ByteArray>();
+    if (!dirty[lane])
+    {
+      continue;
+    }
+
+    if (LookupLocal(lane) != nullptr)
+    {
+      local_lanes.push_back(lane);
+    }
+    else
+    {
+      promises.emplace_back(lane, rpc_client_.CallSpecificAddress(
+                                      LookupAddress(lane), RPC_STATE,
+                                      RevertibleDocumentStoreProtocol::CURRENT_HASH));
+    }
+  }
+
+  auto const update_leaf = [&tree, incremental](LaneIndex lane, Hash const &lane_hash) {
+    FETCH_LOG_DEBUG(LOGGING_NAME, "Merkle Hash ", lane, ": ", ToBase64(lane_hash));
 
-    FETCH_LOG_DEBUG(LOGGING_NAME, "Merkle Hash ", index, ": ", ToBase64(tree[index]));
+    if (incremental)
+    {
+      tree.UpdateLeaf(lane, lane_hash);
+    }
+    else
+    {
+      tree[lane] = lane_hash;
+    }
+  };
 
-    ++index;
+  // the local lanes are queried while the requests to the remote lanes are in flight
+  for (auto const lane : local_lanes)
+  {
+    update_leaf(lane, LookupLocal(lane)->state_db->CurrentHash());
+  }
+
+  for (auto &p : promises)
+  {
+    FETCH_LOG_PROMISE();
+    update_leaf(p.first, p.second->As<byte_array::ByteArray>());
   }
 
-  tree.CalculateRoot();
+  if (!incremental)
+  {
+    tree.CalculateRoot();
+  }
 
   FETCH_LOG_DEBUG(LOGGING_NAME, "Merkle Final Hash: ", ToBase64(tree.root()));
 
@@ -138,7 +362,7 @@ bool StorageUnitClient::RevertToHash(Hash const &hash, uint64_t index)
     }
 
     permanent_state_merkle_stack_.New(MERKLE_FILENAME);  // clear the stack
-    permanent_state_merkle_stack_.Push(MerkleTreeBlock{tree});
+    permanent_state_merkle_stack_.Push(MerkleTreeBlock{current_merkle_});
   }
   else
   {
@@ -163,41 +387,56 @@ bool StorageUnitClient::RevertToHash(Hash const &hash, uint64_t index)
       return false;
     }
 
+    if (tree.size() != num_lanes())
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Unable to revert to a state from before the lanes changed");
+      return false;
+    }
+
     FETCH_LOG_DEBUG(LOGGING_NAME, "Successfully found merkle at: ", index);
   }  // End set merkle stack
 
+  assert(!hash.empty());
+
   // Note: we shouldn't be touching the lanes at this point from other threads
-  std::vector<service::Promise> promises;
+  std::vector<std::pair<LaneIndex, Promise>> promises;
   promises.reserve(num_lanes());
 
-  // Now perform the revert
-  StorageUnitClient::LaneIndex lane_index{0};
-  for (auto const &lane_merkle_hash : tree)
+  // Now perform the revert, making the calls to the remote lanes first
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
   {
-    assert(!hash.empty());
+    if (LookupLocal(lane) == nullptr)
+    {
+      promises.emplace_back(lane, rpc_client_.CallSpecificAddress(
+                                      LookupAddress(lane), RPC_STATE,
+                                      RevertibleDocumentStoreProtocol::REVERT_TO_HASH, tree[lane]));
+    }
+  }
+
+  bool       all_success{true};
+  auto const check_revert = [&all_success, &tree](LaneIndex lane, bool success) {
+    if (!success)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Failed to revert shard ", lane, " to ", tree[lane].ToHex());
 
-    // make the call to the RPC server
-    auto promise = rpc_client_.CallSpecificAddress(LookupAddress(lane_index++), RPC_STATE,
-                                                   RevertibleDocumentStoreProtocol::REVERT_TO_HASH,
-                                                   lane_merkle_hash);
+      all_success = false;
+    }
+  };
 
-    // add the promise to the queue
-    promises.emplace_back(std::move(promise));
+  // the local lanes are reverted while the requests to the remote lanes are in flight
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+  {
+    LocalLane const *local = LookupLocal(lane);
+    if (local != nullptr)
+    {
+      check_revert(lane, local->state_db->RevertToHash(tree[lane]));
+    }
   }
 
-  lane_index = 0;
-  bool all_success{true};
   for (auto &p : promises)
   {
     FETCH_LOG_PROMISE();
-
-    if (!p->As<bool>())
-    {
-      FETCH_LOG_WARN(LOGGING_NAME, "Failed to revert shard ", lane_index, " to ",
-                     tree[lane_index].ToHex());
-
-      all_success &= false;
-    }
+    check_revert(p.first, p.second->As<bool>());
   }
 
   if (all_success)
@@ -211,7 +450,17 @@ bool StorageUnitClient::RevertToHash(Hash const &hash, uint64_t index)
     permanent_state_merkle_stack_.Flush(false);
 
     // since the state has now been restored we can update the current merkle reference
-    current_merkle_ = tree;
+    current_merkle_       = tree;
+    merkle_levels_cached_ = false;
+
+    // all the lanes are now in the state of their leaf in the tree. The genesis leaves are only
+    // placeholders, so in this case the lanes are all queried at the next commit
+    TakeDirtyLanes();
+    lane_roots_valid_ = !genesis_state;
+  }
+  else
+  {
+    lane_roots_valid_ = false;
   }
 
   return all_success;
@@ -222,38 +471,78 @@ byte_array::ConstByteArray StorageUnitClient::Commit(uint64_t commit_index)
 {
   FETCH_LOG_DEBUG(LOGGING_NAME, "Committing: ", commit_index);
 
-  MerkleTree tree{num_lanes()};
+  FETCH_LOCK(merkle_mutex_);
 
-  std::vector<service::Promise> promises;
+  // only the lanes which have been modified since their last commit need to be committed, the
+  // others are still in the state recorded in their leaf of the tree
+  LaneFlags dirty = TakeDirtyLanes();
+  if (!lane_roots_valid_)
+  {
+    std::fill(dirty.begin(), dirty.end(), true);
+  }
+
+  // should any of the commits fail the leaves of the tree can no longer be trusted
+  lane_roots_valid_ = false;
+
+  std::vector<std::pair<LaneIndex, Promise>> promises;
+  std::vector<LaneIndex>                     local_lanes;
   promises.reserve(num_lanes());
 
-  for (uint32_t lane_idx = 0; lane_idx < num_lanes(); ++lane_idx)
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
   {
-    // make the request to the RPC server
-    auto promise = rpc_client_.CallSpecificAddress(LookupAddress(lane_idx), RPC_STATE,
-                                                   RevertibleDocumentStoreProtocol::COMMIT);
+    if (!dirty[lane])
+    {
+      continue;
+    }
+
+    if (LookupLocal(lane) != nullptr)
+    {
+      local_lanes.push_back(lane);
+    }
+    else
+    {
+      // make the request to the RPC server
+      promises.emplace_back(lane, rpc_client_.CallSpecificAddress(
+                                      LookupAddress(lane), RPC_STATE,
+                                      RevertibleDocumentStoreProtocol::COMMIT));
+    }
+  }
+
+  auto const update_leaf = [this](LaneIndex lane, Hash const &lane_hash) {
+    if (merkle_levels_cached_)
+    {
+      current_merkle_.UpdateLeaf(lane, lane_hash);
+    }
+    else
+    {
+      current_merkle_[lane] = lane_hash;
+    }
+  };
 
-    // add the promise to the waiting queue
-    promises.push_back(promise);
+  // all the remote commits are in flight, commit the local lanes in the meantime
+  for (auto const lane : local_lanes)
+  {
+    update_leaf(lane, LookupLocal(lane)->state_db->Commit());
   }
 
-  std::size_t index = 0;
+  // update the tree as each of the remote commits completes
   for (auto &p : promises)
   {
     FETCH_LOG_PROMISE();
-    tree[index] = p->As<byte_array::ByteArray>();
+    update_leaf(p.first, p.second->As<byte_array::ByteArray>());
+  }
 
-    ++index;
+  if (!merkle_levels_cached_)
+  {
+    current_merkle_.CalculateRoot();
+    merkle_levels_cached_ = true;
   }
 
-  tree.CalculateRoot();
+  lane_roots_valid_ = true;
 
-  auto const tree_root = tree.root();
+  auto const tree_root = current_merkle_.root();
 
   {
-    FETCH_LOCK(merkle_mutex_);
-    current_merkle_ = tree;
-
     if (permanent_state_merkle_stack_.size() != commit_index)
     {
       FETCH_LOG_WARN(LOGGING_NAME,
@@ -265,138 +554,467 @@ byte_array::ConstByteArray StorageUnitClient::Commit(uint64_t commit_index)
       permanent_state_merkle_stack_.Push(MerkleTreeBlock{});
     }
 
-    permanent_state_merkle_stack_.Set(commit_index, MerkleTreeBlock{tree});
+    permanent_state_merkle_stack_.Set(commit_index, MerkleTreeBlock{current_merkle_});
     permanent_state_merkle_stack_.Flush(false);
   }
 
   return tree_root;
 }
 
-bool StorageUnitClient::HashExists(Hash const &hash, uint64_t index)
-{
-  // FETCH_LOCK(merkle_mutex_);
-  return HashInStack(hash, index);
-}
-
-// Search backwards through stack
-// TODO(HUT): should be const correct
-bool StorageUnitClient::HashInStack(Hash const &hash, uint64_t index)
+/**
+ * Start executing on a fork of a previous state, on all the lanes
+ *
+ * @param hash The merkle hash of the state to fork from
+ * @param index The block index of the state
+ * @return true if successful, otherwise false
+ */
+bool StorageUnitClient::BeginFork(Hash const &hash, uint64_t index)
 {
-  MerkleTreeBlock proxy;
   FETCH_LOCK(merkle_mutex_);
-  uint64_t const merkle_stack_size = permanent_state_merkle_stack_.size();
 
-  if (index >= merkle_stack_size)
+  fork_bases_.clear();
+
+  // lookup the state of each of the lanes
+  if ((hash == GENESIS_MERKLE_ROOT) || (index >= permanent_state_merkle_stack_.size()))
   {
-    FETCH_LOG_WARN(LOGGING_NAME, "Tried to find hash in merkle tree when index more than stack: ",
-                   merkle_stack_size, " index: ", index);
     return false;
   }
 
-  permanent_state_merkle_stack_.Get(index, proxy);
-  MerkleTree deser = proxy.Extract(num_lanes());
+  MerkleTreeBlock merkle_block;
+  permanent_state_merkle_stack_.Get(index, merkle_block);
 
-  if (deser.root() == hash)
+  MerkleTree tree{num_lanes()};
+  tree = merkle_block.Extract(num_lanes());
+
+  if (tree.root() != hash)
   {
-    return true;
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to fork, index given for merkle hash didn't match stack");
+    return false;
   }
 
-  return false;
-}
-
-StorageUnitClient::Address const &StorageUnitClient::LookupAddress(LaneIndex lane) const
-{
-  return addresses_.at(lane);
-}
+  if (tree.size() != num_lanes())
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to fork from a state from before the lanes changed");
+    return false;
+  }
 
-StorageUnitClient::Address const &StorageUnitClient::LookupAddress(
-    storage::ResourceID const &resource) const
-{
-  return LookupAddress(resource.lane(log2_num_lanes_));
-}
+  std::vector<Promise> promises;
+  promises.reserve(num_lanes());
 
-void StorageUnitClient::AddTransaction(VerifiedTransaction const &tx)
-{
-  try
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
   {
-    ResourceID resource{tx.digest()};
+    if (LookupLocal(lane) == nullptr)
+    {
+      promises.emplace_back(rpc_client_.CallSpecificAddress(
+          LookupAddress(lane), RPC_STATE, RevertibleDocumentStoreProtocol::BEGIN_FORK,
+          tree[lane]));
+    }
+  }
 
-    // make the RPC request
-    auto promise = rpc_client_.CallSpecificAddress(LookupAddress(resource), RPC_TX_STORE,
-                                                   TxStoreProtocol::SET, resource, tx);
+  bool success{true};
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+  {
+    LocalLane const *local = LookupLocal(lane);
+    if (local != nullptr)
+    {
+      success &= local->state_db->BeginFork(tree[lane]);
+    }
+  }
 
-    // wait the for the response
+  for (auto &p : promises)
+  {
     FETCH_LOG_PROMISE();
-    promise->Wait();
+    success &= p->As<bool>();
   }
-  catch (std::exception const &ex)
+
+  if (success)
   {
-    FETCH_LOG_WARN(LOGGING_NAME, "Unable to add transaction: ", ex.what());
+    fork_bases_.assign(tree.begin(), tree.end());
   }
+  else
+  {
+    // the lanes which were able to fork must not remain on the fork
+    CallAllLanes(RevertibleDocumentStoreProtocol::DISCARD_FORK,
+                 [](LocalLane::StateDb &state_db) { state_db.DiscardFork(); });
+  }
+
+  return success;
 }
 
-void StorageUnitClient::AddTransactions(TransactionList const &txs)
+/**
+ * Stop executing on the fork, on all the lanes. The changes made on the fork are kept.
+ */
+void StorageUnitClient::EndFork()
 {
-  std::vector<TxStoreProtocol::ElementList> transaction_lists(num_lanes());
+  CallAllLanes(RevertibleDocumentStoreProtocol::END_FORK,
+               [](LocalLane::StateDb &state_db) { state_db.EndFork(); });
+}
 
-  for (auto const &tx : txs)
-  {
-    // determine the lane for this given transaction
-    ResourceID      resource{tx.digest()};
-    LaneIndex const lane = resource.lane(log2_num_lanes_);
+/**
+ * Apply the changes made on the fork on top of the current state, which must have been reverted
+ * to the state the fork was made from
+ *
+ * @return true if successful, otherwise false
+ */
+bool StorageUnitClient::ApplyFork()
+{
+  FETCH_LOCK(merkle_mutex_);
 
-    // add it to the correct list
-    transaction_lists.at(lane).push_back({resource, tx});
+  if (fork_bases_.size() != num_lanes())
+  {
+    return false;
   }
 
   std::vector<Promise> promises;
   promises.reserve(num_lanes());
 
-  // dispatch all the set requests off
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
   {
-    LaneIndex lane{0};
-    for (auto const &list : transaction_lists)
+    if (LookupLocal(lane) == nullptr)
     {
-      if (!list.empty())
-      {
-        promises.emplace_back(rpc_client_.CallSpecificAddress(LookupAddress(lane), RPC_TX_STORE,
-                                                              TxStoreProtocol::SET_BULK, list));
-      }
-
-      ++lane;
+      promises.emplace_back(rpc_client_.CallSpecificAddress(
+          LookupAddress(lane), RPC_STATE, RevertibleDocumentStoreProtocol::APPLY_FORK,
+          fork_bases_[lane]));
     }
   }
 
-  // wait for all the requests to complete
-  for (auto &promise : promises)
+  bool success{true};
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
   {
-    promise->Wait();
+    LocalLane const *local = LookupLocal(lane);
+    if (local != nullptr)
+    {
+      success &= local->state_db->ApplyFork(fork_bases_[lane]);
+    }
   }
-}
-
-StorageUnitClient::TxSummaries StorageUnitClient::PollRecentTx(uint32_t max_to_poll)
-{
-  std::vector<service::Promise> promises;
-  TxSummaries                   new_txs;
-
-  FETCH_LOG_DEBUG(LOGGING_NAME, "Polling recent transactions from lanes");
 
-  // Assume that the lanes are roughly balanced in terms of new TXs
-  for (auto const &lane_address : addresses_)
+  for (auto &p : promises)
   {
-    auto promise =
-        rpc_client_.CallSpecificAddress(lane_address, RPC_TX_STORE, TxStoreProtocol::GET_RECENT,
-                                        uint32_t(max_to_poll / addresses_.size()));
     FETCH_LOG_PROMISE();
-    promises.push_back(promise);
+    success &= p->As<bool>();
   }
 
-  for (auto const &promise : promises)
+  if (success)
   {
-    auto txs = promise->As<TxSummaries>();
+    // every lane has uncommitted changes from the fork
+    for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+    {
+      MarkDirty(lane);
+    }
+  }
+  else
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to apply the fork, restoring the lane states");
+
+    // the lanes which were able to apply the fork must be restored
+    promises.clear();
+    for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+    {
+      LocalLane const *local = LookupLocal(lane);
+      if (local != nullptr)
+      {
+        local->state_db->RevertToHash(fork_bases_[lane]);
+      }
+      else
+      {
+        promises.emplace_back(rpc_client_.CallSpecificAddress(
+            LookupAddress(lane), RPC_STATE, RevertibleDocumentStoreProtocol::REVERT_TO_HASH,
+            fork_bases_[lane]));
+      }
+    }
+
+    for (auto &p : promises)
+    {
+      FETCH_LOG_PROMISE();
+      p->Wait();
+    }
+  }
+
+  fork_bases_.clear();
+
+  return success;
+}
+
+/**
+ * Drop the fork and the changes made on it, on all the lanes
+ */
+void StorageUnitClient::DiscardFork()
+{
+  {
+    FETCH_LOCK(merkle_mutex_);
+    fork_bases_.clear();
+  }
+
+  CallAllLanes(RevertibleDocumentStoreProtocol::DISCARD_FORK,
+               [](LocalLane::StateDb &state_db) { state_db.DiscardFork(); });
+}
+
+/**
+ * Make the same (argument free) call to all the lanes, waiting for all of them to complete
+ *
+ * @param function The function to be called on the remote lanes
+ * @param local_call The equivalent call made on the local lanes
+ */
+void StorageUnitClient::CallAllLanes(service::function_handler_type function,
+                                     LocalCall const &              local_call)
+{
+  std::vector<Promise> promises;
+  promises.reserve(num_lanes());
+
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+  {
+    if (LookupLocal(lane) == nullptr)
+    {
+      promises.emplace_back(
+          rpc_client_.CallSpecificAddress(LookupAddress(lane), RPC_STATE, function));
+    }
+  }
+
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+  {
+    LocalLane const *local = LookupLocal(lane);
+    if (local != nullptr)
+    {
+      try
+      {
+        local_call(*local->state_db);
+      }
+      catch (std::runtime_error const &e)
+      {
+        FETCH_LOG_WARN(LOGGING_NAME, "Failed to call lane function ", function, ", because: ",
+                       e.what());
+      }
+    }
+  }
+
+  for (auto &p : promises)
+  {
+    try
+    {
+      FETCH_LOG_PROMISE();
+      p->Wait();
+    }
+    catch (std::runtime_error const &e)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Failed to call lane function ", function, ", because: ",
+                     e.what());
+    }
+  }
+}
+
+/**
+ * Record that the state of a lane has (potentially) been modified since its last commit
+ *
+ * @param lane The index of the lane
+ */
+void StorageUnitClient::MarkDirty(LaneIndex lane)
+{
+  FETCH_LOCK(dirty_mutex_);
+  dirty_lanes_.at(lane) = true;
+}
+
+void StorageUnitClient::MarkDirty(ResourceAddress const &key)
+{
+  MarkDirty(key.as_resource_id().lane(log2_num_lanes_));
+}
+
+/**
+ * Get the set of modified lanes, marking all the lanes as unmodified
+ *
+ * @return The flags of the lanes modified since their last commit or revert
+ */
+StorageUnitClient::LaneFlags StorageUnitClient::TakeDirtyLanes()
+{
+  LaneFlags dirty(num_lanes(), false);
+
+  FETCH_LOCK(dirty_mutex_);
+  std::swap(dirty, dirty_lanes_);
+
+  return dirty;
+}
+
+bool StorageUnitClient::HashExists(Hash const &hash, uint64_t index)
+{
+  // FETCH_LOCK(merkle_mutex_);
+  return HashInStack(hash, index);
+}
+
+// Search backwards through stack
+// TODO(HUT): should be const correct
+bool StorageUnitClient::HashInStack(Hash const &hash, uint64_t index)
+{
+  MerkleTreeBlock proxy;
+  FETCH_LOCK(merkle_mutex_);
+  uint64_t const merkle_stack_size = permanent_state_merkle_stack_.size();
+
+  if (index >= merkle_stack_size)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Tried to find hash in merkle tree when index more than stack: ",
+                   merkle_stack_size, " index: ", index);
+    return false;
+  }
+
+  permanent_state_merkle_stack_.Get(index, proxy);
+  MerkleTree deser = proxy.Extract(num_lanes());
+
+  if (deser.root() == hash)
+  {
+    return true;
+  }
+
+  return false;
+}
+
+StorageUnitClient::Address const &StorageUnitClient::LookupAddress(LaneIndex lane) const
+{
+  return addresses_.at(lane);
+}
+
+StorageUnitClient::Address const &StorageUnitClient::LookupAddress(
+    storage::ResourceID const &resource) const
+{
+  return LookupAddress(resource.lane(log2_num_lanes_));
+}
+
+/**
+ * Lookup the stores of a lane which runs in this process
+ *
+ * @param lane The index of the lane
+ * @return The stores of the lane, or nullptr if the lane is remote
+ */
+LocalLane const *StorageUnitClient::LookupLocal(LaneIndex lane) const
+{
+  if ((lane < local_lanes_.size()) && local_lanes_[lane].state_db)
+  {
+    return &local_lanes_[lane];
+  }
+
+  return nullptr;
+}
+
+LocalLane const *StorageUnitClient::LookupLocal(storage::ResourceID const &resource) const
+{
+  return LookupLocal(resource.lane(log2_num_lanes_));
+}
+
+void StorageUnitClient::AddTransaction(VerifiedTransaction const &tx)
+{
+  try
+  {
+    ResourceID resource{tx.digest()};
+
+    LocalLane const *local = LookupLocal(resource);
+    if (local != nullptr)
+    {
+      local->tx_store->Set(resource, tx, false);
+    }
+    else
+    {
+      // make the RPC request
+      auto promise = rpc_client_.CallSpecificAddress(LookupAddress(resource), RPC_TX_STORE,
+                                                     TxStoreProtocol::SET, resource, tx);
+
+      // wait the for the response
+      FETCH_LOG_PROMISE();
+      promise->Wait();
+    }
+  }
+  catch (std::exception const &ex)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to add transaction: ", ex.what());
+  }
+}
+
+void StorageUnitClient::AddTransactions(TransactionList const &txs)
+{
+  std::vector<TxStoreProtocol::ElementList> transaction_lists(num_lanes());
+
+  for (auto const &tx : txs)
+  {
+    // determine the lane for this given transaction
+    ResourceID      resource{tx.digest()};
+    LaneIndex const lane = resource.lane(log2_num_lanes_);
+
+    // add it to the correct list
+    transaction_lists.at(lane).push_back({resource, tx});
+  }
+
+  std::vector<Promise> promises;
+  promises.reserve(num_lanes());
+
+  // dispatch all the set requests off
+  {
+    LaneIndex lane{0};
+    for (auto const &list : transaction_lists)
+    {
+      if (!list.empty() && (LookupLocal(lane) == nullptr))
+      {
+        promises.emplace_back(rpc_client_.CallSpecificAddress(LookupAddress(lane), RPC_TX_STORE,
+                                                              TxStoreProtocol::SET_BULK, list));
+      }
+
+      ++lane;
+    }
+  }
+
+  // store the transactions of the local lanes while the remote requests are in flight
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+  {
+    LocalLane const *local = LookupLocal(lane);
+    if (local != nullptr)
+    {
+      for (auto const &element : transaction_lists[lane])
+      {
+        local->tx_store->Set(element.key, element.value, false);
+      }
+    }
+  }
+
+  // wait for all the requests to complete
+  for (auto &promise : promises)
+  {
+    promise->Wait();
+  }
+}
 
+StorageUnitClient::TxSummaries StorageUnitClient::PollRecentTx(uint32_t max_to_poll)
+{
+  std::vector<service::Promise> promises;
+  TxSummaries                   new_txs;
+
+  FETCH_LOG_DEBUG(LOGGING_NAME, "Polling recent transactions from lanes");
+
+  // Assume that the lanes are roughly balanced in terms of new TXs
+  auto const max_per_lane = uint32_t(max_to_poll / num_lanes());
+
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+  {
+    if (LookupLocal(lane) == nullptr)
+    {
+      auto promise = rpc_client_.CallSpecificAddress(LookupAddress(lane), RPC_TX_STORE,
+                                                     TxStoreProtocol::GET_RECENT, max_per_lane);
+      FETCH_LOG_PROMISE();
+      promises.push_back(promise);
+    }
+  }
+
+  auto const append = [&new_txs](TxSummaries txs) {
     new_txs.insert(new_txs.end(), std::make_move_iterator(txs.begin()),
                    std::make_move_iterator(txs.end()));
+  };
+
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+  {
+    LocalLane const *local = LookupLocal(lane);
+    if (local != nullptr)
+    {
+      append(local->tx_store->GetRecent(max_per_lane));
+    }
+  }
+
+  for (auto const &promise : promises)
+  {
+    append(promise->As<TxSummaries>());
   }
 
   return new_txs;
@@ -410,12 +1028,26 @@ bool StorageUnitClient::GetTransaction(byte_array::ConstByteArray const &digest,
   {
     ResourceID resource{digest};
 
-    // make the request to the RPC server
-    auto promise = rpc_client_.CallSpecificAddress(LookupAddress(resource), RPC_TX_STORE,
-                                                   TxStoreProtocol::GET, resource);
+    LocalLane const *local = LookupLocal(resource);
+    if (local != nullptr)
+    {
+      if (!local->tx_store->Get(resource, tx))
+      {
+        throw std::runtime_error("Unable to lookup transaction in local lane");
+      }
 
-    // wait for the response to be delivered
-    tx = promise->As<VerifiedTransaction>();
+      // once a transaction has been retrieved from the core it is persisted to disk
+      local->tx_store->Confirm(resource);
+    }
+    else
+    {
+      // make the request to the RPC server
+      auto promise = rpc_client_.CallSpecificAddress(LookupAddress(resource), RPC_TX_STORE,
+                                                     TxStoreProtocol::GET, resource);
+
+      // wait for the response to be delivered
+      tx = promise->As<VerifiedTransaction>();
+    }
 
     success = true;
   }
@@ -435,12 +1067,20 @@ bool StorageUnitClient::HasTransaction(ConstByteArray const &digest)
   {
     ResourceID resource{digest};
 
-    // make the request to the RPC server
-    auto promise = rpc_client_.CallSpecificAddress(LookupAddress(resource), RPC_TX_STORE,
-                                                   TxStoreProtocol::HAS, resource);
+    LocalLane const *local = LookupLocal(resource);
+    if (local != nullptr)
+    {
+      present = local->tx_store->Has(resource);
+    }
+    else
+    {
+      // make the request to the RPC server
+      auto promise = rpc_client_.CallSpecificAddress(LookupAddress(resource), RPC_TX_STORE,
+                                                     TxStoreProtocol::HAS, resource);
 
-    // wait for the response to be delivered
-    present = promise->As<bool>();
+      // wait for the response to be delivered
+      present = promise->As<bool>();
+    }
 
     FETCH_LOG_DEBUG(LOGGING_NAME, "TX: ", ToBase64(digest), " Present: ", present);
   }
@@ -453,19 +1093,108 @@ bool StorageUnitClient::HasTransaction(ConstByteArray const &digest)
   return present;
 }
 
+/**
+ * Determine which of a set of transactions are not present, issuing a single request to each of
+ * the lanes involved. All the requests are in flight at the same time. Should a lane fail to
+ * respond, all of its transactions are reported as missing.
+ *
+ * @param digests The digests of the transactions to be checked
+ * @return The digests of the missing transactions
+ */
+StorageUnitClient::TxDigests StorageUnitClient::GetMissingTransactions(TxDigests const &digests)
+{
+  using ResourceIDs = TxStoreProtocol::ResourceIDs;
+
+  uint32_t const log2_num_lanes = log2_num_lanes_;
+
+  // group the requests by lane
+  std::vector<ResourceIDs> requests(num_lanes());
+  for (auto const &digest : digests)
+  {
+    ResourceID resource{digest};
+    requests.at(resource.lane(log2_num_lanes)).push_back(std::move(resource));
+  }
+
+  // dispatch all the requests to the remote lanes
+  std::vector<std::pair<LaneIndex, Promise>> promises;
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+  {
+    if (!requests[lane].empty() && (LookupLocal(lane) == nullptr))
+    {
+      promises.emplace_back(lane, rpc_client_.CallSpecificAddress(LookupAddress(lane), RPC_TX_STORE,
+                                                                  TxStoreProtocol::GET_MISSING,
+                                                                  requests[lane]));
+    }
+  }
+
+  TxDigests missing{};
+
+  // check the local lanes while the remote requests are in flight
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+  {
+    LocalLane const *local = LookupLocal(lane);
+    if (local == nullptr)
+    {
+      continue;
+    }
+
+    for (auto const &resource : requests[lane])
+    {
+      if (!local->tx_store->Has(resource))
+      {
+        missing.push_back(resource.id());
+      }
+    }
+  }
+
+  // collect the responses
+  for (auto &promise : promises)
+  {
+    try
+    {
+      for (auto const &resource : promise.second->As<ResourceIDs>())
+      {
+        missing.push_back(resource.id());
+      }
+    }
+    catch (std::exception const &e)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Unable to check transaction existence, because: ", e.what(),
+                     " lane: ", promise.first);
+
+      for (auto const &resource : requests[promise.first])
+      {
+        missing.push_back(resource.id());
+      }
+    }
+  }
+
+  return missing;
+}
+
 StorageUnitClient::Document StorageUnitClient::GetOrCreate(ResourceAddress const &key)
 {
   Document doc;
 
+  MarkDirty(key);
+
   try
   {
-    // make the request to the RPC client
-    auto promise = rpc_client_.CallSpecificAddress(LookupAddress(key), RPC_STATE,
-                                                   RevertibleDocumentStoreProtocol::GET_OR_CREATE,
-                                                   key.as_resource_id());
+    LocalLane const *local = LookupLocal(key);
+    if (local != nullptr)
+    {
+      doc = local->state_db->GetOrCreate(key.as_resource_id());
+    }
+    else
+    {
+      // make the request to the RPC client
+      auto promise = rpc_client_.CallSpecificAddress(
+          LookupAddress(key), RPC_STATE, RevertibleDocumentStoreProtocol::GET_OR_CREATE,
+          key.as_resource_id());
 
-    // wait for the document to be returned
-    doc = promise->As<Document>();
+      // wait for the document to be returned
+      doc = promise->As<Document>();
+    }
   }
   catch (std::runtime_error const &e)
   {
@@ -482,13 +1211,21 @@ StorageUnitClient::Document StorageUnitClient::Get(ResourceAddress const &key)
 
   try
   {
-    // make the request to the RPC server
-    auto promise = rpc_client_.CallSpecificAddress(
-        LookupAddress(key), RPC_STATE, fetch::storage::RevertibleDocumentStoreProtocol::GET,
-        key.as_resource_id());
+    LocalLane const *local = LookupLocal(key);
+    if (local != nullptr)
+    {
+      doc = local->state_db->Get(key.as_resource_id());
+    }
+    else
+    {
+      // make the request to the RPC server
+      auto promise = rpc_client_.CallSpecificAddress(
+          LookupAddress(key), RPC_STATE, fetch::storage::RevertibleDocumentStoreProtocol::GET,
+          key.as_resource_id());
 
-    // wait for the document response
-    doc = promise->As<Document>();
+      // wait for the document response
+      doc = promise->As<Document>();
+    }
   }
   catch (std::runtime_error const &e)
   {
@@ -503,18 +1240,27 @@ StorageUnitClient::Document StorageUnitClient::Get(ResourceAddress const &key)
 
 void StorageUnitClient::Set(ResourceAddress const &key, StateValue const &value)
 {
+  MarkDirty(key);
 
   try
   {
-    // make the request to the RPC server
-    auto promise = rpc_client_.CallSpecificAddress(
-        LookupAddress(key), RPC_STATE, fetch::storage::RevertibleDocumentStoreProtocol::SET,
-        key.as_resource_id(), value);
+    LocalLane const *local = LookupLocal(key);
+    if (local != nullptr)
+    {
+      local->state_db->Set(key.as_resource_id(), value);
+    }
+    else
+    {
+      // make the request to the RPC server
+      auto promise = rpc_client_.CallSpecificAddress(
+          LookupAddress(key), RPC_STATE, fetch::storage::RevertibleDocumentStoreProtocol::SET,
+          key.as_resource_id(), value);
 
-    FETCH_LOG_PROMISE();
+      FETCH_LOG_PROMISE();
 
-    // wait for the response
-    promise->Wait();
+      // wait for the response
+      promise->Wait();
+    }
   }
   catch (std::runtime_error const &e)
   {
@@ -522,18 +1268,286 @@ void StorageUnitClient::Set(ResourceAddress const &key, StateValue const &value)
   }
 }
 
+/**
+ * Lookup a batch of documents, issuing a single request to each of the lanes involved
+ *
+ * @param keys The keys to be looked up
+ * @return The documents, in the same order as the keys
+ */
+StorageUnitClient::Documents StorageUnitClient::GetBulk(ResourceAddresses const &keys)
+{
+  using ResourceIDs = RevertibleDocumentStoreProtocol::ResourceIDs;
+  using Positions   = std::vector<std::size_t>;
+
+  Documents documents(keys.size());
+
+  // group the requests by lane
+  std::vector<ResourceIDs> requests(num_lanes());
+  std::vector<Positions>   positions(num_lanes());
+
+  for (std::size_t i = 0; i < keys.size(); ++i)
+  {
+    ResourceID const resource = keys[i].as_resource_id();
+    LaneIndex const  lane     = resource.lane(log2_num_lanes_);
+
+    requests.at(lane).push_back(resource);
+    positions.at(lane).push_back(i);
+  }
+
+  // dispatch all the requests to the remote lanes
+  std::vector<std::pair<LaneIndex, Promise>> promises;
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+  {
+    if (!requests[lane].empty() && (LookupLocal(lane) == nullptr))
+    {
+      promises.emplace_back(lane, rpc_client_.CallSpecificAddress(
+                                      LookupAddress(lane), RPC_STATE,
+                                      RevertibleDocumentStoreProtocol::GET_BULK, requests[lane]));
+    }
+  }
+
+  // lookup the documents of the local lanes while the remote requests are in flight
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+  {
+    LocalLane const *local = LookupLocal(lane);
+    if (local == nullptr)
+    {
+      continue;
+    }
+
+    auto const &lane_positions = positions[lane];
+
+    try
+    {
+      for (std::size_t i = 0; i < lane_positions.size(); ++i)
+      {
+        documents[lane_positions[i]] = local->state_db->Get(requests[lane][i]);
+      }
+    }
+    catch (std::runtime_error const &e)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Unable to get documents, because: ", e.what());
+
+      // signal the failures
+      for (auto const position : lane_positions)
+      {
+        documents[position].failed = true;
+      }
+    }
+  }
+
+  // collect the responses
+  for (auto &promise : promises)
+  {
+    auto const &lane_positions = positions[promise.first];
+
+    try
+    {
+      auto const lane_documents = promise.second->As<Documents>();
+
+      if (lane_documents.size() != lane_positions.size())
+      {
+        throw std::runtime_error("Incorrect number of documents returned");
+      }
+
+      for (std::size_t i = 0; i < lane_positions.size(); ++i)
+      {
+        documents[lane_positions[i]] = lane_documents[i];
+      }
+    }
+    catch (std::runtime_error const &e)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Unable to get documents, because: ", e.what());
+
+      // signal the failures
+      for (auto const position : lane_positions)
+      {
+        documents[position].failed = true;
+      }
+    }
+  }
+
+  return documents;
+}
+
+/**
+ * Set a batch of values, issuing a single request to each of the lanes involved
+ *
+ * @param values The keys and values to be set
+ */
+void StorageUnitClient::SetBulk(KeyValues const &values)
+{
+  using LaneKeyValues = RevertibleDocumentStoreProtocol::KeyValues;
+
+  // group the requests by lane
+  std::vector<LaneKeyValues> requests(num_lanes());
+  for (auto const &value : values)
+  {
+    ResourceID const resource = value.first.as_resource_id();
+    LaneIndex const  lane     = resource.lane(log2_num_lanes_);
+
+    requests.at(lane).emplace_back(resource, value.second);
+  }
+
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+  {
+    if (!requests[lane].empty())
+    {
+      MarkDirty(lane);
+    }
+  }
+
+  // dispatch all the requests to the remote lanes
+  std::vector<Promise> promises;
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+  {
+    if (!requests[lane].empty() && (LookupLocal(lane) == nullptr))
+    {
+      promises.emplace_back(rpc_client_.CallSpecificAddress(
+          LookupAddress(lane), RPC_STATE, RevertibleDocumentStoreProtocol::SET_BULK,
+          requests[lane]));
+    }
+  }
+
+  // update the local lanes while the remote requests are in flight
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+  {
+    LocalLane const *local = LookupLocal(lane);
+    if (local == nullptr)
+    {
+      continue;
+    }
+
+    try
+    {
+      for (auto const &value : requests[lane])
+      {
+        local->state_db->Set(value.first, value.second);
+      }
+    }
+    catch (std::runtime_error const &e)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Failed to store documents, because: ", e.what());
+    }
+  }
+
+  // wait for all the requests to complete
+  for (auto &promise : promises)
+  {
+    try
+    {
+      promise->Wait();
+    }
+    catch (std::runtime_error const &e)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Failed to call SET_BULK (store documents), because: ",
+                     e.what());
+    }
+  }
+}
+
+/**
+ * Lock a set of resources, issuing a single request to each of the lanes involved. All the
+ * requests are in flight at the same time and are awaited together.
+ *
+ * @param keys The keys of the resources to be locked
+ * @return true if all the resources were locked, otherwise false
+ */
+bool StorageUnitClient::LockBulk(ResourceAddresses const &keys)
+{
+  return CallLockBulk(keys, true);
+}
+
+/**
+ * Unlock a set of resources, issuing a single request to each of the lanes involved
+ *
+ * @param keys The keys of the resources to be unlocked
+ * @return true if all the resources were unlocked, otherwise false
+ */
+bool StorageUnitClient::UnlockBulk(ResourceAddresses const &keys)
+{
+  return CallLockBulk(keys, false);
+}
+
+bool StorageUnitClient::CallLockBulk(ResourceAddresses const &keys, bool lock)
+{
+  using ResourceIDs = RevertibleDocumentStoreProtocol::ResourceIDs;
+
+  auto const function = lock ? RevertibleDocumentStoreProtocol::LOCK_BULK
+                             : RevertibleDocumentStoreProtocol::UNLOCK_BULK;
+
+  // group the requests by lane
+  std::vector<ResourceIDs> requests(num_lanes());
+  for (auto const &key : keys)
+  {
+    ResourceID const resource = key.as_resource_id();
+
+    requests.at(resource.lane(log2_num_lanes_)).push_back(resource);
+  }
+
+  // dispatch all the requests to the remote lanes
+  std::vector<Promise> promises;
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+  {
+    if (!requests[lane].empty() && (LookupLocal(lane) == nullptr))
+    {
+      promises.emplace_back(rpc_client_.CallSpecificAddress(LookupAddress(lane), RPC_STATE,
+                                                            function, requests[lane]));
+    }
+  }
+
+  // the local lanes are (un)locked while the remote requests are in flight
+  bool success{true};
+  for (LaneIndex lane = 0; lane < num_lanes(); ++lane)
+  {
+    LocalLane const *local = LookupLocal(lane);
+    if ((local != nullptr) && !requests[lane].empty())
+    {
+      auto &protocol = *local->state_db_protocol;
+
+      success &= lock ? protocol.LockBulk(&local_context_, requests[lane])
+                      : protocol.UnlockBulk(&local_context_, requests[lane]);
+    }
+  }
+
+  // wait for all the requests to complete
+  for (auto &promise : promises)
+  {
+    try
+    {
+      success &= promise->As<bool>();
+    }
+    catch (std::runtime_error const &e)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Failed to call bulk (un)lock, because: ", e.what());
+      success = false;
+    }
+  }
+
+  return success;
+}
+
 bool StorageUnitClient::Lock(ResourceAddress const &key)
 {
   bool success{false};
 
   try
   {
-    // make the request to the RPC server
-    auto promise = rpc_client_.CallSpecificAddress(
-        LookupAddress(key), RPC_STATE, RevertibleDocumentStoreProtocol::LOCK, key.as_resource_id());
+    LocalLane const *local = LookupLocal(key);
+    if (local != nullptr)
+    {
+      success = local->state_db_protocol->LockResource(&local_context_, key.as_resource_id());
+    }
+    else
+    {
+      // make the request to the RPC server
+      auto promise = rpc_client_.CallSpecificAddress(LookupAddress(key), RPC_STATE,
+                                                     RevertibleDocumentStoreProtocol::LOCK,
+                                                     key.as_resource_id());
 
-    // wait for the promise
-    success = promise->As<bool>();
+      // wait for the promise
+      success = promise->As<bool>();
+    }
   }
   catch (std::runtime_error const &e)
   {
@@ -549,13 +1563,21 @@ bool StorageUnitClient::Unlock(ResourceAddress const &key)
 
   try
   {
-    // make the request to the RPC server
-    auto promise = rpc_client_.CallSpecificAddress(LookupAddress(key), RPC_STATE,
-                                                   RevertibleDocumentStoreProtocol::UNLOCK,
-                                                   key.as_resource_id());
+    LocalLane const *local = LookupLocal(key);
+    if (local != nullptr)
+    {
+      success = local->state_db_protocol->UnlockResource(&local_context_, key.as_resource_id());
+    }
+    else
+    {
+      // make the request to the RPC server
+      auto promise = rpc_client_.CallSpecificAddress(LookupAddress(key), RPC_STATE,
+                                                     RevertibleDocumentStoreProtocol::UNLOCK,
+                                                     key.as_resource_id());
 
-    // wait for the result
-    success = promise->As<bool>();
+      // wait for the result
+      success = promise->As<bool>();
+    }
   }
   catch (std::runtime_error const &e)
   {
@@ -0,0 +1,210 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/storage_unit/transaction_sketch.hpp"
+
+#include <algorithm>
+
+namespace fetch {
+namespace ledger {
+namespace {
+
+constexpr uint64_t CHECK_SEED = 0xc2b2ae3d27d4eb4fULL;
+
+/**
+ * Mix the bits of a short id with a seed (the splitmix64 finaliser)
+ */
+uint64_t Mix(uint64_t value, uint64_t seed)
+{
+  value += seed + 0x9e3779b97f4a7c15ULL;
+  value = (value ^ (value >> 30u)) * 0xbf58476d1ce4e5b9ULL;
+  value = (value ^ (value >> 27u)) * 0x94d049bb133111ebULL;
+  return value ^ (value >> 31u);
+}
+
+/**
+ * Determine the index of the cell for the specified hash function. Each hash function has its own
+ * partition of the cells, so that a short id never lands twice in the same cell.
+ */
+std::size_t CellIndex(uint64_t id, std::size_t hash, std::size_t partition)
+{
+  return (hash * partition) + static_cast<std::size_t>(Mix(id, hash) % partition);
+}
+
+bool IsPure(TransactionSketch::Cell const &cell)
+{
+  return ((cell.count == 1) || (cell.count == -1)) &&
+         (cell.hash_sum == Mix(cell.id_sum, CHECK_SEED));
+}
+
+bool IsZero(TransactionSketch::Cell const &cell)
+{
+  return (cell.count == 0) && (cell.id_sum == 0) && (cell.hash_sum == 0);
+}
+
+}  // namespace
+
+constexpr std::size_t TransactionSketch::NUM_HASHES;
+
+/**
+ * Construct an empty sketch
+ *
+ * @param num_cells The number of cells, rounded up to a multiple of the number of hashes
+ */
+TransactionSketch::TransactionSketch(std::size_t num_cells)
+  : cells_(((num_cells + NUM_HASHES - 1) / NUM_HASHES) * NUM_HASHES)
+{}
+
+/**
+ * Add a short id to the sketch
+ *
+ * @param id The short id to be added
+ */
+void TransactionSketch::Insert(ShortId id)
+{
+  Update(id, 1);
+}
+
+/**
+ * Remove a short id from the sketch
+ *
+ * @param id The short id to be removed
+ */
+void TransactionSketch::Erase(ShortId id)
+{
+  Update(id, -1);
+}
+
+/**
+ * Subtract another sketch from this one, leaving the sketch of the difference of the two sets
+ *
+ * @param other The sketch to be subtracted
+ * @return true if successful, false if the sketches are of different sizes
+ */
+bool TransactionSketch::Subtract(TransactionSketch const &other)
+{
+  if (other.cells_.size() != cells_.size())
+  {
+    return false;
+  }
+
+  for (std::size_t i = 0; i < cells_.size(); ++i)
+  {
+    cells_[i].count -= other.cells_[i].count;
+    cells_[i].id_sum ^= other.cells_[i].id_sum;
+    cells_[i].hash_sum ^= other.cells_[i].hash_sum;
+  }
+
+  return true;
+}
+
+/**
+ * List the short ids in the sketch, typically the difference of two sketches
+ *
+ * @param positive The output short ids which were added (present only in this set)
+ * @param negative The output short ids which were removed (present only in the subtracted set)
+ * @return true if the sketch was completely decoded, otherwise false
+ */
+bool TransactionSketch::Decode(ShortIds &positive, ShortIds &negative) const
+{
+  positive.clear();
+  negative.clear();
+
+  if (cells_.empty() || (cells_.size() % NUM_HASHES) != 0)
+  {
+    return cells_.empty();
+  }
+
+  // peel the pure cells, i.e. the cells with a single short id, until none are left
+  TransactionSketch remaining{*this};
+
+  std::vector<std::size_t> pure{};
+  for (std::size_t i = 0; i < cells_.size(); ++i)
+  {
+    if (IsPure(cells_[i]))
+    {
+      pure.push_back(i);
+    }
+  }
+
+  std::size_t const partition = cells_.size() / NUM_HASHES;
+
+  while (!pure.empty())
+  {
+    auto const index = pure.back();
+    pure.pop_back();
+
+    Cell const cell = remaining.cells_[index];
+    if (!IsPure(cell))
+    {
+      continue;
+    }
+
+    ((cell.count > 0) ? positive : negative).push_back(cell.id_sum);
+    remaining.Update(cell.id_sum, -cell.count);
+
+    for (std::size_t hash = 0; hash < NUM_HASHES; ++hash)
+    {
+      auto const neighbour = CellIndex(cell.id_sum, hash, partition);
+      if (IsPure(remaining.cells_[neighbour]))
+      {
+        pure.push_back(neighbour);
+      }
+    }
+  }
+
+  return std::all_of(remaining.cells_.begin(), remaining.cells_.end(), IsZero);
+}
+
+std::size_t TransactionSketch::num_cells() const
+{
+  return cells_.size();
+}
+
+bool TransactionSketch::empty() const
+{
+  return std::all_of(cells_.begin(), cells_.end(), IsZero);
+}
+
+TransactionSketch::Cells const &TransactionSketch::cells() const
+{
+  return cells_;
+}
+
+void TransactionSketch::Update(ShortId id, int64_t delta)
+{
+  if (cells_.size() < NUM_HASHES)
+  {
+    return;
+  }
+
+  std::size_t const partition = cells_.size() / NUM_HASHES;
+  uint64_t const    check     = Mix(id, CHECK_SEED);
+
+  for (std::size_t hash = 0; hash < NUM_HASHES; ++hash)
+  {
+    auto &cell = cells_[CellIndex(id, hash, partition)];
+
+    cell.count += delta;
+    cell.id_sum ^= id;
+    cell.hash_sum ^= check;
+  }
+}
+
+}  // namespace ledger
+}  // namespace fetch
@@ -43,6 +43,8 @@ static void RecordNewCacheElement(ConstByteArray const &identifier)
 namespace fetch {
 namespace ledger {
 
+constexpr std::size_t TransactionStoreSyncProtocol::SKETCH_CELLS;
+
 /**
  * Create a transaction store sync protocol
  *
@@ -59,6 +61,8 @@ TransactionStoreSyncProtocol::TransactionStoreSyncProtocol(ObjectStore *store, i
   this->Expose(OBJECT_COUNT, this, &Self::ObjectCount);
   this->ExposeWithClientContext(PULL_OBJECTS, this, &Self::PullObjects);
   this->Expose(PULL_SUBTREE, this, &Self::PullSubtree);
+  this->Expose(PULL_SKETCH, this, &Self::RecentSketch);
+  this->ExposeWithClientContext(PULL_SPECIFIC_OBJECTS, this, &Self::PullSpecificObjects);
 }
 
 void TransactionStoreSyncProtocol::TrimCache()
@@ -74,12 +78,19 @@ void TransactionStoreSyncProtocol::TrimCache()
   auto const cut_off =
       CachedObject::Clock::now() - std::chrono::milliseconds(uint32_t{MAX_CACHE_LIFETIME_MS});
 
-  // generate the next cache version
-  std::copy_if(cache_.begin(), cache_.end(), std::back_inserter(next_cache),
-               [&cut_off](CachedObject const &object) {
-                 // we only copy objects which are young that we want to keep
-                 return object.created > cut_off;
-               });
+  // generate the next cache version, removing the expired objects from the sketch
+  for (auto &object : cache_)
+  {
+    // we only copy objects which are young that we want to keep
+    if (object.created > cut_off)
+    {
+      next_cache.emplace_back(std::move(object));
+    }
+    else
+    {
+      sketch_.Erase(object.short_id);
+    }
+  }
 
   auto const next_cache_size = next_cache.size();
   auto const curr_cache_size = cache_.size();
@@ -105,6 +116,19 @@ void TransactionStoreSyncProtocol::OnNewTx(VerifiedTransaction const &o)
 
   FETCH_LOCK(cache_mutex_);
   cache_.emplace_back(o);
+  sketch_.Insert(cache_.back().short_id);
+}
+
+/**
+ * Build the sketch of the recently received transactions, for reconciliation with a peer
+ *
+ * @return The sketch of the short ids of the transactions in the cache
+ */
+TransactionSketch TransactionStoreSyncProtocol::RecentSketch()
+{
+  FETCH_LOCK(cache_mutex_);
+
+  return sketch_;
 }
 
 uint64_t TransactionStoreSyncProtocol::ObjectCount()
@@ -152,5 +176,37 @@ TxList TransactionStoreSyncProtocol::PullObjects(service::CallContext const *cal
   return ret;
 }
 
+/**
+ * Allow peers to pull the recent transactions which a reconciliation of sketches has found to be
+ * missing on their side
+ *
+ * @param call_context The context of the client making the request
+ * @param ids The short ids of the transactions being requested
+ * @return The requested transactions which are still in the cache
+ */
+TxList TransactionStoreSyncProtocol::PullSpecificObjects(service::CallContext const *call_context,
+                                                         ShortIds const &            ids)
+{
+  std::unordered_set<uint64_t> const requested(ids.begin(), ids.end());
+
+  TxList ret;
+
+  {
+    generics::MilliTimer timer("ObjectSync:PullSpecificObjects", 500);
+    FETCH_LOCK(cache_mutex_);
+
+    for (auto &c : cache_)
+    {
+      if (requested.find(c.short_id) != requested.end())
+      {
+        c.delivered_to.insert(call_context->sender_address);
+        ret.push_back(c.data);
+      }
+    }
+  }
+
+  return ret;
+}
+
 }  // namespace ledger
 }  // namespace fetch
@@ -19,7 +19,9 @@
 #include "ledger/storage_unit/transaction_store_sync_service.hpp"
 #include "core/macros.hpp"
 #include "ledger/chain/transaction_serialization.hpp"
+#include "metrics/tracer.hpp"
 
+#include <algorithm>
 #include <memory>
 
 static char const *FETCH_MAYBE_UNUSED ToString(fetch::ledger::tx_sync::State state)
@@ -45,9 +47,15 @@ static char const *FETCH_MAYBE_UNUSED ToString(fetch::ledger::tx_sync::State sta
   case State::RESOLVING_SUBTREE:
     text = "Resolving Subtree";
     break;
+  case State::PIPELINED_SUBTREE:
+    text = "Pipelined Subtree";
+    break;
   case State::QUERY_OBJECTS:
     text = "Query Objects";
     break;
+  case State::RESOLVING_SKETCHES:
+    text = "Resolving Sketches";
+    break;
   case State::RESOLVING_OBJECTS:
     text = "Resolving Objects";
     break;
@@ -63,6 +71,7 @@ namespace fetch {
 namespace ledger {
 
 const std::size_t TransactionStoreSyncService::BATCH_SIZE = 30;
+constexpr uint64_t TransactionStoreSyncService::MAX_SUBTREE_ROOT_BITS;
 
 TransactionStoreSyncService::TransactionStoreSyncService(Config const &cfg, MuddlePtr muddle,
                                                          ObjectStorePtr store)
@@ -74,7 +83,8 @@ TransactionStoreSyncService::TransactionStoreSyncService(Config const &cfg, Mudd
                                      muddle_->AsEndpoint(), Muddle::Address(), SERVICE_LANE,
                                      CHANNEL_RPC))
   , store_(std::move(store))
-  , verifier_(*this, cfg_.verification_threads, "TxV-L" + std::to_string(cfg_.lane_id))
+  , verifier_(*this, cfg_.verification_threads, "TxV-L" + std::to_string(cfg_.lane_id),
+              cfg_.verified_cache)
 {
   state_machine_->RegisterHandler(State::INITIAL, this, &TransactionStoreSyncService::OnInitial);
   state_machine_->RegisterHandler(State::QUERY_OBJECT_COUNTS, this,
@@ -85,8 +95,12 @@ TransactionStoreSyncService::TransactionStoreSyncService(Config const &cfg, Mudd
                                   &TransactionStoreSyncService::OnQuerySubtree);
   state_machine_->RegisterHandler(State::RESOLVING_SUBTREE, this,
                                   &TransactionStoreSyncService::OnResolvingSubtree);
+  state_machine_->RegisterHandler(State::PIPELINED_SUBTREE, this,
+                                  &TransactionStoreSyncService::OnPipelinedSubtree);
   state_machine_->RegisterHandler(State::QUERY_OBJECTS, this,
                                   &TransactionStoreSyncService::OnQueryObjects);
+  state_machine_->RegisterHandler(State::RESOLVING_SKETCHES, this,
+                                  &TransactionStoreSyncService::OnResolvingSketches);
   state_machine_->RegisterHandler(State::RESOLVING_OBJECTS, this,
                                   &TransactionStoreSyncService::OnResolvingObjects);
   state_machine_->RegisterHandler(State::TRIM_CACHE, this,
@@ -174,12 +188,28 @@ TransactionStoreSyncService::State TransactionStoreSyncService::OnResolvingObjec
 
     root_size_ = platform::Log2Ceil(((max_object_count_ / (PULL_LIMIT_ / 2)) + 1)) + 1;
 
+    if (cfg_.sync_mode == SyncMode::PIPELINED)
+    {
+      // split the sync into enough roots to fill the windows of all the peers, limited by the
+      // single byte of the prefix
+      std::size_t const num_peers =
+          std::max<std::size_t>(muddle_->AsEndpoint().GetDirectlyConnectedPeers().size(), 1);
+      uint64_t const root_size = platform::Log2Ceil(num_peers * cfg_.max_requests_per_peer);
+
+      root_size_ = std::min(std::max(root_size_, root_size), MAX_SUBTREE_ROOT_BITS);
+    }
+
     for (uint64_t i = 0, end = (1 << (root_size_)); i < end; ++i)
     {
       roots_to_sync_.push(Reverse(static_cast<uint8_t>(i)));
     }
   }
 
+  if (cfg_.sync_mode == SyncMode::PIPELINED)
+  {
+    return State::PIPELINED_SUBTREE;
+  }
+
   return State::QUERY_SUBTREE;
 }
 
@@ -231,6 +261,8 @@ TransactionStoreSyncService::State TransactionStoreSyncService::OnResolvingSubtr
 
     for (auto &tx : result.promised)
     {
+      metrics::Tracer::Instance().StartTransactionSpan("tx.sync.received", tx.digest()).End();
+
       // add the transaction to the verifier
       verifier_.AddTransaction(tx.AsMutable());
 
@@ -282,6 +314,115 @@ TransactionStoreSyncService::State TransactionStoreSyncService::OnResolvingSubtr
   return roots_to_sync_.empty() ? State::QUERY_OBJECTS : State::QUERY_SUBTREE;
 }
 
+/**
+ * Resolve the completed subtree requests and keep the window of every peer full
+ *
+ * Unlike the batched sync, which waits for every request of a round to complete before the next
+ * round is sent, each request is resolved (or timed out and requeued) on its own. The transactions
+ * are passed to the verifier in bulk as the responses arrive.
+ */
+TransactionStoreSyncService::State TransactionStoreSyncService::OnPipelinedSubtree()
+{
+  using PromiseState = PromiseOfTxList::State;
+
+  auto const now = RequestWindow::Clock::now();
+
+  FETCH_LOCK(mutex_);
+
+  // resolve the requests in flight
+  TransactionVerifier::MutableTxList synced;
+  for (auto it = subtree_requests_.begin(); it != subtree_requests_.end();)
+  {
+    auto &request = it->second;
+    auto &window  = peer_windows_.at(request.peer);
+
+    auto const state = request.promise.GetState();
+    if (PromiseState::SUCCESS == state)
+    {
+      window.OnResponse(now - request.sent);
+
+      for (auto &tx : request.promise.Get())
+      {
+        metrics::Tracer::Instance().StartTransactionSpan("tx.sync.received", tx.digest()).End();
+
+        synced.emplace_back(tx.AsMutable());
+      }
+    }
+    else if ((PromiseState::WAITING != state) || ((now - request.sent) > cfg_.promise_wait_timeout))
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Lane ", cfg_.lane_id, ": ", "Failed subtree request for root ",
+                     static_cast<uint32_t>(it->first), " from muddle://",
+                     request.peer.ToBase64());
+
+      window.OnFailure();
+      roots_to_sync_.push(it->first);
+    }
+    else
+    {
+      ++it;
+      continue;
+    }
+
+    it = subtree_requests_.erase(it);
+  }
+
+  if (!synced.empty())
+  {
+    FETCH_LOG_INFO(LOGGING_NAME, "Lane ", cfg_.lane_id, " Incorporated ", synced.size(), " txs");
+
+    verifier_.AddTransactions(std::move(synced));
+  }
+
+  // fill the windows of the peers, a request at a time from each peer in turn
+  auto const peers = muddle_->AsEndpoint().GetDirectlyConnectedPeers();
+
+  bool sent = true;
+  while (sent && !roots_to_sync_.empty())
+  {
+    sent = false;
+
+    for (auto const &peer : peers)
+    {
+      if (roots_to_sync_.empty())
+      {
+        break;
+      }
+
+      auto &window =
+          peer_windows_.emplace(peer, RequestWindow{1, cfg_.max_requests_per_peer}).first->second;
+      if (!window.CanSend())
+      {
+        continue;
+      }
+
+      auto const root = roots_to_sync_.front();
+      roots_to_sync_.pop();
+
+      byte_array::ByteArray transactions_prefix;
+
+      transactions_prefix.Resize(std::size_t{ResourceID::RESOURCE_ID_SIZE_IN_BYTES});
+      transactions_prefix[0] = root;
+
+      auto promise = PromiseOfTxList(client_->CallSpecificAddress(
+          peer, RPC_TX_STORE_SYNC, TransactionStoreSyncProtocol::PULL_SUBTREE,
+          transactions_prefix, root_size_));
+
+      window.OnSent();
+      subtree_requests_[root] =
+          SubtreeRequest{peer, std::move(promise), RequestWindow::Clock::now()};
+
+      sent = true;
+    }
+  }
+
+  if (roots_to_sync_.empty() && subtree_requests_.empty())
+  {
+    return State::QUERY_OBJECTS;
+  }
+
+  return State::PIPELINED_SUBTREE;
+}
+
 TransactionStoreSyncService::State TransactionStoreSyncService::OnQueryObjects()
 {
   if (!fetch_object_wait_timeout_.IsDue())
@@ -289,11 +430,22 @@ TransactionStoreSyncService::State TransactionStoreSyncService::OnQueryObjects()
     return State::QUERY_OBJECTS;
   }
 
+  bool const reconcile = cfg_.reconcile_recent && static_cast<bool>(recent_sketch_callback_);
+
   for (auto const &connection : muddle_->AsEndpoint().GetDirectlyConnectedPeers())
   {
-    auto promise = PromiseOfTxList(client_->CallSpecificAddress(
-        connection, RPC_TX_STORE_SYNC, TransactionStoreSyncProtocol::PULL_OBJECTS));
-    pending_objects_.Add(connection, promise);
+    if (reconcile)
+    {
+      auto promise = PromiseOfSketch(client_->CallSpecificAddress(
+          connection, RPC_TX_STORE_SYNC, TransactionStoreSyncProtocol::PULL_SKETCH));
+      pending_sketches_.Add(connection, promise);
+    }
+    else
+    {
+      auto promise = PromiseOfTxList(client_->CallSpecificAddress(
+          connection, RPC_TX_STORE_SYNC, TransactionStoreSyncProtocol::PULL_OBJECTS));
+      pending_objects_.Add(connection, promise);
+    }
   }
 
   promise_wait_timeout_.Set(cfg_.promise_wait_timeout);
@@ -302,6 +454,78 @@ TransactionStoreSyncService::State TransactionStoreSyncService::OnQueryObjects()
   FETCH_LOCK(is_ready_mutex_);
   is_ready_ = true;
 
+  return reconcile ? State::RESOLVING_SKETCHES : State::RESOLVING_OBJECTS;
+}
+
+/**
+ * Reconcile the sketches of the recent objects of the peers with the local one
+ *
+ * Each peer sends a sketch of the short ids of its recent transactions. The local sketch is
+ * subtracted from it, and decoding the difference yields the transactions which only the peer has,
+ * which are then requested explicitly. When the difference is too large to decode the recent
+ * objects are pulled from the peer in full instead.
+ */
+TransactionStoreSyncService::State TransactionStoreSyncService::OnResolvingSketches()
+{
+  auto counts = pending_sketches_.Resolve();
+
+  auto const local = recent_sketch_callback_();
+
+  TransactionSketch::ShortIds missing{}, unknown{};
+  for (auto &result : pending_sketches_.Get(MAX_SKETCH_RESOLUTION_PER_CYCLE))
+  {
+    auto &difference = result.promised;
+
+    if (difference.Subtract(local) && difference.Decode(missing, unknown))
+    {
+      if (missing.empty())
+      {
+        continue;
+      }
+
+      FETCH_LOG_DEBUG(LOGGING_NAME, "Lane ", cfg_.lane_id, ": ", "Reconciled ", missing.size(),
+                      " missing objects from muddle://", result.key.ToBase64());
+
+      auto promise = PromiseOfTxList(client_->CallSpecificAddress(
+          result.key, RPC_TX_STORE_SYNC, TransactionStoreSyncProtocol::PULL_SPECIFIC_OBJECTS,
+          missing));
+      pending_objects_.Add(result.key, promise);
+    }
+    else
+    {
+      FETCH_LOG_INFO(LOGGING_NAME, "Lane ", cfg_.lane_id, ": ",
+                     "Unable to reconcile recent objects, pulling all from muddle://",
+                     result.key.ToBase64());
+
+      auto promise = PromiseOfTxList(client_->CallSpecificAddress(
+          result.key, RPC_TX_STORE_SYNC, TransactionStoreSyncProtocol::PULL_OBJECTS));
+      pending_objects_.Add(result.key, promise);
+    }
+  }
+
+  FETCH_LOCK(mutex_);
+  if (counts.pending > 0)
+  {
+    if (!promise_wait_timeout_.IsDue())
+    {
+      return State::RESOLVING_SKETCHES;
+    }
+    FETCH_LOG_WARN(LOGGING_NAME, "Lane ", cfg_.lane_id, ": ",
+                   "Still pending sketch promises but limit approached!");
+
+    // the late sketches are discarded, the next round will reconcile with those peers
+    pending_sketches_.GetPending();
+  }
+
+  if (counts.failed)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Lane ", cfg_.lane_id, ": ", "Failed sketch promises: ",
+                   counts.failed);
+    pending_sketches_.GetFailures(counts.failed);
+  }
+
+  promise_wait_timeout_.Set(cfg_.promise_wait_timeout);
+
   return State::RESOLVING_OBJECTS;
 }
 
@@ -320,6 +544,8 @@ TransactionStoreSyncService::State TransactionStoreSyncService::OnResolvingObjec
 
     for (auto &tx : result.promised)
     {
+      metrics::Tracer::Instance().StartTransactionSpan("tx.sync.received", tx.digest()).End();
+
       verifier_.AddTransaction(tx.AsMutable());
       ++synced_tx;
     }
@@ -368,6 +594,7 @@ void TransactionStoreSyncService::OnTransaction(VerifiedTransaction const &tx)
     FETCH_LOG_DEBUG(LOGGING_NAME, "Verified Sync TX: ", tx.digest().ToBase64(), " (",
                     tx.contract_name(), ')');
 
+    auto span = metrics::Tracer::Instance().StartTransactionSpan("tx.sync.store", tx.digest());
     store_->Set(rid, tx, true);
   }
 }
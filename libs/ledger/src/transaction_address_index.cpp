@@ -0,0 +1,319 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/logger.hpp"
+#include "crypto/hash.hpp"
+#include "crypto/sha256.hpp"
+#include "ledger/transaction_address_index.hpp"
+#include "storage/storage_exception.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace fetch {
+namespace ledger {
+namespace {
+
+byte_array::ConstByteArray ToBytes(uint8_t const *data)
+{
+  byte_array::ByteArray bytes;
+  bytes.Resize(TransactionAddressIndex::HASH_SIZE);
+  std::memcpy(bytes.pointer(), data, TransactionAddressIndex::HASH_SIZE);
+
+  return {bytes};
+}
+
+}  // namespace
+
+constexpr std::size_t TransactionAddressIndex::HASH_SIZE;
+
+/**
+ * Create a new (empty) index, removing any previous contents
+ *
+ * @param filename The path to the index file
+ */
+void TransactionAddressIndex::New(std::string const &filename)
+{
+  FETCH_LOCK(lock_);
+
+  table_.clear();
+  indexed_.clear();
+  stack_.New(filename);
+  stack_.SetExtraHeader(VERSION);
+}
+
+/**
+ * Load a previously created index, rebuilding the address table from its records
+ *
+ * @param filename The path to the index file
+ * @return true if the index was loaded, false if it was missing or of an incompatible version
+ */
+bool TransactionAddressIndex::Load(std::string const &filename)
+{
+  FETCH_LOCK(lock_);
+
+  table_.clear();
+  indexed_.clear();
+
+  try
+  {
+    stack_.Load(filename, false);
+  }
+  catch (storage::StorageException const &ex)
+  {
+    FETCH_LOG_INFO(LOGGING_NAME, "Unable to load tx address index: ", ex.what());
+    return false;
+  }
+
+  if (VERSION != stack_.header_extra())
+  {
+    return false;
+  }
+
+  Record   record{};
+  TxDigest previous_digest{};
+  uint64_t previous_block{0};
+  for (uint64_t i = 0, end = stack_.size(); i < end; ++i)
+  {
+    stack_.Get(i, record);
+
+    table_[ToBytes(record.address)].push_back({record.block_number, i});
+
+    // a transaction has one record per address, all written together
+    TxDigest digest = ToBytes(record.digest);
+    if ((i == 0) || (digest != previous_digest) || (record.block_number != previous_block))
+    {
+      MarkIndexed(digest, record.block_number);
+    }
+
+    previous_digest = std::move(digest);
+    previous_block  = record.block_number;
+  }
+
+  // records of a block executed again after a fork can be out of order in the log
+  for (auto &element : table_)
+  {
+    std::stable_sort(element.second.begin(), element.second.end(),
+                     [](Position const &a, Position const &b) {
+                       return a.block_number < b.block_number;
+                     });
+  }
+
+  FETCH_LOG_INFO(LOGGING_NAME, "Loaded ", stack_.size(), " records for ", table_.size(),
+                 " addresses");
+
+  return true;
+}
+
+/**
+ * Flush the contents of the index to disk
+ */
+void TransactionAddressIndex::Flush()
+{
+  FETCH_LOCK(lock_);
+
+  if (stack_.is_open())
+  {
+    stack_.Flush(false);
+  }
+}
+
+/**
+ * Index all the transactions of an executed block, against each of the resources they touch
+ *
+ * @param block The block which has been executed
+ */
+void TransactionAddressIndex::Add(Block const &block)
+{
+  FETCH_LOCK(lock_);
+
+  if (!stack_.is_open())
+  {
+    return;
+  }
+
+  Addresses addresses{};
+  for (auto const &slice : block.body.slices)
+  {
+    for (auto const &tx : slice)
+    {
+      addresses.assign(tx.resources.begin(), tx.resources.end());
+      AddLocked(tx.transaction_hash, addresses, block.body.block_number);
+    }
+  }
+}
+
+/**
+ * Index a single transaction against a set of addresses
+ *
+ * @param digest The digest of the transaction
+ * @param addresses The addresses the transaction touches
+ * @param block_number The number of the block the transaction was executed in
+ */
+void TransactionAddressIndex::Add(TxDigest const &digest, Addresses const &addresses,
+                                  uint64_t block_number)
+{
+  FETCH_LOCK(lock_);
+
+  if (!stack_.is_open())
+  {
+    return;
+  }
+
+  AddLocked(digest, addresses, block_number);
+}
+
+/**
+ * Query the transactions of an address within a range of block numbers, in block number order
+ *
+ * @param address The address to query
+ * @param from The first block number of the range
+ * @param to The last block number of the range (inclusive)
+ * @param offset The number of entries of the range to skip
+ * @param limit The maximum number of entries to return
+ * @param entries The output entries
+ * @return The total number of entries within the range, which may exceed the limit
+ */
+std::size_t TransactionAddressIndex::Query(Address const &address, uint64_t from, uint64_t to,
+                                           std::size_t offset, std::size_t limit,
+                                           Entries &entries) const
+{
+  entries.clear();
+
+  FETCH_LOCK(lock_);
+
+  auto const it = table_.find(Key(address));
+  if ((it == table_.end()) || (from > to))
+  {
+    return 0;
+  }
+
+  auto const &positions = it->second;
+
+  auto const begin = std::lower_bound(
+      positions.begin(), positions.end(), from,
+      [](Position const &position, uint64_t value) { return position.block_number < value; });
+  auto const end = std::upper_bound(
+      begin, positions.end(), to,
+      [](uint64_t value, Position const &position) { return value < position.block_number; });
+
+  auto const total = static_cast<std::size_t>(end - begin);
+  if (offset >= total)
+  {
+    return total;
+  }
+
+  entries.reserve(std::min(total - offset, limit));
+
+  Record record{};
+  for (auto position = begin + static_cast<std::ptrdiff_t>(offset);
+       (position != end) && (entries.size() < limit); ++position)
+  {
+    stack_.Get(position->record, record);
+    entries.push_back({ToBytes(record.digest), record.block_number});
+  }
+
+  return total;
+}
+
+/**
+ * Get the number of records in the index
+ *
+ * @return The number of records
+ */
+std::size_t TransactionAddressIndex::size() const
+{
+  FETCH_LOCK(lock_);
+  return stack_.size();
+}
+
+/**
+ * Internal: Compute the fixed size key of an address
+ *
+ * @param address The address
+ * @return The key of the address
+ */
+byte_array::ConstByteArray TransactionAddressIndex::Key(Address const &address)
+{
+  return crypto::Hash<crypto::SHA256>(address);
+}
+
+/**
+ * Internal: Append the records of a transaction to the log and the table, unless the transaction
+ * has already been indexed at the same block number. The lock must be held.
+ *
+ * @param digest The digest of the transaction
+ * @param addresses The addresses the transaction touches
+ * @param block_number The block number of the transaction
+ * @return true if the transaction was added, otherwise false
+ */
+bool TransactionAddressIndex::AddLocked(TxDigest const &digest, Addresses const &addresses,
+                                        uint64_t block_number)
+{
+  if ((digest.size() != HASH_SIZE) || !MarkIndexed(digest, block_number))
+  {
+    return false;
+  }
+
+  Record record{};
+  std::memcpy(record.digest, digest.pointer(), HASH_SIZE);
+  record.block_number = block_number;
+
+  for (auto const &address : addresses)
+  {
+    auto const key = Key(address);
+    std::memcpy(record.address, key.pointer(), HASH_SIZE);
+
+    uint64_t const index = stack_.size();
+    stack_.Push(record);
+
+    // blocks are almost always executed in order, so this is usually an append
+    auto &positions = table_[key];
+    auto  position  = std::upper_bound(
+        positions.begin(), positions.end(), block_number,
+        [](uint64_t value, Position const &element) { return value < element.block_number; });
+    positions.insert(position, Position{block_number, index});
+  }
+
+  return true;
+}
+
+/**
+ * Internal: Record that a transaction has been indexed at a block number. The lock must be held.
+ *
+ * @param digest The digest of the transaction
+ * @param block_number The block number of the transaction
+ * @return true if the transaction had not been indexed at the block number, otherwise false
+ */
+bool TransactionAddressIndex::MarkIndexed(TxDigest const &digest, uint64_t block_number)
+{
+  auto const range = indexed_.equal_range(digest);
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    if (it->second == block_number)
+    {
+      return false;
+    }
+  }
+
+  indexed_.emplace(digest, block_number);
+  return true;
+}
+
+}  // namespace ledger
+}  // namespace fetch
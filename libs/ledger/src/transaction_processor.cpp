@@ -21,7 +21,9 @@
 #include "ledger/block_packer_interface.hpp"
 #include "ledger/storage_unit/storage_unit_interface.hpp"
 #include "ledger/transaction_status_cache.hpp"
+#include "ledger/transaction_summary_cache.hpp"
 #include "metrics/metrics.hpp"
+#include "metrics/tracer.hpp"
 
 namespace fetch {
 namespace ledger {
@@ -31,15 +33,19 @@ namespace ledger {
  *
  * @param storage The reference to the storage unit
  * @param miner The reference to the system miner
+ * @param tx_summary_cache The (optional) cache of recent summaries used to rebuild compact blocks
  */
-TransactionProcessor::TransactionProcessor(StorageUnitInterface &  storage,
-                                           BlockPackerInterface &  packer,
-                                           TransactionStatusCache &tx_status_cache,
-                                           std::size_t             num_threads)
+TransactionProcessor::TransactionProcessor(StorageUnitInterface &   storage,
+                                           BlockPackerInterface &   packer,
+                                           TransactionStatusCache & tx_status_cache,
+                                           std::size_t              num_threads,
+                                           TransactionSummaryCache *tx_summary_cache,
+                                           VerifiedDigestCache *    verified_cache)
   : storage_{storage}
   , packer_{packer}
   , status_cache_{tx_status_cache}
-  , verifier_{*this, num_threads, "TxV-P"}
+  , summary_cache_{tx_summary_cache}
+  , verifier_{*this, num_threads, "TxV-P", verified_cache}
   , running_{false}
 {}
 
@@ -62,6 +68,8 @@ void TransactionProcessor::OnTransaction(VerifiedTransaction const &tx)
   FETCH_LOG_DEBUG(LOGGING_NAME, "Verified Input Transaction: ", byte_array::ToBase64(tx.digest()),
                   " (", tx.contract_name(), ')');
 
+  auto span = metrics::Tracer::Instance().StartTransactionSpan("tx.store", tx.digest());
+
   // dispatch the transaction to the storage engine
   try
   {
@@ -79,6 +87,11 @@ void TransactionProcessor::OnTransaction(VerifiedTransaction const &tx)
   // dispatch the summary to the miner
   packer_.EnqueueTransaction(tx.summary());
 
+  if (summary_cache_)
+  {
+    summary_cache_->Add(tx.summary());
+  }
+
   // update the status cache with the state of this transaction
   status_cache_.Update(tx.digest(), TransactionStatus::PENDING);
 
@@ -91,6 +104,9 @@ void TransactionProcessor::OnTransactions(TransactionList const &txs)
   auto const submitted = metrics::Metrics::Clock::now();
 #endif  // FETCH_ENABLE_METRICS
 
+  auto &     tracer  = metrics::Tracer::Instance();
+  auto const started = metrics::Tracer::Clock::now();
+
   // dispatch all the transactions to the storage engine
   try
   {
@@ -108,9 +124,28 @@ void TransactionProcessor::OnTransactions(TransactionList const &txs)
 #endif  // FETCH_ENABLE_METRICS
 
   // enqueue all of the transactions
+  Summaries summaries{};
+  Digests   digests{};
+  summaries.reserve(txs.size());
+  digests.reserve(txs.size());
+
   for (auto const &tx : txs)
   {
-    packer_.EnqueueTransaction(tx.summary());
+    summaries.push_back(tx.summary());
+    digests.push_back(tx.digest());
+  }
+
+  Enqueue(summaries);
+
+  // update the status cache with the state of all the transactions
+  status_cache_.Update(digests, TransactionStatus::PENDING);
+
+  if (tracer.enabled())
+  {
+    for (auto const &tx : txs)
+    {
+      tracer.StartTransactionSpan("tx.store", tx.digest(), started).End();
+    }
   }
 
 #ifdef FETCH_ENABLE_METRICS
@@ -129,29 +164,67 @@ void TransactionProcessor::ThreadEntryPoint()
 {
   SetThreadName("TxProc");
 
-  std::vector<TransactionSummary> new_txs;
+  Summaries new_txs;
   while (running_)
   {
     std::this_thread::sleep_for(std::chrono::milliseconds(500));
     new_txs.clear();
     new_txs = storage_.PollRecentTx(10000);
 
-    if (!new_txs.empty())
+    if (new_txs.empty())
     {
-      FETCH_LOG_INFO(LOGGING_NAME, "Pulled ", new_txs.size(), " transactions from shards");
+      continue;
     }
 
+    FETCH_LOG_INFO(LOGGING_NAME, "Pulled ", new_txs.size(), " transactions from shards");
+
+    // Note: metric for TX stored will not fire this way
+    // dispatch the summaries to the miner
+    Enqueue(new_txs);
+
     for (auto const &summary : new_txs)
     {
-      // Note: metric for TX stored will not fire this way
-      // dispatch the summary to the miner
       assert(summary.IsWellFormed());
-      packer_.EnqueueTransaction(summary);
-
       FETCH_METRIC_TX_QUEUED(summary.transaction_hash);
     }
   }
 }
 
+/**
+ * Get the depth of the ingest pipeline: the transactions waiting to be verified and those waiting
+ * to be packed into a block
+ *
+ * @return The number of transactions
+ */
+std::size_t TransactionProcessor::GetBacklog() const
+{
+  return verifier_.GetBacklog() + static_cast<std::size_t>(packer_.GetBacklog());
+}
+
+/**
+ * Get the number of transactions waiting to be verified, or dispatched once verified
+ *
+ * @return The number of transactions
+ */
+std::size_t TransactionProcessor::GetVerifierBacklog() const
+{
+  return verifier_.GetBacklog();
+}
+
+/**
+ * Dispatch a batch of transaction summaries to the miner, and the summary cache if present
+ *
+ * @param summaries The summaries of the transactions
+ */
+void TransactionProcessor::Enqueue(Summaries const &summaries)
+{
+  packer_.EnqueueTransactions(summaries);
+
+  if (summary_cache_)
+  {
+    summary_cache_->Add(summaries);
+  }
+}
+
 }  // namespace ledger
 }  // namespace fetch
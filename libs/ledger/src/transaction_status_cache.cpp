@@ -19,6 +19,8 @@
 #include "ledger/transaction_status_cache.hpp"
 #include "network/generics/milli_timer.hpp"
 
+#include <algorithm>
+
 static const std::chrono::hours   LIFETIME{24};
 static const std::chrono::minutes INTERVAL{5};
 
@@ -49,15 +51,39 @@ char const *ToString(TransactionStatus status)
   return text;
 }
 
+/**
+ * Parse the text form of a transaction status
+ *
+ * @param text The text, as produced by ToString
+ * @param status The output status
+ * @return true if successful, otherwise false
+ */
+bool FromString(std::string const &text, TransactionStatus &status)
+{
+  for (auto const candidate : {TransactionStatus::UNKNOWN, TransactionStatus::PENDING,
+                               TransactionStatus::MINED, TransactionStatus::EXECUTED})
+  {
+    if (text == ToString(candidate))
+    {
+      status = candidate;
+      return true;
+    }
+  }
+
+  return false;
+}
+
 TransactionStatus TransactionStatusCache::Query(TxDigest digest) const
 {
   TransactionStatus status{TransactionStatus::UNKNOWN};
 
+  auto const &shard = shards_[ShardIndex(digest)];
+
   {
-    FETCH_LOCK(mtx_);
+    FETCH_LOCK(shard.mtx);
 
-    auto const it = cache_.find(digest);
-    if (cache_.end() != it)
+    auto const it = shard.cache.find(digest);
+    if (shard.cache.end() != it)
     {
       status = it->second.status;
     }
@@ -68,40 +94,237 @@ TransactionStatus TransactionStatusCache::Query(TxDigest digest) const
 
 void TransactionStatusCache::Update(TxDigest digest, TransactionStatus status, Timepoint const &now)
 {
-  FETCH_LOCK(mtx_);
+  auto &shard = shards_[ShardIndex(digest)];
+
+  Events events{};
+  {
+    FETCH_LOCK(shard.mtx);
+    UpdateShard(shard, std::move(digest), status, now, events);
+  }
+
+  Notify(events);
+  PruneIfRequired(now);
+}
+
+/**
+ * Update the status of a batch of transactions. The digests are grouped by shard so that each
+ * shard is only locked once for the whole batch.
+ *
+ * @param digests The digests of the transactions
+ * @param status The new status of the transactions
+ * @param now The current time
+ */
+void TransactionStatusCache::Update(TxDigests const &digests, TransactionStatus status,
+                                    Timepoint const &now)
+{
+  std::array<std::vector<TxDigest const *>, NUM_SHARDS> grouped{};
+  for (auto const &digest : digests)
+  {
+    grouped[ShardIndex(digest)].push_back(&digest);
+  }
+
+  Events events{};
+  for (std::size_t index = 0; index < NUM_SHARDS; ++index)
+  {
+    if (grouped[index].empty())
+    {
+      continue;
+    }
+
+    auto &shard = shards_[index];
+
+    FETCH_LOCK(shard.mtx);
+    for (auto const *digest : grouped[index])
+    {
+      UpdateShard(shard, *digest, status, now, events);
+    }
+  }
+
+  Notify(events);
+  PruneIfRequired(now);
+}
+
+/**
+ * Subscribe to the next change to the status of any of a set of transactions. The notification
+ * is called at most once, after which the subscription is removed. To avoid missing a change the
+ * caller should query the statuses after subscribing, rather than before.
+ *
+ * @param digests The digests of the transactions
+ * @param notification The function to be called with the first change
+ * @return The subscription, which can be cancelled with Unsubscribe
+ */
+TransactionStatusCache::SubscriptionPtr TransactionStatusCache::Subscribe(
+    TxDigests digests, Notification notification)
+{
+  auto subscription          = std::make_shared<Subscription>();
+  subscription->digests      = std::move(digests);
+  subscription->notification = std::move(notification);
+
+  for (auto const &digest : subscription->digests)
+  {
+    auto &shard = shards_[ShardIndex(digest)];
+
+    FETCH_LOCK(shard.mtx);
+    shard.subscribers[digest].push_back(subscription);
+  }
+
+  return subscription;
+}
+
+/**
+ * Cancel a subscription, if it has not already been notified
+ *
+ * @param subscription The subscription to be cancelled
+ */
+void TransactionStatusCache::Unsubscribe(SubscriptionPtr const &subscription)
+{
+  if (!subscription)
+  {
+    return;
+  }
+
+  subscription->active = false;
+
+  for (auto const &digest : subscription->digests)
+  {
+    auto &shard = shards_[ShardIndex(digest)];
+
+    FETCH_LOCK(shard.mtx);
+
+    auto it = shard.subscribers.find(digest);
+    if (shard.subscribers.end() == it)
+    {
+      continue;
+    }
+
+    auto &list = it->second;
+    list.erase(std::remove(list.begin(), list.end(), subscription), list.end());
+
+    if (list.empty())
+    {
+      shard.subscribers.erase(it);
+    }
+  }
+}
+
+/**
+ * Internal: Update the status of a single transaction, the lock of the shard must be held
+ */
+void TransactionStatusCache::UpdateShard(Shard &shard, TxDigest digest, TransactionStatus status,
+                                         Timepoint const &now, Events &events)
+{
+  // start a new bucket if the current one has been filled for a complete interval
+  if (shard.buckets.empty() || ((now - shard.buckets.back().start) >= INTERVAL))
+  {
+    shard.buckets.emplace_back(Bucket{now, {}});
+  }
+
+  auto &bucket = shard.buckets.back();
 
   // update the cache
-  cache_[digest] = Element{status, now};
+  auto const result = shard.cache.emplace(digest, Element{status, now});
+
+  // only track the digest if it is not already present in the current bucket
+  bool const in_bucket = !result.second && (result.first->second.timestamp >= bucket.start);
+  bool const changed   = result.second || (result.first->second.status != status);
+
+  result.first->second = Element{status, now};
 
-  // determine if we need to prune the cache
-  auto const delta_prune = now - last_clean_;
-  if (delta_prune > INTERVAL)
+  // the subscriptions on this digest are triggered by the change
+  if (changed && !shard.subscribers.empty())
   {
-    PruneCache(now);
+    auto it = shard.subscribers.find(digest);
+    if (shard.subscribers.end() != it)
+    {
+      for (auto &subscription : it->second)
+      {
+        events.push_back(Event{std::move(subscription), digest, status});
+      }
+
+      shard.subscribers.erase(it);
+    }
+  }
 
-    last_clean_ = now;
+  if (!in_bucket)
+  {
+    bucket.digests.emplace_back(std::move(digest));
   }
 }
 
+/**
+ * Internal: Call the notifications of the triggered subscriptions, without holding any locks
+ *
+ * @param events The status changes which triggered the subscriptions
+ */
+void TransactionStatusCache::Notify(Events const &events)
+{
+  for (auto const &event : events)
+  {
+    // only the first change is notified, and never after the subscription has been cancelled
+    if (event.subscription->active.exchange(false))
+    {
+      event.subscription->notification(event.digest, event.status);
+
+      // the subscription may still be waiting on its other digests
+      Unsubscribe(event.subscription);
+    }
+  }
+}
+
+void TransactionStatusCache::PruneIfRequired(Timepoint const &now)
+{
+  // determine if we need to prune the cache, only one of the updating threads will win the
+  // exchange and do the actual pruning
+  Ticks       last_clean = last_clean_.load();
+  Ticks const now_ticks  = ToTicks(now);
+
+  if (((now_ticks - last_clean) > Clock::duration{INTERVAL}.count()) &&
+      last_clean_.compare_exchange_strong(last_clean, now_ticks))
+  {
+    PruneCache(now);
+  }
+}
+
+std::size_t TransactionStatusCache::ShardIndex(TxDigest const &digest)
+{
+  // transaction digests are cryptographic hashes so the first byte is sufficient to distribute
+  // the elements evenly across the shards
+  std::size_t const value = digest.empty() ? 0 : digest[0];
+
+  return value % NUM_SHARDS;
+}
+
 void TransactionStatusCache::PruneCache(Timepoint const &now)
 {
   MilliTimer timer{"TxStatusCache::Prune"};
 
-  auto it = cache_.begin();
-  while (it != cache_.end())
+  for (auto &shard : shards_)
   {
-    auto const age = now - it->second.timestamp;
+    FETCH_LOCK(shard.mtx);
 
-    if (age > LIFETIME)
-    {
-      it = cache_.erase(it);
-    }
-    else
+    // only buckets whose complete interval has expired are evicted
+    while (!shard.buckets.empty() && ((now - shard.buckets.front().start) > (LIFETIME + INTERVAL)))
     {
-      ++it;
+      for (auto const &digest : shard.buckets.front().digests)
+      {
+        auto const it = shard.cache.find(digest);
+
+        // elements which have been updated since will also be present in a more recent bucket
+        if ((shard.cache.end() != it) && ((now - it->second.timestamp) > LIFETIME))
+        {
+          shard.cache.erase(it);
+        }
+      }
+
+      shard.buckets.pop_front();
     }
   }
 }
 
+TransactionStatusCache::Ticks TransactionStatusCache::ToTicks(Timepoint const &timepoint)
+{
+  return timepoint.time_since_epoch().count();
+}
+
 }  // namespace ledger
 }  // namespace fetch
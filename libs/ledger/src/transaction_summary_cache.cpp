@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/transaction_summary_cache.hpp"
+
+#include <algorithm>
+
+namespace fetch {
+namespace ledger {
+
+constexpr std::size_t TransactionSummaryCache::DEFAULT_CAPACITY;
+
+/**
+ * Construct the summary cache
+ *
+ * @param capacity The maximum number of summaries to be cached
+ */
+TransactionSummaryCache::TransactionSummaryCache(std::size_t capacity)
+  : capacity_{capacity}
+{}
+
+/**
+ * Add a transaction summary to the cache, evicting the oldest entries if required
+ *
+ * @param summary The summary to be added
+ */
+void TransactionSummaryCache::Add(TransactionSummary const &summary)
+{
+  FETCH_LOCK(lock_);
+
+  AddLocked(summary);
+  EvictLocked();
+}
+
+/**
+ * Add a batch of transaction summaries to the cache, taking the lock once
+ *
+ * @param summaries The summaries to be added
+ */
+void TransactionSummaryCache::Add(TransactionSummaries const &summaries)
+{
+  FETCH_LOCK(lock_);
+
+  for (auto const &summary : summaries)
+  {
+    AddLocked(summary);
+  }
+
+  EvictLocked();
+}
+
+/**
+ * Lookup a transaction summary from its short id
+ *
+ * @param id The short id of the transaction
+ * @param summary The output summary to be populated
+ * @return true if successful, otherwise false
+ */
+bool TransactionSummaryCache::Lookup(ShortId id, TransactionSummary &summary) const
+{
+  FETCH_LOCK(lock_);
+
+  auto const it = summaries_.find(id);
+  if (it == summaries_.end())
+  {
+    return false;
+  }
+
+  summary = it->second;
+  return true;
+}
+
+/**
+ * Get the number of summaries in the cache
+ *
+ * @return The number of summaries
+ */
+std::size_t TransactionSummaryCache::size() const
+{
+  FETCH_LOCK(lock_);
+  return summaries_.size();
+}
+
+void TransactionSummaryCache::AddLocked(TransactionSummary const &summary)
+{
+  ShortId const id = ComputeShortId(summary.transaction_hash);
+
+  auto const result = summaries_.emplace(id, summary);
+  if (!result.second)
+  {
+    // either a duplicate or a short id collision, in both cases the latest summary is kept
+    result.first->second = summary;
+    return;
+  }
+
+  order_.push_back(id);
+}
+
+void TransactionSummaryCache::EvictLocked()
+{
+  while (order_.size() > capacity_)
+  {
+    summaries_.erase(order_.front());
+    order_.pop_front();
+  }
+}
+
+/**
+ * Compute the short id of a transaction. Since the transaction digest is already a cryptographic
+ * hash the first 8 bytes of it are used directly. Collisions are detected when the block digest
+ * of a rebuilt block does not match.
+ *
+ * @param digest The digest of the transaction
+ * @return The short id of the transaction
+ */
+TransactionSummaryCache::ShortId TransactionSummaryCache::ComputeShortId(TxDigest const &digest)
+{
+  ShortId id{0};
+
+  for (std::size_t i = 0, end = std::min(digest.size(), sizeof(ShortId)); i < end; ++i)
+  {
+    id |= static_cast<ShortId>(digest[i]) << (8u * i);
+  }
+
+  return id;
+}
+
+}  // namespace ledger
+}  // namespace fetch
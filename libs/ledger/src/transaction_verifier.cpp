@@ -19,7 +19,9 @@
 #include "ledger/transaction_verifier.hpp"
 #include "core/logger.hpp"
 #include "core/threading.hpp"
+#include "ledger/verified_digest_cache.hpp"
 #include "metrics/metrics.hpp"
+#include "metrics/tracer.hpp"
 #include "network/generics/milli_timer.hpp"
 
 #include <chrono>
@@ -30,6 +32,49 @@ static const std::chrono::milliseconds WAITTIME_FOR_NEW_VERIFIED_TRANSACTIONS_IF
 
 namespace fetch {
 namespace ledger {
+namespace {
+
+/**
+ * Add all the signatures of a batch of transactions to the batch verifier
+ *
+ * @param batch The batch of transactions
+ * @param verifier The verifier to be populated
+ * @return true if all the signatures could be added, otherwise false
+ */
+bool PopulateBatchVerifier(std::vector<MutableTransaction> const &batch,
+                           crypto::ECDSABatchVerifier &           verifier)
+{
+  verifier.Clear();
+
+  for (auto const &mtx : batch)
+  {
+    auto const &signatures = mtx.signatures();
+
+    // transactions without signatures are always invalid
+    if (signatures.empty())
+    {
+      return false;
+    }
+
+    auto tx_sign_adapter = TxSigningAdapterFactory(mtx);
+    for (auto const &sig : signatures)
+    {
+      auto const &identity = sig.first;
+
+      if (identity.identifier().empty())
+      {
+        return false;
+      }
+
+      verifier.Add(identity.identifier(), tx_sign_adapter.HashOfTxDataForSigning(identity),
+                   sig.second.signature_data);
+    }
+  }
+
+  return true;
+}
+
+}  // namespace
 
 TransactionVerifier::~TransactionVerifier()
 {
@@ -80,29 +125,35 @@ void TransactionVerifier::Stop()
  */
 void TransactionVerifier::Verifier()
 {
-  MutableTransaction mtx;
+  MutableTxList pending;
+  MutableTxList batch;
+  BatchVerifier verifier;
 
-  bool success{false};
+  pending.reserve(batch_size_);
+  batch.reserve(batch_size_);
 
   while (active_)
   {
     try
     {
-      // wait for a mutable transaction to be available
-      if (unverified_queue_.Pop(mtx, POP_TIMEOUT))
+      // wait for a mutable transaction to be available, collecting all the other transactions
+      // which are immediately available along with it
+      pending.clear();
+      if (unverified_queue_.PopBulk(pending, batch_size_, POP_TIMEOUT) != 0)
       {
-        // convert the transaction to a verified one and enqueue
-        auto const tx = VerifiedTransaction::Create(mtx, &success);
+        batch.clear();
 
-        // check the status
-        if (success)
+        for (auto &mtx : pending)
         {
-          verified_queue_.Push(tx);
+          if (!DispatchIfVerified(mtx))
+          {
+            batch.emplace_back(std::move(mtx));
+          }
         }
-        else
+
+        if (!batch.empty())
         {
-          FETCH_LOG_WARN(LOGGING_NAME, name_ + " Unable to verify transaction: ",
-                         byte_array::ToBase64(tx.digest()));
+          VerifyBatch(batch, verifier);
         }
       }
     }
@@ -113,6 +164,133 @@ void TransactionVerifier::Verifier()
   }
 }
 
+/**
+ * Internal: Verify a batch of transactions in one pass. In the case that the batch fails, each
+ * transaction is verified individually in order to determine which of them are invalid.
+ *
+ * @param batch The batch of transactions to be verified
+ * @param verifier The batch verifier instance for the current thread
+ */
+void TransactionVerifier::VerifyBatch(MutableTxList const &batch, BatchVerifier &verifier)
+{
+  bool batch_valid{false};
+
+  // batch verification only pays off when there is more than one transaction
+  if (batch.size() > 1)
+  {
+    auto &                     tracer = metrics::Tracer::Instance();
+    std::vector<metrics::Span> spans;
+
+    if (tracer.enabled())
+    {
+      for (auto const &mtx : batch)
+      {
+        auto span = tracer.StartTransactionSpan("tx.verify.batch", mtx.digest());
+        if (span.active())
+        {
+          spans.emplace_back(std::move(span));
+        }
+      }
+    }
+
+    try
+    {
+      batch_valid = PopulateBatchVerifier(batch, verifier) && verifier.Verify();
+    }
+    catch (std::exception const &e)
+    {
+      FETCH_LOG_DEBUG(LOGGING_NAME, name_ + " Unable to batch verify: ", e.what());
+    }
+
+    // end the spans before the transactions are passed on (or individually verified)
+    spans.clear();
+  }
+
+  if (batch_valid)
+  {
+    for (auto const &mtx : batch)
+    {
+      auto tx = VerifiedTransaction::CreatePreVerified(mtx);
+
+      if (verified_cache_)
+      {
+        verified_cache_->Add(tx.digest());
+      }
+
+      verified_queue_.Push(std::move(tx));
+    }
+
+    return;
+  }
+
+  for (auto const &mtx : batch)
+  {
+    VerifyIndividually(mtx);
+  }
+}
+
+/**
+ * Internal: Verify a single transaction and enqueue it if successful
+ *
+ * @param mtx The transaction to be verified
+ */
+void TransactionVerifier::VerifyIndividually(MutableTransaction const &mtx)
+{
+  bool success{false};
+  auto span = metrics::Tracer::Instance().StartTransactionSpan("tx.verify", mtx.digest());
+
+  try
+  {
+    // convert the transaction to a verified one and enqueue
+    auto const tx = VerifiedTransaction::Create(mtx, &success);
+
+    // check the status
+    if (success)
+    {
+      if (verified_cache_)
+      {
+        verified_cache_->Add(tx.digest());
+      }
+
+      verified_queue_.Push(tx);
+    }
+    else
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, name_ + " Unable to verify transaction: ",
+                     byte_array::ToBase64(tx.digest()));
+    }
+  }
+  catch (std::exception const &e)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, name_ + " Exception caught: ", e.what());
+  }
+}
+
+/**
+ * Internal: Pass on a transaction without checking its signatures when it has already been
+ * verified by this node. The digest is recomputed from the contents, so that a transaction can not
+ * claim the digest of another one.
+ *
+ * @param mtx The transaction to be checked
+ * @return true if the transaction had already been verified and has been enqueued, otherwise false
+ */
+bool TransactionVerifier::DispatchIfVerified(MutableTransaction const &mtx)
+{
+  if (verified_cache_ == nullptr)
+  {
+    return false;
+  }
+
+  auto tx = VerifiedTransaction::CreatePreVerified(mtx);
+  if (!verified_cache_->Contains(tx.digest()))
+  {
+    return false;
+  }
+
+  verified_queue_.Push(std::move(tx));
+  return true;
+}
+
 /**
  * Internal: Dispatch thread process for verified transactions to be sent to the storage
  * engine and the mining interface.
@@ -130,17 +308,10 @@ void TransactionVerifier::Dispatcher()
     {
       while (txs.size() < batch_size_ && active_)
       {
-        std::chrono::milliseconds wait_time{WAITTIME_FOR_NEW_VERIFIED_TRANSACTIONS_IF_FLUSH_NEEDED};
-        VerifiedTransaction       tx;
-        if (txs.empty())
-        {
-          wait_time = WAITTIME_FOR_NEW_VERIFIED_TRANSACTIONS;
-        }
-        if (verified_queue_.Pop(tx, wait_time))
-        {
-          txs.emplace_back(std::move(tx));
-        }
-        else
+        auto const wait_time = txs.empty() ? WAITTIME_FOR_NEW_VERIFIED_TRANSACTIONS
+                                           : WAITTIME_FOR_NEW_VERIFIED_TRANSACTIONS_IF_FLUSH_NEEDED;
+
+        if (verified_queue_.PopBulk(txs, batch_size_ - txs.size(), wait_time) == 0)
         {
           break;
         }
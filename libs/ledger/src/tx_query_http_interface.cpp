@@ -23,22 +23,65 @@
 #include "core/macros.hpp"
 #include "http/json_response.hpp"
 #include "ledger/storage_unit/storage_unit_interface.hpp"
+#include "ledger/transaction_address_index.hpp"
 #include "miner/resource_mapper.hpp"
 #include "variant/variant.hpp"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
 static constexpr char const *LOGGING_NAME = "TxQueryAPI";
 
 using fetch::byte_array::FromHex;
 using fetch::byte_array::ToBase64;
+using fetch::byte_array::ToHex;
 using fetch::variant::Variant;
 
 namespace fetch {
 namespace ledger {
+namespace {
+
+/**
+ * Parse an optional unsigned integer query parameter
+ *
+ * @param request The request to read the parameter from
+ * @param name The name of the parameter
+ * @param value The output value, left untouched if the parameter is absent
+ * @return true if the parameter was absent or valid, otherwise false
+ */
+bool ParseQueryValue(http::HTTPRequest const &request, char const *name, uint64_t &value)
+{
+  if (!request.query().Has(name))
+  {
+    return true;
+  }
+
+  std::string const text = static_cast<std::string>(request.query()[name]);
+  if (text.empty() || (text.find_first_not_of("0123456789") != std::string::npos))
+  {
+    return false;
+  }
+
+  errno = 0;
+  value = std::strtoull(text.c_str(), nullptr, 10);
+
+  return errno == 0;
+}
+
+}  // namespace
+
+constexpr std::size_t TxQueryHttpInterface::DEFAULT_LIMIT;
+constexpr std::size_t TxQueryHttpInterface::MAX_LIMIT;
 
-TxQueryHttpInterface::TxQueryHttpInterface(StorageUnitInterface &storage_unit,
-                                           uint32_t              log2_num_lanes)
+TxQueryHttpInterface::TxQueryHttpInterface(StorageUnitInterface &   storage_unit,
+                                           uint32_t                 log2_num_lanes,
+                                           TransactionAddressIndex *address_index)
   : storage_unit_{storage_unit}
   , log2_num_lanes_{log2_num_lanes}
+  , address_index_{address_index}
 {
   Get("/api/tx/(digest=[a-fA-F0-9]{64})/", [this](http::ViewParameters const &params,
                                                   http::HTTPRequest const &   request) {
@@ -83,6 +126,73 @@ TxQueryHttpInterface::TxQueryHttpInterface(StorageUnitInterface &storage_unit,
 
     return http::CreateJsonResponse(tx_obj);
   });
+
+  Get("/api/tx/address/(address=[a-fA-F0-9]{2,512})/",
+      [this](http::ViewParameters const &params, http::HTTPRequest const &request) {
+        return QueryAddress(params, request);
+      });
+}
+
+/**
+ * Query the executed transactions which touched an address, in block number order. The optional
+ * query parameters `from` and `to` select an (inclusive) range of block numbers, while `offset`
+ * and `limit` page through the transactions of the range.
+ *
+ * @param params The view parameters, containing the hex encoded address
+ * @param request The request
+ * @return The response
+ */
+http::HTTPResponse TxQueryHttpInterface::QueryAddress(http::ViewParameters const &params,
+                                                      http::HTTPRequest const &   request)
+{
+  if (address_index_ == nullptr)
+  {
+    return http::CreateJsonResponse(R"({"error": "address index disabled"})",
+                                    http::Status::SERVER_ERROR_NOT_IMPLEMENTED);
+  }
+
+  if (!params.Has("address") || ((params["address"].size() % 2) != 0))
+  {
+    return http::CreateJsonResponse("{}", http::Status::CLIENT_ERROR_BAD_REQUEST);
+  }
+
+  uint64_t from{0};
+  uint64_t to{std::numeric_limits<uint64_t>::max()};
+  uint64_t offset{0};
+  uint64_t limit{DEFAULT_LIMIT};
+
+  if (!ParseQueryValue(request, "from", from) || !ParseQueryValue(request, "to", to) ||
+      !ParseQueryValue(request, "offset", offset) || !ParseQueryValue(request, "limit", limit))
+  {
+    return http::CreateJsonResponse(R"({"error": "malformed query parameters"})",
+                                    http::Status::CLIENT_ERROR_BAD_REQUEST);
+  }
+
+  limit = std::min<uint64_t>(limit, MAX_LIMIT);
+
+  auto const address = FromHex(params["address"]);
+
+  TransactionAddressIndex::Entries entries{};
+  std::size_t const                total = address_index_->Query(
+      address, from, to, static_cast<std::size_t>(offset), static_cast<std::size_t>(limit),
+      entries);
+
+  Variant response    = Variant::Object();
+  response["address"] = params["address"];
+  response["total"]   = total;
+  response["offset"]  = offset;
+  response["txs"]     = Variant::Array(entries.size());
+
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    Variant entry        = Variant::Object();
+    entry["digest"]      = ToHex(entries[i].digest);
+    entry["blockNumber"] = entries[i].block_number;
+
+    response["txs"][i] = entry;
+  }
+
+  return http::CreateJsonResponse(response);
 }
 
 }  // namespace ledger
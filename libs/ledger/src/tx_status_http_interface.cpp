@@ -19,21 +19,97 @@
 #include "ledger/tx_status_http_interface.hpp"
 #include "core/byte_array/decoders.hpp"
 #include "core/byte_array/encoders.hpp"
+#include "core/json/document.hpp"
 #include "core/logger.hpp"
 #include "core/macros.hpp"
+#include "core/threading.hpp"
 #include "http/json_response.hpp"
-#include "ledger/transaction_status_cache.hpp"
 #include "variant/variant.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
 static constexpr char const *LOGGING_NAME = "TxStatusHttp";
 
+using fetch::byte_array::ConstByteArray;
 using fetch::byte_array::FromHex;
 using fetch::byte_array::ToBase64;
+using fetch::byte_array::ToHex;
 using fetch::variant::Variant;
 
 namespace fetch {
 namespace ledger {
+namespace {
+
+std::size_t const DIGEST_LENGTH_BYTES = 32;
+
+http::HTTPResponse WatchError(std::string const &error)
+{
+  Variant response  = Variant::Object();
+  response["error"] = error;
+
+  return http::CreateJsonResponse(response, http::Status::CLIENT_ERROR_BAD_REQUEST);
+}
+
+}  // namespace
+
+constexpr std::size_t TxStatusHttpInterface::MAX_WATCHED_TXS;
+constexpr uint64_t    TxStatusHttpInterface::DEFAULT_WATCH_TIMEOUT;
+constexpr uint64_t    TxStatusHttpInterface::MAX_WATCH_TIMEOUT;
+
+/**
+ * A request waiting on a change to the status of a set of transactions
+ */
+struct TxStatusHttpInterface::Watch
+{
+  using TxDigests       = TransactionStatusCache::TxDigests;
+  using SubscriptionPtr = TransactionStatusCache::SubscriptionPtr;
+
+  Watch(TransactionStatusCache &status_cache, Responder responder)
+    : cache{status_cache}
+    , respond{std::move(responder)}
+  {}
+
+  /**
+   * Respond with the current status of every transaction, only the first call has any effect
+   *
+   * @param changed Whether the response was triggered by a change
+   */
+  void Complete(bool changed)
+  {
+    if (done.exchange(true))
+    {
+      return;
+    }
+
+    Variant txs = Variant::Object();
+    for (auto const &digest : digests)
+    {
+      txs[ToHex(digest)] = ToString(cache.Query(digest));
+    }
+
+    Variant response    = Variant::Object();
+    response["changed"] = changed;
+    response["txs"]     = txs;
 
+    respond(http::CreateJsonResponse(response));
+  }
+
+  TransactionStatusCache &cache;
+  Responder               respond;
+  TxDigests               digests{};
+  SubscriptionPtr         subscription{};  ///< Only accessed by the requesting and expiry threads
+  std::atomic<bool>       done{false};
+};
+
+/**
+ * Construct the transaction status interface
+ *
+ * @param status_cache The cache of the transaction statuses
+ */
 TxStatusHttpInterface::TxStatusHttpInterface(TransactionStatusCache &status_cache)
   : status_cache_{status_cache}
 {
@@ -60,6 +136,230 @@ TxStatusHttpInterface::TxStatusHttpInterface(TransactionStatusCache &status_cach
           return http::CreateJsonResponse("{}", http::Status::CLIENT_ERROR_BAD_REQUEST);
         }
       });
+
+  AddDeferredView(http::Method::POST, "/api/status/tx/watch",
+                  [this](http::ViewParameters const &, http::HTTPRequest const &request,
+                         Responder const &responder) { OnWatch(request, responder); });
+
+  expiry_thread_ = std::thread{&TxStatusHttpInterface::ExpireWatches, this};
+}
+
+TxStatusHttpInterface::~TxStatusHttpInterface()
+{
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    running_ = false;
+  }
+
+  wake_.notify_all();
+  expiry_thread_.join();
+
+  // answer the outstanding requests rather than leaving them hanging
+  for (auto &element : deadlines_)
+  {
+    status_cache_.Unsubscribe(element.second->subscription);
+    element.second->Complete(false);
+  }
+}
+
+/**
+ * Handle a watch request. The body is a JSON object of the form:
+ *
+ *   {"txs": {"<hex digest>": "<last seen status>", ...}, "timeout": <seconds>}
+ *
+ * The request is answered as soon as the status of one of the transactions differs from the
+ * status given for it, or once the timeout expires. The transactions can also be given as an
+ * array of digests, in which case their current statuses are the ones which are watched.
+ *
+ * @param request The originating HTTPRequest object
+ * @param responder The function to be called with the response
+ */
+void TxStatusHttpInterface::OnWatch(http::HTTPRequest const &request, Responder const &responder)
+{
+  using TxDigest  = TransactionStatusCache::TxDigest;
+  using TxDigests = TransactionStatusCache::TxDigests;
+  using Statuses  = std::vector<TransactionStatus>;
+
+  json::JSONDocument doc;
+  try
+  {
+    doc.Parse(request.body());
+  }
+  catch (std::exception const &ex)
+  {
+    responder(WatchError(std::string{"Unable to parse request: "} + ex.what()));
+    return;
+  }
+
+  auto const &root = doc.root();
+  if (!root.IsObject() || !root.Has("txs"))
+  {
+    responder(WatchError("Missing transactions to be watched"));
+    return;
+  }
+
+  // parse the digests and the statuses last seen by the client (if any)
+  TxDigests   digests{};
+  Statuses    known{};
+  bool        has_known{false};
+  std::string error{};
+
+  auto const parse_digest = [&digests, &error](ConstByteArray const &hex) {
+    ConstByteArray const digest = FromHex(hex);
+    if (digest.size() != DIGEST_LENGTH_BYTES)
+    {
+      error = "Invalid transaction digest: " + static_cast<std::string>(hex);
+      return false;
+    }
+
+    digests.push_back(digest);
+    return true;
+  };
+
+  auto const &txs = root["txs"];
+  if (txs.IsArray())
+  {
+    for (std::size_t i = 0; (i < txs.size()) && error.empty(); ++i)
+    {
+      if (!txs[i].IsString())
+      {
+        error = "Transaction digests must be strings";
+        break;
+      }
+
+      parse_digest(txs[i].As<ConstByteArray>());
+    }
+  }
+  else if (txs.IsObject())
+  {
+    has_known = true;
+
+    txs.IterateObject([&](ConstByteArray const &hex, Variant const &value) {
+      TransactionStatus status{TransactionStatus::UNKNOWN};
+      if (!value.IsString() || !FromString(value.As<std::string>(), status))
+      {
+        error = "Invalid status for transaction: " + static_cast<std::string>(hex);
+        return false;
+      }
+
+      known.push_back(status);
+      return parse_digest(hex);
+    });
+  }
+  else
+  {
+    error = "Transactions must be an array or an object";
+  }
+
+  if (error.empty() && (digests.empty() || (digests.size() > MAX_WATCHED_TXS)))
+  {
+    error = "Between 1 and " + std::to_string(MAX_WATCHED_TXS) + " transactions can be watched";
+  }
+
+  uint64_t timeout = DEFAULT_WATCH_TIMEOUT;
+  if (error.empty() && root.Has("timeout"))
+  {
+    if (!root["timeout"].IsInteger() || (root["timeout"].As<int64_t>() < 0))
+    {
+      error = "Invalid timeout";
+    }
+    else
+    {
+      timeout = std::min(static_cast<uint64_t>(root["timeout"].As<int64_t>()), MAX_WATCH_TIMEOUT);
+    }
+  }
+
+  if (!error.empty())
+  {
+    responder(WatchError(error));
+    return;
+  }
+
+  auto watch     = std::make_shared<Watch>(status_cache_, responder);
+  watch->digests = digests;
+
+  // subscribe before checking the current statuses, so that no change can be missed
+  std::weak_ptr<Watch> weak_watch{watch};
+  auto const notification = [weak_watch](TxDigest const &, TransactionStatus) {
+    auto watch = weak_watch.lock();
+    if (watch)
+    {
+      watch->Complete(true);
+    }
+  };
+
+  watch->subscription = status_cache_.Subscribe(std::move(digests), notification);
+
+  bool changed{false};
+  if (has_known)
+  {
+    for (std::size_t i = 0; (i < known.size()) && !changed; ++i)
+    {
+      changed = (status_cache_.Query(watch->digests[i]) != known[i]);
+    }
+  }
+
+  if (changed || (timeout == 0))
+  {
+    status_cache_.Unsubscribe(watch->subscription);
+    watch->Complete(changed);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    deadlines_.emplace(Clock::now() + std::chrono::seconds{timeout}, std::move(watch));
+  }
+
+  wake_.notify_one();
+}
+
+/**
+ * Thread answering the watches whose timeout has expired
+ */
+void TxStatusHttpInterface::ExpireWatches()
+{
+  SetThreadName("TxWatch");
+
+  std::vector<WatchPtr> expired{};
+
+  std::unique_lock<std::mutex> lock(lock_);
+  while (running_)
+  {
+    if (deadlines_.empty())
+    {
+      wake_.wait(lock);
+    }
+    else
+    {
+      wake_.wait_until(lock, deadlines_.begin()->first);
+    }
+
+    // also discards the watches which have already been answered by a change
+    auto const now = Clock::now();
+    while (!deadlines_.empty() && (deadlines_.begin()->first <= now))
+    {
+      expired.push_back(std::move(deadlines_.begin()->second));
+      deadlines_.erase(deadlines_.begin());
+    }
+
+    if (expired.empty())
+    {
+      continue;
+    }
+
+    lock.unlock();
+
+    for (auto const &watch : expired)
+    {
+      status_cache_.Unsubscribe(watch->subscription);
+      watch->Complete(false);
+    }
+
+    expired.clear();
+
+    lock.lock();
+  }
 }
 
 }  // namespace ledger
@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/verified_digest_cache.hpp"
+
+#include <algorithm>
+
+namespace fetch {
+namespace ledger {
+
+constexpr std::size_t VerifiedDigestCache::DEFAULT_CAPACITY;
+constexpr std::size_t VerifiedDigestCache::NUM_SHARDS;
+
+/**
+ * Construct the verified digest cache
+ *
+ * @param capacity The maximum number of digests to be cached (across all the shards)
+ */
+VerifiedDigestCache::VerifiedDigestCache(std::size_t capacity)
+  : shard_capacity_{std::max<std::size_t>(capacity / NUM_SHARDS, 1)}
+{}
+
+/**
+ * Record that the transaction with the specified digest has been verified, evicting the oldest
+ * digests of the shard if required
+ *
+ * @param digest The digest of the verified transaction
+ */
+void VerifiedDigestCache::Add(TxDigest const &digest)
+{
+  Key const key   = ToKey(digest);
+  auto &    shard = LookupShard(key);
+
+  FETCH_LOCK(shard.lock);
+
+  if (!shard.keys.insert(key).second)
+  {
+    return;
+  }
+
+  shard.order.push_back(key);
+
+  while (shard.order.size() > shard_capacity_)
+  {
+    shard.keys.erase(shard.order.front());
+    shard.order.pop_front();
+  }
+}
+
+/**
+ * Determine if the transaction with the specified digest has already been verified
+ *
+ * @param digest The digest of the transaction
+ * @return true if the transaction has been verified, otherwise false
+ */
+bool VerifiedDigestCache::Contains(TxDigest const &digest) const
+{
+  Key const   key   = ToKey(digest);
+  auto const &shard = LookupShard(key);
+
+  FETCH_LOCK(shard.lock);
+  return shard.keys.find(key) != shard.keys.end();
+}
+
+/**
+ * Get the number of digests in the cache
+ *
+ * @return The number of digests
+ */
+std::size_t VerifiedDigestCache::size() const
+{
+  std::size_t total{0};
+
+  for (auto const &shard : shards_)
+  {
+    FETCH_LOCK(shard.lock);
+    total += shard.keys.size();
+  }
+
+  return total;
+}
+
+/**
+ * Build the key of a digest from its first 16 bytes. Shorter digests are zero padded, although
+ * this is not expected since the digest is a SHA256 hash.
+ *
+ * @param digest The digest of the transaction
+ * @return The key of the digest
+ */
+VerifiedDigestCache::Key VerifiedDigestCache::ToKey(TxDigest const &digest)
+{
+  Key key{};
+
+  for (std::size_t i = 0, end = std::min<std::size_t>(digest.size(), 16); i < end; ++i)
+  {
+    uint64_t &word = (i < 8) ? key.low : key.high;
+    word |= static_cast<uint64_t>(digest[i]) << (8u * (i % 8));
+  }
+
+  return key;
+}
+
+VerifiedDigestCache::Shard &VerifiedDigestCache::LookupShard(Key const &key)
+{
+  return shards_[key.high % NUM_SHARDS];
+}
+
+VerifiedDigestCache::Shard const &VerifiedDigestCache::LookupShard(Key const &key) const
+{
+  return shards_[key.high % NUM_SHARDS];
+}
+
+}  // namespace ledger
+}  // namespace fetch
@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/admission_controller.hpp"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstddef>
+
+namespace {
+
+using fetch::ledger::AdmissionController;
+using Decision  = AdmissionController::Decision;
+using Config    = AdmissionController::Config;
+using Clock     = AdmissionController::Clock;
+using Timepoint = AdmissionController::Timepoint;
+
+Config MakeConfig()
+{
+  Config config;
+  config.client_rate  = 100.0;
+  config.client_burst = 100.0;
+  config.signer_rate  = 10.0;
+  config.signer_burst = 10.0;
+  config.shed_depth   = 1000;
+  config.max_depth    = 2000;
+
+  return config;
+}
+
+TEST(AdmissionControllerTests, CheckClientBurstAndRefill)
+{
+  AdmissionController admission{MakeConfig(), []() { return std::size_t{0}; }};
+
+  Timepoint const start = Clock::now();
+
+  EXPECT_EQ(Decision::ADMITTED, admission.AdmitClient("client", 60, start));
+  EXPECT_EQ(Decision::ADMITTED, admission.AdmitClient("client", 40, start));
+  EXPECT_EQ(Decision::RATE_LIMITED, admission.AdmitClient("client", 1, start));
+
+  // other clients are not affected
+  EXPECT_EQ(Decision::ADMITTED, admission.AdmitClient("other", 100, start));
+
+  // half a second refills half of the bucket
+  Timepoint const later = start + std::chrono::milliseconds{500};
+  EXPECT_EQ(Decision::RATE_LIMITED, admission.AdmitClient("client", 51, later));
+  EXPECT_EQ(Decision::ADMITTED, admission.AdmitClient("client", 50, later));
+
+  EXPECT_EQ(1u + 51u, admission.counters().rate_limited_client.load());
+  EXPECT_EQ(2u, admission.GetNumClients());
+}
+
+TEST(AdmissionControllerTests, CheckSignersAreLimitedIndependently)
+{
+  AdmissionController admission{MakeConfig(), []() { return std::size_t{0}; }};
+
+  Timepoint const now = Clock::now();
+
+  for (std::size_t i = 0; i < 10; ++i)
+  {
+    EXPECT_EQ(Decision::ADMITTED, admission.AdmitSigner("flood", now));
+  }
+
+  EXPECT_EQ(Decision::RATE_LIMITED, admission.AdmitSigner("flood", now));
+  EXPECT_EQ(Decision::ADMITTED, admission.AdmitSigner("quiet", now));
+
+  // unsigned transactions are only limited by their client
+  for (std::size_t i = 0; i < 20; ++i)
+  {
+    EXPECT_EQ(Decision::ADMITTED, admission.AdmitSigner("", now));
+  }
+
+  EXPECT_EQ(31u, admission.counters().admitted.load());
+  EXPECT_EQ(1u, admission.counters().rate_limited_signer.load());
+}
+
+TEST(AdmissionControllerTests, CheckLoadShedding)
+{
+  std::size_t depth{0};
+
+  AdmissionController admission{MakeConfig(), [&depth]() { return depth; }};
+
+  Timepoint const start = Clock::now();
+
+  // drain the bucket of the client
+  EXPECT_EQ(Decision::ADMITTED, admission.AdmitClient("client", 100, start));
+  EXPECT_DOUBLE_EQ(0.0, admission.GetPressure());
+
+  // half way to the maximum depth the bucket refills at half the rate
+  depth = 1500;
+  EXPECT_DOUBLE_EQ(0.5, admission.GetPressure());
+
+  Timepoint const later = start + std::chrono::seconds{1};
+  EXPECT_EQ(Decision::RATE_LIMITED, admission.AdmitClient("client", 51, later));
+  EXPECT_EQ(Decision::ADMITTED, admission.AdmitClient("client", 50, later));
+
+  // submissions which would overflow the pipeline are rejected outright
+  EXPECT_EQ(Decision::OVERLOADED, admission.AdmitClient("other", 501, later));
+  EXPECT_FALSE(admission.IsOverloaded());
+
+  depth = 2000;
+  EXPECT_TRUE(admission.IsOverloaded());
+  EXPECT_EQ(Decision::OVERLOADED, admission.AdmitClient("other", 1, later));
+  EXPECT_EQ(502u, admission.counters().overloaded.load());
+}
+
+}  // namespace
@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/byte_array.hpp"
+#include "ledger/chain/block.hpp"
+#include "ledger/protocols/compact_block.hpp"
+#include "ledger/transaction_summary_cache.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+
+using fetch::byte_array::ByteArray;
+using fetch::ledger::Block;
+using fetch::ledger::CompactBlock;
+using fetch::ledger::TransactionSummary;
+using fetch::ledger::TransactionSummaryCache;
+
+TransactionSummary MakeSummary(uint8_t id)
+{
+  ByteArray digest;
+  digest.Resize(32);
+  for (std::size_t i = 0; i < digest.size(); ++i)
+  {
+    digest[i] = static_cast<uint8_t>(id + i);
+  }
+
+  TransactionSummary summary;
+  summary.transaction_hash = digest;
+  summary.contract_name    = "fetch.token.transfer";
+  summary.fee              = id;
+  summary.resources.insert("resource");
+
+  return summary;
+}
+
+Block MakeBlock()
+{
+  Block block;
+  block.body.previous_hash = "previous";
+  block.body.block_number  = 42;
+  block.body.slices.resize(2);
+  block.body.slices[0] = {MakeSummary(1), MakeSummary(2)};
+  block.body.slices[1] = {MakeSummary(3), MakeSummary(4), MakeSummary(5)};
+  block.UpdateDigest();
+
+  return block;
+}
+
+TEST(CompactBlockTests, CheckCacheEvictsOldestSummaries)
+{
+  TransactionSummaryCache cache{2};
+
+  cache.Add(MakeSummary(1));
+  cache.Add(MakeSummary(2));
+  cache.Add(MakeSummary(3));
+
+  auto const oldest = TransactionSummaryCache::ComputeShortId(MakeSummary(1).transaction_hash);
+  auto const newest = TransactionSummaryCache::ComputeShortId(MakeSummary(3).transaction_hash);
+
+  TransactionSummary summary;
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_FALSE(cache.Lookup(oldest, summary));
+  EXPECT_TRUE(cache.Lookup(newest, summary));
+  EXPECT_EQ(summary.fee, 3u);
+}
+
+TEST(CompactBlockTests, CheckRebuiltFromCache)
+{
+  Block const block = MakeBlock();
+
+  TransactionSummaryCache cache;
+  for (auto const &slice : block.body.slices)
+  {
+    for (auto const &tx : slice)
+    {
+      cache.Add(tx);
+    }
+  }
+
+  CompactBlock const compact{block};
+  EXPECT_TRUE(compact.header.body.slices.empty());
+  ASSERT_EQ(compact.slices.size(), 2u);
+
+  Block rebuilt;
+  EXPECT_TRUE(compact.Reconstruct(&cache, rebuilt).empty());
+
+  rebuilt.UpdateDigest();
+  EXPECT_EQ(rebuilt.body.hash, block.body.hash);
+  EXPECT_EQ(rebuilt.body.slices[1][2].fee, 5u);
+}
+
+TEST(CompactBlockTests, CheckMissingTransactionsFilled)
+{
+  Block const block = MakeBlock();
+
+  TransactionSummaryCache cache;
+  cache.Add(MakeSummary(1));
+  cache.Add(MakeSummary(4));
+
+  CompactBlock const compact{block};
+
+  Block rebuilt;
+  auto const missing = compact.Reconstruct(&cache, rebuilt);
+  ASSERT_EQ(missing, (CompactBlock::Indices{1, 2, 4}));
+
+  // the summaries as returned by the sender of the block
+  CompactBlock::TxSummaries const summaries{MakeSummary(2), MakeSummary(3), MakeSummary(5)};
+  ASSERT_TRUE(CompactBlock::Fill(rebuilt, missing, summaries));
+
+  rebuilt.UpdateDigest();
+  EXPECT_EQ(rebuilt.body.hash, block.body.hash);
+}
+
+TEST(CompactBlockTests, CheckFillRejectsIncompleteResponse)
+{
+  Block const block = MakeBlock();
+
+  CompactBlock const compact{block};
+
+  Block rebuilt;
+  auto const missing = compact.Reconstruct(nullptr, rebuilt);
+  EXPECT_EQ(missing.size(), block.GetTransactionCount());
+
+  EXPECT_FALSE(CompactBlock::Fill(rebuilt, missing, {MakeSummary(1)}));
+}
+
+}  // namespace
@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/conflict_scheduler.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+
+namespace {
+
+using fetch::ledger::ConflictScheduler;
+using fetch::storage::ResourceAddress;
+using ResourceAddresses = ConflictScheduler::ResourceAddresses;
+
+ResourceAddresses Resources(std::initializer_list<char const *> names)
+{
+  ResourceAddresses resources{};
+  for (auto const *name : names)
+  {
+    resources.emplace_back(std::string{name});
+  }
+  return resources;
+}
+
+TEST(ConflictSchedulerTests, CheckIndependentTransactionsShareASlice)
+{
+  ConflictScheduler scheduler{};
+
+  // a block which the miner has split into one transaction per slice
+  EXPECT_EQ(0u, scheduler.Schedule(Resources({"a"})));
+  EXPECT_EQ(0u, scheduler.Schedule(Resources({"b"})));
+  EXPECT_EQ(0u, scheduler.Schedule(Resources({"c", "d"})));
+  EXPECT_EQ(0u, scheduler.Schedule(Resources({})));
+
+  EXPECT_EQ(1u, scheduler.num_slices());
+}
+
+TEST(ConflictSchedulerTests, CheckConflictingTransactionsKeepBlockOrder)
+{
+  ConflictScheduler scheduler{};
+
+  EXPECT_EQ(0u, scheduler.Schedule(Resources({"a", "b"})));
+  EXPECT_EQ(0u, scheduler.Schedule(Resources({"c"})));
+  EXPECT_EQ(1u, scheduler.Schedule(Resources({"b"})));
+  EXPECT_EQ(1u, scheduler.Schedule(Resources({"c", "d"})));
+  EXPECT_EQ(2u, scheduler.Schedule(Resources({"d", "e"})));
+  EXPECT_EQ(1u, scheduler.Schedule(Resources({"a"})));
+  EXPECT_EQ(0u, scheduler.Schedule(Resources({"f"})));
+
+  EXPECT_EQ(3u, scheduler.num_slices());
+}
+
+TEST(ConflictSchedulerTests, CheckFollowsTheLatestConflict)
+{
+  ConflictScheduler scheduler{};
+
+  EXPECT_EQ(0u, scheduler.Schedule(Resources({"a"})));
+  EXPECT_EQ(1u, scheduler.Schedule(Resources({"a"})));
+  EXPECT_EQ(2u, scheduler.Schedule(Resources({"a"})));
+  EXPECT_EQ(0u, scheduler.Schedule(Resources({"b"})));
+
+  // must follow both the last access of "a" and of "b"
+  EXPECT_EQ(3u, scheduler.Schedule(Resources({"b", "a"})));
+  EXPECT_EQ(4u, scheduler.Schedule(Resources({"b"})));
+
+  EXPECT_EQ(5u, scheduler.num_slices());
+}
+
+}  // namespace
@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "ledger/lane_bitmap.hpp"
+
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using fetch::ledger::LaneBitmap;
+using LaneIndex = LaneBitmap::LaneIndex;
+
+std::vector<LaneIndex> ToVector(LaneBitmap const &bitmap)
+{
+  std::vector<LaneIndex> lanes{};
+  bitmap.ForEach([&lanes](LaneIndex lane) { lanes.push_back(lane); });
+  return lanes;
+}
+
+TEST(LaneBitmapTests, CheckEmptyBitmap)
+{
+  LaneBitmap bitmap{};
+
+  EXPECT_TRUE(bitmap.empty());
+  EXPECT_EQ(0u, bitmap.count());
+  EXPECT_EQ(LaneBitmap::MAX_LANES, std::size_t{bitmap.lowest()});
+  EXPECT_TRUE(ToVector(bitmap).empty());
+}
+
+TEST(LaneBitmapTests, CheckSetAndReset)
+{
+  LaneBitmap bitmap{1023, 5, 64, 63};
+
+  EXPECT_FALSE(bitmap.empty());
+  EXPECT_EQ(4u, bitmap.count());
+  EXPECT_EQ(5u, bitmap.lowest());
+  EXPECT_TRUE(bitmap.Test(64));
+  EXPECT_FALSE(bitmap.Test(65));
+  EXPECT_FALSE(bitmap.Test(5000));
+  EXPECT_EQ((std::vector<LaneIndex>{5, 63, 64, 1023}), ToVector(bitmap));
+
+  bitmap.Reset(5);
+  EXPECT_EQ(63u, bitmap.lowest());
+  EXPECT_EQ(3u, bitmap.count());
+}
+
+TEST(LaneBitmapTests, CheckOverlaps)
+{
+  LaneBitmap const a{1, 100, 700};
+  LaneBitmap const b{2, 101, 700};
+  LaneBitmap const c{3, 102, 701};
+
+  EXPECT_TRUE(a.Overlaps(b));
+  EXPECT_FALSE(a.Overlaps(c));
+  EXPECT_FALSE(a.Overlaps(LaneBitmap{}));
+
+  LaneBitmap merged{a};
+  merged |= c;
+  EXPECT_EQ(6u, merged.count());
+  EXPECT_TRUE(merged.Overlaps(c));
+
+  merged.Remove(a);
+  EXPECT_EQ(c, merged);
+
+  merged &= b;
+  EXPECT_TRUE(merged.empty());
+}
+
+TEST(LaneBitmapTests, CheckRange)
+{
+  LaneBitmap const range = LaneBitmap::Range(62, 130);
+
+  EXPECT_EQ(68u, range.count());
+  EXPECT_EQ(62u, range.lowest());
+  EXPECT_FALSE(range.Test(130));
+}
+
+TEST(LaneBitmapTests, CheckOutOfRangeLanesAreRejected)
+{
+  LaneBitmap bitmap{};
+  EXPECT_THROW(bitmap.Set(1024), std::out_of_range);
+  EXPECT_TRUE(bitmap.empty());
+}
+
+}  // namespace
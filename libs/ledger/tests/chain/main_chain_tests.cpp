@@ -24,6 +24,8 @@
 #include "ledger/testing/block_generator.hpp"
 
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <list>
 #include <memory>
 #include <random>
 
@@ -604,6 +606,50 @@ TEST_P(MainChainTests, CheckLongChainWrite)
   }
 }
 
+TEST_P(MainChainTests, CheckStoredBlocksRetainTheirSlices)
+{
+  using fetch::ledger::TransactionSummary;
+
+  static constexpr std::size_t NUM_BLOCKS = 40;
+
+  auto previous_block = generator_->Generate();
+
+  // build a chain which is long enough for the old blocks to be written to storage
+  std::vector<BlockPtr> blocks{NUM_BLOCKS};
+  for (std::size_t i = 0; i < NUM_BLOCKS; ++i)
+  {
+    TransactionSummary tx;
+    tx.transaction_hash = fetch::byte_array::ConstByteArray{"tx-" + std::to_string(i)};
+
+    auto next_block = generator_->Generate(previous_block);
+    next_block->body.slices.front().push_back(tx);
+    next_block->UpdateDigest();
+
+    ASSERT_EQ(BlockStatus::ADDED, chain_->AddBlock(*next_block));
+
+    previous_block = next_block;
+    blocks[i]      = next_block;
+  }
+
+  // the complete blocks are available regardless of where they are held
+  for (auto const &block : blocks)
+  {
+    auto const retrieved_block = chain_->GetBlock(block->body.hash);
+    ASSERT_TRUE(retrieved_block);
+    EXPECT_TRUE(retrieved_block->has_body);
+    EXPECT_EQ(block->body.hash, retrieved_block->body.hash);
+    EXPECT_EQ(block->body.slices, retrieved_block->body.slices);
+  }
+
+  // the heaviest chain runs from the heaviest block down to (and including) genesis
+  auto const heaviest_chain = chain_->GetHeaviestChain();
+  ASSERT_EQ(NUM_BLOCKS + 1, heaviest_chain.size());
+  for (std::size_t i = 0; i < NUM_BLOCKS; ++i)
+  {
+    EXPECT_EQ(blocks[NUM_BLOCKS - (i + 1)]->body.slices, heaviest_chain[i]->body.slices);
+  }
+}
+
 TEST_P(MainChainTests, CheckInOrderWeights)
 {
   auto genesis = generator_->Generate();
@@ -685,6 +731,125 @@ TEST_P(MainChainTests, CheckResolvedLooseWeight)
   ASSERT_EQ(chain_->GetBlock(main5->body.hash)->total_weight, main5->total_weight);
 }
 
+TEST_P(MainChainTests, CheckHeaviestTipWithManyForks)
+{
+  static constexpr std::size_t MAIN_CHAIN_LENGTH = 8;
+  static constexpr std::size_t NUM_FORKS         = 200;
+
+  std::vector<BlockPtr> main_chain{generator_->Generate()};
+  for (std::size_t i = 0; i < MAIN_CHAIN_LENGTH; ++i)
+  {
+    main_chain.push_back(generator_->Generate(main_chain.back()));
+    ASSERT_EQ(BlockStatus::ADDED, chain_->AddBlock(*main_chain.back()));
+  }
+
+  // create a large number of (short) forks from the recent blocks of the main chain
+  Rng rng{42};
+  for (std::size_t i = 0; i < NUM_FORKS; ++i)
+  {
+    auto const &parent = main_chain.at(MAIN_CHAIN_LENGTH - (rng() % 3));
+    auto const  fork   = generator_->Generate(parent);
+
+    ASSERT_EQ(BlockStatus::ADDED, chain_->AddBlock(*fork));
+  }
+
+  auto const heaviest_hash = chain_->GetHeaviestBlockHash();
+  EXPECT_EQ(heaviest_hash, chain_->GetHeaviestBlock()->body.hash);
+
+  // the incrementally tracked tip must match the one determined from scratch
+  ASSERT_TRUE(chain_->ReindexTips());
+  EXPECT_EQ(heaviest_hash, chain_->GetHeaviestBlockHash());
+}
+
+TEST_P(MainChainTests, CheckStripAlreadySeenTx)
+{
+  using fetch::ledger::TransactionSummary;
+
+  struct Entry
+  {
+    TransactionSummary transaction;
+  };
+
+  static constexpr std::size_t NUM_BLOCKS = 20;
+
+  auto const make_tx = [](std::size_t index) {
+    TransactionSummary tx;
+    tx.transaction_hash = fetch::byte_array::ConstByteArray{"tx-" + std::to_string(index)};
+    return tx;
+  };
+
+  // build a chain where each block contains a single transaction
+  auto previous_block = generator_->Generate();
+  for (std::size_t i = 0; i < NUM_BLOCKS; ++i)
+  {
+    auto next_block = generator_->Generate(previous_block);
+    next_block->body.slices.front().push_back(make_tx(i));
+
+    ASSERT_EQ(BlockStatus::ADDED, chain_->AddBlock(*next_block));
+    previous_block = next_block;
+  }
+
+  // a mixture of old, recent and new transactions
+  std::list<Entry> container{{make_tx(0)}, {make_tx(100)}, {make_tx(NUM_BLOCKS - 1)},
+                             {make_tx(101)}};
+
+  ASSERT_TRUE(chain_->StripAlreadySeenTx(previous_block->body.hash, container));
+  ASSERT_EQ(2u, container.size());
+  EXPECT_EQ(make_tx(100).transaction_hash, container.front().transaction.transaction_hash);
+  EXPECT_EQ(make_tx(101).transaction_hash, container.back().transaction.transaction_hash);
+
+  // all new transactions should be left untouched
+  std::list<Entry> new_only{{make_tx(200)}, {make_tx(201)}};
+  ASSERT_TRUE(chain_->StripAlreadySeenTx(previous_block->body.hash, new_only));
+  EXPECT_EQ(2u, new_only.size());
+}
+
+TEST(MainChainPersistenceTests, CheckRecoveryFromDisk)
+{
+  static constexpr std::size_t NUM_BLOCKS = 30;
+
+  BlockGenerator generator{1, 2};
+  BlockHash      recovered_hash{};
+
+  {
+    MainChain chain{MainChain::Mode::CREATE_PERSISTENT_DB};
+
+    auto previous_block = generator.Generate();
+    for (std::size_t i = 0; i < NUM_BLOCKS; ++i)
+    {
+      auto next_block = generator.Generate(previous_block);
+      ASSERT_EQ(BlockStatus::ADDED, chain.AddBlock(*next_block));
+
+      previous_block = next_block;
+    }
+  }
+
+  // the chain should be recovered from the block index
+  {
+    MainChain chain{MainChain::Mode::LOAD_PERSISTENT_DB};
+
+    auto const heaviest = chain.GetHeaviestBlock();
+    ASSERT_TRUE(heaviest);
+    EXPECT_GT(heaviest->body.block_number, 0u);
+
+    recovered_hash = heaviest->body.hash;
+  }
+
+  // without the index the chain should be walked and the same heaviest block recovered
+  std::remove("chain.block_index.db");
+
+  {
+    MainChain chain{MainChain::Mode::LOAD_PERSISTENT_DB};
+    EXPECT_EQ(recovered_hash, chain.GetHeaviestBlockHash());
+  }
+
+  // the index should have been rebuilt
+  {
+    MainChain chain{MainChain::Mode::LOAD_PERSISTENT_DB};
+    EXPECT_EQ(recovered_hash, chain.GetHeaviestBlockHash());
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(ParamBased, MainChainTests,
                         ::testing::Values(MainChain::Mode::CREATE_PERSISTENT_DB,
                                           MainChain::Mode::IN_MEMORY_DB), );
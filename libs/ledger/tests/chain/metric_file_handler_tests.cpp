@@ -0,0 +1,233 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/byte_array.hpp"
+#include "metrics/metric_aggregator.hpp"
+#include "metrics/metric_file_format.hpp"
+#include "metrics/metric_file_handler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using fetch::byte_array::ByteArray;
+using fetch::byte_array::ConstByteArray;
+using fetch::metrics::MetricAggregator;
+using fetch::metrics::MetricFileFormat;
+using fetch::metrics::MetricFileHandler;
+using fetch::metrics::MetricRecord;
+
+using Event      = MetricFileHandler::Event;
+using Instrument = MetricFileHandler::Instrument;
+using Records    = std::vector<MetricRecord>;
+
+class MetricFileHandlerTests : public ::testing::Test
+{
+protected:
+  void TearDown() override
+  {
+    std::remove(FILENAME);
+  }
+
+  static ConstByteArray CreateDigest(std::size_t index)
+  {
+    ByteArray digest;
+    digest.Resize(32);
+
+    for (std::size_t i = 0; i < digest.size(); ++i)
+    {
+      digest[i] = static_cast<uint8_t>(index + (i * 13));
+    }
+
+    return {digest};
+  }
+
+  static Records ReadRecords()
+  {
+    std::ifstream input(FILENAME, std::ios::in | std::ios::binary);
+    EXPECT_TRUE(fetch::metrics::ReadHeader(input));
+
+    Records      records;
+    MetricRecord record;
+    while (input.read(reinterpret_cast<char *>(&record), sizeof(record)))
+    {
+      records.push_back(record);
+    }
+
+    return records;
+  }
+
+  static constexpr char const *FILENAME = "metric_file_handler_tests.out";
+};
+
+constexpr char const *MetricFileHandlerTests::FILENAME;
+
+TEST_F(MetricFileHandlerTests, BinaryRecordsAreWrittenInOrder)
+{
+  static constexpr std::size_t NUM_EVENTS = 100;
+
+  auto const start = MetricFileHandler::Clock::now();
+
+  {
+    MetricFileHandler handler{FILENAME, MetricFileFormat::BINARY};
+
+    for (std::size_t i = 0; i < NUM_EVENTS; ++i)
+    {
+      handler.RecordMetric(CreateDigest(i), Instrument::TRANSACTION, Event::STORED,
+                           start + std::chrono::microseconds{i});
+    }
+  }
+
+  auto const records = ReadRecords();
+  ASSERT_EQ(NUM_EVENTS, records.size());
+
+  for (std::size_t i = 0; i < NUM_EVENTS; ++i)
+  {
+    auto const expected = fetch::metrics::CreateMetricRecord(
+        CreateDigest(i), Instrument::TRANSACTION, Event::STORED,
+        start + std::chrono::microseconds{i});
+
+    EXPECT_EQ(expected.timestamp, records[i].timestamp);
+    EXPECT_EQ(static_cast<uint8_t>(Event::STORED), records[i].event);
+    EXPECT_EQ(CreateDigest(i), fetch::metrics::GetIdentifier(records[i]));
+  }
+}
+
+TEST_F(MetricFileHandlerTests, CsvOutput)
+{
+  auto const timestamp = MetricFileHandler::Clock::now();
+  auto const digest    = CreateDigest(7);
+
+  {
+    MetricFileHandler handler{FILENAME};
+    handler.RecordMetric(digest, Instrument::BLOCK, Event::GENERATED, timestamp);
+  }
+
+  std::ifstream input(FILENAME);
+  std::string   header;
+  std::string   line;
+  std::string   extra;
+  ASSERT_TRUE(std::getline(input, header));
+  ASSERT_TRUE(std::getline(input, line));
+  EXPECT_FALSE(std::getline(input, extra));
+
+  std::ostringstream expected;
+  fetch::metrics::WriteCsvRecord(
+      expected,
+      fetch::metrics::CreateMetricRecord(digest, Instrument::BLOCK, Event::GENERATED, timestamp));
+
+  EXPECT_EQ("Timestamp,Instrument,Event,Identifier", header);
+  EXPECT_EQ(expected.str(), line + '\n');
+  EXPECT_NE(std::string::npos, line.find(",block,generated,"));
+}
+
+TEST_F(MetricFileHandlerTests, LongIdentifiersAreTruncated)
+{
+  ByteArray identifier;
+  identifier.Resize(MetricRecord::MAX_IDENTIFIER_LENGTH + 8);
+
+  auto const record = fetch::metrics::CreateMetricRecord(
+      identifier, Instrument::TRANSACTION, Event::QUEUED, MetricFileHandler::Clock::now());
+
+  EXPECT_EQ(MetricRecord::MAX_IDENTIFIER_LENGTH, fetch::metrics::GetIdentifier(record).size());
+}
+
+TEST_F(MetricFileHandlerTests, ConcurrentEventsAreWrittenOrDropped)
+{
+  static constexpr std::size_t NUM_THREADS       = 4;
+  static constexpr std::size_t EVENTS_PER_THREAD = 50000;
+
+  uint64_t dropped{0};
+
+  {
+    MetricFileHandler handler{FILENAME, MetricFileFormat::BINARY};
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < NUM_THREADS; ++i)
+    {
+      threads.emplace_back([&handler, i]() {
+        auto const digest = CreateDigest(i);
+        for (std::size_t j = 0; j < EVENTS_PER_THREAD; ++j)
+        {
+          handler.RecordMetric(digest, Instrument::TRANSACTION, Event::SUBMITTED,
+                               MetricFileHandler::Clock::now());
+        }
+      });
+    }
+
+    for (auto &thread : threads)
+    {
+      thread.join();
+    }
+
+    dropped = handler.dropped();
+  }
+
+  EXPECT_EQ(NUM_THREADS * EVENTS_PER_THREAD, ReadRecords().size() + dropped);
+}
+
+TEST_F(MetricFileHandlerTests, EventsAreAggregated)
+{
+  MetricAggregator aggregator;
+  auto const       submitted = MetricFileHandler::Clock::now();
+
+  {
+    MetricFileHandler handler{FILENAME, MetricFileFormat::BINARY, &aggregator};
+
+    for (std::size_t i = 0; i < 10; ++i)
+    {
+      handler.RecordMetric(CreateDigest(i), Instrument::TRANSACTION, Event::SUBMITTED, submitted);
+      handler.RecordMetric(CreateDigest(i), Instrument::TRANSACTION, Event::EXECUTION_COMPLETE,
+                           submitted + std::chrono::milliseconds{3});
+    }
+
+    // an event for a transaction which was not submitted through this node
+    handler.RecordMetric(CreateDigest(99), Instrument::TRANSACTION, Event::EXECUTION_COMPLETE,
+                         submitted);
+  }
+
+  EXPECT_EQ(10u, aggregator.count(Instrument::TRANSACTION, Event::SUBMITTED));
+  EXPECT_EQ(11u, aggregator.count(Instrument::TRANSACTION, Event::EXECUTION_COMPLETE));
+  EXPECT_EQ(0u, aggregator.count(Instrument::BLOCK, Event::GENERATED));
+
+  auto const &latency = aggregator.latency(Event::EXECUTION_COMPLETE);
+  EXPECT_EQ(10u, latency.count());
+  EXPECT_EQ(30000u, latency.total_us());
+
+  std::string const text = aggregator.ToPrometheusText();
+  EXPECT_NE(std::string::npos,
+            text.find(
+                "fetch_metric_events_total{instrument=\"transaction\",event=\"submitted\"} 10\n"));
+  EXPECT_NE(std::string::npos,
+            text.find("fetch_transaction_latency_seconds_bucket{event=\"exec-complete\","
+                      "le=\"+Inf\"} 10\n"));
+  EXPECT_NE(std::string::npos,
+            text.find("fetch_transaction_latency_seconds_count{event=\"exec-complete\"} 10\n"));
+  EXPECT_EQ(std::string::npos, text.find("fetch_transaction_latency_seconds_count{event=\"stored"));
+}
+
+}  // namespace
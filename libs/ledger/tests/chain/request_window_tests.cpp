@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/storage_unit/request_window.hpp"
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+
+namespace {
+
+using fetch::ledger::RequestWindow;
+using std::chrono::milliseconds;
+
+constexpr std::size_t MAXIMUM = 8;
+
+TEST(RequestWindowTests, CheckInitialWindowIsLimited)
+{
+  RequestWindow window{2, MAXIMUM};
+  EXPECT_EQ(2u, window.window());
+
+  window.OnSent();
+  window.OnSent();
+  EXPECT_FALSE(window.CanSend());
+  EXPECT_EQ(2u, window.in_flight());
+
+  EXPECT_EQ(MAXIMUM, RequestWindow(100, MAXIMUM).window());
+  EXPECT_EQ(1u, RequestWindow(0, MAXIMUM).window());
+}
+
+TEST(RequestWindowTests, CheckWindowGrowsToMaximumWithoutQueuing)
+{
+  RequestWindow window{1, MAXIMUM};
+
+  for (std::size_t i = 0; i < (MAXIMUM * 2); ++i)
+  {
+    ASSERT_TRUE(window.CanSend());
+    window.OnSent();
+    window.OnResponse(milliseconds{10});
+    EXPECT_EQ(0u, window.in_flight());
+  }
+
+  EXPECT_EQ(MAXIMUM, window.window());
+  EXPECT_EQ(milliseconds{10}, window.smoothed_rtt());
+}
+
+TEST(RequestWindowTests, CheckWindowShrinksWhenRequestsQueue)
+{
+  RequestWindow window{1, MAXIMUM};
+
+  for (std::size_t i = 0; i < MAXIMUM; ++i)
+  {
+    window.OnSent();
+    window.OnResponse(milliseconds{10});
+  }
+  ASSERT_EQ(MAXIMUM, window.window());
+
+  // the round trip slowly rises far above the lowest observed, the peer is queuing the requests
+  std::size_t last = window.window();
+  for (std::size_t i = 0; i < 50; ++i)
+  {
+    window.OnSent();
+    window.OnResponse(milliseconds{100});
+
+    EXPECT_LE(window.window(), last);
+    last = window.window();
+  }
+
+  EXPECT_GT(window.smoothed_rtt(), milliseconds{20});
+  EXPECT_EQ(1u, window.window());
+}
+
+TEST(RequestWindowTests, CheckFailureHalvesWindow)
+{
+  RequestWindow window{MAXIMUM, MAXIMUM};
+
+  for (std::size_t i = 0; i < MAXIMUM; ++i)
+  {
+    window.OnSent();
+  }
+  EXPECT_FALSE(window.CanSend());
+
+  window.OnFailure();
+  EXPECT_EQ(MAXIMUM / 2, window.window());
+  EXPECT_EQ(MAXIMUM - 1, window.in_flight());
+  EXPECT_FALSE(window.CanSend());
+
+  for (std::size_t i = 0; i < 10; ++i)
+  {
+    window.OnFailure();
+  }
+
+  EXPECT_EQ(1u, window.window());
+  EXPECT_EQ(0u, window.in_flight());
+  EXPECT_TRUE(window.CanSend());
+}
+
+}  // namespace
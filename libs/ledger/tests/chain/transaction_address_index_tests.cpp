@@ -0,0 +1,153 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/byte_array.hpp"
+#include "crypto/hash.hpp"
+#include "crypto/sha256.hpp"
+#include "ledger/transaction_address_index.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace {
+
+using fetch::ledger::TransactionAddressIndex;
+using fetch::ledger::Block;
+using fetch::ledger::TransactionSummary;
+using fetch::byte_array::ConstByteArray;
+using Entries   = TransactionAddressIndex::Entries;
+using Addresses = TransactionAddressIndex::Addresses;
+
+constexpr char const *FILENAME = "tx_address_index_tests.db";
+constexpr uint64_t    ALL      = std::numeric_limits<uint64_t>::max();
+
+ConstByteArray MakeDigest(std::string const &seed)
+{
+  return fetch::crypto::Hash<fetch::crypto::SHA256>(seed);
+}
+
+TransactionSummary MakeSummary(std::string const &seed, Addresses const &addresses)
+{
+  TransactionSummary summary;
+  summary.transaction_hash = MakeDigest(seed);
+  summary.resources.insert(addresses.begin(), addresses.end());
+
+  return summary;
+}
+
+TEST(TransactionAddressIndexTests, CheckRangeQueries)
+{
+  TransactionAddressIndex index;
+  index.New(FILENAME);
+
+  for (uint64_t block_number = 1; block_number <= 10; ++block_number)
+  {
+    index.Add(MakeDigest("alice" + std::to_string(block_number)), {"alice"}, block_number);
+    index.Add(MakeDigest("both" + std::to_string(block_number)), {"alice", "bob"}, block_number);
+  }
+
+  Entries entries{};
+  EXPECT_EQ(20u, index.Query("alice", 0, ALL, 0, 100, entries));
+  ASSERT_EQ(20u, entries.size());
+  EXPECT_EQ(10u, index.Query("bob", 0, ALL, 0, 100, entries));
+  EXPECT_EQ(0u, index.Query("carol", 0, ALL, 0, 100, entries));
+  EXPECT_TRUE(entries.empty());
+
+  // the range of block numbers is inclusive and the results are in block order
+  EXPECT_EQ(6u, index.Query("alice", 3, 5, 0, 100, entries));
+  ASSERT_EQ(6u, entries.size());
+  EXPECT_EQ(3u, entries.front().block_number);
+  EXPECT_EQ(5u, entries.back().block_number);
+
+  // paging through the range
+  EXPECT_EQ(6u, index.Query("alice", 3, 5, 4, 4, entries));
+  ASSERT_EQ(2u, entries.size());
+  EXPECT_EQ(MakeDigest("both5"), entries.back().digest);
+
+  EXPECT_EQ(6u, index.Query("alice", 3, 5, 6, 4, entries));
+  EXPECT_TRUE(entries.empty());
+}
+
+TEST(TransactionAddressIndexTests, CheckBlocksAndDuplicates)
+{
+  TransactionAddressIndex index;
+  index.New(FILENAME);
+
+  Block block;
+  block.body.block_number = 7;
+  block.body.slices.resize(2);
+  block.body.slices[0].push_back(MakeSummary("tx1", {"alice", "bob"}));
+  block.body.slices[1].push_back(MakeSummary("tx2", {"bob"}));
+
+  index.Add(block);
+  EXPECT_EQ(3u, index.size());
+
+  // executing the same block again does not add any records
+  index.Add(block);
+  EXPECT_EQ(3u, index.size());
+
+  // while the same transaction in a block at another height (after a fork) does
+  block.body.block_number = 8;
+  index.Add(block);
+  EXPECT_EQ(6u, index.size());
+
+  // an earlier block executed late is still returned in order
+  index.Add(MakeDigest("tx0"), {"bob"}, 2);
+
+  Entries entries{};
+  ASSERT_EQ(5u, index.Query("bob", 0, ALL, 0, 100, entries));
+  EXPECT_EQ(MakeDigest("tx0"), entries[0].digest);
+  EXPECT_EQ(2u, entries[0].block_number);
+  EXPECT_EQ(8u, entries[4].block_number);
+}
+
+TEST(TransactionAddressIndexTests, CheckReload)
+{
+  {
+    TransactionAddressIndex index;
+    index.New(FILENAME);
+
+    index.Add(MakeDigest("tx2"), {"alice"}, 2);
+    index.Add(MakeDigest("tx1"), {"alice", "bob"}, 1);
+    index.Flush();
+  }
+
+  TransactionAddressIndex index;
+  ASSERT_TRUE(index.Load(FILENAME));
+  EXPECT_EQ(3u, index.size());
+
+  Entries entries{};
+  ASSERT_EQ(2u, index.Query("alice", 0, ALL, 0, 100, entries));
+  EXPECT_EQ(MakeDigest("tx1"), entries[0].digest);
+  EXPECT_EQ(MakeDigest("tx2"), entries[1].digest);
+
+  // the transactions already indexed are still recognised
+  index.Add(MakeDigest("tx1"), {"alice", "bob"}, 1);
+  EXPECT_EQ(3u, index.size());
+}
+
+TEST(TransactionAddressIndexTests, CheckMissingIndex)
+{
+  TransactionAddressIndex index;
+  EXPECT_FALSE(index.Load("tx_address_index_missing.db"));
+}
+
+}  // namespace
@@ -28,6 +28,7 @@
 
 #include <random>
 #include <string>
+#include <vector>
 
 using fetch::byte_array::ConstByteArray;
 using fetch::byte_array::FromHex;
@@ -645,6 +646,54 @@ TEST_F(TransactionSerializerTests, MultipleTransfers)
   EnsureAreSame(output, *tx);
 }
 
+TEST_F(TransactionSerializerTests, ConcatenatedTransactions)
+{
+  static constexpr std::size_t NUM_TRANSACTIONS = 3;
+
+  std::vector<Transaction> inputs(NUM_TRANSACTIONS);
+
+  // build up a stream of transactions, one after another
+  fetch::byte_array::ByteArray stream;
+  for (std::size_t i = 0; i < NUM_TRANSACTIONS; ++i)
+  {
+    auto tx = TransactionBuilder()
+                  .From(addresses_[i])
+                  .Transfer(addresses_[i + 1], 100u * (i + 1))
+                  .Signer(signers_[i]->identity())
+                  .Seal()
+                  .Sign(*signers_[i])
+                  .Build();
+
+    ASSERT_TRUE(static_cast<bool>(tx));
+    inputs[i] = *tx;
+
+    TransactionSerializer serializer;
+    serializer << *tx;
+    stream.Append(serializer.data());
+  }
+
+  ConstByteArray const data{stream};
+
+  // decode the transactions back out of the stream
+  std::size_t offset{0};
+  for (std::size_t i = 0; i < NUM_TRANSACTIONS; ++i)
+  {
+    TransactionSerializer const serializer{data.SubArray(offset, data.size() - offset)};
+
+    Transaction output;
+    std::size_t consumed{0};
+    ASSERT_TRUE(serializer.Deserialize(output, consumed));
+    ASSERT_GT(consumed, 0u);
+
+    EXPECT_TRUE(output.Verify());
+    EnsureAreSame(output, inputs[i]);
+
+    offset += consumed;
+  }
+
+  EXPECT_EQ(data.size(), offset);
+}
+
 TEST_F(TransactionSerializerTests, ChainCodeExecute)
 {
   static const std::string EXPECTED_DATA =
@@ -1033,3 +1082,34 @@ TEST_F(TransactionSerializerTests, ContractWithLargeShardMask)
   // ensure the output transaction matches the input one
   EnsureAreSame(output, *tx);
 }
+
+TEST_F(TransactionSerializerTests, ReserializedTransactionIsUnchanged)
+{
+  auto tx = TransactionBuilder()
+                .From(addresses_[0])
+                .Transfer(addresses_[1], 256u)
+                .Signer(signers_[0]->identity())
+                .Seal()
+                .Sign(*signers_[0])
+                .Build();
+
+  ASSERT_TRUE(static_cast<bool>(tx));
+
+  TransactionSerializer serializer;
+  serializer << *tx;
+
+  Transaction output;
+  serializer >> output;
+
+  // serializing the deserialized transaction (which reuses its payload) gives the same data
+  TransactionSerializer reserializer;
+  reserializer << output;
+
+  EXPECT_EQ(serializer.data(), reserializer.data());
+
+  Transaction copy;
+  reserializer >> copy;
+
+  EXPECT_EQ(copy.digest(), tx->digest());
+  EXPECT_TRUE(copy.Verify());
+}
@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/serializers/byte_array_buffer.hpp"
+#include "ledger/storage_unit/transaction_sketch.hpp"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+
+namespace {
+
+using fetch::ledger::TransactionSketch;
+using fetch::serializers::ByteArrayBuffer;
+using ShortIds = TransactionSketch::ShortIds;
+
+constexpr std::size_t NUM_CELLS = 240;
+
+ShortIds Sorted(ShortIds ids)
+{
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+TEST(TransactionSketchTests, CheckEmptySketchDecodes)
+{
+  TransactionSketch sketch{NUM_CELLS};
+  EXPECT_EQ(NUM_CELLS, sketch.num_cells());
+  EXPECT_TRUE(sketch.empty());
+
+  ShortIds positive{}, negative{};
+  EXPECT_TRUE(sketch.Decode(positive, negative));
+  EXPECT_TRUE(positive.empty());
+  EXPECT_TRUE(negative.empty());
+}
+
+TEST(TransactionSketchTests, CheckInsertAndEraseCancel)
+{
+  TransactionSketch sketch{NUM_CELLS};
+
+  sketch.Insert(42);
+  EXPECT_FALSE(sketch.empty());
+
+  sketch.Erase(42);
+  EXPECT_TRUE(sketch.empty());
+}
+
+TEST(TransactionSketchTests, CheckDifferenceOfLargeSetsIsRecovered)
+{
+  std::mt19937_64 rng{42};
+
+  TransactionSketch local{NUM_CELLS};
+  TransactionSketch remote{NUM_CELLS};
+
+  // the bulk of the transactions are shared
+  for (std::size_t i = 0; i < 10000; ++i)
+  {
+    auto const id = rng();
+    local.Insert(id);
+    remote.Insert(id);
+  }
+
+  ShortIds only_remote{}, only_local{};
+  for (std::size_t i = 0; i < 50; ++i)
+  {
+    only_remote.push_back(rng());
+    remote.Insert(only_remote.back());
+  }
+  for (std::size_t i = 0; i < 30; ++i)
+  {
+    only_local.push_back(rng());
+    local.Insert(only_local.back());
+  }
+
+  ASSERT_TRUE(remote.Subtract(local));
+
+  ShortIds positive{}, negative{};
+  ASSERT_TRUE(remote.Decode(positive, negative));
+
+  EXPECT_EQ(Sorted(only_remote), Sorted(positive));
+  EXPECT_EQ(Sorted(only_local), Sorted(negative));
+}
+
+TEST(TransactionSketchTests, CheckOverfullDifferenceFailsToDecode)
+{
+  std::mt19937_64 rng{7};
+
+  TransactionSketch sketch{NUM_CELLS};
+  for (std::size_t i = 0; i < (NUM_CELLS * 2); ++i)
+  {
+    sketch.Insert(rng());
+  }
+
+  ShortIds positive{}, negative{};
+  EXPECT_FALSE(sketch.Decode(positive, negative));
+}
+
+TEST(TransactionSketchTests, CheckSketchesOfDifferentSizesCannotBeSubtracted)
+{
+  TransactionSketch sketch{NUM_CELLS};
+  EXPECT_FALSE(sketch.Subtract(TransactionSketch{NUM_CELLS * 2}));
+}
+
+TEST(TransactionSketchTests, CheckSerialisation)
+{
+  TransactionSketch sketch{NUM_CELLS};
+  sketch.Insert(1);
+  sketch.Insert(2);
+
+  ByteArrayBuffer buffer;
+  buffer << sketch;
+  buffer.seek(0);
+
+  TransactionSketch output{};
+  buffer >> output;
+
+  ASSERT_EQ(sketch.num_cells(), output.num_cells());
+  ASSERT_TRUE(output.Subtract(sketch));
+  EXPECT_TRUE(output.empty());
+}
+
+}  // namespace
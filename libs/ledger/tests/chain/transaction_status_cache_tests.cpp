@@ -125,6 +125,111 @@ TEST_F(TransactionStatusCacheTests, CheckPruning)
   EXPECT_EQ(TransactionStatus::EXECUTED, cache_->Query(tx3));
 }
 
+TEST_F(TransactionStatusCacheTests, CheckRefreshedEntriesSurvivePruning)
+{
+  auto tx1 = GenerateDigest();
+  auto tx2 = GenerateDigest();
+  auto tx3 = GenerateDigest();
+
+  Timepoint const start = Clock::now();
+
+  cache_->Update(tx1, TransactionStatus::PENDING, start);
+  cache_->Update(tx2, TransactionStatus::PENDING, start);
+
+  // refresh the first transaction so that it is no longer part of the oldest bucket
+  cache_->Update(tx1, TransactionStatus::MINED, start + std::chrono::hours{20});
+
+  cache_->Update(tx3, TransactionStatus::EXECUTED, start + std::chrono::hours{25});
+
+  EXPECT_EQ(TransactionStatus::MINED, cache_->Query(tx1));
+  EXPECT_EQ(TransactionStatus::UNKNOWN, cache_->Query(tx2));
+  EXPECT_EQ(TransactionStatus::EXECUTED, cache_->Query(tx3));
+}
+
+TEST_F(TransactionStatusCacheTests, CheckBatchUpdate)
+{
+  TransactionStatusCache::TxDigests digests{};
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    digests.push_back(GenerateDigest());
+  }
+
+  cache_->Update(digests, TransactionStatus::PENDING);
+
+  for (auto const &digest : digests)
+  {
+    EXPECT_EQ(TransactionStatus::PENDING, cache_->Query(digest));
+  }
+
+  cache_->Update(digests, TransactionStatus::MINED);
+
+  for (auto const &digest : digests)
+  {
+    EXPECT_EQ(TransactionStatus::MINED, cache_->Query(digest));
+  }
+}
+
+TEST_F(TransactionStatusCacheTests, CheckSubscriptionIsNotifiedOnceOnChange)
+{
+  auto tx1 = GenerateDigest();
+  auto tx2 = GenerateDigest();
+
+  cache_->Update(tx1, TransactionStatus::PENDING);
+  cache_->Update(tx2, TransactionStatus::PENDING);
+
+  std::size_t       notifications{0};
+  TxDigest          notified_digest{};
+  TransactionStatus notified_status{TransactionStatus::UNKNOWN};
+
+  auto subscription = cache_->Subscribe(
+      {tx1, tx2}, [&](TxDigest const &digest, TransactionStatus status) {
+        ++notifications;
+        notified_digest = digest;
+        notified_status = status;
+      });
+
+  // updates which do not change the status are not notified
+  cache_->Update(tx1, TransactionStatus::PENDING);
+  EXPECT_EQ(0u, notifications);
+
+  cache_->Update({tx2, tx1}, TransactionStatus::EXECUTED);
+  EXPECT_EQ(1u, notifications);
+  EXPECT_TRUE((notified_digest == tx1) || (notified_digest == tx2));
+  EXPECT_EQ(TransactionStatus::EXECUTED, notified_status);
+  EXPECT_FALSE(subscription->active);
+
+  cache_->Update(tx1, TransactionStatus::MINED);
+  EXPECT_EQ(1u, notifications);
+}
+
+TEST_F(TransactionStatusCacheTests, CheckCancelledSubscriptionIsNotNotified)
+{
+  auto tx1 = GenerateDigest();
+
+  std::size_t notifications{0};
+  auto        subscription =
+      cache_->Subscribe({tx1}, [&](TxDigest const &, TransactionStatus) { ++notifications; });
+
+  cache_->Unsubscribe(subscription);
+  cache_->Update(tx1, TransactionStatus::PENDING);
+
+  EXPECT_EQ(0u, notifications);
+}
+
+TEST_F(TransactionStatusCacheTests, CheckStatusStringsRoundTrip)
+{
+  for (auto const status : {TransactionStatus::UNKNOWN, TransactionStatus::PENDING,
+                            TransactionStatus::MINED, TransactionStatus::EXECUTED})
+  {
+    TransactionStatus parsed{TransactionStatus::UNKNOWN};
+    EXPECT_TRUE(FromString(ToString(status), parsed));
+    EXPECT_EQ(status, parsed);
+  }
+
+  TransactionStatus parsed{TransactionStatus::UNKNOWN};
+  EXPECT_FALSE(FromString("Lost", parsed));
+}
+
 TEST_F(TransactionStatusCacheTests, CheckStatusStrings)
 {
   EXPECT_STREQ("Unknown", ToString(TransactionStatus::UNKNOWN));
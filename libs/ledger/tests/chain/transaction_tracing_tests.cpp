@@ -0,0 +1,276 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/encoders.hpp"
+#include "crypto/ecdsa.hpp"
+#include "ledger/chain/mutable_transaction.hpp"
+#include "ledger/chain/transaction.hpp"
+#include "ledger/storage_unit/transaction_sinks.hpp"
+#include "ledger/transaction_verifier.hpp"
+#include "metrics/tracer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+
+using fetch::byte_array::ByteArray;
+using fetch::byte_array::ConstByteArray;
+using fetch::crypto::ECDSASigner;
+using fetch::ledger::MutableTransaction;
+using fetch::ledger::TransactionVerifier;
+using fetch::ledger::VerifiedTransaction;
+using fetch::ledger::VerifiedTransactionSink;
+using fetch::metrics::SpanContext;
+using fetch::metrics::Tracer;
+
+class CountingSink : public VerifiedTransactionSink
+{
+public:
+  void OnTransaction(VerifiedTransaction const &) override
+  {
+    ++count_;
+  }
+
+  std::size_t count() const
+  {
+    return count_;
+  }
+
+private:
+  std::atomic<std::size_t> count_{0};
+};
+
+class TransactionTracingTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // discard the spans of any previous test
+    tracer_.Collect();
+  }
+
+  void TearDown() override
+  {
+    tracer_.SetSampleRate(0);
+    tracer_.Collect();
+  }
+
+  static ConstByteArray CreateDigest(std::size_t index)
+  {
+    ByteArray digest;
+    digest.Resize(32);
+
+    for (std::size_t i = 0; i < digest.size(); ++i)
+    {
+      digest[i] = static_cast<uint8_t>((index * 31) + (i * 7) + 1);
+    }
+
+    return {digest};
+  }
+
+  Tracer &tracer_ = Tracer::Instance();
+};
+
+TEST_F(TransactionTracingTests, DisabledByDefault)
+{
+  EXPECT_FALSE(tracer_.enabled());
+
+  EXPECT_FALSE(tracer_.StartSpan("test").active());
+  EXPECT_FALSE(tracer_.StartTransactionRootSpan("test", CreateDigest(0)).active());
+  EXPECT_FALSE(tracer_.StartTransactionSpan("test", CreateDigest(0)).active());
+
+  EXPECT_TRUE(tracer_.Collect().empty());
+}
+
+TEST_F(TransactionTracingTests, TransactionSpansShareTheTrace)
+{
+  tracer_.SetSampleRate(1);
+
+  auto const digest = CreateDigest(1);
+
+  tracer_.StartTransactionRootSpan("tx.submit", digest).End();
+  tracer_.StartTransactionSpan("tx.verify", digest).End();
+
+  auto const records = tracer_.Collect();
+  ASSERT_EQ(2u, records.size());
+
+  SpanContext const context = Tracer::TransactionContext(digest);
+  EXPECT_STREQ("tx.submit", records[0].name);
+  EXPECT_EQ(context.trace_id, records[0].trace_id);
+  EXPECT_EQ(context.span_id, records[0].span_id);
+  EXPECT_EQ(0u, records[0].parent_id);
+
+  EXPECT_STREQ("tx.verify", records[1].name);
+  EXPECT_EQ(context.trace_id, records[1].trace_id);
+  EXPECT_EQ(context.span_id, records[1].parent_id);
+  EXPECT_NE(context.span_id, records[1].span_id);
+  EXPECT_LE(records[1].start_ns, records[1].end_ns);
+}
+
+TEST_F(TransactionTracingTests, TransactionsWithoutDigestsAreNotTraced)
+{
+  tracer_.SetSampleRate(1);
+
+  EXPECT_FALSE(Tracer::TransactionContext(ConstByteArray{}).valid());
+  EXPECT_FALSE(tracer_.StartTransactionRootSpan("test", ConstByteArray{}).active());
+  EXPECT_FALSE(tracer_.StartTransactionSpan("test", ConstByteArray{}).active());
+}
+
+TEST_F(TransactionTracingTests, SamplingIsConsistentAcrossStages)
+{
+  static constexpr std::size_t NUM_TRANSACTIONS = 400;
+
+  tracer_.SetSampleRate(4);
+
+  std::size_t sampled{0};
+  for (std::size_t i = 0; i < NUM_TRANSACTIONS; ++i)
+  {
+    auto const digest = CreateDigest(i);
+
+    auto root  = tracer_.StartTransactionRootSpan("tx.submit", digest);
+    auto child = tracer_.StartTransactionSpan("tx.verify", digest);
+
+    EXPECT_EQ(root.active(), child.active());
+    sampled += root.active() ? 1u : 0u;
+  }
+
+  // roughly one in four of the transactions should have been sampled
+  EXPECT_GT(sampled, NUM_TRANSACTIONS / 8);
+  EXPECT_LT(sampled, NUM_TRANSACTIONS / 2);
+  EXPECT_EQ(sampled * 2, tracer_.Collect().size());
+}
+
+TEST_F(TransactionTracingTests, OverwrittenSpansAreDropped)
+{
+  static constexpr std::size_t EXTRA_SPANS = 10;
+
+  tracer_.SetSampleRate(1);
+  uint64_t const dropped = tracer_.dropped();
+
+  // record from a new thread so that the spans are in a buffer of their own
+  std::thread thread([this]() {
+    for (std::size_t i = 0; i < Tracer::BUFFER_SIZE + EXTRA_SPANS; ++i)
+    {
+      tracer_.StartSpan("test").End();
+    }
+  });
+  thread.join();
+
+  auto const records = tracer_.Collect();
+
+  EXPECT_EQ(Tracer::BUFFER_SIZE, records.size());
+  EXPECT_EQ(dropped + EXTRA_SPANS, tracer_.dropped());
+
+  // the buffer of the exited thread has been released
+  EXPECT_TRUE(tracer_.Collect().empty());
+}
+
+TEST_F(TransactionTracingTests, ExportFormats)
+{
+  tracer_.SetSampleRate(1);
+
+  tracer_.StartTransactionRootSpan("tx.submit", CreateDigest(2)).End();
+  tracer_.StartTransactionSpan("tx.store", CreateDigest(2)).End();
+
+  auto const records = tracer_.Collect();
+  ASSERT_EQ(2u, records.size());
+
+  std::string const chrome = Tracer::ToChromeTrace(records);
+  EXPECT_EQ(0u, chrome.find(R"({"displayTimeUnit":"ns","traceEvents":[{"name":"tx.submit")"));
+  EXPECT_NE(std::string::npos, chrome.find(R"("name":"tx.store","cat":"fetch","ph":"X")"));
+
+  std::string const otlp = Tracer::ToOtlpJson(records, "node");
+  EXPECT_NE(std::string::npos, otlp.find(R"({"stringValue":"node"})"));
+  EXPECT_NE(std::string::npos, otlp.find(R"("parentSpanId")"));
+
+  // the root span has no parent
+  EXPECT_EQ(otlp.find(R"("parentSpanId")"), otlp.rfind(R"("parentSpanId")"));
+
+  EXPECT_EQ(R"({"displayTimeUnit":"ns","traceEvents":[]})", Tracer::ToChromeTrace({}));
+}
+
+TEST_F(TransactionTracingTests, VerificationIsPartOfTheTransactionTrace)
+{
+  static constexpr std::size_t NUM_TRANSACTIONS = 20;
+
+  tracer_.SetSampleRate(1);
+
+  ECDSASigner signer;
+  signer.GenerateKeys();
+
+  CountingSink                 sink;
+  auto                         verifier = std::make_unique<TransactionVerifier>(sink, 2, "Test");
+  std::map<uint64_t, uint64_t> root_spans;
+
+  for (std::size_t i = 0; i < NUM_TRANSACTIONS; ++i)
+  {
+    MutableTransaction tx;
+    tx.set_contract_name("fetch.token.transfer");
+    tx.set_fee(i);
+    tx.set_data("payload " + std::to_string(i));
+    tx.set_resources({signer.public_key()});
+    tx.Sign(signer.private_key());
+    tx.UpdateDigest();
+
+    SpanContext const context = Tracer::TransactionContext(tx.digest());
+    root_spans[context.trace_id] = context.span_id;
+
+    tracer_.StartTransactionRootSpan("tx.submit", tx.digest()).End();
+    verifier->AddTransaction(std::move(tx));
+  }
+
+  verifier->Start();
+  for (std::size_t i = 0; (i < 200) && (sink.count() < NUM_TRANSACTIONS); ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds{25});
+  }
+  verifier->Stop();
+
+  ASSERT_EQ(NUM_TRANSACTIONS, sink.count());
+
+  std::size_t roots{0};
+  std::size_t verifications{0};
+  for (auto const &record : tracer_.Collect())
+  {
+    if (std::strcmp(record.name, "tx.submit") == 0)
+    {
+      ++roots;
+    }
+    else if (std::strncmp(record.name, "tx.verify", 9) == 0)
+    {
+      // the parent is the submission of the same transaction
+      ASSERT_EQ(1u, root_spans.count(record.trace_id));
+      EXPECT_EQ(root_spans[record.trace_id], record.parent_id);
+      ++verifications;
+    }
+  }
+
+  EXPECT_EQ(NUM_TRANSACTIONS, roots);
+  EXPECT_GE(verifications, NUM_TRANSACTIONS);
+}
+
+}  // namespace
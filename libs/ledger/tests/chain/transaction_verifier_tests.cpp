@@ -0,0 +1,246 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "crypto/ecdsa.hpp"
+#include "ledger/chain/mutable_transaction.hpp"
+#include "ledger/chain/transaction.hpp"
+#include "ledger/storage_unit/transaction_sinks.hpp"
+#include "ledger/transaction_verifier.hpp"
+#include "ledger/verified_digest_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using fetch::byte_array::ConstByteArray;
+using fetch::crypto::ECDSASigner;
+using fetch::ledger::MutableTransaction;
+using fetch::ledger::TransactionVerifier;
+using fetch::ledger::VerifiedTransaction;
+using fetch::ledger::VerifiedDigestCache;
+using fetch::ledger::VerifiedTransactionSink;
+
+using DigestSet = std::set<ConstByteArray>;
+
+class CollectingSink : public VerifiedTransactionSink
+{
+public:
+  void OnTransaction(VerifiedTransaction const &tx) override
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    digests_.insert(tx.digest());
+  }
+
+  DigestSet digests() const
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    return digests_;
+  }
+
+private:
+  mutable std::mutex lock_;
+  DigestSet          digests_;
+};
+
+class TransactionVerifierTests : public ::testing::Test
+{
+protected:
+  static MutableTransaction CreateTransaction(ECDSASigner &signer, std::size_t index)
+  {
+    MutableTransaction tx;
+    tx.set_contract_name("fetch.token.transfer");
+    tx.set_fee(index);
+    tx.set_data("payload " + std::to_string(index));
+    tx.set_resources({signer.public_key()});
+    tx.Sign(signer.private_key());
+    tx.UpdateDigest();
+
+    return tx;
+  }
+
+  bool WaitForTransactions(std::size_t count)
+  {
+    for (std::size_t i = 0; i < 200; ++i)
+    {
+      if (sink_.digests().size() >= count)
+      {
+        return true;
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds{25});
+    }
+
+    return false;
+  }
+
+  CollectingSink sink_;
+};
+
+TEST_F(TransactionVerifierTests, ValidTransactionsAreDispatched)
+{
+  static constexpr std::size_t NUM_TRANSACTIONS = 50;
+
+  ECDSASigner signer;
+  signer.GenerateKeys();
+
+  DigestSet expected;
+
+  // needs to be created on the heap because of memory use
+  auto verifier = std::make_unique<TransactionVerifier>(sink_, 2, "Test");
+
+  // queue up all the transactions before the verifier starts so that they are batched
+  for (std::size_t i = 0; i < NUM_TRANSACTIONS; ++i)
+  {
+    auto tx = CreateTransaction(signer, i);
+    expected.insert(tx.digest());
+    verifier->AddTransaction(std::move(tx));
+  }
+
+  verifier->Start();
+
+  ASSERT_TRUE(WaitForTransactions(NUM_TRANSACTIONS));
+  verifier->Stop();
+
+  EXPECT_EQ(expected, sink_.digests());
+}
+
+TEST_F(TransactionVerifierTests, InvalidTransactionsAreRejectedFromBatch)
+{
+  static constexpr std::size_t NUM_TRANSACTIONS = 20;
+
+  ECDSASigner signer;
+  signer.GenerateKeys();
+
+  DigestSet expected;
+
+  // needs to be created on the heap because of memory use
+  auto verifier = std::make_unique<TransactionVerifier>(sink_, 1, "Test");
+
+  for (std::size_t i = 0; i < NUM_TRANSACTIONS; ++i)
+  {
+    auto tx = CreateTransaction(signer, i);
+
+    if ((i % 5) == 0)
+    {
+      // modify the payload after signing to invalidate the signature
+      tx.set_data("tampered payload " + std::to_string(i));
+      tx.UpdateDigest();
+    }
+    else
+    {
+      expected.insert(tx.digest());
+    }
+
+    verifier->AddTransaction(std::move(tx));
+  }
+
+  verifier->Start();
+
+  ASSERT_TRUE(WaitForTransactions(expected.size()));
+
+  // give the verifier the opportunity to (incorrectly) dispatch the invalid transactions
+  std::this_thread::sleep_for(std::chrono::milliseconds{200});
+  verifier->Stop();
+
+  EXPECT_EQ(expected, sink_.digests());
+}
+
+TEST_F(TransactionVerifierTests, BulkTransactionsAreDispatched)
+{
+  static constexpr std::size_t NUM_TRANSACTIONS = 300;
+
+  ECDSASigner signer;
+  signer.GenerateKeys();
+
+  DigestSet expected;
+
+  // needs to be created on the heap because of memory use
+  auto verifier = std::make_unique<TransactionVerifier>(sink_, 2, "Test");
+  verifier->Start();
+
+  TransactionVerifier::MutableTxList batch;
+  for (std::size_t i = 0; i < NUM_TRANSACTIONS; ++i)
+  {
+    batch.emplace_back(CreateTransaction(signer, i));
+    expected.insert(batch.back().digest());
+  }
+
+  verifier->AddTransactions(std::move(batch));
+  EXPECT_TRUE(batch.empty());
+
+  ASSERT_TRUE(WaitForTransactions(NUM_TRANSACTIONS));
+  verifier->Stop();
+
+  EXPECT_EQ(expected, sink_.digests());
+}
+
+TEST_F(TransactionVerifierTests, VerifiedDigestsAreSharedBetweenVerifiers)
+{
+  ECDSASigner signer;
+  signer.GenerateKeys();
+
+  VerifiedDigestCache cache;
+
+  auto const tx = CreateTransaction(signer, 1);
+
+  // the first verifier checks the signature and records the digest
+  {
+    auto verifier = std::make_unique<TransactionVerifier>(sink_, 1, "Test", &cache);
+    verifier->Start();
+    verifier->AddTransaction(tx);
+
+    ASSERT_TRUE(WaitForTransactions(1));
+    verifier->Stop();
+  }
+
+  EXPECT_TRUE(cache.Contains(tx.digest()));
+
+  // a modified transaction which still claims the verified digest must be verified (and rejected)
+  CollectingSink second_sink;
+  auto           verifier = std::make_unique<TransactionVerifier>(second_sink, 1, "Test", &cache);
+  verifier->Start();
+
+  auto tampered = tx;
+  tampered.set_data("tampered payload");
+  verifier->AddTransaction(std::move(tampered));
+  verifier->AddTransaction(tx);
+
+  for (std::size_t i = 0; (i < 200) && second_sink.digests().empty(); ++i)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds{25});
+  }
+
+  // give the verifier the opportunity to (incorrectly) dispatch the tampered transaction
+  std::this_thread::sleep_for(std::chrono::milliseconds{200});
+  verifier->Stop();
+
+  EXPECT_EQ(DigestSet{tx.digest()}, second_sink.digests());
+  EXPECT_EQ(1u, cache.size());
+}
+
+}  // namespace
@@ -0,0 +1,83 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/byte_array.hpp"
+#include "ledger/verified_digest_cache.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+
+using fetch::byte_array::ByteArray;
+using fetch::ledger::VerifiedDigestCache;
+
+ByteArray MakeDigest(uint32_t id)
+{
+  ByteArray digest;
+  digest.Resize(32);
+  for (std::size_t i = 0; i < digest.size(); ++i)
+  {
+    digest[i] = static_cast<uint8_t>((id >> (8u * (i % 4))) + i);
+  }
+
+  return digest;
+}
+
+TEST(VerifiedDigestCacheTests, CheckAddedDigestsAreFound)
+{
+  VerifiedDigestCache cache;
+
+  for (uint32_t i = 0; i < 100; ++i)
+  {
+    cache.Add(MakeDigest(i));
+  }
+
+  // duplicates are ignored
+  cache.Add(MakeDigest(0));
+
+  EXPECT_EQ(100u, cache.size());
+
+  for (uint32_t i = 0; i < 100; ++i)
+  {
+    EXPECT_TRUE(cache.Contains(MakeDigest(i)));
+  }
+
+  EXPECT_FALSE(cache.Contains(MakeDigest(100)));
+}
+
+TEST(VerifiedDigestCacheTests, CheckCapacityIsBounded)
+{
+  static constexpr std::size_t CAPACITY = VerifiedDigestCache::NUM_SHARDS * 4;
+
+  VerifiedDigestCache cache{CAPACITY};
+
+  for (uint32_t i = 0; i < 10000; ++i)
+  {
+    cache.Add(MakeDigest(i));
+  }
+
+  EXPECT_LE(cache.size(), CAPACITY);
+
+  // the most recent digest is always retained
+  EXPECT_TRUE(cache.Contains(MakeDigest(9999)));
+}
+
+}  // namespace
@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+
+#include "ledger/storage_unit/cached_storage_adapter.hpp"
+#include "mock_storage_unit.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using fetch::ledger::CachedStorageAdapter;
+using fetch::byte_array::ConstByteArray;
+using fetch::storage::ResourceAddress;
+using ::testing::_;
+
+class CachedStorageAdapterTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    storage_.GetFake().Set(ResourceAddress{"a"}, "1");
+    storage_.GetFake().Set(ResourceAddress{"b"}, "2");
+  }
+
+  MockStorageUnit storage_;
+};
+
+TEST_F(CachedStorageAdapterTests, PrefetchRetrievesResourcesInASingleBatch)
+{
+  CachedStorageAdapter cache{storage_};
+
+  EXPECT_CALL(storage_, GetBulk(_)).Times(1);
+  EXPECT_CALL(storage_, Get(_)).Times(1);
+
+  cache.Prefetch({ResourceAddress{"a"}, ResourceAddress{"b"}, ResourceAddress{"c"}});
+
+  // prefetched values are served from the cache
+  EXPECT_EQ(ConstByteArray(cache.Get(ResourceAddress{"a"}).document), ConstByteArray("1"));
+  EXPECT_EQ(ConstByteArray(cache.Get(ResourceAddress{"b"}).document), ConstByteArray("2"));
+
+  // missing values are looked up on access
+  EXPECT_TRUE(cache.Get(ResourceAddress{"c"}).failed);
+}
+
+TEST_F(CachedStorageAdapterTests, FlushWritesOnlyModifiedValuesInASingleBatch)
+{
+  CachedStorageAdapter cache{storage_};
+
+  EXPECT_CALL(storage_, GetBulk(_)).Times(1);
+  cache.Prefetch({ResourceAddress{"a"}, ResourceAddress{"b"}});
+  cache.Set(ResourceAddress{"b"}, "3");
+
+  EXPECT_CALL(storage_, SetBulk(_)).Times(1);
+  EXPECT_CALL(storage_, Set(_, _)).Times(0);
+
+  cache.Flush();
+
+  EXPECT_EQ(ConstByteArray(storage_.GetFake().Get(ResourceAddress{"a"}).document),
+            ConstByteArray("1"));
+  EXPECT_EQ(ConstByteArray(storage_.GetFake().Get(ResourceAddress{"b"}).document),
+            ConstByteArray("3"));
+}
+
+TEST_F(CachedStorageAdapterTests, BulkLocksAreForwardedToTheStorage)
+{
+  CachedStorageAdapter cache{storage_};
+
+  EXPECT_CALL(storage_, Lock(_)).Times(2);
+  EXPECT_TRUE(cache.LockBulk({ResourceAddress{"a"}, ResourceAddress{"b"}}));
+
+  EXPECT_CALL(storage_, Unlock(_)).Times(2);
+  EXPECT_TRUE(cache.UnlockBulk({ResourceAddress{"a"}, ResourceAddress{"b"}}));
+}
@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "fake_storage_unit.hpp"
+#include "ledger/chaincode/chain_code_cache.hpp"
+#include "ledger/chaincode/dummy_contract.hpp"
+#include "ledger/chaincode/smart_contract_manager.hpp"
+#include "ledger/chaincode/token_contract.hpp"
+#include "ledger/identifier.hpp"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using fetch::ledger::ChainCodeCache;
+using fetch::ledger::DummyContract;
+using fetch::ledger::Identifier;
+using fetch::ledger::SmartContractManager;
+using fetch::ledger::TokenContract;
+
+TEST(ChainCodeCacheTests, CheckInstancesAreReused)
+{
+  FakeStorageUnit storage{};
+  ChainCodeCache  cache{};
+
+  Identifier const token{TokenContract::NAME};
+
+  auto const first = cache.Lookup(token, storage);
+  ASSERT_TRUE(first);
+  EXPECT_EQ(first, cache.Lookup(token, storage));
+  EXPECT_EQ(1u, cache.size());
+}
+
+TEST(ChainCodeCacheTests, CheckLeastRecentlyUsedIsEvicted)
+{
+  FakeStorageUnit storage{};
+  ChainCodeCache  cache{2};
+
+  Identifier const token{TokenContract::NAME};
+  Identifier const dummy{DummyContract::NAME};
+  Identifier const manager{SmartContractManager::NAME};
+
+  auto const token_instance = cache.Lookup(token, storage);
+  auto const dummy_instance = cache.Lookup(dummy, storage);
+
+  // refresh the token contract, making the dummy contract the least recently used
+  EXPECT_EQ(token_instance, cache.Lookup(token, storage));
+
+  cache.Lookup(manager, storage);
+  EXPECT_EQ(2u, cache.size());
+
+  EXPECT_EQ(token_instance, cache.Lookup(token, storage));
+  EXPECT_NE(dummy_instance, cache.Lookup(dummy, storage));
+  EXPECT_EQ(2u, cache.size());
+}
+
+}  // namespace
@@ -0,0 +1,223 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+#include "core/serializers/typed_byte_array_buffer.hpp"
+#include "crypto/sha256.hpp"
+#include "ledger/chaincode/compiled_script_cache.hpp"
+#include "vm/compiler.hpp"
+#include "vm/module.hpp"
+#include "vm/script_serializers.hpp"
+#include "vm/vm.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using fetch::byte_array::ConstByteArray;
+using fetch::ledger::CompiledScriptCache;
+using fetch::serializers::TypedByteArrayBuffer;
+
+using Script    = fetch::vm::Script;
+using ScriptPtr = std::shared_ptr<Script>;
+
+char const *CONTRACT_SOURCE = R"(
+@query
+function sum(count : Int32) : Int32
+  var total = 0;
+  for (i in 0:count)
+    total += i;
+  endfor
+  return total;
+endfunction
+)";
+
+int32_t Double(fetch::vm::VM * /*vm*/, int32_t const &value)
+{
+  return value * 2;
+}
+
+class CompiledScriptCacheTests : public ::testing::Test
+{
+protected:
+  static constexpr char const *DOC_FILE   = "compiled_script_cache_test.db";
+  static constexpr char const *INDEX_FILE = "compiled_script_cache_test.index.db";
+
+  void SetUp() override
+  {
+    RemoveFiles();
+  }
+
+  void TearDown() override
+  {
+    RemoveFiles();
+  }
+
+  static void RemoveFiles()
+  {
+    std::remove(DOC_FILE);
+    std::remove(INDEX_FILE);
+    std::remove((std::string{INDEX_FILE} + ".bloom").c_str());
+  }
+
+  static ConstByteArray Digest(std::string const &source)
+  {
+    fetch::crypto::SHA256 hash;
+    hash.Update(source);
+    return hash.Final();
+  }
+
+  ScriptPtr Compile(std::string const &source)
+  {
+    fetch::vm::Compiler compiler{&module_};
+
+    auto                     script = std::make_shared<Script>();
+    std::vector<std::string> errors;
+    EXPECT_TRUE(compiler.Compile(source, "contract", *script, errors));
+    EXPECT_TRUE(errors.empty());
+
+    return script;
+  }
+
+  int32_t ExecuteSum(Script const &script, int32_t count)
+  {
+    fetch::vm::VM      vm{&module_};
+    std::string        error;
+    std::string        console;
+    fetch::vm::Variant output;
+
+    EXPECT_TRUE(vm.Execute(script, "sum", error, console, output, count));
+
+    return output.Get<int32_t>();
+  }
+
+  ConstByteArray Key(std::string const &source) const
+  {
+    return CompiledScriptCache::CreateKey(Digest(source), module_);
+  }
+
+  fetch::vm::Module module_;
+};
+
+constexpr char const *CompiledScriptCacheTests::DOC_FILE;
+constexpr char const *CompiledScriptCacheTests::INDEX_FILE;
+
+TEST_F(CompiledScriptCacheTests, SerialisedScriptExecutesIdentically)
+{
+  auto const original = Compile(CONTRACT_SOURCE);
+
+  TypedByteArrayBuffer buffer;
+  buffer << *original;
+
+  Script restored;
+  buffer.seek(0);
+  buffer >> restored;
+
+  EXPECT_EQ(original->name, restored.name);
+  EXPECT_EQ(original->strings, restored.strings);
+  ASSERT_EQ(original->functions.size(), restored.functions.size());
+  EXPECT_EQ(original->functions[0].instructions.size(),
+            restored.functions[0].instructions.size());
+  ASSERT_NE(nullptr, restored.FindFunction("sum"));
+  EXPECT_EQ(1u, restored.FindFunction("sum")->annotations.size());
+
+  EXPECT_EQ(ExecuteSum(*original, 10), ExecuteSum(restored, 10));
+  EXPECT_EQ(55, ExecuteSum(restored, 10));
+}
+
+TEST_F(CompiledScriptCacheTests, LookupMissThenHit)
+{
+  CompiledScriptCache cache;
+
+  auto const key = Key(CONTRACT_SOURCE);
+  EXPECT_EQ(nullptr, cache.Lookup(key));
+
+  auto const script = Compile(CONTRACT_SOURCE);
+  cache.Add(key, script);
+
+  EXPECT_EQ(script, cache.Lookup(key));
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_EQ(1u, cache.counters().hits);
+  EXPECT_EQ(1u, cache.counters().misses);
+  EXPECT_EQ(0u, cache.counters().store_hits);
+}
+
+TEST_F(CompiledScriptCacheTests, LeastRecentlyUsedScriptIsEvicted)
+{
+  CompiledScriptCache cache{2};
+
+  auto const key1 = Key("contract 1");
+  auto const key2 = Key("contract 2");
+  auto const key3 = Key("contract 3");
+
+  cache.Add(key1, std::make_shared<Script>());
+  cache.Add(key2, std::make_shared<Script>());
+
+  // touch the first script so that the second is the least recently used
+  EXPECT_NE(nullptr, cache.Lookup(key1));
+
+  cache.Add(key3, std::make_shared<Script>());
+
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_NE(nullptr, cache.Lookup(key1));
+  EXPECT_EQ(nullptr, cache.Lookup(key2));
+  EXPECT_NE(nullptr, cache.Lookup(key3));
+}
+
+TEST_F(CompiledScriptCacheTests, KeyDependsOnModuleLayout)
+{
+  auto const digest = Digest(CONTRACT_SOURCE);
+  auto const key    = CompiledScriptCache::CreateKey(digest, module_);
+
+  EXPECT_EQ(key, CompiledScriptCache::CreateKey(digest, module_));
+
+  fetch::vm::Module extended;
+  extended.CreateFreeFunction("double", &Double);
+
+  EXPECT_NE(key, CompiledScriptCache::CreateKey(digest, extended));
+}
+
+TEST_F(CompiledScriptCacheTests, ScriptsSurviveRestart)
+{
+  auto const key = Key(CONTRACT_SOURCE);
+
+  {
+    CompiledScriptCache cache;
+    cache.Load(DOC_FILE, INDEX_FILE);
+    EXPECT_TRUE(cache.is_persistent());
+
+    cache.Add(key, Compile(CONTRACT_SOURCE));
+  }
+
+  CompiledScriptCache cache;
+  cache.Load(DOC_FILE, INDEX_FILE);
+
+  auto const script = cache.Lookup(key);
+  ASSERT_NE(nullptr, script);
+  EXPECT_EQ(1u, cache.counters().store_hits);
+  EXPECT_EQ(55, ExecuteSum(*script, 10));
+
+  // subsequent lookups are served from memory
+  EXPECT_EQ(script, cache.Lookup(key));
+  EXPECT_EQ(1u, cache.counters().hits);
+}
+
+}  // namespace
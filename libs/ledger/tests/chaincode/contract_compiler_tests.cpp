@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "crypto/sha256.hpp"
+#include "ledger/chaincode/compiled_script_cache.hpp"
+#include "ledger/chaincode/contract_compiler.hpp"
+#include "ledger/chaincode/smart_contract_exception.hpp"
+#include "vm/module.hpp"
+#include "vm_modules/vm_factory.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using fetch::byte_array::ConstByteArray;
+using fetch::ledger::CompiledScriptCache;
+using fetch::ledger::ContractCompiler;
+using fetch::ledger::SmartContractException;
+using fetch::vm_modules::VMFactory;
+
+std::string CreateSource(int index)
+{
+  return "function main() : Int32\n  return " + std::to_string(index) + ";\nendfunction\n";
+}
+
+class ContractCompilerTests : public ::testing::Test
+{
+protected:
+  static ConstByteArray Digest(std::string const &source)
+  {
+    fetch::crypto::SHA256 hash;
+    hash.Update(source);
+    return hash.Final();
+  }
+
+  CompiledScriptCache         cache_;
+  ContractCompiler            compiler_{cache_, 2};
+  ContractCompiler::ModulePtr module_ = VMFactory::GetModule();
+};
+
+TEST_F(ContractCompilerTests, SubmittedContractIsSharedWithExecution)
+{
+  auto const source = CreateSource(1);
+
+  EXPECT_TRUE(compiler_.Submit(source));
+
+  auto const script = compiler_.Compile(source, Digest(source), module_);
+  ASSERT_NE(nullptr, script);
+  EXPECT_NE(nullptr, script->FindFunction("main"));
+
+  // the background compilation populated the cache
+  EXPECT_EQ(script, cache_.Lookup(CompiledScriptCache::CreateKey(Digest(source), *module_)));
+  EXPECT_EQ(script, compiler_.Compile(source, Digest(source), module_));
+  EXPECT_EQ(1u, compiler_.submitted());
+}
+
+TEST_F(ContractCompilerTests, ContractsAreCompiledOnDemand)
+{
+  auto const source = CreateSource(2);
+
+  auto const script = compiler_.Compile(source, Digest(source), module_);
+  ASSERT_NE(nullptr, script);
+  EXPECT_EQ(1u, cache_.size());
+  EXPECT_EQ(0u, compiler_.submitted());
+}
+
+TEST_F(ContractCompilerTests, CompilationErrorsReachTheExecution)
+{
+  std::string const source = "function main()\n  var x : Int32 = ;\nendfunction\n";
+
+  compiler_.Submit(source);
+
+  EXPECT_THROW(compiler_.Compile(source, Digest(source), module_), SmartContractException);
+  EXPECT_EQ(0u, cache_.size());
+}
+
+TEST_F(ContractCompilerTests, ManyContractsCompileConcurrently)
+{
+  static constexpr int NUM_CONTRACTS = 16;
+
+  for (int i = 0; i < NUM_CONTRACTS; ++i)
+  {
+    EXPECT_TRUE(compiler_.Submit(CreateSource(i)));
+  }
+
+  std::vector<ContractCompiler::ScriptPtr> scripts;
+  for (int i = 0; i < NUM_CONTRACTS; ++i)
+  {
+    auto const source = CreateSource(i);
+    scripts.push_back(compiler_.Compile(source, Digest(source), module_));
+    EXPECT_NE(nullptr, scripts.back());
+  }
+
+  EXPECT_EQ(std::size_t{NUM_CONTRACTS}, cache_.size());
+}
+
+}  // namespace
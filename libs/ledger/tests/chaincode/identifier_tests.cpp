@@ -127,3 +127,25 @@ TEST(IdentifierTests, CheckContractName)
   EXPECT_EQ(ns + "." + "main", id.full_name());
   EXPECT_EQ(ToBase64(digest), id.qualifier());
 }
+
+TEST(IdentifierTests, CheckIdentifiersAreInterned)
+{
+  Identifier first{"foo.bar.baz"};
+  Identifier second{};
+  ASSERT_TRUE(second.Parse(ByteArray{"foo.bar.baz"}));
+
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(&first.full_name(), &second.full_name());
+  EXPECT_EQ(first.hash(), second.hash());
+  EXPECT_EQ(std::hash<Identifier>{}(first), std::hash<Identifier>{}(second));
+
+  // the parent is the same identifier as the one parsed from its name
+  Identifier parent{"foo.bar"};
+  EXPECT_EQ(parent, first.GetParent());
+  EXPECT_TRUE(parent.IsDirectParentTo(first));
+  EXPECT_NE(parent, first);
+
+  // the parent of a single token is the empty identifier
+  EXPECT_EQ(Identifier{}, Identifier{"foo"}.GetParent());
+  EXPECT_TRUE(Identifier{}.GetParent().empty());
+}
@@ -34,6 +34,8 @@ public:
     ON_CALL(*this, Set(_, _)).WillByDefault(Invoke(&fake_, &FakeStorageUnit::Set));
     ON_CALL(*this, Lock(_)).WillByDefault(Invoke(&fake_, &FakeStorageUnit::Lock));
     ON_CALL(*this, Unlock(_)).WillByDefault(Invoke(&fake_, &FakeStorageUnit::Unlock));
+    ON_CALL(*this, GetBulk(_)).WillByDefault(Invoke(&fake_, &FakeStorageUnit::GetBulk));
+    ON_CALL(*this, SetBulk(_)).WillByDefault(Invoke(&fake_, &FakeStorageUnit::SetBulk));
 
     ON_CALL(*this, CurrentHash()).WillByDefault(Invoke(&fake_, &FakeStorageUnit::CurrentHash));
     ON_CALL(*this, LastCommitHash())
@@ -55,6 +57,8 @@ public:
   MOCK_METHOD2(Set, void(ResourceAddress const &, StateValue const &));
   MOCK_METHOD1(Lock, bool(ResourceAddress const &));
   MOCK_METHOD1(Unlock, bool(ResourceAddress const &));
+  MOCK_METHOD1(GetBulk, Documents(ResourceAddresses const &));
+  MOCK_METHOD1(SetBulk, void(KeyValues const &));
 
   MOCK_METHOD0(CurrentHash, Hash());
   MOCK_METHOD0(LastCommitHash, Hash());
@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/chaincode/query_result_cache.hpp"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using fetch::ledger::QueryResultCache;
+using fetch::byte_array::ConstByteArray;
+using Generation = QueryResultCache::Generation;
+
+TEST(QueryResultCacheTests, CheckResultsAreCachedPerState)
+{
+  QueryResultCache cache{};
+  cache.SetState("root1");
+
+  ConstByteArray result{};
+  Generation     generation{0};
+
+  EXPECT_FALSE(cache.Lookup("fetch.token", "balance", R"({"address": "a"})", result, generation));
+  EXPECT_TRUE(cache.Insert("fetch.token", "balance", R"({"address": "a"})", "{\"balance\": 1}",
+                           generation));
+
+  ASSERT_TRUE(cache.Lookup("fetch.token", "balance", R"({"address": "a"})", result, generation));
+  EXPECT_EQ(ConstByteArray{"{\"balance\": 1}"}, result);
+
+  // other arguments are another query
+  EXPECT_FALSE(cache.Lookup("fetch.token", "balance", R"({"address": "b"})", result, generation));
+
+  // settling on the same state keeps the results
+  cache.SetState("root1");
+  EXPECT_TRUE(cache.Lookup("fetch.token", "balance", R"({"address": "a"})", result, generation));
+
+  // while a new state drops them
+  cache.SetState("root2");
+  EXPECT_FALSE(cache.Lookup("fetch.token", "balance", R"({"address": "a"})", result, generation));
+  EXPECT_EQ(0u, cache.size());
+
+  auto const counters = cache.counters();
+  EXPECT_EQ(2u, counters.hits);
+  EXPECT_EQ(3u, counters.misses);
+  EXPECT_EQ(1u, counters.invalidations);
+}
+
+TEST(QueryResultCacheTests, CheckNothingIsCachedAcrossUpdates)
+{
+  QueryResultCache cache{};
+
+  ConstByteArray result{};
+  Generation     generation{0};
+
+  // the state is unknown until it has settled
+  EXPECT_FALSE(cache.Lookup("fetch.token", "balance", "{}", result, generation));
+  EXPECT_FALSE(cache.Insert("fetch.token", "balance", "{}", "1", generation));
+
+  cache.SetState("root1");
+
+  // a query which started before the state was modified is not cached
+  EXPECT_FALSE(cache.Lookup("fetch.token", "balance", "{}", result, generation));
+  cache.BeginStateUpdate();
+  EXPECT_FALSE(cache.Insert("fetch.token", "balance", "{}", "1", generation));
+
+  // nor is one which ran while it was being modified
+  EXPECT_FALSE(cache.Lookup("fetch.token", "balance", "{}", result, generation));
+  EXPECT_FALSE(cache.Insert("fetch.token", "balance", "{}", "1", generation));
+
+  // a query which started before the state settled is not cached either
+  EXPECT_FALSE(cache.Lookup("fetch.token", "balance", "{}", result, generation));
+  cache.SetState("root2");
+  EXPECT_FALSE(cache.Insert("fetch.token", "balance", "{}", "1", generation));
+  EXPECT_EQ(0u, cache.size());
+}
+
+TEST(QueryResultCacheTests, CheckSizeBounds)
+{
+  QueryResultCache cache{2, 64};
+  cache.SetState("root");
+
+  ConstByteArray result{};
+  Generation     generation{0};
+
+  cache.Lookup("c", "q", "1", result, generation);
+  EXPECT_TRUE(cache.Insert("c", "q", "1", "one", generation));
+  EXPECT_TRUE(cache.Insert("c", "q", "2", "two", generation));
+
+  // use the first result so that the second is the least recently used
+  EXPECT_TRUE(cache.Lookup("c", "q", "1", result, generation));
+  EXPECT_TRUE(cache.Insert("c", "q", "3", "three", generation));
+
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_TRUE(cache.Lookup("c", "q", "1", result, generation));
+  EXPECT_FALSE(cache.Lookup("c", "q", "2", result, generation));
+  EXPECT_TRUE(cache.Lookup("c", "q", "3", result, generation));
+
+  // results larger than the cache are never kept
+  EXPECT_FALSE(cache.Insert("c", "q", "4", ConstByteArray{std::string(64, 'x')}, generation));
+  EXPECT_LE(cache.bytes(), 64u);
+  EXPECT_EQ(1u, cache.counters().evictions);
+}
+
+}  // namespace
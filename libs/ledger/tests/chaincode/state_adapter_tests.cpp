@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/identifier.hpp"
+#include "ledger/state_sentinel_adapter.hpp"
+#include "mock_storage_unit.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+using fetch::byte_array::ConstByteArray;
+using fetch::ledger::Identifier;
+using fetch::ledger::StateSentinelAdapter;
+using fetch::storage::ResourceAddress;
+using ::testing::_;
+
+class StateAdapterTests : public ::testing::Test
+{
+protected:
+  using Status = StateSentinelAdapter::Status;
+
+  void SetUp() override
+  {
+    storage_.GetFake().Set(ResourceAddress{"fetch.dummy.state.value"}, ConstByteArray{LARGE_VALUE});
+  }
+
+  static std::string const LARGE_VALUE;
+
+  MockStorageUnit storage_;
+  Identifier      scope_{"fetch.dummy"};
+};
+
+std::string const StateAdapterTests::LARGE_VALUE(1000, 'x');
+
+TEST_F(StateAdapterTests, ReadViewRequiresSingleLookup)
+{
+  StateSentinelAdapter adapter{storage_, scope_, {"value"}};
+
+  EXPECT_CALL(storage_, Get(_)).Times(1);
+
+  ConstByteArray value;
+  EXPECT_EQ(Status::OK, adapter.ReadView("value", value));
+  EXPECT_EQ(ConstByteArray{LARGE_VALUE}, value);
+}
+
+TEST_F(StateAdapterTests, ReadIntoSmallBufferReportsSize)
+{
+  StateSentinelAdapter adapter{storage_, scope_, {"value", "missing"}};
+
+  char     buffer[16];
+  uint64_t size = sizeof(buffer);
+  EXPECT_EQ(Status::BUFFER_TOO_SMALL, adapter.Read("value", buffer, size));
+  EXPECT_EQ(LARGE_VALUE.size(), size);
+
+  ConstByteArray value;
+  EXPECT_EQ(Status::ERROR, adapter.ReadView("missing", value));
+}
+
+TEST_F(StateAdapterTests, WriteViewIsCheckedAgainstResources)
+{
+  StateSentinelAdapter adapter{storage_, scope_, {"value"}};
+
+  ConstByteArray const updated{"updated"};
+
+  // the write is buffered until the adapter is flushed
+  EXPECT_CALL(storage_, Set(_, _)).Times(0);
+  EXPECT_CALL(storage_, SetBulk(_)).Times(1);
+  EXPECT_EQ(Status::OK, adapter.WriteView("value", updated));
+  EXPECT_EQ(Status::PERMISSION_DENIED, adapter.WriteView("other", updated));
+
+  ConstByteArray value;
+  EXPECT_EQ(Status::PERMISSION_DENIED, adapter.ReadView("other", value));
+  EXPECT_EQ(Status::OK, adapter.ReadView("value", value));
+  EXPECT_EQ(updated, value);
+}
+
+TEST_F(StateAdapterTests, RepeatedAccessesAreServedLocally)
+{
+  ConstByteArray const updated{"updated"};
+
+  {
+    StateSentinelAdapter adapter{storage_, scope_, {"value", "missing"}};
+
+    EXPECT_CALL(storage_, Get(_)).Times(2);
+    EXPECT_CALL(storage_, SetBulk(_)).Times(1);
+
+    ConstByteArray value;
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+      EXPECT_EQ(Status::OK, adapter.ReadView("value", value));
+      EXPECT_EQ(Status::ERROR, adapter.Exists("missing"));
+    }
+
+    // reads after a write see the written value
+    EXPECT_EQ(Status::OK, adapter.WriteView("value", updated));
+    EXPECT_EQ(Status::OK, adapter.WriteView("missing", updated));
+    EXPECT_EQ(Status::OK, adapter.Exists("missing"));
+    EXPECT_EQ(Status::OK, adapter.ReadView("value", value));
+    EXPECT_EQ(updated, value);
+
+    adapter.Flush();
+
+    // a second flush has nothing to write
+    adapter.Flush();
+  }
+
+  EXPECT_EQ(updated, storage_.GetFake().Get(ResourceAddress{"fetch.dummy.state.value"}).document);
+  EXPECT_EQ(updated, storage_.GetFake().Get(ResourceAddress{"fetch.dummy.state.missing"}).document);
+}
@@ -16,6 +16,7 @@
 //
 //------------------------------------------------------------------------------
 
+#include "core/serializers/byte_array_buffer.hpp"
 #include "ledger/chain/transaction.hpp"
 #include "ledger/chaincode/deed.hpp"
 #include "variant/variant.hpp"
@@ -199,6 +200,25 @@ TEST_F(TokenContractDeedTests, is_sane_fails_when_some_thresholds_are_zero)
   EXPECT_TRUE((Deed{signees, thresholds}.IsSane()));
 }
 
+TEST_F(TokenContractDeedTests, is_sane_after_deserialization)
+{
+  Deed::Signees signees;
+  signees["0"] = 1;
+  signees["1"] = 2;
+
+  Deed::OperationTresholds thresholds;
+  thresholds["a"] = 3;
+
+  serializers::ByteArrayBuffer buffer;
+  buffer << Deed{signees, thresholds};
+  buffer.seek(0);
+
+  // the full weight of the signees must be restored, otherwise the threshold would be unreachable
+  Deed deed{};
+  buffer >> deed;
+  EXPECT_TRUE(deed.IsSane());
+}
+
 TEST_F(TokenContractDeedTests, verify_basic_scenario)
 {
   std::vector<PrivateKey> keys{3};
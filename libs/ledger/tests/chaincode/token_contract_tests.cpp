@@ -121,7 +121,7 @@ protected:
   {
     EXPECT_CALL(*storage_, Get(_)).Times(1);
     EXPECT_CALL(*storage_, GetOrCreate(_)).Times(0);
-    EXPECT_CALL(*storage_, Set(_, _)).Times(set_call_expected ? 1 : 0);
+    EXPECT_CALL(*storage_, SetBulk(_)).Times(set_call_expected ? 1 : 0);
     EXPECT_CALL(*storage_, Lock(_)).Times(testing::AnyNumber());
     EXPECT_CALL(*storage_, Unlock(_)).Times(testing::AnyNumber());
     EXPECT_CALL(*storage_, AddTransaction(_)).Times(0);
@@ -141,7 +141,7 @@ protected:
   bool CreateWealth(Address const &address, uint64_t amount)
   {
     EXPECT_CALL(*storage_, Get(_)).Times(1);
-    EXPECT_CALL(*storage_, Set(_, _)).Times(1);
+    EXPECT_CALL(*storage_, SetBulk(_)).Times(1);
     EXPECT_CALL(*storage_, Lock(_)).Times(testing::AnyNumber());
     EXPECT_CALL(*storage_, Unlock(_)).Times(testing::AnyNumber());
     EXPECT_CALL(*storage_, AddTransaction(_)).Times(0);
@@ -163,7 +163,7 @@ protected:
   {
     EXPECT_CALL(*storage_, Get(_)).Times(set_call_expected ? 2 : 1);
     EXPECT_CALL(*storage_, GetOrCreate(_)).Times(0);
-    EXPECT_CALL(*storage_, Set(_, _)).Times(set_call_expected ? 2 : 0);
+    EXPECT_CALL(*storage_, SetBulk(_)).Times(set_call_expected ? 1 : 0);
     EXPECT_CALL(*storage_, Lock(_)).Times(testing::AnyNumber());
     EXPECT_CALL(*storage_, Unlock(_)).Times(testing::AnyNumber());
     EXPECT_CALL(*storage_, AddTransaction(_)).Times(0);
@@ -192,7 +192,7 @@ protected:
   {
     EXPECT_CALL(*storage_, Get(_)).Times(1);
     EXPECT_CALL(*storage_, GetOrCreate(_)).Times(0);
-    EXPECT_CALL(*storage_, Set(_, _)).Times(0);
+    EXPECT_CALL(*storage_, SetBulk(_)).Times(0);
     EXPECT_CALL(*storage_, Lock(_)).Times(testing::AnyNumber());
     EXPECT_CALL(*storage_, Unlock(_)).Times(testing::AnyNumber());
     EXPECT_CALL(*storage_, AddTransaction(_)).Times(0);
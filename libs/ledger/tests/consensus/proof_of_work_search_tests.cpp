@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/serializers/byte_array_buffer.hpp"
+#include "crypto/hash.hpp"
+#include "crypto/merkle_tree.hpp"
+#include "crypto/sha256.hpp"
+#include "ledger/chain/block.hpp"
+#include "ledger/chain/consensus/proof_of_work_search.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+namespace {
+
+using fetch::ledger::Block;
+using fetch::ledger::consensus::ProofOfWorkSearch;
+
+Block CreateBlock(uint64_t block_number)
+{
+  Block block;
+  block.body.previous_hash = "previous";
+  block.body.merkle_hash   = "merkle";
+  block.body.block_number  = block_number;
+  block.body.miner         = "miner";
+  block.proof.SetTarget(8);
+  block.UpdateDigest();
+
+  return block;
+}
+
+// the nonce that the original search (recalculating the whole block digest) would find
+uint64_t FindNonceSequentially(Block block, uint64_t start_nonce)
+{
+  block.nonce = start_nonce;
+  block.UpdateDigest();
+
+  while (!block.proof())
+  {
+    ++block.nonce;
+    block.UpdateDigest();
+  }
+
+  return block.nonce;
+}
+
+TEST(ProofOfWorkSearchTests, CheckDigestIsUnchanged)
+{
+  Block block = CreateBlock(1);
+  block.nonce = 0x0123456789abcdefull;
+  block.UpdateDigest();
+
+  // the digest as it was calculated before the prefix was split out
+  fetch::crypto::MerkleTree tx_merkle_tree{0};
+  tx_merkle_tree.CalculateRoot();
+
+  fetch::serializers::ByteArrayBuffer buffer;
+  buffer.Append(block.body.previous_hash, block.body.merkle_hash, block.body.block_number,
+                block.body.miner, block.body.log2_num_lanes, tx_merkle_tree.root(), block.nonce);
+
+  EXPECT_EQ(block.body.hash, fetch::crypto::Hash<fetch::crypto::SHA256>(buffer.data()));
+}
+
+TEST(ProofOfWorkSearchTests, CheckSingleThreadedSearchFindsFirstNonce)
+{
+  ProofOfWorkSearch search{1};
+
+  for (uint64_t i = 0; i < 4; ++i)
+  {
+    Block block = CreateBlock(i);
+
+    uint64_t const expected = FindNonceSequentially(block, 1000);
+
+    ASSERT_TRUE(search.Search(block, 1000, 100000));
+    EXPECT_EQ(expected, block.nonce);
+    EXPECT_TRUE(block.proof());
+  }
+}
+
+TEST(ProofOfWorkSearchTests, CheckParallelSearchFindsValidNonce)
+{
+  ProofOfWorkSearch search{4};
+
+  Block block = CreateBlock(42);
+  block.proof.SetTarget(12);
+
+  ASSERT_TRUE(search.Search(block, 0, 1u << 20u));
+  EXPECT_TRUE(block.proof());
+}
+
+TEST(ProofOfWorkSearchTests, CheckExhaustedSearchFails)
+{
+  ProofOfWorkSearch search{1};
+
+  Block block = CreateBlock(7);
+  block.proof.SetTarget(200);
+
+  EXPECT_FALSE(search.Search(block, 0, 16));
+  EXPECT_EQ(16u, block.nonce);
+}
+
+}  // namespace
@@ -0,0 +1,290 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/encoders.hpp"
+#include "ledger/block_replay_profiler.hpp"
+#include "ledger/chain/mutable_transaction.hpp"
+#include "ledger/chain/transaction.hpp"
+
+#include "fake_storage_unit.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace {
+
+using fetch::ledger::Block;
+using fetch::ledger::BlockReplayProfiler;
+using fetch::ledger::MutableTransaction;
+using fetch::ledger::StorageUnitInterface;
+using fetch::ledger::Transaction;
+using fetch::ledger::VerifiedTransaction;
+
+/**
+ * A fake storage unit which supports (and records) forks of its state
+ */
+class ForkingStorageUnit : public StorageUnitInterface
+{
+public:
+  Document Get(ResourceAddress const &key) override
+  {
+    return storage_.Get(key);
+  }
+
+  Document GetOrCreate(ResourceAddress const &key) override
+  {
+    return storage_.GetOrCreate(key);
+  }
+
+  void Set(ResourceAddress const &key, StateValue const &value) override
+  {
+    storage_.Set(key, value);
+  }
+
+  bool Lock(ResourceAddress const &key) override
+  {
+    return storage_.Lock(key);
+  }
+
+  bool Unlock(ResourceAddress const &key) override
+  {
+    return storage_.Unlock(key);
+  }
+
+  void AddTransaction(Transaction const &tx) override
+  {
+    storage_.AddTransaction(tx);
+  }
+
+  bool GetTransaction(ConstByteArray const &digest, Transaction &tx) override
+  {
+    return storage_.GetTransaction(digest, tx);
+  }
+
+  bool HasTransaction(ConstByteArray const &digest) override
+  {
+    return storage_.HasTransaction(digest);
+  }
+
+  TxSummaries PollRecentTx(uint32_t max) override
+  {
+    return storage_.PollRecentTx(max);
+  }
+
+  Hash CurrentHash() override
+  {
+    return storage_.CurrentHash();
+  }
+
+  Hash LastCommitHash() override
+  {
+    return storage_.LastCommitHash();
+  }
+
+  bool RevertToHash(Hash const &hash, uint64_t index) override
+  {
+    return storage_.RevertToHash(hash, index);
+  }
+
+  Hash Commit(uint64_t index) override
+  {
+    return storage_.Commit(index);
+  }
+
+  bool HashExists(Hash const &hash, uint64_t index) override
+  {
+    return storage_.HashExists(hash, index);
+  }
+
+  bool BeginFork(Hash const &, uint64_t) override
+  {
+    ++forks_begun;
+    return supports_forks;
+  }
+
+  void EndFork() override
+  {
+    ++forks_ended;
+  }
+
+  void DiscardFork() override
+  {
+    ++forks_discarded;
+  }
+
+  bool        supports_forks{true};
+  std::size_t forks_begun{0};
+  std::size_t forks_ended{0};
+  std::size_t forks_discarded{0};
+
+private:
+  FakeStorageUnit storage_;
+};
+
+class BlockReplayProfilerTests : public ::testing::Test
+{
+protected:
+  using StoragePtr  = std::shared_ptr<ForkingStorageUnit>;
+  using ProfilerPtr = std::unique_ptr<BlockReplayProfiler>;
+
+  static constexpr std::size_t IDENTITY_SIZE = 64;
+
+  void SetUp() override
+  {
+    rng_.seed(42);
+
+    storage_  = std::make_shared<ForkingStorageUnit>();
+    profiler_ = std::make_unique<BlockReplayProfiler>(storage_);
+
+    parent_.body.block_number = 1;
+    parent_.UpdateDigest();
+
+    block_.body.previous_hash = parent_.body.hash;
+    block_.body.block_number  = 2;
+  }
+
+  void AddToBlock(Transaction const &tx)
+  {
+    storage_->AddTransaction(tx);
+
+    block_.body.slices.emplace_back();
+    block_.body.slices.back().push_back(tx.summary());
+  }
+
+  Transaction CreateDummyTransaction()
+  {
+    MutableTransaction tx;
+    tx.set_contract_name("fetch.dummy.run");
+    return VerifiedTransaction::Create(std::move(tx));
+  }
+
+  Transaction CreateWalletTransaction()
+  {
+    fetch::byte_array::ByteArray address;
+    address.Resize(std::size_t{IDENTITY_SIZE});
+
+    for (std::size_t i = 0; i < std::size_t{IDENTITY_SIZE}; ++i)
+    {
+      address[i] = static_cast<uint8_t>(rng_() & 0xFF);
+    }
+
+    std::ostringstream oss;
+    oss << "{ "
+        << R"("address": ")" << static_cast<std::string>(fetch::byte_array::ToBase64(address))
+        << "\", "
+        << R"("amount": )" << 1000 << " }";
+
+    MutableTransaction tx;
+    tx.set_contract_name("fetch.token.wealth");
+    tx.PushResource(address);
+    tx.set_data(oss.str());
+
+    return VerifiedTransaction::Create(std::move(tx));
+  }
+
+  StoragePtr   storage_;
+  ProfilerPtr  profiler_;
+  Block        parent_;
+  Block        block_;
+  std::mt19937 rng_;
+};
+
+TEST_F(BlockReplayProfilerTests, ProfilesEachTransactionOnADiscardedFork)
+{
+  AddToBlock(CreateWalletTransaction());
+  AddToBlock(CreateDummyTransaction());
+  AddToBlock(CreateWalletTransaction());
+  block_.UpdateDigest();
+
+  BlockReplayProfiler::Report report{};
+  ASSERT_TRUE(profiler_->Replay(block_, parent_, report));
+
+  EXPECT_EQ(report.block, block_.body.hash);
+  EXPECT_EQ(report.block_number, 2u);
+  ASSERT_EQ(report.transactions.size(), 3u);
+
+  std::size_t num_wealth{0};
+  for (std::size_t i = 0; i < report.transactions.size(); ++i)
+  {
+    auto const &profile = report.transactions[i];
+
+    EXPECT_EQ(profile.status, BlockReplayProfiler::Status::SUCCESS);
+    EXPECT_EQ(profile.vm_instructions, 0u);
+
+    if (profile.contract == "fetch.token.wealth")
+    {
+      ++num_wealth;
+      EXPECT_GT(profile.storage_calls, 0u);
+      EXPECT_GT(profile.bytes_written, 0u);
+    }
+    else
+    {
+      EXPECT_EQ(profile.contract, "fetch.dummy.run");
+    }
+
+    // the costliest transactions come first
+    if (i > 0)
+    {
+      EXPECT_GE(report.transactions[i - 1].wall_time, profile.wall_time);
+    }
+  }
+
+  EXPECT_EQ(num_wealth, 2u);
+
+  // the state of the storage unit is left untouched
+  EXPECT_EQ(storage_->forks_begun, 1u);
+  EXPECT_EQ(storage_->forks_ended, 1u);
+  EXPECT_EQ(storage_->forks_discarded, 1u);
+
+  std::ostringstream oss;
+  BlockReplayProfiler::WriteReport(oss, report);
+  EXPECT_NE(oss.str().find("fetch.token.wealth"), std::string::npos);
+  EXPECT_NE(oss.str().find("fetch.dummy.run"), std::string::npos);
+}
+
+TEST_F(BlockReplayProfilerTests, RejectsABlockWhichIsNotAChildOfTheParent)
+{
+  AddToBlock(CreateDummyTransaction());
+  block_.body.previous_hash = "not the parent";
+  block_.UpdateDigest();
+
+  BlockReplayProfiler::Report report{};
+  EXPECT_FALSE(profiler_->Replay(block_, parent_, report));
+  EXPECT_TRUE(report.transactions.empty());
+  EXPECT_EQ(storage_->forks_begun, 0u);
+}
+
+TEST_F(BlockReplayProfilerTests, FailsWhenTheStateCanNotBeForked)
+{
+  storage_->supports_forks = false;
+
+  AddToBlock(CreateDummyTransaction());
+  block_.UpdateDigest();
+
+  BlockReplayProfiler::Report report{};
+  EXPECT_FALSE(profiler_->Replay(block_, parent_, report));
+  EXPECT_TRUE(report.transactions.empty());
+  EXPECT_EQ(storage_->forks_discarded, 0u);
+}
+
+}  // namespace
@@ -18,6 +18,7 @@
 
 #include "core/logger.hpp"
 #include "ledger/execution_manager.hpp"
+#include "ledger/state_adapter.hpp"
 
 #include "block_configs.hpp"
 #include "mock_executor.hpp"
@@ -33,6 +34,7 @@
 #include <iostream>
 #include <random>
 #include <thread>
+#include <unordered_map>
 
 class ExecutionManagerTests : public ::testing::TestWithParam<BlockConfig>
 {
@@ -47,19 +49,26 @@ protected:
   using Clock               = std::chrono::high_resolution_clock;
   using ScheduleStatus      = ExecutionManager::ScheduleStatus;
   using State               = ExecutionManager::State;
+  using Mode                = ExecutionManager::Mode;
 
   static constexpr char const *LOGGING_NAME = "ExecutionManagerTests";
 
   void SetUp() override
+  {
+    mock_storage_.reset(new MockStorageUnit);
+
+    CreateManager(Mode::SERIAL);
+  }
+
+  void CreateManager(Mode mode)
   {
     BlockConfig const &config = GetParam();
 
-    mock_storage_.reset(new MockStorageUnit);
     executors_.clear();
 
     // create the manager
-    manager_ = std::make_shared<ExecutionManager>(config.executors, mock_storage_,
-                                                  [this]() { return CreateExecutor(); });
+    manager_ = std::make_shared<ExecutionManager>(
+        config.executors, mock_storage_, [this]() { return CreateExecutor(); }, mode);
   }
 
   void TearDown() override
@@ -102,6 +111,18 @@ protected:
     return success;
   }
 
+  std::size_t GetNumPrefetchedExecutions()
+  {
+    std::size_t total = 0;
+
+    for (auto const &executor : executors_)
+    {
+      total += executor->GetNumPrefetchedExecutions();
+    }
+
+    return total;
+  }
+
   std::size_t GetNumExecutedTransaction()
   {
     std::size_t total = 0;
@@ -164,6 +185,50 @@ protected:
     return success;
   }
 
+  bool CheckForLaneExecutionOrder()
+  {
+    using HistoryElement      = FakeExecutor::HistoryElement;
+    using HistoryElementCache = FakeExecutor::HistoryElementCache;
+    using LaneSliceMap        = std::unordered_map<FakeExecutor::LaneIndex, std::size_t>;
+
+    // Step 1. Collect all the data from each of the executors
+    HistoryElementCache history;
+    history.reserve(GetNumExecutedTransaction());
+    for (auto &exec : executors_)
+    {
+      exec->CollectHistory(history);
+    }
+
+    // Step 2. Sort the elements by timestamp
+    std::sort(history.begin(), history.end(), [](HistoryElement const &a, HistoryElement const &b) {
+      return a.timestamp < b.timestamp;
+    });
+
+    // Step 3. Check that for every lane the slices are executed in order
+    LaneSliceMap current_slices;
+    for (auto const &element : history)
+    {
+      for (auto const &lane : element.lanes)
+      {
+        auto it = current_slices.find(lane);
+        if (it == current_slices.end())
+        {
+          current_slices[lane] = element.slice;
+        }
+        else if (element.slice < it->second)
+        {
+          return false;
+        }
+        else
+        {
+          it->second = element.slice;
+        }
+      }
+    }
+
+    return true;
+  }
+
   MockStorageUnitPtr  mock_storage_;
   ExecutionManagerPtr manager_;
   FakeExecutorList    executors_;
@@ -196,5 +261,86 @@ TEST_P(ExecutionManagerTests, CheckIncrementalExecution)
   manager_->Stop();
 }
 
+TEST_P(ExecutionManagerTests, CheckOptimisticExecution)
+{
+  BlockConfig const &config = GetParam();
+
+  CreateManager(Mode::OPTIMISTIC);
+  ASSERT_EQ(Mode::OPTIMISTIC, manager_->mode());
+
+  // generate a block with the desired lane and slice configuration
+  auto block = TestBlock::Generate(config.log2_lanes, config.slices, __LINE__);
+  EXPECT_GT(block.num_transactions, 0);
+
+  manager_->Start();
+
+  ASSERT_EQ(manager_->Execute(block.block), ExecutionManager::ScheduleStatus::SCHEDULED);
+
+  // wait for the manager to become idle again
+  ASSERT_TRUE(WaitUntilExecutionComplete(static_cast<std::size_t>(block.num_transactions)));
+  ASSERT_EQ(GetNumExecutedTransaction(), block.num_transactions);
+  ASSERT_TRUE(CheckForLaneExecutionOrder());
+
+  manager_->Stop();
+}
+
+TEST_P(ExecutionManagerTests, CheckStatePrefetching)
+{
+  using fetch::ledger::Identifier;
+  using fetch::ledger::StateAdapter;
+  using fetch::ledger::TransactionSummary;
+
+  static constexpr uint32_t LOG2_NUM_LANES = 1;
+
+  Identifier contract;
+  ASSERT_TRUE(contract.Parse("fetch.dummy.run"));
+
+  // find a resource name which maps to the specified lane
+  auto const find_resource = [&contract](uint32_t lane) {
+    for (std::size_t index = 0;; ++index)
+    {
+      std::string const name = "Resource: " + std::to_string(index);
+      if (StateAdapter::CreateAddress(contract, name).lane(LOG2_NUM_LANES) == lane)
+      {
+        return name;
+      }
+    }
+  };
+
+  std::mt19937 rng{__LINE__};
+
+  // the second slice uses a lane which is not touched by the first slice
+  TestBlock block;
+  block.block.log2_num_lanes = LOG2_NUM_LANES;
+  block.block.slices.resize(2);
+  for (uint32_t slice = 0; slice < 2; ++slice)
+  {
+    TransactionSummary summary;
+    summary.transaction_hash = TestBlock::GenerateHash(rng);
+    summary.contract_name    = contract.full_name();
+    summary.resources.insert(find_resource(slice));
+
+    block.block.slices[slice].emplace_back(std::move(summary));
+  }
+
+  // populate the state that the second transaction will read
+  mock_storage_->GetFake().Set(
+      StateAdapter::CreateAddress(contract.GetParent(), find_resource(1)), "value");
+
+  manager_->Start();
+  ASSERT_TRUE(manager_->prefetch_enabled());
+  ASSERT_EQ(manager_->Execute(block.block), ExecutionManager::ScheduleStatus::SCHEDULED);
+
+  ASSERT_TRUE(WaitUntilExecutionComplete(2));
+  ASSERT_EQ(GetNumExecutedTransaction(), 2u);
+  ASSERT_TRUE(CheckForExecutionOrder());
+
+  // only the second slice can be prefetched
+  EXPECT_EQ(GetNumPrefetchedExecutions(), 1u);
+  EXPECT_EQ(manager_->prefetched_resources(), 1u);
+
+  manager_->Stop();
+}
+
 INSTANTIATE_TEST_CASE_P(Param, ExecutionManagerTests,
                         ::testing::ValuesIn(BlockConfig::REDUCED_SET), );
@@ -0,0 +1,255 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/execution_item.hpp"
+#include "ledger/executor_farm.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using fetch::ledger::ExecutionItem;
+using fetch::ledger::ExecutorFarm;
+using fetch::ledger::ExecutorInterface;
+using fetch::ledger::RemoteExecutorInterface;
+using fetch::byte_array::ConstByteArray;
+
+using ExecutionItemPtr  = std::unique_ptr<ExecutionItem>;
+using ExecutionItemList = std::vector<ExecutionItemPtr>;
+
+constexpr std::size_t NUM_ITEMS  = 500;
+constexpr std::size_t BATCH_SIZE = 8;
+
+class FakeRemoteExecutor : public RemoteExecutorInterface
+{
+public:
+  using LaneSet = ExecutionItem::LaneSet;
+
+  explicit FakeRemoteExecutor(bool failing = false)
+    : failing_{failing}
+  {}
+
+  PendingBatch ExecuteBatch(Requests const &requests) override
+  {
+    if (failing_)
+    {
+      return std::async(std::launch::deferred,
+                        []() -> Statuses { throw std::runtime_error("unreachable"); });
+    }
+
+    return std::async(std::launch::async, [this, requests]() {
+      std::lock_guard<std::mutex> lock(lock_);
+
+      largest_batch_ = std::max(largest_batch_, requests.size());
+      for (auto const &request : requests)
+      {
+        lanes_.insert(request.lanes.begin(), request.lanes.end());
+      }
+
+      executions_ += requests.size();
+      return Statuses(requests.size(), ExecutorInterface::Status::SUCCESS);
+    });
+  }
+
+  std::size_t executions() const
+  {
+    return executions_;
+  }
+
+  std::size_t largest_batch() const
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    return largest_batch_;
+  }
+
+  LaneSet lanes() const
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    return lanes_;
+  }
+
+private:
+  bool const               failing_;
+  mutable std::mutex       lock_;
+  std::atomic<std::size_t> executions_{0};
+  std::size_t              largest_batch_{0};
+  LaneSet                  lanes_{};  ///< The lanes of all the executed items
+};
+
+using FakeRemoteExecutorPtr = std::shared_ptr<FakeRemoteExecutor>;
+
+class ExecutorFarmTests : public ::testing::Test
+{
+protected:
+  void TearDown() override
+  {
+    farm_.reset();
+  }
+
+  void CreateFarm(ExecutorFarm::Members members)
+  {
+    farm_ = std::make_unique<ExecutorFarm>(
+        std::move(members), [this](ExecutionItem &) { ++completed_; }, "TestFarm", BATCH_SIZE);
+  }
+
+  static ExecutionItemList CreateItems(std::size_t count, uint32_t num_lanes)
+  {
+    ExecutionItemList items;
+    items.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      items.emplace_back(std::make_unique<ExecutionItem>(ConstByteArray{std::to_string(i)},
+                                                         static_cast<uint32_t>(i % num_lanes), 0));
+    }
+
+    return items;
+  }
+
+  bool WaitForCompletion(std::size_t count)
+  {
+    for (std::size_t i = 0; i < 500; ++i)
+    {
+      if (completed_ >= count)
+      {
+        return true;
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+
+    return false;
+  }
+
+  std::unique_ptr<ExecutorFarm> farm_;
+  std::atomic<std::size_t>      completed_{0};
+};
+
+TEST_F(ExecutorFarmTests, ItemsArePlacedCloseToTheirLanes)
+{
+  auto even = std::make_shared<FakeRemoteExecutor>();
+  auto odd  = std::make_shared<FakeRemoteExecutor>();
+
+  CreateFarm({{even, {0, 2}}, {odd, {1, 3}}});
+
+  auto items = CreateItems(NUM_ITEMS, 4);
+  for (auto &item : items)
+  {
+    farm_->Post(*item);
+  }
+
+  farm_->Start();
+  ASSERT_TRUE(WaitForCompletion(NUM_ITEMS));
+  farm_->Stop();
+
+  EXPECT_EQ(NUM_ITEMS / 2, even->executions());
+  EXPECT_EQ(NUM_ITEMS / 2, odd->executions());
+  EXPECT_EQ(FakeRemoteExecutor::LaneSet({0, 2}), even->lanes());
+  EXPECT_EQ(FakeRemoteExecutor::LaneSet({1, 3}), odd->lanes());
+
+  for (auto const &item : items)
+  {
+    EXPECT_TRUE(item->completed());
+    EXPECT_EQ(ExecutorInterface::Status::SUCCESS, item->status());
+  }
+}
+
+TEST_F(ExecutorFarmTests, ItemsAreSentInBatches)
+{
+  auto executor = std::make_shared<FakeRemoteExecutor>();
+
+  CreateFarm({{executor, {}}});
+
+  // queue the items up front, so that full batches are available to the dispatcher
+  auto items = CreateItems(NUM_ITEMS, 1);
+  for (auto &item : items)
+  {
+    farm_->Post(*item);
+  }
+
+  farm_->Start();
+  ASSERT_TRUE(WaitForCompletion(NUM_ITEMS));
+  farm_->Stop();
+
+  EXPECT_EQ(NUM_ITEMS, executor->executions());
+  EXPECT_EQ(BATCH_SIZE, executor->largest_batch());
+}
+
+TEST_F(ExecutorFarmTests, ItemsFailOverToTheRemainingExecutors)
+{
+  auto failing = std::make_shared<FakeRemoteExecutor>(true);
+  auto healthy = std::make_shared<FakeRemoteExecutor>();
+
+  // all the items are close to the failing executor
+  CreateFarm({{failing, {0}}, {healthy, {1}}});
+  farm_->Start();
+
+  auto items = CreateItems(NUM_ITEMS, 1);
+  for (auto &item : items)
+  {
+    farm_->Post(*item);
+  }
+
+  ASSERT_TRUE(WaitForCompletion(NUM_ITEMS));
+  farm_->Stop();
+
+  EXPECT_EQ(1u, farm_->num_available());
+  EXPECT_GT(farm_->failover_count(), 0u);
+  EXPECT_EQ(NUM_ITEMS, healthy->executions());
+
+  for (auto const &item : items)
+  {
+    EXPECT_EQ(ExecutorInterface::Status::SUCCESS, item->status());
+  }
+}
+
+TEST_F(ExecutorFarmTests, ItemsFailWithoutExecutors)
+{
+  CreateFarm({{std::make_shared<FakeRemoteExecutor>(true), {}}});
+  farm_->Start();
+
+  auto items = CreateItems(NUM_ITEMS, 1);
+  for (auto &item : items)
+  {
+    farm_->Post(*item);
+  }
+
+  ASSERT_TRUE(WaitForCompletion(NUM_ITEMS));
+  farm_->Stop();
+
+  EXPECT_EQ(0u, farm_->num_available());
+
+  for (auto const &item : items)
+  {
+    EXPECT_TRUE(item->completed());
+    EXPECT_EQ(ExecutorInterface::Status::RESOURCE_FAILURE, item->status());
+  }
+}
+
+}  // namespace
@@ -0,0 +1,162 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "ledger/execution_item.hpp"
+#include "ledger/executor_pool.hpp"
+
+#include "fake_executor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using fetch::ledger::ExecutionItem;
+using fetch::ledger::ExecutorInterface;
+using fetch::ledger::ExecutorPool;
+using fetch::byte_array::ConstByteArray;
+
+using ExecutionItemPtr  = std::unique_ptr<ExecutionItem>;
+using ExecutionItemList = std::vector<ExecutionItemPtr>;
+using FakeExecutorPtr   = std::shared_ptr<FakeExecutor>;
+using FakeExecutorList  = std::vector<FakeExecutorPtr>;
+
+constexpr std::size_t NUM_WORKERS = 4;
+constexpr std::size_t NUM_ITEMS   = 1000;
+
+class ExecutorPoolTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    pool_ = std::make_unique<ExecutorPool>(
+        NUM_WORKERS,
+        [this]() {
+          auto executor = std::make_shared<FakeExecutor>();
+          executors_.push_back(executor);
+          return executor;
+        },
+        [this](ExecutionItem &item, ExecutorInterface &executor) {
+          item.Execute(executor);
+          ++completed_;
+        },
+        "TestPool");
+  }
+
+  void TearDown() override
+  {
+    pool_.reset();
+    executors_.clear();
+  }
+
+  static ExecutionItemList CreateItems(std::size_t count)
+  {
+    ExecutionItemList items;
+    items.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      items.emplace_back(std::make_unique<ExecutionItem>(ConstByteArray{std::to_string(i)}, 0));
+    }
+
+    return items;
+  }
+
+  bool WaitForCompletion(std::size_t count)
+  {
+    for (std::size_t i = 0; i < 500; ++i)
+    {
+      if (completed_ >= count)
+      {
+        return true;
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+
+    return false;
+  }
+
+  std::size_t GetNumExecutions() const
+  {
+    std::size_t total{0};
+    for (auto const &executor : executors_)
+    {
+      total += executor->GetNumExecutions();
+    }
+
+    return total;
+  }
+
+  FakeExecutorList              executors_;
+  std::unique_ptr<ExecutorPool> pool_;
+  std::atomic<std::size_t>      completed_{0};
+};
+
+TEST_F(ExecutorPoolTests, CreatesOneExecutorPerWorker)
+{
+  EXPECT_EQ(NUM_WORKERS, pool_->num_workers());
+  EXPECT_EQ(NUM_WORKERS, executors_.size());
+}
+
+TEST_F(ExecutorPoolTests, ExecutesAllPostedItems)
+{
+  auto items = CreateItems(NUM_ITEMS);
+
+  pool_->Start();
+
+  for (auto &item : items)
+  {
+    pool_->Post(*item);
+  }
+
+  ASSERT_TRUE(WaitForCompletion(NUM_ITEMS));
+
+  pool_->Stop();
+
+  EXPECT_EQ(NUM_ITEMS, GetNumExecutions());
+  for (auto const &item : items)
+  {
+    EXPECT_TRUE(item->completed());
+    EXPECT_EQ(ExecutorInterface::Status::SUCCESS, item->status());
+  }
+}
+
+TEST_F(ExecutorPoolTests, ItemsPostedBeforeStartAreExecuted)
+{
+  auto items = CreateItems(NUM_ITEMS);
+
+  for (auto &item : items)
+  {
+    pool_->Post(*item);
+  }
+
+  pool_->Start();
+
+  ASSERT_TRUE(WaitForCompletion(NUM_ITEMS));
+  EXPECT_EQ(NUM_ITEMS, GetNumExecutions());
+}
+
+}  // namespace
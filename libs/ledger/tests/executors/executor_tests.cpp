@@ -120,7 +120,7 @@ TEST_F(ExecutorTests, CheckTokenContract)
   EXPECT_CALL(*storage_, GetTransaction(_, _)).Times(1);
   EXPECT_CALL(*storage_, Lock(_)).Times(1);
   EXPECT_CALL(*storage_, Get(_)).Times(1);
-  EXPECT_CALL(*storage_, Set(_, _)).Times(1);
+  EXPECT_CALL(*storage_, SetBulk(_)).Times(1);
   EXPECT_CALL(*storage_, Unlock(_)).Times(1);
 
   // create the dummy contract
@@ -70,11 +70,30 @@ public:
     return Status::SUCCESS;
   }
 
+  Status ExecuteWithState(TxDigest const &hash, std::size_t slice, LaneSet const &lanes,
+                          PrefetchedState const &state) override
+  {
+    prefetched_resources_ += state.size();
+    ++prefetched_executions_;
+
+    return Execute(hash, slice, lanes);
+  }
+
   std::size_t GetNumExecutions() const
   {
     return history_.size();
   }
 
+  std::size_t GetNumPrefetchedExecutions() const
+  {
+    return prefetched_executions_;
+  }
+
+  std::size_t GetNumPrefetchedResources() const
+  {
+    return prefetched_resources_;
+  }
+
   void CollectHistory(HistoryElementCache &history)
   {
     history_.reserve(history.size() + history_.size());  // do the allocation
@@ -92,6 +111,8 @@ public:
   }
 
 private:
-  StorageInterface *  state_ = nullptr;
-  HistoryElementCache history_;
+  StorageInterface *       state_ = nullptr;
+  HistoryElementCache      history_;
+  std::atomic<std::size_t> prefetched_executions_{0};
+  std::atomic<std::size_t> prefetched_resources_{0};
 };
@@ -23,6 +23,9 @@
 
 #include "core/random/lcg.hpp"
 #include "math/approx_exp.hpp"
+#include "math/standard_functions/exp.hpp"
+#include "math/standard_functions/log.hpp"
+#include "math/tensor.hpp"
 
 template <uint8_t N, uint64_t C>
 static void BM_ApproxExpImplementation(benchmark::State &state)
@@ -59,4 +62,102 @@ static void BM_exp(benchmark::State &state)
 }
 BENCHMARK(BM_exp)->RangeMultiplier(10)->Range(1, 1000000);
 
+template <typename T>
+static fetch::math::Tensor<T> MakeExponents(std::size_t n)
+{
+  fetch::math::Tensor<T> x(n);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    x[i] = static_cast<T>((static_cast<double>(i % 2000) / 100.0) - 10.0);
+  }
+  return x;
+}
+
+// the element-wise standard library exponential over a tensor
+template <typename T>
+static void BM_TensorExp(benchmark::State &state)
+{
+  auto const             n = static_cast<std::size_t>(state.range(0));
+  auto const             x = MakeExponents<T>(n);
+  fetch::math::Tensor<T> ret(n);
+  for (auto _ : state)
+  {
+    fetch::math::Exp(x, ret);
+    benchmark::DoNotOptimize(ret.data().pointer());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_TensorExp, float)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_TensorExp, double)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+// the vectorised polynomial exponential over a tensor
+template <typename T, fetch::math::Accuracy A>
+static void BM_TensorPolynomialExp(benchmark::State &state)
+{
+  auto const             n = static_cast<std::size_t>(state.range(0));
+  auto const             x = MakeExponents<T>(n);
+  fetch::math::Tensor<T> ret(n);
+  for (auto _ : state)
+  {
+    fetch::math::Exp(x, ret, A);
+    benchmark::DoNotOptimize(ret.data().pointer());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_TensorPolynomialExp, float, fetch::math::Accuracy::APPROXIMATE)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_TensorPolynomialExp, float, fetch::math::Accuracy::FAST)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_TensorPolynomialExp, float, fetch::math::Accuracy::PRECISE)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_TensorPolynomialExp, double, fetch::math::Accuracy::PRECISE)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18);
+
+// the element-wise standard library logarithm over a tensor
+template <typename T>
+static void BM_TensorLog(benchmark::State &state)
+{
+  auto const             n = static_cast<std::size_t>(state.range(0));
+  auto                   x = MakeExponents<T>(n);
+  fetch::math::Tensor<T> ret(n);
+  fetch::math::Exp(x, x);
+  for (auto _ : state)
+  {
+    fetch::math::Log(x, ret);
+    benchmark::DoNotOptimize(ret.data().pointer());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_TensorLog, float)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_TensorLog, double)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+// the vectorised series logarithm over a tensor
+template <typename T, fetch::math::Accuracy A>
+static void BM_TensorPolynomialLog(benchmark::State &state)
+{
+  auto const             n = static_cast<std::size_t>(state.range(0));
+  auto                   x = MakeExponents<T>(n);
+  fetch::math::Tensor<T> ret(n);
+  fetch::math::Exp(x, x);
+  for (auto _ : state)
+  {
+    fetch::math::Log(x, ret, A);
+    benchmark::DoNotOptimize(ret.data().pointer());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_TensorPolynomialLog, float, fetch::math::Accuracy::FAST)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_TensorPolynomialLog, float, fetch::math::Accuracy::PRECISE)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_TensorPolynomialLog, double, fetch::math::Accuracy::PRECISE)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18);
+
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -270,4 +270,29 @@ BENCHMARK_TEMPLATE(BM_Maximum, int, 256, 256, 256)->Unit(benchmark::kMillisecond
 BENCHMARK_TEMPLATE(BM_Maximum, float, 256, 256, 256)->Unit(benchmark::kMillisecond);
 BENCHMARK_TEMPLATE(BM_Maximum, double, 256, 256, 256)->Unit(benchmark::kMillisecond);
 
+template <class T, int M, int N, int K>
+void BM_Dot(benchmark::State &state)
+{
+  fetch::math::Tensor<T> a(std::vector<std::uint64_t>{M, K});
+  fetch::math::Tensor<T> b(std::vector<std::uint64_t>{K, N});
+  fetch::math::Tensor<T> c(std::vector<std::uint64_t>{M, N});
+  a.FillUniformRandom();
+  b.FillUniformRandom();
+
+  for (auto _ : state)
+  {
+    fetch::math::Dot(a, b, c);
+  }
+
+  state.counters["flops"] =
+      benchmark::Counter(2.0 * M * N * K, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK_TEMPLATE(BM_Dot, float, 16, 16, 16)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Dot, float, 64, 64, 64)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Dot, float, 256, 256, 256)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Dot, float, 1024, 1024, 1024)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Dot, double, 64, 64, 64)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Dot, double, 256, 256, 256)->Unit(benchmark::kMicrosecond);
+
 BENCHMARK_MAIN();
@@ -19,13 +19,19 @@
 
 #include "core/vector.hpp"
 #include "math/distance/euclidean.hpp"
+#include "math/gemm.hpp"
 #include "math/meta/math_type_traits.hpp"
 #include "math/standard_functions/pow.hpp"
 #include "random"
 
 #include "math/tensor.hpp"
 
+#include <cmath>
+#include <limits>
+#include <numeric>
 #include <set>
+#include <stdexcept>
+#include <vector>
 
 /**
  * assigns the absolute of x to this array
@@ -54,6 +60,111 @@ enum class KInferenceMode
 
 namespace details {
 
+/// Blocks of points are assigned to clusters in parallel
+constexpr SizeType ASSIGNMENT_BLOCK = 256;
+
+/**
+ * Copies the data so that every point is stored contiguously. The distances and the pruning
+ * bounds are computed in double, which keeps the bounds exact for integer and fixed point data.
+ * @param data array of shape # data points X # feature dimensions
+ */
+template <typename ArrayType>
+std::vector<double> PointsByRow(ArrayType const &data)
+{
+  SizeType const n_points     = data.shape()[0];
+  SizeType const n_dimensions = data.shape()[1];
+  auto const *   values       = data.data().pointer();
+
+  std::vector<double> ret(n_points * n_dimensions);
+  for (SizeType j = 0; j < n_dimensions; ++j)
+  {
+    for (SizeType i = 0; i < n_points; ++i)
+    {
+      ret[(i * n_dimensions) + j] = static_cast<double>(values[(j * n_points) + i]);
+    }
+  }
+  return ret;
+}
+
+inline double SquareDistance(double const *a, double const *b, SizeType n_dimensions)
+{
+  double ret = 0;
+  for (SizeType j = 0; j < n_dimensions; ++j)
+  {
+    double const difference = a[j] - b[j];
+    ret += difference * difference;
+  }
+  return ret;
+}
+
+/**
+ * Finds the centre nearest to a point
+ * @param nearest set to the distance to the nearest centre
+ * @param second set to the distance to the second nearest centre
+ * @return the index of the nearest centre, the lowest of them in case of a tie
+ */
+inline SizeType NearestCentre(double const *point, double const *centres, SizeType n_clusters,
+                              SizeType n_dimensions, double &nearest, double &second)
+{
+  SizeType ret = 0;
+  nearest      = std::numeric_limits<double>::max();
+  second       = std::numeric_limits<double>::max();
+  for (SizeType k = 0; k < n_clusters; ++k)
+  {
+    double const distance = SquareDistance(point, centres + (k * n_dimensions), n_dimensions);
+    if (distance < nearest)
+    {
+      second  = nearest;
+      nearest = distance;
+      ret     = k;
+    }
+    else if (distance < second)
+    {
+      second = distance;
+    }
+  }
+  nearest = std::sqrt(nearest);
+  second  = std::sqrt(second);
+  return ret;
+}
+
+/**
+ * KMeans++ seeding: every further centre is a data point drawn with probability proportional to
+ * its square distance from the nearest centre chosen so far. The distances are updated with only
+ * the newest centre each round.
+ * @param points the data as returned by PointsByRow
+ * @param first the index of the point used as the first centre
+ * @return the indices of the points chosen as centres
+ */
+template <typename RandomEngine>
+std::vector<SizeType> KMeansPlusPlus(std::vector<double> const &points, SizeType n_points,
+                                     SizeType n_dimensions, SizeType n_clusters, SizeType first,
+                                     RandomEngine &rng)
+{
+  std::vector<SizeType> ret{first};
+  ret.reserve(n_clusters);
+
+  std::vector<double> weights(n_points, std::numeric_limits<double>::max());
+  std::vector<double> interval(n_points + 1);
+  std::iota(interval.begin(), interval.end(), 0);
+
+  while (ret.size() < n_clusters)
+  {
+    double const *centre = points.data() + (ret.back() * n_dimensions);
+    for (SizeType i = 0; i < n_points; ++i)
+    {
+      weights[i] = std::min(
+          weights[i], SquareDistance(points.data() + (i * n_dimensions), centre, n_dimensions));
+    }
+
+    std::piecewise_constant_distribution<double> dist(interval.begin(), interval.end(),
+                                                      weights.begin());
+    ret.push_back(std::min(static_cast<SizeType>(dist(rng)), n_points - 1));
+  }
+
+  return ret;
+}
+
 template <typename ArrayType>
 class KMeansImplementation
 {
@@ -161,7 +272,7 @@ public:
     rng_.seed(uint32_t(r_seed));
     loop_counter_ = 0;
 
-    temp_k_ = ArrayType(data.shape());
+    points_ = PointsByRow(data);
 
     // instantiate counter with zeros
     InitialiseKMeans(data);
@@ -180,8 +291,10 @@ public:
       reassigned_k_.Set(j, -1);
     }
 
-    // initialise size of euclidean distance container
-    k_euclids_      = fetch::core::Vector<ArrayType>(n_clusters_);
+    // no bounds are known until the first full assignment
+    upper_bounds_ = std::vector<double>(n_points_, std::numeric_limits<double>::max());
+    lower_bounds_ = std::vector<double>(n_points_, 0);
+
     empty_clusters_ = fetch::core::Vector<SizeType>(n_clusters_);
   };
 
@@ -193,7 +306,7 @@ private:
   {
     while (NotConverged())
     {
-      Assign(data);
+      Assign();
       Update(data);
     }
     UnReassign();
@@ -434,134 +547,144 @@ private:
    */
   void KMeansPPInitialisation(ArrayType const &data)
   {
-    // assign first cluster centre
-    for (SizeType j = 0; j < n_dimensions_; ++j)
+    auto const centres =
+        KMeansPlusPlus(points_, n_points_, n_dimensions_, n_clusters_, data_idxs_[0], rng_);
+
+    for (SizeType i = 0; i < n_clusters_; ++i)
     {
-      k_means_.Set(0, j, data.At(data_idxs_[0], j));
+      for (SizeType j = 0; j < n_dimensions_; ++j)
+      {
+        k_means_.Set(i, j, data.At(centres[i], j));
+      }
     }
+  }
 
-    // assign remaining cluster centres
-    SizeType n_remaining_data_points = n_points_ - 1;
-    SizeType n_remaining_clusters    = n_clusters_ - 1;
-
-    fetch::core::Vector<SizeType> assigned_data_points{data_idxs_[0]};
-
-    fetch::core::Vector<ArrayType> cluster_distances(n_clusters_);
-    SizeType                       assigned_cluster = 0;
-
-    fetch::core::Vector<typename ArrayType::Type> weights(
-        n_points_);  // weight for choosing each data point
-    fetch::core::Vector<typename ArrayType::Type> interval(
-        n_points_);  // interval for defining random distribution
-    std::iota(std::begin(interval), std::end(interval), 0);  // fill interval with range
+  /**
+   * part 1 of the iterative process for KMeans:
+   * Assign each data point to a cluster based on euclidean distance. Following Hamerly, every
+   * point keeps an upper bound on the distance to its own centre and a lower bound on the distance
+   * to any other, and only the points whose bounds overlap are compared against all the centres.
+   */
+  void Assign()
+  {
+    UpdateCentres();
 
-    for (SizeType cur_cluster = 1; cur_cluster < n_clusters_; ++cur_cluster)
+    // a point closer to its centre than half the distance to the nearest other centre can not be
+    // closer to any other centre
+    std::vector<double> half_separation(n_clusters_, std::numeric_limits<double>::max());
+    for (SizeType i = 0; i < n_clusters_; ++i)
     {
-      // calculate distances to all clusters
-      for (SizeType i = 0; i < (n_clusters_ - n_remaining_clusters); ++i)
+      for (SizeType j = i + 1; j < n_clusters_; ++j)
       {
-        for (SizeType l = 0; l < n_points_; ++l)
-        {
-          for (SizeType k = 0; k < n_dimensions_; ++k)
-          {
-            temp_k_.Set(l, k, k_means_.At(i, k));
-          }
-        }
-
-        cluster_distances.at(i) = fetch::math::distance::EuclideanMatrix(data, temp_k_, 1);
+        double const separation =
+            std::sqrt(SquareDistance(centres_.data() + (i * n_dimensions_),
+                                     centres_.data() + (j * n_dimensions_), n_dimensions_)) /
+            2;
+        half_separation[i] = std::min(half_separation[i], separation);
+        half_separation[j] = std::min(half_separation[j], separation);
       }
+    }
 
-      // select smallest distance to cluster for each data point and square
-      for (SizeType m = 0; m < n_points_; ++m)
-      {
-        // ignore already assigned data points
-        if (std::find(assigned_data_points.begin(), assigned_data_points.end(), m) ==
-            assigned_data_points.end())
-        {
-          running_mean_ = NumericMax<typename ArrayType::Type>();
-          for (SizeType i = 0; i < (n_clusters_ - n_remaining_clusters); ++i)
-          {
-            if (cluster_distances[i][m] < running_mean_)
-            {
-              running_mean_    = cluster_distances[i][m];
-              assigned_cluster = i;
-            }
-          }
-          weights[m] = cluster_distances[assigned_cluster][m];
-        }
-        else
-        {
-          weights[m] = 0;
-        }
-      }
-      for (auto &val : weights)
-      {
-        fetch::math::Square(val, val);
-      }
+    details_gemm::ForEachColumnBlock(n_clusters_, n_points_, n_dimensions_, ASSIGNMENT_BLOCK,
+                                     [this, &half_separation](SizeType begin, SizeType count) {
+                                       for (SizeType i = begin; i < begin + count; ++i)
+                                       {
+                                         AssignPoint(i, half_separation);
+                                       }
+                                     });
 
-      // select point as new cluster centre
-      std::piecewise_constant_distribution<double> dist(std::begin(interval), std::end(interval),
-                                                        std::begin(weights));
+    std::fill(k_count_.begin(), k_count_.end(), 0);
+    for (SizeType i = 0; i < n_points_; ++i)
+    {
+      ++k_count_[static_cast<SizeType>(k_assignment_[i])];
+    }
 
-      auto val      = dist(rng_);
-      auto tmp_rand = static_cast<SizeType>(val);
+    // sometimes we get an empty cluster - in these cases we should reassign one data point to that
+    // cluster
+    Reassign();
+  }
 
-      assert((tmp_rand < n_points_) && (tmp_rand >= 0));
-      assigned_data_points.push_back(tmp_rand);
+  /**
+   * Assigns a single data point to its nearest centre, skipping the search when the bounds show
+   * that the current assignment still holds
+   */
+  void AssignPoint(SizeType i, std::vector<double> const &half_separation)
+  {
+    double const *point = points_.data() + (i * n_dimensions_);
 
-      for (SizeType j = 0; j < n_dimensions_; ++j)
+    if (!(k_assignment_[i] < 0))
+    {
+      auto const   current = static_cast<SizeType>(k_assignment_[i]);
+      double const bound   = std::max(half_separation[current], lower_bounds_[i]);
+      if (upper_bounds_[i] < bound)
       {
-        k_means_.Set(cur_cluster, j, data.At(assigned_data_points.back(), j));
+        return;
       }
 
-      // update count of remaining data points and clusters
-      --n_remaining_data_points;
-      --n_remaining_clusters;
+      // tighten the upper bound before falling back to the full search
+      upper_bounds_[i] = std::sqrt(
+          SquareDistance(point, centres_.data() + (current * n_dimensions_), n_dimensions_));
+      if (upper_bounds_[i] < bound)
+      {
+        return;
+      }
     }
+
+    SizeType const nearest = NearestCentre(point, centres_.data(), n_clusters_, n_dimensions_,
+                                           upper_bounds_[i], lower_bounds_[i]);
+    k_assignment_[i]       = static_cast<std::int64_t>(nearest);
   }
 
   /**
-   * part 1 of the iterative process for KMeans:
-   * Assign each data point to a cluster based on euclidean distance
+   * Copies the current cluster centres for the assignment, and loosens the bounds of every point
+   * by how far the centres have moved since the last assignment
    */
-  void Assign(ArrayType const &data)
+  void UpdateCentres()
   {
-    // replicate kmeans which is 1 x n_dims into n_data x n_dims
-    // allows for easy call to Euclidean
+    std::vector<double> centres(n_clusters_ * n_dimensions_);
     for (SizeType i = 0; i < n_clusters_; ++i)
     {
-      for (SizeType j = 0; j < n_points_; ++j)
+      for (SizeType j = 0; j < n_dimensions_; ++j)
+      {
+        centres[(i * n_dimensions_) + j] = static_cast<double>(k_means_.At(i, j));
+      }
+    }
+
+    if (centres_.size() == centres.size())
+    {
+      std::vector<double> shift(n_clusters_);
+      SizeType            largest_shift = 0;
+      for (SizeType i = 0; i < n_clusters_; ++i)
       {
-        for (SizeType k = 0; k < n_dimensions_; ++k)
+        shift[i] = std::sqrt(SquareDistance(centres.data() + (i * n_dimensions_),
+                                            centres_.data() + (i * n_dimensions_), n_dimensions_));
+        if (shift[i] > shift[largest_shift])
         {
-          temp_k_.Set(j, k, k_means_.At(i, k));
+          largest_shift = i;
         }
       }
-      k_euclids_[i] = fetch::math::distance::EuclideanMatrix(data, temp_k_, 1);
-    }
 
-    // now we have a vector of n_data x 1 Arrays
-    // we have to go through and compare which is smallest for each K and make the assignment
-    std::fill(k_count_.begin(), k_count_.end(), 0);
+      double second_shift = 0;
+      for (SizeType i = 0; i < n_clusters_; ++i)
+      {
+        if (i != largest_shift)
+        {
+          second_shift = std::max(second_shift, shift[i]);
+        }
+      }
 
-    for (SizeType i = 0; i < n_points_; ++i)
-    {
-      running_mean_ = NumericMax<typename ArrayType::Type>();
-      for (SizeType j = 0; j < n_clusters_; ++j)
+      for (SizeType i = 0; i < n_points_; ++i)
       {
-        if (k_euclids_[j][i] < running_mean_)
+        if (!(k_assignment_[i] < 0))
         {
-          running_mean_ = k_euclids_[j][i];
-          assigned_k_   = static_cast<DataType>(j);
+          auto const current = static_cast<SizeType>(k_assignment_[i]);
+          upper_bounds_[i] += shift[current];
+          lower_bounds_[i] -= (current == largest_shift) ? second_shift : shift[largest_shift];
         }
       }
-      k_assignment_.Set(i, assigned_k_);
-      ++k_count_[static_cast<SizeType>(assigned_k_)];
     }
 
-    // sometimes we get an empty cluster - in these cases we should reassign one data point to that
-    // cluster
-    Reassign();
+    centres_ = std::move(centres);
   }
 
   /**
@@ -597,6 +720,10 @@ private:
           reassigned_k_[data_idxs_[i]] = k_assignment_[i];
           k_assignment_[data_idxs_[i]] = static_cast<DataType>(i);
           ++k_count_[i];
+
+          // the point is no longer at its nearest centre, so its bounds no longer hold
+          upper_bounds_[data_idxs_[i]] = std::numeric_limits<double>::max();
+          lower_bounds_[data_idxs_[i]] = 0;
         }
       }
     }
@@ -733,10 +860,6 @@ private:
   SizeType max_no_change_convergence_ = INVALID;  // max no change k_assignment before convergence
   SizeType loop_counter_              = INVALID;
   SizeType max_loops_                 = INVALID;
-  DataType assigned_k_                = NumericMax<DataType>();  // current cluster to assign
-
-  // used to find the smallest distance out of K comparisons
-  typename ArrayType::Type running_mean_ = NumericMax<typename ArrayType::Type>();
 
   std::default_random_engine rng_;
 
@@ -745,15 +868,18 @@ private:
 
   ArrayType k_means_;       // current cluster centres
   ArrayType prev_k_means_;  // previous cluster centres (for checking convergence)
-  ArrayType temp_k_;        // a container for ease of access to using Euclidean function
+
+  std::vector<double> points_;        // the data with every point stored contiguously
+  std::vector<double> centres_;       // the cluster centres used by the last assignment
+  std::vector<double> upper_bounds_;  // at least the distance from each point to its centre
+  std::vector<double> lower_bounds_;  // at most the distance from each point to any other centre
 
   ClusteringType k_assignment_;  // current data to cluster assignment
   ClusteringType
                  prev_k_assignment_;  // previous data to cluster assignment (for checkign convergence)
   ClusteringType reassigned_k_;       // reassigned data to cluster assignment
 
-  fetch::core::Vector<SizeType>  k_count_;    // count of how many data points assigned per cluster
-  fetch::core::Vector<ArrayType> k_euclids_;  // container for current euclid distances
+  fetch::core::Vector<SizeType> k_count_;  // count of how many data points assigned per cluster
 
   // map previously assigned clusters to current clusters
   std::unordered_map<SizeType, SizeType>
@@ -765,6 +891,128 @@ private:
   KInferenceMode k_inference_mode_ = KInferenceMode::Off;
 };
 
+/**
+ * Mini-batch KMeans, after Sculley: every iteration assigns a random sample of the data to the
+ * nearest centres and moves each centre towards its sampled points with a step of one over the
+ * number of points it has been given so far
+ */
+template <typename ArrayType>
+class MiniBatchKMeansImplementation
+{
+  using DataType = typename ArrayType::Type;
+  using SizeType = typename ArrayType::SizeType;
+
+public:
+  /**
+   * @param data the data itself in the format of a 2D array of n_points x n_dims
+   * @param n_clusters the number K of clusters to identify
+   * @param batch_size the number of data points sampled every iteration
+   * @param ret the return matrix of shape n_points x 1 with values in range 0 -> K-1
+   * @param r_seed a random seed for the initialisation and the sampling
+   * @param max_loops the number of mini-batch iterations
+   * @param init_mode what type of initialization to use
+   */
+  MiniBatchKMeansImplementation(ArrayType const &data, SizeType n_clusters, SizeType batch_size,
+                                ClusteringType &ret, SizeType r_seed, SizeType max_loops,
+                                InitMode init_mode)
+    : n_points_(data.shape()[0])
+    , n_dimensions_(data.shape()[1])
+    , n_clusters_(n_clusters)
+    , points_(PointsByRow(data))
+  {
+    rng_.seed(uint32_t(r_seed));
+
+    Initialise(init_mode);
+
+    std::uniform_int_distribution<SizeType> sample(0, n_points_ - 1);
+    std::vector<SizeType>                   batch(batch_size);
+    std::vector<SizeType>                   nearest(batch_size);
+    std::vector<double>                     counts(n_clusters_, 0);
+
+    for (SizeType loop = 0; loop < max_loops; ++loop)
+    {
+      for (auto &index : batch)
+      {
+        index = sample(rng_);
+      }
+
+      // the whole batch is assigned to the centres of the previous iteration
+      details_gemm::ForEachColumnBlock(n_clusters_, batch_size, n_dimensions_, ASSIGNMENT_BLOCK,
+                                       [&](SizeType begin, SizeType count) {
+                                         for (SizeType i = begin; i < begin + count; ++i)
+                                         {
+                                           nearest[i] = Nearest(batch[i]);
+                                         }
+                                       });
+
+      for (SizeType i = 0; i < batch_size; ++i)
+      {
+        double const  rate   = 1.0 / ++counts[nearest[i]];
+        double const *point  = points_.data() + (batch[i] * n_dimensions_);
+        double *      centre = centres_.data() + (nearest[i] * n_dimensions_);
+        for (SizeType j = 0; j < n_dimensions_; ++j)
+        {
+          centre[j] += rate * (point[j] - centre[j]);
+        }
+      }
+    }
+
+    // assign the final output
+    details_gemm::ForEachColumnBlock(n_clusters_, n_points_, n_dimensions_, ASSIGNMENT_BLOCK,
+                                     [&](SizeType begin, SizeType count) {
+                                       for (SizeType i = begin; i < begin + count; ++i)
+                                       {
+                                         ret[i] = static_cast<std::int64_t>(Nearest(i));
+                                       }
+                                     });
+  }
+
+private:
+  void Initialise(InitMode init_mode)
+  {
+    std::vector<SizeType> data_idxs(n_points_);
+    std::iota(data_idxs.begin(), data_idxs.end(), 0);
+    std::shuffle(data_idxs.begin(), data_idxs.end(), rng_);
+
+    std::vector<SizeType> seeds;
+    switch (init_mode)
+    {
+    case InitMode::KMeansPP:
+      seeds = KMeansPlusPlus(points_, n_points_, n_dimensions_, n_clusters_, data_idxs[0], rng_);
+      break;
+    case InitMode::Forgy:
+      seeds.assign(data_idxs.begin(), data_idxs.begin() + static_cast<std::ptrdiff_t>(n_clusters_));
+      break;
+    default:
+      throw std::runtime_error("no such initialization mode for mini-batch KMeans");
+    }
+
+    centres_.resize(n_clusters_ * n_dimensions_);
+    for (SizeType i = 0; i < n_clusters_; ++i)
+    {
+      std::copy_n(points_.data() + (seeds[i] * n_dimensions_), n_dimensions_,
+                  centres_.data() + (i * n_dimensions_));
+    }
+  }
+
+  SizeType Nearest(SizeType index) const
+  {
+    double nearest;
+    double second;
+    return NearestCentre(points_.data() + (index * n_dimensions_), centres_.data(), n_clusters_,
+                         n_dimensions_, nearest, second);
+  }
+
+  SizeType n_points_;
+  SizeType n_dimensions_;
+  SizeType n_clusters_;
+
+  std::default_random_engine rng_;
+
+  std::vector<double> points_;   // the data with every point stored contiguously
+  std::vector<double> centres_;  // current cluster centres
+};
+
 }  // namespace details
 
 /**
@@ -881,6 +1129,50 @@ ClusteringType KMeans(ArrayType const &data, typename ArrayType::SizeType const
   return ret;
 }
 
+/**
+ * Interface to mini-batch KMeans, which trades some accuracy of the clustering for iterations
+ * whose cost does not depend on the size of the data
+ * @tparam ArrayType    fetch library Array type
+ * @param data          input data to cluster in format n_data x n_dims
+ * @param r_seed        random seed
+ * @param K             number of clusters
+ * @param batch_size    number of data points sampled every iteration
+ * @param max_loops     number of iterations
+ * @param init_mode     KMeansPP or Forgy initialisation
+ * @return              ArrayType of format n_data x 1 with values indicating cluster
+ */
+template <typename ArrayType>
+ClusteringType KMeansMiniBatch(ArrayType const &data, typename ArrayType::SizeType const &r_seed,
+                               typename ArrayType::SizeType const &K,
+                               typename ArrayType::SizeType        batch_size = 1024,
+                               typename ArrayType::SizeType        max_loops  = 100,
+                               InitMode                            init_mode  = InitMode::KMeansPP)
+{
+  using SizeType = typename ArrayType::SizeType;
+
+  SizeType n_points = data.shape()[0];
+
+  assert(K <= n_points);  // you can't have more clusters than data points
+  assert(K > 1);          // why would you run k means clustering with only one cluster?
+
+  ClusteringType ret{n_points};
+
+  if (n_points == K)  // very easy to cluster!
+  {
+    for (SizeType i = 0; i < n_points; ++i)
+    {
+      ret[i] = static_cast<std::int64_t>(i);
+    }
+  }
+  else
+  {
+    details::MiniBatchKMeansImplementation<ArrayType>(data, K, batch_size, ret, r_seed, max_loops,
+                                                      init_mode);
+  }
+
+  return ret;
+}
+
 }  // namespace clustering
 }  // namespace math
 }  // namespace fetch
@@ -18,13 +18,68 @@
 //------------------------------------------------------------------------------
 
 #include "math/distance/cosine.hpp"
+#include "math/distance/pairwise_distance.hpp"
+#include "math/gemm.hpp"
+
+#include <algorithm>
 #include <utility>
+#include <vector>
 
 namespace fetch {
 namespace math {
 namespace clustering {
 namespace details {
 
+/**
+ * Keeps the k nearest of the neighbours pushed into it, in a heap with the furthest of them on
+ * top. Ties in distance are broken by index, so the selection does not depend on the order of the
+ * pushes.
+ */
+template <typename DataType>
+class NearestNeighbours
+{
+public:
+  using NeighbourType = std::pair<SizeType, DataType>;
+
+  explicit NearestNeighbours(SizeType k)
+    : k_(k)
+  {
+    heap_.reserve(k);
+  }
+
+  void Push(SizeType index, DataType distance)
+  {
+    NeighbourType neighbour(index, distance);
+    if (heap_.size() < k_)
+    {
+      heap_.push_back(neighbour);
+      std::push_heap(heap_.begin(), heap_.end(), Closer);
+    }
+    else if ((k_ != 0) && Closer(neighbour, heap_.front()))
+    {
+      std::pop_heap(heap_.begin(), heap_.end(), Closer);
+      heap_.back() = neighbour;
+      std::push_heap(heap_.begin(), heap_.end(), Closer);
+    }
+  }
+
+  /// The neighbours in order of increasing distance
+  std::vector<NeighbourType> Take()
+  {
+    std::sort_heap(heap_.begin(), heap_.end(), Closer);
+    return std::move(heap_);
+  }
+
+private:
+  static bool Closer(NeighbourType const &a, NeighbourType const &b)
+  {
+    return (a.second < b.second) || ((a.second == b.second) && (a.first < b.first));
+  }
+
+  SizeType                   k_;
+  std::vector<NeighbourType> heap_;
+};
+
 template <typename ArrayType,
           typename ArrayType::Type (*Distance)(ArrayType const &, ArrayType const &)>
 std::vector<std::pair<typename ArrayType::SizeType, typename ArrayType::Type>> GetKNNImplementation(
@@ -38,29 +93,130 @@ std::vector<std::pair<typename ArrayType::SizeType, typename ArrayType::Type>> G
   assert(array.shape().at(1) == one_vector.shape().at(1));
   assert(one_vector.shape().at(0) == 1);
 
-  std::vector<std::pair<SizeType, DataType>> similarities;
-  similarities.reserve(array.shape().at(0));
+  NearestNeighbours<DataType> nearest(std::min(k, array.shape().at(0)));
   for (SizeType i(0); i < array.shape().at(0); ++i)
   {
-    typename ArrayType::Type d = Distance(one_vector, array.Slice(i).Copy());
-    similarities.emplace_back(i, d);
+    nearest.Push(i, Distance(one_vector, array.Slice(i).Copy()));
+  }
+
+  return nearest.Take();
+}
+
+/// The k nearest neighbours by square euclidean distance, reported as euclidean distances
+struct EuclideanMetric
+{
+  template <typename T>
+  static std::vector<T> Norms(std::vector<T> square_norms)
+  {
+    return square_norms;
   }
 
-  std::nth_element(similarities.begin(), similarities.begin() + unsigned(k), similarities.end(),
-                   [](std::pair<SizeType, DataType> const &a,
-                      std::pair<SizeType, DataType> const &b) { return a.second > b.second; });
+  template <typename T>
+  static void FromInnerProducts(T *products, SizeType ldp, T const *a_norms, T const *b_norms,
+                                SizeType m, SizeType n)
+  {
+    distance::details::SquareEuclideanFromInnerProducts(products, ldp, a_norms, b_norms, m, n);
+  }
+
+  template <typename T>
+  static void Finish(std::vector<std::pair<SizeType, T>> &neighbours)
+  {
+    for (auto &neighbour : neighbours)
+    {
+      neighbour.second = Sqrt(neighbour.second);
+    }
+  }
+};
+
+struct CosineMetric
+{
+  template <typename T>
+  static std::vector<T> Norms(std::vector<T> square_norms)
+  {
+    return distance::details::Lengths(std::move(square_norms));
+  }
 
-  // fill the return container with the top K
-  std::vector<std::pair<SizeType, DataType>> ret;
-  for (SizeType i(0); i < k; ++i)
+  template <typename T>
+  static void FromInnerProducts(T *products, SizeType ldp, T const *a_norms, T const *b_norms,
+                                SizeType m, SizeType n)
   {
-    ret.emplace_back(std::make_pair(similarities.at(i).first, similarities.at(i).second));
+    distance::details::CosineFromInnerProducts(products, ldp, a_norms, b_norms, m, n);
   }
 
-  std::sort(ret.begin(), ret.end(),
-            [](std::pair<SizeType, DataType> const &a, std::pair<SizeType, DataType> const &b) {
-              return a.second < b.second;
-            });
+  template <typename T>
+  static void Finish(std::vector<std::pair<SizeType, T>> & /*neighbours*/)
+  {}
+};
+
+/**
+ * The k nearest rows of data to every row of queries. The distances are computed for blocks of
+ * data rows and queries at a time as a matrix product, the neighbours of every query are
+ * selected with a heap, and the queries are split between the threads of the pool.
+ */
+template <typename Metric, typename ArrayType>
+std::vector<std::vector<std::pair<SizeType, typename ArrayType::Type>>> BatchKNNImplementation(
+    ArrayType const &data, ArrayType const &queries, SizeType k)
+{
+  using DataType = typename ArrayType::Type;
+
+  static constexpr SizeType DATA_BLOCK  = 1024;
+  static constexpr SizeType QUERY_BLOCK = 64;
+
+  ASSERT(data.shape().size() == 2 && queries.shape().size() == 2);
+  ASSERT(data.shape()[1] == queries.shape()[1]);
+
+  SizeType const num_data    = data.shape()[0];
+  SizeType const num_queries = queries.shape()[0];
+  SizeType const features    = data.shape()[1];
+  k                          = std::min(k, num_data);
+
+  auto const data_norms = Metric::Norms(
+      distance::details::RowSquareNorms(data.data().pointer(), num_data, num_data, features));
+  auto const query_norms = Metric::Norms(distance::details::RowSquareNorms(
+      queries.data().pointer(), num_queries, num_queries, features));
+
+  auto const data_view  = details_gemm::View(data);
+  auto const query_view = details_gemm::View(queries);
+
+  std::vector<std::vector<std::pair<SizeType, DataType>>> ret(num_queries);
+
+  details_gemm::ForEachColumnBlock(
+      num_data, num_queries, features, QUERY_BLOCK, [&](SizeType begin, SizeType count) {
+        std::vector<DataType> products(DATA_BLOCK * QUERY_BLOCK);
+
+        for (SizeType q0 = begin; q0 < begin + count; q0 += QUERY_BLOCK)
+        {
+          SizeType const qb = std::min(QUERY_BLOCK, begin + count - q0);
+
+          std::vector<NearestNeighbours<DataType>> nearest(qb, NearestNeighbours<DataType>(k));
+          for (SizeType d0 = 0; d0 < num_data; d0 += DATA_BLOCK)
+          {
+            SizeType const db = std::min(DATA_BLOCK, num_data - d0);
+
+            // column j of the products holds query q0 + j against the data rows of the block
+            details_gemm::Multiply(DataType(1), data_view.Offset(d0, 0),
+                                   query_view.Offset(q0, 0).Transposed(), DataType(0),
+                                   products.data(), db, db, qb, features);
+            Metric::FromInnerProducts(products.data(), db, data_norms.data() + d0,
+                                      query_norms.data() + q0, db, qb);
+
+            for (SizeType j = 0; j < qb; ++j)
+            {
+              DataType const *column = products.data() + (j * db);
+              for (SizeType i = 0; i < db; ++i)
+              {
+                nearest[j].Push(d0 + i, column[i]);
+              }
+            }
+          }
+
+          for (SizeType j = 0; j < qb; ++j)
+          {
+            ret[q0 + j] = nearest[j].Take();
+            Metric::Finish(ret[q0 + j]);
+          }
+        }
+      });
 
   return ret;
 }
@@ -135,6 +291,35 @@ std::vector<std::pair<typename ArrayType::SizeType, typename ArrayType::Type>> K
   return details::GetKNNImplementation<ArrayType, Distance>(array, one_vector, k);
 }
 
+/**
+ * The K nearest neighbours among the rows of data of every row of queries, by euclidean distance
+ * @param data   array of shape # data points X # feature dimensions
+ * @param queries   array of shape # queries X # feature dimensions
+ * @param k  how many nearest data points to find for each query
+ * @return for every query, (index, distance) pairs in order of increasing distance
+ */
+template <typename ArrayType>
+std::vector<std::vector<std::pair<typename ArrayType::SizeType, typename ArrayType::Type>>>
+BatchKNNEuclidean(ArrayType const &data, ArrayType const &queries,
+                  typename ArrayType::SizeType k)
+{
+  return details::BatchKNNImplementation<details::EuclideanMetric>(data, queries, k);
+}
+
+/**
+ * The K nearest neighbours among the rows of data of every row of queries, by cosine distance
+ * @param data   array of shape # data points X # feature dimensions
+ * @param queries   array of shape # queries X # feature dimensions
+ * @param k  how many nearest data points to find for each query
+ * @return for every query, (index, distance) pairs in order of increasing distance
+ */
+template <typename ArrayType>
+std::vector<std::vector<std::pair<typename ArrayType::SizeType, typename ArrayType::Type>>>
+BatchKNNCosine(ArrayType const &data, ArrayType const &queries, typename ArrayType::SizeType k)
+{
+  return details::BatchKNNImplementation<details::CosineMetric>(data, queries, k);
+}
+
 }  // namespace clustering
 }  // namespace math
-}  // namespace fetch
\ No newline at end of file
+}  // namespace fetch
@@ -27,8 +27,31 @@ namespace fetch {
 namespace math {
 namespace distance {
 
+/**
+ * The squared euclidean distance between two floating point arrays, split between the threads of
+ * the pool for the larger arrays
+ */
+template <typename ArrayType>
+meta::IfIsMathFloatArray<ArrayType, typename ArrayType::Type> SquareDistance(ArrayType const &A,
+                                                                             ArrayType const &B)
+{
+  using VectorRegisterType = typename ArrayType::VectorRegisterType;
+
+  assert(A.size() == B.size());
+
+  memory::ConstParallelDispatcher<typename ArrayType::Type> dispatcher(A.data().pointer(),
+                                                                      A.size());
+  return dispatcher.ParallelSumReduce(
+      [](VectorRegisterType const &a, VectorRegisterType const &b) {
+        VectorRegisterType const d = a - b;
+        return d * d;
+      },
+      B.data());
+}
+
 template <typename ArrayType>
-typename ArrayType::Type SquareDistance(ArrayType const &A, ArrayType const &B)
+meta::IfIsMathNonFloatArray<ArrayType, typename ArrayType::Type> SquareDistance(
+    ArrayType const &A, ArrayType const &B)
 {
   using Type = typename ArrayType::Type;
   auto it1   = A.begin();
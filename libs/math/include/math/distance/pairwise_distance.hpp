@@ -15,41 +15,202 @@
 //   See the License for the specific language governing permissions and
 //   limitations under the License.
 //
-//------------------------------------------------------------------------------
 
 #include "core/assert.hpp"
+#include "math/matrix_operations.hpp"
+#include "math/standard_functions/sqrt.hpp"
+
 #include <cmath>
+#include <vector>
 
 namespace fetch {
 namespace math {
 namespace distance {
 
+/**
+ * Compute a metric between every pair of rows of a
+ * @param r output of shape (1, n * (n - 1) / 2), the distances of row i to the rows after it
+ * @param a array of shape (n, # features)
+ * @param metric distance between two (1, # features) arrays
+ */
 template <typename ArrayType, typename F>
 inline ArrayType &PairWiseDistance(ArrayType &r, ArrayType const &a, F &&metric)
 {
   using SizeType = typename ArrayType::SizeType;
 
-  detailed_assert(r.height() == 1);
-  detailed_assert(r.width() == (a.height() * (a.height() - 1) / 2));
+  SizeType const n = a.shape()[0];
+  ASSERT(r.size() == (n * (n - 1) / 2));
+
+  SizeType k = 0;
+  for (SizeType i = 0; i < n; ++i)
+  {
+    ArrayType const row1 = a.Slice(i).Copy();
+    for (SizeType j = i + 1; j < n; ++j)
+    {
+      r.At(SizeType(0), k++) = metric(row1, a.Slice(j).Copy());
+    }
+  }
+
+  return r;
+}
+
+namespace details {
 
-  SizeType offset1 = 0;
-  SizeType k       = 0;
+/**
+ * The squared norms of the rows of the (m x # features) matrix a, in column major storage with a
+ * distance of lda between the columns
+ */
+template <typename T>
+std::vector<T> RowSquareNorms(T const *a, SizeType lda, SizeType m, SizeType features)
+{
+  std::vector<T> norms(m, T(0));
+  for (SizeType p = 0; p < features; ++p)
+  {
+    T const *column = a + (p * lda);
+    for (SizeType i = 0; i < m; ++i)
+    {
+      norms[i] += column[i] * column[i];
+    }
+  }
+  return norms;
+}
 
-  for (SizeType i = 0; i < a.height(); ++i)
+/**
+ * Turn the inner products of the rows of two matrices into square euclidean distances, using
+ * |a - b|^2 = |a|^2 + |b|^2 - 2 a.b
+ */
+template <typename T>
+void SquareEuclideanFromInnerProducts(T *products, SizeType ldp, T const *a_norms,
+                                      T const *b_norms, SizeType m, SizeType n)
+{
+  for (SizeType j = 0; j < n; ++j)
   {
-    ArrayType slice1 = a.data().slice(offset1, a.width());
-    offset1 += a.padded_width();
-    SizeType offset2 = offset1;
+    T *column = products + (j * ldp);
+    for (SizeType i = 0; i < m; ++i)
+    {
+      T const distance = a_norms[i] + b_norms[j] - (T(2) * column[i]);
+
+      // rounding can leave the distance of (nearly) equal points slightly negative
+      column[i] = (distance < T(0)) ? T(0) : distance;
+    }
+  }
+}
 
-    for (SizeType j = i + 1; j < a.height(); ++j)
+/**
+ * Turn the inner products of the rows of two matrices into cosine distances, 1 - a.b / (|a||b|).
+ * A row with no length is at a distance of one from everything.
+ */
+template <typename T>
+void CosineFromInnerProducts(T *products, SizeType ldp, T const *a_norms, T const *b_norms,
+                             SizeType m, SizeType n)
+{
+  for (SizeType j = 0; j < n; ++j)
+  {
+    T *column = products + (j * ldp);
+    for (SizeType i = 0; i < m; ++i)
     {
-      ArrayType slice2 = a.data().slice(offset2, a.width());
-      offset2 += a.padded_width();
-      r(SizeType(0), k++) = metric(slice1, slice2);
+      T const denominator = a_norms[i] * b_norms[j];
+      column[i]           = (denominator == T(0)) ? T(1) : T(T(1) - (column[i] / denominator));
     }
   }
+}
 
-  return r;
+template <typename T>
+std::vector<T> Lengths(std::vector<T> norms)
+{
+  for (auto &norm : norms)
+  {
+    norm = Sqrt(norm);
+  }
+  return norms;
+}
+
+}  // namespace details
+
+/**
+ * The square euclidean distances between every row of a and every row of b, with the inner
+ * products of the rows computed as a single matrix product
+ * @param a array of shape (m, # features)
+ * @param b array of shape (n, # features)
+ * @param ret output of shape (m, n)
+ */
+template <typename ArrayType>
+void PairwiseSquareEuclidean(ArrayType const &a, ArrayType const &b, ArrayType &ret)
+{
+  ASSERT(a.shape().size() == 2 && b.shape().size() == 2);
+  ASSERT(a.shape()[1] == b.shape()[1]);
+
+  SizeType const m = a.shape()[0];
+  SizeType const n = b.shape()[0];
+
+  auto const a_norms = details::RowSquareNorms(a.data().pointer(), m, m, a.shape()[1]);
+  auto const b_norms = details::RowSquareNorms(b.data().pointer(), n, n, b.shape()[1]);
+
+  DotTranspose(a, b, ret);
+  details::SquareEuclideanFromInnerProducts(ret.data().pointer(), m, a_norms.data(),
+                                            b_norms.data(), m, n);
+}
+
+/**
+ * The euclidean distances between every row of a and every row of b
+ * @param a array of shape (m, # features)
+ * @param b array of shape (n, # features)
+ * @param ret output of shape (m, n)
+ */
+template <typename ArrayType>
+void PairwiseEuclidean(ArrayType const &a, ArrayType const &b, ArrayType &ret)
+{
+  using Type = typename ArrayType::Type;
+
+  PairwiseSquareEuclidean(a, b, ret);
+
+  Type *const output = ret.data().pointer();
+  for (SizeType i = 0, end = ret.size(); i < end; ++i)
+  {
+    output[i] = Sqrt(output[i]);
+  }
+}
+
+/**
+ * The cosine distances between every row of a and every row of b, with the inner products of
+ * the rows computed as a single matrix product
+ * @param a array of shape (m, # features)
+ * @param b array of shape (n, # features)
+ * @param ret output of shape (m, n)
+ */
+template <typename ArrayType>
+void PairwiseCosine(ArrayType const &a, ArrayType const &b, ArrayType &ret)
+{
+  ASSERT(a.shape().size() == 2 && b.shape().size() == 2);
+  ASSERT(a.shape()[1] == b.shape()[1]);
+
+  SizeType const m = a.shape()[0];
+  SizeType const n = b.shape()[0];
+
+  auto const a_lengths =
+      details::Lengths(details::RowSquareNorms(a.data().pointer(), m, m, a.shape()[1]));
+  auto const b_lengths =
+      details::Lengths(details::RowSquareNorms(b.data().pointer(), n, n, b.shape()[1]));
+
+  DotTranspose(a, b, ret);
+  details::CosineFromInnerProducts(ret.data().pointer(), m, a_lengths.data(), b_lengths.data(), m,
+                                   n);
+}
+
+template <typename ArrayType>
+ArrayType PairwiseEuclidean(ArrayType const &a, ArrayType const &b)
+{
+  ArrayType ret({a.shape()[0], b.shape()[0]});
+  PairwiseEuclidean(a, b, ret);
+  return ret;
+}
+
+template <typename ArrayType>
+ArrayType PairwiseCosine(ArrayType const &a, ArrayType const &b)
+{
+  ArrayType ret({a.shape()[0], b.shape()[0]});
+  PairwiseCosine(a, b, ret);
+  return ret;
 }
 
 }  // namespace distance
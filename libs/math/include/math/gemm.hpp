@@ -0,0 +1,551 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "math/base_types.hpp"
+#include "math/meta/math_type_traits.hpp"
+#include "vectorise/platform.hpp"
+#include "vectorise/threading/singleton_pool.hpp"
+#include "vectorise/vectorise.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace fetch {
+namespace math {
+
+/// The limit on the threads of split loops, 0 for all the hardware threads
+inline std::atomic<SizeType> &ThreadLimit()
+{
+  static std::atomic<SizeType> limit{0};
+  return limit;
+}
+
+/**
+ * Limits the number of threads that the products and other split loops spread their work over,
+ * for example to measure how they scale
+ * @param num_threads the maximum number of threads, 0 to use all the hardware threads
+ */
+inline void SetMaxThreads(SizeType num_threads)
+{
+  ThreadLimit() = num_threads;
+}
+
+/// The number of threads that split loops spread their work over at most
+inline SizeType MaxThreads()
+{
+  SizeType const limit = ThreadLimit();
+  if (limit != 0)
+  {
+    return limit;
+  }
+  return std::max(SizeType{1}, static_cast<SizeType>(std::thread::hardware_concurrency()));
+}
+
+namespace details_gemm {
+
+/**
+ * A read only view of a matrix in column major storage. Swapping the strides gives a view of the
+ * transpose without moving any data.
+ */
+template <typename T>
+struct MatrixView
+{
+  T const *data;
+  SizeType row_stride;
+  SizeType column_stride;
+
+  T operator()(SizeType i, SizeType j) const
+  {
+    return data[(i * row_stride) + (j * column_stride)];
+  }
+
+  MatrixView Offset(SizeType i, SizeType j) const
+  {
+    return {data + (i * row_stride) + (j * column_stride), row_stride, column_stride};
+  }
+
+  MatrixView Transposed() const
+  {
+    return {data, column_stride, row_stride};
+  }
+};
+
+/**
+ * Scale the (m x n) matrix C by beta, where a beta of zero overwrites C (so that whatever C held
+ * before, including NaNs, does not leak into the result)
+ */
+template <typename T>
+void Scale(T beta, T *c, SizeType ldc, SizeType m, SizeType n)
+{
+  if (beta == T(1))
+  {
+    return;
+  }
+
+  for (SizeType j = 0; j < n; ++j)
+  {
+    T *column = c + (j * ldc);
+    for (SizeType i = 0; i < m; ++i)
+    {
+      column[i] = (beta == T(0)) ? T(0) : T(beta * column[i]);
+    }
+  }
+}
+
+/**
+ * Reference routine for C = alpha * A.B + beta * C, used for small matrices and for the types
+ * which have no vector registers (like the integer types)
+ */
+template <typename T>
+void NaiveMultiply(T alpha, MatrixView<T> const &a, MatrixView<T> const &b, T beta, T *c,
+                   SizeType ldc, SizeType m, SizeType n, SizeType k)
+{
+  for (SizeType j = 0; j < n; ++j)
+  {
+    for (SizeType i = 0; i < m; ++i)
+    {
+      T sum{0};
+      for (SizeType p = 0; p < k; ++p)
+      {
+        sum += a(i, p) * b(p, j);
+      }
+
+      T &element = c[i + (j * ldc)];
+      element    = (beta == T(0)) ? T(alpha * sum) : T((alpha * sum) + (beta * element));
+    }
+  }
+}
+
+/// The number of multiply adds above which the products are split between threads
+constexpr SizeType PARALLEL_THRESHOLD = SizeType{128} * 128 * 128;
+
+/**
+ * Call function(begin, columns) over blocks of the n columns of C. The columns are split between
+ * the threads of the pool, in multiples of granularity columns, for the larger products, and the
+ * calling thread takes part in the work itself. Loops nested inside a share are split again on the
+ * same pool, whose waiting threads run the pending shares rather than blocking.
+ */
+template <typename Function>
+void ForEachColumnBlock(SizeType m, SizeType n, SizeType k, SizeType granularity,
+                        Function const &function)
+{
+  SizeType const blocks = (n + granularity - 1) / granularity;
+
+  SizeType num_threads = 1;
+  if ((m * n * k) >= PARALLEL_THRESHOLD)
+  {
+    num_threads = std::max(SizeType{1}, std::min(MaxThreads(), blocks));
+  }
+
+  if (num_threads == 1)
+  {
+    function(SizeType{0}, n);
+    return;
+  }
+
+  SizeType const chunk = ((blocks + num_threads - 1) / num_threads) * granularity;
+
+  threading::SingletonPool::GetInstance().ParallelFor(
+      0, n, chunk, [&function](SizeType begin, SizeType end) { function(begin, end - begin); });
+}
+
+/**
+ * Packed, register tiled matrix multiplication on the vector registers of the platform.
+ *
+ * C is computed in tiles of MR x NR elements, each of which is held in registers over the whole
+ * depth of a panel. The operands are copied into packed panels first: KC x NR slivers of B which
+ * stay in L1 while an MC x KC block of A (in L2) is streamed past them. The columns of C are split
+ * between the threads of the pool for the larger products.
+ */
+template <typename T>
+class Gemm
+{
+public:
+  using VectorRegisterType = vectorize::VectorRegister<T, platform::VectorRegisterSize<T>::value>;
+
+  static constexpr SizeType LANES = VectorRegisterType::E_BLOCK_COUNT;
+  static constexpr SizeType MR    = 2 * LANES;  ///< The rows of a register tile
+  static constexpr SizeType NR    = 4;          ///< The columns of a register tile
+  static constexpr SizeType KC    = 256;        ///< The depth of the packed panels
+  static constexpr SizeType MC    = 16 * MR;    ///< The rows of a packed block of A
+  static constexpr SizeType NC    = 1024;       ///< The columns of a packed block of B
+
+  static void Multiply(T alpha, MatrixView<T> const &a, MatrixView<T> const &b, T beta, T *c,
+                       SizeType ldc, SizeType m, SizeType n, SizeType k);
+
+private:
+  static void MultiplyColumns(T alpha, MatrixView<T> const &a, MatrixView<T> const &b, T beta,
+                              T *c, SizeType ldc, SizeType m, SizeType n, SizeType k);
+  static void PackA(MatrixView<T> const &a, SizeType mc, SizeType kc, T *packed);
+  static void PackB(MatrixView<T> const &b, SizeType kc, SizeType nc, T *packed);
+  static void MicroKernel(SizeType kc, T const *a, T const *b, T alpha, T *c, SizeType ldc,
+                          SizeType rows, SizeType columns);
+  static T *   AlignedBuffer(std::vector<T> &storage, SizeType size);
+};
+
+template <typename T>
+constexpr SizeType Gemm<T>::LANES;
+template <typename T>
+constexpr SizeType Gemm<T>::MR;
+template <typename T>
+constexpr SizeType Gemm<T>::NR;
+template <typename T>
+constexpr SizeType Gemm<T>::KC;
+template <typename T>
+constexpr SizeType Gemm<T>::MC;
+template <typename T>
+constexpr SizeType Gemm<T>::NC;
+
+/**
+ * Compute C = alpha * A.B + beta * C
+ *
+ * @param alpha The scale of the product
+ * @param a The (m x k) matrix A
+ * @param b The (k x n) matrix B
+ * @param beta The scale of the existing contents of C
+ * @param c The (m x n) matrix C, in column major storage
+ * @param ldc The distance between the columns of C
+ */
+template <typename T>
+void Gemm<T>::Multiply(T alpha, MatrixView<T> const &a, MatrixView<T> const &b, T beta, T *c,
+                       SizeType ldc, SizeType m, SizeType n, SizeType k)
+{
+  // split the columns of C between the threads, in whole register tiles
+  ForEachColumnBlock(m, n, k, NR, [&](SizeType begin, SizeType columns) {
+    MultiplyColumns(alpha, a, b.Offset(0, begin), beta, c + (begin * ldc), ldc, m, columns, k);
+  });
+}
+
+template <typename T>
+void Gemm<T>::MultiplyColumns(T alpha, MatrixView<T> const &a, MatrixView<T> const &b, T beta,
+                              T *c, SizeType ldc, SizeType m, SizeType n, SizeType k)
+{
+  Scale(beta, c, ldc, m, n);
+
+  // every thread packs into its own buffers, which are kept between calls
+  thread_local std::vector<T> a_storage;
+  thread_local std::vector<T> b_storage;
+  T *const packed_a = AlignedBuffer(a_storage, MC * KC);
+  T *const packed_b = AlignedBuffer(b_storage, KC * (NC + NR));
+
+  for (SizeType jc = 0; jc < n; jc += NC)
+  {
+    SizeType const nc = std::min(NC, n - jc);
+
+    for (SizeType pc = 0; pc < k; pc += KC)
+    {
+      SizeType const kc = std::min(KC, k - pc);
+      PackB(b.Offset(pc, jc), kc, nc, packed_b);
+
+      for (SizeType ic = 0; ic < m; ic += MC)
+      {
+        SizeType const mc = std::min(MC, m - ic);
+        PackA(a.Offset(ic, pc), mc, kc, packed_a);
+
+        for (SizeType jr = 0; jr < nc; jr += NR)
+        {
+          for (SizeType ir = 0; ir < mc; ir += MR)
+          {
+            MicroKernel(kc, packed_a + (ir * kc), packed_b + (jr * kc), alpha,
+                        c + (ic + ir) + ((jc + jr) * ldc), ldc, std::min(MR, mc - ir),
+                        std::min(NR, nc - jr));
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Pack a block of A into panels of MR rows, each of which holds the MR elements of a column next
+ * to each other. The panels are padded with zeros at the bottom of the block.
+ */
+template <typename T>
+void Gemm<T>::PackA(MatrixView<T> const &a, SizeType mc, SizeType kc, T *packed)
+{
+  for (SizeType i0 = 0; i0 < mc; i0 += MR)
+  {
+    SizeType const rows = std::min(MR, mc - i0);
+    for (SizeType p = 0; p < kc; ++p)
+    {
+      for (SizeType r = 0; r < rows; ++r)
+      {
+        packed[r] = a(i0 + r, p);
+      }
+      std::fill(packed + rows, packed + MR, T{0});
+      packed += MR;
+    }
+  }
+}
+
+/**
+ * Pack a block of B into panels of NR columns, each of which holds the NR elements of a row next
+ * to each other. The panels are padded with zeros at the right of the block.
+ */
+template <typename T>
+void Gemm<T>::PackB(MatrixView<T> const &b, SizeType kc, SizeType nc, T *packed)
+{
+  for (SizeType j0 = 0; j0 < nc; j0 += NR)
+  {
+    SizeType const columns = std::min(NR, nc - j0);
+    for (SizeType p = 0; p < kc; ++p)
+    {
+      for (SizeType r = 0; r < columns; ++r)
+      {
+        packed[r] = b(p, j0 + r);
+      }
+      std::fill(packed + columns, packed + NR, T{0});
+      packed += NR;
+    }
+  }
+}
+
+/**
+ * Accumulate alpha times the product of a packed panel of A and a packed panel of B into a tile
+ * of C, of which only the top left (rows x columns) elements are valid
+ */
+template <typename T>
+void Gemm<T>::MicroKernel(SizeType kc, T const *a, T const *b, T alpha, T *c, SizeType ldc,
+                          SizeType rows, SizeType columns)
+{
+  VectorRegisterType const zero(T{0});
+
+  VectorRegisterType c00 = zero;
+  VectorRegisterType c10 = zero;
+  VectorRegisterType c01 = zero;
+  VectorRegisterType c11 = zero;
+  VectorRegisterType c02 = zero;
+  VectorRegisterType c12 = zero;
+  VectorRegisterType c03 = zero;
+  VectorRegisterType c13 = zero;
+
+  for (SizeType p = 0; p < kc; ++p)
+  {
+    VectorRegisterType const a0(a);
+    VectorRegisterType const a1(a + LANES);
+
+    VectorRegisterType const b0(b[0]);
+    c00 = c00 + (a0 * b0);
+    c10 = c10 + (a1 * b0);
+
+    VectorRegisterType const b1(b[1]);
+    c01 = c01 + (a0 * b1);
+    c11 = c11 + (a1 * b1);
+
+    VectorRegisterType const b2(b[2]);
+    c02 = c02 + (a0 * b2);
+    c12 = c12 + (a1 * b2);
+
+    VectorRegisterType const b3(b[3]);
+    c03 = c03 + (a0 * b3);
+    c13 = c13 + (a1 * b3);
+
+    a += MR;
+    b += NR;
+  }
+
+  alignas(sizeof(VectorRegisterType)) T tile[MR * NR];
+  c00.Store(tile);
+  c10.Store(tile + LANES);
+  c01.Store(tile + MR);
+  c11.Store(tile + MR + LANES);
+  c02.Store(tile + (2 * MR));
+  c12.Store(tile + (2 * MR) + LANES);
+  c03.Store(tile + (3 * MR));
+  c13.Store(tile + (3 * MR) + LANES);
+
+  for (SizeType j = 0; j < columns; ++j)
+  {
+    T *const       column = c + (j * ldc);
+    T const *const values = tile + (j * MR);
+    for (SizeType i = 0; i < rows; ++i)
+    {
+      column[i] += alpha * values[i];
+    }
+  }
+}
+
+/// Get a buffer of (at least) the specified size, aligned for the vector registers
+template <typename T>
+T *Gemm<T>::AlignedBuffer(std::vector<T> &storage, SizeType size)
+{
+  constexpr std::uintptr_t ALIGNMENT = sizeof(VectorRegisterType);
+
+  storage.resize(size + (ALIGNMENT / sizeof(T)));
+  auto const address = reinterpret_cast<std::uintptr_t>(storage.data());
+  return reinterpret_cast<T *>((address + ALIGNMENT - 1) & ~(ALIGNMENT - 1));
+}
+
+/**
+ * Matrix multiplication for the fixed point types.
+ *
+ * The products of the underlying integers are summed at twice their width and only shifted back
+ * to the fixed point scale once per element of C, rather than after every product. This leaves an
+ * integer multiply add over a packed column of A as the inner loop, which the compiler vectorises,
+ * and since integer sums do not depend on their order the result is the same however the product
+ * is split between threads.
+ */
+template <typename T>
+class FixedPointGemm
+{
+public:
+  using Type     = typename T::Type;
+  using NextType = typename T::NextType;
+
+  static constexpr SizeType MC = 64;  ///< The rows of C accumulated together
+
+  static void Multiply(T alpha, MatrixView<T> const &a, MatrixView<T> const &b, T beta, T *c,
+                       SizeType ldc, SizeType m, SizeType n, SizeType k);
+
+private:
+  static void MultiplyColumns(T alpha, MatrixView<T> const &a, MatrixView<T> const &b, T beta,
+                              T *c, SizeType ldc, SizeType m, SizeType n, SizeType k);
+};
+
+template <typename T>
+constexpr SizeType FixedPointGemm<T>::MC;
+
+template <typename T>
+void FixedPointGemm<T>::Multiply(T alpha, MatrixView<T> const &a, MatrixView<T> const &b, T beta,
+                                 T *c, SizeType ldc, SizeType m, SizeType n, SizeType k)
+{
+  ForEachColumnBlock(m, n, k, 1, [&](SizeType begin, SizeType columns) {
+    MultiplyColumns(alpha, a, b.Offset(0, begin), beta, c + (begin * ldc), ldc, m, columns, k);
+  });
+}
+
+template <typename T>
+void FixedPointGemm<T>::MultiplyColumns(T alpha, MatrixView<T> const &a, MatrixView<T> const &b,
+                                        T beta, T *c, SizeType ldc, SizeType m, SizeType n,
+                                        SizeType k)
+{
+  thread_local std::vector<Type> packed;
+  packed.resize(MC * k);
+
+  NextType accumulators[MC];
+
+  for (SizeType ic = 0; ic < m; ic += MC)
+  {
+    SizeType const mc = std::min(MC, m - ic);
+
+    // the underlying integers of a block of rows of A, column by column
+    Type *destination = packed.data();
+    for (SizeType p = 0; p < k; ++p)
+    {
+      for (SizeType r = 0; r < mc; ++r)
+      {
+        *destination++ = a(ic + r, p).Data();
+      }
+    }
+
+    for (SizeType j = 0; j < n; ++j)
+    {
+      std::fill(accumulators, accumulators + mc, NextType{0});
+
+      Type const *column = packed.data();
+      for (SizeType p = 0; p < k; ++p, column += mc)
+      {
+        Type const factor = b(p, j).Data();
+        for (SizeType r = 0; r < mc; ++r)
+        {
+          accumulators[r] += NextType(column[r]) * NextType(factor);
+        }
+      }
+
+      T *const output = c + ic + (j * ldc);
+      for (SizeType r = 0; r < mc; ++r)
+      {
+        T const sum = T::FromBase(Type(accumulators[r] >> T::FRACTIONAL_BITS));
+        output[r]   = (beta == T(0)) ? T(alpha * sum) : T((alpha * sum) + (beta * output[r]));
+      }
+    }
+  }
+}
+
+/**
+ * Whether the products of a type are computed with the vector kernel, which needs vector registers
+ * with more than one element of the type
+ */
+template <typename T>
+struct UseGemmKernel
+{
+  static constexpr bool value =
+      (std::is_same<T, float>::value || std::is_same<T, double>::value) &&
+      (vectorize::VectorRegister<T, platform::VectorRegisterSize<T>::value>::E_BLOCK_COUNT > 1);
+};
+
+/// The number of multiply adds above which the vector kernel is used
+constexpr SizeType GEMM_THRESHOLD = SizeType{32} * 32 * 32;
+
+template <typename T>
+void Multiply(std::true_type /*use_gemm_kernel*/, T alpha, MatrixView<T> const &a,
+              MatrixView<T> const &b, T beta, T *c, SizeType ldc, SizeType m, SizeType n,
+              SizeType k)
+{
+  if ((m * n * k) >= GEMM_THRESHOLD)
+  {
+    Gemm<T>::Multiply(alpha, a, b, beta, c, ldc, m, n, k);
+  }
+  else
+  {
+    NaiveMultiply(alpha, a, b, beta, c, ldc, m, n, k);
+  }
+}
+
+template <typename T>
+void Multiply(std::false_type /*use_gemm_kernel*/, T alpha, MatrixView<T> const &a,
+              MatrixView<T> const &b, T beta, T *c, SizeType ldc, SizeType m, SizeType n,
+              SizeType k)
+{
+  NaiveMultiply(alpha, a, b, beta, c, ldc, m, n, k);
+}
+
+/**
+ * Compute C = alpha * A.B + beta * C, selecting the implementation from the type and the size of
+ * the product
+ *
+ * @param a The (m x k) matrix A
+ * @param b The (k x n) matrix B
+ * @param c The (m x n) matrix C, in column major storage with a distance of ldc between columns
+ */
+template <typename T>
+meta::IfIsNotFixedPoint<T, void> Multiply(T alpha, MatrixView<T> const &a, MatrixView<T> const &b,
+                                          T beta, T *c, SizeType ldc, SizeType m, SizeType n,
+                                          SizeType k)
+{
+  Multiply(std::integral_constant<bool, UseGemmKernel<T>::value>{}, alpha, a, b, beta, c, ldc, m,
+           n, k);
+}
+
+template <typename T>
+meta::IfIsFixedPoint<T, void> Multiply(T alpha, MatrixView<T> const &a, MatrixView<T> const &b,
+                                       T beta, T *c, SizeType ldc, SizeType m, SizeType n,
+                                       SizeType k)
+{
+  FixedPointGemm<T>::Multiply(alpha, a, b, beta, c, ldc, m, n, k);
+}
+
+}  // namespace details_gemm
+}  // namespace math
+}  // namespace fetch
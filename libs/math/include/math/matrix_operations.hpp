@@ -23,7 +23,9 @@
 #include "math/base_types.hpp"
 #include "math/comparison.hpp"
 #include "math/fundamental_operators.hpp"  // add, subtract etc.
+#include "math/gemm.hpp"
 #include "math/meta/math_type_traits.hpp"
+#include "vectorise/memory/parallel_dispatcher.hpp"
 
 namespace fetch {
 namespace math {
@@ -82,6 +84,33 @@ void Sum(ArrayType const &obj1, typename ArrayType::Type &ret)
                                          typename ArrayType::VectorRegisterType { return a + b; });
 }
 
+/**
+ * The sum of the elements of a floating point array. The sum is vectorised and split between the
+ * threads of the pool for the larger arrays, in an order which does not depend on the number of
+ * threads (see ConstParallelDispatcher::ParallelSumReduce).
+ */
+template <typename ArrayType>
+meta::IfIsMathFloatArray<ArrayType, typename ArrayType::Type> ParallelSum(ArrayType const &array)
+{
+  using VectorRegisterType = typename ArrayType::VectorRegisterType;
+
+  memory::ConstParallelDispatcher<typename ArrayType::Type> dispatcher(array.data().pointer(),
+                                                                      array.size());
+  return dispatcher.ParallelSumReduce([](VectorRegisterType const &x) { return x; });
+}
+
+template <typename ArrayType>
+meta::IfIsMathNonFloatArray<ArrayType, typename ArrayType::Type> ParallelSum(
+    ArrayType const &array)
+{
+  typename ArrayType::Type ret{0};
+  for (auto const &val : array)
+  {
+    ret += val;
+  }
+  return ret;
+}
+
 }  // namespace details_vectorisation
 
 /**
@@ -414,11 +443,7 @@ meta::IfIsMathArray<ArrayType, ArrayType> Maximum(ArrayType const &array1, Array
 template <typename ArrayType, typename T, typename = std::enable_if_t<meta::IsArithmetic<T>>>
 meta::IfIsMathArray<ArrayType, void> Sum(ArrayType const &array1, T &ret)
 {
-  ret = typename ArrayType::Type(0);
-  for (auto &val : array1)
-  {
-    ret += val;
-  }
+  ret = static_cast<T>(details_vectorisation::ParallelSum(array1));
 }
 
 template <typename ArrayType>
@@ -610,25 +635,56 @@ T ArgMax(std::vector<T> const &obj1)
   return ret;
 }
 
+namespace details_gemm {
+
+template <typename ArrayType>
+MatrixView<typename ArrayType::Type> View(ArrayType const &array)
+{
+  return {array.data().pointer(), 1, array.shape()[0]};
+}
+
+template <typename ArrayType>
+void Multiply(typename ArrayType::Type alpha, MatrixView<typename ArrayType::Type> const &a,
+              MatrixView<typename ArrayType::Type> const &b, typename ArrayType::Type beta,
+              ArrayType &ret, SizeType k)
+{
+  Multiply(alpha, a, b, beta, ret.data().pointer(), ret.shape()[0], ret.shape()[0],
+           ret.shape()[1], k);
+}
+
+}  // namespace details_gemm
+
+/**
+ * Routine for C = alpha * A.B + beta * C, which uses a blocked vector kernel (see gemm.hpp) for
+ * the larger floating point products
+ * @param A
+ * @param B
+ * @param ret
+ * @param alpha
+ * @param beta
+ */
 template <typename ArrayType>
 fetch::math::meta::IfIsMathArray<ArrayType, void> Dot(ArrayType const &A, ArrayType const &B,
-                                                      ArrayType &ret)
+                                                      ArrayType &ret,
+                                                      typename ArrayType::Type alpha,
+                                                      typename ArrayType::Type beta)
 {
   ASSERT(A.shape().size() == 2);
   ASSERT(B.shape().size() == 2);
   ASSERT(A.shape()[1] == B.shape()[0]);
+  ASSERT(A.shape()[0] == ret.shape()[0]);
+  ASSERT(B.shape()[1] == ret.shape()[1]);
 
-  for (SizeType i(0); i < A.shape()[0]; ++i)
-  {
-    for (SizeType j(0); j < B.shape()[1]; ++j)
-    {
-      ret.At(i, j) = A.At(i, 0) * B.At(0, j);
-      for (SizeType k(1); k < A.shape()[1]; ++k)
-      {
-        ret.At(i, j) += A.At(i, k) * B.At(k, j);
-      }
-    }
-  }
+  details_gemm::Multiply(alpha, details_gemm::View(A), details_gemm::View(B), beta, ret,
+                         A.shape()[1]);
+}
+
+template <typename ArrayType>
+fetch::math::meta::IfIsMathArray<ArrayType, void> Dot(ArrayType const &A, ArrayType const &B,
+                                                      ArrayType &ret)
+{
+  using Type = typename ArrayType::Type;
+  Dot(A, B, ret, Type(1), Type(0));
 }
 
 template <typename ArrayType>
@@ -641,15 +697,18 @@ ArrayType Dot(ArrayType const &A, ArrayType const &B)
 }
 
 /**
- * Naive routine for C = A.T(B)
+ * Routine for C = alpha * A.T(B) + beta * C
  * @param A
  * @param B
  * @param ret
- * @return
+ * @param alpha
+ * @param beta
  */
 template <class ArrayType>
 fetch::math::meta::IfIsMathArray<ArrayType, void> DotTranspose(ArrayType const &A,
-                                                               ArrayType const &B, ArrayType &ret)
+                                                               ArrayType const &B, ArrayType &ret,
+                                                               typename ArrayType::Type alpha,
+                                                               typename ArrayType::Type beta)
 {
   ASSERT(A.shape().size() == 2);
   ASSERT(B.shape().size() == 2);
@@ -657,16 +716,16 @@ fetch::math::meta::IfIsMathArray<ArrayType, void> DotTranspose(ArrayType const &
   ASSERT(A.shape()[0] == ret.shape()[0]);
   ASSERT(B.shape()[0] == ret.shape()[1]);
 
-  for (size_t i(0); i < A.shape()[0]; ++i)
-  {
-    for (size_t j(0); j < B.shape()[0]; ++j)
-    {
-      for (size_t k(0); k < A.shape()[1]; ++k)
-      {
-        ret.At(i, j) += A.At(i, k) * B.At(j, k);
-      }
-    }
-  }
+  details_gemm::Multiply(alpha, details_gemm::View(A), details_gemm::View(B).Transposed(), beta,
+                         ret, A.shape()[1]);
+}
+
+template <class ArrayType>
+fetch::math::meta::IfIsMathArray<ArrayType, void> DotTranspose(ArrayType const &A,
+                                                               ArrayType const &B, ArrayType &ret)
+{
+  using Type = typename ArrayType::Type;
+  DotTranspose(A, B, ret, Type(1), Type(0));
 }
 
 template <typename ArrayType>
@@ -680,30 +739,35 @@ fetch::math::meta::IfIsMathArray<ArrayType, ArrayType> DotTranspose(ArrayType co
 }
 
 /**
- * Naive routine for C = T(A).B
+ * Routine for C = alpha * T(A).B + beta * C
  * @param A
  * @param B
  * @param ret
- * @return
+ * @param alpha
+ * @param beta
  */
 template <class ArrayType>
 fetch::math::meta::IfIsMathArray<ArrayType, void> TransposeDot(ArrayType const &A,
-                                                               ArrayType const &B, ArrayType &ret)
+                                                               ArrayType const &B, ArrayType &ret,
+                                                               typename ArrayType::Type alpha,
+                                                               typename ArrayType::Type beta)
 {
+  ASSERT(A.shape().size() == 2);
+  ASSERT(B.shape().size() == 2);
   ASSERT(A.shape()[0] == B.shape()[0]);
   ASSERT(A.shape()[1] == ret.shape()[0]);
   ASSERT(B.shape()[1] == ret.shape()[1]);
 
-  for (size_t i(0); i < A.shape()[1]; ++i)
-  {
-    for (size_t j(0); j < B.shape()[1]; ++j)
-    {
-      for (size_t k(0); k < A.shape()[0]; ++k)
-      {
-        ret.At(i, j) += A.At(k, i) * B.At(k, j);
-      }
-    }
-  }
+  details_gemm::Multiply(alpha, details_gemm::View(A).Transposed(), details_gemm::View(B), beta,
+                         ret, A.shape()[0]);
+}
+
+template <class ArrayType>
+fetch::math::meta::IfIsMathArray<ArrayType, void> TransposeDot(ArrayType const &A,
+                                                               ArrayType const &B, ArrayType &ret)
+{
+  using Type = typename ArrayType::Type;
+  TransposeDot(A, B, ret, Type(1), Type(0));
 }
 
 template <class ArrayType>
@@ -131,6 +131,14 @@ template <typename DataType, typename ReturnType>
 using IfIsMathNonFixedPointArray =
     IfIsNotFixedPoint<typename DataType::Type, IfIsMathArray<DataType, ReturnType>>;
 
+template <typename DataType, typename ReturnType>
+using IfIsMathFloatArray =
+    EnableIf<fetch::meta::IsFloat<typename DataType::Type>, IfIsMathArray<DataType, ReturnType>>;
+
+template <typename DataType, typename ReturnType>
+using IfIsMathNonFloatArray =
+    EnableIf<!fetch::meta::IsFloat<typename DataType::Type>, IfIsMathArray<DataType, ReturnType>>;
+
 }  // namespace meta
 }  // namespace math
 }  // namespace fetch
@@ -19,7 +19,9 @@
 
 #include "core/assert.hpp"
 #include "math/comparison.hpp"
+#include "math/meta/math_type_traits.hpp"
 #include "math/standard_functions/exp.hpp"
+#include "vectorise/vectorise.hpp"
 
 namespace fetch {
 namespace math {
@@ -32,7 +34,9 @@ namespace math {
  * @param ret
  */
 template <typename ArrayType>
-void Elu(ArrayType const &t, typename ArrayType::Type &a, ArrayType &ret)
+meta::IfIsMathNonFloatArray<ArrayType, void> Elu(ArrayType const &t, typename ArrayType::Type &a,
+                                                 ArrayType &ret,
+                                                 Accuracy /*accuracy*/ = Accuracy::PRECISE)
 {
   ASSERT(t.size() == ret.size());
   using DataType = typename ArrayType::Type;
@@ -56,11 +60,41 @@ void Elu(ArrayType const &t, typename ArrayType::Type &a, ArrayType &ret)
   }
 }
 
+/**
+ * Exponential linear unit of floating point values, vectorised
+ * @tparam ArrayType
+ * @param t
+ * @param a
+ * @param ret
+ * @param accuracy the accuracy of the exponential
+ */
+template <typename ArrayType>
+meta::IfIsMathFloatArray<ArrayType, void> Elu(ArrayType const &t, typename ArrayType::Type &a,
+                                              ArrayType &ret, Accuracy accuracy = Accuracy::PRECISE)
+{
+  using Type               = typename ArrayType::Type;
+  using VectorRegisterType = typename ArrayType::VectorRegisterType;
+  ASSERT(t.size() == ret.size());
+
+  VectorRegisterType const zero(Type{0});
+  VectorRegisterType const one(Type{1});
+  VectorRegisterType const scale(a);
+
+  // f(x) = max(x, 0) + a * (e^min(x, 0) - 1), i.e. x for x >= 0 and a * (e^x - 1) otherwise
+  ret.data().in_parallel().Apply(
+      memory::TrivialRange(0, t.size()),
+      [zero, one, scale, accuracy](VectorRegisterType const &x, VectorRegisterType &z) {
+        z = max(x, zero) + (scale * (vectorize::polynomial_exp(min(x, zero), accuracy) - one));
+      },
+      t.data());
+}
+
 template <typename ArrayType>
-ArrayType Elu(ArrayType const &t, typename ArrayType::Type &a)
+ArrayType Elu(ArrayType const &t, typename ArrayType::Type &a,
+              Accuracy accuracy = Accuracy::PRECISE)
 {
   ArrayType ret(t.shape());
-  Elu(t, a, ret);
+  Elu(t, a, ret, accuracy);
   return ret;
 }
 
@@ -36,24 +36,16 @@ void LeakyRelu(ArrayType const &t, typename ArrayType::Type const &a, ArrayType
 {
   ASSERT(t.size() == ret.size());
   using DataType = typename ArrayType::Type;
+  using SizeType = typename ArrayType::SizeType;
 
-  auto it  = t.cbegin();
-  auto rit = ret.begin();
-  while (it.is_valid())
+  // f(x)=x for x>=0, f(x)=a*x for x<0, over the (contiguous) storage
+  DataType const *input  = t.data().pointer();
+  DataType *      output = ret.data().pointer();
+  DataType const  alpha  = a;
+  for (SizeType i = 0, end = t.size(); i < end; ++i)
   {
-    *rit = fetch::math::Max(*it, typename ArrayType::Type(0));
-    if (*it >= DataType(0))
-    {
-      // f(x)=x for x>=0
-      *rit = *it;
-    }
-    else
-    {
-      // f(x)=a*x for x<0
-      *rit = Multiply(a, *it);
-    }
-    ++it;
-    ++rit;
+    DataType const x = input[i];
+    output[i]        = (x >= DataType(0)) ? x : DataType(alpha * x);
   }
 }
 
@@ -79,27 +71,16 @@ void LeakyRelu(ArrayType const &t, ArrayType const &a, ArrayType &ret)
     ASSERT(t.size() == ret.size());
     ASSERT(t.size() == a.size());
     using DataType = typename ArrayType::Type;
+    using SizeType = typename ArrayType::SizeType;
 
-    auto it  = t.cbegin();
-    auto rit = ret.begin();
-    auto ait = a.begin();
-
-    while (it.is_valid())
+    // f(x)=x for x>=0, f(x)=a*x for x<0, over the (contiguous) storage
+    DataType const *input  = t.data().pointer();
+    DataType const *alpha  = a.data().pointer();
+    DataType *      output = ret.data().pointer();
+    for (SizeType i = 0, end = t.size(); i < end; ++i)
     {
-      *rit = fetch::math::Max(*it, typename ArrayType::Type(0));
-      if (*it >= DataType(0))
-      {
-        // f(x)=x for x>=0
-        *rit = *it;
-      }
-      else
-      {
-        // f(x)=a*x for x<0
-        *rit = Multiply(*ait, *it);
-      }
-      ++it;
-      ++rit;
-      ++ait;
+      DataType const x = input[i];
+      output[i]        = (x >= DataType(0)) ? x : DataType(alpha[i] * x);
     }
   }
 }
@@ -32,15 +32,17 @@ namespace math {
 template <typename ArrayType>
 void Relu(ArrayType const &t, ArrayType &ret)
 {
+  using DataType = typename ArrayType::Type;
+  using SizeType = typename ArrayType::SizeType;
   assert(t.size() == ret.size());
 
-  auto it  = t.cbegin();
-  auto rit = ret.begin();
-  while (it.is_valid())
+  // a plain loop over the (contiguous) storage, which vectorises for the fixed point types too
+  DataType const *input  = t.data().pointer();
+  DataType *      output = ret.data().pointer();
+  DataType const  zero{0};
+  for (SizeType i = 0, end = t.size(); i < end; ++i)
   {
-    *rit = fetch::math::Max(*it, typename ArrayType::Type(0));
-    ++it;
-    ++rit;
+    output[i] = (input[i] < zero) ? zero : input[i];
   }
 }
 
@@ -17,7 +17,9 @@
 //
 //------------------------------------------------------------------------------
 
+#include "core/assert.hpp"
 #include "math/fundamental_operators.hpp"  // add, subtract etc.
+#include "math/meta/math_type_traits.hpp"
 #include "math/standard_functions/exp.hpp"
 
 namespace fetch {
@@ -30,7 +32,8 @@ namespace math {
  * @param ret
  */
 template <typename ArrayType>
-void Sigmoid(ArrayType const &t, ArrayType &ret)
+meta::IfIsMathNonFloatArray<ArrayType, void> Sigmoid(ArrayType const &t, ArrayType &ret,
+                                                     Accuracy /*accuracy*/ = Accuracy::PRECISE)
 {
   using Type = typename ArrayType::Type;
 
@@ -59,11 +62,38 @@ void Sigmoid(ArrayType const &t, ArrayType &ret)
   }
 }
 
+/**
+ * The sigmoid function of floating point values, vectorised
+ * @tparam ArrayType
+ * @param t
+ * @param ret
+ * @param accuracy the accuracy of the exponential
+ */
+template <typename ArrayType>
+meta::IfIsMathFloatArray<ArrayType, void> Sigmoid(ArrayType const &t, ArrayType &ret,
+                                                  Accuracy accuracy = Accuracy::PRECISE)
+{
+  using Type               = typename ArrayType::Type;
+  using VectorRegisterType = typename ArrayType::VectorRegisterType;
+  ASSERT(t.size() == ret.size());
+
+  VectorRegisterType const zero(Type{0});
+  VectorRegisterType const one(Type{1});
+
+  // for large negative values e^-x overflows to infinity, which gives the correct limit of 0
+  ret.data().in_parallel().Apply(
+      memory::TrivialRange(0, t.size()),
+      [zero, one, accuracy](VectorRegisterType const &x, VectorRegisterType &z) {
+        z = one / (one + vectorize::polynomial_exp(zero - x, accuracy));
+      },
+      t.data());
+}
+
 template <typename ArrayType>
-ArrayType Sigmoid(ArrayType const &t)
+ArrayType Sigmoid(ArrayType const &t, Accuracy accuracy = Accuracy::PRECISE)
 {
   ArrayType ret(t.shape());
-  Sigmoid(t, ret);
+  Sigmoid(t, ret, accuracy);
   return ret;
 }
 
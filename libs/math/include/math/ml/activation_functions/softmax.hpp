@@ -43,7 +43,7 @@ namespace details {
  */
 
 template <typename ArrayType1, typename ArrayType2>
-void Softmax1DImplementation(ArrayType1 const &array, ArrayType2 &ret)
+void Softmax1DImplementation(ArrayType1 const &array, ArrayType2 &ret, Accuracy accuracy)
 {
   using Type = typename ArrayType1::Type;
   ASSERT(ret.size() == array.size());
@@ -54,15 +54,22 @@ void Softmax1DImplementation(ArrayType1 const &array, ArrayType2 &ret)
 
   auto it1 = array.begin();
   auto it2 = ret.begin();
-  Type sum = Type(0);
   while (it1.is_valid())
   {
-    *it2 = Exp(*it1 - array_max);
-    sum += *it2;
+    *it2 = *it1 - array_max;
     ++it2;
     ++it1;
   }
 
+  // exponentiate the whole array at once, so that it is vectorised
+  Exp(ret, ret, accuracy);
+
+  Type sum = Type(0);
+  for (auto const &value : ret)
+  {
+    sum += value;
+  }
+
   auto it3 = ret.begin();  // TODO (private 855): Fix implictly deleted copy const. for iterator
   while (it3.is_valid())
   {
@@ -73,7 +80,7 @@ void Softmax1DImplementation(ArrayType1 const &array, ArrayType2 &ret)
 
 template <typename ArrayType>
 void Softmax2DImplementation(ArrayType const &array, ArrayType &ret,
-                             typename ArrayType::SizeType axis)
+                             typename ArrayType::SizeType axis, Accuracy accuracy)
 {
   assert(ret.size() == array.size());
   assert(array.shape().size() == 2);
@@ -85,25 +92,34 @@ void Softmax2DImplementation(ArrayType const &array, ArrayType &ret,
   {
     auto cur_slice = array.Slice(i).Copy();
     auto ret_slice = ret.Slice(i).Copy();
-    Softmax1DImplementation(cur_slice, ret_slice);
+    Softmax1DImplementation(cur_slice, ret_slice, accuracy);
     ret.Slice(i).Assign(ret_slice);
   }
 }
 }  // namespace details
 
+/**
+ * The softmax of an array along an axis
+ * @tparam ArrayType
+ * @param array
+ * @param ret
+ * @param axis
+ * @param accuracy the accuracy of the exponential, floating point arrays only
+ */
 template <typename ArrayType>
-void Softmax(ArrayType const &array, ArrayType &ret, typename ArrayType::SizeType axis)
+void Softmax(ArrayType const &array, ArrayType &ret, typename ArrayType::SizeType axis,
+             Accuracy accuracy = Accuracy::PRECISE)
 {
   assert(ret.size() == array.size());
 
   if ((array.shape().size() == 1) && (ret.shape().size() == 1))
   {
     assert(axis == 0);
-    details::Softmax1DImplementation(array, ret);
+    details::Softmax1DImplementation(array, ret, accuracy);
   }
   else if ((array.shape().size() == 2) && (ret.shape().size() == 2))
   {
-    details::Softmax2DImplementation(array, ret, axis);
+    details::Softmax2DImplementation(array, ret, axis, accuracy);
   }
   else
   {
@@ -20,6 +20,8 @@
 #include "core/assert.hpp"
 #include "core/fixed_point/fixed_point.hpp"
 #include "math/meta/math_type_traits.hpp"
+#include "vectorise/math/transcendental.hpp"
+#include "vectorise/memory/range.hpp"
 
 /**
  * e^x
@@ -29,6 +31,8 @@
 namespace fetch {
 namespace math {
 
+using Accuracy = vectorize::Accuracy;
+
 ///////////////////////
 /// IMPLEMENTATIONS ///
 ///////////////////////
@@ -73,6 +77,38 @@ meta::IfIsMathArray<ArrayType, void> Exp(ArrayType const &array, ArrayType &ret)
   }
 }
 
+/**
+ * e^x over a whole array of floating point values, evaluated as a polynomial one vector register
+ * at a time
+ *
+ * @param array The exponents
+ * @param ret The exponentials
+ * @param accuracy The accuracy of the polynomial
+ */
+template <typename ArrayType>
+meta::IfIsMathFloatArray<ArrayType, void> Exp(ArrayType const &array, ArrayType &ret,
+                                              Accuracy accuracy)
+{
+  using VectorRegisterType = typename ArrayType::VectorRegisterType;
+  ASSERT(ret.shape() == array.shape());
+
+  ret.data().in_parallel().Apply(memory::TrivialRange(0, array.size()),
+                                 [accuracy](VectorRegisterType const &x, VectorRegisterType &z) {
+                                   z = vectorize::polynomial_exp(x, accuracy);
+                                 },
+                                 array.data());
+}
+
+/**
+ * e^x over a whole array of fixed point (or integer) values, which always use the scalar function
+ */
+template <typename ArrayType>
+meta::IfIsMathNonFloatArray<ArrayType, void> Exp(ArrayType const &array, ArrayType &ret,
+                                                 Accuracy /*accuracy*/)
+{
+  Exp(array, ret);
+}
+
 template <typename ArrayType>
 meta::IfIsMathArray<ArrayType, ArrayType> Exp(ArrayType const &array)
 {
@@ -19,6 +19,8 @@
 
 #include "core/assert.hpp"
 #include "math/meta/math_type_traits.hpp"
+#include "vectorise/math/transcendental.hpp"
+#include "vectorise/memory/range.hpp"
 
 /**
  * natural logarithm of x
@@ -28,6 +30,8 @@
 namespace fetch {
 namespace math {
 
+using Accuracy = vectorize::Accuracy;
+
 ///////////////////////
 /// IMPLEMENTATIONS ///
 ///////////////////////
@@ -88,6 +92,35 @@ meta::IfIsMathArray<ArrayType, void> Log(ArrayType const &array, ArrayType &ret)
   }
 }
 
+/**
+ * The natural logarithm over a whole array of floating point values, evaluated as a series one
+ * vector register at a time
+ *
+ * @param array The values
+ * @param ret The logarithms
+ * @param accuracy The accuracy of the series
+ */
+template <typename ArrayType>
+meta::IfIsMathFloatArray<ArrayType, void> Log(ArrayType const &array, ArrayType &ret,
+                                              Accuracy accuracy)
+{
+  using VectorRegisterType = typename ArrayType::VectorRegisterType;
+  ASSERT(ret.shape() == array.shape());
+
+  ret.data().in_parallel().Apply(memory::TrivialRange(0, array.size()),
+                                 [accuracy](VectorRegisterType const &x, VectorRegisterType &z) {
+                                   z = vectorize::polynomial_log(x, accuracy);
+                                 },
+                                 array.data());
+}
+
+template <typename ArrayType>
+meta::IfIsMathNonFloatArray<ArrayType, void> Log(ArrayType const &array, ArrayType &ret,
+                                                 Accuracy /*accuracy*/)
+{
+  Log(array, ret);
+}
+
 template <typename ArrayType>
 meta::IfIsMathArray<ArrayType, ArrayType> Log(ArrayType const &array)
 {
@@ -118,6 +151,38 @@ meta::IfIsMathArray<ArrayType, void> Log2(ArrayType const &array, ArrayType &ret
   }
 }
 
+/**
+ * The base 2 logarithm over a whole array of floating point values, vectorised
+ *
+ * @param array The values
+ * @param ret The logarithms
+ * @param accuracy The accuracy of the series
+ */
+template <typename ArrayType>
+meta::IfIsMathFloatArray<ArrayType, void> Log2(ArrayType const &array, ArrayType &ret,
+                                               Accuracy accuracy)
+{
+  using Type               = typename ArrayType::Type;
+  using VectorRegisterType = typename ArrayType::VectorRegisterType;
+  ASSERT(ret.shape() == array.shape());
+
+  VectorRegisterType const log2e(static_cast<Type>(1.44269504088896340736));
+
+  ret.data().in_parallel().Apply(
+      memory::TrivialRange(0, array.size()),
+      [accuracy, log2e](VectorRegisterType const &x, VectorRegisterType &z) {
+        z = vectorize::polynomial_log(x, accuracy) * log2e;
+      },
+      array.data());
+}
+
+template <typename ArrayType>
+meta::IfIsMathNonFloatArray<ArrayType, void> Log2(ArrayType const &array, ArrayType &ret,
+                                                  Accuracy /*accuracy*/)
+{
+  Log2(array, ret);
+}
+
 template <typename ArrayType>
 meta::IfIsMathArray<ArrayType, ArrayType> Log2(ArrayType const &array)
 {
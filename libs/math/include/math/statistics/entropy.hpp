@@ -32,19 +32,25 @@ namespace statistics {
  * i.e. -sum(a*log2(a))
  * @param a input array of probabilities
  * @param ret return value
+ * @param accuracy the accuracy of the logarithm, floating point arrays only
  */
 template <typename ArrayType>
-void Entropy(ArrayType const &a, typename ArrayType::Type &ret)
+void Entropy(ArrayType const &a, typename ArrayType::Type &ret,
+             Accuracy accuracy = Accuracy::PRECISE)
 {
   using DataType = typename ArrayType::Type;
-  ret            = Multiply(DataType(-1), Sum(Multiply(a, fetch::math::Log2(a))));
+
+  ArrayType log2_a{a.shape()};
+  fetch::math::Log2(a, log2_a, accuracy);
+
+  ret = Multiply(DataType(-1), Sum(Multiply(a, log2_a)));
 }
 
 template <typename ArrayType>
-typename ArrayType::Type Entropy(ArrayType const &a)
+typename ArrayType::Type Entropy(ArrayType const &a, Accuracy accuracy = Accuracy::PRECISE)
 {
   typename ArrayType::Type ret;
-  Entropy(a, ret);
+  Entropy(a, ret, accuracy);
   return ret;
 }
 
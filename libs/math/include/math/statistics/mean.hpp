@@ -18,6 +18,7 @@
 //------------------------------------------------------------------------------
 
 #include "core/assert.hpp"
+#include "math/matrix_operations.hpp"
 #include "vectorise/memory/range.hpp"
 
 #include <cmath>
@@ -29,11 +30,7 @@ namespace statistics {
 template <typename ArrayType>
 meta::IfIsMathArray<ArrayType, void> Mean(ArrayType const &a, typename ArrayType::Type &ret)
 {
-  ret = typename ArrayType::Type(0);
-  for (std::size_t j = 0; j < a.size(); ++j)
-  {
-    ret += a.At(j);
-  }
+  ret = details_vectorisation::ParallelSum(a);
   ret /= static_cast<typename ArrayType::Type>(a.size());
   return ret;
 }
@@ -42,11 +39,7 @@ template <typename ArrayType>
 meta::IfIsMathArray<ArrayType, typename ArrayType::Type> Mean(ArrayType const &a)
 {
 
-  typename ArrayType::Type ret = 0;
-  for (std::size_t j = 0; j < a.size(); ++j)
-  {
-    ret += a.At(j);
-  }
+  typename ArrayType::Type ret = details_vectorisation::ParallelSum(a);
   ret /= static_cast<typename ArrayType::Type>(a.size());
   return ret;
 }
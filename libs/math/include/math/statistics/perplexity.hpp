@@ -33,19 +33,21 @@ namespace statistics {
  * @param a input tensor of dimensions n_data x n_features
  * @param i index of the data point on which distribution is centred
  * @param ret return value
+ * @param accuracy the accuracy of the logarithm, floating point arrays only
  */
 template <typename ArrayType>
-void Perplexity(ArrayType const &a, typename ArrayType::Type &ret)
+void Perplexity(ArrayType const &a, typename ArrayType::Type &ret,
+                Accuracy accuracy = Accuracy::PRECISE)
 {
   using DataType = typename ArrayType::Type;
-  Pow(DataType(2), Entropy(a), ret);
+  Pow(DataType(2), Entropy(a, accuracy), ret);
 }
 
 template <typename ArrayType>
-typename ArrayType::Type Perplexity(ArrayType const &a)
+typename ArrayType::Type Perplexity(ArrayType const &a, Accuracy accuracy = Accuracy::PRECISE)
 {
   typename ArrayType::Type ret;
-  Perplexity(a, ret);
+  Perplexity(a, ret, accuracy);
   return ret;
 }
 
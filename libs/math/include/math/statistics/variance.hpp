@@ -26,17 +26,47 @@ namespace fetch {
 namespace math {
 namespace statistics {
 
+namespace details {
+
+/// The sum of the squared deviations from the mean, split between threads for the larger arrays
 template <typename A>
-inline typename A::Type Variance(A const &a)
+meta::IfIsMathFloatArray<A, typename A::Type> SumSquaredDeviations(A const &a,
+                                                                   typename A::Type mean)
+{
+  using VectorRegisterType = typename A::VectorRegisterType;
+
+  VectorRegisterType const m(mean);
+
+  memory::ConstParallelDispatcher<typename A::Type> dispatcher(a.data().pointer(), a.size());
+  return dispatcher.ParallelSumReduce([&m](VectorRegisterType const &x) {
+    VectorRegisterType const d = x - m;
+    return d * d;
+  });
+}
+
+template <typename A>
+meta::IfIsMathNonFloatArray<A, typename A::Type> SumSquaredDeviations(A const &a,
+                                                                      typename A::Type mean)
 {
   using DataType = typename A::Type;
 
-  DataType m = Mean(a);
   DataType v{0};
   for (auto &val : a)
   {
-    v += ((val - m) * (val - m));
+    v += ((val - mean) * (val - mean));
   }
+  return v;
+}
+
+}  // namespace details
+
+template <typename A>
+inline typename A::Type Variance(A const &a)
+{
+  using DataType = typename A::Type;
+
+  DataType m = Mean(a);
+  DataType v = details::SumSquaredDeviations(a, m);
   v /= static_cast<DataType>(a.size());
 
   return v;
@@ -107,6 +107,7 @@ public:
   Tensor(Tensor &&other)      = default;
   Tensor(Tensor const &other) = default;
   Tensor(SizeVector const &dims);
+  Tensor(ContainerType data, SizeVector const &dims);
   virtual ~Tensor()
   {}
 
@@ -692,6 +693,20 @@ Tensor<T, C>::Tensor(SizeVector const &dims)
   this->SetAllZero();
 }
 
+/**
+ * Constructor wraps existing (column major) storage in a tensor without copying it
+ * @param data the storage, which must hold at least as many elements as the shape
+ * @param dims vector of lengths for each dimension
+ */
+template <typename T, typename C>
+Tensor<T, C>::Tensor(ContainerType data, SizeVector const &dims)
+  : data_(std::move(data))
+{
+  assert(data_.size() >= SelfType::SizeFromShape(dims));
+  LazyReshape(dims);
+  size_ = SelfType::SizeFromShape(dims);
+}
+
 /////////////////////////////////
 /// Tensor methods: iterators ///
 /////////////////////////////////
@@ -1190,9 +1205,19 @@ Tensor<T, C> Tensor<T, C>::UniformRandomIntegers(SizeType const &N, int64_t cons
 template <typename T, typename C>
 Tensor<T, C> &Tensor<T, C>::FillUniformRandom()
 {
-  for (SizeType i = 0; i < this->size(); ++i)
+  // generate the values in batches rather than one call per element
+  constexpr SizeType BATCH_SIZE = 256;
+  double             values[BATCH_SIZE];
+
+  for (SizeType i = 0; i < this->size(); i += BATCH_SIZE)
   {
-    this->data()[i] = Type(random::Random::generator.AsDouble());
+    SizeType const count = std::min(BATCH_SIZE, this->size() - i);
+    random::Random::generator.FillUniform(values, count);
+
+    for (SizeType j = 0; j < count; ++j)
+    {
+      this->data()[i + j] = Type(values[j]);
+    }
   }
   return *this;
 }
@@ -1507,9 +1532,7 @@ typename Tensor<T, C>::SelfType Tensor<T, C>::InlineAdd(Tensor const &other)
   }
   else
   {
-    SelfType self_copy  = this->Copy();
-    SelfType other_copy = other.Copy();
-    if (!(Broadcast([](T x, T y) { return x + y; }, self_copy, other_copy, *this)))
+    if (!(Broadcast([](T x, T y) { return x + y; }, *this, other, *this)))
     {
       throw std::runtime_error("arrays not broadcastable for InlineAdd!");
     }
@@ -1543,9 +1566,7 @@ typename Tensor<T, C>::SelfType Tensor<T, C>::InlineSubtract(Tensor const &other
   }
   else
   {
-    SelfType self_copy  = this->Copy();
-    SelfType other_copy = other.Copy();
-    if (!(Broadcast([](T x, T y) { return x - y; }, self_copy, other_copy, *this)))
+    if (!(Broadcast([](T x, T y) { return x - y; }, *this, other, *this)))
     {
       throw std::runtime_error("arrays not broadcastable for InlineSubtract!");
     }
@@ -1579,9 +1600,7 @@ typename Tensor<T, C>::SelfType Tensor<T, C>::InlineReverseSubtract(Tensor const
   }
   else
   {
-    SelfType self_copy  = this->Copy();
-    SelfType other_copy = other.Copy();
-    if (!(Broadcast([](T x, T y) { return x - y; }, other_copy, self_copy, *this)))
+    if (!(Broadcast([](T x, T y) { return x - y; }, other, *this, *this)))
     {
       throw std::runtime_error("arrays not broadcastable for InlineReverseSubtract!");
     }
@@ -1617,9 +1636,7 @@ typename Tensor<T, C>::SelfType Tensor<T, C>::InlineMultiply(Tensor const &other
   }
   else
   {
-    SelfType self_copy  = this->Copy();
-    SelfType other_copy = other.Copy();
-    if (!(Broadcast([](T x, T y) { return x * y; }, other_copy, self_copy, *this)))
+    if (!(Broadcast([](T x, T y) { return x * y; }, other, *this, *this)))
     {
       throw std::runtime_error("arrays not broadcastable for InlineMultiply!");
     }
@@ -1653,9 +1670,7 @@ typename Tensor<T, C>::SelfType Tensor<T, C>::InlineDivide(Tensor const &other)
   }
   else
   {
-    SelfType self_copy  = this->Copy();
-    SelfType other_copy = other.Copy();
-    if (!(Broadcast([](T x, T y) { return x / y; }, self_copy, other_copy, *this)))
+    if (!(Broadcast([](T x, T y) { return x / y; }, *this, other, *this)))
     {
       throw std::runtime_error("arrays not broadcastable for InlineDivide!");
     }
@@ -1689,9 +1704,7 @@ typename Tensor<T, C>::SelfType Tensor<T, C>::InlineReverseDivide(Tensor const &
   }
   else
   {
-    SelfType self_copy  = this->Copy();
-    SelfType other_copy = other.Copy();
-    if (!(Broadcast([](T x, T y) { return x / y; }, other_copy, self_copy, *this)))
+    if (!(Broadcast([](T x, T y) { return x / y; }, other, *this, *this)))
     {
       throw std::runtime_error("arrays not broadcastable for InlineReverseDivide!");
     }
@@ -1824,12 +1837,7 @@ typename Tensor<T, C>::SelfType &Tensor<T, C>::TransposeDot(SelfType const &A, S
 template <typename T, typename C>
 typename Tensor<T, C>::Type Tensor<T, C>::Sum() const
 {
-  Type ret{0};
-  for (auto const &v : *this)
-  {
-    ret += v;
-  }
-  return ret;
+  return fetch::math::details_vectorisation::ParallelSum(*this);
 }
 
 /**
@@ -19,7 +19,6 @@
 
 #include "math/tensor_iterator.hpp"
 #include <assert.h>
-#include <iostream>
 
 #include "math/base_types.hpp"
 
@@ -126,54 +125,181 @@ inline bool UpgradeIteratorFromBroadcast(SizeVector const &a, TensorIterator<T,
   return true;
 }
 
-template <typename F, typename T, typename C>
-inline bool Broadcast(F function, Tensor<T, C> &a, Tensor<T, C> &b, Tensor<T, C> &c)
+/**
+ * A read only view of a tensor broadcast to a larger shape, which does not copy the tensor.
+ * Dimensions along which the tensor is broadcast (including the leading ones it does not have)
+ * have a stride of 0, so that every position of the broadcast shape maps onto one of its elements.
+ */
+template <typename T>
+class TensorBroadcastView
 {
-  SizeVector cshape;
+public:
+  /**
+   * @param tensor The tensor to be viewed, which must outlive the view
+   * @param shape The shape to broadcast to, as computed by ShapeFromBroadcast
+   */
+  template <typename C>
+  TensorBroadcastView(Tensor<T, C> const &tensor, SizeVector const &shape)
+    : data_(tensor.data().pointer())
+    , shape_(shape)
+    , stride_(shape.size(), 0)
+  {
+    SizeVector const &own_shape = tensor.shape();
+    assert(own_shape.size() <= shape_.size());
 
-  ShapeFromBroadcast(a.shape(), b.shape(), cshape);
-  c.ResizeFromShape(cshape);
+    // the trailing dimensions are aligned, as in ShapeFromBroadcast
+    SizeType const offset = shape_.size() - own_shape.size();
+    SizeType       volume = 1;
+    for (SizeType i = 0; i < own_shape.size(); ++i)
+    {
+      assert((own_shape[i] == shape_[offset + i]) || (own_shape[i] == 1));
 
-  std::vector<SizeVector> rangeA, rangeB, rangeC;
-  for (auto &i : a.shape())
+      if (own_shape[i] != 1)
+      {
+        stride_[offset + i] = volume;
+      }
+      volume *= own_shape[i];
+    }
+  }
+
+  T const *data() const
   {
-    rangeA.push_back({0, i});
+    return data_;
   }
 
-  for (auto &i : b.shape())
+  SizeVector const &shape() const
   {
-    rangeB.push_back({0, i});
+    return shape_;
   }
 
-  for (auto &i : c.shape())
+  SizeVector const &stride() const
   {
-    rangeC.push_back({0, i});
+    return stride_;
   }
 
-  TensorIterator<T, C> it_a(a, rangeA);
-  TensorIterator<T, C> it_b(b, rangeB);
-  TensorIterator<T, C> it_c(c, rangeC);
+private:
+  T const *  data_;
+  SizeVector shape_;
+  SizeVector stride_;  ///< The strides in elements, 0 along the broadcast dimensions
+};
+
+/**
+ * Apply an element-wise function to two views of the same broadcast shape, writing the results
+ * contiguously (column major) to ret. The output may alias an input only if that input is not
+ * broadcast along any dimension.
+ *
+ * @param function The function applied to each pair of elements
+ * @param a The view of the first operand
+ * @param b The view of the second operand
+ * @param ret Points to the output, with room for every element of the broadcast shape
+ */
+template <typename F, typename T>
+void ApplyBroadcast(F &&function, TensorBroadcastView<T> const &a, TensorBroadcastView<T> const &b,
+                    T *ret)
+{
+  SizeVector const &shape = a.shape();
+  assert(shape == b.shape());
 
-  if (!UpgradeIteratorFromBroadcast(cshape, it_a))
+  SizeType const rank = shape.size();
+  SizeType       size = 1;
+  for (auto const &dimension : shape)
   {
-    std::cout << "Could not promote iterator A" << std::endl;
-    return false;
+    size *= dimension;
   }
-  if (!UpgradeIteratorFromBroadcast(cshape, it_b))
+
+  if ((rank == 0) || (size == 0))
   {
-    std::cout << "Could not promote iterator B" << std::endl;
-    return false;
+    return;
+  }
+
+  // the innermost dimension is walked directly, the others with a counter
+  SizeType const inner  = shape[0];
+  SizeType const step_a = a.stride()[0];
+  SizeType const step_b = b.stride()[0];
+
+  SizeVector index(rank, 0);
+  SizeType   offset_a = 0;
+  SizeType   offset_b = 0;
+
+  for (SizeType n = 0; n < size; n += inner)
+  {
+    T const *x = a.data() + offset_a;
+    T const *y = b.data() + offset_b;
+    for (SizeType i = 0; i < inner; ++i)
+    {
+      ret[i] = function(x[i * step_a], y[i * step_b]);
+    }
+    ret += inner;
+
+    for (SizeType d = 1; d < rank; ++d)
+    {
+      offset_a += a.stride()[d];
+      offset_b += b.stride()[d];
+      if (++index[d] < shape[d])
+      {
+        break;
+      }
+
+      offset_a -= shape[d] * a.stride()[d];
+      offset_b -= shape[d] * b.stride()[d];
+      index[d] = 0;
+    }
   }
+}
+
+namespace details {
+
+/**
+ * The input to read when writing to c, which is the input itself unless c overlaps it and the
+ * output would be written ahead of the elements still to be read
+ */
+template <typename T, typename C>
+Tensor<T, C> BroadcastInput(Tensor<T, C> const &input, Tensor<T, C> const &c,
+                            SizeVector const &cshape)
+{
+  T const *pi = input.data().pointer();
+  T const *pc = c.data().pointer();
+
+  bool const overlaps = (pi < pc + c.size()) && (pc < pi + input.size());
+  bool const in_place = (pi == pc) && (input.shape() == cshape) && (c.shape() == cshape);
 
-  while (it_c)
+  return (overlaps && !in_place) ? input.Copy() : input;
+}
+
+}  // namespace details
+
+/**
+ * Apply an element-wise function to two tensors broadcast against each other. The smaller operand
+ * is read through a stride-0 view rather than being expanded, and c may be one of the inputs: an
+ * input is only copied when c aliases it and it is broadcast or c has to be resized.
+ *
+ * @param function The function applied to each pair of elements
+ * @param a The first operand
+ * @param b The second operand
+ * @param c The output, resized to the broadcast shape
+ * @return false if the shapes can not be broadcast against each other
+ */
+template <typename F, typename T, typename C>
+inline bool Broadcast(F function, Tensor<T, C> const &a, Tensor<T, C> const &b, Tensor<T, C> &c)
+{
+  SizeVector cshape;
+  if (!ShapeFromBroadcast(a.shape(), b.shape(), cshape))
   {
-    (*it_c) = function(*it_a, *it_b);
+    return false;
+  }
+
+  // keep hold of the inputs, since c may be one of them
+  Tensor<T, C> input_a = details::BroadcastInput(a, c, cshape);
+  Tensor<T, C> input_b = details::BroadcastInput(b, c, cshape);
 
-    ++it_a;
-    ++it_b;
-    ++it_c;
+  if (c.shape() != cshape)
+  {
+    c.ResizeFromShape(cshape);
   }
 
+  ApplyBroadcast(function, TensorBroadcastView<T>(input_a, cshape),
+                 TensorBroadcastView<T>(input_b, cshape), c.data().pointer());
+
   return true;
 }
 
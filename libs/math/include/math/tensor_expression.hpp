@@ -0,0 +1,295 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "math/base_types.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace fetch {
+namespace math {
+
+/**
+ * Lazily evaluated element wise expressions over tensors.
+ *
+ * The arithmetic operators of Tensor work in place, so a chain like a * b + c either overwrites
+ * its operands or needs a copy and a full pass over memory for every operation. Wrapping the
+ * operands with Lazy() builds an expression instead, which Evaluate() computes in a single pass
+ * over the contiguous storage of the tensors with no temporaries:
+ *
+ *   Evaluate(Lazy(a) * Lazy(b) + Lazy(c), ret);
+ *   Evaluate(Lazy(weights) + Lazy(gradients) * (-learning_rate), weights);
+ *
+ * The tensors which take part must outlive the expression. Operands must have the same shape (or
+ * be scalars); there is no broadcasting in lazy expressions.
+ */
+namespace expression {
+
+/**
+ * Base of all expressions. The derived class provides the element type (Type), the tensor type of
+ * the result (ArrayType), the shape of the result (Shape(), nullptr for a scalar) and element
+ * access (operator[]).
+ */
+template <typename Derived>
+struct Expression
+{
+  Derived const &self() const
+  {
+    return static_cast<Derived const &>(*this);
+  }
+};
+
+template <typename A>
+class TensorTerminal : public Expression<TensorTerminal<A>>
+{
+public:
+  using ArrayType = A;
+  using Type      = typename A::Type;
+
+  explicit TensorTerminal(ArrayType const &array)
+    : data_(array.data().pointer())
+    , shape_(&array.shape())
+  {}
+
+  SizeVector const *Shape() const
+  {
+    return shape_;
+  }
+
+  Type operator[](SizeType i) const
+  {
+    return data_[i];
+  }
+
+private:
+  Type const *      data_;
+  SizeVector const *shape_;
+};
+
+template <typename A>
+class ScalarTerminal : public Expression<ScalarTerminal<A>>
+{
+public:
+  using ArrayType = A;
+  using Type      = typename A::Type;
+
+  explicit ScalarTerminal(Type const &value)
+    : value_(value)
+  {}
+
+  SizeVector const *Shape() const
+  {
+    return nullptr;
+  }
+
+  Type operator[](SizeType /*i*/) const
+  {
+    return value_;
+  }
+
+private:
+  Type value_;
+};
+
+template <typename Op, typename L, typename R>
+class BinaryExpression : public Expression<BinaryExpression<Op, L, R>>
+{
+public:
+  using ArrayType = typename L::ArrayType;
+  using Type      = typename L::Type;
+
+  BinaryExpression(L left, R right)
+    : left_(std::move(left))
+    , right_(std::move(right))
+  {
+    if (left_.Shape() && right_.Shape() && (*left_.Shape() != *right_.Shape()))
+    {
+      throw std::runtime_error("operands of a lazy expression must have the same shape");
+    }
+  }
+
+  SizeVector const *Shape() const
+  {
+    return left_.Shape() ? left_.Shape() : right_.Shape();
+  }
+
+  Type operator[](SizeType i) const
+  {
+    return Op::Apply(left_[i], right_[i]);
+  }
+
+private:
+  L left_;
+  R right_;
+};
+
+template <typename F, typename E>
+class MapExpression : public Expression<MapExpression<F, E>>
+{
+public:
+  using ArrayType = typename E::ArrayType;
+  using Type      = typename E::Type;
+
+  MapExpression(E expression, F function)
+    : expression_(std::move(expression))
+    , function_(std::move(function))
+  {}
+
+  SizeVector const *Shape() const
+  {
+    return expression_.Shape();
+  }
+
+  Type operator[](SizeType i) const
+  {
+    return function_(expression_[i]);
+  }
+
+private:
+  E expression_;
+  F function_;
+};
+
+struct Plus
+{
+  template <typename T>
+  static T Apply(T const &x, T const &y)
+  {
+    return x + y;
+  }
+};
+
+struct Minus
+{
+  template <typename T>
+  static T Apply(T const &x, T const &y)
+  {
+    return x - y;
+  }
+};
+
+struct Times
+{
+  template <typename T>
+  static T Apply(T const &x, T const &y)
+  {
+    return x * y;
+  }
+};
+
+struct Divides
+{
+  template <typename T>
+  static T Apply(T const &x, T const &y)
+  {
+    return x / y;
+  }
+};
+
+#define FETCH_LAZY_BINARY_OPERATOR(OPERATOR, OP)                                    \
+  template <typename L, typename R>                                                 \
+  BinaryExpression<OP, L, R> operator OPERATOR(Expression<L> const &left,           \
+                                               Expression<R> const &right)          \
+  {                                                                                 \
+    return {left.self(), right.self()};                                             \
+  }                                                                                 \
+                                                                                    \
+  template <typename L>                                                             \
+  BinaryExpression<OP, L, ScalarTerminal<typename L::ArrayType>> operator OPERATOR( \
+      Expression<L> const &left, typename L::Type const &right)                     \
+  {                                                                                 \
+    return {left.self(), ScalarTerminal<typename L::ArrayType>(right)};             \
+  }                                                                                 \
+                                                                                    \
+  template <typename R>                                                             \
+  BinaryExpression<OP, ScalarTerminal<typename R::ArrayType>, R> operator OPERATOR( \
+      typename R::Type const &left, Expression<R> const &right)                     \
+  {                                                                                 \
+    return {ScalarTerminal<typename R::ArrayType>(left), right.self()};             \
+  }
+
+FETCH_LAZY_BINARY_OPERATOR(+, Plus)
+FETCH_LAZY_BINARY_OPERATOR(-, Minus)
+FETCH_LAZY_BINARY_OPERATOR(*, Times)
+FETCH_LAZY_BINARY_OPERATOR(/, Divides)
+
+#undef FETCH_LAZY_BINARY_OPERATOR
+
+}  // namespace expression
+
+/**
+ * Wrap a tensor as the operand of a lazy expression
+ */
+template <typename ArrayType>
+expression::TensorTerminal<ArrayType> Lazy(ArrayType const &array)
+{
+  return expression::TensorTerminal<ArrayType>(array);
+}
+
+/**
+ * Apply a function to every element of an expression, for example an activation
+ */
+template <typename E, typename F>
+expression::MapExpression<F, E> Map(expression::Expression<E> const &expression, F function)
+{
+  return {expression.self(), std::move(function)};
+}
+
+/**
+ * Compute an expression into ret in a single pass. Every element is read before it is written, so
+ * ret may be one of the operands of the expression.
+ */
+template <typename E>
+void Evaluate(expression::Expression<E> const &expression, typename E::ArrayType &ret)
+{
+  E const &e = expression.self();
+  if (!e.Shape() || (*e.Shape() != ret.shape()))
+  {
+    throw std::runtime_error("the output of a lazy expression must have the shape of its operands");
+  }
+
+  using Type = typename E::Type;
+
+  Type *const    output = ret.data().pointer();
+  SizeType const size   = ret.size();
+  for (SizeType i = 0; i < size; ++i)
+  {
+    output[i] = e[i];
+  }
+}
+
+/**
+ * Compute an expression into a newly allocated tensor
+ */
+template <typename E>
+typename E::ArrayType Evaluate(expression::Expression<E> const &expression)
+{
+  E const &e = expression.self();
+  if (!e.Shape())
+  {
+    throw std::runtime_error("a lazy expression needs at least one tensor operand");
+  }
+
+  typename E::ArrayType ret(*e.Shape());
+  Evaluate(expression, ret);
+  return ret;
+}
+
+}  // namespace math
+}  // namespace fetch
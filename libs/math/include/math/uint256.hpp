@@ -0,0 +1,261 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "math/bignumber.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace fetch {
+namespace math {
+
+/**
+ * Fixed width 256-bit unsigned integer stored as four 64-bit limbs (least significant first).
+ *
+ * A fast companion to BigUnsigned for the values which are known to fit in 256 bits, for example
+ * the targets and digests of the proof of work. Like BigUnsigned, the conversions to and from bytes
+ * assume a little endian host. Arithmetic wraps around on overflow.
+ */
+class UInt256
+{
+public:
+  using Limbs = std::array<uint64_t, 4>;
+
+  static constexpr std::size_t SIZE_IN_BYTES = 32;
+
+  // Construction / Destruction
+  UInt256() = default;
+  explicit UInt256(uint64_t value);
+  UInt256(UInt256 const &) = default;
+  ~UInt256()               = default;
+
+  /// @name Conversions
+  /// @{
+  static UInt256 FromBytes(uint8_t const *data, std::size_t size);
+  static UInt256 FromBytes(byte_array::ConstByteArray const &value);
+  static bool    Fits(BigUnsigned const &value);
+  BigUnsigned    ToBigUnsigned() const;
+  /// @}
+
+  Limbs const &limbs() const;
+  std::size_t  TrimmedSize() const;
+
+  // Operators
+  UInt256 &operator=(UInt256 const &) = default;
+  UInt256 &operator++();
+  UInt256 &operator+=(UInt256 const &other);
+  UInt256 &operator<<=(std::size_t bits);
+
+  bool operator==(UInt256 const &other) const;
+  bool operator!=(UInt256 const &other) const;
+  bool operator<(UInt256 const &other) const;
+  bool operator>(UInt256 const &other) const;
+  bool operator<=(UInt256 const &other) const;
+  bool operator>=(UInt256 const &other) const;
+
+private:
+  static constexpr std::size_t NUM_LIMBS  = 4;
+  static constexpr std::size_t LIMB_BITS  = 64;
+  static constexpr std::size_t LIMB_BYTES = sizeof(uint64_t);
+
+  Limbs limbs_{};
+};
+
+inline UInt256::UInt256(uint64_t value)
+  : limbs_{{value, 0, 0, 0}}
+{}
+
+/**
+ * Create a value from little endian bytes. Any bytes beyond the first 32 are ignored.
+ *
+ * @param data The pointer to the bytes
+ * @param size The number of bytes
+ * @return The created value
+ */
+inline UInt256 UInt256::FromBytes(uint8_t const *data, std::size_t size)
+{
+  std::size_t const num_bytes = (size < SIZE_IN_BYTES) ? size : std::size_t{SIZE_IN_BYTES};
+
+  UInt256 value{};
+  std::memcpy(value.limbs_.data(), data, num_bytes);
+  return value;
+}
+
+/**
+ * Create a value from a little endian byte array (for example a BigUnsigned or a digest). Any
+ * bytes beyond the first 32 are ignored, use Fits() to check that none of them are set.
+ *
+ * @param value The input bytes
+ * @return The created value
+ */
+inline UInt256 UInt256::FromBytes(byte_array::ConstByteArray const &value)
+{
+  return FromBytes(value.pointer(), value.size());
+}
+
+/**
+ * Determine if a big number can be represented without loss
+ *
+ * @param value The big number to check
+ * @return true if it fits in 256 bits, otherwise false
+ */
+inline bool UInt256::Fits(BigUnsigned const &value)
+{
+  return value.TrimmedSize() <= std::size_t{SIZE_IN_BYTES};
+}
+
+/**
+ * Convert the value into an (256-bit) big number
+ *
+ * @return The converted value
+ */
+inline BigUnsigned UInt256::ToBigUnsigned() const
+{
+  std::size_t const num_bytes = SIZE_IN_BYTES;
+
+  byte_array::ByteArray bytes;
+  bytes.Resize(num_bytes);
+  std::memcpy(bytes.pointer(), limbs_.data(), num_bytes);
+
+  return BigUnsigned{bytes};
+}
+
+inline UInt256::Limbs const &UInt256::limbs() const
+{
+  return limbs_;
+}
+
+/**
+ * Get the number of bytes needed to represent the value, as for BigUnsigned
+ *
+ * @return The number of significant bytes
+ */
+inline std::size_t UInt256::TrimmedSize() const
+{
+  for (std::size_t i = NUM_LIMBS; i > 0; --i)
+  {
+    uint64_t const limb = limbs_[i - 1];
+
+    if (limb != 0)
+    {
+      auto const leading_zero_bytes = static_cast<std::size_t>(__builtin_clzll(limb)) / 8;
+      return (i * LIMB_BYTES) - leading_zero_bytes;
+    }
+  }
+
+  return 0;
+}
+
+inline UInt256 &UInt256::operator++()
+{
+  for (auto &limb : limbs_)
+  {
+    if (++limb != 0)
+    {
+      break;
+    }
+  }
+
+  return *this;
+}
+
+inline UInt256 &UInt256::operator+=(UInt256 const &other)
+{
+  unsigned __int128 carry{0};
+
+  for (std::size_t i = 0; i < NUM_LIMBS; ++i)
+  {
+    carry += static_cast<unsigned __int128>(limbs_[i]) + other.limbs_[i];
+
+    limbs_[i] = static_cast<uint64_t>(carry);
+    carry >>= LIMB_BITS;
+  }
+
+  return *this;
+}
+
+inline UInt256 &UInt256::operator<<=(std::size_t bits)
+{
+  std::size_t const limb_shift = bits / LIMB_BITS;
+  std::size_t const bit_shift  = bits % LIMB_BITS;
+
+  for (std::size_t i = NUM_LIMBS; i > 0; --i)
+  {
+    std::size_t const index = i - 1;
+
+    uint64_t value{0};
+    if (index >= limb_shift)
+    {
+      std::size_t const source = index - limb_shift;
+
+      value = limbs_[source] << bit_shift;
+      if ((bit_shift != 0) && (source > 0))
+      {
+        value |= limbs_[source - 1] >> (LIMB_BITS - bit_shift);
+      }
+    }
+
+    limbs_[index] = value;
+  }
+
+  return *this;
+}
+
+inline bool UInt256::operator==(UInt256 const &other) const
+{
+  return limbs_ == other.limbs_;
+}
+
+inline bool UInt256::operator!=(UInt256 const &other) const
+{
+  return !(*this == other);
+}
+
+inline bool UInt256::operator<(UInt256 const &other) const
+{
+  for (std::size_t i = NUM_LIMBS; i > 0; --i)
+  {
+    if (limbs_[i - 1] != other.limbs_[i - 1])
+    {
+      return limbs_[i - 1] < other.limbs_[i - 1];
+    }
+  }
+
+  return false;
+}
+
+inline bool UInt256::operator>(UInt256 const &other) const
+{
+  return other < *this;
+}
+
+inline bool UInt256::operator<=(UInt256 const &other) const
+{
+  return !(other < *this);
+}
+
+inline bool UInt256::operator>=(UInt256 const &other) const
+{
+  return !(*this < other);
+}
+
+}  // namespace math
+}  // namespace fetch
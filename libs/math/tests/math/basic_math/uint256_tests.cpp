@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "math/bignumber.hpp"
+#include "math/uint256.hpp"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <random>
+
+namespace {
+
+using fetch::math::BigUnsigned;
+using fetch::math::UInt256;
+
+TEST(UInt256Tests, CheckConversionToAndFromBigUnsigned)
+{
+  BigUnsigned value{0};
+  value = 0xdeadbeefu;
+  value <<= 200;
+
+  ASSERT_TRUE(UInt256::Fits(value));
+
+  auto const converted = UInt256::FromBytes(value);
+  EXPECT_EQ(value, converted.ToBigUnsigned());
+  EXPECT_EQ(value.TrimmedSize(), converted.TrimmedSize());
+}
+
+TEST(UInt256Tests, CheckLargerValuesDoNotFit)
+{
+  BigUnsigned value{1, 512};
+  value <<= 300;
+
+  EXPECT_FALSE(UInt256::Fits(value));
+}
+
+TEST(UInt256Tests, CheckShiftMatchesBigUnsigned)
+{
+  for (std::size_t shift = 0; shift < 256; shift += 7)
+  {
+    BigUnsigned expected{0};
+    expected = 0x1234567u;
+    expected <<= shift;
+
+    UInt256 actual{0x1234567u};
+    actual <<= shift;
+
+    EXPECT_EQ(expected, actual.ToBigUnsigned()) << "shift: " << shift;
+  }
+}
+
+TEST(UInt256Tests, CheckIncrementCarries)
+{
+  UInt256 value{~uint64_t{0}};
+  ++value;
+
+  EXPECT_EQ(0u, value.limbs()[0]);
+  EXPECT_EQ(1u, value.limbs()[1]);
+
+  UInt256 sum{~uint64_t{0}};
+  sum += UInt256{~uint64_t{0}};
+
+  EXPECT_EQ(~uint64_t{0} - 1u, sum.limbs()[0]);
+  EXPECT_EQ(1u, sum.limbs()[1]);
+}
+
+TEST(UInt256Tests, CheckComparisonMatchesBigUnsigned)
+{
+  std::mt19937_64 rng{42};
+
+  for (std::size_t i = 0; i < 1000; ++i)
+  {
+    BigUnsigned a{rng()}, b{rng()};
+    a <<= static_cast<std::size_t>(rng() % 192);
+    b <<= static_cast<std::size_t>(rng() % 192);
+
+    auto const fast_a = UInt256::FromBytes(a);
+    auto const fast_b = UInt256::FromBytes(b);
+
+    EXPECT_EQ(a < b, fast_a < fast_b);
+    EXPECT_EQ(a > b, fast_a > fast_b);
+    EXPECT_FALSE(fast_a < fast_a);
+    EXPECT_TRUE(fast_a <= fast_a);
+  }
+}
+
+}  // namespace
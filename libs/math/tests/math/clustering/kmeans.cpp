@@ -26,6 +26,7 @@
 #include <chrono>
 #include <cmath>
 #include <math/tensor.hpp>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -291,3 +292,64 @@ TEST(clustering_test, kmeans_remap_previous_assignment_no_K)
     ASSERT_EQ(group_3, static_cast<int>(clusters[j]));
   }
 }
+
+namespace {
+
+constexpr SizeType N_BLOBS         = 8;
+constexpr SizeType POINTS_PER_BLOB = 100;
+
+/// Well separated blobs of points in 3 dimensions, blob after blob
+ArrayType MakeBlobs()
+{
+  ArrayType A({N_BLOBS * POINTS_PER_BLOB, 3});
+  for (SizeType blob = 0; blob < N_BLOBS; ++blob)
+  {
+    for (SizeType i = 0; i < POINTS_PER_BLOB; ++i)
+    {
+      SizeType const point = (blob * POINTS_PER_BLOB) + i;
+      for (SizeType j = 0; j < 3; ++j)
+      {
+        DataType const centre = ((blob >> j) & 1) ? 1000 : -1000;
+        DataType const offset = static_cast<DataType>((i * (j + 3) * 7) % 41) - 20;
+        A.Set(point, j, centre + offset);
+      }
+    }
+  }
+  return A;
+}
+
+void ExpectOneClusterPerBlob(ClusteringType const &clusters)
+{
+  std::set<SizeType> labels;
+  for (SizeType blob = 0; blob < N_BLOBS; ++blob)
+  {
+    SizeType const label = static_cast<SizeType>(clusters[blob * POINTS_PER_BLOB]);
+    for (SizeType i = 0; i < POINTS_PER_BLOB; ++i)
+    {
+      ASSERT_EQ(label, static_cast<SizeType>(clusters[(blob * POINTS_PER_BLOB) + i]));
+    }
+    labels.insert(label);
+  }
+  EXPECT_EQ(labels.size(), N_BLOBS);
+}
+
+}  // namespace
+
+TEST(clustering_test, kmeans_test_3d_8k)
+{
+  ArrayType      A           = MakeBlobs();
+  SizeType       random_seed = 123456;
+  ClusteringType clusters    = fetch::math::clustering::KMeans(A, random_seed, N_BLOBS);
+
+  ExpectOneClusterPerBlob(clusters);
+}
+
+TEST(clustering_test, kmeans_mini_batch_test_3d_8k)
+{
+  ArrayType      A           = MakeBlobs();
+  SizeType       random_seed = 123456;
+  ClusteringType clusters =
+      fetch::math::clustering::KMeansMiniBatch(A, random_seed, N_BLOBS, SizeType{64}, SizeType{50});
+
+  ExpectOneClusterPerBlob(clusters);
+}
@@ -131,3 +131,79 @@ TYPED_TEST(ClusteringTest, knn_cosine_test)
   EXPECT_EQ(output.at(3).first, SizeType(3));
   EXPECT_NEAR(double(output.at(3).second), double(1.99784), 1e-4);
 }
+
+TYPED_TEST(ClusteringTest, knn_returns_the_nearest_when_k_is_less_than_the_data_size)
+{
+  using DataType  = typename TypeParam::Type;
+  using ArrayType = TypeParam;
+  using SizeType  = typename TypeParam::SizeType;
+
+  ArrayType A = ArrayType({6, 1});
+  for (SizeType i{0}; i < 6; ++i)
+  {
+    A.Set(i, SizeType{0}, DataType(i * 10));
+  }
+
+  ArrayType v = ArrayType({1, 1});
+  v.Set(SizeType{0}, SizeType{0}, DataType(21));
+
+  std::vector<std::pair<typename ArrayType::SizeType, typename ArrayType::Type>> output =
+      fetch::math::clustering::KNN<ArrayType, fetch::math::distance::Euclidean>(A, v, 2);
+
+  ASSERT_EQ(output.size(), 2);
+  EXPECT_EQ(output.at(0).first, SizeType(2));
+  EXPECT_NEAR(double(output.at(0).second), double(1), 1e-4);
+  EXPECT_EQ(output.at(1).first, SizeType(3));
+  EXPECT_NEAR(double(output.at(1).second), double(9), 1e-4);
+}
+
+TYPED_TEST(ClusteringTest, batch_knn_matches_knn)
+{
+  using DataType  = typename TypeParam::Type;
+  using ArrayType = TypeParam;
+  using SizeType  = typename TypeParam::SizeType;
+
+  SizeType const num_data    = 40;
+  SizeType const num_queries = 7;
+  SizeType const features    = 5;
+  SizeType const k           = 3;
+
+  ArrayType data({num_data, features});
+  ArrayType queries({num_queries, features});
+  for (SizeType i{0}; i < num_data; ++i)
+  {
+    for (SizeType j{0}; j < features; ++j)
+    {
+      data.Set(i, j, DataType(double((i * 7 + j * 3) % 11) - 5.0));
+    }
+  }
+  for (SizeType i{0}; i < num_queries; ++i)
+  {
+    for (SizeType j{0}; j < features; ++j)
+    {
+      queries.Set(i, j, DataType(double((i * 5 + j * 2) % 9) - 4.5));
+    }
+  }
+
+  auto const euclidean = fetch::math::clustering::BatchKNNEuclidean(data, queries, k);
+  auto const cosine    = fetch::math::clustering::BatchKNNCosine(data, queries, k);
+  ASSERT_EQ(euclidean.size(), num_queries);
+  ASSERT_EQ(cosine.size(), num_queries);
+
+  for (SizeType q{0}; q < num_queries; ++q)
+  {
+    ArrayType query = queries.Slice(q).Copy();
+
+    auto const expected_euclidean =
+        fetch::math::clustering::KNN<ArrayType, fetch::math::distance::Euclidean>(data, query, k);
+    auto const expected_cosine = fetch::math::clustering::KNNCosine(data, query, k);
+
+    ASSERT_EQ(euclidean[q].size(), k);
+    ASSERT_EQ(cosine[q].size(), k);
+    for (SizeType i{0}; i < k; ++i)
+    {
+      EXPECT_NEAR(double(euclidean[q][i].second), double(expected_euclidean[i].second), 1e-3);
+      EXPECT_NEAR(double(cosine[q][i].second), double(expected_cosine[i].second), 1e-3);
+    }
+  }
+}
@@ -0,0 +1,114 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "math/distance/cosine.hpp"
+#include "math/distance/euclidean.hpp"
+#include "math/distance/pairwise_distance.hpp"
+#include "math/tensor.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace fetch::math::distance;
+using namespace fetch::math;
+
+template <typename T>
+class PairwiseDistanceTest : public ::testing::Test
+{
+};
+
+using MyTypes = ::testing::Types<fetch::math::Tensor<float>, fetch::math::Tensor<double>,
+                                 fetch::math::Tensor<fetch::fixed_point::FixedPoint<32, 32>>>;
+
+TYPED_TEST_CASE(PairwiseDistanceTest, MyTypes);
+
+template <typename ArrayType>
+ArrayType MakeRows(typename ArrayType::SizeType rows, typename ArrayType::SizeType columns,
+                   typename ArrayType::SizeType seed)
+{
+  using DataType = typename ArrayType::Type;
+  using SizeType = typename ArrayType::SizeType;
+
+  ArrayType ret({rows, columns});
+  for (SizeType i{0}; i < rows; ++i)
+  {
+    for (SizeType j{0}; j < columns; ++j)
+    {
+      ret.Set(i, j, DataType(double((i * seed + j * 3 + 1) % 7) - 3.0));
+    }
+  }
+  return ret;
+}
+
+TYPED_TEST(PairwiseDistanceTest, euclidean_matches_row_by_row_distance)
+{
+  using ArrayType = TypeParam;
+  using SizeType  = typename TypeParam::SizeType;
+
+  ArrayType a = MakeRows<ArrayType>(5, 4, 2);
+  ArrayType b = MakeRows<ArrayType>(3, 4, 5);
+
+  ArrayType ret = PairwiseEuclidean(a, b);
+  ASSERT_EQ(ret.shape(), std::vector<SizeType>({5, 3}));
+
+  for (SizeType i{0}; i < 5; ++i)
+  {
+    for (SizeType j{0}; j < 3; ++j)
+    {
+      double expected = double(Euclidean(a.Slice(i).Copy(), b.Slice(j).Copy()));
+      EXPECT_NEAR(double(ret.At(i, j)), expected, 1e-3);
+    }
+  }
+}
+
+TYPED_TEST(PairwiseDistanceTest, square_euclidean_of_identical_rows_is_zero)
+{
+  using DataType  = typename TypeParam::Type;
+  using ArrayType = TypeParam;
+  using SizeType  = typename TypeParam::SizeType;
+
+  ArrayType a = MakeRows<ArrayType>(4, 3, 3);
+  ArrayType ret({4, 4});
+  PairwiseSquareEuclidean(a, a, ret);
+
+  for (SizeType i{0}; i < 4; ++i)
+  {
+    EXPECT_GE(ret.At(i, i), DataType(0));
+    EXPECT_NEAR(double(ret.At(i, i)), 0.0, 1e-3);
+  }
+}
+
+TYPED_TEST(PairwiseDistanceTest, cosine_matches_row_by_row_distance)
+{
+  using ArrayType = TypeParam;
+  using SizeType  = typename TypeParam::SizeType;
+
+  ArrayType a = MakeRows<ArrayType>(4, 6, 2);
+  ArrayType b = MakeRows<ArrayType>(5, 6, 4);
+
+  ArrayType ret = PairwiseCosine(a, b);
+  ASSERT_EQ(ret.shape(), std::vector<SizeType>({4, 5}));
+
+  for (SizeType i{0}; i < 4; ++i)
+  {
+    for (SizeType j{0}; j < 5; ++j)
+    {
+      double expected = double(Cosine(a.Slice(i).Copy(), b.Slice(j).Copy()));
+      EXPECT_NEAR(double(ret.At(i, j)), expected, 1e-3);
+    }
+  }
+}
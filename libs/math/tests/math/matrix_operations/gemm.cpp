@@ -0,0 +1,162 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/fixed_point/fixed_point.hpp"
+#include "math/matrix_operations.hpp"
+#include "math/tensor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <tuple>
+#include <vector>
+
+using fetch::math::SizeType;
+
+template <typename T>
+class GemmTest : public ::testing::Test
+{
+protected:
+  using Type = typename T::Type;
+
+  // small integers, so that every sum of products is exact whatever the order of summation
+  static T Generate(SizeType rows, SizeType columns, SizeType seed)
+  {
+    T array{{rows, columns}};
+    for (SizeType i = 0; i < rows; ++i)
+    {
+      for (SizeType j = 0; j < columns; ++j)
+      {
+        array.Set(i, j, Type(static_cast<int>(((i * 7) + (j * 3) + seed) % 11) - 5));
+      }
+    }
+    return array;
+  }
+
+  static Type Reference(T const &a, T const &b, SizeType i, SizeType j, bool transpose_a,
+                        bool transpose_b)
+  {
+    SizeType const depth = transpose_a ? a.shape()[0] : a.shape()[1];
+
+    Type sum{0};
+    for (SizeType p = 0; p < depth; ++p)
+    {
+      sum += (transpose_a ? a.At(p, i) : a.At(i, p)) * (transpose_b ? b.At(j, p) : b.At(p, j));
+    }
+    return sum;
+  }
+
+  static void ExpectProduct(T const &a, T const &b, T const &c, bool transpose_a,
+                            bool transpose_b)
+  {
+    for (SizeType i = 0; i < c.shape()[0]; ++i)
+    {
+      for (SizeType j = 0; j < c.shape()[1]; ++j)
+      {
+        ASSERT_EQ(c.At(i, j), Reference(a, b, i, j, transpose_a, transpose_b)) << i << ", " << j;
+      }
+    }
+  }
+
+  // (m, n, k) covering the naive routine, partial register tiles, several packed blocks and the
+  // threaded outer loop
+  std::vector<std::tuple<SizeType, SizeType, SizeType>> const sizes_{
+      {3, 5, 7}, {33, 17, 65}, {97, 130, 61}, {70, 1100, 300}, {200, 150, 180}};
+};
+
+using GemmTypes = ::testing::Types<fetch::math::Tensor<float>, fetch::math::Tensor<double>,
+                                   fetch::math::Tensor<fetch::fixed_point::FixedPoint<16, 16>>,
+                                   fetch::math::Tensor<fetch::fixed_point::FixedPoint<32, 32>>>;
+TYPED_TEST_CASE(GemmTest, GemmTypes);
+
+TYPED_TEST(GemmTest, Dot)
+{
+  for (auto const &size : this->sizes_)
+  {
+    auto const a = this->Generate(std::get<0>(size), std::get<2>(size), 1);
+    auto const b = this->Generate(std::get<2>(size), std::get<1>(size), 2);
+
+    this->ExpectProduct(a, b, fetch::math::Dot(a, b), false, false);
+  }
+}
+
+TYPED_TEST(GemmTest, DotTranspose)
+{
+  for (auto const &size : this->sizes_)
+  {
+    auto const a = this->Generate(std::get<0>(size), std::get<2>(size), 3);
+    auto const b = this->Generate(std::get<1>(size), std::get<2>(size), 4);
+
+    this->ExpectProduct(a, b, fetch::math::DotTranspose(a, b), false, true);
+  }
+}
+
+TYPED_TEST(GemmTest, TransposeDot)
+{
+  for (auto const &size : this->sizes_)
+  {
+    auto const a = this->Generate(std::get<2>(size), std::get<0>(size), 5);
+    auto const b = this->Generate(std::get<2>(size), std::get<1>(size), 6);
+
+    this->ExpectProduct(a, b, fetch::math::TransposeDot(a, b), true, false);
+  }
+}
+
+TYPED_TEST(GemmTest, Dot_ScalesTheProductAndTheOutput)
+{
+  using Type = typename TypeParam::Type;
+
+  for (auto const &size : this->sizes_)
+  {
+    auto const a = this->Generate(std::get<0>(size), std::get<2>(size), 7);
+    auto const b = this->Generate(std::get<2>(size), std::get<1>(size), 8);
+    auto       c = this->Generate(std::get<0>(size), std::get<1>(size), 9);
+
+    auto const original = c.Copy();
+    fetch::math::Dot(a, b, c, Type(2), Type(-3));
+
+    for (SizeType i = 0; i < c.shape()[0]; ++i)
+    {
+      for (SizeType j = 0; j < c.shape()[1]; ++j)
+      {
+        Type const expected =
+            (Type(2) * this->Reference(a, b, i, j, false, false)) - (Type(3) * original.At(i, j));
+        ASSERT_EQ(c.At(i, j), expected) << i << ", " << j;
+      }
+    }
+  }
+}
+
+TEST(FixedPointGemmTest, Dot_RoundsOncePerElement)
+{
+  using Type  = fetch::fixed_point::FixedPoint<16, 16>;
+  using Array = fetch::math::Tensor<Type>;
+
+  // each product is half of the smallest fraction, so only the sum of them is representable
+  Array a{{2, 4}};
+  Array b{{4, 3}};
+  a.Fill(Type::FromBase(1));
+  b.Fill(Type(0.5));
+  a.At(1, 3) = Type::FromBase(-1);
+
+  auto const c = fetch::math::Dot(a, b);
+  for (SizeType j = 0; j < 3; ++j)
+  {
+    EXPECT_EQ(c.At(0, j).Data(), 2);
+    EXPECT_EQ(c.At(1, j).Data(), 1);
+  }
+}
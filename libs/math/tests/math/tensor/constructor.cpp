@@ -34,3 +34,20 @@ TYPED_TEST(TensorConstructorTest, string_construction)
   ASSERT_EQ(tensor.At(0, 1), TypeParam(3));
   ASSERT_EQ(tensor.At(0, 2), TypeParam(4));
 }
+
+TYPED_TEST(TensorConstructorTest, wraps_storage_without_copy)
+{
+  fetch::memory::SharedArray<TypeParam> data(6);
+  for (std::size_t i = 0; i < 6; ++i)
+  {
+    data[i] = TypeParam(i);
+  }
+
+  fetch::math::Tensor<TypeParam> tensor(data, {2, 3});
+  ASSERT_EQ(tensor.shape(), std::vector<fetch::math::SizeType>({2, 3}));
+  ASSERT_EQ(tensor.size(), 6);
+  ASSERT_EQ(tensor.At(1, 2), TypeParam(5));
+
+  tensor.At(0, 1) = TypeParam(7);
+  ASSERT_EQ(data[2], TypeParam(7));
+}
@@ -0,0 +1,160 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/fixed_point/fixed_point.hpp"
+#include "math/tensor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+template <typename T>
+class TensorBroadcastTest : public ::testing::Test
+{
+};
+
+using MyTypes = ::testing::Types<int, float, double, fetch::fixed_point::FixedPoint<16, 16>>;
+TYPED_TEST_CASE(TensorBroadcastTest, MyTypes);
+
+using SizeType   = fetch::math::SizeType;
+using SizeVector = fetch::math::SizeVector;
+
+template <typename T>
+fetch::math::Tensor<T> Sequence(SizeVector const &shape, int start)
+{
+  fetch::math::Tensor<T> ret(shape);
+  for (SizeType i = 0; i < ret.size(); ++i)
+  {
+    ret[i] = T(start + static_cast<int>(i));
+  }
+  return ret;
+}
+
+TYPED_TEST(TensorBroadcastTest, bias_add_is_in_place)
+{
+  fetch::math::Tensor<TypeParam> batch = Sequence<TypeParam>({3, 4}, 0);
+  fetch::math::Tensor<TypeParam> bias  = Sequence<TypeParam>({3, 1}, 10);
+
+  TypeParam const *storage = batch.data().pointer();
+  batch.InlineAdd(bias);
+
+  EXPECT_EQ(batch.data().pointer(), storage);
+  EXPECT_EQ(batch.shape(), SizeVector({3, 4}));
+  for (SizeType i = 0; i < 3; ++i)
+  {
+    for (SizeType j = 0; j < 4; ++j)
+    {
+      EXPECT_EQ(batch.At(i, j), TypeParam(static_cast<int>(i + 3 * j + 10 + i)));
+    }
+    EXPECT_EQ(bias.At(i, 0), TypeParam(static_cast<int>(10 + i)));
+  }
+}
+
+TYPED_TEST(TensorBroadcastTest, divide_by_row)
+{
+  fetch::math::Tensor<TypeParam> batch = Sequence<TypeParam>({2, 3}, 2);
+  fetch::math::Tensor<TypeParam> row({1, 3});
+  row.Fill(TypeParam(2));
+
+  TypeParam const *storage = batch.data().pointer();
+  batch.InlineDivide(row);
+
+  EXPECT_EQ(batch.data().pointer(), storage);
+  for (SizeType i = 0; i < batch.size(); ++i)
+  {
+    EXPECT_EQ(batch[i], TypeParam(static_cast<int>(2 + i)) / TypeParam(2));
+  }
+}
+
+TYPED_TEST(TensorBroadcastTest, reverse_subtract_expands_this)
+{
+  fetch::math::Tensor<TypeParam> column = Sequence<TypeParam>({2, 1}, 1);
+  fetch::math::Tensor<TypeParam> batch  = Sequence<TypeParam>({2, 3}, 0);
+
+  column.InlineReverseSubtract(batch);
+
+  ASSERT_EQ(column.shape(), SizeVector({2, 3}));
+  for (SizeType i = 0; i < 2; ++i)
+  {
+    for (SizeType j = 0; j < 3; ++j)
+    {
+      EXPECT_EQ(column.At(i, j), TypeParam(static_cast<int>(i + 2 * j)) -
+                                     TypeParam(static_cast<int>(1 + i)));
+    }
+  }
+}
+
+TYPED_TEST(TensorBroadcastTest, both_operands_broadcast)
+{
+  fetch::math::Tensor<TypeParam> column = Sequence<TypeParam>({3, 1}, 1);
+  fetch::math::Tensor<TypeParam> row    = Sequence<TypeParam>({1, 4}, 1);
+  fetch::math::Tensor<TypeParam> ret;
+
+  ASSERT_TRUE(fetch::math::Broadcast([](TypeParam x, TypeParam y) { return x * y; }, column, row,
+                                     ret));
+
+  ASSERT_EQ(ret.shape(), SizeVector({3, 4}));
+  for (SizeType i = 0; i < 3; ++i)
+  {
+    for (SizeType j = 0; j < 4; ++j)
+    {
+      EXPECT_EQ(ret.At(i, j), TypeParam(static_cast<int>((i + 1) * (j + 1))));
+    }
+  }
+}
+
+TYPED_TEST(TensorBroadcastTest, missing_leading_dimensions)
+{
+  fetch::math::Tensor<TypeParam> batch = Sequence<TypeParam>({2, 3, 2}, 0);
+  fetch::math::Tensor<TypeParam> plane = Sequence<TypeParam>({3, 2}, 100);
+
+  batch.InlineSubtract(plane);
+
+  for (SizeType i = 0; i < 2; ++i)
+  {
+    for (SizeType j = 0; j < 3; ++j)
+    {
+      for (SizeType k = 0; k < 2; ++k)
+      {
+        EXPECT_EQ(batch.At(i, j, k), TypeParam(static_cast<int>(i + 2 * j + 6 * k)) -
+                                         TypeParam(static_cast<int>(100 + j + 3 * k)));
+      }
+    }
+  }
+}
+
+TYPED_TEST(TensorBroadcastTest, view_strides)
+{
+  fetch::math::Tensor<TypeParam> bias({4, 1});
+
+  fetch::math::TensorBroadcastView<TypeParam> view(bias, {2, 4, 3});
+
+  EXPECT_EQ(view.data(), bias.data().pointer());
+  EXPECT_EQ(view.shape(), SizeVector({2, 4, 3}));
+  EXPECT_EQ(view.stride(), SizeVector({0, 1, 0}));
+}
+
+TYPED_TEST(TensorBroadcastTest, incompatible_shapes_throw)
+{
+  fetch::math::Tensor<TypeParam> a({2, 3});
+  fetch::math::Tensor<TypeParam> b({3, 3});
+
+  EXPECT_THROW(a.InlineAdd(b), std::runtime_error);
+  EXPECT_EQ(a.shape(), SizeVector({2, 3}));
+}
@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/fixed_point/fixed_point.hpp"
+#include "math/tensor.hpp"
+#include "math/tensor_expression.hpp"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+template <typename T>
+class TensorExpressionTest : public ::testing::Test
+{
+protected:
+  using Array = fetch::math::Tensor<T>;
+
+  static Array Make(std::vector<int> const &values)
+  {
+    Array array(std::vector<std::uint64_t>({2, values.size() / 2}));
+    auto  it = array.begin();
+    for (int value : values)
+    {
+      *it = T(value);
+      ++it;
+    }
+    return array;
+  }
+};
+
+using MyTypes = ::testing::Types<int, float, double, fetch::fixed_point::FixedPoint<16, 16>,
+                                 fetch::fixed_point::FixedPoint<32, 32>>;
+TYPED_TEST_CASE(TensorExpressionTest, MyTypes);
+
+TYPED_TEST(TensorExpressionTest, fuses_an_expression_into_a_new_tensor)
+{
+  using fetch::math::Lazy;
+
+  auto const a = this->Make({1, -2, 3, -4, 5, -6});
+  auto const b = this->Make({2, 3, -1, 0, 4, -2});
+  auto const c = this->Make({-1, 2, 3, -5, -8, 13});
+
+  auto const ret = fetch::math::Evaluate(Lazy(a) * Lazy(b) + Lazy(c) - TypeParam(1));
+
+  ASSERT_EQ(ret.shape(), a.shape());
+  for (fetch::math::SizeType i = 0; i < ret.size(); ++i)
+  {
+    EXPECT_EQ(ret.data()[i], (a.data()[i] * b.data()[i]) + c.data()[i] - TypeParam(1));
+  }
+
+  // the operands are left untouched
+  EXPECT_EQ(a, this->Make({1, -2, 3, -4, 5, -6}));
+  EXPECT_EQ(c, this->Make({-1, 2, 3, -5, -8, 13}));
+}
+
+TYPED_TEST(TensorExpressionTest, scalars_on_either_side)
+{
+  using fetch::math::Lazy;
+
+  auto const a   = this->Make({4, 8, -12, 16});
+  auto const ret = fetch::math::Evaluate((TypeParam(2) * Lazy(a)) / TypeParam(4) - Lazy(a));
+
+  EXPECT_EQ(ret, this->Make({-2, -4, 6, -8}));
+}
+
+TYPED_TEST(TensorExpressionTest, evaluates_in_place)
+{
+  using fetch::math::Lazy;
+
+  auto       weights   = this->Make({10, 20, 30, 40});
+  auto const gradients = this->Make({1, -2, 3, -4});
+
+  fetch::math::Evaluate(Lazy(weights) + Lazy(gradients) * TypeParam(-2), weights);
+
+  EXPECT_EQ(weights, this->Make({8, 24, 24, 48}));
+}
+
+TYPED_TEST(TensorExpressionTest, maps_a_function_over_the_elements)
+{
+  using fetch::math::Lazy;
+
+  auto const a   = this->Make({1, -2, 3, -4});
+  auto const b   = this->Make({1, 1, -5, 1});
+  auto const ret = fetch::math::Evaluate(fetch::math::Map(Lazy(a) + Lazy(b), [](TypeParam x) {
+    return (x < TypeParam(0)) ? TypeParam(0) : x;
+  }));
+
+  EXPECT_EQ(ret, this->Make({2, 0, 0, 0}));
+}
+
+TYPED_TEST(TensorExpressionTest, rejects_mismatched_shapes)
+{
+  using fetch::math::Lazy;
+
+  auto const a = this->Make({1, 2, 3, 4});
+  auto const b = this->Make({1, 2, 3, 4, 5, 6});
+  auto       c = this->Make({1, 2, 3, 4, 5, 6});
+
+  EXPECT_THROW(Lazy(a) + Lazy(b), std::runtime_error);
+  EXPECT_THROW(fetch::math::Evaluate(Lazy(a) * TypeParam(2), c), std::runtime_error);
+}
@@ -0,0 +1,105 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fetch {
+namespace metrics {
+
+/**
+ * An on-demand sampling CPU profiler for the whole process
+ *
+ * While a capture is running the process is interrupted (with SIGPROF) at a fixed rate of the CPU
+ * time it consumes, and the stack of the interrupted thread is recorded. The samples are only
+ * symbolised once the capture has completed, and are reported as folded stacks, which can be
+ * rendered directly as a flame graph. Only one capture can run at a time.
+ *
+ * Symbols are resolved from the dynamic symbol table, so functions of the executable itself are
+ * only named when it is linked with -rdynamic, otherwise they are reported as an offset into it.
+ * Profiling is only available on Linux.
+ */
+class CpuProfiler
+{
+public:
+  using Duration = std::chrono::milliseconds;
+  using Stacks   = std::map<std::string, uint64_t>;
+
+  static constexpr uint32_t    DEFAULT_FREQUENCY = 99;     ///< Samples per CPU second
+  static constexpr uint32_t    MAX_FREQUENCY     = 1000;   ///< The highest supported rate
+  static constexpr std::size_t MAX_SAMPLES       = 16384;  ///< The samples kept per capture
+  static constexpr std::size_t MAX_DEPTH         = 32;     ///< The frames kept per sample
+
+  struct Profile
+  {
+    Duration    duration{};
+    uint32_t    frequency{0};
+    std::size_t samples{0};  ///< The samples recorded
+    std::size_t dropped{0};  ///< The samples lost once the buffer was full
+    Stacks      stacks{};    ///< The number of samples of each folded (root first) stack
+  };
+
+  // Singleton instance
+  static CpuProfiler &Instance();
+
+  // Construction / Destruction
+  CpuProfiler(CpuProfiler const &) = delete;
+  CpuProfiler(CpuProfiler &&)      = delete;
+  ~CpuProfiler()                   = default;
+
+  static bool supported();
+
+  bool Capture(Duration const &duration, uint32_t frequency, Profile &profile);
+
+  static std::string ToFoldedStacks(Profile const &profile);
+
+  // Operators
+  CpuProfiler &operator=(CpuProfiler const &) = delete;
+  CpuProfiler &operator=(CpuProfiler &&) = delete;
+
+private:
+  struct Sample
+  {
+    std::size_t depth{0};
+    void *      frames[MAX_DEPTH];
+  };
+
+  using Samples = std::vector<Sample>;
+
+  CpuProfiler() = default;
+
+  static void OnSignal(int signal);
+
+  Stacks Symbolise(std::size_t count) const;
+
+  std::mutex capture_lock_;  ///< Held for the duration of a capture
+  Samples    samples_;       ///< Allocated by the first capture and reused afterwards
+
+  static std::atomic<Sample *>    active_samples_;  ///< Written from the signal handler
+  static std::atomic<std::size_t> next_sample_;
+};
+
+}  // namespace metrics
+}  // namespace fetch
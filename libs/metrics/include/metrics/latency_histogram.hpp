@@ -0,0 +1,61 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace fetch {
+namespace metrics {
+
+/**
+ * A lock free histogram of latencies with power of two (microsecond) buckets
+ */
+class LatencyHistogram
+{
+public:
+  using Clock     = std::chrono::steady_clock;
+  using Timestamp = Clock::time_point;
+  using Duration  = Clock::duration;
+  using Buckets   = std::array<uint64_t, 24>;
+
+  static constexpr std::size_t NUM_BUCKETS = std::tuple_size<Buckets>::value;
+
+  void Record(Duration const &duration);
+  void Reset();
+
+  uint64_t count() const;
+  uint64_t total_us() const;
+  Buckets  buckets() const;
+
+  static uint64_t BucketUpperBound(std::size_t bucket);
+
+private:
+  using Counter      = std::atomic<uint64_t>;
+  using CounterArray = std::array<Counter, NUM_BUCKETS>;
+
+  CounterArray buckets_{};
+  Counter      count_{0};
+  Counter      total_us_{0};
+};
+
+}  // namespace metrics
+}  // namespace fetch
@@ -0,0 +1,74 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "metrics/latency_histogram.hpp"
+#include "metrics/metric_file_format.hpp"
+#include "metrics/metric_handler.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace fetch {
+namespace metrics {
+
+/**
+ * Aggregates metric events in memory, as Prometheus style counters (for every instrument and
+ * event) and histograms (of the time from the submission of each transaction to its later
+ * events).
+ *
+ * Events must only be added from a single thread (the writer of the metric file handler), the
+ * aggregated values can be read from any thread.
+ */
+class MetricAggregator
+{
+public:
+  using Instrument = MetricHandler::Instrument;
+  using Event      = MetricHandler::Event;
+
+  static constexpr std::size_t NUM_INSTRUMENTS = 2;
+  static constexpr std::size_t NUM_EVENTS      = 10;
+  static constexpr std::size_t MAX_PENDING     = 1u << 16u;  ///< Transactions awaiting execution
+
+  void Update(MetricRecord const &record);
+  void AddDropped(uint64_t count);
+
+  uint64_t                count(Instrument instrument, Event event) const;
+  uint64_t                dropped() const;
+  LatencyHistogram const &latency(Event event) const;
+
+  std::string ToPrometheusText() const;
+
+private:
+  using Counter    = std::atomic<uint64_t>;
+  using Counters   = std::array<Counter, NUM_INSTRUMENTS * NUM_EVENTS>;
+  using Histograms = std::array<LatencyHistogram, NUM_EVENTS>;
+  using PendingMap = std::unordered_map<uint64_t, int64_t>;
+
+  Counters   counts_{};
+  Counter    dropped_{0};
+  Histograms latencies_{};
+  PendingMap submitted_;  ///< The submission time of the transactions, only used by the writer
+};
+
+}  // namespace metrics
+}  // namespace fetch
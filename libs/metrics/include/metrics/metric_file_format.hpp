@@ -0,0 +1,89 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "metrics/metric_handler.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+namespace fetch {
+namespace metrics {
+
+/**
+ * The formats in which the metric file handler can write its events
+ */
+enum class MetricFileFormat
+{
+  CSV,    ///< Human readable text, one event per line
+  BINARY  ///< Fixed size records, converted offline with the metrics-converter tool
+};
+
+/**
+ * The header at the start of every binary metric file
+ */
+struct MetricFileHeader
+{
+  static constexpr uint32_t MAGIC   = 0x4D455446;  // "FTEM" (little endian)
+  static constexpr uint32_t VERSION = 1;
+
+  uint32_t magic{MAGIC};
+  uint32_t version{VERSION};
+  uint32_t record_size{0};
+  uint32_t reserved{0};
+};
+
+/**
+ * A single event as written to a binary metric file. The identifiers are (truncated) digests, so
+ * that every record has the same size and can be copied into a ring buffer without allocating.
+ */
+struct MetricRecord
+{
+  static constexpr std::size_t MAX_IDENTIFIER_LENGTH = 32;
+
+  int64_t timestamp{0};  ///< Nanoseconds since the epoch of the metric clock
+  uint8_t instrument{0};
+  uint8_t event{0};
+  uint8_t identifier_length{0};
+  uint8_t reserved[5]{};
+  uint8_t identifier[MAX_IDENTIFIER_LENGTH]{};
+};
+
+static_assert(sizeof(MetricRecord) == 48, "Binary metric records must have a fixed layout");
+
+MetricRecord CreateMetricRecord(MetricHandler::ConstByteArray const &identifier,
+                                MetricHandler::Instrument instrument, MetricHandler::Event event,
+                                MetricHandler::Timestamp const &timestamp);
+
+MetricHandler::ConstByteArray GetIdentifier(MetricRecord const &record);
+
+char const *ToString(MetricHandler::Instrument instrument);
+char const *ToString(MetricHandler::Event event);
+
+/// @name Stream Helpers
+/// @{
+void WriteHeader(std::ostream &stream);
+bool ReadHeader(std::istream &stream);
+void WriteCsvHeader(std::ostream &stream);
+void WriteCsvRecord(std::ostream &stream, MetricRecord const &record);
+/// @}
+
+}  // namespace metrics
+}  // namespace fetch
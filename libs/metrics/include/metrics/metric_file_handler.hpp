@@ -18,25 +18,38 @@
 //------------------------------------------------------------------------------
 
 #include "core/mutex.hpp"
+#include "metrics/metric_file_format.hpp"
 #include "metrics/metric_handler.hpp"
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <memory>
 #include <string>
 #include <thread>
-#include <vector>
 
 namespace fetch {
 namespace metrics {
 
+class MetricAggregator;
+
 /**
- * A Metric Handler that outputs recorded metrics to a CSV file
+ * A Metric Handler that outputs recorded metrics to a (CSV or binary) file
+ *
+ * Recording an event only copies a fixed size record into a lock free ring buffer, the file is
+ * written (and the aggregator updated) from a background thread which periodically drains the
+ * buffer. Events are dropped, and counted, if the buffer fills up between two flushes.
  */
 class MetricFileHandler : public MetricHandler
 {
 public:
+  using Format = MetricFileFormat;
+
+  static constexpr std::size_t BUFFER_SIZE = 1u << 16u;  // 65536 records
+
   // Construction / Destruction
-  MetricFileHandler(std::string filename);
+  explicit MetricFileHandler(std::string filename, Format format = Format::CSV,
+                             MetricAggregator *aggregator = nullptr);
   MetricFileHandler(MetricHandler const &) = delete;
   MetricFileHandler(MetricHandler &&)      = delete;
   ~MetricFileHandler() override;
@@ -47,32 +60,41 @@ public:
                     Timestamp const &timestamp) override;
   /// @}
 
+  uint64_t dropped() const;
+
   // Operators
   MetricFileHandler &operator=(MetricFileHandler const &) = delete;
   MetricFileHandler &operator=(MetricFileHandler &&) = delete;
 
 private:
-  static constexpr std::size_t BUFFER_SIZE = 1 << 18u;  // 262144
+  static constexpr std::size_t BATCH_SIZE     = 1024;
+  static constexpr uint32_t    FLUSH_INTERVAL = 50;  // ms
 
-  struct Entry
+  struct Slot
   {
-    ConstByteArray identifier;
-    Instrument     instrument;
-    Event          event;
-    Timestamp      timestamp;
+    std::atomic<uint64_t> sequence{0};  ///< The index of the next write (or read) of the slot
+    MetricRecord          record;
   };
 
-  using Mutex      = mutex::Mutex;
-  using EntryStack = std::vector<Entry>;
+  using Mutex = mutex::Mutex;
+  using Slots = std::unique_ptr<Slot[]>;
 
   void ThreadEntryPoint();
 
+  template <typename Writer>
+  bool Drain(Writer &&writer);
+
   std::string const       filename_;  ///< The filename for the output file
-  Mutex                   stack_lock_{__LINE__, __FILE__};
-  std::condition_variable stack_notify_;  ///< The notification variable for
-  EntryStack              stack_;         ///< The stack of events that need to be generated
-  std::atomic<bool>       active_;        ///< Active monitor thread
-  std::thread             worker_;        ///< The worker thread
+  Format const            format_;
+  MetricAggregator *const aggregator_;  ///< The (optional) in memory aggregation of the events
+  Slots                   slots_;
+  std::atomic<uint64_t>   write_index_{0};  ///< The index of the next record, shared by producers
+  uint64_t                read_index_{0};   ///< The index of the next record to be flushed
+  std::atomic<uint64_t>   dropped_{0};      ///< The number of events lost to a full buffer
+  Mutex                   worker_lock_{__LINE__, __FILE__};
+  std::condition_variable worker_notify_;  ///< Wakes the worker on shutdown
+  std::atomic<bool>       active_;         ///< Active monitor thread
+  std::thread             worker_;         ///< The worker thread
 };
 
 }  // namespace metrics
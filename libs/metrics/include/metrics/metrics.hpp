@@ -17,8 +17,12 @@
 //
 //------------------------------------------------------------------------------
 
+#include "metrics/metric_aggregator.hpp"
+#include "metrics/metric_file_format.hpp"
 #include "metrics/metric_handler.hpp"
 
+#include <atomic>
+#include <memory>
 #include <string>
 
 namespace fetch {
@@ -35,6 +39,7 @@ public:
   using ConstByteArray = byte_array::ConstByteArray;
   using Instrument     = MetricHandler::Instrument;
   using Event          = MetricHandler::Event;
+  using FileFormat     = MetricFileFormat;
 
   // Singleton instance
   static Metrics &Instance();
@@ -48,7 +53,12 @@ public:
   }
 
   // Configuration
-  void ConfigureFileHandler(std::string filename);
+  void ConfigureFileHandler(std::string filename, FileFormat format = FileFormat::CSV);
+
+  MetricAggregator const &aggregator() const
+  {
+    return aggregator_;
+  }
 
   void RecordMetric(ConstByteArray const &identifier, Instrument instrument, Event event,
                     Timestamp const &timestamp = Clock::now())
@@ -81,6 +91,7 @@ private:
   Metrics() = default;
   void RemoveMetricHandler();
 
+  MetricAggregator               aggregator_;  ///< Updated by the file handler (when configured)
   std::unique_ptr<MetricHandler> handler_object_;
   std::atomic<MetricHandler *>   handler_{nullptr};
 };
@@ -0,0 +1,44 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include <cstdint>
+
+namespace fetch {
+namespace metrics {
+
+/**
+ * A snapshot of the memory held by the heap allocator and by the process as a whole. The
+ * allocator figures are only available with glibc, elsewhere they are reported as zero.
+ */
+struct AllocatorStats
+{
+  uint64_t arena_bytes{0};       ///< The bytes obtained from the system with brk / sbrk
+  uint64_t mmap_bytes{0};        ///< The bytes obtained with mmap for large allocations
+  uint64_t in_use_bytes{0};      ///< The bytes handed out to the application
+  uint64_t free_bytes{0};        ///< The bytes held by the allocator but not in use
+  uint64_t releasable_bytes{0};  ///< The free bytes at the top of the heap, which can be trimmed
+  uint64_t resident_bytes{0};    ///< The resident set size of the process
+
+  static AllocatorStats Read();
+
+  double fragmentation() const;
+};
+
+}  // namespace metrics
+}  // namespace fetch
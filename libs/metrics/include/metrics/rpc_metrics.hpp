@@ -0,0 +1,125 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "metrics/latency_histogram.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace fetch {
+namespace metrics {
+
+/**
+ * The instruments for a single RPC (protocol / function pair)
+ */
+struct RpcCallMetrics
+{
+  using Counter  = std::atomic<uint64_t>;
+  using Duration = LatencyHistogram::Duration;
+
+  Counter          calls{0};      ///< Calls which have been issued
+  Counter          succeeded{0};  ///< Calls which received a result
+  Counter          failed{0};     ///< Calls which received an error or could not be delivered
+  Counter          timeouts{0};   ///< Calls which were given up on by the caller
+  LatencyHistogram latency{};     ///< Time from issuing the call until its result or error
+
+  void Reset();
+
+  void RecordCall()
+  {
+    calls.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void RecordTimeout()
+  {
+    timeouts.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void RecordCompletion(bool success, Duration const &duration)
+  {
+    (success ? succeeded : failed).fetch_add(1, std::memory_order_relaxed);
+    latency.Record(duration);
+  }
+};
+
+/**
+ * Singleton registry of the RPC instruments, keyed by the protocol and function identifiers.
+ *
+ * Instruments are never removed from the registry so the references which are handed out remain
+ * valid for the lifetime of the process.
+ */
+class RpcMetrics
+{
+public:
+  using ProtocolId = uint64_t;
+  using FunctionId = uint64_t;
+
+  // Singleton instance
+  static RpcMetrics &Instance();
+
+  // Construction / Destruction
+  RpcMetrics(RpcMetrics const &) = delete;
+  RpcMetrics(RpcMetrics &&)      = delete;
+  ~RpcMetrics()                  = default;
+
+  RpcCallMetrics &Call(ProtocolId protocol, FunctionId function);
+
+  template <typename Visitor>
+  void VisitCalls(Visitor &&visitor) const;
+
+  void Reset();
+
+  // Operators
+  RpcMetrics &operator=(RpcMetrics const &) = delete;
+  RpcMetrics &operator=(RpcMetrics &&) = delete;
+
+private:
+  using Mutex   = std::mutex;
+  using Key     = std::pair<ProtocolId, FunctionId>;
+  using CallMap = std::map<Key, std::unique_ptr<RpcCallMetrics>>;
+
+  // Hidden construction
+  RpcMetrics() = default;
+
+  mutable Mutex lock_;  ///< guards `calls_`
+  CallMap       calls_;
+};
+
+/**
+ * Visit all of the registered RPC instruments, in protocol / function order
+ *
+ * @param visitor The callable invoked with the protocol, function and instruments of each RPC
+ */
+template <typename Visitor>
+void RpcMetrics::VisitCalls(Visitor &&visitor) const
+{
+  std::lock_guard<Mutex> guard(lock_);
+
+  for (auto const &element : calls_)
+  {
+    visitor(element.first.first, element.first.second, *element.second);
+  }
+}
+
+}  // namespace metrics
+}  // namespace fetch
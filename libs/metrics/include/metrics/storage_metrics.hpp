@@ -0,0 +1,165 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "metrics/latency_histogram.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace fetch {
+namespace metrics {
+
+/**
+ * The instruments for a single (file backed) stack
+ */
+struct StackMetrics
+{
+  using Counter = std::atomic<uint64_t>;
+
+  Counter          cache_hits{0};     ///< Reads served from the cache of the stack
+  Counter          cache_misses{0};   ///< Reads which had to go to the underlying file
+  Counter          bytes_read{0};     ///< Bytes read from the file
+  Counter          bytes_written{0};  ///< Bytes written to the file
+  LatencyHistogram flush_latency{};   ///< Time taken to flush (and sync) the file
+
+  void   Reset();
+  double cache_hit_ratio() const;
+
+  void RecordCacheHit()
+  {
+    cache_hits.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void RecordCacheMiss()
+  {
+    cache_misses.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void RecordRead(std::size_t bytes)
+  {
+    bytes_read.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  void RecordWrite(std::size_t bytes)
+  {
+    bytes_written.fetch_add(bytes, std::memory_order_relaxed);
+  }
+};
+
+/**
+ * The instruments for a revertible document store
+ */
+struct DocumentStoreMetrics
+{
+  LatencyHistogram commit_latency{};  ///< Time taken to commit the state
+  LatencyHistogram revert_latency{};  ///< Time taken to revert to a previous state
+
+  void Reset();
+};
+
+/**
+ * Singleton registry of the storage instruments, keyed by the file name of the stack (or store).
+ *
+ * Instruments are never removed from the registry so the references which are handed out remain
+ * valid for the lifetime of the process.
+ */
+class StorageMetrics
+{
+public:
+  // Singleton instance
+  static StorageMetrics &Instance();
+
+  // Construction / Destruction
+  StorageMetrics(StorageMetrics const &) = delete;
+  StorageMetrics(StorageMetrics &&)      = delete;
+  ~StorageMetrics()                      = default;
+
+  /// @name Instrument Lookup
+  /// @{
+  StackMetrics &        Stack(std::string const &name);
+  DocumentStoreMetrics &DocumentStore(std::string const &name);
+  /// @}
+
+  /// @name Iteration
+  /// @{
+  template <typename Visitor>
+  void VisitStacks(Visitor &&visitor) const;
+
+  template <typename Visitor>
+  void VisitDocumentStores(Visitor &&visitor) const;
+  /// @}
+
+  void Reset();
+
+  // Operators
+  StorageMetrics &operator=(StorageMetrics const &) = delete;
+  StorageMetrics &operator=(StorageMetrics &&) = delete;
+
+private:
+  using Mutex            = std::mutex;
+  using StackMap         = std::unordered_map<std::string, std::unique_ptr<StackMetrics>>;
+  using DocumentStoreMap = std::unordered_map<std::string, std::unique_ptr<DocumentStoreMetrics>>;
+
+  // Hidden construction
+  StorageMetrics() = default;
+
+  mutable Mutex    lock_;  ///< guards `stacks_` and `stores_`
+  StackMap         stacks_;
+  DocumentStoreMap stores_;
+};
+
+/**
+ * Visit all of the registered stack instruments
+ *
+ * @param visitor The callable invoked with the name and instruments of each stack
+ */
+template <typename Visitor>
+void StorageMetrics::VisitStacks(Visitor &&visitor) const
+{
+  std::lock_guard<Mutex> guard(lock_);
+
+  for (auto const &element : stacks_)
+  {
+    visitor(element.first, *element.second);
+  }
+}
+
+/**
+ * Visit all of the registered document store instruments
+ *
+ * @param visitor The callable invoked with the name and instruments of each document store
+ */
+template <typename Visitor>
+void StorageMetrics::VisitDocumentStores(Visitor &&visitor) const
+{
+  std::lock_guard<Mutex> guard(lock_);
+
+  for (auto const &element : stores_)
+  {
+    visitor(element.first, *element.second);
+  }
+}
+
+}  // namespace metrics
+}  // namespace fetch
@@ -0,0 +1,203 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "core/mutex.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fetch {
+namespace metrics {
+
+class Span;
+
+/**
+ * The identity of a span, which is used as the parent of the spans started from it. The context
+ * of an inactive span has a zero trace id.
+ */
+struct SpanContext
+{
+  uint64_t trace_id{0};
+  uint64_t span_id{0};
+
+  bool valid() const
+  {
+    return trace_id != 0;
+  }
+};
+
+/**
+ * A completed span, as exported by the tracer
+ */
+struct SpanRecord
+{
+  char const *name{nullptr};  ///< The (static) name of the span
+  uint64_t    trace_id{0};
+  uint64_t    span_id{0};
+  uint64_t    parent_id{0};  ///< The span id of the parent, or zero for the root of a trace
+  int64_t     start_ns{0};   ///< The start time, in nanoseconds since the unix epoch
+  int64_t     end_ns{0};     ///< The end time, in nanoseconds since the unix epoch
+  uint32_t    thread{0};     ///< The index of the thread which completed the span
+};
+
+/**
+ * Records spans of work, with parent ids, so that the path of a transaction through the system
+ * (HTTP submission, verification, storage, packing and execution) can be reconstructed.
+ *
+ * Each thread records the spans it completes into its own fixed size ring buffer without taking
+ * any locks, the oldest spans are overwritten if the buffer is not collected in time. Tracing is
+ * disabled by default, when enabled only one in every N traces is sampled.
+ *
+ * The trace of a transaction is identified by its digest, so that every stage can find the parent
+ * span without the context being passed along with the transaction. Since the sampling decision
+ * is also made on the trace id, either all or none of the spans of a transaction are recorded.
+ */
+class Tracer
+{
+public:
+  using Clock          = std::chrono::steady_clock;
+  using Timestamp      = Clock::time_point;
+  using ConstByteArray = byte_array::ConstByteArray;
+  using SpanRecords    = std::vector<SpanRecord>;
+
+  static constexpr std::size_t BUFFER_SIZE = 4096;  ///< The number of spans kept per thread
+
+  // Singleton instance
+  static Tracer &Instance();
+
+  // Construction / Destruction
+  Tracer(Tracer const &) = delete;
+  Tracer(Tracer &&)      = delete;
+  ~Tracer()              = default;
+
+  /// @name Configuration
+  /// @{
+  void SetSampleRate(uint32_t one_in);
+  bool enabled() const;
+  /// @}
+
+  /// @name Spans
+  /// @{
+  Span StartSpan(char const *name);
+  Span StartSpan(char const *name, SpanContext const &parent,
+                 Timestamp const &start = Clock::now());
+  Span StartTransactionSpan(char const *name, ConstByteArray const &digest,
+                            Timestamp const &start = Clock::now());
+  Span StartTransactionRootSpan(char const *name, ConstByteArray const &digest,
+                                Timestamp const &start = Clock::now());
+
+  static SpanContext TransactionContext(ConstByteArray const &digest);
+  /// @}
+
+  /// @name Export
+  /// @{
+  SpanRecords Collect();
+  uint64_t    dropped() const;
+
+  static std::string ToChromeTrace(SpanRecords const &records);
+  static std::string ToOtlpJson(SpanRecords const &records, std::string const &service_name);
+  /// @}
+
+  // Operators
+  Tracer &operator=(Tracer const &) = delete;
+  Tracer &operator=(Tracer &&) = delete;
+
+private:
+  class Buffer;
+
+  using BufferPtr  = std::shared_ptr<Buffer>;
+  using BufferList = std::vector<BufferPtr>;
+  using Mutex      = mutex::Mutex;
+
+  // Hidden construction
+  Tracer();
+
+  bool     IsSampled(uint64_t trace_id) const;
+  uint64_t NextId();
+  Span     Start(char const *name, uint64_t trace_id, uint64_t span_id, uint64_t parent_id,
+                 Timestamp const &start);
+  void     Record(Span const &span, Timestamp const &end);
+  Buffer & LocalBuffer();
+  int64_t  ToUnixNanos(Timestamp const &timestamp) const;
+
+  std::atomic<uint32_t> sample_rate_{0};  ///< One in this many traces are sampled, 0 disables
+  std::atomic<uint64_t> next_seed_{0};    ///< The seed of the span ids of the next thread
+  std::atomic<uint64_t> dropped_{0};      ///< The number of spans overwritten before collection
+  std::atomic<uint32_t> next_thread_{0};
+  int64_t               epoch_offset_ns_{0};  ///< The offset from the clock to the unix epoch
+
+  Mutex      lock_{__LINE__, __FILE__};  ///< Protects the list of buffers and their collection
+  BufferList buffers_;                   ///< The buffers of every thread which has recorded a span
+
+  friend class Span;
+};
+
+/**
+ * A span of work which is recorded when it ends (or is destroyed). Spans which are not sampled
+ * are inactive and do nothing.
+ */
+class Span
+{
+public:
+  using Timestamp = Tracer::Timestamp;
+
+  // Construction / Destruction
+  Span()             = default;
+  Span(Span const &) = delete;
+  Span(Span &&other) noexcept;
+  ~Span();
+
+  void End(Timestamp const &end = Tracer::Clock::now());
+
+  bool active() const
+  {
+    return tracer_ != nullptr;
+  }
+
+  SpanContext context() const
+  {
+    return {trace_id_, span_id_};
+  }
+
+  // Operators
+  Span &operator=(Span const &) = delete;
+  Span &operator=(Span &&other) noexcept;
+
+private:
+  Span(Tracer &tracer, char const *name, uint64_t trace_id, uint64_t span_id, uint64_t parent_id,
+       Timestamp const &start);
+
+  Tracer *    tracer_{nullptr};
+  char const *name_{nullptr};
+  uint64_t    trace_id_{0};
+  uint64_t    span_id_{0};
+  uint64_t    parent_id_{0};
+  Timestamp   start_{};
+
+  friend class Tracer;
+};
+
+}  // namespace metrics
+}  // namespace fetch
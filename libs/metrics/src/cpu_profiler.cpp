@@ -0,0 +1,285 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "metrics/cpu_profiler.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#if defined(FETCH_PLATFORM_LINUX)
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <sys/time.h>
+#endif
+
+namespace fetch {
+namespace metrics {
+namespace {
+
+#if defined(FETCH_PLATFORM_LINUX)
+/// The frames of the signal handler and of the signal trampoline at the top of every sample
+constexpr std::size_t SIGNAL_FRAMES = 2;
+
+/// The time allowed for signals raised before the timer was stopped to be handled
+constexpr std::chrono::milliseconds SIGNAL_GRACE_PERIOD{20};
+
+/**
+ * Name the function containing an address
+ *
+ * @param address The (return) address
+ * @return The demangled name of the function if it is known, otherwise the module and offset
+ */
+std::string SymbolName(void *address)
+{
+  std::ostringstream oss;
+
+  Dl_info info{};
+  if ((dladdr(address, &info) != 0) && (info.dli_sname != nullptr))
+  {
+    int   status{0};
+    char *demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+
+    oss << ((status == 0) ? demangled : info.dli_sname);
+    std::free(demangled);
+  }
+  else if (info.dli_fname != nullptr)
+  {
+    std::string module{info.dli_fname};
+    module = module.substr(module.find_last_of('/') + 1);
+
+    oss << module << "+0x" << std::hex
+        << (reinterpret_cast<uintptr_t>(address) - reinterpret_cast<uintptr_t>(info.dli_fbase));
+  }
+  else
+  {
+    oss << address;
+  }
+
+  return oss.str();
+}
+#endif
+
+}  // namespace
+
+constexpr uint32_t    CpuProfiler::DEFAULT_FREQUENCY;
+constexpr uint32_t    CpuProfiler::MAX_FREQUENCY;
+constexpr std::size_t CpuProfiler::MAX_SAMPLES;
+constexpr std::size_t CpuProfiler::MAX_DEPTH;
+
+std::atomic<CpuProfiler::Sample *> CpuProfiler::active_samples_{nullptr};
+std::atomic<std::size_t>           CpuProfiler::next_sample_{0};
+
+CpuProfiler &CpuProfiler::Instance()
+{
+  static CpuProfiler instance;
+  return instance;
+}
+
+/**
+ * @return true if the process can be profiled on this platform, otherwise false
+ */
+bool CpuProfiler::supported()
+{
+#if defined(FETCH_PLATFORM_LINUX)
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Sample the stacks of the process for a period of time. Blocks the calling thread until the
+ * capture has completed.
+ *
+ * @param duration The length of the capture
+ * @param frequency The number of samples per second of CPU time consumed
+ * @param profile The profile to be populated
+ * @return true if the capture was made, false if another capture is running or profiling is not
+ * supported
+ */
+bool CpuProfiler::Capture(Duration const &duration, uint32_t frequency, Profile &profile)
+{
+#if defined(FETCH_PLATFORM_LINUX)
+  std::unique_lock<std::mutex> lock(capture_lock_, std::try_to_lock);
+  if (!lock.owns_lock())
+  {
+    return false;
+  }
+
+  frequency = std::min(std::max(frequency, 1u), MAX_FREQUENCY);
+
+  if (samples_.empty())
+  {
+    samples_.resize(MAX_SAMPLES);
+  }
+
+  // the first call to backtrace loads the unwinder, which must not happen inside the handler
+  void *primer[1];
+  backtrace(primer, 1);
+
+  // the handler is never removed, since a signal raised before the timer was stopped could
+  // otherwise be delivered after the default action (terminating the process) had been restored
+  struct sigaction action = {};
+  action.sa_handler = &CpuProfiler::OnSignal;
+  action.sa_flags   = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+
+  if (sigaction(SIGPROF, &action, nullptr) != 0)
+  {
+    return false;
+  }
+
+  next_sample_ = 0;
+  active_samples_.store(samples_.data(), std::memory_order_release);
+
+  itimerval timer{};
+  timer.it_interval.tv_usec = static_cast<suseconds_t>(1000000u / frequency);
+  timer.it_value            = timer.it_interval;
+
+  bool const started = (setitimer(ITIMER_PROF, &timer, nullptr) == 0);
+  if (started)
+  {
+    std::this_thread::sleep_for(duration);
+
+    itimerval const stop{};
+    setitimer(ITIMER_PROF, &stop, nullptr);
+  }
+
+  active_samples_.store(nullptr, std::memory_order_release);
+  std::this_thread::sleep_for(SIGNAL_GRACE_PERIOD);
+
+  if (!started)
+  {
+    return false;
+  }
+
+  std::size_t const raised = next_sample_;
+  std::size_t const count  = std::min(raised, MAX_SAMPLES);
+
+  profile.duration  = duration;
+  profile.frequency = frequency;
+  profile.samples   = count;
+  profile.dropped   = raised - count;
+  profile.stacks    = Symbolise(count);
+
+  return true;
+#else
+  (void)duration;
+  (void)frequency;
+  (void)profile;
+  return false;
+#endif
+}
+
+/**
+ * Format a profile as folded stacks: one line per distinct stack, with the frames from the root
+ * separated by semicolons, followed by the number of samples
+ *
+ * @param profile The profile to be formatted
+ * @return The folded stacks
+ */
+std::string CpuProfiler::ToFoldedStacks(Profile const &profile)
+{
+  std::ostringstream oss;
+  for (auto const &entry : profile.stacks)
+  {
+    oss << entry.first << ' ' << entry.second << '\n';
+  }
+
+  return oss.str();
+}
+
+/**
+ * Internal: Record the stack of the interrupted thread. Only async signal safe calls can be made.
+ */
+void CpuProfiler::OnSignal(int /*signal*/)
+{
+#if defined(FETCH_PLATFORM_LINUX)
+  int const saved_errno = errno;
+
+  Sample *samples = active_samples_.load(std::memory_order_acquire);
+  if (samples != nullptr)
+  {
+    std::size_t const index = next_sample_.fetch_add(1, std::memory_order_relaxed);
+    if (index < MAX_SAMPLES)
+    {
+      Sample &sample = samples[index];
+      sample.depth   = static_cast<std::size_t>(backtrace(sample.frames, MAX_DEPTH));
+    }
+  }
+
+  errno = saved_errno;
+#endif
+}
+
+/**
+ * Internal: Resolve and fold the stacks of the recorded samples
+ *
+ * @param count The number of samples recorded
+ * @return The number of samples of each folded stack
+ */
+CpuProfiler::Stacks CpuProfiler::Symbolise(std::size_t count) const
+{
+  Stacks stacks{};
+
+#if defined(FETCH_PLATFORM_LINUX)
+  std::unordered_map<void *, std::string> names{};
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    Sample const &sample = samples_[i];
+
+    std::string folded{};
+    for (std::size_t frame = sample.depth; frame > SIGNAL_FRAMES; --frame)
+    {
+      void *const address = sample.frames[frame - 1];
+
+      auto it = names.find(address);
+      if (it == names.end())
+      {
+        it = names.emplace(address, SymbolName(address)).first;
+      }
+
+      if (!folded.empty())
+      {
+        folded.push_back(';');
+      }
+
+      folded += it->second;
+    }
+
+    if (!folded.empty())
+    {
+      ++stacks[folded];
+    }
+  }
+#else
+  (void)count;
+#endif
+
+  return stacks;
+}
+
+}  // namespace metrics
+}  // namespace fetch
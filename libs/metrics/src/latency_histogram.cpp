@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "metrics/latency_histogram.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace fetch {
+namespace metrics {
+
+constexpr std::size_t LatencyHistogram::NUM_BUCKETS;
+
+/**
+ * Record a single latency sample
+ *
+ * @param duration The measured duration
+ */
+void LatencyHistogram::Record(Duration const &duration)
+{
+  auto const micros = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+  auto const value  = static_cast<uint64_t>(std::max<decltype(micros)>(micros, 0));
+
+  // bucket N contains the sample in the range [2^(N-1), 2^N) microseconds
+  std::size_t bucket = 0;
+  if (value)
+  {
+    bucket = static_cast<std::size_t>(64 - __builtin_clzll(value));
+  }
+  bucket = std::min(bucket, NUM_BUCKETS - 1);
+
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  total_us_.fetch_add(value, std::memory_order_relaxed);
+}
+
+/**
+ * Clear all the recorded samples
+ */
+void LatencyHistogram::Reset()
+{
+  for (auto &bucket : buckets_)
+  {
+    bucket = 0;
+  }
+
+  count_    = 0;
+  total_us_ = 0;
+}
+
+/**
+ * @return The number of recorded samples
+ */
+uint64_t LatencyHistogram::count() const
+{
+  return count_.load(std::memory_order_relaxed);
+}
+
+/**
+ * @return The sum of all the recorded samples in microseconds
+ */
+uint64_t LatencyHistogram::total_us() const
+{
+  return total_us_.load(std::memory_order_relaxed);
+}
+
+/**
+ * @return A snapshot of the sample counts for each of the buckets
+ */
+LatencyHistogram::Buckets LatencyHistogram::buckets() const
+{
+  Buckets values{};
+  for (std::size_t i = 0; i < NUM_BUCKETS; ++i)
+  {
+    values[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+
+  return values;
+}
+
+/**
+ * Get the (exclusive) upper bound of the specified bucket
+ *
+ * @param bucket The index of the bucket
+ * @return The upper bound in microseconds
+ */
+uint64_t LatencyHistogram::BucketUpperBound(std::size_t bucket)
+{
+  if (bucket + 1 >= NUM_BUCKETS)
+  {
+    return std::numeric_limits<uint64_t>::max();
+  }
+
+  return uint64_t{1} << bucket;
+}
+
+}  // namespace metrics
+}  // namespace fetch
@@ -0,0 +1,211 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "metrics/metric_aggregator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+namespace fetch {
+namespace metrics {
+namespace {
+
+/**
+ * Format the upper bound of a histogram bucket as a Prometheus `le` label (in seconds)
+ */
+std::string ToBucketLabel(std::size_t bucket)
+{
+  if ((bucket + 1) >= LatencyHistogram::NUM_BUCKETS)
+  {
+    return "+Inf";
+  }
+
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%g",
+                static_cast<double>(LatencyHistogram::BucketUpperBound(bucket)) / 1e6);
+  return buffer;
+}
+
+}  // namespace
+
+constexpr std::size_t MetricAggregator::NUM_INSTRUMENTS;
+constexpr std::size_t MetricAggregator::NUM_EVENTS;
+constexpr std::size_t MetricAggregator::MAX_PENDING;
+
+/**
+ * Add an event to the aggregated values
+ *
+ * @param record The event to be added
+ */
+void MetricAggregator::Update(MetricRecord const &record)
+{
+  if ((record.instrument >= NUM_INSTRUMENTS) || (record.event >= NUM_EVENTS))
+  {
+    return;
+  }
+
+  counts_[(record.instrument * NUM_EVENTS) + record.event].fetch_add(1, std::memory_order_relaxed);
+
+  if (static_cast<Instrument>(record.instrument) != Instrument::TRANSACTION)
+  {
+    return;
+  }
+
+  // the leading bytes of the digest are more than enough to distinguish pending transactions
+  uint64_t key{0};
+  std::memcpy(&key, record.identifier,
+              std::min<std::size_t>(record.identifier_length, sizeof(key)));
+
+  auto const event = static_cast<Event>(record.event);
+  if (event == Event::SUBMITTED)
+  {
+    // bound the memory used by transactions which never complete
+    if (submitted_.size() >= MAX_PENDING)
+    {
+      submitted_.clear();
+    }
+
+    submitted_.emplace(key, record.timestamp);
+    return;
+  }
+
+  auto const it = submitted_.find(key);
+  if (it == submitted_.end())
+  {
+    return;
+  }
+
+  latencies_[record.event].Record(std::chrono::duration_cast<LatencyHistogram::Duration>(
+      std::chrono::nanoseconds{record.timestamp - it->second}));
+
+  if (event == Event::EXECUTION_COMPLETE)
+  {
+    submitted_.erase(it);
+  }
+}
+
+/**
+ * Record events which were discarded before they could be aggregated
+ *
+ * @param count The number of events
+ */
+void MetricAggregator::AddDropped(uint64_t count)
+{
+  dropped_.fetch_add(count, std::memory_order_relaxed);
+}
+
+/**
+ * Get the number of times an event has been recorded
+ *
+ * @param instrument The instrument
+ * @param event The event
+ * @return The number of events
+ */
+uint64_t MetricAggregator::count(Instrument instrument, Event event) const
+{
+  auto const index = (static_cast<std::size_t>(instrument) * NUM_EVENTS) +
+                     static_cast<std::size_t>(event);
+
+  return counts_[index].load(std::memory_order_relaxed);
+}
+
+/**
+ * @return The number of events which were discarded before they could be aggregated
+ */
+uint64_t MetricAggregator::dropped() const
+{
+  return dropped_.load(std::memory_order_relaxed);
+}
+
+/**
+ * Get the histogram of the time from the submission of transactions to an event
+ *
+ * @param event The event
+ * @return The histogram
+ */
+LatencyHistogram const &MetricAggregator::latency(Event event) const
+{
+  return latencies_[static_cast<std::size_t>(event)];
+}
+
+/**
+ * Format the aggregated values in the Prometheus text exposition format
+ *
+ * @return The formatted values
+ */
+std::string MetricAggregator::ToPrometheusText() const
+{
+  std::ostringstream oss;
+
+  oss << "# HELP fetch_metric_events_total The number of recorded metric events\n"
+      << "# TYPE fetch_metric_events_total counter\n";
+
+  for (std::size_t instrument = 0; instrument < NUM_INSTRUMENTS; ++instrument)
+  {
+    for (std::size_t event = 0; event < NUM_EVENTS; ++event)
+    {
+      auto const value = count(static_cast<Instrument>(instrument), static_cast<Event>(event));
+
+      oss << "fetch_metric_events_total{instrument=\""
+          << ToString(static_cast<Instrument>(instrument)) << "\",event=\""
+          << ToString(static_cast<Event>(event)) << "\"} " << value << '\n';
+    }
+  }
+
+  oss << "# HELP fetch_metric_events_dropped_total The number of metric events discarded\n"
+      << "# TYPE fetch_metric_events_dropped_total counter\n"
+      << "fetch_metric_events_dropped_total " << dropped() << '\n';
+
+  oss << "# HELP fetch_transaction_latency_seconds The time from the submission of a transaction\n"
+      << "# TYPE fetch_transaction_latency_seconds histogram\n";
+
+  for (std::size_t event = 0; event < NUM_EVENTS; ++event)
+  {
+    auto const &histogram = latencies_[event];
+    if (histogram.count() == 0)
+    {
+      continue;
+    }
+
+    char const *name = ToString(static_cast<Event>(event));
+
+    // prometheus buckets are cumulative
+    uint64_t   cumulative{0};
+    auto const buckets = histogram.buckets();
+    for (std::size_t bucket = 0; bucket < LatencyHistogram::NUM_BUCKETS; ++bucket)
+    {
+      cumulative += buckets[bucket];
+
+      oss << "fetch_transaction_latency_seconds_bucket{event=\"" << name << "\",le=\""
+          << ToBucketLabel(bucket) << "\"} " << cumulative << '\n';
+    }
+
+    oss << "fetch_transaction_latency_seconds_sum{event=\"" << name << "\"} "
+        << (static_cast<double>(histogram.total_us()) / 1e6) << '\n'
+        << "fetch_transaction_latency_seconds_count{event=\"" << name << "\"} "
+        << histogram.count() << '\n';
+  }
+
+  return oss.str();
+}
+
+}  // namespace metrics
+}  // namespace fetch
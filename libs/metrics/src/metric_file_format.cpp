@@ -0,0 +1,189 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "metrics/metric_file_format.hpp"
+#include "core/byte_array/encoders.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+namespace fetch {
+namespace metrics {
+
+constexpr uint32_t    MetricFileHeader::MAGIC;
+constexpr uint32_t    MetricFileHeader::VERSION;
+constexpr std::size_t MetricRecord::MAX_IDENTIFIER_LENGTH;
+
+/**
+ * Build the fixed size record of an event
+ *
+ * @param identifier The identifier of the metric, truncated if longer than the record allows
+ * @param instrument The instrument being measured
+ * @param event The event being recorded
+ * @param timestamp The timestamp of the event
+ * @return The record
+ */
+MetricRecord CreateMetricRecord(MetricHandler::ConstByteArray const &identifier,
+                                MetricHandler::Instrument instrument, MetricHandler::Event event,
+                                MetricHandler::Timestamp const &timestamp)
+{
+  MetricRecord record;
+  record.timestamp = static_cast<int64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch()).count());
+  record.instrument = static_cast<uint8_t>(instrument);
+  record.event      = static_cast<uint8_t>(event);
+
+  std::size_t const length = std::min(identifier.size(), MetricRecord::MAX_IDENTIFIER_LENGTH);
+  std::memcpy(record.identifier, identifier.pointer(), length);
+  record.identifier_length = static_cast<uint8_t>(length);
+
+  return record;
+}
+
+/**
+ * Extract the identifier of a record
+ *
+ * @param record The record
+ * @return The identifier
+ */
+MetricHandler::ConstByteArray GetIdentifier(MetricRecord const &record)
+{
+  std::size_t const length =
+      std::min<std::size_t>(record.identifier_length, MetricRecord::MAX_IDENTIFIER_LENGTH);
+
+  return {record.identifier, length};
+}
+
+/**
+ * Convert a instrument type to string
+ *
+ * @param instrument The instrument to convert
+ * @return The string representation of the instrument
+ */
+char const *ToString(MetricHandler::Instrument instrument)
+{
+  switch (instrument)
+  {
+  case MetricHandler::Instrument::TRANSACTION:
+    return "transaction";
+
+  case MetricHandler::Instrument::BLOCK:
+    return "block";
+  }
+
+  return "unknown";
+}
+
+/**
+ * Convert a event type to string
+ *
+ * @param event The input event type
+ * @return The string representation fo the event
+ */
+char const *ToString(MetricHandler::Event event)
+{
+  switch (event)
+  {
+  case MetricHandler::Event::SUBMITTED:
+    return "submitted";
+  case MetricHandler::Event::STORED:
+    return "stored";
+  case MetricHandler::Event::SYNCED:
+    return "synced";
+  case MetricHandler::Event::RECEIVED_FOR_SYNC:
+    return "received_for_sync";
+  case MetricHandler::Event::QUEUED:
+    return "queued";
+  case MetricHandler::Event::PACKED:
+    return "packed";
+  case MetricHandler::Event::EXECUTION_STARTED:
+    return "exec-started";
+  case MetricHandler::Event::EXECUTION_COMPLETE:
+    return "exec-complete";
+  case MetricHandler::Event::GENERATED:
+    return "generated";
+  case MetricHandler::Event::RECEIVED:
+    return "received";
+  }
+
+  return "unknown";
+}
+
+/**
+ * Write the header of a binary metric file
+ *
+ * @param stream The output stream
+ */
+void WriteHeader(std::ostream &stream)
+{
+  MetricFileHeader header;
+  header.record_size = static_cast<uint32_t>(sizeof(MetricRecord));
+
+  stream.write(reinterpret_cast<char const *>(&header), sizeof(header));
+}
+
+/**
+ * Read and validate the header of a binary metric file
+ *
+ * @param stream The input stream
+ * @return true if the stream contains records of the expected format, otherwise false
+ */
+bool ReadHeader(std::istream &stream)
+{
+  MetricFileHeader header;
+  header.magic = 0;
+
+  if (!stream.read(reinterpret_cast<char *>(&header), sizeof(header)))
+  {
+    return false;
+  }
+
+  return (header.magic == MetricFileHeader::MAGIC) &&
+         (header.version == MetricFileHeader::VERSION) &&
+         (header.record_size == sizeof(MetricRecord));
+}
+
+/**
+ * Write the header line of a CSV metric file
+ *
+ * @param stream The output stream
+ */
+void WriteCsvHeader(std::ostream &stream)
+{
+  stream << "Timestamp,Instrument,Event,Identifier\n";
+}
+
+/**
+ * Write a single event as a line of a CSV metric file
+ *
+ * @param stream The output stream
+ * @param record The event to be written
+ */
+void WriteCsvRecord(std::ostream &stream, MetricRecord const &record)
+{
+  stream << record.timestamp << ','
+         << ToString(static_cast<MetricHandler::Instrument>(record.instrument)) << ','
+         << ToString(static_cast<MetricHandler::Event>(record.event)) << ','
+         << byte_array::ToBase64(GetIdentifier(record)) << '\n';
+}
+
+}  // namespace metrics
+}  // namespace fetch
@@ -17,86 +17,39 @@
 //------------------------------------------------------------------------------
 
 #include "metrics/metric_file_handler.hpp"
-#include "core/byte_array/encoders.hpp"
+#include "metrics/metric_aggregator.hpp"
 
 #include <fstream>
-
-using fetch::byte_array::ToBase64;
+#include <vector>
 
 namespace fetch {
 namespace metrics {
-namespace {
-
-/**
- * Convert a instrument type to string
- *
- * @param instrument The instrument to convert
- * @return The string representation of the instrument
- */
-char const *ToString(MetricHandler::Instrument instrument)
-{
-  switch (instrument)
-  {
-  case MetricHandler::Instrument::TRANSACTION:
-    return "transaction";
-
-  case MetricHandler::Instrument::BLOCK:
-    return "block";
-  }
-
-  return "unknown";
-}
 
-/**
- * Convert a event type to string
- *
- * @param event The input event type
- * @return The string representation fo the event
- */
-char const *ToString(MetricHandler::Event event)
-{
-  switch (event)
-  {
-  case MetricHandler::Event::SUBMITTED:
-    return "submitted";
-  case MetricHandler::Event::STORED:
-    return "stored";
-  case MetricHandler::Event::SYNCED:
-    return "synced";
-  case MetricHandler::Event::RECEIVED_FOR_SYNC:
-    return "received_for_sync";
-  case MetricHandler::Event::QUEUED:
-    return "queued";
-  case MetricHandler::Event::PACKED:
-    return "packed";
-  case MetricHandler::Event::EXECUTION_STARTED:
-    return "exec-started";
-  case MetricHandler::Event::EXECUTION_COMPLETE:
-    return "exec-complete";
-  case MetricHandler::Event::GENERATED:
-    return "generated";
-  case MetricHandler::Event::RECEIVED:
-    return "received";
-  }
-
-  return "unknown";
-}
-
-}  // namespace
+constexpr std::size_t MetricFileHandler::BUFFER_SIZE;
+constexpr std::size_t MetricFileHandler::BATCH_SIZE;
+constexpr uint32_t    MetricFileHandler::FLUSH_INTERVAL;
 
 /**
  * Create a metric file handler with specified filename
  *
  * @param filename The filename of the file to be generated
+ * @param format The format of the file
+ * @param aggregator The (optional) aggregator to be updated with every event
  */
-MetricFileHandler::MetricFileHandler(std::string filename)
+MetricFileHandler::MetricFileHandler(std::string filename, Format format,
+                                     MetricAggregator *aggregator)
   : filename_(std::move(filename))
-  , stack_{}
+  , format_{format}
+  , aggregator_{aggregator}
+  , slots_{new Slot[BUFFER_SIZE]}
   , active_{true}
-  , worker_{&MetricFileHandler::ThreadEntryPoint, this}
 {
-  FETCH_LOCK(stack_lock_);
-  stack_.reserve(BUFFER_SIZE);
+  for (std::size_t i = 0; i < BUFFER_SIZE; ++i)
+  {
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  worker_ = std::thread{&MetricFileHandler::ThreadEntryPoint, this};
 }
 
 /**
@@ -107,8 +60,8 @@ MetricFileHandler::~MetricFileHandler()
   active_ = false;
 
   {
-    FETCH_LOCK(stack_lock_);
-    stack_notify_.notify_all();
+    FETCH_LOCK(worker_lock_);
+    worker_notify_.notify_all();
   }
 
   worker_.join();
@@ -126,10 +79,87 @@ MetricFileHandler::~MetricFileHandler()
 void MetricFileHandler::RecordMetric(ConstByteArray const &identifier, Instrument instrument,
                                      Event event, Timestamp const &timestamp)
 {
-  // add the entry to the stack
-  FETCH_LOCK(stack_lock_);
-  stack_.emplace_back(Entry{identifier, instrument, event, timestamp});
-  stack_notify_.notify_all();
+  uint64_t index = write_index_.load(std::memory_order_relaxed);
+
+  // claim the next free slot of the buffer
+  for (;;)
+  {
+    Slot &         slot     = slots_[index % BUFFER_SIZE];
+    uint64_t const sequence = slot.sequence.load(std::memory_order_acquire);
+
+    if (sequence == index)
+    {
+      if (write_index_.compare_exchange_weak(index, index + 1, std::memory_order_relaxed))
+      {
+        slot.record = CreateMetricRecord(identifier, instrument, event, timestamp);
+        slot.sequence.store(index + 1, std::memory_order_release);
+        return;
+      }
+    }
+    else if (sequence < index)
+    {
+      // the buffer is full, the worker has not yet flushed the slot
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    else
+    {
+      index = write_index_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+/**
+ * Get the number of events which were dropped because the buffer was full
+ *
+ * @return The number of events
+ */
+uint64_t MetricFileHandler::dropped() const
+{
+  return dropped_.load(std::memory_order_relaxed);
+}
+
+/**
+ * Internal: Pass all the completed records in the buffer to the writer, in batches
+ *
+ * @param writer The callable which is passed each batch of records
+ * @return true if any records were drained, otherwise false
+ */
+template <typename Writer>
+bool MetricFileHandler::Drain(Writer &&writer)
+{
+  std::vector<MetricRecord> batch;
+  batch.reserve(BATCH_SIZE);
+
+  bool drained{false};
+  for (;;)
+  {
+    Slot &slot = slots_[read_index_ % BUFFER_SIZE];
+
+    bool const available = slot.sequence.load(std::memory_order_acquire) == (read_index_ + 1);
+    if (available)
+    {
+      batch.push_back(slot.record);
+
+      // release the slot for the producers
+      slot.sequence.store(read_index_ + BUFFER_SIZE, std::memory_order_release);
+      ++read_index_;
+    }
+
+    if ((!available && !batch.empty()) || (batch.size() == BATCH_SIZE))
+    {
+      writer(batch);
+      batch.clear();
+      drained = true;
+    }
+
+    if (!available)
+    {
+      break;
+    }
+  }
+
+  return drained;
 }
 
 /**
@@ -137,37 +167,70 @@ void MetricFileHandler::RecordMetric(ConstByteArray const &identifier, Instrumen
  */
 void MetricFileHandler::ThreadEntryPoint()
 {
-  // create the output file stream
-  std::ofstream output_file(filename_.c_str());
+  bool const binary = format_ == Format::BINARY;
 
-  // write out the CSV header
-  output_file << "Timestamp,Instrument,Event,Identifier" << std::endl;
+  // create the output file stream
+  std::ofstream output_file(filename_.c_str(), binary ? std::ios::out | std::ios::binary
+                                                      : std::ios::out);
 
-  // main processing loop
-  Entry current;
-  while (active_)
+  if (binary)
   {
-    // extract an entry from the stack or wait for one to be available
-    {
-      std::unique_lock<std::mutex> lock(stack_lock_);
+    WriteHeader(output_file);
+  }
+  else
+  {
+    WriteCsvHeader(output_file);
+  }
 
-      // if the stack is empty
-      if (stack_.empty())
+  auto const write = [this, binary, &output_file](std::vector<MetricRecord> const &batch) {
+    if (binary)
+    {
+      output_file.write(reinterpret_cast<char const *>(batch.data()),
+                        static_cast<std::streamsize>(batch.size() * sizeof(MetricRecord)));
+    }
+    else
+    {
+      for (auto const &record : batch)
       {
-        stack_notify_.wait(lock);
-        continue;
+        WriteCsvRecord(output_file, record);
       }
-      else
+    }
+
+    if (aggregator_)
+    {
+      for (auto const &record : batch)
       {
-        // must have more than one entry
-        current = stack_.back();
-        stack_.pop_back();
+        aggregator_->Update(record);
       }
     }
-    // generate the CSV entry
-    output_file << current.timestamp.time_since_epoch().count() << ','
-                << ToString(current.instrument) << ',' << ToString(current.event) << ','
-                << ToBase64(current.identifier) << std::endl;
+  };
+
+  // main processing loop
+  uint64_t reported_drops{0};
+  bool     running{true};
+  while (running)
+  {
+    // flush all the outstanding events once the handler is stopped
+    running = active_;
+
+    if (Drain(write))
+    {
+      output_file.flush();
+    }
+
+    if (aggregator_)
+    {
+      uint64_t const drops = dropped();
+      aggregator_->AddDropped(drops - reported_drops);
+      reported_drops = drops;
+    }
+
+    if (running)
+    {
+      std::unique_lock<std::mutex> lock(worker_lock_);
+      worker_notify_.wait_for(lock, std::chrono::milliseconds{FLUSH_INTERVAL},
+                              [this]() { return !active_; });
+    }
   }
 }
 
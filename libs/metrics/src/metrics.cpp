@@ -28,9 +28,13 @@ Metrics &Metrics::Instance()
   return instance;
 }
 
-void Metrics::ConfigureFileHandler(std::string filename)
+void Metrics::ConfigureFileHandler(std::string filename, FileFormat format)
 {
-  std::unique_ptr<MetricHandler> new_handler(new MetricFileHandler(std::move(filename)));
+  // only a single handler may update the aggregator at a time
+  RemoveMetricHandler();
+
+  std::unique_ptr<MetricHandler> new_handler(
+      new MetricFileHandler(std::move(filename), format, &aggregator_));
 
   handler_.store(new_handler.get());
   handler_object_ = std::move(new_handler);
@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "metrics/process_metrics.hpp"
+
+#if defined(FETCH_PLATFORM_LINUX)
+#include <fstream>
+#include <unistd.h>
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace fetch {
+namespace metrics {
+
+/**
+ * Read the current statistics of the allocator and the resident size of the process
+ *
+ * @return The statistics
+ */
+AllocatorStats AllocatorStats::Read()
+{
+  AllocatorStats stats{};
+
+#if defined(__GLIBC__)
+#if (__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 33))
+  struct mallinfo2 const info = mallinfo2();
+#else
+  // the fields of the older interface wrap once the heap exceeds 2GB
+  struct mallinfo const info = mallinfo();
+#endif
+
+  stats.arena_bytes      = static_cast<uint64_t>(info.arena);
+  stats.mmap_bytes       = static_cast<uint64_t>(info.hblkhd);
+  stats.in_use_bytes     = static_cast<uint64_t>(info.uordblks) + stats.mmap_bytes;
+  stats.free_bytes       = static_cast<uint64_t>(info.fordblks);
+  stats.releasable_bytes = static_cast<uint64_t>(info.keepcost);
+#endif
+
+#if defined(FETCH_PLATFORM_LINUX)
+  // the second field is the number of resident pages
+  std::ifstream statm{"/proc/self/statm"};
+  uint64_t      size_pages{0};
+  uint64_t      resident_pages{0};
+  if (statm >> size_pages >> resident_pages)
+  {
+    stats.resident_bytes = resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  }
+#endif
+
+  return stats;
+}
+
+/**
+ * @return The fraction of the heap held by the allocator which is not in use
+ */
+double AllocatorStats::fragmentation() const
+{
+  uint64_t const held = in_use_bytes + free_bytes;
+
+  return (held) ? static_cast<double>(free_bytes) / static_cast<double>(held) : 0.0;
+}
+
+}  // namespace metrics
+}  // namespace fetch
@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "metrics/rpc_metrics.hpp"
+
+namespace fetch {
+namespace metrics {
+
+/**
+ * Clear all of the RPC instruments
+ */
+void RpcCallMetrics::Reset()
+{
+  calls     = 0;
+  succeeded = 0;
+  failed    = 0;
+  timeouts  = 0;
+  latency.Reset();
+}
+
+RpcMetrics &RpcMetrics::Instance()
+{
+  static RpcMetrics instance;
+  return instance;
+}
+
+/**
+ * Lookup (or create) the instruments for an RPC
+ *
+ * @param protocol The protocol identifier of the call
+ * @param function The function identifier of the call
+ * @return The instruments for the RPC
+ */
+RpcCallMetrics &RpcMetrics::Call(ProtocolId protocol, FunctionId function)
+{
+  std::lock_guard<Mutex> guard(lock_);
+
+  auto &metrics = calls_[Key{protocol, function}];
+  if (!metrics)
+  {
+    metrics = std::make_unique<RpcCallMetrics>();
+  }
+
+  return *metrics;
+}
+
+/**
+ * Clear the samples of all registered instruments
+ */
+void RpcMetrics::Reset()
+{
+  std::lock_guard<Mutex> guard(lock_);
+
+  for (auto &element : calls_)
+  {
+    element.second->Reset();
+  }
+}
+
+}  // namespace metrics
+}  // namespace fetch
@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "metrics/storage_metrics.hpp"
+
+namespace fetch {
+namespace metrics {
+
+/**
+ * Clear all of the stack instruments
+ */
+void StackMetrics::Reset()
+{
+  cache_hits    = 0;
+  cache_misses  = 0;
+  bytes_read    = 0;
+  bytes_written = 0;
+  flush_latency.Reset();
+}
+
+/**
+ * @return The fraction of the reads which were served from the cache
+ */
+double StackMetrics::cache_hit_ratio() const
+{
+  auto const hits  = cache_hits.load(std::memory_order_relaxed);
+  auto const total = hits + cache_misses.load(std::memory_order_relaxed);
+
+  return (total) ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+}
+
+/**
+ * Clear all of the document store instruments
+ */
+void DocumentStoreMetrics::Reset()
+{
+  commit_latency.Reset();
+  revert_latency.Reset();
+}
+
+StorageMetrics &StorageMetrics::Instance()
+{
+  static StorageMetrics instance;
+  return instance;
+}
+
+/**
+ * Lookup (or create) the instruments for a stack
+ *
+ * @param name The name of the stack, typically its file name
+ * @return The instruments for the stack
+ */
+StackMetrics &StorageMetrics::Stack(std::string const &name)
+{
+  std::lock_guard<Mutex> guard(lock_);
+
+  auto &metrics = stacks_[name];
+  if (!metrics)
+  {
+    metrics = std::make_unique<StackMetrics>();
+  }
+
+  return *metrics;
+}
+
+/**
+ * Lookup (or create) the instruments for a document store
+ *
+ * @param name The name of the document store, typically the file name of its document stack
+ * @return The instruments for the document store
+ */
+DocumentStoreMetrics &StorageMetrics::DocumentStore(std::string const &name)
+{
+  std::lock_guard<Mutex> guard(lock_);
+
+  auto &metrics = stores_[name];
+  if (!metrics)
+  {
+    metrics = std::make_unique<DocumentStoreMetrics>();
+  }
+
+  return *metrics;
+}
+
+/**
+ * Clear the samples of all registered instruments
+ */
+void StorageMetrics::Reset()
+{
+  std::lock_guard<Mutex> guard(lock_);
+
+  for (auto &element : stacks_)
+  {
+    element.second->Reset();
+  }
+
+  for (auto &element : stores_)
+  {
+    element.second->Reset();
+  }
+}
+
+}  // namespace metrics
+}  // namespace fetch
@@ -0,0 +1,623 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "metrics/tracer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+namespace fetch {
+namespace metrics {
+namespace {
+
+/**
+ * Mix the bits of a value (the finaliser of splitmix64)
+ */
+uint64_t Mix(uint64_t value)
+{
+  value = (value ^ (value >> 30u)) * 0xbf58476d1ce4e5b9ull;
+  value = (value ^ (value >> 27u)) * 0x94d049bb133111ebull;
+  return value ^ (value >> 31u);
+}
+
+uint64_t ReadId(uint8_t const *data, std::size_t size)
+{
+  uint64_t value{0};
+  std::memcpy(&value, data, std::min(size, sizeof(value)));
+  return value;
+}
+
+std::string ToHex(uint64_t value)
+{
+  char buffer[17];
+  std::snprintf(buffer, sizeof(buffer), "%016" PRIx64, value);
+  return buffer;
+}
+
+/**
+ * Format a time in nanoseconds as (fractional) microseconds, the unit of the Chrome trace format
+ */
+std::string ToMicros(int64_t nanos)
+{
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%" PRId64 ".%03" PRId64, nanos / 1000, nanos % 1000);
+  return buffer;
+}
+
+}  // namespace
+
+constexpr std::size_t Tracer::BUFFER_SIZE;
+
+/**
+ * The ring buffer of the spans completed by a single thread. Spans are only pushed by the owning
+ * thread and only drained by the collector, each slot is guarded by a sequence number so that the
+ * collector can detect slots which have been overwritten while they were being read.
+ */
+class Tracer::Buffer
+{
+public:
+  explicit Buffer(uint32_t thread)
+    : thread_{thread}
+  {}
+
+  void Push(SpanRecord const &record);
+  bool Drain(SpanRecords &output, uint64_t &dropped);
+
+  void Retire()
+  {
+    retired_ = true;
+  }
+
+private:
+  struct Slot
+  {
+    std::atomic<uint64_t>     sequence{0};  ///< Odd while being written, 2 * (index + 1) when done
+    std::atomic<char const *> name{nullptr};
+    std::atomic<uint64_t>     trace_id{0};
+    std::atomic<uint64_t>     span_id{0};
+    std::atomic<uint64_t>     parent_id{0};
+    std::atomic<int64_t>      start_ns{0};
+    std::atomic<int64_t>      end_ns{0};
+  };
+
+  using Slots = std::array<Slot, BUFFER_SIZE>;
+
+  Slots                 slots_{};
+  std::atomic<uint64_t> head_{0};  ///< The index of the next span to be written
+  uint64_t              tail_{0};  ///< The index of the next span to be collected
+  uint32_t const        thread_;
+  std::atomic<bool>     retired_{false};  ///< Set once the owning thread has exited
+};
+
+/**
+ * Record a completed span, overwriting the oldest span when the buffer is full
+ *
+ * @param record The span to be recorded
+ */
+void Tracer::Buffer::Push(SpanRecord const &record)
+{
+  uint64_t const index = head_.load(std::memory_order_relaxed);
+  Slot &         slot  = slots_[index % BUFFER_SIZE];
+
+  slot.sequence.store((2 * index) + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.name.store(record.name, std::memory_order_relaxed);
+  slot.trace_id.store(record.trace_id, std::memory_order_relaxed);
+  slot.span_id.store(record.span_id, std::memory_order_relaxed);
+  slot.parent_id.store(record.parent_id, std::memory_order_relaxed);
+  slot.start_ns.store(record.start_ns, std::memory_order_relaxed);
+  slot.end_ns.store(record.end_ns, std::memory_order_relaxed);
+
+  slot.sequence.store((2 * index) + 2, std::memory_order_release);
+  head_.store(index + 1, std::memory_order_release);
+}
+
+/**
+ * Collect the spans which have been recorded since the last call
+ *
+ * @param output The list to which the spans are appended
+ * @param dropped The counter of spans which were overwritten before they could be collected
+ * @return true if the buffer is no longer needed, i.e. it is retired and has been drained
+ */
+bool Tracer::Buffer::Drain(SpanRecords &output, uint64_t &dropped)
+{
+  // the retired flag must be read first, so that no span can be pushed after the final drain
+  bool const     retired = retired_;
+  uint64_t const head    = head_.load(std::memory_order_acquire);
+
+  // skip the spans which have already been overwritten
+  if ((head - tail_) > BUFFER_SIZE)
+  {
+    dropped += (head - tail_) - BUFFER_SIZE;
+    tail_ = head - BUFFER_SIZE;
+  }
+
+  for (; tail_ < head; ++tail_)
+  {
+    Slot const &   slot     = slots_[tail_ % BUFFER_SIZE];
+    uint64_t const expected = (2 * tail_) + 2;
+
+    if (slot.sequence.load(std::memory_order_acquire) != expected)
+    {
+      ++dropped;
+      continue;
+    }
+
+    SpanRecord record;
+    record.name      = slot.name.load(std::memory_order_relaxed);
+    record.trace_id  = slot.trace_id.load(std::memory_order_relaxed);
+    record.span_id   = slot.span_id.load(std::memory_order_relaxed);
+    record.parent_id = slot.parent_id.load(std::memory_order_relaxed);
+    record.start_ns  = slot.start_ns.load(std::memory_order_relaxed);
+    record.end_ns    = slot.end_ns.load(std::memory_order_relaxed);
+    record.thread    = thread_;
+
+    // the slot might have been overwritten while it was being read
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != expected)
+    {
+      ++dropped;
+      continue;
+    }
+
+    output.push_back(record);
+  }
+
+  return retired;
+}
+
+Tracer &Tracer::Instance()
+{
+  static Tracer instance;
+  return instance;
+}
+
+Tracer::Tracer()
+{
+  auto const system = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch());
+  auto const steady =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch());
+
+  epoch_offset_ns_ = static_cast<int64_t>(system.count() - steady.count());
+  next_seed_       = static_cast<uint64_t>(system.count());
+}
+
+/**
+ * Configure the sampling of traces
+ *
+ * @param one_in One in this many traces are recorded, zero disables tracing
+ */
+void Tracer::SetSampleRate(uint32_t one_in)
+{
+  sample_rate_ = one_in;
+}
+
+/**
+ * Determine if tracing is enabled
+ *
+ * @return true if enabled, otherwise false
+ */
+bool Tracer::enabled() const
+{
+  return sample_rate_.load(std::memory_order_relaxed) != 0;
+}
+
+/**
+ * Start a span at the root of a new trace
+ *
+ * @param name The (static) name of the span
+ * @return The span, which is inactive if the trace is not sampled
+ */
+Span Tracer::StartSpan(char const *name)
+{
+  if (!enabled())
+  {
+    return {};
+  }
+
+  uint64_t const trace_id = NextId();
+  if (!IsSampled(trace_id))
+  {
+    return {};
+  }
+
+  return Start(name, trace_id, NextId(), 0, Clock::now());
+}
+
+/**
+ * Start a child span of another span
+ *
+ * @param name The (static) name of the span
+ * @param parent The context of the parent span
+ * @param start The start of the span
+ * @return The span, which is inactive if the trace of the parent is not sampled
+ */
+Span Tracer::StartSpan(char const *name, SpanContext const &parent, Timestamp const &start)
+{
+  if (!parent.valid() || !IsSampled(parent.trace_id))
+  {
+    return {};
+  }
+
+  return Start(name, parent.trace_id, NextId(), parent.span_id, start);
+}
+
+/**
+ * Start a span for a stage of the processing of a transaction, as a child of its root span
+ *
+ * @param name The (static) name of the span
+ * @param digest The digest of the transaction
+ * @param start The start of the span
+ * @return The span, which is inactive if the transaction is not sampled
+ */
+Span Tracer::StartTransactionSpan(char const *name, ConstByteArray const &digest,
+                                  Timestamp const &start)
+{
+  if (!enabled())
+  {
+    return {};
+  }
+
+  return StartSpan(name, TransactionContext(digest), start);
+}
+
+/**
+ * Start the root span of the trace of a transaction, typically on its submission to the node
+ *
+ * @param name The (static) name of the span
+ * @param digest The digest of the transaction
+ * @param start The start of the span, for example when the request was received
+ * @return The span, which is inactive if the transaction is not sampled
+ */
+Span Tracer::StartTransactionRootSpan(char const *name, ConstByteArray const &digest,
+                                      Timestamp const &start)
+{
+  if (!enabled())
+  {
+    return {};
+  }
+
+  SpanContext const context = TransactionContext(digest);
+  if (!context.valid() || !IsSampled(context.trace_id))
+  {
+    return {};
+  }
+
+  return Start(name, context.trace_id, context.span_id, 0, start);
+}
+
+/**
+ * Determine the context of the root span of a transaction from its digest
+ *
+ * @param digest The digest of the transaction
+ * @return The context of the root span, which is invalid if the digest is empty
+ */
+SpanContext Tracer::TransactionContext(ConstByteArray const &digest)
+{
+  SpanContext context;
+
+  // a transaction without a digest can not be traced
+  if (digest.empty())
+  {
+    return context;
+  }
+
+  std::size_t const half = std::min(digest.size(), sizeof(uint64_t));
+
+  context.trace_id = ReadId(digest.pointer(), half);
+  context.span_id  = (digest.size() > half)
+                        ? ReadId(digest.pointer() + half, digest.size() - half)
+                        : Mix(context.trace_id);
+
+  // zero identifies an inactive (or missing) span
+  context.trace_id = (context.trace_id != 0) ? context.trace_id : 1;
+  context.span_id  = (context.span_id != 0) ? context.span_id : 1;
+
+  return context;
+}
+
+/**
+ * Collect all the spans which have been completed since the last collection
+ *
+ * @return The spans, in order of their start time
+ */
+Tracer::SpanRecords Tracer::Collect()
+{
+  SpanRecords records;
+  uint64_t    dropped{0};
+
+  {
+    FETCH_LOCK(lock_);
+
+    auto it = buffers_.begin();
+    while (it != buffers_.end())
+    {
+      if ((*it)->Drain(records, dropped))
+      {
+        // the owning thread has exited, no more spans will be recorded
+        it = buffers_.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
+
+  dropped_ += dropped;
+
+  std::sort(records.begin(), records.end(), [](SpanRecord const &a, SpanRecord const &b) {
+    return a.start_ns < b.start_ns;
+  });
+
+  return records;
+}
+
+/**
+ * Get the number of spans which were overwritten before they could be collected
+ *
+ * @return The number of spans
+ */
+uint64_t Tracer::dropped() const
+{
+  return dropped_;
+}
+
+/**
+ * Format spans in the Chrome trace event format (as loaded by chrome://tracing or Perfetto)
+ *
+ * @param records The spans to be formatted
+ * @return The JSON document
+ */
+std::string Tracer::ToChromeTrace(SpanRecords const &records)
+{
+  std::ostringstream oss;
+  oss << R"({"displayTimeUnit":"ns","traceEvents":[)";
+
+  bool first{true};
+  for (auto const &record : records)
+  {
+    if (!first)
+    {
+      oss << ',';
+    }
+    first = false;
+
+    oss << R"({"name":")" << record.name << R"(","cat":"fetch","ph":"X","ts":)"
+        << ToMicros(record.start_ns) << R"(,"dur":)" << ToMicros(record.end_ns - record.start_ns)
+        << R"(,"pid":1,"tid":)" << record.thread << R"(,"args":{"trace_id":")"
+        << ToHex(record.trace_id) << R"(","span_id":")" << ToHex(record.span_id)
+        << R"(","parent_id":")" << ToHex(record.parent_id) << R"("}})";
+  }
+
+  oss << "]}";
+  return oss.str();
+}
+
+/**
+ * Format spans as an OpenTelemetry (OTLP/HTTP JSON) trace export request
+ *
+ * @param records The spans to be formatted
+ * @param service_name The name of the service reported in the resource
+ * @return The JSON document
+ */
+std::string Tracer::ToOtlpJson(SpanRecords const &records, std::string const &service_name)
+{
+  std::ostringstream oss;
+  oss << R"({"resourceSpans":[{"resource":{"attributes":[{"key":"service.name","value":)"
+      << R"({"stringValue":")" << service_name << R"("}}]},"scopeSpans":[{"scope":)"
+      << R"({"name":"fetch.metrics.tracer"},"spans":[)";
+
+  bool first{true};
+  for (auto const &record : records)
+  {
+    if (!first)
+    {
+      oss << ',';
+    }
+    first = false;
+
+    // trace ids are 128 bits in OTLP
+    oss << R"({"traceId":")" << ToHex(0) << ToHex(record.trace_id) << R"(","spanId":")"
+        << ToHex(record.span_id) << '"';
+
+    if (record.parent_id != 0)
+    {
+      oss << R"(,"parentSpanId":")" << ToHex(record.parent_id) << '"';
+    }
+
+    oss << R"(,"name":")" << record.name << R"(","kind":1,"startTimeUnixNano":")"
+        << record.start_ns << R"(","endTimeUnixNano":")" << record.end_ns
+        << R"(","attributes":[{"key":"thread.id","value":{"intValue":")" << record.thread
+        << R"("}}]})";
+  }
+
+  oss << "]}]}]}";
+  return oss.str();
+}
+
+/**
+ * Internal: Determine if a trace is sampled
+ *
+ * @param trace_id The id of the trace
+ * @return true if sampled, otherwise false
+ */
+bool Tracer::IsSampled(uint64_t trace_id) const
+{
+  uint32_t const rate = sample_rate_.load(std::memory_order_relaxed);
+  return (rate != 0) && ((Mix(trace_id) % rate) == 0);
+}
+
+/**
+ * Internal: Generate a new (non zero) span or trace id, without synchronising with other threads
+ *
+ * @return The new id
+ */
+uint64_t Tracer::NextId()
+{
+  thread_local uint64_t state = next_seed_.fetch_add(0x9e3779b97f4a7c15ull);
+
+  uint64_t id{0};
+  while (id == 0)
+  {
+    state += 0x9e3779b97f4a7c15ull;
+    id = Mix(state);
+  }
+
+  return id;
+}
+
+/**
+ * Internal: Start an active span
+ */
+Span Tracer::Start(char const *name, uint64_t trace_id, uint64_t span_id, uint64_t parent_id,
+                   Timestamp const &start)
+{
+  return {*this, name, trace_id, span_id, parent_id, start};
+}
+
+/**
+ * Internal: Record a completed span into the buffer of the current thread
+ *
+ * @param span The span which has ended
+ * @param end The end time of the span
+ */
+void Tracer::Record(Span const &span, Timestamp const &end)
+{
+  SpanRecord record;
+  record.name      = span.name_;
+  record.trace_id  = span.trace_id_;
+  record.span_id   = span.span_id_;
+  record.parent_id = span.parent_id_;
+  record.start_ns  = ToUnixNanos(span.start_);
+  record.end_ns    = ToUnixNanos(end);
+
+  LocalBuffer().Push(record);
+}
+
+/**
+ * Internal: Lookup (or create) the buffer of the current thread
+ *
+ * @return The buffer of the current thread
+ */
+Tracer::Buffer &Tracer::LocalBuffer()
+{
+  // the buffer is retired when the thread exits, the spans it holds can still be collected
+  struct Holder
+  {
+    BufferPtr buffer;
+
+    ~Holder()
+    {
+      if (buffer)
+      {
+        buffer->Retire();
+      }
+    }
+  };
+
+  thread_local Holder holder;
+
+  if (!holder.buffer)
+  {
+    holder.buffer = std::make_shared<Buffer>(next_thread_++);
+
+    FETCH_LOCK(lock_);
+    buffers_.push_back(holder.buffer);
+  }
+
+  return *holder.buffer;
+}
+
+int64_t Tracer::ToUnixNanos(Timestamp const &timestamp) const
+{
+  auto const nanos =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch());
+  return static_cast<int64_t>(nanos.count()) + epoch_offset_ns_;
+}
+
+/**
+ * Internal: Construct an active span
+ */
+Span::Span(Tracer &tracer, char const *name, uint64_t trace_id, uint64_t span_id,
+           uint64_t parent_id, Timestamp const &start)
+  : tracer_{&tracer}
+  , name_{name}
+  , trace_id_{trace_id}
+  , span_id_{span_id}
+  , parent_id_{parent_id}
+  , start_{start}
+{}
+
+Span::Span(Span &&other) noexcept
+  : tracer_{other.tracer_}
+  , name_{other.name_}
+  , trace_id_{other.trace_id_}
+  , span_id_{other.span_id_}
+  , parent_id_{other.parent_id_}
+  , start_{other.start_}
+{
+  other.tracer_ = nullptr;
+}
+
+Span::~Span()
+{
+  End();
+}
+
+/**
+ * End the span, recording it if it is active. Only the first call has any effect.
+ *
+ * @param end The end time of the span
+ */
+void Span::End(Timestamp const &end)
+{
+  if (tracer_ != nullptr)
+  {
+    tracer_->Record(*this, end);
+    tracer_ = nullptr;
+  }
+}
+
+Span &Span::operator=(Span &&other) noexcept
+{
+  if (this != &other)
+  {
+    End();
+
+    tracer_    = other.tracer_;
+    name_      = other.name_;
+    trace_id_  = other.trace_id_;
+    span_id_   = other.span_id_;
+    parent_id_ = other.parent_id_;
+    start_     = other.start_;
+
+    other.tracer_ = nullptr;
+  }
+
+  return *this;
+}
+
+}  // namespace metrics
+}  // namespace fetch
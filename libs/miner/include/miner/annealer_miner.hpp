@@ -24,6 +24,7 @@
 #include "miner/transaction_item.hpp"
 
 #include <iostream>
+#include <thread>
 
 namespace fetch {
 namespace miner {
@@ -102,8 +103,9 @@ private:
   {
     using Strategy = generator_type::Strategy;
 
-    // configure the solver
-    generator_.ConfigureAnnealer(100, 0.1, 3.0);
+    // configure the solver, with a parallel tempering replica per core
+    std::size_t const num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    generator_.ConfigureAnnealer(100, 0.1, 3.0, num_threads, num_threads);
 
     // TODO(issue 7):  Move to configuration variables
     std::size_t const batch_size =
@@ -22,32 +22,48 @@
 #include "ledger/chain/block.hpp"
 #include "ledger/chain/transaction.hpp"
 #include "meta/is_log2.hpp"
-#include "miner/optimisation/bitvector.hpp"
+#include "miner/mempool.hpp"
 #include "vectorise/threading/pool.hpp"
+
+#include <atomic>
 #include <list>
+#include <set>
+#include <thread>
+#include <vector>
 
 namespace fetch {
 namespace miner {
 
 /**
- * Simplistic greedy search algorithm for generating / packing blocks. Has rudimentary support to
- * parallelise the packing over a number of threads.
+ * Simplistic greedy search algorithm for generating / packing blocks.
+ *
+ * Internally the miner maintains a pending queue, which is populated when a new transaction is
+ * added to the miner, and a mempool. When block generation begins, the pending queue is moved into
+ * the mempool from which each slice is filled with the highest fee transactions which do not
+ * collide. Only the pending queue is locked, so transactions can be added during packing.
  *
- * Internally the miner maintains 2 queues. One which is the pending queue which is populated when
- * a new transaction is added to the miner. When block generation begins, this pending queue is
- * transferred to the main queue when it is evaluated in order to generate new blocks. During this
- * operation the main queue is locked.
+ * The mempool is split into shards by the lowest lane of each transaction. The shards fill every
+ * slice independently (in parallel when the backlog is large enough), after which the selections
+ * are merged in fee order. The transactions which collide with a higher fee transaction of another
+ * shard are returned to their shard and the remaining space is then topped up.
  */
 class BasicMiner : public ledger::BlockPackerInterface
 {
 public:
   static constexpr char const *LOGGING_NAME = "BasicMiner";
 
+  /// The number of times a block is topped up after replayed transactions are removed from it
+  static constexpr std::size_t MAX_REPACK_ROUNDS = 3;
+
+  /// The (average) number of transactions per shard above which the shards are packed in parallel
+  static constexpr std::size_t PARALLEL_PACKING_THRESHOLD = 1000;
+
   using Block     = ledger::Block;
   using MainChain = ledger::MainChain;
 
   // Construction / Destruction
-  explicit BasicMiner(uint32_t log2_num_lanes, uint32_t num_slices);
+  BasicMiner(uint32_t log2_num_lanes, uint32_t num_slices,
+             std::size_t num_threads = std::thread::hardware_concurrency());
   BasicMiner(BasicMiner const &) = delete;
   BasicMiner(BasicMiner &&)      = delete;
   ~BasicMiner()                  = default;
@@ -55,6 +71,7 @@ public:
   /// @name Miner Interface
   /// @{
   void EnqueueTransaction(ledger::TransactionSummary const &tx) override;
+  void EnqueueTransactions(TransactionSummaries const &txs) override;
   void GenerateBlock(Block &block, std::size_t num_lanes, std::size_t num_slices,
                      MainChain const &chain) override;
   /// @}
@@ -70,39 +87,52 @@ public:
   BasicMiner &operator=(BasicMiner &&) = delete;
 
 private:
-  using BitVector = bitmanip::BitVector;
-
-  struct TransactionEntry
+  /// A transaction packed into the block, in the form expected by the duplicate check of the chain
+  struct PackedEntry
   {
-    BitVector                  resources;
     ledger::TransactionSummary transaction;
+    std::size_t                slice;
+    Mempool::Lanes             lanes;
+  };
 
-    TransactionEntry(ledger::TransactionSummary const &summary, uint32_t log2_num_lanes);
-    ~TransactionEntry() = default;
+  /// The transactions selected by a shard for one of the slices, along with their lanes
+  struct Selection
+  {
+    Block::Slice      transactions;
+    Mempool::LaneList lanes;
   };
 
-  using Mutex           = mutex::Mutex;
-  using TransactionList = std::list<TransactionEntry>;
-  using TransactionSet  = std::set<ledger::TransactionSummary>;
-  using ThreadPool      = threading::Pool;
-
-  static void GenerateSlices(TransactionList &tx, Block::Body &block, std::size_t offset,
-                             std::size_t interval, std::size_t num_lanes);
-  static void GenerateSlice(TransactionList &tx, Block::Slice &slice, std::size_t slice_index,
-                            std::size_t num_lanes);
-
-  static bool SortByFee(TransactionEntry const &a, TransactionEntry const &b);
-
-  uint32_t       log2_num_lanes_;                    ///< The log2 of the number of lanes
-  uint32_t const max_num_threads_;                   ///< The configured maximum number of threads
-  ThreadPool     thread_pool_;                       ///< The thread pool used to dispatch work
-  mutable Mutex  pending_lock_{__LINE__, __FILE__};  ///< The lock for the pending transaction queue
-  TransactionList pending_;                          ///< The pending transaction queue
-  TransactionSet  txs_seen_;                         ///< The transactions seen so far
-  std::size_t     main_queue_size_{0};               ///< The thread safe main queue size
-  TransactionList main_queue_;                       ///< The main transaction queue
-  bool            filtering_input_duplicates_{
-      true};  ///< Whether duplicate transactions are filtered on entry to the packer
+  using Mutex          = mutex::Mutex;
+  using PendingQueue   = std::vector<ledger::TransactionSummary>;
+  using TransactionSet = std::set<ledger::TransactionSummary>;
+  using Shards         = std::vector<Mempool>;
+  using ShardSelection = std::vector<Selection>;
+  using Selections     = std::vector<ShardSelection>;
+  using Occupancies    = std::vector<LaneOccupancy>;
+  using PackedList     = std::list<PackedEntry>;
+  using SliceIndices   = std::set<std::size_t>;
+  using ThreadPool     = threading::Pool;
+
+  void         EnqueueLocked(ledger::TransactionSummary const &tx);
+  std::size_t  ShardOf(Mempool::Lanes const &lanes) const;
+  std::size_t  BacklogSize() const;
+  void         SelectFromShard(std::size_t shard, ShardSelection &selection,
+                               std::size_t num_lanes);
+  void         MergeSelections(Block &block, Occupancies &occupancies, Selections &selections,
+                               PackedList &packed);
+  void         FillSlice(Block &block, std::size_t slice_index, Occupancies &occupancies,
+                         PackedList &packed);
+  SliceIndices RemoveReplayedTransactions(Block &block, Occupancies &occupancies,
+                                          PackedList &packed, MainChain const &chain);
+
+  uint32_t      log2_num_lanes_;                    ///< The log2 of the number of lanes
+  mutable Mutex pending_lock_{__LINE__, __FILE__};  ///< The lock for the pending transaction queue
+  PendingQueue  pending_;                           ///< The pending transaction queue
+  TransactionSet           txs_seen_;               ///< The transactions seen so far
+  Shards                   shards_;                 ///< The transactions waiting to be packed
+  std::atomic<std::size_t> mempool_size_{0};        ///< The thread safe mempool size
+  ThreadPool               thread_pool_;            ///< The threads filling the shards in parallel
+  bool filtering_input_duplicates_{true};  ///< Whether duplicate transactions are filtered on entry
 };
 
 }  // namespace miner
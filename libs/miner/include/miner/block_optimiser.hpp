@@ -92,18 +92,24 @@ public:
    * @sweeps is the number of sweeps done by the annealer.
    * @b0 is the initial inverse temperature.
    * @b1 is the final inverse temperature.
+   * @replicas is the number of parallel tempering replicas, one for a
+   * single annealing chain.
+   * @threads is the number of threads over which the replicas are run.
    *
    * We define a sweep as one attempted variable update for every binary
    * variable in the problem considered. Normally the optimal amount of
    * sweeps depends on the problem size (i.e. the number of lanes and
    * the batch size). Likewise the inverse temperatures are likely to
-   * change as the problem is changing.
+   * change as the problem is changing. With parallel tempering the
+   * replicas sample at fixed temperatures between b0 and b1.
    */
-  void ConfigureAnnealer(std::size_t const &sweeps, double const &b0, double const &b1)
+  void ConfigureAnnealer(std::size_t const &sweeps, double const &b0, double const &b1,
+                         std::size_t const &replicas = 1, std::size_t const &threads = 1)
   {
     annealer_.SetSweeps(sweeps);
     annealer_.SetBetaStart(b0);
     annealer_.SetBetaEnd(b1);
+    annealer_.SetReplicas(replicas, threads);
   }
 
   /* Generates the next block.
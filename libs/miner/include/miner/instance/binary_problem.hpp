@@ -17,21 +17,40 @@
 //
 //------------------------------------------------------------------------------
 
-#include "math/tensor.hpp"
-#include <memory/shared_array.hpp>
-#include <unordered_set>
+#include "vectorise/memory/shared_array.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
 #include <vector>
+
 namespace fetch {
 namespace optimisers {
+
+/**
+ * A quadratic binary problem, with the energy of a state x given by
+ *
+ *   E(x) = sum_i Q_ii x_i + sum_i<j Q_ij x_i x_j
+ *
+ * The couplings are collected as they are inserted and then indexed in a compressed sparse row
+ * layout. Once a state has been set, the local field of each spin (the change in energy of
+ * switching it on) is cached, so that the energy change of a flip is available immediately and a
+ * flip only updates the fields of its neighbours.
+ */
 class BinaryProblem
 {
 public:
-  using cost_type = double;
+  using cost_type  = double;
+  using spin_type  = int16_t;
+  using state_type = std::vector<spin_type>;
+
   void Reset()
   {
-    for (std::size_t i = 0; i < couplings_.size(); ++i)
+    for (std::size_t i = 0; i < diagonal_.size(); ++i)
     {
-      couplings_[i] = 0.;
+      diagonal_[i] = 0.;
     }
     for (std::size_t i = 0; i < coupling_sum_.size(); ++i)
     {
@@ -46,11 +65,13 @@ public:
     energy_offset_          = 0;
     max_abs_coupling_       = 0.0;
     normalisation_constant_ = 1.0;
+
+    ClearIndex();
   }
 
-  void Resize(std::size_t const &n, std::size_t const &max_connectivity = std::size_t(-1))
+  void Resize(std::size_t const &n, std::size_t const & /*max_connectivity*/ = std::size_t(-1))
   {
-    couplings_.Resize(n, n);
+    diagonal_     = memory::SharedArray<cost_type>(n);
     coupling_sum_ = memory::SharedArray<cost_type>(n);
 
     couples_to_.resize(n);
@@ -70,21 +91,15 @@ public:
       B = i;
     }
 
-    if (couples_to_[A].find(B) != couples_to_[A].end())
-    {
-      return false;
-    }
-    if (couplings_(A, B) != 0.)
-    {
-      return false;
-    }
-
-    couplings_.Set(A, B, c);
-
     if (A != B)
     {
-      couples_to_[A].insert(B);
-      couples_to_[B].insert(A);
+      if (couples_to_[A].find(B) != couples_to_[A].end())
+      {
+        return false;
+      }
+
+      couples_to_[A][B] = c;
+      couples_to_[B][A] = c;
 
       coupling_sum_[A] += c;
       coupling_sum_[B] += c;
@@ -102,28 +117,39 @@ public:
     }
     else
     {
+      if (diagonal_[A] != 0.)
+      {
+        return false;
+      }
+
+      diagonal_[A] = c;
       energy_offset_ += c / 2.;
     }
 
+    // the index is rebuilt when it is next needed
+    ClearIndex();
+
     return true;
   }
 
   template <typename T>
   void ProgramSpinGlassSolver(T &annealer, bool normalise = true)
   {
+    BuildIndex();
+
     std::size_t max_conn = MaxConnectivity();
     annealer.Resize(size_, max_conn);
 
     for (std::size_t i = 0; i < size_; ++i)
     {
-      cost_type field = -0.5 * (couplings_(i, i) + 0.5 * coupling_sum_[i]);
+      cost_type field = -0.5 * (diagonal_[i] + 0.5 * coupling_sum_[i]);
       cost_type ff    = field < 0 ? -field : field;
       if (ff > max_abs_coupling_)
       {
         max_abs_coupling_ = ff;
       }
     }
-    normalisation_constant_ = 1. / max_abs_coupling_ / max_conn;
+    normalisation_constant_ = 1. / max_abs_coupling_ / cost_type(max_conn);
 
     if (!normalise)
     {
@@ -132,20 +158,110 @@ public:
 
     for (std::size_t i = 0; i < size_; ++i)
     {
-      cost_type field = -0.5 * (couplings_(i, i) + 0.5 * coupling_sum_[i]);
+      cost_type field = -0.5 * (diagonal_[i] + 0.5 * coupling_sum_[i]);
 
       annealer.Insert(i, i, normalisation_constant_ * field);
 
-      for (std::size_t j = i + 1; j < size_; ++j)
+      // the columns of each row are sorted, so only the upper triangle is visited
+      for (std::size_t k = row_offsets_[i]; k < row_offsets_[i + 1]; ++k)
+      {
+        if (columns_[k] > i)
+        {
+          annealer.Insert(i, columns_[k], normalisation_constant_ * 0.25 * values_[k]);
+        }
+      }
+    }
+  }
+
+  /// @name Incremental Evaluation
+  /// @{
+
+  /**
+   * Set the current state and compute the local field of each spin. Costs O(n + nnz).
+   *
+   * @param state The value (0 or 1) of each of the spins
+   */
+  void SetState(state_type const &state)
+  {
+    assert(state.size() == size_);
+
+    BuildIndex();
+
+    state_  = state;
+    energy_ = 0;
+
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+      fields_[i] = diagonal_[i];
+    }
+
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+      if (state_[i] == 0)
+      {
+        continue;
+      }
+
+      // each pair of spins is only counted once in the energy
+      energy_ += diagonal_[i];
+      for (std::size_t k = row_offsets_[i]; k < row_offsets_[i + 1]; ++k)
       {
-        if (couplings_(i, j) != 0)
+        fields_[columns_[k]] += values_[k];
+        if ((columns_[k] > i) && (state_[columns_[k]] != 0))
         {
-          annealer.Insert(i, j, normalisation_constant_ * 0.25 * couplings_(i, j));
+          energy_ += values_[k];
         }
       }
     }
   }
 
+  /**
+   * The energy change of flipping a spin of the current state. Costs O(1).
+   */
+  cost_type DeltaEnergy(std::size_t const &i) const
+  {
+    assert(indexed_ && (i < state_.size()));
+    return (state_[i] != 0) ? -fields_[i] : fields_[i];
+  }
+
+  /**
+   * Flip a spin of the current state, updating the fields of its neighbours. Costs O(degree).
+   *
+   * @param i The index of the spin
+   * @return The change in the energy
+   */
+  cost_type Flip(std::size_t const &i)
+  {
+
+    cost_type const delta = DeltaEnergy(i);
+    cost_type const sign  = (state_[i] != 0) ? -1. : 1.;
+
+    state_[i] = spin_type(1 - state_[i]);
+    energy_ += delta;
+
+    for (std::size_t k = row_offsets_[i]; k < row_offsets_[i + 1]; ++k)
+    {
+      fields_[columns_[k]] += sign * values_[k];
+    }
+
+    return delta;
+  }
+
+  /**
+   * The energy of the current state, excluding the offset
+   */
+  cost_type energy() const
+  {
+    return energy_;
+  }
+
+  state_type const &state() const
+  {
+    return state_;
+  }
+
+  /// @}
+
   std::size_t MaxConnectivity() const
   {
     std::size_t max_connectivity = 0;
@@ -160,13 +276,20 @@ public:
     return max_connectivity;
   }
 
-  cost_type energy_offset() const
+  cost_type coupling(std::size_t const &i, std::size_t const &j) const
   {
-    return energy_offset_;
+    if (i == j)
+    {
+      return diagonal_[i];
+    }
+
+    auto const it = couples_to_[i].find(j);
+    return (it == couples_to_[i].end()) ? 0. : it->second;
   }
-  math::Tensor<cost_type> const &couplings() const
+
+  cost_type energy_offset() const
   {
-    return couplings_;
+    return energy_offset_;
   }
   std::size_t const &size() const
   {
@@ -184,15 +307,80 @@ public:
   }
 
 private:
+  using Offsets = std::vector<std::size_t>;
+  using Columns = std::vector<uint64_t>;
+  using Values  = std::vector<cost_type>;
+
+  /**
+   * Build the compressed sparse row index of the (symmetric) off diagonal couplings, with the
+   * columns of each row sorted
+   */
+  void BuildIndex()
+  {
+    if (indexed_)
+    {
+      return;
+    }
+
+    row_offsets_.assign(size_ + 1, 0);
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+      row_offsets_[i + 1] = row_offsets_[i] + couples_to_[i].size();
+    }
+
+    columns_.resize(row_offsets_[size_]);
+    values_.resize(row_offsets_[size_]);
+
+    std::vector<std::pair<uint64_t, cost_type>> row;
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+      row.assign(couples_to_[i].begin(), couples_to_[i].end());
+      std::sort(row.begin(), row.end());
+
+      std::size_t k = row_offsets_[i];
+      for (auto const &entry : row)
+      {
+        columns_[k] = entry.first;
+        values_[k]  = entry.second;
+        ++k;
+      }
+    }
+
+    fields_.assign(size_, 0.);
+    state_.assign(size_, 0);
+    energy_  = 0;
+    indexed_ = true;
+
+    // the fields of the (all zero) state are the diagonal
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+      fields_[i] = diagonal_[i];
+    }
+  }
+
+  void ClearIndex()
+  {
+    indexed_ = false;
+  }
+
   std::size_t size_          = 0;
   cost_type   energy_offset_ = 0;
 
   cost_type max_abs_coupling_       = 0.0;
   cost_type normalisation_constant_ = 1.0;
 
-  std::vector<std::unordered_set<uint64_t>> couples_to_;
-  Tensor<cost_type>                         couplings_;
-  memory::SharedArray<cost_type>            coupling_sum_;
+  std::vector<std::unordered_map<uint64_t, cost_type>> couples_to_;  ///< Off diagonal couplings
+  memory::SharedArray<cost_type>                        diagonal_;
+  memory::SharedArray<cost_type>                        coupling_sum_;
+
+  bool    indexed_{false};  ///< Whether the sparse index is up to date with the couplings
+  Offsets row_offsets_;     ///< The start of each row in the columns and values
+  Columns columns_;         ///< The column of each coupling, sorted within each row
+  Values  values_;          ///< The value of each coupling
+
+  state_type state_;       ///< The current state
+  Values     fields_;      ///< The energy change of switching on each spin of the current state
+  cost_type  energy_ = 0;  ///< The energy of the current state
 };
 }  // namespace optimisers
 }  // namespace fetch
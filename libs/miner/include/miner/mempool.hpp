@@ -0,0 +1,131 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/chain/block.hpp"
+#include "ledger/chain/transaction.hpp"
+#include "ledger/lane_bitmap.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+namespace fetch {
+namespace miner {
+
+/**
+ * The lanes which are used by the transactions of a slice. The lanes beyond the number of lanes of
+ * the slice are permanently marked as occupied, so that a collision is a single bitmap check.
+ */
+class LaneOccupancy
+{
+public:
+  using Lanes = ledger::LaneBitmap;
+
+  explicit LaneOccupancy(std::size_t num_lanes);
+
+  bool Collides(Lanes const &lanes) const;
+  void Occupy(Lanes const &lanes);
+  void Release(Lanes const &lanes);
+
+  bool IsOccupied(uint32_t lane) const;
+  bool full() const;
+
+private:
+  Lanes       occupied_;  ///< The occupied lanes, including those outside of the slice
+  std::size_t num_lanes_;
+  std::size_t num_occupied_{0};
+};
+
+/**
+ * An indexed pool of the transactions waiting to be packed into a block.
+ *
+ * Transactions are grouped by the lowest lane that they use, and each group is kept as a heap
+ * ordered by fee (and then by arrival). When a slice is filled only the groups whose lowest lane
+ * is still free are considered, so the cost of packing depends on the number of transactions
+ * selected rather than the size of the pool.
+ */
+class Mempool
+{
+public:
+  using TransactionSummary = ledger::TransactionSummary;
+  using Slice              = ledger::Block::Slice;
+  using Lanes              = LaneOccupancy::Lanes;
+  using LaneList           = std::vector<Lanes>;
+
+  /// The number of colliding transactions inspected (per lane) before a slice is given up on
+  static constexpr std::size_t MAX_COLLISIONS_PER_LANE = 4;
+
+  void        Add(TransactionSummary const &summary, uint32_t log2_num_lanes);
+  void        Add(TransactionSummary const &summary, Lanes lanes);
+  void        Fill(Slice &slice, LaneOccupancy &occupancy, LaneList *lanes = nullptr);
+  std::size_t size() const;
+
+  static Lanes MapToLanes(TransactionSummary const &summary, uint32_t log2_num_lanes);
+
+private:
+  struct Entry
+  {
+    TransactionSummary summary;
+    Lanes              lanes;  ///< The lanes used by the transaction
+  };
+
+  /// The ordering key of an entry in its group
+  struct Item
+  {
+    uint64_t    fee;
+    uint64_t    sequence;  ///< The arrival order, earlier transactions are preferred
+    std::size_t index;     ///< The index of the entry
+
+    bool operator<(Item const &other) const
+    {
+      return (fee != other.fee) ? (fee < other.fee) : (sequence > other.sequence);
+    }
+  };
+
+  /// A group which is considered for the current slice, keyed by its preferred entry
+  struct Candidate
+  {
+    Item        item;
+    std::size_t group;
+
+    bool operator<(Candidate const &other) const
+    {
+      return item < other.item;
+    }
+  };
+
+  using Entries    = std::vector<Entry>;
+  using Indices    = std::vector<std::size_t>;
+  using Group      = std::priority_queue<Item>;
+  using Groups     = std::vector<Group>;
+  using Candidates = std::priority_queue<Candidate>;
+
+  std::size_t GroupOf(Lanes const &lanes);
+  bool        IsAvailable(std::size_t group, LaneOccupancy const &occupancy) const;
+
+  Entries     entries_;          ///< The storage of the entries
+  Indices     free_;             ///< The indices of the unused entries
+  Groups      groups_{1};        ///< The groups by lowest lane, the first is for lane-less entries
+  uint64_t    next_sequence_{0};
+  std::size_t size_{0};
+};
+
+}  // namespace miner
+}  // namespace fetch
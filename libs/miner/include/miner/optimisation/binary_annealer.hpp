@@ -22,15 +22,34 @@
 #include "core/random/lfg.hpp"
 #include "math/approx_exp.hpp"
 #include "miner/optimisation/bitvector.hpp"
+#include "vectorise/threading/pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
 
 namespace fetch {
 namespace optimisers {
 
+/**
+ * Simulated annealing of a binary (QUBO) problem, with one coupling magnitude.
+ *
+ * By default a single chain is annealed from the start to the end inverse temperature. When more
+ * than one replica is configured the problem is instead solved with parallel tempering: each
+ * replica samples at a fixed temperature of a geometric ladder between the start and the end
+ * inverse temperatures, and replicas at neighbouring temperatures periodically attempt to exchange
+ * their states. The replicas are swept in parallel over the configured number of threads, the
+ * result is independent of the number of threads.
+ */
 class BinaryAnnealer
 {
 public:
   static constexpr char const *LOGGING_NAME = "BinaryAnnealer";
 
+  /// The default number of sweeps between attempted exchanges of the replica states
+  static constexpr std::size_t DEFAULT_SWAP_INTERVAL = 10;
+
   using spin_type  = int16_t;
   using state_type = std::vector<spin_type>;
 
@@ -38,88 +57,27 @@ public:
   using bit_data_type   = uint64_t;
   using bit_vector_type = bitmanip::BitVector;
   using cost_type       = double;
+  using rng_type        = random::LinearCongruentialGenerator;
 
   void Anneal()
   {
     Initialize();
+
+    if (replicas_ > 1)
+    {
+      AnnealReplicas();
+      return;
+    }
+
     SetBeta(beta0_);
 
-    double          db = (beta1_ - beta0_) / double(sweeps_ - 1);
-    bit_vector_type B;
-    B.Resize(size_);
+    double db = (beta1_ - beta0_) / double(sweeps_ - 1);
 
     for (std::size_t k = 0; k < sweeps_; ++k)
     {
       attempts_ += double(size_);
 
-      std::size_t block = 0;
-      std::size_t bit   = 0;
-
-      double    r           = sim_rng_.AsDouble();
-      double    TlogR       = std::log(r) / beta_ / 2. / normalisation_constant_;
-      cost_type approxTlogR = cost_type(TlogR);
-
-      for (std::size_t i = 0; i < size_; ++i)
-      {
-        //        assert( i ==( block * 8*sizeof(bit_data_type) + bit ));
-        assert(i < sites_.size());
-
-        Site const &s         = sites_[i];
-        uint64_t    state_bit = state_.bit(block, bit);
-        uint64_t    update    = 0;
-
-        int p = 0;
-        switch (B.blocks())
-        {
-        case 0:
-          break;
-        case 1:
-        case 2:
-          B(0) = s.couplings(0) & state_(0);
-          B(1) = s.couplings(1) & state_(1);
-          p    = __builtin_popcountl(B(0)) + __builtin_popcountl(B(1));
-
-          break;
-
-        case 3:
-        case 4:
-          B(0) = s.couplings(0) & state_(0);
-          B(1) = s.couplings(1) & state_(1);
-          B(2) = s.couplings(2) & state_(2);
-          B(3) = s.couplings(3) & state_(3);
-          p    = __builtin_popcountl(B(0)) + __builtin_popcountl(B(1)) + __builtin_popcountl(B(2)) +
-              __builtin_popcountl(B(3));
-          break;
-
-        default:
-          B.InlineAndAssign(s.couplings, state_);
-          p = static_cast<int>(B.PopCount());
-          break;
-        }
-
-        cost_type C;
-        C      = -cost_type(p) - s.local_field;
-        update = (approxTlogR <= C);
-        //        update =
-        switch (state_bit)
-        {
-        case 0:
-
-          break;
-        case 1:
-          C      = cost_type(p) + s.local_field;
-          update = (approxTlogR <= C);
-          break;
-        }
-
-        if (update)
-        {
-          state_.conditional_flip(block, bit, update);
-        }
-        ++bit;
-        block += (bit >= 8 * sizeof(bit_data_type));
-        bit &= (8 * sizeof(bit_data_type) - 1);
-      }
+      Sweep(state_, beta_, sim_rng_);
 
       SetBeta(beta() + db);
     }
@@ -171,6 +129,11 @@ public:
   }
 
   cost_type Energy() const
+  {
+    return Energy(state_);
+  }
+
+  cost_type Energy(bit_vector_type const &state) const
   {
     cost_type   ret   = 0;
     std::size_t block = 0;
@@ -181,10 +144,12 @@ public:
       assert(i == (block * 8 * sizeof(bit_data_type) + bit));
       Site const &s = sites_[i];
 
-      bit_vector_type B    = s.couplings & state_;
-      cost_type       sign = cost_type(state_.bit(block, bit));
+      if (state.bit(block, bit) != 0)
+      {
+        ret += 2 * s.local_field +
+               coupling_magnitude_ * static_cast<cost_type>(s.couplings.AndPopCount(state));
+      }
 
-      ret += sign * (2 * s.local_field + coupling_magnitude_ * static_cast<int>(B.PopCount()));
       ++bit;
       block += (bit >= 8 * sizeof(bit_data_type));
       bit &= (8 * sizeof(bit_data_type) - 1);
@@ -263,15 +228,36 @@ public:
     beta1_ = b1;
   }
 
+  std::size_t replicas() const
+  {
+    return replicas_;
+  }
+  std::size_t threads() const
+  {
+    return threads_;
+  }
+
+  /**
+   * Configure parallel tempering
+   *
+   * @param replicas The number of replicas, one disables parallel tempering
+   * @param threads The number of threads over which the replicas are swept
+   * @param swap_interval The number of sweeps between the attempted exchanges of the states
+   */
+  void SetReplicas(std::size_t replicas, std::size_t threads = 1,
+                   std::size_t swap_interval = DEFAULT_SWAP_INTERVAL)
+  {
+    replicas_      = std::max<std::size_t>(replicas, 1);
+    threads_       = std::max<std::size_t>(threads, 1);
+    swap_interval_ = std::max<std::size_t>(swap_interval, 1);
+  }
+
   void Initialize()
   {
     attempts_ = 0;
     accepted_ = 0;
     state_.Resize(size_);
-    for (std::size_t i = 0; i < state_.blocks(); ++i)
-    {
-      state_(i) = (init_rng_() >> 32) ^ init_rng_();
-    }
+    Randomise(state_);
   }
 
   bit_vector_type state()
@@ -292,6 +278,187 @@ public:
   }
 
 private:
+  /// A chain of the parallel tempering, sampling at a fixed temperature
+  struct Replica
+  {
+    bit_vector_type state;
+    cost_type       energy{0};
+    rng_type        rng;
+  };
+
+  using Replicas   = std::vector<Replica>;
+  using Indices    = std::vector<std::size_t>;
+  using ThreadPool = threading::Pool;
+
+  void Randomise(bit_vector_type &state)
+  {
+    for (std::size_t i = 0; i < state.blocks(); ++i)
+    {
+      state(i) = (init_rng_() >> 32) ^ init_rng_();
+    }
+  }
+
+  /**
+   * Attempt to flip every spin of the state once
+   *
+   * The change in the energy of each flip is determined from the population count of the
+   * intersection of the couplings of the site with the state, a single pass over the packed bits.
+   *
+   * @param state The state to be updated
+   * @param beta The inverse temperature
+   * @param rng The random number generator of the chain
+   * @return The change in the energy of the state
+   */
+  cost_type Sweep(bit_vector_type &state, double beta, rng_type &rng) const
+  {
+    std::size_t block = 0;
+    std::size_t bit   = 0;
+
+    double    r           = rng.AsDouble();
+    double    TlogR       = std::log(r) / beta / 2. / normalisation_constant_;
+    cost_type approxTlogR = cost_type(TlogR);
+    cost_type delta       = 0;
+
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+      assert(i < sites_.size());
+
+      Site const &s         = sites_[i];
+      uint64_t    state_bit = state.bit(block, bit);
+      cost_type   p         = static_cast<cost_type>(s.couplings.AndPopCount(state));
+
+      // the (normalised) cost of switching the spin on, which is gained when switched off
+      cost_type C      = p + s.local_field;
+      uint64_t  update = uint64_t(approxTlogR <= ((state_bit == 0) ? -C : C));
+
+      if (update)
+      {
+        state.conditional_flip(block, bit, update);
+
+        cost_type const change = s.local_field + (coupling_magnitude_ * p);
+        delta += (state_bit == 0) ? change : -change;
+      }
+
+      ++bit;
+      block += (bit >= 8 * sizeof(bit_data_type));
+      bit &= (8 * sizeof(bit_data_type) - 1);
+    }
+
+    return delta * normalisation_constant_;
+  }
+
+  /**
+   * Anneal with parallel tempering, the lowest energy state seen by any replica is kept
+   */
+  void AnnealReplicas()
+  {
+    assert(beta0_ > 0);
+
+    // the inverse temperature of each position of the ladder, from the hottest to the coldest
+    std::vector<double> betas(replicas_);
+    double const        ratio = std::pow(beta1_ / beta0_, 1. / double(replicas_ - 1));
+    for (std::size_t i = 0; i < replicas_; ++i)
+    {
+      betas[i] = beta0_ * std::pow(ratio, double(i));
+    }
+
+    // randomise each replica, the seeds are drawn in order so the result is reproducible
+    Replicas replicas(replicas_);
+    Indices  ladder(replicas_);
+    for (std::size_t i = 0; i < replicas_; ++i)
+    {
+      Replica &replica = replicas[i];
+      replica.state.Resize(size_);
+      Randomise(replica.state);
+      replica.energy = Energy(replica.state);
+      replica.rng.Seed(sim_rng_());
+
+      ladder[i] = i;
+    }
+
+    bit_vector_type best_state{replicas[0].state};
+    cost_type       best_energy = std::numeric_limits<cost_type>::max();
+
+    std::size_t const num_threads = std::min(threads_, replicas_);
+    ThreadPool        pool{num_threads > 1 ? num_threads : 0, "Annealer"};
+
+    for (std::size_t done = 0, round = 0; done < sweeps_; done += swap_interval_, ++round)
+    {
+      std::size_t const sweeps = std::min(swap_interval_, sweeps_ - done);
+
+      // sweep each of the replicas at their current temperature
+      for (std::size_t thread = 0; thread < num_threads; ++thread)
+      {
+        auto work = [this, thread, num_threads, sweeps, &replicas, &ladder, &betas]() {
+          for (std::size_t position = thread; position < ladder.size(); position += num_threads)
+          {
+            Replica &replica = replicas[ladder[position]];
+            for (std::size_t k = 0; k < sweeps; ++k)
+            {
+              replica.energy += Sweep(replica.state, betas[position], replica.rng);
+            }
+          }
+        };
+
+        if (num_threads > 1)
+        {
+          pool.Dispatch(work);
+        }
+        else
+        {
+          work();
+        }
+      }
+
+      if (num_threads > 1)
+      {
+        pool.Wait();
+      }
+
+      attempts_ += double(size_ * sweeps * replicas_);
+
+      for (auto const &replica : replicas)
+      {
+        if (replica.energy < best_energy)
+        {
+          best_energy = replica.energy;
+          CopyState(replica.state, best_state);
+        }
+      }
+
+      // attempt to exchange the states of neighbouring temperatures, alternating between the odd
+      // and even pairs of the ladder
+      for (std::size_t position = (round & 1u); (position + 1) < ladder.size(); position += 2)
+      {
+        Replica const &hot  = replicas[ladder[position]];
+        Replica const &cold = replicas[ladder[position + 1]];
+
+        double const x = 2. * (betas[position + 1] - betas[position]) * (cold.energy - hot.energy);
+        if ((x >= 0) || (swap_rng_.AsDouble() < std::exp(x)))
+        {
+          std::swap(ladder[position], ladder[position + 1]);
+          ++accepted_;
+        }
+      }
+    }
+
+    CopyState(best_state, state_);
+  }
+
+  /**
+   * Copy the bits of a state into another of the same size (the assignment of bit vectors shares
+   * their storage)
+   */
+  static void CopyState(bit_vector_type const &from, bit_vector_type &to)
+  {
+    assert(from.blocks() == to.blocks());
+
+    for (std::size_t i = 0; i < from.blocks(); ++i)
+    {
+      to(i) = from(i);
+    }
+  }
+
   double    attempts_           = 0;
   double    accepted_           = 0;
   cost_type coupling_magnitude_ = 0, normalisation_constant_ = 1.0;
@@ -306,11 +473,15 @@ private:
   std::vector<Site> sites_;
   double            beta_, beta0_ = 0.1, beta1_ = 3;
 
-  std::size_t                         sweeps_ = 10;
-  std::size_t                         size_   = 0;
-  exp_type                            fexp_;
-  random::LinearCongruentialGenerator sim_rng_;
-  random::LaggedFibonacciGenerator<>  init_rng_;
+  std::size_t                        sweeps_        = 10;
+  std::size_t                        size_          = 0;
+  std::size_t                        replicas_      = 1;
+  std::size_t                        threads_       = 1;
+  std::size_t                        swap_interval_ = DEFAULT_SWAP_INTERVAL;
+  exp_type                           fexp_;
+  rng_type                           sim_rng_;
+  rng_type                           swap_rng_;
+  random::LaggedFibonacciGenerator<> init_rng_;
 };
 
 }  // namespace optimisers
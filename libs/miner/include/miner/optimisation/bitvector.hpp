@@ -255,6 +255,39 @@ public:
     return ret;
   }
 
+  /**
+   * Count the bits which are set in both this and the other vector, without forming their
+   * intersection. The blocks are processed four at a time with independent accumulators, so that
+   * the population counts are not serialised on a single register.
+   *
+   * @param other The other vector, of the same size
+   * @return The number of bits set in both vectors
+   */
+  std::size_t AndPopCount(BitVectorImplementation const &other) const
+  {
+    assert(blocks_ == other.blocks_);
+
+    data_type const *a = data_.pointer();
+    data_type const *b = other.data_.pointer();
+
+    std::size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    std::size_t i  = 0;
+    for (; (i + 4) <= blocks_; i += 4)
+    {
+      c0 += static_cast<std::size_t>(__builtin_popcountl(a[i] & b[i]));
+      c1 += static_cast<std::size_t>(__builtin_popcountl(a[i + 1] & b[i + 1]));
+      c2 += static_cast<std::size_t>(__builtin_popcountl(a[i + 2] & b[i + 2]));
+      c3 += static_cast<std::size_t>(__builtin_popcountl(a[i + 3] & b[i + 3]));
+    }
+
+    for (; i < blocks_; ++i)
+    {
+      c0 += static_cast<std::size_t>(__builtin_popcountl(a[i] & b[i]));
+    }
+
+    return c0 + c1 + c2 + c3;
+  }
+
 private:
   container_type data_;
   std::size_t    size_;
@@ -20,75 +20,79 @@
 #include "core/logger.hpp"
 #include "ledger/chain/block.hpp"
 #include "ledger/chain/main_chain.hpp"
-#include "miner/resource_mapper.hpp"
+#include "metrics/tracer.hpp"
 
 #include <algorithm>
+#include <utility>
 
 namespace fetch {
 namespace miner {
-namespace {
+
+constexpr std::size_t BasicMiner::MAX_REPACK_ROUNDS;
+constexpr std::size_t BasicMiner::PARALLEL_PACKING_THRESHOLD;
 
 /**
- * Clip the specified to the bounds: [min_value, max_value]
+ * Construct the BasicMiner
  *
- * @tparam T The type of the value
- * @param value The input value to be clipped
- * @param min_value The minimum (inclusive) value
- * @param max_value The maximum (inclusive) value
- * @return The clipped value
+ * @param log2_num_lanes Log2 of the number of lanes
+ * @param num_slices The number of slices
+ * @param num_threads The number of threads (and mempool shards) used to pack blocks
  */
-template <typename T>
-T Clip3(T value, T min_value, T max_value)
-{
-  return std::min(std::max(value, min_value), max_value);
-}
-
-}  // namespace
+BasicMiner::BasicMiner(uint32_t log2_num_lanes, uint32_t /*num_slices*/, std::size_t num_threads)
+  : log2_num_lanes_{log2_num_lanes}
+  , shards_(std::max<std::size_t>(
+        std::min<std::size_t>(num_threads, std::size_t{1} << log2_num_lanes), 1))
+  , thread_pool_{shards_.size(), "Miner"}
+{}
 
 /**
- * Construct a transaction entry for the queue
+ * Add the specified transaction (summary) to the internal queue
  *
- * @param summary The reference to the transaction
- * @param log2_num_lanes The log2 of the number of lanes
+ * @param tx The reference to the transaction
  */
-BasicMiner::TransactionEntry::TransactionEntry(ledger::TransactionSummary const &summary,
-                                               uint32_t                          log2_num_lanes)
-  : resources{1u << log2_num_lanes}
-  , transaction{summary}
-
+void BasicMiner::EnqueueTransaction(ledger::TransactionSummary const &tx)
 {
-  // update the resources array with the correct bits flags for the lanes
-  for (auto const &resource : summary.resources)
-  {
-    // map the resource to a lane
-    uint32_t const lane = MapResourceToLane(resource, summary.contract_name, log2_num_lanes);
+  auto span = metrics::Tracer::Instance().StartTransactionSpan("tx.enqueue", tx.transaction_hash);
 
-    // update the bit flag
-    resources.set(lane, 1);
-  }
+  FETCH_LOCK(pending_lock_);
+  EnqueueLocked(tx);
 }
 
 /**
- * Construct the BasicMiner
+ * Add a batch of transactions (summaries) to the internal queue, taking the lock once
  *
- * @param log2_num_lanes Log2 of the number of lanes
- * @param num_slices The number of slices
+ * @param txs The transactions to be added
  */
-BasicMiner::BasicMiner(uint32_t log2_num_lanes, uint32_t /*num_slices*/)
-  : log2_num_lanes_{log2_num_lanes}
-  , max_num_threads_{std::thread::hardware_concurrency()}
-  , thread_pool_{max_num_threads_, "Miner"}
-{}
+void BasicMiner::EnqueueTransactions(TransactionSummaries const &txs)
+{
+  auto &     tracer  = metrics::Tracer::Instance();
+  auto const started = metrics::Tracer::Clock::now();
+
+  {
+    FETCH_LOCK(pending_lock_);
+
+    for (auto const &tx : txs)
+    {
+      EnqueueLocked(tx);
+    }
+  }
+
+  if (tracer.enabled())
+  {
+    for (auto const &tx : txs)
+    {
+      tracer.StartTransactionSpan("tx.enqueue", tx.transaction_hash, started).End();
+    }
+  }
+}
 
 /**
- * Add the specified transaction (summary) to the internal queue
+ * Internal: Add a transaction to the pending queue, the pending lock must be held
  *
  * @param tx The reference to the transaction
  */
-void BasicMiner::EnqueueTransaction(ledger::TransactionSummary const &tx)
+void BasicMiner::EnqueueLocked(ledger::TransactionSummary const &tx)
 {
-  FETCH_LOCK(pending_lock_);
-
   FETCH_LOG_DEBUG(LOGGING_NAME, "Enqueued Transaction: ", tx.transaction_hash.ToBase64());
 
   if (filtering_input_duplicates_)
@@ -98,7 +102,7 @@ void BasicMiner::EnqueueTransaction(ledger::TransactionSummary const &tx)
       FETCH_LOG_DEBUG(LOGGING_NAME, "Enqueued Transaction (added) ",
                       tx.transaction_hash.ToBase64());
 
-      pending_.emplace_back(tx, log2_num_lanes_);
+      pending_.emplace_back(tx);
       txs_seen_.insert(tx);
     }
     else
@@ -109,7 +113,7 @@ void BasicMiner::EnqueueTransaction(ledger::TransactionSummary const &tx)
   }
   else
   {
-    pending_.emplace_back(tx, log2_num_lanes_);
+    pending_.emplace_back(tx);
   }
 }
 
@@ -124,176 +128,306 @@ void BasicMiner::GenerateBlock(Block &block, std::size_t num_lanes, std::size_t
                                MainChain const &chain)
 {
   assert(num_lanes == (1u << log2_num_lanes_));
-  std::size_t pending_size = 0;
 
-  // add the most relevant transactions of the pending queue into the main queue
+  auto &     tracer     = metrics::Tracer::Instance();
+  auto const started    = metrics::Tracer::Clock::now();
+  auto       block_span = tracer.StartSpan("block.pack");
+
+  // move the pending transactions into the mempool, indexing them outside of the lock
+  PendingQueue pending;
   {
-    std::size_t max_block_capacity = (num_lanes * num_slices) + ((num_lanes * num_slices) / 8);
     FETCH_LOCK(pending_lock_);
-
-    // sort the pending list by fees (pending fees high -> low)
-    pending_.sort(SortByFee);
-
-    pending_size = pending_.size();
-    auto start   = pending_.begin();
-    auto end     = start;
-    std::advance(end, static_cast<int32_t>(std::min(max_block_capacity, pending_size)));
-
-    // Take as many transactions as we need from the front of the pending queue
-    main_queue_.splice(main_queue_.end(), pending_, start, end);
+    std::swap(pending, pending_);
   }
 
-  std::size_t const num_transactions  = main_queue_.size() + pending_size;
-  std::size_t const main_transactions = main_queue_.size();
+  for (auto const &tx : pending)
+  {
+    auto lanes = Mempool::MapToLanes(tx, log2_num_lanes_);
+    shards_[ShardOf(lanes)].Add(tx, std::move(lanes));
+  }
 
-  // Before packing transactions, we must be sure they're unique
-  chain.StripAlreadySeenTx(block.body.previous_hash, main_queue_);
+  std::size_t const num_transactions = BacklogSize();
+  bool const        parallel         = (shards_.size() > 1) &&
+                          (num_transactions > (PARALLEL_PACKING_THRESHOLD * shards_.size()));
 
   FETCH_LOG_INFO(LOGGING_NAME, "Starting block packing. Backlog: ", num_transactions,
-                 ", main queue: ", main_queue_.size(), " pending: ", pending_.size());
-
-  // determine how many of the threads should be used in this block generation
-  std::size_t const num_threads =
-      Clip3<std::size_t>(main_queue_.size() / 1000u, 1u, max_num_threads_);
+                 " new: ", pending.size(), " parallel: ", parallel);
 
   // prepare the basic formatting for the block
   block.body.slices.resize(num_slices);
 
-  // skip thread generation in the simple case
-  if (num_threads == 1)
+  Occupancies occupancies(num_slices, LaneOccupancy{num_lanes});
+  PackedList  packed;
+
+  // each shard selects the transactions for every slice on its own...
+  Selections selections(shards_.size(), ShardSelection(num_slices));
+  for (std::size_t shard = 0; shard < shards_.size(); ++shard)
   {
-    GenerateSlices(main_queue_, block.body, 0, 1, num_lanes);
+    if (parallel)
+    {
+      thread_pool_.Dispatch([this, shard, &selections, num_lanes]() {
+        SelectFromShard(shard, selections[shard], num_lanes);
+      });
+    }
+    else
+    {
+      SelectFromShard(shard, selections[shard], num_lanes);
+    }
   }
-  else
-  {
-    // split the main queue into a series of smaller lists
-    std::vector<TransactionList> transaction_lists(num_threads);
-
-    std::size_t const num_tx_per_thread = main_queue_.size() / num_threads;
 
-    for (std::size_t i = 0; i < num_threads; ++i)
-    {
-      TransactionList &txs = transaction_lists[i];
+  if (parallel)
+  {
+    thread_pool_.Wait();
+  }
 
-      auto start = main_queue_.begin();
-      auto end   = start;
-      std::advance(end, static_cast<int32_t>(std::min(num_tx_per_thread, main_queue_.size())));
+  // ...the selections are then merged, with the space left by any collisions between the shards
+  // (or by shards which have run out of transactions) given to the next best transactions
+  MergeSelections(block, occupancies, selections, packed);
 
-      // splice in the contents of the array
-      txs.splice(txs.end(), main_queue_, start, end);
+  for (std::size_t slice_index = 0; slice_index < num_slices; ++slice_index)
+  {
+    FillSlice(block, slice_index, occupancies, packed);
+  }
 
-      thread_pool_.Dispatch([&txs, &block, i, num_threads, num_lanes]() {
-        GenerateSlices(txs, block.body, i, num_threads, num_lanes);
-      });
+  // the transactions must be unique, the space of any which have already been included in the
+  // chain is given to the next best transactions (which must then also be checked)
+  std::size_t round{0};
+  while (!packed.empty())
+  {
+    auto const slices = RemoveReplayedTransactions(block, occupancies, packed, chain);
+    if (slices.empty() || (++round > MAX_REPACK_ROUNDS))
+    {
+      break;
     }
 
-    // wait for all the threads to complete
-    thread_pool_.Wait();
+    for (auto const slice_index : slices)
+    {
+      FillSlice(block, slice_index, occupancies, packed);
+    }
+  }
 
-    // return all the transactions to the main queue
-    for (std::size_t i = 0; i < num_threads; ++i)
+  // the packing is a stage of the trace of each (sampled) transaction in the block
+  if (tracer.enabled())
+  {
+    for (auto const &slice : block.body.slices)
     {
-      main_queue_.splice(main_queue_.begin(), transaction_lists[i]);
+      for (auto const &tx : slice)
+      {
+        tracer.StartTransactionSpan("tx.pack", tx.transaction_hash, started).End();
+      }
     }
   }
 
-  std::size_t const packed_transactions    = main_transactions - main_queue_.size();
-  std::size_t const remaining_transactions = num_transactions - packed_transactions;
+  std::size_t const remaining_transactions = BacklogSize();
+  std::size_t const packed_transactions    = num_transactions - remaining_transactions;
 
   FETCH_UNUSED(packed_transactions);
   FETCH_UNUSED(remaining_transactions);
   FETCH_LOG_INFO(LOGGING_NAME, "Finished block packing (packed: ", packed_transactions,
                  " remaining: ", remaining_transactions, ")");
 
-  main_queue_size_ = main_queue_.size();
+  mempool_size_ = remaining_transactions;
 }
 
 uint64_t BasicMiner::GetBacklog() const
 {
   FETCH_LOCK(pending_lock_);
-  return main_queue_size_ + pending_.size();
+  return mempool_size_ + pending_.size();
 }
 
 /**
- * Internal: Generate a selection of slices
+ * Internal: Determine the shard of a transaction from the lowest lane that it uses
  *
- * @param tx The reference to the transaction list to be used when generating the selection of
- * slices
- * @param block The reference to the block to populate
- * @param offset The slice index offset to start from
- * @param interval The slice index interval to be used when selecting the next slice to populate
- * @param num_lanes The number of lanes of the block
+ * @param lanes The lanes of the transaction
+ * @return The index of the shard
  */
-void BasicMiner::GenerateSlices(TransactionList &tx, Block::Body &block, std::size_t offset,
-                                std::size_t interval, std::size_t num_lanes)
+std::size_t BasicMiner::ShardOf(Mempool::Lanes const &lanes) const
 {
-  // sort by fees
-  tx.sort(SortByFee);
-
-  for (std::size_t slice_idx = offset; slice_idx < block.slices.size(); slice_idx += interval)
+  if (lanes.empty())
   {
-    auto &slice = block.slices[slice_idx];
+    return 0;
+  }
+
+  std::size_t const shard = (std::size_t{lanes.lowest()} * shards_.size()) >> log2_num_lanes_;
 
-    // generate the slice
-    GenerateSlice(tx, slice, slice_idx, num_lanes);
+  return std::min(shard, shards_.size() - 1);
+}
+
+/**
+ * Internal: The number of transactions in the mempool. Not thread safe.
+ */
+std::size_t BasicMiner::BacklogSize() const
+{
+  std::size_t size{0};
+  for (auto const &shard : shards_)
+  {
+    size += shard.size();
   }
+
+  return size;
 }
 
 /**
- * Internal: Generate a slice
+ * Internal: Select the transactions of a shard for each of the slices, without regard for the
+ * selections of the other shards
  *
- * @param tx The reference to the transaction list to be used when generating the slice
- * @param slice The slice to be populated
- * @param slice_index The slice number
- * @param num_lanes The number of lanes for the block
+ * @param shard The index of the shard
+ * @param selection The selection for each of the slices
+ * @param num_lanes The number of lanes of the block
  */
-void BasicMiner::GenerateSlice(TransactionList &tx, Block::Slice &      slice,
-                               std::size_t /*slice_index*/, std::size_t num_lanes)
+void BasicMiner::SelectFromShard(std::size_t shard, ShardSelection &selection,
+                                 std::size_t num_lanes)
 {
-  BitVector slice_state{num_lanes};
+  Mempool &mempool = shards_[shard];
 
-  auto it = tx.begin();
-  while (it != tx.end())
+  for (auto &slice : selection)
   {
-    // exit the search loop once the slice is full
-    if (slice_state.PopCount() == num_lanes)
+    if (mempool.size() == 0)
     {
       break;
     }
 
-    // calculate the collisions for this
-    BitVector const collisions = slice_state & it->resources;
+    LaneOccupancy occupancy{num_lanes};
+    mempool.Fill(slice.transactions, occupancy, &slice.lanes);
+  }
+}
 
-    // determine if there are collisions
-    if (collisions.PopCount() == 0)
+/**
+ * Internal: Merge the selections of the shards into the slices of the block in fee order. The
+ * transactions which collide with a transaction of a higher fee are returned to their shard.
+ *
+ * @param block The block being generated
+ * @param occupancies The lane occupancy of each slice of the block
+ * @param selections The selections of each shard, consumed by the merge
+ * @param packed The list of the transactions packed into the block
+ */
+void BasicMiner::MergeSelections(Block &block, Occupancies &occupancies, Selections &selections,
+                                 PackedList &packed)
+{
+  struct Selected
+  {
+    std::size_t                 shard;
+    ledger::TransactionSummary *tx;
+    Mempool::Lanes const *      lanes;
+  };
+
+  std::vector<Selected> selected;
+
+  for (std::size_t slice_index = 0; slice_index < block.body.slices.size(); ++slice_index)
+  {
+    selected.clear();
+    for (std::size_t shard = 0; shard < selections.size(); ++shard)
     {
-      // update the slice state
-      slice_state |= it->resources;
+      auto &selection = selections[shard][slice_index];
+      for (std::size_t i = 0; i < selection.transactions.size(); ++i)
+      {
+        selected.push_back(Selected{shard, &selection.transactions[i], &selection.lanes[i]});
+      }
+    }
+
+    std::stable_sort(selected.begin(), selected.end(),
+                     [](Selected const &a, Selected const &b) { return a.tx->fee > b.tx->fee; });
 
-      // insert the transaction into the slice
-      slice.push_back(it->transaction);
+    auto &slice     = block.body.slices[slice_index];
+    auto &occupancy = occupancies[slice_index];
 
-      // remove the transaction from the main queue
-      it = tx.erase(it);
+    for (auto &entry : selected)
+    {
+      auto &      tx    = *entry.tx;
+      auto const &lanes = *entry.lanes;
+
+      if (occupancy.Collides(lanes))
+      {
+        shards_[entry.shard].Add(tx, lanes);
+      }
+      else
+      {
+        occupancy.Occupy(lanes);
+        packed.push_back(PackedEntry{tx, slice_index, lanes});
+        slice.emplace_back(std::move(tx));
+      }
     }
-    else
+  }
+}
+
+/**
+ * Internal: Top up a slice of the block from each of the shards, unless it is already full
+ *
+ * @param block The block being generated
+ * @param slice_index The index of the slice to be filled
+ * @param occupancies The lane occupancy of each slice of the block
+ * @param packed The list of the transactions packed into the block, updated with the additions
+ */
+void BasicMiner::FillSlice(Block &block, std::size_t slice_index, Occupancies &occupancies,
+                           PackedList &packed)
+{
+  auto &            slice     = block.body.slices[slice_index];
+  auto &            occupancy = occupancies[slice_index];
+  std::size_t const first     = slice.size();
+  Mempool::LaneList lanes;
+
+  for (auto &shard : shards_)
+  {
+    if (occupancy.full())
     {
-      // advance to the next iterator
-      ++it;
+      break;
     }
+
+    shard.Fill(slice, occupancy, &lanes);
+  }
+
+  for (std::size_t i = first; i < slice.size(); ++i)
+  {
+    packed.push_back(PackedEntry{slice[i], slice_index, lanes[i - first]});
   }
 }
 
 /**
- * Sorting method for transactions
+ * Internal: Remove the packed transactions which have already been included in the chain from
+ * the block. The replayed transactions are discarded.
  *
- * @param a The reference to a transaction entry
- * @param b The refernece to the other transaction entry
- * @return true if a is preferable to b, otherwise false
+ * @param block The block being generated
+ * @param occupancies The lane occupancy of each slice of the block, updated for the removals
+ * @param packed The transactions to be checked, cleared once checked
+ * @param chain The chain on which the block is built
+ * @return The indices of the slices from which transactions were removed
  */
-bool BasicMiner::SortByFee(TransactionEntry const &a, TransactionEntry const &b)
+BasicMiner::SliceIndices BasicMiner::RemoveReplayedTransactions(Block &          block,
+                                                                Occupancies &    occupancies,
+                                                                PackedList &     packed,
+                                                                MainChain const &chain)
 {
-  return a.transaction.fee > b.transaction.fee;
+  SliceIndices slices;
+
+  PackedList unique{packed};
+  chain.StripAlreadySeenTx(block.body.previous_hash, unique);
+
+  if (unique.size() != packed.size())
+  {
+    TransactionSet remaining;
+    for (auto const &entry : unique)
+    {
+      remaining.insert(entry.transaction);
+    }
+
+    for (auto const &entry : packed)
+    {
+      if (remaining.find(entry.transaction) != remaining.end())
+      {
+        continue;
+      }
+
+      auto &slice = block.body.slices[entry.slice];
+      slice.erase(std::remove(slice.begin(), slice.end(), entry.transaction), slice.end());
+
+      occupancies[entry.slice].Release(entry.lanes);
+      slices.insert(entry.slice);
+    }
+  }
+
+  packed.clear();
+
+  return slices;
 }
 
 }  // namespace miner
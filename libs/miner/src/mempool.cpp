@@ -0,0 +1,256 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "miner/mempool.hpp"
+#include "miner/resource_mapper.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace fetch {
+namespace miner {
+
+constexpr std::size_t Mempool::MAX_COLLISIONS_PER_LANE;
+
+/**
+ * Construct an empty occupancy
+ *
+ * @param num_lanes The number of lanes of the slice
+ */
+LaneOccupancy::LaneOccupancy(std::size_t num_lanes)
+  : num_lanes_{num_lanes}
+{
+  if (num_lanes > Lanes::MAX_LANES)
+  {
+    throw std::out_of_range("Number of lanes exceeds the capacity of the lane bitmap");
+  }
+
+  occupied_ =
+      Lanes::Range(static_cast<uint32_t>(num_lanes), static_cast<uint32_t>(Lanes::MAX_LANES));
+}
+
+/**
+ * Determine if any of the lanes are already in use (or outside of the slice)
+ *
+ * @param lanes The lanes to be checked
+ * @return true if the lanes can not be used, otherwise false
+ */
+bool LaneOccupancy::Collides(Lanes const &lanes) const
+{
+  return occupied_.Overlaps(lanes);
+}
+
+/**
+ * Mark the lanes as in use
+ *
+ * @param lanes The lanes, which must not collide
+ */
+void LaneOccupancy::Occupy(Lanes const &lanes)
+{
+  occupied_ |= lanes;
+  num_occupied_ += lanes.count();
+}
+
+/**
+ * Mark the lanes as free, e.g. when a transaction is removed from the slice
+ *
+ * @param lanes The lanes, which must have been occupied
+ */
+void LaneOccupancy::Release(Lanes const &lanes)
+{
+  lanes.ForEach([this](uint32_t lane) {
+    if ((lane < num_lanes_) && occupied_.Test(lane))
+    {
+      occupied_.Reset(lane);
+      --num_occupied_;
+    }
+  });
+}
+
+bool LaneOccupancy::IsOccupied(uint32_t lane) const
+{
+  return (lane >= num_lanes_) || occupied_.Test(lane);
+}
+
+bool LaneOccupancy::full() const
+{
+  return num_occupied_ >= num_lanes_;
+}
+
+/**
+ * Add a transaction to the pool
+ *
+ * @param summary The transaction
+ * @param log2_num_lanes The log2 of the number of lanes
+ */
+void Mempool::Add(TransactionSummary const &summary, uint32_t log2_num_lanes)
+{
+  Add(summary, MapToLanes(summary, log2_num_lanes));
+}
+
+/**
+ * Add a transaction to the pool, for which the lanes have already been determined
+ *
+ * @param summary The transaction
+ * @param lanes The lanes of the transaction
+ */
+void Mempool::Add(TransactionSummary const &summary, Lanes lanes)
+{
+  std::size_t index{0};
+  if (free_.empty())
+  {
+    index = entries_.size();
+    entries_.emplace_back();
+  }
+  else
+  {
+    index = free_.back();
+    free_.pop_back();
+  }
+
+  Entry &entry  = entries_[index];
+  entry.summary = summary;
+  entry.lanes   = std::move(lanes);
+
+  groups_[GroupOf(entry.lanes)].push(Item{summary.fee, next_sequence_++, index});
+  ++size_;
+}
+
+/**
+ * Fill a slice with the transactions of the highest fees which do not collide with each other, or
+ * with the transactions already in the slice. The selected transactions are removed from the pool.
+ *
+ * @param slice The slice to be filled
+ * @param occupancy The lanes which are already used by the slice, updated with the new selection
+ * @param lanes The (optional) list to which the lanes of each selected transaction are appended
+ */
+void Mempool::Fill(Slice &slice, LaneOccupancy &occupancy, LaneList *lanes)
+{
+  Candidates candidates;
+  for (std::size_t group = 0; group < groups_.size(); ++group)
+  {
+    if (!groups_[group].empty() && IsAvailable(group, occupancy))
+    {
+      candidates.push(Candidate{groups_[group].top(), group});
+    }
+  }
+
+  // the entries which collided with the slice are put back into their groups afterwards
+  std::vector<Candidate> collided;
+  std::size_t const      max_collisions = MAX_COLLISIONS_PER_LANE * groups_.size();
+
+  while (!candidates.empty() && !occupancy.full() && (collided.size() < max_collisions))
+  {
+    Candidate const candidate = candidates.top();
+    candidates.pop();
+
+    // the lowest lane of the group might have been occupied since the candidate was added
+    if (!IsAvailable(candidate.group, occupancy))
+    {
+      continue;
+    }
+
+    Group &group = groups_[candidate.group];
+    group.pop();
+
+    Entry &entry = entries_[candidate.item.index];
+    if (occupancy.Collides(entry.lanes))
+    {
+      collided.push_back(candidate);
+    }
+    else
+    {
+      occupancy.Occupy(entry.lanes);
+      slice.emplace_back(std::move(entry.summary));
+
+      if (lanes)
+      {
+        lanes->push_back(entry.lanes);
+      }
+
+      entry = Entry{};
+      free_.push_back(candidate.item.index);
+      --size_;
+    }
+
+    if (!group.empty())
+    {
+      candidates.push(Candidate{group.top(), candidate.group});
+    }
+  }
+
+  for (auto const &candidate : collided)
+  {
+    groups_[candidate.group].push(candidate.item);
+  }
+}
+
+/**
+ * @return The number of transactions in the pool
+ */
+std::size_t Mempool::size() const
+{
+  return size_;
+}
+
+/**
+ * Determine the lanes used by a transaction
+ *
+ * @param summary The transaction
+ * @param log2_num_lanes The log2 of the number of lanes
+ * @return The lanes of the transaction
+ */
+Mempool::Lanes Mempool::MapToLanes(TransactionSummary const &summary, uint32_t log2_num_lanes)
+{
+  Lanes lanes;
+  for (auto const &resource : summary.resources)
+  {
+    lanes.Set(MapResourceToLane(resource, summary.contract_name, log2_num_lanes));
+  }
+
+  return lanes;
+}
+
+/**
+ * Internal: Lookup the group of an entry, creating it if needed
+ *
+ * @param lanes The lanes of the entry
+ * @return The index of the group
+ */
+std::size_t Mempool::GroupOf(Lanes const &lanes)
+{
+  std::size_t const group = lanes.empty() ? 0 : (std::size_t{lanes.lowest()} + 1);
+
+  if (group >= groups_.size())
+  {
+    groups_.resize(group + 1);
+  }
+
+  return group;
+}
+
+/**
+ * Internal: Determine if the lowest lane of a group is free in the slice
+ */
+bool Mempool::IsAvailable(std::size_t group, LaneOccupancy const &occupancy) const
+{
+  return (group == 0) || !occupancy.IsOccupied(static_cast<uint32_t>(group - 1));
+}
+
+}  // namespace miner
+}  // namespace fetch
@@ -21,6 +21,7 @@
 #include "ledger/chain/transaction.hpp"
 #include "meta/is_log2.hpp"
 #include "miner/basic_miner.hpp"
+#include "miner/optimisation/bitvector.hpp"
 #include "miner/resource_mapper.hpp"
 #include "vectorise/platform.hpp"
 
@@ -243,4 +244,86 @@ TEST_P(BasicMinerTests, reject_replayed_transactions)
   }
 }
 
+TEST_P(BasicMinerTests, ParallelPackingIsFreeOfCollisions)
+{
+  // enough transactions for each of the shards to be packed on its own thread
+  std::size_t const num_tx      = GetParam() * 1000;
+  std::size_t const num_threads = 4;
+
+  miner_ = std::make_unique<BasicMiner>(uint32_t{LOG2_NUM_LANES}, std::size_t{NUM_SLICES},
+                                        num_threads);
+
+  PopulateWithTransactions(num_tx);
+
+  MainChain                    chain{MainChain::Mode::IN_MEMORY_DB};
+  std::set<TransactionSummary> transactions_packed;
+
+  while (miner_->GetBacklog() > 0)
+  {
+    Block block;
+    block.body.previous_hash = chain.GetHeaviestBlockHash();
+
+    miner_->GenerateBlock(block, NUM_LANES, NUM_SLICES, chain);
+
+    std::size_t block_transactions{0};
+    for (auto const &slice : block.body.slices)
+    {
+      BitVector lanes{NUM_LANES};
+
+      for (auto const &tx : slice)
+      {
+        BitVector resources{NUM_LANES};
+        for (auto const &resource : tx.resources)
+        {
+          resources.set(
+              fetch::miner::MapResourceToLane(resource, tx.contract_name, LOG2_NUM_LANES), 1);
+        }
+
+        // ensure there are no collisions between the transactions selected by different shards
+        BitVector collisions = resources & lanes;
+        EXPECT_EQ(0, collisions.PopCount());
+        lanes |= resources;
+
+        // ensure each transaction is only packed once
+        EXPECT_TRUE(transactions_packed.insert(tx).second);
+        ++block_transactions;
+      }
+    }
+
+    ASSERT_GT(block_transactions, 0u);
+
+    block.UpdateDigest();
+    chain.AddBlock(block);
+  }
+
+  EXPECT_EQ(num_tx, transactions_packed.size());
+}
+
+TEST_P(BasicMinerTests, BatchEnqueueFiltersDuplicates)
+{
+  std::size_t const num_tx = GetParam();
+
+  BasicMiner::TransactionSummaries summaries{};
+  for (std::size_t i = 0; i < num_tx; ++i)
+  {
+    MutableTransaction transaction;
+    transaction.set_fee(rng_() & 0x3f);
+    transaction.set_contract_name("ai.fetch.dummy");
+    transaction.PushResource("Unique: " + std::to_string(i));
+
+    auto tx = VerifiedTransaction::Create(std::move(transaction));
+
+    // every transaction appears twice in the batch
+    summaries.push_back(tx.summary());
+    summaries.push_back(tx.summary());
+  }
+
+  miner_->EnqueueTransactions(summaries);
+  EXPECT_EQ(num_tx, miner_->GetBacklog());
+
+  // a repeated batch is filtered entirely
+  miner_->EnqueueTransactions(summaries);
+  EXPECT_EQ(num_tx, miner_->GetBacklog());
+}
+
 INSTANTIATE_TEST_CASE_P(ParamBased, BasicMinerTests, ::testing::Values(10, 20), );
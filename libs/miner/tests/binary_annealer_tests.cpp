@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "miner/optimisation/binary_annealer.hpp"
+#include "miner/optimisation/bitvector.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+namespace {
+
+using fetch::bitmanip::BitVector;
+using fetch::optimisers::BinaryAnnealer;
+
+using Rng = std::mt19937_64;
+
+/**
+ * Build a problem shaped like the slice packing of the block generator: each transaction has a
+ * (negative) fee as its local field and the colliding transactions are penalised
+ */
+void BuildProblem(BinaryAnnealer &annealer, std::size_t size, double density, uint64_t seed)
+{
+  Rng                                    rng{seed};
+  std::uniform_int_distribution<int>     fees{1, 100};
+  std::uniform_real_distribution<double> collision{0., 1.};
+
+  annealer.Resize(size);
+
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    annealer.Insert(i, i, -fees(rng));
+
+    for (std::size_t j = i + 1; j < size; ++j)
+    {
+      if (collision(rng) < density)
+      {
+        annealer.Insert(i, j, 200);
+      }
+    }
+  }
+
+  annealer.Normalise();
+}
+
+TEST(BinaryAnnealerTests, AndPopCountMatchesTheIntersection)
+{
+  Rng rng{42};
+
+  for (std::size_t size = 1; size < 600; size += 37)
+  {
+    BitVector a{size};
+    BitVector b{size};
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      a.set(i, rng() & 1u);
+      b.set(i, rng() & 1u);
+    }
+
+    EXPECT_EQ((a & b).PopCount(), a.AndPopCount(b));
+    EXPECT_EQ(a.PopCount(), a.AndPopCount(a));
+  }
+}
+
+TEST(BinaryAnnealerTests, ParallelTemperingFindsTheGroundState)
+{
+  std::size_t const size = 14;
+
+  BinaryAnnealer annealer;
+  BuildProblem(annealer, size, 0.3, 7);
+
+  // exhaustively determine the lowest energy
+  double    ground_energy = std::numeric_limits<double>::max();
+  BitVector state{size};
+  for (uint64_t bits = 0; bits < (uint64_t{1} << size); ++bits)
+  {
+    state(0)      = bits;
+    ground_energy = std::min(ground_energy, annealer.Energy(state));
+  }
+
+  // the temperatures are relative to the scale of the problem (the collision penalty)
+  annealer.SetSweeps(200);
+  annealer.SetBetaStart(0.0005);
+  annealer.SetBetaEnd(0.05);
+  annealer.SetReplicas(4, 2);
+
+  BinaryAnnealer::state_type solution;
+  double const               energy = annealer.FindMinimum(solution);
+
+  EXPECT_DOUBLE_EQ(ground_energy, energy);
+  EXPECT_EQ(size, solution.size());
+}
+
+TEST(BinaryAnnealerTests, ParallelTemperingDoesNotDependOnTheThreads)
+{
+  std::size_t const size = 300;
+
+  BinaryAnnealer single_threaded;
+  BinaryAnnealer multi_threaded;
+  BuildProblem(single_threaded, size, 0.05, 11);
+  BuildProblem(multi_threaded, size, 0.05, 11);
+
+  single_threaded.SetSweeps(50);
+  single_threaded.SetReplicas(6, 1);
+  multi_threaded.SetSweeps(50);
+  multi_threaded.SetReplicas(6, 3);
+
+  BinaryAnnealer::state_type single_solution;
+  BinaryAnnealer::state_type multi_solution;
+
+  EXPECT_DOUBLE_EQ(single_threaded.FindMinimum(single_solution),
+                   multi_threaded.FindMinimum(multi_solution));
+  EXPECT_EQ(single_solution, multi_solution);
+}
+
+TEST(BinaryAnnealerTests, ParallelTemperingIsNoWorseThanASingleChain)
+{
+  std::size_t const size = 300;
+
+  BinaryAnnealer single_chain;
+  BinaryAnnealer tempering;
+  BuildProblem(single_chain, size, 0.05, 13);
+  BuildProblem(tempering, size, 0.05, 13);
+
+  single_chain.SetSweeps(100);
+  tempering.SetSweeps(100);
+  tempering.SetReplicas(8, 4);
+
+  EXPECT_LE(tempering.FindMinimum(), single_chain.FindMinimum());
+}
+
+}  // namespace
@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "miner/instance/binary_problem.hpp"
+#include "miner/instance/load_txt.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using fetch::optimisers::BinaryProblem;
+
+using Rng       = std::mt19937_64;
+using StateType = BinaryProblem::state_type;
+
+/**
+ * Evaluate the energy of a state directly from the couplings
+ */
+double ReferenceEnergy(BinaryProblem const &problem, StateType const &state)
+{
+  double energy = 0;
+  for (std::size_t i = 0; i < problem.size(); ++i)
+  {
+    for (std::size_t j = i; j < problem.size(); ++j)
+    {
+      energy += problem.coupling(i, j) * state[i] * state[j];
+    }
+  }
+
+  return energy;
+}
+
+void BuildProblem(BinaryProblem &problem, std::size_t size, double density, Rng &rng)
+{
+  std::uniform_real_distribution<double> value{-1., 1.};
+  std::uniform_real_distribution<double> coupled{0., 1.};
+
+  problem.Resize(size);
+
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    problem.Insert(i, i, value(rng));
+
+    for (std::size_t j = i + 1; j < size; ++j)
+    {
+      if (coupled(rng) < density)
+      {
+        problem.Insert(j, i, value(rng));
+      }
+    }
+  }
+}
+
+TEST(BinaryProblemTests, DuplicateCouplingsAreRejected)
+{
+  BinaryProblem problem;
+  problem.Resize(4);
+
+  EXPECT_TRUE(problem.Insert(0, 1, 2.));
+  EXPECT_FALSE(problem.Insert(1, 0, 3.));
+  EXPECT_TRUE(problem.Insert(2, 2, 1.));
+  EXPECT_FALSE(problem.Insert(2, 2, 1.));
+
+  EXPECT_DOUBLE_EQ(2., problem.coupling(0, 1));
+  EXPECT_DOUBLE_EQ(2., problem.coupling(1, 0));
+  EXPECT_DOUBLE_EQ(1., problem.coupling(2, 2));
+  EXPECT_DOUBLE_EQ(0., problem.coupling(0, 3));
+  EXPECT_EQ(1u, problem.MaxConnectivity());
+}
+
+TEST(BinaryProblemTests, FlipsMatchTheFullEvaluation)
+{
+  Rng rng{42};
+
+  BinaryProblem problem;
+  BuildProblem(problem, 64, 0.2, rng);
+
+  StateType state(problem.size());
+  for (auto &spin : state)
+  {
+    spin = static_cast<BinaryProblem::spin_type>(rng() & 1u);
+  }
+
+  problem.SetState(state);
+  EXPECT_NEAR(ReferenceEnergy(problem, state), problem.energy(), 1e-9);
+
+  for (std::size_t n = 0; n < 1000; ++n)
+  {
+    std::size_t const i = rng() % problem.size();
+
+    double const before   = problem.energy();
+    double const expected = problem.DeltaEnergy(i);
+    double const delta    = problem.Flip(i);
+
+    state[i] = static_cast<BinaryProblem::spin_type>(1 - state[i]);
+
+    EXPECT_DOUBLE_EQ(expected, delta);
+    EXPECT_NEAR(before + delta, problem.energy(), 1e-9);
+    EXPECT_EQ(state, problem.state());
+  }
+
+  EXPECT_NEAR(ReferenceEnergy(problem, state), problem.energy(), 1e-9);
+}
+
+TEST(BinaryProblemTests, InsertingAfterEvaluationRebuildsTheIndex)
+{
+  BinaryProblem problem;
+  problem.Resize(3);
+  problem.Insert(0, 1, 1.);
+
+  StateType const state{1, 1, 1};
+  problem.SetState(state);
+  EXPECT_DOUBLE_EQ(1., problem.energy());
+
+  problem.Insert(1, 2, -4.);
+  problem.SetState(state);
+  EXPECT_DOUBLE_EQ(-3., problem.energy());
+  EXPECT_DOUBLE_EQ(3., problem.DeltaEnergy(1));
+}
+
+TEST(BinaryProblemTests, LoadFromText)
+{
+  std::string const filename = "binary_problem_tests.txt";
+  {
+    std::ofstream file{filename};
+    file << "# i j value\n"
+         << "10 10 -1.5\n"
+         << "10 20 2\n"
+         << "20 30 -0.5\n";
+  }
+
+  BinaryProblem problem;
+  ASSERT_TRUE(fetch::optimisers::Load(problem, filename));
+  std::remove(filename.c_str());
+
+  ASSERT_EQ(3u, problem.size());
+  EXPECT_DOUBLE_EQ(-1.5, problem.coupling(0, 0));
+  EXPECT_DOUBLE_EQ(2., problem.coupling(0, 1));
+  EXPECT_DOUBLE_EQ(-0.5, problem.coupling(1, 2));
+  EXPECT_EQ(2u, problem.MaxConnectivity());
+
+  problem.SetState({1, 1, 0});
+  EXPECT_DOUBLE_EQ(0.5, problem.energy());
+  EXPECT_DOUBLE_EQ(-0.5, problem.DeltaEnergy(2));
+}
+
+}  // namespace
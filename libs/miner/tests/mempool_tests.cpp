@@ -0,0 +1,242 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/chain/mutable_transaction.hpp"
+#include "miner/mempool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+using fetch::ledger::TransactionSummary;
+using fetch::miner::LaneOccupancy;
+using fetch::miner::Mempool;
+
+using Rng       = std::mt19937_64;
+using Summaries = std::vector<TransactionSummary>;
+using Slice     = Mempool::Slice;
+using Slices    = std::vector<Slice>;
+
+class MempoolTests : public ::testing::Test
+{
+protected:
+  static constexpr uint32_t    LOG2_NUM_LANES = 4;
+  static constexpr std::size_t NUM_LANES      = 1u << LOG2_NUM_LANES;
+  static constexpr std::size_t NUM_SLICES     = 8;
+
+  Summaries CreateTransactions(std::size_t count, uint64_t max_fee)
+  {
+    std::poisson_distribution<uint32_t> num_resources(1.5);
+
+    Summaries summaries;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      TransactionSummary summary;
+      summary.contract_name    = "fetch.token.transfer";
+      summary.transaction_hash = "digest " + std::to_string(i);
+      summary.fee              = rng_() % max_fee;
+
+      summary.resources.insert("unique " + std::to_string(i));
+      for (std::size_t j = num_resources(rng_); j > 0; --j)
+      {
+        summary.resources.insert("resource " + std::to_string(rng_()));
+      }
+
+      summaries.push_back(summary);
+    }
+
+    return summaries;
+  }
+
+  /**
+   * The reference packing: walk the transactions in (stable) fee order, once for each slice,
+   * taking each one which does not collide
+   */
+  static Slices PackReference(Summaries const &summaries)
+  {
+    using Candidate = std::pair<Mempool::Lanes, TransactionSummary>;
+
+    std::list<Candidate> candidates;
+    for (auto const &summary : summaries)
+    {
+      candidates.emplace_back(Mempool::MapToLanes(summary, LOG2_NUM_LANES), summary);
+    }
+
+    candidates.sort([](Candidate const &a, Candidate const &b) {
+      return a.second.fee > b.second.fee;
+    });
+
+    Slices slices(NUM_SLICES);
+    for (auto &slice : slices)
+    {
+      LaneOccupancy occupancy{NUM_LANES};
+
+      for (auto it = candidates.begin(); (it != candidates.end()) && !occupancy.full();)
+      {
+        if (occupancy.Collides(it->first))
+        {
+          ++it;
+          continue;
+        }
+
+        occupancy.Occupy(it->first);
+        slice.push_back(it->second);
+        it = candidates.erase(it);
+      }
+    }
+
+    return slices;
+  }
+
+  static Slices Pack(Mempool &mempool)
+  {
+    Slices slices(NUM_SLICES);
+    for (auto &slice : slices)
+    {
+      LaneOccupancy occupancy{NUM_LANES};
+      mempool.Fill(slice, occupancy);
+    }
+
+    return slices;
+  }
+
+  Rng rng_{42};
+};
+
+constexpr uint32_t    MempoolTests::LOG2_NUM_LANES;
+constexpr std::size_t MempoolTests::NUM_LANES;
+constexpr std::size_t MempoolTests::NUM_SLICES;
+
+TEST_F(MempoolTests, MatchesTheGreedyPacking)
+{
+  auto const summaries = CreateTransactions(60, 1000);
+
+  Mempool mempool;
+  for (auto const &summary : summaries)
+  {
+    mempool.Add(summary, LOG2_NUM_LANES);
+  }
+
+  EXPECT_EQ(summaries.size(), mempool.size());
+
+  auto const expected = PackReference(summaries);
+  auto const actual   = Pack(mempool);
+
+  std::size_t packed{0};
+  for (std::size_t i = 0; i < NUM_SLICES; ++i)
+  {
+    EXPECT_EQ(expected[i], actual[i]);
+    packed += actual[i].size();
+  }
+
+  EXPECT_GT(packed, 0u);
+  EXPECT_EQ(summaries.size() - packed, mempool.size());
+}
+
+TEST_F(MempoolTests, EqualFeesArePackedInArrivalOrder)
+{
+  auto const summaries = CreateTransactions(60, 1);
+
+  Mempool mempool;
+  for (auto const &summary : summaries)
+  {
+    mempool.Add(summary, LOG2_NUM_LANES);
+  }
+
+  auto const expected = PackReference(summaries);
+  auto const actual   = Pack(mempool);
+
+  for (std::size_t i = 0; i < NUM_SLICES; ++i)
+  {
+    EXPECT_EQ(expected[i], actual[i]);
+  }
+}
+
+TEST_F(MempoolTests, SlicesAreFreeOfCollisions)
+{
+  Mempool mempool;
+  for (auto const &summary : CreateTransactions(20000, 1u << 20u))
+  {
+    mempool.Add(summary, LOG2_NUM_LANES);
+  }
+
+  std::set<TransactionSummary> packed;
+  for (auto const &slice : Pack(mempool))
+  {
+    LaneOccupancy occupancy{NUM_LANES};
+
+    for (auto const &summary : slice)
+    {
+      auto const lanes = Mempool::MapToLanes(summary, LOG2_NUM_LANES);
+
+      EXPECT_FALSE(occupancy.Collides(lanes));
+      occupancy.Occupy(lanes);
+
+      EXPECT_TRUE(packed.insert(summary).second);
+    }
+
+    // with this many transactions every slice should be (nearly) full
+    EXPECT_GE(slice.size(), 4u);
+  }
+
+  EXPECT_EQ(20000u - packed.size(), mempool.size());
+}
+
+TEST_F(MempoolTests, PartiallyFilledSlicesAreToppedUp)
+{
+  auto const summaries = CreateTransactions(100, 1000);
+
+  Mempool mempool;
+  for (auto const &summary : summaries)
+  {
+    mempool.Add(summary, LOG2_NUM_LANES);
+  }
+
+  Slice         slice;
+  LaneOccupancy occupancy{NUM_LANES};
+  mempool.Fill(slice, occupancy);
+  ASSERT_FALSE(slice.empty());
+
+  // free the lanes of the first transaction, as when it is removed from the block
+  auto const removed = slice.front();
+  slice.erase(slice.begin());
+  occupancy.Release(Mempool::MapToLanes(removed, LOG2_NUM_LANES));
+
+  mempool.Fill(slice, occupancy);
+
+  LaneOccupancy check{NUM_LANES};
+  for (auto const &summary : slice)
+  {
+    auto const lanes = Mempool::MapToLanes(summary, LOG2_NUM_LANES);
+
+    EXPECT_FALSE(check.Collides(lanes));
+    EXPECT_FALSE(summary == removed);
+    check.Occupy(lanes);
+  }
+}
+
+}  // namespace
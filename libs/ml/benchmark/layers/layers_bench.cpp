@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "math/tensor.hpp"
+#include "ml/layers/fully_connected.hpp"
+#include "ml/layers/self_attention.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <functional>
+#include <vector>
+
+// The layers flatten their input into a single sample, so the counters are per sample
+
+// A single sample of I features through a dense layer of O units
+template <class T, int I, int O>
+void BM_FullyConnectedForward(benchmark::State &state)
+{
+  using ArrayType = fetch::math::Tensor<T>;
+  using SizeType  = typename ArrayType::SizeType;
+
+  ArrayType input(std::vector<SizeType>{1, I});
+  input.FillUniformRandom();
+  std::vector<std::reference_wrapper<ArrayType const>> inputs({input});
+
+  fetch::ml::layers::FullyConnected<ArrayType> fc(I, O);
+  ArrayType                                    output(fc.ComputeOutputShape(inputs));
+
+  for (auto _ : state)
+  {
+    auto prediction = fc.Forward(inputs, output);
+    benchmark::DoNotOptimize(prediction.data().pointer());
+  }
+
+  state.counters["flops"] =
+      benchmark::Counter(double(2 * I * O), benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["samples"] = benchmark::Counter(1, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK_TEMPLATE(BM_FullyConnectedForward, float, 784, 10)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_FullyConnectedForward, float, 784, 256)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_FullyConnectedForward, float, 1024, 1024)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_FullyConnectedForward, double, 1024, 1024)->Unit(benchmark::kMicrosecond);
+
+template <class T, int I, int O>
+void BM_FullyConnectedBackward(benchmark::State &state)
+{
+  using ArrayType = fetch::math::Tensor<T>;
+  using SizeType  = typename ArrayType::SizeType;
+
+  ArrayType input(std::vector<SizeType>{1, I});
+  input.FillUniformRandom();
+  std::vector<std::reference_wrapper<ArrayType const>> inputs({input});
+
+  fetch::ml::layers::FullyConnected<ArrayType> fc(I, O);
+  ArrayType                                    output(fc.ComputeOutputShape(inputs));
+  ArrayType                                    error(fc.ComputeOutputShape(inputs));
+  error.FillUniformRandom();
+
+  // the backward pass reads the activations of the forward pass
+  fc.Forward(inputs, output);
+
+  for (auto _ : state)
+  {
+    auto gradients = fc.Backward(inputs, error);
+    benchmark::DoNotOptimize(gradients.front().data().pointer());
+  }
+
+  state.counters["flops"] =
+      benchmark::Counter(double(4 * I * O), benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["samples"] = benchmark::Counter(1, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK_TEMPLATE(BM_FullyConnectedBackward, float, 784, 10)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_FullyConnectedBackward, float, 784, 256)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_FullyConnectedBackward, float, 1024, 1024)->Unit(benchmark::kMicrosecond);
+
+// A [R x C] sample through self attention with H hidden and O output units
+template <class T, int R, int C, int H, int O>
+void BM_SelfAttentionForward(benchmark::State &state)
+{
+  using ArrayType = fetch::math::Tensor<T>;
+  using SizeType  = typename ArrayType::SizeType;
+
+  ArrayType input(std::vector<SizeType>{R, C});
+  input.FillUniformRandom();
+  std::vector<std::reference_wrapper<ArrayType const>> inputs({input});
+
+  fetch::ml::layers::SelfAttention<ArrayType> attention(R * C, O, H);
+  ArrayType                                   output(attention.ComputeOutputShape(inputs));
+
+  for (auto _ : state)
+  {
+    auto prediction = attention.Forward(inputs, output);
+    benchmark::DoNotOptimize(prediction.data().pointer());
+  }
+
+  state.counters["samples"] = benchmark::Counter(1, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK_TEMPLATE(BM_SelfAttentionForward, float, 10, 50, 64, 42)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_SelfAttentionForward, float, 32, 64, 256, 128)
+    ->Unit(benchmark::kMicrosecond);
+
+template <class T, int R, int C, int H, int O>
+void BM_SelfAttentionBackward(benchmark::State &state)
+{
+  using ArrayType = fetch::math::Tensor<T>;
+  using SizeType  = typename ArrayType::SizeType;
+
+  ArrayType input(std::vector<SizeType>{R, C});
+  input.FillUniformRandom();
+  std::vector<std::reference_wrapper<ArrayType const>> inputs({input});
+
+  fetch::ml::layers::SelfAttention<ArrayType> attention(R * C, O, H);
+  ArrayType                                   output(attention.ComputeOutputShape(inputs));
+
+  // the backward pass reads the activations of the forward pass
+  ArrayType error(attention.Forward(inputs, output).shape());
+  error.FillUniformRandom();
+
+  for (auto _ : state)
+  {
+    auto gradients = attention.Backward(inputs, error);
+    benchmark::DoNotOptimize(gradients.front().data().pointer());
+  }
+
+  state.counters["samples"] = benchmark::Counter(1, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK_TEMPLATE(BM_SelfAttentionBackward, float, 10, 50, 64, 42)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_SelfAttentionBackward, float, 32, 64, 256, 128)
+    ->Unit(benchmark::kMicrosecond);
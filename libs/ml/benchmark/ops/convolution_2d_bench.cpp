@@ -0,0 +1,95 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "math/tensor.hpp"
+#include "ml/ops/convolution_2d.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <functional>
+#include <vector>
+
+// A [C x H x W] input convolved with [F x C x K x K] kernels
+template <class T, int C, int H, int W, int F, int K>
+void BM_Convolution2DForward(benchmark::State &state)
+{
+  using ArrayType = fetch::math::Tensor<T>;
+  using SizeType  = typename ArrayType::SizeType;
+
+  ArrayType input(std::vector<SizeType>{C, H, W});
+  ArrayType kernels(std::vector<SizeType>{F, C, K, K});
+  input.FillUniformRandom();
+  kernels.FillUniformRandom();
+
+  std::vector<std::reference_wrapper<ArrayType const>> inputs({input, kernels});
+
+  fetch::ml::ops::Convolution2D<ArrayType> op;
+  ArrayType                                output(op.ComputeOutputShape(inputs));
+
+  for (auto _ : state)
+  {
+    op.Forward(inputs, output);
+    benchmark::DoNotOptimize(output.data().pointer());
+  }
+
+  state.counters["flops"] = benchmark::Counter(
+      double(2 * F * C * K * K * (H - K + 1) * (W - K + 1)),
+      benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK_TEMPLATE(BM_Convolution2DForward, float, 1, 28, 28, 16, 5)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Convolution2DForward, float, 16, 24, 24, 32, 3)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Convolution2DForward, double, 16, 24, 24, 32, 3)
+    ->Unit(benchmark::kMicrosecond);
+
+template <class T, int C, int H, int W, int F, int K>
+void BM_Convolution2DBackward(benchmark::State &state)
+{
+  using ArrayType = fetch::math::Tensor<T>;
+  using SizeType  = typename ArrayType::SizeType;
+
+  ArrayType input(std::vector<SizeType>{C, H, W});
+  ArrayType kernels(std::vector<SizeType>{F, C, K, K});
+  input.FillUniformRandom();
+  kernels.FillUniformRandom();
+
+  std::vector<std::reference_wrapper<ArrayType const>> inputs({input, kernels});
+
+  fetch::ml::ops::Convolution2D<ArrayType> op;
+  ArrayType                                error(op.ComputeOutputShape(inputs));
+  error.FillUniformRandom();
+
+  for (auto _ : state)
+  {
+    auto gradients = op.Backward(inputs, error);
+    benchmark::DoNotOptimize(gradients.data());
+  }
+
+  state.counters["flops"] = benchmark::Counter(
+      double(4 * F * C * K * K * (H - K + 1) * (W - K + 1)),
+      benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK_TEMPLATE(BM_Convolution2DBackward, float, 1, 28, 28, 16, 5)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Convolution2DBackward, float, 16, 24, 24, 32, 3)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,540 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "math/gemm.hpp"
+#include "math/tensor.hpp"
+#include "ml/ops/activations/dropout.hpp"
+#include "ml/ops/activations/elu.hpp"
+#include "ml/ops/activations/leaky_relu.hpp"
+#include "ml/ops/activations/logsigmoid.hpp"
+#include "ml/ops/activations/logsoftmax.hpp"
+#include "ml/ops/activations/randomized_relu.hpp"
+#include "ml/ops/activations/relu.hpp"
+#include "ml/ops/activations/sigmoid.hpp"
+#include "ml/ops/activations/softmax.hpp"
+#include "ml/ops/add.hpp"
+#include "ml/ops/embeddings.hpp"
+#include "ml/ops/flatten.hpp"
+#include "ml/ops/fused_matrix_multiply_add.hpp"
+#include "ml/ops/leaky_relu_op.hpp"
+#include "ml/ops/loss_functions/cross_entropy.hpp"
+#include "ml/ops/loss_functions/mean_square_error.hpp"
+#include "ml/ops/loss_functions/softmax_cross_entropy.hpp"
+#include "ml/ops/matrix_multiply.hpp"
+#include "ml/ops/tanh.hpp"
+#include "ml/ops/transpose.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// Multiply and Divide are not covered, they still implement the shared pointer interface
+
+namespace {
+
+using FloatTensor = fetch::math::Tensor<float>;
+using SizeType    = FloatTensor::SizeType;
+
+// the element wise ops run over a batch of BATCH samples of FEATURES values
+constexpr SizeType BATCH    = 128;
+constexpr SizeType FEATURES = 1024;
+
+// uniform values in [-1, 1) so that the piecewise activations take both branches
+template <class ArrayType>
+ArrayType Random(std::vector<SizeType> const &shape)
+{
+  using DataType = typename ArrayType::Type;
+
+  ArrayType array(shape);
+  array.FillUniformRandom();
+  for (auto &value : array)
+  {
+    value = value * DataType(2) - DataType(1);
+  }
+  return array;
+}
+
+void ElementsProcessed(benchmark::State &state, SizeType elements, SizeType samples)
+{
+  state.counters["elements"] =
+      benchmark::Counter(double(elements), benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["samples"] =
+      benchmark::Counter(double(samples), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void FlopsProcessed(benchmark::State &state, double flops, SizeType samples)
+{
+  state.counters["flops"] =
+      benchmark::Counter(flops, benchmark::Counter::kIsIterationInvariantRate);
+  state.counters["samples"] =
+      benchmark::Counter(double(samples), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// the gemm based ops are benchmarked with 1, 2, 4, ... threads up to the hardware concurrency
+void ThreadCounts(benchmark::internal::Benchmark *benchmark)
+{
+  SizeType const hardware = std::max(SizeType(std::thread::hardware_concurrency()), SizeType(1));
+  for (SizeType threads = 1; threads < hardware; threads *= 2)
+  {
+    benchmark->Arg(int64_t(threads));
+  }
+  benchmark->Arg(int64_t(hardware));
+}
+
+// the ops are default constructed unless they need parameters
+template <class OpType>
+OpType MakeOp()
+{
+  return OpType();
+}
+
+template <>
+fetch::ml::ops::LeakyRelu<FloatTensor> MakeOp<fetch::ml::ops::LeakyRelu<FloatTensor>>()
+{
+  return fetch::ml::ops::LeakyRelu<FloatTensor>(0.01f);
+}
+
+template <>
+fetch::ml::ops::RandomizedRelu<FloatTensor> MakeOp<fetch::ml::ops::RandomizedRelu<FloatTensor>>()
+{
+  return fetch::ml::ops::RandomizedRelu<FloatTensor>(0.03f, 0.08f);
+}
+
+template <>
+fetch::ml::ops::Elu<FloatTensor> MakeOp<fetch::ml::ops::Elu<FloatTensor>>()
+{
+  return fetch::ml::ops::Elu<FloatTensor>(1.0f);
+}
+
+template <>
+fetch::ml::ops::Dropout<FloatTensor> MakeOp<fetch::ml::ops::Dropout<FloatTensor>>()
+{
+  return fetch::ml::ops::Dropout<FloatTensor>(0.5f);
+}
+
+// the element wise activations only index their gradients linearly, so run over a flat input
+template <class OpType>
+std::vector<SizeType> InputShape()
+{
+  return {BATCH * FEATURES};
+}
+
+template <>
+std::vector<SizeType> InputShape<fetch::ml::ops::Softmax<FloatTensor>>()
+{
+  return {BATCH, FEATURES};
+}
+
+template <>
+std::vector<SizeType> InputShape<fetch::ml::ops::LogSoftmax<FloatTensor>>()
+{
+  return {BATCH, FEATURES};
+}
+
+template <>
+std::vector<SizeType> InputShape<fetch::ml::ops::Flatten<FloatTensor>>()
+{
+  return {BATCH, FEATURES};
+}
+
+template <>
+std::vector<SizeType> InputShape<fetch::ml::ops::Transpose<FloatTensor>>()
+{
+  return {BATCH, FEATURES};
+}
+
+}  // namespace
+
+// Single input ops over BATCH samples of FEATURES values
+template <class OpType>
+void BM_UnaryForward(benchmark::State &state)
+{
+  using ArrayType = typename OpType::ArrayType;
+
+  ArrayType input = Random<ArrayType>(InputShape<OpType>());
+  std::vector<std::reference_wrapper<ArrayType const>> inputs({input});
+
+  OpType    op = MakeOp<OpType>();
+  ArrayType output(op.ComputeOutputShape(inputs));
+
+  for (auto _ : state)
+  {
+    op.Forward(inputs, output);
+    benchmark::DoNotOptimize(output.data().pointer());
+  }
+
+  ElementsProcessed(state, input.size(), BATCH);
+}
+
+template <class OpType>
+void BM_UnaryBackward(benchmark::State &state)
+{
+  using ArrayType = typename OpType::ArrayType;
+
+  ArrayType input = Random<ArrayType>(InputShape<OpType>());
+  std::vector<std::reference_wrapper<ArrayType const>> inputs({input});
+
+  OpType    op = MakeOp<OpType>();
+  ArrayType output(op.ComputeOutputShape(inputs));
+  ArrayType error = Random<ArrayType>(output.shape());
+
+  // some ops keep state from the forward pass (e.g. the dropout mask)
+  op.Forward(inputs, output);
+
+  for (auto _ : state)
+  {
+    auto gradients = op.Backward(inputs, error);
+    benchmark::DoNotOptimize(gradients.front().data().pointer());
+  }
+
+  ElementsProcessed(state, input.size(), BATCH);
+}
+
+BENCHMARK_TEMPLATE(BM_UnaryForward, fetch::ml::ops::Relu<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryBackward, fetch::ml::ops::Relu<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryForward, fetch::ml::ops::LeakyRelu<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryBackward, fetch::ml::ops::LeakyRelu<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryForward, fetch::ml::ops::RandomizedRelu<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryBackward, fetch::ml::ops::RandomizedRelu<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryForward, fetch::ml::ops::Elu<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryBackward, fetch::ml::ops::Elu<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryForward, fetch::ml::ops::Sigmoid<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryBackward, fetch::ml::ops::Sigmoid<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryForward, fetch::ml::ops::LogSigmoid<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryBackward, fetch::ml::ops::LogSigmoid<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryForward, fetch::ml::ops::Softmax<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryBackward, fetch::ml::ops::Softmax<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryForward, fetch::ml::ops::LogSoftmax<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryBackward, fetch::ml::ops::LogSoftmax<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryForward, fetch::ml::ops::Dropout<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryBackward, fetch::ml::ops::Dropout<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryForward, fetch::ml::ops::TanH<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryBackward, fetch::ml::ops::TanH<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryForward, fetch::ml::ops::Flatten<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryBackward, fetch::ml::ops::Flatten<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryForward, fetch::ml::ops::Transpose<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_UnaryBackward, fetch::ml::ops::Transpose<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+
+// Two input ops over a pair of [BATCH x FEATURES] inputs
+template <class OpType>
+void BM_BinaryForward(benchmark::State &state)
+{
+  using ArrayType = typename OpType::ArrayType;
+
+  ArrayType lhs = Random<ArrayType>({BATCH, FEATURES});
+  ArrayType rhs = Random<ArrayType>({BATCH, FEATURES});
+  std::vector<std::reference_wrapper<ArrayType const>> inputs({lhs, rhs});
+
+  OpType    op;
+  ArrayType output(op.ComputeOutputShape(inputs));
+
+  for (auto _ : state)
+  {
+    op.Forward(inputs, output);
+    benchmark::DoNotOptimize(output.data().pointer());
+  }
+
+  ElementsProcessed(state, lhs.size(), BATCH);
+}
+
+template <class OpType>
+void BM_BinaryBackward(benchmark::State &state)
+{
+  using ArrayType = typename OpType::ArrayType;
+
+  ArrayType lhs = Random<ArrayType>({BATCH, FEATURES});
+  ArrayType rhs = Random<ArrayType>({BATCH, FEATURES});
+  std::vector<std::reference_wrapper<ArrayType const>> inputs({lhs, rhs});
+
+  OpType    op;
+  ArrayType error = Random<ArrayType>(op.ComputeOutputShape(inputs));
+
+  for (auto _ : state)
+  {
+    auto gradients = op.Backward(inputs, error);
+    benchmark::DoNotOptimize(gradients.front().data().pointer());
+  }
+
+  ElementsProcessed(state, lhs.size(), BATCH);
+}
+
+BENCHMARK_TEMPLATE(BM_BinaryForward, fetch::ml::ops::Add<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_BinaryBackward, fetch::ml::ops::Add<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_BinaryForward, fetch::ml::ops::LeakyReluOp<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_BinaryBackward, fetch::ml::ops::LeakyReluOp<FloatTensor>)
+    ->Unit(benchmark::kMicrosecond);
+
+// A [M x K] by [K x N] product, the argument is the number of threads
+template <class T, int M, int K, int N>
+void BM_MatrixMultiplyForward(benchmark::State &state)
+{
+  using ArrayType = fetch::math::Tensor<T>;
+
+  fetch::math::SetMaxThreads(SizeType(state.range(0)));
+
+  ArrayType a = Random<ArrayType>({M, K});
+  ArrayType b = Random<ArrayType>({K, N});
+  std::vector<std::reference_wrapper<ArrayType const>> inputs({a, b});
+
+  fetch::ml::ops::MatrixMultiply<ArrayType> op;
+  ArrayType                                 output(op.ComputeOutputShape(inputs));
+
+  for (auto _ : state)
+  {
+    op.Forward(inputs, output);
+    benchmark::DoNotOptimize(output.data().pointer());
+  }
+
+  FlopsProcessed(state, 2.0 * M * K * N, M);
+  fetch::math::SetMaxThreads(0);
+}
+
+template <class T, int M, int K, int N>
+void BM_MatrixMultiplyBackward(benchmark::State &state)
+{
+  using ArrayType = fetch::math::Tensor<T>;
+
+  fetch::math::SetMaxThreads(SizeType(state.range(0)));
+
+  ArrayType a     = Random<ArrayType>({M, K});
+  ArrayType b     = Random<ArrayType>({K, N});
+  ArrayType error = Random<ArrayType>({M, N});
+  std::vector<std::reference_wrapper<ArrayType const>> inputs({a, b});
+
+  fetch::ml::ops::MatrixMultiply<ArrayType> op;
+
+  for (auto _ : state)
+  {
+    auto gradients = op.Backward(inputs, error);
+    benchmark::DoNotOptimize(gradients.front().data().pointer());
+  }
+
+  FlopsProcessed(state, 4.0 * M * K * N, M);
+  fetch::math::SetMaxThreads(0);
+}
+
+BENCHMARK_TEMPLATE(BM_MatrixMultiplyForward, float, 128, 784, 256)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MatrixMultiplyForward, float, 512, 512, 512)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MatrixMultiplyForward, double, 512, 512, 512)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MatrixMultiplyBackward, float, 128, 784, 256)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_MatrixMultiplyBackward, float, 512, 512, 512)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMicrosecond);
+
+// relu(x.w + b) for a [M x K] input and [K x N] weights
+template <class T, int M, int K, int N>
+void BM_FusedMatrixMultiplyAddForward(benchmark::State &state)
+{
+  using ArrayType = fetch::math::Tensor<T>;
+
+  fetch::math::SetMaxThreads(SizeType(state.range(0)));
+
+  ArrayType x    = Random<ArrayType>({M, K});
+  ArrayType w    = Random<ArrayType>({K, N});
+  ArrayType bias = Random<ArrayType>({M, N});
+  std::vector<std::reference_wrapper<ArrayType const>> inputs({x, w, bias});
+
+  fetch::ml::ops::FusedMatrixMultiplyAdd<ArrayType> op(true);
+  ArrayType                                         output(op.ComputeOutputShape(inputs));
+
+  for (auto _ : state)
+  {
+    op.Forward(inputs, output);
+    benchmark::DoNotOptimize(output.data().pointer());
+  }
+
+  FlopsProcessed(state, 2.0 * M * K * N + 2.0 * M * N, M);
+  fetch::math::SetMaxThreads(0);
+}
+
+template <class T, int M, int K, int N>
+void BM_FusedMatrixMultiplyAddBackward(benchmark::State &state)
+{
+  using ArrayType = fetch::math::Tensor<T>;
+
+  fetch::math::SetMaxThreads(SizeType(state.range(0)));
+
+  ArrayType x     = Random<ArrayType>({M, K});
+  ArrayType w     = Random<ArrayType>({K, N});
+  ArrayType bias  = Random<ArrayType>({M, N});
+  ArrayType error = Random<ArrayType>({M, N});
+  std::vector<std::reference_wrapper<ArrayType const>> inputs({x, w, bias});
+
+  fetch::ml::ops::FusedMatrixMultiplyAdd<ArrayType> op(true);
+  ArrayType                                         output(op.ComputeOutputShape(inputs));
+  op.Forward(inputs, output);
+
+  for (auto _ : state)
+  {
+    auto gradients = op.Backward(inputs, error);
+    benchmark::DoNotOptimize(gradients.front().data().pointer());
+  }
+
+  FlopsProcessed(state, 4.0 * M * K * N, M);
+  fetch::math::SetMaxThreads(0);
+}
+
+BENCHMARK_TEMPLATE(BM_FusedMatrixMultiplyAddForward, float, 128, 784, 256)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_FusedMatrixMultiplyAddBackward, float, 128, 784, 256)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMicrosecond);
+
+// Looks up BATCH rows of a [V x D] embedding matrix
+template <class T, int V, int D>
+void BM_EmbeddingsForward(benchmark::State &state)
+{
+  using ArrayType = fetch::math::Tensor<T>;
+
+  ArrayType indices(std::vector<SizeType>{BATCH});
+  indices.FillUniformRandomIntegers(0, V - 1);
+  std::vector<std::reference_wrapper<ArrayType const>> inputs({indices});
+
+  fetch::ml::ops::Embeddings<ArrayType> op(V, D);
+  ArrayType                             output;
+
+  for (auto _ : state)
+  {
+    auto embedded = op.Forward(inputs, output);
+    benchmark::DoNotOptimize(embedded.data().pointer());
+  }
+
+  ElementsProcessed(state, BATCH * D, BATCH);
+}
+
+template <class T, int V, int D>
+void BM_EmbeddingsBackward(benchmark::State &state)
+{
+  using ArrayType = fetch::math::Tensor<T>;
+
+  ArrayType indices(std::vector<SizeType>{BATCH});
+  indices.FillUniformRandomIntegers(0, V - 1);
+  std::vector<std::reference_wrapper<ArrayType const>> inputs({indices});
+
+  fetch::ml::ops::Embeddings<ArrayType> op(V, D);
+  ArrayType                             error = Random<ArrayType>({BATCH, D});
+
+  for (auto _ : state)
+  {
+    auto gradients = op.Backward(inputs, error);
+    benchmark::DoNotOptimize(gradients.front().data().pointer());
+  }
+
+  ElementsProcessed(state, BATCH * D, BATCH);
+}
+
+BENCHMARK_TEMPLATE(BM_EmbeddingsForward, float, 10000, 100)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_EmbeddingsBackward, float, 10000, 100)->Unit(benchmark::kMicrosecond);
+
+// Loss of a [BATCH x C] prediction against one hot ground truth
+template <class LossType, int C>
+void BM_LossForward(benchmark::State &state)
+{
+  using ArrayType = typename LossType::ArrayType;
+
+  ArrayType prediction(std::vector<SizeType>{BATCH, C});
+  ArrayType ground_truth(std::vector<SizeType>{BATCH, C});
+  prediction.FillUniformRandom();
+  for (SizeType i = 0; i < BATCH; ++i)
+  {
+    ground_truth.At(i, i % C) = typename ArrayType::Type(1);
+  }
+
+  LossType loss;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(loss.Forward({prediction, ground_truth}));
+  }
+
+  ElementsProcessed(state, prediction.size(), BATCH);
+}
+
+template <class LossType, int C>
+void BM_LossBackward(benchmark::State &state)
+{
+  using ArrayType = typename LossType::ArrayType;
+
+  ArrayType prediction(std::vector<SizeType>{BATCH, C});
+  ArrayType ground_truth(std::vector<SizeType>{BATCH, C});
+  prediction.FillUniformRandom();
+  for (SizeType i = 0; i < BATCH; ++i)
+  {
+    ground_truth.At(i, i % C) = typename ArrayType::Type(1);
+  }
+
+  LossType loss;
+  for (auto _ : state)
+  {
+    auto gradient = loss.Backward({prediction, ground_truth});
+    benchmark::DoNotOptimize(gradient.data().pointer());
+  }
+
+  ElementsProcessed(state, prediction.size(), BATCH);
+}
+
+BENCHMARK_TEMPLATE(BM_LossForward, fetch::ml::ops::MeanSquareError<FloatTensor>, 10)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_LossBackward, fetch::ml::ops::MeanSquareError<FloatTensor>, 10)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_LossForward, fetch::ml::ops::CrossEntropy<FloatTensor>, 10)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_LossBackward, fetch::ml::ops::CrossEntropy<FloatTensor>, 10)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_LossForward, fetch::ml::ops::SoftmaxCrossEntropy<FloatTensor>, 10)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_LossBackward, fetch::ml::ops::SoftmaxCrossEntropy<FloatTensor>, 10)
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "math/tensor.hpp"
+#include "ml/data_parallel_trainer.hpp"
+#include "ml/graph.hpp"
+#include "ml/layers/fully_connected.hpp"
+#include "ml/layers/skip_gram.hpp"
+#include "ml/ops/activation.hpp"
+#include "ml/ops/loss_functions/cross_entropy.hpp"
+#include "ml/ops/placeholder.hpp"
+
+#include "benchmark/benchmark.h"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+// One mini batch step of the example models on random data, the argument is the number of
+// worker threads the batch is split across
+
+namespace {
+
+using ArrayType = fetch::math::Tensor<float>;
+using DataType  = ArrayType::Type;
+using SizeType  = ArrayType::SizeType;
+using GraphType = fetch::ml::Graph<ArrayType>;
+
+constexpr SizeType BATCH = 64;
+
+void ThreadCounts(benchmark::internal::Benchmark *benchmark)
+{
+  SizeType const hardware = std::max(SizeType(std::thread::hardware_concurrency()), SizeType(1));
+  for (SizeType threads = 1; threads < hardware; threads *= 2)
+  {
+    benchmark->Arg(int64_t(threads));
+  }
+  benchmark->Arg(int64_t(hardware));
+}
+
+// the model of the mnist example
+void BuildMnist(GraphType &g)
+{
+  g.AddNode<fetch::ml::ops::PlaceHolder<ArrayType>>("Input", {});
+  g.AddNode<fetch::ml::layers::FullyConnected<ArrayType>>("FC1", {"Input"}, 28u * 28u, 10u);
+  g.AddNode<fetch::ml::ops::Relu<ArrayType>>("Relu1", {"FC1"});
+  g.AddNode<fetch::ml::layers::FullyConnected<ArrayType>>("FC2", {"Relu1"}, 10u, 10u);
+  g.AddNode<fetch::ml::ops::Relu<ArrayType>>("Relu2", {"FC2"});
+  g.AddNode<fetch::ml::layers::FullyConnected<ArrayType>>("FC3", {"Relu2"}, 10u, 10u);
+  g.AddNode<fetch::ml::ops::Softmax<ArrayType>>("Softmax", {"FC3"});
+}
+
+// the model of the skip gram word2vec example
+template <int E, int V>
+void BuildSkipGram(GraphType &g)
+{
+  g.AddNode<fetch::ml::ops::PlaceHolder<ArrayType>>("Input", {});
+  g.AddNode<fetch::ml::ops::PlaceHolder<ArrayType>>("Context", {});
+  g.AddNode<fetch::ml::layers::SkipGram<ArrayType>>("SkipGram", {"Input", "Context"}, SizeType(1),
+                                                    SizeType(1), SizeType(E), SizeType(V));
+}
+
+}  // namespace
+
+void BM_MnistTrainingStep(benchmark::State &state)
+{
+  SizeType const classes = 10;
+
+  std::mt19937 rng(1);
+
+  std::vector<ArrayType> images;
+  std::vector<SizeType>  labels;
+  for (SizeType i = 0; i < BATCH; ++i)
+  {
+    images.emplace_back(std::vector<SizeType>({28, 28}));
+    images.back().FillUniformRandom();
+    labels.push_back(rng() % classes);
+  }
+
+  fetch::ml::DataParallelTrainer<ArrayType> trainer(SizeType(state.range(0)), BuildMnist);
+
+  auto train_example = [&](GraphType &g, SizeType idx) {
+    fetch::ml::ops::CrossEntropy<ArrayType> criterion;
+
+    ArrayType gt(std::vector<SizeType>({1, classes}));
+    gt.At(0, labels[idx]) = DataType(1);
+
+    g.SetInput("Input", images[idx]);
+    ArrayType results = g.Evaluate("Softmax").Copy();
+    g.BackPropagate("Softmax", criterion.Backward({results, gt}));
+    return criterion.Forward({results, gt});
+  };
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(trainer.TrainBatch(BATCH, train_example));
+    trainer.Step(DataType(0.01));
+  }
+
+  state.counters["samples"] =
+      benchmark::Counter(double(BATCH), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK(BM_MnistTrainingStep)->Apply(ThreadCounts)->Unit(benchmark::kMillisecond);
+
+// E dimensional embeddings of a vocabulary of V words, one negative sample per positive one
+template <int E, int V>
+void BM_SkipGramTrainingStep(benchmark::State &state)
+{
+  std::mt19937 rng(1);
+
+  std::vector<SizeType> words;
+  std::vector<SizeType> contexts;
+  for (SizeType i = 0; i < BATCH; ++i)
+  {
+    words.push_back(rng() % V);
+    contexts.push_back(rng() % V);
+  }
+
+  fetch::ml::DataParallelTrainer<ArrayType> trainer(SizeType(state.range(0)),
+                                                    BuildSkipGram<E, V>);
+
+  auto train_example = [&](GraphType &g, SizeType idx) {
+    fetch::ml::ops::CrossEntropy<ArrayType> criterion;
+
+    ArrayType input(std::vector<SizeType>({1, 1}));
+    ArrayType context(std::vector<SizeType>({1, 1}));
+    ArrayType gt(std::vector<SizeType>({1, 1}));
+    input.At(0, 0)   = DataType(words[idx]);
+    context.At(0, 0) = DataType(contexts[idx]);
+    gt.At(0, 0)      = DataType(idx % 2);
+
+    g.SetInput("Input", input, false);
+    g.SetInput("Context", context, false);
+    ArrayType results = g.Evaluate("SkipGram");
+    g.BackPropagate("SkipGram", criterion.Backward({results, gt}));
+    return criterion.Forward({results, gt});
+  };
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(trainer.TrainBatch(BATCH, train_example));
+    trainer.Step(DataType(0.01));
+  }
+
+  state.counters["samples"] =
+      benchmark::Counter(double(BATCH), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK_TEMPLATE(BM_SkipGramTrainingStep, 100, 10000)
+    ->Apply(ThreadCounts)
+    ->Unit(benchmark::kMillisecond);
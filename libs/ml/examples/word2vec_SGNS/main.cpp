@@ -22,6 +22,7 @@
 #include "math/clustering/knn.hpp"
 #include "math/matrix_operations.hpp"
 
+#include "ml/data_parallel_trainer.hpp"
 #include "ml/dataloaders/word2vec_loaders/skipgram_dataloader.hpp"
 #include "ml/graph.hpp"
 #include "ml/layers/skip_gram.hpp"
@@ -54,6 +55,7 @@ struct TrainingParams
   SizeType    k               = 10;             // how many nearest neighbours to compare against
   std::string test_word       = "action";       // test word to consider
   std::string save_loc        = "./model.fba";  // save file location for exporting graph
+  SizeType    num_threads     = 0;              // number of training threads, 0 uses all cores
 };
 
 template <typename T>
@@ -167,13 +169,14 @@ int main(int argc, char **argv)
   /// SETUP MODEL ARCHITECTURE ///
   ////////////////////////////////
 
-  // set up model architecture
+  // set up model architecture, one replica of the graph per worker thread
   std::cout << "building model architecture...: " << std::endl;
-  fetch::ml::Graph<ArrayType> g;
-  std::string                 output_name = Model(g, tp.embedding_size, dataloader.VocabSize());
-
-  // set up loss
-  CrossEntropy<ArrayType> criterion;
+  std::string                               output_name;
+  fetch::ml::DataParallelTrainer<ArrayType> trainer(
+      tp.num_threads, [&output_name, &tp, &dataloader](fetch::ml::Graph<ArrayType> &g) {
+        output_name = Model(g, tp.embedding_size, dataloader.VocabSize());
+      });
+  std::cout << "training on [" << trainer.NumWorkers() << "] threads" << std::endl;
 
   /////////////////////////////////
   /// TRAIN THE WORD EMBEDDINGS ///
@@ -181,24 +184,54 @@ int main(int argc, char **argv)
 
   std::cout << "beginning training...: " << std::endl;
 
-  std::pair<ArrayType, SizeType> data;
-  ArrayType                      input(std::vector<typename ArrayType::SizeType>({1, 1}));
-  ArrayType                      context(std::vector<typename ArrayType::SizeType>({1, 1}));
-  ArrayType                      gt(std::vector<typename ArrayType::SizeType>({1, tp.output_size}));
-  ArrayType                      scale_factor(std::vector<typename ArrayType::SizeType>({1, 1}));
+  // the batch is drawn from the dataloader up front, the workers only read it
+  std::vector<std::pair<ArrayType, SizeType>> batch;
+  std::vector<char>                           correct;
+
+  // forward and backward pass for one example of the batch, run concurrently on the replicas
+  auto train_example = [&](fetch::ml::Graph<ArrayType> &g, SizeType idx) {
+    CrossEntropy<ArrayType> criterion;
+
+    ArrayType input(std::vector<typename ArrayType::SizeType>({1, 1}));
+    ArrayType context(std::vector<typename ArrayType::SizeType>({1, 1}));
+    ArrayType gt(std::vector<typename ArrayType::SizeType>({1, tp.output_size}));
+
+    // assign input and context vectors
+    input.At(0, 0)   = batch[idx].first.At(0);
+    context.At(0, 0) = batch[idx].first.At(1);
+
+    // assign label
+    gt.At(0, 0) = DataType(batch[idx].second);
+
+    g.SetInput("Input", input, false);
+    g.SetInput("Context", context, false);
+
+    // forward pass
+    ArrayType results = g.Evaluate(output_name);
+
+    correct[idx] = ((results.At(0, 0) >= DataType(0.5)) && (gt.At(0, 0) == DataType(1))) ||
+                   ((results.At(0, 0) < DataType(0.5)) && (gt.At(0, 0) == DataType(0)));
+
+    DataType loss = criterion.Forward({results, gt});
+
+    // diminish size of updates due to negative examples
+    if (batch[idx].second == 0)
+    {
+      loss /= DataType(sp.k_negative_samples);
+    }
+
+    // backprop
+    g.BackPropagate(output_name, criterion.Backward(std::vector<ArrayType>({results, gt})));
+    return loss;
+  };
 
-  DataType correct_score      = 0;
   DataType sum_average_scores = 0;
   DataType sum_average_count  = 0;
-  DataType loss               = 0;
-  DataType batch_loss         = 0;
   DataType epoch_loss         = 0;
 
   SizeType batch_count = 0;
   SizeType step_count  = 0;
 
-  ArrayType results;  // store predictions
-
   for (SizeType i = 0; i < tp.training_epochs; ++i)
   {
     dataloader.Reset();
@@ -210,74 +243,37 @@ int main(int argc, char **argv)
     step_count  = 0;
 
     epoch_loss = 0;
-    batch_loss = 0;
 
     // effectively clears any leftover gradients
-    g.Step(0);
+    trainer.Step(0);
 
     while (!dataloader.IsDone())
     {
-      gt.Fill(DataType(0));
-
-      // get random data point
-      data = dataloader.GetRandom();
-
-      // assign input and context vectors
-      input.At(0, 0)   = data.first.At(0);
-      context.At(0, 0) = data.first.At(1);
-
-      // assign label
-      gt.At(0, 0) = DataType(data.second);
-
-      g.SetInput("Input", input, false);
-      g.SetInput("Context", context, false);
-
-      // forward pass
-      results = g.Evaluate(output_name);
-
-      scale_factor.At(0, 0) =
-          (gt.At(0, 0) == DataType(0)) ? DataType(sp.k_negative_samples) : DataType(1);
-
-      if (((results.At(0, 0) >= DataType(0.5)) && (gt.At(0, 0) == DataType(1))) ||
-          ((results.At(0, 0) < DataType(0.5)) && (gt.At(0, 0) == DataType(0))))
-      {
-        ++correct_score;
-      }
-
-      loss = criterion.Forward({results, gt});
-
-      // diminish size of updates due to negative examples
-      if (data.second == 0)
+      // get random data points
+      batch.clear();
+      while ((batch.size() < tp.batch_size) && !dataloader.IsDone())
       {
-        loss /= DataType(sp.k_negative_samples);
+        auto data = dataloader.GetRandom();
+        batch.emplace_back(data.first.Copy(), data.second);
       }
-      batch_loss += loss;
-
-      // backprop
-      g.BackPropagate(output_name, criterion.Backward(std::vector<ArrayType>({results, gt})));
+      correct.assign(batch.size(), 0);
 
       // take mini-batch learning step
-      if (step_count % tp.batch_size == (tp.batch_size - 1))
-      {
-        g.Step(tp.learning_rate);
-
-        // average prediction scores
-        sum_average_scores += (correct_score / double(tp.batch_size));
-        sum_average_count++;
-        correct_score = 0;
+      epoch_loss += trainer.TrainBatch(batch.size(), train_example);
+      trainer.Step(tp.learning_rate);
 
-        // sum epoch losses
-        epoch_loss += batch_loss;
-        batch_loss = 0;
+      // average prediction scores
+      sum_average_scores +=
+          DataType(std::accumulate(correct.begin(), correct.end(), 0)) / DataType(batch.size());
+      sum_average_count++;
 
-        ++batch_count;
-      }
-      ++step_count;
+      ++batch_count;
+      step_count += batch.size();
     }
 
     // print batch loss and embeddings distances
     // Test trained embeddings
-    TestEmbeddings(g, output_name, dataloader, tp.test_word, tp.k);
+    TestEmbeddings(trainer.GetGraph(), output_name, dataloader, tp.test_word, tp.k);
     std::cout << "epoch_loss: " << epoch_loss << std::endl;
     std::cout << "average_score: " << sum_average_scores / sum_average_count << std::endl;
     std::cout << "over [" << batch_count << "] batches involving [" << step_count
@@ -285,7 +281,7 @@ int main(int argc, char **argv)
     std::cout << "\n: " << std::endl;
 
     // Save model
-    fetch::ml::examples::SaveModel(g, tp.save_loc);
+    fetch::ml::examples::SaveModel(trainer.GetGraph(), tp.save_loc);
   }
 
   //////////////////////////////////////
@@ -293,7 +289,7 @@ int main(int argc, char **argv)
   //////////////////////////////////////
 
   // Test trained embeddings
-  TestEmbeddings(g, output_name, dataloader, tp.test_word, tp.k);
+  TestEmbeddings(trainer.GetGraph(), output_name, dataloader, tp.test_word, tp.k);
 
   return 0;
 }
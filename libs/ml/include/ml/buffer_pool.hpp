@@ -0,0 +1,99 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace fetch {
+namespace ml {
+
+/**
+ * A pool of released node outputs which can be handed to later nodes of the same size, so that
+ * evaluating a graph does not allocate a fresh output for every node. The pool is not thread safe,
+ * buffers are acquired and released by the thread driving the evaluation
+ * @tparam T  the tensor/array type
+ */
+template <class T>
+class BufferPool
+{
+public:
+  using ArrayType = T;
+  using SizeType  = typename ArrayType::SizeType;
+  using ShapeType = std::vector<SizeType>;
+
+  /**
+   * Returns a buffer to the pool. Only buffers whose storage is not shared with any other array
+   * are kept, since anything else may still be read (e.g. placeholder data or weights)
+   * @param buffer the released buffer
+   * @return true if the buffer was taken by the pool
+   */
+  bool Release(ArrayType buffer)
+  {
+    if ((buffer.size() == 0) || (buffer.data().UseCount() != 1))
+    {
+      return false;
+    }
+
+    free_.push_back(std::move(buffer));
+    return true;
+  }
+
+  /**
+   * Takes a buffer with exactly as many elements as the requested shape out of the pool
+   * @param shape the shape the buffer is required to have
+   * @param buffer the array to be assigned the buffer
+   * @return true if a matching buffer was found
+   */
+  bool Acquire(ShapeType const &shape, ArrayType &buffer)
+  {
+    SizeType const size = ArrayType::SizeFromShape(shape);
+
+    for (auto it = free_.begin(); it != free_.end(); ++it)
+    {
+      if (it->size() == size)
+      {
+        buffer = std::move(*it);
+        free_.erase(it);
+        buffer.Reshape(shape);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Drops all of the pooled buffers
+   */
+  void Clear()
+  {
+    free_.clear();
+  }
+
+  std::size_t size() const
+  {
+    return free_.size();
+  }
+
+private:
+  std::vector<ArrayType> free_;
+};
+
+}  // namespace ml
+}  // namespace fetch
@@ -0,0 +1,576 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/random/lfg.hpp"
+#include "math/base_types.hpp"
+#include "math/clustering/knn.hpp"
+#include "math/gemm.hpp"
+#include "math/tensor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace fetch {
+namespace ml {
+namespace details {
+
+/**
+ * A space partitioning tree over the points of a t-SNE embedding, a quadtree in two dimensions and
+ * an octree in three. Every cell keeps the number of points under it and their centre of mass, so
+ * that the repulsion from a cell which is small compared to its distance can be computed as from a
+ * single point.
+ */
+class SpacePartitioningTree
+{
+public:
+  using SizeType = fetch::math::SizeType;
+
+  /**
+   * @param points the points, one after another
+   * @param n_points the number of points
+   * @param dimensions the number of dimensions of every point
+   */
+  SpacePartitioningTree(double const *points, SizeType n_points, SizeType dimensions)
+    : dimensions_(dimensions)
+    , n_children_(SizeType{1} << dimensions)
+  {
+    std::vector<double> lowest(dimensions_, std::numeric_limits<double>::max());
+    std::vector<double> highest(dimensions_, std::numeric_limits<double>::lowest());
+    for (SizeType i = 0; i < n_points; ++i)
+    {
+      for (SizeType j = 0; j < dimensions_; ++j)
+      {
+        lowest[j]  = std::min(lowest[j], points[(i * dimensions_) + j]);
+        highest[j] = std::max(highest[j], points[(i * dimensions_) + j]);
+      }
+    }
+
+    double half_width = 0;
+    for (SizeType j = 0; j < dimensions_; ++j)
+    {
+      half_width = std::max(half_width, (highest[j] - lowest[j]) / 2);
+      centres_.push_back((lowest[j] + highest[j]) / 2);
+    }
+    AddNode(half_width + 1e-5);
+
+    for (SizeType i = 0; i < n_points; ++i)
+    {
+      Insert(points + (i * dimensions_));
+    }
+  }
+
+  /**
+   * Adds the repulsion of all the other points of the tree on a point of the tree, with the
+   * Barnes-Hut approximation for cells whose width over distance is below theta
+   * @param point the point, which must have been inserted in the tree
+   * @param theta the accuracy of the approximation, 0 for the exact sum
+   * @param force the repulsive force before normalisation, to be accumulated into
+   * @return the sum of the unnormalised student-t affinities to all the other points
+   */
+  double Repulsion(double const *point, double theta, double *force) const
+  {
+    double sum_q = 0;
+    Repulsion(0, point, theta * theta, force, sum_q);
+    return sum_q;
+  }
+
+private:
+  static constexpr SizeType NO_CHILDREN = std::numeric_limits<SizeType>::max();
+  static constexpr SizeType MAX_DEPTH   = 64;
+
+  struct Node
+  {
+    double   half_width;
+    SizeType count       = 0;
+    SizeType first_child = NO_CHILDREN;
+  };
+
+  double SquareDistance(double const *a, double const *b) const
+  {
+    double ret = 0;
+    for (SizeType j = 0; j < dimensions_; ++j)
+    {
+      ret += (a[j] - b[j]) * (a[j] - b[j]);
+    }
+    return ret;
+  }
+
+  /// adds a node, the centre of which must just have been pushed onto centres_
+  SizeType AddNode(double half_width)
+  {
+    nodes_.emplace_back();
+    nodes_.back().half_width = half_width;
+    masses_.resize(masses_.size() + dimensions_);
+    return nodes_.size() - 1;
+  }
+
+  SizeType Child(SizeType node, double const *point) const
+  {
+    SizeType child = 0;
+    for (SizeType j = 0; j < dimensions_; ++j)
+    {
+      if (point[j] > centres_[(node * dimensions_) + j])
+      {
+        child |= SizeType{1} << j;
+      }
+    }
+    return nodes_[node].first_child + child;
+  }
+
+  void Subdivide(SizeType node)
+  {
+    double const half_width = nodes_[node].half_width / 2;
+    SizeType     first      = nodes_.size();
+    for (SizeType child = 0; child < n_children_; ++child)
+    {
+      for (SizeType j = 0; j < dimensions_; ++j)
+      {
+        double const offset = ((child >> j) & 1) ? half_width : -half_width;
+        centres_.push_back(centres_[(node * dimensions_) + j] + offset);
+      }
+      AddNode(half_width);
+    }
+    nodes_[node].first_child = first;
+  }
+
+  void Insert(double const *point)
+  {
+    SizeType node  = 0;
+    SizeType depth = 0;
+    for (;;)
+    {
+      SizeType const previous = nodes_[node].count;
+      double *       mass     = masses_.data() + (node * dimensions_);
+
+      // leaves hold a single point, or several which can not be told apart
+      if ((nodes_[node].first_child == NO_CHILDREN) &&
+          ((previous == 0) || (depth >= MAX_DEPTH) || (SquareDistance(mass, point) == 0)))
+      {
+        AddToMass(node, point);
+        return;
+      }
+
+      if (nodes_[node].first_child == NO_CHILDREN)
+      {
+        // move the points of the leaf down to a new child
+        Subdivide(node);
+        mass             = masses_.data() + (node * dimensions_);
+        SizeType const c = Child(node, mass);
+        std::copy_n(mass, dimensions_, masses_.data() + (c * dimensions_));
+        nodes_[c].count = previous;
+      }
+
+      AddToMass(node, point);
+      node = Child(node, point);
+      ++depth;
+    }
+  }
+
+  void AddToMass(SizeType node, double const *point)
+  {
+    double *     mass  = masses_.data() + (node * dimensions_);
+    double const count = static_cast<double>(++nodes_[node].count);
+    for (SizeType j = 0; j < dimensions_; ++j)
+    {
+      mass[j] += (point[j] - mass[j]) / count;
+    }
+  }
+
+  void Repulsion(SizeType node, double const *point, double square_theta, double *force,
+                 double &sum_q) const
+  {
+    Node const &current = nodes_[node];
+    if (current.count == 0)
+    {
+      return;
+    }
+
+    double const *mass          = masses_.data() + (node * dimensions_);
+    double const  distance      = SquareDistance(point, mass);
+    double const  width         = 2 * current.half_width;
+    bool const    is_leaf       = current.first_child == NO_CHILDREN;
+    double const  count         = static_cast<double>(current.count);
+    bool const    contains_self = is_leaf && (distance == 0);
+
+    if (contains_self)
+    {
+      // the points coinciding with this one attract no force but still count towards the sum
+      sum_q += count - 1;
+      return;
+    }
+
+    if (!is_leaf && ((width * width) >= (square_theta * distance)))
+    {
+      for (SizeType child = 0; child < n_children_; ++child)
+      {
+        Repulsion(current.first_child + child, point, square_theta, force, sum_q);
+      }
+      return;
+    }
+
+    double const q = 1 / (1 + distance);
+    sum_q += count * q;
+    for (SizeType j = 0; j < dimensions_; ++j)
+    {
+      force[j] += count * q * q * (point[j] - mass[j]);
+    }
+  }
+
+  SizeType            dimensions_;
+  SizeType            n_children_;
+  std::vector<Node>   nodes_;
+  std::vector<double> centres_;  // the centre of every cell
+  std::vector<double> masses_;   // the centre of mass of the points under every cell
+};
+
+}  // namespace details
+
+/**
+ *  Barnes-Hut approximation of T-SNE, based on paper:
+ *  http://jmlr.org/papers/volume15/vandermaaten14a/vandermaaten14a.pdf
+ *  The input affinities are only computed for the k = 3 * perplexity nearest neighbours of every
+ *  point, and the repulsive forces between the output points are approximated with a space
+ *  partitioning tree, which brings every iteration down from O(N^2) to O(N log N).
+ */
+template <class T>
+class BarnesHutTSNE
+{
+public:
+  using ArrayType = T;
+  using DataType  = typename ArrayType::Type;
+  using SizeType  = typename ArrayType::SizeType;
+  using RNG       = fetch::random::LaggedFibonacciGenerator<>;
+
+  static constexpr char const *DESCRIPTOR = "BarnesHutTSNE";
+
+  /**
+   * @param input_matrix the data in the format of a 2D array of n_points x n_dims
+   * @param output_matrix the initial embedding in the format n_points x n_output_dims
+   * @param perplexity the target perplexity of the input affinities
+   * @param theta the accuracy of the approximation, 0 for exact repulsive forces
+   */
+  BarnesHutTSNE(ArrayType const &input_matrix, ArrayType const &output_matrix,
+                DataType const &perplexity, DataType const &theta = DataType{0.5f})
+    : theta_(static_cast<double>(theta))
+  {
+    Init(input_matrix, output_matrix, perplexity);
+  }
+
+  BarnesHutTSNE(ArrayType const &input_matrix, SizeType const &output_dimensions,
+                DataType const &perplexity, SizeType const &random_seed,
+                DataType const &theta = DataType{0.5f})
+    : theta_(static_cast<double>(theta))
+  {
+    ArrayType output_matrix({input_matrix.shape().at(0), output_dimensions});
+    rng_.Seed(random_seed);
+    for (auto &val : output_matrix)
+    {
+      val = DataType(rng_.AsDouble());
+    }
+    Init(input_matrix, output_matrix, perplexity);
+  }
+
+  /**
+   * i.e. Optimize cost function, with the same schedule as TSNE::Optimize
+   * @param learning_rate input Learning rate
+   * @param max_iters input Number of optimization iterations
+   */
+  void Optimize(DataType const &learning_rate, SizeType const &max_iters,
+                DataType const &initial_momentum, DataType const &final_momentum,
+                SizeType const &final_momentum_steps, SizeType const &p_later_correction_iteration)
+  {
+    double const min_gain = 0.01;
+    double const rate     = static_cast<double>(learning_rate);
+    double       momentum = static_cast<double>(initial_momentum);
+
+    std::vector<double> i_y(output_.size(), 0);
+    std::vector<double> gains(output_.size(), 1);
+    std::vector<double> gradient(output_.size());
+
+    for (SizeType iter{0}; iter < max_iters; iter++)
+    {
+      ComputeGradient(gradient);
+
+      if (iter >= final_momentum_steps)
+      {
+        momentum = static_cast<double>(final_momentum);
+      }
+
+      for (SizeType i{0}; i < output_.size(); i++)
+      {
+        gains[i] = ((gradient[i] > 0.0) != (i_y[i] > 0.0)) ? gains[i] + 0.2 : gains[i] * 0.8;
+        gains[i] = std::max(gains[i], min_gain);
+
+        i_y[i] = (momentum * i_y[i]) - (rate * gains[i] * gradient[i]);
+        output_[i] += i_y[i];
+      }
+
+      // keep the embedding centred on the origin
+      for (SizeType j{0}; j < output_dimensions_; j++)
+      {
+        double mean = 0;
+        for (SizeType i{0}; i < n_points_; i++)
+        {
+          mean += output_[(i * output_dimensions_) + j];
+        }
+        mean /= static_cast<double>(n_points_);
+        for (SizeType i{0}; i < n_points_; i++)
+        {
+          output_[(i * output_dimensions_) + j] -= mean;
+        }
+      }
+
+      // Later P-values correction
+      if (iter == p_later_correction_iteration)
+      {
+        for (auto &p : affinities_)
+        {
+          p /= 4;
+        }
+      }
+    }
+  }
+
+  const ArrayType GetOutputMatrix() const
+  {
+    ArrayType ret({n_points_, output_dimensions_});
+    for (SizeType i{0}; i < n_points_; i++)
+    {
+      for (SizeType j{0}; j < output_dimensions_; j++)
+      {
+        ret.Set(i, j, DataType(output_[(i * output_dimensions_) + j]));
+      }
+    }
+    return ret;
+  }
+
+private:
+  /**
+   * i.e. Computes the sparse symmetric input affinities Pij and copies the initial embedding
+   */
+  void Init(ArrayType const &input_matrix, ArrayType const &output_matrix,
+            DataType const &perplexity)
+  {
+    n_points_          = input_matrix.shape().at(0);
+    output_dimensions_ = output_matrix.shape().at(1);
+    ASSERT(output_matrix.shape().at(0) == n_points_);
+
+    output_.resize(n_points_ * output_dimensions_);
+    for (SizeType i{0}; i < n_points_; i++)
+    {
+      for (SizeType j{0}; j < output_dimensions_; j++)
+      {
+        output_[(i * output_dimensions_) + j] = static_cast<double>(output_matrix.At(i, j));
+      }
+    }
+
+    CalculateAffinitiesP(input_matrix, static_cast<double>(perplexity));
+  }
+
+  /**
+   * i.e. Computes the conditional affinities Pj|i over the nearest neighbours of every point with
+   * the given perplexity, and symmetrises them into Pij = (Pj|i + Pi|j) / sum(Pij)
+   */
+  void CalculateAffinitiesP(ArrayType const &input_matrix, double perplexity)
+  {
+    double const   tolerance = 1e-5;
+    SizeType const max_tries = 50;
+
+    SizeType const k = std::min(n_points_ - 1, static_cast<SizeType>(3 * perplexity));
+
+    // the nearest neighbour of every point is the point itself
+    auto const neighbours =
+        fetch::math::clustering::BatchKNNEuclidean(input_matrix, input_matrix, k + 1);
+
+    double const target_entropy = std::log(perplexity);
+
+    // (row, column, affinity) for Pj|i and its transpose
+    std::vector<std::pair<std::pair<SizeType, SizeType>, double>> entries;
+    entries.reserve(2 * n_points_ * k);
+
+    std::vector<SizeType> columns;
+    std::vector<double>   distances;
+    std::vector<double>   p(k);
+    for (SizeType i{0}; i < n_points_; i++)
+    {
+      columns.clear();
+      distances.clear();
+      for (auto const &neighbour : neighbours[i])
+      {
+        if ((neighbour.first != i) && (columns.size() < k))
+        {
+          columns.push_back(neighbour.first);
+          distances.push_back(static_cast<double>(neighbour.second) *
+                              static_cast<double>(neighbour.second));
+        }
+      }
+
+      // the affinities do not change when the same distance is taken off all of them
+      double const nearest = distances.empty() ? 0.0 : distances.front();
+
+      double const inf      = std::numeric_limits<double>::max();
+      double       beta     = 1;
+      double       beta_min = -inf;
+      double       beta_max = inf;
+      for (SizeType tries = 0; tries <= max_tries; ++tries)
+      {
+        double sum_p   = 0;
+        double sum_d_p = 0;
+        for (SizeType j = 0; j < columns.size(); ++j)
+        {
+          p[j] = std::exp(-beta * (distances[j] - nearest));
+          sum_p += p[j];
+          sum_d_p += (distances[j] - nearest) * p[j];
+        }
+        for (SizeType j = 0; j < columns.size(); ++j)
+        {
+          p[j] /= sum_p;
+        }
+
+        double const entropy_diff = std::log(sum_p) + (beta * sum_d_p / sum_p) - target_entropy;
+        if (std::abs(entropy_diff) <= tolerance)
+        {
+          break;
+        }
+
+        // If not, increase or decrease precision
+        if (entropy_diff > 0)
+        {
+          beta_min = beta;
+          beta     = (beta_max == inf) ? beta * 2 : (beta + beta_max) / 2;
+        }
+        else
+        {
+          beta_max = beta;
+          beta     = (beta_min == -inf) ? beta / 2 : (beta + beta_min) / 2;
+        }
+      }
+
+      for (SizeType j = 0; j < columns.size(); ++j)
+      {
+        entries.emplace_back(std::make_pair(i, columns[j]), p[j]);
+        entries.emplace_back(std::make_pair(columns[j], i), p[j]);
+      }
+    }
+
+    // merge the entries into rows of the symmetric affinities
+    std::sort(entries.begin(), entries.end());
+
+    row_offsets_.assign(n_points_ + 1, 0);
+    columns_.clear();
+    affinities_.clear();
+    double sum = 0;
+    for (SizeType e = 0; e < entries.size(); ++e)
+    {
+      if ((e != 0) && (entries[e].first == entries[e - 1].first))
+      {
+        affinities_.back() += entries[e].second;
+      }
+      else
+      {
+        ++row_offsets_[entries[e].first.first + 1];
+        columns_.push_back(entries[e].first.second);
+        affinities_.push_back(entries[e].second);
+      }
+      sum += entries[e].second;
+    }
+    std::partial_sum(row_offsets_.begin(), row_offsets_.end(), row_offsets_.begin());
+
+    // Early exaggeration
+    for (auto &value : affinities_)
+    {
+      value = 4 * value / sum;
+    }
+  }
+
+  /**
+   * i.e. Calculates the gradient of the Kullback-Leibler divergence, from the exact attractive
+   * forces over the sparse input affinities and the approximate repulsive forces from the tree
+   * @param gradient the return value in the layout of output_
+   */
+  void ComputeGradient(std::vector<double> &gradient) const
+  {
+    details::SpacePartitioningTree const tree(output_.data(), n_points_, output_dimensions_);
+
+    std::vector<double> repulsion(output_.size(), 0);
+    std::vector<double> sum_q(n_points_, 0);
+
+    // every point may interact with all the others
+    fetch::math::details_gemm::ForEachColumnBlock(
+        n_points_, n_points_, output_dimensions_, FORCE_BLOCK,
+        [&](SizeType begin, SizeType count) {
+          for (SizeType i = begin; i < begin + count; ++i)
+          {
+            sum_q[i] = tree.Repulsion(output_.data() + (i * output_dimensions_), theta_,
+                                      repulsion.data() + (i * output_dimensions_));
+          }
+        });
+
+    double const normalisation = std::accumulate(sum_q.begin(), sum_q.end(), 0.0);
+
+    for (SizeType i = 0; i < n_points_; ++i)
+    {
+      double const *y_i = output_.data() + (i * output_dimensions_);
+      double *      g_i = gradient.data() + (i * output_dimensions_);
+      for (SizeType j = 0; j < output_dimensions_; ++j)
+      {
+        g_i[j] = -repulsion[(i * output_dimensions_) + j] / normalisation;
+      }
+
+      // (Pij - Qij) = Pij - num[i, j] / sum(num), the second part of which is the repulsion
+      for (SizeType e = row_offsets_[i]; e < row_offsets_[i + 1]; ++e)
+      {
+        double const *y_j      = output_.data() + (columns_[e] * output_dimensions_);
+        double        distance = 0;
+        for (SizeType j = 0; j < output_dimensions_; ++j)
+        {
+          distance += (y_i[j] - y_j[j]) * (y_i[j] - y_j[j]);
+        }
+
+        double const attraction = affinities_[e] / (1 + distance);
+        for (SizeType j = 0; j < output_dimensions_; ++j)
+        {
+          g_i[j] += attraction * (y_i[j] - y_j[j]);
+        }
+      }
+    }
+  }
+
+  static constexpr SizeType FORCE_BLOCK = 64;
+
+  double   theta_;
+  SizeType n_points_          = 0;
+  SizeType output_dimensions_ = 0;
+
+  std::vector<double> output_;  // the embedding, one point after another
+
+  // the symmetric input affinities as a sparse matrix in compressed row format
+  std::vector<SizeType> row_offsets_;
+  std::vector<SizeType> columns_;
+  std::vector<double>   affinities_;
+
+  RNG rng_;
+};
+
+}  // namespace ml
+}  // namespace fetch
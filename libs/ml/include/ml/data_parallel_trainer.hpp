@@ -0,0 +1,214 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ml/graph.hpp"
+#include "vectorise/threading/pool.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace fetch {
+namespace ml {
+
+/**
+ * Trains a graph on mini batches split across worker threads. Every worker has its own replica of
+ * the graph, sharing the trainable weights of the first one, so that the replicas evaluate and
+ * back propagate their part of the batch independently. The gradients of the replicas are summed
+ * into the first graph before each step, which updates the shared weights in place
+ * @tparam T  the tensor/array type
+ */
+template <class T>
+class DataParallelTrainer
+{
+public:
+  using ArrayType     = T;
+  using DataType      = typename ArrayType::Type;
+  using SizeType      = typename ArrayType::SizeType;
+  using GraphType     = Graph<ArrayType>;
+  using GraphPtrType  = std::shared_ptr<GraphType>;
+  using BuildFunction = std::function<void(GraphType &)>;
+
+  DataParallelTrainer(SizeType num_workers, BuildFunction const &build);
+
+  template <typename F>
+  DataType TrainBatch(SizeType batch_size, F &&train_example);
+  void     MergeGradients();
+  void     Step(DataType learning_rate);
+
+  /**
+   * @return the graph holding the trained weights, e.g. to be evaluated or saved
+   */
+  GraphType &GetGraph()
+  {
+    return *replicas_.front();
+  }
+
+  GraphType &GetReplica(SizeType worker)
+  {
+    return *replicas_.at(worker);
+  }
+
+  SizeType NumWorkers() const
+  {
+    return replicas_.size();
+  }
+
+private:
+  std::vector<GraphPtrType>        replicas_;
+  std::unique_ptr<threading::Pool> workers_;
+};
+
+/**
+ * Builds the graph replicas
+ * @param num_workers number of threads to train on, 0 selects the number of hardware threads
+ * @param build function adding the nodes of the model to an (empty) graph. It is called once per
+ * worker and must build the same graph, with the same node names, every time
+ */
+template <class T>
+DataParallelTrainer<T>::DataParallelTrainer(SizeType num_workers, BuildFunction const &build)
+{
+  if (num_workers == 0)
+  {
+    num_workers = std::max(SizeType{1}, SizeType(std::thread::hardware_concurrency()));
+  }
+
+  for (SizeType i = 0; i < num_workers; ++i)
+  {
+    auto replica = std::make_shared<GraphType>();
+    build(*replica);
+
+    // the replicas already run in parallel, the nodes of each are evaluated in order
+    replica->SetParallelEvaluation(false);
+
+    // loading the state dict shares the weights' storage rather than copying it
+    if (!replicas_.empty())
+    {
+      replica->LoadStateDict(replicas_.front()->StateDict());
+    }
+    replicas_.push_back(std::move(replica));
+  }
+
+  // the calling thread trains the first replica itself
+  if (num_workers > 1)
+  {
+    workers_ = std::make_unique<threading::Pool>(num_workers - 1, "DataParallel");
+  }
+}
+
+/**
+ * Runs the forward and backward passes for a mini batch, split into contiguous parts, one per
+ * worker. The gradients are accumulated by the replicas until the next Step
+ * @param batch_size number of examples in the batch
+ * @param train_example function (GraphType &graph, SizeType example) -> DataType which sets the
+ * inputs of the replica for one example of the batch, evaluates it, back propagates the error and
+ * returns the loss. It is called concurrently for different replicas
+ * @return the sum of the losses of the batch
+ */
+template <class T>
+template <typename F>
+typename DataParallelTrainer<T>::DataType DataParallelTrainer<T>::TrainBatch(SizeType batch_size,
+                                                                             F &&train_example)
+{
+  SizeType const num_workers = replicas_.size();
+  SizeType const chunk       = (batch_size + num_workers - 1) / num_workers;
+
+  std::vector<DataType> losses(num_workers, DataType(0));
+  auto run_worker = [this, &train_example, &losses, chunk, batch_size](SizeType worker) {
+    GraphType &graph = *replicas_[worker];
+    for (SizeType i = worker * chunk, end = std::min(batch_size, i + chunk); i < end; ++i)
+    {
+      losses[worker] += train_example(graph, i);
+    }
+  };
+
+  std::vector<std::future<void>> pending;
+  for (SizeType worker = 1; (worker < num_workers) && (worker * chunk < batch_size); ++worker)
+  {
+    pending.emplace_back(workers_->Dispatch([&run_worker, worker]() { run_worker(worker); }));
+  }
+
+  std::exception_ptr error;
+  try
+  {
+    run_worker(0);
+  }
+  catch (...)
+  {
+    error = std::current_exception();
+  }
+
+  // wait for every worker before reporting a failure, they reference this stack frame
+  for (auto &result : pending)
+  {
+    try
+    {
+      result.get();
+    }
+    catch (...)
+    {
+      if (!error)
+      {
+        error = std::current_exception();
+      }
+    }
+  }
+
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+
+  DataType loss(0);
+  for (auto const &l : losses)
+  {
+    loss += l;
+  }
+  return loss;
+}
+
+/**
+ * All-reduce: sums the gradients of every replica into the first one, in replica order
+ */
+template <class T>
+void DataParallelTrainer<T>::MergeGradients()
+{
+  for (SizeType i = 1; i < replicas_.size(); ++i)
+  {
+    replicas_.front()->MergeGradients(*replicas_[i]);
+  }
+}
+
+/**
+ * Merges the gradients of the replicas and takes a training step on the shared weights
+ * @param learning_rate the learning rate (alpha) hyperparameter
+ */
+template <class T>
+void DataParallelTrainer<T>::Step(DataType learning_rate)
+{
+  MergeGradients();
+  replicas_.front()->Step(learning_rate);
+}
+
+}  // namespace ml
+}  // namespace fetch
@@ -0,0 +1,185 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fetch {
+namespace ml {
+namespace dataloaders {
+
+/**
+ * Streams records out of a list of files while only holding one chunk of each file in memory.
+ * Records are either lines of text (record_size == 0) or fixed width binary records.
+ */
+class ChunkedFileReader
+{
+public:
+  using SizeType = uint64_t;
+
+  static constexpr SizeType DEFAULT_CHUNK_SIZE = 1u << 20u;
+
+  explicit ChunkedFileReader(std::vector<std::string> files, SizeType record_size = 0,
+                             SizeType chunk_size = DEFAULT_CHUNK_SIZE)
+    : files_(std::move(files))
+    , record_size_(record_size)
+    , chunk_size_(chunk_size)
+  {
+    if (chunk_size_ == 0)
+    {
+      throw std::invalid_argument("chunk size must be non zero");
+    }
+  }
+
+  bool Next(std::string &record);
+  void Reset();
+
+private:
+  bool NextFromChunk(std::string &record);
+  bool ReadChunk();
+
+  std::vector<std::string> files_;
+  SizeType                 record_size_;
+  SizeType                 chunk_size_;
+
+  SizeType      file_index_ = 0;
+  bool          file_open_  = false;
+  std::ifstream stream_;
+  std::string   chunk_;
+  SizeType      offset_ = 0;
+};
+
+/**
+ * Reads the next record, moving on to the following file when the current one is exhausted
+ * @param record the record which has been read
+ * @return false once every file has been consumed
+ */
+inline bool ChunkedFileReader::Next(std::string &record)
+{
+  for (;;)
+  {
+    if (NextFromChunk(record))
+    {
+      return true;
+    }
+
+    if (ReadChunk())
+    {
+      continue;
+    }
+
+    // the end of the file has been reached, a final line need not be terminated
+    if ((record_size_ == 0) && (offset_ < chunk_.size()))
+    {
+      record.assign(chunk_, offset_, std::string::npos);
+      offset_ = chunk_.size();
+      return true;
+    }
+
+    // any trailing partial binary record is discarded
+    stream_.close();
+    chunk_.clear();
+    offset_    = 0;
+    file_open_ = false;
+
+    if (file_index_ >= files_.size())
+    {
+      return false;
+    }
+  }
+}
+
+/**
+ * Rewinds to the first record of the first file
+ */
+inline void ChunkedFileReader::Reset()
+{
+  stream_.close();
+  chunk_.clear();
+  offset_     = 0;
+  file_index_ = 0;
+  file_open_  = false;
+}
+
+inline bool ChunkedFileReader::NextFromChunk(std::string &record)
+{
+  if (record_size_ == 0)
+  {
+    auto const end = chunk_.find('\n', offset_);
+    if (end == std::string::npos)
+    {
+      return false;
+    }
+
+    record.assign(chunk_, offset_, end - offset_);
+    offset_ = end + 1;
+    return true;
+  }
+
+  if (chunk_.size() - offset_ < record_size_)
+  {
+    return false;
+  }
+
+  record.assign(chunk_, offset_, record_size_);
+  offset_ += record_size_;
+  return true;
+}
+
+/**
+ * Appends the next chunk of the current file to the unconsumed remainder of the previous one
+ * @return false when the current file has no more data
+ */
+inline bool ChunkedFileReader::ReadChunk()
+{
+  if (!file_open_)
+  {
+    if (file_index_ >= files_.size())
+    {
+      return false;
+    }
+
+    std::string const &filename = files_[file_index_++];
+    stream_.clear();
+    stream_.open(filename, std::ios::binary);
+    if (!stream_.is_open())
+    {
+      throw std::runtime_error("Cannot open file `" + filename + "`!");
+    }
+    file_open_ = true;
+  }
+
+  chunk_.erase(0, offset_);
+  offset_ = 0;
+
+  auto const remainder = chunk_.size();
+  chunk_.resize(remainder + chunk_size_);
+  stream_.read(&chunk_[remainder], static_cast<std::streamsize>(chunk_size_));
+  chunk_.resize(remainder + static_cast<SizeType>(stream_.gcount()));
+
+  return chunk_.size() > remainder;
+}
+
+}  // namespace dataloaders
+}  // namespace ml
+}  // namespace fetch
@@ -0,0 +1,387 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/random/lfg.hpp"
+#include "ml/dataloaders/chunked_file_reader.hpp"
+#include "ml/dataloaders/dataloader.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace fetch {
+namespace ml {
+namespace dataloaders {
+
+/**
+ * A data loader for corpora which do not fit in memory. Records are streamed from disk, parsed
+ * into samples, shuffled through a bounded buffer and grouped into batches by a background
+ * thread, which stays up to prefetch_batches ahead of the consumer.
+ *
+ * @tparam DataType type of the sample data
+ * @tparam LabelType type of the sample label
+ */
+template <typename DataType, typename LabelType>
+class StreamingDataLoader : public DataLoader<DataType, LabelType>
+{
+public:
+  using SizeType   = uint64_t;
+  using SampleType = std::pair<DataType, LabelType>;
+  using BatchType  = std::vector<SampleType>;
+
+  // converts a record into a sample, records for which it returns false are skipped
+  using ParseFunction = std::function<bool(std::string const &record, SampleType &sample)>;
+
+  StreamingDataLoader(ChunkedFileReader reader, ParseFunction parse, SizeType batch_size,
+                      SizeType shuffle_buffer_size = 0, SizeType prefetch_batches = 2,
+                      uint64_t seed = 42);
+  StreamingDataLoader(StreamingDataLoader const &) = delete;
+  StreamingDataLoader &operator=(StreamingDataLoader const &) = delete;
+  virtual ~StreamingDataLoader();
+
+  virtual SampleType GetNext();
+  virtual SizeType   Size() const;
+  virtual bool       IsDone() const;
+  virtual void       Reset();
+
+  BatchType GetNextBatch();
+
+private:
+  void Start();
+  void Stop();
+  void Produce();
+  bool Push(BatchType &&batch);
+
+  ChunkedFileReader reader_;
+  ParseFunction     parse_;
+  SizeType          batch_size_;
+  SizeType          shuffle_buffer_size_;
+  SizeType          prefetch_batches_;
+  uint64_t          seed_;
+  SizeType          epoch_ = 0;
+
+  // state shared with the producer thread
+  mutable std::mutex              mutex_;
+  mutable std::condition_variable ready_;
+  std::condition_variable         space_;
+  std::deque<BatchType>           queue_;
+  std::exception_ptr              error_;
+  bool                            finished_ = false;
+  bool                            stop_     = false;
+  std::thread                     producer_;
+
+  // consumer side state
+  BatchType current_;
+  SizeType  current_position_ = 0;
+  SizeType  consumed_         = 0;
+  SizeType  size_             = 0;
+};
+
+/**
+ * @param reader source of the records, owned by the loader
+ * @param parse converts each record into a sample
+ * @param batch_size number of samples in each batch prepared in the background
+ * @param shuffle_buffer_size number of samples buffered for shuffling, 0 keeps the file order
+ * @param prefetch_batches maximum number of batches prepared ahead of the consumer
+ * @param seed seed of the shuffle, each epoch uses a different shuffle
+ */
+template <typename DataType, typename LabelType>
+StreamingDataLoader<DataType, LabelType>::StreamingDataLoader(
+    ChunkedFileReader reader, ParseFunction parse, SizeType batch_size,
+    SizeType shuffle_buffer_size, SizeType prefetch_batches, uint64_t seed)
+  : reader_(std::move(reader))
+  , parse_(std::move(parse))
+  , batch_size_(batch_size)
+  , shuffle_buffer_size_(shuffle_buffer_size)
+  , prefetch_batches_(prefetch_batches)
+  , seed_(seed)
+{
+  if ((batch_size_ == 0) || (prefetch_batches_ == 0))
+  {
+    throw std::invalid_argument("batch size and prefetch depth must be non zero");
+  }
+
+  Start();
+}
+
+template <typename DataType, typename LabelType>
+StreamingDataLoader<DataType, LabelType>::~StreamingDataLoader()
+{
+  Stop();
+}
+
+/**
+ * Returns the next sample, waiting for the producer if no batch has been prepared yet
+ */
+template <typename DataType, typename LabelType>
+typename StreamingDataLoader<DataType, LabelType>::SampleType
+StreamingDataLoader<DataType, LabelType>::GetNext()
+{
+  if (current_position_ >= current_.size())
+  {
+    current_          = GetNextBatch();
+    current_position_ = 0;
+
+    if (current_.empty())
+    {
+      throw std::out_of_range("streaming data loader is exhausted");
+    }
+  }
+
+  return std::move(current_[current_position_++]);
+}
+
+/**
+ * Returns the next prepared batch, the final batch of an epoch may be smaller than the batch size
+ * @return the batch, empty once the epoch is complete
+ */
+template <typename DataType, typename LabelType>
+typename StreamingDataLoader<DataType, LabelType>::BatchType
+StreamingDataLoader<DataType, LabelType>::GetNextBatch()
+{
+  // hand out whatever remains of a batch which was partially consumed through GetNext
+  if (current_position_ < current_.size())
+  {
+    BatchType remainder(std::make_move_iterator(current_.begin() + long(current_position_)),
+                        std::make_move_iterator(current_.end()));
+    current_.clear();
+    current_position_ = 0;
+    return remainder;
+  }
+
+  BatchType batch;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ready_.wait(lock, [this] { return !queue_.empty() || finished_; });
+
+    if (queue_.empty())
+    {
+      if (error_)
+      {
+        std::exception_ptr error = error_;
+        error_                   = nullptr;
+        std::rethrow_exception(error);
+      }
+
+      size_ = consumed_;
+      return batch;
+    }
+
+    batch = std::move(queue_.front());
+    queue_.pop_front();
+  }
+  space_.notify_one();
+
+  consumed_ += batch.size();
+  return batch;
+}
+
+/**
+ * The number of samples in an epoch is only known once it has been streamed completely, until
+ * then this is the number of samples handed out so far
+ */
+template <typename DataType, typename LabelType>
+typename StreamingDataLoader<DataType, LabelType>::SizeType
+StreamingDataLoader<DataType, LabelType>::Size() const
+{
+  return std::max(size_, consumed_);
+}
+
+template <typename DataType, typename LabelType>
+bool StreamingDataLoader<DataType, LabelType>::IsDone() const
+{
+  if (current_position_ < current_.size())
+  {
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  ready_.wait(lock, [this] { return !queue_.empty() || finished_; });
+
+  // a pending error is reported by the next call to GetNext
+  return queue_.empty() && !error_;
+}
+
+/**
+ * Restarts streaming from the beginning of the files with a new shuffle
+ */
+template <typename DataType, typename LabelType>
+void StreamingDataLoader<DataType, LabelType>::Reset()
+{
+  Stop();
+
+  reader_.Reset();
+  queue_.clear();
+  current_.clear();
+  error_            = nullptr;
+  finished_         = false;
+  stop_             = false;
+  current_position_ = 0;
+  consumed_         = 0;
+  ++epoch_;
+
+  Start();
+}
+
+template <typename DataType, typename LabelType>
+void StreamingDataLoader<DataType, LabelType>::Start()
+{
+  producer_ = std::thread([this] { Produce(); });
+}
+
+template <typename DataType, typename LabelType>
+void StreamingDataLoader<DataType, LabelType>::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  space_.notify_all();
+
+  if (producer_.joinable())
+  {
+    producer_.join();
+  }
+}
+
+/**
+ * Body of the producer thread
+ */
+template <typename DataType, typename LabelType>
+void StreamingDataLoader<DataType, LabelType>::Produce()
+{
+  try
+  {
+    random::LaggedFibonacciGenerator<> rng(seed_ + epoch_);
+
+    std::vector<SampleType> shuffle_buffer;
+    shuffle_buffer.reserve(shuffle_buffer_size_);
+
+    BatchType batch;
+    batch.reserve(batch_size_);
+
+    auto emit = [this, &batch](SampleType &&sample) {
+      batch.push_back(std::move(sample));
+      if (batch.size() < batch_size_)
+      {
+        return true;
+      }
+
+      bool const accepted = Push(std::move(batch));
+      batch               = BatchType();
+      batch.reserve(batch_size_);
+      return accepted;
+    };
+
+    std::string record;
+    SampleType  sample;
+    while (reader_.Next(record))
+    {
+      if (!parse_(record, sample))
+      {
+        continue;
+      }
+
+      if (shuffle_buffer_size_ < 2)
+      {
+        if (!emit(std::move(sample)))
+        {
+          return;
+        }
+      }
+      else if (shuffle_buffer.size() < shuffle_buffer_size_)
+      {
+        shuffle_buffer.push_back(std::move(sample));
+      }
+      else
+      {
+        // emit a random buffered sample and keep the new one in its place
+        std::swap(shuffle_buffer[rng() % shuffle_buffer.size()], sample);
+        if (!emit(std::move(sample)))
+        {
+          return;
+        }
+      }
+    }
+
+    // drain the shuffle buffer in random order
+    while (!shuffle_buffer.empty())
+    {
+      std::swap(shuffle_buffer[rng() % shuffle_buffer.size()], shuffle_buffer.back());
+      if (!emit(std::move(shuffle_buffer.back())))
+      {
+        return;
+      }
+      shuffle_buffer.pop_back();
+    }
+
+    if (!batch.empty() && !Push(std::move(batch)))
+    {
+      return;
+    }
+  }
+  catch (...)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    error_ = std::current_exception();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = true;
+  }
+  ready_.notify_all();
+}
+
+/**
+ * Queues a batch for the consumer, blocking while prefetch_batches batches are already waiting
+ * @return false if the loader is being stopped
+ */
+template <typename DataType, typename LabelType>
+bool StreamingDataLoader<DataType, LabelType>::Push(BatchType &&batch)
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    space_.wait(lock, [this] { return stop_ || (queue_.size() < prefetch_batches_); });
+
+    if (stop_)
+    {
+      return false;
+    }
+
+    queue_.push_back(std::move(batch));
+  }
+  ready_.notify_one();
+
+  return true;
+}
+
+}  // namespace dataloaders
+}  // namespace ml
+}  // namespace fetch
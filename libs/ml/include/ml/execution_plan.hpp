@@ -0,0 +1,318 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "math/fundamental_operators.hpp"
+#include "math/gemm.hpp"
+#include "ml/buffer_pool.hpp"
+#include "ml/node.hpp"
+#include "vectorise/threading/singleton_pool.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace fetch {
+namespace ml {
+
+/**
+ * A compiled schedule for evaluating one node of a graph. The ancestors of the node are put in
+ * topological order once, and grouped into levels of nodes which only depend on earlier levels,
+ * so that the nodes of a level can be evaluated in parallel. The plan also records after which
+ * level each intermediate output is last read, so that it can be handed back to a buffer pool
+ * @tparam T  the tensor/array type
+ */
+template <class T>
+class ExecutionPlan
+{
+public:
+  using ArrayType    = T;
+  using SizeType     = std::uint64_t;
+  using NodePtrType  = std::shared_ptr<NodeInterface<ArrayType>>;
+  using ErrorSignals = std::vector<std::pair<NodeInterface<ArrayType> *, ArrayType>>;
+
+  explicit ExecutionPlan(NodePtrType const &target, bool parallel = true);
+
+  ArrayType &  Forward(BufferPool<ArrayType> &buffers, bool release_intermediates);
+  ErrorSignals Backward(ArrayType const &errorSignal);
+
+  std::vector<NodePtrType> Order() const;
+
+  SizeType NumLevels() const
+  {
+    return levels_.size();
+  }
+
+private:
+  using IndexMap = std::unordered_map<NodeInterface<ArrayType> *, SizeType>;
+
+  struct Step
+  {
+    NodePtrType           node;
+    std::vector<SizeType> inputs;
+    SizeType              level{0};
+  };
+
+  SizeType Visit(NodePtrType const &node, IndexMap &index);
+
+  template <typename F>
+  void Run(std::vector<SizeType> const &steps, F &&function);
+
+  std::vector<Step>                  steps_;  ///< The nodes in topological order, target last
+  std::vector<std::vector<SizeType>> levels_;
+  std::vector<std::vector<SizeType>> releases_;  ///< Outputs last read by each level
+  bool                               parallel_;
+};
+
+/**
+ * Builds the plan for evaluating the target node
+ * @param target the node the plan evaluates
+ * @param parallel whether independent nodes of the same level are evaluated on the thread pool
+ */
+template <class T>
+ExecutionPlan<T>::ExecutionPlan(NodePtrType const &target, bool parallel)
+  : parallel_(parallel)
+{
+  IndexMap index;
+  Visit(target, index);
+
+  // group the nodes into levels, and find the last level which reads each output
+  std::vector<SizeType> last_read(steps_.size(), 0);
+  for (SizeType i = 0; i < steps_.size(); ++i)
+  {
+    Step const &step = steps_[i];
+    if (step.level >= levels_.size())
+    {
+      levels_.resize(step.level + 1);
+    }
+    levels_[step.level].push_back(i);
+
+    for (SizeType input : step.inputs)
+    {
+      last_read[input] = std::max(last_read[input], step.level);
+    }
+  }
+
+  // the target and the leaf nodes (placeholders and weights) are never released
+  releases_.resize(levels_.size());
+  for (SizeType i = 0; i + 1 < steps_.size(); ++i)
+  {
+    if (!steps_[i].inputs.empty())
+    {
+      releases_[last_read[i]].push_back(i);
+    }
+  }
+}
+
+/**
+ * Evaluates the target node, reusing pooled buffers for outputs which need to be (re)allocated
+ * @param buffers the pool of released buffers
+ * @param release_intermediates whether intermediate outputs are returned to the pool once read. The
+ * released nodes have to be recomputed before they can be read or back propagated through again
+ * @return the output of the target node
+ */
+template <class T>
+typename ExecutionPlan<T>::ArrayType &ExecutionPlan<T>::Forward(BufferPool<ArrayType> &buffers,
+                                                                bool release_intermediates)
+{
+  for (SizeType level = 0; level < levels_.size(); ++level)
+  {
+    for (SizeType i : levels_[level])
+    {
+      steps_[i].node->AcquireOutput(buffers);
+    }
+
+    // the leaf nodes only hand out their data, they are not worth dispatching
+    if (level == 0)
+    {
+      for (SizeType i : levels_[level])
+      {
+        steps_[i].node->Evaluate();
+      }
+    }
+    else
+    {
+      Run(levels_[level], [this](SizeType i) { steps_[i].node->Evaluate(); });
+    }
+
+    if (release_intermediates)
+    {
+      for (SizeType i : releases_[level])
+      {
+        steps_[i].node->ReleaseOutput(buffers);
+      }
+    }
+  }
+
+  return steps_.back().node->Evaluate();
+}
+
+/**
+ * Back propagates an error signal from the target node. Each node is visited once, in reverse
+ * topological order, with the sum of the error signals of all of its consumers
+ * @param errorSignal the error signal of the target's output
+ * @return the error signals which could not be propagated any further, i.e. those of leaf nodes
+ */
+template <class T>
+typename ExecutionPlan<T>::ErrorSignals ExecutionPlan<T>::Backward(ArrayType const &errorSignal)
+{
+  std::vector<ArrayType> errors(steps_.size());
+  std::vector<bool>      has_error(steps_.size(), false);
+  errors.back()    = errorSignal;
+  has_error.back() = true;
+
+  std::vector<std::vector<ArrayType>> signals(steps_.size());
+  ErrorSignals                        non_back_propagated_error_signals;
+  for (SizeType level = levels_.size(); level-- > 0;)
+  {
+    std::vector<SizeType> pending;
+    for (SizeType i : levels_[level])
+    {
+      if (has_error[i])
+      {
+        pending.push_back(i);
+      }
+    }
+
+    Run(pending, [this, &signals, &errors](SizeType i) {
+      signals[i] = steps_[i].node->ComputeErrorSignals(errors[i]);
+    });
+
+    for (SizeType i : pending)
+    {
+      Step const &step = steps_[i];
+      if (step.inputs.empty())
+      {
+        for (auto &signal : signals[i])
+        {
+          non_back_propagated_error_signals.emplace_back(step.node.get(), std::move(signal));
+        }
+      }
+      else
+      {
+        assert(signals[i].size() == step.inputs.size());
+        for (SizeType j = 0; j < step.inputs.size(); ++j)
+        {
+          SizeType const input = step.inputs[j];
+          if (has_error[input])
+          {
+            // signals may share storage with each other, so sum into a new array
+            ArrayType sum{errors[input].shape()};
+            fetch::math::Add(errors[input], signals[i][j], sum);
+            errors[input] = std::move(sum);
+          }
+          else
+          {
+            errors[input]    = std::move(signals[i][j]);
+            has_error[input] = true;
+          }
+        }
+      }
+
+      // the error signals of this node are no longer needed
+      errors[i] = ArrayType{};
+      signals[i].clear();
+    }
+  }
+
+  return non_back_propagated_error_signals;
+}
+
+/**
+ * @return the nodes of the plan in the order they are evaluated
+ */
+template <class T>
+std::vector<typename ExecutionPlan<T>::NodePtrType> ExecutionPlan<T>::Order() const
+{
+  std::vector<NodePtrType> order;
+  for (auto const &level : levels_)
+  {
+    for (SizeType i : level)
+    {
+      order.push_back(steps_[i].node);
+    }
+  }
+  return order;
+}
+
+/**
+ * Adds a node to the plan after all of its inputs (depth first, post order)
+ * @return the position of the node in the plan
+ */
+template <class T>
+typename ExecutionPlan<T>::SizeType ExecutionPlan<T>::Visit(
+    NodePtrType const &node, IndexMap &index)
+{
+  auto it = index.find(node.get());
+  if (it != index.end())
+  {
+    return it->second;
+  }
+
+  Step step;
+  step.node = node;
+  for (auto const &input : node->GetInputs())
+  {
+    SizeType const position = Visit(input, index);
+    step.inputs.push_back(position);
+    step.level = std::max(step.level, steps_[position].level + 1);
+  }
+
+  SizeType const position = steps_.size();
+  steps_.push_back(std::move(step));
+  index[node.get()] = position;
+  return position;
+}
+
+/**
+ * Applies a function to the given steps, splitting them between the calling thread and the
+ * thread pool when there is more than one. Plans evaluated from within a step (e.g. the graph of a
+ * layer evaluated as one of the nodes) are split again on the same pool, whose waiting threads run
+ * the pending steps rather than blocking
+ */
+template <class T>
+template <typename F>
+void ExecutionPlan<T>::Run(std::vector<SizeType> const &steps, F &&function)
+{
+  if (!parallel_ || (steps.size() < 2))
+  {
+    for (SizeType i : steps)
+    {
+      function(i);
+    }
+    return;
+  }
+
+  SizeType const num_steps = steps.size();
+  SizeType const num_tasks = std::max(SizeType{1}, std::min(fetch::math::MaxThreads(), num_steps));
+  SizeType const chunk     = (num_steps + num_tasks - 1) / num_tasks;
+
+  threading::SingletonPool::GetInstance().ParallelFor(
+      0, num_steps, chunk, [&steps, &function](SizeType begin, SizeType end) {
+        for (SizeType i = begin; i < end; ++i)
+        {
+          function(steps[i]);
+        }
+      });
+}
+
+}  // namespace ml
+}  // namespace fetch
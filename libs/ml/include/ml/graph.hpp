@@ -19,13 +19,22 @@
 
 #include "ml/meta/ml_type_traits.hpp"
 
+#include "ml/buffer_pool.hpp"
+#include "ml/execution_plan.hpp"
 #include "ml/node.hpp"
+#include "ml/ops/activations/relu.hpp"
+#include "ml/ops/add.hpp"
+#include "ml/ops/fused_matrix_multiply_add.hpp"
+#include "ml/ops/matrix_multiply.hpp"
 #include "ml/ops/weights.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <list>
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace fetch {
 namespace ml {
@@ -41,25 +50,29 @@ public:
   using ArrayPtrType   = std::shared_ptr<ArrayType>;
   using Datatype       = typename ArrayType::Type;
   using ConstSliceType = typename ArrayType::ConstSliceType;
+  using SizeType       = typename ArrayType::SizeType;
+  using NodePtrType    = std::shared_ptr<fetch::ml::NodeInterface<ArrayType>>;
 
   Graph()
   {}
 
+  virtual ~Graph() = default;
+
   /**
    * Evaluates the output of a node (calling all necessary forward prop)
    * @param node_name name of node to evaluate for output
+   * @param is_training when false the intermediate outputs are not kept for back propagation, and
+   * their buffers are reused by the nodes evaluated after them
    * @return pointer to array containing node output
    */
-  ArrayType Evaluate(std::string const &node_name)
+  ArrayType Evaluate(std::string const &node_name, bool is_training = true)
   {
-    if (nodes_[node_name])
-    {
-      return nodes_[node_name]->Evaluate();
-    }
-    else
+    auto it = nodes_.find(node_name);
+    if ((it == nodes_.end()) || !it->second)
     {
       throw std::runtime_error("Cannot evaluate: node [" + node_name + "] not in graph");
     }
+    return GetPlan(it->second).Forward(buffers_, !is_training);
   }
 
   /**
@@ -69,7 +82,22 @@ public:
    */
   void BackPropagate(std::string const &node_name, ArrayType const &errorSignal)
   {
-    nodes_[node_name]->BackPropagate(errorSignal);
+    auto it = nodes_.find(node_name);
+    if ((it == nodes_.end()) || !it->second)
+    {
+      throw std::runtime_error("Cannot backpropagate: node [" + node_name + "] not in graph");
+    }
+    GetPlan(it->second).Backward(errorSignal);
+  }
+
+  /**
+   * Sets whether independent nodes are evaluated in parallel on the thread pool
+   * @param parallel true to evaluate in parallel
+   */
+  void SetParallelEvaluation(bool parallel)
+  {
+    parallel_evaluation_ = parallel;
+    plans_.clear();
   }
 
   /**
@@ -139,6 +167,12 @@ public:
     {
       bool input_size_changed = placeholder->SetData(data);
       ResetGraphCache(nodes_[node_name], input_size_changed);
+
+      // buffers of the previous size are unlikely to fit any more
+      if (input_size_changed)
+      {
+        buffers_.Clear();
+      }
     }
     else
     {
@@ -162,6 +196,52 @@ public:
     }
   }
 
+  /**
+   * Merges the gradients accumulated by a replica of this graph, built identically, into this
+   * graph's trainable nodes and clears them from the replica
+   * @param replica the replica graph
+   */
+  virtual void MergeGradients(ops::Trainable<T> &replica)
+  {
+    auto &other = dynamic_cast<Graph<T> &>(replica);
+    for (auto &t : trainable_)
+    {
+      t.second->MergeGradients(*other.trainable_.at(t.first));
+    }
+  }
+
+  /**
+   * Rewrites the graph, fusing chains of nodes into single kernels which do not materialise the
+   * intermediate outputs. MatrixMultiply -> Add (bias) -> optional Relu chains are replaced by a
+   * FusedMatrixMultiplyAdd node. The fused node takes the name of the last node of the chain, the
+   * other nodes of the chain are removed from the graph and can no longer be evaluated
+   * @return the number of chains which were fused
+   */
+  SizeType Fuse()
+  {
+    std::vector<std::string> names;
+    for (auto const &n : nodes_)
+    {
+      names.push_back(n.first);
+    }
+    std::sort(names.begin(), names.end());
+
+    SizeType fused = 0;
+    for (auto const &name : names)
+    {
+      if ((nodes_.find(name) != nodes_.end()) && FuseMatrixMultiplyAdd(name))
+      {
+        ++fused;
+      }
+    }
+
+    if (fused > 0)
+    {
+      plans_.clear();
+    }
+    return fused;
+  }
+
   /**
    * Resets graph cache, clearing stored evaluation outputs
    * and recursively updating the input size for all downstream nodes
@@ -223,6 +303,7 @@ private:
     }
 
     nodes_[node_name] = op;
+    plans_.clear();
 
     for (auto const &i : inputs)
     {
@@ -231,6 +312,87 @@ private:
     }
   }
 
+  /**
+   * Fuses the chain starting at a MatrixMultiply node, if it is followed by an Add of a bias and
+   * optionally by a Relu, each being the only consumer of the previous node
+   * @param name the name of the candidate MatrixMultiply node
+   * @return true if the chain was replaced by a fused node
+   */
+  bool FuseMatrixMultiplyAdd(std::string const &name)
+  {
+    auto matmul =
+        std::dynamic_pointer_cast<Node<ArrayType, ops::MatrixMultiply<ArrayType>>>(nodes_[name]);
+    if (!matmul || (matmul->GetOutputs().size() != 1) || !IsRemovable(name))
+    {
+      return false;
+    }
+
+    NodePtrType add = matmul->GetOutputs().front();
+    if (!std::dynamic_pointer_cast<Node<ArrayType, ops::Add<ArrayType>>>(add) ||
+        (add->GetInputs().size() != 2))
+    {
+      return false;
+    }
+
+    NodePtrType bias =
+        (add->GetInputs()[0] == matmul) ? add->GetInputs()[1] : add->GetInputs()[0];
+    if (bias == matmul)
+    {
+      return false;
+    }
+
+    // include a trailing relu, if nothing else reads the biased sum
+    std::string const add_name = NameOf(add);
+    NodePtrType       last     = add;
+    if ((add->GetOutputs().size() == 1) && IsRemovable(add_name) &&
+        std::dynamic_pointer_cast<Node<ArrayType, ops::Relu<ArrayType>>>(add->GetOutputs().front()))
+    {
+      last = add->GetOutputs().front();
+    }
+    bool const        relu      = (last != add);
+    std::string const last_name = NameOf(last);
+
+    auto fused = std::make_shared<Node<ArrayType, ops::FusedMatrixMultiplyAdd<ArrayType>>>(
+        last_name, relu);
+
+    // the fused node reads the chain's inputs, and feeds the chain's consumers
+    for (auto const &input : matmul->GetInputs())
+    {
+      input->ReplaceOutput(matmul.get(), fused);
+      fused->AddInput(input);
+    }
+    bias->ReplaceOutput(add.get(), fused);
+    fused->AddInput(bias);
+
+    for (auto const &output : last->GetOutputs())
+    {
+      output->ReplaceInput(last.get(), fused);
+      fused->AddOutput(output);
+    }
+
+    nodes_.erase(name);
+    nodes_.erase(add_name);
+    nodes_[last_name] = fused;
+
+    FETCH_LOG_INFO("ML_LIB", "Fused [", name, "] into node [", last_name, "]");
+    return true;
+  }
+
+  /**
+   * Finds the name under which a node is stored in the graph
+   */
+  std::string NameOf(NodePtrType const &node) const
+  {
+    for (auto const &n : nodes_)
+    {
+      if (n.second == node)
+      {
+        return n.first;
+      }
+    }
+    throw std::runtime_error("node not found in graph");
+  }
+
   /**
    * generates a new variable name if necessary to ensure uniqueness within graph
    * @param pre_string
@@ -257,8 +419,45 @@ private:
   }
 
 protected:
-  std::unordered_map<std::string, std::shared_ptr<fetch::ml::NodeInterface<ArrayType>>>  nodes_;
+  /**
+   * Whether a node may be removed from the graph by a rewrite, i.e. nothing outside of the graph
+   * refers to it directly
+   * @param node_name name of the node
+   * @return true if the node can be removed
+   */
+  virtual bool IsRemovable(std::string const &node_name) const
+  {
+    (void)node_name;
+    return true;
+  }
+
+  /**
+   * Returns the execution plan for a node, compiling it on first use. Plans are discarded
+   * whenever a node is added to the graph
+   * @param node the node to be evaluated
+   * @return the plan evaluating the node
+   */
+  ExecutionPlan<ArrayType> &GetPlan(NodePtrType const &node)
+  {
+    auto it = plans_.find(node.get());
+    if (it == plans_.end())
+    {
+      auto plan = std::make_shared<ExecutionPlan<ArrayType>>(node, parallel_evaluation_);
+      it        = plans_.emplace(node.get(), std::move(plan)).first;
+    }
+    return *(it->second);
+  }
+
+  std::unordered_map<std::string, NodePtrType>                                           nodes_;
   std::unordered_map<std::string, std::shared_ptr<fetch::ml::ops::Trainable<ArrayType>>> trainable_;
+  BufferPool<ArrayType>                                                                  buffers_;
+
+private:
+  using PlanPtrType = std::shared_ptr<ExecutionPlan<ArrayType>>;
+  using PlanMap     = std::unordered_map<NodeInterface<ArrayType> const *, PlanPtrType>;
+
+  PlanMap plans_;
+  bool    parallel_evaluation_{true};
 };
 
 }  // namespace ml
@@ -20,11 +20,11 @@
 #include "ml/layers/layer.hpp"
 
 #include "ml/layers/fully_connected.hpp"
-#include "ml/ops/activations/softmax.hpp"
 #include "ml/ops/add.hpp"
-#include "ml/ops/matrix_multiply.hpp"
+#include "ml/ops/flatten.hpp"
+#include "ml/ops/multi_head_attention.hpp"
 #include "ml/ops/placeholder.hpp"
-#include "ml/ops/transpose.hpp"
+#include "ml/ops/weights.hpp"
 
 #include <cmath>
 #include <random>
@@ -33,6 +33,13 @@ namespace fetch {
 namespace ml {
 namespace layers {
 
+/**
+ * Self attention over the flattened input, followed by a dense output layer.
+ *
+ * The attention is a single fused op (see ops::MultiHeadAttention), fed with one packed [in x
+ * 3.hidden] matrix for the query, key and value projections and a [hidden x in] matrix projecting
+ * the attention back onto the input, to which it is added as a residual connection.
+ */
 template <class T>
 class SelfAttention : public Layer<T>
 {
@@ -40,44 +47,36 @@ public:
   using ArrayType    = T;
   using SizeType     = typename ArrayType::SizeType;
   using ArrayPtrType = std::shared_ptr<ArrayType>;
+  using WeightsInit  = fetch::ml::ops::WeightsInitialisation;
 
   SelfAttention(std::uint64_t in, std::uint64_t out, std::uint64_t hidden,
-                std::string const &name = "SA")
+                std::string const &name = "SA", std::uint64_t num_heads = 1)
     : Layer<T>(in, out)
   {
+    ASSERT((num_heads > 0) && ((hidden % num_heads) == 0));
 
     std::string input =
         this->template AddNode<fetch::ml::ops::PlaceHolder<ArrayType>>(name + "_Input", {});
-
-    // key & value dense layer
     std::string flat_input = this->template AddNode<fetch::ml::ops::Flatten<ArrayType>>(
         name + "_Flatten_Input", {input});
-    std::string query_name = this->template AddNode<fetch::ml::layers::FullyConnected<ArrayType>>(
-        name + "_KEY_VAL", {flat_input}, in, hidden);
+
+    // packed query, key & value projections, and the projection of the heads back onto the input
+    std::string qkv_weights =
+        this->template AddNode<fetch::ml::ops::Weights<ArrayType>>(name + "_QKV_Weights", {});
+    std::string projection_weights = this->template AddNode<fetch::ml::ops::Weights<ArrayType>>(
+        name + "_Projection_Weights", {});
 
     //////////////////////
     /// attention part ///
     //////////////////////
 
-    // query key matmul
-    std::string transpose_key = this->template AddNode<fetch::ml::ops::Transpose<ArrayType>>(
-        name + "_TransposeKey", {flat_input});
-    std::string qk_matmul = this->template AddNode<fetch::ml::ops::MatrixMultiply<ArrayType>>(
-        name + "_Query_Key_MatMul", {flat_input, transpose_key});
-
-    // TODO(707) normalise by square root of vector length
-
-    // softmax
-    std::string attention_weights =
-        this->template AddNode<fetch::ml::ops::Softmax<ArrayType>>(name + "_Softmax", {qk_matmul});
-
-    // attention & value matmul
-    std::string weighted_value = this->template AddNode<fetch::ml::ops::MatrixMultiply<ArrayType>>(
-        name + "_Att_Val_MatMul", {attention_weights, flat_input});
+    std::string attention =
+        this->template AddNode<fetch::ml::ops::MultiHeadAttention<ArrayType>>(
+            name + "_Attention", {flat_input, qkv_weights, projection_weights}, num_heads);
 
     // residual connection to input
     std::string decoding = this->template AddNode<fetch::ml::ops::Add<ArrayType>>(
-        name + "_ResidualConnection", {flat_input, weighted_value});
+        name + "_ResidualConnection", {flat_input, attention});
 
     // final dense output
     std::string output = this->template AddNode<fetch::ml::layers::FullyConnected<ArrayType>>(
@@ -85,6 +84,14 @@ public:
 
     this->AddInputNode(input);
     this->SetOutputNode(output);
+
+    ArrayType qkv_data(std::vector<SizeType>({in, 3 * hidden}));
+    fetch::ml::ops::Weights<ArrayType>::Initialise(qkv_data, in, 3 * hidden);
+    this->SetInput(qkv_weights, qkv_data, false);
+
+    ArrayType projection_data(std::vector<SizeType>({hidden, in}));
+    fetch::ml::ops::Weights<ArrayType>::Initialise(projection_data, hidden, in);
+    this->SetInput(projection_weights, projection_data, false);
   }
 
   virtual std::vector<SizeType> ComputeOutputShape(
@@ -18,8 +18,10 @@
 //------------------------------------------------------------------------------
 
 #include "core/logger.hpp"
+#include "ml/buffer_pool.hpp"
 #include "ops/ops.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <unordered_map>
@@ -46,6 +48,15 @@ public:
   virtual void ResetCache(bool input_size_changed)                                 = 0;
   virtual void SetBatch(bool b)                                                    = 0;
   virtual std::vector<std::shared_ptr<NodeInterface<T>>> const &GetOutputs() const = 0;
+  virtual std::vector<std::shared_ptr<NodeInterface<T>>> const &GetInputs() const  = 0;
+  virtual std::vector<ArrayType> ComputeErrorSignals(ArrayType const &errorSignal) = 0;
+  virtual void                   AcquireOutput(BufferPool<ArrayType> &buffers)     = 0;
+  virtual void                   ReleaseOutput(BufferPool<ArrayType> &buffers)     = 0;
+
+  virtual void ReplaceInput(NodeInterface<T> const *                 old,
+                            std::shared_ptr<NodeInterface<T>> const &i)  = 0;
+  virtual void ReplaceOutput(NodeInterface<T> const *                 old,
+                             std::shared_ptr<NodeInterface<T>> const &o) = 0;
 };
 
 template <class T, class O>
@@ -142,6 +153,48 @@ public:
     return non_back_propagated_error_signals;
   }
 
+  /**
+   * Computes the error signals for each of the inputs of this node, without propagating them any
+   * further. Used by the execution plan, which visits the nodes itself
+   * @param errorSignal the (accumulated) error signal of this node's output
+   * @return one error signal per input, or the signals to pass out of the graph for a leaf node
+   */
+  virtual std::vector<ArrayType> ComputeErrorSignals(ArrayType const &errorSignal)
+  {
+    FETCH_LOG_INFO("ML_LIB", "Computing error signals for node [", name_, "]");
+    return this->Backward(GatherInputs(), errorSignal);
+  }
+
+  /**
+   * Takes an output buffer of the right size from the pool, if the output is about to be resized
+   * @param buffers the pool of released buffers
+   */
+  virtual void AcquireOutput(BufferPool<ArrayType> &buffers)
+  {
+    if ((cached_output_status_ != CachedOutputState::CHANGED_SIZE) || inputs_.empty())
+    {
+      return;
+    }
+
+    auto output_shape = this->ComputeOutputShape(GatherInputs());
+    if (cached_output_.shape() != output_shape)
+    {
+      buffers.Acquire(output_shape, cached_output_);
+    }
+  }
+
+  /**
+   * Hands the cached output back to the pool once no other node will read it. The output will be
+   * recomputed if it is evaluated again
+   * @param buffers the pool of released buffers
+   */
+  virtual void ReleaseOutput(BufferPool<ArrayType> &buffers)
+  {
+    buffers.Release(std::move(cached_output_));
+    cached_output_        = ArrayType{};
+    cached_output_status_ = CachedOutputState::CHANGED_SIZE;
+  }
+
   void AddInput(std::shared_ptr<NodeInterface<T>> const &i)
   {
     inputs_.push_back(i);
@@ -152,15 +205,45 @@ public:
     outputs_.push_back(o);
   }
 
+  /**
+   * Substitutes a node for another wherever the other is an input, used by graph rewrites
+   */
+  void ReplaceInput(NodeInterface<T> const *old, std::shared_ptr<NodeInterface<T>> const &i)
+  {
+    auto matches = [old](std::shared_ptr<NodeInterface<T>> const &n) { return n.get() == old; };
+    std::replace_if(inputs_.begin(), inputs_.end(), matches, i);
+  }
+
+  /**
+   * Substitutes a node for another wherever the other is an output, used by graph rewrites
+   */
+  void ReplaceOutput(NodeInterface<T> const *old, std::shared_ptr<NodeInterface<T>> const &o)
+  {
+    auto matches = [old](std::shared_ptr<NodeInterface<T>> const &n) { return n.get() == old; };
+    std::replace_if(outputs_.begin(), outputs_.end(), matches, o);
+  }
+
   virtual std::vector<std::shared_ptr<NodeInterface<T>>> const &GetOutputs() const
   {
     return outputs_;
   }
 
+  virtual std::vector<std::shared_ptr<NodeInterface<T>>> const &GetInputs() const
+  {
+    return inputs_;
+  }
+
   virtual void ResetCache(bool input_size_changed)
   {
-    cached_output_status_ =
-        input_size_changed ? CachedOutputState::CHANGED_SIZE : CachedOutputState::CHANGED_CONTENT;
+    // an output which still has to be (re)allocated keeps needing it
+    if (input_size_changed)
+    {
+      cached_output_status_ = CachedOutputState::CHANGED_SIZE;
+    }
+    else if (cached_output_status_ == CachedOutputState::VALID_CACHE)
+    {
+      cached_output_status_ = CachedOutputState::CHANGED_CONTENT;
+    }
   }
 
   virtual void SetBatch(bool b)
@@ -23,6 +23,8 @@
 #include "math/matrix_operations.hpp"
 #include "ml/ops/ops.hpp"
 
+#include <vector>
+
 namespace fetch {
 namespace ml {
 namespace ops {
@@ -99,9 +101,13 @@ public:
 private:
   void UpdateRandomValues()
   {
+    // draw all the random values in one batch rather than one call per element
+    random_values_.resize(drop_values_.size());
+    rng_.FillUniform(random_values_.data(), random_values_.size());
+
     for (SizeType i(0); i < drop_values_.size(); i++)
     {
-      if (DataType(rng_.AsDouble()) <= probability_)
+      if (DataType(random_values_[i]) <= probability_)
       {
         drop_values_.Set(i, DataType(1.0));
       }
@@ -112,9 +118,10 @@ private:
     }
   }
 
-  ArrayType drop_values_;
-  DataType  probability_;
-  RNG       rng_;
+  ArrayType           drop_values_;
+  DataType            probability_;
+  RNG                 rng_;
+  std::vector<double> random_values_;  ///< Scratch space for the random values of each pass
 };
 
 }  // namespace ops
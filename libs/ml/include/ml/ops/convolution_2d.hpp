@@ -17,12 +17,22 @@
 //
 //------------------------------------------------------------------------------
 
+#include "math/gemm.hpp"
+#include "math/matrix_operations.hpp"
 #include "ml/ops/ops.hpp"
 
 namespace fetch {
 namespace ml {
 namespace ops {
 
+/**
+ * A 2D convolution (without padding and with unit strides) of a [C x H x W] input with a set of
+ * [oC x C x kH x kW] kernels.
+ *
+ * The convolution is lowered onto a matrix multiplication: the input patches are unrolled (im2col)
+ * into the columns of a [C.kH.kW x oH.oW] matrix, which is multiplied by the kernels viewed as an
+ * [oC x C.kH.kW] matrix. The unrolled matrices are kept between calls to avoid reallocating them.
+ */
 template <class T>
 class Convolution2D : public BatchOps<T>
 {
@@ -31,6 +41,7 @@ public:
   using SizeType     = typename ArrayType::SizeType;
   using DataType     = typename ArrayType::Type;
   using ArrayPtrType = std::shared_ptr<ArrayType>;
+  using MatrixView   = fetch::math::details_gemm::MatrixView<DataType>;
 
   Convolution2D()  = default;
   ~Convolution2D() = default;
@@ -43,43 +54,62 @@ public:
     ASSERT(inputs.at(0).get().shape().size() == 3);
     // Weights should be a 4D tensor [oC x iC x H x W]
     ASSERT(inputs.at(1).get().shape().size() == 4);
+    ASSERT(inputs.at(0).get().shape()[0] == inputs.at(1).get().shape()[1]);
 
     auto outputShape = ComputeOutputShape(inputs);
     ASSERT(output.shape() == outputShape);
-    for (SizeType i(0); i < outputShape[0]; ++i)  // Iterate over output channels
-    {
-      for (SizeType j{0}; j < outputShape[1]; ++j)  // Iterate over output height
-      {
-        for (SizeType k{0}; k < outputShape[2]; ++k)  // Iterate over output width
-        {
-          typename ArrayType::Type sum(0);
-          for (SizeType ki(0); ki < inputs.at(1).get().shape()[1];
-               ki++)  // Iterate over Input channel
-          {
-            for (SizeType kj(0); kj < inputs.at(1).get().shape()[2];
-                 kj++)  // Iterate over kernel height
-            {
-              for (SizeType kk(0); kk < inputs.at(1).get().shape()[3];
-                   kk++)  // Iterate over kernel width
-              {
-                typename ArrayType::Type w = inputs.at(1).get().At(i, ki, kj, kk);
-                typename ArrayType::Type i = inputs.at(0).get().At(ki, j + kj, k + kk);
-                sum += i * w;
-              }
-            }
-          }
-          output.Set(i, j, k, sum);
-        }
-      }
-    }
+
+    ArrayType const &kernels = inputs.at(1).get();
+
+    SizeType const output_channels = kernels.shape()[0];
+    SizeType const depth           = kernels.shape()[1] * kernels.shape()[2] * kernels.shape()[3];
+    SizeType const positions       = outputShape[1] * outputShape[2];
+
+    Im2Col(inputs.at(0).get(), kernels.shape(), outputShape, columns_);
+
+    // output = kernels . columns
+    fetch::math::details_gemm::Multiply(DataType(1), KernelMatrix(kernels),
+                                        fetch::math::details_gemm::View(columns_), DataType(0),
+                                        output.data().pointer(), output_channels,
+                                        output_channels, positions, depth);
     return output;
   }
 
   std::vector<ArrayType> Backward(
-      std::vector<std::reference_wrapper<const ArrayType>> const & /*inputs*/,
-      ArrayType const &errorSignal)
+      std::vector<std::reference_wrapper<const ArrayType>> const &inputs,
+      ArrayType const &                                           errorSignal)
   {
-    return {errorSignal};
+    ASSERT(inputs.size() == 2);
+
+    ArrayType const &input   = inputs.at(0).get();
+    ArrayType const &kernels = inputs.at(1).get();
+    ASSERT(errorSignal.shape() == ComputeOutputShape(inputs));
+
+    SizeType const output_channels = kernels.shape()[0];
+    SizeType const depth           = kernels.shape()[1] * kernels.shape()[2] * kernels.shape()[3];
+    SizeType const positions       = errorSignal.shape()[1] * errorSignal.shape()[2];
+
+    ArrayType inputError(input.shape());
+    ArrayType kernelError(kernels.shape());
+
+    // the unrolled input of the forward pass may since have been replaced by another input
+    Im2Col(input, kernels.shape(), errorSignal.shape(), columns_);
+    Resize(column_errors_, {depth, positions});
+
+    MatrixView const error{errorSignal.data().pointer(), 1, output_channels};
+
+    // kernelError = errorSignal . columns^T
+    fetch::math::details_gemm::Multiply(
+        DataType(1), error, fetch::math::details_gemm::View(columns_).Transposed(), DataType(0),
+        kernelError.data().pointer(), output_channels, output_channels, depth, positions);
+
+    // columnErrors = kernels^T . errorSignal, which is folded back onto the input
+    fetch::math::details_gemm::Multiply(DataType(1), KernelMatrix(kernels).Transposed(), error,
+                                        DataType(0), column_errors_.data().pointer(), depth,
+                                        depth, positions, output_channels);
+    Col2Im(column_errors_, kernels.shape(), errorSignal.shape(), inputError);
+
+    return {inputError, kernelError};
   }
 
   std::vector<SizeType> ComputeOutputShape(
@@ -93,6 +123,90 @@ public:
   }
 
   static constexpr char const *DESCRIPTOR = "Convolution2D";
+
+private:
+  /// The [oC x iC x kH x kW] kernels viewed as an [oC x iC.kH.kW] matrix (in place)
+  static MatrixView KernelMatrix(ArrayType const &kernels)
+  {
+    return {kernels.data().pointer(), 1, kernels.shape()[0]};
+  }
+
+  static void Resize(ArrayType &matrix, std::vector<SizeType> const &shape)
+  {
+    if (matrix.shape() != shape)
+    {
+      matrix.ResizeFromShape(shape);
+    }
+  }
+
+  /**
+   * Unroll the input patches into the columns of a matrix, such that column (oh + oH.ow) holds the
+   * patch of the output position (oh, ow), in the order of the elements of a kernel
+   */
+  static void Im2Col(ArrayType const &input, std::vector<SizeType> const &kernel_shape,
+                     std::vector<SizeType> const &output_shape, ArrayType &columns)
+  {
+    SizeType const channels      = input.shape()[0];
+    SizeType const input_height  = input.shape()[1];
+    SizeType const kernel_height = kernel_shape[2];
+    SizeType const kernel_width  = kernel_shape[3];
+
+    Resize(columns, {channels * kernel_height * kernel_width, output_shape[1] * output_shape[2]});
+
+    DataType const *source      = input.data().pointer();
+    DataType *      destination = columns.data().pointer();
+
+    for (SizeType ow{0}; ow < output_shape[2]; ++ow)
+    {
+      for (SizeType oh{0}; oh < output_shape[1]; ++oh)
+      {
+        for (SizeType kw{0}; kw < kernel_width; ++kw)
+        {
+          for (SizeType kh{0}; kh < kernel_height; ++kh)
+          {
+            // the channels of each input element are contiguous
+            DataType const *element = source + (channels * ((oh + kh) + (input_height * (ow + kw))));
+            destination             = std::copy(element, element + channels, destination);
+          }
+        }
+      }
+    }
+  }
+
+  /// The reverse of Im2Col, accumulating the columns of the matrix onto the input patches
+  static void Col2Im(ArrayType const &columns, std::vector<SizeType> const &kernel_shape,
+                     std::vector<SizeType> const &output_shape, ArrayType &input)
+  {
+    SizeType const channels      = input.shape()[0];
+    SizeType const input_height  = input.shape()[1];
+    SizeType const kernel_height = kernel_shape[2];
+    SizeType const kernel_width  = kernel_shape[3];
+
+    DataType const *source      = columns.data().pointer();
+    DataType *      destination = input.data().pointer();
+
+    for (SizeType ow{0}; ow < output_shape[2]; ++ow)
+    {
+      for (SizeType oh{0}; oh < output_shape[1]; ++oh)
+      {
+        for (SizeType kw{0}; kw < kernel_width; ++kw)
+        {
+          for (SizeType kh{0}; kh < kernel_height; ++kh)
+          {
+            DataType *element =
+                destination + (channels * ((oh + kh) + (input_height * (ow + kw))));
+            for (SizeType c{0}; c < channels; ++c)
+            {
+              element[c] += *source++;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  ArrayType columns_;
+  ArrayType column_errors_;
 };
 
 }  // namespace ops
@@ -19,12 +19,103 @@
 
 #include "core/assert.hpp"
 #include "ml/ops/weights.hpp"
-#include <set>
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
 
 namespace fetch {
 namespace ml {
 namespace ops {
 
+/**
+ * The gradient of an embedding matrix, stored only for the rows which have been touched: the row
+ * indices, in the order they were first updated, and a contiguous block of values for each row
+ * @tparam T  the tensor/array type
+ */
+template <class T>
+class SparseRowGradient
+{
+public:
+  using ArrayType = T;
+  using DataType  = typename ArrayType::Type;
+  using SizeType  = typename ArrayType::SizeType;
+
+  explicit SparseRowGradient(SizeType columns = 0)
+    : columns_(columns)
+  {}
+
+  /**
+   * Drops all rows and changes the number of values per row
+   */
+  void Reset(SizeType columns)
+  {
+    columns_ = columns;
+    values_.clear();
+    Clear();
+  }
+
+  /**
+   * Drops all rows, keeping the storage for reuse
+   */
+  void Clear()
+  {
+    rows_.clear();
+    positions_.clear();
+  }
+
+  /**
+   * Returns the values of a row, which start at zero the first time the row is touched
+   * @param row the row index in the embedding matrix
+   * @return pointer to the columns() values of the row
+   */
+  DataType *Row(SizeType row)
+  {
+    auto it = positions_.find(row);
+    if (it != positions_.end())
+    {
+      return &values_[it->second * columns_];
+    }
+
+    SizeType const position = rows_.size();
+    positions_.emplace(row, position);
+    rows_.push_back(row);
+
+    if (values_.size() < ((position + 1) * columns_))
+    {
+      values_.resize((position + 1) * columns_);
+    }
+    DataType *values = &values_[position * columns_];
+    std::fill(values, values + columns_, DataType(0));
+    return values;
+  }
+
+  /**
+   * @param position index into rows()
+   * @return pointer to the columns() values of the row at that position
+   */
+  DataType const *Values(SizeType position) const
+  {
+    return &values_[position * columns_];
+  }
+
+  std::vector<SizeType> const &rows() const
+  {
+    return rows_;
+  }
+
+  SizeType columns() const
+  {
+    return columns_;
+  }
+
+private:
+  SizeType                               columns_;
+  std::vector<SizeType>                  rows_;
+  std::unordered_map<SizeType, SizeType> positions_;
+  std::vector<DataType>                  values_;
+};
+
 template <class T>
 class Embeddings : public fetch::ml::ops::Weights<T>
 {
@@ -66,17 +157,24 @@ public:
       this->embeddings_output_ = std::make_shared<ArrayType>(
           std::vector<SizeType>({inputs.front().get().size(), this->output_->shape()[1]}));
     }
-    uint64_t j(0);
+    // copy the looked up rows element wise, building a slice per row dominates small batches
+    SizeType const columns = this->output_->shape()[1];
+    SizeType       j(0);
     for (DataType const &i : inputs.front().get())
     {
-      auto tmp  = this->embeddings_output_->Slice(j);
-      auto tmp2 = this->output_->Slice(typename ArrayType::SizeType(i));
-      tmp.Assign(tmp2);
+      SizeType const row = typename ArrayType::SizeType(double(i));
+      for (SizeType k(0); k < columns; ++k)
+      {
+        this->embeddings_output_->At(j, k) = this->output_->At(row, k);
+      }
       j++;
     }
     return *this->embeddings_output_;
   }
 
+  /**
+   * Accumulates the error signal into the sparse gradient of the rows which were looked up
+   */
   virtual std::vector<ArrayType> Backward(
       std::vector<std::reference_wrapper<const ArrayType>> const &inputs,
       ArrayType const &                                           errorSignal)
@@ -86,34 +184,94 @@ public:
         (inputs.front().get().shape().size() == 1) ||
         ((inputs.front().get().shape().size() == 2) && (inputs.front().get().shape().at(1) == 1)));
 
+    SizeType const columns = gradient_.columns();
+
     uint64_t j(0);
     for (DataType const &i : inputs.front().get())
     {
-      updated_rows_.insert(typename ArrayType::SizeType(double(i)));
-      this->gradient_accumulation_->Slice(typename ArrayType::SizeType(double(i)))
-          .Assign(errorSignal.Slice(j));
+      SizeType const row = typename ArrayType::SizeType(double(i));
+      ASSERT(row < this->output_->shape()[0]);
+
+      DataType *gradient = gradient_.Row(row);
+      for (SizeType k = 0; k < columns; ++k)
+      {
+        gradient[k] += errorSignal.At(j, k);
+      }
       j++;
     }
     return {ArrayType(errorSignal.shape())};
   }
 
+  /**
+   * One row of the embedding matrix per looked up index
+   */
+  virtual std::vector<SizeType> ComputeOutputShape(
+      std::vector<std::reference_wrapper<ArrayType const>> const &inputs) const
+  {
+    return {inputs.front().get().size(), this->output_->shape()[1]};
+  }
+
+  /**
+   * The embedding matrix only needs the shape of its gradient, it is never stored densely
+   */
+  virtual bool SetData(ArrayType const &data)
+  {
+    bool const input_size_changed = PlaceHolder<T>::SetData(data);
+    if (input_size_changed)
+    {
+      gradient_.Reset(this->output_->shape()[1]);
+    }
+    return input_size_changed;
+  }
+
+  /**
+   * Updates only the rows which were touched since the last step
+   */
   virtual void Step(typename T::Type learningRate)
   {
-    for (auto const &r : updated_rows_)
+    ArrayType &    weights = *this->output_;
+    SizeType const columns = gradient_.columns();
+
+    for (SizeType p = 0; p < gradient_.rows().size(); ++p)
     {
-      auto gradient_accumulation_slice = this->gradient_accumulation_->Slice(r).Tensor();
-      auto output_slice                = this->output_->Slice(r).Tensor();
+      SizeType const  row    = gradient_.rows()[p];
+      DataType const *values = gradient_.Values(p);
+      for (SizeType k = 0; k < columns; ++k)
+      {
+        weights.At(row, k) -= learningRate * values[k];
+      }
+    }
+    gradient_.Clear();
+  }
 
-      gradient_accumulation_slice.InlineMultiply(-learningRate);
-      output_slice.InlineAdd(gradient_accumulation_slice);
-      gradient_accumulation_slice.Fill(typename T::Type(0));
+  /**
+   * Only the rows updated by the replica are merged
+   */
+  virtual void MergeGradients(Trainable<T> &replica)
+  {
+    auto &         other   = dynamic_cast<Embeddings<T> &>(replica);
+    SizeType const columns = gradient_.columns();
+
+    for (SizeType p = 0; p < other.gradient_.rows().size(); ++p)
+    {
+      DataType *      gradient = gradient_.Row(other.gradient_.rows()[p]);
+      DataType const *values   = other.gradient_.Values(p);
+      for (SizeType k = 0; k < columns; ++k)
+      {
+        gradient[k] += values[k];
+      }
     }
-    updated_rows_.clear();
+    other.gradient_.Clear();
+  }
+
+  SparseRowGradient<ArrayType> const &GetSparseGradient() const
+  {
+    return gradient_;
   }
 
 private:
-  ArrayPtrType                           embeddings_output_;
-  std::set<typename ArrayType::SizeType> updated_rows_;
+  ArrayPtrType                 embeddings_output_;
+  SparseRowGradient<ArrayType> gradient_;
 };
 
 }  // namespace ops
@@ -0,0 +1,145 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "math/matrix_operations.hpp"
+#include "ml/ops/ops.hpp"
+
+namespace fetch {
+namespace ml {
+namespace ops {
+
+/**
+ * The fused form of MatrixMultiply -> Add -> (optional) Relu, as produced by Graph::Fuse. The bias
+ * and the activation are applied in a single pass over the output of the matrix multiply, so
+ * neither the product nor the biased sum is materialised as a separate tensor
+ * inputs are: {input, weights, bias}
+ * @tparam T  the tensor/array type
+ */
+template <class T>
+class FusedMatrixMultiplyAdd : public fetch::ml::BatchOps<T>
+{
+public:
+  using ArrayType      = T;
+  using DataType       = typename ArrayType::Type;
+  using SizeType       = typename ArrayType::SizeType;
+  using ArrayPtrType   = std::shared_ptr<ArrayType>;
+  using ConstSliceType = typename ArrayType::ConstSliceType;
+
+  explicit FusedMatrixMultiplyAdd(bool relu = false)
+    : relu_(relu)
+  {}
+
+  virtual ~FusedMatrixMultiplyAdd() = default;
+
+  // f(x, w, b)=relu(x.w + b)
+  virtual ArrayType Forward(std::vector<std::reference_wrapper<ArrayType const>> const &inputs,
+                            ArrayType &                                                 output)
+  {
+    ASSERT(inputs.size() == 3);
+    ASSERT(inputs.at(0).get().shape().size() == 2);
+    ASSERT(inputs.at(1).get().shape().size() == 2);
+    ASSERT(output.shape() == ComputeOutputShape(inputs));
+    ASSERT(inputs.at(2).get().size() == output.size());
+
+    fetch::math::Dot(inputs[0].get(), inputs[1].get(), output);
+
+    auto output_it  = output.begin();
+    auto output_end = output.end();
+    auto bias_it    = inputs[2].get().begin();
+
+    while (output_it != output_end)
+    {
+      DataType const value = *output_it + *bias_it;
+      *output_it           = (relu_ && (value <= DataType(0))) ? DataType(0) : value;
+      ++output_it;
+      ++bias_it;
+    }
+
+    // the relu gradient only depends on the sign of the output
+    if (relu_)
+    {
+      output_ = output;
+    }
+    return output;
+  }
+
+  virtual std::vector<ArrayType> Backward(
+      std::vector<std::reference_wrapper<const ArrayType>> const &inputs,
+      ArrayType const &                                           errorSignal)
+  {
+    ASSERT(inputs.size() == 3);
+    ASSERT(errorSignal.size() == inputs.at(2).get().size());
+
+    ArrayType error = errorSignal;
+    if (relu_)
+    {
+      ASSERT(output_.shape() == errorSignal.shape());
+      error = errorSignal.Copy();
+
+      auto error_it  = error.begin();
+      auto error_end = error.end();
+      auto output_it = output_.begin();
+
+      while (error_it != error_end)
+      {
+        if (*output_it <= DataType(0))
+        {
+          *error_it = DataType(0);
+        }
+        ++error_it;
+        ++output_it;
+      }
+    }
+
+    ArrayType errorSignal1(inputs.at(0).get().shape());
+    ArrayType errorSignal2(inputs.at(1).get().shape());
+
+    fetch::math::DotTranspose(error, inputs.at(1).get(), errorSignal1);
+    fetch::math::TransposeDot(inputs.at(0).get(), error, errorSignal2);
+
+    return {errorSignal1, errorSignal2, error};
+  }
+
+  virtual ArrayType ForwardBatch(std::vector<std::reference_wrapper<const ArrayType>> const &inputs)
+  {
+    ArrayType output(ComputeOutputShape(inputs));
+    return Forward(inputs, output);
+  }
+
+  std::vector<SizeType> ComputeOutputShape(
+      std::vector<std::reference_wrapper<ArrayType const>> const &inputs) const
+  {
+    return {inputs.at(0).get().shape()[0], inputs.at(1).get().shape()[1]};
+  }
+
+  bool HasRelu() const
+  {
+    return relu_;
+  }
+
+  static constexpr char const *DESCRIPTOR = "FusedMatrixMultiplyAdd";
+
+private:
+  bool      relu_;
+  ArrayType output_;
+};
+
+}  // namespace ops
+}  // namespace ml
+}  // namespace fetch
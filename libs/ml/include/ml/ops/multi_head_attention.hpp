@@ -0,0 +1,427 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "math/gemm.hpp"
+#include "math/matrix_operations.hpp"
+#include "ml/ops/ops.hpp"
+#include "vectorise/threading/singleton_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace fetch {
+namespace ml {
+namespace ops {
+
+/**
+ * Multi head scaled dot product attention over the [n x d] rows of an input, fused into one op.
+ *
+ * The inputs are the rows X, the packed [d x 3.h] query, key and value projections W (the columns
+ * of the queries of every head, then those of the keys, then those of the values) and the [h x o]
+ * output projection Wo. The queries, keys and values of all the heads are computed by a single
+ * product X.W, after which each head (of h / heads columns) attends on a thread of its own.
+ *
+ * The attention of a head walks over blocks of BLOCK_SIZE queries and keys, keeping a running
+ * maximum and sum of the scores of each query (an online softmax), so that the [n x n] matrix of
+ * the scores is never held in full. The backward pass recomputes the scores of each block from the
+ * log sum of the exponentials kept by the forward pass.
+ */
+template <class T>
+class MultiHeadAttention : public BatchOps<T>
+{
+public:
+  using ArrayType    = T;
+  using SizeType     = typename ArrayType::SizeType;
+  using DataType     = typename ArrayType::Type;
+  using ArrayPtrType = std::shared_ptr<ArrayType>;
+  using MatrixView   = fetch::math::details_gemm::MatrixView<DataType>;
+
+  static_assert(std::is_floating_point<DataType>::value,
+                "MultiHeadAttention requires a floating point type");
+
+  static constexpr SizeType BLOCK_SIZE = 64;  ///< The queries and keys of a block
+
+  explicit MultiHeadAttention(SizeType num_heads = 1)
+    : num_heads_(num_heads)
+  {
+    ASSERT(num_heads_ > 0);
+  }
+
+  ~MultiHeadAttention() = default;
+
+  ArrayType Forward(std::vector<std::reference_wrapper<ArrayType const>> const &inputs,
+                    ArrayType &                                                 output)
+  {
+    CheckInputs(inputs);
+    ASSERT(output.shape() == ComputeOutputShape(inputs));
+
+    ArrayType const &projection = inputs.at(2).get();
+
+    SizeType const rows  = inputs.at(0).get().shape()[0];
+    SizeType const width = projection.shape()[0];
+
+    Attend(inputs);
+
+    // output = heads . Wo
+    fetch::math::details_gemm::Multiply(DataType(1), fetch::math::details_gemm::View(heads_),
+                                        fetch::math::details_gemm::View(projection), DataType(0),
+                                        output.data().pointer(), rows, rows,
+                                        projection.shape()[1], width);
+    return output;
+  }
+
+  std::vector<ArrayType> Backward(
+      std::vector<std::reference_wrapper<const ArrayType>> const &inputs,
+      ArrayType const &                                           errorSignal)
+  {
+    CheckInputs(inputs);
+    ASSERT(errorSignal.shape() == ComputeOutputShape(inputs));
+
+    ArrayType const &input      = inputs.at(0).get();
+    ArrayType const &weights    = inputs.at(1).get();
+    ArrayType const &projection = inputs.at(2).get();
+
+    SizeType const rows    = input.shape()[0];
+    SizeType const columns = input.shape()[1];
+    SizeType const width   = projection.shape()[0];
+    SizeType const outputs = projection.shape()[1];
+
+    ArrayType inputError(input.shape());
+    ArrayType weightsError(weights.shape());
+    ArrayType projectionError(projection.shape());
+
+    // the heads of the forward pass may since have been replaced by those of another input
+    Attend(inputs);
+
+    MatrixView const error = fetch::math::details_gemm::View(errorSignal);
+
+    // projectionError = heads^T . errorSignal
+    fetch::math::details_gemm::Multiply(
+        DataType(1), fetch::math::details_gemm::View(heads_).Transposed(), error, DataType(0),
+        projectionError.data().pointer(), width, width, outputs, rows);
+
+    // headErrors = errorSignal . Wo^T
+    Resize(head_errors_, {rows, width});
+    fetch::math::details_gemm::Multiply(
+        DataType(1), error, fetch::math::details_gemm::View(projection).Transposed(), DataType(0),
+        head_errors_.data().pointer(), rows, rows, width, outputs);
+
+    Resize(qkv_errors_, {rows, 3 * width});
+    std::fill(qkv_errors_.data().pointer(), qkv_errors_.data().pointer() + (rows * 3 * width),
+              DataType(0));
+
+    ForEachHead([this, rows, width](SizeType head) { BackwardHead(head, rows, width); });
+
+    MatrixView const qkv_errors = fetch::math::details_gemm::View(qkv_errors_);
+
+    // weightsError = X^T . qkvErrors
+    fetch::math::details_gemm::Multiply(
+        DataType(1), fetch::math::details_gemm::View(input).Transposed(), qkv_errors, DataType(0),
+        weightsError.data().pointer(), columns, columns, 3 * width, rows);
+
+    // inputError = qkvErrors . W^T
+    fetch::math::details_gemm::Multiply(
+        DataType(1), qkv_errors, fetch::math::details_gemm::View(weights).Transposed(),
+        DataType(0), inputError.data().pointer(), rows, rows, columns, 3 * width);
+
+    return {inputError, weightsError, projectionError};
+  }
+
+  std::vector<SizeType> ComputeOutputShape(
+      std::vector<std::reference_wrapper<ArrayType const>> const &inputs) const
+  {
+    return {inputs.at(0).get().shape()[0], inputs.at(2).get().shape()[1]};
+  }
+
+  SizeType num_heads() const
+  {
+    return num_heads_;
+  }
+
+  static constexpr char const *DESCRIPTOR = "MultiHeadAttention";
+
+private:
+  void CheckInputs(std::vector<std::reference_wrapper<ArrayType const>> const &inputs) const
+  {
+    ASSERT(inputs.size() == 3);
+    // Input should be a 2D tensor [n x d]
+    ASSERT(inputs.at(0).get().shape().size() == 2);
+    // Packed projections should be a 2D tensor [d x 3.h]
+    ASSERT(inputs.at(1).get().shape().size() == 2);
+    ASSERT(inputs.at(0).get().shape()[1] == inputs.at(1).get().shape()[0]);
+    ASSERT(inputs.at(1).get().shape()[1] == 3 * inputs.at(2).get().shape()[0]);
+    // Output projection should be a 2D tensor [h x o], split evenly between the heads
+    ASSERT(inputs.at(2).get().shape().size() == 2);
+    ASSERT((inputs.at(2).get().shape()[0] % num_heads_) == 0);
+    (void)inputs;
+  }
+
+  static void Resize(ArrayType &matrix, std::vector<SizeType> const &shape)
+  {
+    if (matrix.shape() != shape)
+    {
+      matrix.ResizeFromShape(shape);
+    }
+  }
+
+  /// Call function(head) for every head, spreading the heads over the threads of the pool
+  template <typename Function>
+  void ForEachHead(Function const &function) const
+  {
+    SizeType const num_threads = std::min(fetch::math::MaxThreads(), num_heads_);
+    if (num_threads <= 1)
+    {
+      for (SizeType head{0}; head < num_heads_; ++head)
+      {
+        function(head);
+      }
+      return;
+    }
+
+    SizeType const chunk = (num_heads_ + num_threads - 1) / num_threads;
+
+    threading::SingletonPool::GetInstance().ParallelFor(
+        0, num_heads_, chunk, [&function](SizeType begin, SizeType end) {
+          for (SizeType head = begin; head < end; ++head)
+          {
+            function(head);
+          }
+        });
+  }
+
+  /// Compute the packed queries, keys and values of the input and the attention of every head
+  void Attend(std::vector<std::reference_wrapper<ArrayType const>> const &inputs)
+  {
+    ArrayType const &input   = inputs.at(0).get();
+    ArrayType const &weights = inputs.at(1).get();
+
+    SizeType const rows  = input.shape()[0];
+    SizeType const width = inputs.at(2).get().shape()[0];
+
+    Resize(qkv_, {rows, 3 * width});
+    Resize(heads_, {rows, width});
+    log_sums_.resize(rows * num_heads_);
+
+    // qkv = X . W
+    fetch::math::details_gemm::Multiply(DataType(1), fetch::math::details_gemm::View(input),
+                                        fetch::math::details_gemm::View(weights), DataType(0),
+                                        qkv_.data().pointer(), rows, rows, 3 * width,
+                                        input.shape()[1]);
+
+    ForEachHead([this, rows, width](SizeType head) { ForwardHead(head, rows, width); });
+  }
+
+  /**
+   * The attention of a single head, softmax(scale . Q.K^T).V, written to the columns of the head
+   * in heads_ along with the log sum of the exponentials of the scores of each query
+   */
+  void ForwardHead(SizeType head, SizeType rows, SizeType width)
+  {
+    SizeType const size  = width / num_heads_;
+    DataType const scale = DataType(1) / std::sqrt(static_cast<DataType>(size));
+
+    MatrixView const qkv     = fetch::math::details_gemm::View(qkv_);
+    MatrixView const queries = qkv.Offset(0, head * size);
+    MatrixView const keys    = qkv.Offset(0, width + (head * size));
+    MatrixView const values  = qkv.Offset(0, (2 * width) + (head * size));
+
+    DataType *output   = heads_.data().pointer() + (head * size * rows);
+    DataType *log_sums = log_sums_.data() + (head * rows);
+
+    std::vector<DataType> scores(BLOCK_SIZE * BLOCK_SIZE);
+    std::vector<DataType> maximum(BLOCK_SIZE);
+    std::vector<DataType> total(BLOCK_SIZE);
+
+    for (SizeType q{0}; q < rows; q += BLOCK_SIZE)
+    {
+      SizeType const num_queries = std::min(BLOCK_SIZE, rows - q);
+      DataType *     accumulated = output + q;
+
+      std::fill(maximum.begin(), maximum.end(), -std::numeric_limits<DataType>::infinity());
+      std::fill(total.begin(), total.end(), DataType(0));
+      for (SizeType c{0}; c < size; ++c)
+      {
+        std::fill(accumulated + (c * rows), accumulated + (c * rows) + num_queries, DataType(0));
+      }
+
+      for (SizeType k{0}; k < rows; k += BLOCK_SIZE)
+      {
+        SizeType const num_keys = std::min(BLOCK_SIZE, rows - k);
+
+        // scores = scale . Q_q . K_k^T
+        fetch::math::details_gemm::Multiply(scale, queries.Offset(q, 0),
+                                            keys.Offset(k, 0).Transposed(), DataType(0),
+                                            scores.data(), num_queries, num_queries, num_keys,
+                                            size);
+
+        for (SizeType i{0}; i < num_queries; ++i)
+        {
+          DataType block_maximum = maximum[i];
+          for (SizeType j{0}; j < num_keys; ++j)
+          {
+            block_maximum = std::max(block_maximum, scores[i + (j * num_queries)]);
+          }
+
+          // rescale what has been accumulated so far to the new maximum
+          DataType const correction = std::exp(maximum[i] - block_maximum);
+          DataType       sum{0};
+          for (SizeType j{0}; j < num_keys; ++j)
+          {
+            DataType &score = scores[i + (j * num_queries)];
+            score           = std::exp(score - block_maximum);
+            sum += score;
+          }
+
+          maximum[i] = block_maximum;
+          total[i]   = (total[i] * correction) + sum;
+
+          if (correction != DataType(1))
+          {
+            for (SizeType c{0}; c < size; ++c)
+            {
+              accumulated[i + (c * rows)] *= correction;
+            }
+          }
+        }
+
+        // accumulated += P . V_k
+        fetch::math::details_gemm::Multiply(DataType(1), MatrixView{scores.data(), 1, num_queries},
+                                            values.Offset(k, 0), DataType(1), accumulated, rows,
+                                            num_queries, size, num_keys);
+      }
+
+      for (SizeType i{0}; i < num_queries; ++i)
+      {
+        DataType const inverse = DataType(1) / total[i];
+        for (SizeType c{0}; c < size; ++c)
+        {
+          accumulated[i + (c * rows)] *= inverse;
+        }
+
+        log_sums[q + i] = maximum[i] + std::log(total[i]);
+      }
+    }
+  }
+
+  /**
+   * The errors of the queries, keys and values of a single head, from the errors of its output in
+   * head_errors_, written to the columns of the head in qkv_errors_
+   */
+  void BackwardHead(SizeType head, SizeType rows, SizeType width)
+  {
+    SizeType const size  = width / num_heads_;
+    DataType const scale = DataType(1) / std::sqrt(static_cast<DataType>(size));
+
+    MatrixView const qkv     = fetch::math::details_gemm::View(qkv_);
+    MatrixView const queries = qkv.Offset(0, head * size);
+    MatrixView const keys    = qkv.Offset(0, width + (head * size));
+    MatrixView const values  = qkv.Offset(0, (2 * width) + (head * size));
+    MatrixView const outputs = fetch::math::details_gemm::View(heads_).Offset(0, head * size);
+    MatrixView const errors  = fetch::math::details_gemm::View(head_errors_).Offset(0, head * size);
+
+    DataType *const query_errors = qkv_errors_.data().pointer() + (head * size * rows);
+    DataType *const key_errors   = query_errors + (width * rows);
+    DataType *const value_errors = key_errors + (width * rows);
+
+    DataType const *log_sums = log_sums_.data() + (head * rows);
+
+    // the softmax term of each query, rowsum(errors o outputs)
+    std::vector<DataType> deltas(rows, DataType(0));
+    for (SizeType c{0}; c < size; ++c)
+    {
+      for (SizeType i{0}; i < rows; ++i)
+      {
+        deltas[i] += errors(i, c) * outputs(i, c);
+      }
+    }
+
+    std::vector<DataType> probabilities(BLOCK_SIZE * BLOCK_SIZE);
+    std::vector<DataType> gradients(BLOCK_SIZE * BLOCK_SIZE);
+
+    for (SizeType q{0}; q < rows; q += BLOCK_SIZE)
+    {
+      SizeType const num_queries = std::min(BLOCK_SIZE, rows - q);
+
+      for (SizeType k{0}; k < rows; k += BLOCK_SIZE)
+      {
+        SizeType const num_keys = std::min(BLOCK_SIZE, rows - k);
+
+        MatrixView const block_probabilities{probabilities.data(), 1, num_queries};
+        MatrixView const block_gradients{gradients.data(), 1, num_queries};
+
+        // probabilities = exp(scale . Q_q . K_k^T - logsum)
+        fetch::math::details_gemm::Multiply(scale, queries.Offset(q, 0),
+                                            keys.Offset(k, 0).Transposed(), DataType(0),
+                                            probabilities.data(), num_queries, num_queries,
+                                            num_keys, size);
+        for (SizeType j{0}; j < num_keys; ++j)
+        {
+          for (SizeType i{0}; i < num_queries; ++i)
+          {
+            DataType &probability = probabilities[i + (j * num_queries)];
+            probability           = std::exp(probability - log_sums[q + i]);
+          }
+        }
+
+        // valueErrors_k += P^T . errors_q
+        fetch::math::details_gemm::Multiply(DataType(1), block_probabilities.Transposed(),
+                                            errors.Offset(q, 0), DataType(1), value_errors + k,
+                                            rows, num_keys, size, num_queries);
+
+        // gradients = P o (errors_q . V_k^T - deltas)
+        fetch::math::details_gemm::Multiply(DataType(1), errors.Offset(q, 0),
+                                            values.Offset(k, 0).Transposed(), DataType(0),
+                                            gradients.data(), num_queries, num_queries, num_keys,
+                                            size);
+        for (SizeType j{0}; j < num_keys; ++j)
+        {
+          for (SizeType i{0}; i < num_queries; ++i)
+          {
+            SizeType const index = i + (j * num_queries);
+            gradients[index]     = probabilities[index] * (gradients[index] - deltas[q + i]);
+          }
+        }
+
+        // queryErrors_q += scale . gradients . K_k
+        fetch::math::details_gemm::Multiply(scale, block_gradients, keys.Offset(k, 0),
+                                            DataType(1), query_errors + q, rows, num_queries,
+                                            size, num_keys);
+
+        // keyErrors_k += scale . gradients^T . Q_q
+        fetch::math::details_gemm::Multiply(scale, block_gradients.Transposed(),
+                                            queries.Offset(q, 0), DataType(1), key_errors + k,
+                                            rows, num_keys, size, num_queries);
+      }
+    }
+  }
+
+  SizeType              num_heads_;
+  ArrayType             qkv_;          ///< The packed queries, keys and values [n x 3.h]
+  ArrayType             heads_;        ///< The attention of every head [n x h]
+  ArrayType             head_errors_;  ///< The errors of the attention of every head [n x h]
+  ArrayType             qkv_errors_;   ///< The errors of the packed queries, keys and values
+  std::vector<DataType> log_sums_;     ///< The log sum of the exponentials, per head and query
+};
+
+}  // namespace ops
+}  // namespace ml
+}  // namespace fetch
@@ -18,6 +18,7 @@
 //------------------------------------------------------------------------------
 
 #include "core/random/lfg.hpp"
+#include "math/tensor_expression.hpp"
 
 #include "ml/ops/placeholder.hpp"
 #include "ml/state_dict.hpp"
@@ -53,6 +54,12 @@ public:
   virtual void                           Step(typename T::Type learningRate) = 0;
   virtual struct fetch::ml::StateDict<T> StateDict() const                   = 0;
   virtual void LoadStateDict(struct fetch::ml::StateDict<T> const &dict)     = 0;
+
+  /**
+   * Adds the gradients accumulated by a replica of this op (e.g. one trained on another part of the
+   * batch) to this op's, and clears them from the replica
+   */
+  virtual void MergeGradients(Trainable<T> &replica) = 0;
 };
 
 template <class T>
@@ -92,13 +99,22 @@ public:
 
   virtual void Step(typename T::Type learningRate)
   {
-    this->gradient_accumulation_->InlineMultiply(-learningRate);
-    this->output_->InlineAdd(*gradient_accumulation_);
+    // a single fused pass over the weights and the gradients
+    using fetch::math::Lazy;
+    fetch::math::Evaluate(Lazy(*this->output_) + Lazy(*gradient_accumulation_) * (-learningRate),
+                          *this->output_);
     // Major DL framework do not do that, but as I can't think of any reason why, I'll leave it here
     // for convenience. Remove if needed -- Pierre
     gradient_accumulation_->Fill(typename T::Type(0));
   }
 
+  virtual void MergeGradients(Trainable<T> &replica)
+  {
+    auto &other = dynamic_cast<Weights<T> &>(replica);
+    gradient_accumulation_->InlineAdd(*other.gradient_accumulation_);
+    other.gradient_accumulation_->Fill(typename T::Type(0));
+  }
+
   /**
    * constructs a state dictionary used for exporting/saving weights
    * @return
@@ -0,0 +1,460 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ml/state_dict.hpp"
+#include "vectorise/memory/array_pool.hpp"
+#include "vectorise/memory/vector_slice.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fetch {
+namespace ml {
+
+/**
+ * A checkpoint of the weights of a state dict which can be loaded without copying the weights.
+ *
+ * The file is a header, followed by a table of the tensors (the path of each in the state dict,
+ * its shape and the offset of its elements) and then the elements of each tensor. The elements
+ * start on a 64 byte boundary and are padded with zeros to the padded size of the tensor storage,
+ * so that the loaded tensors can use the file mapping as their storage directly.
+ *
+ * The file is mapped privately (copy-on-write): the pages are shared, through the page cache, with
+ * every other process which has loaded the same checkpoint until a tensor is written to, at which
+ * point the written page is copied. The file itself is never modified.
+ *
+ * The checkpoint is in the byte order of the machine, and must be loaded with the type of tensor
+ * it was saved from.
+ */
+template <class T>
+class Checkpoint
+{
+public:
+  using ArrayType     = T;
+  using ArrayPtrType  = std::shared_ptr<ArrayType>;
+  using DataType      = typename ArrayType::Type;
+  using SizeType      = typename ArrayType::SizeType;
+  using ContainerType = typename ArrayType::ContainerType;
+  using Path          = std::vector<std::string>;
+
+  static constexpr char const *MAGIC     = "FETCHCKP";
+  static constexpr uint32_t    VERSION   = 1;
+  static constexpr uint64_t    ALIGNMENT = memory::ArrayPool::ALIGNMENT;
+
+  static void         Save(StateDict<T> const &dict, std::string const &filename);
+  static StateDict<T> Load(std::string const &filename);
+
+private:
+  struct Header
+  {
+    char     magic[8];
+    uint32_t version;
+    uint32_t element_size;
+    uint64_t num_entries;  ///< The entries of the table, one per tensor or empty leaf
+    uint64_t table_size;   ///< The size of the table in bytes
+  };
+
+  struct Entry
+  {
+    Path                  path;
+    std::vector<SizeType> shape;
+    uint64_t              offset{0};  ///< The offset of the elements in the file, 0 for none
+    ArrayPtrType          tensor;
+  };
+
+  using Entries = std::vector<Entry>;
+  using Mapping = std::shared_ptr<uint8_t>;
+
+  static void     Collect(StateDict<T> const &dict, Path &path, Entries &entries);
+  static uint64_t PaddedBytes(std::vector<SizeType> const &shape);
+  static uint64_t Align(uint64_t offset);
+  static Mapping  Map(std::string const &filename, uint64_t &size);
+
+  /// Reads the fields of the table, checking each against the end of the table
+  class Reader
+  {
+  public:
+    Reader(uint8_t const *data, uint64_t size)
+      : data_(data)
+      , size_(size)
+    {}
+
+    uint64_t    ReadInteger();
+    uint64_t    ReadCount();
+    std::string ReadString();
+
+  private:
+    uint8_t const *data_;
+    uint64_t       size_;
+    uint64_t       position_{0};
+  };
+};
+
+/**
+ * Write the weights of a state dict to a checkpoint file, replacing the file if it exists
+ *
+ * @param dict The state dict to be saved
+ * @param filename The path of the checkpoint file
+ */
+template <class T>
+void Checkpoint<T>::Save(StateDict<T> const &dict, std::string const &filename)
+{
+  Entries entries;
+  Path    path;
+  Collect(dict, path, entries);
+
+  // the table, whose size sets the offset of the elements of the first tensor
+  std::string           table;
+  std::vector<uint64_t> offset_fields;
+  auto                  write_integer = [&table](uint64_t value) {
+    table.append(reinterpret_cast<char const *>(&value), sizeof(value));
+  };
+
+  for (auto const &entry : entries)
+  {
+    write_integer(entry.path.size());
+    for (auto const &key : entry.path)
+    {
+      write_integer(key.size());
+      table.append(key);
+    }
+
+    write_integer(entry.shape.size());
+    for (auto const &dimension : entry.shape)
+    {
+      write_integer(dimension);
+    }
+
+    // filled in once the size of the table is known
+    offset_fields.push_back(table.size());
+    write_integer(0);
+  }
+
+  uint64_t offset = Align(sizeof(Header) + table.size());
+  for (std::size_t i = 0; i < entries.size(); ++i)
+  {
+    if (!entries[i].tensor)
+    {
+      continue;
+    }
+
+    entries[i].offset = offset;
+    std::memcpy(&table[offset_fields[i]], &offset, sizeof(offset));
+
+    offset = Align(offset + PaddedBytes(entries[i].shape));
+  }
+
+  Header header{};
+  std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+  header.version      = VERSION;
+  header.element_size = static_cast<uint32_t>(sizeof(DataType));
+  header.num_entries  = entries.size();
+  header.table_size   = table.size();
+
+  std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+  if (!stream)
+  {
+    throw std::runtime_error("Unable to create checkpoint: " + filename);
+  }
+
+  stream.write(reinterpret_cast<char const *>(&header), sizeof(header));
+  stream.write(table.data(), static_cast<std::streamsize>(table.size()));
+
+  uint64_t                position = sizeof(Header) + table.size();
+  std::vector<char> const zeros(ALIGNMENT, 0);
+  auto                    pad_to = [&stream, &position, &zeros](uint64_t target) {
+    while (position < target)
+    {
+      uint64_t const count = std::min<uint64_t>(target - position, zeros.size());
+      stream.write(zeros.data(), static_cast<std::streamsize>(count));
+      position += count;
+    }
+  };
+
+  for (auto const &entry : entries)
+  {
+    if (!entry.tensor)
+    {
+      continue;
+    }
+
+    pad_to(entry.offset);
+
+    // tensors are held contiguously in column major order
+    uint64_t const bytes = entry.tensor->size() * sizeof(DataType);
+    stream.write(reinterpret_cast<char const *>(entry.tensor->data().pointer()),
+                 static_cast<std::streamsize>(bytes));
+    position += bytes;
+
+    pad_to(entry.offset + PaddedBytes(entry.shape));
+  }
+
+  pad_to(offset);
+
+  if (!stream.flush())
+  {
+    throw std::runtime_error("Unable to write checkpoint: " + filename);
+  }
+}
+
+/**
+ * Load a checkpoint file into a state dict whose tensors are backed by a private mapping of the
+ * file. The mapping is released once the last of the tensors is.
+ *
+ * @param filename The path of the checkpoint file
+ * @return The state dict
+ */
+template <class T>
+StateDict<T> Checkpoint<T>::Load(std::string const &filename)
+{
+  uint64_t      size{0};
+  Mapping const mapping = Map(filename, size);
+
+  Header header{};
+  if (size < sizeof(Header))
+  {
+    throw std::runtime_error("Truncated checkpoint: " + filename);
+  }
+  std::memcpy(&header, mapping.get(), sizeof(header));
+
+  if (std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0)
+  {
+    throw std::runtime_error("Not a checkpoint: " + filename);
+  }
+
+  if ((header.version != VERSION) || (header.element_size != sizeof(DataType)))
+  {
+    throw std::runtime_error("Incompatible checkpoint: " + filename);
+  }
+
+  if (header.table_size > (size - sizeof(Header)))
+  {
+    throw std::runtime_error("Truncated checkpoint: " + filename);
+  }
+
+  StateDict<T> dict;
+  Reader       reader(mapping.get() + sizeof(Header), header.table_size);
+
+  for (uint64_t i = 0; i < header.num_entries; ++i)
+  {
+    Path path(reader.ReadCount());
+    for (auto &key : path)
+    {
+      key = reader.ReadString();
+    }
+
+    std::vector<SizeType> shape(reader.ReadCount());
+    for (auto &dimension : shape)
+    {
+      dimension = reader.ReadInteger();
+    }
+
+    StateDict<T> *node = &dict;
+    for (auto const &key : path)
+    {
+      node = &node->dict_[key];
+    }
+
+    uint64_t const offset = reader.ReadInteger();
+    if (offset == 0)
+    {
+      continue;
+    }
+
+    uint64_t const bytes = PaddedBytes(shape);
+    if (((offset % ALIGNMENT) != 0) || (offset > size) || (bytes > (size - offset)))
+    {
+      throw std::runtime_error("Truncated checkpoint: " + filename);
+    }
+
+    // the tensor shares the ownership of the mapping
+    std::shared_ptr<DataType> region(mapping, reinterpret_cast<DataType *>(mapping.get() + offset));
+    ContainerType storage(std::move(region), ArrayType::SizeFromShape(shape));
+
+    node->weights_ = std::make_shared<ArrayType>(std::move(storage), shape);
+  }
+
+  return dict;
+}
+
+/// Internal: gather the tensors of a state dict, depth first, along with their paths
+template <class T>
+void Checkpoint<T>::Collect(StateDict<T> const &dict, Path &path, Entries &entries)
+{
+  // empty leaves are kept as entries without a tensor, so that the structure round trips
+  if (dict.weights_ || dict.dict_.empty())
+  {
+    Entry entry{};
+    entry.path   = path;
+    entry.tensor = dict.weights_;
+    if (entry.tensor)
+    {
+      entry.shape = entry.tensor->shape();
+    }
+    entries.push_back(std::move(entry));
+  }
+
+  for (auto const &child : dict.dict_)
+  {
+    path.push_back(child.first);
+    Collect(child.second, path, entries);
+    path.pop_back();
+  }
+}
+
+/// Internal: the size of the storage of a tensor of the shape, including its padding
+template <class T>
+uint64_t Checkpoint<T>::PaddedBytes(std::vector<SizeType> const &shape)
+{
+  memory::VectorSlice<DataType> const slice(nullptr, ArrayType::SizeFromShape(shape));
+  return slice.padded_size() * sizeof(DataType);
+}
+
+template <class T>
+uint64_t Checkpoint<T>::Align(uint64_t offset)
+{
+  return ((offset + ALIGNMENT - 1) / ALIGNMENT) * ALIGNMENT;
+}
+
+/**
+ * Internal: map the whole of a file, privately and writable so that the tensors can be modified
+ * without affecting the file. Where mapping is not available the file is read into memory.
+ *
+ * @param filename The path of the file
+ * @param size The size of the file, set on return
+ * @return The mapping, which is released with the last of its owners
+ */
+template <class T>
+typename Checkpoint<T>::Mapping Checkpoint<T>::Map(std::string const &filename, uint64_t &size)
+{
+#if defined(__unix__) || defined(__APPLE__)
+  int const fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    throw std::runtime_error("Unable to open checkpoint: " + filename);
+  }
+
+  struct stat status
+  {
+  };
+  if ((fstat(fd, &status) != 0) || (status.st_size <= 0))
+  {
+    close(fd);
+    throw std::runtime_error("Unable to map checkpoint: " + filename);
+  }
+
+  size          = static_cast<uint64_t>(status.st_size);
+  void *address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (address == MAP_FAILED)
+  {
+    throw std::runtime_error("Unable to map checkpoint: " + filename);
+  }
+
+  uint64_t const length = size;
+  return Mapping(static_cast<uint8_t *>(address),
+                 [length](uint8_t *data) { munmap(data, length); });
+#else
+  std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+  if (!stream)
+  {
+    throw std::runtime_error("Unable to open checkpoint: " + filename);
+  }
+
+  size = static_cast<uint64_t>(stream.tellg());
+  stream.seekg(0);
+
+  Mapping data(static_cast<uint8_t *>(memory::ArrayPool::Allocate(size)),
+               memory::ArrayPool::Deleter(size));
+  if (!stream.read(reinterpret_cast<char *>(data.get()), static_cast<std::streamsize>(size)))
+  {
+    throw std::runtime_error("Unable to read checkpoint: " + filename);
+  }
+
+  return data;
+#endif
+}
+
+template <class T>
+uint64_t Checkpoint<T>::Reader::ReadInteger()
+{
+  if ((size_ - position_) < sizeof(uint64_t))
+  {
+    throw std::runtime_error("Truncated checkpoint table");
+  }
+
+  uint64_t value{0};
+  std::memcpy(&value, data_ + position_, sizeof(value));
+  position_ += sizeof(value);
+
+  return value;
+}
+
+/// The number of the fields which follow, each of which takes at least one integer
+template <class T>
+uint64_t Checkpoint<T>::Reader::ReadCount()
+{
+  uint64_t const count = ReadInteger();
+  if (count > ((size_ - position_) / sizeof(uint64_t)))
+  {
+    throw std::runtime_error("Truncated checkpoint table");
+  }
+
+  return count;
+}
+
+template <class T>
+std::string Checkpoint<T>::Reader::ReadString()
+{
+  uint64_t const length = ReadInteger();
+  if ((size_ - position_) < length)
+  {
+    throw std::runtime_error("Truncated checkpoint table");
+  }
+
+  std::string value(reinterpret_cast<char const *>(data_ + position_), length);
+  position_ += length;
+
+  return value;
+}
+
+template <class T>
+constexpr char const *Checkpoint<T>::MAGIC;
+template <class T>
+constexpr uint32_t Checkpoint<T>::VERSION;
+template <class T>
+constexpr uint64_t Checkpoint<T>::ALIGNMENT;
+
+}  // namespace ml
+}  // namespace fetch
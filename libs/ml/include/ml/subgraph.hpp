@@ -18,6 +18,7 @@
 //------------------------------------------------------------------------------
 
 #include "ml/graph.hpp"
+#include <algorithm>
 #include <iostream>
 #include <memory>
 
@@ -46,7 +47,7 @@ public:
     {
       this->SetInput(input_nodes_[i], inputs.at(i));
     }
-    return output_node_->Evaluate();
+    return this->GetPlan(this->nodes_.at(output_node_)).Forward(this->buffers_, false);
   }
 
   virtual std::vector<ArrayType> Backward(
@@ -55,7 +56,7 @@ public:
   {
     ASSERT(inputs.size() == this->input_nodes_.size());
     std::vector<std::pair<NodeInterface<T> *, ArrayType>> nonBackpropagatedErrorSignals =
-        this->output_node_->BackPropagate(errorSignal);
+        this->GetPlan(this->nodes_.at(output_node_)).Backward(errorSignal);
     std::vector<ArrayType> backpropagatedErrorSignals;
 
     for (std::string const &s : input_nodes_)
@@ -84,15 +85,24 @@ protected:
 
   void SetOutputNode(std::string const &node_name)
   {
-    output_node_ = this->nodes_[node_name];
+    output_node_ = node_name;
+  }
+
+  /**
+   * The input and output nodes are referred to by name, so a rewrite must keep them
+   */
+  virtual bool IsRemovable(std::string const &node_name) const
+  {
+    return (node_name != output_node_) &&
+           (std::find(input_nodes_.begin(), input_nodes_.end(), node_name) == input_nodes_.end());
   }
 
 protected:
   SubGraph() = default;
 
 private:
-  std::vector<std::string>          input_nodes_;
-  std::shared_ptr<NodeInterface<T>> output_node_;
+  std::vector<std::string> input_nodes_;
+  std::string              output_node_;
 };
 
 }  // namespace ml
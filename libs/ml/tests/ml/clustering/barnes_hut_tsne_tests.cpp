@@ -0,0 +1,207 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "math/tensor.hpp"
+#include "ml/clustering/barnes_hut_tsne.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+template <typename T>
+class BarnesHutTsneTests : public ::testing::Test
+{
+};
+
+using MyTypes = ::testing::Types<fetch::math::Tensor<float>, fetch::math::Tensor<double>,
+                                 fetch::math::Tensor<fetch::fixed_point::FixedPoint<32, 32>>>;
+
+TYPED_TEST_CASE(BarnesHutTsneTests, MyTypes);
+
+namespace {
+
+constexpr fetch::math::SizeType N_CLUSTERS        = 4;
+constexpr fetch::math::SizeType POINTS_PER_CLUSTER = 50;
+
+/// Easily separable clusters of data in 3 dimensions, cluster after cluster
+template <typename ArrayType>
+ArrayType MakeClusters()
+{
+  using DataType = typename ArrayType::Type;
+  using SizeType = typename ArrayType::SizeType;
+
+  ArrayType A({N_CLUSTERS * POINTS_PER_CLUSTER, 3});
+  for (SizeType cluster = 0; cluster < N_CLUSTERS; ++cluster)
+  {
+    for (SizeType i = 0; i < POINTS_PER_CLUSTER; ++i)
+    {
+      for (SizeType j = 0; j < 3; ++j)
+      {
+        double const centre = ((cluster >> j) & 1) ? 50 : -50;
+        double const offset = static_cast<double>((i * (j + 3) * 7) % 23) / 4;
+        A.Set((cluster * POINTS_PER_CLUSTER) + i, j, DataType(centre + offset));
+      }
+    }
+  }
+  return A;
+}
+
+/// Every point of the embedding is nearer to the centroid of its own cluster than to any other
+template <typename ArrayType>
+void ExpectClustersSeparated(ArrayType const &output)
+{
+  using SizeType = typename ArrayType::SizeType;
+
+  SizeType const      dimensions = output.shape().at(1);
+  std::vector<double> centroids(N_CLUSTERS * dimensions, 0);
+  for (SizeType i = 0; i < output.shape().at(0); ++i)
+  {
+    for (SizeType j = 0; j < dimensions; ++j)
+    {
+      centroids[((i / POINTS_PER_CLUSTER) * dimensions) + j] +=
+          static_cast<double>(output.At(i, j)) / POINTS_PER_CLUSTER;
+    }
+  }
+
+  for (SizeType i = 0; i < output.shape().at(0); ++i)
+  {
+    SizeType nearest          = 0;
+    double   nearest_distance = std::numeric_limits<double>::max();
+    for (SizeType cluster = 0; cluster < N_CLUSTERS; ++cluster)
+    {
+      double distance = 0;
+      for (SizeType j = 0; j < dimensions; ++j)
+      {
+        double const difference =
+            static_cast<double>(output.At(i, j)) - centroids[(cluster * dimensions) + j];
+        distance += difference * difference;
+      }
+      if (distance < nearest_distance)
+      {
+        nearest          = cluster;
+        nearest_distance = distance;
+      }
+    }
+    EXPECT_EQ(nearest, i / POINTS_PER_CLUSTER);
+  }
+}
+
+template <typename ArrayType>
+ArrayType RunTest(typename ArrayType::SizeType output_dimensions, typename ArrayType::Type theta)
+{
+  using DataType = typename ArrayType::Type;
+  using SizeType = typename ArrayType::SizeType;
+
+  ArrayType A = MakeClusters<ArrayType>();
+
+  fetch::ml::BarnesHutTSNE<ArrayType> tsn(A, output_dimensions, DataType(10), SizeType{123456},
+                                          theta);
+  tsn.Optimize(DataType(100), SizeType{200}, DataType{0.5f}, DataType{0.8f}, SizeType{20},
+               SizeType{50});
+  return tsn.GetOutputMatrix();
+}
+
+}  // namespace
+
+TYPED_TEST(BarnesHutTsneTests, separates_clusters_in_2d)
+{
+  using DataType = typename TypeParam::Type;
+
+  TypeParam output = RunTest<TypeParam>(2, DataType{0.5f});
+
+  ASSERT_EQ(output.shape().at(0), N_CLUSTERS * POINTS_PER_CLUSTER);
+  ASSERT_EQ(output.shape().at(1), 2);
+  ExpectClustersSeparated(output);
+}
+
+TYPED_TEST(BarnesHutTsneTests, separates_clusters_in_3d)
+{
+  using DataType = typename TypeParam::Type;
+
+  TypeParam output = RunTest<TypeParam>(3, DataType{0.5f});
+
+  ASSERT_EQ(output.shape().at(1), 3);
+  ExpectClustersSeparated(output);
+}
+
+TEST(BarnesHutTsneTests, tree_repulsion_matches_exact_sum)
+{
+  using SizeType = fetch::math::SizeType;
+
+  SizeType const      n_points   = 300;
+  SizeType const      dimensions = 2;
+  std::vector<double> points(n_points * dimensions);
+  for (SizeType i = 0; i < points.size(); ++i)
+  {
+    points[i] = static_cast<double>((i * 2654435761u) % 1000) / 100;
+  }
+  // coinciding points
+  std::copy_n(points.data(), dimensions, points.data() + dimensions);
+
+  fetch::ml::details::SpacePartitioningTree const tree(points.data(), n_points, dimensions);
+
+  for (SizeType i = 0; i < n_points; i += 7)
+  {
+    double const *point = points.data() + (i * dimensions);
+
+    std::vector<double> expected_force(dimensions, 0);
+    double              expected_sum_q = 0;
+    for (SizeType k = 0; k < n_points; ++k)
+    {
+      if (k == i)
+      {
+        continue;
+      }
+      double distance = 0;
+      for (SizeType j = 0; j < dimensions; ++j)
+      {
+        distance += (point[j] - points[(k * dimensions) + j]) *
+                    (point[j] - points[(k * dimensions) + j]);
+      }
+      double const q = 1 / (1 + distance);
+      expected_sum_q += q;
+      for (SizeType j = 0; j < dimensions; ++j)
+      {
+        expected_force[j] += q * q * (point[j] - points[(k * dimensions) + j]);
+      }
+    }
+
+    std::vector<double> exact_force(dimensions, 0);
+    std::vector<double> approximate_force(dimensions, 0);
+    double const        exact_sum_q       = tree.Repulsion(point, 0, exact_force.data());
+    double const        approximate_sum_q = tree.Repulsion(point, 0.25, approximate_force.data());
+
+    double force_norm = 0;
+    for (SizeType j = 0; j < dimensions; ++j)
+    {
+      force_norm += expected_force[j] * expected_force[j];
+    }
+    force_norm = std::sqrt(force_norm);
+
+    EXPECT_NEAR(exact_sum_q, expected_sum_q, 1e-9);
+    EXPECT_NEAR(approximate_sum_q, expected_sum_q, 5e-2 * expected_sum_q);
+    for (SizeType j = 0; j < dimensions; ++j)
+    {
+      EXPECT_NEAR(exact_force[j], expected_force[j], 1e-9);
+      EXPECT_NEAR(approximate_force[j], expected_force[j], 5e-2 * (force_norm + 1));
+    }
+  }
+}
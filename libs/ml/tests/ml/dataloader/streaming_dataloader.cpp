@@ -0,0 +1,198 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ml/dataloaders/streaming_dataloader.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using fetch::ml::dataloaders::ChunkedFileReader;
+using fetch::ml::dataloaders::StreamingDataLoader;
+
+using LoaderType = StreamingDataLoader<uint64_t, uint64_t>;
+
+class StreamingDataLoaderTest : public ::testing::Test
+{
+protected:
+  void TearDown() override
+  {
+    for (auto const &file : files_)
+    {
+      std::remove(file.c_str());
+    }
+  }
+
+  std::string WriteFile(std::string const &name, std::string const &contents)
+  {
+    std::ofstream stream(name, std::ios::binary);
+    stream << contents;
+    files_.push_back(name);
+    return name;
+  }
+
+  // writes one number per line, split across two files
+  std::vector<std::string> WriteNumbers(uint64_t count)
+  {
+    std::string first, second;
+    for (uint64_t i = 0; i < count; ++i)
+    {
+      ((i < count / 2) ? first : second) += std::to_string(i) + "\n";
+    }
+    return {WriteFile("streaming_test_1.txt", first), WriteFile("streaming_test_2.txt", second)};
+  }
+
+  static bool Parse(std::string const &record, LoaderType::SampleType &sample)
+  {
+    if (record.empty())
+    {
+      return false;
+    }
+    sample.first  = std::stoull(record);
+    sample.second = sample.first * 2;
+    return true;
+  }
+
+  static std::vector<uint64_t> Drain(LoaderType &loader)
+  {
+    std::vector<uint64_t> values;
+    while (!loader.IsDone())
+    {
+      auto sample = loader.GetNext();
+      EXPECT_EQ(sample.second, sample.first * 2);
+      values.push_back(sample.first);
+    }
+    return values;
+  }
+
+  std::vector<std::string> files_;
+};
+
+TEST_F(StreamingDataLoaderTest, reader_splits_lines_across_chunks_and_files)
+{
+  ChunkedFileReader reader({WriteFile("streaming_test_1.txt", "alpha\nbravo charlie\n\ndelta"),
+                            WriteFile("streaming_test_2.txt", "echo\n")},
+                           0, 4);
+
+  std::vector<std::string> records;
+  for (std::string record; reader.Next(record);)
+  {
+    records.push_back(record);
+  }
+  EXPECT_EQ(records, std::vector<std::string>({"alpha", "bravo charlie", "", "delta", "echo"}));
+
+  std::string record;
+  EXPECT_FALSE(reader.Next(record));
+
+  reader.Reset();
+  ASSERT_TRUE(reader.Next(record));
+  EXPECT_EQ(record, "alpha");
+}
+
+TEST_F(StreamingDataLoaderTest, reader_fixed_width_records)
+{
+  ChunkedFileReader reader({WriteFile("streaming_test_1.bin", std::string("abcdefghij\0k", 12))}, 3,
+                           5);
+
+  std::vector<std::string> records;
+  for (std::string record; reader.Next(record);)
+  {
+    records.push_back(record);
+  }
+
+  // the trailing partial record is discarded
+  EXPECT_EQ(records, std::vector<std::string>({"abc", "def", "ghi", std::string("j\0k", 3)}));
+}
+
+TEST_F(StreamingDataLoaderTest, missing_file_is_reported_to_the_consumer)
+{
+  LoaderType loader(ChunkedFileReader({"streaming_test_missing.txt"}), Parse, 4);
+  EXPECT_FALSE(loader.IsDone());
+  EXPECT_THROW(loader.GetNext(), std::runtime_error);
+  EXPECT_TRUE(loader.IsDone());
+}
+
+TEST_F(StreamingDataLoaderTest, unshuffled_batches_keep_file_order)
+{
+  LoaderType loader(ChunkedFileReader(WriteNumbers(10), 0, 8), Parse, 4);
+
+  std::vector<std::size_t> batch_sizes;
+  std::vector<uint64_t>    values;
+  for (auto batch = loader.GetNextBatch(); !batch.empty(); batch = loader.GetNextBatch())
+  {
+    batch_sizes.push_back(batch.size());
+    for (auto const &sample : batch)
+    {
+      values.push_back(sample.first);
+    }
+  }
+
+  EXPECT_EQ(batch_sizes, std::vector<std::size_t>({4, 4, 2}));
+  EXPECT_EQ(values, std::vector<uint64_t>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+  EXPECT_EQ(loader.Size(), 10);
+  EXPECT_TRUE(loader.IsDone());
+  EXPECT_THROW(loader.GetNext(), std::out_of_range);
+}
+
+TEST_F(StreamingDataLoaderTest, shuffled_epochs_cover_every_sample_once)
+{
+  uint64_t const count = 1000;
+  LoaderType     loader(ChunkedFileReader(WriteNumbers(count), 0, 64), Parse, 16, 100, 3);
+
+  std::vector<uint64_t> expected(count);
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    expected[i] = i;
+  }
+
+  auto first = Drain(loader);
+  EXPECT_EQ(loader.Size(), count);
+  EXPECT_NE(first, expected);
+
+  loader.Reset();
+  auto second = Drain(loader);
+  EXPECT_NE(second, first);
+
+  std::sort(first.begin(), first.end());
+  std::sort(second.begin(), second.end());
+  EXPECT_EQ(first, expected);
+  EXPECT_EQ(second, expected);
+}
+
+TEST_F(StreamingDataLoaderTest, reset_part_way_through_an_epoch)
+{
+  LoaderType loader(ChunkedFileReader(WriteNumbers(100), 0, 16), Parse, 5, 0, 2);
+
+  for (uint64_t i = 0; i < 7; ++i)
+  {
+    EXPECT_EQ(loader.GetNext().first, i);
+  }
+
+  // the rest of the partially consumed batch is handed out first
+  auto batch = loader.GetNextBatch();
+  ASSERT_EQ(batch.size(), 3);
+  EXPECT_EQ(batch.front().first, 7);
+
+  loader.Reset();
+  EXPECT_EQ(Drain(loader).size(), 100);
+}
@@ -46,3 +46,28 @@ TYPED_TEST(SelfAttentionTest, output_shape_test)  // Use the class as a Node
   ASSERT_EQ(prediction.shape()[0], 1);
   ASSERT_EQ(prediction.shape()[1], 42);
 }
+
+TYPED_TEST(SelfAttentionTest, node_backward_test)  // Use the class as a Node
+{
+  TypeParam data({5, 10});
+  std::shared_ptr<fetch::ml::Node<TypeParam, fetch::ml::ops::PlaceHolder<TypeParam>>> placeholder =
+      std::make_shared<fetch::ml::Node<TypeParam, fetch::ml::ops::PlaceHolder<TypeParam>>>("Input");
+  placeholder->SetData(data);
+
+  // the attention split between two heads
+  fetch::ml::Node<TypeParam, fetch::ml::layers::SelfAttention<TypeParam>> sa(
+      "SelfAttention", 50u, 42u, 10u, "SA", 2u);
+  sa.AddInput(placeholder);
+  TypeParam prediction = sa.Evaluate();
+
+  ASSERT_EQ(prediction.shape()[0], 1);
+  ASSERT_EQ(prediction.shape()[1], 42);
+
+  TypeParam error_signal(std::vector<typename TypeParam::SizeType>({1, 42}));
+  auto      backprop_error = sa.BackPropagate(error_signal);
+
+  ASSERT_EQ(backprop_error.size(), 1);
+  ASSERT_EQ(backprop_error[0].second.shape().size(), 2);
+  ASSERT_EQ(backprop_error[0].second.shape()[0], 5);
+  ASSERT_EQ(backprop_error[0].second.shape()[1], 10);
+}
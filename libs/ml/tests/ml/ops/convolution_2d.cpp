@@ -113,3 +113,106 @@ TYPED_TEST(Convolution2DTest, forward_1x5x5_1x1x3x3)
 
   ASSERT_EQ(output.shape(), std::vector<uint64_t>({1, 3, 3}));
 }
+
+template <typename TypeParam>
+void FillConvolutionTestData(TypeParam &input, TypeParam &kernels, TypeParam &error)
+{
+  using DataType = typename TypeParam::Type;
+  using SizeType = typename TypeParam::SizeType;
+
+  for (SizeType c(0); c < input.shape()[0]; ++c)
+  {
+    for (SizeType h(0); h < input.shape()[1]; ++h)
+    {
+      for (SizeType w(0); w < input.shape()[2]; ++w)
+      {
+        input.At(c, h, w) = DataType(int((c + (2 * h) + (3 * w)) % 4));
+      }
+    }
+  }
+
+  for (SizeType o(0); o < kernels.shape()[0]; ++o)
+  {
+    for (SizeType c(0); c < kernels.shape()[1]; ++c)
+    {
+      for (SizeType kh(0); kh < kernels.shape()[2]; ++kh)
+      {
+        for (SizeType kw(0); kw < kernels.shape()[3]; ++kw)
+        {
+          kernels.At(o, c, kh, kw) = DataType(int((o + c + (kh * kw)) % 3) - 1);
+        }
+      }
+    }
+  }
+
+  for (SizeType o(0); o < error.shape()[0]; ++o)
+  {
+    for (SizeType oh(0); oh < error.shape()[1]; ++oh)
+    {
+      for (SizeType ow(0); ow < error.shape()[2]; ++ow)
+      {
+        error.At(o, oh, ow) = DataType(int((o + oh + ow) % 5) - 2);
+      }
+    }
+  }
+}
+
+TYPED_TEST(Convolution2DTest, forward_backward_3x30x30_8x3x3x3)
+{
+  using DataType = typename TypeParam::Type;
+  using SizeType = typename TypeParam::SizeType;
+
+  // large enough for the products to use the blocked matrix multiplication
+  TypeParam input(std::vector<SizeType>({3, 30, 30}));
+  TypeParam kernels(std::vector<SizeType>({8, 3, 3, 3}));
+  TypeParam error(std::vector<SizeType>({8, 28, 28}));
+  FillConvolutionTestData(input, kernels, error);
+
+  // the reference convolution and its gradients
+  TypeParam expectedOutput(error.shape());
+  TypeParam expectedInputError(input.shape());
+  TypeParam expectedKernelError(kernels.shape());
+  for (SizeType o(0); o < 8; ++o)
+  {
+    for (SizeType oh(0); oh < 28; ++oh)
+    {
+      for (SizeType ow(0); ow < 28; ++ow)
+      {
+        DataType sum(0);
+        for (SizeType c(0); c < 3; ++c)
+        {
+          for (SizeType kh(0); kh < 3; ++kh)
+          {
+            for (SizeType kw(0); kw < 3; ++kw)
+            {
+              DataType const x = input.At(c, oh + kh, ow + kw);
+              DataType const w = kernels.At(o, c, kh, kw);
+              DataType const e = error.At(o, oh, ow);
+
+              sum += x * w;
+              expectedKernelError.At(o, c, kh, kw) += e * x;
+              expectedInputError.At(c, oh + kh, ow + kw) += e * w;
+            }
+          }
+        }
+        expectedOutput.At(o, oh, ow) = sum;
+      }
+    }
+  }
+
+  fetch::ml::ops::Convolution2D<TypeParam> c;
+  TypeParam                                output = c.fetch::ml::template Ops<TypeParam>::Forward(
+      std::vector<std::reference_wrapper<TypeParam const>>({input, kernels}));
+
+  ASSERT_EQ(output.shape(), expectedOutput.shape());
+  EXPECT_TRUE(output.AllClose(expectedOutput));
+
+  std::vector<TypeParam> gradients =
+      c.Backward(std::vector<std::reference_wrapper<TypeParam const>>({input, kernels}), error);
+
+  ASSERT_EQ(gradients.size(), 2);
+  ASSERT_EQ(gradients[0].shape(), input.shape());
+  ASSERT_EQ(gradients[1].shape(), kernels.shape());
+  EXPECT_TRUE(gradients[0].AllClose(expectedInputError));
+  EXPECT_TRUE(gradients[1].AllClose(expectedKernelError));
+}
@@ -129,3 +129,56 @@ TYPED_TEST(EmbeddingsTest, backward)
     }
   }
 }
+
+TYPED_TEST(EmbeddingsTest, sparse_backward)
+{
+  using DataType = typename TypeParam::Type;
+  using SizeType = typename TypeParam::SizeType;
+
+  fetch::ml::ops::Embeddings<TypeParam> e(10, 4);
+  TypeParam                             weights(std::vector<uint64_t>({10, 4}));
+  for (unsigned int i(0); i < 10; ++i)
+  {
+    for (unsigned int j(0); j < 4; ++j)
+    {
+      weights.Set(i, j, DataType(i * 10 + j));
+    }
+  }
+  e.SetData(weights);
+
+  // row 3 is looked up twice
+  TypeParam input(std::vector<uint64_t>({3}));
+  input.At(0) = DataType(3);
+  input.At(1) = DataType(5);
+  input.At(2) = DataType(3);
+  e.fetch::ml::template Ops<TypeParam>::Forward(
+      std::vector<std::reference_wrapper<TypeParam const>>({input}));
+
+  TypeParam errorSignal(std::vector<uint64_t>({3, 4}));
+  for (unsigned int j(0); j < 3; ++j)
+  {
+    for (unsigned int k{0}; k < 4; ++k)
+    {
+      errorSignal.Set(j, k, DataType(j + 1));
+    }
+  }
+  e.Backward({input}, errorSignal);
+
+  // only the touched rows are held, and repeated rows accumulate
+  ASSERT_EQ(e.GetSparseGradient().rows(), std::vector<SizeType>({3, 5}));
+  EXPECT_EQ(e.GetSparseGradient().Values(0)[0], DataType(4));
+  EXPECT_EQ(e.GetSparseGradient().Values(1)[0], DataType(2));
+
+  e.Step(DataType(1));
+  EXPECT_TRUE(e.GetSparseGradient().rows().empty());
+
+  TypeParam const &updated = e.GetWeights();
+  for (unsigned int i(0); i < 10; ++i)
+  {
+    for (unsigned int j(0); j < 4; ++j)
+    {
+      int change = (i == 3) ? 4 : ((i == 5) ? 2 : 0);
+      EXPECT_EQ(updated.At(i, j), DataType(int(i * 10 + j) - change));
+    }
+  }
+}
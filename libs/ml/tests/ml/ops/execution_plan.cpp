@@ -0,0 +1,194 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ml/execution_plan.hpp"
+#include "math/tensor.hpp"
+#include "ml/graph.hpp"
+#include "ml/ops/activations/relu.hpp"
+#include "ml/ops/activations/sigmoid.hpp"
+#include "ml/ops/add.hpp"
+#include "ml/ops/placeholder.hpp"
+#include "ml/ops/tanh.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using ArrayType = fetch::math::Tensor<float>;
+using GraphType = fetch::ml::Graph<ArrayType>;
+using PlanType  = fetch::ml::ExecutionPlan<ArrayType>;
+
+namespace {
+
+/**
+ * Input feeds three independent branches, which are summed pairwise into the output
+ */
+void BuildDiamond(GraphType &g)
+{
+  g.AddNode<fetch::ml::ops::PlaceHolder<ArrayType>>("Input", {});
+  g.AddNode<fetch::ml::ops::Relu<ArrayType>>("Relu", {"Input"});
+  g.AddNode<fetch::ml::ops::TanH<ArrayType>>("TanH", {"Input"});
+  g.AddNode<fetch::ml::ops::Sigmoid<ArrayType>>("Sigmoid", {"Input"});
+  g.AddNode<fetch::ml::ops::Add<ArrayType>>("Sum", {"Relu", "TanH"});
+  g.AddNode<fetch::ml::ops::Add<ArrayType>>("Output", {"Sum", "Sigmoid"});
+}
+
+ArrayType MakeInput(fetch::math::SizeType rows, fetch::math::SizeType columns)
+{
+  ArrayType data({rows, columns});
+  int       i = 0;
+  for (auto &value : data)
+  {
+    value = static_cast<float>(i % 17) / 4.0f - 2.0f;
+    ++i;
+  }
+  return data;
+}
+
+}  // namespace
+
+TEST(execution_plan_test, order_is_topological)
+{
+  GraphType g;
+  BuildDiamond(g);
+
+  PlanType plan(g.GetNode("Output"));
+  auto     order = plan.Order();
+
+  ASSERT_EQ(order.size(), 6);
+  EXPECT_EQ(plan.NumLevels(), 4);
+  EXPECT_EQ(order.front(), g.GetNode("Input"));
+  EXPECT_EQ(order.back(), g.GetNode("Output"));
+
+  for (std::size_t i = 0; i < order.size(); ++i)
+  {
+    for (auto const &input : order[i]->GetInputs())
+    {
+      auto position = std::find(order.begin(), order.end(), input);
+      ASSERT_NE(position, order.end());
+      EXPECT_LT(static_cast<std::size_t>(position - order.begin()), i);
+    }
+  }
+}
+
+TEST(execution_plan_test, parallel_matches_sequential)
+{
+  GraphType parallel;
+  GraphType sequential;
+  BuildDiamond(parallel);
+  BuildDiamond(sequential);
+  sequential.SetParallelEvaluation(false);
+
+  ArrayType data = MakeInput(32, 16);
+  parallel.SetInput("Input", data);
+  sequential.SetInput("Input", data);
+
+  ArrayType expected = sequential.Evaluate("Output");
+  EXPECT_TRUE(parallel.Evaluate("Output").AllClose(expected));
+
+  // and the intermediate results are still there to be read
+  EXPECT_TRUE(parallel.Evaluate("Sum").AllClose(sequential.Evaluate("Sum")));
+}
+
+TEST(execution_plan_test, inference_reuses_buffers)
+{
+  GraphType g;
+  g.AddNode<fetch::ml::ops::PlaceHolder<ArrayType>>("Input", {});
+  g.AddNode<fetch::ml::ops::Relu<ArrayType>>("Relu1", {"Input"});
+  g.AddNode<fetch::ml::ops::TanH<ArrayType>>("TanH1", {"Relu1"});
+  g.AddNode<fetch::ml::ops::Relu<ArrayType>>("Relu2", {"TanH1"});
+  g.AddNode<fetch::ml::ops::TanH<ArrayType>>("TanH2", {"Relu2"});
+
+  ArrayType data = MakeInput(16, 16);
+  g.SetInput("Input", data);
+  ArrayType expected = g.Evaluate("TanH2").Copy();
+
+  PlanType                          plan(g.GetNode("TanH2"));
+  fetch::ml::BufferPool<ArrayType> buffers;
+  for (auto const &name : {"Relu1", "TanH1", "Relu2", "TanH2"})
+  {
+    g.GetNode(name)->ResetCache(true);
+  }
+
+  EXPECT_TRUE(plan.Forward(buffers, true).AllClose(expected));
+
+  // every intermediate output is released once its consumer has run
+  EXPECT_EQ(buffers.size(), 3);
+
+  // re-evaluating reuses the released buffers instead of allocating
+  g.GetNode("TanH2")->ResetCache(true);
+  EXPECT_TRUE(plan.Forward(buffers, true).AllClose(expected));
+  EXPECT_EQ(buffers.size(), 3);
+
+  // the placeholder data is never handed out
+  EXPECT_TRUE(g.GetNode("Input")->Evaluate().AllClose(data));
+}
+
+TEST(execution_plan_test, backward_sums_error_signals)
+{
+  GraphType g;
+  g.AddNode<fetch::ml::ops::PlaceHolder<ArrayType>>("Input", {});
+  g.AddNode<fetch::ml::ops::Add<ArrayType>>("Double", {"Input", "Input"});
+
+  ArrayType data = MakeInput(4, 4);
+  g.SetInput("Input", data);
+  g.Evaluate("Double");
+
+  ArrayType error({4, 4});
+  error.Fill(1.0f);
+
+  PlanType plan(g.GetNode("Double"));
+  auto     signals = plan.Backward(error);
+
+  // both uses of the input are summed into a single signal
+  ASSERT_EQ(signals.size(), 1);
+  EXPECT_EQ(signals[0].first, g.GetNode("Input").get());
+
+  ArrayType expected({4, 4});
+  expected.Fill(2.0f);
+  EXPECT_TRUE(signals[0].second.AllClose(expected));
+
+  // the caller's error signal is left untouched
+  ArrayType ones({4, 4});
+  ones.Fill(1.0f);
+  EXPECT_TRUE(error.AllClose(ones));
+}
+
+TEST(execution_plan_test, released_outputs_are_recomputed)
+{
+  GraphType inference;
+  GraphType training;
+  for (GraphType *g : {&inference, &training})
+  {
+    g->AddNode<fetch::ml::ops::PlaceHolder<ArrayType>>("Input", {});
+    g->AddNode<fetch::ml::ops::Relu<ArrayType>>("Relu", {"Input"});
+    g->AddNode<fetch::ml::ops::TanH<ArrayType>>("TanH", {"Relu"});
+    g->SetInput("Input", MakeInput(8, 8));
+  }
+  inference.Evaluate("TanH", false);
+
+  // new data of the same size must still reallocate the released output of Relu
+  ArrayType data = MakeInput(8, 8);
+  data.Fill(0.5f);
+  inference.SetInput("Input", data);
+  training.SetInput("Input", data);
+
+  EXPECT_TRUE(inference.Evaluate("TanH", false).AllClose(training.Evaluate("TanH")));
+}
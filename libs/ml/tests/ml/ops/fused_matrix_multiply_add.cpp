@@ -0,0 +1,188 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ml/ops/fused_matrix_multiply_add.hpp"
+#include "math/tensor.hpp"
+#include "ml/execution_plan.hpp"
+#include "ml/graph.hpp"
+#include "ml/layers/fully_connected.hpp"
+#include "ml/ops/activations/relu.hpp"
+#include "ml/ops/add.hpp"
+#include "ml/ops/matrix_multiply.hpp"
+#include "ml/ops/placeholder.hpp"
+#include "ml/ops/tanh.hpp"
+
+#include <gtest/gtest.h>
+
+template <typename T>
+class FusedMatrixMultiplyAddTest : public ::testing::Test
+{
+};
+
+using MyTypes = ::testing::Types<fetch::math::Tensor<float>, fetch::math::Tensor<double>>;
+TYPED_TEST_CASE(FusedMatrixMultiplyAddTest, MyTypes);
+
+namespace {
+
+template <typename ArrayType>
+ArrayType MakeData(typename ArrayType::SizeType rows, typename ArrayType::SizeType columns,
+                   int seed)
+{
+  using DataType = typename ArrayType::Type;
+
+  ArrayType data(std::vector<typename ArrayType::SizeType>({rows, columns}));
+  int       i = seed;
+  for (auto &value : data)
+  {
+    value = static_cast<DataType>((i * 7) % 13) / DataType(4) - DataType(1.5);
+    ++i;
+  }
+  return data;
+}
+
+/**
+ * x.w + b -> relu -> tanh, with all of x, w and b fed by placeholders
+ */
+template <typename ArrayType>
+void BuildChain(fetch::ml::Graph<ArrayType> &g, bool relu)
+{
+  g.template AddNode<fetch::ml::ops::PlaceHolder<ArrayType>>("Input", {});
+  g.template AddNode<fetch::ml::ops::PlaceHolder<ArrayType>>("Weights", {});
+  g.template AddNode<fetch::ml::ops::PlaceHolder<ArrayType>>("Bias", {});
+  g.template AddNode<fetch::ml::ops::MatrixMultiply<ArrayType>>("MatMul", {"Input", "Weights"});
+  g.template AddNode<fetch::ml::ops::Add<ArrayType>>("Add", {"MatMul", "Bias"});
+  std::string last = "Add";
+  if (relu)
+  {
+    last = g.template AddNode<fetch::ml::ops::Relu<ArrayType>>("Relu", {"Add"});
+  }
+  g.template AddNode<fetch::ml::ops::TanH<ArrayType>>("Output", {last});
+
+  g.SetInput("Input", MakeData<ArrayType>(6, 4, 0));
+  g.SetInput("Weights", MakeData<ArrayType>(4, 5, 3));
+  g.SetInput("Bias", MakeData<ArrayType>(6, 5, 5));
+}
+
+template <typename ArrayType>
+void ExpectSameGradients(fetch::ml::Graph<ArrayType> &expected, fetch::ml::Graph<ArrayType> &actual)
+{
+  ArrayType error = MakeData<ArrayType>(6, 5, 1);
+
+  fetch::ml::ExecutionPlan<ArrayType> expected_plan(expected.GetNode("Output"));
+  fetch::ml::ExecutionPlan<ArrayType> actual_plan(actual.GetNode("Output"));
+  auto                                expected_signals = expected_plan.Backward(error);
+  auto                                actual_signals   = actual_plan.Backward(error);
+
+  for (auto const &name : {"Input", "Weights", "Bias"})
+  {
+    auto find = [](fetch::ml::Graph<ArrayType> &g, decltype(expected_signals) const &signals,
+                   std::string const &node) {
+      for (auto const &signal : signals)
+      {
+        if (signal.first == g.GetNode(node).get())
+        {
+          return signal.second;
+        }
+      }
+      return ArrayType{};
+    };
+    EXPECT_TRUE(find(actual, actual_signals, name)
+                    .AllClose(find(expected, expected_signals, name)))
+        << name;
+  }
+}
+
+}  // namespace
+
+TYPED_TEST(FusedMatrixMultiplyAddTest, fuse_matrix_multiply_add_relu)
+{
+  fetch::ml::Graph<TypeParam> reference;
+  fetch::ml::Graph<TypeParam> g;
+  BuildChain(reference, true);
+  BuildChain(g, true);
+
+  EXPECT_EQ(g.Fuse(), 1);
+  EXPECT_EQ(g.Fuse(), 0);
+
+  // the fused node replaces the end of the chain, the rest of the chain is gone
+  EXPECT_NO_THROW(g.GetNode("Relu"));
+  EXPECT_ANY_THROW(g.GetNode("MatMul"));
+  EXPECT_ANY_THROW(g.GetNode("Add"));
+  EXPECT_EQ(g.GetNode("Relu")->GetInputs().size(), 3);
+
+  EXPECT_TRUE(g.Evaluate("Output").AllClose(reference.Evaluate("Output")));
+  EXPECT_TRUE(g.Evaluate("Relu").AllClose(reference.Evaluate("Relu")));
+  ExpectSameGradients(reference, g);
+}
+
+TYPED_TEST(FusedMatrixMultiplyAddTest, fuse_matrix_multiply_add)
+{
+  fetch::ml::Graph<TypeParam> reference;
+  fetch::ml::Graph<TypeParam> g;
+  BuildChain(reference, false);
+  BuildChain(g, false);
+
+  EXPECT_EQ(g.Fuse(), 1);
+  EXPECT_ANY_THROW(g.GetNode("MatMul"));
+
+  EXPECT_TRUE(g.Evaluate("Output").AllClose(reference.Evaluate("Output")));
+  ExpectSameGradients(reference, g);
+
+  // new inputs still propagate through the fused node
+  reference.SetInput("Input", MakeData<TypeParam>(6, 4, 9));
+  g.SetInput("Input", MakeData<TypeParam>(6, 4, 9));
+  EXPECT_TRUE(g.Evaluate("Output").AllClose(reference.Evaluate("Output")));
+}
+
+TYPED_TEST(FusedMatrixMultiplyAddTest, shared_product_is_not_fused)
+{
+  fetch::ml::Graph<TypeParam> g;
+  BuildChain(g, true);
+
+  // the product is read twice, it has to be materialised
+  g.template AddNode<fetch::ml::ops::TanH<TypeParam>>("Other", {"MatMul"});
+  EXPECT_EQ(g.Fuse(), 0);
+  EXPECT_NO_THROW(g.GetNode("MatMul"));
+}
+
+TYPED_TEST(FusedMatrixMultiplyAddTest, fully_connected_layer)
+{
+  using SizeType = typename TypeParam::SizeType;
+
+  fetch::ml::layers::FullyConnected<TypeParam> fc(20u, 8u,
+                                                  fetch::ml::details::ActivationType::RELU);
+  TypeParam input = MakeData<TypeParam>(1, 20, 2);
+
+  TypeParam expected = fc.fetch::ml::template Ops<TypeParam>::Forward(
+      std::vector<std::reference_wrapper<TypeParam const>>({input}));
+  TypeParam error = MakeData<TypeParam>(1, 8, 4);
+  auto      expected_error =
+      fc.Backward(std::vector<std::reference_wrapper<TypeParam const>>({input}), error);
+
+  EXPECT_EQ(fc.Fuse(), 1);
+
+  TypeParam output = fc.fetch::ml::template Ops<TypeParam>::Forward(
+      std::vector<std::reference_wrapper<TypeParam const>>({input}));
+  ASSERT_EQ(output.shape(), std::vector<SizeType>({1, 8}));
+  EXPECT_TRUE(output.AllClose(expected));
+
+  auto actual_error =
+      fc.Backward(std::vector<std::reference_wrapper<TypeParam const>>({input}), error);
+  ASSERT_EQ(actual_error.size(), 1);
+  EXPECT_TRUE(actual_error[0].AllClose(expected_error[0]));
+}
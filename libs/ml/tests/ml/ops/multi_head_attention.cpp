@@ -0,0 +1,255 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ml/ops/multi_head_attention.hpp"
+#include "math/tensor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+template <typename T>
+class MultiHeadAttentionTest : public ::testing::Test
+{
+};
+
+using MyTypes = ::testing::Types<fetch::math::Tensor<float>, fetch::math::Tensor<double>>;
+TYPED_TEST_CASE(MultiHeadAttentionTest, MyTypes);
+
+namespace {
+
+using SizeType = fetch::math::SizeType;
+using Matrix   = std::vector<std::vector<double>>;
+
+template <typename ArrayType>
+ArrayType MakeData(SizeType rows, SizeType columns, int seed)
+{
+  using DataType = typename ArrayType::Type;
+
+  ArrayType data(std::vector<SizeType>({rows, columns}));
+  int       i = seed;
+  for (auto &value : data)
+  {
+    value = (static_cast<DataType>((i * 7) % 13) / DataType(8)) - DataType(0.75);
+    ++i;
+  }
+  return data;
+}
+
+template <typename ArrayType>
+Matrix ToMatrix(ArrayType const &array)
+{
+  Matrix matrix(array.shape()[0], std::vector<double>(array.shape()[1]));
+  for (SizeType i{0}; i < array.shape()[0]; ++i)
+  {
+    for (SizeType j{0}; j < array.shape()[1]; ++j)
+    {
+      matrix[i][j] = static_cast<double>(array(i, j));
+    }
+  }
+  return matrix;
+}
+
+Matrix Product(Matrix const &a, Matrix const &b)
+{
+  Matrix c(a.size(), std::vector<double>(b.front().size(), 0.0));
+  for (SizeType i{0}; i < a.size(); ++i)
+  {
+    for (SizeType k{0}; k < b.size(); ++k)
+    {
+      for (SizeType j{0}; j < b.front().size(); ++j)
+      {
+        c[i][j] += a[i][k] * b[k][j];
+      }
+    }
+  }
+  return c;
+}
+
+/// The attention computed directly, holding the full matrix of the scores of each head
+Matrix ReferenceAttention(Matrix const &input, Matrix const &weights, Matrix const &projection,
+                          SizeType num_heads)
+{
+  SizeType const rows  = input.size();
+  SizeType const width = projection.size();
+  SizeType const size  = width / num_heads;
+  double const   scale = 1.0 / std::sqrt(static_cast<double>(size));
+
+  Matrix const qkv = Product(input, weights);
+  Matrix       heads(rows, std::vector<double>(width, 0.0));
+
+  for (SizeType h{0}; h < num_heads; ++h)
+  {
+    SizeType const queries = h * size;
+    SizeType const keys    = width + (h * size);
+    SizeType const values  = (2 * width) + (h * size);
+
+    for (SizeType i{0}; i < rows; ++i)
+    {
+      std::vector<double> scores(rows, 0.0);
+      double              maximum = -1e300;
+      for (SizeType j{0}; j < rows; ++j)
+      {
+        for (SizeType c{0}; c < size; ++c)
+        {
+          scores[j] += qkv[i][queries + c] * qkv[j][keys + c];
+        }
+        scores[j] *= scale;
+        maximum = std::max(maximum, scores[j]);
+      }
+
+      double total = 0.0;
+      for (auto &score : scores)
+      {
+        score = std::exp(score - maximum);
+        total += score;
+      }
+
+      for (SizeType j{0}; j < rows; ++j)
+      {
+        for (SizeType c{0}; c < size; ++c)
+        {
+          heads[i][h * size + c] += (scores[j] / total) * qkv[j][values + c];
+        }
+      }
+    }
+  }
+
+  return Product(heads, projection);
+}
+
+template <typename DataType>
+double Tolerance()
+{
+  return std::is_same<DataType, float>::value ? 1e-4 : 1e-9;
+}
+
+/// The tolerance of the gradients, against the central differences of the reference
+template <typename DataType>
+double GradientTolerance()
+{
+  return std::is_same<DataType, float>::value ? 1e-3 : 1e-6;
+}
+
+}  // namespace
+
+TYPED_TEST(MultiHeadAttentionTest, output_shape_test)
+{
+  TypeParam input      = MakeData<TypeParam>(5, 6, 1);
+  TypeParam weights    = MakeData<TypeParam>(6, 12, 2);
+  TypeParam projection = MakeData<TypeParam>(4, 3, 3);
+
+  fetch::ml::ops::MultiHeadAttention<TypeParam> op(2);
+  std::vector<SizeType> shape = op.ComputeOutputShape({input, weights, projection});
+
+  ASSERT_EQ(shape, std::vector<SizeType>({5, 3}));
+}
+
+TYPED_TEST(MultiHeadAttentionTest, forward_matches_reference)
+{
+  using DataType = typename TypeParam::Type;
+
+  // more rows than a block, so that the online softmax spans several blocks of keys
+  for (SizeType rows : {SizeType{1}, SizeType{7}, SizeType{150}})
+  {
+    for (SizeType num_heads : {SizeType{1}, SizeType{2}, SizeType{4}})
+    {
+      TypeParam input      = MakeData<TypeParam>(rows, 6, 1);
+      TypeParam weights    = MakeData<TypeParam>(6, 24, 2);
+      TypeParam projection = MakeData<TypeParam>(8, 5, 3);
+
+      fetch::ml::ops::MultiHeadAttention<TypeParam> op(num_heads);
+
+      TypeParam output(op.ComputeOutputShape({input, weights, projection}));
+      op.Forward({input, weights, projection}, output);
+
+      Matrix const expected = ReferenceAttention(ToMatrix(input), ToMatrix(weights),
+                                                 ToMatrix(projection), num_heads);
+
+      for (SizeType i{0}; i < rows; ++i)
+      {
+        for (SizeType j{0}; j < 5; ++j)
+        {
+          EXPECT_NEAR(static_cast<double>(output(i, j)), expected[i][j], Tolerance<DataType>());
+        }
+      }
+    }
+  }
+}
+
+TYPED_TEST(MultiHeadAttentionTest, backward_matches_reference)
+{
+  using DataType = typename TypeParam::Type;
+
+  SizeType const rows      = 70;
+  SizeType const num_heads = 2;
+
+  TypeParam input      = MakeData<TypeParam>(rows, 3, 1);
+  TypeParam weights    = MakeData<TypeParam>(3, 12, 2);
+  TypeParam projection = MakeData<TypeParam>(4, 2, 3);
+  TypeParam error      = MakeData<TypeParam>(rows, 2, 4);
+
+  fetch::ml::ops::MultiHeadAttention<TypeParam> op(num_heads);
+  std::vector<TypeParam> gradients = op.Backward({input, weights, projection}, error);
+  ASSERT_EQ(gradients.size(), 3);
+
+  std::vector<Matrix> arguments = {ToMatrix(input), ToMatrix(weights), ToMatrix(projection)};
+  Matrix const        errors    = ToMatrix(error);
+
+  // the loss sum(output o error), whose gradients are those propagated for the error signal
+  auto loss = [&arguments, &errors, num_heads]() {
+    Matrix const output = ReferenceAttention(arguments[0], arguments[1], arguments[2], num_heads);
+
+    double total = 0.0;
+    for (SizeType i{0}; i < output.size(); ++i)
+    {
+      for (SizeType j{0}; j < output[i].size(); ++j)
+      {
+        total += output[i][j] * errors[i][j];
+      }
+    }
+    return total;
+  };
+
+  double const step = 1e-5;
+  for (SizeType a{0}; a < arguments.size(); ++a)
+  {
+    ASSERT_EQ(gradients[a].shape()[0], arguments[a].size());
+    ASSERT_EQ(gradients[a].shape()[1], arguments[a].front().size());
+
+    // a sample of the elements of each argument, in central differences
+    for (SizeType i{0}; i < arguments[a].size(); i += 3)
+    {
+      for (SizeType j{0}; j < arguments[a][i].size(); ++j)
+      {
+        double const original = arguments[a][i][j];
+
+        arguments[a][i][j]   = original + step;
+        double const forward = loss();
+        arguments[a][i][j]   = original - step;
+        double const backward = loss();
+        arguments[a][i][j]    = original;
+
+        double const expected = (forward - backward) / (2 * step);
+        EXPECT_NEAR(static_cast<double>(gradients[a](i, j)), expected,
+                    GradientTolerance<DataType>() * std::max(1.0, std::abs(expected)));
+      }
+    }
+  }
+}
@@ -0,0 +1,189 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ml/serializers/checkpoint.hpp"
+#include "core/fixed_point/fixed_point.hpp"
+#include "math/tensor.hpp"
+#include "ml/graph.hpp"
+#include "ml/layers/fully_connected.hpp"
+#include "ml/ops/placeholder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+template <typename T>
+class CheckpointTest : public ::testing::Test
+{
+protected:
+  void TearDown() override
+  {
+    std::remove(FILENAME);
+  }
+
+  static constexpr char const *FILENAME = "checkpoint_test.ckpt";
+};
+
+template <typename T>
+constexpr char const *CheckpointTest<T>::FILENAME;
+
+using MyTypes = ::testing::Types<fetch::math::Tensor<int>, fetch::math::Tensor<float>,
+                                 fetch::math::Tensor<double>,
+                                 fetch::math::Tensor<fetch::fixed_point::FixedPoint<16, 16>>,
+                                 fetch::math::Tensor<fetch::fixed_point::FixedPoint<32, 32>>>;
+TYPED_TEST_CASE(CheckpointTest, MyTypes);
+
+namespace {
+
+template <typename ArrayType>
+std::shared_ptr<ArrayType> MakeTensor(std::vector<typename ArrayType::SizeType> const &shape,
+                                      int                                              seed)
+{
+  using DataType = typename ArrayType::Type;
+
+  auto tensor = std::make_shared<ArrayType>(shape);
+  int  i      = seed;
+  for (auto &value : *tensor)
+  {
+    value = DataType((i * 7) % 13);
+    ++i;
+  }
+  return tensor;
+}
+
+}  // namespace
+
+TYPED_TEST(CheckpointTest, empty_state_dict)
+{
+  fetch::ml::StateDict<TypeParam> sd1;
+  fetch::ml::Checkpoint<TypeParam>::Save(sd1, this->FILENAME);
+
+  fetch::ml::StateDict<TypeParam> sd2 = fetch::ml::Checkpoint<TypeParam>::Load(this->FILENAME);
+  EXPECT_EQ(sd1, sd2);
+}
+
+TYPED_TEST(CheckpointTest, nested_state_dict)
+{
+  // tensors at every level, of sizes which are not a multiple of the vector registers, and an
+  // empty leaf
+  fetch::ml::StateDict<TypeParam> sd1;
+  sd1.weights_                           = MakeTensor<TypeParam>({3}, 1);
+  sd1.dict_["layer"].weights_            = MakeTensor<TypeParam>({5, 7}, 2);
+  sd1.dict_["layer"].dict_["bias"]       = {};
+  sd1.dict_["layer"].dict_["w"].weights_ = MakeTensor<TypeParam>({2, 3, 4}, 3);
+  sd1.dict_["other"].weights_            = MakeTensor<TypeParam>({1, 1}, 4);
+
+  fetch::ml::Checkpoint<TypeParam>::Save(sd1, this->FILENAME);
+  fetch::ml::StateDict<TypeParam> sd2 = fetch::ml::Checkpoint<TypeParam>::Load(this->FILENAME);
+
+  EXPECT_EQ(sd1, sd2);
+  ASSERT_TRUE(sd2.dict_.at("layer").dict_.at("w").weights_);
+  EXPECT_EQ(sd2.dict_.at("layer").dict_.at("w").weights_->shape(),
+            std::vector<typename TypeParam::SizeType>({2, 3, 4}));
+
+  // the tensors are backed by aligned storage
+  auto const address = reinterpret_cast<std::uintptr_t>(sd2.weights_->data().pointer());
+  EXPECT_EQ(address % fetch::ml::Checkpoint<TypeParam>::ALIGNMENT, 0);
+}
+
+TYPED_TEST(CheckpointTest, loaded_tensors_are_copy_on_write)
+{
+  fetch::ml::StateDict<TypeParam> sd1;
+  sd1.dict_["w"].weights_ = MakeTensor<TypeParam>({4, 4}, 1);
+  fetch::ml::Checkpoint<TypeParam>::Save(sd1, this->FILENAME);
+
+  fetch::ml::StateDict<TypeParam> sd2 = fetch::ml::Checkpoint<TypeParam>::Load(this->FILENAME);
+  fetch::ml::StateDict<TypeParam> sd3 = fetch::ml::Checkpoint<TypeParam>::Load(this->FILENAME);
+
+  sd2.dict_.at("w").weights_->Fill(typename TypeParam::Type(42));
+
+  // neither the file nor the other loads see the write
+  EXPECT_EQ(sd1, sd3);
+  EXPECT_EQ(sd1, fetch::ml::Checkpoint<TypeParam>::Load(this->FILENAME));
+  EXPECT_FALSE(sd1 == sd2);
+}
+
+TYPED_TEST(CheckpointTest, load_into_graph)
+{
+  using SizeType = typename TypeParam::SizeType;
+
+  fetch::ml::Graph<TypeParam> g1;
+  g1.template AddNode<fetch::ml::ops::PlaceHolder<TypeParam>>("Input", {});
+  g1.template AddNode<fetch::ml::layers::FullyConnected<TypeParam>>("FC", {"Input"}, 10u, 10u);
+
+  fetch::ml::Checkpoint<TypeParam>::Save(g1.StateDict(), this->FILENAME);
+
+  fetch::ml::Graph<TypeParam> g2;
+  g2.template AddNode<fetch::ml::ops::PlaceHolder<TypeParam>>("Input", {});
+  g2.template AddNode<fetch::ml::layers::FullyConnected<TypeParam>>("FC", {"Input"}, 10u, 10u);
+  g2.LoadStateDict(fetch::ml::Checkpoint<TypeParam>::Load(this->FILENAME));
+
+  EXPECT_EQ(g1.StateDict(), g2.StateDict());
+
+  TypeParam data = *MakeTensor<TypeParam>(std::vector<SizeType>({1, 10}), 5);
+  g1.SetInput("Input", data);
+  g2.SetInput("Input", data);
+  EXPECT_EQ(g1.Evaluate("FC"), g2.Evaluate("FC"));
+}
+
+TYPED_TEST(CheckpointTest, invalid_files_are_rejected)
+{
+  using Checkpoint = fetch::ml::Checkpoint<TypeParam>;
+
+  EXPECT_THROW(Checkpoint::Load("missing_checkpoint.ckpt"), std::runtime_error);
+
+  {
+    std::ofstream stream(this->FILENAME, std::ios::binary | std::ios::trunc);
+    stream << "this is not a checkpoint, although it is long enough to hold a header";
+  }
+  EXPECT_THROW(Checkpoint::Load(this->FILENAME), std::runtime_error);
+
+  // a checkpoint cut short in the middle of the elements of a tensor
+  fetch::ml::StateDict<TypeParam> sd;
+  sd.dict_["w"].weights_ = MakeTensor<TypeParam>({32, 32}, 1);
+  Checkpoint::Save(sd, this->FILENAME);
+
+  std::string contents;
+  {
+    std::ifstream stream(this->FILENAME, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream stream(this->FILENAME, std::ios::binary | std::ios::trunc);
+    stream.write(contents.data(), static_cast<std::streamsize>(contents.size() / 2));
+  }
+  EXPECT_THROW(Checkpoint::Load(this->FILENAME), std::runtime_error);
+}
+
+TEST(CheckpointTypeTest, element_size_mismatch_is_rejected)
+{
+  char const *filename = "checkpoint_type_test.ckpt";
+
+  fetch::ml::StateDict<fetch::math::Tensor<double>> sd;
+  sd.weights_ = std::make_shared<fetch::math::Tensor<double>>(
+      std::vector<fetch::math::SizeType>({2, 2}));
+  fetch::ml::Checkpoint<fetch::math::Tensor<double>>::Save(sd, filename);
+
+  EXPECT_THROW(fetch::ml::Checkpoint<fetch::math::Tensor<float>>::Load(filename),
+               std::runtime_error);
+  std::remove(filename);
+}
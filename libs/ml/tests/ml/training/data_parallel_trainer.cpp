@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ml/data_parallel_trainer.hpp"
+#include "math/tensor.hpp"
+#include "ml/layers/fully_connected.hpp"
+#include "ml/ops/activation.hpp"
+#include "ml/ops/embeddings.hpp"
+#include "ml/ops/loss_functions/mean_square_error.hpp"
+#include "ml/ops/placeholder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+template <typename T>
+class DataParallelTrainerTest : public ::testing::Test
+{
+};
+
+using MyTypes = ::testing::Types<fetch::math::Tensor<float>, fetch::math::Tensor<double>>;
+TYPED_TEST_CASE(DataParallelTrainerTest, MyTypes);
+
+namespace {
+
+template <typename ArrayType>
+void BuildDense(fetch::ml::Graph<ArrayType> &g)
+{
+  g.template AddNode<fetch::ml::ops::PlaceHolder<ArrayType>>("Input", {});
+  g.template AddNode<fetch::ml::layers::FullyConnected<ArrayType>>(
+      "FC1", {"Input"}, 4u, 8u, fetch::ml::details::ActivationType::RELU);
+  g.template AddNode<fetch::ml::layers::FullyConnected<ArrayType>>("FC2", {"FC1"}, 8u, 2u);
+}
+
+template <typename ArrayType>
+ArrayType Example(typename ArrayType::SizeType i, typename ArrayType::SizeType size)
+{
+  using DataType = typename ArrayType::Type;
+
+  ArrayType data(std::vector<typename ArrayType::SizeType>({1, size}));
+  for (typename ArrayType::SizeType j = 0; j < size; ++j)
+  {
+    data.At(0, j) = DataType(int((i * 5 + j * 3) % 7) - 3) / DataType(4);
+  }
+  return data;
+}
+
+/**
+ * One forward and backward pass of a mean square error regression
+ */
+template <typename ArrayType>
+typename ArrayType::Type TrainExample(fetch::ml::Graph<ArrayType> &g,
+                                      typename ArrayType::SizeType i)
+{
+  fetch::ml::ops::MeanSquareError<ArrayType> criterion;
+
+  ArrayType gt = Example<ArrayType>(i + 1, 2);
+  g.SetInput("Input", Example<ArrayType>(i, 4));
+  ArrayType prediction = g.Evaluate("FC2");
+  g.BackPropagate("FC2", criterion.Backward({prediction, gt}));
+  return criterion.Forward({prediction, gt});
+}
+
+}  // namespace
+
+TYPED_TEST(DataParallelTrainerTest, matches_single_threaded_training)
+{
+  using DataType = typename TypeParam::Type;
+  using SizeType = typename TypeParam::SizeType;
+
+  SizeType const batch_size = 23;
+
+  fetch::ml::Graph<TypeParam> serial;
+  BuildDense(serial);
+
+  fetch::ml::DataParallelTrainer<TypeParam> trainer(4, BuildDense<TypeParam>);
+  ASSERT_EQ(trainer.NumWorkers(), 4);
+
+  // the replicas share the weights of the first graph
+  EXPECT_EQ(trainer.GetReplica(3).StateDict(), trainer.GetGraph().StateDict());
+
+  for (SizeType step = 0; step < 3; ++step)
+  {
+    DataType serial_loss(0);
+    for (SizeType i = 0; i < batch_size; ++i)
+    {
+      serial_loss += TrainExample(serial, i);
+    }
+    serial.Step(DataType(0.1));
+
+    DataType loss = trainer.TrainBatch(batch_size, TrainExample<TypeParam>);
+    trainer.Step(DataType(0.1));
+
+    EXPECT_NEAR(double(loss), double(serial_loss), 1e-4);
+  }
+
+  auto expected = serial.StateDict();
+  auto actual   = trainer.GetGraph().StateDict();
+  for (auto const &layer : {"FC1", "FC2"})
+  {
+    for (auto const &weights : expected.dict_.at(layer).dict_)
+    {
+      EXPECT_TRUE(actual.dict_.at(layer).dict_.at(weights.first).weights_->AllClose(
+          *weights.second.weights_, DataType(1e-4), DataType(1e-4)))
+          << weights.first;
+    }
+  }
+
+  // and every replica sees the updated weights
+  EXPECT_EQ(trainer.GetReplica(2).StateDict(), trainer.GetGraph().StateDict());
+}
+
+TYPED_TEST(DataParallelTrainerTest, embeddings_merge_updated_rows)
+{
+  using DataType = typename TypeParam::Type;
+  using SizeType = typename TypeParam::SizeType;
+
+  auto build = [](fetch::ml::Graph<TypeParam> &g) {
+    g.template AddNode<fetch::ml::ops::PlaceHolder<TypeParam>>("Input", {});
+    g.template AddNode<fetch::ml::ops::Embeddings<TypeParam>>("Embeddings", {"Input"}, 16u, 3u);
+  };
+  auto train = [](fetch::ml::Graph<TypeParam> &g, SizeType i) {
+    fetch::ml::ops::MeanSquareError<TypeParam> criterion;
+
+    TypeParam input(std::vector<SizeType>({1, 1}));
+    input.At(0, 0) = DataType(i * 3 % 16);
+    g.SetInput("Input", input);
+
+    TypeParam gt(std::vector<SizeType>({1, 3}));
+    gt.Fill(DataType(1));
+    TypeParam prediction = g.Evaluate("Embeddings");
+    g.BackPropagate("Embeddings", criterion.Backward({prediction, gt}));
+    return criterion.Forward({prediction, gt});
+  };
+
+  fetch::ml::Graph<TypeParam> serial;
+  build(serial);
+  for (SizeType i = 0; i < 8; ++i)
+  {
+    train(serial, i);
+  }
+  serial.Step(DataType(0.5));
+
+  fetch::ml::DataParallelTrainer<TypeParam> trainer(3, build);
+  trainer.TrainBatch(8, train);
+  trainer.Step(DataType(0.5));
+
+  auto expected = serial.StateDict().dict_.at("Embeddings").weights_;
+  auto actual   = trainer.GetGraph().StateDict().dict_.at("Embeddings").weights_;
+  EXPECT_TRUE(actual->AllClose(*expected));
+}
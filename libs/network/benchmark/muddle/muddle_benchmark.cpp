@@ -0,0 +1,466 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/byte_array.hpp"
+#include "core/byte_array/const_byte_array.hpp"
+#include "core/commandline/params.hpp"
+#include "core/logger.hpp"
+#include "crypto/ecdsa.hpp"
+#include "network/management/network_manager.hpp"
+#include "network/muddle/muddle.hpp"
+#include "network/muddle/rpc/client.hpp"
+#include "network/muddle/rpc/server.hpp"
+#include "network/service/protocol.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * End to end benchmark of the muddle network stack. A set of nodes is created in-process and
+ * connected as a full mesh over the loopback interface. For each configuration (with and without
+ * packet signing) the message rate and the p50 / p99 delivery latency is reported for direct
+ * sends, broadcasts and RPC calls.
+ */
+
+namespace {
+
+using fetch::byte_array::ByteArray;
+using fetch::byte_array::ConstByteArray;
+using fetch::muddle::Muddle;
+using fetch::muddle::MuddleEndpoint;
+using fetch::muddle::NetworkId;
+using fetch::network::NetworkManager;
+
+using Clock       = std::chrono::steady_clock;
+using Timepoint   = Clock::time_point;
+using Address     = Muddle::Address;
+using Payload     = fetch::muddle::Packet::Payload;
+using Uri         = Muddle::Uri;
+using MuddlePtr   = std::unique_ptr<Muddle>;
+using ManagerPtr  = std::unique_ptr<NetworkManager>;
+using Latencies   = std::vector<uint64_t>;
+using RpcServer   = fetch::muddle::rpc::Server;
+using RpcClient   = fetch::muddle::rpc::Client;
+using Microsecond = std::chrono::microseconds;
+
+constexpr uint16_t    SERVICE_BENCHMARK   = 10;
+constexpr uint16_t    CHANNEL_DIRECT      = 1;
+constexpr uint16_t    CHANNEL_BROADCAST   = 2;
+constexpr uint16_t    CHANNEL_RPC         = 3;
+constexpr uint64_t    RPC_BENCHMARK       = 1;
+constexpr std::size_t RPC_WINDOW          = 32;
+constexpr std::size_t NUM_NETWORK_THREADS = 2;
+
+struct Config
+{
+  std::size_t num_nodes{4};
+  std::size_t num_messages{2000};
+  std::size_t payload_size{256};
+  uint16_t    port{8400};
+  uint32_t    timeout_s{30};
+};
+
+struct Result
+{
+  std::size_t delivered{0};
+  double      seconds{0};
+  Latencies   latencies{};
+};
+
+/**
+ * Encode the current time at the start of the payload so that the receiver can determine the
+ * delivery latency (all the nodes share the same clock)
+ */
+ConstByteArray MakePayload(std::size_t size)
+{
+  ByteArray buffer;
+  buffer.Resize(std::max(size, sizeof(uint64_t)));
+
+  auto const now = static_cast<uint64_t>(Clock::now().time_since_epoch().count());
+  std::memcpy(buffer.pointer(), &now, sizeof(now));
+
+  return {buffer};
+}
+
+uint64_t LatencyOf(Payload const &payload)
+{
+  uint64_t sent{0};
+  std::memcpy(&sent, payload.pointer(), sizeof(sent));
+
+  auto const now = static_cast<uint64_t>(Clock::now().time_since_epoch().count());
+  return std::chrono::duration_cast<Microsecond>(Clock::duration{now - sent}).count();
+}
+
+/**
+ * Wait for a condition to be satisfied, or the timeout to expire
+ */
+template <typename Predicate>
+bool WaitFor(Predicate &&predicate, uint32_t timeout_s)
+{
+  auto const deadline = Clock::now() + std::chrono::seconds{timeout_s};
+
+  while (!predicate())
+  {
+    if (Clock::now() >= deadline)
+    {
+      return false;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+
+  return true;
+}
+
+class EchoProtocol : public fetch::service::Protocol
+{
+public:
+  enum
+  {
+    RESPOND = 1
+  };
+
+  EchoProtocol()
+  {
+    Expose(RESPOND, this, &EchoProtocol::Respond);
+  }
+
+private:
+  ConstByteArray Respond(ConstByteArray const &payload)
+  {
+    return payload;
+  }
+};
+
+/**
+ * The set of in-process nodes making up the network
+ */
+class Network
+{
+public:
+  Network(Config const &cfg, bool sign)
+    : cfg_{cfg}
+  {
+    for (std::size_t i = 0; i < cfg_.num_nodes; ++i)
+    {
+      auto certificate = std::make_unique<fetch::crypto::ECDSASigner>();
+      certificate->GenerateKeys();
+
+      managers_.emplace_back(
+          std::make_unique<NetworkManager>("Bench" + std::to_string(i), NUM_NETWORK_THREADS));
+      managers_.back()->Start();
+
+      nodes_.emplace_back(std::make_unique<Muddle>(NetworkId{"Bench"}, std::move(certificate),
+                                                   *managers_.back(), sign, sign));
+    }
+
+    // connect the nodes as a full mesh, each node connecting to all the previous ones
+    for (std::size_t i = 0; i < nodes_.size(); ++i)
+    {
+      Muddle::UriList peers;
+      for (std::size_t j = 0; j < i; ++j)
+      {
+        peers.emplace_back(Uri{"tcp://127.0.0.1:" + std::to_string(Port(j))});
+      }
+
+      nodes_[i]->Start({Port(i)}, peers);
+    }
+  }
+
+  ~Network()
+  {
+    for (auto &node : nodes_)
+    {
+      node->Stop();
+    }
+
+    for (auto &manager : managers_)
+    {
+      manager->Stop();
+    }
+
+    nodes_.clear();
+    managers_.clear();
+  }
+
+  bool WaitUntilConnected() const
+  {
+    return WaitFor(
+        [this]() {
+          for (auto const &node : nodes_)
+          {
+            if (node->GetConnections(true).size() + 1 < nodes_.size())
+            {
+              return false;
+            }
+          }
+          return true;
+        },
+        cfg_.timeout_s);
+  }
+
+  Muddle &node(std::size_t index)
+  {
+    return *nodes_[index];
+  }
+
+  std::size_t size() const
+  {
+    return nodes_.size();
+  }
+
+private:
+  uint16_t Port(std::size_t index) const
+  {
+    return static_cast<uint16_t>(cfg_.port + index);
+  }
+
+  Config const            cfg_;
+  std::vector<ManagerPtr> managers_;
+  std::vector<MuddlePtr>  nodes_;
+};
+
+/**
+ * Collects the latencies reported by the subscription handlers
+ */
+class Collector
+{
+public:
+  void Record(uint64_t latency_us)
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    latencies_.push_back(latency_us);
+    last_ = Clock::now();
+  }
+
+  std::size_t count() const
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    return latencies_.size();
+  }
+
+  Result Finish(Timepoint const &start) const
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+
+    Result result;
+    result.delivered = latencies_.size();
+    result.latencies = latencies_;
+    result.seconds   = std::chrono::duration<double>(last_ - start).count();
+
+    return result;
+  }
+
+private:
+  mutable std::mutex lock_;
+  Latencies          latencies_;
+  Timepoint          last_{Clock::now()};
+};
+
+Result RunDirect(Network &network, Config const &cfg)
+{
+  auto &sender   = network.node(0).AsEndpoint();
+  auto &receiver = network.node(network.size() - 1);
+
+  Collector collector;
+
+  auto subscription = receiver.AsEndpoint().Subscribe(SERVICE_BENCHMARK, CHANNEL_DIRECT);
+  subscription->SetMessageHandler([&collector](Address const &, uint16_t, uint16_t, uint16_t,
+                                               Payload const &payload, Address const &) {
+    collector.Record(LatencyOf(payload));
+  });
+
+  Address const target = receiver.identity().identifier();
+  auto const    start  = Clock::now();
+
+  for (std::size_t i = 0; i < cfg.num_messages; ++i)
+  {
+    sender.Send(target, SERVICE_BENCHMARK, CHANNEL_DIRECT, MakePayload(cfg.payload_size));
+  }
+
+  WaitFor([&]() { return collector.count() >= cfg.num_messages; }, cfg.timeout_s);
+
+  auto result = collector.Finish(start);
+  subscription->SetMessageHandler(nullptr);
+
+  return result;
+}
+
+Result RunBroadcast(Network &network, Config const &cfg)
+{
+  auto &sender = network.node(0).AsEndpoint();
+
+  Collector collector;
+
+  std::vector<std::shared_ptr<fetch::muddle::Subscription>> subscriptions;
+  for (std::size_t i = 1; i < network.size(); ++i)
+  {
+    subscriptions.push_back(
+        network.node(i).AsEndpoint().Subscribe(SERVICE_BENCHMARK, CHANNEL_BROADCAST));
+    subscriptions.back()->SetMessageHandler([&collector](Address const &, uint16_t, uint16_t,
+                                                         uint16_t, Payload const &payload,
+                                                         Address const &) {
+      collector.Record(LatencyOf(payload));
+    });
+  }
+
+  std::size_t const expected = cfg.num_messages * (network.size() - 1);
+  auto const        start    = Clock::now();
+
+  for (std::size_t i = 0; i < cfg.num_messages; ++i)
+  {
+    sender.Broadcast(SERVICE_BENCHMARK, CHANNEL_BROADCAST, MakePayload(cfg.payload_size));
+  }
+
+  WaitFor([&]() { return collector.count() >= expected; }, cfg.timeout_s);
+
+  auto result = collector.Finish(start);
+  for (auto &subscription : subscriptions)
+  {
+    subscription->SetMessageHandler(nullptr);
+  }
+
+  return result;
+}
+
+Result RunRpc(Network &network, Config const &cfg)
+{
+  auto &server_node = network.node(network.size() - 1);
+
+  EchoProtocol protocol;
+  RpcServer    server{server_node.AsEndpoint(), SERVICE_BENCHMARK, CHANNEL_RPC};
+  server.Add(RPC_BENCHMARK, &protocol);
+
+  RpcClient client{"Bench", network.node(0).AsEndpoint(), Address{}, SERVICE_BENCHMARK,
+                   CHANNEL_RPC};
+
+  Address const target = server_node.identity().identifier();
+  Collector     collector;
+  auto const    start = Clock::now();
+
+  // keep a bounded number of calls in flight
+  for (std::size_t sent = 0; sent < cfg.num_messages;)
+  {
+    std::vector<std::pair<fetch::service::Promise, Timepoint>> window;
+
+    for (std::size_t i = 0; (i < RPC_WINDOW) && (sent < cfg.num_messages); ++i, ++sent)
+    {
+      auto promise = client.CallSpecificAddress(target, RPC_BENCHMARK, EchoProtocol::RESPOND,
+                                                MakePayload(cfg.payload_size));
+      window.emplace_back(std::move(promise), Clock::now());
+    }
+
+    for (auto &call : window)
+    {
+      if (call.first->Wait(cfg.timeout_s * 1000u, false))
+      {
+        collector.Record(static_cast<uint64_t>(
+            std::chrono::duration_cast<Microsecond>(Clock::now() - call.second).count()));
+      }
+    }
+  }
+
+  return collector.Finish(start);
+}
+
+uint64_t Percentile(Latencies const &sorted, double percentile)
+{
+  if (sorted.empty())
+  {
+    return 0;
+  }
+
+  auto const index = static_cast<std::size_t>(percentile * static_cast<double>(sorted.size() - 1));
+  return sorted[index];
+}
+
+void Report(char const *name, bool sign, std::size_t expected, Result result)
+{
+  std::sort(result.latencies.begin(), result.latencies.end());
+
+  double const rate =
+      (result.seconds > 0) ? static_cast<double>(result.delivered) / result.seconds : 0.0;
+
+  std::cout << std::left << std::setw(10) << name << std::setw(8) << (sign ? "signed" : "plain")
+            << std::right << std::setw(8) << result.delivered << '/' << std::left << std::setw(8)
+            << expected << std::right << std::fixed << std::setprecision(1) << std::setw(12)
+            << rate << " msg/s" << std::setw(10) << Percentile(result.latencies, 0.50) << "us p50"
+            << std::setw(10) << Percentile(result.latencies, 0.99) << "us p99" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char **argv)
+{
+  Config                     cfg;
+  bool                       verbose{false};
+  fetch::commandline::Params params;
+
+  params.description("End to end benchmark of the muddle network stack");
+  params.add(cfg.num_nodes, "nodes", "The number of nodes in the network", std::size_t{4});
+  params.add(cfg.num_messages, "messages", "The number of messages per test", std::size_t{2000});
+  params.add(cfg.payload_size, "payload", "The size of each message payload", std::size_t{256});
+  params.add(cfg.port, "port", "The first port used by the nodes", uint16_t{8400});
+  params.add(cfg.timeout_s, "timeout", "The timeout for each test in seconds", uint32_t{30});
+  params.add(verbose, "verbose", "Keep the network logging enabled", false);
+  params.Parse(argc, argv);
+
+  if (!verbose)
+  {
+    fetch::logger.DisableLogger();
+  }
+
+  if (cfg.num_nodes < 2)
+  {
+    std::cerr << "At least 2 nodes are required" << std::endl;
+    return 1;
+  }
+
+  std::cout << "nodes: " << cfg.num_nodes << " messages: " << cfg.num_messages
+            << " payload: " << cfg.payload_size << " bytes" << std::endl;
+
+  for (bool const sign : {false, true})
+  {
+    // each network uses its own range of ports
+    Config run_cfg = cfg;
+    run_cfg.port   = static_cast<uint16_t>(cfg.port + (sign ? cfg.num_nodes : 0));
+
+    Network network{run_cfg, sign};
+    if (!network.WaitUntilConnected())
+    {
+      std::cerr << "Unable to connect the network" << std::endl;
+      return 1;
+    }
+
+    Report("direct", sign, cfg.num_messages, RunDirect(network, cfg));
+    Report("broadcast", sign, cfg.num_messages * (cfg.num_nodes - 1), RunBroadcast(network, cfg));
+    Report("rpc", sign, cfg.num_messages, RunRpc(network, cfg));
+  }
+
+  return 0;
+}
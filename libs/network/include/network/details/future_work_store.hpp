@@ -19,19 +19,29 @@
 
 #include "core/mutex.hpp"
 
-#include <algorithm>
-#include <iostream>
-#include <queue>
-#include <string>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
 
 namespace fetch {
 namespace network {
 namespace details {
 
 /**
- * The future work store is a simple priority queue of work items. These work items are
- * stored alongside a due timestamp. The priority / order of the queue is determined by
- * these timestamps
+ * The future work store holds work items until their due time has been reached.
+ *
+ * Internally it is a hierarchical timer wheel with a resolution of one millisecond. Each of the
+ * levels is a ring of slots covering 64 times the range of the level below it, and an item is
+ * placed in the lowest level whose range contains its due time. As time advances the slots of the
+ * upper levels are cascaded down into the lower ones, until the items become due in level 0.
+ *
+ * The slots are intrusive linked lists of nodes kept in a single pool, so that posting and
+ * cancelling a work item are both O(1) operations. Cancellation is done through the handle
+ * returned when posting, which remains safe to use after the work item has been dispatched.
  */
 class FutureWorkStore
 {
@@ -39,39 +49,24 @@ public:
   static constexpr char const *LOGGING_NAME = "FutureWorkStore";
 
   using WorkItem = std::function<void()>;
+  using Handle   = uint64_t;
+
+  static constexpr Handle INVALID_HANDLE = 0;
 
   // Construction / Destruction
-  FutureWorkStore()                           = default;
+  FutureWorkStore();
   FutureWorkStore(const FutureWorkStore &rhs) = delete;
   FutureWorkStore(FutureWorkStore &&rhs)      = delete;
-  ~FutureWorkStore()
-  {
-    shutdown_ = true;
-    Clear();  // remove any pending things
-  }
+  ~FutureWorkStore();
 
-  /**
-   * Signal that the work queue should no longer accept and work items
-   */
-  void Abort()
-  {
-    shutdown_ = true;
-  }
+  void Abort();
+  void Clear();
 
-  /**
-   * Empty the queue of work items
-   */
-  void Clear()
-  {
-    FETCH_LOCK(queue_mutex_);
-    while (!queue_.empty())
-    {
-      queue_.pop();
-    }
-  }
+  Handle Post(WorkItem item, uint32_t milliseconds);
+  bool   Cancel(Handle handle);
 
   /**
-   * Extract and dispatch a single item from the queue
+   * Extract and dispatch all the items from the store which have become due
    *
    * @tparam CALLBACK The type of the callable accepting the signature: void(WorkItem const &)
    * @param visitor The dispatching function
@@ -80,128 +75,93 @@ public:
   template <typename CALLBACK>
   std::size_t Dispatch(CALLBACK const &visitor)
   {
-    std::size_t num_processed = 0;
-
-    Timestamp const now = Clock::now();
+    std::vector<WorkItem> items;
 
     // allow early exit
-    std::unique_lock<Mutex> lock(queue_mutex_, std::try_to_lock);
-    if (lock.owns_lock())
     {
-      WorkItem item;
-
-      // empty loop condition
-      if (!queue_.empty())
+      std::unique_lock<Mutex> lock(mutex_, std::try_to_lock);
+      if (!lock.owns_lock())
       {
-        Element const &next = queue_.top();
-        if (next.due <= now)
-        {
-          item = next.item;
-          queue_.pop();
-        }
+        return 0;
       }
 
-      // release the queue
-      lock.unlock();
-
-      // dispatch all the work items
-      if (item)
-      {
-        // dispatch the work item
-        visitor(item);
-
-        // increment the counter
-        ++num_processed;
-      }
+      Advance(CurrentTick());
+      ExtractReady(items);
     }
 
-    return num_processed;
-  }
-
-  /**
-   * Add a work item with a specified delay in milliseconds
-   *
-   * @param item The work item to be added to the queue
-   * @param milliseconds The delay in milliseconds before this work item is scheduled
-   */
-  void Post(WorkItem item, uint32_t milliseconds)
-  {
-    // reject further work if we are in the process of shutting down
-    if (shutdown_)
+    // dispatch all the work items outside of the lock
+    for (auto const &item : items)
     {
-      return;
+      visitor(item);
     }
 
-    // add it to the queue
-    {
-      FETCH_LOCK(queue_mutex_);
-      queue_.emplace(std::move(item), milliseconds);
-    }
+    return items.size();
   }
 
-  /**
-   * Determine the time until the next available item in the queue
-   *
-   * @return milliseconds::max() if the work queue is empty, milliseconds::zero()
-   * if the time is already due for execution, otherwise the time in milliseconds remaining
-   */
-  std::chrono::milliseconds TimeUntilNextItem()
-  {
-    using std::chrono::duration_cast;
-    using std::chrono::milliseconds;
-
-    Timestamp const now = Clock::now();
-
-    {
-      FETCH_LOCK(queue_mutex_);
-      if (!queue_.empty())
-      {
-        Element const &element = queue_.top();
-
-        if (element.due > now)
-        {
-          return duration_cast<milliseconds>(element.due - now);
-        }
-        else
-        {
-          return milliseconds::zero();
-        }
-      }
-    }
-
-    return milliseconds::max();
-  }
+  std::chrono::milliseconds TimeUntilNextItem();
+  std::size_t               size() const;
 
   // Operators
   FutureWorkStore operator=(const FutureWorkStore &rhs) = delete;
   FutureWorkStore operator=(FutureWorkStore &&rhs) = delete;
 
 private:
-  using Clock     = std::chrono::system_clock;
+  using Clock     = std::chrono::steady_clock;
   using Timestamp = Clock::time_point;
+  using Tick      = uint64_t;
+  using Index     = uint32_t;
+  using Mutex     = fetch::mutex::Mutex;
+  using Flag      = std::atomic<bool>;
 
-  struct Element
-  {
-    WorkItem  item;
-    Timestamp due;
+  static constexpr std::size_t SLOT_BITS  = 6;
+  static constexpr std::size_t NUM_SLOTS  = 1u << SLOT_BITS;
+  static constexpr std::size_t NUM_LEVELS = 11;  // enough levels to cover the full 64 bit tick
+  static constexpr Tick        SLOT_MASK  = NUM_SLOTS - 1u;
 
-    Element(WorkItem i, uint32_t delay_ms)
-      : item(std::move(i))
-      , due{Clock::now() + std::chrono::milliseconds(delay_ms)}
-    {}
+  /// The list of items which are already due, stored after all the wheel slots
+  static constexpr std::size_t READY_LIST = NUM_LEVELS * NUM_SLOTS;
+  static constexpr Index       NIL        = std::numeric_limits<Index>::max();
 
-    bool operator<(Element const &other) const
-    {
-      return due < other.due;
-    }
+  struct Node
+  {
+    WorkItem    item;
+    Tick        due{0};
+    Index       prev{NIL};
+    Index       next{NIL};
+    uint32_t    generation{0};
+    std::size_t list{READY_LIST};
+    bool        in_use{false};
   };
 
-  using Queue = std::priority_queue<Element>;
-  using Mutex = fetch::mutex::Mutex;
-  using Flag  = std::atomic<bool>;
-
-  mutable Mutex queue_mutex_{__LINE__, __FILE__};  ///< Mutex protecting `queue_`
-  Queue         queue_;                            ///< Ordered queue of work items
+  using Nodes    = std::vector<Node>;
+  using Heads    = std::array<Index, READY_LIST + 1>;
+  using Bitmaps  = std::array<uint64_t, NUM_LEVELS>;
+  using ItemList = std::vector<WorkItem>;
+
+  Tick CurrentTick() const;
+  Tick NextEventTick() const;
+  void Advance(Tick now);
+  void Cascade(std::size_t level, std::size_t slot);
+
+  /// @name Node Management
+  /// @{
+  Index AllocateNode();
+  void  ReleaseNode(Index index);
+  void  Insert(Index index);
+  void  Link(Index index, std::size_t list);
+  void  Unlink(Index index);
+  void  ExtractReady(ItemList &items);
+  /// @}
+
+  Timestamp const origin_{Clock::now()};  ///< The reference point for the ticks
+
+  mutable Mutex mutex_{__LINE__, __FILE__};  ///< Mutex protecting all the members below
+  Tick          current_{0};                 ///< The last tick processed by the wheel
+  Nodes         nodes_;                      ///< The node pool
+  Index         free_{NIL};                  ///< The head of the list of free nodes
+  Heads         heads_;                      ///< The heads of the slot lists
+  Bitmaps       occupied_{};                 ///< The non-empty slots of each level
+  std::size_t   size_{0};                    ///< The number of pending items
 
   // Shutdown flag this is designed to only ever be set to true. User will have to recreate the
   // whole thread pool with current implementation.
@@ -25,6 +25,7 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <vector>
 
 namespace fetch {
 namespace network {
@@ -37,14 +38,31 @@ class NetworkManagerImplementation
   using Lock  = std::unique_lock<Mutex>;
 
 public:
+  /**
+   * The threading model of the network manager
+   *
+   * SHARED:   all the threads service a single io context, any thread can run any handler
+   * PER_CORE: each thread services its own io context and is pinned to a core. IO objects are
+   *           created on the context of the calling thread, so that a connection, its strand and
+   *           its socket stay on one core and only explicit hand-offs cross between cores
+   */
+  enum class Mode
+  {
+    SHARED,
+    PER_CORE
+  };
+
   static constexpr char const *LOGGING_NAME = "NetworkManagerImpl";
 
-  NetworkManagerImplementation(std::string name, std::size_t threads)
+  NetworkManagerImplementation(std::string name, std::size_t threads, Mode mode = Mode::SHARED)
     : name_(std::move(name))
     , number_of_threads_(threads)
+    , mode_{mode}
     , running_{false}
   {
     FETCH_LOG_DEBUG(LOGGING_NAME, "Creating network manager");
+
+    CreateContexts();
   }
 
   ~NetworkManagerImplementation()
@@ -57,36 +75,69 @@ public:
   NetworkManagerImplementation(NetworkManagerImplementation &&)      = default;
 
   void Start();
-  void Work();
+  void Work(std::size_t core);
   void Stop();
   bool Running();
 
+  Mode mode() const
+  {
+    return mode_;
+  }
+
+  std::size_t NextCore();
+
   // Must only be called within a post, then the io_service_ is always
   // guaranteed to be valid
   template <typename IO, typename... arguments>
   std::shared_ptr<IO> CreateIO(arguments &&... args)
   {
-    return std::make_shared<IO>(*io_service_, std::forward<arguments>(args)...);
+    return CreateIOOnCore<IO>(LocalOrNextCore(), std::forward<arguments>(args)...);
+  }
+
+  template <typename IO, typename... arguments>
+  std::shared_ptr<IO> CreateIOOnCore(std::size_t core, arguments &&... args)
+  {
+    return std::make_shared<IO>(*io_services_[core % io_services_.size()],
+                                std::forward<arguments>(args)...);
   }
 
   template <typename F>
   void Post(F &&f)
   {
-    io_service_->post(std::forward<F>(f));
+    PostOnCore(LocalOrNextCore(), std::forward<F>(f));
+  }
+
+  template <typename F>
+  void PostOnCore(std::size_t core, F &&f)
+  {
+    io_services_[core % io_services_.size()]->post(std::forward<F>(f));
   }
 
 private:
+  using IoServicePtr = std::unique_ptr<asio::io_service>;
+  using WorkPtr      = std::shared_ptr<asio::io_service::work>;
+
+  void        CreateContexts();
+  std::size_t LocalOrNextCore();
+
   std::string const                         name_;
   std::thread::id                           owning_thread_;
   std::size_t                               number_of_threads_ = 1;
+  Mode const                                mode_;
   std::vector<std::shared_ptr<std::thread>> threads_;
   std::atomic<bool>                         running_;
+  std::atomic<std::size_t>                  next_core_{0};
 
-  std::unique_ptr<asio::io_service> io_service_ = std::make_unique<asio::io_service>();
-
-  std::shared_ptr<asio::io_service::work> shared_work_;
+  std::vector<IoServicePtr> io_services_;
+  std::vector<WorkPtr>      shared_work_;
 
   mutable Mutex thread_mutex_{__LINE__, __FILE__};
+
+  /// The manager and core serviced by the calling thread, if it is a network thread
+  /// @{
+  static thread_local NetworkManagerImplementation const *current_manager_;
+  static thread_local std::size_t                         current_core_;
+  /// @}
 };
 
 }  // namespace details
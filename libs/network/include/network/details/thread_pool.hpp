@@ -47,9 +47,10 @@ namespace details {
  * The main work queue is a FIFO based model and these jobs are extracted by the dispatch
  * threads.
  *
- * The other work queue is the future work queue. These jobs are ordered by due time and
+ * The other work queue is the future work queue. These jobs are kept in a timer wheel and
  * once the due time has been reached they are placed at the end of the work queue. Users
- * should note that the due timestamp can be thought of as the mimimum schedule time.
+ * should note that the due timestamp can be thought of as the mimimum schedule time. Future
+ * work can be cancelled, with the handle returned when it was posted, up until that point.
  *
  * The third queue is an "idle" work store. This is probably better thought of as a
  * periodic or reoccuring work. Work from this store is executed directly. The design of
@@ -81,6 +82,7 @@ public:
 
   using ThreadPoolPtr = std::shared_ptr<ThreadPoolImplementation>;
   using WorkItem      = std::function<void()>;
+  using WorkHandle    = FutureWorkStore::Handle;
 
   static ThreadPoolPtr Create(std::size_t threads, std::string const &name);
 
@@ -91,8 +93,9 @@ public:
 
   /// @name Current / Future Work
   /// @{
-  void Post(WorkItem work, uint32_t milliseconds);
-  void Post(WorkItem work);
+  WorkHandle Post(WorkItem work, uint32_t milliseconds);
+  void       Post(WorkItem work);
+  bool       Cancel(WorkHandle handle);
   /// @}
 
   /// @name Idle / Background tasks
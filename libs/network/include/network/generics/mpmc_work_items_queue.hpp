@@ -0,0 +1,321 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/containers/lock_free_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fetch {
+namespace generics {
+
+/**
+ * Multi producer, multi consumer variant of the WorkItemsQueue
+ *
+ * Items are exchanged through a lock free ring, so neither adding nor taking items requires a
+ * lock while the ring has space. Should the ring fill up, further items are parked in an overflow
+ * list (under a lock) until the consumers have caught up, so that adding never blocks.
+ *
+ * Waiting consumers first spin for a configurable number of iterations before going to sleep on a
+ * condition variable. Producers only touch the condition variable when there are sleepers.
+ *
+ * @tparam TYPE The type of the work items
+ * @tparam SIZE The size of the lock free ring
+ */
+template <class TYPE, std::size_t SIZE = (1u << 12u)>
+class MPMCWorkItemsQueue
+{
+  using Ring      = core::LockFreeMPMCQueue<TYPE, SIZE>;
+  using Overflow  = std::deque<TYPE>;
+  using Mutex     = std::mutex;
+  using Lock      = std::unique_lock<Mutex>;
+  using Condition = std::condition_variable;
+  using Items     = std::vector<TYPE>;
+  using Counter   = std::atomic<std::size_t>;
+  using Flag      = std::atomic<bool>;
+
+public:
+  static constexpr std::size_t DEFAULT_SPIN_COUNT = 1000;
+
+  explicit MPMCWorkItemsQueue(std::size_t spin_count = DEFAULT_SPIN_COUNT)
+    : spin_count_{spin_count}
+  {}
+
+  MPMCWorkItemsQueue(MPMCWorkItemsQueue const &rhs) = delete;
+  MPMCWorkItemsQueue(MPMCWorkItemsQueue &&rhs)      = delete;
+  ~MPMCWorkItemsQueue()                             = default;
+
+  /// @name Producers
+  /// @{
+  void Add(TYPE const &item)
+  {
+    Push(item);
+    Notify(false);
+  }
+
+  template <class ITERATOR_GIVING_TYPE>
+  void Add(ITERATOR_GIVING_TYPE iter, ITERATOR_GIVING_TYPE end)
+  {
+    for (; iter != end; ++iter)
+    {
+      Push(*iter);
+    }
+    Notify(true);
+  }
+  /// @}
+
+  /// @name Consumers
+  /// @{
+  bool Wait();
+
+  template <typename R, typename P>
+  bool Wait(std::chrono::duration<R, P> const &timeout);
+
+  std::size_t Get(Items &output, std::size_t limit);
+
+  template <typename R, typename P>
+  std::size_t GetBatch(Items &output, std::size_t limit,
+                       std::chrono::duration<R, P> const &timeout);
+  /// @}
+
+  bool empty() const
+  {
+    return count_.load() == 0;
+  }
+
+  std::size_t size() const
+  {
+    return count_.load();
+  }
+
+  bool Remaining() const
+  {
+    return !empty();
+  }
+
+  void Quit()
+  {
+    quit_.store(true);
+
+    Lock lock(mutex_);
+    cv_.notify_all();
+  }
+
+  // Operators
+  MPMCWorkItemsQueue &operator=(MPMCWorkItemsQueue const &rhs) = delete;
+  MPMCWorkItemsQueue &operator=(MPMCWorkItemsQueue &&rhs) = delete;
+
+private:
+  void Push(TYPE const &item);
+  bool Pop(TYPE &item);
+  bool Spin();
+  void Notify(bool all);
+
+  std::size_t const spin_count_;
+
+  Ring      ring_;           ///< The lock free ring
+  Counter   count_{0};       ///< The total number of queued items
+  Counter   overflowed_{0};  ///< The number of items in the overflow list
+  Counter   sleepers_{0};    ///< The number of sleeping consumers
+  Flag      quit_{false};    ///< Signal to the consumers that they should exit
+  Mutex     mutex_;          ///< Protects the overflow list and the condition
+  Overflow  overflow_;       ///< Items which did not fit into the ring
+  Condition cv_;             ///< Wakes sleeping consumers
+};
+
+template <class T, std::size_t N>
+constexpr std::size_t MPMCWorkItemsQueue<T, N>::DEFAULT_SPIN_COUNT;
+
+/**
+ * Wait (without timeout) until there are items in the queue
+ *
+ * @return false if the queue has been quit, otherwise true
+ */
+template <class T, std::size_t N>
+bool MPMCWorkItemsQueue<T, N>::Wait()
+{
+  if (Spin())
+  {
+    return true;
+  }
+
+  Lock lock(mutex_);
+  ++sleepers_;
+  cv_.wait(lock, [this]() { return !empty() || quit_.load(); });
+  --sleepers_;
+
+  return !quit_.load();
+}
+
+/**
+ * Wait, for at most the specified timeout, until there are items in the queue
+ *
+ * @param timeout The maximum time to wait
+ * @return true if there are items available, otherwise false
+ */
+template <class T, std::size_t N>
+template <typename R, typename P>
+bool MPMCWorkItemsQueue<T, N>::Wait(std::chrono::duration<R, P> const &timeout)
+{
+  if (Spin())
+  {
+    return true;
+  }
+
+  Lock lock(mutex_);
+  ++sleepers_;
+  bool const available =
+      cv_.wait_for(lock, timeout, [this]() { return !empty() || quit_.load(); });
+  --sleepers_;
+
+  return available && !quit_.load();
+}
+
+/**
+ * Take up to `limit` items from the queue without waiting
+ *
+ * @param output The vector to which the items are appended
+ * @param limit The maximum number of items to take
+ * @return The number of items in the output
+ */
+template <class T, std::size_t N>
+std::size_t MPMCWorkItemsQueue<T, N>::Get(Items &output, std::size_t limit)
+{
+  output.reserve(output.size() + std::min(limit, size()));
+
+  T item;
+  for (std::size_t i = 0; (i < limit) && Pop(item); ++i)
+  {
+    output.push_back(std::move(item));
+  }
+
+  return output.size();
+}
+
+/**
+ * Wait, for at most the specified timeout, for items to become available and then take up to
+ * `limit` of them from the queue
+ *
+ * @param output The vector to which the items are appended
+ * @param limit The maximum number of items to take
+ * @param timeout The maximum time to wait for the first item
+ * @return The number of items in the output
+ */
+template <class T, std::size_t N>
+template <typename R, typename P>
+std::size_t MPMCWorkItemsQueue<T, N>::GetBatch(Items &output, std::size_t limit,
+                                               std::chrono::duration<R, P> const &timeout)
+{
+  if (Wait(timeout))
+  {
+    Get(output, limit);
+  }
+
+  return output.size();
+}
+
+template <class T, std::size_t N>
+void MPMCWorkItemsQueue<T, N>::Push(T const &item)
+{
+  // counted before it is visible, so that consumers never observe a negative count
+  ++count_;
+
+  // once items have overflowed, keep adding to the overflow until it has been drained so that the
+  // items are not overtaken by newer ones
+  if ((overflowed_.load() != 0) || !ring_.TryPush(T{item}))
+  {
+    Lock lock(mutex_);
+    overflow_.push_back(item);
+    ++overflowed_;
+  }
+}
+
+template <class T, std::size_t N>
+bool MPMCWorkItemsQueue<T, N>::Pop(T &item)
+{
+  if (ring_.TryPop(item))
+  {
+    --count_;
+    return true;
+  }
+
+  if (overflowed_.load() != 0)
+  {
+    Lock lock(mutex_);
+    if (!overflow_.empty())
+    {
+      item = std::move(overflow_.front());
+      overflow_.pop_front();
+      --overflowed_;
+      --count_;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Busy wait for a while for items to arrive
+ *
+ * @return true if items are available, otherwise false
+ */
+template <class T, std::size_t N>
+bool MPMCWorkItemsQueue<T, N>::Spin()
+{
+  for (std::size_t i = 0; i < spin_count_; ++i)
+  {
+    if (!empty() || quit_.load())
+    {
+      return !empty();
+    }
+
+    std::this_thread::yield();
+  }
+
+  return !empty();
+}
+
+template <class T, std::size_t N>
+void MPMCWorkItemsQueue<T, N>::Notify(bool all)
+{
+  // the item count has already been updated, a consumer which is about to sleep will either
+  // observe it or be registered as a sleeper by now
+  if (sleepers_.load() != 0)
+  {
+    Lock lock(mutex_);
+    if (all)
+    {
+      cv_.notify_all();
+    }
+    else
+    {
+      cv_.notify_one();
+    }
+  }
+}
+
+}  // namespace generics
+}  // namespace fetch
@@ -18,12 +18,18 @@
 //------------------------------------------------------------------------------
 
 #include "core/logger.hpp"
+#include "core/macros.hpp"
 #include "core/mutex.hpp"
 #include "network/management/abstract_connection_register.hpp"
 #include "network/message.hpp"
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 namespace fetch {
 namespace network {
 
@@ -37,6 +43,8 @@ public:
 
   static constexpr char const *LOGGING_NAME = "AbstractConnection";
 
+  static constexpr std::size_t DEFAULT_HIGH_WATER_MARK = 32 * 1024 * 1024;  ///< Bytes
+
   enum
   {
     TYPE_UNDEFINED = 0,
@@ -77,6 +85,19 @@ public:
   virtual bool     Closed() const             = 0;
   virtual bool     is_alive() const           = 0;
 
+  /**
+   * Send a message ahead of any queued messages of a lower priority. Connections which do not
+   * queue messages send them in order.
+   *
+   * @param msg The message to be sent
+   * @param priority The priority of the message
+   */
+  virtual void SendWithPriority(message_type const &msg, MessagePriority priority)
+  {
+    FETCH_UNUSED(priority);
+    Send(msg);
+  }
+
   // Common to all
   std::string Address() const
   {
@@ -135,6 +156,56 @@ public:
     on_message_            = nullptr;
   }
 
+  /// @name Send Queue Backpressure
+  /// The messages waiting to be written (or being written) to a connection are bounded by its high
+  /// water mark. Once it has been reached further messages are dropped by Send, unless the queue is
+  /// empty, so that a single large message can always be sent. High priority messages may use
+  /// twice the high water mark, so that they are not starved by bulk traffic.
+  /// @{
+  void SetHighWaterMark(std::size_t bytes)
+  {
+    high_water_mark_ = bytes;
+  }
+
+  std::size_t high_water_mark() const
+  {
+    return high_water_mark_;
+  }
+
+  std::size_t queued_bytes() const
+  {
+    return queued_bytes_;
+  }
+
+  uint64_t dropped_messages() const
+  {
+    return dropped_messages_;
+  }
+
+  bool IsCongested() const
+  {
+    return queued_bytes_ >= high_water_mark_;
+  }
+
+  /**
+   * Block until the connection is no longer congested
+   *
+   * @param timeout The maximum time to wait
+   * @return true if the connection has capacity, false if the wait timed out
+   */
+  bool WaitForSendCapacity(std::chrono::milliseconds const &timeout)
+  {
+    std::unique_lock<std::mutex> lock(send_capacity_mutex_);
+
+    ++send_capacity_waiters_;
+    bool const success =
+        send_capacity_.wait_for(lock, timeout, [this]() { return !IsCongested() || Closed(); });
+    --send_capacity_waiters_;
+
+    return success && !Closed();
+  }
+  /// @}
+
   void ActivateSelfManage()
   {
     self_ = shared_from_this();
@@ -157,6 +228,48 @@ protected:
     port_ = p;
   }
 
+  /**
+   * Account for a message about to be queued for sending
+   *
+   * @param bytes The number of bytes which will be written
+   * @param priority The priority of the message
+   * @return true if the message can be queued, false if it must be dropped
+   */
+  bool ReserveSendCapacity(std::size_t bytes, MessagePriority priority = MessagePriority::NORMAL)
+  {
+    std::size_t       queued = queued_bytes_;
+    std::size_t const limit =
+        (priority == MessagePriority::HIGH) ? (2 * high_water_mark_) : high_water_mark_.load();
+
+    do
+    {
+      if ((queued != 0) && ((queued + bytes) > limit))
+      {
+        ++dropped_messages_;
+        return false;
+      }
+    } while (!queued_bytes_.compare_exchange_weak(queued, queued + bytes));
+
+    return true;
+  }
+
+  /**
+   * Account for messages which have been written (or discarded)
+   *
+   * @param bytes The number of bytes which were reserved for them
+   */
+  void ReleaseSendCapacity(std::size_t bytes)
+  {
+    queued_bytes_ -= bytes;
+
+    // waiters register under the lock before checking for capacity, so no wake up can be missed
+    if (send_capacity_waiters_ > 0)
+    {
+      std::lock_guard<std::mutex> lock(send_capacity_mutex_);
+      send_capacity_.notify_all();
+    }
+  }
+
   void SignalLeave()
   {
     FETCH_LOG_DEBUG(LOGGING_NAME, "Connection terminated for handle ", handle_.load(),
@@ -255,6 +368,13 @@ private:
 
   shared_type self_;
 
+  std::atomic<std::size_t> high_water_mark_{DEFAULT_HIGH_WATER_MARK};
+  std::atomic<std::size_t> queued_bytes_{0};
+  std::atomic<uint64_t>    dropped_messages_{0};
+  std::atomic<std::size_t> send_capacity_waiters_{0};
+  std::mutex               send_capacity_mutex_;
+  std::condition_variable  send_capacity_;
+
   friend class AbstractConnectionRegister;
 };
 
@@ -85,8 +85,18 @@ public:
     {
       auto c = which->second;
       clients_mutex_.unlock();
-      c->Send(msg);
-      FETCH_LOG_DEBUG(LOGGING_NAME, "Client manager did send message to ", client);
+
+      // the connection drops messages once its send queue is full, report this to the caller
+      if (c->IsCongested())
+      {
+        FETCH_LOG_DEBUG(LOGGING_NAME, "Client ", client, " is congested, message dropped");
+        ret = false;
+      }
+      else
+      {
+        c->Send(msg);
+        FETCH_LOG_DEBUG(LOGGING_NAME, "Client manager did send message to ", client);
+      }
       clients_mutex_.lock();
     }
     else
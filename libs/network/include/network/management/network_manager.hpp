@@ -37,11 +37,12 @@ public:
   using implementation_type = details::NetworkManagerImplementation;
   using PointerType         = std::shared_ptr<implementation_type>;
   using weak_ref_type       = std::weak_ptr<implementation_type>;
+  using Mode                = implementation_type::Mode;
 
   static constexpr char const *LOGGING_NAME = "NetworkManager";
 
-  NetworkManager(std::string name, std::size_t threads)
-    : pointer_{std::make_shared<implementation_type>(std::move(name), threads)}
+  NetworkManager(std::string name, std::size_t threads, Mode mode = Mode::SHARED)
+    : pointer_{std::make_shared<implementation_type>(std::move(name), threads, mode)}
   {}
 
   NetworkManager(NetworkManager const &other)
@@ -91,6 +92,23 @@ public:
     }
   }
 
+  /**
+   * Post work to the io context of a specific core, see NextCore
+   */
+  template <typename F>
+  void PostOnCore(std::size_t core, F &&f)
+  {
+    auto ptr = lock();
+    if (ptr)
+    {
+      ptr->PostOnCore(core, std::forward<F>(f));
+    }
+    else
+    {
+      FETCH_LOG_INFO(LOGGING_NAME, "Failed to post: network man dead.");
+    }
+  }
+
   template <typename F>
   void Post(F &&f, int milliseconds)
   {
@@ -112,6 +130,21 @@ public:
     return ptr && ptr->Running();
   }
 
+  bool is_per_core()
+  {
+    auto ptr = lock();
+    return ptr && (Mode::PER_CORE == ptr->mode());
+  }
+
+  /**
+   * Select the core which should own a new connection. Always 0 in the shared mode
+   */
+  std::size_t NextCore()
+  {
+    auto ptr = lock();
+    return ptr ? ptr->NextCore() : 0;
+  }
+
   bool is_primary()
   {
     return (!is_copy_);
@@ -138,6 +171,18 @@ public:
     return std::shared_ptr<IO>{};
   }
 
+  template <typename IO, typename... Args>
+  std::shared_ptr<IO> CreateIOOnCore(std::size_t core, Args &&... args)
+  {
+    auto ptr = lock();
+    if (ptr)
+    {
+      return ptr->CreateIOOnCore<IO>(core, std::forward<Args>(args)...);
+    }
+    TODO_FAIL("Attempted to get IO from dead TM");
+    return std::shared_ptr<IO>{};
+  }
+
 private:
   PointerType   pointer_;
   weak_ref_type weak_pointer_;
@@ -20,11 +20,31 @@
 #include "core/byte_array/byte_array.hpp"
 #include "core/byte_array/const_byte_array.hpp"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
 
 namespace fetch {
 namespace network {
 using message_type       = byte_array::ByteArray;
 using message_queue_type = std::deque<message_type>;
+
+/**
+ * The priority with which a message is sent. Higher priority messages are written before any
+ * queued message of a lower priority.
+ */
+enum class MessagePriority : uint8_t
+{
+  LOW    = 0,  ///< Bulk traffic, e.g. block synchronisation
+  NORMAL = 1,
+  HIGH   = 2   ///< Latency critical traffic, e.g. consensus and executor RPCs
+};
+
+static constexpr std::size_t NUM_MESSAGE_PRIORITIES = 3;
+
+/// A queue per priority, indexed by the value of the priority
+using prioritised_message_queue_type = std::array<message_queue_type, NUM_MESSAGE_PRIORITIES>;
+
 }  // namespace network
 }  // namespace fetch
@@ -0,0 +1,100 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/mutex.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fetch {
+namespace muddle {
+
+/**
+ * A fixed size, time bucketed set of recently seen broadcast identifiers
+ *
+ * Identifiers are inserted into the current bucket, each bucket being a fixed size open addressed
+ * hash table. Once the bucket interval has elapsed (or the current bucket has become full) the
+ * oldest bucket is cleared and becomes the current bucket. Therefore an identifier is remembered
+ * for at least (NUM_BUCKETS - 1) bucket intervals, without any periodic clean up being required.
+ */
+class BroadcastCache
+{
+public:
+  using Id        = uint64_t;
+  using Clock     = std::chrono::steady_clock;
+  using Timepoint = Clock::time_point;
+  using Duration  = Clock::duration;
+
+  static constexpr std::size_t NUM_BUCKETS     = 4;
+  static constexpr std::size_t BUCKET_SIZE     = 1u << 14u;  ///< Must be a power of two
+  static constexpr std::size_t MAX_BUCKET_LOAD = BUCKET_SIZE / 2;
+
+  struct Stats
+  {
+    uint64_t inserted{0};          ///< The number of unique identifiers inserted
+    uint64_t suppressed{0};        ///< The number of duplicate identifiers detected
+    uint64_t rotations{0};         ///< The number of expired buckets
+    uint64_t forced_rotations{0};  ///< The number of buckets expired early because they were full
+  };
+
+  // Construction / Destruction
+  explicit BroadcastCache(Duration bucket_interval = std::chrono::seconds{10});
+  BroadcastCache(BroadcastCache const &) = delete;
+  BroadcastCache(BroadcastCache &&)      = delete;
+  ~BroadcastCache()                      = default;
+
+  bool  Insert(Id id, Timepoint const &now = Clock::now());
+  bool  Contains(Id id) const;
+  Stats GetStats() const;
+
+  // Operators
+  BroadcastCache &operator=(BroadcastCache const &) = delete;
+  BroadcastCache &operator=(BroadcastCache &&) = delete;
+
+private:
+  using Mutex = mutex::Mutex;
+  using Slots = std::vector<Id>;
+
+  struct Bucket
+  {
+    Slots       slots = Slots(BUCKET_SIZE, 0);
+    std::size_t count{0};
+  };
+
+  using Buckets = std::array<Bucket, NUM_BUCKETS>;
+
+  static Id   Normalise(Id id);
+  static bool Find(Bucket const &bucket, Id id);
+  static void Add(Bucket &bucket, Id id);
+  void        Rotate(std::size_t count, Timepoint const &now);
+
+  Duration const bucket_interval_;
+
+  mutable Mutex lock_{__LINE__, __FILE__};
+  Buckets       buckets_{};
+  std::size_t   current_{0};      ///< The index of the bucket being inserted into
+  Timepoint     current_start_;  ///< The time at which the current bucket was started
+  Stats         stats_{};
+};
+
+}  // namespace muddle
+}  // namespace fetch
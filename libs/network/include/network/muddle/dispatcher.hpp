@@ -18,18 +18,37 @@
 //------------------------------------------------------------------------------
 
 #include "core/mutex.hpp"
+#include "network/message.hpp"
 #include "network/muddle/packet.hpp"
 #include "network/service/promise.hpp"
 
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <unordered_map>
-#include <unordered_set>
+#include <utility>
 
 namespace fetch {
 namespace muddle {
 
+/**
+ * The dispatcher matches the responses of exchanges with the promises waiting on them, and queues
+ * the received packets to be dispatched by priority.
+ *
+ * Pending promises are kept in a lock-free table indexed by message counter. Since counters are
+ * unique across all the services and channels of a muddle, each counter owns a slot of the table
+ * whose state (free, busy or holding a promise) is a single atomic word. Registering, resolving or
+ * failing a promise claims the slot with a compare-and-swap, so that exactly one of them wins. The
+ * table is split into chunks which are only allocated once their counters are first used.
+ *
+ * Promises expire through a timer wheel of one second buckets. Each registration pushes a node
+ * onto the lock-free list of the bucket of its deadline, and the cleanup only visits the buckets
+ * whose time has passed rather than every pending promise.
+ */
 class Dispatcher
 {
 public:
@@ -39,14 +58,15 @@ public:
   using Timepoint = Clock::time_point;
   using Handle    = uint64_t;
   using Address   = Packet::Address;
+  using Priority  = network::MessagePriority;
 
   static constexpr char const *LOGGING_NAME = "MuddleDispatch";
 
   // Construction / Destruction
-  Dispatcher()                   = default;
+  Dispatcher();
   Dispatcher(Dispatcher const &) = delete;
   Dispatcher(Dispatcher &&)      = delete;
-  ~Dispatcher()                  = default;
+  ~Dispatcher();
 
   // Operators
   Dispatcher &operator=(Dispatcher const &) = delete;
@@ -65,35 +85,101 @@ public:
 
   void FailAllPendingPromises();
 
+  std::size_t GetNumPendingPromises() const;
+
+  /// @name Priorities
+  /// Each service / channel pair has a priority (normal by default). It determines the order in
+  /// which packets are written to a connection and, for received packets, the order in which they
+  /// are dispatched.
+  /// @{
+  void     SetPriority(uint16_t service, uint16_t channel, Priority priority);
+  Priority GetPriority(uint16_t service, uint16_t channel) const;
+  /// @}
+
+  /// @name Received Packet Queue
+  /// @{
+  void        Enqueue(PacketPtr packet, Address const &transmitter);
+  bool        Dequeue(PacketPtr &packet, Address &transmitter);
+  std::size_t pending() const;
+  /// @}
+
 private:
+  static constexpr std::size_t NUM_SLOTS       = std::size_t{1} << 16u;  ///< One per counter
+  static constexpr std::size_t SLOTS_PER_CHUNK = 256;
+  static constexpr std::size_t NUM_CHUNKS      = NUM_SLOTS / SLOTS_PER_CHUNK;
+  static constexpr std::size_t WHEEL_SIZE      = 64;  ///< Buckets, must exceed the timeout
+  static constexpr Handle      NO_HANDLE       = 0;
+
   using Counter = std::atomic<uint16_t>;
   using Mutex   = mutex::Mutex;
 
-  struct PromiseEntry
+  /// The state of a slot: the id of the exchange (service, channel and counter) in the low 48 bits,
+  /// a sequence number incremented by each registration, and the busy / published flags
+  using SlotState = std::atomic<uint64_t>;
+
+  struct Slot
   {
-    Promise   promise   = service::MakePromise();
-    Timepoint timestamp = Clock::now();
-    Address   address;
+    SlotState           state{0};
+    std::atomic<Handle> handle{NO_HANDLE};  ///< The connection the request was sent on
+    Promise             promise{};
+    Address             address{};  ///< The address expected to respond
   };
 
-  using PromiseMap = std::unordered_map<uint64_t, PromiseEntry>;
-  using PromiseSet = std::unordered_set<uint64_t>;
-  using HandleMap  = std::unordered_map<Handle, PromiseSet>;
-
-  Mutex    counter_lock_{__LINE__, __FILE__};
-  uint16_t counter_{1};
+  using Chunk    = std::array<Slot, SLOTS_PER_CHUNK>;
+  using ChunkPtr = std::atomic<Chunk *>;
+  using Chunks   = std::array<ChunkPtr, NUM_CHUNKS>;
 
-  Mutex      promises_lock_{__LINE__, __FILE__};
-  PromiseMap promises_;
+  struct Expiry
+  {
+    Slot *    slot;
+    uint64_t  state;  ///< The state of the slot when the promise was registered
+    Timepoint deadline;
+    Expiry *  next;
+  };
 
-  Mutex     handles_lock_{__LINE__, __FILE__};
-  HandleMap handles_;
+  using Bucket = std::atomic<Expiry *>;
+  using Wheel  = std::array<Bucket, WHEEL_SIZE>;
+
+  using PriorityMap    = std::unordered_map<uint32_t, Priority>;
+  using ReceivedPacket = std::pair<PacketPtr, Address>;
+  using ReceivedQueue  = std::deque<ReceivedPacket>;
+  using ReceivedQueues = std::array<ReceivedQueue, network::NUM_MESSAGE_PRIORITIES>;
+
+  /// @name Promise Table
+  /// @{
+  Slot &  LookupSlot(uint16_t counter);
+  Slot *  FindSlot(uint16_t counter) const;
+  bool    Claim(Slot &slot, uint64_t state);
+  Promise Release(Slot &slot, uint64_t state);
+  template <typename Function>
+  void VisitSlots(Function &&function) const;
+  /// @}
+
+  /// @name Expiry
+  /// @{
+  int64_t ToTick(Timepoint const &timepoint) const;
+  void    Schedule(Expiry *expiry);
+  /// @}
+
+  Counter counter_{1};
+
+  Chunks                   chunks_{};  ///< The slots of the promise table, allocated on demand
+  Wheel                    wheel_{};   ///< The pending expiries, by the tick of their deadline
+  Timepoint const          epoch_;     ///< The start of the first tick of the wheel
+  Mutex                    cleanup_lock_{__LINE__, __FILE__};
+  int64_t                  next_tick_{0};    ///< The next tick of the wheel to be expired
+  std::atomic<std::size_t> num_pending_{0};  ///< The number of promises waiting on a response
+
+  mutable Mutex priorities_lock_{__LINE__, __FILE__};
+  PriorityMap   priorities_;
+
+  mutable Mutex  received_lock_{__LINE__, __FILE__};
+  ReceivedQueues received_;
 };
 
 inline uint16_t Dispatcher::GetNextCounter()
 {
-  FETCH_LOCK(counter_lock_);
-  return counter_++;
+  return counter_.fetch_add(1, std::memory_order_relaxed);
 }
 
 }  // namespace muddle
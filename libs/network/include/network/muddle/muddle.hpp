@@ -31,9 +31,11 @@
 #include "network/tcp/abstract_server.hpp"
 #include "network/uri.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace fetch {
@@ -128,6 +130,7 @@ public:
 
   using ConnectionDataList = std::vector<ConnectionData>;
   using ConnectionMap      = std::unordered_map<Address, Uri>;
+  using LatencyMap         = std::unordered_map<Address, uint32_t>;
 
   static constexpr char const *LOGGING_NAME = "Muddle";
 
@@ -172,6 +175,10 @@ public:
   MuddleEndpoint &AsEndpoint();
 
   ConnectionMap GetConnections(bool direct_only = false);
+  LatencyMap    GetPeerLatencies() const;
+
+  template <typename R, typename P>
+  bool WaitForConnections(std::size_t count, std::chrono::duration<R, P> const &max_wait_time);
 
   bool UriToDirectAddress(const Uri &uri, Address &address) const;
 
@@ -195,6 +202,50 @@ public:
     return router_.IsConnected(target);
   }
 
+  /**
+   * Set the priority with which the packets of a service / channel pair are sent and dispatched
+   *
+   * @param service The service id
+   * @param channel The channel id
+   * @param priority The priority to be used
+   */
+  void SetPriority(uint16_t service, uint16_t channel, network::MessagePriority priority)
+  {
+    dispatcher_.SetPriority(service, channel, priority);
+  }
+
+  /**
+   * Collect the packets sent to each direct peer over a short window and send them as a single
+   * (signed) batch
+   *
+   * @param milliseconds The duration of the window, zero disables batching
+   */
+  void SetBatchWindow(uint32_t milliseconds)
+  {
+    router_.SetBatchWindow(milliseconds);
+  }
+
+  /**
+   * Compress the large packets sent to direct peers which support it, unless they are on the local
+   * network. Must be called before the muddle is started.
+   *
+   * @param options The compression options
+   */
+  void SetCompression(CompressionOptions options)
+  {
+    router_.SetCompression(std::move(options));
+  }
+
+  /**
+   * Get the depth of the queues of packets waiting to be sent to, or received from, direct peers
+   *
+   * @return The current queue depths
+   */
+  Router::QueueStats GetQueueStats() const
+  {
+    return router_.GetQueueStats();
+  }
+
   // Operators
   Muddle &operator=(Muddle const &) = delete;
   Muddle &operator=(Muddle &&) = delete;
@@ -273,6 +324,41 @@ inline std::size_t Muddle::NumPeers() const
   return clients_.GetNumPeers();
 }
 
+/**
+ * Wait for the node to be directly connected to at least a given number of peers
+ *
+ * @param count The number of direct connections required
+ * @param max_wait_time The maximum time to wait
+ * @return true if the connections were established in time, otherwise false
+ */
+template <typename R, typename P>
+bool Muddle::WaitForConnections(std::size_t count, std::chrono::duration<R, P> const &max_wait_time)
+{
+  // a connection is only counted once it is alive, which is not signalled by the router, so the
+  // routing table is also checked periodically
+  static constexpr std::chrono::milliseconds MAX_POLL_INTERVAL{100};
+
+  auto const deadline = std::chrono::steady_clock::now() + max_wait_time;
+
+  for (;;)
+  {
+    uint64_t const updates = router_.RoutingUpdates();
+    if (GetConnections(true).size() >= count)
+    {
+      return true;
+    }
+
+    auto const now = std::chrono::steady_clock::now();
+    if (now >= deadline)
+    {
+      return false;
+    }
+
+    auto const remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+    router_.WaitForRoutingUpdate(updates, std::min(remaining, MAX_POLL_INTERVAL));
+  }
+}
+
 inline Muddle::ConnectionState Muddle::GetPeerState(Uri const &uri)
 {
   return clients_.GetStateForPeer(uri);
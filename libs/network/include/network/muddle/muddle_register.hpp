@@ -17,9 +17,10 @@
 //
 //------------------------------------------------------------------------------
 
-#include "core/byte_array/const_byte_array.hpp"
+#include "core/byte_array/byte_array.hpp"
 #include "core/mutex.hpp"
 #include "network/management/abstract_connection_register.hpp"
+#include "network/message.hpp"
 
 #include <functional>
 #include <thread>
@@ -40,8 +41,10 @@ public:
   using ConnectionPtr         = std::weak_ptr<network::AbstractConnection>;
   using ConnectionMap         = std::unordered_map<ConnectionHandle, ConnectionPtr>;
   using ConnectionMapCallback = std::function<void(ConnectionMap const &)>;
-  using ConstByteArray        = byte_array::ConstByteArray;
+  using ByteArray             = byte_array::ByteArray;
+  using EncodeCallback        = std::function<ByteArray(ConnectionHandle)>;
   using Mutex                 = mutex::Mutex;
+  using Priority              = network::MessagePriority;
 
   static constexpr char const *LOGGING_NAME = "MuddleReg";
 
@@ -60,7 +63,8 @@ public:
   void VisitConnectionMap(ConnectionMapCallback const &cb);
   /// @}
 
-  void          Broadcast(ConstByteArray const &data) const;
+  void          Broadcast(ByteArray const &data, Priority priority = Priority::NORMAL) const;
+  void          Broadcast(EncodeCallback const &encode, Priority priority = Priority::NORMAL) const;
   ConnectionPtr LookupConnection(ConnectionHandle handle) const;
 
 protected:
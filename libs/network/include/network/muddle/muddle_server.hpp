@@ -87,13 +87,11 @@ private:
     {
       LOG_STACK_TRACE_POINT;
       // un-marshall the data
-      ByteArrayBuffer buffer(msg);
-
       auto packet = std::make_shared<Packet>();
 
       {
         LOG_STACK_TRACE_POINT;
-        buffer >> *packet;
+        packet->FromWireBuffer(msg);
       }
 
       // dispatch the message to router
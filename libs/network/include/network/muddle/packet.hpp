@@ -19,7 +19,9 @@
 
 #include "core/byte_array/byte_array.hpp"
 #include "core/byte_array/const_byte_array.hpp"
+#include "core/serializers/byte_array.hpp"
 #include "core/serializers/byte_array_buffer.hpp"
+#include "core/serializers/counter.hpp"
 #include "crypto/prover.hpp"
 #include "crypto/verifier.hpp"
 
@@ -77,6 +79,7 @@ public:
   using Address    = byte_array::ConstByteArray;
   using Payload    = byte_array::ConstByteArray;
   using Stamp      = byte_array::ConstByteArray;
+  using WireBuffer = byte_array::ByteArray;
 
   struct RoutingHeader
   {
@@ -150,6 +153,10 @@ public:
   void Sign(crypto::Prover &prover);
   bool Verify() const;
 
+  // Wire Format
+  WireBuffer const &GetWireBuffer() const;
+  void              FromWireBuffer(byte_array::ByteArray const &buffer);
+
 private:
   RoutingHeader header_;   ///< The header containing primarily routing information
   Payload       payload_;  ///< The payload of the message
@@ -159,7 +166,12 @@ private:
   mutable Address target_;
   mutable Address sender_;
 
+  ///< Cached encoded version of the packet
+  mutable WireBuffer wire_;
+  mutable bool       wire_shared_{false};  ///< Signal the encoded version has been handed out
+
   void         SetStamped(bool set = true) noexcept;
+  void         ResetWireBuffer() const noexcept;
   BinaryHeader StaticHeader() const noexcept;
 
   template <typename T>
@@ -304,6 +316,20 @@ inline void Packet::SetTTL(uint8_t ttl) noexcept
 {
   header_.ttl = ttl;
   // stamps are not invalidated
+
+  // the TTL is updated on every hop, so rather than invalidating the encoded packet, patch the
+  // header in place. This is only possible while no connection holds a reference to the buffer.
+  if (!wire_.empty())
+  {
+    if (wire_shared_)
+    {
+      ResetWireBuffer();
+    }
+    else
+    {
+      wire_.WriteBytes(reinterpret_cast<uint8_t const *>(&header_), HEADER_SIZE);
+    }
+  }
 }
 
 inline void Packet::SetService(uint16_t service_num) noexcept
@@ -352,6 +378,15 @@ inline void Packet::SetPayload(Payload const &payload)
 inline void Packet::SetStamped(bool set) noexcept
 {
   header_.stamped = set;
+
+  // any change to the contents of the packet invalidates the encoded version
+  ResetWireBuffer();
+}
+
+inline void Packet::ResetWireBuffer() const noexcept
+{
+  wire_        = WireBuffer{};
+  wire_shared_ = false;
 }
 
 inline Packet::BinaryHeader Packet::StaticHeader() const noexcept
@@ -402,6 +437,8 @@ void Serialize(T &serializer, Packet const &packet)
 template <typename T>
 void Deserialize(T &serializer, Packet &packet)
 {
+  packet.ResetWireBuffer();
+
   serializer >> *reinterpret_cast<Packet::BinaryHeader *>(&packet.header_) >> packet.payload_;
   if (packet.header_.stamped)
   {
@@ -409,6 +446,45 @@ void Deserialize(T &serializer, Packet &packet)
   }
 }
 
+/**
+ * Get the encoded (wire) version of the packet
+ *
+ * The packet is only encoded once and the resulting buffer is shared between all the connections
+ * that the packet is sent to.
+ *
+ * @return The encoded packet
+ */
+inline Packet::WireBuffer const &Packet::GetWireBuffer() const
+{
+  if (wire_.empty())
+  {
+    serializers::ByteArrayBuffer buffer;
+    buffer.Append(*this);
+
+    wire_ = buffer.data();
+  }
+
+  wire_shared_ = true;
+
+  return wire_;
+}
+
+/**
+ * Populate the packet from its encoded (wire) version
+ *
+ * The decoded copy of the buffer is retained (the payload refers to it) so that if the packet is
+ * subsequently forwarded it does not need to be encoded again.
+ *
+ * @param buffer The encoded packet
+ */
+inline void Packet::FromWireBuffer(byte_array::ByteArray const &buffer)
+{
+  serializers::ByteArrayBuffer serializer(buffer);
+  serializer >> *this;
+
+  wire_ = serializer.data().SubArray(0, serializer.tell());
+}
+
 }  // namespace muddle
 }  // namespace fetch
 
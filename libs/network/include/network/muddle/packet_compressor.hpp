@@ -0,0 +1,101 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/byte_array.hpp"
+#include "core/byte_array/const_byte_array.hpp"
+#include "core/mutex.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace fetch {
+namespace muddle {
+
+struct CompressionOptions
+{
+  using ConstByteArray = byte_array::ConstByteArray;
+
+  bool           enabled        = false;
+  int            level          = 1;      ///< zlib compression level (1 - 9)
+  std::size_t    min_size       = 1024;   ///< Packets smaller than this are always sent raw
+  bool           compress_local = false;  ///< Also compress on loopback and private network links
+  ConstByteArray dictionary{};            ///< Preset dictionary, only used with peers sharing it
+};
+
+/**
+ * Compresses the encoded packets sent to a single hop peer with deflate
+ *
+ * Compression is negotiated per connection: each side advertises its capabilities in the payload
+ * of the routing handshake and a packet is only compressed when the peer has advertised support
+ * for it. Peers may also share a preset dictionary (for example one trained on the serialised
+ * transaction format), which is identified by its Adler-32 checksum. The dictionary is only used
+ * with peers which advertised the same checksum.
+ */
+class PacketCompressor
+{
+public:
+  using ConstByteArray = byte_array::ConstByteArray;
+  using ByteArray      = byte_array::ByteArray;
+  using DictionaryId   = uint32_t;
+
+  struct Capabilities
+  {
+    bool         deflate{false};  ///< The peer accepts deflated packets
+    DictionaryId dictionary{0};   ///< The preset dictionary of the peer (0 if none)
+  };
+
+  static constexpr char const *LOGGING_NAME          = "PacketCompressor";
+  static constexpr uint32_t    CAPABILITY_DEFLATE    = 1u << 0u;
+  static constexpr std::size_t MAX_DICTIONARY_SIZE   = 32 * 1024;  ///< deflate window size
+  static constexpr std::size_t MAX_DECOMPRESSED_SIZE = 256 * 1024 * 1024;
+
+  /// @name Options
+  /// @{
+  void               SetOptions(CompressionOptions options);
+  CompressionOptions options() const;
+  bool               enabled() const;
+  DictionaryId       dictionary_id() const;
+  /// @}
+
+  /// @name Negotiation
+  /// @{
+  ConstByteArray      EncodeCapabilities() const;
+  static Capabilities DecodeCapabilities(ConstByteArray const &payload);
+  bool                ShouldCompress(Capabilities const &peer, std::string const &address) const;
+  /// @}
+
+  /// @name Encoding
+  /// @{
+  bool Compress(ConstByteArray const &input, bool use_dictionary, ConstByteArray &output) const;
+  bool Decompress(ConstByteArray const &input, ByteArray &output) const;
+  /// @}
+
+  static bool IsLocalAddress(std::string const &address);
+
+private:
+  using Mutex = mutex::Mutex;
+
+  mutable Mutex      lock_{__LINE__, __FILE__};
+  CompressionOptions options_;           ///< The current options (Protected by lock_)
+  DictionaryId       dictionary_id_{0};  ///< The checksum of the dictionary (Protected by lock_)
+};
+
+}  // namespace muddle
+}  // namespace fetch
@@ -18,18 +18,24 @@
 //------------------------------------------------------------------------------
 
 #include "core/mutex.hpp"
+#include "core/threading/synchronised_state.hpp"
 #include "crypto/prover.hpp"
 #include "network/details/thread_pool.hpp"
 #include "network/management/abstract_connection.hpp"
 #include "network/muddle/blacklist.hpp"
+#include "network/muddle/broadcast_cache.hpp"
 #include "network/muddle/muddle_endpoint.hpp"
 #include "network/muddle/network_id.hpp"
 #include "network/muddle/packet.hpp"
+#include "network/muddle/packet_compressor.hpp"
 #include "network/muddle/subscription_registrar.hpp"
 #include "network/p2pservice/p2p_service_defs.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <deque>
 #include <memory>
+#include <vector>
 
 namespace fetch {
 namespace muddle {
@@ -53,17 +59,64 @@ public:
   using ThreadPool          = network::ThreadPool;
   using HandleDirectAddrMap = std::unordered_map<Handle, Address>;
   using Prover              = crypto::Prover;
+  using BroadcastStats      = BroadcastCache::Stats;
 
   struct RoutingData
   {
-    bool   direct = false;
-    Handle handle = 0;
+    bool     direct     = false;
+    Handle   handle     = 0;
+    uint8_t  hops       = 0;  ///< The number of hops to the address via the handle (0 if unknown)
+    uint32_t latency_us = 0;  ///< The round trip time of the handle's connection (0 if unknown)
   };
 
   using RoutingTable = std::unordered_map<Packet::RawAddress, RoutingData>;
 
+  /**
+   * The action taken when a packet is to be sent to a connection which has reached its high water
+   * mark
+   */
+  enum class BackpressurePolicy
+  {
+    DROP,    ///< Drop the packet
+    BLOCK,   ///< Wait (for a bounded time) for the connection to drain, then drop
+    REROUTE  ///< Route the packet via the least loaded other direct peer, otherwise drop
+  };
+
+  struct BackpressureStats
+  {
+    uint64_t congested{0};  ///< The number of packets which found their connection congested
+    uint64_t dropped{0};    ///< The number of packets dropped because of congestion
+    uint64_t blocked{0};    ///< The number of packets sent after waiting for a connection to drain
+    uint64_t rerouted{0};   ///< The number of packets sent to another peer
+  };
+
+  struct CompressionStats
+  {
+    uint64_t compressed{0};        ///< The number of packets sent compressed
+    uint64_t raw_bytes{0};         ///< The size of the compressed packets before compression
+    uint64_t compressed_bytes{0};  ///< The size of the compressed packets on the wire
+    uint64_t decompressed{0};      ///< The number of compressed packets received
+    uint64_t rejected{0};          ///< The number of compressed packets which could not be read
+  };
+
+  struct QueueStats
+  {
+    std::size_t connections{0};       ///< The number of direct connections
+    std::size_t congested{0};         ///< The connections at (or above) their high water mark
+    std::size_t queued_bytes{0};      ///< The bytes waiting to be sent on all the connections
+    std::size_t max_queued_bytes{0};  ///< The bytes waiting to be sent on the busiest connection
+    std::size_t batched_packets{0};   ///< The packets waiting for their batch to be sent
+    std::size_t verify_backlog{0};    ///< The packets waiting for their signature to be checked
+  };
+
   static constexpr char const *LOGGING_NAME = "Router";
 
+  static constexpr std::chrono::milliseconds::rep DEFAULT_BLOCK_TIMEOUT_MS = 100;
+
+  static constexpr uint32_t    DEFAULT_BATCH_WINDOW_MS = 1;
+  static constexpr std::size_t MAX_BATCH_PACKETS       = 64;
+  static constexpr std::size_t MAX_BATCH_BYTES         = 64 * 1024;
+
   // Helper functions
   static Packet::RawAddress ConvertAddress(Packet::Address const &address);
   static Packet::Address    ConvertAddress(Packet::RawAddress const &address);
@@ -125,6 +178,33 @@ public:
 
   void Cleanup();
 
+  /** Get the statistics of the broadcast (echo) suppression
+   * @returns The current statistics
+   */
+  BroadcastStats GetBroadcastStats() const;
+
+  /// @name Backpressure
+  /// @{
+  void SetBackpressurePolicy(BackpressurePolicy        policy,
+                             std::chrono::milliseconds block_timeout =
+                                 std::chrono::milliseconds{DEFAULT_BLOCK_TIMEOUT_MS});
+  void              SetHighWaterMark(std::size_t bytes);
+  BackpressureStats GetBackpressureStats() const;
+  /// @}
+
+  /// @name Packet Batching
+  /// @{
+  void SetBatchWindow(uint32_t milliseconds);
+  /// @}
+
+  /// @name Compression
+  /// @{
+  void             SetCompression(CompressionOptions options);
+  CompressionStats GetCompressionStats() const;
+  /// @}
+
+  QueueStats GetQueueStats() const;
+
   /** Show debugging information about the internals of the router.
    * @param prefix the string to put on the front of the logging lines.
    */
@@ -158,6 +238,14 @@ public:
 
   Handle LookupHandle(Packet::RawAddress const &address) const;
 
+  /// @name Routing Updates
+  /// @{
+  uint64_t RoutingUpdates() const;
+
+  template <typename R, typename P>
+  bool WaitForRoutingUpdate(uint64_t seen, std::chrono::duration<R, P> const &max_wait_time) const;
+  /// @}
+
   // Operators
   Router &operator=(Router const &) = delete;
   Router &operator=(Router &&) = delete;
@@ -165,29 +253,89 @@ public:
 private:
   using HandleMap  = std::unordered_map<Handle, std::unordered_set<Packet::RawAddress>>;
   using Mutex      = mutex::Mutex;
-  using Clock      = std::chrono::steady_clock;
-  using Timepoint  = Clock::time_point;
-  using EchoCache  = std::unordered_map<std::size_t, Timepoint>;
   using RawAddress = Packet::RawAddress;
   using BlackList  = fetch::muddle::Blacklist;
 
+  using RoutingTablePtr = std::shared_ptr<RoutingTable const>;
+  using RouteList       = std::vector<RoutingData>;
+  using RouteCandidates = std::unordered_map<RawAddress, RouteList>;
+  using Clock           = std::chrono::steady_clock;
+  using Timepoint       = Clock::time_point;
+  using PingMap         = std::unordered_map<Handle, Timepoint>;
+  using LatencyMap      = std::unordered_map<Handle, uint32_t>;
+
+  struct PacketBatch
+  {
+    std::vector<PacketPtr> packets;
+    std::size_t            bytes{0};
+  };
+
+  using PacketBatches = std::unordered_map<Handle, PacketBatch>;
+
+  struct VerifyQueue
+  {
+    std::deque<PacketPtr> packets;
+    bool                  scheduled{false};  ///< Signal that a verification task is active
+  };
+
+  using VerifyQueues = std::unordered_map<Handle, VerifyQueue>;
+
+  /// The handles whose packets are compressed, mapped to whether the peer shares our dictionary
+  using CompressedHandles = std::unordered_map<Handle, bool>;
+
   static constexpr std::size_t NUMBER_OF_ROUTER_THREADS = 10;
+  static constexpr std::size_t MAX_ROUTES_PER_ADDRESS   = 4;
+  static constexpr std::size_t NUMBER_OF_VERIFY_THREADS = 4;
+  static constexpr std::size_t MAX_VERIFY_BATCH         = 32;
 
-  bool AssociateHandleWithAddress(Handle handle, Packet::RawAddress const &address, bool direct);
+  bool AssociateHandleWithAddress(Handle handle, Packet::RawAddress const &address, bool direct,
+                                  uint8_t hops);
+
+  /// @name Routing Table (must be called with routing_table_lock_ held)
+  /// @{
+  bool SelectRoute(RawAddress const &address);
+  void RemoveRoutes(Handle handle);
+  void RecordLatency(Handle handle, uint32_t latency_us);
+  void PublishRoutingTable();
+  /// @}
+
+  RoutingTablePtr LoadRoutingTable() const;
 
   Handle LookupRandomHandle(Packet::RawAddress const &address) const;
 
+  void SendPacket(PacketPtr packet);
+  bool AddToBatch(PacketPtr const &packet);
+  void FlushBatch(Handle handle);
+
+  void BroadcastPacket(PacketPtr const &packet);
   void SendToConnection(Handle handle, PacketPtr packet);
+  bool RelieveBackpressure(Handle &handle, network::AbstractConnection::shared_type &conn,
+                           Packet const &packet);
+  Handle LookupLeastLoadedHandle(Handle exclude) const;
   void RoutePacket(PacketPtr packet, bool external = true);
+  bool RequiresVerification(Packet const &packet) const;
+  void EnqueueVerification(Handle handle, PacketPtr packet);
+  void VerifyPackets(Handle handle);
+
+  void RouteGenuine(Handle handle, PacketPtr packet);
   void DispatchDirect(Handle handle, PacketPtr packet);
+  void DispatchBatch(Handle handle, Packet const &batch);
+  void DispatchCompressed(Handle handle, Packet const &frame);
   void KillConnection(Handle handle, Address const &peer);
   void KillConnection(Handle handle);
 
+  /// @name Compression
+  /// @{
+  bool               LookupCompression(Handle handle, bool &use_dictionary) const;
+  Packet::WireBuffer EncodeCompressed(Packet const &packet, bool use_dictionary);
+  void               UpdateCompression(Handle handle, Payload const &capabilities);
+  /// @}
+
   void DispatchPacket(PacketPtr packet, Address transmitter);
 
   bool IsEcho(Packet const &packet, bool register_echo = true);
-  void CleanEchoCache();
 
+  PacketPtr        FormatHandshake() const;
   PacketPtr const &Sign(PacketPtr const &p) const;
   bool             Genuine(PacketPtr const &p) const;
 
@@ -201,20 +349,84 @@ private:
   Prover *              prover_          = nullptr;
   bool                  sign_broadcasts_ = false;
 
-  mutable Mutex routing_table_lock_{__LINE__, __FILE__};
-  RoutingTable  routing_table_;  ///< The map routing table from address to handle (Protected by
-                                 ///< routing_table_lock_)
-  HandleMap
-      routing_table_handles_;  ///< The map of handles to address (Protected by routing_table_lock_)
+  mutable Mutex   routing_table_lock_{__LINE__, __FILE__};
+  RoutingTable    routing_table_;  ///< The writer's copy of the routing table (Protected by
+                                   ///< routing_table_lock_)
+  RoutingTablePtr routing_snapshot_;  ///< The published copy of the routing table, read without
+                                      ///< the lock through std::atomic_load and never modified
+  RouteCandidates route_candidates_;  ///< All the known routes to each address (Protected by
+                                      ///< routing_table_lock_)
+  HandleMap       routing_table_handles_;  ///< The map of handles to address (Protected by
+                                           ///< routing_table_lock_)
+  PingMap    pending_pings_;   ///< The send time of unanswered routing exchanges (Protected by
+                               ///< routing_table_lock_)
+  LatencyMap handle_latency_;  ///< The smoothed round trip time of each handle (Protected by
+                               ///< routing_table_lock_)
 
-  mutable Mutex echo_cache_lock_{__LINE__, __FILE__};
-  EchoCache     echo_cache_;
+  SynchronisedState<uint64_t> routing_updates_{0};  ///< The number of routing table changes
+
+  BroadcastCache echo_cache_;  ///< The set of recently seen broadcasts (internally locked)
 
   ThreadPool dispatch_thread_pool_;
+  ThreadPool verify_thread_pool_;
+
+  mutable Mutex verify_lock_{__LINE__, __FILE__};
+  VerifyQueues  verify_queues_;  ///< The packets waiting for verification per handle (Protected
+                                 ///< by verify_lock_)
 
   HandleDirectAddrMap direct_address_map_;  ///< Map of handles to direct address
   ///< (Protected by routing_table_lock)
+
+  std::atomic<BackpressurePolicy>              backpressure_policy_{BackpressurePolicy::DROP};
+  std::atomic<std::chrono::milliseconds::rep> block_timeout_ms_{DEFAULT_BLOCK_TIMEOUT_MS};
+  std::atomic<std::size_t> high_water_mark_{network::AbstractConnection::DEFAULT_HIGH_WATER_MARK};
+
+  mutable Mutex         batch_lock_{__LINE__, __FILE__};
+  PacketBatches         batches_;  ///< The packets waiting to be sent per handle (Protected by
+                                   ///< batch_lock_)
+  std::atomic<uint32_t> batch_window_ms_{0};
+
+  std::atomic<uint64_t> congested_packets_{0};
+  std::atomic<uint64_t> dropped_packets_{0};
+  std::atomic<uint64_t> blocked_packets_{0};
+  std::atomic<uint64_t> rerouted_packets_{0};
+
+  PacketCompressor  compressor_;  ///< The compression options (internally locked)
+  mutable Mutex     compression_lock_{__LINE__, __FILE__};
+  CompressedHandles compressed_handles_;  ///< The peers which accept compressed packets
+                                          ///< (Protected by compression_lock_)
+
+  std::atomic<uint64_t> compressed_packets_{0};
+  std::atomic<uint64_t> compressed_raw_bytes_{0};
+  std::atomic<uint64_t> compressed_wire_bytes_{0};
+  std::atomic<uint64_t> decompressed_packets_{0};
+  std::atomic<uint64_t> rejected_compressed_packets_{0};
 };
 
+/**
+ * Get the number of times the routing table has changed, to be passed to WaitForRoutingUpdate
+ *
+ * @return The number of changes so far
+ */
+inline uint64_t Router::RoutingUpdates() const
+{
+  return routing_updates_.Get();
+}
+
+/**
+ * Wait for the routing table to change
+ *
+ * @param seen The number of changes already seen, from RoutingUpdates
+ * @param max_wait_time The maximum time to wait
+ * @return true if the routing table has changed since, otherwise false
+ */
+template <typename R, typename P>
+bool Router::WaitForRoutingUpdate(uint64_t                           seen,
+                                  std::chrono::duration<R, P> const &max_wait_time) const
+{
+  return routing_updates_.WaitFor(max_wait_time,
+                                  [seen](uint64_t updates) { return updates != seen; });
+}
+
 }  // namespace muddle
 }  // namespace fetch
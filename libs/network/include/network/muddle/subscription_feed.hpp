@@ -21,6 +21,7 @@
 #include "network/muddle/subscription.hpp"
 
 #include <memory>
+#include <vector>
 
 namespace fetch {
 namespace muddle {
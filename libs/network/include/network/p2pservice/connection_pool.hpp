@@ -0,0 +1,95 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "crypto/fnv.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace fetch {
+namespace p2p {
+
+/**
+ * Selects the set of peers to which the node should be connected. The pool keeps a target number
+ * of the best scoring peers, where the score combines the trust rating of the peer with the
+ * measured round trip time of its connection.
+ *
+ * Slow peers are rotated out gradually: when a candidate appears to be significantly better than
+ * the worst connected peer, the candidate is connected first (pre-warmed) and only once the
+ * connection exists is the worst peer released. Candidates which fail to connect in time are put
+ * on a short cool down.
+ *
+ * The pool is not thread safe, it is expected to be driven from the P2P work cycle.
+ */
+class ConnectionPool
+{
+public:
+  using Address    = byte_array::ConstByteArray;
+  using AddressSet = std::unordered_set<Address>;
+
+  struct Candidate
+  {
+    Address  address;
+    double   trust      = 0.0;    ///< The trust rating of the peer
+    uint32_t latency_us = 0;      ///< The measured round trip time (0 if unknown)
+    bool     connected  = false;  ///< Flag to signal the peer is currently connected
+  };
+
+  using Candidates = std::vector<Candidate>;
+
+  static constexpr uint32_t    DEFAULT_LATENCY_US  = 100000;  ///< Assumed for unmeasured peers
+  static constexpr uint32_t    REFERENCE_LATENCY_US = 50000;  ///< Latency which halves the score
+  static constexpr double      ROTATION_MARGIN      = 0.25;   ///< Required relative improvement
+  static constexpr std::size_t MAX_WARMUP_CYCLES    = 5;
+  static constexpr std::size_t COOLDOWN_CYCLES      = 10;
+
+  // Construction / Destruction
+  ConnectionPool(std::size_t target_peers, std::size_t max_warming_peers);
+  ConnectionPool(ConnectionPool const &) = delete;
+  ConnectionPool(ConnectionPool &&)      = delete;
+  ~ConnectionPool()                      = default;
+
+  AddressSet Update(Candidates const &candidates);
+
+  std::size_t NumWarming() const;
+
+  static double Score(Candidate const &candidate);
+
+  // Operators
+  ConnectionPool &operator=(ConnectionPool const &) = delete;
+  ConnectionPool &operator=(ConnectionPool &&) = delete;
+
+private:
+  using CycleMap = std::unordered_map<Address, std::size_t>;
+
+  void UpdateWarming(Candidates const &candidates);
+
+  std::size_t const target_peers_;       ///< The number of peers to maintain
+  std::size_t const max_warming_peers_;  ///< The number of replacements warmed at the same time
+  CycleMap          warming_;            ///< The replacements being connected (and their age)
+  CycleMap          cooldown_;           ///< The candidates excluded from selection (and the
+                                         ///< remaining cycles)
+};
+
+}  // namespace p2p
+}  // namespace fetch
@@ -23,12 +23,22 @@
 #include "network/uri.hpp"
 
 #include <chrono>
+#include <functional>
+#include <memory>
 #include <unordered_map>
 #include <utility>
 
 namespace fetch {
 namespace p2p {
 
+/**
+ * The cache of the URIs of the peers known to this node. Lookups are made without taking the lock,
+ * from a published copy of the cache which is replaced after each update.
+ *
+ * Resolved entries are refreshed once they reach REFRESH_INTERVAL, but remain in use until then.
+ * Addresses which could not be resolved are not resolved again until RETRY_INTERVAL has elapsed,
+ * so that peer churn does not result in a storm of resolution requests.
+ */
 class IdentityCache
 {
 public:
@@ -51,26 +61,33 @@ public:
     {}
   };
 
-  using Cache = std::unordered_map<Address, CacheElement>;
+  using Cache    = std::unordered_map<Address, CacheElement>;
+  using Failures = std::unordered_map<Address, Timepoint>;  ///< address to the time of the retry
+
+  static constexpr std::chrono::seconds REFRESH_INTERVAL{300};
+  static constexpr std::chrono::seconds RETRY_INTERVAL{30};
 
   // Construction / Destruction
-  IdentityCache()                      = default;
+  IdentityCache();
   IdentityCache(IdentityCache const &) = delete;
   IdentityCache(IdentityCache &&)      = delete;
   ~IdentityCache()                     = default;
 
-  // Queries and Updates
-  void       Update(ConnectionMap const &connections);
-  void       Update(Address const &address, Uri const &uri);
+  // Queries
   bool       Lookup(Address const &address, Uri &uri) const;
-  AddressSet FilterOutUnresolved(AddressSet const &addresses);
+  AddressSet FilterOutUnresolved(AddressSet const &addresses) const;
+  bool       NeedsResolution(Address const &address, Timepoint const &now = Clock::now()) const;
+
+  // Updates
+  void Update(ConnectionMap const &connections);
+  void Update(Address const &address, Uri const &uri);
+  void MarkUnresolved(Address const &address, Timepoint const &now = Clock::now());
 
   void VisitCache(std::function<void(Cache const &)> cb) const
   {
     if (cb)
     {
-      FETCH_LOCK(lock_);
-      cb(cache_);
+      cb(LoadSnapshot()->cache);
     }
   }
 
@@ -79,11 +96,23 @@ public:
   IdentityCache &operator=(IdentityCache &&) = delete;
 
 private:
-  void UpdateInternal(Address const &address, Uri const &uri);
+  struct Snapshot
+  {
+    Cache    cache{};
+    Failures failures{};
+  };
+
+  using SnapshotPtr = std::shared_ptr<Snapshot const>;
+
+  void        UpdateInternal(Address const &address, Uri const &uri);
+  void        Publish();
+  SnapshotPtr LoadSnapshot() const;
 
   mutable Mutex lock_{__LINE__, __FILE__};
-  Cache         cache_;
+  Snapshot      state_;     ///< The writer's copy of the cache (Protected by lock_)
+  SnapshotPtr   snapshot_;  ///< The published copy of the cache, read without the lock through
+                            ///< std::atomic_load and never modified
 };
 
 }  // namespace p2p
-}  // namespace fetch
\ No newline at end of file
+}  // namespace fetch
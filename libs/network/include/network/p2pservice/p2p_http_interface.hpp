@@ -84,6 +84,10 @@ public:
         [this](http::ViewParameters const &params, http::HTTPRequest const &request) {
           return GetBacklogStatus(params, request);
         });
+    Get("/api/status/states/timing",
+        [this](http::ViewParameters const &params, http::HTTPRequest const &request) {
+          return GetStateMachineTimings(params, request);
+        });
     Get("/api/status/states",
         [this](http::ViewParameters const &params, http::HTTPRequest const &request) {
           return GetStateMachineStatus(params, request);
@@ -221,6 +225,40 @@ private:
     return http::CreateJsonResponse(data);
   }
 
+  http::HTTPResponse GetStateMachineTimings(http::ViewParameters const & /*params*/,
+                                            http::HTTPRequest const & /*request*/)
+  {
+    variant::Variant data = variant::Variant::Object();
+
+    for (auto const &sm : state_machines_)
+    {
+      auto instance = sm.lock();
+      if (instance)
+      {
+        auto const timings = instance->GetStateTimings();
+
+        Variant states = Variant::Array(timings.size());
+        for (std::size_t i = 0; i < timings.size(); ++i)
+        {
+          auto const &timing = timings[i];
+
+          Variant &state            = states[i];
+          state                     = Variant::Object();
+          state["name"]             = timing.name;
+          state["code"]             = timing.code;
+          state["entries"]          = timing.entries;
+          state["executions"]       = timing.executions;
+          state["executionSeconds"] = timing.execution_seconds;
+          state["residenceSeconds"] = timing.residence_seconds;
+        }
+
+        data[instance->GetName()] = states;
+      }
+    }
+
+    return http::CreateJsonResponse(data);
+  }
+
   Variant GenerateBlockList(bool include_transactions, std::size_t length)
   {
     using byte_array::ToBase64;
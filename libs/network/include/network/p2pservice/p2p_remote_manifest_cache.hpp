@@ -23,6 +23,8 @@
 #include "network/muddle/packet.hpp"
 #include "network/p2pservice/manifest.hpp"
 
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -31,15 +33,21 @@ namespace p2p {
 
 /**
  * This holds a mapping of remote-host to manifest. It also includes a validity time so that this
- * information can be updated periodically.
+ * information can be updated periodically. A manifest remains available while its update is
+ * requested, and the peers which fail to provide a manifest are only asked again once their retry
+ * is due.
+ *
+ * Queries are made without taking the lock, from a published copy of the cache which is replaced
+ * after each update.
  */
 class ManifestCache
 {
 public:
   struct CacheEntry
   {
-    network::FutureTimepoint timepoint;
+    network::FutureTimepoint timepoint;  ///< The time of the next update (or retry)
     network::Manifest        manifest;
+    bool                     valid{false};  ///< false if no manifest has been received
   };
 
   using Clock      = network::FutureTimepoint::Clock;
@@ -65,13 +73,20 @@ public:
   // Updates
   void ProvideUpdate(Address const &address, network::Manifest const &manifest,
                      std::size_t valid_for);
+  void ProvideFailure(Address const &address, std::size_t retry_after);
 
   // Operators
   ManifestCache &operator=(ManifestCache const &) = delete;
   ManifestCache &operator=(ManifestCache &&) = delete;
 
 private:
-  Cache         cache_;
+  using CachePtr = std::shared_ptr<Cache const>;
+
+  void     Publish();
+  CachePtr LoadCache() const;
+
+  Cache         cache_;  ///< The writer's copy of the cache (Protected by mutex_)
+  CachePtr      published_{std::make_shared<Cache const>()};  ///< Read through std::atomic_load
   mutable Mutex mutex_{__LINE__, __FILE__};
 };
 
@@ -86,15 +101,12 @@ inline bool ManifestCache::Get(Address const &address, Manifest &manifest) const
 {
   bool success = false;
 
+  auto const cache = LoadCache();
+  auto       iter  = cache->find(address);
+  if ((iter != cache->end()) && iter->second.valid)
   {
-    FETCH_LOCK(mutex_);
-
-    auto iter = cache_.find(address);
-    if (iter != cache_.end())
-    {
-      manifest = iter->second.manifest;
-      success  = true;
-    }
+    manifest = iter->second.manifest;
+    success  = true;
   }
 
   return success;
@@ -110,14 +122,11 @@ inline ManifestCache::AddressSet ManifestCache::GetUpdatesNeeded() const
   Timepoint const now = Clock::now();
   AddressSet      addresses;
 
+  for (auto const &entry : *LoadCache())
   {
-    FETCH_LOCK(mutex_);
-    for (auto const &entry : cache_)
+    if (entry.second.timepoint.IsDue(now))
     {
-      if (entry.second.timepoint.IsDue(now))
-      {
-        addresses.insert(entry.first);
-      }
+      addresses.insert(entry.first);
     }
   }
 
@@ -135,16 +144,13 @@ inline ManifestCache::AddressSet ManifestCache::GetUpdatesNeeded(AddressSet cons
   Timepoint const now = Clock::now();
   AddressSet      result;
 
+  auto const cache = LoadCache();
+  for (auto const &address : addresses)
   {
-    FETCH_LOCK(mutex_);
-
-    for (auto const &address : addresses)
+    auto const it = cache->find(address);
+    if ((it == cache->end()) || (it->second.timepoint.IsDue(now)))
     {
-      auto const it = cache_.find(address);
-      if ((it == cache_.end()) || (it->second.timepoint.IsDue(now)))
-      {
-        result.insert(address);
-      }
+      result.insert(address);
     }
   }
 
@@ -166,7 +172,39 @@ inline void ManifestCache::ProvideUpdate(Address const &address, network::Manife
   CacheEntry &entry = cache_[address];
 
   entry.manifest = manifest;
+  entry.valid    = true;
   entry.timepoint.SetSeconds(valid_for);
+
+  Publish();
+}
+
+/**
+ * Record that a peer failed to provide its manifest. Any previous manifest of the peer is kept.
+ *
+ * @param address The address of the peer
+ * @param retry_after The time in seconds before the manifest is requested again
+ */
+inline void ManifestCache::ProvideFailure(Address const &address, std::size_t retry_after)
+{
+  FETCH_LOCK(mutex_);
+
+  cache_[address].timepoint.SetSeconds(retry_after);
+
+  Publish();
+}
+
+/**
+ * Internal: Replace the published cache with a copy of the writer's cache. Must be called with the
+ * lock held.
+ */
+inline void ManifestCache::Publish()
+{
+  std::atomic_store(&published_, CachePtr{std::make_shared<Cache const>(cache_)});
+}
+
+inline ManifestCache::CachePtr ManifestCache::LoadCache() const
+{
+  return std::atomic_load(&published_);
 }
 
 }  // namespace p2p
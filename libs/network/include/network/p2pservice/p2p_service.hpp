@@ -24,6 +24,7 @@
 #include "network/muddle/muddle.hpp"
 #include "network/muddle/rpc/client.hpp"
 #include "network/muddle/rpc/server.hpp"
+#include "network/p2pservice/connection_pool.hpp"
 #include "network/p2pservice/identity_cache.hpp"
 #include "network/p2pservice/manifest.hpp"
 #include "network/p2pservice/p2p_lane_management.hpp"
@@ -134,6 +135,8 @@ private:
   void PeerDiscovery(AddressSet const &active_addresses);
   void RenewDesiredPeers(AddressSet const &active_addresses);
   void UpdateMuddlePeers(AddressSet const &active_addresses);
+  void RequestResolution(Address const &address, AddressSet const &active_addresses);
+  void ProcessResolutions();
   void UpdateManifests(AddressSet const &active_addresses);
   /// @}
 
@@ -170,6 +173,7 @@ private:
   AddressSet desired_peers_;  ///< The desired set of addresses that we want to have connections to
   AddressSet blacklisted_peers_;  ///< The set of addresses that we will not have connections to
   ManifestCache manifest_cache_;  ///< The cache of manifests of the peers to which we are connected
+  ConnectionPool connection_pool_;  ///< The selection of the best (trusted, low latency) peers
   P2PManagedLocalServices local_services_;
   ///@}
 
@@ -25,12 +25,18 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <ctime>
 #include <iostream>
+#include <iterator>
 #include <map>
+#include <mutex>
 #include <random>
+#include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace fetch {
@@ -44,6 +50,14 @@ inline math::statistics::Gaussian<double> const &LookupReferencePlayer(TrustQual
   return reference_players_.at(static_cast<std::size_t>(quality));
 }
 
+/**
+ * Bayesian ranking of the trust of peers. Each feedback event updates the rating of its peer and
+ * its position in the ordering of the peers, rather than resorting all the peers.
+ *
+ * Feedback arrives from the muddle threads for every block and transaction received. It is queued,
+ * and whichever thread finds no other thread applying the queue applies all the feedback queued so
+ * far in one batch, so that the other threads do not wait on the ratings.
+ */
 template <typename IDENTITY>
 class P2PTrustBayRank : public P2PTrustInterface<IDENTITY>
 {
@@ -61,10 +75,19 @@ protected:
     }
     bool scored = false;
   };
-  using TrustStore   = std::vector<PeerTrustRating>;
-  using RankingStore = std::unordered_map<IDENTITY, size_t>;
-  using Mutex        = mutex::Mutex;
-  using PeerTrusts   = typename P2PTrustInterface<IDENTITY>::PeerTrusts;
+  struct Feedback
+  {
+    IDENTITY     peer_identity;
+    TrustSubject subject;
+    TrustQuality quality;
+  };
+  using TrustStore    = std::vector<PeerTrustRating>;
+  using RankingStore  = std::unordered_map<IDENTITY, size_t>;
+  using RankKey       = std::pair<double, IDENTITY>;  ///< score, then identity to break ties
+  using OrderingStore = std::set<RankKey>;
+  using FeedbackQueue = std::vector<Feedback>;
+  using Mutex         = mutex::Mutex;
+  using PeerTrusts    = typename P2PTrustInterface<IDENTITY>::PeerTrusts;
 
 public:
   using ConstByteArray = byte_array::ConstByteArray;
@@ -87,41 +110,12 @@ public:
   void AddFeedback(IDENTITY const &peer_ident, ConstByteArray const & /*object_ident*/,
                    TrustSubject subject, TrustQuality quality) override
   {
-    FETCH_UNUSED(subject);
-    FETCH_LOCK(mutex_);
-
-    auto ranking = ranking_store_.find(peer_ident);
-
-    size_t pos;
-    if (ranking == ranking_store_.end())
-    {
-      PeerTrustRating new_record{peer_ident, Gaussian::ClassicForm(100., 100 / 6.), 0, false};
-      pos = trust_store_.size();
-      trust_store_.push_back(new_record);
-    }
-    else
-    {
-      pos = ranking->second;
-    }
-
-    FETCH_LOG_DEBUG(LOGGING_NAME, "Feedback: ", byte_array::ToBase64(peer_ident),
-                    " subj=", ToString(subject), " qual=", ToString(quality));
-    if (quality == TrustQuality::NEW_PEER)
     {
-      trust_store_[pos].update_score();
-      dirty_ = true;
-      SortIfNeeded();
-      return;  // we're introducing this element, not rating it.
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      queue_.push_back(Feedback{peer_ident, subject, quality});
     }
 
-    Gaussian const &reference_player = LookupReferencePlayer(quality);
-    bool honest = quality == TrustQuality::NEW_INFORMATION || quality == TrustQuality::DUPLICATE;
-    trust_store_[pos].scored = true;
-    updateGaussian(honest, trust_store_[pos].g, reference_player, 100 / 12., 1 / 6., 0.2);
-    trust_store_[pos].update_score();
-
-    dirty_ = true;
-    SortIfNeeded();
+    ApplyQueuedFeedback();
   }
 
   bool IsPeerKnown(IDENTITY const &peer_ident) const override
@@ -132,7 +126,13 @@ public:
 
   IdentitySet GetRandomPeers(std::size_t maximum_count, double minimum_trust) const override
   {
-    if (maximum_count > trust_store_.size())
+    std::size_t num_peers{0};
+    {
+      FETCH_LOCK(mutex_);
+      num_peers = trust_store_.size();
+    }
+
+    if (maximum_count > num_peers)
     {
       return GetBestPeers(maximum_count);
     }
@@ -143,7 +143,7 @@ public:
     size_t                                max_trial = maximum_count * 1000;
     std::random_device                    rd;
     std::mt19937                          g(rd());
-    std::uniform_int_distribution<size_t> distribution(0, trust_store_.size() - 1);
+    std::uniform_int_distribution<size_t> distribution(0, num_peers - 1);
 
     {
       FETCH_LOCK(mutex_);
@@ -176,20 +176,26 @@ public:
     {
       FETCH_LOCK(mutex_);
 
-      for (std::size_t pos = 0, end = std::min(maximum, trust_store_.size()); pos < end; ++pos)
+      // walk down from the most trusted peer
+      for (auto it = ordering_.rbegin(); (it != ordering_.rend()) && (result.size() < maximum);
+           ++it)
       {
-        if (trust_store_[pos].score < threshold_)
+        if (it->first < threshold_)
         {
           break;
         }
 
-        result.insert(trust_store_[pos].peer_identity);
+        result.insert(it->second);
       }
     }
 
     return result;
   }
 
+  /**
+   * Get the rank of a peer, counted from the least trusted peer. Linear in the rank, this is not
+   * used on any of the feedback paths.
+   */
   std::size_t GetRankOfPeer(IDENTITY const &peer_ident) const override
   {
     FETCH_LOCK(mutex_);
@@ -199,24 +205,27 @@ public:
     {
       return trust_store_.size() + 1;
     }
-    else
-    {
-      return ranking_it->second;
-    }
+
+    auto const &record = trust_store_[ranking_it->second];
+    return static_cast<std::size_t>(std::distance(
+        ordering_.begin(), ordering_.find(RankKey{record.score, record.peer_identity})));
   }
 
   PeerTrusts GetPeersAndTrusts() const override
   {
     FETCH_LOCK(mutex_);
     PeerTrusts trust_list;
+    trust_list.reserve(ordering_.size());
 
-    for (std::size_t pos = 0, end = trust_store_.size(); pos < end; ++pos)
+    for (auto const &key : ordering_)
     {
+      auto const &record = trust_store_[ranking_store_.at(key.second)];
+
       PeerTrust pt;
-      pt.address        = trust_store_[pos].peer_identity;
+      pt.address        = record.peer_identity;
       pt.name           = std::string(byte_array::ToBase64(pt.address));
-      pt.trust          = trust_store_[pos].score;
-      pt.has_transacted = trust_store_[pos].scored;
+      pt.trust          = record.score;
+      pt.has_transacted = record.scored;
       trust_list.push_back(pt);
     }
 
@@ -249,11 +258,10 @@ public:
   virtual void Debug() const override
   {
     FETCH_LOCK(mutex_);
-    for (std::size_t pos = 0; pos < trust_store_.size(); ++pos)
+    for (auto const &key : ordering_)
     {
-      FETCH_LOG_WARN(LOGGING_NAME, "trust_store_ ",
-                     byte_array::ToBase64(trust_store_[pos].peer_identity), " => ",
-                     trust_store_[pos].score);
+      FETCH_LOG_WARN(LOGGING_NAME, "trust_store_ ", byte_array::ToBase64(key.second), " => ",
+                     key.first);
     }
   }
 
@@ -304,39 +312,100 @@ protected:
     }
   }
 
-  void SortIfNeeded()
+  /**
+   * Apply the queued feedback, unless another thread is already doing so. Feedback queued while
+   * the queue is being applied is picked up by the thread applying it.
+   */
+  void ApplyQueuedFeedback()
   {
-    if (!dirty_)
+    while (!applying_.exchange(true))
     {
-      return;
+      {
+        FETCH_LOCK(mutex_);
+
+        FeedbackQueue batch;
+        for (;;)
+        {
+          {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            std::swap(batch, queue_);
+          }
+
+          if (batch.empty())
+          {
+            break;
+          }
+
+          for (auto const &feedback : batch)
+          {
+            ApplyFeedback(feedback);
+          }
+
+          batch.clear();
+        }
+      }
+
+      applying_ = false;
+
+      // feedback may have been queued after the last check, but before the flag was cleared
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      if (queue_.empty())
+      {
+        break;
+      }
     }
-    dirty_ = false;
-
-    std::sort(trust_store_.begin(), trust_store_.end(),
-              [](const PeerTrustRating &a, const PeerTrustRating &b) {
-                if (a.score < b.score)
-                {
-                  return true;
-                }
-                if (a.score > b.score)
-                {
-                  return false;
-                }
-                return a.peer_identity < b.peer_identity;
-              });
-
-    ranking_store_.clear();
-    for (std::size_t pos = 0; pos < trust_store_.size(); ++pos)
+  }
+
+  /**
+   * Update the rating of a peer, and its position in the ordering. Must be called with the lock
+   * held.
+   */
+  void ApplyFeedback(Feedback const &feedback)
+  {
+    FETCH_LOG_DEBUG(LOGGING_NAME, "Feedback: ", byte_array::ToBase64(feedback.peer_identity),
+                    " subj=", ToString(feedback.subject), " qual=", ToString(feedback.quality));
+
+    auto const ranking = ranking_store_.find(feedback.peer_identity);
+
+    std::size_t pos;
+    if (ranking == ranking_store_.end())
+    {
+      pos = trust_store_.size();
+      trust_store_.push_back(PeerTrustRating{feedback.peer_identity,
+                                             Gaussian::ClassicForm(100., 100 / 6.), 0, false});
+      ranking_store_.emplace(feedback.peer_identity, pos);
+    }
+    else
+    {
+      pos = ranking->second;
+      ordering_.erase(RankKey{trust_store_[pos].score, feedback.peer_identity});
+    }
+
+    PeerTrustRating &record = trust_store_[pos];
+
+    // new peers are only introduced, not rated
+    if (feedback.quality != TrustQuality::NEW_PEER)
     {
-      ranking_store_[trust_store_[pos].peer_identity] = pos;
+      bool const honest = (feedback.quality == TrustQuality::NEW_INFORMATION) ||
+                          (feedback.quality == TrustQuality::DUPLICATE);
+
+      record.scored = true;
+      updateGaussian(honest, record.g, LookupReferencePlayer(feedback.quality), 100 / 12., 1 / 6.,
+                     0.2);
     }
+
+    record.update_score();
+    ordering_.emplace(record.score, record.peer_identity);
   }
 
 protected:
-  bool          dirty_ = false;
-  mutable Mutex mutex_{__LINE__, __FILE__};
-  TrustStore    trust_store_;
-  RankingStore  ranking_store_;
+  mutable Mutex     mutex_{__LINE__, __FILE__};
+  TrustStore        trust_store_;    ///< The rating of each peer, in the order they became known
+  RankingStore      ranking_store_;  ///< The index of each peer in the trust store
+  OrderingStore     ordering_;       ///< The peers in order of increasing score
+  std::mutex        queue_mutex_;
+  FeedbackQueue     queue_;  ///< The feedback yet to be applied (Protected by queue_mutex_)
+  std::atomic<bool> applying_{false};  ///< Set while a thread is applying the queued feedback
 };
 
 }  // namespace p2p
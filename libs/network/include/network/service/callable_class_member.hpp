@@ -56,12 +56,8 @@ struct Invoke
   static void MemberFunction(serializer_type &result, class_type &cls, member_function_pointer &m,
                              used_args &... args)
   {
-    auto                                      ret = (cls.*m)(args...);
-    serializers::SizeCounter<serializer_type> counter;
-    counter << ret;
-
-    result.Reserve(counter.size());
-    result << ret;
+    auto ret = (cls.*m)(args...);
+    result.Append(ret);
   };
 };
 
@@ -314,11 +310,7 @@ public:
     LOG_STACK_TRACE_POINT;
 
     auto ret = ((*class_).*function_)();
-
-    serializers::SizeCounter<serializer_type> counter;
-    counter << ret;
-    result.Reserve(counter.size());
-    result << ret;
+    result.Append(ret);
   }
 
   void operator()(serializer_type &result, CallableArgumentList const & /*additional_args*/,
@@ -326,11 +318,8 @@ public:
   {
     LOG_STACK_TRACE_POINT;
 
-    auto                                      ret = ((*class_).*function_)();
-    serializers::SizeCounter<serializer_type> counter;
-    counter << ret;
-    result.Reserve(counter.size());
-    result << ret;
+    auto ret = ((*class_).*function_)();
+    result.Append(ret);
   }
 
 private:
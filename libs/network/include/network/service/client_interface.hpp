@@ -62,6 +62,7 @@ public:
     FETCH_LOG_DEBUG(LOGGING_NAME, "Service Client Calling ", protocol, ":", function);
 
     Promise prom = MakePromise(protocol, function);
+    RecordCall(*prom);
 
     serializer_type params;
 
@@ -152,6 +153,7 @@ private:
     AbstractCallable *    callback = nullptr;
   };
 
+  void    RecordCall(details::PromiseImplementation &promise);
   void    AddPromise(Promise const &promise);
   Promise LookupPromise(PromiseCounter id);
   Promise ExtractPromise(PromiseCounter id);
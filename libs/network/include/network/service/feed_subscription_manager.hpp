@@ -26,7 +26,7 @@ class FeedSubscriptionManager;
 
 #include "core/mutex.hpp"
 #include "network/details/thread_pool.hpp"
-#include "network/generics/work_items_queue.hpp"
+#include "network/generics/mpmc_work_items_queue.hpp"
 #include "network/message.hpp"
 #include "network/service/abstract_publication_feed.hpp"
 #include "network/service/message_types.hpp"
@@ -59,10 +59,12 @@ public:
   using service_type           = fetch::service::ServiceServerInterface;
   using connection_handle_type = uint64_t;
   using publishing_workload_type =
-      std::tuple<service_type *, connection_handle_type, network::message_type const>;
+      std::tuple<service_type *, connection_handle_type, network::message_type>;
 
   static constexpr char const *LOGGING_NAME = "FeedSubscriptionManager";
 
+  static constexpr std::size_t MAX_PUBLISHING_BATCH = 16;
+
   /* A feed that services can subscribe to.
    * @feed is the feed number defined in the protocol.
    * @publisher is an implementation class that subclasses
@@ -81,6 +83,12 @@ public:
     , publisher_(publisher)
   {
     workers_ = network::MakeThreadPool(3, "FeedSubscriptionManager");
+    workers_->Start();
+  }
+
+  ~FeedSubscriptionManager()
+  {
+    workers_->Stop();
   }
 
   /* Attaches a feed to a given service.
@@ -172,14 +180,18 @@ private:
     subscription_handler_type id;
   };
 
+  static network::message_type EncodeNotification(feed_handler_type                 feed,
+                                                  subscription_handler_type         id,
+                                                  byte_array::ConstByteArray const &msg);
+
   std::vector<ClientSubscription> subscribers_;
   fetch::mutex::Mutex             subscribe_mutex_;
   feed_handler_type               feed_;
 
   fetch::service::AbstractPublicationFeed *publisher_ = nullptr;
 
-  generics::WorkItemsQueue<publishing_workload_type> publishing_workload_;
-  network::ThreadPool                                workers_;
+  generics::MPMCWorkItemsQueue<publishing_workload_type> publishing_workload_;
+  network::ThreadPool                                    workers_;
 };
 }  // namespace service
 }  // namespace fetch
@@ -21,6 +21,7 @@
 #include "core/logger.hpp"
 #include "core/mutex.hpp"
 #include "core/serializers/exception.hpp"
+#include "metrics/rpc_metrics.hpp"
 #include "network/service/types.hpp"
 
 #include <atomic>
@@ -60,6 +61,7 @@ public:
   using Callback              = std::function<void()>;
   using Clock                 = std::chrono::high_resolution_clock;
   using Timepoint             = Clock::time_point;
+  using CallMetrics           = metrics::RpcCallMetrics;
 
   static constexpr char const *LOGGING_NAME = "Promise";
   static constexpr uint32_t    FOREVER      = std::numeric_limits<uint32_t>::max();
@@ -154,6 +156,18 @@ private:
 public:
   PromiseBuilder WithHandlers();
 
+  /**
+   * Attach the instruments of the RPC which this promise resolves, from this point the latency
+   * until resolution and any timeouts of waiters are recorded
+   *
+   * @param metrics The instruments of the RPC
+   */
+  void SetCallMetrics(CallMetrics &metrics)
+  {
+    call_metrics_ = &metrics;
+    call_issued_  = metrics::LatencyHistogram::Clock::now();
+  }
+
   /// @name Promise Results
   /// @{
   void Fulfill(ConstByteArray const &value)
@@ -240,6 +254,8 @@ private:
   using Mutex       = mutex::Mutex;
   using AtomicState = std::atomic<State>;
   using Condition   = std::condition_variable;
+  using Flag        = std::atomic<bool>;
+  using CallIssued  = metrics::LatencyHistogram::Timestamp;
 
   void UpdateState(State state);
   void DispatchCallbacks();
@@ -257,6 +273,10 @@ private:
   Callback       callback_completion_;
   std::string    name_;
 
+  CallMetrics *call_metrics_{nullptr};
+  CallIssued   call_issued_{};
+  mutable Flag timeout_recorded_{false};
+
 #define FETCH_PROMISE_CV
 #ifdef FETCH_PROMISE_CV
   mutable Mutex     notify_lock_{__LINE__, __FILE__};
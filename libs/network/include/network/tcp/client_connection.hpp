@@ -25,8 +25,11 @@
 #include "network/management/client_manager.hpp"
 #include "network/management/network_manager.hpp"
 #include "network/message.hpp"
+#include "network/tcp/receive_buffer_pool.hpp"
+#include "network/tcp/write_batch.hpp"
 
 #include "network/fetch_asio.hpp"
+#include <algorithm>
 #include <atomic>
 #include <utility>
 
@@ -119,6 +122,11 @@ public:
   }
 
   void Send(message_type const &msg) override
+  {
+    SendWithPriority(msg, MessagePriority::NORMAL);
+  }
+
+  void SendWithPriority(message_type const &msg, MessagePriority priority) override
   {
     if (shutting_down_)
     {
@@ -126,9 +134,16 @@ public:
       return;
     }
 
+    // bound the memory held by a slow peer
+    if (!ReserveSendCapacity(WriteBatch::HEADER_SIZE + msg.size(), priority))
+    {
+      FETCH_LOG_DEBUG(LOGGING_NAME, "Send queue full, dropping message of ", msg.size(), " bytes");
+      return;
+    }
+
     {
       std::lock_guard<mutex_type> lock(queue_mutex_);
-      write_queue_.push_back(msg);
+      write_queue_[static_cast<std::size_t>(priority)].push_back(msg);
     }
 
     std::weak_ptr<AbstractConnection> self   = shared_from_this();
@@ -188,7 +203,10 @@ private:
   // bool                  posted_close_ = false;
   std::weak_ptr<Strand> strand_;
 
-  message_queue_type write_queue_;
+  prioritised_message_queue_type write_queue_;
+  WriteBatch                     write_batch_;
+  ReceiveBufferPool              receive_buffers_;  ///< Only used by the (sequential) read path
+
   mutable mutex_type can_write_mutex_;
   bool               can_write_{true};
   mutable mutex_type queue_mutex_;
@@ -275,7 +293,7 @@ private:
       return;
     }
 
-    message.Resize(header_.content.length);
+    message = receive_buffers_.Allocate(header_.content.length);
     auto self(shared_from_this());
     auto cb = [this, socket_ptr, self, message, strong_strand](std::error_code ec,
                                                                std::size_t     len) {
@@ -303,21 +321,6 @@ private:
     asio::async_read(*socket_ptr, asio::buffer(message.pointer(), message.size()), cb);
   }
 
-  static void SetHeader(byte_array::ByteArray &header, uint64_t bufSize)
-  {
-    header.Resize(16);
-
-    for (std::size_t i = 0; i < 8; ++i)
-    {
-      header[i] = uint8_t((networkMagic_ >> i * 8) & 0xff);
-    }
-
-    for (std::size_t i = 0; i < 8; ++i)
-    {
-      header[i + 8] = uint8_t((bufSize >> i * 8) & 0xff);
-    }
-  }
-
   // Always executed in a run(), in a strand
   void WriteNext(shared_self_type selfLock)
   {
@@ -335,30 +338,30 @@ private:
       }
     }
 
-    message_type buffer;
+    // coalesce the pending messages into a single write. The batch is only modified by the
+    // writer, which holds can_write_ until the write has completed
     {
       std::lock_guard<mutex_type> lock(queue_mutex_);
-      if (write_queue_.empty())
+      bool const queue_empty =
+          std::all_of(write_queue_.begin(), write_queue_.end(),
+                      [](message_queue_type const &queue) { return queue.empty(); });
+      if (queue_empty)
       {
         std::lock_guard<mutex_type> lock(can_write_mutex_);
         can_write_ = true;
         return;
       }
-      buffer = write_queue_.front();
-      write_queue_.pop_front();
+      write_batch_.Fill(write_queue_);
     }
 
-    byte_array::ByteArray header;
-    SetHeader(header, buffer.size());
-
-    std::vector<asio::const_buffer> buffers{asio::buffer(header.pointer(), header.size()),
-                                            asio::buffer(buffer.pointer(), buffer.size())};
-
     auto socket = socket_.lock();
 
-    auto cb = [this, selfLock, socket, buffer, header](std::error_code ec, std::size_t len) {
+    auto cb = [this, selfLock, socket](std::error_code ec, std::size_t len) {
       FETCH_UNUSED(len);
 
+      ReleaseSendCapacity(write_batch_.byte_count());
+      write_batch_.Clear();
+
       {
         std::lock_guard<mutex_type> lock(can_write_mutex_);
         can_write_ = true;
@@ -385,11 +388,12 @@ private:
     if (socket && strand)
     {
       assert(strand->running_in_this_thread());
-      asio::async_write(*socket, buffers, strand->wrap(cb));
+      asio::async_write(*socket, write_batch_.buffers(), strand->wrap(cb));
     }
     else
     {
       FETCH_LOG_ERROR(LOGGING_NAME, "Failed to lock socket in WriteNext!");
+      write_batch_.Clear();
       SignalLeave();
     }
   }
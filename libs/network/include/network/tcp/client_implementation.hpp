@@ -25,11 +25,14 @@
 #include "core/serializers/byte_array_buffer.hpp"
 #include "network/management/network_manager.hpp"
 #include "network/message.hpp"
+#include "network/tcp/receive_buffer_pool.hpp"
+#include "network/tcp/write_batch.hpp"
 
 #include "core/mutex.hpp"
 #include "network/fetch_asio.hpp"
 #include "network/management/abstract_connection.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <mutex>
@@ -179,6 +182,11 @@ public:
   }
 
   void Send(message_type const &msg) override
+  {
+    SendWithPriority(msg, MessagePriority::NORMAL);
+  }
+
+  void SendWithPriority(message_type const &msg, MessagePriority priority) override
   {
     if (!connected_)
     {
@@ -188,9 +196,16 @@ public:
     //    std::cout << "SENDING: " << this->Address() << ":" << this->port() <<
     //    std::endl;
 
+    // bound the memory held by a slow peer
+    if (!ReserveSendCapacity(WriteBatch::HEADER_SIZE + msg.size(), priority))
+    {
+      FETCH_LOG_DEBUG(LOGGING_NAME, "Send queue full, dropping message of ", msg.size(), " bytes");
+      return;
+    }
+
     {
       std::lock_guard<mutex_type> lock(queue_mutex_);
-      write_queue_.push_back(msg);
+      write_queue_[static_cast<std::size_t>(priority)].push_back(msg);
     }
 
     self_type                  self   = shared_from_this();
@@ -249,7 +264,10 @@ private:
   std::weak_ptr<socket_type> socket_;
   std::weak_ptr<strand_type> strand_;
 
-  message_queue_type write_queue_;
+  prioritised_message_queue_type write_queue_;
+  WriteBatch                     write_batch_;
+  ReceiveBufferPool              receive_buffers_;  ///< Only used by the (sequential) read path
+
   mutable mutex_type queue_mutex_;
   mutable mutex_type io_creation_mutex_;
 
@@ -336,8 +354,7 @@ private:
       return;
     }
 
-    byte_array::ByteArray message;
-    message.Resize(size);
+    byte_array::ByteArray message = receive_buffers_.Allocate(size);
 
     self_type self   = shared_from_this();
     auto      socket = socket_.lock();
@@ -406,30 +423,30 @@ private:
       }
     }
 
-    message_type buffer;
+    // coalesce the pending messages into a single write. The batch is only modified by the
+    // writer, which holds can_write_ until the write has completed
     {
       std::lock_guard<mutex_type> lock(queue_mutex_);
-      if (write_queue_.empty())
+      bool const queue_empty =
+          std::all_of(write_queue_.begin(), write_queue_.end(),
+                      [](message_queue_type const &queue) { return queue.empty(); });
+      if (queue_empty)
       {
         std::lock_guard<mutex_type> lock(can_write_mutex_);
         can_write_ = true;
         return;
       }
-      buffer = write_queue_.front();
-      write_queue_.pop_front();
+      write_batch_.Fill(write_queue_);
     }
 
-    byte_array::ByteArray header;
-    SetHeader(header, buffer.size());
-
-    std::vector<asio::const_buffer> buffers{asio::buffer(header.pointer(), header.size()),
-                                            asio::buffer(buffer.pointer(), buffer.size())};
-
     auto socket = socket_.lock();
 
-    auto cb = [this, selfLock, socket, buffer, header](std::error_code ec, std::size_t len) {
+    auto cb = [this, selfLock, socket](std::error_code ec, std::size_t len) {
       FETCH_UNUSED(len);
 
+      ReleaseSendCapacity(write_batch_.byte_count());
+      write_batch_.Clear();
+
       {
         std::lock_guard<mutex_type> lock(can_write_mutex_);
         can_write_ = true;
@@ -456,11 +473,12 @@ private:
     if (socket && strand)
     {
       assert(strand->running_in_this_thread());
-      asio::async_write(*socket, buffers, strand->wrap(cb));
+      asio::async_write(*socket, write_batch_.buffers(), strand->wrap(cb));
     }
     else
     {
       FETCH_LOG_ERROR(LOGGING_NAME, "Failed to lock socket in WriteNext!");
+      write_batch_.Clear();
       SignalLeave();
     }
   }
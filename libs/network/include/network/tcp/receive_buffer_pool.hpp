@@ -0,0 +1,84 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "network/message.hpp"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace fetch {
+namespace network {
+
+/**
+ * A pool of receive buffers for a single connection.
+ *
+ * Buffers are grouped into size classes which cover the common RPC message sizes (256 bytes up to
+ * 64 KiB). The pool keeps a reference to each of its buffers, a buffer becomes available again as
+ * soon as the last message referring to it is dropped, wherever that happens. Messages larger than
+ * the biggest size class, or requested while all the buffers of their class are in use, are
+ * allocated normally.
+ *
+ * Allocate must only be called by one thread at a time, which is the case for the (sequential)
+ * read path of a connection. The messages can be released by any thread.
+ */
+class ReceiveBufferPool
+{
+public:
+  static constexpr std::size_t NUM_SIZE_CLASSES          = 5;    ///< Each is 4 times the last
+  static constexpr std::size_t MIN_BUFFER_SIZE           = 256;  ///< Bytes
+  static constexpr std::size_t MAX_BUFFER_SIZE           = 64 * 1024;
+  static constexpr std::size_t DEFAULT_BUFFERS_PER_CLASS = 16;
+
+  static_assert((MIN_BUFFER_SIZE << (2 * (NUM_SIZE_CLASSES - 1))) == MAX_BUFFER_SIZE,
+                "Size classes must span the maximum buffer size");
+
+  // Construction / Destruction
+  explicit ReceiveBufferPool(std::size_t buffers_per_class = DEFAULT_BUFFERS_PER_CLASS);
+  ReceiveBufferPool(ReceiveBufferPool const &) = delete;
+  ReceiveBufferPool(ReceiveBufferPool &&)      = delete;
+  ~ReceiveBufferPool()                         = default;
+
+  message_type Allocate(std::size_t size);
+
+  std::size_t pooled_bytes() const;
+
+  // Operators
+  ReceiveBufferPool &operator=(ReceiveBufferPool const &) = delete;
+  ReceiveBufferPool &operator=(ReceiveBufferPool &&) = delete;
+
+private:
+  using SharedArray = byte_array::ConstByteArray::shared_array_type;
+
+  struct SizeClass
+  {
+    std::vector<SharedArray> buffers;
+    std::size_t              next{0};  ///< The buffer to be checked first
+  };
+
+  static std::size_t ClassIndex(std::size_t size);
+  static std::size_t ClassSize(std::size_t index);
+
+  std::size_t const                       buffers_per_class_;
+  std::array<SizeClass, NUM_SIZE_CLASSES> classes_;
+};
+
+}  // namespace network
+}  // namespace fetch
@@ -0,0 +1,113 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/byte_array.hpp"
+#include "network/fetch_asio.hpp"
+#include "network/message.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fetch {
+namespace network {
+
+/**
+ * A set of queued messages which are written to a socket with a single scatter-gather write.
+ *
+ * Each message is framed by the usual network header (magic followed by the payload length). The
+ * headers of the batch are kept in one contiguous buffer and the payloads are referenced in place,
+ * so building a batch does not copy any message data. A batch is bounded both by a byte budget and
+ * by a maximum number of messages, the latter caps the data in flight on a connection and keeps
+ * the number of buffers well below the system limit for a single vectored write.
+ *
+ * When filled from prioritised queues, higher priority messages are taken first.
+ *
+ * The batch must be kept alive and left unmodified until the write has completed.
+ */
+class WriteBatch
+{
+public:
+  using Buffers = std::vector<asio::const_buffer>;
+
+  static constexpr uint64_t    NETWORK_MAGIC        = 0xFE7C80A1FE7C80A1;
+  static constexpr std::size_t HEADER_SIZE          = 2 * sizeof(uint64_t);
+  static constexpr std::size_t DEFAULT_BYTE_BUDGET  = 256 * 1024;
+  static constexpr std::size_t DEFAULT_MAX_MESSAGES = 64;
+
+  // Construction / Destruction
+  explicit WriteBatch(std::size_t byte_budget  = DEFAULT_BYTE_BUDGET,
+                      std::size_t max_messages = DEFAULT_MAX_MESSAGES);
+  WriteBatch(WriteBatch const &) = delete;
+  WriteBatch(WriteBatch &&)      = delete;
+  ~WriteBatch()                  = default;
+
+  std::size_t Fill(message_queue_type &queue);
+  std::size_t Fill(prioritised_message_queue_type &queues);
+  void        Clear();
+
+  /// @name Accessors
+  /// @{
+  Buffers const &buffers() const;
+  std::size_t    message_count() const;
+  std::size_t    byte_count() const;
+  bool           empty() const;
+  /// @}
+
+  static void SetHeader(uint8_t *header, uint64_t length);
+
+  // Operators
+  WriteBatch &operator=(WriteBatch const &) = delete;
+  WriteBatch &operator=(WriteBatch &&) = delete;
+
+private:
+  bool Take(message_queue_type &queue);
+  void BuildBuffers();
+
+  std::size_t const byte_budget_;
+  std::size_t const max_messages_;
+
+  std::vector<message_type> messages_;
+  byte_array::ByteArray     headers_;
+  Buffers                   buffers_;
+  std::size_t               byte_count_{0};
+};
+
+inline WriteBatch::Buffers const &WriteBatch::buffers() const
+{
+  return buffers_;
+}
+
+inline std::size_t WriteBatch::message_count() const
+{
+  return messages_.size();
+}
+
+inline std::size_t WriteBatch::byte_count() const
+{
+  return byte_count_;
+}
+
+inline bool WriteBatch::empty() const
+{
+  return messages_.empty();
+}
+
+}  // namespace network
+}  // namespace fetch
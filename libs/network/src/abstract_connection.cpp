@@ -21,6 +21,8 @@
 namespace fetch {
 namespace network {
 
+constexpr std::size_t AbstractConnection::DEFAULT_HIGH_WATER_MARK;
+
 AbstractConnection::connection_handle_type AbstractConnection::global_handle_counter_ = 1;
 fetch::mutex::Mutex AbstractConnection::global_handle_mutex_(__LINE__, __FILE__);
 
@@ -0,0 +1,464 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "network/details/future_work_store.hpp"
+
+#include <algorithm>
+
+namespace fetch {
+namespace network {
+namespace details {
+namespace {
+
+constexpr uint32_t HANDLE_SHIFT = 32;
+
+/**
+ * Determine the index of the most significant bit set
+ *
+ * @param value The (non-zero) value to be inspected
+ * @return The index of the bit
+ */
+std::size_t MostSignificantBit(uint64_t value)
+{
+  return 63u - static_cast<std::size_t>(__builtin_clzll(value));
+}
+
+/**
+ * Determine the index of the least significant bit set
+ *
+ * @param value The (non-zero) value to be inspected
+ * @return The index of the bit
+ */
+std::size_t LeastSignificantBit(uint64_t value)
+{
+  return static_cast<std::size_t>(__builtin_ctzll(value));
+}
+
+}  // namespace
+
+constexpr FutureWorkStore::Handle FutureWorkStore::INVALID_HANDLE;
+constexpr std::size_t             FutureWorkStore::SLOT_BITS;
+constexpr std::size_t             FutureWorkStore::NUM_SLOTS;
+constexpr std::size_t             FutureWorkStore::NUM_LEVELS;
+constexpr FutureWorkStore::Tick   FutureWorkStore::SLOT_MASK;
+constexpr std::size_t             FutureWorkStore::READY_LIST;
+constexpr FutureWorkStore::Index  FutureWorkStore::NIL;
+
+FutureWorkStore::FutureWorkStore()
+{
+  heads_.fill(NIL);
+}
+
+FutureWorkStore::~FutureWorkStore()
+{
+  shutdown_ = true;
+  Clear();  // remove any pending things
+}
+
+/**
+ * Signal that the work queue should no longer accept and work items
+ */
+void FutureWorkStore::Abort()
+{
+  shutdown_ = true;
+}
+
+/**
+ * Remove all the pending work items from the store
+ */
+void FutureWorkStore::Clear()
+{
+  FETCH_LOCK(mutex_);
+
+  for (Index index = 0; index < nodes_.size(); ++index)
+  {
+    if (nodes_[index].in_use)
+    {
+      ReleaseNode(index);
+    }
+  }
+
+  heads_.fill(NIL);
+  occupied_.fill(0);
+  size_ = 0;
+}
+
+/**
+ * Add a work item with a specified delay in milliseconds
+ *
+ * @param item The work item to be added to the store
+ * @param milliseconds The delay in milliseconds before this work item is scheduled
+ * @return The handle with which the work item can be cancelled, INVALID_HANDLE if it was rejected
+ */
+FutureWorkStore::Handle FutureWorkStore::Post(WorkItem item, uint32_t milliseconds)
+{
+  // reject further work if we are in the process of shutting down
+  if (shutdown_)
+  {
+    return INVALID_HANDLE;
+  }
+
+  FETCH_LOCK(mutex_);
+
+  Index const index = AllocateNode();
+  Node &      node  = nodes_[index];
+
+  node.item = std::move(item);
+  node.due  = CurrentTick() + milliseconds;
+
+  Insert(index);
+  ++size_;
+
+  return (Handle{node.generation} << HANDLE_SHIFT) | Handle{index};
+}
+
+/**
+ * Cancel a work item which has not yet been dispatched
+ *
+ * @param handle The handle returned when the work item was posted
+ * @return true if the work item was removed, false if it was unknown or has already run
+ */
+bool FutureWorkStore::Cancel(Handle handle)
+{
+  auto const index      = static_cast<Index>(handle);
+  auto const generation = static_cast<uint32_t>(handle >> HANDLE_SHIFT);
+
+  FETCH_LOCK(mutex_);
+
+  if ((index >= nodes_.size()) || !nodes_[index].in_use ||
+      (nodes_[index].generation != generation))
+  {
+    return false;
+  }
+
+  Unlink(index);
+  ReleaseNode(index);
+  --size_;
+
+  return true;
+}
+
+/**
+ * Determine the time until the next event in the store
+ *
+ * The next event is either an item becoming due or the cascade of an upper level slot, in which
+ * case the result will only be a lower bound on the due time of any item.
+ *
+ * @return milliseconds::max() if the store is empty, milliseconds::zero() if an item is already
+ * due for execution, otherwise the time in milliseconds remaining
+ */
+std::chrono::milliseconds FutureWorkStore::TimeUntilNextItem()
+{
+  using std::chrono::milliseconds;
+
+  FETCH_LOCK(mutex_);
+
+  if (size_ == 0)
+  {
+    return milliseconds::max();
+  }
+
+  if (heads_[READY_LIST] != NIL)
+  {
+    return milliseconds::zero();
+  }
+
+  Tick const next = NextEventTick();
+  Tick const now  = CurrentTick();
+
+  if (next <= now)
+  {
+    return milliseconds::zero();
+  }
+
+  return milliseconds{static_cast<milliseconds::rep>(next - now)};
+}
+
+/**
+ * Get the number of work items pending in the store
+ *
+ * @return The number of items
+ */
+std::size_t FutureWorkStore::size() const
+{
+  FETCH_LOCK(mutex_);
+  return size_;
+}
+
+/**
+ * Get the current tick, the number of milliseconds since the creation of the store
+ *
+ * @return The current tick
+ */
+FutureWorkStore::Tick FutureWorkStore::CurrentTick() const
+{
+  using std::chrono::duration_cast;
+  using std::chrono::milliseconds;
+
+  return static_cast<Tick>(duration_cast<milliseconds>(Clock::now() - origin_).count());
+}
+
+/**
+ * Determine the next tick at which either a level 0 slot becomes due or an upper level slot needs
+ * to be cascaded. Since occupied slots are always ahead of the current position of their level,
+ * this is the first occupied slot in each of the levels.
+ *
+ * @return The tick of the next event, or the maximum tick if the wheel is empty
+ */
+FutureWorkStore::Tick FutureWorkStore::NextEventTick() const
+{
+  Tick next = std::numeric_limits<Tick>::max();
+
+  for (std::size_t level = 0; level < NUM_LEVELS; ++level)
+  {
+    if (occupied_[level] != 0)
+    {
+      std::size_t const shift       = level * SLOT_BITS;
+      std::size_t const upper_shift = shift + SLOT_BITS;
+      Tick const        slot        = LeastSignificantBit(occupied_[level]);
+
+      // the position of the current tick with this level and all below it cleared
+      Tick const base =
+          (upper_shift < 64u) ? ((current_ >> upper_shift) << upper_shift) : Tick{0};
+
+      next = std::min(next, base | (slot << shift));
+    }
+  }
+
+  return next;
+}
+
+/**
+ * Advance the wheel up to the specified tick, moving all the items which become due onto the
+ * ready list. Only the ticks where there are events are visited.
+ *
+ * @param now The tick to advance to
+ */
+void FutureWorkStore::Advance(Tick now)
+{
+  while (current_ < now)
+  {
+    Tick const next = NextEventTick();
+    if (next > now)
+    {
+      current_ = now;
+      break;
+    }
+
+    current_ = next;
+
+    // cascade the upper levels (from the top down) whose slot boundary has been reached
+    for (std::size_t level = NUM_LEVELS - 1; level > 0; --level)
+    {
+      std::size_t const shift = level * SLOT_BITS;
+      if ((current_ & ((Tick{1} << shift) - 1u)) == 0)
+      {
+        Cascade(level, static_cast<std::size_t>((current_ >> shift) & SLOT_MASK));
+      }
+    }
+
+    // all the items in the level 0 slot are now due
+    Cascade(0, static_cast<std::size_t>(current_ & SLOT_MASK));
+  }
+}
+
+/**
+ * Redistribute all the items in a slot, relative to the current tick
+ *
+ * @param level The level of the slot
+ * @param slot The index of the slot in the level
+ */
+void FutureWorkStore::Cascade(std::size_t level, std::size_t slot)
+{
+  uint64_t const bit = uint64_t{1} << slot;
+  if ((occupied_[level] & bit) == 0)
+  {
+    return;
+  }
+
+  std::size_t const list = (level * NUM_SLOTS) + slot;
+
+  Index index  = heads_[list];
+  heads_[list] = NIL;
+  occupied_[level] &= ~bit;
+
+  while (index != NIL)
+  {
+    Index const next = nodes_[index].next;
+    Insert(index);
+    index = next;
+  }
+}
+
+/**
+ * Acquire a node from the pool
+ *
+ * @return The index of the node
+ */
+FutureWorkStore::Index FutureWorkStore::AllocateNode()
+{
+  Index index = free_;
+
+  if (index != NIL)
+  {
+    free_ = nodes_[index].next;
+  }
+  else
+  {
+    index = static_cast<Index>(nodes_.size());
+    nodes_.emplace_back();
+  }
+
+  Node &node = nodes_[index];
+
+  node.in_use = true;
+  node.prev   = NIL;
+  node.next   = NIL;
+
+  // the generation is never zero, so that a valid handle can not equal INVALID_HANDLE
+  if (++node.generation == 0)
+  {
+    node.generation = 1;
+  }
+
+  return index;
+}
+
+/**
+ * Return a (unlinked) node to the pool
+ *
+ * @param index The index of the node
+ */
+void FutureWorkStore::ReleaseNode(Index index)
+{
+  Node &node = nodes_[index];
+
+  node.item   = WorkItem{};
+  node.in_use = false;
+  node.prev   = NIL;
+  node.next   = free_;
+
+  free_ = index;
+}
+
+/**
+ * Place a node into the slot matching its due time, or onto the ready list if it is already due.
+ *
+ * The level is determined by the most significant bit in which the due time differs from the
+ * current tick. This guarantees that the slot is ahead of the current position in its level, and
+ * that it is reached (and cascaded) by the time the due tick arrives.
+ *
+ * @param index The index of the node
+ */
+void FutureWorkStore::Insert(Index index)
+{
+  Tick const due = nodes_[index].due;
+
+  if (due <= current_)
+  {
+    Link(index, READY_LIST);
+    return;
+  }
+
+  std::size_t const level = MostSignificantBit(due ^ current_) / SLOT_BITS;
+  std::size_t const slot  = static_cast<std::size_t>((due >> (level * SLOT_BITS)) & SLOT_MASK);
+
+  Link(index, (level * NUM_SLOTS) + slot);
+  occupied_[level] |= uint64_t{1} << slot;
+}
+
+/**
+ * Add a node to the front of a list
+ *
+ * @param index The index of the node
+ * @param list The index of the list
+ */
+void FutureWorkStore::Link(Index index, std::size_t list)
+{
+  Node &node = nodes_[index];
+
+  node.list = list;
+  node.prev = NIL;
+  node.next = heads_[list];
+
+  if (node.next != NIL)
+  {
+    nodes_[node.next].prev = index;
+  }
+
+  heads_[list] = index;
+}
+
+/**
+ * Remove a node from the list it is currently in
+ *
+ * @param index The index of the node
+ */
+void FutureWorkStore::Unlink(Index index)
+{
+  Node &node = nodes_[index];
+
+  if (node.prev != NIL)
+  {
+    nodes_[node.prev].next = node.next;
+  }
+  else
+  {
+    heads_[node.list] = node.next;
+  }
+
+  if (node.next != NIL)
+  {
+    nodes_[node.next].prev = node.prev;
+  }
+
+  // clear the occupancy of wheel slots which have become empty
+  if ((node.list != READY_LIST) && (heads_[node.list] == NIL))
+  {
+    occupied_[node.list / NUM_SLOTS] &= ~(uint64_t{1} << (node.list % NUM_SLOTS));
+  }
+
+  node.prev = NIL;
+  node.next = NIL;
+}
+
+/**
+ * Remove all the items from the ready list
+ *
+ * @param items The output list of work items to be dispatched
+ */
+void FutureWorkStore::ExtractReady(ItemList &items)
+{
+  Index index        = heads_[READY_LIST];
+  heads_[READY_LIST] = NIL;
+
+  while (index != NIL)
+  {
+    Index const next = nodes_[index].next;
+
+    items.emplace_back(std::move(nodes_[index].item));
+    ReleaseNode(index);
+    --size_;
+
+    index = next;
+  }
+}
+
+}  // namespace details
+}  // namespace network
+}  // namespace fetch
@@ -19,10 +19,16 @@
 #include "network/details/network_manager_implementation.hpp"
 #include "core/threading.hpp"
 
+#include <algorithm>
+
 namespace fetch {
 namespace network {
 namespace details {
 
+thread_local NetworkManagerImplementation const *NetworkManagerImplementation::current_manager_ =
+    nullptr;
+thread_local std::size_t NetworkManagerImplementation::current_core_ = 0;
+
 void NetworkManagerImplementation::Start()
 {
   FETCH_LOCK(thread_mutex_);
@@ -31,23 +37,40 @@ void NetworkManagerImplementation::Start()
   if (threads_.size() == 0)
   {
     owning_thread_ = std::this_thread::get_id();
-    shared_work_   = std::make_shared<asio::io_service::work>(*io_service_);
+
+    shared_work_.clear();
+    for (auto &io_service : io_services_)
+    {
+      shared_work_.push_back(std::make_shared<asio::io_service::work>(*io_service));
+    }
 
     for (std::size_t i = 0; i < number_of_threads_; ++i)
     {
-      auto thread = std::make_shared<std::thread>([this, i]() {
+      std::size_t const core = i % io_services_.size();
+
+      auto thread = std::make_shared<std::thread>([this, i, core]() {
         SetThreadName(name_, i);
 
-        this->Work();
+        if (Mode::PER_CORE == mode_)
+        {
+          SetThreadAffinity(i);
+        }
+
+        this->Work(core);
       });
       threads_.push_back(thread);
     }
   }
 }
 
-void NetworkManagerImplementation::Work()
+void NetworkManagerImplementation::Work(std::size_t core)
 {
-  io_service_->run();
+  current_manager_ = this;
+  current_core_    = core;
+
+  io_services_[core]->run();
+
+  current_manager_ = nullptr;
 }
 
 void NetworkManagerImplementation::Stop()
@@ -69,8 +92,11 @@ void NetworkManagerImplementation::Stop()
     }
   }
 
-  shared_work_.reset();
-  io_service_->stop();
+  shared_work_.clear();
+  for (auto &io_service : io_services_)
+  {
+    io_service->stop();
+  }
 
   // Allow a period of time for any pending thread to finish
   // starting. It doesn't need to be long, just basically us
@@ -83,7 +109,7 @@ void NetworkManagerImplementation::Stop()
   }
 
   threads_.clear();
-  io_service_ = std::make_unique<asio::io_service>();
+  CreateContexts();
 }
 
 bool NetworkManagerImplementation::Running()
@@ -91,6 +117,52 @@ bool NetworkManagerImplementation::Running()
   return running_;
 }
 
+/**
+ * Select the core (io context) for a new unit of work, distributing them in turn
+ *
+ * @return The index of the selected core
+ */
+std::size_t NetworkManagerImplementation::NextCore()
+{
+  if (io_services_.size() == 1)
+  {
+    return 0;
+  }
+
+  return next_core_.fetch_add(1) % io_services_.size();
+}
+
+/**
+ * (Re)create the io contexts, a single shared one or one for each of the threads
+ */
+void NetworkManagerImplementation::CreateContexts()
+{
+  std::size_t const count =
+      (Mode::PER_CORE == mode_) ? std::max<std::size_t>(number_of_threads_, 1) : 1;
+
+  io_services_.clear();
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    io_services_.emplace_back(std::make_unique<asio::io_service>());
+  }
+}
+
+/**
+ * Work issued from one of our own threads stays on that thread's core, anything issued from
+ * outside is spread across the cores
+ *
+ * @return The index of the selected core
+ */
+std::size_t NetworkManagerImplementation::LocalOrNextCore()
+{
+  if (this == current_manager_)
+  {
+    return current_core_;
+  }
+
+  return NextCore();
+}
+
 }  // namespace details
 }  // namespace network
 }  // namespace fetch
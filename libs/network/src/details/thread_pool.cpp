@@ -61,16 +61,33 @@ ThreadPoolImplementation::~ThreadPoolImplementation()
  *
  * @param item The work item to execute
  * @param milliseconds The (minimum) time to postpone the execution for
+ * @return The handle with which the work can be cancelled before it is executed
  */
-void ThreadPoolImplementation::Post(WorkItem item, uint32_t milliseconds)
+ThreadPoolImplementation::WorkHandle ThreadPoolImplementation::Post(WorkItem item,
+                                                                    uint32_t milliseconds)
 {
+  WorkHandle handle = FutureWorkStore::INVALID_HANDLE;
+
   if (!shutdown_)
   {
-    future_work_.Post(std::move(item), milliseconds);
+    handle = future_work_.Post(std::move(item), milliseconds);
 
     FETCH_LOCK(idle_mutex_);
     work_available_.notify_one();
   }
+
+  return handle;
+}
+
+/**
+ * Cancel a piece of future work which has not yet become due
+ *
+ * @param handle The handle returned when the work was posted
+ * @return true if the work was cancelled, otherwise false
+ */
+bool ThreadPoolImplementation::Cancel(WorkHandle handle)
+{
+  return future_work_.Cancel(handle);
 }
 
 /**
@@ -0,0 +1,186 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "network/muddle/broadcast_cache.hpp"
+
+#include <algorithm>
+
+namespace fetch {
+namespace muddle {
+
+constexpr std::size_t BroadcastCache::NUM_BUCKETS;
+constexpr std::size_t BroadcastCache::BUCKET_SIZE;
+constexpr std::size_t BroadcastCache::MAX_BUCKET_LOAD;
+
+static_assert((BroadcastCache::BUCKET_SIZE & (BroadcastCache::BUCKET_SIZE - 1u)) == 0,
+              "Bucket size must be a power of two");
+
+/**
+ * Construct the broadcast cache
+ *
+ * @param bucket_interval The period of time covered by each bucket
+ */
+BroadcastCache::BroadcastCache(Duration bucket_interval)
+  : bucket_interval_{bucket_interval}
+  , current_start_{Clock::now()}
+{}
+
+/**
+ * Insert an identifier into the cache
+ *
+ * @param id The identifier to be inserted
+ * @param now The current time
+ * @return true if the identifier was new, false if it has already been seen
+ */
+bool BroadcastCache::Insert(Id id, Timepoint const &now)
+{
+  id = Normalise(id);
+
+  FETCH_LOCK(lock_);
+
+  // expire the buckets which have aged out
+  auto const elapsed = now - current_start_;
+  if (elapsed >= bucket_interval_)
+  {
+    auto const intervals = static_cast<std::size_t>(elapsed / bucket_interval_);
+
+    Rotate(std::min(intervals, NUM_BUCKETS), now);
+  }
+
+  // check to see if this identifier has been seen
+  for (auto const &bucket : buckets_)
+  {
+    if (Find(bucket, id))
+    {
+      ++stats_.suppressed;
+      return false;
+    }
+  }
+
+  // ensure the current bucket has space for the identifier
+  if (buckets_[current_].count >= MAX_BUCKET_LOAD)
+  {
+    ++stats_.forced_rotations;
+    Rotate(1, now);
+  }
+
+  Add(buckets_[current_], id);
+  ++stats_.inserted;
+
+  return true;
+}
+
+/**
+ * Determine if an identifier is present in the cache
+ *
+ * @param id The identifier to lookup
+ * @return true if the identifier is present, otherwise false
+ */
+bool BroadcastCache::Contains(Id id) const
+{
+  id = Normalise(id);
+
+  FETCH_LOCK(lock_);
+
+  return std::any_of(buckets_.begin(), buckets_.end(),
+                     [id](Bucket const &bucket) { return Find(bucket, id); });
+}
+
+/**
+ * Get a copy of the current cache statistics
+ *
+ * @return The statistics
+ */
+BroadcastCache::Stats BroadcastCache::GetStats() const
+{
+  FETCH_LOCK(lock_);
+  return stats_;
+}
+
+/**
+ * Mix the bits of the identifier so that it can be used to directly index the slots. The value
+ * zero is reserved to mark an empty slot.
+ *
+ * @param id The input identifier
+ * @return The normalised identifier
+ */
+BroadcastCache::Id BroadcastCache::Normalise(Id id)
+{
+  id ^= id >> 33u;
+  id *= 0xff51afd7ed558ccdull;
+  id ^= id >> 33u;
+
+  return (id == 0) ? 1 : id;
+}
+
+bool BroadcastCache::Find(Bucket const &bucket, Id id)
+{
+  std::size_t index = static_cast<std::size_t>(id) & (BUCKET_SIZE - 1u);
+
+  // since the bucket is never more than half full the probe is guaranteed to find an empty slot
+  while (bucket.slots[index] != 0)
+  {
+    if (bucket.slots[index] == id)
+    {
+      return true;
+    }
+
+    index = (index + 1u) & (BUCKET_SIZE - 1u);
+  }
+
+  return false;
+}
+
+void BroadcastCache::Add(Bucket &bucket, Id id)
+{
+  std::size_t index = static_cast<std::size_t>(id) & (BUCKET_SIZE - 1u);
+
+  while (bucket.slots[index] != 0)
+  {
+    index = (index + 1u) & (BUCKET_SIZE - 1u);
+  }
+
+  bucket.slots[index] = id;
+  ++bucket.count;
+}
+
+/**
+ * Expire the oldest bucket(s), the last of which becomes the new current bucket
+ *
+ * @param count The number of buckets to expire
+ * @param now The current time
+ */
+void BroadcastCache::Rotate(std::size_t count, Timepoint const &now)
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    current_ = (current_ + 1u) % NUM_BUCKETS;
+
+    auto &bucket = buckets_[current_];
+    std::fill(bucket.slots.begin(), bucket.slots.end(), 0);
+    bucket.count = 0;
+
+    ++stats_.rotations;
+  }
+
+  current_start_ = now;
+}
+
+}  // namespace muddle
+}  // namespace fetch
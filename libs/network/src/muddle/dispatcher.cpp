@@ -18,12 +18,20 @@
 
 #include "network/muddle/dispatcher.hpp"
 
+#include <algorithm>
+#include <thread>
+
 namespace fetch {
 namespace muddle {
 namespace {
 
 const std::chrono::seconds PROMISE_TIMEOUT{30};
 
+constexpr uint64_t ID_MASK       = (uint64_t{1} << 48u) - 1u;
+constexpr uint64_t SEQUENCE_MASK = ((uint64_t{1} << 62u) - 1u) & ~ID_MASK;
+constexpr uint64_t PUBLISHED     = uint64_t{1} << 62u;  ///< The slot holds a pending promise
+constexpr uint64_t BUSY          = uint64_t{1} << 63u;  ///< The slot is being updated
+
 /**
  * Combine service, channel and counter into a single incde
  *
@@ -43,8 +51,61 @@ uint64_t Combine(uint16_t service, uint16_t channel, uint16_t counter)
   return id;
 }
 
+/**
+ * Combine service and channel into a single index
+ *
+ * @param service The service id
+ * @param channel The channel id
+ * @return The aggregated index
+ */
+uint32_t Combine(uint16_t service, uint16_t channel)
+{
+  return (static_cast<uint32_t>(service) << 16u) | static_cast<uint32_t>(channel);
+}
+
+/**
+ * Determine if a slot state holds a promise for the specified exchange
+ *
+ * @param state The state of the slot
+ * @param id The combined id of the exchange
+ * @return true if it does, otherwise false
+ */
+bool IsPending(uint64_t state, uint64_t id)
+{
+  return ((state & (PUBLISHED | BUSY)) == PUBLISHED) && ((state & ID_MASK) == id);
+}
+
 }  // namespace
 
+constexpr std::size_t        Dispatcher::NUM_SLOTS;
+constexpr std::size_t        Dispatcher::SLOTS_PER_CHUNK;
+constexpr std::size_t        Dispatcher::NUM_CHUNKS;
+constexpr std::size_t        Dispatcher::WHEEL_SIZE;
+constexpr Dispatcher::Handle Dispatcher::NO_HANDLE;
+
+Dispatcher::Dispatcher()
+  : epoch_{Clock::now()}
+{}
+
+Dispatcher::~Dispatcher()
+{
+  for (auto &bucket : wheel_)
+  {
+    Expiry *expiry = bucket.exchange(nullptr);
+    while (expiry != nullptr)
+    {
+      Expiry *next = expiry->next;
+      delete expiry;
+      expiry = next;
+    }
+  }
+
+  for (auto &chunk : chunks_)
+  {
+    delete chunk.load();
+  }
+}
+
 /**
  * Register that a exchange is scheduled to take place and create a promise to track the response
  *
@@ -56,21 +117,51 @@ uint64_t Combine(uint16_t service, uint16_t channel, uint16_t counter)
 Dispatcher::Promise Dispatcher::RegisterExchange(uint16_t service, uint16_t channel,
                                                  uint16_t counter, Packet::Address const &address)
 {
-  FETCH_LOCK(promises_lock_);
+  uint64_t const id   = Combine(service, channel, counter);
+  Slot &         slot = LookupSlot(counter);
 
-  uint64_t const id = Combine(service, channel, counter);
+  // claim the slot, failing the promise of an exchange which has not completed since the counter
+  // was last used
+  uint64_t state = slot.state.load(std::memory_order_acquire);
+  for (;;)
+  {
+    if ((state & BUSY) != 0)
+    {
+      std::this_thread::yield();
+      state = slot.state.load(std::memory_order_acquire);
+      continue;
+    }
+
+    if (slot.state.compare_exchange_weak(state, state | BUSY, std::memory_order_acquire))
+    {
+      break;
+    }
+  }
 
-  auto it = promises_.find(id);
-  if (it != promises_.end())
+  if ((state & PUBLISHED) != 0)
   {
-    FETCH_LOG_ERROR(LOGGING_NAME, "Duplicate promise: ", service, ':', channel, ':', counter,
-                    " forced to remove entry");
-    promises_.erase(it);
+    uint64_t const previous = state & ID_MASK;
+    FETCH_LOG_ERROR(LOGGING_NAME, "Duplicate promise: ", (previous >> 32u) & 0xFFFFu, ':',
+                    (previous >> 16u) & 0xFFFFu, ':', counter, " forced to remove entry");
+
+    slot.promise->Fail();
+    --num_pending_;
   }
 
-  PromiseEntry &entry = promises_[id];
-  entry.address       = address;
-  return entry.promise;
+  uint64_t const sequence = (state + (uint64_t{1} << 48u)) & SEQUENCE_MASK;
+  uint64_t const pending  = sequence | PUBLISHED | id;
+
+  Promise promise = service::MakePromise();
+  slot.promise    = promise;
+  slot.address    = address;
+  slot.handle.store(NO_HANDLE, std::memory_order_relaxed);
+
+  ++num_pending_;
+  slot.state.store(pending, std::memory_order_release);
+
+  Schedule(new Expiry{&slot, pending, Clock::now() + PROMISE_TIMEOUT, nullptr});
+
+  return promise;
 }
 
 /**
@@ -81,31 +172,34 @@ Dispatcher::Promise Dispatcher::RegisterExchange(uint16_t service, uint16_t chan
  */
 bool Dispatcher::Dispatch(PacketPtr packet)
 {
-  bool success = false;
-
-  FETCH_LOCK(promises_lock_);
   uint64_t const id = Combine(packet->GetService(), packet->GetProtocol(), packet->GetMessageNum());
 
-  auto it = promises_.find(id);
-  if (it != promises_.end())
+  Slot *slot = FindSlot(packet->GetMessageNum());
+  if (slot == nullptr)
   {
-    assert(it->second.promise);
-    if (packet->GetSender() == it->second.address)
-    {
-      it->second.promise->Fulfill(packet->GetPayload());
-      // finally remove the promise from the map (since it has been completed)
-      promises_.erase(it);
-      success = true;
-    }
-    else
-    {
-      FETCH_LOG_INFO(LOGGING_NAME, "Recieved response from wrong address");
-      FETCH_LOG_INFO(LOGGING_NAME, "Expected : " + ToBase64(it->second.address));
-      FETCH_LOG_INFO(LOGGING_NAME, "Recieved : " + ToBase64(packet->GetSender()));
-    }
+    return false;
+  }
+
+  uint64_t const state = slot->state.load(std::memory_order_acquire);
+  if (!IsPending(state, id) || !Claim(*slot, state))
+  {
+    return false;
+  }
+
+  if (packet->GetSender() != slot->address)
+  {
+    FETCH_LOG_INFO(LOGGING_NAME, "Recieved response from wrong address");
+    FETCH_LOG_INFO(LOGGING_NAME, "Expected : " + ToBase64(slot->address));
+    FETCH_LOG_INFO(LOGGING_NAME, "Recieved : " + ToBase64(packet->GetSender()));
+
+    // leave the promise waiting for the right response
+    slot->state.store(state, std::memory_order_release);
+    return false;
   }
 
-  return success;
+  Release(*slot, state)->Fulfill(packet->GetPayload());
+
+  return true;
 }
 
 /**
@@ -118,10 +212,12 @@ bool Dispatcher::Dispatch(PacketPtr packet)
  */
 void Dispatcher::NotifyMessage(Handle handle, uint16_t service, uint16_t channel, uint16_t counter)
 {
-  FETCH_LOCK(handles_lock_);
-  uint64_t const id = Combine(service, channel, counter);
-
-  handles_[handle].insert(id);
+  Slot *slot = FindSlot(counter);
+  if ((slot != nullptr) &&
+      IsPending(slot->state.load(std::memory_order_acquire), Combine(service, channel, counter)))
+  {
+    slot->handle.store(handle, std::memory_order_release);
+  }
 }
 
 /**
@@ -132,100 +228,291 @@ void Dispatcher::NotifyMessage(Handle handle, uint16_t service, uint16_t channel
  */
 void Dispatcher::NotifyConnectionFailure(Handle handle)
 {
-  PromiseSet affected_promises{};
-
-  // lookup all the affected promises
-  {
-    FETCH_LOCK(handles_lock_);
-    auto it = handles_.find(handle);
-    if (it != handles_.end())
+  // connection failures are rare, so the pending promises are not indexed by connection
+  VisitSlots([this, handle](Slot &slot) {
+    uint64_t const state = slot.state.load(std::memory_order_acquire);
+    if (((state & (PUBLISHED | BUSY)) == PUBLISHED) &&
+        (slot.handle.load(std::memory_order_acquire) == handle) && Claim(slot, state))
     {
-      std::swap(affected_promises, it->second);
-      handles_.erase(it);
+      Release(slot, state)->Fail();
     }
-  }
+  });
+}
+
+/**
+ * Run the cleanup routing, expiring the promises of the buckets whose time has passed
+ *
+ * @param now The reference time out (by default the current time)
+ */
+void Dispatcher::Cleanup(Timepoint const &now)
+{
+  FETCH_LOCK(cleanup_lock_);
 
-  // update all the affected promises
+  int64_t const current = ToTick(now);
+
+  // a cleanup in the future (tests) is followed by the present again
+  next_tick_ = std::min(next_tick_, current);
+
+  // every bucket is visited at most once, whatever the time since the last cleanup
+  int64_t const first = std::max(next_tick_, current - static_cast<int64_t>(WHEEL_SIZE) + 1);
+
+  for (int64_t tick = first; tick <= current; ++tick)
   {
-    FETCH_LOCK(promises_lock_);
+    auto &bucket = wheel_[static_cast<std::size_t>(tick) % WHEEL_SIZE];
 
-    for (auto const &id : affected_promises)
+    Expiry *expiry = bucket.exchange(nullptr, std::memory_order_acquire);
+    while (expiry != nullptr)
     {
-      auto it = promises_.find(id);
-      if (it != promises_.end())
+      Expiry *next = expiry->next;
+
+      if (expiry->deadline > now)
       {
-        it->second.promise->Fail();
-        promises_.erase(it);
+        // a later turn of the wheel
+        Schedule(expiry);
       }
+      else
+      {
+        if (Claim(*expiry->slot, expiry->state))
+        {
+          FETCH_LOG_INFO(LOGGING_NAME, "Discarding promise due to timeout");
+          Release(*expiry->slot, expiry->state)->Fail();
+        }
+
+        delete expiry;
+      }
+
+      expiry = next;
     }
   }
+
+  next_tick_ = current + 1;
+}
+
+void Dispatcher::FailAllPendingPromises()
+{
+  VisitSlots([this](Slot &slot) {
+    uint64_t const state = slot.state.load(std::memory_order_acquire);
+    if (((state & (PUBLISHED | BUSY)) == PUBLISHED) && Claim(slot, state))
+    {
+      Release(slot, state)->Fail();
+    }
+  });
 }
 
 /**
- * Run the cleanup routing
+ * @return The number of promises waiting on a response
+ */
+std::size_t Dispatcher::GetNumPendingPromises() const
+{
+  return num_pending_;
+}
+
+/**
+ * Set the priority of the packets of a service / channel pair
  *
- * @param now The reference time out (by default the current time)
+ * @param service The service id
+ * @param channel The channel id
+ * @param priority The priority to be used
  */
-void Dispatcher::Cleanup(Timepoint const &now)
+void Dispatcher::SetPriority(uint16_t service, uint16_t channel, Priority priority)
+{
+  FETCH_LOCK(priorities_lock_);
+  priorities_[Combine(service, channel)] = priority;
+}
+
+/**
+ * Get the priority of the packets of a service / channel pair
+ *
+ * @param service The service id
+ * @param channel The channel id
+ * @return The configured priority, otherwise normal priority
+ */
+Dispatcher::Priority Dispatcher::GetPriority(uint16_t service, uint16_t channel) const
 {
-  FETCH_LOCK(promises_lock_);
-  FETCH_LOCK(handles_lock_);
+  FETCH_LOCK(priorities_lock_);
 
-  PromiseSet dead_promises{};
+  auto const it = priorities_.find(Combine(service, channel));
+  return (it == priorities_.end()) ? Priority::NORMAL : it->second;
+}
 
-  // Step 1. Determine which of the promises is now deemed to be dead
-  auto promise_it = promises_.begin();
-  while (promise_it != promises_.end())
+/**
+ * Queue a received packet to be dispatched
+ *
+ * @param packet The received packet
+ * @param transmitter The address of the peer which delivered it
+ */
+void Dispatcher::Enqueue(PacketPtr packet, Address const &transmitter)
+{
+  auto const priority = GetPriority(packet->GetService(), packet->GetProtocol());
+
+  FETCH_LOCK(received_lock_);
+  received_[static_cast<std::size_t>(priority)].emplace_back(std::move(packet), transmitter);
+}
+
+/**
+ * Take the next received packet to be dispatched, higher priority packets are returned before any
+ * packet of a lower priority
+ *
+ * @param packet The packet to be populated
+ * @param transmitter The address of the peer to be populated
+ * @return true if a packet was available, otherwise false
+ */
+bool Dispatcher::Dequeue(PacketPtr &packet, Address &transmitter)
+{
+  FETCH_LOCK(received_lock_);
+
+  for (auto it = received_.rbegin(); it != received_.rend(); ++it)
   {
-    auto const delta = now - promise_it->second.timestamp;
-    if (delta > PROMISE_TIMEOUT)
+    if (!it->empty())
     {
-      FETCH_LOG_INFO(LOGGING_NAME, "Discarding promise due to timeout");
-      promise_it->second.promise->Fail();
-      dead_promises.insert(promise_it->first);
+      packet      = std::move(it->front().first);
+      transmitter = std::move(it->front().second);
+      it->pop_front();
 
-      // erase the whole entry
-      promise_it = promises_.erase(promise_it);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * @return The number of received packets waiting to be dispatched
+ */
+std::size_t Dispatcher::pending() const
+{
+  FETCH_LOCK(received_lock_);
+
+  std::size_t count{0};
+  for (auto const &queue : received_)
+  {
+    count += queue.size();
+  }
+
+  return count;
+}
+
+/**
+ * Internal: Get the slot of a counter, allocating its chunk if needed
+ *
+ * @param counter The message counter
+ * @return The slot of the counter
+ */
+Dispatcher::Slot &Dispatcher::LookupSlot(uint16_t counter)
+{
+  auto &chunk = chunks_[counter / SLOTS_PER_CHUNK];
+
+  Chunk *current = chunk.load(std::memory_order_acquire);
+  if (current == nullptr)
+  {
+    auto * allocated = new Chunk{};
+    Chunk *expected  = nullptr;
+
+    if (chunk.compare_exchange_strong(expected, allocated, std::memory_order_acq_rel))
+    {
+      current = allocated;
     }
     else
     {
-      ++promise_it;
+      // another thread allocated the chunk first
+      delete allocated;
+      current = expected;
     }
   }
 
-  // Step 2. Clean up the handles map
-  for (auto const &id : dead_promises)
-  {
-    // evaluate all the of the handles
-    auto handle_it = handles_.begin();
-    while (handle_it != handles_.end())
-    {
-      auto &promise_set = handle_it->second;
+  return (*current)[counter % SLOTS_PER_CHUNK];
+}
 
-      // ensure the affected promise is removed from the set
-      promise_set.erase(id);
+/**
+ * Internal: Get the slot of a counter, if its chunk has been allocated
+ *
+ * @param counter The message counter
+ * @return The slot of the counter, otherwise nullptr
+ */
+Dispatcher::Slot *Dispatcher::FindSlot(uint16_t counter) const
+{
+  Chunk *chunk = chunks_[counter / SLOTS_PER_CHUNK].load(std::memory_order_acquire);
+  return (chunk != nullptr) ? &(*chunk)[counter % SLOTS_PER_CHUNK] : nullptr;
+}
 
-      // clear out the whole handle set if needed
-      if (promise_set.empty())
-      {
-        handle_it = handles_.erase(handle_it);
-      }
-      else
+/**
+ * Internal: Take ownership of a slot holding a promise
+ *
+ * @param slot The slot to be claimed
+ * @param state The expected state of the slot
+ * @return true if the slot was claimed, false if its state has changed
+ */
+bool Dispatcher::Claim(Slot &slot, uint64_t state)
+{
+  return ((state & (PUBLISHED | BUSY)) == PUBLISHED) &&
+         slot.state.compare_exchange_strong(state, state | BUSY, std::memory_order_acquire);
+}
+
+/**
+ * Internal: Free a claimed slot, handing back its promise to be resolved
+ *
+ * @param slot The slot which has been claimed
+ * @param state The state of the slot before it was claimed
+ * @return The promise which was held by the slot
+ */
+Dispatcher::Promise Dispatcher::Release(Slot &slot, uint64_t state)
+{
+  Promise promise = std::move(slot.promise);
+  slot.promise.reset();
+
+  --num_pending_;
+
+  // the sequence number is kept so that stale expiries never match a later registration
+  slot.state.store(state & SEQUENCE_MASK, std::memory_order_release);
+
+  return promise;
+}
+
+/**
+ * Internal: Call a function on each allocated slot of the promise table
+ *
+ * @param function The function to be called with each slot
+ */
+template <typename Function>
+void Dispatcher::VisitSlots(Function &&function) const
+{
+  for (auto const &chunk : chunks_)
+  {
+    Chunk *current = chunk.load(std::memory_order_acquire);
+    if (current != nullptr)
+    {
+      for (auto &slot : *current)
       {
-        ++handle_it;
+        function(slot);
       }
     }
   }
 }
 
-void Dispatcher::FailAllPendingPromises()
+/**
+ * Internal: Convert a time point to the tick of the expiry wheel
+ *
+ * @param timepoint The time point
+ * @return The tick (second) since the creation of the dispatcher
+ */
+int64_t Dispatcher::ToTick(Timepoint const &timepoint) const
 {
-  FETCH_LOCK(promises_lock_);
-  FETCH_LOCK(handles_lock_);
-  for (auto promise_it = promises_.begin(); promise_it != promises_.end();)
+  return std::chrono::duration_cast<std::chrono::seconds>(timepoint - epoch_).count();
+}
+
+/**
+ * Internal: Push an expiry onto the bucket of its deadline
+ *
+ * @param expiry The expiry to be scheduled
+ */
+void Dispatcher::Schedule(Expiry *expiry)
+{
+  auto &bucket = wheel_[static_cast<std::size_t>(ToTick(expiry->deadline)) % WHEEL_SIZE];
+
+  expiry->next = bucket.load(std::memory_order_relaxed);
+  while (!bucket.compare_exchange_weak(expiry->next, expiry, std::memory_order_release,
+                                       std::memory_order_relaxed))
   {
-    promise_it->second.promise->Fail();
-    promise_it = promises_.erase(promise_it);
   }
 }
 
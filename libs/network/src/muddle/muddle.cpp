@@ -195,6 +195,27 @@ Muddle::ConnectionMap Muddle::GetConnections(bool direct_only)
   return connection_map;
 }
 
+/**
+ * Get the measured round trip times of the direct peers of this node. Peers for which no
+ * measurement is available yet are omitted.
+ *
+ * @return The map of peer address to round trip time in microseconds
+ */
+Muddle::LatencyMap Muddle::GetPeerLatencies() const
+{
+  LatencyMap latencies;
+
+  for (auto const &entry : router_.GetRoutingTable())
+  {
+    if (entry.second.direct && (entry.second.latency_us > 0))
+    {
+      latencies[ConvertAddress(entry.first)] = entry.second.latency_us;
+    }
+  }
+
+  return latencies;
+}
+
 void Muddle::DropPeer(Address const &peer)
 {
   FETCH_LOG_INFO(LOGGING_NAME, "Drop address peer: ", ToBase64(peer));
@@ -327,10 +348,8 @@ void Muddle::CreateTcpClient(Uri const &peer)
     try
     {
       // un-marshall the data
-      serializers::ByteArrayBuffer buffer(msg);
-
       auto packet = std::make_shared<Packet>();
-      buffer >> *packet;
+      packet->FromWireBuffer(msg);
 
       // dispatch the message to router
       router_.Route(conn_handle, packet);
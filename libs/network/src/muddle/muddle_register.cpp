@@ -46,9 +46,12 @@ void MuddleRegister::VisitConnectionMap(MuddleRegister::ConnectionMapCallback co
 /**
  * Broadcast data to all active connections
  *
+ * The same buffer is shared (not copied) between all of the connections
+ *
  * @param data The data to be broadcast
+ * @param priority The priority with which the data is sent
  */
-void MuddleRegister::Broadcast(ConstByteArray const &data) const
+void MuddleRegister::Broadcast(ByteArray const &data, Priority priority) const
 {
   FETCH_LOCK(connection_map_lock_);
 
@@ -60,7 +63,27 @@ void MuddleRegister::Broadcast(ConstByteArray const &data) const
     if (connection)
     {
       // schedule sending of the data
-      connection->Send(data);
+      connection->SendWithPriority(data, priority);
+    }
+  }
+}
+
+/**
+ * Broadcast data to all active connections, encoded separately for each of them
+ *
+ * @param encode The callback which returns the data to be sent to a connection
+ * @param priority The priority with which the data is sent
+ */
+void MuddleRegister::Broadcast(EncodeCallback const &encode, Priority priority) const
+{
+  FETCH_LOCK(connection_map_lock_);
+
+  for (auto const &elem : connection_map_)
+  {
+    auto connection = elem.second.lock();
+    if (connection)
+    {
+      connection->SendWithPriority(encode(elem.first), priority);
     }
   }
 }
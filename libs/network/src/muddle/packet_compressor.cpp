@@ -0,0 +1,366 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "network/muddle/packet_compressor.hpp"
+#include "core/logger.hpp"
+#include "core/serializers/byte_array_buffer.hpp"
+
+#include <arpa/inet.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <utility>
+
+namespace fetch {
+namespace muddle {
+namespace {
+
+using byte_array::ByteArray;
+using byte_array::ConstByteArray;
+
+std::size_t const INFLATE_CHUNK_SIZE = 64 * 1024;
+
+Bytef const *Data(ConstByteArray const &array)
+{
+  return array.pointer();
+}
+
+bool IsLocalIPv4(uint8_t const *octets)
+{
+  return (octets[0] == 127) ||                                  // loopback
+         (octets[0] == 10) ||                                   // 10.0.0.0/8
+         ((octets[0] == 172) && ((octets[1] & 0xF0) == 16)) ||  // 172.16.0.0/12
+         ((octets[0] == 192) && (octets[1] == 168)) ||          // 192.168.0.0/16
+         ((octets[0] == 169) && (octets[1] == 254));            // link local
+}
+
+}  // namespace
+
+constexpr char const *PacketCompressor::LOGGING_NAME;
+constexpr uint32_t    PacketCompressor::CAPABILITY_DEFLATE;
+constexpr std::size_t PacketCompressor::MAX_DICTIONARY_SIZE;
+constexpr std::size_t PacketCompressor::MAX_DECOMPRESSED_SIZE;
+
+/**
+ * Update the compression options. Connections which have already completed their handshake keep
+ * the capabilities they advertised at the time.
+ *
+ * @param options The new options, the dictionary is truncated to the deflate window
+ */
+void PacketCompressor::SetOptions(CompressionOptions options)
+{
+  options.level = std::min(std::max(options.level, 1), 9);
+
+  // deflate only references the end of the dictionary
+  if (options.dictionary.size() > MAX_DICTIONARY_SIZE)
+  {
+    options.dictionary = options.dictionary.SubArray(
+        options.dictionary.size() - MAX_DICTIONARY_SIZE, MAX_DICTIONARY_SIZE);
+  }
+
+  DictionaryId dictionary_id{0};
+  if (!options.dictionary.empty())
+  {
+    dictionary_id = static_cast<DictionaryId>(
+        adler32(adler32(0, Z_NULL, 0), Data(options.dictionary),
+                static_cast<uInt>(options.dictionary.size())));
+  }
+
+  FETCH_LOCK(lock_);
+  options_       = std::move(options);
+  dictionary_id_ = dictionary_id;
+}
+
+CompressionOptions PacketCompressor::options() const
+{
+  FETCH_LOCK(lock_);
+  return options_;
+}
+
+bool PacketCompressor::enabled() const
+{
+  FETCH_LOCK(lock_);
+  return options_.enabled;
+}
+
+PacketCompressor::DictionaryId PacketCompressor::dictionary_id() const
+{
+  FETCH_LOCK(lock_);
+  return dictionary_id_;
+}
+
+/**
+ * Build the capabilities advertised in the routing handshake
+ *
+ * @return The encoded capabilities, empty if compression is disabled
+ */
+ConstByteArray PacketCompressor::EncodeCapabilities() const
+{
+  FETCH_LOCK(lock_);
+
+  if (!options_.enabled)
+  {
+    return {};
+  }
+
+  serializers::ByteArrayBuffer buffer;
+  buffer << CAPABILITY_DEFLATE << dictionary_id_;
+
+  return buffer.data();
+}
+
+/**
+ * Parse the capabilities advertised by a peer. Peers which predate compression send an empty
+ * handshake and therefore have no capabilities.
+ *
+ * @param payload The payload of the routing handshake
+ * @return The capabilities of the peer
+ */
+PacketCompressor::Capabilities PacketCompressor::DecodeCapabilities(ConstByteArray const &payload)
+{
+  Capabilities capabilities{};
+
+  if (!payload.empty())
+  {
+    try
+    {
+      uint32_t     flags{0};
+      DictionaryId dictionary{0};
+
+      serializers::ByteArrayBuffer buffer{payload};
+      buffer >> flags >> dictionary;
+
+      capabilities.deflate    = (flags & CAPABILITY_DEFLATE) != 0;
+      capabilities.dictionary = dictionary;
+    }
+    catch (std::exception const &ex)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Unable to parse peer capabilities: ", ex.what());
+    }
+  }
+
+  return capabilities;
+}
+
+/**
+ * Determine if the packets sent to a peer should be compressed
+ *
+ * @param peer The capabilities advertised by the peer
+ * @param address The remote address of the connection to the peer
+ * @return true if large packets should be compressed, otherwise false
+ */
+bool PacketCompressor::ShouldCompress(Capabilities const &peer, std::string const &address) const
+{
+  bool compress_local{false};
+  {
+    FETCH_LOCK(lock_);
+
+    if (!options_.enabled || !peer.deflate)
+    {
+      return false;
+    }
+
+    compress_local = options_.compress_local;
+  }
+
+  // bandwidth is cheap on the local network, the CPU time is better spent elsewhere
+  return compress_local || !IsLocalAddress(address);
+}
+
+/**
+ * Compress an encoded packet
+ *
+ * @param input The encoded packet
+ * @param use_dictionary Flag to signal that the peer shares our preset dictionary
+ * @param output The compressed packet
+ * @return true if the packet was compressed, false if it is too small or does not compress
+ */
+bool PacketCompressor::Compress(ConstByteArray const &input, bool use_dictionary,
+                                ConstByteArray &output) const
+{
+  int            level{0};
+  ConstByteArray dictionary;
+  {
+    FETCH_LOCK(lock_);
+
+    if (input.size() < options_.min_size)
+    {
+      return false;
+    }
+
+    level = options_.level;
+    if (use_dictionary)
+    {
+      dictionary = options_.dictionary;
+    }
+  }
+
+  z_stream stream{};
+  if (deflateInit(&stream, level) != Z_OK)
+  {
+    return false;
+  }
+
+  bool success = dictionary.empty() ||
+                 (deflateSetDictionary(&stream, Data(dictionary),
+                                       static_cast<uInt>(dictionary.size())) == Z_OK);
+
+  ByteArray compressed;
+  if (success)
+  {
+    compressed.Resize(deflateBound(&stream, static_cast<uLong>(input.size())));
+
+    stream.next_in   = const_cast<Bytef *>(Data(input));
+    stream.avail_in  = static_cast<uInt>(input.size());
+    stream.next_out  = compressed.pointer();
+    stream.avail_out = static_cast<uInt>(compressed.size());
+
+    success = (deflate(&stream, Z_FINISH) == Z_STREAM_END) && (stream.total_out < input.size());
+  }
+
+  if (success)
+  {
+    compressed.Resize(stream.total_out);
+    output = compressed;
+  }
+
+  deflateEnd(&stream);
+
+  return success;
+}
+
+/**
+ * Decompress an encoded packet
+ *
+ * @param input The compressed packet
+ * @param output The encoded packet
+ * @return true if successful, false if the input is corrupt, requires a dictionary which we do not
+ * have or is too large
+ */
+bool PacketCompressor::Decompress(ConstByteArray const &input, ByteArray &output) const
+{
+  z_stream stream{};
+  if (inflateInit(&stream) != Z_OK)
+  {
+    return false;
+  }
+
+  stream.next_in  = const_cast<Bytef *>(Data(input));
+  stream.avail_in = static_cast<uInt>(input.size());
+
+  ByteArray   decompressed;
+  std::size_t size{0};
+  int         status{Z_OK};
+
+  while (status == Z_OK)
+  {
+    if (size + INFLATE_CHUNK_SIZE > MAX_DECOMPRESSED_SIZE)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Discarding oversized compressed packet");
+      break;
+    }
+
+    decompressed.Resize(size + INFLATE_CHUNK_SIZE);
+
+    stream.next_out  = decompressed.pointer() + size;
+    stream.avail_out = static_cast<uInt>(INFLATE_CHUNK_SIZE);
+
+    status = inflate(&stream, Z_NO_FLUSH);
+    size   = stream.total_out;
+
+    if (status == Z_NEED_DICT)
+    {
+      ConstByteArray dictionary;
+      {
+        FETCH_LOCK(lock_);
+        if (stream.adler == dictionary_id_)
+        {
+          dictionary = options_.dictionary;
+        }
+      }
+
+      if (dictionary.empty())
+      {
+        FETCH_LOG_WARN(LOGGING_NAME, "Compressed packet requires an unknown dictionary");
+        break;
+      }
+
+      status = inflateSetDictionary(&stream, Data(dictionary),
+                                    static_cast<uInt>(dictionary.size()));
+    }
+    else if ((status == Z_BUF_ERROR) && (stream.avail_out != 0))
+    {
+      // the input is truncated
+      break;
+    }
+    else if (status == Z_BUF_ERROR)
+    {
+      status = Z_OK;
+    }
+  }
+
+  inflateEnd(&stream);
+
+  if (status != Z_STREAM_END)
+  {
+    return false;
+  }
+
+  decompressed.Resize(size);
+  output = decompressed;
+
+  return true;
+}
+
+/**
+ * Determine if an address is on the loopback or a private network
+ *
+ * @param address The textual IPv4 or IPv6 address
+ * @return true if the address is local, otherwise false
+ */
+bool PacketCompressor::IsLocalAddress(std::string const &address)
+{
+  std::array<uint8_t, 16> octets{};
+
+  if (inet_pton(AF_INET, address.c_str(), octets.data()) == 1)
+  {
+    return IsLocalIPv4(octets.data());
+  }
+
+  if (inet_pton(AF_INET6, address.c_str(), octets.data()) == 1)
+  {
+    static std::array<uint8_t, 12> const V4_MAPPED{{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF}};
+    static std::array<uint8_t, 16> const LOOPBACK{{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1}};
+
+    if (std::equal(V4_MAPPED.begin(), V4_MAPPED.end(), octets.begin()))
+    {
+      return IsLocalIPv4(octets.data() + V4_MAPPED.size());
+    }
+
+    return (octets == LOOPBACK) ||                                 // ::1
+           ((octets[0] & 0xFE) == 0xFC) ||                         // fc00::/7 unique local
+           ((octets[0] == 0xFE) && ((octets[1] & 0xC0) == 0x80));  // fe80::/10 link local
+  }
+
+  return false;
+}
+
+}  // namespace muddle
+}  // namespace fetch
@@ -27,12 +27,17 @@
 #include "network/muddle/muddle_register.hpp"
 #include "network/muddle/packet.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstring>
+#include <deque>
 #include <iomanip>
+#include <limits>
 #include <memory>
 #include <random>
 #include <sstream>
 #include <utility>
+#include <vector>
 
 static constexpr uint8_t DEFAULT_TTL = 40;
 
@@ -150,6 +155,46 @@ Router::PacketPtr FormatPacket(Packet::Address const &from, NetworkId const &net
   return packet;
 }
 
+/**
+ * Calculate the number of hops that the packet has travelled to reach this node
+ *
+ * @param packet The received packet
+ * @return The number of hops
+ */
+uint8_t CalculateHops(Packet const &packet)
+{
+  uint8_t const ttl = std::min(packet.GetTTL(), DEFAULT_TTL);
+  return static_cast<uint8_t>(DEFAULT_TTL - ttl + 1u);
+}
+
+/**
+ * Determine if one route should be preferred to another. Direct routes are always preferred,
+ * followed by the route with the fewest hops and then the lowest latency. Unknown metrics rank
+ * behind any known value.
+ *
+ * @param lhs The first route
+ * @param rhs The second route
+ * @return true if the first route is better than the second, otherwise false
+ */
+bool IsBetterRoute(Router::RoutingData const &lhs, Router::RoutingData const &rhs)
+{
+  auto const rank = [](uint32_t value) {
+    return (value == 0) ? std::numeric_limits<uint32_t>::max() : value;
+  };
+
+  if (lhs.direct != rhs.direct)
+  {
+    return lhs.direct;
+  }
+
+  if (lhs.hops != rhs.hops)
+  {
+    return rank(lhs.hops) < rank(rhs.hops);
+  }
+
+  return rank(lhs.latency_us) < rank(rhs.latency_us);
+}
+
 std::string DescribePacket(Packet const &packet)
 {
   std::ostringstream oss;
@@ -165,6 +210,14 @@ std::string DescribePacket(Packet const &packet)
 
 }  // namespace
 
+constexpr std::chrono::milliseconds::rep Router::DEFAULT_BLOCK_TIMEOUT_MS;
+constexpr std::size_t                     Router::MAX_ROUTES_PER_ADDRESS;
+constexpr uint32_t                        Router::DEFAULT_BATCH_WINDOW_MS;
+constexpr std::size_t                     Router::MAX_BATCH_PACKETS;
+constexpr std::size_t                     Router::MAX_BATCH_BYTES;
+constexpr std::size_t                     Router::NUMBER_OF_VERIFY_THREADS;
+constexpr std::size_t                     Router::MAX_VERIFY_BATCH;
+
 /**
  * Convert one address format to another
  *
@@ -210,22 +263,26 @@ Router::Router(NetworkId network_id, Address address, MuddleRegister const &reg,
   , network_id_(std::move(network_id))
   , prover_(prover)
   , sign_broadcasts_(prover && sign_broadcasts)
+  , routing_snapshot_(std::make_shared<RoutingTable const>())
   , dispatch_thread_pool_(network::MakeThreadPool(NUMBER_OF_ROUTER_THREADS, "Router"))
+  , verify_thread_pool_(network::MakeThreadPool(NUMBER_OF_VERIFY_THREADS, "Verify"))
 {}
 
 /**
- * Starts the routers internal dispatch thread pool
+ * Starts the routers internal dispatch and verification thread pools
  */
 void Router::Start()
 {
   dispatch_thread_pool_->Start();
+  verify_thread_pool_->Start();
 }
 
 /**
- * Stops the routers internal dispatch thread pool
+ * Stops the routers internal dispatch and verification thread pools
  */
 void Router::Stop()
 {
+  verify_thread_pool_->Stop();
   dispatch_thread_pool_->Stop();
 }
 
@@ -245,6 +302,24 @@ inline bool Router::Genuine(PacketPtr const &p) const
   return !prover_;
 }
 
+/**
+ * Internal: Format the (unsigned) routing handshake, which advertises our capabilities
+ *
+ * @return The handshake packet
+ */
+Router::PacketPtr Router::FormatHandshake() const
+{
+  auto packet = FormatDirect(address_, network_id_, SERVICE_MUDDLE, CHANNEL_ROUTING);
+
+  auto const capabilities = compressor_.EncodeCapabilities();
+  if (!capabilities.empty())
+  {
+    packet->SetPayload(capabilities);
+  }
+
+  return packet;
+}
+
 Router::PacketPtr const &Router::Sign(PacketPtr const &p) const
 {
   if (prover_ && (sign_broadcasts_ || !p->IsBroadcast()))
@@ -272,12 +347,158 @@ void Router::Route(Handle handle, PacketPtr packet)
     return;
   }
 
-  if (!Genuine(packet))
+  bool const forward_only =
+      !packet->IsDirect() && !packet->IsBroadcast() && (packet->GetTargetRaw() != address_raw_);
+
+  bool const compressed = packet->IsDirect() && (SERVICE_MUDDLE == packet->GetService()) &&
+                          (CHANNEL_COMPRESSED == packet->GetProtocol());
+
+  if (compressed)
+  {
+    // the frame carries no authority of its own, the packet inside is checked as if it had been
+    // received directly
+    DispatchCompressed(handle, *packet);
+  }
+  else if (forward_only)
+  {
+    // the signatures of packets which are only passing through are verified by their target
+    if (prover_ && !packet->IsStamped())
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Discarding unsigned packet: ", DescribePacket(*packet));
+      return;
+    }
+
+    RouteGenuine(handle, packet);
+  }
+  else if (RequiresVerification(*packet))
+  {
+    // signature checks are performed off the receiving thread
+    EnqueueVerification(handle, std::move(packet));
+  }
+  else if (Genuine(packet))
+  {
+    RouteGenuine(handle, packet);
+  }
+  else
   {
     FETCH_LOG_WARN(LOGGING_NAME, "Packet's authenticity not verified:", DescribePacket(*packet));
-    return;
+  }
+}
+
+/**
+ * Internal: Determine if establishing the authenticity of the packet requires a signature check
+ *
+ * @param packet The received packet
+ * @return true if the signature must be verified, otherwise false
+ */
+bool Router::RequiresVerification(Packet const &packet) const
+{
+  if (packet.IsBroadcast())
+  {
+    return sign_broadcasts_;
+  }
+
+  return packet.IsStamped();
+}
+
+/**
+ * Internal: Queue a received packet for signature verification. The packets of each connection
+ * are verified (and subsequently routed) in the order in which they were received.
+ *
+ * @param handle The handle of the receiving connection for the packet
+ * @param packet The packet to be verified
+ */
+void Router::EnqueueVerification(Handle handle, PacketPtr packet)
+{
+  bool schedule = false;
+  {
+    FETCH_LOCK(verify_lock_);
+
+    auto &queue = verify_queues_[handle];
+    queue.packets.emplace_back(std::move(packet));
+
+    // only one verification task is active for each connection
+    schedule        = !queue.scheduled;
+    queue.scheduled = true;
+  }
+
+  if (schedule)
+  {
+    verify_thread_pool_->Post([this, handle]() { VerifyPackets(handle); });
+  }
+}
+
+/**
+ * Internal: Verify and route a batch of the packets waiting for a connection. If there are still
+ * packets waiting the task is rescheduled so that the other connections are not starved.
+ *
+ * @param handle The handle of the connection
+ */
+void Router::VerifyPackets(Handle handle)
+{
+  std::vector<PacketPtr> packets;
+  {
+    FETCH_LOCK(verify_lock_);
+
+    auto it = verify_queues_.find(handle);
+    if (it == verify_queues_.end())
+    {
+      return;
+    }
+
+    auto &queue = it->second.packets;
+    while (!queue.empty() && (packets.size() < MAX_VERIFY_BATCH))
+    {
+      packets.emplace_back(std::move(queue.front()));
+      queue.pop_front();
+    }
+  }
+
+  for (auto &packet : packets)
+  {
+    if (Genuine(packet))
+    {
+      RouteGenuine(handle, std::move(packet));
+    }
+    else
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Packet's authenticity not verified:", DescribePacket(*packet));
+    }
+  }
+
+  bool reschedule = false;
+  {
+    FETCH_LOCK(verify_lock_);
+
+    auto it = verify_queues_.find(handle);
+    if (it != verify_queues_.end())
+    {
+      if (it->second.packets.empty())
+      {
+        verify_queues_.erase(it);
+      }
+      else
+      {
+        reschedule = true;
+      }
+    }
   }
 
+  if (reschedule)
+  {
+    verify_thread_pool_->Post([this, handle]() { VerifyPackets(handle); });
+  }
+}
+
+/**
+ * Internal: Routes a packet which has been received from the network and whose authenticity has
+ * been established (or which is only being forwarded)
+ *
+ * @param handle The handle of the receiving connection for the packet
+ * @param packet The input packet to route
+ */
+void Router::RouteGenuine(Handle handle, PacketPtr packet)
+{
   if (packet->IsDirect())
   {
     // when it is a direct message we must handle this
@@ -301,9 +522,9 @@ void Router::Route(Handle handle, PacketPtr packet)
   }
   else
   {
-    // update the routing table if required
-    // TODO(KLL): this may not be the association we're looking for.
-    AssociateHandleWithAddress(handle, packet->GetSenderRaw(), false);
+    // update the routing table, the hops travelled so far give the distance to the sender via
+    // this connection
+    AssociateHandleWithAddress(handle, packet->GetSenderRaw(), false, CalculateHops(*packet));
 
     // if this message does not belong to us we must route it along the path
     RoutePacket(packet);
@@ -322,11 +543,23 @@ void Router::Route(Handle handle, PacketPtr packet)
  */
 void Router::AddConnection(Handle handle)
 {
+  auto conn = register_.LookupConnection(handle).lock();
+  if (conn)
+  {
+    conn->SetHighWaterMark(high_water_mark_);
+  }
+
   // create and format the packet
-  auto packet = FormatDirect(address_, network_id_, SERVICE_MUDDLE, CHANNEL_ROUTING);
+  auto packet = FormatHandshake();
   packet->SetExchange(true);  // signal that this is the request half of a direct message
   Sign(packet);
 
+  // the response to the exchange gives the round trip time of the connection
+  {
+    FETCH_LOCK(routing_table_lock_);
+    pending_pings_[handle] = Clock::now();
+  }
+
   // send it
   SendToConnection(handle, packet);
 }
@@ -355,9 +588,8 @@ void Router::Send(Address const &address, uint16_t service, uint16_t channel,
   auto packet =
       FormatPacket(address_, network_id_, service, channel, counter, DEFAULT_TTL, message);
   packet->SetTarget(address);
-  Sign(packet);
 
-  RoutePacket(packet, false);
+  SendPacket(packet);
 }
 
 /**
@@ -376,12 +608,11 @@ void Router::Send(Address const &address, uint16_t service, uint16_t channel, ui
   auto packet =
       FormatPacket(address_, network_id_, service, channel, message_num, DEFAULT_TTL, payload);
   packet->SetTarget(address);
-  Sign(packet);
 
   FETCH_LOG_DEBUG(LOGGING_NAME, "Exchange Response: ", ToBase64(address), " (", service, '-',
                   channel, '-', message_num, ")");
 
-  RoutePacket(packet, false);
+  SendPacket(packet);
 }
 
 /**
@@ -411,8 +642,7 @@ void Router::Broadcast(uint16_t service, uint16_t channel, Payload const &payloa
  */
 Router::RoutingTable Router::GetRoutingTable() const
 {
-  FETCH_LOCK(routing_table_lock_);
-  return routing_table_;
+  return *LoadRoutingTable();
 }
 
 /**
@@ -457,9 +687,17 @@ void Router::Debug(std::string const &prefix) const
     std::copy(routing.first.begin(), routing.first.end(), output.pointer());
     FETCH_LOG_WARN(LOGGING_NAME, prefix, static_cast<std::string>(ToBase64(output)),
                    " -> handle=", std::to_string(routing.second.handle),
-                   " direct=", routing.second.direct);
+                   " direct=", routing.second.direct, " hops=", std::to_string(routing.second.hops),
+                   " latency=", routing.second.latency_us, "us routes=",
+                   route_candidates_.at(routing.first).size());
   }
   FETCH_LOG_WARN(LOGGING_NAME, prefix, "routing_table_: --------------------------------------");
+
+  auto const stats = echo_cache_.GetStats();
+  FETCH_LOG_WARN(LOGGING_NAME, prefix, "broadcasts: ", stats.inserted,
+                 " suppressed: ", stats.suppressed, " rotations: ", stats.rotations,
+                 " forced: ", stats.forced_rotations);
+
   registrar_.Debug(prefix);
 }
 
@@ -469,7 +707,53 @@ void Router::Debug(std::string const &prefix) const
  */
 void Router::Cleanup()
 {
-  CleanEchoCache();
+  // the echo cache ages out its own entries as broadcasts are inserted, so there is nothing to be
+  // done here at the moment
+}
+
+Router::BroadcastStats Router::GetBroadcastStats() const
+{
+  return echo_cache_.GetStats();
+}
+
+/**
+ * Configure how packets for congested connections are handled
+ *
+ * @param policy The policy to be applied
+ * @param block_timeout The maximum time a sender is blocked for, when blocking
+ */
+void Router::SetBackpressurePolicy(BackpressurePolicy policy,
+                                   std::chrono::milliseconds block_timeout)
+{
+  backpressure_policy_ = policy;
+  block_timeout_ms_    = block_timeout.count();
+}
+
+/**
+ * Set the maximum number of bytes queued for sending on each connection. Applies to connections
+ * which are added afterwards.
+ *
+ * @param bytes The high water mark in bytes
+ */
+void Router::SetHighWaterMark(std::size_t bytes)
+{
+  high_water_mark_ = bytes;
+}
+
+/**
+ * Get the statistics of the handling of congested connections
+ *
+ * @return The current statistics
+ */
+Router::BackpressureStats Router::GetBackpressureStats() const
+{
+  BackpressureStats stats;
+  stats.congested = congested_packets_;
+  stats.dropped   = dropped_packets_;
+  stats.blocked   = blocked_packets_;
+  stats.rerouted  = rerouted_packets_;
+
+  return stats;
 }
 
 /**
@@ -497,9 +781,8 @@ Router::Response Router::Exchange(Address const &address, uint16_t service, uint
       FormatPacket(address_, network_id_, service, channel, counter, DEFAULT_TTL, request);
   packet->SetTarget(address);
   packet->SetExchange();
-  Sign(packet);
 
-  RoutePacket(packet, false);
+  SendPacket(packet);
 
   // return the response
   return Response(std::move(promise));
@@ -535,8 +818,8 @@ MuddleEndpoint::AddressList Router::GetDirectlyConnectedPeers() const
 {
   AddressList addresses{};
 
-  FETCH_LOCK(routing_table_lock_);
-  for (auto const &entry : routing_table_)
+  auto const routing_table = LoadRoutingTable();
+  for (auto const &entry : *routing_table)
   {
     if (entry.second.direct)
     {
@@ -561,13 +844,13 @@ MuddleEndpoint::AddressList Router::GetDirectlyConnectedPeers() const
  */
 bool Router::IsConnected(Address const &target) const
 {
-  FETCH_LOCK(routing_table_lock_);
+  auto const routing_table = LoadRoutingTable();
 
   auto raw_address = ConvertAddress(target);
-  auto iter        = routing_table_.find(raw_address);
+  auto iter        = routing_table->find(raw_address);
   bool connected   = false;
 
-  if (iter != routing_table_.end())
+  if (iter != routing_table->end())
   {
     auto conn = register_.LookupConnection(iter->second.handle).lock();
     if (conn)
@@ -580,24 +863,22 @@ bool Router::IsConnected(Address const &target) const
 }
 
 /**
- * Internal: Add an entry into the routing table for the given address and handle.
+ * Internal: Add a route into the routing table for the given address and handle.
  *
- * This call might override an existing routing table entry in the case that the connection
- * becomes direct, or is updated to an alternate direct connection.
+ * Each address can be reached through a number of handles. The best of these routes is selected
+ * for the published routing table, which is replaced when the selection changes.
  *
  * @param handle The handle to the connection
  * @param address The address associated with that handle
  * @param direct Signal that this connection is a direct connection
- * @return true if an update was performed, otherwise false
+ * @param hops The number of hops to the address via the handle
+ * @return true if the selected route for the address was changed, otherwise false
  */
 bool Router::AssociateHandleWithAddress(Handle handle, Packet::RawAddress const &address,
-                                        bool direct)
+                                        bool direct, uint8_t hops)
 {
   bool update_complete = false;
 
-  // At the moment these updates (and by extension the routing logic) works on a first
-  // come first served basis. This is not reliable longer term and will need tweaking
-
   // sanity check
   assert(handle);
 
@@ -606,46 +887,53 @@ bool Router::AssociateHandleWithAddress(Handle handle, Packet::RawAddress const
   {
     FETCH_LOCK(routing_table_lock_);
 
-    // lookup (or create) the routing table entry
-    auto &routing_data = routing_table_[address];
+    auto &routes = route_candidates_[address];
 
-    bool const is_empty = (routing_data.handle == 0);
+    auto it = std::find_if(routes.begin(), routes.end(),
+                           [handle](RoutingData const &route) { return route.handle == handle; });
 
-    // an update is only valid when the connection is direct.
-    bool const is_different = (routing_data.handle != handle) || (routing_data.direct != direct);
-    bool const is_update    = (routing_data.handle && direct && is_different);
-
-    // update the routing table if required
-    if (is_empty || is_update)
+    if (it == routes.end())
     {
-      // replacing an existing entry
-      Handle prev_handle = routing_data.handle;
-
-      // update the table
-      routing_data.handle = handle;
-      routing_data.direct = direct;
+      RoutingData route;
+      route.handle = handle;
+      route.direct = direct;
+      route.hops   = (direct) ? uint8_t{1} : hops;
 
-      // remove association of the previous handle with the address (if required)
-      if (prev_handle)
+      auto const latency_it = handle_latency_.find(handle);
+      if (latency_it != handle_latency_.end())
       {
-        routing_table_handles_[prev_handle].erase(address);
+        route.latency_us = latency_it->second;
       }
 
-      // associate the new handle with the address
+      routes.push_back(route);
       routing_table_handles_[handle].insert(address);
 
-      // signal an update was made to the table
-      update_complete = true;
-
-      if (direct)
+      // only keep the best few routes to any address
+      if (routes.size() > MAX_ROUTES_PER_ADDRESS)
       {
-        direct_address_map_[handle] = ToConstByteArray(address);
-        if (prev_handle)
-        {
-          direct_address_map_.erase(prev_handle);
-        }
+        auto worst = std::max_element(routes.begin(), routes.end(), IsBetterRoute);
+
+        routing_table_handles_[worst->handle].erase(address);
+        routes.erase(worst);
       }
     }
+    else
+    {
+      // update the metrics of the existing route
+      it->direct = it->direct || direct;
+      it->hops   = (it->direct) ? uint8_t{1} : hops;
+    }
+
+    if (direct)
+    {
+      direct_address_map_[handle] = ToConstByteArray(address);
+    }
+
+    update_complete = SelectRoute(address);
+    if (update_complete)
+    {
+      PublishRoutingTable();
+    }
   }
 
   if (update_complete)
@@ -659,6 +947,145 @@ bool Router::AssociateHandleWithAddress(Handle handle, Packet::RawAddress const
   return update_complete;
 }
 
+/**
+ * Internal: Update the writer's copy of the routing table with the best of the known routes to an
+ * address
+ *
+ * @param address The address to be updated
+ * @return true if the selected route was changed, otherwise false
+ */
+bool Router::SelectRoute(RawAddress const &address)
+{
+  auto candidates_it = route_candidates_.find(address);
+  if ((candidates_it == route_candidates_.end()) || candidates_it->second.empty())
+  {
+    if (candidates_it != route_candidates_.end())
+    {
+      route_candidates_.erase(candidates_it);
+    }
+
+    return routing_table_.erase(address) > 0;
+  }
+
+  auto const &routes = candidates_it->second;
+  auto const &best   = *std::min_element(routes.begin(), routes.end(), IsBetterRoute);
+
+  auto &current = routing_table_[address];
+
+  bool const is_different = (current.handle != best.handle) || (current.direct != best.direct) ||
+                            (current.hops != best.hops) || (current.latency_us != best.latency_us);
+
+  current = best;
+
+  return is_different;
+}
+
+/**
+ * Internal: Remove all the routes which use a given handle
+ *
+ * @param handle The handle of the connection which has been removed
+ */
+void Router::RemoveRoutes(Handle handle)
+{
+  bool updated = false;
+
+  auto const handle_it = routing_table_handles_.find(handle);
+  if (handle_it != routing_table_handles_.end())
+  {
+    for (auto const &address : handle_it->second)
+    {
+      auto &routes = route_candidates_[address];
+      routes.erase(std::remove_if(routes.begin(), routes.end(),
+                                  [handle](RoutingData const &route) {
+                                    return route.handle == handle;
+                                  }),
+                   routes.end());
+
+      updated |= SelectRoute(address);
+    }
+
+    routing_table_handles_.erase(handle_it);
+  }
+
+  pending_pings_.erase(handle);
+  handle_latency_.erase(handle);
+  direct_address_map_.erase(handle);
+
+  if (updated)
+  {
+    PublishRoutingTable();
+  }
+}
+
+/**
+ * Internal: Record a round trip time measurement for a connection and update the routes using it
+ *
+ * @param handle The handle of the connection
+ * @param latency_us The measured round trip time in microseconds
+ */
+void Router::RecordLatency(Handle handle, uint32_t latency_us)
+{
+  // avoid the reserved unknown value
+  latency_us = std::max(latency_us, 1u);
+
+  // smooth successive measurements
+  auto &latency = handle_latency_[handle];
+  if (latency == 0)
+  {
+    latency = latency_us;
+  }
+  else
+  {
+    latency = static_cast<uint32_t>((uint64_t{latency} * 7u + latency_us) / 8u);
+  }
+
+  bool updated = false;
+
+  auto const handle_it = routing_table_handles_.find(handle);
+  if (handle_it != routing_table_handles_.end())
+  {
+    for (auto const &address : handle_it->second)
+    {
+      for (auto &route : route_candidates_[address])
+      {
+        if (route.handle == handle)
+        {
+          route.latency_us = latency;
+        }
+      }
+
+      updated |= SelectRoute(address);
+    }
+  }
+
+  if (updated)
+  {
+    PublishRoutingTable();
+  }
+}
+
+/**
+ * Internal: Replace the published routing table with a copy of the writer's routing table
+ */
+void Router::PublishRoutingTable()
+{
+  std::atomic_store(&routing_snapshot_,
+                    RoutingTablePtr{std::make_shared<RoutingTable const>(routing_table_)});
+
+  routing_updates_.Apply([](uint64_t &updates) { ++updates; });
+}
+
+/**
+ * Internal: Get the current published routing table. The snapshot remains valid (and unchanged)
+ * for as long as the caller holds it.
+ *
+ * @return The routing table snapshot
+ */
+Router::RoutingTablePtr Router::LoadRoutingTable() const
+{
+  return std::atomic_load(&routing_snapshot_);
+}
+
 /**
  * Internal: Looks up the specified connection handle from a given address
  *
@@ -681,16 +1108,14 @@ Router::Handle Router::LookupHandle(Packet::RawAddress const &address) const
 {
   Handle handle = 0;
 
-  {
-    FETCH_LOCK(routing_table_lock_);
+  auto const routing_table = LoadRoutingTable();
 
-    auto address_it = routing_table_.find(address);
-    if (address_it != routing_table_.end())
-    {
-      auto const &routing_data = address_it->second;
+  auto address_it = routing_table->find(address);
+  if (address_it != routing_table->end())
+  {
+    auto const &routing_data = address_it->second;
 
-      handle = routing_data.handle;
-    }
+    handle = routing_data.handle;
   }
 
   return handle;
@@ -706,24 +1131,21 @@ Router::Handle Router::LookupRandomHandle(Packet::RawAddress const & /*address*/
   static std::random_device rd;
   static std::mt19937       rng(rd());
 
-  {
-    FETCH_LOCK(routing_table_lock_);
+  auto const routing_table = LoadRoutingTable();
 
-    if (!routing_table_.empty())
-    {
-      // decide the random index to access
-      std::uniform_int_distribution<decltype(routing_table_)::size_type> distro(
-          0, routing_table_.size() - 1);
-      std::size_t const element = distro(rng);
+  if (!routing_table->empty())
+  {
+    // decide the random index to access
+    std::uniform_int_distribution<RoutingTable::size_type> distro(0, routing_table->size() - 1);
+    std::size_t const element = distro(rng);
 
-      // advance the iterator to the correct offset
-      auto it = routing_table_.cbegin();
-      std::advance(it, static_cast<std::ptrdiff_t>(element));
+    // advance the iterator to the correct offset
+    auto it = routing_table->cbegin();
+    std::advance(it, static_cast<std::ptrdiff_t>(element));
 
-      assert(it != routing_table_.cend());
+    assert(it != routing_table->cend());
 
-      return it->second.handle;
-    }
+    return it->second.handle;
   }
 
   return 0;
@@ -741,13 +1163,19 @@ void Router::KillConnection(Handle handle, Address const &peer)
   {
     FETCH_LOCK(routing_table_lock_);
     conn->Close();
-    routing_table_.erase(ConvertAddress(peer));
-    direct_address_map_.erase(handle);
+
+    // any alternative routes to the peer (or via it) take over
+    RemoveRoutes(handle);
+
+    FETCH_LOG_INFO(LOGGING_NAME, "Removed routes via handle: ", handle, " to: ", ToBase64(peer));
   }
   else
   {
     FETCH_LOG_WARN(LOGGING_NAME, "No connection object available to KillConnection(", handle, ")");
   }
+
+  FETCH_LOCK(compression_lock_);
+  compressed_handles_.erase(handle);
 }
 
 /**
@@ -786,8 +1214,21 @@ void Router::SendToConnection(Handle handle, PacketPtr packet)
   // internal method, we expect all inputs be valid at this stage
   assert(static_cast<bool>(packet));
 
+  auto const priority = dispatcher_.GetPriority(packet->GetService(), packet->GetProtocol());
+
   // lookup the connection
   auto conn = register_.LookupConnection(handle).lock();
+
+  // high priority packets use the headroom above the high water mark instead
+  if (conn && (priority != network::MessagePriority::HIGH) && conn->IsCongested() &&
+      !RelieveBackpressure(handle, conn, *packet))
+  {
+    ++dropped_packets_;
+
+    FETCH_LOG_DEBUG(LOGGING_NAME, "Dropping packet for congested handle: ", handle);
+    return;
+  }
+
   if (conn)
   {
     // determine if this packet originated from this node and that we are expecting an exchange
@@ -800,14 +1241,18 @@ void Router::SendToConnection(Handle handle, PacketPtr packet)
                                 packet->GetMessageNum());
     }
 
-    // serialize the packet to the buffer
-    serializers::ByteArrayBuffer buffer;
-    buffer << *packet;
-
     FETCH_LOG_DEBUG(LOGGING_NAME, "Sending out", DescribePacket(*packet));
 
-    // dispatch to the connection object
-    conn->Send(buffer.data());
+    // dispatch the encoded packet to the connection object, ahead of lower priority traffic
+    bool use_dictionary{false};
+    if (LookupCompression(handle, use_dictionary))
+    {
+      conn->SendWithPriority(EncodeCompressed(*packet, use_dictionary), priority);
+    }
+    else
+    {
+      conn->SendWithPriority(packet->GetWireBuffer(), priority);
+    }
   }
   else
   {
@@ -815,6 +1260,345 @@ void Router::SendToConnection(Handle handle, PacketPtr packet)
   }
 }
 
+/**
+ * Internal: Broadcast a packet to all of the direct peers, compressed for those which accept it.
+ * The packet is compressed at most once with and once without our dictionary.
+ *
+ * @param packet The packet to be broadcast
+ */
+void Router::BroadcastPacket(PacketPtr const &packet)
+{
+  auto const priority = dispatcher_.GetPriority(packet->GetService(), packet->GetProtocol());
+
+  if (!compressor_.enabled())
+  {
+    register_.Broadcast(packet->GetWireBuffer(), priority);
+    return;
+  }
+
+  std::array<Packet::WireBuffer, 2> encoded{};
+  register_.Broadcast(
+      [this, &packet, &encoded](Handle handle) -> Packet::WireBuffer {
+        bool use_dictionary{false};
+        if (!LookupCompression(handle, use_dictionary))
+        {
+          return packet->GetWireBuffer();
+        }
+
+        auto &buffer = encoded[use_dictionary ? 1 : 0];
+        if (buffer.empty())
+        {
+          buffer = EncodeCompressed(*packet, use_dictionary);
+        }
+
+        return buffer;
+      },
+      priority);
+}
+
+/**
+ * Internal: Apply the backpressure policy to a packet destined for a congested connection
+ *
+ * @param handle The handle of the connection, updated if the packet is rerouted
+ * @param conn The connection, updated if the packet is rerouted
+ * @param packet The packet to be sent
+ * @return true if the packet should be sent to the (updated) connection, false if it is dropped
+ */
+bool Router::RelieveBackpressure(Handle &handle, network::AbstractConnection::shared_type &conn,
+                                 Packet const &packet)
+{
+  ++congested_packets_;
+
+  switch (backpressure_policy_.load())
+  {
+  case BackpressurePolicy::BLOCK:
+    if (conn->WaitForSendCapacity(std::chrono::milliseconds{block_timeout_ms_}))
+    {
+      ++blocked_packets_;
+      return true;
+    }
+    break;
+
+  case BackpressurePolicy::REROUTE:
+    // direct packets are only meaningful to the peer they are addressed to
+    if (!packet.IsDirect())
+    {
+      Handle const alternative = LookupLeastLoadedHandle(handle);
+      auto         alt_conn    = register_.LookupConnection(alternative).lock();
+
+      if (alt_conn)
+      {
+        ++rerouted_packets_;
+
+        handle = alternative;
+        conn   = std::move(alt_conn);
+        return true;
+      }
+    }
+    break;
+
+  case BackpressurePolicy::DROP:
+    break;
+  }
+
+  return false;
+}
+
+/**
+ * Internal: Looks up the direct connection with the fewest bytes waiting to be sent, which is not
+ * congested
+ *
+ * @param exclude A handle which should not be selected
+ * @return The handle of the connection, or zero if there is none
+ */
+Router::Handle Router::LookupLeastLoadedHandle(Handle exclude) const
+{
+  Handle      handle    = 0;
+  std::size_t min_bytes = 0;
+
+  FETCH_LOCK(routing_table_lock_);
+  for (auto const &entry : direct_address_map_)
+  {
+    if (entry.first == exclude)
+    {
+      continue;
+    }
+
+    auto conn = register_.LookupConnection(entry.first).lock();
+    if (conn && conn->is_alive() && !conn->IsCongested())
+    {
+      std::size_t const bytes = conn->queued_bytes();
+      if ((handle == 0) || (bytes < min_bytes))
+      {
+        handle    = entry.first;
+        min_bytes = bytes;
+      }
+    }
+  }
+
+  return handle;
+}
+
+/**
+ * Set the window during which packets to the same direct peer are collected and sent as a single
+ * batch (with a single signature)
+ *
+ * @param milliseconds The duration of the window, zero disables batching
+ */
+void Router::SetBatchWindow(uint32_t milliseconds)
+{
+  batch_window_ms_ = milliseconds;
+}
+
+/**
+ * Set the compression of the packets sent to direct peers. Compression is advertised in the
+ * routing handshake, so the options must be set before connections are made.
+ *
+ * @param options The compression options
+ */
+void Router::SetCompression(CompressionOptions options)
+{
+  compressor_.SetOptions(std::move(options));
+}
+
+/**
+ * Get the statistics of the compression of packets
+ *
+ * @return The current statistics
+ */
+Router::CompressionStats Router::GetCompressionStats() const
+{
+  CompressionStats stats;
+  stats.compressed       = compressed_packets_;
+  stats.raw_bytes        = compressed_raw_bytes_;
+  stats.compressed_bytes = compressed_wire_bytes_;
+  stats.decompressed     = decompressed_packets_;
+  stats.rejected         = rejected_compressed_packets_;
+
+  return stats;
+}
+
+/**
+ * Get the depth of the queues of packets waiting to be sent to, or received from, direct peers
+ *
+ * @return The current queue depths
+ */
+Router::QueueStats Router::GetQueueStats() const
+{
+  QueueStats stats;
+
+  {
+    FETCH_LOCK(routing_table_lock_);
+    for (auto const &entry : direct_address_map_)
+    {
+      auto conn = register_.LookupConnection(entry.first).lock();
+      if (conn && conn->is_alive())
+      {
+        std::size_t const bytes = conn->queued_bytes();
+
+        ++stats.connections;
+        stats.queued_bytes += bytes;
+        stats.max_queued_bytes = std::max(stats.max_queued_bytes, bytes);
+
+        if (conn->IsCongested())
+        {
+          ++stats.congested;
+        }
+      }
+    }
+  }
+
+  {
+    FETCH_LOCK(batch_lock_);
+    for (auto const &entry : batches_)
+    {
+      stats.batched_packets += entry.second.packets.size();
+    }
+  }
+
+  {
+    FETCH_LOCK(verify_lock_);
+    for (auto const &entry : verify_queues_)
+    {
+      stats.verify_backlog += entry.second.packets.size();
+    }
+  }
+
+  return stats;
+}
+
+/**
+ * Internal: Send a packet originating from this node, either as part of a batch or signed and
+ * routed individually
+ *
+ * @param packet The packet to be sent
+ */
+void Router::SendPacket(PacketPtr packet)
+{
+  if (!AddToBatch(packet))
+  {
+    RoutePacket(Sign(packet), false);
+  }
+}
+
+/**
+ * Internal: Add an (unsigned) packet to the batch for its next hop. Only packets targeted at
+ * direct peers can be batched since the signature of a batch only covers a single hop.
+ *
+ * @param packet The packet to be batched
+ * @return true if the packet was added to a batch, otherwise false
+ */
+bool Router::AddToBatch(PacketPtr const &packet)
+{
+  uint32_t const window_ms = batch_window_ms_;
+  if ((window_ms == 0) || packet->IsBroadcast() || packet->IsDirect())
+  {
+    return false;
+  }
+
+  // high priority packets are never delayed
+  if (dispatcher_.GetPriority(packet->GetService(), packet->GetProtocol()) ==
+      network::MessagePriority::HIGH)
+  {
+    return false;
+  }
+
+  Handle handle = 0;
+  {
+    auto const routing_table = LoadRoutingTable();
+
+    auto const it = routing_table->find(packet->GetTargetRaw());
+    if ((it == routing_table->end()) || !it->second.direct)
+    {
+      return false;
+    }
+
+    handle = it->second.handle;
+  }
+
+  bool schedule = false;
+  bool flush    = false;
+  {
+    FETCH_LOCK(batch_lock_);
+
+    auto &batch = batches_[handle];
+    schedule    = batch.packets.empty();
+
+    batch.packets.push_back(packet);
+    batch.bytes += Packet::HEADER_SIZE + packet->GetPayload().size();
+
+    flush = (batch.packets.size() >= MAX_BATCH_PACKETS) || (batch.bytes >= MAX_BATCH_BYTES);
+  }
+
+  if (flush)
+  {
+    FlushBatch(handle);
+  }
+  else if (schedule)
+  {
+    dispatch_thread_pool_->Post([this, handle]() { FlushBatch(handle); }, window_ms);
+  }
+
+  return true;
+}
+
+/**
+ * Internal: Sign and send the packets which have been batched for a connection
+ *
+ * @param handle The handle to the connection
+ */
+void Router::FlushBatch(Handle handle)
+{
+  std::vector<PacketPtr> packets;
+  {
+    FETCH_LOCK(batch_lock_);
+
+    auto it = batches_.find(handle);
+    if (it == batches_.end())
+    {
+      return;
+    }
+
+    packets = std::move(it->second.packets);
+    batches_.erase(it);
+  }
+
+  if (packets.empty())
+  {
+    return;
+  }
+
+  // there is no benefit in wrapping a single packet
+  if (packets.size() == 1)
+  {
+    SendToConnection(handle, Sign(packets.front()));
+    return;
+  }
+
+  std::vector<Packet::WireBuffer> buffers;
+  buffers.reserve(packets.size());
+
+  for (auto const &packet : packets)
+  {
+    // the promises of the exchanges are associated with the connection as for individual packets
+    if (packet->IsExchange())
+    {
+      dispatcher_.NotifyMessage(handle, packet->GetService(), packet->GetProtocol(),
+                                packet->GetMessageNum());
+    }
+
+    buffers.emplace_back(packet->GetWireBuffer());
+  }
+
+  serializers::ByteArrayBuffer serializer;
+  serializer << buffers;
+
+  auto batch = FormatDirect(address_, network_id_, SERVICE_MUDDLE, CHANNEL_BATCH);
+  batch->SetPayload(serializer.data());
+
+  SendToConnection(handle, Sign(batch));
+}
+
 /**
  * Attempt to route the packet to the require address(es)
  *
@@ -852,12 +1636,8 @@ void Router::RoutePacket(PacketPtr packet, bool external)
       DispatchPacket(packet, address_);
     }
 
-    // serialize the packet to the buffer
-    serializers::ByteArrayBuffer buffer;
-    buffer << *packet;
-
-    // broadcast the data across the network
-    register_.Broadcast(buffer.data());
+    // broadcast the encoded packet across the network
+    BroadcastPacket(packet);
   }
   else
   {
@@ -905,15 +1685,193 @@ void Router::DispatchDirect(Handle handle, PacketPtr packet)
       }
 
       // make the association with
-      AssociateHandleWithAddress(handle, packet->GetSenderRaw(), true);
+      AssociateHandleWithAddress(handle, packet->GetSenderRaw(), true, 1);
+
+      // the handshake advertises which compression the peer accepts
+      UpdateCompression(handle, packet->GetPayload());
+
+      // the response to our exchange completes the round trip time measurement
+      if (!packet->IsExchange())
+      {
+        FETCH_LOCK(routing_table_lock_);
+
+        auto const ping_it = pending_pings_.find(handle);
+        if (ping_it != pending_pings_.end())
+        {
+          auto const elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+              Clock::now() - ping_it->second);
+          pending_pings_.erase(ping_it);
+
+          RecordLatency(handle, static_cast<uint32_t>(std::min<std::chrono::microseconds::rep>(
+                                    elapsed.count(), std::numeric_limits<uint32_t>::max())));
+        }
+      }
 
       // send back a direct response if that is required
       if (packet->IsExchange())
       {
-        SendToConnection(
-            handle, Sign(FormatDirect(address_, network_id_, SERVICE_MUDDLE, CHANNEL_ROUTING)));
+        SendToConnection(handle, Sign(FormatHandshake()));
       }
     }
+    else if (CHANNEL_BATCH == packet->GetProtocol())
+    {
+      DispatchBatch(handle, *packet);
+    }
+  }
+}
+
+/**
+ * Internal: Unpack and route the packets of a batch received from a single hop peer
+ *
+ * Packets from the peer which are targeted at this node are covered by the signature of the
+ * batch, all other packets are required to be genuine in their own right.
+ *
+ * @param handle The handle to the originating connection
+ * @param batch The batch packet that was received
+ */
+void Router::DispatchBatch(Handle handle, Packet const &batch)
+{
+  std::vector<Packet::WireBuffer> buffers;
+
+  serializers::ByteArrayBuffer serializer{batch.GetPayload()};
+  serializer >> buffers;
+
+  for (auto const &buffer : buffers)
+  {
+    auto packet = std::make_shared<Packet>();
+    packet->FromWireBuffer(buffer);
+
+    bool const covered = !packet->IsDirect() && !packet->IsBroadcast() &&
+                         (packet->GetSenderRaw() == batch.GetSenderRaw()) &&
+                         (packet->GetTargetRaw() == address_raw_);
+
+    if ((packet->GetNetworkId() != network_id_.value()) || !(covered || Genuine(packet)))
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Discarding batched packet: ", DescribePacket(*packet));
+      continue;
+    }
+
+    RouteGenuine(handle, packet);
+  }
+}
+
+/**
+ * Internal: Decompress and route the packet contained in a compressed frame from a single hop peer
+ *
+ * @param handle The handle to the originating connection
+ * @param frame The compressed frame that was received
+ */
+void Router::DispatchCompressed(Handle handle, Packet const &frame)
+{
+  Packet::WireBuffer decompressed;
+  if (!compressor_.Decompress(frame.GetPayload(), decompressed))
+  {
+    ++rejected_compressed_packets_;
+
+    FETCH_LOG_WARN(LOGGING_NAME, "Discarding unreadable compressed packet: ",
+                   DescribePacket(frame));
+    return;
+  }
+
+  auto packet = std::make_shared<Packet>();
+  packet->FromWireBuffer(decompressed);
+
+  // frames are never nested
+  if (packet->IsDirect() && (SERVICE_MUDDLE == packet->GetService()) &&
+      (CHANNEL_COMPRESSED == packet->GetProtocol()))
+  {
+    ++rejected_compressed_packets_;
+
+    FETCH_LOG_WARN(LOGGING_NAME, "Discarding nested compressed packet: ", DescribePacket(frame));
+    return;
+  }
+
+  ++decompressed_packets_;
+
+  Route(handle, packet);
+}
+
+/**
+ * Internal: Determine if the packets sent to a connection should be compressed
+ *
+ * @param handle The handle of the connection
+ * @param use_dictionary Set if the peer shares our preset dictionary
+ * @return true if the packets should be compressed, otherwise false
+ */
+bool Router::LookupCompression(Handle handle, bool &use_dictionary) const
+{
+  FETCH_LOCK(compression_lock_);
+
+  auto const it = compressed_handles_.find(handle);
+  if (it == compressed_handles_.end())
+  {
+    return false;
+  }
+
+  use_dictionary = it->second;
+  return true;
+}
+
+/**
+ * Internal: Encode a packet as a compressed frame, unless it is too small or does not compress
+ *
+ * @param packet The packet to be sent
+ * @param use_dictionary Flag to signal that the peer shares our preset dictionary
+ * @return The encoded frame, or the encoded packet itself
+ */
+Packet::WireBuffer Router::EncodeCompressed(Packet const &packet, bool use_dictionary)
+{
+  auto const &wire = packet.GetWireBuffer();
+
+  Packet::Payload compressed;
+  if (!compressor_.Compress(wire, use_dictionary, compressed) ||
+      ((compressed.size() + Packet::HEADER_SIZE) >= wire.size()))
+  {
+    return wire;
+  }
+
+  // the frame is unsigned, it only covers a single hop and the packet inside keeps its signature
+  auto frame = FormatDirect(address_, network_id_, SERVICE_MUDDLE, CHANNEL_COMPRESSED);
+  frame->SetPayload(compressed);
+
+  auto const &encoded = frame->GetWireBuffer();
+
+  ++compressed_packets_;
+  compressed_raw_bytes_ += wire.size();
+  compressed_wire_bytes_ += encoded.size();
+
+  return encoded;
+}
+
+/**
+ * Internal: Record the compression advertised by a peer in its routing handshake. Packets are
+ * only compressed if both sides support it and the connection is not on the local network.
+ *
+ * @param handle The handle of the connection to the peer
+ * @param capabilities The payload of the handshake
+ */
+void Router::UpdateCompression(Handle handle, Payload const &capabilities)
+{
+  auto const peer = PacketCompressor::DecodeCapabilities(capabilities);
+
+  std::string address;
+  if (auto conn = register_.LookupConnection(handle).lock())
+  {
+    address = conn->Address();
+  }
+
+  bool const compress = compressor_.ShouldCompress(peer, address);
+  bool const use_dictionary =
+      (peer.dictionary != 0) && (peer.dictionary == compressor_.dictionary_id());
+
+  FETCH_LOCK(compression_lock_);
+  if (compress)
+  {
+    compressed_handles_[handle] = use_dictionary;
+  }
+  else
+  {
+    compressed_handles_.erase(handle);
   }
 }
 
@@ -924,7 +1882,18 @@ void Router::DispatchDirect(Handle handle, PacketPtr packet)
  */
 void Router::DispatchPacket(PacketPtr packet, Address transmitter)
 {
-  dispatch_thread_pool_->Post([this, packet, transmitter]() {
+  // packets are queued by priority, each work item dispatches the highest priority packet which is
+  // waiting at the time it runs (not necessarily the one which scheduled it)
+  dispatcher_.Enqueue(std::move(packet), transmitter);
+
+  dispatch_thread_pool_->Post([this]() {
+    PacketPtr packet;
+    Address   transmitter;
+    if (!dispatcher_.Dequeue(packet, transmitter))
+    {
+      return;
+    }
+
     bool const isPossibleExchangeResponse = !packet->IsExchange();
 
     // determine if this was an exchange based node
@@ -956,57 +1925,14 @@ void Router::DispatchPacket(PacketPtr packet, Address transmitter)
  */
 bool Router::IsEcho(Packet const &packet, bool register_echo)
 {
-  bool is_echo = true;
-
-  // combine the 3 fields together into a single index
   std::size_t const index = GenerateEchoId(packet);
 
+  if (register_echo)
   {
-    FETCH_LOCK(echo_cache_lock_);
-
-    // lookup if the echo is in the cache
-    auto it = echo_cache_.find(index);
-    if (it == echo_cache_.end())
-    {
-      // register the echo (in needed)
-      if (register_echo)
-      {
-        echo_cache_[index] = Clock::now();
-      }
-
-      is_echo = false;
-    }
+    return !echo_cache_.Insert(index);
   }
 
-  return is_echo;
-}
-
-/**
- * Periodic function used to trim the echo cache
- */
-void Router::CleanEchoCache()
-{
-  FETCH_LOCK(echo_cache_lock_);
-
-  auto const now = Clock::now();
-
-  auto it = echo_cache_.begin();
-  while (it != echo_cache_.end())
-  {
-    // calculate the time delta
-    auto const delta = now - it->second;
-
-    if (delta > std::chrono::seconds{30})
-    {
-      // remove the element
-      it = echo_cache_.erase(it);
-    }
-    else
-    {
-      // move on to the next element in the cache
-      ++it;
-    }
-  }
+  return echo_cache_.Contains(index);
 }
 
 void Router::Blacklist(Address const &target)
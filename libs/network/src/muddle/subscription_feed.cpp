@@ -19,6 +19,9 @@
 #include "network/muddle/subscription_feed.hpp"
 #include "core/mutex.hpp"
 
+#include <utility>
+#include <vector>
+
 namespace fetch {
 namespace muddle {
 
@@ -52,32 +55,37 @@ bool SubscriptionFeed::Dispatch(Address const &address, uint16_t service, uint16
                                 uint16_t counter, Payload const &payload,
                                 Address const &transmitter)
 {
-  FETCH_LOCK(feed_lock_);
-
-  bool success = false;
+  std::vector<SubscriptionPtr> subscriptions;
 
-  // loop through the subscriptions
-  auto it = feed_.cbegin();
-  while (it != feed_.cend())
   {
-    // check
-    auto subscription = it->lock();
-    if (subscription)
-    {
-      // dispatch the message to the handler
-      subscription->Dispatch(address, service, channel, counter, payload, transmitter);
+    FETCH_LOCK(feed_lock_);
+    subscriptions.reserve(feed_.size());
 
-      success = true;
-      ++it;
-    }
-    else
+    // collect the live subscriptions and remove those which are dead
+    auto it = feed_.cbegin();
+    while (it != feed_.cend())
     {
-      // if the subscription is dead then remove it from our list
-      it = feed_.erase(it);
+      auto subscription = it->lock();
+      if (subscription)
+      {
+        subscriptions.emplace_back(std::move(subscription));
+        ++it;
+      }
+      else
+      {
+        it = feed_.erase(it);
+      }
     }
   }
 
-  return success;
+  // the handlers are called without holding the feed lock, the (immutable) payload is shared
+  // between all of them
+  for (auto const &subscription : subscriptions)
+  {
+    subscription->Dispatch(address, service, channel, counter, payload, transmitter);
+  }
+
+  return !subscriptions.empty();
 }
 
 }  // namespace muddle
@@ -0,0 +1,211 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "network/p2pservice/connection_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace fetch {
+namespace p2p {
+namespace {
+
+using Candidate  = ConnectionPool::Candidate;
+using Candidates = ConnectionPool::Candidates;
+
+void SortByScore(Candidates &candidates)
+{
+  std::sort(candidates.begin(), candidates.end(), [](Candidate const &a, Candidate const &b) {
+    return ConnectionPool::Score(a) > ConnectionPool::Score(b);
+  });
+}
+
+}  // namespace
+
+constexpr uint32_t    ConnectionPool::DEFAULT_LATENCY_US;
+constexpr uint32_t    ConnectionPool::REFERENCE_LATENCY_US;
+constexpr double      ConnectionPool::ROTATION_MARGIN;
+constexpr std::size_t ConnectionPool::MAX_WARMUP_CYCLES;
+constexpr std::size_t ConnectionPool::COOLDOWN_CYCLES;
+
+/**
+ * Construct the connection pool
+ *
+ * @param target_peers The number of peers to which connections should be maintained
+ * @param max_warming_peers The maximum number of replacement peers connected at the same time
+ */
+ConnectionPool::ConnectionPool(std::size_t target_peers, std::size_t max_warming_peers)
+  : target_peers_{target_peers}
+  , max_warming_peers_{max_warming_peers}
+{}
+
+/**
+ * Compute the score of a candidate peer, higher is better. The trust rating of the peer is
+ * discounted by its round trip time, unmeasured peers are assumed to have an average latency.
+ *
+ * @param candidate The candidate to be scored
+ * @return The score of the candidate
+ */
+double ConnectionPool::Score(Candidate const &candidate)
+{
+  if (candidate.trust <= 0.0)
+  {
+    return candidate.trust;
+  }
+
+  uint32_t const latency_us =
+      (candidate.latency_us > 0) ? candidate.latency_us : DEFAULT_LATENCY_US;
+
+  return candidate.trust / (1.0 + (static_cast<double>(latency_us) / REFERENCE_LATENCY_US));
+}
+
+/**
+ * Update the pool with the current set of candidates and determine the peers to which the node
+ * should be connected. Connected peers which are not part of the result are expected to be
+ * dropped.
+ *
+ * @param candidates The set of trusted peers together with their connection status and latency
+ * @return The set of desired peers
+ */
+ConnectionPool::AddressSet ConnectionPool::Update(Candidates const &candidates)
+{
+  UpdateWarming(candidates);
+
+  Candidates connected;
+  Candidates cold;
+
+  for (auto const &candidate : candidates)
+  {
+    if (candidate.connected)
+    {
+      connected.push_back(candidate);
+    }
+    else if ((warming_.find(candidate.address) == warming_.end()) &&
+             (cooldown_.find(candidate.address) == cooldown_.end()))
+    {
+      cold.push_back(candidate);
+    }
+  }
+
+  SortByScore(connected);
+  SortByScore(cold);
+
+  // keep the best of the connected peers, once a replacement has finished warming up this drops
+  // the worst of the existing peers
+  if (connected.size() > target_peers_)
+  {
+    connected.resize(target_peers_);
+  }
+
+  auto cold_it = cold.begin();
+
+  // fill any free slots with the best of the unconnected candidates
+  while ((cold_it != cold.end()) && ((connected.size() + warming_.size()) < target_peers_))
+  {
+    warming_.emplace(cold_it->address, 0);
+    ++cold_it;
+  }
+
+  // rotate out the slowest / least trusted peer if a significantly better candidate exists
+  if (!connected.empty() && (connected.size() == target_peers_) && (cold_it != cold.end()) &&
+      (warming_.size() < max_warming_peers_))
+  {
+    double const worst_score     = Score(connected.back());
+    double const candidate_score = Score(*cold_it);
+
+    if (candidate_score > (worst_score + (std::fabs(worst_score) * ROTATION_MARGIN)))
+    {
+      warming_.emplace(cold_it->address, 0);
+    }
+  }
+
+  AddressSet desired;
+  desired.reserve(connected.size() + warming_.size());
+
+  for (auto const &candidate : connected)
+  {
+    desired.insert(candidate.address);
+  }
+
+  for (auto const &element : warming_)
+  {
+    desired.insert(element.first);
+  }
+
+  return desired;
+}
+
+/**
+ * Get the number of peers which are currently being connected
+ *
+ * @return The number of warming peers
+ */
+std::size_t ConnectionPool::NumWarming() const
+{
+  return warming_.size();
+}
+
+/**
+ * Update the state of the peers which are being connected, and the peers currently cooling down
+ *
+ * @param candidates The current set of candidates
+ */
+void ConnectionPool::UpdateWarming(Candidates const &candidates)
+{
+  std::unordered_map<Address, bool> status;
+  for (auto const &candidate : candidates)
+  {
+    status[candidate.address] = candidate.connected;
+  }
+
+  for (auto it = cooldown_.begin(); it != cooldown_.end();)
+  {
+    if (--it->second == 0)
+    {
+      it = cooldown_.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  for (auto it = warming_.begin(); it != warming_.end();)
+  {
+    auto const status_it = status.find(it->first);
+
+    if ((status_it == status.end()) || status_it->second)
+    {
+      // either the connection has been established or the peer is no longer a candidate
+      it = warming_.erase(it);
+    }
+    else if (++it->second >= MAX_WARMUP_CYCLES)
+    {
+      // the peer failed to connect in time, stop trying for a while
+      cooldown_[it->first] = COOLDOWN_CYCLES;
+      it                   = warming_.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
+
+}  // namespace p2p
+}  // namespace fetch
@@ -18,9 +18,19 @@
 
 #include "network/p2pservice/identity_cache.hpp"
 
+#include <algorithm>
+#include <iterator>
+
 namespace fetch {
 namespace p2p {
 
+constexpr std::chrono::seconds IdentityCache::REFRESH_INTERVAL;
+constexpr std::chrono::seconds IdentityCache::RETRY_INTERVAL;
+
+IdentityCache::IdentityCache()
+  : snapshot_{std::make_shared<Snapshot const>()}
+{}
+
 void IdentityCache::Update(ConnectionMap const &connections)
 {
   FETCH_LOCK(lock_);
@@ -32,21 +42,38 @@ void IdentityCache::Update(ConnectionMap const &connections)
 
     UpdateInternal(address, uri);
   }
+
+  Publish();
 }
 
 void IdentityCache::Update(Address const &address, Uri const &uri)
 {
   FETCH_LOCK(lock_);
   UpdateInternal(address, uri);
+  Publish();
+}
+
+/**
+ * Record that an address could not be resolved, so that it is not resolved again until the retry
+ * interval has elapsed
+ *
+ * @param address The address which could not be resolved
+ * @param now The current time
+ */
+void IdentityCache::MarkUnresolved(Address const &address, Timepoint const &now)
+{
+  FETCH_LOCK(lock_);
+  state_.failures[address] = now + RETRY_INTERVAL;
+  Publish();
 }
 
 bool IdentityCache::Lookup(Address const &address, Uri &uri) const
 {
   bool success = false;
 
-  FETCH_LOCK(lock_);
-  auto it = cache_.find(address);
-  if (it != cache_.end())
+  auto const snapshot = LoadSnapshot();
+  auto       it       = snapshot->cache.find(address);
+  if (it != snapshot->cache.end())
   {
     uri     = it->second.uri;
     success = true;
@@ -55,35 +82,62 @@ bool IdentityCache::Lookup(Address const &address, Uri &uri) const
   return success;
 }
 
-IdentityCache::AddressSet IdentityCache::FilterOutUnresolved(AddressSet const &addresses)
+IdentityCache::AddressSet IdentityCache::FilterOutUnresolved(AddressSet const &addresses) const
 {
   AddressSet resolvedAddresses;
 
-  {
-    FETCH_LOCK(lock_);
+  auto const snapshot = LoadSnapshot();
+  std::copy_if(addresses.begin(), addresses.end(),
+               std::inserter(resolvedAddresses, resolvedAddresses.begin()),
+               [&snapshot](Address const &address) {
+                 bool resolved = false;
 
-    std::copy_if(addresses.begin(), addresses.end(),
-                 std::inserter(resolvedAddresses, resolvedAddresses.begin()),
-                 [this](Address const &address) {
-                   bool resolved = false;
+                 auto it = snapshot->cache.find(address);
+                 if ((it != snapshot->cache.end()) &&
+                     (it->second.uri.scheme() != Uri::Scheme::Muddle))
+                 {
+                   resolved = true;
+                 }
 
-                   auto it = cache_.find(address);
-                   if ((it != cache_.end()) && (it->second.uri.scheme() != Uri::Scheme::Muddle))
-                   {
-                     resolved = true;
-                   }
+                 return resolved;
+               });
+
+  return resolvedAddresses;
+}
+
+/**
+ * Determine if an address should be (re)resolved: either it has not been resolved, or its entry is
+ * due a refresh. Addresses which recently failed to resolve are not resolved again until their
+ * retry is due.
+ *
+ * @param address The address to be checked
+ * @param now The current time
+ * @return true if a resolution should be requested, otherwise false
+ */
+bool IdentityCache::NeedsResolution(Address const &address, Timepoint const &now) const
+{
+  auto const snapshot = LoadSnapshot();
 
-                   return resolved;
-                 });
+  auto const failure = snapshot->failures.find(address);
+  if ((failure != snapshot->failures.end()) && (now < failure->second))
+  {
+    return false;
   }
 
-  return resolvedAddresses;
+  auto const it = snapshot->cache.find(address);
+  if ((it == snapshot->cache.end()) || (it->second.uri.scheme() == Uri::Scheme::Muddle))
+  {
+    return true;
+  }
+
+  return (now - it->second.last_update) >= REFRESH_INTERVAL;
 }
 
 void IdentityCache::UpdateInternal(Address const &address, Uri const &uri)
 {
-  auto cache_it = cache_.find(address);
-  if (cache_it != cache_.end())
+  auto &cache    = state_.cache;
+  auto  cache_it = cache.find(address);
+  if (cache_it != cache.end())
   {
     auto &cache_entry = cache_it->second;
 
@@ -97,9 +151,33 @@ void IdentityCache::UpdateInternal(Address const &address, Uri const &uri)
   }
   else
   {
-    cache_.emplace(address, uri);
+    cache.emplace(address, uri);
+  }
+
+  if (uri.scheme() != Uri::Scheme::Muddle)
+  {
+    state_.failures.erase(address);
   }
 }
 
+/**
+ * Internal: Replace the published cache with a copy of the writer's cache. Must be called with the
+ * lock held.
+ */
+void IdentityCache::Publish()
+{
+  std::atomic_store(&snapshot_, SnapshotPtr{std::make_shared<Snapshot const>(state_)});
+}
+
+/**
+ * Internal: Get the current published cache, which remains unchanged for as long as it is held
+ *
+ * @return The cache snapshot
+ */
+IdentityCache::SnapshotPtr IdentityCache::LoadSnapshot() const
+{
+  return std::atomic_load(&snapshot_);
+}
+
 }  // namespace p2p
 }  // namespace fetch
@@ -39,6 +39,7 @@ P2PService::P2PService(Muddle &muddle, LaneManagement &lane_management, TrustInt
   , resolver_{identity_cache_}
   , resolver_proto_{resolver_, *this}
   , client_("R:P2P", muddle_ep_, Muddle::Address(), SERVICE_P2P, CHANNEL_RPC)
+  , connection_pool_(max_peers - transient_peers, transient_peers)
   , local_services_(lane_management_)
   , max_peers_(max_peers)
   , transient_peers_(transient_peers)
@@ -115,7 +116,7 @@ void P2PService::WorkCycle()
   {
     // Important, set the cycle time early to prevent rapid re-calls
     // in the case of exceptions.
-    process_future_timepoint_.Set(manifest_update_cycle_ms_);
+    manifests_next_update_timepoint_.Set(manifest_update_cycle_ms_);
 
     AddressSet active_addresses;
 
@@ -242,28 +243,43 @@ bool P2PService::IsDesired(Address const &address)
   return desired_peers_.find(address) != desired_peers_.end();
 }
 
-void P2PService::RenewDesiredPeers(AddressSet const & /*active_addresses*/)
+void P2PService::RenewDesiredPeers(AddressSet const &active_addresses)
 {
-  auto static_peers       = trust_system_.GetBestPeers(max_peers_ - transient_peers_);
-  auto experimental_peers = trust_system_.GetRandomPeers(transient_peers_, 0.0);
+  auto const latencies = muddle_.GetPeerLatencies();
 
-  desired_peers_.clear();
-
-  for (auto const &p : static_peers)
+  // build the set of candidates from the trusted peers of which we are aware
+  ConnectionPool::Candidates candidates;
+  for (auto const &pt : trust_system_.GetPeersAndTrusts())
   {
-    desired_peers_.insert(p);
-  }
+    bool const blacklisted = blacklisted_peers_.find(pt.address) != blacklisted_peers_.end();
 
-  for (auto const &p : experimental_peers)
-  {
-    desired_peers_.insert(p);
+    if ((pt.address == address_) || blacklisted || !trust_system_.IsPeerTrusted(pt.address))
+    {
+      continue;
+    }
+
+    ConnectionPool::Candidate candidate;
+    candidate.address   = pt.address;
+    candidate.trust     = pt.trust;
+    candidate.connected = active_addresses.find(pt.address) != active_addresses.end();
+
+    auto const it = latencies.find(pt.address);
+    if (it != latencies.end())
+    {
+      candidate.latency_us = it->second;
+    }
+
+    candidates.push_back(candidate);
   }
+
+  desired_peers_ = connection_pool_.Update(candidates);
+
+  FETCH_LOG_INFO(LOGGING_NAME, "Desired peers: ", desired_peers_.size(),
+                 " (warming: ", connection_pool_.NumWarming(), ")");
 }
 
 void P2PService::UpdateMuddlePeers(AddressSet const &active_addresses)
 {
-  static constexpr std::size_t MAX_RESOLUTIONS_PER_CYCLE = 20;
-
   AddressSet const outgoing_peers = identity_cache_.FilterOutUnresolved(active_addresses);
 
   AddressSet const new_peers     = desired_peers_ - active_addresses;
@@ -276,6 +292,12 @@ void P2PService::UpdateMuddlePeers(AddressSet const &active_addresses)
     if (identity_cache_.Lookup(d, uri) && uri.IsDirectlyConnectable())
     {
       muddle_.AddPeer(uri);
+
+      // the cached URI is used until its refresh completes
+      if (identity_cache_.NeedsResolution(d))
+      {
+        RequestResolution(d, active_addresses);
+      }
     }
   }
   for (auto const &d : dropped_peers)
@@ -287,56 +309,21 @@ void P2PService::UpdateMuddlePeers(AddressSet const &active_addresses)
     FETCH_LOG_INFO(LOGGING_NAME, "Muddle Update: GAIN: ", ToBase64(d));
   }
 
-  // process pending resolutions
-  pending_resolutions_.Resolve();
-  for (auto const &result : pending_resolutions_.Get(MAX_RESOLUTIONS_PER_CYCLE))
-  {
-    FETCH_LOG_DEBUG(LOGGING_NAME, "Resolve: ", ToBase64(result.key.second), ": ",
-                    result.promised.uri());
-    Uri uri;
-    if (result.promised.IsDirectlyConnectable())
-    {
-      identity_cache_.Update(result.key.second, result.promised);
-      muddle_.AddPeer(result.promised);
-    }
-    else
-    {
-      FETCH_LOG_DEBUG(LOGGING_NAME,
-                      "Discarding resolution for peer: ", ToBase64(result.key.second));
-    }
-  }
+  ProcessResolutions();
 
   // process all additional peer requests
   Uri uri;
   for (auto const &address : new_peers)
   {
-    bool resolve = true;
-
     // once the identity has been resolved it can be added as a peer
     if (identity_cache_.Lookup(address, uri) && uri.IsDirectlyConnectable())
     {
       FETCH_LOG_INFO(LOGGING_NAME, "Add peer: ", ToBase64(address));
       muddle_.AddPeer(uri);
-      resolve = false;
     }
-
-    // if we need to resolve this address
-    if (resolve)
+    else if (identity_cache_.NeedsResolution(address))
     {
-      FETCH_LOG_INFO(LOGGING_NAME, "Resolve Peer: ", ToBase64(address));
-      for (const auto &addr : active_addresses)
-      {
-        auto key = std::make_pair(addr, address);
-        if (pending_resolutions_.IsInFlight(key))
-        {
-          continue;
-        }
-        auto prom = network::PromiseOf<Uri>(
-            client_.CallSpecificAddress(addr, RPC_P2P_RESOLVER, ResolverProtocol::QUERY, address));
-        FETCH_LOG_INFO(LOGGING_NAME, "Resolve Peer: ", ToBase64(address),
-                       ", promise id=", prom.id());
-        pending_resolutions_.Add(key, prom);
-      }
+      RequestResolution(address, active_addresses);
     }
   }
 
@@ -365,6 +352,62 @@ void P2PService::UpdateMuddlePeers(AddressSet const &active_addresses)
   }
 }
 
+/**
+ * Ask each of the connected peers for the URI of an address
+ *
+ * @param address The address to be resolved
+ * @param active_addresses The addresses of the connected peers
+ */
+void P2PService::RequestResolution(Address const &address, AddressSet const &active_addresses)
+{
+  FETCH_LOG_INFO(LOGGING_NAME, "Resolve Peer: ", ToBase64(address));
+
+  for (const auto &addr : active_addresses)
+  {
+    auto key = std::make_pair(addr, address);
+    if (pending_resolutions_.IsInFlight(key))
+    {
+      continue;
+    }
+    auto prom = network::PromiseOf<Uri>(
+        client_.CallSpecificAddress(addr, RPC_P2P_RESOLVER, ResolverProtocol::QUERY, address));
+    FETCH_LOG_INFO(LOGGING_NAME, "Resolve Peer: ", ToBase64(address), ", promise id=", prom.id());
+    pending_resolutions_.Add(key, prom);
+  }
+}
+
+/**
+ * Update the identity cache with the completed resolutions. The addresses which could not be
+ * resolved are cached as such, so that they are not immediately requested again.
+ */
+void P2PService::ProcessResolutions()
+{
+  static constexpr std::size_t MAX_RESOLUTIONS_PER_CYCLE = 20;
+
+  pending_resolutions_.Resolve();
+  for (auto const &result : pending_resolutions_.Get(MAX_RESOLUTIONS_PER_CYCLE))
+  {
+    FETCH_LOG_DEBUG(LOGGING_NAME, "Resolve: ", ToBase64(result.key.second), ": ",
+                    result.promised.uri());
+    if (result.promised.IsDirectlyConnectable())
+    {
+      identity_cache_.Update(result.key.second, result.promised);
+      muddle_.AddPeer(result.promised);
+    }
+    else
+    {
+      FETCH_LOG_DEBUG(LOGGING_NAME,
+                      "Discarding resolution for peer: ", ToBase64(result.key.second));
+      identity_cache_.MarkUnresolved(result.key.second);
+    }
+  }
+
+  for (auto const &failure : pending_resolutions_.GetFailures(MAX_RESOLUTIONS_PER_CYCLE))
+  {
+    identity_cache_.MarkUnresolved(failure.key.second);
+  }
+}
+
 void P2PService::UpdateManifests(AddressSet const &active_addresses)
 {
   // determine which of the nodes that we are talking too, require an update. This might be
@@ -407,6 +450,13 @@ void P2PService::UpdateManifests(AddressSet const &active_addresses)
     // distribute the updated manifest at a later point
     DistributeUpdatedManifest(address);
   }
+
+  // the peers which failed to respond are only asked again once their retry is due
+  for (auto const &failure : outstanding_manifests_.GetFailures(20))
+  {
+    FETCH_LOG_DEBUG(LOGGING_NAME, "Failed to get manifest from: ", ToBase64(failure.key));
+    manifest_cache_.ProvideFailure(failure.key, 30);
+  }
 }
 
 void P2PService::DistributeUpdatedManifest(Address const &address)
@@ -17,6 +17,7 @@
 //------------------------------------------------------------------------------
 
 #include "network/service/client_interface.hpp"
+#include "metrics/rpc_metrics.hpp"
 
 namespace fetch {
 namespace service {
@@ -33,9 +34,11 @@ Promise ServiceClientInterface::CallWithPackedArguments(protocol_handler_type co
   LOG_STACK_TRACE_POINT;
   FETCH_LOG_DEBUG(LOGGING_NAME, "Service Client Calling (2) ", protocol, ":", function);
 
-  Promise         prom = MakePromise();
+  Promise         prom = MakePromise(protocol, function);
   serializer_type params;
 
+  RecordCall(*prom);
+
   serializers::SizeCounter<serializer_type> counter;
   counter << SERVICE_FUNCTION_CALL << prom->id();
   PackCallWithPackedArguments(counter, protocol, function, args);
@@ -73,11 +76,7 @@ subscription_handler_type ServiceClientInterface::Subscribe(protocol_handler_typ
   subscription_handler_type subid = CreateSubscription(protocol, feed, callback);
   serializer_type           params;
 
-  serializers::SizeCounter<serializer_type> counter;
-  counter << SERVICE_SUBSCRIBE << protocol << feed << subid;
-  params.Reserve(counter.size());
-
-  params << SERVICE_SUBSCRIBE << protocol << feed << subid;
+  params.Append(SERVICE_SUBSCRIBE, protocol, feed, subid);
   DeliverRequest(params.data());
   return subid;
 }
@@ -117,11 +116,7 @@ void ServiceClientInterface::Unsubscribe(subscription_handler_type id)
   {
     serializer_type params;
 
-    serializers::SizeCounter<serializer_type> counter;
-    counter << SERVICE_UNSUBSCRIBE << sub.protocol << sub.feed << id;
-    params.Reserve(counter.size());
-
-    params << SERVICE_UNSUBSCRIBE << sub.protocol << sub.feed << id;
+    params.Append(SERVICE_UNSUBSCRIBE, sub.protocol, sub.feed, id);
     DeliverRequest(params.data());
   }
 }
@@ -250,6 +245,21 @@ bool ServiceClientInterface::ProcessServerMessage(network::message_type const &m
   return ret;
 }
 
+/**
+ * Count a call against the instruments of its protocol and function, and attach them to its
+ * promise so that the latency and outcome of the call are recorded
+ *
+ * @param promise The promise of the call
+ */
+void ServiceClientInterface::RecordCall(details::PromiseImplementation &promise)
+{
+  auto &call_metrics =
+      metrics::RpcMetrics::Instance().Call(promise.protocol(), promise.function());
+
+  call_metrics.RecordCall();
+  promise.SetCallMetrics(call_metrics);
+}
+
 void ServiceClientInterface::AddPromise(Promise const &promise)
 {
   FETCH_LOCK(promises_mutex_);
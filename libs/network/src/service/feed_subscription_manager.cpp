@@ -20,9 +20,13 @@
 
 #include "network/service/server_interface.hpp"
 
+#include <unordered_map>
+
 namespace fetch {
 namespace service {
 
+constexpr std::size_t FeedSubscriptionManager::MAX_PUBLISHING_BATCH;
+
 void FeedSubscriptionManager::PublishingProcessor()
 {
   std::vector<publishing_workload_type> my_work;
@@ -32,8 +36,9 @@ void FeedSubscriptionManager::PublishingProcessor()
   {
     service_type *         service       = std::get<0>(w);
     connection_handle_type client_number = std::get<1>(w);
-    network::message_type  msg           = std::get<2>(w);
-    if (!service->DeliverResponse(client_number, msg.Copy()))
+
+    // the encoded notification is shared between subscribers and never modified
+    if (!service->DeliverResponse(client_number, std::get<2>(w)))
     {
       dead_connections.push_back(std::make_tuple(service, client_number));
     }
@@ -54,46 +59,69 @@ void FeedSubscriptionManager::PublishingProcessor()
   }
 }
 
+/**
+ * Encode a feed notification for a subscription
+ *
+ * @param feed The feed identifier
+ * @param id The (client side) subscription identifier
+ * @param msg The message being published
+ * @return The encoded notification
+ */
+network::message_type FeedSubscriptionManager::EncodeNotification(
+    feed_handler_type feed, subscription_handler_type id, byte_array::ConstByteArray const &msg)
+{
+  serializer_type params;
+  params << SERVICE_FEED << feed << id;
+
+  params.Allocate(msg.size());
+  params.WriteBytes(msg.pointer(), msg.size());
+
+  return params.data();
+}
+
 void FeedSubscriptionManager::AttachToService(ServiceServerInterface *service)
 {
   LOG_STACK_TRACE_POINT;
 
   auto feed = feed_;
-  publisher_->create_publisher(feed_,
-                               [service, feed, this](fetch::byte_array::ConstByteArray const &msg) {
-                                 serializer_type params;
-                                 params << SERVICE_FEED << feed;
-
-                                 uint64_t p = params.tell();
-                                 params << subscription_handler_type(0);  // placeholder
-
-                                 params.Allocate(msg.size());
-                                 params.WriteBytes(msg.pointer(), msg.size());
-                                 LOG_STACK_TRACE_POINT;
-                                 lock_type lock(subscribe_mutex_);
-
-                                 std::vector<publishing_workload_type> notifications_to_send;
-                                 notifications_to_send.reserve(16);
-                                 std::size_t i = 0;
-
-                                 while (i < subscribers_.size())
-                                 {
-                                   auto &s = subscribers_[i];
-                                   params.seek(p);
-                                   params << s.id;
-
-                                   publishing_workload_type new_notification =
-                                       std::make_tuple<>(service, s.client, params.data());
-                                   notifications_to_send.push_back(new_notification);
-
-                                   i++;
-                                   if ((i & 0xF) == 0)
-                                   {
-                                     PublishAll(notifications_to_send);
-                                   }
-                                 }
-                                 PublishAll(notifications_to_send);
-                               });
+  publisher_->create_publisher(
+      feed_, [service, feed, this](fetch::byte_array::ConstByteArray const &msg) {
+        LOG_STACK_TRACE_POINT;
+
+        // take a copy of the subscribers so that the notifications are encoded without the lock
+        std::vector<ClientSubscription> subscribers;
+        {
+          lock_type lock(subscribe_mutex_);
+          subscribers = subscribers_;
+        }
+
+        // subscribers with the same subscription id all receive the same encoded notification
+        std::unordered_map<subscription_handler_type, network::message_type> notifications;
+
+        std::vector<publishing_workload_type> notifications_to_send;
+        notifications_to_send.reserve(MAX_PUBLISHING_BATCH);
+
+        for (auto const &s : subscribers)
+        {
+          auto it = notifications.find(s.id);
+          if (it == notifications.end())
+          {
+            it = notifications.emplace(s.id, EncodeNotification(feed, s.id, msg)).first;
+          }
+
+          notifications_to_send.emplace_back(service, s.client, it->second);
+
+          if (notifications_to_send.size() >= MAX_PUBLISHING_BATCH)
+          {
+            PublishAll(notifications_to_send);
+          }
+        }
+
+        if (!notifications_to_send.empty())
+        {
+          PublishAll(notifications_to_send);
+        }
+      });
 }
 
 }  // namespace service
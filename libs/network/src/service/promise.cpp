@@ -67,6 +67,13 @@ bool PromiseImplementation::Wait(uint32_t timeout_ms, bool throw_exception) cons
       if (std::cv_status::timeout == notify_.wait_until(lock, timeout_deadline))
       {
         LogTimout(name_, id_);
+
+        // a promise only counts as a single timeout, however many times it has been waited on
+        if (call_metrics_ && !timeout_recorded_.exchange(true))
+        {
+          call_metrics_->RecordTimeout();
+        }
+
         return false;
       }
     }
@@ -106,6 +113,12 @@ void PromiseImplementation::UpdateState(State state)
 
   if (dispatch)
   {
+    if (call_metrics_)
+    {
+      call_metrics_->RecordCompletion(State::SUCCESS == state,
+                                      metrics::LatencyHistogram::Clock::now() - call_issued_);
+    }
+
     // wake up all the pending threads
     notify_.notify_all();
     DispatchCallbacks();
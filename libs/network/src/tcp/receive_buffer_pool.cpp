@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "network/tcp/receive_buffer_pool.hpp"
+
+#include <atomic>
+
+namespace fetch {
+namespace network {
+
+constexpr std::size_t ReceiveBufferPool::NUM_SIZE_CLASSES;
+constexpr std::size_t ReceiveBufferPool::MIN_BUFFER_SIZE;
+constexpr std::size_t ReceiveBufferPool::MAX_BUFFER_SIZE;
+constexpr std::size_t ReceiveBufferPool::DEFAULT_BUFFERS_PER_CLASS;
+
+/**
+ * Construct an empty pool, buffers are created on demand
+ *
+ * @param buffers_per_class The maximum number of buffers kept for each size class
+ */
+ReceiveBufferPool::ReceiveBufferPool(std::size_t buffers_per_class)
+  : buffers_per_class_{buffers_per_class}
+{
+  for (auto &size_class : classes_)
+  {
+    size_class.buffers.reserve(buffers_per_class_);
+  }
+}
+
+/**
+ * Obtain a buffer for an incoming message. The contents of the buffer are undefined.
+ *
+ * @param size The size of the message
+ * @return The message buffer
+ */
+message_type ReceiveBufferPool::Allocate(std::size_t size)
+{
+  message_type message;
+
+  if ((size > 0) && (size <= MAX_BUFFER_SIZE))
+  {
+    SizeClass &size_class = classes_[ClassIndex(size)];
+
+    // look for a buffer which is only referenced by the pool
+    std::size_t const count = size_class.buffers.size();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      std::size_t const index = (size_class.next + i) % count;
+      if (size_class.buffers[index].UseCount() == 1)
+      {
+        // pairs with the release of the last reference by the previous owner
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        message         = message_type{size_class.buffers[index]};
+        size_class.next = (index + 1) % count;
+        break;
+      }
+    }
+
+    if (message.empty() && (count < buffers_per_class_))
+    {
+      size_class.buffers.emplace_back(ClassSize(ClassIndex(size)));
+      message = message_type{size_class.buffers.back()};
+    }
+  }
+
+  // shrinking never reallocates, otherwise this is a normal allocation
+  message.Resize(size);
+
+  return message;
+}
+
+/**
+ * @return The total size of the buffers held by the pool
+ */
+std::size_t ReceiveBufferPool::pooled_bytes() const
+{
+  std::size_t total{0};
+  for (std::size_t i = 0; i < NUM_SIZE_CLASSES; ++i)
+  {
+    total += classes_[i].buffers.size() * ClassSize(i);
+  }
+
+  return total;
+}
+
+/**
+ * Determine the smallest size class which can hold a message
+ *
+ * @param size The size of the message, no more than MAX_BUFFER_SIZE
+ * @return The index of the size class
+ */
+std::size_t ReceiveBufferPool::ClassIndex(std::size_t size)
+{
+  std::size_t index = 0;
+  while (ClassSize(index) < size)
+  {
+    ++index;
+  }
+
+  return index;
+}
+
+/**
+ * @param index The index of the size class
+ * @return The size of the buffers in the class
+ */
+std::size_t ReceiveBufferPool::ClassSize(std::size_t index)
+{
+  return MIN_BUFFER_SIZE << (2 * index);
+}
+
+}  // namespace network
+}  // namespace fetch
@@ -176,10 +176,14 @@ void TCPServer::Accept(std::shared_ptr<asio::ip::tcp::tcp::acceptor> acceptor)
 {
   LOG_STACK_TRACE_POINT;
 
-  auto strongSocket                = network_manager_.CreateIO<asio::ip::tcp::tcp::socket>();
+  // in the per core mode each accepted socket is assigned to a core in turn and the connection is
+  // started there, so its strand and all subsequent reads and writes stay local to that core
+  auto const core         = network_manager_.NextCore();
+  auto       strongSocket = network_manager_.CreateIOOnCore<asio::ip::tcp::tcp::socket>(core);
+
   std::weak_ptr<ClientManager> man = manager_;
 
-  auto cb = [this, man, acceptor, strongSocket](std::error_code ec) {
+  auto cb = [this, man, acceptor, strongSocket, core](std::error_code ec) {
     auto lock_ptr = man.lock();
     if (!lock_ptr)
     {
@@ -188,16 +192,29 @@ void TCPServer::Accept(std::shared_ptr<asio::ip::tcp::tcp::acceptor> acceptor)
 
     if (!ec)
     {
-      auto conn = std::make_shared<ClientConnection>(strongSocket, manager_, network_manager_);
-      auto ptr  = connection_register_.lock();
+      auto start = [man, strongSocket, network_manager = network_manager_,
+                    weak_register = connection_register_]() {
+        auto conn = std::make_shared<ClientConnection>(strongSocket, man, network_manager);
+        auto ptr  = weak_register.lock();
+
+        if (ptr)
+        {
+          ptr->Enter(conn->connection_pointer());
+          conn->SetConnectionManager(ptr);
+        }
 
-      if (ptr)
+        conn->Start();
+      };
+
+      if (network_manager_.is_per_core())
+      {
+        network_manager_.PostOnCore(core, start);
+      }
+      else
       {
-        ptr->Enter(conn->connection_pointer());
-        conn->SetConnectionManager(ptr);
+        start();
       }
 
-      conn->Start();
       Accept(acceptor);
     }
     else
@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "network/tcp/write_batch.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace fetch {
+namespace network {
+
+constexpr uint64_t    WriteBatch::NETWORK_MAGIC;
+constexpr std::size_t WriteBatch::HEADER_SIZE;
+constexpr std::size_t WriteBatch::DEFAULT_BYTE_BUDGET;
+constexpr std::size_t WriteBatch::DEFAULT_MAX_MESSAGES;
+
+/**
+ * Construct an empty batch
+ *
+ * @param byte_budget The maximum number of bytes (including headers) in a batch. A single message
+ * larger than the budget is still written, on its own
+ * @param max_messages The maximum number of messages in a batch
+ */
+WriteBatch::WriteBatch(std::size_t byte_budget, std::size_t max_messages)
+  : byte_budget_{byte_budget}
+  , max_messages_{(max_messages > 0) ? max_messages : 1}
+{
+  messages_.reserve(max_messages_);
+  buffers_.reserve(2 * max_messages_);
+}
+
+/**
+ * Move as many messages from the front of the queue into the (empty) batch as the limits allow.
+ * The queue must be locked by the caller.
+ *
+ * @param queue The queue of pending messages
+ * @return The number of messages added to the batch
+ */
+std::size_t WriteBatch::Fill(message_queue_type &queue)
+{
+  assert(empty());
+
+  Take(queue);
+  BuildBuffers();
+
+  return messages_.size();
+}
+
+/**
+ * Move as many messages into the (empty) batch as the limits allow, starting with the highest
+ * priority. The queues must be locked by the caller.
+ *
+ * @param queues The queues of pending messages, indexed by priority
+ * @return The number of messages added to the batch
+ */
+std::size_t WriteBatch::Fill(prioritised_message_queue_type &queues)
+{
+  assert(empty());
+
+  for (auto it = queues.rbegin(); it != queues.rend(); ++it)
+  {
+    if (!Take(*it))
+    {
+      break;
+    }
+  }
+
+  BuildBuffers();
+
+  return messages_.size();
+}
+
+/**
+ * Move messages from the front of the queue into the batch
+ *
+ * @param queue The queue of pending messages
+ * @return true if the whole queue was taken, false if a limit was reached
+ */
+bool WriteBatch::Take(message_queue_type &queue)
+{
+  while (!queue.empty())
+  {
+    if (messages_.size() >= max_messages_)
+    {
+      return false;
+    }
+
+    std::size_t const bytes = HEADER_SIZE + queue.front().size();
+
+    // always make progress, even when the next message exceeds the budget by itself
+    if (!messages_.empty() && ((byte_count_ + bytes) > byte_budget_))
+    {
+      return false;
+    }
+
+    messages_.push_back(std::move(queue.front()));
+    queue.pop_front();
+    byte_count_ += bytes;
+  }
+
+  return true;
+}
+
+/**
+ * Build the headers and the buffer sequence for the messages in the batch
+ */
+void WriteBatch::BuildBuffers()
+{
+  // the header buffer must not be resized once the buffers refer to it
+  headers_.Resize(messages_.size() * HEADER_SIZE);
+
+  for (std::size_t i = 0; i < messages_.size(); ++i)
+  {
+    uint8_t *header = headers_.pointer() + (i * HEADER_SIZE);
+    SetHeader(header, messages_[i].size());
+
+    buffers_.emplace_back(asio::buffer(header, HEADER_SIZE));
+    if (!messages_[i].empty())
+    {
+      buffers_.emplace_back(asio::buffer(messages_[i].pointer(), messages_[i].size()));
+    }
+  }
+}
+
+/**
+ * Release the messages of a completed write
+ */
+void WriteBatch::Clear()
+{
+  buffers_.clear();
+  messages_.clear();
+  byte_count_ = 0;
+}
+
+/**
+ * Write the network header for a message
+ *
+ * @param header The output buffer, at least HEADER_SIZE bytes
+ * @param length The length of the message payload
+ */
+void WriteBatch::SetHeader(uint8_t *header, uint64_t length)
+{
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    header[i] = uint8_t((NETWORK_MAGIC >> i * 8) & 0xff);
+  }
+
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    header[i + 8] = uint8_t((length >> i * 8) & 0xff);
+  }
+}
+
+}  // namespace network
+}  // namespace fetch
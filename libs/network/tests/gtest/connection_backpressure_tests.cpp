@@ -0,0 +1,154 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "network/management/abstract_connection.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+namespace {
+
+using fetch::network::AbstractConnection;
+using fetch::network::message_type;
+using fetch::network::message_queue_type;
+
+/**
+ * A connection which never writes anything until it is explicitly drained
+ */
+class QueuedConnection : public AbstractConnection
+{
+public:
+  void Send(message_type const &msg) override
+  {
+    if (ReserveSendCapacity(msg.size()))
+    {
+      queue_.push_back(msg);
+    }
+  }
+
+  void Drain()
+  {
+    std::size_t bytes{0};
+    for (auto const &msg : queue_)
+    {
+      bytes += msg.size();
+    }
+
+    queue_.clear();
+    ReleaseSendCapacity(bytes);
+  }
+
+  uint16_t Type() const override
+  {
+    return TYPE_UNDEFINED;
+  }
+
+  void Close() override
+  {}
+
+  bool Closed() const override
+  {
+    return false;
+  }
+
+  bool is_alive() const override
+  {
+    return true;
+  }
+
+  std::size_t queue_size() const
+  {
+    return queue_.size();
+  }
+
+private:
+  message_queue_type queue_;
+};
+
+message_type CreateMessage(std::size_t length)
+{
+  message_type message;
+  message.Resize(length);
+
+  return message;
+}
+
+TEST(ConnectionBackpressureTests, MessagesBeyondTheHighWaterMarkAreDropped)
+{
+  QueuedConnection connection;
+  connection.SetHighWaterMark(1000);
+
+  for (std::size_t i = 0; i < 20; ++i)
+  {
+    connection.Send(CreateMessage(100));
+  }
+
+  EXPECT_EQ(connection.queue_size(), 10);
+  EXPECT_EQ(connection.queued_bytes(), 1000);
+  EXPECT_EQ(connection.dropped_messages(), 10);
+  EXPECT_TRUE(connection.IsCongested());
+
+  connection.Drain();
+  EXPECT_EQ(connection.queued_bytes(), 0);
+  EXPECT_FALSE(connection.IsCongested());
+
+  connection.Send(CreateMessage(100));
+  EXPECT_EQ(connection.queue_size(), 1);
+}
+
+TEST(ConnectionBackpressureTests, LargeMessageIsAcceptedByAnEmptyQueue)
+{
+  QueuedConnection connection;
+  connection.SetHighWaterMark(1000);
+
+  connection.Send(CreateMessage(5000));
+  EXPECT_EQ(connection.queue_size(), 1);
+
+  connection.Send(CreateMessage(1));
+  EXPECT_EQ(connection.queue_size(), 1);
+  EXPECT_EQ(connection.dropped_messages(), 1);
+}
+
+TEST(ConnectionBackpressureTests, WaitTimesOutWhileCongested)
+{
+  QueuedConnection connection;
+  connection.SetHighWaterMark(100);
+  connection.Send(CreateMessage(100));
+
+  EXPECT_FALSE(connection.WaitForSendCapacity(std::chrono::milliseconds{20}));
+}
+
+TEST(ConnectionBackpressureTests, WaitReturnsOnceDrained)
+{
+  QueuedConnection connection;
+  connection.SetHighWaterMark(100);
+  connection.Send(CreateMessage(100));
+
+  std::thread writer([&connection]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    connection.Drain();
+  });
+
+  EXPECT_TRUE(connection.WaitForSendCapacity(std::chrono::seconds{10}));
+  writer.join();
+}
+
+}  // namespace
@@ -0,0 +1,162 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "network/service/abstract_publication_feed.hpp"
+#include "network/service/feed_subscription_manager.hpp"
+#include "network/service/server_interface.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+using fetch::byte_array::ConstByteArray;
+using fetch::network::message_type;
+using fetch::service::AbstractPublicationFeed;
+using fetch::service::FeedSubscriptionManager;
+using fetch::service::ServiceServerInterface;
+using fetch::service::feed_handler_type;
+using fetch::service::serializer_type;
+using fetch::service::service_classification_type;
+using fetch::service::subscription_handler_type;
+
+static constexpr feed_handler_type FEED = 3;
+
+class TestPublisher : public AbstractPublicationFeed
+{
+public:
+  using AbstractPublicationFeed::create_publisher;
+
+  void create_publisher(feed_handler_type, function_type function) override
+  {
+    publish_ = std::move(function);
+  }
+
+  void Publish(ConstByteArray const &msg)
+  {
+    publish_(msg);
+  }
+
+private:
+  function_type publish_;
+};
+
+class TestService : public ServiceServerInterface
+{
+public:
+  using Deliveries = std::unordered_map<connection_handle_type, message_type>;
+
+  bool DeliverResponse(connection_handle_type client, message_type const &msg) override
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    deliveries_[client] = msg;
+    return true;
+  }
+
+  Deliveries WaitForDeliveries(std::size_t count)
+  {
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (deliveries_.size() >= count)
+        {
+          return deliveries_;
+        }
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+
+    std::lock_guard<std::mutex> guard(lock_);
+    return deliveries_;
+  }
+
+private:
+  std::mutex lock_;
+  Deliveries deliveries_;
+};
+
+void CheckNotification(message_type const &msg, subscription_handler_type expected_id,
+                       ConstByteArray const &expected_payload)
+{
+  serializer_type             params(msg);
+  service_classification_type type{0};
+  feed_handler_type           feed{0};
+  subscription_handler_type   id{0};
+  params >> type >> feed >> id;
+
+  EXPECT_EQ(type, fetch::service::SERVICE_FEED);
+  EXPECT_EQ(feed, FEED);
+  EXPECT_EQ(id, expected_id);
+  EXPECT_EQ(msg.SubArray(params.tell()), expected_payload);
+}
+
+TEST(FeedSubscriptionManagerTests, CheckNotificationsSharedBetweenSubscribers)
+{
+  TestPublisher           publisher;
+  TestService             service;
+  FeedSubscriptionManager manager{FEED, &publisher};
+
+  manager.AttachToService(&service);
+  manager.Subscribe(1, 7);
+  manager.Subscribe(2, 7);
+  manager.Subscribe(3, 9);
+
+  ConstByteArray const payload{"a transaction"};
+  publisher.Publish(payload);
+
+  auto deliveries = service.WaitForDeliveries(3);
+  ASSERT_EQ(deliveries.size(), 3);
+
+  CheckNotification(deliveries[1], 7, payload);
+  CheckNotification(deliveries[2], 7, payload);
+  CheckNotification(deliveries[3], 9, payload);
+
+  // subscribers with the same subscription id receive the same buffer
+  ConstByteArray const &first  = deliveries[1];
+  ConstByteArray const &second = deliveries[2];
+  EXPECT_EQ(first.pointer(), second.pointer());
+}
+
+TEST(FeedSubscriptionManagerTests, CheckUnsubscribedClientsNotNotified)
+{
+  TestPublisher           publisher;
+  TestService             service;
+  FeedSubscriptionManager manager{FEED, &publisher};
+
+  manager.AttachToService(&service);
+  manager.Subscribe(1, 7);
+  manager.Subscribe(2, 8);
+  manager.Unsubscribe(1, 7);
+
+  publisher.Publish(ConstByteArray{"payload"});
+
+  auto deliveries = service.WaitForDeliveries(1);
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  deliveries = service.WaitForDeliveries(1);
+
+  ASSERT_EQ(deliveries.size(), 1);
+  EXPECT_EQ(deliveries.count(2), 1);
+}
+
+}  // namespace
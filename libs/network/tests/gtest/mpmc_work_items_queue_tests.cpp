@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "network/generics/mpmc_work_items_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using std::chrono::milliseconds;
+
+using Queue = fetch::generics::MPMCWorkItemsQueue<std::size_t, 16>;
+using Items = std::vector<std::size_t>;
+
+TEST(MPMCWorkItemsQueueTests, OverflowKeepsOrder)
+{
+  Queue queue;
+
+  Items input;
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    input.push_back(i);
+  }
+
+  // far more items than the ring can hold
+  queue.Add(input.begin(), input.end());
+  EXPECT_EQ(queue.size(), input.size());
+
+  Items output;
+  EXPECT_EQ(queue.Get(output, 10), 10);
+  EXPECT_EQ(queue.Get(output, 1000), input.size());
+  EXPECT_EQ(output, input);
+  EXPECT_TRUE(queue.empty());
+  EXPECT_FALSE(queue.Remaining());
+}
+
+TEST(MPMCWorkItemsQueueTests, GetBatchTimesOutWhenEmpty)
+{
+  Queue queue{0};
+
+  Items output;
+  EXPECT_EQ(queue.GetBatch(output, 16, milliseconds{20}), 0);
+
+  queue.Add(42);
+  EXPECT_EQ(queue.GetBatch(output, 16, milliseconds{20}), 1);
+  EXPECT_EQ(output.front(), 42);
+}
+
+TEST(MPMCWorkItemsQueueTests, SleepingConsumerIsWoken)
+{
+  Queue queue{0};
+
+  Items             output;
+  std::atomic<bool> received{false};
+
+  std::thread consumer([&queue, &output, &received]() {
+    queue.GetBatch(output, 16, milliseconds{5000});
+    received = true;
+  });
+
+  std::this_thread::sleep_for(milliseconds{50});
+  queue.Add(7);
+  consumer.join();
+
+  EXPECT_TRUE(received);
+  ASSERT_EQ(output.size(), 1);
+  EXPECT_EQ(output.front(), 7);
+}
+
+TEST(MPMCWorkItemsQueueTests, QuitReleasesWaiters)
+{
+  Queue queue{0};
+
+  std::thread consumer([&queue]() { EXPECT_FALSE(queue.Wait()); });
+
+  std::this_thread::sleep_for(milliseconds{20});
+  queue.Quit();
+  consumer.join();
+}
+
+TEST(MPMCWorkItemsQueueTests, MultipleProducersAndConsumers)
+{
+  static constexpr std::size_t NUM_PRODUCERS      = 4;
+  static constexpr std::size_t NUM_CONSUMERS      = 4;
+  static constexpr std::size_t ITEMS_PER_PRODUCER = 20000;
+  static constexpr std::size_t TOTAL_ITEMS        = NUM_PRODUCERS * ITEMS_PER_PRODUCER;
+
+  Queue                    queue;
+  std::atomic<std::size_t> consumed{0};
+  std::atomic<std::size_t> sum{0};
+
+  std::vector<std::thread> threads;
+  for (std::size_t p = 0; p < NUM_PRODUCERS; ++p)
+  {
+    threads.emplace_back([&queue]() {
+      for (std::size_t i = 1; i <= ITEMS_PER_PRODUCER; ++i)
+      {
+        queue.Add(i);
+      }
+    });
+  }
+
+  for (std::size_t c = 0; c < NUM_CONSUMERS; ++c)
+  {
+    threads.emplace_back([&queue, &consumed, &sum]() {
+      Items batch;
+      while (consumed < TOTAL_ITEMS)
+      {
+        batch.clear();
+        queue.GetBatch(batch, 32, milliseconds{10});
+
+        for (auto const &item : batch)
+        {
+          sum += item;
+        }
+        consumed += batch.size();
+      }
+    });
+  }
+
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  EXPECT_EQ(consumed, TOTAL_ITEMS);
+  EXPECT_EQ(sum, NUM_PRODUCERS * (ITEMS_PER_PRODUCER * (ITEMS_PER_PRODUCER + 1)) / 2);
+  EXPECT_TRUE(queue.empty());
+}
+
+}  // namespace
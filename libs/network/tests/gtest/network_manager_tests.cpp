@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "network/management/network_manager.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using fetch::network::NetworkManager;
+
+class PerCoreNetworkManagerTests : public ::testing::Test
+{
+protected:
+  static constexpr std::size_t NUM_THREADS = 4;
+  static constexpr std::size_t NUM_TASKS   = 16;
+
+  using ThreadIds = std::vector<std::thread::id>;
+
+  void WaitForCompletion()
+  {
+    for (std::size_t i = 0; (i < 500) && (completed_ < NUM_TASKS); ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(completed_, NUM_TASKS);
+  }
+
+  NetworkManager           manager_{"NetMgr", NUM_THREADS, NetworkManager::Mode::PER_CORE};
+  std::mutex               lock_;
+  ThreadIds                outer_ids_ = ThreadIds(NUM_TASKS);
+  ThreadIds                inner_ids_ = ThreadIds(NUM_TASKS);
+  std::atomic<std::size_t> completed_{0};
+};
+
+constexpr std::size_t PerCoreNetworkManagerTests::NUM_THREADS;
+constexpr std::size_t PerCoreNetworkManagerTests::NUM_TASKS;
+
+TEST_F(PerCoreNetworkManagerTests, ExternalWorkIsSpreadAcrossCores)
+{
+  manager_.Start();
+
+  for (std::size_t i = 0; i < NUM_TASKS; ++i)
+  {
+    manager_.Post([this, i]() {
+      std::lock_guard<std::mutex> guard(lock_);
+      outer_ids_[i] = std::this_thread::get_id();
+      ++completed_;
+    });
+  }
+
+  WaitForCompletion();
+  manager_.Stop();
+
+  std::set<std::thread::id> const distinct(outer_ids_.begin(), outer_ids_.end());
+  EXPECT_EQ(distinct.size(), NUM_THREADS);
+}
+
+TEST_F(PerCoreNetworkManagerTests, NestedWorkStaysOnTheSameCore)
+{
+  manager_.Start();
+
+  for (std::size_t i = 0; i < NUM_TASKS; ++i)
+  {
+    manager_.Post([this, i]() {
+      {
+        std::lock_guard<std::mutex> guard(lock_);
+        outer_ids_[i] = std::this_thread::get_id();
+      }
+
+      manager_.Post([this, i]() {
+        std::lock_guard<std::mutex> guard(lock_);
+        inner_ids_[i] = std::this_thread::get_id();
+        ++completed_;
+      });
+    });
+  }
+
+  WaitForCompletion();
+  manager_.Stop();
+
+  EXPECT_EQ(outer_ids_, inner_ids_);
+}
+
+TEST_F(PerCoreNetworkManagerTests, WorkCanBeHandedToASpecificCore)
+{
+  manager_.Start();
+
+  std::size_t const core = manager_.NextCore();
+  for (std::size_t i = 0; i < NUM_TASKS; ++i)
+  {
+    manager_.PostOnCore(core, [this, i]() {
+      std::lock_guard<std::mutex> guard(lock_);
+      outer_ids_[i] = std::this_thread::get_id();
+      ++completed_;
+    });
+  }
+
+  WaitForCompletion();
+  manager_.Stop();
+
+  std::set<std::thread::id> const distinct(outer_ids_.begin(), outer_ids_.end());
+  EXPECT_EQ(distinct.size(), 1u);
+}
+
+}  // namespace
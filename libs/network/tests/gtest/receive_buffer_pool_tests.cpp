@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "network/tcp/receive_buffer_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+
+namespace {
+
+using fetch::network::ReceiveBufferPool;
+using fetch::network::message_type;
+
+TEST(ReceiveBufferPoolTests, BufferIsReusedOnceReleased)
+{
+  ReceiveBufferPool pool;
+
+  uint8_t const *first{nullptr};
+  {
+    message_type message = pool.Allocate(100);
+    EXPECT_EQ(message.size(), 100);
+    first = message.pointer();
+  }
+
+  message_type message = pool.Allocate(200);
+  EXPECT_EQ(message.size(), 200);
+  EXPECT_EQ(message.pointer(), first);
+  EXPECT_EQ(pool.pooled_bytes(), ReceiveBufferPool::MIN_BUFFER_SIZE);
+}
+
+TEST(ReceiveBufferPoolTests, BufferIsNotReusedWhileReferenced)
+{
+  ReceiveBufferPool pool;
+
+  message_type first  = pool.Allocate(100);
+  message_type copy   = first;
+  message_type second = pool.Allocate(100);
+
+  EXPECT_NE(first.pointer(), second.pointer());
+  EXPECT_EQ(pool.pooled_bytes(), 2 * ReceiveBufferPool::MIN_BUFFER_SIZE);
+}
+
+TEST(ReceiveBufferPoolTests, MessagesAreGroupedBySizeClass)
+{
+  ReceiveBufferPool pool;
+
+  message_type small = pool.Allocate(10);
+  message_type large = pool.Allocate(1000);
+
+  EXPECT_EQ(pool.pooled_bytes(), ReceiveBufferPool::MIN_BUFFER_SIZE + 1024);
+}
+
+TEST(ReceiveBufferPoolTests, LargeMessagesAreNotPooled)
+{
+  ReceiveBufferPool pool;
+
+  message_type message = pool.Allocate(ReceiveBufferPool::MAX_BUFFER_SIZE + 1);
+  EXPECT_EQ(message.size(), ReceiveBufferPool::MAX_BUFFER_SIZE + 1);
+  EXPECT_EQ(pool.pooled_bytes(), 0);
+}
+
+TEST(ReceiveBufferPoolTests, FallsBackToAllocationWhenExhausted)
+{
+  ReceiveBufferPool pool{2};
+
+  message_type a = pool.Allocate(100);
+  message_type b = pool.Allocate(100);
+  message_type c = pool.Allocate(100);
+
+  EXPECT_EQ(c.size(), 100);
+  EXPECT_EQ(pool.pooled_bytes(), 2 * ReceiveBufferPool::MIN_BUFFER_SIZE);
+}
+
+TEST(ReceiveBufferPoolTests, BuffersCanBeReleasedByAnotherThread)
+{
+  ReceiveBufferPool pool{4};
+
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    message_type message = pool.Allocate(100);
+    message[0]           = static_cast<uint8_t>(i);
+
+    std::thread consumer([message]() mutable { message = message_type{}; });
+    message = message_type{};
+    consumer.join();
+  }
+
+  EXPECT_EQ(pool.pooled_bytes(), ReceiveBufferPool::MIN_BUFFER_SIZE);
+}
+
+}  // namespace
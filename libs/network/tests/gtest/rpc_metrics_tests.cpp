@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "metrics/rpc_metrics.hpp"
+#include "network/service/client_interface.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+namespace {
+
+using fetch::metrics::RpcCallMetrics;
+using fetch::metrics::RpcMetrics;
+using fetch::network::message_type;
+using fetch::service::Promise;
+using fetch::service::SERVICE_RESULT;
+using fetch::service::ServiceClientInterface;
+using fetch::service::serializer_type;
+
+/**
+ * A client which records the outgoing requests and can be fed the responses directly
+ */
+class LoopbackClient : public ServiceClientInterface
+{
+public:
+  bool deliverable = true;
+
+  void Respond(Promise const &promise, uint64_t value)
+  {
+    serializer_type response;
+    response << SERVICE_RESULT << promise->id() << value;
+
+    ProcessServerMessage(response.data());
+  }
+
+protected:
+  bool DeliverRequest(message_type const &) override
+  {
+    return deliverable;
+  }
+};
+
+class RpcMetricsTests : public ::testing::Test
+{
+protected:
+  static constexpr uint64_t PROTOCOL = 0xF00D;
+  static constexpr uint64_t FUNCTION = 1;
+
+  void SetUp() override
+  {
+    RpcMetrics::Instance().Reset();
+  }
+
+  static RpcCallMetrics &Metrics()
+  {
+    return RpcMetrics::Instance().Call(PROTOCOL, FUNCTION);
+  }
+
+  LoopbackClient client_;
+};
+
+constexpr uint64_t RpcMetricsTests::PROTOCOL;
+constexpr uint64_t RpcMetricsTests::FUNCTION;
+
+TEST_F(RpcMetricsTests, SuccessfulCallsAreTimed)
+{
+  auto promise = client_.Call(0, PROTOCOL, FUNCTION, uint64_t{1});
+  client_.Respond(promise, 42);
+
+  EXPECT_EQ(promise->As<uint64_t>(), 42u);
+
+  auto const &metrics = Metrics();
+  EXPECT_EQ(metrics.calls, 1u);
+  EXPECT_EQ(metrics.succeeded, 1u);
+  EXPECT_EQ(metrics.failed, 0u);
+  EXPECT_EQ(metrics.timeouts, 0u);
+  EXPECT_EQ(metrics.latency.count(), 1u);
+}
+
+TEST_F(RpcMetricsTests, UndeliverableCallsAreFailures)
+{
+  client_.deliverable = false;
+
+  auto promise = client_.Call(0, PROTOCOL, FUNCTION, uint64_t{1});
+  EXPECT_TRUE(promise->IsFailed());
+
+  auto const &metrics = Metrics();
+  EXPECT_EQ(metrics.calls, 1u);
+  EXPECT_EQ(metrics.succeeded, 0u);
+  EXPECT_EQ(metrics.failed, 1u);
+  EXPECT_EQ(metrics.latency.count(), 1u);
+}
+
+TEST_F(RpcMetricsTests, TimeoutsAreCountedOncePerCall)
+{
+  auto promise = client_.Call(0, PROTOCOL, FUNCTION, uint64_t{1});
+
+  EXPECT_FALSE(promise->Wait(5, false));
+  EXPECT_FALSE(promise->Wait(5, false));
+
+  auto const &metrics = Metrics();
+  EXPECT_EQ(metrics.calls, 1u);
+  EXPECT_EQ(metrics.timeouts, 1u);
+  EXPECT_EQ(metrics.latency.count(), 0u);
+
+  // a late response still records the latency of the call
+  client_.Respond(promise, 7);
+  EXPECT_EQ(metrics.succeeded, 1u);
+  EXPECT_EQ(metrics.latency.count(), 1u);
+}
+
+TEST_F(RpcMetricsTests, CallsAreKeyedByProtocolAndFunction)
+{
+  client_.Call(0, PROTOCOL, FUNCTION, uint64_t{1});
+  client_.Call(0, PROTOCOL, FUNCTION + 1, uint64_t{1});
+  client_.Call(0, PROTOCOL, FUNCTION + 1, uint64_t{1});
+
+  EXPECT_EQ(RpcMetrics::Instance().Call(PROTOCOL, FUNCTION).calls, 1u);
+  EXPECT_EQ(RpcMetrics::Instance().Call(PROTOCOL, FUNCTION + 1).calls, 2u);
+}
+
+}  // namespace
@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "network/tcp/write_batch.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace {
+
+using fetch::network::MessagePriority;
+using fetch::network::WriteBatch;
+using fetch::network::message_queue_type;
+using fetch::network::message_type;
+using fetch::network::prioritised_message_queue_type;
+
+message_type CreateMessage(std::size_t length)
+{
+  message_type message;
+  message.Resize(length);
+  for (std::size_t i = 0; i < length; ++i)
+  {
+    message[i] = static_cast<uint8_t>(i);
+  }
+
+  return message;
+}
+
+std::size_t TotalSize(WriteBatch::Buffers const &buffers)
+{
+  std::size_t total = 0;
+  for (auto const &buffer : buffers)
+  {
+    total += asio::buffer_size(buffer);
+  }
+
+  return total;
+}
+
+TEST(WriteBatchTests, CoalescesAllSmallMessages)
+{
+  message_queue_type queue;
+  for (std::size_t i = 0; i < 10; ++i)
+  {
+    queue.push_back(CreateMessage(100));
+  }
+
+  WriteBatch batch;
+  EXPECT_EQ(batch.Fill(queue), 10);
+  EXPECT_TRUE(queue.empty());
+
+  // a header and a payload per message
+  EXPECT_EQ(batch.buffers().size(), 20);
+  EXPECT_EQ(batch.byte_count(), 10 * (WriteBatch::HEADER_SIZE + 100));
+  EXPECT_EQ(TotalSize(batch.buffers()), batch.byte_count());
+}
+
+TEST(WriteBatchTests, RespectsByteBudget)
+{
+  message_queue_type queue;
+  for (std::size_t i = 0; i < 10; ++i)
+  {
+    queue.push_back(CreateMessage(100));
+  }
+
+  WriteBatch batch{3 * (WriteBatch::HEADER_SIZE + 100)};
+  EXPECT_EQ(batch.Fill(queue), 3);
+  EXPECT_EQ(queue.size(), 7);
+
+  batch.Clear();
+  EXPECT_TRUE(batch.empty());
+  EXPECT_EQ(batch.Fill(queue), 3);
+  EXPECT_EQ(queue.size(), 4);
+}
+
+TEST(WriteBatchTests, RespectsMessageLimit)
+{
+  message_queue_type queue;
+  for (std::size_t i = 0; i < 10; ++i)
+  {
+    queue.push_back(CreateMessage(1));
+  }
+
+  WriteBatch batch{WriteBatch::DEFAULT_BYTE_BUDGET, 4};
+  EXPECT_EQ(batch.Fill(queue), 4);
+  EXPECT_EQ(queue.size(), 6);
+}
+
+TEST(WriteBatchTests, OversizedMessageIsWrittenAlone)
+{
+  message_queue_type queue;
+  queue.push_back(CreateMessage(1000));
+  queue.push_back(CreateMessage(10));
+
+  WriteBatch batch{100};
+  EXPECT_EQ(batch.Fill(queue), 1);
+  EXPECT_EQ(batch.byte_count(), WriteBatch::HEADER_SIZE + 1000);
+  EXPECT_EQ(queue.size(), 1);
+}
+
+TEST(WriteBatchTests, HeadersMatchTheWireFormat)
+{
+  message_queue_type queue;
+  queue.push_back(CreateMessage(5));
+  queue.push_back(CreateMessage(0));
+
+  WriteBatch batch;
+  ASSERT_EQ(batch.Fill(queue), 2);
+
+  // empty payloads only contribute a header
+  ASSERT_EQ(batch.buffers().size(), 3);
+
+  auto const check_header = [](asio::const_buffer const &buffer, uint64_t expected_length) {
+    ASSERT_EQ(asio::buffer_size(buffer), WriteBatch::HEADER_SIZE);
+
+    uint64_t magic{0};
+    uint64_t length{0};
+    std::memcpy(&magic, asio::buffer_cast<uint8_t const *>(buffer), sizeof(magic));
+    std::memcpy(&length, asio::buffer_cast<uint8_t const *>(buffer) + sizeof(magic),
+                sizeof(length));
+
+    EXPECT_EQ(magic, WriteBatch::NETWORK_MAGIC);
+    EXPECT_EQ(length, expected_length);
+  };
+
+  check_header(batch.buffers()[0], 5);
+  check_header(batch.buffers()[2], 0);
+  EXPECT_EQ(asio::buffer_size(batch.buffers()[1]), 5);
+}
+
+TEST(WriteBatchTests, HigherPrioritiesAreTakenFirst)
+{
+  prioritised_message_queue_type queues;
+  queues[static_cast<std::size_t>(MessagePriority::LOW)].push_back(CreateMessage(1));
+  queues[static_cast<std::size_t>(MessagePriority::NORMAL)].push_back(CreateMessage(2));
+  queues[static_cast<std::size_t>(MessagePriority::HIGH)].push_back(CreateMessage(3));
+
+  WriteBatch batch{WriteBatch::DEFAULT_BYTE_BUDGET, 2};
+  ASSERT_EQ(batch.Fill(queues), 2);
+
+  // the payloads follow their headers
+  ASSERT_EQ(batch.buffers().size(), 4);
+  EXPECT_EQ(asio::buffer_size(batch.buffers()[1]), 3);
+  EXPECT_EQ(asio::buffer_size(batch.buffers()[3]), 2);
+
+  // the low priority message is left for the next batch
+  EXPECT_EQ(queues[static_cast<std::size_t>(MessagePriority::LOW)].size(), 1);
+  EXPECT_TRUE(queues[static_cast<std::size_t>(MessagePriority::NORMAL)].empty());
+  EXPECT_TRUE(queues[static_cast<std::size_t>(MessagePriority::HIGH)].empty());
+}
+
+}  // namespace
@@ -0,0 +1,119 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "crypto/ecdsa.hpp"
+#include "network/management/abstract_connection.hpp"
+#include "network/muddle/dispatcher.hpp"
+#include "network/muddle/muddle_register.hpp"
+#include "network/muddle/network_id.hpp"
+#include "network/muddle/router.hpp"
+
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace fetch {
+namespace muddle {
+namespace test {
+
+/**
+ * A connection which records everything that is sent to it
+ */
+class CapturingConnection : public network::AbstractConnection
+{
+public:
+  using network::AbstractConnection::SetAddress;
+
+  void Send(network::message_type const &msg) override
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    messages_.push_back(msg);
+  }
+
+  uint16_t Type() const override
+  {
+    return TYPE_UNDEFINED;
+  }
+
+  void Close() override
+  {}
+
+  bool Closed() const override
+  {
+    return false;
+  }
+
+  bool is_alive() const override
+  {
+    return true;
+  }
+
+  std::vector<network::message_type> Take()
+  {
+    std::vector<network::message_type> messages;
+
+    std::lock_guard<std::mutex> guard(lock_);
+    std::swap(messages, messages_);
+
+    return messages;
+  }
+
+private:
+  std::mutex                         lock_;
+  std::vector<network::message_type> messages_;
+};
+
+/**
+ * A single node with a (signing) router and a connection to its peer
+ */
+struct Node
+{
+  explicit Node(NetworkId const &network_id)
+    : signer{std::make_unique<crypto::ECDSASigner>()}
+    , address{signer->identity().identifier()}
+    , reg{dispatcher}
+    , router{network_id, address, reg, dispatcher, signer.get()}
+    , connection{std::make_shared<CapturingConnection>()}
+  {
+    static_cast<network::AbstractConnectionRegister &>(reg).Enter(connection);
+    router.Start();
+  }
+
+  ~Node()
+  {
+    router.Stop();
+  }
+
+  Router::Handle handle() const
+  {
+    return connection->handle();
+  }
+
+  std::unique_ptr<crypto::ECDSASigner> signer;
+  Packet::Address                      address;
+  Dispatcher                           dispatcher;
+  MuddleRegister                       reg;
+  Router                               router;
+  std::shared_ptr<CapturingConnection> connection;
+};
+
+}  // namespace test
+}  // namespace muddle
+}  // namespace fetch
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "network/muddle/broadcast_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+namespace {
+
+using fetch::muddle::BroadcastCache;
+using Clock     = BroadcastCache::Clock;
+using Timepoint = BroadcastCache::Timepoint;
+
+TEST(BroadcastCacheTests, CheckDuplicatesAreSuppressed)
+{
+  BroadcastCache cache{std::chrono::seconds{10}};
+  Timepoint const now = Clock::now();
+
+  EXPECT_TRUE(cache.Insert(1, now));
+  EXPECT_TRUE(cache.Insert(2, now));
+  EXPECT_FALSE(cache.Insert(1, now));
+  EXPECT_FALSE(cache.Insert(2, now));
+  EXPECT_TRUE(cache.Contains(1));
+  EXPECT_FALSE(cache.Contains(3));
+
+  // zero is used internally to mark empty slots, but must still be a valid identifier
+  EXPECT_FALSE(cache.Contains(0));
+  EXPECT_TRUE(cache.Insert(0, now));
+  EXPECT_FALSE(cache.Insert(0, now));
+
+  auto const stats = cache.GetStats();
+  EXPECT_EQ(stats.inserted, 3u);
+  EXPECT_EQ(stats.suppressed, 3u);
+}
+
+TEST(BroadcastCacheTests, CheckEntriesAgeOut)
+{
+  BroadcastCache cache{std::chrono::seconds{10}};
+  Timepoint const start = Clock::now();
+
+  EXPECT_TRUE(cache.Insert(42, start));
+
+  // the entry must be remembered for at least (NUM_BUCKETS - 1) intervals
+  for (std::size_t i = 1; i < BroadcastCache::NUM_BUCKETS; ++i)
+  {
+    EXPECT_FALSE(cache.Insert(42, start + std::chrono::seconds{10 * i}));
+  }
+
+  // but should be forgotten once all the buckets have been rotated
+  Timepoint const later =
+      start + std::chrono::seconds{10 * (2 * BroadcastCache::NUM_BUCKETS + 1)};
+  EXPECT_TRUE(cache.Insert(7, later));
+  EXPECT_FALSE(cache.Contains(42));
+}
+
+TEST(BroadcastCacheTests, CheckFullBucketIsRotated)
+{
+  BroadcastCache cache{std::chrono::seconds{10}};
+  Timepoint const now = Clock::now();
+
+  std::size_t const count = BroadcastCache::MAX_BUCKET_LOAD * 2;
+  for (std::size_t i = 1; i <= count; ++i)
+  {
+    EXPECT_TRUE(cache.Insert(i, now));
+  }
+
+  // both batches should still be present
+  EXPECT_TRUE(cache.Contains(1));
+  EXPECT_TRUE(cache.Contains(count));
+
+  auto const stats = cache.GetStats();
+  EXPECT_EQ(stats.inserted, count);
+  EXPECT_EQ(stats.forced_rotations, 1u);
+}
+
+}  // namespace
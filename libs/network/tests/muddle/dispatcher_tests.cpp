@@ -19,7 +19,12 @@
 #include "network/muddle/dispatcher.hpp"
 
 #include <gmock/gmock.h>
+
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
+#include <vector>
 
 class DispatcherTests : public ::testing::Test
 {
@@ -121,3 +126,135 @@ TEST_F(DispatcherTests, CheckConnectionFailure)
   EXPECT_FALSE(prom->IsSuccessful());
   EXPECT_FALSE(prom->Wait(0, false));
 }
+
+TEST_F(DispatcherTests, CheckExpiryAfterTimeout)
+{
+  Packet::Address address;
+
+  auto const start = Dispatcher::Clock::now();
+  Promise    prom  = dispatcher_->RegisterExchange(1, 2, 3, address);
+
+  // the promise survives the cleanups before its deadline
+  dispatcher_->Cleanup(start + std::chrono::seconds{10});
+  dispatcher_->Cleanup(start + std::chrono::seconds{20});
+  EXPECT_TRUE(prom->IsWaiting());
+  EXPECT_EQ(dispatcher_->GetNumPendingPromises(), 1);
+
+  dispatcher_->Cleanup(start + std::chrono::seconds{32});
+  EXPECT_TRUE(prom->IsFailed());
+  EXPECT_EQ(dispatcher_->GetNumPendingPromises(), 0);
+}
+
+TEST_F(DispatcherTests, CheckResolvedPromiseIsNotExpired)
+{
+  Payload   response("hello");
+  PacketPtr packet = CreatePacket(1, 2, 3, response);
+
+  Promise prom = dispatcher_->RegisterExchange(1, 2, 3, packet->GetSender());
+  EXPECT_TRUE(dispatcher_->Dispatch(packet));
+
+  // a second response to the same exchange is not matched
+  EXPECT_FALSE(dispatcher_->Dispatch(packet));
+
+  // nor is a new exchange with the same counter expired by the first
+  Promise next = dispatcher_->RegisterExchange(1, 2, 3, packet->GetSender());
+  dispatcher_->Cleanup(Dispatcher::Clock::now() + std::chrono::hours{2});
+
+  EXPECT_TRUE(prom->IsSuccessful());
+  EXPECT_TRUE(next->IsFailed());
+}
+
+TEST_F(DispatcherTests, CheckDuplicateCounterFailsPrevious)
+{
+  Packet::Address address;
+
+  Promise first  = dispatcher_->RegisterExchange(1, 2, 3, address);
+  Promise second = dispatcher_->RegisterExchange(4, 5, 3, address);
+
+  EXPECT_TRUE(first->IsFailed());
+  EXPECT_TRUE(second->IsWaiting());
+  EXPECT_EQ(dispatcher_->GetNumPendingPromises(), 1);
+}
+
+TEST_F(DispatcherTests, CheckFailAllPendingPromises)
+{
+  Packet::Address address;
+
+  Promise first  = dispatcher_->RegisterExchange(1, 2, 3, address);
+  Promise second = dispatcher_->RegisterExchange(1, 2, 60000, address);
+
+  dispatcher_->FailAllPendingPromises();
+
+  EXPECT_TRUE(first->IsFailed());
+  EXPECT_TRUE(second->IsFailed());
+  EXPECT_EQ(dispatcher_->GetNumPendingPromises(), 0);
+}
+
+TEST_F(DispatcherTests, CheckConcurrentExchanges)
+{
+  static constexpr std::size_t NUM_THREADS          = 4;
+  static constexpr std::size_t EXCHANGES_PER_THREAD = 2000;
+
+  std::atomic<std::size_t> fulfilled{0};
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < NUM_THREADS; ++i)
+  {
+    threads.emplace_back([this, &fulfilled]() {
+      for (std::size_t j = 0; j < EXCHANGES_PER_THREAD; ++j)
+      {
+        uint16_t const counter = dispatcher_->GetNextCounter();
+
+        PacketPtr packet = CreatePacket(1, 2, counter, Payload{});
+        Promise   prom   = dispatcher_->RegisterExchange(1, 2, counter, packet->GetSender());
+
+        if (dispatcher_->Dispatch(packet) && prom->IsSuccessful())
+        {
+          ++fulfilled;
+        }
+      }
+    });
+  }
+
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  EXPECT_EQ(fulfilled, NUM_THREADS * EXCHANGES_PER_THREAD);
+  EXPECT_EQ(dispatcher_->GetNumPendingPromises(), 0);
+}
+
+TEST_F(DispatcherTests, CheckDefaultPriority)
+{
+  using Priority = Dispatcher::Priority;
+
+  EXPECT_EQ(dispatcher_->GetPriority(1, 2), Priority::NORMAL);
+
+  dispatcher_->SetPriority(1, 2, Priority::HIGH);
+  EXPECT_EQ(dispatcher_->GetPriority(1, 2), Priority::HIGH);
+  EXPECT_EQ(dispatcher_->GetPriority(2, 1), Priority::NORMAL);
+}
+
+TEST_F(DispatcherTests, CheckHighPriorityDequeuedFirst)
+{
+  dispatcher_->SetPriority(1, 1, Dispatcher::Priority::LOW);
+  dispatcher_->SetPriority(3, 3, Dispatcher::Priority::HIGH);
+
+  Packet::Address address;
+  dispatcher_->Enqueue(CreatePacket(1, 1, 1, Payload{}), address);
+  dispatcher_->Enqueue(CreatePacket(2, 2, 2, Payload{}), address);
+  dispatcher_->Enqueue(CreatePacket(3, 3, 3, Payload{}), address);
+  EXPECT_EQ(dispatcher_->pending(), 3);
+
+  PacketPtr       packet;
+  Packet::Address transmitter;
+  for (uint16_t expected : {uint16_t{3}, uint16_t{2}, uint16_t{1}})
+  {
+    ASSERT_TRUE(dispatcher_->Dequeue(packet, transmitter));
+    EXPECT_EQ(packet->GetService(), expected);
+  }
+
+  EXPECT_FALSE(dispatcher_->Dequeue(packet, transmitter));
+  EXPECT_EQ(dispatcher_->pending(), 0);
+}
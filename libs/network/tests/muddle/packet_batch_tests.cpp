@@ -0,0 +1,208 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/serializers/byte_array_buffer.hpp"
+#include "core/serializers/stl_types.hpp"
+#include "core/service_ids.hpp"
+#include "muddle_test_node.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using fetch::muddle::NetworkId;
+using fetch::muddle::Packet;
+using fetch::muddle::Router;
+using fetch::muddle::test::Node;
+
+using Address   = Packet::Address;
+using PacketPtr = std::shared_ptr<Packet>;
+using Signer    = fetch::crypto::ECDSASigner;
+
+static constexpr uint16_t SERVICE = 1;
+static constexpr uint16_t CHANNEL = 1;
+
+class PacketBatchTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    alice_ = std::make_unique<Node>(network_id_);
+    bob_   = std::make_unique<Node>(network_id_);
+
+    // complete the routing handshake in both directions
+    Connect(*alice_, *bob_);
+    Connect(*bob_, *alice_);
+  }
+
+  void TearDown() override
+  {
+    subscriptions_.clear();
+    alice_.reset();
+    bob_.reset();
+  }
+
+  PacketPtr CreatePacket(Node &from, uint16_t service, uint16_t channel) const
+  {
+    PacketPtr packet = std::make_shared<Packet>(from.address, network_id_.value());
+    packet->SetService(service);
+    packet->SetProtocol(channel);
+
+    return packet;
+  }
+
+  void Connect(Node &node, Node &peer)
+  {
+    auto packet = CreatePacket(peer, fetch::SERVICE_MUDDLE, fetch::CHANNEL_ROUTING);
+    packet->SetDirect(true);
+    packet->Sign(*peer.signer);
+
+    node.router.Route(node.handle(), packet);
+
+    // the handshake is verified asynchronously
+    for (std::size_t i = 0; (i < 100) && !node.router.LookupHandleFromAddress(peer.address); ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+  }
+
+  /// Wait for the messages sent by a node to its peer
+  static std::vector<PacketPtr> WaitForPackets(Node &node, std::size_t count)
+  {
+    std::vector<PacketPtr> packets;
+
+    for (std::size_t i = 0; (i < 100) && (packets.size() < count); ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+      for (auto const &msg : node.connection->Take())
+      {
+        auto packet = std::make_shared<Packet>();
+        packet->FromWireBuffer(msg);
+        packets.push_back(packet);
+      }
+    }
+
+    return packets;
+  }
+
+  /// Count the messages which are delivered to a subscription on the node
+  std::shared_ptr<std::atomic<std::size_t>> CountDeliveries(Node &node)
+  {
+    auto count = std::make_shared<std::atomic<std::size_t>>(0);
+
+    auto subscription = node.router.Subscribe(SERVICE, CHANNEL);
+    subscription->SetMessageHandler(
+        [count](Address const &, uint16_t, uint16_t, uint16_t, Packet::Payload const &,
+                Address const &) { ++(*count); });
+    subscriptions_.push_back(subscription);
+
+    return count;
+  }
+
+  static bool WaitForCount(std::atomic<std::size_t> const &count, std::size_t expected)
+  {
+    for (std::size_t i = 0; (i < 100) && (count < expected); ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+
+    return count == expected;
+  }
+
+  NetworkId                            network_id_{"TEST"};
+  std::unique_ptr<Node>                alice_;
+  std::unique_ptr<Node>                bob_;
+  std::vector<Router::SubscriptionPtr> subscriptions_;
+};
+
+TEST_F(PacketBatchTests, CheckBurstSentAsSingleSignedBatch)
+{
+  auto const delivered = CountDeliveries(*bob_);
+
+  alice_->router.SetBatchWindow(20);
+  for (std::size_t i = 0; i < 5; ++i)
+  {
+    alice_->router.Send(bob_->address, SERVICE, CHANNEL, Packet::Payload{"hello"});
+  }
+
+  auto const packets = WaitForPackets(*alice_, 1);
+  ASSERT_EQ(packets.size(), 1);
+
+  auto const &batch = packets.front();
+  EXPECT_TRUE(batch->IsDirect());
+  EXPECT_EQ(batch->GetService(), fetch::SERVICE_MUDDLE);
+  EXPECT_EQ(batch->GetProtocol(), fetch::CHANNEL_BATCH);
+  EXPECT_TRUE(batch->Verify());
+
+  bob_->router.Route(bob_->handle(), batch);
+  EXPECT_TRUE(WaitForCount(*delivered, 5));
+}
+
+TEST_F(PacketBatchTests, CheckSinglePacketNotWrapped)
+{
+  alice_->router.SetBatchWindow(20);
+  alice_->router.Send(bob_->address, SERVICE, CHANNEL, Packet::Payload{"hello"});
+
+  auto const packets = WaitForPackets(*alice_, 1);
+  ASSERT_EQ(packets.size(), 1);
+
+  EXPECT_FALSE(packets.front()->IsDirect());
+  EXPECT_EQ(packets.front()->GetService(), SERVICE);
+  EXPECT_TRUE(packets.front()->Verify());
+}
+
+TEST_F(PacketBatchTests, CheckForeignUnsignedPacketsRejected)
+{
+  auto const delivered = CountDeliveries(*bob_);
+
+  // an unsigned packet which claims to originate from a third party
+  Signer mallory;
+  auto   forged = std::make_shared<Packet>(mallory.identity().identifier(), network_id_.value());
+  forged->SetService(SERVICE);
+  forged->SetProtocol(CHANNEL);
+  forged->SetTarget(bob_->address);
+
+  // an unsigned packet from alice herself
+  auto genuine = CreatePacket(*alice_, SERVICE, CHANNEL);
+  genuine->SetTarget(bob_->address);
+
+  std::vector<Packet::WireBuffer> buffers{forged->GetWireBuffer(), genuine->GetWireBuffer()};
+
+  fetch::serializers::ByteArrayBuffer serializer;
+  serializer << buffers;
+
+  auto batch = CreatePacket(*alice_, fetch::SERVICE_MUDDLE, fetch::CHANNEL_BATCH);
+  batch->SetDirect(true);
+  batch->SetPayload(serializer.data());
+  batch->Sign(*alice_->signer);
+
+  bob_->router.Route(bob_->handle(), batch);
+
+  EXPECT_TRUE(WaitForCount(*delivered, 1));
+  std::this_thread::sleep_for(std::chrono::milliseconds{50});
+  EXPECT_EQ(*delivered, 1);
+}
+
+}  // namespace
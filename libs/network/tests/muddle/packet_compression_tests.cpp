@@ -0,0 +1,306 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/service_ids.hpp"
+#include "muddle_test_node.hpp"
+#include "network/muddle/packet_compressor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using fetch::byte_array::ByteArray;
+using fetch::byte_array::ConstByteArray;
+using fetch::muddle::CompressionOptions;
+using fetch::muddle::NetworkId;
+using fetch::muddle::Packet;
+using fetch::muddle::PacketCompressor;
+using fetch::muddle::Router;
+using fetch::muddle::test::Node;
+
+using Address   = Packet::Address;
+using PacketPtr = std::shared_ptr<Packet>;
+
+static constexpr uint16_t SERVICE = 1;
+static constexpr uint16_t CHANNEL = 1;
+
+ConstByteArray Repetitive(std::size_t size)
+{
+  std::string text;
+  while (text.size() < size)
+  {
+    text += "{\"digest\": \"0123456789abcdef\", \"fee\": 1000, \"resources\": []} ";
+  }
+
+  return ConstByteArray{text.substr(0, size)};
+}
+
+CompressionOptions Enabled()
+{
+  CompressionOptions options;
+  options.enabled  = true;
+  options.min_size = 256;
+
+  return options;
+}
+
+class PacketCompressionTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    alice_ = std::make_unique<Node>(network_id_);
+    bob_   = std::make_unique<Node>(network_id_);
+
+    alice_->router.SetCompression(Enabled());
+  }
+
+  void TearDown() override
+  {
+    subscriptions_.clear();
+    alice_.reset();
+    bob_.reset();
+  }
+
+  /// Deliver the routing handshake of the peer, advertising the specified capabilities
+  void Connect(Node &node, Node &peer, ConstByteArray const &capabilities = ConstByteArray{})
+  {
+    auto packet = std::make_shared<Packet>(peer.address, network_id_.value());
+    packet->SetService(fetch::SERVICE_MUDDLE);
+    packet->SetProtocol(fetch::CHANNEL_ROUTING);
+    packet->SetDirect(true);
+    packet->SetPayload(capabilities);
+    packet->Sign(*peer.signer);
+
+    node.router.Route(node.handle(), packet);
+
+    // the handshake is verified asynchronously
+    for (std::size_t i = 0; (i < 100) && !node.router.LookupHandleFromAddress(peer.address); ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+  }
+
+  static std::vector<PacketPtr> WaitForPackets(Node &node, std::size_t count)
+  {
+    std::vector<PacketPtr> packets;
+
+    for (std::size_t i = 0; (i < 100) && (packets.size() < count); ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+      for (auto const &msg : node.connection->Take())
+      {
+        auto packet = std::make_shared<Packet>();
+        packet->FromWireBuffer(msg);
+        packets.push_back(packet);
+      }
+    }
+
+    return packets;
+  }
+
+  std::shared_ptr<std::atomic<std::size_t>> CountDeliveries(Node &node)
+  {
+    auto count = std::make_shared<std::atomic<std::size_t>>(0);
+
+    auto subscription = node.router.Subscribe(SERVICE, CHANNEL);
+    subscription->SetMessageHandler(
+        [count](Address const &, uint16_t, uint16_t, uint16_t, Packet::Payload const &,
+                Address const &) { ++(*count); });
+    subscriptions_.push_back(subscription);
+
+    return count;
+  }
+
+  static bool WaitForCount(std::atomic<std::size_t> const &count, std::size_t expected)
+  {
+    for (std::size_t i = 0; (i < 100) && (count < expected); ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+
+    return count == expected;
+  }
+
+  static bool IsCompressedFrame(Packet const &packet)
+  {
+    return packet.IsDirect() && (packet.GetService() == fetch::SERVICE_MUDDLE) &&
+           (packet.GetProtocol() == fetch::CHANNEL_COMPRESSED);
+  }
+
+  static ConstByteArray Capabilities(CompressionOptions const &options)
+  {
+    PacketCompressor compressor;
+    compressor.SetOptions(options);
+
+    return compressor.EncodeCapabilities();
+  }
+
+  NetworkId                            network_id_{"TEST"};
+  std::unique_ptr<Node>                alice_;
+  std::unique_ptr<Node>                bob_;
+  std::vector<Router::SubscriptionPtr> subscriptions_;
+};
+
+TEST(PacketCompressorTests, CheckRoundTrip)
+{
+  PacketCompressor compressor;
+  compressor.SetOptions(Enabled());
+
+  auto const input = Repetitive(4096);
+
+  ConstByteArray compressed;
+  ASSERT_TRUE(compressor.Compress(input, false, compressed));
+  EXPECT_LT(compressed.size(), input.size());
+
+  ByteArray output;
+  ASSERT_TRUE(compressor.Decompress(compressed, output));
+  EXPECT_EQ(ConstByteArray{output}, input);
+
+  // small inputs are not worth compressing
+  EXPECT_FALSE(compressor.Compress(Repetitive(100), false, compressed));
+}
+
+TEST(PacketCompressorTests, CheckDictionaryMustBeShared)
+{
+  auto options       = Enabled();
+  options.dictionary = Repetitive(1024);
+
+  PacketCompressor sender;
+  sender.SetOptions(options);
+
+  PacketCompressor receiver;
+  receiver.SetOptions(options);
+
+  PacketCompressor stranger;
+  stranger.SetOptions(Enabled());
+
+  EXPECT_NE(sender.dictionary_id(), 0u);
+  EXPECT_EQ(sender.dictionary_id(), receiver.dictionary_id());
+
+  auto const input = Repetitive(512);
+
+  ConstByteArray with_dictionary;
+  ConstByteArray without_dictionary;
+  ASSERT_TRUE(sender.Compress(input, true, with_dictionary));
+  ASSERT_TRUE(sender.Compress(input, false, without_dictionary));
+  EXPECT_LT(with_dictionary.size(), without_dictionary.size());
+
+  ByteArray output;
+  ASSERT_TRUE(receiver.Decompress(with_dictionary, output));
+  EXPECT_EQ(ConstByteArray{output}, input);
+
+  EXPECT_FALSE(stranger.Decompress(with_dictionary, output));
+  EXPECT_FALSE(stranger.Decompress(input, output));
+}
+
+TEST(PacketCompressorTests, CheckCapabilities)
+{
+  PacketCompressor compressor;
+  EXPECT_TRUE(compressor.EncodeCapabilities().empty());
+
+  auto options       = Enabled();
+  options.dictionary = Repetitive(64);
+  compressor.SetOptions(options);
+
+  auto const capabilities = PacketCompressor::DecodeCapabilities(compressor.EncodeCapabilities());
+  EXPECT_TRUE(capabilities.deflate);
+  EXPECT_EQ(capabilities.dictionary, compressor.dictionary_id());
+
+  // peers which predate compression send an empty handshake
+  EXPECT_FALSE(PacketCompressor::DecodeCapabilities(ConstByteArray{}).deflate);
+}
+
+TEST(PacketCompressorTests, CheckLocalAddresses)
+{
+  EXPECT_TRUE(PacketCompressor::IsLocalAddress("127.0.0.1"));
+  EXPECT_TRUE(PacketCompressor::IsLocalAddress("10.1.2.3"));
+  EXPECT_TRUE(PacketCompressor::IsLocalAddress("172.20.0.1"));
+  EXPECT_TRUE(PacketCompressor::IsLocalAddress("192.168.1.1"));
+  EXPECT_TRUE(PacketCompressor::IsLocalAddress("::1"));
+  EXPECT_TRUE(PacketCompressor::IsLocalAddress("fd00::1"));
+  EXPECT_TRUE(PacketCompressor::IsLocalAddress("::ffff:192.168.0.7"));
+
+  EXPECT_FALSE(PacketCompressor::IsLocalAddress("172.32.0.1"));
+  EXPECT_FALSE(PacketCompressor::IsLocalAddress("8.8.8.8"));
+  EXPECT_FALSE(PacketCompressor::IsLocalAddress("2001:db8::1"));
+  EXPECT_FALSE(PacketCompressor::IsLocalAddress(""));
+}
+
+TEST_F(PacketCompressionTests, CheckLargePacketsCompressedForCapablePeer)
+{
+  auto const delivered = CountDeliveries(*bob_);
+
+  Connect(*alice_, *bob_, Capabilities(Enabled()));
+  Connect(*bob_, *alice_);
+
+  alice_->router.Send(bob_->address, SERVICE, CHANNEL, Repetitive(8192));
+
+  auto const packets = WaitForPackets(*alice_, 1);
+  ASSERT_EQ(packets.size(), 1);
+  EXPECT_TRUE(IsCompressedFrame(*packets.front()));
+  EXPECT_EQ(alice_->router.GetCompressionStats().compressed, 1);
+
+  bob_->router.Route(bob_->handle(), packets.front());
+  EXPECT_TRUE(WaitForCount(*delivered, 1));
+  EXPECT_EQ(bob_->router.GetCompressionStats().decompressed, 1);
+}
+
+TEST_F(PacketCompressionTests, CheckSmallPacketsSentRaw)
+{
+  Connect(*alice_, *bob_, Capabilities(Enabled()));
+
+  alice_->router.Send(bob_->address, SERVICE, CHANNEL, Packet::Payload{"hello"});
+
+  auto const packets = WaitForPackets(*alice_, 1);
+  ASSERT_EQ(packets.size(), 1);
+  EXPECT_FALSE(IsCompressedFrame(*packets.front()));
+}
+
+TEST_F(PacketCompressionTests, CheckNoCompressionWithoutPeerSupport)
+{
+  Connect(*alice_, *bob_);
+
+  alice_->router.Send(bob_->address, SERVICE, CHANNEL, Repetitive(8192));
+
+  auto const packets = WaitForPackets(*alice_, 1);
+  ASSERT_EQ(packets.size(), 1);
+  EXPECT_FALSE(IsCompressedFrame(*packets.front()));
+}
+
+TEST_F(PacketCompressionTests, CheckNoCompressionOnLocalNetwork)
+{
+  alice_->connection->SetAddress("192.168.0.2");
+  Connect(*alice_, *bob_, Capabilities(Enabled()));
+
+  alice_->router.Send(bob_->address, SERVICE, CHANNEL, Repetitive(8192));
+
+  auto const packets = WaitForPackets(*alice_, 1);
+  ASSERT_EQ(packets.size(), 1);
+  EXPECT_FALSE(IsCompressedFrame(*packets.front()));
+}
+
+}  // namespace
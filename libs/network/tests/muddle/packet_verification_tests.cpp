@@ -0,0 +1,160 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/service_ids.hpp"
+#include "crypto/ecdsa.hpp"
+#include "muddle_test_node.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using fetch::muddle::NetworkId;
+using fetch::muddle::Packet;
+using fetch::muddle::Router;
+using fetch::muddle::test::Node;
+
+using Address   = Packet::Address;
+using PacketPtr = std::shared_ptr<Packet>;
+using Signer    = fetch::crypto::ECDSASigner;
+
+static constexpr uint16_t SERVICE = 1;
+static constexpr uint16_t CHANNEL = 1;
+
+class PacketVerificationTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    node_ = std::make_unique<Node>(network_id_);
+
+    delivered_    = std::make_shared<std::atomic<std::size_t>>(0);
+    subscription_ = node_->router.Subscribe(SERVICE, CHANNEL);
+
+    auto delivered = delivered_;
+    subscription_->SetMessageHandler(
+        [delivered](Address const &, uint16_t, uint16_t, uint16_t, Packet::Payload const &,
+                    Address const &) { ++(*delivered); });
+
+    // the node is directly connected to the peer
+    auto packet = CreatePacket(peer_.identity().identifier());
+    packet->SetService(fetch::SERVICE_MUDDLE);
+    packet->SetProtocol(fetch::CHANNEL_ROUTING);
+    packet->SetDirect(true);
+    packet->Sign(peer_);
+
+    node_->router.Route(node_->handle(), packet);
+
+    // the handshake is verified asynchronously
+    for (std::size_t i = 0;
+         (i < 100) && !node_->router.LookupHandleFromAddress(peer_.identity().identifier()); ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+  }
+
+  void TearDown() override
+  {
+    subscription_.reset();
+    node_.reset();
+  }
+
+  PacketPtr CreatePacket(Address const &from) const
+  {
+    PacketPtr packet = std::make_shared<Packet>(from, network_id_.value());
+    packet->SetService(SERVICE);
+    packet->SetProtocol(CHANNEL);
+    packet->SetPayload(Packet::Payload{"payload"});
+
+    return packet;
+  }
+
+  bool WaitForDeliveries(std::size_t expected) const
+  {
+    for (std::size_t i = 0; (i < 100) && (*delivered_ < expected); ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+
+    // allow time for any unexpected deliveries
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+
+    return *delivered_ == expected;
+  }
+
+  NetworkId                                 network_id_{"TEST"};
+  Signer                                    peer_;
+  std::unique_ptr<Node>                     node_;
+  std::shared_ptr<std::atomic<std::size_t>> delivered_;
+  Router::SubscriptionPtr                   subscription_;
+};
+
+TEST_F(PacketVerificationTests, CheckOnlyGenuinePacketsDelivered)
+{
+  Signer mallory;
+
+  for (std::size_t i = 0; i < 10; ++i)
+  {
+    // a genuine packet from the peer
+    auto genuine = CreatePacket(peer_.identity().identifier());
+    genuine->SetTarget(node_->address);
+    genuine->Sign(peer_);
+
+    // a packet which claims to be from the peer but was signed by someone else
+    auto forged = CreatePacket(peer_.identity().identifier());
+    forged->SetTarget(node_->address);
+    forged->Sign(mallory);
+
+    node_->router.Route(node_->handle(), genuine);
+    node_->router.Route(node_->handle(), forged);
+  }
+
+  EXPECT_TRUE(WaitForDeliveries(10));
+}
+
+TEST_F(PacketVerificationTests, CheckForwardedPacketsNotVerified)
+{
+  Signer mallory;
+  Signer target;
+
+  // a packet which would fail verification, but is destined for another node
+  auto packet = CreatePacket(peer_.identity().identifier());
+  packet->SetTarget(target.identity().identifier());
+  packet->Sign(mallory);
+  packet->SetTTL(10);
+
+  node_->router.Route(node_->handle(), packet);
+
+  // the packet is passed on (to the only connection available)
+  auto const forwarded = node_->connection->Take();
+  ASSERT_EQ(forwarded.size(), 1);
+
+  Packet received;
+  received.FromWireBuffer(forwarded.front());
+  EXPECT_EQ(received.GetTarget(), target.identity().identifier());
+
+  EXPECT_TRUE(WaitForDeliveries(0));
+}
+
+}  // namespace
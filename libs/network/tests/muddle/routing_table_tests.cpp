@@ -0,0 +1,206 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/service_ids.hpp"
+#include "network/management/abstract_connection.hpp"
+#include "network/muddle/dispatcher.hpp"
+#include "network/muddle/muddle_register.hpp"
+#include "network/muddle/router.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+namespace {
+
+using fetch::muddle::Dispatcher;
+using fetch::muddle::MuddleRegister;
+using fetch::muddle::NetworkId;
+using fetch::muddle::Packet;
+using fetch::muddle::Router;
+using fetch::network::AbstractConnection;
+using fetch::network::AbstractConnectionRegister;
+using fetch::network::message_type;
+
+using Address       = Packet::Address;
+using Handle        = Router::Handle;
+using PacketPtr     = std::shared_ptr<Packet>;
+using ConnectionPtr = std::shared_ptr<AbstractConnection>;
+
+/**
+ * A connection which silently discards everything that is sent to it
+ */
+class NullConnection : public AbstractConnection
+{
+public:
+  void Send(message_type const &) override
+  {}
+
+  uint16_t Type() const override
+  {
+    return TYPE_UNDEFINED;
+  }
+
+  void Close() override
+  {
+    closed_ = true;
+  }
+
+  bool Closed() const override
+  {
+    return closed_;
+  }
+
+  bool is_alive() const override
+  {
+    return !closed_;
+  }
+
+private:
+  bool closed_{false};
+};
+
+class RoutingTableTests : public ::testing::Test
+{
+protected:
+  static constexpr uint8_t DEFAULT_TTL = 40;
+
+  void SetUp() override
+  {
+    register_ = std::make_unique<MuddleRegister>(dispatcher_);
+    router_   = std::make_unique<Router>(network_id_, CreateAddress(0), *register_, dispatcher_);
+  }
+
+  static Address CreateAddress(uint8_t value)
+  {
+    fetch::byte_array::ByteArray address;
+    address.Resize(Packet::ADDRESS_SIZE);
+    for (std::size_t i = 0; i < address.size(); ++i)
+    {
+      address[i] = value;
+    }
+
+    return address;
+  }
+
+  Handle CreateConnection()
+  {
+    ConnectionPtr connection = std::make_shared<NullConnection>();
+    static_cast<AbstractConnectionRegister &>(*register_).Enter(connection);
+    connections_.push_back(connection);
+
+    return connection->handle();
+  }
+
+  /// Deliver a packet from the sender (a number of hops away) which is to be routed onwards
+  void ReceiveRouted(Handle handle, Address const &sender, uint8_t hops)
+  {
+    PacketPtr packet = std::make_shared<Packet>(sender, network_id_.value());
+    packet->SetService(1);
+    packet->SetProtocol(1);
+    packet->SetTTL(static_cast<uint8_t>(DEFAULT_TTL - hops + 1));
+    packet->SetTarget(CreateAddress(0xFF));
+
+    router_->Route(handle, packet);
+  }
+
+  /// Deliver the routing response of a directly connected peer
+  void ReceiveDirect(Handle handle, Address const &sender)
+  {
+    PacketPtr packet = std::make_shared<Packet>(sender, network_id_.value());
+    packet->SetService(fetch::SERVICE_MUDDLE);
+    packet->SetProtocol(fetch::CHANNEL_ROUTING);
+    packet->SetDirect(true);
+
+    router_->Route(handle, packet);
+  }
+
+  Handle Lookup(Address const &address) const
+  {
+    return router_->LookupHandleFromAddress(address);
+  }
+
+  NetworkId                       network_id_{"TEST"};
+  Dispatcher                      dispatcher_;
+  std::unique_ptr<MuddleRegister> register_;
+  std::unique_ptr<Router>         router_;
+  std::vector<ConnectionPtr>      connections_;
+};
+
+constexpr uint8_t RoutingTableTests::DEFAULT_TTL;
+
+TEST_F(RoutingTableTests, CheckFewestHopsSelected)
+{
+  Handle const far  = CreateConnection();
+  Handle const near = CreateConnection();
+
+  Address const peer = CreateAddress(1);
+
+  ReceiveRouted(far, peer, 5);
+  EXPECT_EQ(Lookup(peer), far);
+
+  ReceiveRouted(near, peer, 2);
+  EXPECT_EQ(Lookup(peer), near);
+
+  auto const routing_table = router_->GetRoutingTable();
+  ASSERT_EQ(routing_table.size(), 1);
+  EXPECT_EQ(routing_table.begin()->second.hops, 2);
+  EXPECT_FALSE(routing_table.begin()->second.direct);
+}
+
+TEST_F(RoutingTableTests, CheckDirectRoutePreferred)
+{
+  Handle const routed = CreateConnection();
+  Handle const direct = CreateConnection();
+
+  Address const peer = CreateAddress(1);
+
+  ReceiveDirect(direct, peer);
+  ReceiveRouted(routed, peer, 1);
+
+  EXPECT_EQ(Lookup(peer), direct);
+  EXPECT_TRUE(router_->GetRoutingTable().at(Router::ConvertAddress(peer)).direct);
+}
+
+TEST_F(RoutingTableTests, CheckAlternativeRouteUsedAfterDrop)
+{
+  Handle const first  = CreateConnection();
+  Handle const second = CreateConnection();
+
+  Address const peer  = CreateAddress(1);
+  Address const other = CreateAddress(2);
+
+  ReceiveDirect(first, peer);
+  ReceiveRouted(second, peer, 3);
+  ReceiveRouted(first, other, 2);
+  EXPECT_EQ(Lookup(peer), first);
+
+  auto const before = router_->GetRoutingTable();
+
+  router_->DropHandle(first, peer);
+
+  // the remaining path to the peer takes over and the unreachable address is removed
+  EXPECT_EQ(Lookup(peer), second);
+  EXPECT_EQ(Lookup(other), 0);
+
+  // previously taken copies of the table are unaffected
+  EXPECT_EQ(before.size(), 2);
+  EXPECT_EQ(before.at(Router::ConvertAddress(peer)).handle, first);
+}
+
+}  // namespace
@@ -0,0 +1,82 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "network/muddle/subscription_feed.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+using fetch::muddle::SubscriptionFeed;
+
+using Address         = SubscriptionFeed::Address;
+using Payload         = SubscriptionFeed::Payload;
+using SubscriptionPtr = SubscriptionFeed::SubscriptionPtr;
+
+TEST(SubscriptionFeedTests, CheckPayloadSharedBetweenSubscribers)
+{
+  SubscriptionFeed feed;
+
+  std::vector<SubscriptionPtr> subscriptions;
+  std::vector<Payload>         received;
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    subscriptions.push_back(feed.Subscribe());
+    subscriptions.back()->SetMessageHandler(
+        [&received](Address const &, uint16_t, uint16_t, uint16_t, Payload const &payload,
+                    Address const &) { received.push_back(payload); });
+  }
+
+  Payload const payload{"a transaction"};
+  EXPECT_TRUE(feed.Dispatch(Address{}, 1, 2, 3, payload, Address{}));
+
+  ASSERT_EQ(received.size(), 3);
+  for (auto const &entry : received)
+  {
+    EXPECT_EQ(entry.pointer(), payload.pointer());
+  }
+}
+
+TEST(SubscriptionFeedTests, CheckHandlerCanSubscribeDuringDispatch)
+{
+  SubscriptionFeed feed;
+
+  SubscriptionPtr later;
+  auto            subscription = feed.Subscribe();
+  subscription->SetMessageHandler(
+      [&feed, &later](Address const &, uint16_t, uint16_t, uint16_t, Payload const &,
+                      Address const &) { later = feed.Subscribe(); });
+
+  // the handler is not called with the feed lock held
+  EXPECT_TRUE(feed.Dispatch(Address{}, 1, 2, 3, Payload{"a"}, Address{}));
+  EXPECT_TRUE(static_cast<bool>(later));
+}
+
+TEST(SubscriptionFeedTests, CheckDeadSubscriptionsRemoved)
+{
+  SubscriptionFeed feed;
+
+  feed.Subscribe();
+
+  EXPECT_FALSE(feed.Dispatch(Address{}, 1, 2, 3, Payload{"a"}, Address{}));
+}
+
+}  // namespace
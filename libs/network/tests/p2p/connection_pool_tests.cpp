@@ -0,0 +1,143 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "network/p2pservice/connection_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace {
+
+using fetch::p2p::ConnectionPool;
+using Address    = ConnectionPool::Address;
+using Candidate  = ConnectionPool::Candidate;
+using Candidates = ConnectionPool::Candidates;
+
+Candidate MakeCandidate(std::string const &name, double trust, uint32_t latency_us, bool connected)
+{
+  Candidate candidate;
+  candidate.address    = Address{name};
+  candidate.trust      = trust;
+  candidate.latency_us = latency_us;
+  candidate.connected  = connected;
+  return candidate;
+}
+
+bool Contains(ConnectionPool::AddressSet const &addresses, std::string const &name)
+{
+  return addresses.find(Address{name}) != addresses.end();
+}
+
+TEST(ConnectionPoolTests, CheckScoreFavoursLowLatency)
+{
+  auto const fast    = MakeCandidate("fast", 0.5, 10000, true);
+  auto const slow    = MakeCandidate("slow", 0.5, 400000, true);
+  auto const unknown = MakeCandidate("unknown", 0.5, 0, false);
+
+  EXPECT_GT(ConnectionPool::Score(fast), ConnectionPool::Score(unknown));
+  EXPECT_GT(ConnectionPool::Score(unknown), ConnectionPool::Score(slow));
+}
+
+TEST(ConnectionPoolTests, CheckFillsUpToTarget)
+{
+  ConnectionPool pool{2, 1};
+
+  auto const desired = pool.Update({MakeCandidate("a", 0.9, 0, false),
+                                    MakeCandidate("b", 0.2, 0, false),
+                                    MakeCandidate("c", 0.7, 0, false)});
+
+  EXPECT_EQ(desired.size(), 2u);
+  EXPECT_TRUE(Contains(desired, "a"));
+  EXPECT_TRUE(Contains(desired, "c"));
+  EXPECT_EQ(pool.NumWarming(), 2u);
+}
+
+TEST(ConnectionPoolTests, CheckDropsWorstExcessPeers)
+{
+  ConnectionPool pool{2, 1};
+
+  auto const desired = pool.Update({MakeCandidate("a", 0.5, 10000, true),
+                                    MakeCandidate("b", 0.5, 500000, true),
+                                    MakeCandidate("c", 0.5, 20000, true)});
+
+  EXPECT_EQ(desired.size(), 2u);
+  EXPECT_TRUE(Contains(desired, "a"));
+  EXPECT_TRUE(Contains(desired, "c"));
+  EXPECT_EQ(pool.NumWarming(), 0u);
+}
+
+TEST(ConnectionPoolTests, CheckSlowPeerRotatedOutAfterReplacementConnects)
+{
+  ConnectionPool pool{2, 1};
+
+  // the slow peer is kept while the replacement is pre-warmed
+  auto desired = pool.Update({MakeCandidate("fast", 0.5, 10000, true),
+                              MakeCandidate("slow", 0.5, 800000, true),
+                              MakeCandidate("new", 0.5, 0, false)});
+
+  EXPECT_EQ(desired.size(), 3u);
+  EXPECT_TRUE(Contains(desired, "slow"));
+  EXPECT_TRUE(Contains(desired, "new"));
+  EXPECT_EQ(pool.NumWarming(), 1u);
+
+  // once the replacement is connected the slow peer is released
+  desired = pool.Update({MakeCandidate("fast", 0.5, 10000, true),
+                         MakeCandidate("slow", 0.5, 800000, true),
+                         MakeCandidate("new", 0.5, 30000, true)});
+
+  EXPECT_EQ(desired.size(), 2u);
+  EXPECT_TRUE(Contains(desired, "fast"));
+  EXPECT_TRUE(Contains(desired, "new"));
+  EXPECT_EQ(pool.NumWarming(), 0u);
+}
+
+TEST(ConnectionPoolTests, CheckNoRotationWithoutSignificantImprovement)
+{
+  ConnectionPool pool{2, 1};
+
+  auto const desired = pool.Update({MakeCandidate("a", 0.5, 90000, true),
+                                    MakeCandidate("b", 0.5, 100000, true),
+                                    MakeCandidate("c", 0.5, 0, false)});
+
+  EXPECT_EQ(desired.size(), 2u);
+  EXPECT_FALSE(Contains(desired, "c"));
+  EXPECT_EQ(pool.NumWarming(), 0u);
+}
+
+TEST(ConnectionPoolTests, CheckFailedWarmupIsCooledDown)
+{
+  ConnectionPool pool{1, 1};
+
+  Candidates const candidates{MakeCandidate("a", 0.9, 0, false), MakeCandidate("b", 0.1, 0, false)};
+
+  for (std::size_t i = 0; i < ConnectionPool::MAX_WARMUP_CYCLES; ++i)
+  {
+    auto const desired = pool.Update(candidates);
+    ASSERT_TRUE(Contains(desired, "a"));
+  }
+
+  // the best candidate never connected, the next best is tried instead
+  auto const desired = pool.Update(candidates);
+  EXPECT_EQ(desired.size(), 1u);
+  EXPECT_TRUE(Contains(desired, "b"));
+}
+
+}  // namespace
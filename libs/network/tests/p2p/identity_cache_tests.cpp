@@ -0,0 +1,118 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "network/p2pservice/identity_cache.hpp"
+#include "network/p2pservice/p2p_remote_manifest_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+namespace {
+
+using fetch::p2p::IdentityCache;
+using fetch::p2p::ManifestCache;
+using Address = IdentityCache::Address;
+using Clock   = IdentityCache::Clock;
+using Uri     = IdentityCache::Uri;
+
+TEST(IdentityCacheTests, CheckUnknownAddressNeedsResolution)
+{
+  IdentityCache cache;
+
+  Uri uri;
+  EXPECT_FALSE(cache.Lookup(Address{"peer"}, uri));
+  EXPECT_TRUE(cache.NeedsResolution(Address{"peer"}));
+}
+
+TEST(IdentityCacheTests, CheckResolvedAddressIsRefreshedOnceStale)
+{
+  IdentityCache cache;
+  cache.Update(Address{"peer"}, Uri{"tcp://127.0.0.1:8000"});
+
+  Uri uri;
+  ASSERT_TRUE(cache.Lookup(Address{"peer"}, uri));
+  EXPECT_EQ(uri.uri(), "tcp://127.0.0.1:8000");
+
+  auto const now = Clock::now();
+  EXPECT_FALSE(cache.NeedsResolution(Address{"peer"}, now));
+  EXPECT_TRUE(cache.NeedsResolution(Address{"peer"}, now + IdentityCache::REFRESH_INTERVAL));
+
+  // the stale entry remains in use until it is refreshed
+  EXPECT_TRUE(cache.Lookup(Address{"peer"}, uri));
+}
+
+TEST(IdentityCacheTests, CheckFailedResolutionIsRetriedLater)
+{
+  IdentityCache cache;
+
+  auto const now = Clock::now();
+  cache.MarkUnresolved(Address{"peer"}, now);
+
+  EXPECT_FALSE(cache.NeedsResolution(Address{"peer"}, now));
+  EXPECT_TRUE(cache.NeedsResolution(Address{"peer"}, now + IdentityCache::RETRY_INTERVAL));
+
+  // a successful resolution clears the failure
+  cache.Update(Address{"peer"}, Uri{"tcp://127.0.0.1:8000"});
+  EXPECT_FALSE(cache.NeedsResolution(Address{"peer"}, now));
+
+  Uri uri;
+  EXPECT_TRUE(cache.Lookup(Address{"peer"}, uri));
+}
+
+TEST(IdentityCacheTests, CheckMuddleUrisAreUnresolved)
+{
+  IdentityCache cache;
+  cache.Update(Address{"muddle"}, Uri{"muddle://" + std::string(86, 'A') + "=="});
+  cache.Update(Address{"tcp"}, Uri{"tcp://127.0.0.1:8000"});
+
+  auto const resolved = cache.FilterOutUnresolved({Address{"muddle"}, Address{"tcp"}});
+
+  ASSERT_EQ(resolved.size(), 1u);
+  EXPECT_EQ(*resolved.begin(), Address{"tcp"});
+  EXPECT_TRUE(cache.NeedsResolution(Address{"muddle"}));
+}
+
+TEST(ManifestCacheTests, CheckFailedPeersAreRetriedLater)
+{
+  ManifestCache cache;
+
+  cache.ProvideFailure(Address{"peer"}, 60);
+
+  ManifestCache::Manifest manifest;
+  EXPECT_FALSE(cache.Get(Address{"peer"}, manifest));
+  EXPECT_TRUE(cache.GetUpdatesNeeded({Address{"peer"}}).empty());
+  EXPECT_EQ(cache.GetUpdatesNeeded({Address{"other"}}).size(), 1u);
+}
+
+TEST(ManifestCacheTests, CheckManifestIsKeptWhenRefreshFails)
+{
+  ManifestCache cache;
+
+  cache.ProvideUpdate(Address{"peer"}, ManifestCache::Manifest{}, 0);
+  EXPECT_EQ(cache.GetUpdatesNeeded().size(), 1u);
+
+  cache.ProvideFailure(Address{"peer"}, 60);
+  EXPECT_TRUE(cache.GetUpdatesNeeded().empty());
+
+  ManifestCache::Manifest manifest;
+  EXPECT_TRUE(cache.Get(Address{"peer"}, manifest));
+}
+
+}  // namespace
@@ -19,6 +19,9 @@
 #include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "network/p2pservice/p2ptrust_bayrank.hpp"
 #include <gtest/gtest.h>
@@ -145,4 +148,74 @@ TEST(TrustTests, BayDuplicate)
   trust.AddFeedback("peer1", ConstByteArray{}, TrustSubject::BLOCK,
                     fetch::p2p::TrustQuality::DUPLICATE);
   EXPECT_EQ(trust.IsPeerTrusted("peer1"), true);
-}
\ No newline at end of file
+}
+
+TEST(TrustTests, BayRanksFollowScores)
+{
+  P2PTrustBayRank<std::string> trust;
+  trust.AddFeedback("liar", ConstByteArray{}, TrustSubject::BLOCK, TrustQuality::LIED);
+  trust.AddFeedback("new", ConstByteArray{}, TrustSubject::PEER, TrustQuality::NEW_PEER);
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    trust.AddFeedback("good", ConstByteArray{}, TrustSubject::BLOCK, TrustQuality::NEW_INFORMATION);
+  }
+
+  EXPECT_EQ(trust.GetRankOfPeer("liar"), 0);
+  EXPECT_EQ(trust.GetRankOfPeer("new"), 1);
+  EXPECT_EQ(trust.GetRankOfPeer("good"), 2);
+  EXPECT_EQ(trust.GetRankOfPeer("unknown"), 4);
+
+  auto const trusts = trust.GetPeersAndTrusts();
+  ASSERT_EQ(trusts.size(), 3);
+  EXPECT_EQ(trusts.front().address, "liar");
+  EXPECT_EQ(trusts.back().address, "good");
+
+  // further feedback moves the peer within the ranking
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    trust.AddFeedback("good", ConstByteArray{}, TrustSubject::BLOCK, TrustQuality::LIED);
+  }
+  EXPECT_LT(trust.GetRankOfPeer("good"), trust.GetRankOfPeer("new"));
+
+  auto const best = trust.GetBestPeers(10);
+  EXPECT_EQ(best.count("new"), 1);
+  EXPECT_EQ(best.count("liar"), 0);
+}
+
+TEST(TrustTests, BayConcurrentFeedbackIsApplied)
+{
+  static constexpr std::size_t NUM_THREADS  = 4;
+  static constexpr std::size_t NUM_FEEDBACK = 200;
+
+  P2PTrustBayRank<std::string> trust;
+  P2PTrustBayRank<std::string> reference;
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < NUM_THREADS; ++i)
+  {
+    threads.emplace_back([&trust, i]() {
+      for (std::size_t j = 0; j < NUM_FEEDBACK; ++j)
+      {
+        trust.AddFeedback("peer" + std::to_string(i), ConstByteArray{}, TrustSubject::TRANSACTION,
+                          TrustQuality::DUPLICATE);
+      }
+    });
+  }
+
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  for (std::size_t j = 0; j < NUM_FEEDBACK; ++j)
+  {
+    reference.AddFeedback("peer", ConstByteArray{}, TrustSubject::TRANSACTION,
+                          TrustQuality::DUPLICATE);
+  }
+
+  for (std::size_t i = 0; i < NUM_THREADS; ++i)
+  {
+    EXPECT_DOUBLE_EQ(trust.GetTrustRatingOfPeer("peer" + std::to_string(i)),
+                     reference.GetTrustRatingOfPeer("peer"));
+  }
+}
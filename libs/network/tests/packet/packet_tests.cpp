@@ -144,3 +144,61 @@ TEST_F(PacketTests, CheckIndifference)
   EXPECT_TRUE(packet_->IsStamped());
   EXPECT_TRUE(packet_->Verify());
 }
+
+TEST_F(PacketTests, CheckWireBufferRoundTrip)
+{
+  packet_->Sign(*prover_);
+
+  Packet decoded;
+  decoded.FromWireBuffer(packet_->GetWireBuffer());
+
+  EXPECT_EQ(decoded.GetSender(), packet_->GetSender());
+  EXPECT_EQ(decoded.GetService(), 1u);
+  EXPECT_EQ(decoded.GetProtocol(), 2u);
+  EXPECT_EQ(decoded.GetMessageNum(), 3u);
+  EXPECT_EQ(decoded.GetPayload(), response_);
+  EXPECT_TRUE(decoded.IsStamped());
+  EXPECT_TRUE(decoded.Verify());
+}
+
+TEST_F(PacketTests, CheckTTLIsPatchedInPlace)
+{
+  packet_->Sign(*prover_);
+
+  Packet decoded;
+  decoded.FromWireBuffer(packet_->GetWireBuffer());
+
+  // the received buffer has not been handed out, so the TTL update should not allocate
+  decoded.SetTTL(10);
+
+  auto const &wire = decoded.GetWireBuffer();
+
+  Packet forwarded;
+  forwarded.FromWireBuffer(wire);
+  EXPECT_EQ(forwarded.GetTTL(), 10u);
+  EXPECT_EQ(forwarded.GetPayload(), response_);
+  EXPECT_TRUE(forwarded.Verify());
+
+  // compare against a freshly encoded version of the packet
+  fetch::serializers::ByteArrayBuffer buffer;
+  buffer << decoded;
+  EXPECT_EQ(Payload{wire}, Payload{buffer.data()});
+}
+
+TEST_F(PacketTests, CheckSharedWireBufferIsNotModified)
+{
+  packet_->SetTTL(40);
+
+  Payload const original = packet_->GetWireBuffer();
+
+  // once handed out the buffer must not be modified in place
+  packet_->SetTTL(20);
+
+  Packet before;
+  before.FromWireBuffer(original);
+  EXPECT_EQ(before.GetTTL(), 40u);
+
+  Packet after;
+  after.FromWireBuffer(packet_->GetWireBuffer());
+  EXPECT_EQ(after.GetTTL(), 20u);
+}
@@ -0,0 +1,175 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "network/details/future_work_store.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using fetch::network::details::FutureWorkStore;
+using std::chrono::milliseconds;
+using std::this_thread::sleep_for;
+
+using Clock     = std::chrono::steady_clock;
+using Timestamp = Clock::time_point;
+using WorkItem  = FutureWorkStore::WorkItem;
+
+std::size_t DispatchAll(FutureWorkStore &store)
+{
+  return store.Dispatch([](WorkItem const &item) { item(); });
+}
+
+bool DispatchUntilEmpty(FutureWorkStore &store, milliseconds timeout)
+{
+  Timestamp const deadline = Clock::now() + timeout;
+
+  while (store.size() > 0)
+  {
+    if (Clock::now() > deadline)
+    {
+      return false;
+    }
+
+    DispatchAll(store);
+    sleep_for(milliseconds{1});
+  }
+
+  return true;
+}
+
+TEST(FutureWorkStoreTests, ItemIsOnlyDispatchedOnceDue)
+{
+  FutureWorkStore store;
+
+  std::size_t count = 0;
+  store.Post([&count]() { ++count; }, 50);
+
+  EXPECT_EQ(DispatchAll(store), 0);
+  EXPECT_EQ(count, 0);
+  EXPECT_GT(store.TimeUntilNextItem(), milliseconds::zero());
+  EXPECT_LE(store.TimeUntilNextItem(), milliseconds{50});
+
+  sleep_for(milliseconds{60});
+
+  EXPECT_EQ(store.TimeUntilNextItem(), milliseconds::zero());
+  EXPECT_EQ(DispatchAll(store), 1);
+  EXPECT_EQ(count, 1);
+  EXPECT_EQ(store.size(), 0);
+  EXPECT_EQ(store.TimeUntilNextItem(), milliseconds::max());
+}
+
+TEST(FutureWorkStoreTests, ItemsAreNeverDispatchedEarly)
+{
+  static constexpr std::size_t NUM_ITEMS = 2000;
+  static constexpr uint32_t    MAX_DELAY = 300;
+
+  FutureWorkStore                         store;
+  std::mt19937                            rng{42};
+  std::uniform_int_distribution<uint32_t> delays{0, MAX_DELAY};
+
+  std::vector<Timestamp> due(NUM_ITEMS);
+  std::vector<Timestamp> executed(NUM_ITEMS);
+
+  for (std::size_t i = 0; i < NUM_ITEMS; ++i)
+  {
+    uint32_t const delay = delays(rng);
+
+    due[i] = Clock::now() + milliseconds{delay};
+    store.Post([&executed, i]() { executed[i] = Clock::now(); }, delay);
+  }
+
+  ASSERT_TRUE(DispatchUntilEmpty(store, milliseconds{MAX_DELAY * 10}));
+
+  for (std::size_t i = 0; i < NUM_ITEMS; ++i)
+  {
+    // the wheel has a millisecond resolution
+    EXPECT_GE(executed[i] + milliseconds{1}, due[i]);
+  }
+}
+
+TEST(FutureWorkStoreTests, LongDelaysAreCascaded)
+{
+  FutureWorkStore store;
+
+  std::size_t count = 0;
+  store.Post([&count]() { ++count; }, 1500);
+  store.Post([&count]() { ++count; }, 70);
+
+  // the upper level items only report a lower bound
+  EXPECT_LE(store.TimeUntilNextItem(), milliseconds{70});
+
+  ASSERT_TRUE(DispatchUntilEmpty(store, milliseconds{5000}));
+  EXPECT_EQ(count, 2);
+}
+
+TEST(FutureWorkStoreTests, CancelledItemsAreNotDispatched)
+{
+  FutureWorkStore store;
+
+  std::size_t count  = 0;
+  auto const  first  = store.Post([&count]() { ++count; }, 10);
+  auto const  second = store.Post([&count]() { count += 10; }, 10);
+
+  EXPECT_NE(first, FutureWorkStore::INVALID_HANDLE);
+  EXPECT_NE(second, FutureWorkStore::INVALID_HANDLE);
+  EXPECT_NE(first, second);
+
+  EXPECT_TRUE(store.Cancel(second));
+  EXPECT_FALSE(store.Cancel(second));
+  EXPECT_EQ(store.size(), 1);
+
+  ASSERT_TRUE(DispatchUntilEmpty(store, milliseconds{1000}));
+  EXPECT_EQ(count, 1);
+
+  // the item has run, the handle is no longer valid
+  EXPECT_FALSE(store.Cancel(first));
+  EXPECT_FALSE(store.Cancel(FutureWorkStore::INVALID_HANDLE));
+}
+
+TEST(FutureWorkStoreTests, StaleHandlesDoNotCancelReusedNodes)
+{
+  FutureWorkStore store;
+
+  auto const stale = store.Post([]() {}, 1000);
+  ASSERT_TRUE(store.Cancel(stale));
+
+  std::size_t count = 0;
+  store.Post([&count]() { ++count; }, 0);
+
+  EXPECT_FALSE(store.Cancel(stale));
+  EXPECT_EQ(DispatchAll(store), 1);
+  EXPECT_EQ(count, 1);
+}
+
+TEST(FutureWorkStoreTests, PostIsRejectedAfterAbort)
+{
+  FutureWorkStore store;
+  store.Abort();
+
+  EXPECT_EQ(store.Post([]() {}, 0), FutureWorkStore::INVALID_HANDLE);
+  EXPECT_EQ(store.size(), 0);
+}
+
+}  // namespace
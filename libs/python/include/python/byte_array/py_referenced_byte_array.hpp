@@ -26,7 +26,12 @@ namespace byte_array {
 void BuildByteArray(pybind11::module &module)
 {
   namespace py = pybind11;
-  py::class_<ByteArray, ConstByteArray>(module, "ByteArray")
+  py::class_<ByteArray, ConstByteArray>(module, "ByteArray", py::buffer_protocol())
+      .def_buffer([](ByteArray &a) {
+        // a writable view of the bytes, for example through memoryview or numpy.frombuffer
+        return py::buffer_info(a.pointer(), 1, py::format_descriptor<uint8_t>::format(), 1,
+                               {static_cast<py::ssize_t>(a.size())}, {py::ssize_t{1}});
+      })
       .def(py::init<>())
       .def(py::init<const char *>())
       .def(py::init<const std::string &>())
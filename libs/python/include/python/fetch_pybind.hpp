@@ -53,3 +53,15 @@
 #if defined(__GNUC__)
 #pragma GCC diagnostic pop
 #endif
+
+namespace fetch {
+namespace python {
+
+/**
+ * Call guard which releases the GIL for the duration of a bound call, so that other Python threads
+ * run in the meantime. Only for calls which touch no Python objects.
+ */
+using ReleaseGil = pybind11::call_guard<pybind11::gil_scoped_release>;
+
+}  // namespace python
+}  // namespace fetch
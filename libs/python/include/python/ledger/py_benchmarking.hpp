@@ -46,7 +46,7 @@ struct AdaptedTx
   }
 };
 
-pybind11::bytes CreateWealthTransactionsBasic(std::size_t num_transactions)
+byte_array::ConstByteArray CreateWealthTransactionsBasic(std::size_t num_transactions)
 {
   // generate a series of keys for all the nodes
   std::vector<crypto::ECDSASigner> signers(num_transactions);
@@ -74,10 +74,10 @@ pybind11::bytes CreateWealthTransactionsBasic(std::size_t num_transactions)
   serializers::ByteArrayBuffer buffer;
   buffer.Append(transactions);
 
-  return {buffer.data().char_pointer(), buffer.data().size()};
+  return buffer.data();
 }
 
-pybind11::bytes CreateWealthTransactionsThreaded(std::size_t num_transactions)
+byte_array::ConstByteArray CreateWealthTransactionsThreaded(std::size_t num_transactions)
 {
   using crypto::ECDSASigner;
   using SignerPtr = std::unique_ptr<ECDSASigner>;
@@ -128,19 +128,28 @@ pybind11::bytes CreateWealthTransactionsThreaded(std::size_t num_transactions)
   serializers::ByteArrayBuffer buffer;
   buffer.Append(transactions);
 
-  return {buffer.data().char_pointer(), buffer.data().size()};
+  return buffer.data();
 }
 
 pybind11::bytes CreateWealthTransactions(std::size_t num_transactions)
 {
-  if (num_transactions > 1000)
-  {
-    return CreateWealthTransactionsThreaded(num_transactions);
-  }
-  else
+  byte_array::ConstByteArray transactions;
+
   {
-    return CreateWealthTransactionsBasic(num_transactions);
+    // signing is slow, let the other Python threads (for example those submitting) run meanwhile
+    pybind11::gil_scoped_release release;
+
+    if (num_transactions > 1000)
+    {
+      transactions = CreateWealthTransactionsThreaded(num_transactions);
+    }
+    else
+    {
+      transactions = CreateWealthTransactionsBasic(num_transactions);
+    }
   }
+
+  return {transactions.char_pointer(), transactions.size()};
 }
 
 void BuildBenchmarking(pybind11::module &module)
@@ -47,8 +47,8 @@ inline void BuildKMeansClustering(std::string const &custom_name, pybind11::modu
   using namespace fetch::memory;
 
   namespace py = pybind11;
-  module.def(custom_name.c_str(), &WrapperKMeans<Tensor<double>>)
-      .def(custom_name.c_str(), &WrapperKMeans<Tensor<float>>);
+  module.def(custom_name.c_str(), &WrapperKMeans<Tensor<double>>, fetch::python::ReleaseGil())
+      .def(custom_name.c_str(), &WrapperKMeans<Tensor<float>>, fetch::python::ReleaseGil());
 }
 
 }  // namespace clustering
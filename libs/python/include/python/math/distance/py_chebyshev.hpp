@@ -42,8 +42,8 @@ inline void BuildChebyshevDistance(std::string const &custom_name, pybind11::mod
   using namespace fetch::memory;
 
   namespace py = pybind11;
-  module.def(custom_name.c_str(), &WrapperChebyshev<Tensor<double>>)
-      .def(custom_name.c_str(), &WrapperChebyshev<Tensor<float>>);
+  module.def(custom_name.c_str(), &WrapperChebyshev<Tensor<double>>, fetch::python::ReleaseGil())
+      .def(custom_name.c_str(), &WrapperChebyshev<Tensor<float>>, fetch::python::ReleaseGil());
 }
 
 }  // namespace distance
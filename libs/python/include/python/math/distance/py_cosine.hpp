@@ -42,8 +42,8 @@ inline void BuildEisenDistance(std::string const &custom_name, pybind11::module
   using namespace fetch::memory;
 
   namespace py = pybind11;
-  module.def(custom_name.c_str(), &WrapperEisen<Tensor<double>>)
-      .def(custom_name.c_str(), &WrapperEisen<Tensor<float>>);
+  module.def(custom_name.c_str(), &WrapperEisen<Tensor<double>>, fetch::python::ReleaseGil())
+      .def(custom_name.c_str(), &WrapperEisen<Tensor<float>>, fetch::python::ReleaseGil());
 }
 
 }  // namespace distance
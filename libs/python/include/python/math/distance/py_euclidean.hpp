@@ -42,8 +42,8 @@ inline void BuildEuclideanDistance(std::string const &custom_name, pybind11::mod
   using namespace fetch::memory;
 
   namespace py = pybind11;
-  module.def(custom_name.c_str(), &WrapperEuclidean<Tensor<double>>)
-      .def(custom_name.c_str(), &WrapperEuclidean<Tensor<float>>);
+  module.def(custom_name.c_str(), &WrapperEuclidean<Tensor<double>>, fetch::python::ReleaseGil())
+      .def(custom_name.c_str(), &WrapperEuclidean<Tensor<float>>, fetch::python::ReleaseGil());
 }
 
 }  // namespace distance
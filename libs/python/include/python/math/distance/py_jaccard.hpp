@@ -42,8 +42,8 @@ inline void BuildJaccardDistance(std::string const &custom_name, pybind11::modul
   using namespace fetch::memory;
 
   namespace py = pybind11;
-  module.def(custom_name.c_str(), &WrapperJaccard<Tensor<double>>)
-      .def(custom_name.c_str(), &WrapperJaccard<Tensor<float>>);
+  module.def(custom_name.c_str(), &WrapperJaccard<Tensor<double>>, fetch::python::ReleaseGil())
+      .def(custom_name.c_str(), &WrapperJaccard<Tensor<float>>, fetch::python::ReleaseGil());
 }
 
 template <typename A>
@@ -64,8 +64,10 @@ inline void BuildGeneralisedJaccardDistance(std::string const &custom_name,
   using namespace fetch::memory;
 
   namespace py = pybind11;
-  module.def(custom_name.c_str(), &WrapperGeneralisedJaccard<Tensor<double>>)
-      .def(custom_name.c_str(), &WrapperGeneralisedJaccard<Tensor<float>>);
+  module.def(custom_name.c_str(), &WrapperGeneralisedJaccard<Tensor<double>>,
+             fetch::python::ReleaseGil())
+      .def(custom_name.c_str(), &WrapperGeneralisedJaccard<Tensor<float>>,
+           fetch::python::ReleaseGil());
 }
 
 }  // namespace distance
@@ -42,8 +42,8 @@ inline void BuildManhattanDistance(std::string const &custom_name, pybind11::mod
   using namespace fetch::memory;
 
   namespace py = pybind11;
-  module.def(custom_name.c_str(), &WrapperManhattan<Tensor<double>>)
-      .def(custom_name.c_str(), &WrapperManhattan<Tensor<float>>);
+  module.def(custom_name.c_str(), &WrapperManhattan<Tensor<double>>, fetch::python::ReleaseGil())
+      .def(custom_name.c_str(), &WrapperManhattan<Tensor<float>>, fetch::python::ReleaseGil());
 }
 
 }  // namespace distance
@@ -42,8 +42,8 @@ inline void BuildPearsonDistance(std::string const &custom_name, pybind11::modul
   using namespace fetch::memory;
 
   namespace py = pybind11;
-  module.def(custom_name.c_str(), &WrapperPearson<Tensor<double>>)
-      .def(custom_name.c_str(), &WrapperPearson<Tensor<float>>);
+  module.def(custom_name.c_str(), &WrapperPearson<Tensor<double>>, fetch::python::ReleaseGil())
+      .def(custom_name.c_str(), &WrapperPearson<Tensor<float>>, fetch::python::ReleaseGil());
 }
 
 }  // namespace distance
@@ -37,8 +37,8 @@ inline void BuildExpStatistics(std::string const &custom_name, pybind11::module
   using namespace fetch::memory;
 
   namespace py = pybind11;
-  module.def(custom_name.c_str(), &WrapperExp<Tensor<double>>)
-      .def(custom_name.c_str(), &WrapperExp<Tensor<float>>);
+  module.def(custom_name.c_str(), &WrapperExp<Tensor<double>>, fetch::python::ReleaseGil())
+      .def(custom_name.c_str(), &WrapperExp<Tensor<float>>, fetch::python::ReleaseGil());
 }
 }  // namespace math
 }  // namespace fetch
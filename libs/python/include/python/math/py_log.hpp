@@ -37,8 +37,8 @@ inline void BuildLogStatistics(std::string const &custom_name, pybind11::module
   using namespace fetch::memory;
 
   namespace py = pybind11;
-  module.def(custom_name.c_str(), &WrapperLog<Tensor<double>>)
-      .def(custom_name.c_str(), &WrapperLog<Tensor<float>>);
+  module.def(custom_name.c_str(), &WrapperLog<Tensor<double>>, fetch::python::ReleaseGil())
+      .def(custom_name.c_str(), &WrapperLog<Tensor<float>>, fetch::python::ReleaseGil());
 }
 
 }  // namespace math
@@ -19,19 +19,95 @@
 
 #include "math/tensor.hpp"
 #include "python/fetch_pybind.hpp"
+#include "python/memory/py_shared_array.hpp"
+
+#include <string>
+#include <type_traits>
+#include <vector>
 
 namespace py = pybind11;
 
 namespace fetch {
 namespace math {
 
+/**
+ * The shape and strides, in bytes, of the column major storage of a tensor
+ */
+template <typename T>
+void TensorLayout(Tensor<T> const &tensor, std::vector<py::ssize_t> &shape,
+                  std::vector<py::ssize_t> &strides)
+{
+  auto stride = static_cast<py::ssize_t>(sizeof(T));
+  for (auto const &dimension : tensor.shape())
+  {
+    shape.push_back(static_cast<py::ssize_t>(dimension));
+    strides.push_back(stride);
+    stride *= static_cast<py::ssize_t>(dimension);
+  }
+}
+
+/**
+ * Describe the memory of a tensor to the buffer protocol, so that NumPy can view it
+ */
+template <typename T>
+py::buffer_info TensorBuffer(Tensor<T> &tensor)
+{
+  std::vector<py::ssize_t> shape;
+  std::vector<py::ssize_t> strides;
+  TensorLayout(tensor, shape, strides);
+
+  return py::buffer_info(tensor.data().pointer(), sizeof(T), py::format_descriptor<T>::format(),
+                         static_cast<py::ssize_t>(shape.size()), shape, strides);
+}
+
+/**
+ * Views from and to NumPy, which share the memory of the arrays rather than copy it. Only for the
+ * types which NumPy has.
+ */
+template <typename T, typename Class>
+typename std::enable_if<std::is_arithmetic<T>::value>::type BuildTensorNumpy(Class &tensor_class)
+{
+  using ArrayType  = Tensor<T>;
+  using NumpyArray = py::array_t<T, py::array::f_style | py::array::forcecast>;
+
+  tensor_class
+      .def(py::init([](NumpyArray const &array) {
+        SizeVector shape;
+        for (py::ssize_t i = 0; i < array.ndim(); ++i)
+        {
+          shape.push_back(static_cast<SizeType>(array.shape(i)));
+        }
+
+        return ArrayType(memory::SharedArrayFromNumpy<T>(array), shape);
+      }))
+      .def_buffer(&TensorBuffer<T>)
+      .def("ToNumpy", [](py::object const &self) {
+        auto &tensor = self.cast<ArrayType &>();
+
+        std::vector<py::ssize_t> shape;
+        std::vector<py::ssize_t> strides;
+        TensorLayout(tensor, shape, strides);
+
+        return py::array_t<T>(shape, strides, tensor.data().pointer(), self);
+      });
+}
+
+template <typename T, typename Class>
+typename std::enable_if<!std::is_arithmetic<T>::value>::type BuildTensorNumpy(Class & /*class*/)
+{}
+
 template <typename T>
 void BuildTensor(std::string const &custom_name, pybind11::module &module)
 {
   using ArrayType = typename fetch::math::Tensor<T>;
 
-  py::class_<ArrayType, std::shared_ptr<ArrayType>>(module, custom_name.c_str())
-      .def(py::init<std::vector<SizeType> const &>())
+  py::class_<ArrayType, std::shared_ptr<ArrayType>> tensor_class(module, custom_name.c_str(),
+                                                                 py::buffer_protocol());
+
+  // before the shape constructor, which would take an integer array for a shape
+  BuildTensorNumpy<T>(tensor_class);
+
+  tensor_class.def(py::init<std::vector<SizeType> const &>())
       .def("ToString", &ArrayType::ToString)
       .def("Size", &ArrayType::size)
       .def("Fill", [](ArrayType &a, T val) { return a.Fill(val); })
@@ -37,8 +37,9 @@ inline void BuildGeometricMeanStatistics(std::string const &custom_name, pybind1
   using namespace fetch::memory;
 
   namespace py = pybind11;
-  module.def(custom_name.c_str(), &WrapperGeometricMean<Tensor<double>>)
-      .def(custom_name.c_str(), &WrapperGeometricMean<Tensor<float>>);
+  module.def(custom_name.c_str(), &WrapperGeometricMean<Tensor<double>>,
+             fetch::python::ReleaseGil())
+      .def(custom_name.c_str(), &WrapperGeometricMean<Tensor<float>>, fetch::python::ReleaseGil());
 }
 
 }  // namespace statistics
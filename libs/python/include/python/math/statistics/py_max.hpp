@@ -36,8 +36,8 @@ inline void BuildMaxStatistics(std::string const &custom_name, pybind11::module
   using namespace fetch::memory;
 
   namespace py = pybind11;
-  module.def(custom_name.c_str(), &WrapperMax<Tensor<double>>)
-      .def(custom_name.c_str(), &WrapperMax<Tensor<float>>);
+  module.def(custom_name.c_str(), &WrapperMax<Tensor<double>>, fetch::python::ReleaseGil())
+      .def(custom_name.c_str(), &WrapperMax<Tensor<float>>, fetch::python::ReleaseGil());
 }
 
 }  // namespace math
@@ -37,8 +37,10 @@ inline void BuildStandardDeviationStatistics(std::string const &custom_name,
   using namespace fetch::memory;
 
   namespace py = pybind11;
-  module.def(custom_name.c_str(), &WrapperStandardDeviation<Tensor<double>>)
-      .def(custom_name.c_str(), &WrapperStandardDeviation<Tensor<float>>);
+  module.def(custom_name.c_str(), &WrapperStandardDeviation<Tensor<double>>,
+             fetch::python::ReleaseGil())
+      .def(custom_name.c_str(), &WrapperStandardDeviation<Tensor<float>>,
+           fetch::python::ReleaseGil());
 }
 
 }  // namespace statistics
@@ -37,8 +37,8 @@ inline void BuildVarianceStatistics(std::string const &custom_name, pybind11::mo
   using namespace fetch::memory;
 
   namespace py = pybind11;
-  module.def(custom_name.c_str(), &WrapperVariance<Tensor<double>>)
-      .def(custom_name.c_str(), &WrapperVariance<Tensor<float>>);
+  module.def(custom_name.c_str(), &WrapperVariance<Tensor<double>>, fetch::python::ReleaseGil())
+      .def(custom_name.c_str(), &WrapperVariance<Tensor<float>>, fetch::python::ReleaseGil());
 }
 
 }  // namespace statistics
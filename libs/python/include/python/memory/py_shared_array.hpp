@@ -20,18 +20,85 @@
 #include "python/fetch_pybind.hpp"
 #include "vectorise/memory/shared_array.hpp"
 
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
 namespace fetch {
 namespace memory {
 
+/**
+ * Wrap the memory of a NumPy array without copying it. The vectorised operations load and store
+ * whole registers, so the memory is only wrapped when it is aligned for them and spans a whole
+ * number of registers, otherwise the values are copied once.
+ *
+ * @param array The contiguous array, which is kept alive for as long as its memory is wrapped
+ * @return The shared array over the memory of the NumPy array
+ */
+template <typename T, int Flags>
+SharedArray<T> SharedArrayFromNumpy(pybind11::array_t<T, Flags> const &array)
+{
+  namespace py = pybind11;
+  using ArrayType = SharedArray<T>;
+
+  auto const  n       = static_cast<std::size_t>(array.size());
+  auto *const data    = const_cast<T *>(array.data());
+  bool const  aligned = (reinterpret_cast<std::uintptr_t>(data) % ArrayType::E_SIMD_ALIGNMENT) == 0;
+  bool const  whole   = (n % ArrayType::E_SIMD_COUNT) == 0;
+
+  if ((n == 0) || !aligned || !whole || !array.writeable())
+  {
+    ArrayType copy(n);
+    if (n > 0)
+    {
+      std::memcpy(copy.pointer(), data, n * sizeof(T));
+    }
+    return copy;
+  }
+
+  // the reference to the NumPy array can be dropped from any thread, so the GIL is taken first
+  auto *owner = new py::object(array);
+  std::shared_ptr<T> memory(data, [owner](T *) {
+    py::gil_scoped_acquire gil;
+    delete owner;
+  });
+
+  return ArrayType(std::move(memory), n);
+}
+
+/**
+ * Describe the memory of a shared array to the buffer protocol, so that NumPy can view it
+ */
+template <typename T>
+pybind11::buffer_info SharedArrayBuffer(SharedArray<T> &array)
+{
+  namespace py = pybind11;
+
+  return py::buffer_info(array.pointer(), sizeof(T), py::format_descriptor<T>::format(), 1,
+                         {static_cast<py::ssize_t>(array.size())},
+                         {static_cast<py::ssize_t>(sizeof(T))});
+}
+
 template <typename T>
 void BuildSharedArray(std::string const &custom_name, pybind11::module &module)
 {
 
   namespace py = pybind11;
-  py::class_<SharedArray<T>>(module, custom_name.c_str())
+  using NumpyArray = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+  py::class_<SharedArray<T>>(module, custom_name.c_str(), py::buffer_protocol())
       .def(py::init<const std::size_t &>())
       .def(py::init<>())
       .def(py::init<const SharedArray<T> &>())
+      .def(py::init([](NumpyArray const &array) { return SharedArrayFromNumpy<T>(array); }))
+      .def_buffer(&SharedArrayBuffer<T>)
+      .def("ToNumpy",
+           [](py::object const &self) {
+             auto &array = self.cast<SharedArray<T> &>();
+             return py::array_t<T>({static_cast<py::ssize_t>(array.size())},
+                                   {static_cast<py::ssize_t>(sizeof(T))}, array.pointer(), self);
+           })
       //    .def(py::init< SharedArray<T> && >())
       .def("simd_size", &SharedArray<T>::simd_size)
       //    .def("begin", &SharedArray< T >::begin)
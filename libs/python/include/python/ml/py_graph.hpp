@@ -36,13 +36,15 @@ void BuildGraph(std::string const &custom_name, pybind11::module &module)
   py::class_<fetch::ml::Graph<ArrayType>>(module, custom_name.c_str())
       .def(py::init<>())
       .def("SetInput", &fetch::ml::Graph<ArrayType>::SetInput)
-      .def("Evaluate", &fetch::ml::Graph<ArrayType>::Evaluate)
-      .def("Backpropagate", &fetch::ml::Graph<ArrayType>::BackPropagate)
-      .def("Step", &fetch::ml::Graph<ArrayType>::Step)
+      .def("Evaluate", &fetch::ml::Graph<ArrayType>::Evaluate, fetch::python::ReleaseGil())
+      .def("Backpropagate", &fetch::ml::Graph<ArrayType>::BackPropagate,
+           fetch::python::ReleaseGil())
+      .def("Step", &fetch::ml::Graph<ArrayType>::Step, fetch::python::ReleaseGil())
       .def("StateDict", &fetch::ml::Graph<ArrayType>::StateDict)
       .def("LoadStateDict", &fetch::ml::Graph<ArrayType>::LoadStateDict)
       .def("Step",  // Convenience method to allow step without explicitly defining a FixedPoint
-           [](fetch::ml::Graph<ArrayType> &g, float lr) { g.Step(T(lr)); })
+           [](fetch::ml::Graph<ArrayType> &g, float lr) { g.Step(T(lr)); },
+           fetch::python::ReleaseGil())
       .def("AddInput",
            [](fetch::ml::Graph<ArrayType> &g, std::string const &name) {
              g.template AddNode<fetch::ml::ops::PlaceHolder<ArrayType>>(name, {});
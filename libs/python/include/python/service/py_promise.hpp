@@ -17,46 +17,89 @@
 //
 //------------------------------------------------------------------------------
 
-#include "service/promise.hpp"
+#include "core/byte_array/const_byte_array.hpp"
+#include "network/service/promise.hpp"
+#include "python/fetch_pybind.hpp"
 
-#include "fetch_pybind.hpp"
+#include <cstdint>
+#include <memory>
 
 namespace fetch {
 namespace service {
-namespace details {
 
-void BuildPromiseImplementation(pybind11::module &module)
+/**
+ * The Python objects of an asyncio future waiting on a promise
+ */
+struct PromiseFuture
+{
+  pybind11::object loop;
+  pybind11::object future;
+};
+
+/**
+ * Get an asyncio future which completes with the serialised value of the promise, or fails with a
+ * RuntimeError. The promise resolves on a network thread, which hands the result over to the event
+ * loop, so awaiting the future neither blocks the loop nor holds the GIL.
+ *
+ * @param promise The promise to wait on
+ * @param loop The event loop of the future
+ * @return The future
+ */
+inline pybind11::object PromiseAsFuture(Promise const &promise, pybind11::object const &loop)
 {
   namespace py = pybind11;
-  py::class_<PromiseImplementation>(module, "PromiseImplementation")
-      .def(py::init<>())
-      .def("exception", &PromiseImplementation::exception)
-      .def("has_failed", &PromiseImplementation::has_failed)
-      .def("is_connection_closed", &PromiseImplementation::is_connection_closed)
-      .def("value", &PromiseImplementation::value)
-      .def("Fail", &PromiseImplementation::Fail)
-      .def("Fulfill", &PromiseImplementation::Fulfill)
-      .def("is_fulfilled", &PromiseImplementation::is_fulfilled)
-      .def("id", &PromiseImplementation::id)
-      .def("ConnectionFailed", &PromiseImplementation::ConnectionFailed);
+
+  // the last reference may be dropped by a network thread, so the GIL is taken first
+  std::shared_ptr<PromiseFuture> const state(
+      new PromiseFuture{loop, loop.attr("create_future")()}, [](PromiseFuture *future) {
+        py::gil_scoped_acquire gil;
+        delete future;
+      });
+
+  // the callbacks are owned by the promise, which is alive for as long as they can be called
+  details::PromiseImplementation const *const implementation = promise.get();
+
+  promise->WithHandlers().Finally([state, implementation]() {
+    py::gil_scoped_acquire gil;
+
+    py::object const call_soon = state->loop.attr("call_soon_threadsafe");
+    if (implementation->IsSuccessful())
+    {
+      auto const &value = implementation->value();
+      call_soon(state->future.attr("set_result"), py::bytes(value.char_pointer(), value.size()));
+    }
+    else
+    {
+      py::object const error = py::module::import("builtins").attr("RuntimeError");
+      call_soon(state->future.attr("set_exception"), error("promise failed"));
+    }
+  });
+
+  return state->future;
 }
-};  // namespace details
-};  // namespace service
-};  // namespace fetch
-namespace fetch {
-namespace service {
 
-void BuildPromise(pybind11::module &module)
+inline void BuildPromise(pybind11::module &module)
 {
   namespace py = pybind11;
-  py::class_<Promise>(module, "Promise")
-      .def(py::init<>())
-      .def("has_failed", &Promise::has_failed)
-      .def("reference", &Promise::reference)
-      .def("is_connection_closed", &Promise::is_connection_closed)
-      .def("is_fulfilled", &Promise::is_fulfilled)
-      .def("id", &Promise::id)
-      .def("Wait", &Promise::Wait);
+  using Implementation = details::PromiseImplementation;
+
+  py::class_<Implementation, Promise>(module, "Promise")
+      .def("id", &Implementation::id)
+      .def("IsWaiting", &Implementation::IsWaiting)
+      .def("IsSuccessful", &Implementation::IsSuccessful)
+      .def("IsFailed", &Implementation::IsFailed)
+      .def("Wait",
+           [](Implementation const &promise, uint32_t timeout_ms) {
+             return promise.Wait(timeout_ms, false);
+           },
+           py::arg("timeout_ms") = uint32_t{Implementation::FOREVER}, fetch::python::ReleaseGil())
+      .def("value",
+           [](Implementation const &promise) {
+             auto const &value = promise.value();
+             return py::bytes(value.char_pointer(), value.size());
+           })
+      .def("AsFuture", &PromiseAsFuture, py::arg("loop"));
 }
-};  // namespace service
-};  // namespace fetch
+
+}  // namespace service
+}  // namespace fetch
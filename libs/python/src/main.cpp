@@ -72,6 +72,8 @@
 
 #include "python/serializers/py_byte_array_buffer.hpp"
 
+#include "python/service/py_promise.hpp"
+
 // !!!!
 namespace py = pybind11;
 
@@ -100,6 +102,7 @@ PYBIND11_MODULE(fetch, module)
   py::module ns_fetch_math_linalg      = ns_fetch_math.def_submodule("linalg");
   py::module ns_fetch_auctions         = module.def_submodule("auctions");
   py::module ns_fetch_serializer       = module.def_submodule("serializers");
+  py::module ns_fetch_service          = module.def_submodule("service");
 
   fetch::math::BuildTensor<float>("TensorFloat", ns_fetch_math_tensor);
   fetch::math::BuildTensor<double>("TensorDouble", ns_fetch_math_tensor);
@@ -174,4 +177,6 @@ PYBIND11_MODULE(fetch, module)
   fetch::auctions::BuildMockSmartLedger("MockSmartLedger", ns_fetch_auctions);
 
   fetch::serializers::BuildByteArrayBuffer(ns_fetch_serializer);
+
+  fetch::service::BuildPromise(ns_fetch_service);
 }
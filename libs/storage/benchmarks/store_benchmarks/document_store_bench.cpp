@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "key_distribution.hpp"
+#include "storage/document_store.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using fetch::byte_array::ConstByteArray;
+using fetch::storage::CompressionOptions;
+using fetch::storage::ResourceAddress;
+
+using namespace fetch::storage::benchmark_utils;
+
+namespace {
+
+constexpr std::size_t KEY_COUNT      = 5000;
+constexpr std::size_t PATTERN_LENGTH = 100000;
+constexpr std::size_t VALUE_VARIANTS = 16;
+
+using Store = fetch::storage::DocumentStore<>;
+
+/**
+ * Arguments: key distribution, document size in bytes
+ */
+void DistributionsAndSizes(::benchmark::internal::Benchmark *benchmark)
+{
+  for (auto distribution :
+       {KeyDistribution::UNIFORM, KeyDistribution::ZIPFIAN, KeyDistribution::SEQUENTIAL})
+  {
+    for (int64_t size : {64, 2048, 16384})
+    {
+      benchmark->Args({static_cast<int64_t>(distribution), size});
+    }
+  }
+}
+
+std::vector<ConstByteArray> GenerateValues(std::size_t size)
+{
+  std::vector<ConstByteArray> values;
+  for (std::size_t i = 0; i < VALUE_VARIANTS; ++i)
+  {
+    values.push_back(GenerateValue(size, i));
+  }
+
+  return values;
+}
+
+void Populate(Store &store, std::vector<ResourceAddress> const &keys,
+              std::vector<ConstByteArray> const &values)
+{
+  store.New("doc_bench.db", "doc_bench.diff.db", "doc_bench.index.db", "doc_bench.index.diff.db");
+
+  for (std::size_t i = 0; i < keys.size(); ++i)
+  {
+    store.Set(keys[i], values[i % values.size()]);
+  }
+
+  store.Flush(false);
+}
+
+void DocumentStoreGet(benchmark::State &state)
+{
+  auto const distribution = Distribution(state);
+  auto const size         = static_cast<std::size_t>(state.range(1));
+  auto const keys         = GenerateKeys(KEY_COUNT);
+  auto const values       = GenerateValues(size);
+  auto const pattern      = GenerateAccessPattern(distribution, KEY_COUNT, PATTERN_LENGTH);
+
+  Store store;
+  Populate(store, keys, values);
+
+  std::size_t position = 0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(store.Get(keys[pattern[position]]));
+
+    position = (position + 1) % pattern.size();
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+
+void DocumentStoreSet(benchmark::State &state)
+{
+  auto const distribution = Distribution(state);
+  auto const size         = static_cast<std::size_t>(state.range(1));
+  auto const keys         = GenerateKeys(KEY_COUNT);
+  auto const values       = GenerateValues(size);
+  auto const pattern      = GenerateAccessPattern(distribution, KEY_COUNT, PATTERN_LENGTH);
+
+  Store store;
+  Populate(store, keys, values);
+
+  std::size_t position = 0;
+  for (auto _ : state)
+  {
+    store.Set(keys[pattern[position]], values[position % values.size()]);
+
+    position = (position + 1) % pattern.size();
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+
+/**
+ * Reads of documents written with compression enabled, the values are generated from a small set
+ * of variants so they share content with each other like contract state does
+ */
+void DocumentStoreCompressedGet(benchmark::State &state)
+{
+  auto const distribution = Distribution(state);
+  auto const size         = static_cast<std::size_t>(state.range(1));
+  auto const keys         = GenerateKeys(KEY_COUNT);
+  auto const values       = GenerateValues(size);
+  auto const pattern      = GenerateAccessPattern(distribution, KEY_COUNT, PATTERN_LENGTH);
+
+  Store store;
+  Populate(store, keys, values);
+
+  CompressionOptions options;
+  options.enabled = true;
+
+  store.TrainCompressionDictionary();
+  store.SetCompression(options);
+  for (std::size_t i = 0; i < keys.size(); ++i)
+  {
+    store.Set(keys[i], values[i % values.size()]);
+  }
+
+  std::size_t position = 0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(store.Get(keys[pattern[position]]));
+
+    position = (position + 1) % pattern.size();
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+
+}  // namespace
+
+BENCHMARK(DocumentStoreGet)->Apply(DistributionsAndSizes);
+BENCHMARK(DocumentStoreSet)->Apply(DistributionsAndSizes);
+BENCHMARK(DocumentStoreCompressedGet)->Apply(DistributionsAndSizes);
@@ -0,0 +1,226 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "storage/resource_mapper.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fetch {
+namespace storage {
+namespace benchmark_utils {
+
+/**
+ * The order in which keys are accessed by a benchmark
+ */
+enum class KeyDistribution : int64_t
+{
+  UNIFORM,    ///< All keys equally likely
+  ZIPFIAN,    ///< Skewed towards a small set of hot keys, as seen with popular contracts
+  SEQUENTIAL  ///< Keys in insertion order, for example bulk loads and iteration
+};
+
+inline char const *ToString(KeyDistribution distribution)
+{
+  switch (distribution)
+  {
+  case KeyDistribution::UNIFORM:
+    return "uniform";
+  case KeyDistribution::ZIPFIAN:
+    return "zipfian";
+  case KeyDistribution::SEQUENTIAL:
+    return "sequential";
+  }
+
+  return "unknown";
+}
+
+/**
+ * Zipfian distribution over [0, n) using the method of Gray et al. "Quickly Generating
+ * Billion-Record Synthetic Databases", as used by YCSB
+ */
+class ZipfianDistribution
+{
+public:
+  explicit ZipfianDistribution(uint64_t n, double theta = 0.99)
+    : n_{n}
+    , theta_{theta}
+  {
+    for (uint64_t i = 1; i <= n_; ++i)
+    {
+      zeta_n_ += 1.0 / std::pow(static_cast<double>(i), theta_);
+    }
+
+    double const zeta_2 = 1.0 + std::pow(0.5, theta_);
+
+    alpha_ = 1.0 / (1.0 - theta_);
+    eta_   = (1.0 - std::pow(2.0 / static_cast<double>(n_), 1.0 - theta_)) /
+           (1.0 - (zeta_2 / zeta_n_));
+  }
+
+  template <typename RNG>
+  uint64_t operator()(RNG &rng)
+  {
+    double const u  = std::uniform_real_distribution<double>{0.0, 1.0}(rng);
+    double const uz = u * zeta_n_;
+
+    if (uz < 1.0)
+    {
+      return 0;
+    }
+
+    if (uz < (1.0 + std::pow(0.5, theta_)))
+    {
+      return 1;
+    }
+
+    auto const value = static_cast<uint64_t>(static_cast<double>(n_) *
+                                             std::pow((eta_ * u) - eta_ + 1.0, alpha_));
+
+    return std::min(value, n_ - 1);
+  }
+
+private:
+  uint64_t n_;
+  double   theta_;
+  double   zeta_n_ = 0.0;
+  double   alpha_  = 0.0;
+  double   eta_    = 0.0;
+};
+
+/**
+ * Generate the indices of the keys accessed by a benchmark
+ *
+ * @param distribution The access distribution
+ * @param key_count The number of distinct keys
+ * @param length The number of accesses
+ * @return The sequence of key indices
+ */
+inline std::vector<uint64_t> GenerateAccessPattern(KeyDistribution distribution,
+                                                   uint64_t key_count, std::size_t length)
+{
+  std::mt19937_64       rng{42};
+  std::vector<uint64_t> pattern;
+  pattern.reserve(length);
+
+  switch (distribution)
+  {
+  case KeyDistribution::UNIFORM:
+  {
+    std::uniform_int_distribution<uint64_t> uniform{0, key_count - 1};
+    for (std::size_t i = 0; i < length; ++i)
+    {
+      pattern.push_back(uniform(rng));
+    }
+    break;
+  }
+  case KeyDistribution::ZIPFIAN:
+  {
+    ZipfianDistribution zipfian{key_count};
+
+    // scatter the hot keys rather than clustering them at the start of the key set
+    std::vector<uint64_t> permutation(key_count);
+    for (uint64_t i = 0; i < key_count; ++i)
+    {
+      permutation[i] = i;
+    }
+    std::shuffle(permutation.begin(), permutation.end(), rng);
+
+    for (std::size_t i = 0; i < length; ++i)
+    {
+      pattern.push_back(permutation[zipfian(rng)]);
+    }
+    break;
+  }
+  case KeyDistribution::SEQUENTIAL:
+    for (std::size_t i = 0; i < length; ++i)
+    {
+      pattern.push_back(i % key_count);
+    }
+    break;
+  }
+
+  return pattern;
+}
+
+/**
+ * Generate a set of distinct resource addresses
+ */
+inline std::vector<ResourceAddress> GenerateKeys(std::size_t count)
+{
+  std::vector<ResourceAddress> keys;
+  keys.reserve(count);
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    keys.emplace_back(byte_array::ConstByteArray{"benchmark.state." + std::to_string(i)});
+  }
+
+  return keys;
+}
+
+/**
+ * Generate a document value of the specified size
+ */
+inline byte_array::ConstByteArray GenerateValue(std::size_t size, uint64_t seed)
+{
+  std::mt19937_64       rng{seed};
+  byte_array::ByteArray value;
+  value.Resize(size);
+
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    value[i] = static_cast<uint8_t>(rng());
+  }
+
+  return {value};
+}
+
+/**
+ * Register a benchmark once for each of the key distributions, use with Apply
+ */
+inline void AllDistributions(::benchmark::internal::Benchmark *benchmark)
+{
+  for (auto distribution :
+       {KeyDistribution::UNIFORM, KeyDistribution::ZIPFIAN, KeyDistribution::SEQUENTIAL})
+  {
+    benchmark->Arg(static_cast<int64_t>(distribution));
+  }
+}
+
+/**
+ * Extract the key distribution from the benchmark arguments and label the run with it
+ */
+inline KeyDistribution Distribution(::benchmark::State &state)
+{
+  auto const distribution = static_cast<KeyDistribution>(state.range(0));
+  state.SetLabel(ToString(distribution));
+  return distribution;
+}
+
+}  // namespace benchmark_utils
+}  // namespace storage
+}  // namespace fetch
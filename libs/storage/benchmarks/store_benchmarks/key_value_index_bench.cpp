@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "key_distribution.hpp"
+#include "storage/cached_random_access_stack.hpp"
+#include "storage/key_value_index.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using fetch::storage::CachedRandomAccessStack;
+using fetch::storage::KeyValueIndex;
+using fetch::storage::KeyValuePair;
+using fetch::storage::RandomAccessStack;
+
+using namespace fetch::storage::benchmark_utils;
+
+namespace {
+
+constexpr std::size_t KEY_COUNT      = 10000;
+constexpr std::size_t PATTERN_LENGTH = 100000;
+
+using CachedKeyIndex = KeyValueIndex<KeyValuePair<>, CachedRandomAccessStack<KeyValuePair<>>>;
+using DirectKeyIndex = KeyValueIndex<KeyValuePair<>, RandomAccessStack<KeyValuePair<>>>;
+
+template <typename I>
+void Populate(I &index, std::vector<fetch::storage::ResourceAddress> const &keys)
+{
+  index.New("kvi_bench.db");
+
+  for (uint64_t i = 0; i < keys.size(); ++i)
+  {
+    index.Set(keys[i].id(), i, keys[i].id());
+  }
+
+  index.Flush(false);
+}
+
+template <typename I>
+void KeyValueIndexGet(benchmark::State &state)
+{
+  auto const distribution = Distribution(state);
+  auto const keys         = GenerateKeys(KEY_COUNT);
+  auto const pattern      = GenerateAccessPattern(distribution, KEY_COUNT, PATTERN_LENGTH);
+
+  I index;
+  Populate(index, keys);
+
+  std::size_t position = 0;
+  uint64_t    value    = 0;
+  for (auto _ : state)
+  {
+    index.GetIfExists(keys[pattern[position]].id(), value);
+    benchmark::DoNotOptimize(value);
+
+    position = (position + 1) % pattern.size();
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+template <typename I>
+void KeyValueIndexSet(benchmark::State &state)
+{
+  auto const distribution = Distribution(state);
+  auto const keys         = GenerateKeys(KEY_COUNT);
+  auto const pattern      = GenerateAccessPattern(distribution, KEY_COUNT, PATTERN_LENGTH);
+
+  I index;
+  Populate(index, keys);
+
+  std::size_t position = 0;
+  uint64_t    value    = 0;
+  for (auto _ : state)
+  {
+    auto const &key = keys[pattern[position]].id();
+    index.Set(key, ++value, key);
+
+    position = (position + 1) % pattern.size();
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+/**
+ * Updates followed by recomputing the root hash, as done once per block
+ */
+void KeyValueIndexUpdateAndHash(benchmark::State &state)
+{
+  auto const distribution = Distribution(state);
+  auto const keys         = GenerateKeys(KEY_COUNT);
+  auto const pattern      = GenerateAccessPattern(distribution, KEY_COUNT, PATTERN_LENGTH);
+
+  CachedKeyIndex index;
+  Populate(index, keys);
+
+  constexpr std::size_t UPDATES_PER_HASH = 100;
+
+  std::size_t position = 0;
+  uint64_t    value    = 0;
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < UPDATES_PER_HASH; ++i)
+    {
+      auto const &key = keys[pattern[position]].id();
+      index.Set(key, ++value, key);
+
+      position = (position + 1) % pattern.size();
+    }
+
+    benchmark::DoNotOptimize(index.Hash());
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * UPDATES_PER_HASH));
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(KeyValueIndexGet, CachedKeyIndex)->Apply(AllDistributions);
+BENCHMARK_TEMPLATE(KeyValueIndexGet, DirectKeyIndex)->Apply(AllDistributions);
+BENCHMARK_TEMPLATE(KeyValueIndexSet, CachedKeyIndex)->Apply(AllDistributions);
+BENCHMARK_TEMPLATE(KeyValueIndexSet, DirectKeyIndex)->Apply(AllDistributions);
+BENCHMARK(KeyValueIndexUpdateAndHash)->Apply(AllDistributions);
+
+// Macro required for all benchmarks
+BENCHMARK_MAIN();
@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "key_distribution.hpp"
+#include "storage/object_store.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using fetch::byte_array::ConstByteArray;
+using fetch::storage::ResourceAddress;
+
+using namespace fetch::storage::benchmark_utils;
+
+namespace {
+
+constexpr std::size_t KEY_COUNT      = 1000;  // population is dominated by the per write index flush
+constexpr std::size_t PATTERN_LENGTH = 100000;
+constexpr std::size_t VALUE_SIZE     = 512;
+
+using Store = fetch::storage::ObjectStore<ConstByteArray>;
+
+void Populate(Store &store, std::vector<ResourceAddress> const &keys)
+{
+  store.New("obj_bench.db", "obj_bench.index.db");
+
+  for (std::size_t i = 0; i < keys.size(); ++i)
+  {
+    store.Set(keys[i], GenerateValue(VALUE_SIZE, i));
+  }
+}
+
+void ObjectStoreGet(benchmark::State &state)
+{
+  auto const distribution = Distribution(state);
+  auto const keys         = GenerateKeys(KEY_COUNT);
+  auto const pattern      = GenerateAccessPattern(distribution, KEY_COUNT, PATTERN_LENGTH);
+
+  Store store;
+  Populate(store, keys);
+
+  std::size_t    position = 0;
+  ConstByteArray object;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(store.Get(keys[pattern[position]], object));
+    position = (position + 1) % pattern.size();
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void ObjectStoreSet(benchmark::State &state)
+{
+  auto const distribution = Distribution(state);
+  auto const keys         = GenerateKeys(KEY_COUNT);
+  auto const pattern      = GenerateAccessPattern(distribution, KEY_COUNT, PATTERN_LENGTH);
+  auto const value        = GenerateValue(VALUE_SIZE, KEY_COUNT);
+
+  Store store;
+  Populate(store, keys);
+
+  std::size_t position = 0;
+  for (auto _ : state)
+  {
+    store.Set(keys[pattern[position]], value);
+    position = (position + 1) % pattern.size();
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void ObjectStoreSnapshotGet(benchmark::State &state)
+{
+  auto const distribution = Distribution(state);
+  auto const keys         = GenerateKeys(KEY_COUNT);
+  auto const pattern      = GenerateAccessPattern(distribution, KEY_COUNT, PATTERN_LENGTH);
+
+  Store store;
+  Populate(store, keys);
+
+  auto const snapshot = store.GetSnapshot();
+
+  std::size_t    position = 0;
+  ConstByteArray object;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(snapshot.Get(keys[pattern[position]], object));
+    position = (position + 1) % pattern.size();
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+}  // namespace
+
+BENCHMARK(ObjectStoreGet)->Apply(AllDistributions);
+BENCHMARK(ObjectStoreSet)->Apply(AllDistributions);
+BENCHMARK(ObjectStoreSnapshotGet)->Apply(AllDistributions);
@@ -0,0 +1,156 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "key_distribution.hpp"
+#include "storage/new_revertible_document_store.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using fetch::byte_array::ConstByteArray;
+using fetch::storage::NewRevertibleDocumentStore;
+using fetch::storage::ResourceAddress;
+
+using namespace fetch::storage::benchmark_utils;
+
+namespace {
+
+constexpr std::size_t KEY_COUNT      = 5000;
+constexpr std::size_t PATTERN_LENGTH = 100000;
+constexpr std::size_t VALUE_SIZE     = 256;
+
+/**
+ * Arguments: key distribution, writes per commit
+ */
+void DistributionsAndBatches(::benchmark::internal::Benchmark *benchmark)
+{
+  for (auto distribution :
+       {KeyDistribution::UNIFORM, KeyDistribution::ZIPFIAN, KeyDistribution::SEQUENTIAL})
+  {
+    for (int64_t writes : {10, 100, 1000})
+    {
+      benchmark->Args({static_cast<int64_t>(distribution), writes});
+    }
+  }
+}
+
+void Populate(NewRevertibleDocumentStore &store, std::vector<ResourceAddress> const &keys)
+{
+  store.New("rds_bench.db", "rds_bench.history.db", "rds_bench.index.db",
+            "rds_bench.index.history.db", true);
+
+  for (std::size_t i = 0; i < keys.size(); ++i)
+  {
+    store.Set(keys[i], GenerateValue(VALUE_SIZE, i));
+  }
+
+  store.Commit();
+}
+
+/**
+ * A block worth of writes followed by a commit
+ */
+void RevertibleDocumentStoreCommit(benchmark::State &state)
+{
+  auto const distribution = Distribution(state);
+  auto const writes       = static_cast<std::size_t>(state.range(1));
+  auto const keys         = GenerateKeys(KEY_COUNT);
+  auto const pattern      = GenerateAccessPattern(distribution, KEY_COUNT, PATTERN_LENGTH);
+  auto const value        = GenerateValue(VALUE_SIZE, KEY_COUNT);
+
+  NewRevertibleDocumentStore store;
+  Populate(store, keys);
+
+  std::size_t position = 0;
+  for (auto _ : state)
+  {
+    for (std::size_t i = 0; i < writes; ++i)
+    {
+      store.Set(keys[pattern[position]], value);
+      position = (position + 1) % pattern.size();
+    }
+
+    benchmark::DoNotOptimize(store.Commit());
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * writes));
+}
+
+/**
+ * Reverting a single block worth of writes, as done on a short fork switch
+ */
+void RevertibleDocumentStoreRevert(benchmark::State &state)
+{
+  auto const distribution = Distribution(state);
+  auto const writes       = static_cast<std::size_t>(state.range(1));
+  auto const keys         = GenerateKeys(KEY_COUNT);
+  auto const pattern      = GenerateAccessPattern(distribution, KEY_COUNT, PATTERN_LENGTH);
+  auto const value        = GenerateValue(VALUE_SIZE, KEY_COUNT);
+
+  NewRevertibleDocumentStore store;
+  Populate(store, keys);
+
+  auto const base = store.CurrentHash();
+
+  std::size_t position = 0;
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    for (std::size_t i = 0; i < writes; ++i)
+    {
+      store.Set(keys[pattern[position]], value);
+      position = (position + 1) % pattern.size();
+    }
+    store.Commit();
+    state.ResumeTiming();
+
+    if (!store.RevertToHash(base))
+    {
+      state.SkipWithError("Unable to revert");
+      break;
+    }
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * writes));
+}
+
+void RevertibleDocumentStoreGet(benchmark::State &state)
+{
+  auto const distribution = Distribution(state);
+  auto const keys         = GenerateKeys(KEY_COUNT);
+  auto const pattern      = GenerateAccessPattern(distribution, KEY_COUNT, PATTERN_LENGTH);
+
+  NewRevertibleDocumentStore store;
+  Populate(store, keys);
+
+  std::size_t position = 0;
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(store.Get(keys[pattern[position]]));
+    position = (position + 1) % pattern.size();
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+}  // namespace
+
+BENCHMARK(RevertibleDocumentStoreCommit)->Apply(DistributionsAndBatches);
+BENCHMARK(RevertibleDocumentStoreRevert)->Apply(DistributionsAndBatches);
+BENCHMARK(RevertibleDocumentStoreGet)->Apply(AllDistributions);
@@ -0,0 +1,84 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace fetch {
+namespace storage {
+
+enum class AsyncIoBackend
+{
+  AUTO,        ///< The best backend available on the running kernel
+  IO_URING,    ///< io_uring submission and completion rings
+  LINUX_AIO,   ///< Linux kernel AIO (io_submit / io_getevents)
+  SYNCHRONOUS  ///< pread for every request, always available
+};
+
+char const *ToString(AsyncIoBackend backend);
+
+bool ReadFully(int fd, void *buffer, std::size_t length, uint64_t offset);
+
+struct ReadRequest
+{
+  uint64_t    offset = 0;        ///< The offset in the file
+  void *      buffer = nullptr;  ///< The destination, must remain valid until the read completes
+  std::size_t length = 0;        ///< The number of bytes to read
+};
+
+/**
+ * Issues batches of reads against a file descriptor, keeping up to queue depth requests in flight
+ * at once so that the device is able to service them in parallel.
+ */
+class AsyncReader
+{
+public:
+  using ReadRequests = std::vector<ReadRequest>;
+  using Completion   = std::function<void(std::size_t index, bool success)>;
+
+  virtual ~AsyncReader() = default;
+
+  /// @name Reader Interface
+  /// @{
+
+  /**
+   * Read a batch of requests, returning once they have all completed. Requests can complete in any
+   * order.
+   *
+   * @param fd The file descriptor to read from
+   * @param requests The batch of requests
+   * @param on_complete Called on the calling thread as each request completes, can be empty
+   * @return true if all the requests were read in full, otherwise false
+   */
+  virtual bool Read(int fd, ReadRequests const &requests, Completion const &on_complete) = 0;
+
+  virtual AsyncIoBackend backend() const     = 0;
+  virtual std::size_t    queue_depth() const = 0;
+  /// @}
+};
+
+using AsyncReaderPtr = std::unique_ptr<AsyncReader>;
+
+AsyncReaderPtr CreateAsyncReader(AsyncIoBackend backend, std::size_t queue_depth);
+
+}  // namespace storage
+}  // namespace fetch
@@ -0,0 +1,467 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+//  ┌──────┬───────────┬───────────┬───────────┬───────────┐
+//  │      │           │           │           │           │
+//  │HEADER│  OBJECT   │  OBJECT   │  OBJECT   │  OBJECT   │
+//  │      │           │           │           │           │......
+//  │      │           │           │           │           │
+//  └──────┴───────────┴───────────┴───────────┴───────────┘
+
+#include "core/assert.hpp"
+#include "storage/async_io.hpp"
+#include "storage/random_access_stack.hpp"
+#include "storage/storage_exception.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace fetch {
+namespace storage {
+
+/**
+ * Random access stack with the same file layout as the RandomAccessStack, which reads and writes
+ * through a file descriptor rather than a stream. In addition to the usual stack interface it is
+ * able to service a batch of Gets in parallel using the asynchronous IO backends, which keeps many
+ * requests in flight at the device rather than one at a time.
+ */
+template <typename T, typename D = uint64_t>
+class AsyncRandomAccessStack
+{
+public:
+  using header_extra_type  = D;
+  using type               = T;
+  using event_handler_type = std::function<void()>;
+  using Indices            = std::vector<uint64_t>;
+  using Completion         = std::function<void(std::size_t index, bool success)>;
+
+  static constexpr char const *LOGGING_NAME        = "AsyncRandomAccessStack";
+  static constexpr std::size_t DEFAULT_QUEUE_DEPTH = 64;
+
+  explicit AsyncRandomAccessStack(AsyncIoBackend backend     = AsyncIoBackend::AUTO,
+                                  std::size_t    queue_depth = DEFAULT_QUEUE_DEPTH)
+    : reader_{CreateAsyncReader(backend, queue_depth)}
+  {}
+
+  AsyncRandomAccessStack(AsyncRandomAccessStack const &) = delete;
+  AsyncRandomAccessStack &operator=(AsyncRandomAccessStack const &) = delete;
+
+  ~AsyncRandomAccessStack()
+  {
+    CloseFile();
+  }
+
+  void ClearEventHandlers()
+  {
+    on_file_loaded_  = nullptr;
+    on_before_flush_ = nullptr;
+  }
+
+  void OnFileLoaded(event_handler_type const &f)
+  {
+    on_file_loaded_ = f;
+  }
+
+  void OnBeforeFlush(event_handler_type const &f)
+  {
+    on_before_flush_ = f;
+  }
+
+  void SignalFileLoaded()
+  {
+    if (on_file_loaded_)
+    {
+      on_file_loaded_();
+    }
+  }
+
+  void SignalBeforeFlush()
+  {
+    if (on_before_flush_)
+    {
+      on_before_flush_();
+    }
+  }
+
+  /**
+   * Indicate whether the stack is writing directly to disk or caching writes.
+   *
+   * @return: Whether the stack is written straight to disk.
+   */
+  static constexpr bool DirectWrite()
+  {
+    return true;
+  }
+
+  void Close(bool const &lazy = false)
+  {
+    if (!lazy)
+    {
+      Flush();
+    }
+    CloseFile();
+  }
+
+  void Load(std::string const &filename, bool const &create_if_not_exist = false)
+  {
+    CloseFile();
+    filename_ = filename;
+    fd_       = open(filename_.c_str(), O_RDWR);
+
+    if (fd_ < 0)
+    {
+      if (!create_if_not_exist)
+      {
+        throw StorageException("Could not load file");
+      }
+
+      Clear();
+      return;
+    }
+
+    struct stat info
+    {
+    };
+    if ((fstat(fd_, &info) != 0) || !ReadHeader())
+    {
+      throw StorageException("Unable to read stack header");
+    }
+
+    auto const length = static_cast<uint64_t>(info.st_size);
+    if (((length - HeaderSize()) / sizeof(type)) < objects_)
+    {
+      throw StorageException("Expected more stack objects.");
+    }
+
+    SignalFileLoaded();
+  }
+
+  void New(std::string const &filename)
+  {
+    CloseFile();
+    filename_ = filename;
+    Clear();
+  }
+
+  /**
+   * Get object on the stack at index i, not safe when i > objects.
+   *
+   * @param: i The Ith object, indexed from 0
+   * @param: object The object reference to fill
+   */
+  void Get(std::size_t const &i, type &object) const
+  {
+    assert(i < size());
+
+    if (!ReadAt(&object, sizeof(type), Offset(i)))
+    {
+      throw StorageException("Unable to read stack object");
+    }
+  }
+
+  /**
+   * Get a batch of objects, the reads are issued in parallel
+   *
+   * @param: indices The indices of the objects, all must be valid
+   * @param: objects The destination of the objects, aligned with the indices
+   * @param: on_complete Optional callback invoked as each object is read
+   *
+   * @return: true if all of the objects were read successfully
+   */
+  bool GetBatch(Indices const &indices, type *objects, Completion const &on_complete = Completion{})
+  {
+    AsyncReader::ReadRequests requests(indices.size());
+
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+      assert(indices[i] < size());
+
+      requests[i].offset = Offset(indices[i]);
+      requests[i].buffer = &objects[i];
+      requests[i].length = sizeof(type);
+    }
+
+    return reader_->Read(fd_, requests, on_complete);
+  }
+
+  /**
+   * Get bulk elements, will fill the pointer with as many elements as are valid
+   *
+   * @param: i Location of first object to be read
+   * @param: elements Number of elements to copy, updated with the number copied
+   * @param: objects Pointer to array of elements
+   */
+  void GetBulk(std::size_t const &i, std::size_t &elements, type *objects)
+  {
+    if (i >= objects_)
+    {
+      elements = 0;
+      return;
+    }
+
+    elements = std::min(elements, std::size_t(objects_ - i));
+
+    if (!ReadAt(objects, sizeof(type) * elements, Offset(i)))
+    {
+      throw StorageException("Unable to read stack objects");
+    }
+  }
+
+  /**
+   * Set object on the stack at index i, not safe when i > objects.
+   *
+   * @param: i The Ith object, indexed from 0
+   * @param: object The object to copy to the stack
+   */
+  void Set(std::size_t const &i, type const &object)
+  {
+    assert(i < size());
+    WriteAt(&object, sizeof(type), Offset(i));
+  }
+
+  void SetBulk(std::size_t const &i, std::size_t elements, type const *objects)
+  {
+    if (LazySetBulk(i, elements, objects))
+    {
+      StoreHeader();
+    }
+  }
+
+  bool LazySetBulk(std::size_t const &i, std::size_t elements, type const *objects)
+  {
+    WriteAt(objects, sizeof(type) * elements, Offset(i));
+
+    if ((i + elements) > objects_)
+    {
+      objects_ = i + elements;
+      return true;
+    }
+
+    return false;
+  }
+
+  void SetExtraHeader(header_extra_type const &he)
+  {
+    extra_ = he;
+    StoreHeader();
+  }
+
+  header_extra_type const &header_extra() const
+  {
+    return extra_;
+  }
+
+  uint64_t Push(type const &object)
+  {
+    uint64_t const ret = LazyPush(object);
+    StoreHeader();
+    return ret;
+  }
+
+  uint64_t LazyPush(type const &object)
+  {
+    uint64_t const ret = objects_;
+    WriteAt(&object, sizeof(type), Offset(ret));
+    ++objects_;
+
+    return ret;
+  }
+
+  void Pop()
+  {
+    assert(objects_ > 0);
+    --objects_;
+    StoreHeader();
+  }
+
+  type Top() const
+  {
+    assert(objects_ > 0);
+
+    type object;
+    Get(objects_ - 1, object);
+    return object;
+  }
+
+  void Swap(std::size_t const &i, std::size_t const &j)
+  {
+    if (i == j)
+    {
+      return;
+    }
+
+    type a, b;
+    Get(i, a);
+    Get(j, b);
+    Set(i, b);
+    Set(j, a);
+  }
+
+  std::size_t size() const
+  {
+    return objects_;
+  }
+
+  std::size_t empty() const
+  {
+    return objects_ == 0;
+  }
+
+  /**
+   * Clear the file and write an 'empty' header to the file
+   */
+  void Clear()
+  {
+    assert(!filename_.empty());
+
+    CloseFile();
+    fd_ = open(filename_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0)
+    {
+      throw StorageException("Error could not create file: " + filename_);
+    }
+
+    objects_ = 0;
+    extra_   = D{};
+    StoreHeader();
+
+    SignalFileLoaded();
+  }
+
+  void Flush(bool const &lazy = false)
+  {
+    if (!lazy)
+    {
+      SignalBeforeFlush();
+    }
+    StoreHeader();
+  }
+
+  bool is_open() const
+  {
+    return fd_ >= 0;
+  }
+
+  AsyncIoBackend backend() const
+  {
+    return reader_->backend();
+  }
+
+  std::size_t queue_depth() const
+  {
+    return reader_->queue_depth();
+  }
+
+private:
+  /// Matches the packed header layout of the RandomAccessStack
+  static constexpr uint64_t HeaderSize()
+  {
+    return sizeof(uint16_t) + sizeof(uint64_t) + sizeof(D);
+  }
+
+  static uint64_t Offset(uint64_t i)
+  {
+    return HeaderSize() + (i * sizeof(type));
+  }
+
+  bool ReadHeader()
+  {
+    uint16_t magic = 0;
+
+    bool const success = ReadAt(&magic, sizeof(magic), 0) &&
+                         ReadAt(&objects_, sizeof(objects_), sizeof(magic)) &&
+                         ReadAt(&extra_, sizeof(extra_), sizeof(magic) + sizeof(objects_));
+
+    return success && (magic == platform::LITTLE_ENDIAN_MAGIC);
+  }
+
+  void StoreHeader()
+  {
+    uint16_t const magic = platform::LITTLE_ENDIAN_MAGIC;
+
+    WriteAt(&magic, sizeof(magic), 0);
+    WriteAt(&objects_, sizeof(objects_), sizeof(magic));
+    WriteAt(&extra_, sizeof(extra_), sizeof(magic) + sizeof(objects_));
+  }
+
+  bool ReadAt(void *buffer, std::size_t length, uint64_t offset) const
+  {
+    // single reads are serviced synchronously, there is nothing to overlap them with
+    return ReadFully(fd_, buffer, length, offset);
+  }
+
+  void WriteAt(void const *buffer, std::size_t length, uint64_t offset)
+  {
+    auto const *source = reinterpret_cast<uint8_t const *>(buffer);
+
+    while (length != 0)
+    {
+      ssize_t const result = pwrite(fd_, source, length, static_cast<off_t>(offset));
+      if (result < 0)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+
+        throw StorageException("Error writing to file: " + filename_);
+      }
+
+      auto const count = static_cast<std::size_t>(result);
+
+      source += count;
+      length -= count;
+      offset += count;
+    }
+  }
+
+  void CloseFile()
+  {
+    if (fd_ >= 0)
+    {
+      close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  event_handler_type on_file_loaded_;
+  event_handler_type on_before_flush_;
+  std::string        filename_;
+  int                fd_      = -1;
+  uint64_t           objects_ = 0;
+  D                  extra_{};
+  AsyncReaderPtr     reader_;
+};
+
+template <typename T, typename D>
+constexpr char const *AsyncRandomAccessStack<T, D>::LOGGING_NAME;
+
+template <typename T, typename D>
+constexpr std::size_t AsyncRandomAccessStack<T, D>::DEFAULT_QUEUE_DEPTH;
+
+}  // namespace storage
+}  // namespace fetch
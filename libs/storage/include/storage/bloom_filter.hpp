@@ -0,0 +1,85 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fetch {
+namespace storage {
+
+/**
+ * Blocked Bloom filter, used to reject lookups for keys which have never been written without
+ * touching the underlying storage.
+ *
+ * Every key is mapped to a single 512 bit block and all of its probe bits are set within that
+ * block, so that a query costs one cache line rather than one random memory access per probe. This
+ * gives a slightly higher false positive rate than a standard filter of the same size (roughly 0.5%
+ * at the default 12 bits per key).
+ *
+ * The filter never yields false negatives for keys that have been added and there is no way of
+ * removing a key. Owners which can lose keys (for example on a revert) simply keep the superset.
+ */
+class BlockedBloomFilter
+{
+public:
+  using ConstByteArray = byte_array::ConstByteArray;
+
+  static constexpr char const *LOGGING_NAME    = "BlockedBloomFilter";
+  static constexpr std::size_t WORDS_PER_BLOCK = 8;  ///< 512 bits, a single cache line
+  static constexpr std::size_t BLOCK_BITS      = WORDS_PER_BLOCK * 64;
+  static constexpr std::size_t PROBE_COUNT     = 6;
+  static constexpr std::size_t BITS_PER_KEY    = 12;
+
+  explicit BlockedBloomFilter(std::size_t capacity = 0);
+
+  /// @name Filter Operations
+  /// @{
+  void Reset(std::size_t capacity);
+  void Add(ConstByteArray const &key);
+  bool MayContain(ConstByteArray const &key) const;
+  /// @}
+
+  /// @name Accessors
+  /// @{
+  std::size_t size() const;
+  std::size_t capacity() const;
+  std::size_t block_count() const;
+  bool        saturated() const;
+  /// @}
+
+  /// @name Persistence
+  /// @{
+  bool Save(std::string const &path, ConstByteArray const &tag) const;
+  bool Load(std::string const &path, ConstByteArray const &tag);
+  /// @}
+
+private:
+  using Words = std::vector<uint64_t>;
+
+  std::size_t capacity_ = 0;  ///< The number of keys the filter has been sized for
+  std::size_t size_     = 0;  ///< The number of keys added since the last reset
+  Words       words_;
+};
+
+}  // namespace storage
+}  // namespace fetch
@@ -0,0 +1,182 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace fetch {
+namespace storage {
+
+enum class EvictionPolicy
+{
+  LRU,       ///< Least recently used
+  CLOCK,     ///< Second chance approximation of LRU
+  TWO_QUEUE  ///< Scan resistant 2Q, lines must be accessed twice before being considered hot
+};
+
+char const *ToString(EvictionPolicy policy);
+
+/**
+ * Interface for the replacement policies used by the cache line stacks. The policy tracks the set
+ * of resident cache lines and decides which one should be evicted when the cache is full.
+ */
+class CacheEvictionPolicy
+{
+public:
+  using LineId = uint64_t;
+
+  virtual ~CacheEvictionPolicy() = default;
+
+  /// @name Policy Interface
+  /// @{
+
+  /**
+   * Called when a line has been loaded into the cache
+   *
+   * @param line The identifier of the line
+   */
+  virtual void OnInsert(LineId line) = 0;
+
+  /**
+   * Called when a resident line is read from or written to
+   *
+   * @param line The identifier of the line
+   */
+  virtual void OnAccess(LineId line) = 0;
+
+  /**
+   * Select the next line to be evicted and stop tracking it. Must only be called when the policy
+   * is tracking at least one line
+   *
+   * @return The identifier of the evicted line
+   */
+  virtual LineId Evict() = 0;
+
+  /**
+   * Update the number of lines the cache is able to hold
+   *
+   * @param lines The capacity in lines
+   */
+  virtual void SetCapacity(std::size_t lines) = 0;
+
+  virtual void        Clear()      = 0;
+  virtual std::size_t size() const = 0;
+  /// @}
+};
+
+using CacheEvictionPolicyPtr = std::unique_ptr<CacheEvictionPolicy>;
+
+CacheEvictionPolicyPtr CreateEvictionPolicy(EvictionPolicy policy, std::size_t capacity);
+
+/**
+ * Least recently used policy
+ */
+class LRUEvictionPolicy : public CacheEvictionPolicy
+{
+public:
+  void        OnInsert(LineId line) override;
+  void        OnAccess(LineId line) override;
+  LineId      Evict() override;
+  void        SetCapacity(std::size_t lines) override;
+  void        Clear() override;
+  std::size_t size() const override;
+
+private:
+  using Queue    = std::list<LineId>;
+  using QueueMap = std::unordered_map<LineId, Queue::iterator>;
+
+  Queue    queue_;  ///< Most recently used at the front
+  QueueMap lookup_;
+};
+
+/**
+ * Clock (second chance) policy: On eviction the hand sweeps around the resident lines. If it
+ * encounters a line whose reference bit is set, it clears it and moves on. The first line found
+ * without the reference bit is evicted.
+ */
+class ClockEvictionPolicy : public CacheEvictionPolicy
+{
+public:
+  void        OnInsert(LineId line) override;
+  void        OnAccess(LineId line) override;
+  LineId      Evict() override;
+  void        SetCapacity(std::size_t lines) override;
+  void        Clear() override;
+  std::size_t size() const override;
+
+private:
+  struct Slot
+  {
+    LineId line       = 0;
+    bool   referenced = false;
+    bool   occupied   = false;
+  };
+
+  using Slots     = std::vector<Slot>;
+  using SlotMap   = std::unordered_map<LineId, std::size_t>;
+  using FreeSlots = std::vector<std::size_t>;
+
+  Slots       slots_;
+  SlotMap     lookup_;
+  FreeSlots   free_;
+  std::size_t hand_ = 0;
+};
+
+/**
+ * 2Q policy (Johnson & Shasha). Newly loaded lines enter a FIFO probation queue (A1in). Lines which
+ * are evicted from probation are remembered in a ghost queue (A1out) and are promoted into the main
+ * LRU queue (Am) if they are loaded again. A single scan therefore only ever displaces the
+ * probation queue and leaves the hot working set in place.
+ */
+class TwoQueueEvictionPolicy : public CacheEvictionPolicy
+{
+public:
+  explicit TwoQueueEvictionPolicy(std::size_t capacity);
+
+  void        OnInsert(LineId line) override;
+  void        OnAccess(LineId line) override;
+  LineId      Evict() override;
+  void        SetCapacity(std::size_t lines) override;
+  void        Clear() override;
+  std::size_t size() const override;
+
+private:
+  using Queue    = std::list<LineId>;
+  using QueueMap = std::unordered_map<LineId, Queue::iterator>;
+
+  static void   PushFront(Queue &queue, QueueMap &lookup, LineId line);
+  static LineId PopBack(Queue &queue, QueueMap &lookup);
+
+  std::size_t probation_limit_ = 1;  ///< Kin: the target size of the probation queue
+  std::size_t ghost_limit_     = 1;  ///< Kout: the maximum size of the ghost queue
+
+  Queue    probation_;  ///< A1in
+  QueueMap probation_lookup_;
+  Queue    ghost_;  ///< A1out (not resident)
+  QueueMap ghost_lookup_;
+  Queue    main_;  ///< Am
+  QueueMap main_lookup_;
+};
+
+}  // namespace storage
+}  // namespace fetch
@@ -18,14 +18,15 @@
 //------------------------------------------------------------------------------
 
 #include "core/assert.hpp"
+#include "metrics/storage_metrics.hpp"
+#include "storage/cache_eviction_policy.hpp"
 #include "storage/random_access_stack.hpp"
 
 #include <algorithm>
-#include <array>
 #include <fstream>
-#include <map>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace fetch {
 namespace storage {
@@ -41,6 +42,8 @@ namespace storage {
  * small and guard against loss of data in the event of system failure. Sets and gets will fill
  * this map.
  *
+ * The number of lines held in memory is bounded by a memory budget (in bytes). When the budget
+ * is exhausted a line is chosen for eviction by the configured replacement policy.
  */
 template <typename T, typename D = uint64_t>
 class CacheLineRandomAccessStack
@@ -51,7 +54,21 @@ public:
   using header_extra_type  = D;
   using type               = T;
 
-  CacheLineRandomAccessStack() = default;
+  struct Stats
+  {
+    uint64_t hits        = 0;  ///< Accesses served from a resident line
+    uint64_t misses      = 0;  ///< Accesses which required a line to be loaded
+    uint64_t evictions   = 0;  ///< Lines removed from the cache
+    uint64_t write_backs = 0;  ///< Dirty lines written to the underlying stack
+  };
+
+  static constexpr std::size_t DEFAULT_CACHE_LINE_LN2 = 13;  // Default cache lines 8192 * sizeof(T)
+  static constexpr std::size_t MIN_CACHED_LINES       = 2;
+
+  explicit CacheLineRandomAccessStack(EvictionPolicy policy = EvictionPolicy::CLOCK)
+    : policy_type_{policy}
+    , policy_{CreateEvictionPolicy(policy, max_lines())}
+  {}
 
   ~CacheLineRandomAccessStack()
   {
@@ -72,6 +89,7 @@ public:
 
   void Load(std::string const &filename, bool const &create_if_not_exists = true)
   {
+    metrics_ = &metrics::StorageMetrics::Instance().Stack(filename);
     stack_.Load(filename, create_if_not_exists);
     this->objects_ = stack_.size();
     this->SignalFileLoaded();
@@ -79,6 +97,7 @@ public:
 
   void New(std::string const &filename)
   {
+    metrics_ = &metrics::StorageMetrics::Instance().Stack(filename);
     stack_.New(filename);
     this->objects_ = 0;
     this->SignalFileLoaded();
@@ -104,25 +123,7 @@ public:
   {
     assert(i < objects_);
 
-    uint64_t cache_lookup   = i >> cache_line_ln2;              // Upper N bits
-    uint64_t cache_subindex = i & ((1 << cache_line_ln2) - 1);  // Lower total - N bits
-
-    auto iter = data_.find(cache_lookup);
-
-    // Found the item via local map
-    if (iter != data_.end())
-    {
-      ++((*iter).second.reads);
-      object = iter->second.elements[cache_subindex];
-    }
-    else
-    {
-      // Case where item isn't found, load it into the cache, then access
-      LoadCacheLine(i);
-
-      data_[cache_lookup].reads++;
-      object = data_[cache_lookup].elements[cache_subindex];
-    }
+    object = LookupLine(i >> cache_line_ln2_, false).elements[i & line_mask()];
   }
 
   /**
@@ -135,25 +136,7 @@ public:
   {
     assert(i < objects_);
 
-    uint64_t cache_lookup   = i >> cache_line_ln2;              // Upper N bits
-    uint64_t cache_subindex = i & ((1 << cache_line_ln2) - 1);  // Lower total - N bits
-
-    auto iter = data_.find(cache_lookup);
-
-    // Found the item via local map
-    if (iter != data_.end())
-    {
-      ++iter->second.writes;
-      iter->second.elements[cache_subindex] = object;
-    }
-    else
-    {
-      // Case where item isn't found, load it into the cache, then access
-      LoadCacheLine(i);
-
-      data_[cache_lookup].writes++;
-      data_[cache_lookup].elements[cache_subindex] = object;
-    }
+    LookupLine(i >> cache_line_ln2_, true).elements[i & line_mask()] = object;
   }
 
   void Close()
@@ -207,32 +190,13 @@ public:
       return;
     }
 
-    uint64_t cache_lookup_i = i >> cache_line_ln2;
-    uint64_t cache_lookup_j = j >> cache_line_ln2;
-
-    uint64_t cache_subindex_i = i & ((1 << cache_line_ln2) - 1);
-    uint64_t cache_subindex_j = j & ((1 << cache_line_ln2) - 1);
-
-    // make sure both items are in the cache
-    if (data_.find(cache_lookup_i) == data_.end())
-    {
-      LoadCacheLine(cache_lookup_i);
-    }
-
-    if (data_.find(cache_lookup_j) == data_.end())
-    {
-      LoadCacheLine(cache_lookup_j);
-    }
-
-    // If this assertion fails, there might not be enough memory for two cache lines
-    assert(data_.find(cache_lookup_i) != data_.end());
-    assert(data_.find(cache_lookup_j) != data_.end());
-
-    data_[cache_lookup_i].reads++;
-    data_[cache_lookup_j].reads++;
-
-    std::swap(data_[cache_lookup_i].elements[cache_subindex_i],
-              data_[cache_lookup_j].elements[cache_subindex_j]);
+    // access the elements one at a time so that this is correct even if only one of the lines is
+    // able to be resident at once
+    type a, b;
+    Get(i, a);
+    Get(j, b);
+    Set(i, b);
+    Set(j, a);
   }
 
   std::size_t size() const
@@ -250,6 +214,7 @@ public:
     stack_.Clear();
     objects_ = 0;
     data_.clear();
+    policy_->Clear();
   }
 
   /**
@@ -259,9 +224,9 @@ public:
   {
     if (!lazy)
     {
-      for (auto const &i : data_)
+      for (auto &i : data_)
       {
-        FlushLine(i.first << cache_line_ln2, i.second);
+        FlushLine(i.first, i.second);
       }
 
       // Trim stack size down
@@ -282,23 +247,100 @@ public:
     return stack_.is_open();
   }
 
+  /// @name Cache Configuration
+  /// @{
+
   /**
    * Set the limit for the amount of RAM this structure will use to amortize the cost of disk
-   * writes.
+   * writes. The cache will always be able to hold at least MIN_CACHED_LINES lines.
    *
    * @param: bytes The number of bytes allowed as an upper bound
    */
   void SetMemoryLimit(std::size_t bytes)
   {
     memory_limit_bytes_ = bytes;
+    policy_->SetCapacity(max_lines());
+
+    while (data_.size() > max_lines())
+    {
+      EvictLine();
+    }
+  }
+
+  /**
+   * Change the replacement policy used by the cache. The currently resident lines are written back
+   * and dropped.
+   *
+   * @param: policy The new policy
+   */
+  void SetEvictionPolicy(EvictionPolicy policy)
+  {
+    DropLines();
+
+    policy_type_ = policy;
+    policy_      = CreateEvictionPolicy(policy, max_lines());
+  }
+
+  /**
+   * Change the number of elements held in each cache line. The currently resident lines are
+   * written back and dropped.
+   *
+   * @param: ln2 The log2 of the number of elements in each cache line
+   */
+  void SetCacheLineLn2(std::size_t ln2)
+  {
+    DropLines();
+
+    cache_line_ln2_ = ln2;
+    policy_->SetCapacity(max_lines());
+  }
+
+  EvictionPolicy eviction_policy() const
+  {
+    return policy_type_;
+  }
+
+  std::size_t cache_line_ln2() const
+  {
+    return cache_line_ln2_;
   }
 
+  std::size_t memory_limit() const
+  {
+    return memory_limit_bytes_;
+  }
+  /// @}
+
+  /// @name Cache Statistics
+  /// @{
+  Stats const &GetStats() const
+  {
+    return stats_;
+  }
+
+  void ResetStats()
+  {
+    stats_ = Stats{};
+  }
+
+  std::size_t cached_lines() const
+  {
+    return data_.size();
+  }
+  /// @}
+
 private:
-  // Cached items
-  static constexpr std::size_t cache_line_ln2 = 13;  // Default cache lines 8192 * sizeof(T)
-  std::size_t memory_limit_bytes_             = std::size_t(1ULL << 29);  // Default 500K memory
+  struct CachedDataItem
+  {
+    uint64_t          reads  = 0;
+    uint64_t          writes = 0;
+    std::vector<type> elements;
+  };
 
-  T dummy_;
+  using CacheMap = std::unordered_map<uint64_t, CachedDataItem>;
+
+  std::size_t cache_line_ln2_     = DEFAULT_CACHE_LINE_LN2;
+  std::size_t memory_limit_bytes_ = std::size_t(1ULL << 29);  // Default 512MB memory
 
   event_handler_type on_file_loaded_;
   event_handler_type on_before_flush_;
@@ -306,18 +348,80 @@ private:
   // Underlying stack
   mutable stack_type stack_;
 
-  struct CachedDataItem
+  EvictionPolicy                 policy_type_;
+  mutable CacheEvictionPolicyPtr policy_;
+  mutable CacheMap               data_;
+  mutable Stats                  stats_;
+  metrics::StackMetrics *        metrics_{nullptr};  ///< The instruments for this file
+  uint64_t                       objects_ = 0;
+
+  std::size_t line_size() const
   {
-    uint64_t                              reads  = 0;
-    uint64_t                              writes = 0;
-    std::array<type, 1 << cache_line_ln2> elements;
-  };
+    return std::size_t{1} << cache_line_ln2_;
+  }
+
+  uint64_t line_mask() const
+  {
+    return line_size() - 1;
+  }
+
+  /**
+   * Compute the number of lines which can be held within the memory budget
+   */
+  std::size_t max_lines() const
+  {
+    std::size_t const line_bytes = sizeof(typename CacheMap::value_type) + (line_size() * sizeof(T));
+    return std::max(memory_limit_bytes_ / line_bytes, MIN_CACHED_LINES);
+  }
+
+  /**
+   * Find the specified cache line, loading it from the underlying stack if required
+   *
+   * @param: line The index of the line
+   * @param: write Whether the line is being accessed for a write
+   *
+   * @return: The cache line
+   */
+  CachedDataItem &LookupLine(uint64_t line, bool write) const
+  {
+    auto iter = data_.find(line);
+
+    // Found the item via local map
+    if (iter != data_.end())
+    {
+      ++stats_.hits;
+      policy_->OnAccess(line);
+
+      if (metrics_)
+      {
+        metrics_->RecordCacheHit();
+      }
+    }
+    else
+    {
+      // Case where item isn't found, load it into the cache, then access
+      ++stats_.misses;
+      iter = LoadCacheLine(line);
 
-  mutable std::map<uint64_t, CachedDataItem> data_;
-  mutable uint64_t                           last_removed_index_ = 0;
-  uint64_t                                   objects_            = 0;
+      if (metrics_)
+      {
+        metrics_->RecordCacheMiss();
+      }
+    }
 
-  void FlushLine(uint64_t line, CachedDataItem const &items) const
+    if (write)
+    {
+      ++iter->second.writes;
+    }
+    else
+    {
+      ++iter->second.reads;
+    }
+
+    return iter->second;
+  }
+
+  void FlushLine(uint64_t line, CachedDataItem &items) const
   {
     if (items.writes == 0)
     {
@@ -329,7 +433,9 @@ private:
       return;
     }
 
-    stack_.SetBulk(line, 1ull << cache_line_ln2, items.elements.data());
+    stack_.SetBulk(line << cache_line_ln2_, line_size(), items.elements.data());
+    items.writes = 0;
+    ++stats_.write_backs;
   }
 
   void GetLine(uint64_t line, CachedDataItem &items) const
@@ -339,54 +445,52 @@ private:
       return;
     }
 
-    stack_.GetBulk(line, 1 << cache_line_ln2, items.elements.data());
+    stack_.GetBulk(line << cache_line_ln2_, line_size(), items.elements.data());
   }
 
-  bool ManageMemory() const
+  void EvictLine() const
   {
-    // Lazy policy: remove items FILO style
-    using MapElement = typename decltype(data_)::value_type;
+    uint64_t const line = policy_->Evict();
 
-    if (!(data_.size() * sizeof(MapElement) > memory_limit_bytes_))
-    {
-      return false;
-    }
+    auto iter = data_.find(line);
+    assert(iter != data_.end());
 
-    // Find and remove next index up from the last one we removed
-    auto next_to_remove = data_.upper_bound(last_removed_index_);
+    FlushLine(iter->first, iter->second);
+    data_.erase(iter);
+    ++stats_.evictions;
+  }
 
-    if (next_to_remove->first > last_removed_index_ && next_to_remove != data_.end())
-    {
-      last_removed_index_ = next_to_remove->first;
-      FlushLine(next_to_remove->first << cache_line_ln2, next_to_remove->second);
-      data_.erase(next_to_remove);
-    }
-    else
+  /**
+   * Write back and remove all the resident lines
+   */
+  void DropLines()
+  {
+    for (auto &i : data_)
     {
-      next_to_remove = data_.begin();  // Get min element
-      FlushLine(next_to_remove->first << cache_line_ln2, next_to_remove->second);
-      last_removed_index_ = next_to_remove->first;
-
-      data_.erase(next_to_remove);
+      FlushLine(i.first, i.second);
     }
 
-    return true;
+    data_.clear();
+    policy_->Clear();
   }
 
-  void LoadCacheLine(uint64_t line) const
+  typename CacheMap::iterator LoadCacheLine(uint64_t line) const
   {
     // Cull memory usage to max allowed
-    for (;;)
+    std::size_t const limit = max_lines();
+    while (!data_.empty() && (data_.size() >= limit))
     {
-      if (!ManageMemory())
-      {
-        break;
-      }
+      EvictLine();
     }
 
-    // Load in the cache line (memory usage now slightly over)
-    uint64_t cache_index = (line >> cache_line_ln2) << cache_line_ln2;
-    GetLine(cache_index, data_[cache_index >> cache_line_ln2]);
+    // Load in the cache line
+    auto &item = data_[line];
+    item.elements.resize(line_size());
+    GetLine(line, item);
+
+    policy_->OnInsert(line);
+
+    return data_.find(line);
   }
 
   void SignalFileLoaded()
@@ -397,5 +501,12 @@ private:
     }
   }
 };
+
+template <typename T, typename D>
+constexpr std::size_t CacheLineRandomAccessStack<T, D>::DEFAULT_CACHE_LINE_LN2;
+
+template <typename T, typename D>
+constexpr std::size_t CacheLineRandomAccessStack<T, D>::MIN_CACHED_LINES;
+
 }  // namespace storage
 }  // namespace fetch
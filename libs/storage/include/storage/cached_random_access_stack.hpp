@@ -25,12 +25,14 @@
 //  └──────┴───────────┴───────────┴───────────┴───────────┘
 
 #include "core/assert.hpp"
+#include "metrics/storage_metrics.hpp"
 #include "storage/random_access_stack.hpp"
 
 #include <fstream>
 #include <map>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace fetch {
 namespace storage {
@@ -97,12 +99,14 @@ public:
 
   void Load(std::string const &filename, bool const &create_if_not_exists = true)
   {
+    metrics_ = &metrics::StorageMetrics::Instance().Stack(filename);
     stack_.Load(filename, create_if_not_exists);
     this->SignalFileLoaded();
   }
 
   void New(std::string const &filename)
   {
+    metrics_ = &metrics::StorageMetrics::Instance().Stack(filename);
     stack_.New(filename);
     Clear();
     this->SignalFileLoaded();
@@ -119,10 +123,12 @@ public:
     {
       ++iter->second.reads;
       object = iter->second.data;
+      RecordAccess(true);
     }
     else
     {
       // Case where item isn't found, get it from the stack and insert it into the map
+      RecordAccess(false);
       stack_.Get(i, object);
       CachedDataItem itm;
       itm.data = object;
@@ -130,6 +136,57 @@ public:
     }
   }
 
+  /**
+   * Get a batch of objects. The cache misses are read from the underlying stack together, in
+   * parallel when the stack supports batched reads.
+   *
+   * @param: indices The indices of the objects
+   * @param: objects The objects, aligned with the indices
+   */
+  void GetBatch(std::vector<uint64_t> const &indices, std::vector<type> &objects)
+  {
+    objects.resize(indices.size());
+
+    std::vector<uint64_t>    misses;
+    std::vector<std::size_t> positions;
+
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+      assert(indices[i] < objects_);
+
+      auto iter = data_.find(indices[i]);
+      if (iter != data_.end())
+      {
+        ++iter->second.reads;
+        objects[i] = iter->second.data;
+        RecordAccess(true);
+      }
+      else
+      {
+        misses.push_back(indices[i]);
+        positions.push_back(i);
+        RecordAccess(false);
+      }
+    }
+
+    if (misses.empty())
+    {
+      return;
+    }
+
+    std::vector<type> loaded(misses.size());
+    ReadBatch(stack_, misses, loaded.data(), 0);
+
+    for (std::size_t i = 0; i < misses.size(); ++i)
+    {
+      objects[positions[i]] = loaded[i];
+
+      CachedDataItem itm;
+      itm.data = loaded[i];
+      data_.insert(std::pair<uint64_t, CachedDataItem>(misses[i], itm));
+    }
+  }
+
   /**
    * Set index i to object. Undefined behaviour if i >= stack size.
    *
@@ -281,9 +338,44 @@ public:
   }
 
 private:
+  template <typename S>
+  static auto ReadBatch(S &stack, std::vector<uint64_t> const &indices, type *objects, int)
+      -> decltype(stack.GetBatch(indices, objects), void())
+  {
+    if (!stack.GetBatch(indices, objects))
+    {
+      throw StorageException("Unable to read batch from the underlying stack");
+    }
+  }
+
+  template <typename S>
+  static void ReadBatch(S &stack, std::vector<uint64_t> const &indices, type *objects, long)
+  {
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+      stack.Get(indices[i], objects[i]);
+    }
+  }
+
+  void RecordAccess(bool hit) const
+  {
+    if (metrics_)
+    {
+      if (hit)
+      {
+        metrics_->RecordCacheHit();
+      }
+      else
+      {
+        metrics_->RecordCacheMiss();
+      }
+    }
+  }
+
   static constexpr std::size_t MAX_SIZE_BYTES = 10000;
   event_handler_type           on_file_loaded_;
   event_handler_type           on_before_flush_;
+  metrics::StackMetrics *      metrics_{nullptr};  ///< The instruments for this file
 
   // Underlying stack
   stack_type stack_;
@@ -0,0 +1,108 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fetch {
+namespace storage {
+
+/**
+ * The codecs used to encode a document. The value is recorded in the file object header so it
+ * must never be reordered
+ */
+enum class DocumentCodec : uint8_t
+{
+  NONE    = 0,  ///< Stored as raw bytes
+  DEFLATE = 1   ///< zlib stream, optionally with a preset dictionary
+};
+
+struct CompressionOptions
+{
+  bool        enabled  = false;
+  int         level    = 6;   ///< zlib compression level (1 - 9)
+  std::size_t min_size = 64;  ///< Documents smaller than this are always stored raw
+};
+
+/**
+ * Compresses documents with deflate using a preset dictionary trained on previously stored
+ * documents. Contract state has lots of shared structure (field names, addresses, serializer
+ * framing) which a dictionary captures even when individual documents are small.
+ *
+ * Dictionaries are persisted in an append-only file next to the document store and are identified
+ * by their Adler-32 checksum, which zlib records in every stream. Once a dictionary has been used
+ * it is never removed, so documents written at any point in the history can always be decoded.
+ */
+class DocumentCompressor
+{
+public:
+  using ConstByteArray = byte_array::ConstByteArray;
+  using Samples        = std::vector<ConstByteArray>;
+  using DictionaryId   = uint32_t;
+
+  static constexpr char const *LOGGING_NAME            = "DocumentCompressor";
+  static constexpr std::size_t MAX_DICTIONARY_SIZE     = 32 * 1024;  ///< deflate window size
+  static constexpr std::size_t DEFAULT_DICTIONARY_SIZE = 16 * 1024;
+
+  /// @name Persistence
+  /// @{
+  void New(std::string const &path);
+  void Load(std::string const &path);
+  /// @}
+
+  /// @name Options
+  /// @{
+  void                      SetOptions(CompressionOptions const &options);
+  CompressionOptions const &options() const;
+  bool                      enabled() const;
+  /// @}
+
+  /// @name Dictionaries
+  /// @{
+  DictionaryId AddDictionary(ConstByteArray const &dictionary);
+  std::size_t  dictionary_count() const;
+
+  static ConstByteArray TrainDictionary(Samples const &samples,
+                                        std::size_t    size = DEFAULT_DICTIONARY_SIZE);
+  /// @}
+
+  /// @name Encoding
+  /// @{
+  DocumentCodec  Compress(ConstByteArray const &input, ConstByteArray &output) const;
+  ConstByteArray Decompress(DocumentCodec codec, ConstByteArray const &input) const;
+  /// @}
+
+private:
+  using Dictionaries = std::unordered_map<DictionaryId, ConstByteArray>;
+
+  void Register(ConstByteArray const &dictionary);
+
+  std::string        path_;
+  CompressionOptions options_;
+  Dictionaries       dictionaries_;
+  ConstByteArray     active_dictionary_;  ///< The dictionary used for new documents
+};
+
+}  // namespace storage
+}  // namespace fetch
@@ -18,6 +18,8 @@
 //------------------------------------------------------------------------------
 
 #include "core/byte_array/byte_array.hpp"
+#include "crypto/hash.hpp"
+#include "storage/document_compression.hpp"
 #include "storage/file_object.hpp"
 #include "storage/key_value_index.hpp"
 #include "storage/resource_mapper.hpp"
@@ -25,6 +27,7 @@
 #include <cassert>
 #include <fstream>
 #include <memory>
+#include <string>
 #include <utility>
 
 #include "core/mutex.hpp"
@@ -42,6 +45,9 @@ namespace storage {
  * to locations
  * in the document store
  *
+ * Documents can optionally be compressed, see SetCompression. The codec is recorded in the header
+ * of each document file and the index hashes the uncompressed contents, so the state hash does not
+ * depend on how the documents are stored.
  */
 template <std::size_t BLOCK_SIZE = 2048, typename A = FileBlockType<BLOCK_SIZE>,
           typename B = KeyValueIndex<>, typename C = VersionedRandomAccessStack<A>,
@@ -103,8 +109,19 @@ public:
       return store_;
     }
 
+    byte_array::ConstByteArray const &content_hash() const
+    {
+      return content_hash_;
+    }
+
+    void SetContentHash(byte_array::ConstByteArray hash)
+    {
+      content_hash_ = std::move(hash);
+    }
+
   private:
     byte_array::ConstByteArray address_;
+    byte_array::ConstByteArray content_hash_;  ///< Hash of the contents before encoding
     self_type *                store_;
   };
 
@@ -193,6 +210,21 @@ public:
       return was_created_;
     }
 
+    DocumentCodec codec() const
+    {
+      return static_cast<DocumentCodec>(pointer_->codec());
+    }
+
+    void SetCodec(DocumentCodec codec)
+    {
+      pointer_->SetCodec(static_cast<uint8_t>(codec));
+    }
+
+    void SetContentHash(byte_array::ConstByteArray hash)
+    {
+      pointer_->SetContentHash(std::move(hash));
+    }
+
   private:
     std::shared_ptr<DocumentFileImplementation> pointer_;
     bool                                        was_created_ = false;
@@ -204,6 +236,7 @@ public:
     std::lock_guard<mutex::Mutex> lock(mutex_);
     file_store_.Load(doc_file, doc_diff, create);
     key_index_.Load(index_file, index_diff, create);
+    compressor_.Load(DictionaryPath(doc_file));
   }
 
   void New(std::string const &doc_file, std::string const &doc_diff, std::string const &index_file,
@@ -212,6 +245,7 @@ public:
     std::lock_guard<mutex::Mutex> lock(mutex_);
     file_store_.New(doc_file, doc_diff);
     key_index_.New(index_file, index_diff);
+    compressor_.New(DictionaryPath(doc_file));
   }
 
   void Load(std::string const &doc_file, std::string const &index_file, bool const &create = true)
@@ -219,6 +253,7 @@ public:
     std::lock_guard<mutex::Mutex> lock(mutex_);
     file_store_.Load(doc_file, create);
     key_index_.Load(index_file, create);
+    compressor_.Load(DictionaryPath(doc_file));
   }
 
   void New(std::string const &doc_file, std::string const &index_file)
@@ -226,6 +261,7 @@ public:
     std::lock_guard<mutex::Mutex> lock(mutex_);
     file_store_.New(doc_file);
     key_index_.New(index_file);
+    compressor_.New(DictionaryPath(doc_file));
   }
 
   Document GetOrCreate(ResourceID const &rid)
@@ -244,8 +280,7 @@ public:
       ret.was_created = doc.was_created();
       if (!doc.was_created())
       {
-        ret.document.Resize(doc.size());
-        doc.Read(ret.document);
+        ret.document = ReadDocument(doc);
       }
     }
 
@@ -268,8 +303,7 @@ public:
       ret.was_created = doc.was_created();
       if (!doc.was_created())
       {
-        ret.document.Resize(doc.size());
-        doc.Read(ret.document);
+        ret.document = ReadDocument(doc);
       }
     }
 
@@ -281,14 +315,25 @@ public:
     {
       std::lock_guard<mutex::Mutex> lock(mutex_);
       DocumentFile                  doc = GetDocumentFile(rid, true);
+
+      byte_array::ConstByteArray encoded;
+      DocumentCodec const        codec  = compressor_.Compress(value, encoded);
+      auto const &               stored = (codec == DocumentCodec::NONE) ? value : encoded;
+
       doc.Seek(0);
 
-      if (doc.size() > value.size())
+      if (doc.size() > stored.size())
       {
-        doc.Shrink(value.size());
+        doc.Shrink(stored.size());
       }
 
-      doc.Write(value);
+      doc.SetCodec(codec);
+      doc.Write(stored);
+
+      if (codec != DocumentCodec::NONE)
+      {
+        doc.SetContentHash(crypto::Hash<typename file_object_type::hasher_type>(value));
+      }
     }
   }
 
@@ -346,12 +391,21 @@ public:
       DocumentFile doc(store_, kv.first, store_->file_store_, kv.second);
 
       Document ret;
-      ret.document.Resize(doc.size());
-      doc.Read(ret.document);
+      ret.document = store_->ReadDocument(doc);
 
       return ret;
     }
 
+    /**
+     * Get the resource id of the current element
+     *
+     * @return: The resource id
+     */
+    ResourceID GetKey() const
+    {
+      return ResourceID{(*wrapped_iterator_).first};
+    }
+
   protected:
     typename key_value_index_type::Iterator wrapped_iterator_;
     self_type *                             store_;
@@ -435,6 +489,101 @@ public:
     return key_index_.Hash();
   }
 
+  /// @name Compression
+  /// Compression only applies to documents written after it has been enabled, existing documents
+  /// are decoded according to the codec recorded in their header
+  /// @{
+  void SetCompression(CompressionOptions const &options)
+  {
+    std::lock_guard<mutex::Mutex> lock(mutex_);
+    compressor_.SetOptions(options);
+  }
+
+  CompressionOptions compression_options()
+  {
+    std::lock_guard<mutex::Mutex> lock(mutex_);
+    return compressor_.options();
+  }
+
+  /**
+   * Train a new compression dictionary on the documents currently in the store. The dictionary is
+   * used for all subsequently written documents
+   *
+   * @param: max_samples The maximum number of documents to sample
+   * @param: size The target size of the dictionary
+   *
+   * @return: true if a dictionary was created, false if there was nothing to train on
+   */
+  bool TrainCompressionDictionary(
+      std::size_t max_samples = 1024,
+      std::size_t size        = DocumentCompressor::DEFAULT_DICTIONARY_SIZE)
+  {
+    std::lock_guard<mutex::Mutex> lock(mutex_);
+
+    DocumentCompressor::Samples samples;
+    for (auto it = key_index_.begin(); (it != key_index_.end()) && (samples.size() < max_samples);
+         ++it)
+    {
+      auto         kv = *it;
+      DocumentFile doc(this, kv.first, file_store_, kv.second);
+
+      samples.emplace_back(ReadDocument(doc));
+    }
+
+    auto const dictionary = DocumentCompressor::TrainDictionary(samples, size);
+    if (dictionary.empty())
+    {
+      return false;
+    }
+
+    compressor_.AddDictionary(dictionary);
+
+    return true;
+  }
+  /// @}
+
+  /// @name Compaction
+  /// Drop the history older than the most recent bookmarks, see the underlying stacks for the
+  /// details of the phases. RunCompaction does not take the lock so that it does not block
+  /// readers, but the caller must ensure that only one compaction is in progress at a time
+  /// @{
+  bool BeginCompaction(uint64_t finality_depth)
+  {
+    std::lock_guard<mutex::Mutex> lock(mutex_);
+
+    auto &index_stack = key_index_.underlying_stack();
+
+    bool const index_begun = index_stack.BeginCompaction(finality_depth);
+    bool const file_begun  = file_store_.BeginCompaction(finality_depth);
+
+    // both stacks are committed together, so they should always agree
+    if (index_begun != file_begun)
+    {
+      index_stack.AbortCompaction();
+      file_store_.AbortCompaction();
+      return false;
+    }
+
+    return index_begun;
+  }
+
+  bool RunCompaction()
+  {
+    bool const index_copied = key_index_.underlying_stack().RunCompaction();
+    bool const file_copied  = file_store_.RunCompaction();
+
+    return index_copied && file_copied;
+  }
+
+  uint64_t CompleteCompaction()
+  {
+    std::lock_guard<mutex::Mutex> lock(mutex_);
+
+    key_index_.underlying_stack().CompleteCompaction();
+    return file_store_.CompleteCompaction();
+  }
+  /// @}
+
 protected:
   /**
    * Get or create a document file
@@ -466,8 +615,30 @@ protected:
   mutex::Mutex         mutex_{__LINE__, __FILE__};
   key_value_index_type key_index_;
   file_store_type      file_store_;
+  DocumentCompressor   compressor_;
 
 private:
+  static std::string DictionaryPath(std::string const &doc_file)
+  {
+    return doc_file + ".dict";
+  }
+
+  /**
+   * Read and decode the contents of a document file
+   *
+   * @param: doc The document file
+   *
+   * @return: The uncompressed document
+   */
+  byte_array::ConstByteArray ReadDocument(DocumentFile &doc) const
+  {
+    byte_array::ByteArray contents;
+    contents.Resize(doc.size());
+    doc.Read(contents);
+
+    return compressor_.Decompress(doc.codec(), contents);
+  }
+
   /**
    * Write a document file under modification back to the store
    *
@@ -477,7 +648,16 @@ private:
   {
     doc.Flush();
 
-    key_index_.Set(doc.address(), doc.id(), doc.Hash());
+    // compressed documents are indexed by the hash of their uncompressed contents, which is only
+    // known when they are written
+    if (doc.codec() == static_cast<uint8_t>(DocumentCodec::NONE))
+    {
+      key_index_.Set(doc.address(), doc.id(), doc.Hash());
+    }
+    else if (!doc.content_hash().empty())
+    {
+      key_index_.Set(doc.address(), doc.id(), doc.content_hash());
+    }
 
     // TODO(issue 10):    file_store_.Flush();
     key_index_.Flush();
@@ -19,12 +19,15 @@
 
 #include "core/byte_array/encoders.hpp"
 #include "core/mutex.hpp"
+#include "network/service/call_context.hpp"
 #include "network/service/protocol.hpp"
 #include "storage/document_store.hpp"
 #include "storage/new_revertible_document_store.hpp"
 #include "storage/revertible_document_store.hpp"
 
 #include <map>
+#include <utility>
+#include <vector>
 
 namespace fetch {
 namespace storage {
@@ -36,7 +39,10 @@ public:
   using lane_type              = uint32_t;  // TODO(issue 12): Fetch from some other palce
   using CallContext            = service::CallContext;
 
-  using Identifier = byte_array::ConstByteArray;
+  using Identifier  = byte_array::ConstByteArray;
+  using ResourceIDs = std::vector<ResourceID>;
+  using Documents   = std::vector<Document>;
+  using KeyValues   = std::vector<std::pair<ResourceID, byte_array::ConstByteArray>>;
 
   static constexpr char const *LOGGING_NAME = "RevertibleDocumentStoreProtocol";
 
@@ -52,9 +58,19 @@ public:
     CURRENT_HASH,
     HASH_EXISTS,
 
+    GET_BULK = 10,
+    SET_BULK,
+
     LOCK = 20,
     UNLOCK,
-    HAS_LOCK
+    HAS_LOCK,
+    LOCK_BULK,
+    UNLOCK_BULK,
+
+    BEGIN_FORK = 30,
+    END_FORK,
+    APPLY_FORK,
+    DISCARD_FORK
   };
 
   explicit RevertibleDocumentStoreProtocol(NewRevertibleDocumentStore *doc_store)
@@ -64,6 +80,8 @@ public:
     this->Expose(GET, doc_store, &NewRevertibleDocumentStore::Get);
     this->Expose(GET_OR_CREATE, doc_store, &NewRevertibleDocumentStore::GetOrCreate);
     this->Expose(SET, doc_store, &NewRevertibleDocumentStore::Set);
+    this->Expose(GET_BULK, this, &RevertibleDocumentStoreProtocol::GetBulk);
+    this->Expose(SET_BULK, this, &RevertibleDocumentStoreProtocol::SetBulk);
 
     // Functionality for hashing/state
     this->Expose(COMMIT, doc_store, &NewRevertibleDocumentStore::Commit);
@@ -71,9 +89,17 @@ public:
     this->Expose(CURRENT_HASH, doc_store, &NewRevertibleDocumentStore::CurrentHash);
     this->Expose(HASH_EXISTS, doc_store, &NewRevertibleDocumentStore::HashExists);
 
+    // Functionality for speculative execution on forks of the state
+    this->Expose(BEGIN_FORK, doc_store, &NewRevertibleDocumentStore::BeginFork);
+    this->Expose(END_FORK, doc_store, &NewRevertibleDocumentStore::EndFork);
+    this->Expose(APPLY_FORK, doc_store, &NewRevertibleDocumentStore::ApplyFork);
+    this->Expose(DISCARD_FORK, doc_store, &NewRevertibleDocumentStore::DiscardFork);
+
     this->ExposeWithClientContext(LOCK, this, &RevertibleDocumentStoreProtocol::LockResource);
     this->ExposeWithClientContext(UNLOCK, this, &RevertibleDocumentStoreProtocol::UnlockResource);
     this->ExposeWithClientContext(HAS_LOCK, this, &RevertibleDocumentStoreProtocol::HasLock);
+    this->ExposeWithClientContext(LOCK_BULK, this, &RevertibleDocumentStoreProtocol::LockBulk);
+    this->ExposeWithClientContext(UNLOCK_BULK, this, &RevertibleDocumentStoreProtocol::UnlockBulk);
   }
 
   RevertibleDocumentStoreProtocol(NewRevertibleDocumentStore *doc_store, lane_type const &lane,
@@ -162,7 +188,77 @@ public:
     return false;
   }
 
+  /**
+   * Lock a batch of resources in a single call
+   *
+   * @param: context The context of the client requesting the locks
+   * @param: rids The resource ids to be locked
+   * @return: true if all the resources were locked, otherwise false
+   */
+  bool LockBulk(CallContext const *context, ResourceIDs const &rids)
+  {
+    bool success{true};
+
+    for (auto const &rid : rids)
+    {
+      success &= LockResource(context, rid);
+    }
+
+    return success;
+  }
+
+  /**
+   * Unlock a batch of resources in a single call
+   *
+   * @param: context The context of the client releasing the locks
+   * @param: rids The resource ids to be unlocked
+   * @return: true if all the resources were unlocked, otherwise false
+   */
+  bool UnlockBulk(CallContext const *context, ResourceIDs const &rids)
+  {
+    bool success{true};
+
+    for (auto const &rid : rids)
+    {
+      success &= UnlockResource(context, rid);
+    }
+
+    return success;
+  }
+
 private:
+  /**
+   * Lookup a batch of documents in a single call
+   *
+   * @param: rids The resource ids to lookup
+   * @return: The documents, in the same order as requested
+   */
+  Documents GetBulk(ResourceIDs const &rids)
+  {
+    Documents documents;
+    documents.reserve(rids.size());
+
+    for (auto const &rid : rids)
+    {
+      documents.emplace_back(doc_store_->Get(rid));
+    }
+
+    return documents;
+  }
+
+  /**
+   * Set a batch of documents in a single call
+   *
+   * @param: values The resource ids and their values
+   */
+  void SetBulk(KeyValues const &values)
+  {
+    for (auto const &value : values)
+    {
+      doc_store_->Set(value.first, value.second);
+    }
+  }
+
   Document GetLaneChecked(ResourceID const &rid)
   {
     if (lane_assignment_ != rid.lane(log2_lanes_))
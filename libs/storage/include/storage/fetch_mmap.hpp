@@ -40,3 +40,187 @@
 #if defined(__GNUC__)
 #pragma GCC diagnostic pop
 #endif
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace fetch {
+namespace storage {
+
+/**
+ * Access pattern hint for a mapped region. Translated to the corresponding madvise advice where
+ * the platform supports it.
+ */
+enum class MmapAccessPattern
+{
+  NORMAL,
+  RANDOM,
+  SEQUENTIAL
+};
+
+/**
+ * Options applied to a region after it has been mapped. The vendored mio library does not allow
+ * passing mmap flags, so MAP_POPULATE is emulated by prefaulting the region once it is mapped.
+ */
+struct MmapOptions
+{
+  bool populate   = false;  ///< Prefault the whole mapping up front
+  bool huge_pages = false;  ///< Request transparent huge pages for the mapping
+  bool adaptive   = true;   ///< Drive RANDOM / SEQUENTIAL advice from observed access pattern
+};
+
+namespace details {
+
+inline std::size_t PageSize()
+{
+#if defined(__unix__) || defined(__APPLE__)
+  static std::size_t const page_size = std::size_t(sysconf(_SC_PAGESIZE));
+  return page_size;
+#else
+  return 4096;
+#endif
+}
+
+/**
+ * Issue madvise on the page aligned region which covers [addr, addr + length)
+ */
+inline bool Advise(void const *addr, std::size_t length, int advice)
+{
+#if defined(__unix__) || defined(__APPLE__)
+  if ((addr == nullptr) || (length == 0))
+  {
+    return false;
+  }
+
+  std::size_t const page  = PageSize();
+  auto const        start = reinterpret_cast<uintptr_t>(addr);
+  uintptr_t const   begin = start - (start % page);
+
+  return madvise(reinterpret_cast<void *>(begin), std::size_t(start - begin) + length, advice) == 0;
+#else
+  (void)addr;
+  (void)length;
+  (void)advice;
+  return false;
+#endif
+}
+
+}  // namespace details
+
+/**
+ * Hint the kernel about how a mapped region will be accessed
+ *
+ * @param: addr The start of the region
+ * @param: length The length of the region in bytes
+ * @param: pattern The expected access pattern
+ * @return: true if the hint was accepted, otherwise false
+ */
+inline bool AdviseMmap(void const *addr, std::size_t length, MmapAccessPattern pattern)
+{
+#if defined(MADV_NORMAL) && defined(MADV_RANDOM) && defined(MADV_SEQUENTIAL)
+  switch (pattern)
+  {
+  case MmapAccessPattern::RANDOM:
+    return details::Advise(addr, length, MADV_RANDOM);
+  case MmapAccessPattern::SEQUENTIAL:
+    return details::Advise(addr, length, MADV_SEQUENTIAL);
+  case MmapAccessPattern::NORMAL:
+    break;
+  }
+  return details::Advise(addr, length, MADV_NORMAL);
+#else
+  (void)addr;
+  (void)length;
+  (void)pattern;
+  return false;
+#endif
+}
+
+/**
+ * Request that the region is backed by transparent huge pages
+ *
+ * @param: addr The start of the region
+ * @param: length The length of the region in bytes
+ * @return: true if the hint was accepted, otherwise false
+ */
+inline bool EnableHugePages(void const *addr, std::size_t length)
+{
+#if defined(MADV_HUGEPAGE)
+  return details::Advise(addr, length, MADV_HUGEPAGE);
+#else
+  (void)addr;
+  (void)length;
+  return false;
+#endif
+}
+
+/**
+ * Ask the kernel to start reading the region in, without blocking on it
+ *
+ * @param: addr The start of the region
+ * @param: length The length of the region in bytes
+ * @return: true if the hint was accepted, otherwise false
+ */
+inline bool WillNeedMmap(void const *addr, std::size_t length)
+{
+#if defined(MADV_WILLNEED)
+  return details::Advise(addr, length, MADV_WILLNEED);
+#else
+  (void)addr;
+  (void)length;
+  return false;
+#endif
+}
+
+/**
+ * Fault in every page of a writable mapping, equivalent to mapping it with MAP_POPULATE
+ *
+ * @param: addr The start of the region
+ * @param: length The length of the region in bytes
+ */
+inline void PrefaultMmap(void *addr, std::size_t length)
+{
+  if ((addr == nullptr) || (length == 0))
+  {
+    return;
+  }
+
+#if defined(MADV_POPULATE_WRITE)
+  if (details::Advise(addr, length, MADV_POPULATE_WRITE))
+  {
+    return;
+  }
+#endif
+
+  WillNeedMmap(addr, length);
+
+  // touch one byte per page so the page tables are populated
+  auto *const       data = static_cast<uint8_t volatile *>(addr);
+  std::size_t const page = details::PageSize();
+  for (std::size_t offset = 0; offset < length; offset += page)
+  {
+    data[offset] = data[offset];
+  }
+}
+
+/**
+ * Prefetch the cache line holding the specified address
+ *
+ * @param: addr The address to prefetch
+ */
+inline void PrefetchMemory(void const *addr)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(addr, 0, 1);
+#else
+  (void)addr;
+#endif
+}
+
+}  // namespace storage
+}  // namespace fetch
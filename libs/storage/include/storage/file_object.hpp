@@ -23,7 +23,9 @@
 #include "storage/storage_exception.hpp"
 #include "storage/versioned_random_access_stack.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <vector>
 
 namespace fetch {
 namespace storage {
@@ -71,7 +73,8 @@ public:
 
   enum
   {
-    HEADER_SIZE = 2 * sizeof(uint64_t)
+    HEADER_SIZE = 2 * sizeof(uint64_t),
+    CODEC_SHIFT = 56  ///< The top byte of the length field records the encoding of the contents
   };
 
   FileObject(FileObject const &other) = delete;
@@ -88,8 +91,10 @@ public:
     block_type block;
     last_position_ = stack_.size();
 
+    uint64_t const header_length = EncodeLength();
+
     memcpy(block.data, reinterpret_cast<uint8_t const *>(&last_position_), sizeof(uint64_t));
-    memcpy(block.data + sizeof(uint64_t), reinterpret_cast<uint8_t const *>(&length_),
+    memcpy(block.data + sizeof(uint64_t), reinterpret_cast<uint8_t const *>(&header_length),
            sizeof(uint64_t));
 
     block_index_ = id_ = stack_.Push(block);
@@ -115,6 +120,9 @@ public:
     memcpy(reinterpret_cast<uint8_t *>(&last_position_), first.data, sizeof(uint64_t));
     memcpy(reinterpret_cast<uint8_t *>(&length_), first.data + sizeof(uint64_t), sizeof(uint64_t));
 
+    codec_ = static_cast<uint8_t>(length_ >> CODEC_SHIFT);
+    length_ &= LengthMask();
+
     // Previously written blocks should at least have header size - if not something has gone wrong
     assert(length_ >= HEADER_SIZE);
 
@@ -132,10 +140,12 @@ public:
 
   void Flush()
   {
+    uint64_t const header_length = EncodeLength();
+
     block_type first;
     stack_.Get(id_, first);
     memcpy(first.data, reinterpret_cast<uint8_t const *>(&last_position_), sizeof(uint64_t));
-    memcpy(first.data + sizeof(uint64_t), reinterpret_cast<uint8_t const *>(&length_),
+    memcpy(first.data + sizeof(uint64_t), reinterpret_cast<uint8_t const *>(&header_length),
            sizeof(uint64_t));
     stack_.Set(id_, first);
     // TODO(issue 10): Flush    stack_.Flush();
@@ -351,10 +361,13 @@ public:
     // Writing first
     assert(block_index_ < stack_.size());
 
+    // the number of blocks to be read after the current one
+    uint64_t remaining = (last_block > block_number_) ? (last_block - block_number_) : 0;
+
     block_type block;
     stack_.Get(block_index_, block);
 
-    if ((last_block != 0) && (block.next == block_type::UNDEFINED))
+    if ((remaining != 0) && (block.next == block_type::UNDEFINED))
     {
       throw StorageException("Could not read block");
     }
@@ -362,39 +375,43 @@ public:
     memcpy(bytes, block.data + byte_index_, first_bytes);
     byte_index_ = (byte_index_ + first_bytes) % block_type::BYTES;
 
-    if (last_block != 0)
+    if (remaining != 0)
     {
       uint64_t offset = first_bytes;
+      uint64_t next   = block.next;
 
-      // Middle last block
-      --last_block;
-      while (block_number_ < last_block)
+      // the remaining blocks are read an extent at a time
+      std::vector<block_type> extent;
+      while (remaining != 0)
       {
-        assert(byte_index_ == 0);
-        ++block_number_;
-        block_index_ = block.next;
-
-        stack_.Get(block_index_, block);
+        std::size_t const count = ReadExtent(next, remaining, extent);
 
-        if (block.next == block_type::UNDEFINED)
+        for (std::size_t i = 0; i < count; ++i)
         {
-          throw StorageException("Could not read block");
+          block_index_ = next;
+          ++block_number_;
+          --remaining;
+
+          block_type const &current = extent[i];
+
+          if (remaining == 0)
+          {
+            memcpy(bytes + offset, current.data, last_bytes);
+            byte_index_ = last_bytes;
+          }
+          else
+          {
+            if (current.next == block_type::UNDEFINED)
+            {
+              throw StorageException("Could not read block");
+            }
+
+            memcpy(bytes + offset, current.data, block_type::BYTES);
+            offset += block_type::BYTES;
+          }
+
+          next = current.next;
         }
-
-        memcpy(bytes + offset, block.data, block_type::BYTES);
-
-        offset += block_type::BYTES;
-      }
-
-      // Last block
-      if (block_number_ == last_block)
-      {
-        ++block_number_;
-        block_index_ = block.next;
-        stack_.Get(block_index_, block);
-        memcpy(bytes + offset, block.data, last_bytes);
-
-        byte_index_ = last_bytes;
       }
     }
   }
@@ -409,6 +426,26 @@ public:
     return length_ - HEADER_SIZE;
   }
 
+  /**
+   * Get the encoding of the contents, zero for raw bytes
+   *
+   * @return The codec identifier
+   */
+  uint8_t codec() const
+  {
+    return codec_;
+  }
+
+  /**
+   * Set the encoding of the contents. The value is stored in the header on the next flush
+   *
+   * @param codec The codec identifier
+   */
+  void SetCodec(uint8_t codec)
+  {
+    codec_ = codec;
+  }
+
   byte_array::ConstByteArray Hash()
   {
     hasher_type hasher;
@@ -429,24 +466,99 @@ public:
     hasher.Update(block.data + HEADER_SIZE, n);
 
     remaining -= n;
+    bi = block.next;
+
+    std::vector<block_type> extent;
     while (remaining != 0)
     {
-
-      bi = block.next;
       if (bi == block_type::UNDEFINED)
       {
         throw StorageException("File corrupted");
       }
 
-      stack_.Get(bi, block);
-      n = std::min(remaining, uint64_t(block_type::BYTES));
-      hasher.Update(block.data, n);
+      uint64_t const    blocks = (remaining + block_type::BYTES - 1) / block_type::BYTES;
+      std::size_t const count  = ReadExtent(bi, blocks, extent);
+
+      for (std::size_t i = 0; (i < count) && (remaining != 0); ++i)
+      {
+        n = std::min(remaining, uint64_t(block_type::BYTES));
+        hasher.Update(extent[i].data, n);
 
-      remaining -= n;
+        remaining -= n;
+        bi = extent[i].next;
+      }
     }
   }
 
 private:
+  /// The maximum number of blocks fetched from the stack with a single read
+  static constexpr uint64_t MAX_EXTENT_BLOCKS = 64;
+
+  /**
+   * Read the run of blocks of this file which starts at the specified index. Blocks are allocated
+   * contiguously when a file is written, so the links between them identify the extents of the
+   * file. Stacks supporting bulk reads are speculatively read a whole extent at a time, others a
+   * block at a time
+   *
+   * @param index The stack index of the first block
+   * @param max_blocks The maximum number of blocks required
+   * @param extent The buffer to be populated
+   * @return The number of blocks read, always at least one
+   */
+  std::size_t ReadExtent(uint64_t index, uint64_t max_blocks, std::vector<block_type> &extent)
+  {
+    std::size_t const count = static_cast<std::size_t>(
+        std::max<uint64_t>(1, std::min<uint64_t>(max_blocks, MAX_EXTENT_BLOCKS)));
+
+    if (extent.size() < count)
+    {
+      extent.resize(count);
+    }
+
+    std::size_t const read = ReadBlocks(stack_, index, count, extent.data(), 0);
+
+    // the extent ends at the first block which does not link to its neighbour
+    std::size_t length = 1;
+    while ((length < read) && (extent[length - 1].next == index + length))
+    {
+      ++length;
+    }
+
+    return length;
+  }
+
+  template <typename T>
+  static auto ReadBlocks(T &stack, uint64_t index, std::size_t count, block_type *blocks, int)
+      -> decltype(stack.GetBulk(std::size_t{}, std::declval<std::size_t &>(), blocks),
+                  std::size_t())
+  {
+    // do not read past the end of the stack
+    std::size_t elements = static_cast<std::size_t>(
+        std::min<uint64_t>(count, static_cast<uint64_t>(stack.size()) - index));
+
+    stack.GetBulk(static_cast<std::size_t>(index), elements, blocks);
+
+    return elements;
+  }
+
+  template <typename T>
+  static std::size_t ReadBlocks(T &stack, uint64_t index, std::size_t /*count*/,
+                                block_type *blocks, long)
+  {
+    stack.Get(static_cast<std::size_t>(index), blocks[0]);
+    return 1;
+  }
+
+  static constexpr uint64_t LengthMask()
+  {
+    return (uint64_t(1) << CODEC_SHIFT) - 1;
+  }
+
+  uint64_t EncodeLength() const
+  {
+    return (length_ & LengthMask()) | (uint64_t(codec_) << CODEC_SHIFT);
+  }
+
   uint64_t    id_;
   stack_type &stack_;
 
@@ -456,6 +568,11 @@ private:
   uint64_t block_index_;
   uint64_t byte_index_;
   uint64_t length_ = 0, last_position_;
+  uint8_t  codec_  = 0;
 };
+
+template <typename S>
+constexpr uint64_t FileObject<S>::MAX_EXTENT_BLOCKS;
+
 }  // namespace storage
 }  // namespace fetch
@@ -57,6 +57,7 @@
 // (256), this represents that the node is a leaf. The nodes can contain additional information
 
 #include "crypto/sha256.hpp"
+#include "storage/bloom_filter.hpp"
 #include "storage/cached_random_access_stack.hpp"
 #include "storage/key.hpp"
 #include "storage/new_versioned_random_access_stack.hpp"
@@ -67,6 +68,9 @@
 #include <cstring>
 #include <deque>
 #include <queue>
+#include <string>
+#include <unordered_set>
+#include <vector>
 
 namespace fetch {
 namespace storage {
@@ -198,6 +202,18 @@ public:
   using key_value_pair = KeyValuePair<>;
   using key_type       = typename key_value_pair::key_type;
 
+  /**
+   * Single element of a batched update, mirrors the arguments of Set
+   */
+  struct BatchEntry
+  {
+    byte_array::ConstByteArray key;
+    uint64_t                   value;
+    byte_array::ConstByteArray data;
+  };
+
+  using Batch = std::vector<BatchEntry>;
+
   static constexpr char const *LOGGING_NAME = "KeyValueIndex";
 
   KeyValueIndex()
@@ -210,18 +226,32 @@ public:
   {
     stack_.ClearEventHandlers();
     BeforeFlushHandler();
+    SaveFilter();
   }
 
   template <typename... Args>
-  void New(Args &&... args)
+  void New(std::string const &filename, Args &&... args)
   {
-    stack_.New(std::forward<Args>(args)...);
+    stack_.New(filename, std::forward<Args>(args)...);
+
+    filter_path_ = FilterPath(filename);
+    filter_.Reset(0);
+    filter_valid_ = true;
+    filter_dirty_ = true;
   }
 
+  /**
+   * Load the index from disk. The bloom filter persisted alongside it is only used if it was
+   * saved for exactly this state of the index, otherwise it is rebuilt on the first lookup.
+   */
   template <typename... Args>
-  void Load(Args &&... args)
+  void Load(std::string const &filename, Args &&... args)
   {
-    stack_.Load(std::forward<Args>(args)...);
+    stack_.Load(filename, std::forward<Args>(args)...);
+
+    filter_path_  = FilterPath(filename);
+    filter_valid_ = filter_.Load(filter_path_, RootHash());
+    filter_dirty_ = false;
   }
 
   void BeforeFlushHandler()
@@ -316,6 +346,11 @@ public:
 
   bool GetIfExists(byte_array::ConstByteArray const &key_str, index_type &value)
   {
+    if (!MayContain(key_str))
+    {
+      return false;
+    }
+
     key_type       key(key_str);
     bool           split      = true;
     int            pos        = 0;
@@ -355,17 +390,103 @@ public:
    */
   template <typename... Args>
   void Set(byte_array::ConstByteArray const &key_str, Args const &... args)
+  {
+    key_value_pair kv;
+    bool           update_parent = false;
+    index_type     index         = Insert(key_str, kv, update_parent, args...);
+
+    // Depending on whether the underlying stack is caching or not, we write to it or defer writing
+    // to it by scheduling updates until the next flush
+    if ((kv.parent != index_type(-1)) && (update_parent))
+    {
+      if (stack_.DirectWrite())
+      {
+        UpdateParents(kv.parent, index, kv);
+      }
+      else
+      {
+        schedule_update_[index] = kv;
+      }
+    }
+  }
+
+  /**
+   * Add a batch of keys in a single pass. All the leaves are inserted or patched first and
+   * afterwards every internal node on the path to one of them is rehashed exactly once, deepest
+   * first. The resulting trie (and hash) is identical to calling Set for each entry in turn.
+   *
+   * The batch should be sorted by key, so that consecutive insertions walk the same part of the
+   * trie. When a key appears more than once the last entry wins.
+   *
+   * @param: batch The entries to be written
+   */
+  void SetBatch(Batch const &batch)
+  {
+    if (batch.empty())
+    {
+      return;
+    }
+
+    std::vector<index_type> leaves;
+    leaves.reserve(batch.size());
+
+    for (auto const &entry : batch)
+    {
+      key_value_pair kv;
+      bool           update_parent = false;
+      index_type     index         = Insert(entry.key, kv, update_parent, entry.value, entry.data);
+
+      if ((kv.parent != index_type(-1)) && (update_parent))
+      {
+        leaves.push_back(index);
+      }
+    }
+
+    // collect the internal nodes which sit above the modified leaves
+    std::unordered_set<index_type> dirty;
+    key_value_pair                 node;
+    for (auto const &leaf : leaves)
+    {
+      stack_.Get(leaf, node);
+
+      index_type pid = node.parent;
+      while ((pid != index_type(-1)) && dirty.insert(pid).second)
+      {
+        stack_.Get(pid, node);
+        pid = node.parent;
+      }
+    }
+
+    if (!dirty.empty())
+    {
+      RehashSubtree(root_, node, dirty);
+    }
+  }
+
+private:
+  /**
+   * Insert or overwrite the leaf for a key without updating the hashes of its parents
+   *
+   * @param: key_str The key
+   * @param: kv Set to the leaf which has been written
+   * @param: update_parent Set to true if the parents of the leaf need rehashing
+   * @param: args The associated information with the key
+   *
+   * @return: the index of the leaf on the stack
+   */
+  template <typename... Args>
+  index_type Insert(byte_array::ConstByteArray const &key_str, key_value_pair &kv,
+                    bool &update_parent, Args const &... args)
   {
     key_type       key(key_str);
     bool           split;
     int            pos;
-    key_value_pair kv;
     int            left_right;
 
     index_type depth;
     index_type index = FindNearest(key, kv, split, pos, left_right, depth);
 
-    bool update_parent = false;
+    update_parent = false;
 
     // Case where the 'nearest' is the root of the tree
     if (index == index_type(-1))
@@ -376,6 +497,7 @@ public:
       update_parent = kv.UpdateLeaf(args...);
 
       index = stack_.Push(kv);
+      AddToFilter(key_str);
     }
     // Case where the nearest node is not a leaf, in that case the tree must be rearranged at that
     // split
@@ -385,6 +507,8 @@ public:
       index_type     rid = 0, lid = 0, pid = 0, cid = 0;
       bool           update_root = (index == root_);
 
+      AddToFilter(key_str);
+
       switch (left_right)
       {
       case -1:
@@ -466,21 +590,36 @@ public:
       stack_.Set(uint64_t(index), kv);
     }
 
-    // Depending on whether the underlying stack is caching or not, we write to it or defer writing
-    // to it by scheduling updates until the next flush
-    if ((kv.parent != index_type(-1)) && (update_parent))
+    return index;
+  }
+
+  /**
+   * Recompute the hashes of the dirty nodes in a subtree, children before parents
+   *
+   * @param: index Address on the stack of the subtree root
+   * @param: node Set to the (updated) subtree root
+   * @param: dirty The set of internal nodes that need rehashing
+   */
+  void RehashSubtree(index_type index, key_value_pair &node,
+                     std::unordered_set<index_type> const &dirty)
+  {
+    stack_.Get(index, node);
+
+    if (node.is_leaf() || (dirty.find(index) == dirty.end()))
     {
-      if (stack_.DirectWrite())
-      {
-        UpdateParents(kv.parent, index, kv);
-      }
-      else
-      {
-        schedule_update_[index] = kv;
-      }
+      return;
     }
+
+    key_value_pair left, right;
+    RehashSubtree(node.left, left, dirty);
+    RehashSubtree(node.right, right, dirty);
+
+    node.UpdateNode(left, right);
+    stack_.Set(index, node);
   }
 
+public:
+
   byte_array::ByteArray Hash()
   {
     stack_.Flush();
@@ -506,6 +645,11 @@ public:
   void Flush(bool lazy = true)
   {
     stack_.Flush(lazy);
+
+    if (!lazy)
+    {
+      SaveFilter();
+    }
   }
 
   bool is_open() const
@@ -520,6 +664,7 @@ public:
 
   void Close()
   {
+    SaveFilter();
     stack_.Close();
   }
 
@@ -527,14 +672,38 @@ public:
   using bookmark_type = uint64_t;
   bookmark_type Commit()
   {
+    SaveFilter();
     return stack_.Commit();
   }
 
   bookmark_type Commit(bookmark_type const &b)
   {
+    SaveFilter();
     return stack_.Commit(b);
   }
 
+  /**
+   * Check the bloom filter for a key, rebuilding the filter first if required
+   *
+   * @param: key_str The key
+   *
+   * @return: false if the key is definitely not in the index, otherwise true
+   */
+  bool MayContain(byte_array::ConstByteArray const &key_str)
+  {
+    if (!filter_valid_)
+    {
+      RebuildFilter();
+    }
+
+    return filter_.MayContain(key_str);
+  }
+
+  BlockedBloomFilter const &filter() const
+  {
+    return filter_;
+  }
+
   void Revert(bookmark_type const &b)
   {
     stack_.Revert(b);
@@ -628,6 +797,10 @@ public:
 
   self_type::Iterator Find(byte_array::ConstByteArray const &key_str)
   {
+    if (!MayContain(key_str))
+    {
+      return end();
+    }
 
     key_type       key(key_str);
     bool           split      = true;
@@ -678,6 +851,99 @@ private:
   uint64_t                                     root_ = 0;
   std::unordered_map<uint64_t, key_value_pair> schedule_update_;
 
+  std::string        filter_path_;
+  BlockedBloomFilter filter_;
+  bool               filter_valid_ = false;  ///< The filter covers every key in the index
+  bool               filter_dirty_ = false;  ///< The filter has changed since it was saved
+
+  static std::string FilterPath(std::string const &filename)
+  {
+    return filename + ".bloom";
+  }
+
+  /**
+   * The hash of the root node identifies the set of keys in the index, so it is used to tag the
+   * persisted filter
+   */
+  byte_array::ConstByteArray RootHash()
+  {
+    if (stack_.empty())
+    {
+      return {};
+    }
+
+    key_value_pair kv;
+    stack_.Get(root_, kv);
+
+    return kv.Hash();
+  }
+
+  /**
+   * Record a newly created key in the filter. Once the filter holds more keys than it was sized
+   * for it is discarded and rebuilt at twice the size on the next lookup.
+   */
+  void AddToFilter(byte_array::ConstByteArray const &key_str)
+  {
+    if (!filter_valid_)
+    {
+      return;
+    }
+
+    filter_.Add(key_str);
+    filter_dirty_ = true;
+
+    if (filter_.saturated())
+    {
+      filter_valid_ = false;
+    }
+  }
+
+  /**
+   * Repopulate the filter with the key of every leaf on the stack. The stack is scanned in order
+   * rather than walking the trie, which keeps the reads sequential.
+   */
+  void RebuildFilter()
+  {
+    // a trie with n leaves has n - 1 internal nodes
+    std::size_t const leaves = (stack_.size() + 1) / 2;
+    filter_.Reset(2 * leaves);
+
+    key_value_pair kv;
+    for (std::size_t i = 0, end = stack_.size(); i < end; ++i)
+    {
+      stack_.Get(i, kv);
+      if (kv.is_leaf())
+      {
+        filter_.Add(kv.key.ToByteArray());
+      }
+    }
+
+    filter_valid_ = true;
+    filter_dirty_ = true;
+  }
+
+  void SaveFilter()
+  {
+    if (!filter_dirty_ || filter_path_.empty() || !stack_.is_open())
+    {
+      return;
+    }
+
+    // a filter that outgrew its capacity is still rebuilt, as new keys were added since the load
+    if (!filter_valid_)
+    {
+      RebuildFilter();
+    }
+
+    // bring the hashes of the internal nodes (and so the tag) up to date
+    BeforeFlushHandler();
+
+    if (filter_.Save(filter_path_, RootHash()))
+    {
+      filter_dirty_ = false;
+    }
+  }
+
   /**
    * Update the parents of a changed node, since this changes the merkle tree
    *
@@ -726,6 +992,19 @@ private:
    *
    * @return: the index which this kv can be found in the stack
    */
+  /**
+   * Forward a prefetch hint for a node to the underlying stack, if the stack supports one
+   */
+  template <typename S>
+  static auto PrefetchNode(S &stack, index_type i, int) -> decltype(stack.Prefetch(i), void())
+  {
+    stack.Prefetch(i);
+  }
+
+  template <typename S>
+  static void PrefetchNode(S & /*stack*/, index_type /*i*/, long)
+  {}
+
   index_type FindNearest(key_type const &key, key_value_pair &kv, bool &split, int &pos,
                          int &left_right, uint64_t &depth,
                          uint64_t max_bits = std::numeric_limits<uint64_t>::max())
@@ -747,6 +1026,10 @@ private:
 
       stack_.Get(next, kv);
 
+      // start pulling in both children while the key is being compared
+      PrefetchNode(stack_, kv.left, 0);
+      PrefetchNode(stack_, kv.right, 0);
+
       left_right = key.Compare(kv.key, pos, kv.split >> 6, kv.split & 63);
 
       switch (left_right)
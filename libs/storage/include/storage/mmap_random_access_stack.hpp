@@ -32,15 +32,10 @@
 #include <string>
 
 #include "core/assert.hpp"
+#include "storage/random_access_stack.hpp"  // needed for platform::LITTLE_ENDIAN_MAGIC
 #include "storage/storage_exception.hpp"
 
 namespace fetch {
-namespace platform {
-enum
-{
-  LITTLE_ENDIAN_MAGIC = 2337
-};
-}
 namespace storage {
 
 /**
@@ -60,7 +55,8 @@ template <typename T, typename D = uint64_t, unsigned long MAX = 256>
 class MMapRandomAccessStack
 {
 private:
-  static constexpr char const *LOGGING_NAME = "MMapRandomAccessStack";
+  static constexpr char const *LOGGING_NAME         = "MMapRandomAccessStack";
+  static constexpr std::size_t SEQUENTIAL_THRESHOLD = 2;
 
 /**
  * Header holding information for the structure. Magic is used to determine the endianness of the
@@ -98,10 +94,7 @@ public:
   using type               = T;
   using event_handler_type = std::function<void()>;
 
-  MMapRandomAccessStack()
-  {
-    throw std::runtime_error("This class hasn't been fully tested for production code");
-  }
+  MMapRandomAccessStack() = default;
 
   // Enable constructor for unit tests
   MMapRandomAccessStack(const char *is_testing)
@@ -482,6 +475,48 @@ public:
     return bool(file_handle_) && (file_handle_.is_open());
   }
 
+  /**
+   * Set the options applied to the mapping of the data file. Applied immediately to the current
+   * mapping and to every subsequent one.
+   *
+   * @param: options The mapping options
+   */
+  void SetMappingOptions(MmapOptions const &options)
+  {
+    options_ = options;
+    if (mapped_data_.is_mapped())
+    {
+      ApplyMappingOptions();
+    }
+  }
+
+  MmapOptions const &mapping_options() const
+  {
+    return options_;
+  }
+
+  /**
+   * The access pattern observed over the most recent remappings of the data file
+   */
+  MmapAccessPattern access_pattern() const
+  {
+    return access_pattern_;
+  }
+
+  /**
+   * Hint that the object at index i is about to be read. Only objects inside the current mapping
+   * are prefetched, a hint never moves the mapping.
+   *
+   * @param: i The Ith object, indexed from 0
+   */
+  void Prefetch(std::size_t i)
+  {
+    if (IsMapped(i))
+    {
+      PrefetchMemory(mapped_data_.data() + ((i - mapped_index_) * sizeof(type)));
+    }
+  }
+
 private:
   /**
    * Check if file is mapped at specific index.
@@ -504,6 +539,8 @@ private:
    */
   void MapIndex(std::size_t const &i)
   {
+    UpdateAccessPattern(i - (i % MAX));
+
     mapped_data_.unmap();
     mapped_index_         = i - (i % MAX);
     size_t mapping_start  = (mapped_index_ * sizeof(type)) + header_->size();
@@ -518,6 +555,50 @@ private:
     {
       throw StorageException(" Could not map file");
     }
+
+    ApplyMappingOptions();
+  }
+
+  /**
+   * Classify the access pattern from the sequence of mapped windows. Walking consecutive windows
+   * switches the mapping to sequential read ahead, anything else is treated as random access.
+   *
+   * @param: window The first index of the window about to be mapped
+   */
+  void UpdateAccessPattern(std::size_t window)
+  {
+    if (mapped_data_.is_mapped() && (window == mapped_index_ + MAX))
+    {
+      ++sequential_maps_;
+    }
+    else
+    {
+      sequential_maps_ = 0;
+    }
+
+    access_pattern_ = (sequential_maps_ >= SEQUENTIAL_THRESHOLD) ? MmapAccessPattern::SEQUENTIAL
+                                                                 : MmapAccessPattern::RANDOM;
+  }
+
+  void ApplyMappingOptions()
+  {
+    std::size_t const length = sizeof(type) * MAX;
+    char *const       data   = mapped_data_.data();
+
+    if (options_.huge_pages)
+    {
+      EnableHugePages(data, length);
+    }
+
+    if (options_.adaptive)
+    {
+      AdviseMmap(data, length, access_pattern_);
+    }
+
+    if (options_.populate)
+    {
+      PrefaultMmap(data, length);
+    }
   }
 
   size_t GetFileLength()
@@ -591,9 +672,12 @@ private:
   mio::mmap_sink     mapped_data_;    // This map handles read/write objects from/to file
   mio::mmap_sink     mapped_header_;  // This map handles header part in the file
   std::fstream       file_handle_;
-  std::string        filename_ = "";
+  std::string        filename_       = "";
   Header *           header_;
-  std::size_t        mapped_index_ = 0;  // It holds the mapped index value
+  std::size_t        mapped_index_   = 0;  // It holds the mapped index value
+  MmapOptions        options_;
+  MmapAccessPattern  access_pattern_  = MmapAccessPattern::NORMAL;
+  std::size_t        sequential_maps_ = 0;  // Number of consecutive windows mapped in order
 };
 }  // namespace storage
 }  // namespace fetch
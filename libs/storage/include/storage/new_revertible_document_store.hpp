@@ -17,20 +17,58 @@
 //
 //------------------------------------------------------------------------------
 
+#include "core/mutex.hpp"
+#include "metrics/storage_metrics.hpp"
 #include "storage/document_store.hpp"
 #include "storage/new_versioned_random_access_stack.hpp"
+#include "storage/state_snapshot.hpp"
+#include "storage/write_ahead_log.hpp"
 
+#include <atomic>
+#include <functional>
+#include <map>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace fetch {
 namespace storage {
 
+/**
+ * Revertible document store used to hold the state database.
+ *
+ * Writes are buffered in memory until the next commit. On commit they are applied to the
+ * underlying stacks in key order and appended, as a single group, to a write ahead log which is
+ * synced to disk once. The random access stacks themselves are only synced to disk periodically
+ * (checkpoints) on a background thread, after which older log segments are discarded. On load
+ * any groups which did not make it into the stacks are replayed from the log.
+ *
+ * When a finality depth is configured, the history of commits older than that depth is
+ * periodically compacted away on a background thread, after which they can no longer be
+ * reverted to.
+ *
+ * When forks are enabled the store can also execute on a fork of either the last commit or its
+ * parent, without modifying the stacks. The writes made on the fork are held aside and can later
+ * be applied on top of the state the fork was made from, once the store has been reverted to it.
+ * Reads of the parent state are served from the previous values of the documents changed by the
+ * last commit, which are only recorded while forks are enabled.
+ */
 class NewRevertibleDocumentStore
 {
 public:
   using Hash           = byte_array::ConstByteArray;
   using ByteArray      = byte_array::ConstByteArray;
   using UnderlyingType = storage::Document;
+  using Filter         = std::function<bool(ResourceID const &)>;
+
+  static constexpr std::size_t CHECKPOINT_INTERVAL = 32;   ///< Commits between stack syncs
+  static constexpr std::size_t COMPACTION_INTERVAL = 256;  ///< Commits between compactions
+  static constexpr std::size_t MIN_FINALITY_DEPTH  = 2 * CHECKPOINT_INTERVAL;
+
+  NewRevertibleDocumentStore()                                  = default;
+  NewRevertibleDocumentStore(NewRevertibleDocumentStore const &) = delete;
+  NewRevertibleDocumentStore(NewRevertibleDocumentStore &&)      = delete;
+  ~NewRevertibleDocumentStore();
 
   bool New(std::string const &state, std::string const &state_history, std::string const &index,
            std::string const &index_history, bool create_if_not_exist);
@@ -46,9 +84,43 @@ public:
   Hash CurrentHash();
   bool HashExists(Hash const &hash);
 
-  std::size_t size() const;
+  std::size_t size();
+
+  /// @name Snapshots
+  /// @{
+  bool CreateSnapshot(Hash const &hash, std::size_t entries_per_chunk, StateSnapshot &snapshot,
+                      Filter const &filter = Filter{});
+  bool BeginSnapshotRestore(StateSnapshotManifest const &manifest);
+  bool RestoreSnapshotChunk(StateSnapshotChunk const &chunk);
+  bool CompleteSnapshotRestore();
+  bool MergeSnapshotChunk(StateSnapshotChunk const &chunk);
+  /// @}
+
+  /// @name Compaction
+  /// @{
+  void        SetFinalityDepth(std::size_t depth);
+  std::size_t finality_depth();
+  std::size_t Compact();
+  /// @}
+
+  /// @name Forks
+  /// @{
+  void EnableForks(bool enable = true);
+  bool BeginFork(Hash const &base);
+  bool EndFork();
+  bool ApplyFork(Hash const &base);
+  void DiscardFork();
+  /// @}
+
+  NewRevertibleDocumentStore &operator=(NewRevertibleDocumentStore const &) = delete;
+  NewRevertibleDocumentStore &operator=(NewRevertibleDocumentStore &&) = delete;
 
 private:
+  using PendingWrites = std::map<ByteArray, ByteArray>;       ///< resource id to value
+  using UndoRecord    = std::map<ByteArray, UnderlyingType>;  ///< resource id to previous doc
+  using CreatedKeys   = std::vector<ByteArray>;               ///< resource ids, in creation order
+  using FileList      = std::vector<std::string>;
+
   using Storage = storage::DocumentStore<
       2048,                 // block size
       FileBlockType<2048>,  // file block type
@@ -56,11 +128,68 @@ private:
                                                                                      // index
       NewVersionedRandomAccessStack<FileBlockType<2048>>>;                           // File store
 
+  void     ApplyPendingWrites();
+  void     ResetUndo(Hash const &head);
+  void     ClearStorage();
+  void     OpenLog(bool replay);
+  void     ReplayLog(std::string const &filename);
+  void     StartCheckpoint();
+  void     WaitForCheckpoint();
+  void     Checkpoint();
+  FileList StorageFiles() const;
+
+  void        StartCompaction();
+  void        WaitForCompaction();
+  std::size_t RunCompaction(std::size_t depth);
+
+  UnderlyingType GetFromFork(ResourceID const &rid, bool create);
+
   std::string state_path_;
   std::string state_history_path_;
   std::string index_path_;
   std::string index_history_path_;
   Storage     storage_;
+
+  metrics::DocumentStoreMetrics *metrics_{nullptr};  ///< The commit / revert instruments
+
+  mutex::Mutex           lock_{__LINE__, __FILE__};
+  PendingWrites          pending_;   ///< Writes not yet applied to the storage
+  WriteAheadLog::Records unlogged_;  ///< Writes applied to the storage but not yet logged
+  WriteAheadLog          log_;
+  std::string            log_path_;
+  std::size_t            commits_since_checkpoint_{0};
+  std::thread            checkpoint_thread_;
+  std::atomic<bool>      checkpoint_active_{false};
+
+  /// @name Compaction
+  /// @{
+  std::size_t       finality_depth_{0};  ///< Zero disables compaction
+  std::size_t       commits_since_compaction_{0};
+  std::thread       compaction_thread_;
+  std::atomic<bool> compaction_active_{false};
+  /// @}
+
+  /// @name Forks
+  /// @{
+  bool          forks_enabled_{false};
+  Hash          head_hash_{};    ///< The hash of the last commit (or revert)
+  Hash          parent_hash_{};  ///< The hash of the commit before the last one (if undo recorded)
+  UndoRecord    undo_;           ///< Previous docs of the writes applied since the last commit
+  UndoRecord    head_undo_;      ///< Previous docs of the writes of the last commit
+  bool          fork_active_{false};
+  Hash          fork_base_{};     ///< The hash of the state the fork was made from
+  PendingWrites fork_writes_;     ///< The writes made on the fork
+  CreatedKeys   fork_created_{};  ///< The documents created (but not written) on the fork
+  /// @}
+
+  /// @name Snapshot Restore
+  /// @{
+  bool                  restore_active_{false};
+  StateSnapshotManifest restore_manifest_;
+  uint64_t              restore_next_chunk_{0};
+  uint64_t              restore_entries_{0};
+  crypto::SHA256        restore_hasher_;
+  /// @}
 };
 
 }  // namespace storage
@@ -41,10 +41,14 @@
 #include "storage/random_access_stack.hpp"
 #include "storage/storage_exception.hpp"
 #include "storage/variant_stack.hpp"
+#include "storage/write_ahead_log.hpp"
 
 #include "core/byte_array/encoders.hpp"
 
+#include <cstdio>
 #include <cstring>
+#include <string>
+#include <utility>
 
 namespace fetch {
 namespace storage {
@@ -267,6 +271,7 @@ public:
 
   ~NewVersionedRandomAccessStack()
   {
+    AbortCompaction();
     stack_.ClearEventHandlers();
   }
 
@@ -315,19 +320,27 @@ public:
   void Load(std::string const &filename, std::string const &history,
             bool const &create_if_not_exist = true)
   {
+    history_path_      = history;
+    hash_history_path_ = "hash_history_" + history;
+
     stack_.Load(filename, create_if_not_exist);
-    history_.Load(history, create_if_not_exist);
+    history_.Load(history_path_, create_if_not_exist);
 
-    hash_history_.Load("hash_history_" + history, create_if_not_exist);
+    hash_history_.Load(hash_history_path_, create_if_not_exist);
     internal_bookmark_index_ = stack_.header_extra().bookmark;
+    ++revision_;
   }
 
   void New(std::string const &filename, std::string const &history)
   {
+    history_path_      = history;
+    hash_history_path_ = "hash_history_" + history;
+
     stack_.New(filename);
-    history_.New(history);
-    hash_history_.New("hash_history_" + history);
+    history_.New(history_path_);
+    hash_history_.New(hash_history_path_);
     internal_bookmark_index_ = stack_.header_extra().bookmark;
+    ++revision_;
   }
 
   void Clear()
@@ -337,6 +350,7 @@ public:
     hash_history_.Clear();
 
     internal_bookmark_index_ = stack_.header_extra().bookmark;
+    ++revision_;
   }
 
   type Get(std::size_t const &i) const
@@ -351,6 +365,20 @@ public:
     stack_.Get(i, object);
   }
 
+  /**
+   * Read a run of elements, only available when the underlying stack supports bulk reads
+   *
+   * @param: i The index of the first element
+   * @param: elements The number of elements, updated with the number actually read
+   * @param: objects The buffer to be populated
+   */
+  template <typename U = stack_type>
+  auto GetBulk(std::size_t const &i, std::size_t &elements, type *objects)
+      -> decltype(std::declval<U &>().GetBulk(i, elements, objects), void())
+  {
+    stack_.GetBulk(i, elements, objects);
+  }
+
   void Set(std::size_t const &i, type const &object)
   {
     type old_data;
@@ -460,6 +488,9 @@ public:
   {
     bool bookmark_found = false;
 
+    // the history is rewritten by the revert, any compaction in progress is invalidated
+    ++revision_;
+
     while (!bookmark_found)
     {
       if (history_.empty())
@@ -520,10 +551,201 @@ public:
     return stack_.is_open();
   }
 
+  /// @name Compaction
+  /// The history of every change is kept so that any previous bookmark can be reverted to. Once
+  /// a bookmark is final this history is no longer required, compaction rewrites the history
+  /// keeping only the section needed to revert to the most recent bookmarks. It is split into
+  /// phases so that the bulk of the copying can happen without holding up users of the stack:
+  ///
+  /// - BeginCompaction determines the section of the history to be retained
+  /// - RunCompaction copies that section to a new file. It only touches files on disk and so can
+  ///   run concurrently with any other operation on the stack
+  /// - CompleteCompaction copies anything added to the history in the meantime and swaps the new
+  ///   files in. If the stack was reverted or reset since BeginCompaction, the compaction is
+  ///   abandoned
+  /// @{
+
+  /**
+   * Begin compacting the history. Only the most recent bookmarks can be reverted to once the
+   * compaction has completed.
+   *
+   * @param: finality_depth The number of most recent bookmarks to keep
+   * @return: true if compaction has begun, false if there is nothing to compact
+   */
+  bool BeginCompaction(uint64_t finality_depth)
+  {
+    AbortCompaction();
+
+    if ((finality_depth == 0) || (hash_history_.size() <= finality_depth))
+    {
+      return false;
+    }
+
+    // make sure all of the history is on disk before it is copied
+    history_.Flush(false);
+
+    // find the oldest bookmark to be retained
+    uint64_t      bookmarks = 0;
+    int64_t const begin     = history_.Walk([&bookmarks, finality_depth](uint64_t type) {
+      if (type == HistoryBookmark::value)
+      {
+        ++bookmarks;
+      }
+
+      return bookmarks < finality_depth;
+    });
+
+    if (bookmarks < finality_depth)
+    {
+      return false;
+    }
+
+    compaction_               = Compaction{};
+    compaction_.active        = true;
+    compaction_.revision      = revision_;
+    compaction_.history_begin = begin;
+    compaction_.history_end   = history_.end();
+    compaction_.hash_begin    = hash_history_.size() - finality_depth;
+    compaction_.source        = history_path_;
+    compaction_.target        = CompactionPath(history_path_);
+
+    return true;
+  }
+
+  /**
+   * Copy the retained section of the history to a new file
+   *
+   * @return: true if successful, otherwise false
+   */
+  bool RunCompaction()
+  {
+    if (!compaction_.active)
+    {
+      return false;
+    }
+
+    VariantStack compacted;
+    compacted.New(compaction_.target);
+
+    compaction_.copied =
+        compacted.AppendFrom(compaction_.source, compaction_.history_begin, compaction_.history_end);
+    compacted.Close();
+
+    return compaction_.copied;
+  }
+
+  /**
+   * Complete the compaction, replacing the history with the compacted version
+   *
+   * @return: The number of bookmarks dropped from the history
+   */
+  uint64_t CompleteCompaction()
+  {
+    if (!compaction_.active)
+    {
+      return 0;
+    }
+
+    compaction_.active = false;
+
+    std::string const hash_target = CompactionPath(hash_history_path_);
+
+    bool success = compaction_.copied && (compaction_.revision == revision_);
+
+    if (success)
+    {
+      // copy the history added since the compaction began
+      history_.Flush(false);
+
+      VariantStack compacted;
+      compacted.Load(compaction_.target, false);
+      success = compacted.AppendFrom(history_path_, compaction_.history_end, history_.end());
+      compacted.Close();
+    }
+
+    if (success)
+    {
+      RandomAccessStack<HistoryBookmark> hashes;
+      hashes.New(hash_target);
+
+      HistoryBookmark book;
+      for (uint64_t i = compaction_.hash_begin, end = hash_history_.size(); i < end; ++i)
+      {
+        hash_history_.Get(i, book);
+        hashes.Push(book);
+      }
+
+      hashes.Close();
+
+      success = WriteAheadLog::SyncFile(compaction_.target) && WriteAheadLog::SyncFile(hash_target);
+    }
+
+    if (!success)
+    {
+      std::remove(compaction_.target.c_str());
+      std::remove(hash_target.c_str());
+
+      return 0;
+    }
+
+    // swap in the compacted history
+    history_.Close();
+    hash_history_.Close();
+
+    if ((std::rename(compaction_.target.c_str(), history_path_.c_str()) != 0) ||
+        (std::rename(hash_target.c_str(), hash_history_path_.c_str()) != 0))
+    {
+      throw StorageException("Unable to replace history with the compacted version");
+    }
+
+    history_.Load(history_path_, false);
+    hash_history_.Load(hash_history_path_, false);
+
+    return compaction_.hash_begin;
+  }
+
+  /**
+   * Abandon any compaction in progress
+   */
+  void AbortCompaction()
+  {
+    if (compaction_.active)
+    {
+      compaction_.active = false;
+      std::remove(compaction_.target.c_str());
+    }
+  }
+
+  /// @}
+
 private:
+  /**
+   * The state of a compaction in progress
+   */
+  struct Compaction
+  {
+    bool        active{false};
+    bool        copied{false};
+    uint64_t    revision{0};
+    int64_t     history_begin{0};  ///< File offset of the oldest retained history object
+    int64_t     history_end{0};    ///< File offset of the end of the history when begun
+    uint64_t    hash_begin{0};     ///< Index of the oldest retained hash history entry
+    std::string source;
+    std::string target;
+  };
+
+  static std::string CompactionPath(std::string const &path)
+  {
+    return path + ".compact";
+  }
+
   VariantStack                       history_;
   RandomAccessStack<HistoryBookmark> hash_history_;
   uint64_t                           internal_bookmark_index_{0};
+  std::string                        history_path_;
+  std::string                        hash_history_path_;
+  uint64_t                           revision_{0};  ///< Incremented when the history is rewritten
+  Compaction                         compaction_;
 
   event_handler_type on_file_loaded_;
   event_handler_type on_before_flush_;
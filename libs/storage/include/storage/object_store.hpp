@@ -23,6 +23,15 @@
 #include "core/serializers/typed_byte_array_buffer.hpp"
 
 #include "storage/key_byte_array_store.hpp"
+#include "storage/read_only_document_store.hpp"
+#include "storage/storage_exception.hpp"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace fetch {
 namespace storage {
@@ -42,6 +51,15 @@ namespace storage {
  *
  * S is the document store's underlying block size
  *
+ * Recently written objects are also held in an immutable, versioned read view which is
+ * republished on every write. Reads served from the read view do not take the store lock, and
+ * a Snapshot pins a single version of it so that a consumer sees a consistent view of the store
+ * while writers continue.
+ *
+ * An existing store can also be opened read only with LoadReadOnly, for example on an archive
+ * node. The files are then memory mapped, reads never take the store lock and writes throw. The
+ * iteration functions are not available in this mode.
+ *
  */
 template <typename T, std::size_t S = 2048>
 class ObjectStore
@@ -52,9 +70,13 @@ public:
   using serializer_type = serializers::TypedByteArrayBuffer;
   using Callback        = std::function<void(type const &)>;
   class Iterator;
+  class Snapshot;
 
   static constexpr char const *LOGGING_NAME = "ObjectStore";
 
+  static constexpr std::size_t READ_VIEW_SHARDS           = 16;
+  static constexpr std::size_t DEFAULT_READ_VIEW_CAPACITY = 8192;  ///< Objects in the read view
+
   std::string id = "";
 
   /**
@@ -67,7 +89,10 @@ public:
   void New(std::string const &doc_file, std::string const &index_file,
            bool const & /*create*/ = true)
   {
+    std::lock_guard<mutex::Mutex> lock(mutex_);
     store_.New(doc_file, index_file);
+    read_only_.reset();
+    ResetReadView();
   }
 
   /**
@@ -77,7 +102,36 @@ public:
    */
   void Load(std::string const &doc_file, std::string const &index_file, bool const &create = true)
   {
+    std::lock_guard<mutex::Mutex> lock(mutex_);
     store_.Load(doc_file, index_file, create);
+    read_only_.reset();
+    ResetReadView();
+  }
+
+  /**
+   * Memory map the files of an existing object store, read only. The files must not be written
+   * by any other store while they are mapped.
+   *
+   * @param: doc_file The document file
+   * @param: index_file The index file
+   */
+  void LoadReadOnly(std::string const &doc_file, std::string const &index_file)
+  {
+    std::lock_guard<mutex::Mutex> lock(mutex_);
+
+    auto mapped = std::make_unique<ReadOnlyDocumentStore<S>>();
+    mapped->Load(doc_file, index_file);
+
+    read_only_ = std::move(mapped);
+    ResetReadView();
+  }
+
+  /**
+   * @return: true if the store was opened with LoadReadOnly, otherwise false
+   */
+  bool read_only() const
+  {
+    return static_cast<bool>(read_only_);
   }
 
   /**
@@ -90,6 +144,16 @@ public:
    */
   bool Get(ResourceID const &rid, type &object)
   {
+    if (read_only_)
+    {
+      return GetReadOnly(rid, object);
+    }
+
+    if (GetFromReadView(*CurrentReadView(), rid, object))
+    {
+      return true;
+    }
+
     std::lock_guard<mutex::Mutex> lock(mutex_);
     return LocklessGet(rid, object);
   }
@@ -103,10 +167,78 @@ public:
    */
   bool Has(ResourceID const &rid)
   {
+    if (read_only_)
+    {
+      return read_only_->Has(rid);
+    }
+
+    if (CurrentReadView()->Find(rid) != nullptr)
+    {
+      return true;
+    }
+
     std::lock_guard<mutex::Mutex> lock(mutex_);
     return LocklessHas(rid);
   }
 
+  /**
+   * Lookup an object in its serialized form. In read only mode this is, where possible, a view
+   * straight into the mapped file.
+   *
+   * @param: rid The key
+   * @param: data The serialized object to populate
+   *
+   * @return: whether the object was found
+   */
+  bool GetSerialized(ResourceID const &rid, byte_array::ConstByteArray &data)
+  {
+    if (read_only_)
+    {
+      return read_only_->Get(rid, data);
+    }
+
+    ReadViewPtr const    view  = CurrentReadView();
+    ReadViewEntry const *entry = view->Find(rid);
+    if (entry != nullptr)
+    {
+      data = entry->data;
+      return true;
+    }
+
+    std::lock_guard<mutex::Mutex> lock(mutex_);
+    Document doc = store_.Get(rid);
+    if (doc.failed)
+    {
+      return false;
+    }
+
+    data = doc.document;
+    return true;
+  }
+
+  /**
+   * Pin the current version of the store. Reads through the snapshot never observe objects
+   * written after it was taken.
+   *
+   * @return: The snapshot
+   */
+  Snapshot GetSnapshot()
+  {
+    return Snapshot{*this, CurrentReadView()};
+  }
+
+  /**
+   * Set the maximum number of recently written objects held in the read view
+   *
+   * @param: capacity The number of objects, zero disables the read view
+   */
+  void SetReadViewCapacity(std::size_t capacity)
+  {
+    std::lock_guard<mutex::Mutex> lock(mutex_);
+    read_view_capacity_ = capacity;
+    ResetReadView();
+  }
+
   /**
    * Put object into the store using the key
    *
@@ -146,6 +278,11 @@ public:
    */
   bool LocklessGet(ResourceID const &rid, type &object)
   {
+    if (read_only_)
+    {
+      return GetReadOnly(rid, object);
+    }
+
     // assert(object != nullptr);
     Document doc = store_.Get(rid);
     if (doc.failed)
@@ -172,6 +309,11 @@ public:
    */
   bool LocklessHas(ResourceID const &rid)
   {
+    if (read_only_)
+    {
+      return read_only_->Has(rid);
+    }
+
     Document doc = store_.Get(rid);
     return !doc.failed;
   }
@@ -187,10 +329,16 @@ public:
    */
   void LocklessSet(ResourceID const &rid, type const &object)
   {
+    if (read_only_)
+    {
+      throw StorageException("Unable to set an object in a read only object store");
+    }
+
     serializer_type ser;
-    ser << object;
+    ser.Append(object);
 
     store_.Set(rid, ser.data());  // temporarily disable disk writes
+    PublishToReadView(rid, ser.data());
 
     if (set_callback_)
     {
@@ -200,7 +348,7 @@ public:
 
   std::size_t size() const
   {
-    return store_.size();
+    return read_only_ ? read_only_->size() : store_.size();
   }
 
   void SetCallback(Callback cb)
@@ -211,7 +359,10 @@ public:
   void Flush(bool lazy = true)
   {
     std::lock_guard<mutex::Mutex> lock(mutex_);
-    store_.Flush(lazy);
+    if (!read_only_)
+    {
+      store_.Flush(lazy);
+    }
   }
 
   /**
@@ -263,6 +414,26 @@ public:
       return ret;
     }
 
+    /**
+     * Get the resource id of the current element
+     *
+     * @return: The resource id
+     */
+    ResourceID GetKey() const
+    {
+      return wrapped_iterator_.GetKey();
+    }
+
+    /**
+     * Get the current element in its serialized form, leaving it to the caller to deserialize
+     *
+     * @return: the serialized object
+     */
+    Document GetDocument() const
+    {
+      return *wrapped_iterator_;
+    }
+
   protected:
     typename KeyByteArrayStore<S>::Iterator wrapped_iterator_;
   };
@@ -302,11 +473,242 @@ public:
   }
 
 private:
+  /**
+   * A serialized object in the read view, along with the version of the store which wrote it
+   */
+  struct ReadViewEntry
+  {
+    uint64_t                   version{0};
+    byte_array::ConstByteArray data;
+  };
+
+  using ReadViewShard    = std::unordered_map<ResourceID, ReadViewEntry>;
+  using ReadViewShardPtr = std::shared_ptr<ReadViewShard const>;
+
+  /**
+   * An immutable version of the recently written objects. Publishing a new version only copies the
+   * shard which was written to.
+   */
+  struct ReadView
+  {
+    uint64_t                                       version{0};
+    std::array<ReadViewShardPtr, READ_VIEW_SHARDS> shards;
+
+    static std::size_t ShardIndex(ResourceID const &rid)
+    {
+      auto const id = rid.id();
+      return id[0] % READ_VIEW_SHARDS;
+    }
+
+    ReadViewEntry const *Find(ResourceID const &rid) const
+    {
+      auto const &shard = shards[ShardIndex(rid)];
+      if (!shard)
+      {
+        return nullptr;
+      }
+
+      auto const it = shard->find(rid);
+      return (it == shard->end()) ? nullptr : &it->second;
+    }
+  };
+
+  using ReadViewPtr = std::shared_ptr<ReadView const>;
+
+  /**
+   * Lookup and deserialize an object from the mapped files. Does not require the lock.
+   */
+  bool GetReadOnly(ResourceID const &rid, type &object)
+  {
+    byte_array::ConstByteArray data;
+    if (!read_only_->Get(rid, data))
+    {
+      return false;
+    }
+
+    serializer_type ser(data);
+    ser >> object;
+
+    return true;
+  }
+
+  ReadViewPtr CurrentReadView() const
+  {
+    return std::atomic_load(&read_view_);
+  }
+
+  static bool GetFromReadView(ReadView const &view, ResourceID const &rid, type &object)
+  {
+    ReadViewEntry const *entry = view.Find(rid);
+    if (entry == nullptr)
+    {
+      return false;
+    }
+
+    serializer_type ser(entry->data);
+    ser >> object;
+
+    return true;
+  }
+
+  /**
+   * Lookup an object which is not in a snapshot's read view, as long as it was not written after
+   * the snapshot was taken. Objects which have since aged out of the read view can not be
+   * distinguished and are returned.
+   */
+  bool GetAtVersion(ResourceID const &rid, uint64_t version, type &object)
+  {
+    std::lock_guard<mutex::Mutex> lock(mutex_);
+
+    ReadViewPtr const    current = CurrentReadView();
+    ReadViewEntry const *entry   = current->Find(rid);
+    if ((entry != nullptr) && (entry->version > version))
+    {
+      return false;
+    }
+
+    return LocklessGet(rid, object);
+  }
+
+  bool HasAtVersion(ResourceID const &rid, uint64_t version)
+  {
+    std::lock_guard<mutex::Mutex> lock(mutex_);
+
+    ReadViewPtr const    current = CurrentReadView();
+    ReadViewEntry const *entry   = current->Find(rid);
+    if ((entry != nullptr) && (entry->version > version))
+    {
+      return false;
+    }
+
+    return LocklessHas(rid);
+  }
+
+  /**
+   * Publish a new version of the read view containing the object. Requires the lock.
+   */
+  void PublishToReadView(ResourceID const &rid, byte_array::ConstByteArray const &data)
+  {
+    ++version_;
+
+    std::size_t const shard_capacity = read_view_capacity_ / READ_VIEW_SHARDS;
+    if (shard_capacity == 0)
+    {
+      return;
+    }
+
+    ReadViewPtr const current = CurrentReadView();
+    std::size_t const index   = ReadView::ShardIndex(rid);
+
+    auto shard = current->shards[index] ? std::make_shared<ReadViewShard>(*current->shards[index])
+                                        : std::make_shared<ReadViewShard>();
+
+    (*shard)[rid] = ReadViewEntry{version_, data};
+
+    // once full, age out the oldest half of the shard. These objects are served from disk
+    if (shard->size() > shard_capacity)
+    {
+      std::vector<uint64_t> versions;
+      versions.reserve(shard->size());
+      for (auto const &element : *shard)
+      {
+        versions.push_back(element.second.version);
+      }
+
+      auto const median = versions.begin() + static_cast<std::ptrdiff_t>(versions.size() / 2);
+      std::nth_element(versions.begin(), median, versions.end());
+
+      for (auto it = shard->begin(); it != shard->end();)
+      {
+        it = (it->second.version < *median) ? shard->erase(it) : std::next(it);
+      }
+    }
+
+    auto view           = std::make_shared<ReadView>(*current);
+    view->version       = version_;
+    view->shards[index] = std::move(shard);
+
+    std::atomic_store(&read_view_, ReadViewPtr{std::move(view)});
+  }
+
+  /**
+   * Discard the contents of the read view. Requires the lock.
+   */
+  void ResetReadView()
+  {
+    auto view     = std::make_shared<ReadView>();
+    view->version = version_;
+
+    std::atomic_store(&read_view_, ReadViewPtr{std::move(view)});
+  }
+
   mutex::Mutex         mutex_{__LINE__, __FILE__};
   KeyByteArrayStore<S> store_;
 
+  std::unique_ptr<ReadOnlyDocumentStore<S>> read_only_;  ///< Set when opened with LoadReadOnly
+
   Callback set_callback_;
+
+  uint64_t    version_{0};  ///< Incremented on every write
+  std::size_t read_view_capacity_{DEFAULT_READ_VIEW_CAPACITY};
+  ReadViewPtr read_view_{std::make_shared<ReadView>()};
+};
+
+/**
+ * A pinned, read only version of the object store
+ */
+template <typename T, std::size_t S>
+class ObjectStore<T, S>::Snapshot
+{
+public:
+  /**
+   * Lookup an object as of the pinned version. Recently written objects are served without taking
+   * the store lock.
+   *
+   * @param: rid The key
+   * @param: object The object to populate
+   *
+   * @return: true if the object was present at the pinned version, otherwise false
+   */
+  bool Get(ResourceID const &rid, type &object) const
+  {
+    return GetFromReadView(*view_, rid, object) || store_->GetAtVersion(rid, version(), object);
+  }
+
+  /**
+   * Check whether a key had been set at the pinned version
+   *
+   * @param: rid The key
+   *
+   * @return: true if the key was set, otherwise false
+   */
+  bool Has(ResourceID const &rid) const
+  {
+    return (view_->Find(rid) != nullptr) || store_->HasAtVersion(rid, version());
+  }
+
+  uint64_t version() const
+  {
+    return view_->version;
+  }
+
+private:
+  Snapshot(self_type &store, ReadViewPtr view)
+    : store_{&store}
+    , view_{std::move(view)}
+  {}
+
+  self_type * store_;
+  ReadViewPtr view_;
+
+  friend class ObjectStore<T, S>;
 };
 
+template <typename T, std::size_t S>
+constexpr std::size_t ObjectStore<T, S>::READ_VIEW_SHARDS;
+
+template <typename T, std::size_t S>
+constexpr std::size_t ObjectStore<T, S>::DEFAULT_READ_VIEW_CAPACITY;
+
 }  // namespace storage
 }  // namespace fetch
@@ -51,6 +51,7 @@ public:
   };
 
   using ElementList = std::vector<Element>;
+  using ResourceIDs = std::vector<ResourceID>;
 
   enum
   {
@@ -58,7 +59,9 @@ public:
     SET,
     SET_BULK,
     HAS,
-    GET_RECENT
+    GET_RECENT,
+    GET_BULK,
+    GET_MISSING
   };
 
   ObjectStoreProtocol(TransientObjectStore<T> *obj_store)
@@ -70,6 +73,8 @@ public:
     this->Expose(SET_BULK, this, &self_type::SetBulk);
     this->Expose(HAS, obj_store, &TransientObjectStore<T>::Has);
     this->Expose(GET_RECENT, obj_store, &TransientObjectStore<T>::GetRecent);
+    this->Expose(GET_BULK, this, &self_type::GetBulk);
+    this->Expose(GET_MISSING, this, &self_type::GetMissing);
   }
 
 private:
@@ -106,6 +111,53 @@ private:
     return ret;
   }
 
+  /**
+   * Lookup a batch of objects in a single call. Objects which are not present are omitted.
+   *
+   * @param: rids The resource ids to lookup
+   * @return: The elements found
+   */
+  ElementList GetBulk(ResourceIDs const &rids)
+  {
+    ElementList elements;
+    elements.reserve(rids.size());
+
+    for (auto const &rid : rids)
+    {
+      Element element;
+      if (obj_store_->Get(rid, element.value))
+      {
+        element.key = rid;
+        elements.push_back(std::move(element));
+
+        obj_store_->Confirm(rid);
+      }
+    }
+
+    return elements;
+  }
+
+  /**
+   * Check for the presence of a batch of objects in a single call
+   *
+   * @param: rids The resource ids to check
+   * @return: The resource ids which are not present
+   */
+  ResourceIDs GetMissing(ResourceIDs const &rids)
+  {
+    ResourceIDs missing;
+
+    for (auto const &rid : rids)
+    {
+      if (!obj_store_->Has(rid))
+      {
+        missing.push_back(rid);
+      }
+    }
+
+    return missing;
+  }
+
   TransientObjectStore<T> *obj_store_;
 };
 
@@ -31,6 +31,7 @@
 #include <string>
 
 #include "core/assert.hpp"
+#include "metrics/storage_metrics.hpp"
 #include "storage/storage_exception.hpp"
 
 namespace fetch {
@@ -170,6 +171,7 @@ public:
   {
 
     filename_    = filename;
+    metrics_     = &metrics::StorageMetrics::Instance().Stack(filename_);
     file_handle_ = STREAM(filename_, std::ios::in | std::ios::out | std::ios::binary);
 
     if (!file_handle_)
@@ -209,6 +211,7 @@ public:
   void New(std::string const &filename)
   {
     filename_ = filename;
+    metrics_  = &metrics::StorageMetrics::Instance().Stack(filename_);
     Clear();
     file_handle_ = STREAM(filename_, std::ios::in | std::ios::out | std::ios::binary);
 
@@ -232,6 +235,7 @@ public:
 
     file_handle_.seekg(n);
     file_handle_.read(reinterpret_cast<char *>(&object), sizeof(type));
+    RecordRead(sizeof(type));
   }
 
   /**
@@ -249,6 +253,7 @@ public:
 
     file_handle_.seekg(start, file_handle_.beg);
     file_handle_.write(reinterpret_cast<char const *>(&object), sizeof(type));
+    RecordWrite(sizeof(type));
   }
 
   /**
@@ -288,6 +293,7 @@ public:
     file_handle_.seekg(start, file_handle_.beg);
     file_handle_.write(reinterpret_cast<char const *>(objects),
                        std::streamsize(sizeof(type)) * std::streamsize(elements));
+    RecordWrite(sizeof(type) * elements);
 
     // Catch case where a set extends the underlying stack
     if ((i + elements) > header_.objects)
@@ -327,6 +333,7 @@ public:
     file_handle_.seekg(start, file_handle_.beg);
     file_handle_.read(reinterpret_cast<char *>(objects),
                       std::streamsize(sizeof(type)) * std::streamsize(elements));
+    RecordRead(sizeof(type) * elements);
   }
 
   void SetExtraHeader(header_extra_type const &he)
@@ -383,6 +390,7 @@ public:
     file_handle_.seekg(n, file_handle_.beg);
     type object;
     file_handle_.read(reinterpret_cast<char *>(&object), sizeof(type));
+    RecordRead(sizeof(type));
 
     return object;
   }
@@ -415,6 +423,9 @@ public:
     file_handle_.write(reinterpret_cast<char const *>(&b), sizeof(type));
     file_handle_.seekg(n2);
     file_handle_.write(reinterpret_cast<char const *>(&a), sizeof(type));
+
+    RecordRead(2 * sizeof(type));
+    RecordWrite(2 * sizeof(type));
   }
 
   std::size_t size() const
@@ -456,8 +467,16 @@ public:
     {
       SignalBeforeFlush();
     }
+
+    auto const started = metrics::LatencyHistogram::Clock::now();
+
     StoreHeader();
     file_handle_.flush();
+
+    if (metrics_)
+    {
+      metrics_->flush_latency.Record(metrics::LatencyHistogram::Clock::now() - started);
+    }
   }
 
   bool is_open() const
@@ -478,6 +497,7 @@ public:
 
     file_handle_.seekg(n, file_handle_.beg);
     file_handle_.write(reinterpret_cast<char const *>(&object), sizeof(type));
+    RecordWrite(sizeof(type));
     ++header_.objects;
 
     return ret;
@@ -495,6 +515,24 @@ private:
   std::string        filename_ = "";
   Header             header_;
 
+  metrics::StackMetrics *metrics_{nullptr};  ///< The instruments for this file
+
+  void RecordRead(std::size_t bytes) const
+  {
+    if (metrics_)
+    {
+      metrics_->RecordRead(bytes);
+    }
+  }
+
+  void RecordWrite(std::size_t bytes) const
+  {
+    if (metrics_)
+    {
+      metrics_->RecordWrite(bytes);
+    }
+  }
+
   /**
    * Write the header to disk. Not usually necessary since we can just refer to our local one
    *
@@ -0,0 +1,242 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/byte_array.hpp"
+#include "core/byte_array/const_byte_array.hpp"
+#include "core/logger.hpp"
+#include "storage/document_compression.hpp"
+#include "storage/file_object.hpp"
+#include "storage/key_value_index.hpp"
+#include "storage/read_only_mapped_stack.hpp"
+#include "storage/resource_mapper.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace fetch {
+namespace storage {
+
+/**
+ * A read only, memory mapped view of the files written by a KeyByteArrayStore (the document store
+ * backing the ObjectStore).
+ *
+ * Both the key index and the document blocks are mapped, so a lookup is a walk over the mapped
+ * trie followed by a read of the mapped document. Nothing is ever modified, which means that no
+ * lock is required and any number of threads can read concurrently. Documents which are stored
+ * uncompressed in a single block (the common case for transactions) are returned as views into the
+ * mapping without being copied.
+ *
+ * The files must not be written while they are mapped.
+ */
+template <std::size_t S = 2048>
+class ReadOnlyDocumentStore
+{
+public:
+  using ConstByteArray   = byte_array::ConstByteArray;
+  using block_type       = FileBlockType<S>;
+  using block_stack_type = ReadOnlyMappedStack<block_type>;
+  using file_object_type = FileObject<block_stack_type>;
+  using index_stack_type = ReadOnlyMappedStack<KeyValuePair<>, uint64_t>;
+  using index_type       = KeyValueIndex<KeyValuePair<>, index_stack_type>;
+
+  static constexpr char const *LOGGING_NAME = "ReadOnlyDocumentStore";
+
+  /**
+   * Map the files of an existing document store
+   *
+   * @param: doc_file The document file
+   * @param: index_file The index file
+   */
+  void Load(std::string const &doc_file, std::string const &index_file)
+  {
+    blocks_.Load(doc_file);
+    index_.Load(index_file);
+    compressor_.Load(doc_file + ".dict");
+
+    // bring the bloom filter up to date now, after this lookups never modify the index
+    index_.MayContain(ConstByteArray{});
+  }
+
+  void Close()
+  {
+    index_.Close();
+    blocks_.Close();
+  }
+
+  bool is_open() const
+  {
+    return blocks_.is_open();
+  }
+
+  /**
+   * Lookup a document
+   *
+   * @param: rid The key
+   * @param: document The document to be populated, a view into the mapping when possible
+   *
+   * @return: true if the document exists, otherwise false
+   */
+  bool Get(ResourceID const &rid, ConstByteArray &document)
+  {
+    uint64_t position{0};
+    if (!index_.GetIfExists(rid.id(), position))
+    {
+      return false;
+    }
+
+    return ReadDocument(position, document);
+  }
+
+  /**
+   * Check if a document exists
+   *
+   * @param: rid The key
+   *
+   * @return: true if the document exists, otherwise false
+   */
+  bool Has(ResourceID const &rid)
+  {
+    uint64_t position{0};
+    return index_.GetIfExists(rid.id(), position);
+  }
+
+  /**
+   * @return: The number of blocks in the document file
+   */
+  std::size_t size() const
+  {
+    return blocks_.size();
+  }
+
+private:
+  static constexpr std::size_t HEADER_SIZE = file_object_type::HEADER_SIZE;
+  static constexpr std::size_t BLOCK_BYTES = block_type::BYTES;
+  static constexpr std::size_t DATA_OFFSET = 2 * sizeof(uint64_t);  ///< after previous and next
+
+  static_assert(offsetof(block_type, data) == DATA_OFFSET, "Unexpected file block layout");
+
+  /**
+   * Read a document starting at the specified block
+   *
+   * @param: position The index of the first block of the document
+   * @param: document The document to be populated
+   *
+   * @return: true if successful, otherwise false
+   */
+  bool ReadDocument(uint64_t position, ConstByteArray &document) const
+  {
+    if (position >= blocks_.size())
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Document index out of bounds: ", position);
+      return false;
+    }
+
+    uint8_t const *block = blocks_.Address(position);
+
+    uint64_t length{0};
+    std::memcpy(&length, block + DATA_OFFSET + sizeof(uint64_t), sizeof(length));
+
+    auto const codec = static_cast<DocumentCodec>(length >> file_object_type::CODEC_SHIFT);
+    length &= (uint64_t{1} << file_object_type::CODEC_SHIFT) - 1;
+
+    if (length < HEADER_SIZE)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Corrupt document header at: ", position);
+      return false;
+    }
+
+    ConstByteArray contents;
+    if (length <= BLOCK_BYTES)
+    {
+      // the document is contiguous in the mapping
+      contents = blocks_.CreateView(block + DATA_OFFSET + HEADER_SIZE, length - HEADER_SIZE);
+    }
+    else if (!ReadChain(block, length, contents))
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Corrupt document block chain at: ", position);
+      return false;
+    }
+
+    document = (codec == DocumentCodec::NONE) ? contents : compressor_.Decompress(codec, contents);
+
+    return true;
+  }
+
+  /**
+   * Assemble a document which spans multiple blocks
+   *
+   * @param: block The first block of the document
+   * @param: length The length of the document including its header
+   * @param: contents The contents to be populated
+   *
+   * @return: true if successful, otherwise false
+   */
+  bool ReadChain(uint8_t const *block, uint64_t length, ConstByteArray &contents) const
+  {
+    byte_array::ByteArray buffer;
+    buffer.Resize(length - HEADER_SIZE);
+
+    uint64_t offset = HEADER_SIZE;  // the logical offset into the document
+    uint64_t output = 0;
+
+    for (;;)
+    {
+      uint64_t const start = offset % BLOCK_BYTES;
+      uint64_t const count = std::min<uint64_t>(BLOCK_BYTES - start, length - offset);
+
+      std::memcpy(buffer.pointer() + output, block + DATA_OFFSET + start, count);
+      offset += count;
+      output += count;
+
+      if (offset >= length)
+      {
+        break;
+      }
+
+      uint64_t next{0};
+      std::memcpy(&next, block + sizeof(uint64_t), sizeof(next));
+      if (next >= blocks_.size())
+      {
+        return false;
+      }
+
+      block = blocks_.Address(next);
+    }
+
+    contents = buffer;
+    return true;
+  }
+
+  block_stack_type   blocks_;
+  index_type         index_;
+  DocumentCompressor compressor_;
+};
+
+template <std::size_t S>
+constexpr std::size_t ReadOnlyDocumentStore<S>::HEADER_SIZE;
+template <std::size_t S>
+constexpr std::size_t ReadOnlyDocumentStore<S>::BLOCK_BYTES;
+template <std::size_t S>
+constexpr std::size_t ReadOnlyDocumentStore<S>::DATA_OFFSET;
+
+}  // namespace storage
+}  // namespace fetch
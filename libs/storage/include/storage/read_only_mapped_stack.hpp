@@ -0,0 +1,252 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "storage/fetch_mmap.hpp"
+#include "storage/random_access_stack.hpp"  // needed for platform::LITTLE_ENDIAN_MAGIC
+#include "storage/storage_exception.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <system_error>
+
+namespace fetch {
+namespace storage {
+
+/**
+ * A read only view of a file written by the RandomAccessStack. The whole file is mapped into
+ * memory once, so reads are plain memory accesses which never take a lock or make a system call,
+ * and any number of threads can read concurrently.
+ *
+ * Objects can be copied out (Get) or accessed in place (At). The mapping can also be shared as a
+ * ConstByteArray, allowing callers to hold views into the file which stay valid after the stack
+ * has been closed.
+ *
+ * All of the mutating operations of the stack interface throw, with the exception of those which
+ * leave the contents unchanged. This allows the stack to be plugged into the structures built on
+ * top of the RandomAccessStack (e.g. the KeyValueIndex) for read only use.
+ */
+template <typename T, typename D = uint64_t>
+class ReadOnlyMappedStack
+{
+public:
+  using header_extra_type  = D;
+  using type               = T;
+  using event_handler_type = std::function<void()>;
+
+  static constexpr char const *LOGGING_NAME = "ReadOnlyMappedStack";
+
+  static constexpr std::size_t HEADER_SIZE = sizeof(uint16_t) + sizeof(uint64_t) + sizeof(D);
+
+  void ClearEventHandlers()
+  {
+    on_file_loaded_ = nullptr;
+  }
+
+  void OnFileLoaded(event_handler_type const &f)
+  {
+    on_file_loaded_ = f;
+  }
+
+  void OnBeforeFlush(event_handler_type const & /*f*/)
+  {
+    // nothing is ever flushed
+  }
+
+  static constexpr bool DirectWrite()
+  {
+    return true;
+  }
+
+  /**
+   * Map an existing stack file
+   *
+   * @param: filename The path to the file
+   */
+  template <typename... Args>
+  void Load(std::string const &filename, Args &&... /*args*/)
+  {
+    Close();
+
+    std::error_code error;
+    auto mapping = std::make_shared<mio::mmap_source>(mio::make_mmap_source(filename, error));
+    if (error || (mapping->size() < HEADER_SIZE))
+    {
+      throw StorageException("Unable to map stack file: " + filename);
+    }
+
+    uint16_t magic{0};
+    std::memcpy(&magic, mapping->data(), sizeof(magic));
+    std::memcpy(&objects_, mapping->data() + sizeof(magic), sizeof(objects_));
+    std::memcpy(&extra_, mapping->data() + sizeof(magic) + sizeof(objects_), sizeof(D));
+
+    if (magic != platform::LITTLE_ENDIAN_MAGIC)
+    {
+      throw StorageException("Unexpected stack file magic: " + filename);
+    }
+
+    if (((mapping->size() - HEADER_SIZE) / sizeof(type)) < objects_)
+    {
+      throw StorageException("Expected more stack objects.");
+    }
+
+    // the stack is mostly accessed by lookups rather than scans
+    AdviseMmap(mapping->data(), mapping->size(), MmapAccessPattern::RANDOM);
+
+    filename_ = filename;
+    mapping_  = std::move(mapping);
+
+    if (on_file_loaded_)
+    {
+      on_file_loaded_();
+    }
+  }
+
+  template <typename... Args>
+  void New(std::string const & /*filename*/, Args &&... /*args*/)
+  {
+    throw StorageException("Unable to create a read only stack");
+  }
+
+  void Close(bool /*lazy*/ = false)
+  {
+    mapping_.reset();
+    objects_ = 0;
+    extra_   = D{};
+    filename_.clear();
+  }
+
+  /**
+   * Copy an object out of the mapping, not safe when i >= size()
+   *
+   * @param: i The index of the object
+   * @param: object The object to be populated
+   */
+  void Get(std::size_t const &i, type &object) const
+  {
+    std::memcpy(reinterpret_cast<uint8_t *>(&object), Address(i), sizeof(type));
+  }
+
+  /**
+   * Access an object in place, not safe when i >= size(). The mapping is not guaranteed to be
+   * suitably aligned for the type, so this is restricted to byte level access.
+   *
+   * @param: i The index of the object
+   *
+   * @return: The start of the object in the mapping
+   */
+  uint8_t const *Address(std::size_t const &i) const
+  {
+    assert(mapping_ && (i < objects_));
+    return reinterpret_cast<uint8_t const *>(mapping_->data()) + HEADER_SIZE + (i * sizeof(type));
+  }
+
+  /**
+   * Create a view of a region of the file which shares the ownership of the mapping
+   *
+   * @param: start The pointer to the start of the region, must be inside the mapping
+   * @param: length The length of the region in bytes
+   *
+   * @return: The view of the region
+   */
+  byte_array::ConstByteArray CreateView(uint8_t const *start, std::size_t length) const
+  {
+    assert(mapping_);
+
+    std::shared_ptr<uint8_t> region(mapping_, const_cast<uint8_t *>(start));
+
+    return byte_array::ConstByteArray{
+        byte_array::ConstByteArray::shared_array_type{std::move(region), length}};
+  }
+
+  void Set(std::size_t const & /*i*/, type const & /*object*/)
+  {
+    throw StorageException("Unable to write to a read only stack");
+  }
+
+  uint64_t Push(type const & /*object*/)
+  {
+    throw StorageException("Unable to write to a read only stack");
+  }
+
+  uint64_t LazyPush(type const & /*object*/)
+  {
+    throw StorageException("Unable to write to a read only stack");
+  }
+
+  /**
+   * Updating the header is permitted as long as it is unchanged, which is the case when the
+   * structures built on top of the stack flush without having been modified
+   *
+   * @param: he The header
+   */
+  void SetExtraHeader(header_extra_type const &he)
+  {
+    if (std::memcmp(&he, &extra_, sizeof(D)) != 0)
+    {
+      throw StorageException("Unable to write to a read only stack");
+    }
+  }
+
+  header_extra_type const &header_extra() const
+  {
+    return extra_;
+  }
+
+  void Flush(bool const & /*lazy*/ = false)
+  {}
+
+  std::size_t size() const
+  {
+    return objects_;
+  }
+
+  bool empty() const
+  {
+    return objects_ == 0;
+  }
+
+  bool is_open() const
+  {
+    return static_cast<bool>(mapping_);
+  }
+
+  std::string const &filename() const
+  {
+    return filename_;
+  }
+
+private:
+  using MappingPtr = std::shared_ptr<mio::mmap_source>;
+
+  event_handler_type on_file_loaded_;
+  std::string        filename_;
+  MappingPtr         mapping_;
+  uint64_t           objects_{0};
+  header_extra_type  extra_{};
+};
+
+template <typename T, typename D>
+constexpr std::size_t ReadOnlyMappedStack<T, D>::HEADER_SIZE;
+
+}  // namespace storage
+}  // namespace fetch
@@ -0,0 +1,138 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "crypto/sha256.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace fetch {
+namespace storage {
+
+/**
+ * A single chunk of a state snapshot, containing a contiguous (in key order) set of documents
+ */
+struct StateSnapshotChunk
+{
+  using ConstByteArray = byte_array::ConstByteArray;
+  using Entry          = std::pair<ConstByteArray, ConstByteArray>;  ///< resource id, document
+  using Entries        = std::vector<Entry>;
+
+  uint64_t       index{0};
+  Entries        entries;
+  ConstByteArray checksum;  ///< SHA256 over the entries of the chunk
+
+  ConstByteArray ComputeChecksum() const
+  {
+    crypto::SHA256 hasher;
+    hasher.Reset();
+
+    for (auto const &entry : entries)
+    {
+      uint64_t const value_size = entry.second.size();
+
+      hasher.Update(entry.first);
+      hasher.Update(reinterpret_cast<uint8_t const *>(&value_size), sizeof(value_size));
+      hasher.Update(entry.second);
+    }
+
+    return hasher.Final();
+  }
+
+  bool IsValid() const
+  {
+    return ComputeChecksum() == checksum;
+  }
+};
+
+/**
+ * Describes the contents of a state snapshot taken at a given commit
+ */
+struct StateSnapshotManifest
+{
+  using ConstByteArray = byte_array::ConstByteArray;
+
+  ConstByteArray state_hash;  ///< The commit hash of the state
+  uint64_t       num_entries{0};
+  uint64_t       num_chunks{0};
+  ConstByteArray checksum;  ///< SHA256 over the checksums of all the chunks, in order
+
+  bool empty() const
+  {
+    return num_chunks == 0;
+  }
+};
+
+/**
+ * Complete state snapshot
+ */
+struct StateSnapshot
+{
+  StateSnapshotManifest           manifest;
+  std::vector<StateSnapshotChunk> chunks;
+};
+
+template <typename T>
+void Serialize(T &serializer, StateSnapshotChunk const &chunk)
+{
+  serializer << chunk.index << static_cast<uint64_t>(chunk.entries.size());
+
+  for (auto const &entry : chunk.entries)
+  {
+    serializer << entry.first << entry.second;
+  }
+
+  serializer << chunk.checksum;
+}
+
+template <typename T>
+void Deserialize(T &serializer, StateSnapshotChunk &chunk)
+{
+  uint64_t num_entries = 0;
+  serializer >> chunk.index >> num_entries;
+
+  chunk.entries.clear();
+  for (uint64_t i = 0; i < num_entries; ++i)
+  {
+    StateSnapshotChunk::Entry entry;
+    serializer >> entry.first >> entry.second;
+    chunk.entries.push_back(std::move(entry));
+  }
+
+  serializer >> chunk.checksum;
+}
+
+template <typename T>
+void Serialize(T &serializer, StateSnapshotManifest const &manifest)
+{
+  serializer << manifest.state_hash << manifest.num_entries << manifest.num_chunks
+             << manifest.checksum;
+}
+
+template <typename T>
+void Deserialize(T &serializer, StateSnapshotManifest &manifest)
+{
+  serializer >> manifest.state_hash >> manifest.num_entries >> manifest.num_chunks >>
+      manifest.checksum;
+}
+
+}  // namespace storage
+}  // namespace fetch
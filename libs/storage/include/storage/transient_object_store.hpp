@@ -21,17 +21,23 @@
 #include "core/logger.hpp"
 #include "core/mutex.hpp"
 #include "core/runnable.hpp"
+#include "core/serializers/counter.hpp"
 #include "core/state_machine.hpp"
 #include "core/threading.hpp"
 #include "ledger/chain/transaction.hpp"
 #include "storage/object_store.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <exception>
 #include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace fetch {
@@ -52,9 +58,49 @@ public:
   using Archive      = ObjectStore<Object>;
   using TxSummaries  = std::vector<ledger::TransactionSummary>;
   using WeakRunnable = core::WeakRunnable;
+  using Verifier     = std::function<bool(ResourceID const &, Object const &)>;
+  using Filter       = std::function<bool(ResourceID const &)>;
+
+  /**
+   * The outcome of a scan of the archive
+   */
+  struct ArchiveReport
+  {
+    std::size_t             subtrees = 0;  ///< The number of subtrees the key space was split into
+    std::size_t             objects  = 0;  ///< The number of objects read from the archive
+    std::vector<ResourceID> corrupt;       ///< Objects which failed to decode or verify
+  };
+
+  /**
+   * Controls when confirmed objects are written back to the archive. A write cycle is started as
+   * soon as any one of the limits is reached.
+   */
+  struct FlushPolicy
+  {
+    std::size_t               batch_size      = 100;      ///< Objects written per cycle
+    std::size_t               max_dirty_bytes = 1 << 26;  ///< Confirmed but unwritten bytes
+    std::chrono::milliseconds max_dirty_age{0};           ///< Longest an object waits to be written
+  };
+
+  struct FlushStats
+  {
+    std::size_t queue_depth        = 0;  ///< Confirmed objects not yet picked up by the writer
+    std::size_t peak_queue_depth   = 0;  ///< The largest queue depth seen
+    std::size_t dirty_bytes        = 0;  ///< Serialized size of the confirmed, unwritten objects
+    std::size_t cached_objects     = 0;  ///< Objects held in memory, confirmed or not
+    std::size_t recent_queue_depth = 0;  ///< Summaries waiting to be polled with GetRecent
+    uint64_t    objects_written    = 0;  ///< Objects written to the archive
+    uint64_t    write_cycles       = 0;  ///< Batches written to the archive
+  };
 
   static constexpr char const *LOGGING_NAME = "TransientObjectStore";
 
+  /// Each thread is handed several subtrees, so that an unbalanced key space keeps them all busy
+  static constexpr std::size_t SUBTREES_PER_THREAD = 4;
+  /// The key space is split further for large archives to bound the memory held per subtree
+  static constexpr std::size_t MAX_SUBTREE_OBJECTS = 4096;
+  static constexpr uint64_t    MAX_SUBTREE_BITS    = 16;
+
   TransientObjectStore();
   TransientObjectStore(TransientObjectStore const &) = delete;
   TransientObjectStore(TransientObjectStore &&)      = delete;
@@ -62,6 +108,17 @@ public:
   void New(std::string const &doc_file, std::string const &index_file, bool const &create = true);
   void Load(std::string const &doc_file, std::string const &index_file, bool const &create = true);
 
+  ArchiveReport VerifyArchive(std::size_t thread_count, Verifier const &verifier = Verifier{});
+  std::size_t   CopyTo(TransientObjectStore &target, Filter const &filter);
+  std::size_t   CopyCachedTo(TransientObjectStore &target, Filter const &filter);
+
+  /// @name Write Back
+  /// @{
+  void        SetFlushPolicy(FlushPolicy const &policy);
+  FlushPolicy flush_policy() const;
+  FlushStats  GetFlushStats() const;
+  /// @}
+
   /// @name Accessors
   /// @{
   bool        Get(ResourceID const &rid, Object &object);
@@ -95,12 +152,29 @@ private:
     Flushing
   };
 
+  using Clock     = std::chrono::steady_clock;
+  using Timestamp = Clock::time_point;
+
+  /**
+   * An object which has been confirmed and is waiting to be written to the archive
+   */
+  struct PendingWrite
+  {
+    ResourceID  rid;
+    std::size_t size = 0;  ///< The serialized size of the object
+    Timestamp   confirmed;
+  };
+
   using Mutex           = fetch::mutex::Mutex;
   using StateMachinePtr = std::shared_ptr<core::StateMachine<Phase>>;
-  using Queue           = fetch::core::MPMCQueue<ResourceID, 1 << 15>;
+  using Queue           = fetch::core::MPMCQueue<PendingWrite, 1 << 15>;
   using RecentQueue     = fetch::core::MPMCQueue<ledger::TransactionSummary, 1 << 15>;
   using Cache           = std::unordered_map<ResourceID, Object>;
   using Flag            = std::atomic<bool>;
+  using Counter         = std::atomic<std::size_t>;
+  using Batch           = std::vector<PendingWrite>;
+
+  static constexpr std::chrono::milliseconds IDLE_DELAY{1000};
 
   bool GetFromCache(ResourceID const &rid, Object &object);
   void SetInCache(ResourceID const &rid, Object const &object);
@@ -110,11 +184,18 @@ private:
   Phase OnWriting();
   Phase OnFlushing();
 
-  const std::size_t batch_size_ = 100;
+  bool IsBatchDue(FlushPolicy const &policy, Timestamp const &now) const;
+
+  mutable Mutex policy_mutex_{__LINE__, __FILE__};
+  FlushPolicy   policy_;
+  Batch         batch_;  ///< The objects being written in the current cycle
 
-  std::vector<ResourceID> rids;
-  std::size_t             extracted_count = 0;
-  std::size_t             written_count   = 0;
+  Counter               queue_depth_{0};
+  Counter               peak_queue_depth_{0};
+  Counter               dirty_bytes_{0};
+  Counter               recent_queue_depth_{0};
+  std::atomic<uint64_t> objects_written_{0};
+  std::atomic<uint64_t> write_cycles_{0};
 
   mutable Mutex   cache_mutex_{__LINE__, __FILE__};  ///< The mutex for the cache
   StateMachinePtr state_machine_;     ///< The state machine controlling the worker writing to disk
@@ -135,8 +216,7 @@ private:
  */
 template <typename O>
 inline TransientObjectStore<O>::TransientObjectStore()
-  : rids(batch_size_)
-  , state_machine_{
+  : state_machine_{
         std::make_shared<core::StateMachine<Phase>>("TransientObjectStore", Phase::Populating)}
 
 {
@@ -180,87 +260,119 @@ ledger::TxList TransientObjectStore<O>::PullSubtree(byte_array::ConstByteArray c
 template <typename O>
 constexpr core::Tickets::Count TransientObjectStore<O>::recent_queue_alarm_threshold;
 
+template <typename O>
+constexpr std::size_t TransientObjectStore<O>::SUBTREES_PER_THREAD;
+
+template <typename O>
+constexpr std::size_t TransientObjectStore<O>::MAX_SUBTREE_OBJECTS;
+
+template <typename O>
+constexpr uint64_t TransientObjectStore<O>::MAX_SUBTREE_BITS;
+
+template <typename O>
+constexpr std::chrono::milliseconds TransientObjectStore<O>::IDLE_DELAY;
+
+/**
+ * Determine if the objects extracted so far should be written, rather than waiting for more
+ *
+ * @tparam O The type of the object being stored
+ * @param policy The flush policy in effect
+ * @param now The current time
+ * @return true if a write cycle should be started, otherwise false
+ */
+template <typename O>
+bool TransientObjectStore<O>::IsBatchDue(FlushPolicy const &policy, Timestamp const &now) const
+{
+  if (batch_.empty())
+  {
+    return false;
+  }
+
+  return (batch_.size() >= policy.batch_size) || (dirty_bytes_ >= policy.max_dirty_bytes) ||
+         ((now - batch_.front().confirmed) >= policy.max_dirty_age);
+}
+
 // Populating: We are filling up our batch of objects from the queue that is being posted
 template <typename O>
 typename TransientObjectStore<O>::Phase TransientObjectStore<O>::OnPopulating()
 {
-  assert(extracted_count < batch_size_);
-
-  // ensure the write count is reset
-  written_count = 0;
+  FlushPolicy const policy = flush_policy();
 
+  PendingWrite pending;
   while (true)
   {
-    // attempt to extract an element in the confirmation queue
-    bool const extracted =
-        confirm_queue_.Pop(rids[extracted_count], std::chrono::milliseconds::zero());
+    // once over the dirty limit the cycle is extended to drain the whole queue in one pass
+    bool const is_buffer_full =
+        (batch_.size() >= policy.batch_size) && (dirty_bytes_ < policy.max_dirty_bytes);
 
-    // update the index if needed
-    if (extracted)
+    if (is_buffer_full || !confirm_queue_.Pop(pending, std::chrono::milliseconds::zero()))
     {
-      ++extracted_count;
+      break;
     }
 
-    bool const is_buffer_full = (extracted_count == batch_size_);
+    --queue_depth_;
+    batch_.push_back(std::move(pending));
+  }
 
-    if (is_buffer_full)
-    {
-      return Phase::Writing;
-    }
+  auto const now = Clock::now();
+  if (IsBatchDue(policy, now))
+  {
+    return Phase::Writing;
+  }
 
-    if (!extracted)
-    {
-      if (extracted_count > 0u)
-      {
-        // Nothing more in queue, but buffer not empty - write contents to disk
-        return Phase::Writing;
-      }
-      else
-      {
-        // Queue is empty and nothing to write - trigger delay and do not change FSM state
-        break;
-      }
-    }
+  if (batch_.empty())
+  {
+    // nothing to write - trigger delay and do not change FSM state
+    state_machine_->Delay(((policy.max_dirty_age.count() > 0) && (policy.max_dirty_age < IDLE_DELAY))
+                              ? policy.max_dirty_age
+                              : IDLE_DELAY);
   }
+  else
+  {
+    // partial batch, come back when its oldest object is due (or to top the batch up)
+    auto const remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                               policy.max_dirty_age - (now - batch_.front().confirmed)) +
+                           std::chrono::milliseconds{1};
 
-  state_machine_->Delay(std::chrono::milliseconds(1000u));
+    state_machine_->Delay(std::min(remaining, IDLE_DELAY));
+  }
 
   return Phase::Populating;
 }
 
-// Writing: We are extracting the items from the cache and writing them to disk
+// Writing: We are extracting the items from the cache and writing them to disk as a single batch
 template <typename O>
 typename TransientObjectStore<O>::Phase TransientObjectStore<O>::OnWriting()
 {
-  // check if we need to transition from this state
-  if (written_count >= extracted_count)
-  {
-    return Phase::Flushing;
-  }
-  else
-  {
-    O           obj;
-    auto const &rid = rids[written_count];
+  std::vector<O> objects(batch_.size());
 
+  {
     FETCH_LOCK(cache_mutex_);
 
-    // get the element from the cache
-    if (GetFromCache(rid, obj))
+    for (std::size_t i = 0; i < batch_.size(); ++i)
     {
-      // write out the object
-      archive_.Set(rid, obj);
-
-      ++written_count;
+      // get the element from the cache
+      if (!GetFromCache(batch_[i].rid, objects[i]))
+      {
+        // If this is the case then for some reason the RID that was added
+        // to the queue has been removed from the cache.
+        assert(false);
+      }
     }
-    else
+  }
+
+  // the objects stay in the cache until they have been written, so readers never see a gap
+  archive_.WithLock([this, &objects]() {
+    for (std::size_t i = 0; i < batch_.size(); ++i)
     {
-      // If this is the case then for some reason the RID that was added
-      // to the queue has been removed from the cache.
-      assert(false);
+      archive_.LocklessSet(batch_[i].rid, objects[i]);
     }
-  }
+  });
 
-  return Phase::Writing;
+  objects_written_ += batch_.size();
+  ++write_cycles_;
+
+  return Phase::Flushing;
 }
 
 // Flushing: In this phase we are removing the elements from the cache. This is important to
@@ -269,20 +381,73 @@ typename TransientObjectStore<O>::Phase TransientObjectStore<O>::OnWriting()
 template <typename O>
 typename TransientObjectStore<O>::Phase TransientObjectStore<O>::OnFlushing()
 {
-  FETCH_LOCK(cache_mutex_);
+  {
+    FETCH_LOCK(cache_mutex_);
 
-  assert(extracted_count <= batch_size_);
+    for (auto const &pending : batch_)
+    {
+      cache_.erase(pending.rid);
+    }
+  }
 
-  for (std::size_t i = 0; i < extracted_count; ++i)
+  for (auto const &pending : batch_)
   {
-    cache_.erase(rids[i]);
+    dirty_bytes_ -= pending.size;
   }
 
-  extracted_count = 0;
+  batch_.clear();
 
   return Phase::Populating;
 }
 
+/**
+ * Update the write back policy. The new limits apply from the next write cycle.
+ *
+ * @tparam O The type of the object being stored
+ * @param policy The new policy
+ */
+template <typename O>
+void TransientObjectStore<O>::SetFlushPolicy(FlushPolicy const &policy)
+{
+  FETCH_LOCK(policy_mutex_);
+
+  policy_            = policy;
+  policy_.batch_size = std::max<std::size_t>(policy_.batch_size, 1);
+}
+
+template <typename O>
+typename TransientObjectStore<O>::FlushPolicy TransientObjectStore<O>::flush_policy() const
+{
+  FETCH_LOCK(policy_mutex_);
+
+  return policy_;
+}
+
+/**
+ * Get a snapshot of the write back queue, for monitoring
+ *
+ * @tparam O The type of the object being stored
+ * @return The current statistics
+ */
+template <typename O>
+typename TransientObjectStore<O>::FlushStats TransientObjectStore<O>::GetFlushStats() const
+{
+  FlushStats stats;
+  stats.queue_depth        = queue_depth_;
+  stats.peak_queue_depth   = peak_queue_depth_;
+  stats.dirty_bytes        = dirty_bytes_;
+  stats.recent_queue_depth = recent_queue_depth_;
+  stats.objects_written    = objects_written_;
+  stats.write_cycles       = write_cycles_;
+
+  {
+    FETCH_LOCK(cache_mutex_);
+    stats.cached_objects = cache_.size();
+  }
+
+  return stats;
+}
+
 template <typename O>
 core::WeakRunnable TransientObjectStore<O>::getWeakRunnable() const
 {
@@ -319,6 +484,223 @@ void TransientObjectStore<O>::Load(std::string const &doc_file, std::string cons
   archive_.Load(doc_file, index_file, create);
 }
 
+/**
+ * Scan the whole of the archive, decoding (and optionally verifying) every object on several
+ * threads. The key space is split into subtrees which the threads claim one at a time. Reads from
+ * the archive itself are serialised on its lock, but the decoding and verification, which is where
+ * the time goes for transactions, runs in parallel.
+ *
+ * @tparam O The type of the object being stored
+ * @param thread_count The number of threads to scan with
+ * @param verifier Optional check applied to every object once decoded
+ * @return The report of the scan
+ */
+template <typename O>
+typename TransientObjectStore<O>::ArchiveReport TransientObjectStore<O>::VerifyArchive(
+    std::size_t thread_count, Verifier const &verifier)
+{
+  using Serializer = typename Archive::serializer_type;
+  using Entries    = std::vector<std::pair<ResourceID, Document>>;
+
+  thread_count = std::max<std::size_t>(thread_count, 1);
+
+  archive_.Flush(false);
+
+  std::size_t const target = std::max(thread_count * SUBTREES_PER_THREAD,
+                                      (archive_.size() / MAX_SUBTREE_OBJECTS) + 1);
+
+  uint64_t bits = 0;
+  while ((bits < MAX_SUBTREE_BITS) && ((std::size_t{1} << bits) < target))
+  {
+    ++bits;
+  }
+
+  std::size_t const          subtree_count = std::size_t{1} << bits;
+  std::atomic<std::size_t>   next_subtree{0};
+  std::vector<ArchiveReport> reports(thread_count);
+
+  auto const scan = [this, &verifier, &next_subtree, bits, subtree_count](ArchiveReport &report) {
+    Entries entries;
+
+    for (std::size_t subtree = next_subtree++; subtree < subtree_count; subtree = next_subtree++)
+    {
+      // the subtree index forms the leading bits of the key
+      uint16_t const        leading = static_cast<uint16_t>(subtree << (MAX_SUBTREE_BITS - bits));
+      byte_array::ByteArray prefix;
+      prefix.Resize(std::size_t{ResourceID::RESOURCE_ID_SIZE_IN_BYTES});
+      prefix[0] = static_cast<uint8_t>(leading >> 8);
+      prefix[1] = static_cast<uint8_t>(leading & 0xFF);
+
+      entries.clear();
+      archive_.WithLock([this, &entries, &prefix, bits]() {
+        for (auto it = archive_.GetSubtree(ResourceID{prefix}, bits); it != archive_.end(); ++it)
+        {
+          entries.emplace_back(it.GetKey(), it.GetDocument());
+        }
+      });
+
+      for (auto const &entry : entries)
+      {
+        bool valid = false;
+
+        try
+        {
+          O          object;
+          Serializer serializer(entry.second.document);
+          serializer >> object;
+
+          valid = !verifier || verifier(entry.first, object);
+        }
+        catch (std::exception const &ex)
+        {
+          FETCH_LOG_WARN(LOGGING_NAME, "Unable to decode archived object: ", entry.first.ToString(),
+                         " error: ", ex.what());
+        }
+
+        ++report.objects;
+        if (!valid)
+        {
+          report.corrupt.push_back(entry.first);
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count - 1);
+  for (std::size_t i = 1; i < thread_count; ++i)
+  {
+    threads.emplace_back(scan, std::ref(reports[i]));
+  }
+
+  // the calling thread takes a share of the work too
+  scan(reports[0]);
+
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  ArchiveReport result;
+  result.subtrees = subtree_count;
+  for (auto &report : reports)
+  {
+    result.objects += report.objects;
+    result.corrupt.insert(result.corrupt.end(), report.corrupt.begin(), report.corrupt.end());
+  }
+
+  FETCH_LOG_INFO(LOGGING_NAME, "Verified ", result.objects, " archived objects in ", subtree_count,
+                 " subtrees on ", thread_count, " threads (", result.corrupt.size(), " corrupt)");
+
+  return result;
+}
+
+/**
+ * Copy the objects accepted by a filter into another store, for example when the objects of one
+ * lane are moved to another. The archive is walked one subtree at a time, so that its lock is only
+ * held briefly. The objects waiting in the cache are copied too, but are not confirmed.
+ *
+ * @tparam O The type of the object being stored
+ * @param target The store to copy the objects into
+ * @param filter Selects the objects to be copied
+ * @return The number of objects copied
+ */
+template <typename O>
+std::size_t TransientObjectStore<O>::CopyTo(TransientObjectStore &target, Filter const &filter)
+{
+  using Serializer = typename Archive::serializer_type;
+  using Entries    = std::vector<std::pair<ResourceID, Document>>;
+
+  std::size_t copied = CopyCachedTo(target, filter);
+
+  archive_.Flush(false);
+
+  uint64_t bits = 0;
+  while ((bits < MAX_SUBTREE_BITS) &&
+         ((std::size_t{1} << bits) < ((archive_.size() / MAX_SUBTREE_OBJECTS) + 1)))
+  {
+    ++bits;
+  }
+
+  Entries entries;
+  for (std::size_t subtree = 0, count = std::size_t{1} << bits; subtree < count; ++subtree)
+  {
+    // the subtree index forms the leading bits of the key
+    uint16_t const        leading = static_cast<uint16_t>(subtree << (MAX_SUBTREE_BITS - bits));
+    byte_array::ByteArray prefix;
+    prefix.Resize(std::size_t{ResourceID::RESOURCE_ID_SIZE_IN_BYTES});
+    prefix[0] = static_cast<uint8_t>(leading >> 8);
+    prefix[1] = static_cast<uint8_t>(leading & 0xFF);
+
+    entries.clear();
+    archive_.WithLock([this, &entries, &prefix, &filter, bits]() {
+      for (auto it = archive_.GetSubtree(ResourceID{prefix}, bits); it != archive_.end(); ++it)
+      {
+        ResourceID const rid = it.GetKey();
+        if (filter(rid))
+        {
+          entries.emplace_back(rid, it.GetDocument());
+        }
+      }
+    });
+
+    for (auto const &entry : entries)
+    {
+      try
+      {
+        O          object;
+        Serializer serializer(entry.second.document);
+        serializer >> object;
+
+        target.Set(entry.first, object, false);
+        target.Confirm(entry.first);
+        ++copied;
+      }
+      catch (std::exception const &ex)
+      {
+        FETCH_LOG_WARN(LOGGING_NAME, "Unable to decode archived object: ", entry.first.ToString(),
+                       " error: ", ex.what());
+      }
+    }
+  }
+
+  return copied;
+}
+
+/**
+ * Copy only the objects in the cache accepted by a filter into another store, without confirming
+ * them. This catches up with the objects added since a previous call to CopyTo.
+ *
+ * @tparam O The type of the object being stored
+ * @param target The store to copy the objects into
+ * @param filter Selects the objects to be copied
+ * @return The number of objects copied
+ */
+template <typename O>
+std::size_t TransientObjectStore<O>::CopyCachedTo(TransientObjectStore &target,
+                                                  Filter const &        filter)
+{
+  std::vector<std::pair<ResourceID, O>> cached;
+  {
+    FETCH_LOCK(cache_mutex_);
+
+    for (auto const &entry : cache_)
+    {
+      if (filter(entry.first))
+      {
+        cached.emplace_back(entry.first, entry.second);
+      }
+    }
+  }
+
+  for (auto const &entry : cached)
+  {
+    target.Set(entry.first, entry.second, false);
+  }
+
+  return cached.size();
+}
+
 /**
  * Retrieve an object with the specified resource id
  *
@@ -334,7 +716,14 @@ bool TransientObjectStore<O>::Get(ResourceID const &rid, O &object)
 
   {
     FETCH_LOCK(cache_mutex_);
-    success = GetFromCache(rid, object) || archive_.Get(rid, object);
+    success = GetFromCache(rid, object);
+  }
+
+  // objects are written to the archive before they leave the cache, so the archive can be queried
+  // without holding the cache lock. Recently archived objects are served from its read view
+  if (!success)
+  {
+    success = archive_.Get(rid, object);
   }
 
   if (!success)
@@ -385,9 +774,15 @@ typename TransientObjectStore<O>::TxSummaries TransientObjectStore<O>::GetRecent
 template <typename O>
 bool TransientObjectStore<O>::Has(ResourceID const &rid)
 {
-  FETCH_LOCK(cache_mutex_);
+  {
+    FETCH_LOCK(cache_mutex_);
+    if (IsInCache(rid))
+    {
+      return true;
+    }
+  }
 
-  return IsInCache(rid) || archive_.Has(rid);
+  return archive_.Has(rid);
 }
 
 /**
@@ -415,6 +810,11 @@ void TransientObjectStore<O>::Set(ResourceID const &rid, O const &object, bool n
     std::size_t count{most_recent_seen_.QUEUE_LENGTH};
     bool const  inserted =
         most_recent_seen_.Push(object.summary(), count, std::chrono::milliseconds{100});
+    if (inserted)
+    {
+      recent_queue_depth_ = count;
+    }
+
     if (inserted && prev_count != count)
     {
       if (prev_count < recent_queue_alarm_threshold && count >= recent_queue_alarm_threshold)
@@ -449,17 +849,36 @@ void TransientObjectStore<O>::Set(ResourceID const &rid, O const &object, bool n
 template <typename O>
 bool TransientObjectStore<O>::Confirm(ResourceID const &rid)
 {
+  PendingWrite pending;
+  pending.rid = rid;
+
   {
     FETCH_LOCK(cache_mutex_);
 
-    if (!IsInCache(rid))
+    auto it = cache_.find(rid);
+    if (it == cache_.end())
     {
       return false;
     }
+
+    // account for the object as it will be written to the archive
+    serializers::SizeCounter<typename Archive::serializer_type> counter;
+    counter << it->second;
+    pending.size = counter.size();
+  }
+
+  pending.confirmed = Clock::now();
+  dirty_bytes_ += pending.size;
+
+  // counted before the push so that the writer can never take the depth below zero
+  std::size_t const depth = ++queue_depth_;
+  std::size_t       peak  = peak_queue_depth_;
+  while ((depth > peak) && !peak_queue_depth_.compare_exchange_weak(peak, depth))
+  {
   }
 
   // add the element into the queue of items to be pushed to disk
-  confirm_queue_.Push(rid);
+  confirm_queue_.Push(pending);
 
   return true;
 }
@@ -36,10 +36,12 @@
 #include "core/assert.hpp"
 #include "core/macros.hpp"
 #include "storage/storage_exception.hpp"
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <fstream>
 #include <string>
+#include <vector>
 
 namespace fetch {
 namespace storage {
@@ -276,9 +278,130 @@ public:
     FETCH_UNUSED(lazy);
 
     WriteHeader();
+    file_handle_.flush();
+  }
+
+  /**
+   * The file offset of the end of the topmost object
+   */
+  int64_t end() const
+  {
+    return header_.end;
+  }
+
+  /**
+   * Walk the objects of the stack from the top down, stopping when the visitor returns false or
+   * the bottom of the stack is reached.
+   *
+   * @param: visitor Called with the type of each object, returns whether to continue
+   *
+   * @return: The file offset of the start of the last visited object
+   */
+  template <typename F>
+  int64_t Walk(F &&visitor)
+  {
+    int64_t position = header_.end;
+
+    while (position > FirstObjectOffset())
+    {
+      Separator separator;
+      file_handle_.seekg(position - int64_t(sizeof(Separator)), file_handle_.beg);
+      file_handle_.read(reinterpret_cast<char *>(&separator), sizeof(Separator));
+
+      position = separator.previous;
+
+      if (!visitor(separator.type))
+      {
+        break;
+      }
+    }
+
+    return position;
+  }
+
+  /**
+   * Append a range of objects from another variant stack file on to the top of this stack. The
+   * objects are copied sequentially and the separators re-linked to their new positions.
+   *
+   * @param: source The filename of the source variant stack
+   * @param: begin The file offset of the start of the first object to copy
+   * @param: end The file offset of the end of the last object to copy
+   *
+   * @return: true if successful, otherwise false
+   */
+  bool AppendFrom(std::string const &source, int64_t begin, int64_t end)
+  {
+    if ((begin < FirstObjectOffset()) || (end < begin))
+    {
+      return false;
+    }
+
+    std::ifstream input(source, std::ios::in | std::ios::binary);
+    if (!input)
+    {
+      return false;
+    }
+
+    int64_t const base = header_.end;
+
+    // bulk copy of the objects and their separators
+    input.seekg(begin, input.beg);
+    file_handle_.seekp(base, file_handle_.beg);
+
+    std::vector<char> buffer(COPY_BUFFER_SIZE);
+    for (int64_t remaining = end - begin; remaining > 0;)
+    {
+      auto const length = std::min<int64_t>(remaining, int64_t(buffer.size()));
+
+      if (!input.read(buffer.data(), length))
+      {
+        return false;
+      }
+
+      file_handle_.write(buffer.data(), length);
+      remaining -= length;
+    }
+
+    // relink the copied separators, walking from the top of the copied range downwards
+    int64_t const delta    = base - begin;
+    int64_t       position = base + (end - begin);
+    uint64_t      count    = 0;
+
+    while (position > base)
+    {
+      Separator     separator;
+      int64_t const offset = position - int64_t(sizeof(Separator));
+
+      file_handle_.seekg(offset, file_handle_.beg);
+      file_handle_.read(reinterpret_cast<char *>(&separator), sizeof(Separator));
+
+      separator.previous += delta;
+      if (separator.previous < base)
+      {
+        return false;
+      }
+
+      file_handle_.seekp(offset, file_handle_.beg);
+      file_handle_.write(reinterpret_cast<char const *>(&separator), sizeof(Separator));
+
+      position = separator.previous;
+      ++count;
+    }
+
+    header_.end += end - begin;
+    header_.object_count += count;
+
+    return bool(file_handle_);
   }
 
 protected:
+  static constexpr std::size_t COPY_BUFFER_SIZE = 1 << 20;
+
+  static constexpr int64_t FirstObjectOffset()
+  {
+    return int64_t(sizeof(Header) + sizeof(Separator));
+  }
+
   void ReadHeader()
   {
     file_handle_.seekg(0, file_handle_.beg);
@@ -42,6 +42,7 @@
 #include "storage/variant_stack.hpp"
 
 #include <cstring>
+#include <utility>
 
 namespace fetch {
 namespace storage {
@@ -340,6 +341,20 @@ public:
     stack_.Get(i, object);
   }
 
+  /**
+   * Read a run of elements, only available when the underlying stack supports bulk reads
+   *
+   * @param: i The index of the first element
+   * @param: elements The number of elements, updated with the number actually read
+   * @param: objects The buffer to be populated
+   */
+  template <typename U = stack_type>
+  auto GetBulk(std::size_t const &i, std::size_t &elements, type *objects)
+      -> decltype(std::declval<U &>().GetBulk(i, elements, objects), void())
+  {
+    stack_.GetBulk(i, elements, objects);
+  }
+
   void Set(std::size_t const &i, type const &object)
   {
     type old_data;
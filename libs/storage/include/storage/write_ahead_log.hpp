@@ -0,0 +1,95 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "metrics/storage_metrics.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace fetch {
+namespace storage {
+
+/**
+ * Append only log used to make groups of writes durable with a single sequential write and sync.
+ *
+ * Each call to Append writes one group, containing all the key / value records for a commit along
+ * with the resulting state hash. Groups are checksummed so that a partially written tail (after a
+ * crash) is detected and discarded during Replay.
+ *
+ * ┌──────────┬──────────┬──────────┬─────────────────────────────┬──────────┐
+ * │  MAGIC   │  COUNT   │  LENGTH  │   RECORDS ... , STATE HASH  │ CHECKSUM │
+ * └──────────┴──────────┴──────────┴─────────────────────────────┴──────────┘
+ */
+class WriteAheadLog
+{
+public:
+  using ConstByteArray = byte_array::ConstByteArray;
+
+  struct Record
+  {
+    ConstByteArray key;
+    ConstByteArray value;
+  };
+
+  using Records        = std::vector<Record>;
+  using ReplayCallback = std::function<void(Records const &, ConstByteArray const &)>;
+
+  static constexpr char const *LOGGING_NAME = "WriteAheadLog";
+
+  // Construction / Destruction
+  WriteAheadLog()                      = default;
+  WriteAheadLog(WriteAheadLog const &) = delete;
+  WriteAheadLog(WriteAheadLog &&)      = delete;
+  ~WriteAheadLog();
+
+  /// @name File Operations
+  /// @{
+  bool Open(std::string const &filename, bool truncate);
+  void Close();
+  bool is_open() const;
+  bool Truncate();
+  /// @}
+
+  /// @name Log Operations
+  /// @{
+  bool        Append(Records const &records, ConstByteArray const &hash);
+  std::size_t Replay(ReplayCallback const &callback);
+  uint64_t    size() const;
+  /// @}
+
+  static bool SyncFile(std::string const &filename);
+
+  // Operators
+  WriteAheadLog &operator=(WriteAheadLog const &) = delete;
+  WriteAheadLog &operator=(WriteAheadLog &&) = delete;
+
+private:
+  bool Sync(bool data_only);
+
+  std::string            filename_;
+  int                    fd_      = -1;
+  uint64_t               size_    = 0;
+  metrics::StackMetrics *metrics_ = nullptr;  ///< The instruments for the log file
+};
+
+}  // namespace storage
+}  // namespace fetch
@@ -0,0 +1,573 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "storage/async_io.hpp"
+#include "core/logger.hpp"
+#include "storage/storage_exception.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <unistd.h>
+
+#if defined(FETCH_PLATFORM_LINUX)
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define FETCH_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#endif
+#if defined(__NR_io_setup) && defined(__NR_io_submit) && defined(__NR_io_getevents)
+#define FETCH_HAS_LINUX_AIO
+#include <linux/aio_abi.h>
+#endif
+#endif
+
+namespace fetch {
+namespace storage {
+namespace {
+
+constexpr char const *LOGGING_NAME    = "AsyncReader";
+constexpr std::size_t MAX_QUEUE_DEPTH = 4096;
+
+/**
+ * Complete a request which the kernel has (partially) serviced
+ *
+ * @param fd The file descriptor
+ * @param request The original request
+ * @param result The number of bytes read, or a negative error code
+ * @return true if the request has been read in full
+ */
+bool FinishRequest(int fd, ReadRequest const &request, int64_t result)
+{
+  if (result < 0)
+  {
+    return false;
+  }
+
+  auto const count = static_cast<std::size_t>(result);
+  if (count >= request.length)
+  {
+    return true;
+  }
+
+  // short reads are completed synchronously
+  return ReadFully(fd, reinterpret_cast<uint8_t *>(request.buffer) + count, request.length - count,
+                   request.offset + count);
+}
+
+class SynchronousReader : public AsyncReader
+{
+public:
+  bool Read(int fd, ReadRequests const &requests, Completion const &on_complete) override
+  {
+    bool success = true;
+
+    for (std::size_t i = 0; i < requests.size(); ++i)
+    {
+      auto const &request = requests[i];
+      bool const  read    = ReadFully(fd, request.buffer, request.length, request.offset);
+
+      if (on_complete)
+      {
+        on_complete(i, read);
+      }
+
+      success &= read;
+    }
+
+    return success;
+  }
+
+  AsyncIoBackend backend() const override
+  {
+    return AsyncIoBackend::SYNCHRONOUS;
+  }
+
+  std::size_t queue_depth() const override
+  {
+    return 1;
+  }
+};
+
+#if defined(FETCH_HAS_IO_URING)
+
+/**
+ * Reader using the io_uring interface directly through the system calls. The submission ring is
+ * kept topped up with readv requests while completions are reaped.
+ */
+class IoUringReader : public AsyncReader
+{
+public:
+  explicit IoUringReader(std::size_t queue_depth)
+  {
+    io_uring_params params{};
+
+    int const fd = static_cast<int>(
+        syscall(__NR_io_uring_setup, static_cast<unsigned>(queue_depth), &params));
+    if (fd < 0)
+    {
+      FETCH_LOG_INFO(LOGGING_NAME, "io_uring unavailable: ", std::strerror(errno));
+      return;
+    }
+
+    ring_fd_ = fd;
+    entries_ = params.sq_entries;
+
+    sq_ring_size_ = params.sq_off.array + (params.sq_entries * sizeof(unsigned));
+    cq_ring_size_ = params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe));
+    sqes_size_    = params.sq_entries * sizeof(io_uring_sqe);
+
+    bool const single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap)
+    {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+
+    sq_ring_ = Map(sq_ring_size_, IORING_OFF_SQ_RING);
+    cq_ring_ = single_mmap ? sq_ring_ : Map(cq_ring_size_, IORING_OFF_CQ_RING);
+    sqes_    = Map(sqes_size_, IORING_OFF_SQES);
+
+    if ((sq_ring_ == MAP_FAILED) || (cq_ring_ == MAP_FAILED) || (sqes_ == MAP_FAILED))
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Unable to map io_uring rings");
+      Close();
+      return;
+    }
+
+    auto *sq = reinterpret_cast<uint8_t *>(sq_ring_);
+    auto *cq = reinterpret_cast<uint8_t *>(cq_ring_);
+
+    sq_tail_  = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_  = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    cq_head_  = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_  = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_  = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_     = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+  }
+
+  ~IoUringReader() override
+  {
+    Close();
+  }
+
+  bool valid() const
+  {
+    return ring_fd_ >= 0;
+  }
+
+  bool Read(int fd, ReadRequests const &requests, Completion const &on_complete) override
+  {
+    std::vector<iovec> vectors(requests.size());
+
+    auto *const sqes = reinterpret_cast<io_uring_sqe *>(sqes_);
+
+    std::size_t submitted   = 0;
+    std::size_t completed   = 0;
+    std::size_t in_flight   = 0;
+    unsigned    unsubmitted = 0;
+    bool        success     = true;
+
+    while (completed < requests.size())
+    {
+      // top up the submission ring
+      unsigned tail = *sq_tail_;
+      while ((submitted < requests.size()) && (in_flight < entries_))
+      {
+        auto const &request = requests[submitted];
+
+        vectors[submitted].iov_base = request.buffer;
+        vectors[submitted].iov_len  = request.length;
+
+        unsigned const slot = tail & *sq_mask_;
+        io_uring_sqe & sqe  = sqes[slot];
+
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode    = IORING_OP_READV;
+        sqe.fd        = fd;
+        sqe.off       = request.offset;
+        sqe.addr      = reinterpret_cast<uint64_t>(&vectors[submitted]);
+        sqe.len       = 1;
+        sqe.user_data = submitted;
+
+        sq_array_[slot] = slot;
+
+        ++tail;
+        ++submitted;
+        ++in_flight;
+        ++unsubmitted;
+      }
+      __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+
+      long const consumed = syscall(__NR_io_uring_enter, ring_fd_, unsubmitted, 1u,
+                                    IORING_ENTER_GETEVENTS, nullptr, 0);
+      if (consumed < 0)
+      {
+        if ((errno != EINTR) && (errno != EAGAIN) && (errno != EBUSY))
+        {
+          throw StorageException(std::string{"io_uring_enter failed: "} + std::strerror(errno));
+        }
+      }
+      else
+      {
+        unsubmitted -= static_cast<unsigned>(consumed);
+      }
+
+      // reap the completions
+      unsigned       head    = *cq_head_;
+      unsigned const cq_tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      for (; head != cq_tail; ++head)
+      {
+        io_uring_cqe const &cqe   = cqes_[head & *cq_mask_];
+        auto const          index = static_cast<std::size_t>(cqe.user_data);
+        bool const          read  = FinishRequest(fd, requests[index], cqe.res);
+
+        --in_flight;
+        ++completed;
+        success &= read;
+
+        if (on_complete)
+        {
+          on_complete(index, read);
+        }
+      }
+      __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+
+    return success;
+  }
+
+  AsyncIoBackend backend() const override
+  {
+    return AsyncIoBackend::IO_URING;
+  }
+
+  std::size_t queue_depth() const override
+  {
+    return entries_;
+  }
+
+private:
+  void *Map(std::size_t size, uint64_t offset) const
+  {
+    return mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                static_cast<off_t>(offset));
+  }
+
+  void Close()
+  {
+    if (sqes_ != MAP_FAILED)
+    {
+      munmap(sqes_, sqes_size_);
+    }
+
+    if ((cq_ring_ != MAP_FAILED) && (cq_ring_ != sq_ring_))
+    {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+
+    if (sq_ring_ != MAP_FAILED)
+    {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+
+    if (ring_fd_ >= 0)
+    {
+      close(ring_fd_);
+    }
+
+    sqes_    = MAP_FAILED;
+    cq_ring_ = MAP_FAILED;
+    sq_ring_ = MAP_FAILED;
+    ring_fd_ = -1;
+  }
+
+  int         ring_fd_      = -1;
+  unsigned    entries_      = 0;
+  void *      sq_ring_      = MAP_FAILED;
+  void *      cq_ring_      = MAP_FAILED;
+  void *      sqes_         = MAP_FAILED;
+  std::size_t sq_ring_size_ = 0;
+  std::size_t cq_ring_size_ = 0;
+  std::size_t sqes_size_    = 0;
+
+  unsigned *    sq_tail_  = nullptr;
+  unsigned *    sq_mask_  = nullptr;
+  unsigned *    sq_array_ = nullptr;
+  unsigned *    cq_head_  = nullptr;
+  unsigned *    cq_tail_  = nullptr;
+  unsigned *    cq_mask_  = nullptr;
+  io_uring_cqe *cqes_     = nullptr;
+};
+
+#endif  // FETCH_HAS_IO_URING
+
+#if defined(FETCH_HAS_LINUX_AIO)
+
+/**
+ * Reader using Linux kernel AIO directly through the system calls (the interface wrapped by libaio)
+ */
+class LinuxAioReader : public AsyncReader
+{
+public:
+  explicit LinuxAioReader(std::size_t queue_depth)
+    : queue_depth_(queue_depth)
+  {
+    if (syscall(__NR_io_setup, static_cast<unsigned>(queue_depth_), &context_) < 0)
+    {
+      FETCH_LOG_INFO(LOGGING_NAME, "Linux AIO unavailable: ", std::strerror(errno));
+      context_ = 0;
+    }
+  }
+
+  ~LinuxAioReader() override
+  {
+    if (valid())
+    {
+      syscall(__NR_io_destroy, context_);
+    }
+  }
+
+  bool valid() const
+  {
+    return context_ != 0;
+  }
+
+  bool Read(int fd, ReadRequests const &requests, Completion const &on_complete) override
+  {
+    std::vector<iocb>     blocks(requests.size());
+    std::vector<iocb *>   pointers(requests.size());
+    std::vector<io_event> events(queue_depth_);
+
+    for (std::size_t i = 0; i < requests.size(); ++i)
+    {
+      auto const &request = requests[i];
+      iocb &      block   = blocks[i];
+
+      std::memset(&block, 0, sizeof(block));
+      block.aio_lio_opcode = IOCB_CMD_PREAD;
+      block.aio_fildes     = static_cast<uint32_t>(fd);
+      block.aio_buf        = reinterpret_cast<uint64_t>(request.buffer);
+      block.aio_nbytes     = request.length;
+      block.aio_offset     = static_cast<int64_t>(request.offset);
+      block.aio_data       = i;
+
+      pointers[i] = &block;
+    }
+
+    std::size_t submitted = 0;
+    std::size_t completed = 0;
+    std::size_t in_flight = 0;
+    bool        success   = true;
+
+    while (completed < requests.size())
+    {
+      std::size_t const batch = std::min(requests.size() - submitted, queue_depth_ - in_flight);
+      if (batch != 0)
+      {
+        long const accepted =
+            syscall(__NR_io_submit, context_, static_cast<long>(batch), &pointers[submitted]);
+
+        if (accepted > 0)
+        {
+          submitted += static_cast<std::size_t>(accepted);
+          in_flight += static_cast<std::size_t>(accepted);
+        }
+        else if ((accepted < 0) && (errno != EAGAIN) && (errno != EINTR) && (in_flight == 0))
+        {
+          // the kernel refused the request, service it synchronously
+          auto const &request = requests[submitted];
+          bool const  read    = ReadFully(fd, request.buffer, request.length, request.offset);
+
+          ++submitted;
+          ++completed;
+          success &= read;
+
+          if (on_complete)
+          {
+            on_complete(submitted - 1, read);
+          }
+
+          continue;
+        }
+      }
+
+      if (in_flight == 0)
+      {
+        continue;
+      }
+
+      long const reaped = syscall(__NR_io_getevents, context_, 1L,
+                                  static_cast<long>(events.size()), events.data(), nullptr);
+      if (reaped < 0)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+
+        throw StorageException(std::string{"io_getevents failed: "} + std::strerror(errno));
+      }
+
+      for (long i = 0; i < reaped; ++i)
+      {
+        auto const &event = events[static_cast<std::size_t>(i)];
+        auto const  index = static_cast<std::size_t>(event.data);
+        bool const  read  = FinishRequest(fd, requests[index], event.res);
+
+        --in_flight;
+        ++completed;
+        success &= read;
+
+        if (on_complete)
+        {
+          on_complete(index, read);
+        }
+      }
+    }
+
+    return success;
+  }
+
+  AsyncIoBackend backend() const override
+  {
+    return AsyncIoBackend::LINUX_AIO;
+  }
+
+  std::size_t queue_depth() const override
+  {
+    return queue_depth_;
+  }
+
+private:
+  std::size_t   queue_depth_;
+  aio_context_t context_ = 0;
+};
+
+#endif  // FETCH_HAS_LINUX_AIO
+
+}  // namespace
+
+/**
+ * Read from a file with pread, retrying on interruption and short reads
+ *
+ * @param fd The file descriptor
+ * @param buffer The destination
+ * @param length The number of bytes to read
+ * @param offset The offset in the file
+ * @return true if the full length was read, otherwise false
+ */
+bool ReadFully(int fd, void *buffer, std::size_t length, uint64_t offset)
+{
+  auto *destination = reinterpret_cast<uint8_t *>(buffer);
+
+  while (length != 0)
+  {
+    ssize_t const result = pread(fd, destination, length, static_cast<off_t>(offset));
+
+    if (result < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      return false;
+    }
+    else if (result == 0)
+    {
+      // end of file
+      return false;
+    }
+
+    auto const count = static_cast<std::size_t>(result);
+
+    destination += count;
+    length -= count;
+    offset += count;
+  }
+
+  return true;
+}
+
+char const *ToString(AsyncIoBackend backend)
+{
+  char const *text = "Unknown";
+
+  switch (backend)
+  {
+  case AsyncIoBackend::AUTO:
+    text = "Auto";
+    break;
+  case AsyncIoBackend::IO_URING:
+    text = "io_uring";
+    break;
+  case AsyncIoBackend::LINUX_AIO:
+    text = "Linux AIO";
+    break;
+  case AsyncIoBackend::SYNCHRONOUS:
+    text = "Synchronous";
+    break;
+  }
+
+  return text;
+}
+
+/**
+ * Create a reader for the requested backend. When the backend is not supported by the platform or
+ * the running kernel the next one in the order io_uring, Linux AIO, synchronous is used instead
+ *
+ * @param backend The preferred backend
+ * @param queue_depth The maximum number of requests in flight
+ * @return The new reader
+ */
+AsyncReaderPtr CreateAsyncReader(AsyncIoBackend backend, std::size_t queue_depth)
+{
+  queue_depth = std::min(std::max<std::size_t>(queue_depth, 1), MAX_QUEUE_DEPTH);
+
+#if defined(FETCH_HAS_IO_URING)
+  if ((backend == AsyncIoBackend::AUTO) || (backend == AsyncIoBackend::IO_URING))
+  {
+    auto reader = std::make_unique<IoUringReader>(queue_depth);
+    if (reader->valid())
+    {
+      return reader;
+    }
+  }
+#endif
+
+#if defined(FETCH_HAS_LINUX_AIO)
+  if (backend != AsyncIoBackend::SYNCHRONOUS)
+  {
+    auto reader = std::make_unique<LinuxAioReader>(queue_depth);
+    if (reader->valid())
+    {
+      return reader;
+    }
+  }
+#endif
+
+  return std::make_unique<SynchronousReader>();
+}
+
+}  // namespace storage
+}  // namespace fetch
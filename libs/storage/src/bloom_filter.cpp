@@ -0,0 +1,286 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "storage/bloom_filter.hpp"
+#include "core/byte_array/byte_array.hpp"
+#include "core/logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace fetch {
+namespace storage {
+namespace {
+
+using byte_array::ByteArray;
+using byte_array::ConstByteArray;
+
+constexpr uint64_t    FILE_MAGIC    = 0x31304d4f4f4c4246ull;  ///< "FBLOOM01"
+constexpr std::size_t MIN_CAPACITY  = 1024;
+constexpr std::size_t BLOCK_MASK    = BlockedBloomFilter::BLOCK_BITS - 1;
+constexpr std::size_t PROBE_SHIFT   = 9;  ///< log2(BLOCK_BITS)
+constexpr std::size_t MAX_TAG_SIZE  = 1024;
+constexpr std::size_t HEADER_FIELDS = 5;
+
+/**
+ * The splitmix64 finaliser
+ */
+uint64_t Mix(uint64_t value)
+{
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+  return value ^ (value >> 31);
+}
+
+/**
+ * Fold the bytes of a key into a single well distributed 64 bit value. The keys of the index are
+ * usually hashes already, but nothing about the filter depends on that.
+ */
+uint64_t HashKey(ConstByteArray const &key)
+{
+  uint8_t const *data   = key.pointer();
+  std::size_t    length = key.size();
+  uint64_t       hash   = Mix(0x9e3779b97f4a7c15ull ^ length);
+
+  while (length >= sizeof(uint64_t))
+  {
+    uint64_t word = 0;
+    std::memcpy(&word, data, sizeof(word));
+
+    hash = Mix(hash ^ word);
+    data += sizeof(word);
+    length -= sizeof(word);
+  }
+
+  if (length > 0)
+  {
+    uint64_t word = 0;
+    std::memcpy(&word, data, length);
+
+    hash = Mix(hash ^ word);
+  }
+
+  return hash;
+}
+
+/**
+ * The number of blocks needed to hold a given number of keys at the configured density
+ */
+std::size_t BlockCountFor(std::size_t capacity)
+{
+  return ((capacity * BlockedBloomFilter::BITS_PER_KEY) + BlockedBloomFilter::BLOCK_BITS - 1) /
+         BlockedBloomFilter::BLOCK_BITS;
+}
+
+/**
+ * Map the upper half of the hash onto a block without a division
+ */
+std::size_t BlockIndex(uint64_t hash, std::size_t block_count)
+{
+  return static_cast<std::size_t>(((hash >> 32) * uint64_t(block_count)) >> 32);
+}
+
+}  // namespace
+
+constexpr char const *BlockedBloomFilter::LOGGING_NAME;
+constexpr std::size_t BlockedBloomFilter::WORDS_PER_BLOCK;
+constexpr std::size_t BlockedBloomFilter::BLOCK_BITS;
+constexpr std::size_t BlockedBloomFilter::PROBE_COUNT;
+constexpr std::size_t BlockedBloomFilter::BITS_PER_KEY;
+
+static_assert(BlockedBloomFilter::PROBE_COUNT * PROBE_SHIFT <= 64,
+              "Probe positions must be derived from a single 64 bit hash");
+
+/**
+ * Construct a filter
+ *
+ * @param capacity The number of keys the filter should be sized for
+ */
+BlockedBloomFilter::BlockedBloomFilter(std::size_t capacity)
+{
+  Reset(capacity);
+}
+
+/**
+ * Clear the filter and resize it for a given number of keys
+ *
+ * @param capacity The number of keys the filter should be sized for
+ */
+void BlockedBloomFilter::Reset(std::size_t capacity)
+{
+  capacity_ = std::max(capacity, MIN_CAPACITY);
+  size_     = 0;
+
+  words_.assign(BlockCountFor(capacity_) * WORDS_PER_BLOCK, 0);
+}
+
+/**
+ * Add a key to the filter
+ *
+ * @param key The key to be added
+ */
+void BlockedBloomFilter::Add(ConstByteArray const &key)
+{
+  uint64_t const hash   = HashKey(key);
+  uint64_t       probes = Mix(hash);
+  uint64_t *     block  = &words_[BlockIndex(hash, block_count()) * WORDS_PER_BLOCK];
+
+  for (std::size_t i = 0; i < PROBE_COUNT; ++i, probes >>= PROBE_SHIFT)
+  {
+    std::size_t const bit = probes & BLOCK_MASK;
+    block[bit >> 6] |= 1ull << (bit & 63);
+  }
+
+  ++size_;
+}
+
+/**
+ * Query the filter for a key
+ *
+ * @param key The key to be checked
+ * @return false if the key has definitely not been added, otherwise true
+ */
+bool BlockedBloomFilter::MayContain(ConstByteArray const &key) const
+{
+  uint64_t const  hash   = HashKey(key);
+  uint64_t        probes = Mix(hash);
+  uint64_t const *block  = &words_[BlockIndex(hash, block_count()) * WORDS_PER_BLOCK];
+
+  for (std::size_t i = 0; i < PROBE_COUNT; ++i, probes >>= PROBE_SHIFT)
+  {
+    std::size_t const bit = probes & BLOCK_MASK;
+    if ((block[bit >> 6] & (1ull << (bit & 63))) == 0)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::size_t BlockedBloomFilter::size() const
+{
+  return size_;
+}
+
+std::size_t BlockedBloomFilter::capacity() const
+{
+  return capacity_;
+}
+
+std::size_t BlockedBloomFilter::block_count() const
+{
+  return words_.size() / WORDS_PER_BLOCK;
+}
+
+/**
+ * Determine if more keys have been added than the filter was sized for, after which the false
+ * positive rate climbs quickly
+ *
+ * @return true if the filter should be rebuilt with a larger capacity, otherwise false
+ */
+bool BlockedBloomFilter::saturated() const
+{
+  return size_ > capacity_;
+}
+
+/**
+ * Write the filter to disk
+ *
+ * @param path The path of the file to be (over)written
+ * @param tag An identifier for the state of the owner, which must be presented again on load
+ * @return true if successful, otherwise false
+ */
+bool BlockedBloomFilter::Save(std::string const &path, ConstByteArray const &tag) const
+{
+  std::ofstream stream(path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+  uint64_t const header[HEADER_FIELDS] = {FILE_MAGIC, capacity_, size_, block_count(), tag.size()};
+
+  stream.write(reinterpret_cast<char const *>(header), sizeof(header));
+  stream.write(reinterpret_cast<char const *>(tag.pointer()),
+               static_cast<std::streamsize>(tag.size()));
+  stream.write(reinterpret_cast<char const *>(words_.data()),
+               static_cast<std::streamsize>(words_.size() * sizeof(uint64_t)));
+
+  if (!stream)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to write bloom filter to: ", path);
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Read the filter from disk. The filter is left untouched if the file is missing, corrupt or
+ * was written for a different state of the owner.
+ *
+ * @param path The path of the file to be read
+ * @param tag The identifier which the filter must have been saved with
+ * @return true if the filter was loaded, otherwise false
+ */
+bool BlockedBloomFilter::Load(std::string const &path, ConstByteArray const &tag)
+{
+  std::ifstream stream(path, std::ios::in | std::ios::binary);
+  uint64_t      header[HEADER_FIELDS] = {};
+
+  if (!stream.read(reinterpret_cast<char *>(header), sizeof(header)))
+  {
+    return false;
+  }
+
+  uint64_t const capacity = header[1];
+  uint64_t const size     = header[2];
+  uint64_t const blocks   = header[3];
+  uint64_t const tag_size = header[4];
+
+  if ((header[0] != FILE_MAGIC) || (tag_size != tag.size()) || (tag_size > MAX_TAG_SIZE) ||
+      (capacity < MIN_CAPACITY) || (blocks != BlockCountFor(capacity)))
+  {
+    return false;
+  }
+
+  ByteArray stored_tag;
+  stored_tag.Resize(tag_size);
+  if (!stream.read(reinterpret_cast<char *>(stored_tag.pointer()),
+                   static_cast<std::streamsize>(tag_size)) ||
+      (stored_tag != tag))
+  {
+    return false;
+  }
+
+  Words words(blocks * WORDS_PER_BLOCK);
+  if (!stream.read(reinterpret_cast<char *>(words.data()),
+                   static_cast<std::streamsize>(words.size() * sizeof(uint64_t))))
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Truncated bloom filter in: ", path);
+    return false;
+  }
+
+  capacity_ = capacity;
+  size_     = size;
+  words_    = std::move(words);
+
+  return true;
+}
+
+}  // namespace storage
+}  // namespace fetch
@@ -0,0 +1,298 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "storage/cache_eviction_policy.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace fetch {
+namespace storage {
+
+char const *ToString(EvictionPolicy policy)
+{
+  char const *text = "Unknown";
+
+  switch (policy)
+  {
+  case EvictionPolicy::LRU:
+    text = "LRU";
+    break;
+  case EvictionPolicy::CLOCK:
+    text = "CLOCK";
+    break;
+  case EvictionPolicy::TWO_QUEUE:
+    text = "2Q";
+    break;
+  }
+
+  return text;
+}
+
+/**
+ * Create an instance of the specified eviction policy
+ *
+ * @param policy The type of the policy
+ * @param capacity The number of lines the cache is able to hold
+ * @return The new policy instance
+ */
+CacheEvictionPolicyPtr CreateEvictionPolicy(EvictionPolicy policy, std::size_t capacity)
+{
+  CacheEvictionPolicyPtr instance;
+
+  switch (policy)
+  {
+  case EvictionPolicy::LRU:
+    instance = std::make_unique<LRUEvictionPolicy>();
+    break;
+  case EvictionPolicy::CLOCK:
+    instance = std::make_unique<ClockEvictionPolicy>();
+    break;
+  case EvictionPolicy::TWO_QUEUE:
+    instance = std::make_unique<TwoQueueEvictionPolicy>(capacity);
+    break;
+  }
+
+  return instance;
+}
+
+// LRU
+
+void LRUEvictionPolicy::OnInsert(LineId line)
+{
+  assert(lookup_.find(line) == lookup_.end());
+
+  queue_.push_front(line);
+  lookup_[line] = queue_.begin();
+}
+
+void LRUEvictionPolicy::OnAccess(LineId line)
+{
+  auto it = lookup_.find(line);
+  if (it != lookup_.end())
+  {
+    queue_.splice(queue_.begin(), queue_, it->second);
+  }
+}
+
+LRUEvictionPolicy::LineId LRUEvictionPolicy::Evict()
+{
+  assert(!queue_.empty());
+
+  LineId const line = queue_.back();
+  queue_.pop_back();
+  lookup_.erase(line);
+
+  return line;
+}
+
+void LRUEvictionPolicy::SetCapacity(std::size_t /*lines*/)
+{}
+
+void LRUEvictionPolicy::Clear()
+{
+  queue_.clear();
+  lookup_.clear();
+}
+
+std::size_t LRUEvictionPolicy::size() const
+{
+  return queue_.size();
+}
+
+// Clock
+
+void ClockEvictionPolicy::OnInsert(LineId line)
+{
+  assert(lookup_.find(line) == lookup_.end());
+
+  std::size_t index = slots_.size();
+  if (free_.empty())
+  {
+    slots_.emplace_back();
+  }
+  else
+  {
+    index = free_.back();
+    free_.pop_back();
+  }
+
+  auto &slot      = slots_[index];
+  slot.line       = line;
+  slot.referenced = false;
+  slot.occupied   = true;
+
+  lookup_[line] = index;
+}
+
+void ClockEvictionPolicy::OnAccess(LineId line)
+{
+  auto it = lookup_.find(line);
+  if (it != lookup_.end())
+  {
+    slots_[it->second].referenced = true;
+  }
+}
+
+ClockEvictionPolicy::LineId ClockEvictionPolicy::Evict()
+{
+  assert(!lookup_.empty());
+
+  for (;;)
+  {
+    if (hand_ >= slots_.size())
+    {
+      hand_ = 0;
+    }
+
+    auto &slot = slots_[hand_];
+
+    if (slot.occupied)
+    {
+      if (!slot.referenced)
+      {
+        slot.occupied = false;
+        lookup_.erase(slot.line);
+        free_.push_back(hand_);
+        ++hand_;
+
+        return slot.line;
+      }
+
+      // give the line a second chance
+      slot.referenced = false;
+    }
+
+    ++hand_;
+  }
+}
+
+void ClockEvictionPolicy::SetCapacity(std::size_t /*lines*/)
+{}
+
+void ClockEvictionPolicy::Clear()
+{
+  slots_.clear();
+  lookup_.clear();
+  free_.clear();
+  hand_ = 0;
+}
+
+std::size_t ClockEvictionPolicy::size() const
+{
+  return lookup_.size();
+}
+
+// 2Q
+
+TwoQueueEvictionPolicy::TwoQueueEvictionPolicy(std::size_t capacity)
+{
+  SetCapacity(capacity);
+}
+
+void TwoQueueEvictionPolicy::OnInsert(LineId line)
+{
+  assert(probation_lookup_.find(line) == probation_lookup_.end());
+  assert(main_lookup_.find(line) == main_lookup_.end());
+
+  auto ghost = ghost_lookup_.find(line);
+  if (ghost != ghost_lookup_.end())
+  {
+    // the line has been seen recently, it is promoted straight into the main queue
+    ghost_.erase(ghost->second);
+    ghost_lookup_.erase(ghost);
+
+    PushFront(main_, main_lookup_, line);
+  }
+  else
+  {
+    PushFront(probation_, probation_lookup_, line);
+  }
+}
+
+void TwoQueueEvictionPolicy::OnAccess(LineId line)
+{
+  // accesses to lines in the probation queue are deliberately ignored (FIFO)
+  auto it = main_lookup_.find(line);
+  if (it != main_lookup_.end())
+  {
+    main_.splice(main_.begin(), main_, it->second);
+  }
+}
+
+TwoQueueEvictionPolicy::LineId TwoQueueEvictionPolicy::Evict()
+{
+  assert(!probation_.empty() || !main_.empty());
+
+  if (main_.empty() || (probation_.size() > probation_limit_))
+  {
+    LineId const line = PopBack(probation_, probation_lookup_);
+
+    // remember the line in case it is requested again soon
+    PushFront(ghost_, ghost_lookup_, line);
+    while (ghost_.size() > ghost_limit_)
+    {
+      PopBack(ghost_, ghost_lookup_);
+    }
+
+    return line;
+  }
+
+  return PopBack(main_, main_lookup_);
+}
+
+void TwoQueueEvictionPolicy::SetCapacity(std::size_t lines)
+{
+  // recommended tuning from the original paper: Kin = 25%, Kout = 50% of the cache size
+  probation_limit_ = std::max<std::size_t>(lines / 4, 1);
+  ghost_limit_     = std::max<std::size_t>(lines / 2, 1);
+}
+
+void TwoQueueEvictionPolicy::Clear()
+{
+  probation_.clear();
+  probation_lookup_.clear();
+  ghost_.clear();
+  ghost_lookup_.clear();
+  main_.clear();
+  main_lookup_.clear();
+}
+
+std::size_t TwoQueueEvictionPolicy::size() const
+{
+  return probation_.size() + main_.size();
+}
+
+void TwoQueueEvictionPolicy::PushFront(Queue &queue, QueueMap &lookup, LineId line)
+{
+  queue.push_front(line);
+  lookup[line] = queue.begin();
+}
+
+TwoQueueEvictionPolicy::LineId TwoQueueEvictionPolicy::PopBack(Queue &queue, QueueMap &lookup)
+{
+  LineId const line = queue.back();
+  queue.pop_back();
+  lookup.erase(line);
+
+  return line;
+}
+
+}  // namespace storage
+}  // namespace fetch
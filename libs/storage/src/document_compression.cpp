@@ -0,0 +1,431 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "storage/document_compression.hpp"
+#include "core/byte_array/byte_array.hpp"
+#include "core/logger.hpp"
+#include "storage/storage_exception.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <unordered_set>
+
+namespace fetch {
+namespace storage {
+namespace {
+
+using byte_array::ByteArray;
+using byte_array::ConstByteArray;
+
+constexpr std::size_t KMER_SIZE    = 8;   ///< The length of the substrings counted when training
+constexpr std::size_t SEGMENT_SIZE = 64;  ///< The unit in which the dictionary is assembled
+constexpr std::size_t MAX_SAMPLE   = 16 * 1024;
+
+using KmerCounts = std::unordered_map<uint64_t, uint32_t>;
+
+uint64_t KmerAt(uint8_t const *data)
+{
+  uint64_t kmer = 0;
+  std::memcpy(&kmer, data, KMER_SIZE);
+  return kmer;
+}
+
+struct Segment
+{
+  std::size_t sample = 0;
+  std::size_t offset = 0;
+  std::size_t length = 0;
+  uint64_t    score  = 0;
+
+  bool operator<(Segment const &other) const
+  {
+    return score < other.score;
+  }
+};
+
+/**
+ * Score a segment as the sum of the sample frequencies of the distinct substrings it contains,
+ * ignoring substrings which only occur in a single sample
+ */
+uint64_t ScoreSegment(ConstByteArray const &sample, Segment const &segment, KmerCounts const &counts)
+{
+  std::unordered_set<uint64_t> seen;
+  uint64_t                     score = 0;
+
+  for (std::size_t i = 0; i + KMER_SIZE <= segment.length; ++i)
+  {
+    uint64_t const kmer = KmerAt(sample.pointer() + segment.offset + i);
+    if (seen.insert(kmer).second)
+    {
+      auto const it = counts.find(kmer);
+      if ((it != counts.end()) && (it->second > 1))
+      {
+        score += it->second;
+      }
+    }
+  }
+
+  return score;
+}
+
+}  // namespace
+
+constexpr char const *DocumentCompressor::LOGGING_NAME;
+constexpr std::size_t DocumentCompressor::MAX_DICTIONARY_SIZE;
+constexpr std::size_t DocumentCompressor::DEFAULT_DICTIONARY_SIZE;
+
+void DocumentCompressor::New(std::string const &path)
+{
+  path_ = path;
+  dictionaries_.clear();
+  active_dictionary_ = ConstByteArray{};
+
+  std::ofstream stream(path_, std::ios::out | std::ios::binary | std::ios::trunc);
+}
+
+void DocumentCompressor::Load(std::string const &path)
+{
+  path_ = path;
+  dictionaries_.clear();
+  active_dictionary_ = ConstByteArray{};
+
+  std::ifstream stream(path_, std::ios::in | std::ios::binary);
+  uint64_t      size = 0;
+
+  while (stream.read(reinterpret_cast<char *>(&size), sizeof(size)))
+  {
+    if (size > MAX_DICTIONARY_SIZE)
+    {
+      throw StorageException("Corrupt compression dictionary file: " + path_);
+    }
+
+    ByteArray dictionary;
+    dictionary.Resize(size);
+
+    if (!stream.read(reinterpret_cast<char *>(dictionary.pointer()),
+                     static_cast<std::streamsize>(size)))
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Truncated compression dictionary in: ", path_);
+      break;
+    }
+
+    Register(dictionary);
+  }
+}
+
+void DocumentCompressor::SetOptions(CompressionOptions const &options)
+{
+  options_       = options;
+  options_.level = std::min(std::max(options_.level, 1), 9);
+}
+
+CompressionOptions const &DocumentCompressor::options() const
+{
+  return options_;
+}
+
+bool DocumentCompressor::enabled() const
+{
+  return options_.enabled;
+}
+
+/**
+ * Persist a dictionary and make it the one used to compress new documents
+ *
+ * @param dictionary The dictionary, truncated to the deflate window if it is larger
+ * @return The identifier of the dictionary
+ */
+DocumentCompressor::DictionaryId DocumentCompressor::AddDictionary(ConstByteArray const &dictionary)
+{
+  // deflate only references the end of the dictionary
+  ConstByteArray const trimmed =
+      (dictionary.size() > MAX_DICTIONARY_SIZE)
+          ? dictionary.SubArray(dictionary.size() - MAX_DICTIONARY_SIZE, MAX_DICTIONARY_SIZE)
+          : dictionary;
+
+  if (trimmed.empty())
+  {
+    return 0;
+  }
+
+  auto const id = static_cast<DictionaryId>(
+      adler32(adler32(0, Z_NULL, 0), trimmed.pointer(), static_cast<uInt>(trimmed.size())));
+
+  if (dictionaries_.find(id) == dictionaries_.end() && !path_.empty())
+  {
+    std::ofstream  stream(path_, std::ios::out | std::ios::binary | std::ios::app);
+    uint64_t const size = trimmed.size();
+
+    stream.write(reinterpret_cast<char const *>(&size), sizeof(size));
+    stream.write(trimmed.char_pointer(), static_cast<std::streamsize>(size));
+    stream.flush();
+
+    if (!stream)
+    {
+      throw StorageException("Unable to persist compression dictionary to: " + path_);
+    }
+  }
+
+  Register(trimmed);
+
+  return id;
+}
+
+std::size_t DocumentCompressor::dictionary_count() const
+{
+  return dictionaries_.size();
+}
+
+/**
+ * Build a dictionary out of the segments of the samples which share the most content with the
+ * other samples. The segments are selected greedily, discounting the substrings already covered,
+ * and are laid out with the most valuable ones at the end where deflate can reach them cheaply.
+ *
+ * @param samples The documents to train on
+ * @param size The target size of the dictionary
+ * @return The dictionary, empty if the samples share no content
+ */
+ConstByteArray DocumentCompressor::TrainDictionary(Samples const &samples, std::size_t size)
+{
+  size = std::min(size, MAX_DICTIONARY_SIZE);
+
+  // count the number of samples in which each substring occurs
+  KmerCounts counts;
+  for (auto const &sample : samples)
+  {
+    std::unordered_set<uint64_t> seen;
+
+    std::size_t const length = std::min(sample.size(), MAX_SAMPLE);
+    for (std::size_t i = 0; i + KMER_SIZE <= length; ++i)
+    {
+      uint64_t const kmer = KmerAt(sample.pointer() + i);
+      if (seen.insert(kmer).second)
+      {
+        ++counts[kmer];
+      }
+    }
+  }
+
+  // score the candidate segments, overlapping by half
+  std::priority_queue<Segment> candidates;
+  for (std::size_t i = 0; i < samples.size(); ++i)
+  {
+    std::size_t const length = std::min(samples[i].size(), MAX_SAMPLE);
+    for (std::size_t offset = 0; offset + KMER_SIZE <= length; offset += SEGMENT_SIZE / 2)
+    {
+      Segment segment;
+      segment.sample = i;
+      segment.offset = offset;
+      segment.length = std::min(SEGMENT_SIZE, length - offset);
+      segment.score  = ScoreSegment(samples[i], segment, counts);
+
+      if (segment.score != 0)
+      {
+        candidates.push(segment);
+      }
+    }
+  }
+
+  // greedy selection, since the scores only ever decrease a stale score is an upper bound and
+  // the candidate only needs to be rescored when it reaches the top
+  std::vector<Segment> selected;
+  std::size_t          total = 0;
+
+  while (!candidates.empty() && (total < size))
+  {
+    Segment segment = candidates.top();
+    candidates.pop();
+
+    segment.score = ScoreSegment(samples[segment.sample], segment, counts);
+    if (segment.score == 0)
+    {
+      continue;
+    }
+
+    if (!candidates.empty() && (segment.score < candidates.top().score))
+    {
+      candidates.push(segment);
+      continue;
+    }
+
+    // the substrings in this segment are now covered by the dictionary
+    for (std::size_t i = 0; i + KMER_SIZE <= segment.length; ++i)
+    {
+      counts.erase(KmerAt(samples[segment.sample].pointer() + segment.offset + i));
+    }
+
+    segment.length = std::min(segment.length, size - total);
+    total += segment.length;
+    selected.push_back(segment);
+  }
+
+  ByteArray   dictionary;
+  std::size_t offset = 0;
+
+  dictionary.Resize(total);
+  for (auto it = selected.rbegin(); it != selected.rend(); ++it)
+  {
+    std::memcpy(dictionary.pointer() + offset, samples[it->sample].pointer() + it->offset,
+                it->length);
+    offset += it->length;
+  }
+
+  return {dictionary};
+}
+
+/**
+ * Compress a document
+ *
+ * @param input The raw document
+ * @param output The encoded document, only set when the document is compressed
+ * @return The codec used, NONE when compression is disabled or would not reduce the size
+ */
+DocumentCodec DocumentCompressor::Compress(ConstByteArray const &input,
+                                           ConstByteArray &      output) const
+{
+  if (!options_.enabled || (input.size() < options_.min_size))
+  {
+    return DocumentCodec::NONE;
+  }
+
+  z_stream stream{};
+  if (deflateInit(&stream, options_.level) != Z_OK)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to initialise deflate stream");
+    return DocumentCodec::NONE;
+  }
+
+  if (!active_dictionary_.empty())
+  {
+    deflateSetDictionary(&stream, active_dictionary_.pointer(),
+                         static_cast<uInt>(active_dictionary_.size()));
+  }
+
+  ByteArray buffer;
+  buffer.Resize(deflateBound(&stream, static_cast<uLong>(input.size())));
+
+  stream.next_in   = const_cast<Bytef *>(input.pointer());
+  stream.avail_in  = static_cast<uInt>(input.size());
+  stream.next_out  = buffer.pointer();
+  stream.avail_out = static_cast<uInt>(buffer.size());
+
+  int const status = deflate(&stream, Z_FINISH);
+  deflateEnd(&stream);
+
+  if ((status != Z_STREAM_END) || (stream.total_out >= input.size()))
+  {
+    return DocumentCodec::NONE;
+  }
+
+  buffer.Resize(stream.total_out);
+  output = buffer;
+
+  return DocumentCodec::DEFLATE;
+}
+
+/**
+ * Decompress a document
+ *
+ * @param codec The codec the document was encoded with
+ * @param input The encoded document
+ * @return The raw document
+ */
+ConstByteArray DocumentCompressor::Decompress(DocumentCodec codec, ConstByteArray const &input) const
+{
+  if (codec == DocumentCodec::NONE)
+  {
+    return input;
+  }
+
+  if (codec != DocumentCodec::DEFLATE)
+  {
+    throw StorageException("Unknown document codec");
+  }
+
+  z_stream stream{};
+  if (inflateInit(&stream) != Z_OK)
+  {
+    throw StorageException("Unable to initialise inflate stream");
+  }
+
+  ByteArray buffer;
+  buffer.Resize(std::max<std::size_t>(input.size() * 4, 256));
+
+  stream.next_in  = const_cast<Bytef *>(input.pointer());
+  stream.avail_in = static_cast<uInt>(input.size());
+
+  int status = Z_OK;
+  while (status != Z_STREAM_END)
+  {
+    if (stream.total_out == buffer.size())
+    {
+      buffer.Resize(buffer.size() * 2);
+    }
+
+    stream.next_out  = buffer.pointer() + stream.total_out;
+    stream.avail_out = static_cast<uInt>(buffer.size() - stream.total_out);
+
+    status = inflate(&stream, Z_NO_FLUSH);
+
+    if (status == Z_NEED_DICT)
+    {
+      auto const it = dictionaries_.find(static_cast<DictionaryId>(stream.adler));
+      if (it == dictionaries_.end())
+      {
+        inflateEnd(&stream);
+        throw StorageException("Missing compression dictionary");
+      }
+
+      status = inflateSetDictionary(&stream, it->second.pointer(),
+                                    static_cast<uInt>(it->second.size()));
+    }
+
+    if ((status != Z_OK) && (status != Z_STREAM_END) && (status != Z_BUF_ERROR))
+    {
+      inflateEnd(&stream);
+      throw StorageException("Corrupt compressed document");
+    }
+
+    if ((status == Z_BUF_ERROR) && (stream.avail_in == 0))
+    {
+      inflateEnd(&stream);
+      throw StorageException("Truncated compressed document");
+    }
+  }
+
+  buffer.Resize(stream.total_out);
+  inflateEnd(&stream);
+
+  return {buffer};
+}
+
+void DocumentCompressor::Register(ConstByteArray const &dictionary)
+{
+  auto const id = static_cast<DictionaryId>(
+      adler32(adler32(0, Z_NULL, 0), dictionary.pointer(), static_cast<uInt>(dictionary.size())));
+
+  dictionaries_[id]  = dictionary;
+  active_dictionary_ = dictionary;
+}
+
+}  // namespace storage
+}  // namespace fetch
@@ -20,6 +20,9 @@
 
 #include "storage/new_revertible_document_store.hpp"
 
+#include <algorithm>
+#include <cstdio>
+
 using Hash           = fetch::storage::NewRevertibleDocumentStore::Hash;
 using ByteArray      = fetch::storage::NewRevertibleDocumentStore::ByteArray;
 using UnderlyingType = fetch::storage::NewRevertibleDocumentStore::UnderlyingType;
@@ -44,8 +47,45 @@ bool IsAllZeros(Hash const &hash)
 
   return all_zeros;
 }
+
+bool FileExists(std::string const &filename)
+{
+  std::FILE *handle = std::fopen(filename.c_str(), "rb");
+  if (handle)
+  {
+    std::fclose(handle);
+  }
+
+  return handle != nullptr;
+}
+
+std::string DirectoryOf(std::string const &filename)
+{
+  auto const pos = filename.rfind('/');
+  return (pos == std::string::npos) ? std::string{"."} : filename.substr(0, pos + 1);
+}
+
+std::string OldSegment(std::string const &log_path)
+{
+  return log_path + ".old";
+}
+
 }  // namespace
 
+constexpr std::size_t NewRevertibleDocumentStore::CHECKPOINT_INTERVAL;
+constexpr std::size_t NewRevertibleDocumentStore::COMPACTION_INTERVAL;
+constexpr std::size_t NewRevertibleDocumentStore::MIN_FINALITY_DEPTH;
+
+NewRevertibleDocumentStore::~NewRevertibleDocumentStore()
+{
+  WaitForCompaction();
+  WaitForCheckpoint();
+
+  // uncommitted writes have always been visible in the files, preserve this behaviour
+  FETCH_LOCK(lock_);
+  ApplyPendingWrites();
+}
+
 bool NewRevertibleDocumentStore::Load(std::string const &state, std::string const &state_history,
                                       std::string const &index, std::string const &index_history,
                                       bool create = true)
@@ -55,9 +95,14 @@ bool NewRevertibleDocumentStore::Load(std::string const &state, std::string cons
   state_history_path_ = state_history;
   index_path_         = index;
   index_history_path_ = index_history;
+  metrics_            = &metrics::StorageMetrics::Instance().DocumentStore(state);
 
   // trigger the load
   storage_.Load(state, state_history, index, index_history, create);
+
+  // recover any commits which were logged but not yet written to the stacks
+  OpenLog(true);
+
   return true;
 }
 
@@ -70,33 +115,122 @@ bool NewRevertibleDocumentStore::New(std::string const &state, std::string const
   state_history_path_ = state_history;
   index_path_         = index;
   index_history_path_ = index_history;
+  metrics_            = &metrics::StorageMetrics::Instance().DocumentStore(state);
 
   // trigger creation
   storage_.New(state, state_history, index, index_history);
 
+  OpenLog(false);
+
   return true;
 }
 
 UnderlyingType NewRevertibleDocumentStore::Get(ResourceID const &rid)
 {
+  FETCH_LOCK(lock_);
+
+  if (fork_active_)
+  {
+    return GetFromFork(rid, false);
+  }
+
+  auto const it = pending_.find(rid.id());
+  if (it != pending_.end())
+  {
+    UnderlyingType doc;
+    doc.document = it->second;
+    return doc;
+  }
+
   return storage_.Get(rid);
 }
 
 UnderlyingType NewRevertibleDocumentStore::GetOrCreate(ResourceID const &rid)
 {
-  return storage_.GetOrCreate(rid);
+  FETCH_LOCK(lock_);
+
+  if (fork_active_)
+  {
+    return GetFromFork(rid, true);
+  }
+
+  auto const it = pending_.find(rid.id());
+  if (it != pending_.end())
+  {
+    UnderlyingType doc;
+    doc.document = it->second;
+    return doc;
+  }
+
+  auto doc = storage_.GetOrCreate(rid);
+
+  // the document did not exist before this commit
+  if (forks_enabled_ && doc.was_created && (undo_.find(rid.id()) == undo_.end()))
+  {
+    UnderlyingType missing;
+    missing.failed = true;
+
+    undo_.emplace(rid.id(), missing);
+  }
+
+  return doc;
 }
 
 void NewRevertibleDocumentStore::Set(ResourceID const &rid, ByteArray const &value)
 {
-  return storage_.Set(rid, value);
+  FETCH_LOCK(lock_);
+
+  if (fork_active_)
+  {
+    fork_writes_[rid.id()] = value;
+    return;
+  }
+
+  pending_[rid.id()] = value;
 }
 
 // State-based operations
 Hash NewRevertibleDocumentStore::Commit()
 {
+  FETCH_LOCK(lock_);
+
+  auto const started = metrics::LatencyHistogram::Clock::now();
+
+  ApplyPendingWrites();
+
   Hash ret{std::move(storage_.Commit())};
   storage_.Flush(false);
+
+  // the previous documents of this commit allow forks to be made from its parent
+  parent_hash_ = forks_enabled_ ? head_hash_ : Hash{};
+  head_hash_   = ret;
+  head_undo_   = std::move(undo_);
+  undo_.clear();
+
+  // group commit: all the writes for this commit are made durable with a single sequential write
+  if (!log_.Append(unlogged_, ret))
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to write commit to the log, forcing checkpoint");
+
+    Checkpoint();
+  }
+  else if (++commits_since_checkpoint_ >= CHECKPOINT_INTERVAL)
+  {
+    StartCheckpoint();
+  }
+
+  unlogged_.clear();
+
+  if ((finality_depth_ != 0) && (++commits_since_compaction_ >= COMPACTION_INTERVAL))
+  {
+    StartCompaction();
+  }
+
+  if (metrics_)
+  {
+    metrics_->commit_latency.Record(metrics::LatencyHistogram::Clock::now() - started);
+  }
+
   return ret;
 }
 
@@ -104,13 +238,21 @@ bool NewRevertibleDocumentStore::RevertToHash(Hash const &state)
 {
   bool success{false};
 
+  FETCH_LOCK(lock_);
+
+  auto const started = metrics::LatencyHistogram::Clock::now();
+
+  // any uncommitted changes are lost in the revert
+  pending_.clear();
+  unlogged_.clear();
+
   if (IsAllZeros(state))
   {
     FETCH_LOG_DEBUG(LOGGING_NAME, "Reverting database back to initial state");
 
     // we are requesting to revert to a blank slate. The simplest way to handle this is to clear
     // out the database
-    storage_.New(state_path_, state_history_path_, index_path_, index_history_path_);
+    ClearStorage();
 
     success = true;
   }
@@ -119,23 +261,777 @@ bool NewRevertibleDocumentStore::RevertToHash(Hash const &state)
     success = storage_.RevertToHash(state);
   }
 
+  ResetUndo(success ? state : Hash{});
+
+  // the log only ever describes changes on top of the current stacks, since the revert has
+  // rewritten them the stacks are synced and the log is restarted
+  storage_.Flush(false);
+  Checkpoint();
+
+  if (metrics_)
+  {
+    metrics_->revert_latency.Record(metrics::LatencyHistogram::Clock::now() - started);
+  }
+
   return success;
 }
 
 bool NewRevertibleDocumentStore::HashExists(Hash const &hash)
 {
+  FETCH_LOCK(lock_);
   return storage_.HashExists(hash);
 }
 
 Hash NewRevertibleDocumentStore::CurrentHash()
 {
+  FETCH_LOCK(lock_);
+  ApplyPendingWrites();
   return storage_.CurrentHash();
 }
 
-std::size_t NewRevertibleDocumentStore::size() const
+std::size_t NewRevertibleDocumentStore::size()
 {
+  FETCH_LOCK(lock_);
+  ApplyPendingWrites();
   return storage_.size();
 }
 
+/**
+ * Create a snapshot of the complete state for a given commit. Only the current (committed) state
+ * of the store can be captured.
+ *
+ * @param hash The commit hash of the state
+ * @param entries_per_chunk The maximum number of documents in each chunk
+ * @param snapshot The snapshot to be populated
+ * @param filter If set, only the documents it accepts are included in the snapshot
+ * @return true if successful, otherwise false
+ */
+bool NewRevertibleDocumentStore::CreateSnapshot(Hash const &hash, std::size_t entries_per_chunk,
+                                                StateSnapshot &snapshot, Filter const &filter)
+{
+  FETCH_LOCK(lock_);
+
+  if (!pending_.empty() || !unlogged_.empty() || (entries_per_chunk == 0))
+  {
+    return false;
+  }
+
+  if (storage_.CurrentHash() != hash)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to create snapshot, 0x", hash.ToHex(),
+                   " is not the current state");
+    return false;
+  }
+
+  snapshot = StateSnapshot{};
+
+  // walk the complete state in key order, splitting it into chunks
+  StateSnapshotChunk chunk;
+  for (auto it = storage_.begin(), end = storage_.end(); it != end; ++it)
+  {
+    if (filter && !filter(it.GetKey()))
+    {
+      continue;
+    }
+
+    chunk.entries.emplace_back(it.GetKey().id(), (*it).document);
+
+    if (chunk.entries.size() >= entries_per_chunk)
+    {
+      chunk.index    = snapshot.chunks.size();
+      chunk.checksum = chunk.ComputeChecksum();
+      snapshot.chunks.push_back(std::move(chunk));
+      chunk = StateSnapshotChunk{};
+    }
+  }
+
+  if (!chunk.entries.empty())
+  {
+    chunk.index    = snapshot.chunks.size();
+    chunk.checksum = chunk.ComputeChecksum();
+    snapshot.chunks.push_back(std::move(chunk));
+  }
+
+  // build the manifest
+  crypto::SHA256 hasher;
+  hasher.Reset();
+
+  auto &manifest = snapshot.manifest;
+  for (auto const &current : snapshot.chunks)
+  {
+    hasher.Update(current.checksum);
+    manifest.num_entries += current.entries.size();
+  }
+
+  manifest.state_hash = hash;
+  manifest.num_chunks = snapshot.chunks.size();
+  manifest.checksum   = hasher.Final();
+
+  return true;
+}
+
+/**
+ * Start restoring the store from a snapshot. All the existing state is discarded.
+ *
+ * @param manifest The manifest of the snapshot to be restored
+ * @return true if successful, otherwise false
+ */
+bool NewRevertibleDocumentStore::BeginSnapshotRestore(StateSnapshotManifest const &manifest)
+{
+  FETCH_LOCK(lock_);
+
+  if (manifest.empty())
+  {
+    return false;
+  }
+
+  // the existing state (and any logged commits on top of it) are discarded
+  ClearStorage();
+  Checkpoint();
+
+  restore_active_     = true;
+  restore_manifest_   = manifest;
+  restore_next_chunk_ = 0;
+  restore_entries_    = 0;
+  restore_hasher_.Reset();
+
+  return true;
+}
+
+/**
+ * Restore the next chunk of the snapshot. Chunks must be supplied in order.
+ *
+ * @param chunk The chunk to be restored
+ * @return true if successful, otherwise false
+ */
+bool NewRevertibleDocumentStore::RestoreSnapshotChunk(StateSnapshotChunk const &chunk)
+{
+  FETCH_LOCK(lock_);
+
+  if (!restore_active_ || (chunk.index != restore_next_chunk_) ||
+      (chunk.index >= restore_manifest_.num_chunks))
+  {
+    return false;
+  }
+
+  if (!chunk.IsValid())
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Snapshot chunk ", chunk.index, " failed checksum");
+    return false;
+  }
+
+  for (auto const &entry : chunk.entries)
+  {
+    if (entry.first.size() != ResourceID::RESOURCE_ID_SIZE_IN_BYTES)
+    {
+      return false;
+    }
+
+    storage_.Set(ResourceID{entry.first}, entry.second);
+  }
+
+  restore_hasher_.Update(chunk.checksum);
+  restore_entries_ += chunk.entries.size();
+  ++restore_next_chunk_;
+
+  return true;
+}
+
+/**
+ * Complete the snapshot restore, committing the restored state. If the restored state does not
+ * match the manifest the store is cleared.
+ *
+ * @return true if the state was successfully restored, otherwise false
+ */
+bool NewRevertibleDocumentStore::CompleteSnapshotRestore()
+{
+  FETCH_LOCK(lock_);
+
+  if (!restore_active_)
+  {
+    return false;
+  }
+
+  restore_active_ = false;
+
+  bool success = (restore_next_chunk_ == restore_manifest_.num_chunks) &&
+                 (restore_entries_ == restore_manifest_.num_entries) &&
+                 (restore_hasher_.Final() == restore_manifest_.checksum);
+
+  if (success)
+  {
+    Hash const hash = storage_.Commit();
+    storage_.Flush(false);
+
+    success = (hash == restore_manifest_.state_hash);
+    ResetUndo(success ? hash : Hash{});
+  }
+
+  if (!success)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Snapshot restore failed for state: 0x",
+                   restore_manifest_.state_hash.ToHex());
+
+    ClearStorage();
+  }
+
+  // the restored state is written directly to the stacks, make it durable and restart the log
+  Checkpoint();
+
+  return success;
+}
+
+/**
+ * Write the documents of a snapshot chunk on top of the current state, as if each had been Set.
+ * Unlike a restore the existing state is kept, the documents are part of the next commit.
+ *
+ * @param chunk The chunk to be merged
+ * @return true if successful, otherwise false
+ */
+bool NewRevertibleDocumentStore::MergeSnapshotChunk(StateSnapshotChunk const &chunk)
+{
+  if (!chunk.IsValid())
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Snapshot chunk ", chunk.index, " failed checksum");
+    return false;
+  }
+
+  for (auto const &entry : chunk.entries)
+  {
+    if (entry.first.size() != ResourceID::RESOURCE_ID_SIZE_IN_BYTES)
+    {
+      return false;
+    }
+  }
+
+  FETCH_LOCK(lock_);
+
+  if (fork_active_ || restore_active_)
+  {
+    return false;
+  }
+
+  for (auto const &entry : chunk.entries)
+  {
+    pending_[entry.first] = entry.second;
+  }
+
+  return true;
+}
+
+/**
+ * Set the number of most recent commits which can be reverted to. Older history is periodically
+ * discarded. The depth is never less than MIN_FINALITY_DEPTH, since the commits in the log must
+ * remain recognisable on replay.
+ *
+ * @param depth The finality depth, or zero to keep the complete history
+ */
+void NewRevertibleDocumentStore::SetFinalityDepth(std::size_t depth)
+{
+  FETCH_LOCK(lock_);
+  finality_depth_ = (depth == 0) ? 0 : std::max(depth, MIN_FINALITY_DEPTH);
+}
+
+std::size_t NewRevertibleDocumentStore::finality_depth()
+{
+  FETCH_LOCK(lock_);
+  return finality_depth_;
+}
+
+/**
+ * Compact the history of the store now, waiting for the compaction to complete
+ *
+ * @return The number of commits which can no longer be reverted to
+ */
+std::size_t NewRevertibleDocumentStore::Compact()
+{
+  WaitForCompaction();
+
+  std::size_t depth{0};
+  {
+    FETCH_LOCK(lock_);
+    depth = finality_depth_;
+  }
+
+  bool expected{false};
+  if ((depth == 0) || !compaction_active_.compare_exchange_strong(expected, true))
+  {
+    return 0;
+  }
+
+  std::size_t const dropped = RunCompaction(depth);
+  compaction_active_        = false;
+
+  return dropped;
+}
+
+/**
+ * Enable (or disable) making forks of the state. When enabled the previous documents of each
+ * commit are recorded, so that forks can also be made from the parent of the last commit. This
+ * should be configured before the first commit.
+ *
+ * @param enable Whether forks are enabled
+ */
+void NewRevertibleDocumentStore::EnableForks(bool enable)
+{
+  FETCH_LOCK(lock_);
+
+  forks_enabled_ = enable;
+  ResetUndo(head_hash_);
+
+  fork_active_ = false;
+  fork_base_   = Hash{};
+  fork_writes_.clear();
+  fork_created_.clear();
+}
+
+/**
+ * Start executing on a fork of the state. Until the fork is ended all the reads observe the state
+ * of the base (plus the writes made on the fork) and all the writes are held aside. Any previous
+ * fork is discarded.
+ *
+ * @param base The hash of the state to fork from, either the last commit or its parent
+ * @return true if successful, otherwise false
+ */
+bool NewRevertibleDocumentStore::BeginFork(Hash const &base)
+{
+  FETCH_LOCK(lock_);
+
+  // a fork can only be made when there are no uncommitted changes in the store
+  bool const clean = pending_.empty() && unlogged_.empty() && undo_.empty();
+  bool const known = !base.empty() && ((base == head_hash_) || (base == parent_hash_));
+
+  if (!forks_enabled_ || fork_active_ || !clean || !known)
+  {
+    return false;
+  }
+
+  fork_active_ = true;
+  fork_base_   = base;
+  fork_writes_.clear();
+  fork_created_.clear();
+
+  return true;
+}
+
+/**
+ * Stop executing on the fork, the writes made on it are kept to be applied later
+ *
+ * @return true if successful, false if there is no active fork
+ */
+bool NewRevertibleDocumentStore::EndFork()
+{
+  FETCH_LOCK(lock_);
+
+  if (!fork_active_)
+  {
+    return false;
+  }
+
+  fork_active_ = false;
+  return true;
+}
+
+/**
+ * Apply the writes made on the (ended) fork, as uncommitted changes on top of the current state.
+ * The store must have been reverted to (or committed) the state the fork was made from.
+ *
+ * @param base The hash of the state the fork was made from
+ * @return true if successful, otherwise false
+ */
+bool NewRevertibleDocumentStore::ApplyFork(Hash const &base)
+{
+  FETCH_LOCK(lock_);
+
+  bool const clean = pending_.empty() && unlogged_.empty() && undo_.empty();
+
+  if (fork_active_ || fork_base_.empty() || (fork_base_ != base) || (head_hash_ != base) || !clean)
+  {
+    return false;
+  }
+
+  // create the documents in the same order as the execution would have
+  for (auto const &key : fork_created_)
+  {
+    auto const doc = storage_.GetOrCreate(ResourceID{key});
+
+    if (forks_enabled_ && doc.was_created && (undo_.find(key) == undo_.end()))
+    {
+      UnderlyingType missing;
+      missing.failed = true;
+
+      undo_.emplace(key, missing);
+    }
+  }
+
+  pending_ = std::move(fork_writes_);
+
+  fork_base_ = Hash{};
+  fork_writes_.clear();
+  fork_created_.clear();
+
+  return true;
+}
+
+/**
+ * Drop the fork and all the writes made on it
+ */
+void NewRevertibleDocumentStore::DiscardFork()
+{
+  FETCH_LOCK(lock_);
+
+  fork_active_ = false;
+  fork_base_   = Hash{};
+  fork_writes_.clear();
+  fork_created_.clear();
+}
+
+/**
+ * Lookup a document on the active fork (the lock must be held)
+ *
+ * @param rid The resource id of the document
+ * @param create Whether the document should be created if it does not exist
+ * @return The document
+ */
+UnderlyingType NewRevertibleDocumentStore::GetFromFork(ResourceID const &rid, bool create)
+{
+  UnderlyingType doc;
+
+  auto const key = rid.id();
+
+  auto const it = fork_writes_.find(key);
+  if (it != fork_writes_.end())
+  {
+    doc.document = it->second;
+    return doc;
+  }
+
+  // documents created earlier on the fork are empty
+  if (std::find(fork_created_.begin(), fork_created_.end(), key) != fork_created_.end())
+  {
+    return doc;
+  }
+
+  // when forked from the parent of the last commit, the documents changed by the last commit are
+  // read from their previous versions
+  auto const undo = head_undo_.find(key);
+  if ((fork_base_ != head_hash_) && (undo != head_undo_.end()))
+  {
+    doc = undo->second;
+  }
+  else
+  {
+    doc = storage_.Get(rid);
+  }
+
+  // the document is only created in the storage when the fork is applied
+  if (create && doc.failed)
+  {
+    fork_created_.push_back(key);
+
+    doc             = UnderlyingType{};
+    doc.was_created = true;
+  }
+
+  return doc;
+}
+
+/**
+ * Forget the previous documents of the commits, after the state has been replaced
+ *
+ * @param head The hash of the current state
+ */
+void NewRevertibleDocumentStore::ResetUndo(Hash const &head)
+{
+  head_hash_   = head;
+  parent_hash_ = Hash{};
+  undo_.clear();
+  head_undo_.clear();
+}
+
+/**
+ * Remove all the contents of the store
+ */
+void NewRevertibleDocumentStore::ClearStorage()
+{
+  pending_.clear();
+  unlogged_.clear();
+  ResetUndo(Hash{});
+
+  storage_.New(state_path_, state_history_path_, index_path_, index_history_path_);
+}
+
+/**
+ * Write all the buffered changes into the underlying storage (in key order)
+ */
+void NewRevertibleDocumentStore::ApplyPendingWrites()
+{
+  for (auto const &entry : pending_)
+  {
+    // record the previous document the first time it is changed after a commit
+    if (forks_enabled_ && (undo_.find(entry.first) == undo_.end()))
+    {
+      undo_.emplace(entry.first, storage_.Get(ResourceID{entry.first}));
+    }
+
+    storage_.Set(ResourceID{entry.first}, entry.second);
+    unlogged_.push_back({entry.first, entry.second});
+  }
+
+  pending_.clear();
+}
+
+/**
+ * Open the write ahead log for the store, optionally replaying its contents
+ *
+ * @param replay Whether the contents of an existing log should be recovered
+ */
+void NewRevertibleDocumentStore::OpenLog(bool replay)
+{
+  WaitForCompaction();
+  WaitForCheckpoint();
+
+  FETCH_LOCK(lock_);
+
+  pending_.clear();
+  unlogged_.clear();
+
+  log_path_ = state_path_ + ".wal";
+
+  if (replay)
+  {
+    ReplayLog(OldSegment(log_path_));
+    ReplayLog(log_path_);
+  }
+
+  // the replayed (or newly created) state is now made durable and the log restarted
+  Checkpoint();
+}
+
+/**
+ * Apply all the commits from a log segment which are not already present in the storage
+ *
+ * @param filename The path to the log segment
+ */
+void NewRevertibleDocumentStore::ReplayLog(std::string const &filename)
+{
+  if (!FileExists(filename))
+  {
+    return;
+  }
+
+  WriteAheadLog segment;
+  if (!segment.Open(filename, false))
+  {
+    return;
+  }
+
+  std::size_t recovered = 0;
+  segment.Replay([this, &recovered](WriteAheadLog::Records const &records, Hash const &hash) {
+    if (storage_.HashExists(hash))
+    {
+      return;
+    }
+
+    for (auto const &record : records)
+    {
+      storage_.Set(ResourceID{record.key}, record.value);
+    }
+
+    Hash const replayed_hash = storage_.Commit();
+    storage_.Flush(false);
+
+    if (replayed_hash != hash)
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Replayed commit hash mismatch. Expected: 0x", hash.ToHex(),
+                     " Actual: 0x", replayed_hash.ToHex());
+    }
+
+    ++recovered;
+  });
+
+  if (recovered > 0)
+  {
+    FETCH_LOG_INFO(LOGGING_NAME, "Recovered ", recovered, " commit(s) from ", filename);
+  }
+}
+
+/**
+ * Rotate the log and sync the stacks to disk in the background. Once complete the old log segment
+ * is removed. If a previous checkpoint is still in progress the request is deferred until the
+ * next commit.
+ */
+void NewRevertibleDocumentStore::StartCheckpoint()
+{
+  if (checkpoint_active_)
+  {
+    return;
+  }
+
+  if (checkpoint_thread_.joinable())
+  {
+    checkpoint_thread_.join();
+  }
+
+  // rotate the log, new commits are written to a fresh segment
+  std::string const old_segment = OldSegment(log_path_);
+
+  log_.Close();
+  if (std::rename(log_path_.c_str(), old_segment.c_str()) != 0)
+  {
+    Checkpoint();
+    return;
+  }
+
+  if (!log_.Open(log_path_, true))
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to create log file: ", log_path_);
+  }
+
+  WriteAheadLog::SyncFile(DirectoryOf(log_path_));
+
+  commits_since_checkpoint_ = 0;
+  checkpoint_active_        = true;
+
+  checkpoint_thread_ = std::thread([this, old_segment](FileList const &files) {
+    bool success = true;
+    for (auto const &file : files)
+    {
+      success &= WriteAheadLog::SyncFile(file);
+    }
+
+    // the stacks are durable so the old segment is no longer needed
+    if (success)
+    {
+      std::remove(old_segment.c_str());
+    }
+    else
+    {
+      FETCH_LOG_WARN(LOGGING_NAME, "Failed to sync storage, keeping log segment: ", old_segment);
+    }
+
+    checkpoint_active_ = false;
+  }, StorageFiles());
+}
+
+/**
+ * Wait for any background checkpoint to complete
+ */
+void NewRevertibleDocumentStore::WaitForCheckpoint()
+{
+  if (checkpoint_thread_.joinable())
+  {
+    checkpoint_thread_.join();
+  }
+}
+
+/**
+ * Synchronously sync the stacks to disk and discard all the log segments
+ */
+void NewRevertibleDocumentStore::Checkpoint()
+{
+  WaitForCheckpoint();
+
+  for (auto const &file : StorageFiles())
+  {
+    WriteAheadLog::SyncFile(file);
+  }
+
+  std::remove(OldSegment(log_path_).c_str());
+
+  if (!log_.Open(log_path_, true))
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to create log file: ", log_path_);
+  }
+
+  commits_since_checkpoint_ = 0;
+}
+
+/**
+ * Start a compaction of the history on a background thread, unless one is already in progress
+ */
+void NewRevertibleDocumentStore::StartCompaction()
+{
+  bool expected{false};
+  if (!compaction_active_.compare_exchange_strong(expected, true))
+  {
+    return;
+  }
+
+  if (compaction_thread_.joinable())
+  {
+    compaction_thread_.join();
+  }
+
+  commits_since_compaction_ = 0;
+
+  compaction_thread_ = std::thread([this](std::size_t depth) {
+    RunCompaction(depth);
+    compaction_active_ = false;
+  }, finality_depth_);
+}
+
+/**
+ * Wait for any background compaction to complete
+ */
+void NewRevertibleDocumentStore::WaitForCompaction()
+{
+  if (compaction_thread_.joinable())
+  {
+    compaction_thread_.join();
+  }
+}
+
+/**
+ * Drop the history older than the finality depth. The lock is only held while the compaction
+ * begins and completes, the history is copied without blocking readers or writers. Any revert in
+ * the meantime causes the compaction to be abandoned.
+ *
+ * @param depth The finality depth
+ * @return The number of commits which can no longer be reverted to
+ */
+std::size_t NewRevertibleDocumentStore::RunCompaction(std::size_t depth)
+{
+  {
+    FETCH_LOCK(lock_);
+
+    if (!storage_.BeginCompaction(depth))
+    {
+      return 0;
+    }
+  }
+
+  storage_.RunCompaction();
+
+  FETCH_LOCK(lock_);
+
+  std::size_t const dropped = storage_.CompleteCompaction();
+  if (dropped > 0)
+  {
+    // make the replaced history files durable
+    WriteAheadLog::SyncFile(DirectoryOf(state_history_path_));
+    WriteAheadLog::SyncFile(DirectoryOf(index_history_path_));
+
+    FETCH_LOG_INFO(LOGGING_NAME, "Compacted history, dropped ", dropped, " commit(s)");
+  }
+
+  return dropped;
+}
+
+/**
+ * Get the list of files which make up the underlying storage
+ *
+ * @return The list of file paths
+ */
+NewRevertibleDocumentStore::FileList NewRevertibleDocumentStore::StorageFiles() const
+{
+  return {state_path_,
+          state_history_path_,
+          "hash_history_" + state_history_path_,
+          index_path_,
+          index_history_path_,
+          "hash_history_" + index_history_path_};
+}
+
 }  // namespace storage
 }  // namespace fetch
@@ -0,0 +1,397 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "storage/write_ahead_log.hpp"
+#include "core/byte_array/byte_array.hpp"
+#include "core/logger.hpp"
+#include "crypto/fnv_detail.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace fetch {
+namespace storage {
+namespace {
+
+using byte_array::ByteArray;
+using byte_array::ConstByteArray;
+
+constexpr uint32_t GROUP_MAGIC = 0x47574c46;  // "FLWG"
+
+struct GroupHeader
+{
+  uint32_t magic;
+  uint32_t count;
+  uint64_t length;
+};
+
+uint64_t Checksum(uint8_t const *data, std::size_t size)
+{
+  crypto::detail::FNV1a hash;
+  hash.update(data, size);
+  return static_cast<uint64_t>(hash.context());
+}
+
+template <typename T>
+void WriteValue(ByteArray &buffer, std::size_t &offset, T const &value)
+{
+  std::memcpy(buffer.pointer() + offset, &value, sizeof(T));
+  offset += sizeof(T);
+}
+
+void WriteBlob(ByteArray &buffer, std::size_t &offset, ConstByteArray const &blob)
+{
+  WriteValue(buffer, offset, static_cast<uint32_t>(blob.size()));
+  std::memcpy(buffer.pointer() + offset, blob.pointer(), blob.size());
+  offset += blob.size();
+}
+
+bool ReadBlob(ConstByteArray const &payload, std::size_t &offset, ConstByteArray &blob)
+{
+  uint32_t length = 0;
+  if (offset + sizeof(length) > payload.size())
+  {
+    return false;
+  }
+
+  std::memcpy(&length, payload.pointer() + offset, sizeof(length));
+  offset += sizeof(length);
+
+  if (offset + length > payload.size())
+  {
+    return false;
+  }
+
+  blob = payload.SubArray(offset, length);
+  offset += length;
+  return true;
+}
+
+bool WriteAll(int fd, uint8_t const *data, std::size_t size)
+{
+  while (size > 0)
+  {
+    ssize_t const written = ::write(fd, data, size);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+
+      return false;
+    }
+
+    data += written;
+    size -= static_cast<std::size_t>(written);
+  }
+
+  return true;
+}
+
+}  // namespace
+
+WriteAheadLog::~WriteAheadLog()
+{
+  Close();
+}
+
+/**
+ * Open (or create) the log file
+ *
+ * @param filename The path to the log file
+ * @param truncate Whether any existing contents should be discarded
+ * @return true if successful, otherwise false
+ */
+bool WriteAheadLog::Open(std::string const &filename, bool truncate)
+{
+  Close();
+
+  int flags = O_RDWR | O_CREAT;
+  if (truncate)
+  {
+    flags |= O_TRUNC;
+  }
+
+  fd_ = ::open(filename.c_str(), flags, 0644);
+  if (fd_ < 0)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Unable to open log file: ", filename, " (", std::strerror(errno),
+                   ")");
+    return false;
+  }
+
+  filename_ = filename;
+  size_     = static_cast<uint64_t>(::lseek(fd_, 0, SEEK_END));
+  metrics_  = &metrics::StorageMetrics::Instance().Stack(filename_);
+
+  return true;
+}
+
+void WriteAheadLog::Close()
+{
+  if (fd_ >= 0)
+  {
+    ::close(fd_);
+    fd_ = -1;
+  }
+
+  size_ = 0;
+}
+
+bool WriteAheadLog::is_open() const
+{
+  return fd_ >= 0;
+}
+
+/**
+ * Discard all the groups in the log. Only safe once the changes they describe are durable
+ * elsewhere
+ *
+ * @return true if successful, otherwise false
+ */
+bool WriteAheadLog::Truncate()
+{
+  if (!is_open())
+  {
+    return false;
+  }
+
+  if ((::ftruncate(fd_, 0) != 0) || (::lseek(fd_, 0, SEEK_SET) != 0))
+  {
+    return false;
+  }
+
+  size_ = 0;
+  return Sync(false);
+}
+
+/**
+ * Append a group of records to the log. The whole group is written with a single write call and
+ * synced to disk before returning.
+ *
+ * @param records The key value records of the group
+ * @param hash The state hash associated with the group
+ * @return true if the group is durable, otherwise false
+ */
+bool WriteAheadLog::Append(Records const &records, ConstByteArray const &hash)
+{
+  if (!is_open())
+  {
+    return false;
+  }
+
+  // compute the size of the payload
+  std::size_t length = sizeof(uint32_t) + hash.size();
+  for (auto const &record : records)
+  {
+    length += (2 * sizeof(uint32_t)) + record.key.size() + record.value.size();
+  }
+
+  GroupHeader const header{GROUP_MAGIC, static_cast<uint32_t>(records.size()), length};
+
+  ByteArray buffer;
+  buffer.Resize(sizeof(GroupHeader) + length + sizeof(uint64_t));
+
+  std::size_t offset = 0;
+  WriteValue(buffer, offset, header);
+
+  for (auto const &record : records)
+  {
+    WriteBlob(buffer, offset, record.key);
+    WriteBlob(buffer, offset, record.value);
+  }
+  WriteBlob(buffer, offset, hash);
+
+  WriteValue(buffer, offset, Checksum(buffer.pointer() + sizeof(GroupHeader), length));
+  assert(offset == buffer.size());
+
+  if (!WriteAll(fd_, buffer.pointer(), buffer.size()))
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Failed to append to log file: ", filename_, " (",
+                   std::strerror(errno), ")");
+    return false;
+  }
+
+  size_ += buffer.size();
+
+  if (metrics_)
+  {
+    metrics_->RecordWrite(buffer.size());
+  }
+
+  return Sync(true);
+}
+
+/**
+ * Read back all of the complete groups in the log, in the order that they were written. An
+ * incomplete or corrupt group terminates the replay and is removed from the log.
+ *
+ * @param callback The handler to be called for each group
+ * @return The number of groups replayed
+ */
+std::size_t WriteAheadLog::Replay(ReplayCallback const &callback)
+{
+  if (!is_open())
+  {
+    return 0;
+  }
+
+  // read the complete log into memory
+  ByteArray contents;
+  contents.Resize(size_);
+
+  std::size_t total = 0;
+  while (total < contents.size())
+  {
+    ssize_t const amount =
+        ::pread(fd_, contents.pointer() + total, contents.size() - total, off_t(total));
+    if (amount <= 0)
+    {
+      if ((amount < 0) && (errno == EINTR))
+      {
+        continue;
+      }
+
+      break;
+    }
+
+    total += static_cast<std::size_t>(amount);
+  }
+
+  std::size_t offset   = 0;
+  std::size_t replayed = 0;
+  while ((offset + sizeof(GroupHeader)) <= total)
+  {
+    GroupHeader header{};
+    std::memcpy(&header, contents.pointer() + offset, sizeof(GroupHeader));
+
+    std::size_t const payload_offset = offset + sizeof(GroupHeader);
+    if ((header.magic != GROUP_MAGIC) ||
+        ((payload_offset + header.length + sizeof(uint64_t)) > total) ||
+        ((uint64_t{header.count} * 2 * sizeof(uint32_t)) > header.length))
+    {
+      break;
+    }
+
+    uint64_t checksum = 0;
+    std::memcpy(&checksum, contents.pointer() + payload_offset + header.length, sizeof(checksum));
+    if (checksum != Checksum(contents.pointer() + payload_offset, header.length))
+    {
+      break;
+    }
+
+    // decode the records
+    ConstByteArray const payload =
+        ConstByteArray(contents).SubArray(payload_offset, header.length);
+    std::size_t    position = 0;
+    Records        records(header.count);
+    ConstByteArray hash;
+
+    bool valid = true;
+    for (auto &record : records)
+    {
+      valid = valid && ReadBlob(payload, position, record.key) &&
+              ReadBlob(payload, position, record.value);
+    }
+    valid = valid && ReadBlob(payload, position, hash);
+
+    if (!valid)
+    {
+      break;
+    }
+
+    callback(records, hash);
+
+    offset = payload_offset + header.length + sizeof(checksum);
+    ++replayed;
+  }
+
+  // remove the damaged tail so that further groups are appended to a valid log
+  if (offset != size_)
+  {
+    FETCH_LOG_WARN(LOGGING_NAME, "Discarding ", size_ - offset, " bytes from the end of ",
+                   filename_);
+
+    if (::ftruncate(fd_, off_t(offset)) == 0)
+    {
+      size_ = offset;
+      ::lseek(fd_, off_t(offset), SEEK_SET);
+    }
+  }
+
+  return replayed;
+}
+
+/**
+ * Get the size of the log in bytes
+ *
+ * @return The size in bytes
+ */
+uint64_t WriteAheadLog::size() const
+{
+  return size_;
+}
+
+/**
+ * Sync the log file to disk, recording the latency of the operation
+ *
+ * @param data_only Whether only the data (and not all the metadata) of the file needs syncing
+ * @return true if successful, otherwise false
+ */
+bool WriteAheadLog::Sync(bool data_only)
+{
+  auto const started = metrics::LatencyHistogram::Clock::now();
+
+  bool const success = ((data_only) ? ::fdatasync(fd_) : ::fsync(fd_)) == 0;
+
+  if (metrics_)
+  {
+    metrics_->flush_latency.Record(metrics::LatencyHistogram::Clock::now() - started);
+  }
+
+  return success;
+}
+
+/**
+ * Ensure that all the previously written contents of a file are on disk
+ *
+ * @param filename The path to the file
+ * @return true if successful, otherwise false
+ */
+bool WriteAheadLog::SyncFile(std::string const &filename)
+{
+  int const fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+
+  bool const success = (::fsync(fd) == 0);
+  ::close(fd);
+
+  return success;
+}
+
+}  // namespace storage
+}  // namespace fetch
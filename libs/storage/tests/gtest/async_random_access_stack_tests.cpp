@@ -0,0 +1,161 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/random/lfg.hpp"
+#include "storage/async_random_access_stack.hpp"
+#include "storage/cached_random_access_stack.hpp"
+#include "storage/random_access_stack.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <vector>
+
+using namespace fetch::storage;
+
+namespace {
+
+struct TestElement
+{
+  uint64_t first  = 0;
+  uint64_t second = 0;
+
+  bool operator==(TestElement const &other) const
+  {
+    return (first == other.first) && (second == other.second);
+  }
+};
+
+class AsyncRandomAccessStackTests : public ::testing::TestWithParam<AsyncIoBackend>
+{
+protected:
+  void TearDown() override
+  {
+    std::remove("async_stack.db");
+  }
+
+  fetch::random::LaggedFibonacciGenerator<> lfg_;
+};
+
+}  // namespace
+
+TEST_P(AsyncRandomAccessStackTests, batched_gets_match_pushed_values)
+{
+  AsyncRandomAccessStack<TestElement> stack{GetParam(), 8};
+  stack.New("async_stack.db");
+
+  std::vector<TestElement> reference;
+  for (std::size_t i = 0; i < 500; ++i)
+  {
+    TestElement element;
+    element.first  = lfg_();
+    element.second = i;
+
+    stack.Push(element);
+    reference.push_back(element);
+  }
+
+  // request more objects than the queue depth in a random order
+  std::vector<uint64_t> indices;
+  for (std::size_t i = 0; i < 200; ++i)
+  {
+    indices.push_back(lfg_() % reference.size());
+  }
+
+  std::vector<TestElement> objects(indices.size());
+  std::vector<bool>        completed(indices.size(), false);
+
+  EXPECT_TRUE(stack.GetBatch(indices, objects.data(), [&completed](std::size_t index, bool success) {
+    EXPECT_TRUE(success);
+    completed[index] = true;
+  }));
+
+  for (std::size_t i = 0; i < indices.size(); ++i)
+  {
+    EXPECT_TRUE(completed[i]);
+    EXPECT_EQ(objects[i], reference[indices[i]]);
+  }
+}
+
+TEST_P(AsyncRandomAccessStackTests, file_is_compatible_with_random_access_stack)
+{
+  {
+    RandomAccessStack<TestElement> stack;
+    stack.New("async_stack.db");
+    stack.SetExtraHeader(42);
+
+    for (uint64_t i = 0; i < 10; ++i)
+    {
+      stack.Push(TestElement{i, i * i});
+    }
+
+    stack.Flush();
+  }
+
+  {
+    AsyncRandomAccessStack<TestElement> stack{GetParam()};
+    stack.Load("async_stack.db");
+
+    ASSERT_EQ(stack.size(), 10u);
+    EXPECT_EQ(stack.header_extra(), 42u);
+
+    stack.Set(3, TestElement{3, 0});
+    stack.Push(TestElement{10, 100});
+  }
+
+  RandomAccessStack<TestElement> stack;
+  stack.Load("async_stack.db");
+
+  ASSERT_EQ(stack.size(), 11u);
+
+  TestElement element;
+  stack.Get(3, element);
+  EXPECT_EQ(element, (TestElement{3, 0}));
+  stack.Get(10, element);
+  EXPECT_EQ(element, (TestElement{10, 100}));
+}
+
+TEST_P(AsyncRandomAccessStackTests, cached_stack_batches_misses)
+{
+  CachedRandomAccessStack<TestElement, uint64_t, AsyncRandomAccessStack<TestElement>> stack;
+  stack.New("async_stack.db");
+
+  for (uint64_t i = 0; i < 100; ++i)
+  {
+    stack.Push(TestElement{i, i + 1});
+  }
+  stack.Flush();
+
+  // a mix of cached and uncached elements
+  TestElement element;
+  stack.Get(5, element);
+
+  std::vector<TestElement> objects;
+  stack.GetBatch({5, 50, 99, 0, 50}, objects);
+
+  ASSERT_EQ(objects.size(), 5u);
+  EXPECT_EQ(objects[0], (TestElement{5, 6}));
+  EXPECT_EQ(objects[1], (TestElement{50, 51}));
+  EXPECT_EQ(objects[2], (TestElement{99, 100}));
+  EXPECT_EQ(objects[3], (TestElement{0, 1}));
+  EXPECT_EQ(objects[4], (TestElement{50, 51}));
+}
+
+INSTANTIATE_TEST_CASE_P(AllBackends, AsyncRandomAccessStackTests,
+                        ::testing::Values(AsyncIoBackend::AUTO, AsyncIoBackend::IO_URING,
+                                          AsyncIoBackend::LINUX_AIO, AsyncIoBackend::SYNCHRONOUS), );
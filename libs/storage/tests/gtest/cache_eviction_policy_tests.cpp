@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "storage/cache_eviction_policy.hpp"
+
+#include <gtest/gtest.h>
+
+using fetch::storage::ClockEvictionPolicy;
+using fetch::storage::CreateEvictionPolicy;
+using fetch::storage::EvictionPolicy;
+using fetch::storage::LRUEvictionPolicy;
+using fetch::storage::TwoQueueEvictionPolicy;
+
+namespace {
+
+TEST(CacheEvictionPolicyTests, LRUEvictsLeastRecentlyUsed)
+{
+  LRUEvictionPolicy policy;
+  policy.OnInsert(1);
+  policy.OnInsert(2);
+  policy.OnInsert(3);
+  policy.OnAccess(1);
+
+  EXPECT_EQ(policy.size(), 3);
+  EXPECT_EQ(policy.Evict(), 2);
+  EXPECT_EQ(policy.Evict(), 3);
+  EXPECT_EQ(policy.Evict(), 1);
+  EXPECT_EQ(policy.size(), 0);
+}
+
+TEST(CacheEvictionPolicyTests, ClockGivesSecondChance)
+{
+  ClockEvictionPolicy policy;
+  policy.OnInsert(1);
+  policy.OnInsert(2);
+  policy.OnInsert(3);
+  policy.OnAccess(1);
+  policy.OnAccess(2);
+
+  EXPECT_EQ(policy.Evict(), 3);
+
+  // freed slots are reused by new lines
+  policy.OnInsert(4);
+  EXPECT_EQ(policy.size(), 3);
+
+  // both 1 and 2 have now lost their reference bits, the hand continues from the start
+  EXPECT_EQ(policy.Evict(), 1);
+  EXPECT_EQ(policy.Evict(), 2);
+  EXPECT_EQ(policy.Evict(), 4);
+}
+
+TEST(CacheEvictionPolicyTests, TwoQueueIsScanResistant)
+{
+  static constexpr std::size_t CAPACITY = 8;
+  TwoQueueEvictionPolicy       policy{CAPACITY};
+
+  // establish a hot working set: lines are loaded, evicted into the ghost queue and reloaded
+  for (uint64_t line = 0; line < 4; ++line)
+  {
+    policy.OnInsert(line);
+  }
+  for (uint64_t line = 0; line < 4; ++line)
+  {
+    EXPECT_EQ(policy.Evict(), line);
+  }
+  for (uint64_t line = 0; line < 4; ++line)
+  {
+    policy.OnInsert(line);
+  }
+
+  // a long scan must only ever evict other scanned lines
+  for (uint64_t line = 100; line < 200; ++line)
+  {
+    if (policy.size() >= CAPACITY)
+    {
+      auto const evicted = policy.Evict();
+      EXPECT_GE(evicted, 100);
+    }
+
+    policy.OnInsert(line);
+  }
+}
+
+TEST(CacheEvictionPolicyTests, Factory)
+{
+  for (auto type : {EvictionPolicy::LRU, EvictionPolicy::CLOCK, EvictionPolicy::TWO_QUEUE})
+  {
+    auto policy = CreateEvictionPolicy(type, 4);
+    ASSERT_TRUE(policy);
+
+    policy->OnInsert(10);
+    policy->OnInsert(11);
+    EXPECT_EQ(policy->size(), 2);
+
+    policy->Clear();
+    EXPECT_EQ(policy->size(), 0);
+  }
+}
+
+}  // namespace
@@ -36,9 +36,7 @@ public:
   }
 };
 
-// fails on swap operation - probably because it doesn't guard against not being able to hold 2
-// cache lines at once
-TEST(DISABLED_cache_line_LRU_random_access_stack, basic_functionality)
+TEST(cache_line_LRU_random_access_stack, basic_functionality)
 {
   constexpr uint64_t                        testSize = 10000;
   fetch::random::LaggedFibonacciGenerator<> lfg;
@@ -227,3 +227,66 @@ TEST(cache_line_random_access_stack, file_writing_and_recovery)
     stack.Close();
   }
 }
+
+TEST(cache_line_random_access_stack, eviction_policies_and_stats)
+{
+  constexpr uint64_t testSize = 10000;
+
+  for (auto policy : {EvictionPolicy::LRU, EvictionPolicy::CLOCK, EvictionPolicy::TWO_QUEUE})
+  {
+    fetch::random::LaggedFibonacciGenerator<> lfg;
+    std::vector<TestClass>                    reference;
+
+    CacheLineRandomAccessStack<TestClass> stack{policy};
+    stack.SetCacheLineLn2(6);
+    stack.SetMemoryLimit(std::size_t(1ULL << 12));
+    stack.New("CRAS_test_3.db");
+
+    EXPECT_EQ(stack.eviction_policy(), policy);
+    EXPECT_EQ(stack.cache_line_ln2(), 6);
+
+    for (uint64_t i = 0; i < testSize; ++i)
+    {
+      TestClass temp;
+      temp.value1 = lfg();
+      temp.value2 = temp.value1 & 0xFF;
+
+      stack.Push(temp);
+      reference.push_back(temp);
+    }
+
+    // random access over the whole stack
+    for (uint64_t i = 0; i < testSize; ++i)
+    {
+      uint64_t const index = lfg() % testSize;
+
+      TestClass temp;
+      stack.Get(index, temp);
+      ASSERT_EQ(temp, reference[index]) << ToString(policy);
+
+      stack.Swap(index, testSize - 1 - index);
+      std::swap(reference[index], reference[testSize - 1 - index]);
+    }
+
+    auto const &stats = stack.GetStats();
+    EXPECT_GT(stats.hits, 0);
+    EXPECT_GT(stats.misses, 0);
+    EXPECT_GT(stats.evictions, 0);
+    EXPECT_GT(stats.write_backs, 0);
+    EXPECT_LT(stack.cached_lines(), 16);
+
+    stack.ResetStats();
+    EXPECT_EQ(stack.GetStats().hits, 0);
+
+    stack.Flush(false);
+
+    for (uint64_t i = 0; i < testSize; ++i)
+    {
+      TestClass temp;
+      stack.Get(i, temp);
+      ASSERT_EQ(temp, reference[i]) << ToString(policy);
+    }
+
+    stack.Close();
+  }
+}
@@ -0,0 +1,175 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "storage/document_store.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace fetch::storage;
+using namespace fetch::byte_array;
+
+namespace {
+
+using Store = DocumentStore<>;
+
+/**
+ * Generate something which looks like contract state: lots of shared structure with a little bit
+ * of per document variation
+ */
+ConstByteArray GenerateState(std::size_t index)
+{
+  std::string state = "{";
+  for (std::size_t i = 0; i < 64; ++i)
+  {
+    state += "\"balance_" + std::to_string(i) + "\": " + std::to_string((index * 31 + i) % 997) +
+             ", \"owner\": \"2Bjr9GcZPjJyTVmFnXY9ZLbVa8pBrTuNPzCpPNyzohdA6SS1rU\", ";
+  }
+  state += "}";
+
+  return {state};
+}
+
+class DocumentStoreTests : public ::testing::Test
+{
+protected:
+  void TearDown() override
+  {
+    for (auto const &name : {"ds_raw.db", "ds_raw.db.dict", "ds_raw.diff", "ds_raw.index.db",
+                             "ds_raw.index.diff", "ds_zip.db", "ds_zip.db.dict", "ds_zip.diff",
+                             "ds_zip.index.db", "ds_zip.index.diff"})
+    {
+      std::remove(name);
+    }
+  }
+
+  static void New(Store &store, std::string const &prefix)
+  {
+    store.New(prefix + ".db", prefix + ".diff", prefix + ".index.db", prefix + ".index.diff");
+  }
+
+  static void Load(Store &store, std::string const &prefix)
+  {
+    store.Load(prefix + ".db", prefix + ".diff", prefix + ".index.db", prefix + ".index.diff");
+  }
+};
+
+}  // namespace
+
+TEST_F(DocumentStoreTests, compression_does_not_change_contents_or_hash)
+{
+  Store raw;
+  Store compressed;
+  New(raw, "ds_raw");
+  New(compressed, "ds_zip");
+
+  CompressionOptions options;
+  options.enabled = true;
+  compressed.SetCompression(options);
+
+  for (std::size_t i = 0; i < 50; ++i)
+  {
+    ResourceAddress const address{"key" + std::to_string(i)};
+    raw.Set(address, GenerateState(i));
+    compressed.Set(address, GenerateState(i));
+  }
+
+  for (std::size_t i = 0; i < 50; ++i)
+  {
+    ResourceAddress const address{"key" + std::to_string(i)};
+    EXPECT_EQ(ConstByteArray(compressed.Get(address).document), GenerateState(i));
+  }
+
+  // the state hash only depends on the contents
+  EXPECT_EQ(raw.CurrentHash(), compressed.CurrentHash());
+
+  // and the compressed store needs fewer blocks
+  EXPECT_LT(compressed.size() * 2, raw.size());
+}
+
+TEST_F(DocumentStoreTests, trained_dictionary_persists_across_reloads)
+{
+  CompressionOptions options;
+  options.enabled = true;
+
+  {
+    Store store;
+    New(store, "ds_zip");
+
+    // seed the store with uncompressed documents and train on them
+    for (std::size_t i = 0; i < 20; ++i)
+    {
+      store.Set(ResourceAddress{"key" + std::to_string(i)}, GenerateState(i));
+    }
+
+    ASSERT_TRUE(store.TrainCompressionDictionary());
+
+    store.SetCompression(options);
+    for (std::size_t i = 20; i < 40; ++i)
+    {
+      store.Set(ResourceAddress{"key" + std::to_string(i)}, GenerateState(i));
+    }
+
+    store.Flush(false);
+  }
+
+  Store store;
+  Load(store, "ds_zip");
+
+  // both the raw and the dictionary compressed documents can be read back
+  for (std::size_t i = 0; i < 40; ++i)
+  {
+    EXPECT_EQ(ConstByteArray(store.Get(ResourceAddress{"key" + std::to_string(i)}).document),
+              GenerateState(i));
+  }
+}
+
+TEST_F(DocumentStoreTests, dictionary_improves_compression_of_small_documents)
+{
+  DocumentCompressor::Samples samples;
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    samples.emplace_back(GenerateState(i).SubArray(0, 256));
+  }
+
+  CompressionOptions options;
+  options.enabled = true;
+
+  DocumentCompressor plain;
+  DocumentCompressor trained;
+  plain.SetOptions(options);
+  trained.SetOptions(options);
+  trained.AddDictionary(DocumentCompressor::TrainDictionary(samples));
+
+  ConstByteArray const input = GenerateState(1000).SubArray(0, 256);
+
+  ConstByteArray plain_output;
+  ConstByteArray trained_output;
+  ASSERT_EQ(plain.Compress(input, plain_output), DocumentCodec::DEFLATE);
+  ASSERT_EQ(trained.Compress(input, trained_output), DocumentCodec::DEFLATE);
+
+  EXPECT_LT(trained_output.size(), plain_output.size());
+  EXPECT_EQ(trained.Decompress(DocumentCodec::DEFLATE, trained_output), input);
+
+  // a compressor without the dictionary is not able to decode the document
+  EXPECT_THROW(plain.Decompress(DocumentCodec::DEFLATE, trained_output), StorageException);
+}
@@ -369,3 +369,88 @@ TEST(storage_file_object_gtest, Hash_consistency)
   EXPECT_TRUE(FileLoadHashConsistency<7>());
   EXPECT_TRUE(FileLoadHashConsistency<1023>());
 }
+
+/**
+ * Stack which counts the number of read operations made against it
+ */
+template <std::size_t BS>
+class CountingStack : public RandomAccessStack<FileBlockType<BS>>
+{
+public:
+  using super_type = RandomAccessStack<FileBlockType<BS>>;
+  using type       = typename super_type::type;
+
+  void Get(std::size_t const &i, type &object) const
+  {
+    ++reads;
+    super_type::Get(i, object);
+  }
+
+  void GetBulk(std::size_t const &i, std::size_t &elements, type *objects)
+  {
+    ++reads;
+    super_type::GetBulk(i, elements, objects);
+  }
+
+  mutable std::size_t reads = 0;
+};
+
+TEST(storage_file_object_gtest, extents_are_read_in_bulk)
+{
+  using stack_type = CountingStack<64>;
+  stack_type stack;
+  stack.New("document_data.db");
+
+  ByteArray contiguous;
+  contiguous.Resize(64 * 50);
+  for (std::size_t j = 0; j < contiguous.size(); ++j)
+  {
+    contiguous[j] = uint8_t(lfg1() >> 9);
+  }
+
+  FileObject<stack_type> contiguous_file(stack);
+  contiguous_file.Write(contiguous.pointer(), contiguous.size());
+
+  // write two documents in alternating chunks so that they are fragmented
+  FileObject<stack_type> first(stack);
+  FileObject<stack_type> second(stack);
+
+  ByteArray first_contents;
+  ByteArray second_contents;
+  for (std::size_t i = 0; i < 10; ++i)
+  {
+    ByteArray chunk;
+    chunk.Resize(64 * 3 + i);
+    for (std::size_t j = 0; j < chunk.size(); ++j)
+    {
+      chunk[j] = uint8_t(lfg1() >> 9);
+    }
+
+    first.Write(chunk.pointer(), chunk.size());
+    first_contents.Append(chunk);
+    second.Write(chunk.pointer(), chunk.size());
+    second_contents.Append(chunk);
+  }
+
+  for (auto *file : {&first, &second})
+  {
+    ByteArray contents;
+    contents.Resize(file->size());
+    file->Seek(0);
+    file->Read(contents);
+
+    EXPECT_EQ(contents, first_contents);
+    EXPECT_EQ(file->Hash(), crypto::Hash<crypto::SHA256>(second_contents));
+  }
+
+  // the contiguous document is read with a bulk read per extent rather than a read per block
+  ByteArray contents;
+  contents.Resize(contiguous_file.size());
+
+  FileObject<stack_type> reader(stack, contiguous_file.id());
+  stack.reads = 0;
+  reader.Read(contents);
+
+  EXPECT_EQ(contents, contiguous);
+  EXPECT_LE(stack.reads, 3u);
+}
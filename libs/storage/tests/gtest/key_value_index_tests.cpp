@@ -19,12 +19,16 @@
 #include "core/byte_array/const_byte_array.hpp"
 #include "core/byte_array/encoders.hpp"
 #include "core/random/lfg.hpp"
+#include "storage/bloom_filter.hpp"
 #include "storage/key.hpp"
 #include "storage/key_value_index.hpp"
 #include <algorithm>
+#include <fstream>
 #include <gtest/gtest.h>
 #include <iomanip>
 #include <iostream>
+#include <string>
+#include <vector>
 using namespace fetch;
 using namespace fetch::storage;
 using cached_kvi_type = KeyValueIndex<KeyValuePair<>, CachedRandomAccessStack<KeyValuePair<>>>;
@@ -447,3 +451,190 @@ TEST(storage_key_value_index_gtest, Load_save_consistency)
 {
   EXPECT_TRUE(LoadSaveVsBulk());
 }
+
+template <typename T>
+bool BatchInsertHashConsistency()
+{
+  std::vector<TestData> values;
+  for (std::size_t i = 0; i < 5000; ++i)
+  {
+    byte_array::ByteArray key;
+    key.Resize(256 / 8);
+    for (std::size_t j = 0; j < key.size(); ++j)
+    {
+      key[j] = uint8_t(lfg() >> 9);
+    }
+
+    values.push_back({key, lfg()});
+  }
+
+  // overwrite a few of the existing keys in the second half
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    values.push_back({values[i * 7].key, lfg()});
+  }
+
+  std::size_t const half = values.size() / 2;
+
+  T sequential;
+  sequential.New("test1.db");
+  for (auto const &val : values)
+  {
+    sequential.Set(val.key, val.value, val.key);
+  }
+  byte_array::ByteArray const sequential_hash = sequential.Hash();
+
+  T batched;
+  batched.New("test2.db");
+  for (std::size_t offset : {std::size_t{0}, half})
+  {
+    typename T::Batch batch;
+    for (std::size_t i = offset; i < std::min(offset + half, values.size()); ++i)
+    {
+      batch.push_back({values[i].key, values[i].value, values[i].key});
+    }
+
+    std::stable_sort(batch.begin(), batch.end(),
+                     [](typename T::BatchEntry const &a, typename T::BatchEntry const &b) {
+                       return a.key < b.key;
+                     });
+    batched.SetBatch(batch);
+  }
+
+  bool ok = (sequential_hash == batched.Hash()) && (sequential.size() == batched.size());
+  for (auto const &val : values)
+  {
+    ok &= (sequential.Get(val.key) == batched.Get(val.key));
+  }
+
+  return ok;
+}
+
+TEST(storage_key_value_index_gtest, Batch_insert_consistency)
+{
+  EXPECT_TRUE(BatchInsertHashConsistency<kvi_type>());
+  EXPECT_TRUE(BatchInsertHashConsistency<cached_kvi_type>());
+}
+
+byte_array::ByteArray RandomKey()
+{
+  byte_array::ByteArray key;
+  key.Resize(256 / 8);
+  for (std::size_t j = 0; j < key.size(); ++j)
+  {
+    key[j] = uint8_t(lfg() >> 9);
+  }
+
+  return key;
+}
+
+template <typename T>
+void PopulateIndex(T &index, std::vector<byte_array::ByteArray> &keys, std::size_t count)
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    keys.push_back(RandomKey());
+    index.Set(keys.back(), i, keys.back());
+  }
+}
+
+void CopyFile(std::string const &from, std::string const &to)
+{
+  std::ifstream source(from, std::ios::binary);
+  std::ofstream destination(to, std::ios::binary | std::ios::trunc);
+  destination << source.rdbuf();
+}
+
+TEST(storage_key_value_index_gtest, Bloom_filter_rejects_missing_keys)
+{
+  std::vector<byte_array::ByteArray> keys;
+
+  kvi_type index;
+  index.New("test_bloom.db");
+  PopulateIndex(index, keys, 5000);
+
+  uint64_t value = 0;
+  for (std::size_t i = 0; i < keys.size(); ++i)
+  {
+    ASSERT_TRUE(index.GetIfExists(keys[i], value));
+    EXPECT_EQ(value, i);
+  }
+
+  // the filter outgrew its initial capacity and was rebuilt on the first lookup
+  EXPECT_GE(index.filter().capacity(), keys.size());
+
+  std::size_t false_positives = 0;
+  for (std::size_t i = 0; i < 10000; ++i)
+  {
+    auto const key = RandomKey();
+    false_positives += index.MayContain(key) ? 1 : 0;
+
+    EXPECT_FALSE(index.GetIfExists(key, value));
+    EXPECT_TRUE(index.Find(key) == index.end());
+  }
+
+  EXPECT_LT(false_positives, 200);
+}
+
+TEST(storage_key_value_index_gtest, Bloom_filter_is_persisted_with_the_index)
+{
+  std::vector<byte_array::ByteArray> keys;
+
+  {
+    cached_kvi_type index;
+    index.New("test_bloom.db");
+    PopulateIndex(index, keys, 2000);
+    index.Flush(false);
+  }
+
+  {
+    cached_kvi_type index;
+    index.Load("test_bloom.db");
+
+    // the filter on disk is tagged with the state of the index
+    BlockedBloomFilter filter;
+    EXPECT_TRUE(filter.Load("test_bloom.db.bloom", index.Hash()));
+    EXPECT_FALSE(filter.Load("test_bloom.db.bloom", RandomKey()));
+    EXPECT_EQ(filter.size(), keys.size());
+
+    uint64_t value = 0;
+    for (auto const &key : keys)
+    {
+      EXPECT_TRUE(index.GetIfExists(key, value));
+    }
+  }
+}
+
+TEST(storage_key_value_index_gtest, Stale_bloom_filter_is_rebuilt_on_load)
+{
+  std::vector<byte_array::ByteArray> keys;
+
+  {
+    kvi_type index;
+    index.New("test_bloom.db");
+    PopulateIndex(index, keys, 500);
+    index.Flush(false);
+  }
+
+  CopyFile("test_bloom.db.bloom", "test_bloom.db.bloom.old");
+
+  {
+    kvi_type index;
+    index.Load("test_bloom.db");
+    PopulateIndex(index, keys, 500);
+  }
+
+  // simulate a crash after the index was written but before the filter was
+  CopyFile("test_bloom.db.bloom.old", "test_bloom.db.bloom");
+
+  kvi_type index;
+  index.Load("test_bloom.db");
+
+  uint64_t value = 0;
+  for (std::size_t i = 0; i < keys.size(); ++i)
+  {
+    ASSERT_TRUE(index.GetIfExists(keys[i], value));
+  }
+
+  EXPECT_EQ(index.filter().size(), keys.size());
+}
@@ -341,3 +341,52 @@ TEST(mmap_random_access_stack, file_writing_and_recovery)
     stack.Close();
   }
 }
+
+TEST(mmap_random_access_stack, mapping_options_and_access_pattern)
+{
+  constexpr uint64_t                             testSize = 1024;
+  fetch::random::LaggedFibonacciGenerator<>      lfg;
+  MMapRandomAccessStack<TestClass, uint64_t, 64> stack("test");
+  std::vector<TestClass>                         reference;
+
+  MmapOptions options;
+  options.populate   = true;
+  options.huge_pages = true;
+  stack.SetMappingOptions(options);
+
+  stack.New("test_mmap_options.db");
+  EXPECT_TRUE(stack.mapping_options().populate);
+
+  for (uint64_t i = 0; i < testSize; ++i)
+  {
+    uint64_t  random = lfg();
+    TestClass temp;
+    temp.value1 = random;
+    temp.value2 = random & 0xFF;
+    stack.Push(temp);
+    reference.push_back(temp);
+  }
+
+  // walking the file in order switches the stack to sequential read ahead
+  TestClass temp;
+  for (uint64_t i = 0; i < testSize; ++i)
+  {
+    stack.Prefetch(i + 1);
+    stack.Get(i, temp);
+    ASSERT_EQ(temp, reference[i]);
+  }
+  EXPECT_EQ(stack.access_pattern(), MmapAccessPattern::SEQUENTIAL);
+
+  // jumping around falls back to random access
+  for (uint64_t i = 0; i < 16; ++i)
+  {
+    uint64_t const index = (lfg() % 8) * 128;
+    stack.Get(index, temp);
+    ASSERT_EQ(temp, reference[index]);
+  }
+  EXPECT_EQ(stack.access_pattern(), MmapAccessPattern::RANDOM);
+
+  // prefetching outside of the mapping is a no-op
+  stack.Prefetch(testSize * 4);
+  stack.Close();
+}
@@ -25,6 +25,7 @@
 #include <algorithm>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <thread>
 
 using namespace fetch::storage;
 using namespace fetch::byte_array;
@@ -479,3 +480,75 @@ TEST(storage_object_store, correlated_strings)
 
   ASSERT_EQ(testStore.size(), unique_ids.size()) << "ERROR: Failed to verify final size!";
 }
+
+TEST(storage_object_store, snapshots_pin_a_version)
+{
+  ObjectStore<std::string> store;
+  store.New("testFile_snapshot.db", "testIndex_snapshot.db");
+  store.SetReadViewCapacity(64);
+
+  for (std::size_t i = 0; i < 128; ++i)
+  {
+    store.Set(ResourceAddress(std::to_string(i)), std::to_string(i));
+  }
+
+  auto const snapshot = store.GetSnapshot();
+
+  // writes after the snapshot are not visible through it
+  store.Set(ResourceAddress("new"), "new");
+  store.Set(ResourceAddress("127"), "updated");
+
+  std::string value;
+  EXPECT_FALSE(snapshot.Has(ResourceAddress("new")));
+  EXPECT_FALSE(snapshot.Get(ResourceAddress("new"), value));
+  EXPECT_TRUE(store.Get(ResourceAddress("new"), value));
+  EXPECT_EQ(value, "new");
+
+  ASSERT_TRUE(snapshot.Get(ResourceAddress("127"), value));
+  EXPECT_EQ(value, "127");
+  ASSERT_TRUE(store.Get(ResourceAddress("127"), value));
+  EXPECT_EQ(value, "updated");
+
+  // objects which have aged out of the read view are served from disk
+  for (std::size_t i = 0; i < 127; ++i)
+  {
+    ASSERT_TRUE(snapshot.Get(ResourceAddress(std::to_string(i)), value));
+    EXPECT_EQ(value, std::to_string(i));
+  }
+}
+
+TEST(storage_object_store, concurrent_snapshot_reads)
+{
+  ObjectStore<std::string> store;
+  store.New("testFile_concurrent.db", "testIndex_concurrent.db");
+
+  std::size_t const num_objects = 500;
+
+  std::thread writer([&store, num_objects]() {
+    for (std::size_t i = 0; i < num_objects; ++i)
+    {
+      store.Set(ResourceAddress(std::to_string(i)), std::to_string(i));
+    }
+  });
+
+  std::size_t mismatches = 0;
+  for (std::size_t round = 0; round < 20; ++round)
+  {
+    auto const  snapshot = store.GetSnapshot();
+    std::string value;
+
+    for (std::size_t i = 0; i < num_objects; ++i)
+    {
+      if (snapshot.Get(ResourceAddress(std::to_string(i)), value) &&
+          (value != std::to_string(i)))
+      {
+        ++mismatches;
+      }
+    }
+  }
+
+  writer.join();
+
+  EXPECT_EQ(mismatches, 0);
+  EXPECT_EQ(store.size(), num_objects);
+}
@@ -0,0 +1,208 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "storage/key_byte_array_store.hpp"
+#include "storage/object_store.hpp"
+#include "storage/read_only_document_store.hpp"
+#include "storage/resource_mapper.hpp"
+#include "storage/storage_exception.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace fetch::storage;
+using fetch::byte_array::ConstByteArray;
+
+namespace {
+
+constexpr char const *DOC_FILE   = "ro_object_store.db";
+constexpr char const *INDEX_FILE = "ro_object_store.index.db";
+
+using Store = ObjectStore<std::string>;
+
+std::string GenerateObject(std::size_t index, std::size_t length)
+{
+  std::string object;
+  object.reserve(length);
+  while (object.size() < length)
+  {
+    object += "object_" + std::to_string(index) + ";";
+  }
+  object.resize(length);
+
+  return object;
+}
+
+ResourceID Key(std::size_t index)
+{
+  return ResourceAddress{"key" + std::to_string(index)};
+}
+
+class ReadOnlyObjectStoreTests : public ::testing::Test
+{
+protected:
+  void TearDown() override
+  {
+    for (auto const &name : {DOC_FILE, INDEX_FILE, "ro_object_store.db.dict",
+                             "ro_object_store.index.db.bloom"})
+    {
+      std::remove(name);
+    }
+  }
+
+  /**
+   * Write objects of varying sizes (spanning one or several blocks) and close the store
+   */
+  static void Populate(std::size_t count)
+  {
+    Store store;
+    store.New(DOC_FILE, INDEX_FILE);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      store.Set(Key(i), GenerateObject(i, 10 + ((i * 997) % 6000)));
+    }
+
+    store.Flush(false);
+  }
+};
+
+TEST_F(ReadOnlyObjectStoreTests, reads_objects_written_by_a_writable_store)
+{
+  Populate(200);
+
+  Store store;
+  store.LoadReadOnly(DOC_FILE, INDEX_FILE);
+  ASSERT_TRUE(store.read_only());
+
+  for (std::size_t i = 0; i < 200; ++i)
+  {
+    std::string object;
+    ASSERT_TRUE(store.Get(Key(i), object));
+    EXPECT_EQ(object, GenerateObject(i, 10 + ((i * 997) % 6000)));
+    EXPECT_TRUE(store.Has(Key(i)));
+  }
+
+  std::string object;
+  EXPECT_FALSE(store.Get(Key(1000), object));
+  EXPECT_FALSE(store.Has(Key(1000)));
+}
+
+TEST_F(ReadOnlyObjectStoreTests, small_objects_are_views_into_the_mapping)
+{
+  Populate(10);
+
+  Store store;
+  store.LoadReadOnly(DOC_FILE, INDEX_FILE);
+
+  ConstByteArray first;
+  ConstByteArray second;
+  ASSERT_TRUE(store.GetSerialized(Key(0), first));
+  ASSERT_TRUE(store.GetSerialized(Key(0), second));
+
+  // both lookups refer to the same bytes of the mapped file
+  ConstByteArray const &lhs = first;
+  ConstByteArray const &rhs = second;
+  EXPECT_EQ(lhs.pointer(), rhs.pointer());
+  EXPECT_EQ(first, second);
+}
+
+TEST_F(ReadOnlyObjectStoreTests, writes_are_rejected)
+{
+  Populate(10);
+
+  Store store;
+  store.LoadReadOnly(DOC_FILE, INDEX_FILE);
+
+  EXPECT_THROW(store.Set(Key(0), "updated"), StorageException);
+
+  std::string object;
+  ASSERT_TRUE(store.Get(Key(0), object));
+  EXPECT_EQ(object, GenerateObject(0, 10));
+}
+
+TEST_F(ReadOnlyObjectStoreTests, concurrent_readers)
+{
+  Populate(100);
+
+  Store store;
+  store.LoadReadOnly(DOC_FILE, INDEX_FILE);
+
+  std::vector<std::thread> readers;
+  std::vector<std::size_t> failures(4, 0);
+  for (std::size_t t = 0; t < failures.size(); ++t)
+  {
+    readers.emplace_back([&store, &failures, t]() {
+      for (std::size_t round = 0; round < 20; ++round)
+      {
+        for (std::size_t i = 0; i < 100; ++i)
+        {
+          std::string object;
+          if (!store.Get(Key(i), object) || (object != GenerateObject(i, 10 + ((i * 997) % 6000))))
+          {
+            ++failures[t];
+          }
+        }
+      }
+    });
+  }
+
+  for (auto &reader : readers)
+  {
+    reader.join();
+  }
+
+  for (auto const &count : failures)
+  {
+    EXPECT_EQ(count, 0);
+  }
+}
+
+TEST_F(ReadOnlyObjectStoreTests, reads_compressed_documents)
+{
+  {
+    KeyByteArrayStore<2048> writer;
+    writer.New(DOC_FILE, INDEX_FILE);
+
+    CompressionOptions options;
+    options.enabled = true;
+    writer.SetCompression(options);
+
+    for (std::size_t i = 0; i < 50; ++i)
+    {
+      writer.Set(Key(i), ConstByteArray{GenerateObject(i, 100 + i * 150)});
+    }
+  }
+
+  ReadOnlyDocumentStore<2048> reader;
+  reader.Load(DOC_FILE, INDEX_FILE);
+
+  for (std::size_t i = 0; i < 50; ++i)
+  {
+    ConstByteArray document;
+    ASSERT_TRUE(reader.Get(Key(i), document));
+    EXPECT_EQ(document, ConstByteArray{GenerateObject(i, 100 + i * 150)});
+  }
+}
+
+}  // namespace
@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "metrics/storage_metrics.hpp"
+#include "storage/cached_random_access_stack.hpp"
+#include "storage/random_access_stack.hpp"
+#include "storage/write_ahead_log.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace {
+
+using fetch::metrics::LatencyHistogram;
+using fetch::metrics::StackMetrics;
+using fetch::metrics::StorageMetrics;
+using fetch::storage::CachedRandomAccessStack;
+using fetch::storage::RandomAccessStack;
+using fetch::storage::WriteAheadLog;
+
+StackMetrics &FreshStackMetrics(std::string const &name)
+{
+  auto &metrics = StorageMetrics::Instance().Stack(name);
+  metrics.Reset();
+  return metrics;
+}
+
+TEST(StorageMetricsTests, HistogramBuckets)
+{
+  LatencyHistogram histogram;
+
+  histogram.Record(std::chrono::nanoseconds{500});
+  histogram.Record(std::chrono::microseconds{1});
+  histogram.Record(std::chrono::microseconds{3});
+  histogram.Record(std::chrono::microseconds{1000});
+  histogram.Record(std::chrono::hours{1});
+
+  auto const buckets = histogram.buckets();
+
+  EXPECT_EQ(histogram.count(), 5u);
+  EXPECT_EQ(buckets[0], 1u);   // [0, 1) us
+  EXPECT_EQ(buckets[1], 1u);   // [1, 2) us
+  EXPECT_EQ(buckets[2], 1u);   // [2, 4) us
+  EXPECT_EQ(buckets[10], 1u);  // [512, 1024) us
+  EXPECT_EQ(buckets[LatencyHistogram::NUM_BUCKETS - 1], 1u);
+
+  EXPECT_EQ(LatencyHistogram::BucketUpperBound(10), 1024u);
+
+  histogram.Reset();
+  EXPECT_EQ(histogram.count(), 0u);
+  EXPECT_EQ(histogram.total_us(), 0u);
+}
+
+TEST(StorageMetricsTests, RandomAccessStackRecordsIO)
+{
+  static constexpr char const *FILENAME = "storage_metrics_ras.db";
+
+  auto &metrics = FreshStackMetrics(FILENAME);
+
+  RandomAccessStack<uint64_t> stack;
+  stack.New(FILENAME);
+
+  for (uint64_t i = 0; i < 10; ++i)
+  {
+    stack.Push(i);
+  }
+
+  uint64_t value{0};
+  stack.Get(3, value);
+  EXPECT_EQ(value, 3u);
+
+  stack.Flush();
+
+  EXPECT_EQ(metrics.bytes_written.load(), 10 * sizeof(uint64_t));
+  EXPECT_EQ(metrics.bytes_read.load(), sizeof(uint64_t));
+  EXPECT_EQ(metrics.flush_latency.count(), 1u);
+}
+
+TEST(StorageMetricsTests, CachedStackRecordsHitRatio)
+{
+  static constexpr char const *FILENAME = "storage_metrics_cras.db";
+
+  auto &metrics = FreshStackMetrics(FILENAME);
+
+  RandomAccessStack<uint64_t> setup;
+  setup.New(FILENAME);
+  for (uint64_t i = 0; i < 4; ++i)
+  {
+    setup.Push(i);
+  }
+  setup.Close();
+
+  CachedRandomAccessStack<uint64_t> stack;
+  stack.Load(FILENAME);
+
+  // the first read of each element misses the cache, the second is a hit
+  uint64_t value{0};
+  for (uint64_t i = 0; i < 4; ++i)
+  {
+    stack.Get(i, value);
+    stack.Get(i, value);
+  }
+
+  EXPECT_EQ(metrics.cache_hits.load(), 4u);
+  EXPECT_EQ(metrics.cache_misses.load(), 4u);
+  EXPECT_DOUBLE_EQ(metrics.cache_hit_ratio(), 0.5);
+}
+
+TEST(StorageMetricsTests, WriteAheadLogRecordsSyncs)
+{
+  static constexpr char const *FILENAME = "storage_metrics.wal";
+
+  auto &metrics = FreshStackMetrics(FILENAME);
+
+  WriteAheadLog log;
+  ASSERT_TRUE(log.Open(FILENAME, true));
+  ASSERT_TRUE(log.Append({{"key", "value"}}, "hash"));
+  ASSERT_TRUE(log.Append({{"key", "value"}}, "hash"));
+
+  EXPECT_EQ(metrics.flush_latency.count(), 2u);
+  EXPECT_EQ(metrics.bytes_written.load(), log.size());
+}
+
+}  // namespace
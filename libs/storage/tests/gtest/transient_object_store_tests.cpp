@@ -0,0 +1,281 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "ledger/chain/mutable_transaction.hpp"
+#include "storage/object_store.hpp"
+#include "storage/resource_mapper.hpp"
+#include "storage/transient_object_store.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace fetch::storage;
+
+/**
+ * Minimal stored object, with the summary that the transient store requires
+ */
+struct TestObject
+{
+  std::string value;
+
+  fetch::ledger::TransactionSummary summary() const
+  {
+    return {};
+  }
+};
+
+template <typename T>
+void Serialize(T &serializer, TestObject const &object)
+{
+  serializer << object.value;
+}
+
+template <typename T>
+void Deserialize(T &serializer, TestObject &object)
+{
+  serializer >> object.value;
+}
+
+namespace {
+
+using TransientStore = TransientObjectStore<std::string>;
+
+constexpr char const *DOC_FILE   = "transient_archive.db";
+constexpr char const *INDEX_FILE = "transient_archive_index.db";
+
+class TransientObjectStoreTests : public ::testing::TestWithParam<std::size_t>
+{
+protected:
+  void SetUp() override
+  {
+    ObjectStore<std::string> archive;
+    archive.New(DOC_FILE, INDEX_FILE);
+
+    for (std::size_t i = 0; i < OBJECT_COUNT; ++i)
+    {
+      auto const name = std::to_string(i);
+      archive.Set(ResourceAddress{name}, name);
+    }
+
+    // an object which does not match the key it was stored under
+    archive.Set(ResourceAddress{"mismatched"}, std::string{"not-mismatched"});
+  }
+
+  static bool MatchesKey(ResourceID const &rid, std::string const &object)
+  {
+    return ResourceAddress{object}.id() == rid.id();
+  }
+
+  static constexpr std::size_t OBJECT_COUNT = 1000;
+};
+
+constexpr std::size_t TransientObjectStoreTests::OBJECT_COUNT;
+
+TEST_P(TransientObjectStoreTests, archive_is_scanned_in_parallel)
+{
+  // the store is too large to be kept on the stack
+  auto store = std::make_unique<TransientStore>();
+  store->Load(DOC_FILE, INDEX_FILE, false);
+
+  auto const report = store->VerifyArchive(GetParam());
+
+  EXPECT_GE(report.subtrees, GetParam() * TransientStore::SUBTREES_PER_THREAD);
+  EXPECT_EQ(report.objects, OBJECT_COUNT + 1);
+  EXPECT_TRUE(report.corrupt.empty());
+}
+
+TEST_P(TransientObjectStoreTests, verification_failures_are_reported)
+{
+  // the store is too large to be kept on the stack
+  auto store = std::make_unique<TransientStore>();
+  store->Load(DOC_FILE, INDEX_FILE, false);
+
+  auto const report = store->VerifyArchive(GetParam(), &TransientObjectStoreTests::MatchesKey);
+
+  EXPECT_EQ(report.objects, OBJECT_COUNT + 1);
+  ASSERT_EQ(report.corrupt.size(), 1);
+  EXPECT_EQ(report.corrupt.front().id(), ResourceAddress{"mismatched"}.id());
+}
+
+INSTANTIATE_TEST_CASE_P(ThreadCounts, TransientObjectStoreTests, ::testing::Values(1u, 2u, 8u), );
+
+class TransientObjectStoreFlushTests : public ::testing::Test
+{
+protected:
+  using Store  = TransientObjectStore<TestObject>;
+  using Policy = Store::FlushPolicy;
+
+  void SetUp() override
+  {
+    store_ = std::make_unique<Store>();
+    store_->New("transient_flush.db", "transient_flush_index.db");
+  }
+
+  void ConfirmObjects(std::size_t count)
+  {
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      auto const name = std::to_string(next_++);
+      auto const rid  = ResourceAddress{name};
+
+      store_->Set(rid, TestObject{name}, false);
+      ASSERT_TRUE(store_->Confirm(rid));
+    }
+  }
+
+  // run the writer through populating, writing and flushing
+  void RunWriter(std::size_t steps = 3)
+  {
+    auto runnable = store_->getWeakRunnable().lock();
+    for (std::size_t i = 0; i < steps; ++i)
+    {
+      runnable->Execute();
+    }
+  }
+
+  std::unique_ptr<Store> store_;
+  std::size_t            next_ = 0;
+};
+
+TEST_F(TransientObjectStoreFlushTests, objects_are_written_in_batches)
+{
+  Policy policy;
+  policy.batch_size = 10;
+  store_->SetFlushPolicy(policy);
+
+  ConfirmObjects(25);
+
+  auto stats = store_->GetFlushStats();
+  EXPECT_EQ(stats.queue_depth, 25);
+  EXPECT_EQ(stats.peak_queue_depth, 25);
+  EXPECT_EQ(stats.cached_objects, 25);
+  EXPECT_GT(stats.dirty_bytes, 0);
+
+  RunWriter();
+
+  stats = store_->GetFlushStats();
+  EXPECT_EQ(stats.queue_depth, 15);
+  EXPECT_EQ(stats.objects_written, 10);
+  EXPECT_EQ(stats.write_cycles, 1);
+  EXPECT_EQ(stats.cached_objects, 15);
+
+  RunWriter(6);
+
+  stats = store_->GetFlushStats();
+  EXPECT_EQ(stats.queue_depth, 0);
+  EXPECT_EQ(stats.objects_written, 25);
+  EXPECT_EQ(stats.write_cycles, 3);
+  EXPECT_EQ(stats.dirty_bytes, 0);
+  EXPECT_EQ(stats.cached_objects, 0);
+
+  // all of the objects are now served from the archive
+  TestObject object;
+  EXPECT_TRUE(store_->Get(ResourceAddress{"24"}, object));
+  EXPECT_EQ(object.value, "24");
+}
+
+TEST_F(TransientObjectStoreFlushTests, partial_batches_wait_for_the_watermark)
+{
+  Policy policy;
+  policy.batch_size    = 100;
+  policy.max_dirty_age = std::chrono::hours{1};
+  store_->SetFlushPolicy(policy);
+
+  ConfirmObjects(5);
+  RunWriter();
+
+  // the objects have been picked up, but are held back until the batch is due
+  auto stats = store_->GetFlushStats();
+  EXPECT_EQ(stats.queue_depth, 0);
+  EXPECT_EQ(stats.objects_written, 0);
+  EXPECT_EQ(stats.cached_objects, 5);
+
+  policy.max_dirty_age = std::chrono::milliseconds{0};
+  store_->SetFlushPolicy(policy);
+  RunWriter();
+
+  stats = store_->GetFlushStats();
+  EXPECT_EQ(stats.objects_written, 5);
+  EXPECT_EQ(stats.cached_objects, 0);
+}
+
+TEST_F(TransientObjectStoreFlushTests, dirty_limit_drains_the_queue_in_one_cycle)
+{
+  Policy policy;
+  policy.batch_size      = 10;
+  policy.max_dirty_bytes = 1;
+  policy.max_dirty_age   = std::chrono::hours{1};
+  store_->SetFlushPolicy(policy);
+
+  ConfirmObjects(40);
+  RunWriter();
+
+  auto const stats = store_->GetFlushStats();
+  EXPECT_EQ(stats.objects_written, 40);
+  EXPECT_EQ(stats.write_cycles, 1);
+  EXPECT_EQ(stats.dirty_bytes, 0);
+}
+
+TEST_F(TransientObjectStoreFlushTests, filtered_objects_are_copied_to_another_store)
+{
+  Policy policy;
+  policy.max_dirty_age = std::chrono::milliseconds{0};
+  store_->SetFlushPolicy(policy);
+
+  // archive most of the objects and leave a few in the cache
+  ConfirmObjects(40);
+  RunWriter();
+  ASSERT_EQ(store_->GetFlushStats().cached_objects, 0);
+
+  std::vector<ResourceAddress> rids;
+  for (std::size_t i = 0; i < 40; ++i)
+  {
+    rids.emplace_back(std::to_string(i));
+  }
+
+  for (auto const &name : {"cached-1", "cached-2", "cached-3", "cached-4"})
+  {
+    rids.emplace_back(name);
+    store_->Set(rids.back(), TestObject{name}, false);
+  }
+
+  auto const filter = [](ResourceID const &rid) { return rid.lane(1) == 1; };
+
+  auto target = std::make_unique<Store>();
+  target->New("transient_copy.db", "transient_copy_index.db");
+
+  std::size_t expected{0};
+  for (auto const &rid : rids)
+  {
+    expected += filter(rid) ? 1 : 0;
+  }
+
+  EXPECT_EQ(store_->CopyTo(*target, filter), expected);
+
+  for (auto const &rid : rids)
+  {
+    EXPECT_EQ(target->Has(rid), filter(rid));
+  }
+}
+
+}  // namespace
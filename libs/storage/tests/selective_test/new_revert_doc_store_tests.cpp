@@ -26,6 +26,7 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <stack>
 #include <string>
@@ -229,3 +230,342 @@ TEST(new_revertible_store_test, basic_example_of_commit_revert_with_load)
     }
   }
 }
+
+TEST(new_revertible_store_test, commits_are_recovered_from_the_log)
+{
+  ByteArray hash;
+  {
+    NewRevertibleDocumentStore store;
+    store.New("a_14.db", "b_14.db", "c_14.db", "d_14.db", true);
+
+    for (std::size_t i = 0; i < 17; ++i)
+    {
+      std::string set_me{std::to_string(i)};
+      store.Set(storage::ResourceAddress(set_me), set_me);
+    }
+
+    hash = store.Commit();
+  }
+
+  // keep a copy of the log
+  std::string log_contents;
+  {
+    std::ifstream input("a_14.db.wal", std::ios::binary);
+    log_contents.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+  }
+  ASSERT_FALSE(log_contents.empty());
+
+  // wipe the stacks, as though the commit never made it to them
+  {
+    NewRevertibleDocumentStore store;
+    store.New("a_14.db", "b_14.db", "c_14.db", "d_14.db", true);
+  }
+
+  {
+    std::ofstream output("a_14.db.wal", std::ios::binary | std::ios::trunc);
+    output << log_contents;
+  }
+
+  NewRevertibleDocumentStore store;
+  store.Load("a_14.db", "b_14.db", "c_14.db", "d_14.db", true);
+
+  EXPECT_TRUE(store.HashExists(hash));
+  EXPECT_EQ(store.CurrentHash(), hash);
+
+  for (std::size_t i = 0; i < 17; ++i)
+  {
+    auto document = store.Get(storage::ResourceAddress(std::to_string(i)));
+    EXPECT_EQ(document.failed, false);
+    EXPECT_EQ(ConstByteArray(document), ByteArray(std::to_string(i)));
+  }
+}
+
+TEST(new_revertible_store_test, uncommitted_writes_are_visible)
+{
+  NewRevertibleDocumentStore store;
+  store.New("a_15.db", "b_15.db", "c_15.db", "d_15.db", true);
+
+  store.Set(storage::ResourceAddress("key"), "value1");
+  EXPECT_EQ(ConstByteArray(store.Get(storage::ResourceAddress("key"))), ByteArray("value1"));
+
+  store.Set(storage::ResourceAddress("key"), "value2");
+  EXPECT_EQ(ConstByteArray(store.GetOrCreate(storage::ResourceAddress("key"))),
+            ByteArray("value2"));
+
+  auto const first = store.Commit();
+  EXPECT_EQ(ConstByteArray(store.Get(storage::ResourceAddress("key"))), ByteArray("value2"));
+
+  // many commits, enough to trigger checkpoints
+  for (std::size_t i = 0; i < 2 * NewRevertibleDocumentStore::CHECKPOINT_INTERVAL; ++i)
+  {
+    store.Set(storage::ResourceAddress("key"), std::to_string(i));
+    store.Commit();
+  }
+
+  EXPECT_TRUE(store.RevertToHash(first));
+  EXPECT_EQ(ConstByteArray(store.Get(storage::ResourceAddress("key"))), ByteArray("value2"));
+}
+
+TEST(new_revertible_store_test, snapshot_export_and_restore)
+{
+  NewRevertibleDocumentStore source;
+  source.New("a_16.db", "b_16.db", "c_16.db", "d_16.db", true);
+
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    std::string set_me{std::to_string(i)};
+    source.Set(storage::ResourceAddress(set_me), "value" + set_me);
+  }
+
+  auto const hash = source.Commit();
+
+  StateSnapshot snapshot;
+  ASSERT_TRUE(source.CreateSnapshot(hash, 16, snapshot));
+  EXPECT_EQ(snapshot.manifest.state_hash, hash);
+  EXPECT_EQ(snapshot.manifest.num_entries, 100);
+  EXPECT_EQ(snapshot.manifest.num_chunks, 7);
+  ASSERT_EQ(snapshot.chunks.size(), 7);
+
+  // snapshots can only be taken of the current state
+  EXPECT_FALSE(source.CreateSnapshot(ByteArray("not the current hash"), 16, snapshot));
+
+  NewRevertibleDocumentStore destination;
+  destination.New("a_17.db", "b_17.db", "c_17.db", "d_17.db", true);
+  destination.Set(storage::ResourceAddress("stale"), "value");
+  destination.Commit();
+
+  ASSERT_TRUE(destination.BeginSnapshotRestore(snapshot.manifest));
+  for (auto const &chunk : snapshot.chunks)
+  {
+    ASSERT_TRUE(destination.RestoreSnapshotChunk(chunk));
+  }
+  ASSERT_TRUE(destination.CompleteSnapshotRestore());
+
+  EXPECT_EQ(destination.CurrentHash(), hash);
+  EXPECT_TRUE(destination.HashExists(hash));
+  EXPECT_TRUE(destination.Get(storage::ResourceAddress("stale")).failed);
+
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    std::string set_me{std::to_string(i)};
+    auto        document = destination.Get(storage::ResourceAddress(set_me));
+    EXPECT_EQ(document.failed, false);
+    EXPECT_EQ(ConstByteArray(document), ByteArray("value" + set_me));
+  }
+}
+
+TEST(new_revertible_store_test, snapshot_restore_rejects_bad_chunks)
+{
+  NewRevertibleDocumentStore source;
+  source.New("a_18.db", "b_18.db", "c_18.db", "d_18.db", true);
+
+  for (std::size_t i = 0; i < 40; ++i)
+  {
+    std::string set_me{std::to_string(i)};
+    source.Set(storage::ResourceAddress(set_me), set_me);
+  }
+
+  auto const hash = source.Commit();
+
+  StateSnapshot snapshot;
+  ASSERT_TRUE(source.CreateSnapshot(hash, 16, snapshot));
+  ASSERT_EQ(snapshot.chunks.size(), 3);
+
+  NewRevertibleDocumentStore destination;
+  destination.New("a_19.db", "b_19.db", "c_19.db", "d_19.db", true);
+
+  ASSERT_TRUE(destination.BeginSnapshotRestore(snapshot.manifest));
+
+  // out of order chunks are rejected
+  EXPECT_FALSE(destination.RestoreSnapshotChunk(snapshot.chunks[1]));
+  EXPECT_TRUE(destination.RestoreSnapshotChunk(snapshot.chunks[0]));
+
+  // corrupted chunks are rejected
+  auto corrupted                   = snapshot.chunks[1];
+  corrupted.entries.front().second = ConstByteArray("corrupted");
+  EXPECT_FALSE(destination.RestoreSnapshotChunk(corrupted));
+
+  // an incomplete restore fails and leaves the store empty
+  EXPECT_TRUE(destination.RestoreSnapshotChunk(snapshot.chunks[1]));
+  EXPECT_FALSE(destination.CompleteSnapshotRestore());
+  EXPECT_TRUE(destination.Get(storage::ResourceAddress("0")).failed);
+}
+
+TEST(new_revertible_store_test, filtered_snapshot_is_merged_into_existing_state)
+{
+  NewRevertibleDocumentStore source;
+  source.New("a_22.db", "b_22.db", "c_22.db", "d_22.db", true);
+
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    std::string set_me{std::to_string(i)};
+    source.Set(storage::ResourceAddress(set_me), "value" + set_me);
+  }
+
+  auto const hash = source.Commit();
+
+  // only export the documents of one of two lanes
+  auto const in_lane = [](ResourceID const &rid) { return rid.lane(1) == 1; };
+
+  StateSnapshot snapshot;
+  ASSERT_TRUE(source.CreateSnapshot(hash, 16, snapshot, in_lane));
+  EXPECT_GT(snapshot.manifest.num_entries, 0);
+  EXPECT_LT(snapshot.manifest.num_entries, 100);
+
+  NewRevertibleDocumentStore destination;
+  destination.New("a_23.db", "b_23.db", "c_23.db", "d_23.db", true);
+  destination.Set(storage::ResourceAddress("existing"), "value");
+  destination.Commit();
+
+  for (auto const &chunk : snapshot.chunks)
+  {
+    ASSERT_TRUE(destination.MergeSnapshotChunk(chunk));
+  }
+
+  // corrupted chunks are rejected
+  auto corrupted                   = snapshot.chunks.front();
+  corrupted.entries.front().second = ConstByteArray("corrupted");
+  EXPECT_FALSE(destination.MergeSnapshotChunk(corrupted));
+
+  destination.Commit();
+
+  // the existing state is kept
+  EXPECT_EQ(ConstByteArray(destination.Get(storage::ResourceAddress("existing"))),
+            ByteArray("value"));
+
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    std::string     set_me{std::to_string(i)};
+    ResourceAddress address{set_me};
+    auto            document = destination.Get(address);
+
+    if (in_lane(address))
+    {
+      EXPECT_EQ(ConstByteArray(document), ByteArray("value" + set_me));
+    }
+    else
+    {
+      EXPECT_TRUE(document.failed);
+    }
+  }
+}
+
+TEST(new_revertible_store_test, compaction_drops_history_beyond_finality_depth)
+{
+  NewRevertibleDocumentStore store;
+  store.New("a_18.db", "b_18.db", "c_18.db", "d_18.db", true);
+
+  // the depth is never less than the minimum
+  store.SetFinalityDepth(1);
+  EXPECT_EQ(store.finality_depth(), NewRevertibleDocumentStore::MIN_FINALITY_DEPTH);
+
+  std::size_t const      num_commits = NewRevertibleDocumentStore::MIN_FINALITY_DEPTH + 16;
+  std::vector<ByteArray> hashes;
+
+  for (std::size_t commit = 0; commit < num_commits; ++commit)
+  {
+    store.Set(storage::ResourceAddress("key"), std::to_string(commit));
+    store.Set(storage::ResourceAddress(std::to_string(commit)), std::to_string(commit));
+    hashes.push_back(store.Commit());
+  }
+
+  EXPECT_EQ(store.Compact(), 16);
+
+  for (std::size_t commit = 0; commit < num_commits; ++commit)
+  {
+    EXPECT_EQ(store.HashExists(hashes[commit]), commit >= 16);
+  }
+
+  // the state is untouched, and the oldest retained commit can be reverted to
+  auto document = store.Get(storage::ResourceAddress("key"));
+  EXPECT_EQ(ConstByteArray(document), ByteArray(std::to_string(num_commits - 1)));
+
+  EXPECT_FALSE(store.RevertToHash(hashes[15]));
+  ASSERT_TRUE(store.RevertToHash(hashes[16]));
+
+  document = store.Get(storage::ResourceAddress("key"));
+  EXPECT_EQ(ConstByteArray(document), ByteArray(std::to_string(16)));
+  EXPECT_EQ(store.size(), 18);
+}
+
+TEST(new_revertible_store_test, fork_of_parent_state_is_applied_after_revert)
+{
+  // the expected outcome of the writes on top of the parent state
+  ByteArray expected_hash;
+  {
+    NewRevertibleDocumentStore reference;
+    reference.New("a_19.db", "b_19.db", "c_19.db", "d_19.db", true);
+
+    reference.Set(storage::ResourceAddress("key"), "parent");
+    reference.Set(storage::ResourceAddress("other"), "parent");
+    reference.Commit();
+
+    reference.Set(storage::ResourceAddress("key"), "sibling");
+    expected_hash = reference.Commit();
+  }
+
+  NewRevertibleDocumentStore store;
+  store.New("a_20.db", "b_20.db", "c_20.db", "d_20.db", true);
+  store.EnableForks();
+
+  store.Set(storage::ResourceAddress("key"), "parent");
+  store.Set(storage::ResourceAddress("other"), "parent");
+  auto const parent = store.Commit();
+
+  store.Set(storage::ResourceAddress("key"), "head");
+  store.Set(storage::ResourceAddress("head"), "head");
+  auto const head = store.Commit();
+
+  // execute on a fork of the parent state
+  ASSERT_TRUE(store.BeginFork(parent));
+  EXPECT_EQ(ConstByteArray(store.Get(storage::ResourceAddress("key"))), ByteArray("parent"));
+  EXPECT_EQ(ConstByteArray(store.Get(storage::ResourceAddress("other"))), ByteArray("parent"));
+  EXPECT_TRUE(store.Get(storage::ResourceAddress("head")).failed);
+
+  store.Set(storage::ResourceAddress("key"), "sibling");
+  EXPECT_EQ(ConstByteArray(store.Get(storage::ResourceAddress("key"))), ByteArray("sibling"));
+  ASSERT_TRUE(store.EndFork());
+
+  // the head state is untouched by the fork
+  EXPECT_EQ(ConstByteArray(store.Get(storage::ResourceAddress("key"))), ByteArray("head"));
+  EXPECT_EQ(store.CurrentHash(), head);
+
+  // the fork can only be applied on top of the state it was made from
+  EXPECT_FALSE(store.ApplyFork(parent));
+
+  ASSERT_TRUE(store.RevertToHash(parent));
+  ASSERT_TRUE(store.ApplyFork(parent));
+  EXPECT_EQ(ConstByteArray(store.Get(storage::ResourceAddress("key"))), ByteArray("sibling"));
+  EXPECT_EQ(store.Commit(), expected_hash);
+}
+
+TEST(new_revertible_store_test, discarded_fork_leaves_state_unchanged)
+{
+  NewRevertibleDocumentStore store;
+  store.New("a_21.db", "b_21.db", "c_21.db", "d_21.db", true);
+
+  // forks must be enabled
+  store.Set(storage::ResourceAddress("key"), "head");
+  auto const head = store.Commit();
+  EXPECT_FALSE(store.BeginFork(head));
+
+  store.EnableForks();
+  ASSERT_TRUE(store.BeginFork(head));
+
+  // documents are only created on the fork
+  EXPECT_TRUE(store.GetOrCreate(storage::ResourceAddress("new")).was_created);
+  EXPECT_FALSE(store.GetOrCreate(storage::ResourceAddress("new")).was_created);
+  store.Set(storage::ResourceAddress("key"), "fork");
+
+  EXPECT_TRUE(store.EndFork());
+  store.DiscardFork();
+
+  EXPECT_FALSE(store.ApplyFork(head));
+  EXPECT_EQ(ConstByteArray(store.Get(storage::ResourceAddress("key"))), ByteArray("head"));
+  EXPECT_TRUE(store.Get(storage::ResourceAddress("new")).failed);
+  EXPECT_EQ(store.CurrentHash(), head);
+
+  // uncommitted changes prevent a fork
+  store.Set(storage::ResourceAddress("key"), "pending");
+  EXPECT_FALSE(store.BeginFork(head));
+}
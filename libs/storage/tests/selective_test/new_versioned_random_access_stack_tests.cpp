@@ -203,3 +203,72 @@ TEST(versioned_random_access_stack_gtest, loading_file)
     }
   }
 }
+
+TEST(versioned_random_access_stack_gtest, compaction_drops_old_history)
+{
+  NewVersionedRandomAccessStack<StringProxy> stack;
+  stack.New("d_main.db", "d_history.db");
+
+  std::vector<ByteArray> hashes;
+  for (std::size_t i = 0; i < 10; ++i)
+  {
+    hashes.push_back(Hash<crypto::SHA256>(std::to_string(i)));
+  }
+
+  // each commit holds the index of the commit in every element
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    stack.Push(std::to_string(0));
+  }
+  stack.Commit(hashes[0]);
+
+  for (std::size_t commit = 1; commit < 8; ++commit)
+  {
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+      stack.Set(i, std::to_string(commit));
+    }
+    stack.Commit(hashes[commit]);
+  }
+
+  ASSERT_TRUE(stack.BeginCompaction(3));
+  ASSERT_TRUE(stack.RunCompaction());
+
+  // changes made while the history is being copied are retained
+  for (std::size_t commit = 8; commit < 10; ++commit)
+  {
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+      stack.Set(i, std::to_string(commit));
+    }
+    stack.Commit(hashes[commit]);
+  }
+
+  EXPECT_EQ(stack.CompleteCompaction(), 5);
+
+  for (std::size_t commit = 0; commit < 5; ++commit)
+  {
+    EXPECT_FALSE(stack.HashExists(hashes[commit]));
+  }
+  for (std::size_t commit = 5; commit < 10; ++commit)
+  {
+    EXPECT_TRUE(stack.HashExists(hashes[commit]));
+  }
+
+  // the oldest retained commit can still be reverted to
+  stack.RevertToHash(hashes[5]);
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(stack.Get(i), std::to_string(5));
+  }
+
+  // a compaction interrupted by a revert is abandoned
+  stack.Set(0, std::to_string(6));
+  stack.Commit(hashes[6]);
+
+  ASSERT_TRUE(stack.BeginCompaction(1));
+  ASSERT_TRUE(stack.RunCompaction());
+  stack.RevertToHash(hashes[5]);
+  EXPECT_EQ(stack.CompleteCompaction(), 0);
+  EXPECT_TRUE(stack.HashExists(hashes[5]));
+}
@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+
+#include "storage/write_ahead_log.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+using fetch::storage::WriteAheadLog;
+using fetch::byte_array::ConstByteArray;
+
+namespace {
+
+struct Group
+{
+  WriteAheadLog::Records records;
+  ConstByteArray         hash;
+};
+
+std::vector<Group> ReadGroups(WriteAheadLog &log)
+{
+  std::vector<Group> groups;
+  log.Replay([&groups](WriteAheadLog::Records const &records, ConstByteArray const &hash) {
+    groups.push_back({records, hash});
+  });
+  return groups;
+}
+
+TEST(WriteAheadLogTests, AppendAndReplay)
+{
+  {
+    WriteAheadLog log;
+    ASSERT_TRUE(log.Open("wal_test_1.wal", true));
+
+    EXPECT_TRUE(log.Append({{"key1", "value1"}, {"key2", "value2"}}, "hash1"));
+    EXPECT_TRUE(log.Append({}, "hash2"));
+    EXPECT_TRUE(log.Append({{"key3", ""}}, "hash3"));
+  }
+
+  WriteAheadLog log;
+  ASSERT_TRUE(log.Open("wal_test_1.wal", false));
+
+  auto const groups = ReadGroups(log);
+  ASSERT_EQ(groups.size(), 3);
+
+  ASSERT_EQ(groups[0].records.size(), 2);
+  EXPECT_EQ(groups[0].records[0].key, "key1");
+  EXPECT_EQ(groups[0].records[0].value, "value1");
+  EXPECT_EQ(groups[0].records[1].key, "key2");
+  EXPECT_EQ(groups[0].records[1].value, "value2");
+  EXPECT_EQ(groups[0].hash, "hash1");
+
+  EXPECT_TRUE(groups[1].records.empty());
+  EXPECT_EQ(groups[1].hash, "hash2");
+
+  ASSERT_EQ(groups[2].records.size(), 1);
+  EXPECT_EQ(groups[2].records[0].key, "key3");
+  EXPECT_EQ(groups[2].records[0].value.size(), 0);
+  EXPECT_EQ(groups[2].hash, "hash3");
+}
+
+TEST(WriteAheadLogTests, TornTailIsDiscarded)
+{
+  uint64_t complete_size = 0;
+  {
+    WriteAheadLog log;
+    ASSERT_TRUE(log.Open("wal_test_2.wal", true));
+    EXPECT_TRUE(log.Append({{"key1", "value1"}}, "hash1"));
+    complete_size = log.size();
+    EXPECT_TRUE(log.Append({{"key2", "value2"}}, "hash2"));
+  }
+
+  // simulate a crash part way through writing the second group
+  {
+    std::ifstream input("wal_test_2.wal", std::ios::binary);
+    std::string   contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    contents.resize(contents.size() - 3);
+
+    std::ofstream output("wal_test_2.wal", std::ios::binary | std::ios::trunc);
+    output << contents;
+  }
+
+  {
+    WriteAheadLog log;
+    ASSERT_TRUE(log.Open("wal_test_2.wal", false));
+
+    auto const groups = ReadGroups(log);
+    ASSERT_EQ(groups.size(), 1);
+    EXPECT_EQ(groups[0].hash, "hash1");
+    EXPECT_EQ(log.size(), complete_size);
+
+    // further groups are appended after the last valid one
+    EXPECT_TRUE(log.Append({{"key3", "value3"}}, "hash3"));
+  }
+
+  WriteAheadLog log;
+  ASSERT_TRUE(log.Open("wal_test_2.wal", false));
+
+  auto const groups = ReadGroups(log);
+  ASSERT_EQ(groups.size(), 2);
+  EXPECT_EQ(groups[0].hash, "hash1");
+  EXPECT_EQ(groups[1].hash, "hash3");
+}
+
+TEST(WriteAheadLogTests, Truncate)
+{
+  WriteAheadLog log;
+  ASSERT_TRUE(log.Open("wal_test_3.wal", true));
+  EXPECT_TRUE(log.Append({{"key1", "value1"}}, "hash1"));
+  EXPECT_GT(log.size(), 0);
+
+  EXPECT_TRUE(log.Truncate());
+  EXPECT_EQ(log.size(), 0);
+  EXPECT_TRUE(ReadGroups(log).empty());
+}
+
+}  // namespace
@@ -17,8 +17,11 @@
 //
 //------------------------------------------------------------------------------
 
+#include <algorithm>
+#include <cstddef>
+#include <functional>
 #include <memory>
-#include <unordered_set>
+#include <stdexcept>
 #include <vector>
 
 namespace fetch {
@@ -28,6 +31,9 @@ namespace detail {
 /**
  * Basic cached object store. Useful for reusing / pre-allocating objects will be used regularly
  *
+ * The objects are allocated in chunks, which grow with the size of the pool, so that the number of
+ * heap allocations is logarithmic in the number of objects.
+ *
  * @note This is not thread safe, all implementations expect to used in the content of one thread
  *
  * @tparam T The type of the cached object.
@@ -55,15 +61,20 @@ private:
   static constexpr std::size_t DEFAULT_ALLOCATE_BATCH = 10;
 
   void Reserve(std::size_t size);
+  bool Contains(T const *element) const;
+
+  struct Chunk
+  {
+    std::unique_ptr<T[]> elements;
+    std::size_t          size;
+  };
 
-  using ElementPtr     = std::shared_ptr<T>;
-  using UnderlyingPool = std::vector<ElementPtr>;
-  using ElementList    = std::vector<T *>;
-  using ElementSet     = std::unordered_set<T *>;
+  using ChunkList   = std::vector<Chunk>;
+  using ElementList = std::vector<T *>;
 
-  UnderlyingPool pool_;
-  ElementList    free_;
-  ElementSet     in_use_;
+  ChunkList   chunks_;
+  ElementList free_;
+  std::size_t capacity_{0};
 };
 
 /**
@@ -90,7 +101,9 @@ T *ElementPool<T>::Allocate()
   // if the free queue is empty then allocate some new instances into the pool
   if (free_.empty())
   {
-    Reserve(DEFAULT_ALLOCATE_BATCH);
+    // grow the pool geometrically
+    std::size_t const batch = DEFAULT_ALLOCATE_BATCH;
+    Reserve(std::max(batch, capacity_));
   }
 
   // sanity check: the previous operation should ensure the pool is populated
@@ -102,7 +115,6 @@ T *ElementPool<T>::Allocate()
   // lookup the next element and update the internal data structures
   T *element = free_.back();
   free_.pop_back();
-  in_use_.emplace(element);
 
   return element;
 }
@@ -116,15 +128,12 @@ T *ElementPool<T>::Allocate()
 template <typename T>
 void ElementPool<T>::Release(T *element)
 {
-  if (in_use_.find(element) == in_use_.end())
+  if (!Contains(element))
   {
     throw std::runtime_error("Element is not part of this pool");
   }
-  else
-  {
-    in_use_.erase(element);
-    free_.push_back(element);
-  }
+
+  free_.push_back(element);
 }
 
 /**
@@ -136,7 +145,7 @@ void ElementPool<T>::Release(T *element)
 template <typename T>
 inline bool ElementPool<T>::empty() const
 {
-  return pool_.empty();
+  return chunks_.empty();
 }
 
 /**
@@ -148,11 +157,46 @@ inline bool ElementPool<T>::empty() const
 template <typename T>
 void ElementPool<T>::Reserve(std::size_t size)
 {
-  for (std::size_t i = 0; i < size; ++i)
+  if (size == 0)
+  {
+    return;
+  }
+
+  chunks_.push_back(Chunk{std::make_unique<T[]>(size), size});
+  capacity_ += size;
+
+  // hand out the elements in order of their address
+  T *elements = chunks_.back().elements.get();
+  free_.reserve(free_.size() + size);
+  for (std::size_t i = size; i > 0; --i)
+  {
+    free_.push_back(elements + (i - 1));
+  }
+}
+
+/**
+ * Internal: Determine if an element has been allocated by this pool
+ *
+ * @tparam T The type of the cached object
+ * @param element The element to check
+ * @return true if the element belongs to one of the chunks, otherwise false
+ */
+template <typename T>
+bool ElementPool<T>::Contains(T const *element) const
+{
+  std::less_equal<T const *> const le{};
+
+  // the chunks grow geometrically, start from the largest
+  for (auto it = chunks_.rbegin(); it != chunks_.rend(); ++it)
   {
-    pool_.emplace_back(std::make_unique<T>());
-    free_.emplace_back(pool_.back().get());
+    T const *begin = it->elements.get();
+    if (le(begin, element) && !le(begin + it->size, element))
+    {
+      return true;
+    }
   }
+
+  return false;
 }
 
 }  // namespace detail
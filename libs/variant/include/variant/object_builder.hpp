@@ -0,0 +1,176 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/byte_array/const_byte_array.hpp"
+#include "variant/variant.hpp"
+
+#include <cstddef>
+#include <utility>
+
+namespace fetch {
+namespace variant {
+
+/**
+ * Populates the members of an object variant in place.
+ *
+ * The keys of an object are kept sorted, so adding members one at a time with the index operator
+ * shifts the existing members on every insertion. The builder instead appends the members and
+ * sorts them once when it is finished (when the same key is added more than once the last value is
+ * kept). The object must not be accessed through the variant until the builder has finished.
+ *
+ * The builder is move only, so that the object is finished exactly once.
+ */
+class ObjectBuilder
+{
+public:
+  using ConstByteArray = byte_array::ConstByteArray;
+
+  // Construction / Destruction
+  explicit ObjectBuilder(Variant &object, std::size_t reserve = 0);
+  ObjectBuilder(ObjectBuilder const &) = delete;
+  ObjectBuilder(ObjectBuilder &&other) noexcept;
+  ~ObjectBuilder();
+
+  /// @name Members
+  /// @{
+  Variant &Add(ConstByteArray key);
+  template <typename T>
+  ObjectBuilder &Add(ConstByteArray key, T &&value);
+  /// @}
+
+  Variant &Finish();
+
+  // Operators
+  ObjectBuilder &operator=(ObjectBuilder const &) = delete;
+  ObjectBuilder &operator=(ObjectBuilder &&other) noexcept;
+
+private:
+  Variant *object_;
+};
+
+/**
+ * Start building an object, any previous value of the variant is replaced by an empty object
+ *
+ * @param object The variant to be populated
+ * @param reserve The expected number of members
+ */
+inline ObjectBuilder::ObjectBuilder(Variant &object, std::size_t reserve)
+  : object_{&object}
+{
+  object.Emplace(Variant::Type::OBJECT);
+  object.data_.elements.keys.reserve(reserve);
+  object.data_.elements.values.reserve(reserve);
+}
+
+/**
+ * Move construct a builder, the other builder no longer refers to the object
+ *
+ * @param other The builder to move from
+ */
+inline ObjectBuilder::ObjectBuilder(ObjectBuilder &&other) noexcept
+  : object_{other.object_}
+{
+  other.object_ = nullptr;
+}
+
+/**
+ * Destructor, finishes the object if this has not already been done
+ */
+inline ObjectBuilder::~ObjectBuilder()
+{
+  if (object_ != nullptr)
+  {
+    object_->SortMembers();
+  }
+}
+
+/**
+ * Add a member to the object
+ *
+ * @param key The key of the member
+ * @return The reference to the (undefined) value of the member, to be populated by the caller
+ */
+inline Variant &ObjectBuilder::Add(ConstByteArray key)
+{
+  if (object_ == nullptr)
+  {
+    throw std::runtime_error("Unable to add members to a finished object");
+  }
+
+  return object_->AppendMember(std::move(key));
+}
+
+/**
+ * Add a member to the object
+ *
+ * @tparam T The type of the value
+ * @param key The key of the member
+ * @param value The value of the member
+ * @return The reference to the builder
+ */
+template <typename T>
+ObjectBuilder &ObjectBuilder::Add(ConstByteArray key, T &&value)
+{
+  Add(std::move(key)) = std::forward<T>(value);
+  return *this;
+}
+
+/**
+ * Finish building the object, after which the builder can not be used any further
+ *
+ * @return The reference to the completed object
+ */
+inline Variant &ObjectBuilder::Finish()
+{
+  if (object_ == nullptr)
+  {
+    throw std::runtime_error("Object has already been finished");
+  }
+
+  Variant &object = *object_;
+  object_         = nullptr;
+
+  object.SortMembers();
+  return object;
+}
+
+/**
+ * Move assign a builder, any object being built by this builder is finished first
+ *
+ * @param other The builder to move from
+ * @return The reference to this builder
+ */
+inline ObjectBuilder &ObjectBuilder::operator=(ObjectBuilder &&other) noexcept
+{
+  if (this != &other)
+  {
+    if (object_ != nullptr)
+    {
+      object_->SortMembers();
+    }
+
+    object_       = other.object_;
+    other.object_ = nullptr;
+  }
+
+  return *this;
+}
+
+}  // namespace variant
+}  // namespace fetch
@@ -22,9 +22,11 @@
 #include "meta/type_traits.hpp"
 #include "variant/detail/element_pool.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
+#include <new>
 #include <stdexcept>
-#include <unordered_map>
 #include <vector>
 
 namespace fetch {
@@ -42,13 +44,18 @@ namespace variant {
  *
  * It is a useful interchange format to JSON, YAML, Message Pack etc. Including other programming
  * languages.
+ *
+ * The value is a tagged union, only the storage of the current type is live. Strings are held in a
+ * ConstByteArray (which keeps small strings inline), and the members of an object are held sorted
+ * by key in a flat vector so that they can be looked up with a binary search. The elements of
+ * arrays and objects are allocated from a pool which is owned by the top level variant.
  */
 class Variant
 {
 public:
   using ConstByteArray = byte_array::ConstByteArray;
 
-  enum class Type
+  enum class Type : uint8_t
   {
     UNDEFINED,
     INTEGER,
@@ -72,7 +79,7 @@ public:
   Variant() = default;
   Variant(std::size_t pool_reserve);
   Variant(Variant const &);
-  Variant(Variant &&) = default;
+  Variant(Variant &&);
   ~Variant();
 
   template <typename T>
@@ -183,6 +190,7 @@ public:
   Variant &                         operator=(char const *value);
 
   Variant &operator=(Variant const &value);
+  Variant &operator=(Variant &&value);
 
   bool operator==(Variant const &other) const;
   bool operator!=(Variant const &other) const;
@@ -197,36 +205,60 @@ public:
   /// @}
 
   friend std::ostream &operator<<(std::ostream &stream, Variant const &variant);
+  friend class ObjectBuilder;
 
 private:
-  using VariantList   = std::vector<Variant *>;
-  using VariantObject = std::unordered_map<ConstByteArray, Variant *>;
-  using Pool          = detail::ElementPool<Variant>;
+  using VariantList = std::vector<Variant *>;
+  using KeyList     = std::vector<ConstByteArray>;
+  using Pool        = detail::ElementPool<Variant>;
+  using PoolPtr     = std::unique_ptr<Pool>;
+
+  /**
+   * The elements of an array, or the members of an object. For objects the keys are sorted and the
+   * values are stored at the same indices as their keys.
+   */
+  struct Elements
+  {
+    VariantList values;
+    KeyList     keys;
+  };
 
-  union PrimitiveData
+  union Data
   {
-    int64_t integer;
-    double  float_point;
-    bool    boolean;
+    Data()
+      : integer{0}
+    {}
+    ~Data()
+    {}
+
+    int64_t        integer;
+    double         float_point;
+    bool           boolean;
+    ConstByteArray string;
+    Elements       elements;
   };
 
   /// @name Helper Methods
   /// @{
-  Pool &   pool();
-  Variant *parent();
-  void     Reset();
+  Pool &                   pool();
+  bool                     IsTopLevel() const;
+  Variant *                AllocateElement();
+  void                     ReleaseElement(Variant *element);
+  void                     Reset();
+  void                     Emplace(Type type);
+  void                     MoveFrom(Variant &other);
+  KeyList::const_iterator  FindKey(ConstByteArray const &key) const;
+  Variant &                AppendMember(ConstByteArray key);
+  void                     SortMembers();
   /// @}
 
   // Memory management
-  Variant *parent_{nullptr};  ///< The parent to which all sub-variants are allocated
-  Pool     pool_;             ///< The pool of variant objects (populated for top only)
+  Pool *  pool_{nullptr};  ///< The pool sub-variants are allocated from (owned by the top level)
+  PoolPtr owned_pool_;     ///< The pool of variant objects (populated for top level only)
 
   // Data Elements
-  Type           type_{Type::UNDEFINED};  ///< The type of the variant
-  PrimitiveData  primitive_;              ///< Union of primitive data values
-  ConstByteArray string_;                 ///< The string value of the variant
-  VariantList    array_;                  ///< The array value of the variant
-  VariantObject  object_;                 ///< The object value of the variant
+  Type type_{Type::UNDEFINED};  ///< The type of the variant
+  Data data_;                   ///< The value of the variant, depending on the type
 };
 
 /**
@@ -237,7 +269,7 @@ private:
 inline Variant Variant::Null()
 {
   Variant v;
-  v.type_ = Type::NULL_VALUE;
+  v.Emplace(Type::NULL_VALUE);
   return v;
 }
 
@@ -260,7 +292,7 @@ inline Variant Variant::Undefined()
 inline Variant Variant::Array(std::size_t elements)
 {
   Variant v;
-  v.type_ = Type::ARRAY;
+  v.Emplace(Type::ARRAY);
   v.ResizeArray(elements);
 
   return v;
@@ -274,7 +306,7 @@ inline Variant Variant::Array(std::size_t elements)
 inline Variant Variant::Object()
 {
   Variant v;
-  v.type_ = Type::OBJECT;
+  v.Emplace(Type::OBJECT);
 
   return v;
 }
@@ -285,8 +317,10 @@ inline Variant Variant::Object()
  * @param pool_reserve The number of elements to preallocate
  */
 inline Variant::Variant(std::size_t pool_reserve)
-  : pool_(pool_reserve)
-{}
+  : owned_pool_{std::make_unique<Pool>(pool_reserve)}
+{
+  pool_ = owned_pool_.get();
+}
 
 /**
  * (Deep) copy construct a variant from another variant
@@ -299,6 +333,20 @@ inline Variant::Variant(Variant const &other)
   *this = other;
 }
 
+/**
+ * Move construct a variant from another variant
+ *
+ * The contents of top level variants are transferred, along with their pool. The elements of
+ * other variants belong to the pool of their top level variant, and so they are copied instead.
+ *
+ * @param other The other variant to move from
+ */
+inline Variant::Variant(Variant &&other)
+  : Variant()
+{
+  *this = std::move(other);
+}
+
 /**
  * Destructor
  */
@@ -317,8 +365,8 @@ template <typename T>
 Variant::Variant(T const &value, meta::IfIsBoolean<T> *)
   : Variant()
 {
-  type_              = Type::BOOLEAN;
-  primitive_.boolean = value;
+  type_         = Type::BOOLEAN;
+  data_.boolean = value;
 }
 
 /**
@@ -331,8 +379,8 @@ template <typename T>
 Variant::Variant(T const &value, meta::IfIsInteger<T> *)
   : Variant()
 {
-  type_              = Type::INTEGER;
-  primitive_.integer = static_cast<int64_t>(value);
+  type_         = Type::INTEGER;
+  data_.integer = static_cast<int64_t>(value);
 }
 
 /**
@@ -345,8 +393,8 @@ template <typename T>
 Variant::Variant(T const &value, meta::IfIsFloat<T> *)
   : Variant()
 {
-  type_                  = Type::FLOATING_POINT;
-  primitive_.float_point = static_cast<double>(value);
+  type_             = Type::FLOATING_POINT;
+  data_.float_point = static_cast<double>(value);
 }
 
 /**
@@ -359,8 +407,8 @@ template <typename T>
 Variant::Variant(T &&value, meta::IfIsString<T> *)
   : Variant()
 {
-  type_   = Type::STRING;
-  string_ = std::forward<T>(value);
+  type_ = Type::STRING;
+  new (&data_.string) ConstByteArray(std::forward<T>(value));
 }
 
 /**
@@ -371,8 +419,8 @@ Variant::Variant(T &&value, meta::IfIsString<T> *)
 inline Variant::Variant(char const *value)
   : Variant()
 {
-  type_   = Type::STRING;
-  string_ = value;
+  type_ = Type::STRING;
+  new (&data_.string) ConstByteArray(value);
 }
 
 /**
@@ -438,7 +486,7 @@ meta::IfIsBoolean<T, T> Variant::As() const
     throw std::runtime_error("Variant type mismatch, unable to extract boolean value");
   }
 
-  return primitive_.boolean;
+  return data_.boolean;
 }
 
 /**
@@ -456,7 +504,7 @@ meta::IfIsInteger<T, T> Variant::As() const
     throw std::runtime_error("Variant type mismatch, unable to extract integer value");
   }
 
-  return static_cast<T>(primitive_.integer);
+  return static_cast<T>(data_.integer);
 }
 
 /**
@@ -474,7 +522,7 @@ meta::IfIsFloat<T, T> Variant::As() const
     throw std::runtime_error("Variant type mismatch, unable to extract floating point value");
   }
 
-  return static_cast<T>(primitive_.float_point);
+  return static_cast<T>(data_.float_point);
 }
 
 /**
@@ -492,7 +540,7 @@ meta::IfIsConstByteArray<T, Variant::ConstByteArray const &> Variant::As() const
     throw std::runtime_error("Variant type mismatch, unable to extract string value");
   }
 
-  return string_;
+  return data_.string;
 }
 
 /**
@@ -510,7 +558,7 @@ meta::IfIsStdString<T, std::string> Variant::As() const
     throw std::runtime_error("Variant type mismatch, unable to extract string value");
   }
 
-  return static_cast<std::string>(string_);
+  return static_cast<std::string>(data_.string);
 }
 
 /**
@@ -525,8 +573,8 @@ meta::IfIsBoolean<T, Variant &> Variant::operator=(T const &value)
 {
   Reset();
 
-  type_              = Type::BOOLEAN;
-  primitive_.boolean = value;
+  type_         = Type::BOOLEAN;
+  data_.boolean = value;
 
   return *this;
 }
@@ -543,8 +591,8 @@ meta::IfIsInteger<T, Variant &> Variant::operator=(T const &value)
 {
   Reset();
 
-  type_              = Type::INTEGER;
-  primitive_.integer = static_cast<int64_t>(value);
+  type_         = Type::INTEGER;
+  data_.integer = static_cast<int64_t>(value);
 
   return *this;
 }
@@ -561,8 +609,8 @@ meta::IfIsFloat<T, Variant &> Variant::operator=(T const &value)
 {
   Reset();
 
-  type_                  = Type::FLOATING_POINT;
-  primitive_.float_point = static_cast<double>(value);
+  type_             = Type::FLOATING_POINT;
+  data_.float_point = static_cast<double>(value);
 
   return *this;
 }
@@ -579,8 +627,8 @@ meta::IfIsAByteArray<T, Variant &> Variant::operator=(T const &value)
 {
   Reset();
 
-  type_   = Type::STRING;
-  string_ = value;
+  type_ = Type::STRING;
+  new (&data_.string) ConstByteArray(value);
 
   return *this;
 }
@@ -597,8 +645,8 @@ meta::IfIsStdString<T, Variant &> Variant::operator=(T const &value)
 {
   Reset();
 
-  type_   = Type::STRING;
-  string_ = ConstByteArray{value};
+  type_ = Type::STRING;
+  new (&data_.string) ConstByteArray(value);
 
   return *this;
 }
@@ -613,8 +661,8 @@ inline Variant &Variant::operator=(char const *value)
 {
   Reset();
 
-  type_   = Type::STRING;
-  string_ = ConstByteArray{value};
+  type_ = Type::STRING;
+  new (&data_.string) ConstByteArray(value);
 
   return *this;
 }
@@ -633,7 +681,7 @@ inline Variant &Variant::operator[](std::size_t index)
     throw std::runtime_error("Unable to access index of non-array variant");
   }
 
-  return *(array_.at(index));
+  return *(data_.elements.values.at(index));
 }
 
 /**
@@ -650,7 +698,7 @@ inline Variant const &Variant::operator[](std::size_t index) const
     throw std::runtime_error("Unable to access index of non-array variant");
   }
 
-  return *(array_.at(index));
+  return *(data_.elements.values.at(index));
 }
 
 /**
@@ -668,18 +716,21 @@ inline Variant &Variant::operator[](ConstByteArray const &key)
     throw std::runtime_error("Unable to access keys of non-object variant");
   }
 
-  auto it = object_.find(key);
-  if (it != object_.end())
+  auto &     keys = data_.elements.keys;
+  auto const it   = FindKey(key);
+  auto const pos  = it - keys.cbegin();
+
+  if ((it != keys.cend()) && (*it == key))
   {
-    return *(it->second);
+    return *(data_.elements.values[static_cast<std::size_t>(pos)]);
   }
 
-  // allocate an element
-  Variant *variant = pool().Allocate();
-  variant->parent_ = parent();
+  // allocate an element and insert it in the sorted position
+  Variant *variant = AllocateElement();
 
-  // update the map
-  object_[key] = variant;
+  auto &values = data_.elements.values;
+  values.insert(values.begin() + pos, variant);
+  keys.insert(keys.begin() + pos, key);
 
   // return the variant
   return *variant;
@@ -700,13 +751,15 @@ inline Variant const &Variant::operator[](ConstByteArray const &key) const
     throw std::runtime_error("Unable to access keys of non-object variant");
   }
 
-  auto it = object_.find(key);
-  if (it == object_.end())
+  auto const &keys = data_.elements.keys;
+  auto const  it   = FindKey(key);
+
+  if ((it == keys.cend()) || (*it != key))
   {
     throw std::out_of_range("Key not present in object");
   }
 
-  return *(it->second);
+  return *(data_.elements.values[static_cast<std::size_t>(it - keys.cbegin())]);
 }
 
 /**
@@ -723,7 +776,9 @@ inline bool Variant::Has(ConstByteArray const &key) const
     throw std::runtime_error("Unable to access keys of non-object variant");
   }
 
-  return object_.find(key) != object_.end();
+  auto const it = FindKey(key);
+
+  return (it != data_.elements.keys.cend()) && (*it == key);
 }
 
 /**
@@ -752,15 +807,12 @@ inline std::size_t Variant::size() const
     break;
 
   case Type::STRING:
-    length = string_.size();
+    length = data_.string.size();
     break;
 
   case Type::ARRAY:
-    length = array_.size();
-    break;
-
   case Type::OBJECT:
-    length = object_.size();
+    length = data_.elements.values.size();
     break;
   }
 
@@ -768,24 +820,72 @@ inline std::size_t Variant::size() const
 }
 
 /**
- * Internal: Helper to lookup the correct pool
+ * Internal: Helper to lookup the correct pool, top level variants create theirs on first use
  *
  * @return The reference to the pool to allocate from
  */
 inline Variant::Pool &Variant::pool()
 {
-  assert((parent_) ? pool_.empty() : true);
-  return (parent_) ? parent_->pool_ : pool_;
+  if (pool_ == nullptr)
+  {
+    owned_pool_ = std::make_unique<Pool>();
+    pool_       = owned_pool_.get();
+  }
+
+  return *pool_;
+}
+
+/**
+ * Internal: Determine if this variant is a top level variant, i.e. not an element of another one
+ *
+ * @return true if top level, otherwise false
+ */
+inline bool Variant::IsTopLevel() const
+{
+  return (pool_ == nullptr) || static_cast<bool>(owned_pool_);
 }
 
 /**
- * Internal: Calculate the correct value for a parent field of a sub object
+ * Internal: Allocate an (undefined) element of this array or object
  *
- * @return The pointer to the parent variant
+ * @return The pointer to the new element
  */
-inline Variant *Variant::parent()
+inline Variant *Variant::AllocateElement()
 {
-  return (parent_) ? parent_ : this;
+  Pool &pool = this->pool();
+
+  Variant *element = pool.Allocate();
+  assert(element->pool_ == nullptr);
+  element->pool_ = &pool;
+
+  return element;
+}
+
+/**
+ * Internal: Release an element of this array or object back to the pool
+ *
+ * @param element The element to be released
+ */
+inline void Variant::ReleaseElement(Variant *element)
+{
+  assert(element->pool_ == pool_);
+
+  element->Reset();
+  element->pool_ = nullptr;
+
+  pool_->Release(element);
+}
+
+/**
+ * Internal: Lookup the position of a key in the (sorted) keys of an object
+ *
+ * @param key The key to lookup
+ * @return The iterator to the first key not less than the specified key
+ */
+inline Variant::KeyList::const_iterator Variant::FindKey(ConstByteArray const &key) const
+{
+  auto const &keys = data_.elements.keys;
+  return std::lower_bound(keys.cbegin(), keys.cend(), key);
 }
 
 /**
@@ -808,31 +908,24 @@ inline void Variant::ResizeArray(std::size_t length)
     throw std::runtime_error("Unable to resize non-array type");
   }
 
-  Variant *parent = (parent_) ? parent_ : this;
+  auto &values = data_.elements.values;
 
   // increase the array size
-  while (length > array_.size())
+  if (length > values.size())
   {
-    Variant *variant = pool().Allocate();
-
-    assert(variant->parent_ == nullptr);
-    variant->parent_ = parent;
+    values.reserve(std::max(length, values.size() * 2));
+  }
 
-    array_.push_back(variant);
+  while (length > values.size())
+  {
+    values.push_back(AllocateElement());
   }
 
   // decrease the array size
-  while (length < array_.size())
+  while (length < values.size())
   {
-    Variant *variant = array_.back();
-    assert(variant->parent_ == parent);
-
-    variant->Reset();
-    variant->parent_ = nullptr;
-
-    pool().Release(variant);
-
-    array_.pop_back();
+    ReleaseElement(values.back());
+    values.pop_back();
   }
 }
 
@@ -872,9 +965,10 @@ void Variant::IterateObject(Function const &function)
 {
   if (IsObject())
   {
-    for (auto &variant : object_)
+    auto const &elements = data_.elements;
+    for (std::size_t i = 0, end = elements.keys.size(); i < end; ++i)
     {
-      if (!function(variant.first, *variant.second))
+      if (!function(elements.keys[i], *elements.values[i]))
       {
         break;
       }
@@ -908,9 +1002,11 @@ void Variant::IterateObject(Function const &function) const
 {
   if (IsObject())
   {
-    for (auto const &item : object_)
+    auto const &elements = data_.elements;
+    for (std::size_t i = 0, end = elements.keys.size(); i < end; ++i)
     {
-      if (!function(item.first, *item.second))
+      Variant const &value = *elements.values[i];
+      if (!function(elements.keys[i], value))
       {
         break;
       }
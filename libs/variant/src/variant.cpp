@@ -17,9 +17,10 @@
 //------------------------------------------------------------------------------
 
 #include "variant/variant.hpp"
-#include "core/macros.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <utility>
 
 namespace fetch {
 namespace variant {
@@ -32,10 +33,12 @@ namespace variant {
  */
 Variant &Variant::operator=(Variant const &value)
 {
-  Reset();
+  if (this == &value)
+  {
+    return *this;
+  }
 
-  // update the type
-  type_ = value.type_;
+  Emplace(value.type_);
 
   // based on the new type update accordingly
   switch (type_)
@@ -46,36 +49,35 @@ Variant &Variant::operator=(Variant const &value)
     break;
 
   case Type::BOOLEAN:
+    data_.boolean = value.data_.boolean;
+    break;
+
   case Type::INTEGER:
+    data_.integer = value.data_.integer;
+    break;
+
   case Type::FLOATING_POINT:
-    primitive_ = value.primitive_;
+    data_.float_point = value.data_.float_point;
     break;
 
   case Type::STRING:
-    string_ = value.string_;
+    data_.string = value.data_.string;
     break;
 
   case Type::ARRAY:
-    ResizeArray(value.array_.size());
-    for (std::size_t i = 0, end = value.array_.size(); i < end; ++i)
-    {
-      *(array_.at(i)) = *(value.array_.at(i));
-    }
-    break;
-
   case Type::OBJECT:
   {
-    for (auto const &element : value.object_)
-    {
-      // create an element
-      Variant *obj = pool().Allocate();
-      obj->parent_ = parent();
+    auto const &other = value.data_.elements;
+    auto &      own   = data_.elements;
 
-      // make a deep copy
-      *obj = *element.second;
+    own.keys = other.keys;
+    own.values.reserve(other.values.size());
 
-      // update our object
-      object_.emplace(element.first, obj);
+    for (Variant const *element : other.values)
+    {
+      // make a deep copy
+      own.values.push_back(AllocateElement());
+      *own.values.back() = *element;
     }
     break;
   }
@@ -84,6 +86,34 @@ Variant &Variant::operator=(Variant const &value)
   return *this;
 }
 
+/**
+ * Variant move assignment operator
+ *
+ * The contents of a top level variant are transferred into a top level variant. Otherwise the
+ * pools of the two variants differ, and the value is copied.
+ *
+ * @param value The value to be moved
+ * @return Reference to the current object
+ */
+Variant &Variant::operator=(Variant &&value)
+{
+  if (this == &value)
+  {
+    return *this;
+  }
+
+  if (IsTopLevel() && value.IsTopLevel())
+  {
+    MoveFrom(value);
+  }
+  else
+  {
+    *this = static_cast<Variant const &>(value);
+  }
+
+  return *this;
+}
+
 /**
  * Check for equality between to variant objects
  *
@@ -104,32 +134,38 @@ bool Variant::operator==(Variant const &other) const
       break;
 
     case Type::INTEGER:
-      equal = primitive_.integer == other.primitive_.integer;
+      equal = data_.integer == other.data_.integer;
       break;
 
     case Type::FLOATING_POINT:
-      equal = primitive_.float_point == other.primitive_.float_point;
+      equal = data_.float_point == other.data_.float_point;
       break;
 
     case Type::BOOLEAN:
-      equal = primitive_.boolean == other.primitive_.boolean;
+      equal = data_.boolean == other.data_.boolean;
       break;
 
     case Type::STRING:
-      equal = string_ == other.string_;
+      equal = data_.string == other.data_.string;
       break;
 
     case Type::ARRAY:
+    case Type::OBJECT:
     {
-      equal = array_.size() == other.array_.size();
+      auto const &values       = data_.elements.values;
+      auto const &other_values = other.data_.elements.values;
+
+      // since the keys are sorted equal objects have equal key lists
+      equal = (values.size() == other_values.size()) &&
+              (data_.elements.keys == other.data_.elements.keys);
 
       if (equal)
       {
         // check the contents
-        for (std::size_t i = 0; i < array_.size(); ++i)
+        for (std::size_t i = 0; i < values.size(); ++i)
         {
           // if the pointers are different and the contents are different
-          if ((array_[i] != other.array_[i]) && (*array_[i] != *other.array_[i]))
+          if ((values[i] != other_values[i]) && (*values[i] != *other_values[i]))
           {
             equal = false;
             break;
@@ -138,31 +174,6 @@ bool Variant::operator==(Variant const &other) const
       }
       break;
     }
-
-    case Type::OBJECT:
-    {
-      equal = object_.size() == other.object_.size();
-
-      for (auto const &element : object_)
-      {
-        // lookup key in the other array
-        auto it = other.object_.find(element.first);
-        if (it == other.object_.end())
-        {
-          equal = false;
-          break;
-        }
-
-        // if the pointers are different and the contents are different
-        if ((element.second != it->second) && (*element.second != *(it->second)))
-        {
-          equal = false;
-          break;
-        }
-      }
-
-      break;
-    }
     }
   }
 
@@ -183,36 +194,185 @@ void Variant::Reset()
   case Type::BOOLEAN:
     break;
   case Type::STRING:
-    string_ = ConstByteArray();
+    data_.string.~ConstByteArray();
     break;
 
   case Type::ARRAY:
-    ResizeArray(0);
+  case Type::OBJECT:
+  {
+    for (Variant *element : data_.elements.values)
+    {
+      ReleaseElement(element);
+    }
+
+    data_.elements.~Elements();
+    break;
+  }
+  }
+
+  type_ = Type::UNDEFINED;
+}
+
+/**
+ * Internal: Reset the variant and construct the (empty) storage for a new type
+ *
+ * @param type The new type of the variant
+ */
+void Variant::Emplace(Type type)
+{
+  Reset();
+
+  switch (type)
+  {
+  case Type::UNDEFINED:
+  case Type::NULL_VALUE:
+  case Type::INTEGER:
+  case Type::FLOATING_POINT:
+  case Type::BOOLEAN:
+    data_.integer = 0;
     break;
 
+  case Type::STRING:
+    new (&data_.string) ConstByteArray();
+    break;
+
+  case Type::ARRAY:
   case Type::OBJECT:
+    new (&data_.elements) Elements();
+    break;
+  }
+
+  type_ = type;
+}
+
+/**
+ * Internal: Transfer the contents of another top level variant into this one, leaving the other
+ * variant undefined
+ *
+ * @param other The variant to move from
+ */
+void Variant::MoveFrom(Variant &other)
+{
+  assert(IsTopLevel() && other.IsTopLevel());
+
+  Reset();
+
+  // the elements of the other variant belong to its pool, so the pools are exchanged. When the
+  // other variant has no elements the current pool (and its reserve) is kept instead.
+  if (other.pool_ != nullptr)
+  {
+    std::swap(pool_, other.pool_);
+    std::swap(owned_pool_, other.owned_pool_);
+  }
+
+  switch (other.type_)
   {
-    Variant *parent = (parent_) ? parent_ : this;
+  case Type::UNDEFINED:
+  case Type::NULL_VALUE:
+    break;
 
-    auto it = object_.begin();
-    while (it != object_.end())
-    {
-      Variant *variant = it->second;
-      it               = object_.erase(it);
+  case Type::BOOLEAN:
+    data_.boolean = other.data_.boolean;
+    break;
+
+  case Type::INTEGER:
+    data_.integer = other.data_.integer;
+    break;
 
-      assert(variant->parent_ == parent);
-      FETCH_UNUSED(parent);
+  case Type::FLOATING_POINT:
+    data_.float_point = other.data_.float_point;
+    break;
 
-      variant->Reset();
-      variant->parent_ = nullptr;
+  case Type::STRING:
+    new (&data_.string) ConstByteArray(std::move(other.data_.string));
+    break;
 
-      pool().Release(variant);
-    }
+  case Type::ARRAY:
+  case Type::OBJECT:
+    new (&data_.elements) Elements(std::move(other.data_.elements));
+    other.data_.elements.values.clear();
     break;
   }
+
+  type_ = other.type_;
+  other.Reset();
+}
+
+/**
+ * Internal: Append a member to an object without maintaining the order of the keys. The object
+ * must be sorted with SortMembers before it is accessed again.
+ *
+ * @param key The key of the member
+ * @return The reference to the value of the new member
+ */
+Variant &Variant::AppendMember(ConstByteArray key)
+{
+  if (type_ != Type::OBJECT)
+  {
+    throw std::runtime_error("Unable to add members to non-object variant");
   }
 
-  type_ = Type::UNDEFINED;
+  Variant *variant = AllocateElement();
+
+  data_.elements.keys.push_back(std::move(key));
+  data_.elements.values.push_back(variant);
+
+  return *variant;
+}
+
+/**
+ * Internal: Sort the members of an object which have been appended, when the same key has been
+ * appended several times the last value is kept.
+ */
+void Variant::SortMembers()
+{
+  assert(type_ == Type::OBJECT);
+
+  auto &keys   = data_.elements.keys;
+  auto &values = data_.elements.values;
+
+  // nothing to be done if the keys are already in order (and unique)
+  auto const out_of_order = [](ConstByteArray const &a, ConstByteArray const &b) {
+    return !(a < b);
+  };
+
+  if (std::adjacent_find(keys.begin(), keys.end(), out_of_order) == keys.end())
+  {
+    return;
+  }
+
+  // determine the sorted order, duplicate keys remain in the order in which they were added
+  std::vector<std::size_t> order(keys.size());
+  for (std::size_t i = 0; i < order.size(); ++i)
+  {
+    order[i] = i;
+  }
+
+  std::stable_sort(order.begin(), order.end(),
+                   [&keys](std::size_t a, std::size_t b) { return keys[a] < keys[b]; });
+
+  KeyList     sorted_keys;
+  VariantList sorted_values;
+  sorted_keys.reserve(keys.size());
+  sorted_values.reserve(values.size());
+
+  for (std::size_t i = 0; i < order.size(); ++i)
+  {
+    std::size_t const index = order[i];
+
+    // only the last of the duplicate keys is kept
+    if (((i + 1) < order.size()) && (keys[order[i + 1]] == keys[index]))
+    {
+      ReleaseElement(values[index]);
+      continue;
+    }
+
+    sorted_keys.push_back(std::move(keys[index]));
+    sorted_values.push_back(values[index]);
+  }
+
+  keys   = std::move(sorted_keys);
+  values = std::move(sorted_values);
 }
 
 /**
@@ -255,7 +415,7 @@ std::ostream &operator<<(std::ostream &stream, Variant const &variant)
   case Variant::Type::ARRAY:
     stream << "[";
 
-    for (std::size_t i = 0; i < variant.array_.size(); ++i)
+    for (std::size_t i = 0; i < variant.data_.elements.values.size(); ++i)
     {
       if (i != 0)
       {
@@ -263,7 +423,7 @@ std::ostream &operator<<(std::ostream &stream, Variant const &variant)
       }
 
       // recursively call the stream operator
-      stream << *(variant.array_[i]);
+      stream << *(variant.data_.elements.values[i]);
     }
 
     stream << "]";
@@ -272,8 +432,7 @@ std::ostream &operator<<(std::ostream &stream, Variant const &variant)
   case Variant::Type::OBJECT:
     stream << "{";
 
-    std::size_t i{0};
-    for (auto const &element : variant.object_)
+    for (std::size_t i = 0; i < variant.data_.elements.keys.size(); ++i)
     {
       if (i != 0)
       {
@@ -281,9 +440,8 @@ std::ostream &operator<<(std::ostream &stream, Variant const &variant)
       }
 
       // format the element
-      stream << std::quoted(std::string{element.first}) << ": " << *(element.second);
-
-      ++i;
+      stream << std::quoted(std::string{variant.data_.elements.keys[i]}) << ": "
+             << *(variant.data_.elements.values[i]);
     }
 
     stream << "}";
@@ -18,10 +18,15 @@
 
 #include "core/byte_array/byte_array.hpp"
 #include "core/byte_array/const_byte_array.hpp"
+#include "variant/object_builder.hpp"
 #include "variant/variant.hpp"
 
 #include <gtest/gtest.h>
 
+#include <sstream>
+#include <string>
+#include <utility>
+
 namespace {
 
 class VariantTests : public ::testing::Test
@@ -598,6 +603,94 @@ TEST_F(VariantTests, ConstObjectAccess)
   }
 }
 
+TEST_F(VariantTests, ObjectKeysAreOrdered)
+{
+  Variant v  = Variant::Object();
+  v["zeta"]  = 1;
+  v["beta"]  = 2;
+  v["alpha"] = 3;
+  v["beta"]  = 4;
+
+  EXPECT_EQ(v.size(), 3);
+
+  std::ostringstream oss;
+  oss << v;
+  EXPECT_EQ(oss.str(), R"({"alpha": 3, "beta": 4, "zeta": 1})");
+
+  // the order does not depend on the order of insertion
+  Variant w  = Variant::Object();
+  w["beta"]  = 4;
+  w["alpha"] = 3;
+  w["zeta"]  = 1;
+  EXPECT_EQ(v, w);
+}
+
+TEST_F(VariantTests, ObjectBuilder)
+{
+  Variant v{"previous value"};
+
+  {
+    fetch::variant::ObjectBuilder builder{v, 4};
+    builder.Add("zeta", 1).Add("beta", 2).Add("alpha", "first");
+    builder.Add("array") = Variant::Array(2);
+
+    // the last value of a duplicate key is kept
+    builder.Add("alpha", "second");
+
+    Variant &object = builder.Finish();
+    EXPECT_EQ(&object, &v);
+    EXPECT_THROW(builder.Add("late"), std::runtime_error);
+  }
+
+  ASSERT_TRUE(v.IsObject());
+  EXPECT_EQ(v.size(), 4);
+  EXPECT_EQ(v["alpha"].As<ConstByteArray>(), "second");
+  EXPECT_EQ(v["beta"].As<int>(), 2);
+  EXPECT_EQ(v["zeta"].As<int>(), 1);
+  EXPECT_EQ(v["array"].size(), 2);
+
+  // a builder which has been moved from no longer refers to the object
+  Variant w;
+  {
+    fetch::variant::ObjectBuilder first{w};
+    fetch::variant::ObjectBuilder second{std::move(first)};
+    second.Add("b", 2);
+    second.Add("a", 1);
+  }
+
+  std::ostringstream oss;
+  oss << w;
+  EXPECT_EQ(oss.str(), R"({"a": 1, "b": 2})");
+}
+
+TEST_F(VariantTests, MovedVariantsKeepTheirElements)
+{
+  Variant v         = Variant::Object();
+  v["obj"]          = Variant::Object();
+  v["obj"]["array"] = Variant::Array(2);
+
+  Variant w{std::move(v)};
+  EXPECT_TRUE(v.IsUndefined());
+
+  // the elements of the moved variant can still be extended
+  w["obj"]["array"].ResizeArray(3);
+  w["obj"]["array"][2] = "value";
+  w["obj"]["other"]    = 42;
+
+  Variant x;
+  x = std::move(w);
+  EXPECT_TRUE(w.IsUndefined());
+
+  ASSERT_TRUE(x.IsObject());
+  EXPECT_EQ(x["obj"]["array"].size(), 3);
+  EXPECT_EQ(x["obj"]["array"][2].As<ConstByteArray>(), "value");
+  EXPECT_EQ(x["obj"]["other"].As<int>(), 42);
+
+  // moving an element of another variant copies it
+  Variant y{std::move(x["obj"])};
+  EXPECT_EQ(y, x["obj"]);
+}
+
 TEST_F(VariantTests, IllAdvisedOperations)
 {
   Variant a = Variant::Array(0);
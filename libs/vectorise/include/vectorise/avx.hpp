@@ -204,7 +204,7 @@ public:
 
   void Store(type *ptr) const
   {
-    _mm256_stream_pd(ptr, data_);
+    _mm256_store_pd(ptr, data_);
   }
   void Stream(type *ptr) const
   {
@@ -380,10 +380,11 @@ inline VectorRegister<double, 256> min(VectorRegister<double, 256> const &a,
 inline VectorRegister<double, 256> vector_zero_below_element(VectorRegister<double, 256> const &a,
                                                              int const &                        n)
 {
-  alignas(16) uint64_t mask[2] = {uint64_t(-(0 >= n)), uint64_t(-(1 >= n))};
+  alignas(32) uint64_t mask[4] = {uint64_t(-(0 >= n)), uint64_t(-(1 >= n)), uint64_t(-(2 >= n)),
+                                  uint64_t(-(3 >= n))};
 
   __m256i conv = _mm256_castpd_si256(a.data());
-  conv         = _mm256_and_si256(conv, *(__m256i *)mask);
+  conv         = _mm256_and_si256(conv, *reinterpret_cast<__m256i const *>(mask));
 
   return VectorRegister<double, 256>(_mm256_castsi256_pd(conv));
 }
@@ -391,10 +392,11 @@ inline VectorRegister<double, 256> vector_zero_below_element(VectorRegister<doub
 inline VectorRegister<double, 256> vector_zero_above_element(VectorRegister<double, 256> const &a,
                                                              int const &                        n)
 {
-  alignas(16) uint64_t mask[2] = {uint64_t(-(0 <= n)), uint64_t(-(1 <= n))};
+  alignas(32) uint64_t mask[4] = {uint64_t(-(0 <= n)), uint64_t(-(1 <= n)), uint64_t(-(2 <= n)),
+                                  uint64_t(-(3 <= n))};
 
   __m256i conv = _mm256_castpd_si256(a.data());
-  conv         = _mm256_and_si256(conv, *(__m256i *)mask);
+  conv         = _mm256_and_si256(conv, *reinterpret_cast<__m256i const *>(mask));
 
   return VectorRegister<double, 256>(_mm256_castsi256_pd(conv));
 }
@@ -402,25 +404,29 @@ inline VectorRegister<double, 256> vector_zero_above_element(VectorRegister<doub
 inline VectorRegister<float, 256> vector_zero_below_element(VectorRegister<float, 256> const &a,
                                                             int const &                       n)
 {
-  alignas(16) const uint32_t mask[4] = {uint32_t(-(0 >= n)), uint32_t(-(1 >= n)),
-                                        uint32_t(-(2 >= n)), uint32_t(-(3 >= n))};
+  alignas(32) const uint32_t mask[8] = {uint32_t(-(0 >= n)), uint32_t(-(1 >= n)),
+                                        uint32_t(-(2 >= n)), uint32_t(-(3 >= n)),
+                                        uint32_t(-(4 >= n)), uint32_t(-(5 >= n)),
+                                        uint32_t(-(6 >= n)), uint32_t(-(7 >= n))};
 
-  __m256i conv = _mm256_castpd_si256(a.data());
-  conv         = _mm256_and_si256(conv, *(__m256i *)mask);
+  __m256i conv = _mm256_castps_si256(a.data());
+  conv         = _mm256_and_si256(conv, *reinterpret_cast<__m256i const *>(mask));
 
-  return VectorRegister<float, 256>(_mm256_castsi256_pd(conv));
+  return VectorRegister<float, 256>(_mm256_castsi256_ps(conv));
 }
 
 inline VectorRegister<float, 256> vector_zero_above_element(VectorRegister<float, 256> const &a,
                                                             int const &                       n)
 {
-  alignas(16) const uint32_t mask[4] = {uint32_t(-(0 <= n)), uint32_t(-(1 <= n)),
-                                        uint32_t(-(2 <= n)), uint32_t(-(3 <= n))};
+  alignas(32) const uint32_t mask[8] = {uint32_t(-(0 <= n)), uint32_t(-(1 <= n)),
+                                        uint32_t(-(2 <= n)), uint32_t(-(3 <= n)),
+                                        uint32_t(-(4 <= n)), uint32_t(-(5 <= n)),
+                                        uint32_t(-(6 <= n)), uint32_t(-(7 <= n))};
 
-  __m256i conv = _mm256_castpd_si256(a.data());
-  conv         = _mm256_and_si256(conv, *(__m256i *)mask);
+  __m256i conv = _mm256_castps_si256(a.data());
+  conv         = _mm256_and_si256(conv, *reinterpret_cast<__m256i const *>(mask));
 
-  return VectorRegister<float, 256>(_mm256_castsi256_pd(conv));
+  return VectorRegister<float, 256>(_mm256_castsi256_ps(conv));
 }
 
 inline VectorRegister<double, 256> sqrt(VectorRegister<double, 256> const &a)
@@ -449,6 +455,27 @@ inline float first_element(VectorRegister<float, 256> const &x)
   return _mm256_cvtss_f32(x.data());
 }
 
+inline VectorRegister<double, 256> shift_elements_left(VectorRegister<double, 256> const &x)
+{
+  __m256d t0 = _mm256_permute_pd(x.data(), 0x5);      // [x2  x3  x0  x1]
+  __m256d t1 = _mm256_permute2f128_pd(t0, t0, 0x08);  // [x0  x1   0   0]
+  return VectorRegister<double, 256>(
+      _mm256_blend_pd(t0, t1, 0x5));  // [x2  x1  x0   0]
+}
+
+inline VectorRegister<double, 256> shift_elements_right(VectorRegister<double, 256> const &x)
+{
+  __m256d t0 = _mm256_permute_pd(x.data(), 0x5);      // [x2  x3  x0  x1]
+  __m256d t1 = _mm256_permute2f128_pd(t0, t0, 0x81);  // [ 0   0  x2  x3]
+  return VectorRegister<double, 256>(
+      _mm256_blend_pd(t0, t1, 0xA));  // [ 0  x3  x2  x1]
+}
+
+inline double first_element(VectorRegister<double, 256> const &x)
+{
+  return _mm256_cvtsd_f64(x.data());
+}
+
 }  // namespace vectorize
 }  // namespace fetch
 #endif
@@ -0,0 +1,610 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#ifdef __AVX512F__
+#include "vectorise/info.hpp"
+#include "vectorise/info_avx512.hpp"
+#include "vectorise/register.hpp"
+#include "vectorise/sse.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include <limits>
+
+namespace fetch {
+namespace vectorize {
+
+// AVX-512 integers
+template <typename T>
+class VectorRegister<T, 512>
+{
+public:
+  using type             = T;
+  using mm_register_type = __m512i;
+
+  enum
+  {
+    E_VECTOR_SIZE   = 512,
+    E_REGISTER_SIZE = sizeof(mm_register_type),
+    E_BLOCK_COUNT   = E_REGISTER_SIZE / sizeof(type)
+  };
+
+  static_assert((E_BLOCK_COUNT * sizeof(type)) == E_REGISTER_SIZE,
+                "type cannot be contained in the given register size.");
+
+  VectorRegister() = default;
+  VectorRegister(type const *d)
+  {
+    data_ = _mm512_load_si512(d);
+  }
+  VectorRegister(type const &c)
+  {
+    alignas(64) type constant[E_BLOCK_COUNT];
+    details::UnrollSet<type, E_BLOCK_COUNT>::Set(constant, c);
+    data_ = _mm512_load_si512(constant);
+  }
+  VectorRegister(mm_register_type const &d)
+    : data_(d)
+  {}
+  VectorRegister(mm_register_type &&d)
+    : data_(d)
+  {}
+
+  explicit operator mm_register_type()
+  {
+    return data_;
+  }
+
+  void Store(type *ptr) const
+  {
+    _mm512_store_si512(ptr, data_);
+  }
+  void Stream(type *ptr) const
+  {
+    _mm512_stream_si512(reinterpret_cast<mm_register_type *>(ptr), data_);
+  }
+
+  mm_register_type const &data() const
+  {
+    return data_;
+  }
+  mm_register_type &data()
+  {
+    return data_;
+  }
+
+private:
+  mm_register_type data_;
+};
+
+template <>
+class VectorRegister<float, 512>
+{
+public:
+  using type             = float;
+  using mm_register_type = __m512;
+
+  enum
+  {
+    E_VECTOR_SIZE   = 512,
+    E_REGISTER_SIZE = sizeof(mm_register_type),
+    E_BLOCK_COUNT   = E_REGISTER_SIZE / sizeof(type)
+  };
+
+  static_assert((E_BLOCK_COUNT * sizeof(type)) == E_REGISTER_SIZE,
+                "type cannot be contained in the given register size.");
+
+  VectorRegister() = default;
+  VectorRegister(type const *d)
+  {
+    data_ = _mm512_load_ps(d);
+  }
+  VectorRegister(mm_register_type const &d)
+    : data_(d)
+  {}
+  VectorRegister(mm_register_type &&d)
+    : data_(d)
+  {}
+  VectorRegister(type const &c)
+  {
+    data_ = _mm512_set1_ps(c);
+  }
+
+  explicit operator mm_register_type()
+  {
+    return data_;
+  }
+
+  void Store(type *ptr) const
+  {
+    _mm512_store_ps(ptr, data_);
+  }
+  void Stream(type *ptr) const
+  {
+    _mm512_stream_ps(ptr, data_);
+  }
+
+  mm_register_type const &data() const
+  {
+    return data_;
+  }
+  mm_register_type &data()
+  {
+    return data_;
+  }
+
+private:
+  mm_register_type data_;
+};
+
+template <>
+class VectorRegister<double, 512>
+{
+public:
+  using type             = double;
+  using mm_register_type = __m512d;
+
+  enum
+  {
+    E_VECTOR_SIZE   = 512,
+    E_REGISTER_SIZE = sizeof(mm_register_type),
+    E_BLOCK_COUNT   = E_REGISTER_SIZE / sizeof(type)
+  };
+
+  static_assert((E_BLOCK_COUNT * sizeof(type)) == E_REGISTER_SIZE,
+                "type cannot be contained in the given register size.");
+
+  VectorRegister() = default;
+  VectorRegister(type const *d)
+  {
+    data_ = _mm512_load_pd(d);
+  }
+  VectorRegister(mm_register_type const &d)
+    : data_(d)
+  {}
+  VectorRegister(mm_register_type &&d)
+    : data_(d)
+  {}
+  VectorRegister(type const &c)
+  {
+    data_ = _mm512_set1_pd(c);
+  }
+
+  explicit operator mm_register_type()
+  {
+    return data_;
+  }
+
+  void Store(type *ptr) const
+  {
+    _mm512_store_pd(ptr, data_);
+  }
+  void Stream(type *ptr) const
+  {
+    _mm512_stream_pd(ptr, data_);
+  }
+
+  mm_register_type const &data() const
+  {
+    return data_;
+  }
+  mm_register_type &data()
+  {
+    return data_;
+  }
+
+private:
+  mm_register_type data_;
+};
+
+#define FETCH_ADD_OPERATOR(zero, type, fnc)                                      \
+  inline VectorRegister<type, 512> operator-(VectorRegister<type, 512> const &x) \
+  {                                                                              \
+    return VectorRegister<type, 512>(fnc(zero(), x.data()));                     \
+  }
+
+FETCH_ADD_OPERATOR(_mm512_setzero_si512, int32_t, _mm512_sub_epi32)
+FETCH_ADD_OPERATOR(_mm512_setzero_ps, float, _mm512_sub_ps)
+FETCH_ADD_OPERATOR(_mm512_setzero_pd, double, _mm512_sub_pd)
+#undef FETCH_ADD_OPERATOR
+
+#define FETCH_ADD_OPERATOR(op, type, fnc)                                          \
+  inline VectorRegister<type, 512> operator op(VectorRegister<type, 512> const &a, \
+                                               VectorRegister<type, 512> const &b) \
+  {                                                                                \
+    VectorRegister<type, 512>::mm_register_type ret = fnc(a.data(), b.data());     \
+    return VectorRegister<type, 512>(ret);                                         \
+  }
+
+FETCH_ADD_OPERATOR(+, int32_t, _mm512_add_epi32)
+FETCH_ADD_OPERATOR(-, int32_t, _mm512_sub_epi32)
+FETCH_ADD_OPERATOR(*, int32_t, _mm512_mullo_epi32)
+
+FETCH_ADD_OPERATOR(+, uint32_t, _mm512_add_epi32)
+FETCH_ADD_OPERATOR(-, uint32_t, _mm512_sub_epi32)
+FETCH_ADD_OPERATOR(*, uint32_t, _mm512_mullo_epi32)
+
+FETCH_ADD_OPERATOR(*, float, _mm512_mul_ps)
+FETCH_ADD_OPERATOR(-, float, _mm512_sub_ps)
+FETCH_ADD_OPERATOR(/, float, _mm512_div_ps)
+FETCH_ADD_OPERATOR(+, float, _mm512_add_ps)
+
+FETCH_ADD_OPERATOR(*, double, _mm512_mul_pd)
+FETCH_ADD_OPERATOR(-, double, _mm512_sub_pd)
+FETCH_ADD_OPERATOR(/, double, _mm512_div_pd)
+FETCH_ADD_OPERATOR(+, double, _mm512_add_pd)
+
+#undef FETCH_ADD_OPERATOR
+
+// there is no integer division instruction, divide element wise (by zero yields zero)
+#define FETCH_ADD_OPERATOR(type)                                                 \
+  inline VectorRegister<type, 512> operator/(VectorRegister<type, 512> const &a, \
+                                             VectorRegister<type, 512> const &b) \
+  {                                                                              \
+    constexpr std::size_t N = VectorRegister<type, 512>::E_BLOCK_COUNT;          \
+    alignas(64) type      d1[N];                                                 \
+    alignas(64) type      d2[N];                                                 \
+    alignas(64) type      ret[N];                                                \
+    a.Store(d1);                                                                 \
+    b.Store(d2);                                                                 \
+    for (std::size_t i = 0; i < N; ++i)                                          \
+    {                                                                            \
+      ret[i] = d2[i] != 0 ? type(d1[i] / d2[i]) : type(0);                       \
+    }                                                                            \
+    return VectorRegister<type, 512>(ret);                                       \
+  }
+
+FETCH_ADD_OPERATOR(int32_t)
+FETCH_ADD_OPERATOR(uint32_t)
+
+#undef FETCH_ADD_OPERATOR
+
+// integer comparisons set all the bits of the matching elements, as for SSE
+#define FETCH_ADD_OPERATOR(op, type, fnc)                                                  \
+  inline VectorRegister<type, 512> operator op(VectorRegister<type, 512> const &a,         \
+                                               VectorRegister<type, 512> const &b)         \
+  {                                                                                        \
+    __mmask16 const mask = fnc(a.data(), b.data());                                        \
+    return VectorRegister<type, 512>(_mm512_maskz_mov_epi32(mask, _mm512_set1_epi32(-1))); \
+  }
+
+FETCH_ADD_OPERATOR(==, int32_t, _mm512_cmpeq_epi32_mask)
+FETCH_ADD_OPERATOR(<, int32_t, _mm512_cmplt_epi32_mask)
+
+#undef FETCH_ADD_OPERATOR
+
+// floating point comparisons set the matching elements to one, as for SSE
+#define FETCH_ADD_OPERATOR(op, type, mask_type, suffix, fnc)                       \
+  inline VectorRegister<type, 512> operator op(VectorRegister<type, 512> const &a, \
+                                               VectorRegister<type, 512> const &b) \
+  {                                                                                \
+    mask_type const mask = _mm512_cmp_##suffix##_mask(a.data(), b.data(), fnc);    \
+    return VectorRegister<type, 512>(                                              \
+        _mm512_maskz_mov_##suffix(mask, _mm512_set1_##suffix(type(1))));           \
+  }
+
+FETCH_ADD_OPERATOR(==, float, __mmask16, ps, _CMP_EQ_OQ)
+FETCH_ADD_OPERATOR(!=, float, __mmask16, ps, _CMP_NEQ_OQ)
+FETCH_ADD_OPERATOR(>=, float, __mmask16, ps, _CMP_GE_OQ)
+FETCH_ADD_OPERATOR(>, float, __mmask16, ps, _CMP_GT_OQ)
+FETCH_ADD_OPERATOR(<=, float, __mmask16, ps, _CMP_LE_OQ)
+FETCH_ADD_OPERATOR(<, float, __mmask16, ps, _CMP_LT_OQ)
+
+FETCH_ADD_OPERATOR(==, double, __mmask8, pd, _CMP_EQ_OQ)
+FETCH_ADD_OPERATOR(!=, double, __mmask8, pd, _CMP_NEQ_OQ)
+FETCH_ADD_OPERATOR(>=, double, __mmask8, pd, _CMP_GE_OQ)
+FETCH_ADD_OPERATOR(>, double, __mmask8, pd, _CMP_GT_OQ)
+FETCH_ADD_OPERATOR(<=, double, __mmask8, pd, _CMP_LE_OQ)
+FETCH_ADD_OPERATOR(<, double, __mmask8, pd, _CMP_LT_OQ)
+
+#undef FETCH_ADD_OPERATOR
+
+// FREE FUNCTIONS
+inline VectorRegister<float, 512> max(VectorRegister<float, 512> const &a,
+                                      VectorRegister<float, 512> const &b)
+{
+  return VectorRegister<float, 512>(_mm512_max_ps(a.data(), b.data()));
+}
+
+inline VectorRegister<float, 512> min(VectorRegister<float, 512> const &a,
+                                      VectorRegister<float, 512> const &b)
+{
+  return VectorRegister<float, 512>(_mm512_min_ps(a.data(), b.data()));
+}
+
+inline VectorRegister<float, 512> sqrt(VectorRegister<float, 512> const &a)
+{
+  return VectorRegister<float, 512>(_mm512_sqrt_ps(a.data()));
+}
+
+inline VectorRegister<float, 512> abs(VectorRegister<float, 512> const &a)
+{
+  __m512i const mask = _mm512_set1_epi32(0x7FFFFFFF);
+  return VectorRegister<float, 512>(
+      _mm512_castsi512_ps(_mm512_and_si512(mask, _mm512_castps_si512(a.data()))));
+}
+
+inline VectorRegister<float, 512> approx_exp(VectorRegister<float, 512> const &x)
+{
+  enum
+  {
+    mantissa = 23,
+    exponent = 8,
+  };
+
+  constexpr float                  multiplier      = float(1ull << mantissa);
+  constexpr float                  exponent_offset = (float(((1ull << (exponent - 1)) - 1)));
+  const VectorRegister<float, 512> a(float(multiplier / M_LN2));
+  const VectorRegister<float, 512> b(float(exponent_offset * multiplier - 60801));
+
+  VectorRegister<float, 512> y    = a * x + b;
+  __m512i                    conv = _mm512_cvtps_epi32(y.data());
+
+  return VectorRegister<float, 512>(_mm512_castsi512_ps(conv));
+}
+
+inline VectorRegister<float, 512> approx_log(VectorRegister<float, 512> const &x)
+{
+  enum
+  {
+    mantissa = 23,
+    exponent = 8,
+  };
+
+  constexpr float                  multiplier      = float(1ull << mantissa);
+  constexpr float                  exponent_offset = (float(((1ull << (exponent - 1)) - 1)));
+  const VectorRegister<float, 512> a(float(M_LN2 / multiplier));
+  const VectorRegister<float, 512> b(float(exponent_offset * multiplier - 60801));
+
+  __m512i conv = _mm512_castps_si512(x.data());
+
+  VectorRegister<float, 512> y(_mm512_cvtepi32_ps(conv));
+
+  return a * (y - b);
+}
+
+inline VectorRegister<float, 512> approx_reciprocal(VectorRegister<float, 512> const &x)
+{
+  return VectorRegister<float, 512>(_mm512_rcp14_ps(x.data()));
+}
+
+inline VectorRegister<double, 512> max(VectorRegister<double, 512> const &a,
+                                       VectorRegister<double, 512> const &b)
+{
+  return VectorRegister<double, 512>(_mm512_max_pd(a.data(), b.data()));
+}
+
+inline VectorRegister<double, 512> min(VectorRegister<double, 512> const &a,
+                                       VectorRegister<double, 512> const &b)
+{
+  return VectorRegister<double, 512>(_mm512_min_pd(a.data(), b.data()));
+}
+
+inline VectorRegister<double, 512> sqrt(VectorRegister<double, 512> const &a)
+{
+  return VectorRegister<double, 512>(_mm512_sqrt_pd(a.data()));
+}
+
+inline VectorRegister<double, 512> abs(VectorRegister<double, 512> const &a)
+{
+  __m512i const mask = _mm512_set1_epi64(std::numeric_limits<int64_t>::max());
+  return VectorRegister<double, 512>(
+      _mm512_castsi512_pd(_mm512_and_si512(mask, _mm512_castpd_si512(a.data()))));
+}
+
+inline VectorRegister<double, 512> approx_exp(VectorRegister<double, 512> const &x)
+{
+  enum
+  {
+    mantissa = 20,
+    exponent = 11,
+  };
+
+  constexpr double                  multiplier      = double(1ull << mantissa);
+  constexpr double                  exponent_offset = (double(((1ull << (exponent - 1)) - 1)));
+  const VectorRegister<double, 512> a(double(multiplier / M_LN2));
+  const VectorRegister<double, 512> b(double(exponent_offset * multiplier - 60801));
+
+  VectorRegister<double, 512> y = a * x + b;
+
+  // the integer forms the upper 32 bits of each element, leaving the lower bits of the mantissa
+  __m512i conv = _mm512_cvtepi32_epi64(_mm512_cvtpd_epi32(y.data()));
+  conv         = _mm512_slli_epi64(conv, 32);
+
+  return VectorRegister<double, 512>(_mm512_castsi512_pd(conv));
+}
+
+inline VectorRegister<double, 512> approx_log(VectorRegister<double, 512> const &x)
+{
+  enum
+  {
+    mantissa = 20,
+    exponent = 11,
+  };
+
+  constexpr double                  multiplier      = double(1ull << mantissa);
+  constexpr double                  exponent_offset = (double(((1ull << (exponent - 1)) - 1)));
+  const VectorRegister<double, 512> a(double(M_LN2 / multiplier));
+  const VectorRegister<double, 512> b(double(exponent_offset * multiplier - 60801));
+
+  // only the upper 32 bits of each element are considered
+  __m512i conv = _mm512_srai_epi64(_mm512_castpd_si512(x.data()), 32);
+
+  VectorRegister<double, 512> y(_mm512_cvtepi32_pd(_mm512_cvtepi64_epi32(conv)));
+
+  return a * (y - b);
+}
+
+inline VectorRegister<double, 512> approx_reciprocal(VectorRegister<double, 512> const &x)
+{
+  return VectorRegister<double, 512>(_mm512_rcp14_pd(x.data()));
+}
+
+namespace details {
+
+/// The mask selecting the elements with an index of at least n
+template <typename M, std::size_t N>
+M MaskFromElement(int n)
+{
+  if (n <= 0)
+  {
+    return M((1ull << N) - 1);
+  }
+
+  if (n >= int(N))
+  {
+    return M(0);
+  }
+
+  return M(((1ull << N) - 1) & ~((1ull << n) - 1));
+}
+
+}  // namespace details
+
+inline VectorRegister<double, 512> vector_zero_below_element(VectorRegister<double, 512> const &a,
+                                                             int const &                        n)
+{
+  __mmask8 const mask = details::MaskFromElement<__mmask8, 8>(n);
+  return VectorRegister<double, 512>(_mm512_maskz_mov_pd(mask, a.data()));
+}
+
+inline VectorRegister<double, 512> vector_zero_above_element(VectorRegister<double, 512> const &a,
+                                                             int const &                        n)
+{
+  __mmask8 const mask = __mmask8(~details::MaskFromElement<__mmask8, 8>(n + 1));
+  return VectorRegister<double, 512>(_mm512_maskz_mov_pd(mask, a.data()));
+}
+
+inline VectorRegister<double, 512> shift_elements_left(VectorRegister<double, 512> const &x)
+{
+  __m512i n = _mm512_alignr_epi64(_mm512_castpd_si512(x.data()), _mm512_setzero_si512(), 7);
+  return VectorRegister<double, 512>(_mm512_castsi512_pd(n));
+}
+
+inline VectorRegister<double, 512> shift_elements_right(VectorRegister<double, 512> const &x)
+{
+  __m512i n = _mm512_alignr_epi64(_mm512_setzero_si512(), _mm512_castpd_si512(x.data()), 1);
+  return VectorRegister<double, 512>(_mm512_castsi512_pd(n));
+}
+
+inline double first_element(VectorRegister<double, 512> const &x)
+{
+  return _mm_cvtsd_f64(_mm512_castpd512_pd128(x.data()));
+}
+
+// Floats
+inline VectorRegister<float, 512> vector_zero_below_element(VectorRegister<float, 512> const &a,
+                                                            int const &                       n)
+{
+  __mmask16 const mask = details::MaskFromElement<__mmask16, 16>(n);
+  return VectorRegister<float, 512>(_mm512_maskz_mov_ps(mask, a.data()));
+}
+
+inline VectorRegister<float, 512> vector_zero_above_element(VectorRegister<float, 512> const &a,
+                                                            int const &                       n)
+{
+  __mmask16 const mask = __mmask16(~details::MaskFromElement<__mmask16, 16>(n + 1));
+  return VectorRegister<float, 512>(_mm512_maskz_mov_ps(mask, a.data()));
+}
+
+inline VectorRegister<float, 512> shift_elements_left(VectorRegister<float, 512> const &x)
+{
+  __m512i n = _mm512_alignr_epi32(_mm512_castps_si512(x.data()), _mm512_setzero_si512(), 15);
+  return VectorRegister<float, 512>(_mm512_castsi512_ps(n));
+}
+
+inline VectorRegister<float, 512> shift_elements_right(VectorRegister<float, 512> const &x)
+{
+  __m512i n = _mm512_alignr_epi32(_mm512_setzero_si512(), _mm512_castps_si512(x.data()), 1);
+  return VectorRegister<float, 512>(_mm512_castsi512_ps(n));
+}
+
+inline float first_element(VectorRegister<float, 512> const &x)
+{
+  return _mm_cvtss_f32(_mm512_castps512_ps128(x.data()));
+}
+
+// Integers
+inline uint32_t first_element(VectorRegister<uint32_t, 512> const &x)
+{
+  return static_cast<uint32_t>(_mm_cvtsi128_si32(_mm512_castsi512_si128(x.data())));
+}
+
+inline VectorRegister<uint32_t, 512> shift_elements_left(VectorRegister<uint32_t, 512> const &x)
+{
+  return VectorRegister<uint32_t, 512>(_mm512_alignr_epi32(x.data(), _mm512_setzero_si512(), 15));
+}
+
+inline VectorRegister<uint32_t, 512> shift_elements_right(VectorRegister<uint32_t, 512> const &x)
+{
+  return VectorRegister<uint32_t, 512>(_mm512_alignr_epi32(_mm512_setzero_si512(), x.data(), 1));
+}
+
+inline int32_t first_element(VectorRegister<int32_t, 512> const &x)
+{
+  return static_cast<int32_t>(_mm_cvtsi128_si32(_mm512_castsi512_si128(x.data())));
+}
+
+inline VectorRegister<int32_t, 512> shift_elements_left(VectorRegister<int32_t, 512> const &x)
+{
+  return VectorRegister<int32_t, 512>(_mm512_alignr_epi32(x.data(), _mm512_setzero_si512(), 15));
+}
+
+inline VectorRegister<int32_t, 512> shift_elements_right(VectorRegister<int32_t, 512> const &x)
+{
+  return VectorRegister<int32_t, 512>(_mm512_alignr_epi32(_mm512_setzero_si512(), x.data(), 1));
+}
+
+inline double reduce(VectorRegister<double, 512> const &x)
+{
+  return _mm512_reduce_add_pd(x.data());
+}
+
+inline float reduce(VectorRegister<float, 512> const &x)
+{
+  return _mm512_reduce_add_ps(x.data());
+}
+
+inline bool all_less_than(VectorRegister<double, 512> const &x,
+                          VectorRegister<double, 512> const &y)
+{
+  return _mm512_cmp_pd_mask(x.data(), y.data(), _CMP_LT_OQ) == 0xFF;
+}
+
+inline bool any_less_than(VectorRegister<double, 512> const &x,
+                          VectorRegister<double, 512> const &y)
+{
+  return _mm512_cmp_pd_mask(x.data(), y.data(), _CMP_LT_OQ) != 0;
+}
+
+inline bool all_less_than(VectorRegister<float, 512> const &x, VectorRegister<float, 512> const &y)
+{
+  return _mm512_cmp_ps_mask(x.data(), y.data(), _CMP_LT_OQ) == 0xFFFF;
+}
+
+inline bool any_less_than(VectorRegister<float, 512> const &x, VectorRegister<float, 512> const &y)
+{
+  return _mm512_cmp_ps_mask(x.data(), y.data(), _CMP_LT_OQ) != 0;
+}
+
+}  // namespace vectorize
+}  // namespace fetch
+#endif
@@ -20,6 +20,10 @@
 #include <cstddef>
 #include <cstdint>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
 namespace fetch {
 namespace vectorize {
 
@@ -29,5 +33,117 @@ struct VectorInfo
   using naitve_type   = T;
   using register_type = T;
 };
+
+/**
+ * The instruction set extensions supported by the CPU the process is running on
+ *
+ * Unlike the compile time checks in platform.hpp, these are determined at runtime so that code
+ * paths requiring newer extensions can be selected without raising the build target architecture.
+ */
+struct CpuFeatures
+{
+  bool sse2{false};
+  bool ssse3{false};
+  bool sse42{false};
+  bool avx{false};
+  bool avx2{false};
+  bool avx512f{false};   ///< AVX-512 Foundation
+  bool avx512dq{false};  ///< AVX-512 Doubleword and Quadword Instructions
+  bool sha{false};       ///< SHA Extensions (SHA-NI)
+  bool neon{false};      ///< ARM Advanced SIMD
+};
+
+namespace details {
+
+inline CpuFeatures DetectCpuFeatures()
+{
+  CpuFeatures features{};
+
+#if defined(__x86_64__) || defined(__i386__)
+  uint32_t eax{0}, ebx{0}, ecx{0}, edx{0};
+  uint32_t xcr0{0};
+
+  if (__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+  {
+    features.sse2  = (edx & (1u << 26u)) != 0;
+    features.ssse3 = (ecx & (1u << 9u)) != 0;
+    features.sse42 = (ecx & (1u << 20u)) != 0;
+
+    // the AVX registers are only usable if the OS saves them on a context switch
+    bool const osxsave = (ecx & (1u << 27u)) != 0;
+    bool const avx     = (ecx & (1u << 28u)) != 0;
+
+    if (osxsave && avx)
+    {
+      uint32_t xcr0_lo{0}, xcr0_hi{0};
+      __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+
+      xcr0         = xcr0_lo;
+      features.avx = (xcr0 & 0x6u) == 0x6u;
+    }
+  }
+
+  if (__get_cpuid_max(0, nullptr) >= 7)
+  {
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+    features.avx2 = features.avx && ((ebx & (1u << 5u)) != 0);
+    features.sha  = (ebx & (1u << 29u)) != 0;
+
+    // in addition to the AVX state the OS must also save the opmask and upper ZMM registers
+    bool const avx512_state = (xcr0 & 0xE6u) == 0xE6u;
+
+    features.avx512f  = avx512_state && ((ebx & (1u << 16u)) != 0);
+    features.avx512dq = features.avx512f && ((ebx & (1u << 17u)) != 0);
+  }
+#elif defined(__aarch64__)
+  // Advanced SIMD is a mandatory part of ARMv8-A
+  features.neon = true;
+#endif
+
+  return features;
+}
+
+}  // namespace details
+
+/**
+ * Get the (cached) set of features supported by the current CPU
+ *
+ * @return The CPU features
+ */
+inline CpuFeatures const &GetCpuFeatures()
+{
+  static CpuFeatures const features = details::DetectCpuFeatures();
+  return features;
+}
+
+/**
+ * Get the width of the widest vector registers supported by the current CPU, which can be compared
+ * against platform::VectorRegisterSize to determine whether a build makes full use of the machine
+ *
+ * @return The register width in bits
+ */
+inline std::size_t GetNativeVectorSize()
+{
+  CpuFeatures const &features = GetCpuFeatures();
+
+  if (features.avx512f)
+  {
+    return 512;
+  }
+
+  if (features.avx)
+  {
+    return 256;
+  }
+
+  if (features.sse2 || features.neon)
+  {
+    return 128;
+  }
+
+  return 8 * sizeof(void *);
+}
+
 }  // namespace vectorize
 }  // namespace fetch
@@ -17,6 +17,7 @@
 //
 //------------------------------------------------------------------------------
 
+#ifdef __SSE__
 #include <cstddef>
 #include <cstdint>
 #include <emmintrin.h>
@@ -76,3 +77,4 @@ struct VectorInfo<double, 128>
 };
 }  // namespace vectorize
 }  // namespace fetch
+#endif
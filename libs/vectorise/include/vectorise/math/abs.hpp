@@ -17,6 +17,7 @@
 //
 //------------------------------------------------------------------------------
 
+#ifdef __SSE__
 #include "vectorise/sse.hpp"
 
 #include <emmintrin.h>
@@ -39,3 +40,4 @@ inline VectorRegister<double, 128> abs(VectorRegister<double, 128> const &a)
 
 }  // namespace vectorize
 }  // namespace fetch
+#endif
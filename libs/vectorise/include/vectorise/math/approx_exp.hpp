@@ -17,6 +17,8 @@
 //
 //------------------------------------------------------------------------------
 
+#ifdef __SSE__
+
 namespace fetch {
 namespace vectorize {
 
@@ -64,3 +66,4 @@ inline VectorRegister<double, 128> approx_exp(VectorRegister<double, 128> const
 
 }  // namespace vectorize
 }  // namespace fetch
+#endif
@@ -17,6 +17,8 @@
 //
 //------------------------------------------------------------------------------
 
+#ifdef __SSE__
+
 namespace fetch {
 namespace vectorize {
 
@@ -65,3 +67,4 @@ inline VectorRegister<double, 128> approx_log(VectorRegister<double, 128> const
 
 }  // namespace vectorize
 }  // namespace fetch
+#endif
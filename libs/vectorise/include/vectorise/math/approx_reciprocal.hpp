@@ -17,6 +17,8 @@
 //
 //------------------------------------------------------------------------------
 
+#ifdef __SSE__
+
 namespace fetch {
 namespace vectorize {
 
@@ -34,3 +36,4 @@ inline VectorRegister<double, 128> approx_reciprocal(VectorRegister<double, 128>
 
 }  // namespace vectorize
 }  // namespace fetch
+#endif
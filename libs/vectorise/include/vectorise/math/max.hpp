@@ -17,6 +17,8 @@
 //
 //------------------------------------------------------------------------------
 
+#ifdef __SSE__
+
 namespace fetch {
 namespace vectorize {
 
@@ -34,3 +36,4 @@ inline VectorRegister<double, 128> max(VectorRegister<double, 128> const &a,
 
 }  // namespace vectorize
 }  // namespace fetch
+#endif
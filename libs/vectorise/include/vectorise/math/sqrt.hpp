@@ -17,6 +17,8 @@
 //
 //------------------------------------------------------------------------------
 
+#ifdef __SSE__
+
 namespace fetch {
 namespace vectorize {
 
@@ -32,3 +34,4 @@ inline VectorRegister<double, 128> sqrt(VectorRegister<double, 128> const &a)
 
 }  // namespace vectorize
 }  // namespace fetch
+#endif
@@ -0,0 +1,382 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "vectorise/register.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace fetch {
+namespace vectorize {
+
+/**
+ * The accuracy of the polynomial exponential and logarithm, each step roughly doubling the cost
+ */
+enum class Accuracy : uint8_t
+{
+  APPROXIMATE,  ///< relative error below 1e-3
+  FAST,         ///< relative error below 1e-5
+  PRECISE       ///< within a few ulp of the standard library
+};
+
+namespace details {
+
+// 1 / k!, the coefficients of the Taylor series of e^r
+static constexpr double EXP_COEFFICIENTS[14] = {
+    1.0,
+    1.0,
+    0.5,
+    0.16666666666666666,
+    0.041666666666666664,
+    0.008333333333333333,
+    0.001388888888888889,
+    0.0001984126984126984,
+    2.48015873015873e-05,
+    2.7557319223985893e-06,
+    2.755731922398589e-07,
+    2.505210838544172e-08,
+    2.08767569878681e-09,
+    1.6059043836821613e-10};
+
+// 1 / (2k + 1), the coefficients of the series of ln((1 + s) / (1 - s)) / 2s in s^2
+static constexpr double LOG_COEFFICIENTS[10] = {
+    1.0,
+    0.3333333333333333,
+    0.2,
+    0.14285714285714285,
+    0.1111111111111111,
+    0.09090909090909091,
+    0.07692307692307693,
+    0.06666666666666667,
+    0.058823529411764705,
+    0.05263157894736842};
+
+template <typename T>
+struct TranscendentalTraits;
+
+template <>
+struct TranscendentalTraits<float>
+{
+  using Bits       = uint32_t;
+  using SignedBits = int32_t;
+
+  static constexpr int  MANTISSA_BITS   = 23;
+  static constexpr int  EXPONENT_BIAS   = 127;
+  static constexpr Bits ONE_BITS        = 0x3f800000u;
+  static constexpr Bits SQRT_HALF_BITS  = 0x3f3504f3u;
+  static constexpr Bits MANTISSA_MASK   = 0x007fffffu;
+  static constexpr Bits INFINITY_BITS   = 0x7f800000u;
+  static constexpr Bits NAN_BITS        = 0x7fc00000u;
+  static constexpr int  PRECISE_DEGREE  = 7;  ///< of the exponential polynomial
+  static constexpr int  PRECISE_TERMS   = 4;  ///< of the logarithm series
+  static constexpr int  SUBNORMAL_SCALE = 25;
+
+  static constexpr float LOG2E  = 1.44269504088896341f;
+  static constexpr float LN2_HI = 6.93145751953125e-01f;
+  static constexpr float LN2_LO = 1.42860682030941723212e-06f;
+
+  // 1.5 * 2^23, adding it rounds to an integer which is then held in the low bits of the mantissa
+  static constexpr float SHIFTER = 12582912.0f;
+
+  // beyond these the result is zero or infinite, the clamp only keeps the exponent in range
+  static constexpr float EXP_LOWER = -104.0f;
+  static constexpr float EXP_UPPER = 89.0f;
+};
+
+template <>
+struct TranscendentalTraits<double>
+{
+  using Bits       = uint64_t;
+  using SignedBits = int64_t;
+
+  static constexpr int  MANTISSA_BITS   = 52;
+  static constexpr int  EXPONENT_BIAS   = 1023;
+  static constexpr Bits ONE_BITS        = 0x3ff0000000000000ull;
+  static constexpr Bits SQRT_HALF_BITS  = 0x3fe6a09e667f3bcdull;
+  static constexpr Bits MANTISSA_MASK   = 0x000fffffffffffffull;
+  static constexpr Bits INFINITY_BITS   = 0x7ff0000000000000ull;
+  static constexpr Bits NAN_BITS        = 0x7ff8000000000000ull;
+  static constexpr int  PRECISE_DEGREE  = 13;
+  static constexpr int  PRECISE_TERMS   = 10;
+  static constexpr int  SUBNORMAL_SCALE = 54;
+
+  static constexpr double LOG2E  = 1.44269504088896338700e+00;
+  static constexpr double LN2_HI = 6.93147180369123816490e-01;
+  static constexpr double LN2_LO = 1.90821492927058770002e-10;
+
+  static constexpr double SHIFTER = 6755399441055744.0;
+
+  static constexpr double EXP_LOWER = -746.0;
+  static constexpr double EXP_UPPER = 710.0;
+};
+
+/**
+ * The degree of the polynomial approximating e^r for |r| <= ln(2) / 2
+ */
+template <Accuracy A, typename T>
+constexpr int ExpDegree()
+{
+  return (A == Accuracy::APPROXIMATE) ? 3
+                                      : ((A == Accuracy::FAST)
+                                             ? 5
+                                             : TranscendentalTraits<T>::PRECISE_DEGREE);
+}
+
+/**
+ * The number of terms of the series approximating ln((1 + s) / (1 - s)) for |s| <= 0.172
+ */
+template <Accuracy A, typename T>
+constexpr int LogTerms()
+{
+  return (A == Accuracy::APPROXIMATE) ? 2
+                                      : ((A == Accuracy::FAST)
+                                             ? 3
+                                             : TranscendentalTraits<T>::PRECISE_TERMS);
+}
+
+template <typename T>
+inline T BitsToValue(typename TranscendentalTraits<T>::Bits bits)
+{
+  T value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+template <typename T>
+inline typename TranscendentalTraits<T>::Bits ValueToBits(T value)
+{
+  typename TranscendentalTraits<T>::Bits bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+/**
+ * An all ones mask if the condition holds, otherwise zero
+ */
+template <typename T>
+inline typename TranscendentalTraits<T>::Bits Mask(bool condition)
+{
+  using Bits = typename TranscendentalTraits<T>::Bits;
+
+  return static_cast<Bits>(0) - static_cast<Bits>(condition);
+}
+
+/**
+ * Select between the bits of two values with a mask. Ternaries on floating point values would be
+ * turned into branches by the compiler, which stops the loops over the lanes from vectorising.
+ */
+template <typename T>
+inline typename TranscendentalTraits<T>::Bits Select(typename TranscendentalTraits<T>::Bits mask,
+                                                     typename TranscendentalTraits<T>::Bits a,
+                                                     typename TranscendentalTraits<T>::Bits b)
+{
+  return (mask & a) | (~mask & b);
+}
+
+/**
+ * 2^n for the normal range of exponents
+ */
+template <typename T>
+inline T Power2(int32_t n)
+{
+  using Traits = TranscendentalTraits<T>;
+  using Bits   = typename Traits::Bits;
+
+  return BitsToValue<T>(static_cast<Bits>(n + Traits::EXPONENT_BIAS) << Traits::MANTISSA_BITS);
+}
+
+/**
+ * e^x, computed as 2^n * e^r with r = x - n ln(2). The code is free of branches so that loops over
+ * it vectorise.
+ */
+template <Accuracy A, typename T>
+inline T Exp(T x)
+{
+  using Traits     = TranscendentalTraits<T>;
+  using Bits       = typename Traits::Bits;
+  using SignedBits = typename Traits::SignedBits;
+
+  constexpr int DEGREE = ExpDegree<A, T>();
+
+  // n = round(x / ln(2)), read from the mantissa rather than converted, which would not vectorise.
+  // Outside of the clamped range n is meaningless, but the result is replaced below.
+  T const       shifted = (x * Traits::LOG2E) + Traits::SHIFTER;
+  T const       fn      = shifted - Traits::SHIFTER;
+  int32_t const n       = static_cast<int32_t>(
+      static_cast<SignedBits>(ValueToBits(shifted) - ValueToBits(Traits::SHIFTER)));
+  T const r = (x - (fn * Traits::LN2_HI)) - (fn * Traits::LN2_LO);
+
+  // the Taylor polynomial, by Horner's rule
+  T p = static_cast<T>(EXP_COEFFICIENTS[DEGREE]);
+  for (int k = DEGREE - 1; k >= 0; --k)
+  {
+    p = (p * r) + static_cast<T>(EXP_COEFFICIENTS[k]);
+  }
+
+  // 2^n is applied in two halves, so that the results which are subnormal or infinite are too
+  int32_t const half   = n / 2;
+  Bits const    result = ValueToBits((p * Power2<T>(half)) * Power2<T>(n - half));
+
+  Bits const bits      = ValueToBits(x);
+  Bits const underflow = Mask<T>(x < Traits::EXP_LOWER);
+  Bits const overflow  = Mask<T>(x > Traits::EXP_UPPER);
+  Bits const nan       = Mask<T>(x != x);
+
+  Bits const special = Select<T>(overflow, Traits::INFINITY_BITS, Select<T>(nan, bits, Bits{0}));
+  return BitsToValue<T>(Select<T>(underflow | overflow | nan, special, result));
+}
+
+/**
+ * ln(x), computed as e ln(2) + ln(m) with x = 2^e m and m in [sqrt(1/2), sqrt(2)). The logarithm
+ * of m is the series 2 (s + s^3/3 + s^5/5 + ...) with s = (m - 1) / (m + 1). Free of branches.
+ */
+template <Accuracy A, typename T>
+inline T Log(T x)
+{
+  using Traits = TranscendentalTraits<T>;
+  using Bits   = typename Traits::Bits;
+
+  constexpr int TERMS = LogTerms<A, T>();
+
+  // subnormal values are scaled into the normal range first
+  T const scale = BitsToValue<T>(static_cast<Bits>(Traits::SUBNORMAL_SCALE + Traits::EXPONENT_BIAS)
+                                 << Traits::MANTISSA_BITS);
+  Bits const    subnormal = Mask<T>(x < std::numeric_limits<T>::min());
+  Bits const    value     = Select<T>(subnormal, ValueToBits(x * scale), ValueToBits(x));
+  int32_t const offset    = static_cast<int32_t>(subnormal & Traits::SUBNORMAL_SCALE);
+
+  // split the value, offsetting the bits so that the mantissa falls in [sqrt(1/2), sqrt(2))
+  Bits const    bits = value + (Traits::ONE_BITS - Traits::SQRT_HALF_BITS);
+  int32_t const e    = static_cast<int32_t>(bits >> Traits::MANTISSA_BITS) - Traits::EXPONENT_BIAS -
+                    offset;
+  T const m = BitsToValue<T>((bits & Traits::MANTISSA_MASK) + Traits::SQRT_HALF_BITS);
+
+  T const f = m - T{1};
+  T const s = f / (T{2} + f);
+  T const z = s * s;
+
+  T q = static_cast<T>(LOG_COEFFICIENTS[TERMS - 1]);
+  for (int k = TERMS - 2; k >= 0; --k)
+  {
+    q = (q * z) + static_cast<T>(LOG_COEFFICIENTS[k]);
+  }
+
+  T const    fe     = static_cast<T>(e);
+  Bits const result =
+      ValueToBits((fe * Traits::LN2_HI) + (((T{2} * s) * q) + (fe * Traits::LN2_LO)));
+
+  // zero gives -infinity, infinity gives itself and negative or NaN values give NaN
+  Bits const zero     = Mask<T>(x == T{0});
+  Bits const infinite = Mask<T>(x == std::numeric_limits<T>::infinity());
+  Bits const invalid  = ~Mask<T>(x >= T{0});
+
+  Bits const special = Select<T>(zero, ValueToBits(-std::numeric_limits<T>::infinity()),
+                                 Select<T>(infinite, Traits::INFINITY_BITS, Traits::NAN_BITS));
+  return BitsToValue<T>(Select<T>(zero | infinite | invalid, special, result));
+}
+
+template <Accuracy A, typename T>
+void ExpLanes(T *values, std::size_t count)
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    values[i] = Exp<A>(values[i]);
+  }
+}
+
+template <Accuracy A, typename T>
+void LogLanes(T *values, std::size_t count)
+{
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    values[i] = Log<A>(values[i]);
+  }
+}
+
+}  // namespace details
+
+/**
+ * e^x evaluated as a polynomial on every element of the register. Unlike approx_exp this is
+ * available for every register and bounded in error, see Accuracy.
+ *
+ * @param x The exponents
+ * @param accuracy The accuracy of the result
+ * @return The exponentials
+ */
+template <typename T, std::size_t S>
+VectorRegister<T, S> polynomial_exp(VectorRegister<T, S> const &x,
+                                    Accuracy                    accuracy = Accuracy::PRECISE)
+{
+  using Register = VectorRegister<T, S>;
+
+  alignas(Register::E_REGISTER_SIZE) T values[Register::E_BLOCK_COUNT];
+  x.Store(values);
+
+  switch (accuracy)
+  {
+  case Accuracy::APPROXIMATE:
+    details::ExpLanes<Accuracy::APPROXIMATE>(values, Register::E_BLOCK_COUNT);
+    break;
+  case Accuracy::FAST:
+    details::ExpLanes<Accuracy::FAST>(values, Register::E_BLOCK_COUNT);
+    break;
+  case Accuracy::PRECISE:
+    details::ExpLanes<Accuracy::PRECISE>(values, Register::E_BLOCK_COUNT);
+    break;
+  }
+
+  return Register(static_cast<T const *>(values));
+}
+
+/**
+ * The natural logarithm evaluated as a series on every element of the register
+ *
+ * @param x The values
+ * @param accuracy The accuracy of the result
+ * @return The logarithms, NaN for negative values and -infinity for zero
+ */
+template <typename T, std::size_t S>
+VectorRegister<T, S> polynomial_log(VectorRegister<T, S> const &x,
+                                    Accuracy                    accuracy = Accuracy::PRECISE)
+{
+  using Register = VectorRegister<T, S>;
+
+  alignas(Register::E_REGISTER_SIZE) T values[Register::E_BLOCK_COUNT];
+  x.Store(values);
+
+  switch (accuracy)
+  {
+  case Accuracy::APPROXIMATE:
+    details::LogLanes<Accuracy::APPROXIMATE>(values, Register::E_BLOCK_COUNT);
+    break;
+  case Accuracy::FAST:
+    details::LogLanes<Accuracy::FAST>(values, Register::E_BLOCK_COUNT);
+    break;
+  case Accuracy::PRECISE:
+    details::LogLanes<Accuracy::PRECISE>(values, Register::E_BLOCK_COUNT);
+    break;
+  }
+
+  return Register(static_cast<T const *>(values));
+}
+
+}  // namespace vectorize
+}  // namespace fetch
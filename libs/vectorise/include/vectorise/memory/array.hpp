@@ -55,7 +55,8 @@ public:
 
     if (n > 0)
     {
-      this->pointer_ = (type *)_mm_malloc(this->padded_size() * sizeof(type), 16);
+      this->pointer_ =
+          (type *)_mm_malloc(this->padded_size() * sizeof(type), super_type::E_SIMD_ALIGNMENT);
     }
   }
 
@@ -99,7 +100,8 @@ public:
 
     if (this->size_ > 0)
     {
-      this->pointer_ = (type *)_mm_malloc(this->padded_size() * sizeof(type), 16);
+      this->pointer_ =
+          (type *)_mm_malloc(this->padded_size() * sizeof(type), super_type::E_SIMD_ALIGNMENT);
     }
 
     for (std::size_t i = 0; i < this->size_; ++i)
@@ -0,0 +1,214 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "vectorise/platform.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mm_malloc.h>
+#include <vector>
+
+namespace fetch {
+namespace memory {
+
+/**
+ * A caching allocator for the aligned blocks of SharedArray. Sizes are rounded up to one of four
+ * size classes per power of two, and freed blocks are kept on free lists of the freeing thread to
+ * be handed out again for the same size class, so that arrays which are repeatedly created and
+ * destroyed with the same shape do not go through the system allocator. Only blocks up to
+ * MAX_BLOCK_SIZE are cached, and at most MAX_CACHED_BYTES per thread.
+ */
+class ArrayPool
+{
+public:
+  static constexpr std::size_t ALIGNMENT        = 64;
+  static constexpr std::size_t MIN_BLOCK_SIZE   = 64;
+  static constexpr std::size_t MAX_BLOCK_SIZE   = std::size_t{1} << 26;
+  static constexpr std::size_t MAX_CACHED_BYTES = std::size_t{1} << 28;
+
+  /// Frees a block back to the pool, for use as the deleter of a shared pointer
+  class Deleter
+  {
+  public:
+    explicit Deleter(std::size_t size)
+      : size_(size)
+    {}
+
+    void operator()(void *block) const
+    {
+      ArrayPool::Free(block, size_);
+    }
+
+  private:
+    std::size_t size_;
+  };
+
+  /**
+   * Allocates a block of at least size bytes, aligned to ALIGNMENT
+   *
+   * @param size The size of the block in bytes
+   * @return The block, or nullptr if the allocation failed
+   */
+  static void *Allocate(std::size_t size)
+  {
+    if (size > MAX_BLOCK_SIZE)
+    {
+      return _mm_malloc(size, ALIGNMENT);
+    }
+
+    std::size_t const size_class = SizeClass(size);
+
+    Cache *cache = LocalCache();
+    if ((cache != nullptr) && !cache->free_lists[size_class].empty())
+    {
+      void *block = cache->free_lists[size_class].back();
+      cache->free_lists[size_class].pop_back();
+      cache->cached_bytes -= ClassSize(size_class);
+      return block;
+    }
+
+    return _mm_malloc(ClassSize(size_class), ALIGNMENT);
+  }
+
+  /**
+   * Returns a block to the pool
+   *
+   * @param block The block, as returned by Allocate
+   * @param size The size which was requested from Allocate for the block
+   */
+  static void Free(void *block, std::size_t size)
+  {
+    if (block == nullptr)
+    {
+      return;
+    }
+
+    if (size <= MAX_BLOCK_SIZE)
+    {
+      std::size_t const size_class = SizeClass(size);
+      std::size_t const class_size = ClassSize(size_class);
+
+      Cache *cache = LocalCache();
+      if ((cache != nullptr) && (cache->cached_bytes + class_size <= MAX_CACHED_BYTES))
+      {
+        cache->free_lists[size_class].push_back(block);
+        cache->cached_bytes += class_size;
+        return;
+      }
+    }
+
+    _mm_free(block);
+  }
+
+  /// The number of bytes held on the free lists of the calling thread
+  static std::size_t CachedBytes()
+  {
+    Cache const *cache = LocalCache();
+    return (cache != nullptr) ? cache->cached_bytes : 0;
+  }
+
+  /// Releases all the blocks held on the free lists of the calling thread
+  static void Trim()
+  {
+    Cache *cache = LocalCache();
+    if (cache != nullptr)
+    {
+      cache->Release();
+    }
+  }
+
+  /// The size of the blocks handed out for a request of size bytes
+  static std::size_t BlockSize(std::size_t size)
+  {
+    return (size > MAX_BLOCK_SIZE) ? size : ClassSize(SizeClass(size));
+  }
+
+private:
+  static constexpr std::size_t SUB_CLASSES = 4;
+  static constexpr std::size_t NUM_CLASSES = 64 * SUB_CLASSES;
+
+  struct Cache
+  {
+    std::array<std::vector<void *>, NUM_CLASSES> free_lists;
+    std::size_t                                  cached_bytes = 0;
+
+    void Release()
+    {
+      for (auto &free_list : free_lists)
+      {
+        for (void *block : free_list)
+        {
+          _mm_free(block);
+        }
+        free_list.clear();
+      }
+      cached_bytes = 0;
+    }
+
+    ~Cache()
+    {
+      Release();
+      LocalCacheDestroyed() = true;
+    }
+  };
+
+  // arrays destroyed after the cache of their thread, such as statics, are freed directly
+  static bool &LocalCacheDestroyed()
+  {
+    thread_local bool destroyed = false;
+    return destroyed;
+  }
+
+  static Cache *LocalCache()
+  {
+    if (LocalCacheDestroyed())
+    {
+      return nullptr;
+    }
+
+    thread_local Cache cache;
+    return &cache;
+  }
+
+  /// classes split every power of two [2^e, 2^(e + 1)) into SUB_CLASSES equal steps
+  static std::size_t SizeClass(std::size_t size)
+  {
+    if (size < MIN_BLOCK_SIZE)
+    {
+      size = MIN_BLOCK_SIZE;
+    }
+
+    uint64_t const n        = size - 1;
+    uint64_t const exponent = 63 - static_cast<uint64_t>(platform::CountLeadingZeroes64(n));
+    uint64_t const step     = (n >> (exponent - 2)) & (SUB_CLASSES - 1);
+    return static_cast<std::size_t>((exponent * SUB_CLASSES) + step);
+  }
+
+  static std::size_t ClassSize(std::size_t size_class)
+  {
+    std::size_t const exponent = size_class / SUB_CLASSES;
+    std::size_t const step     = size_class % SUB_CLASSES;
+    return (SUB_CLASSES + step + 1) << (exponent - 2);
+  }
+};
+
+}  // namespace memory
+}  // namespace fetch
@@ -20,9 +20,13 @@
 #include "vectorise/memory/details.hpp"
 #include "vectorise/memory/range.hpp"
 #include "vectorise/platform.hpp"
+#include "vectorise/threading/singleton_pool.hpp"
 #include "vectorise/vectorise.hpp"
 
+#include <algorithm>
+#include <cstddef>
 #include <type_traits>
+#include <vector>
 
 namespace fetch {
 namespace memory {
@@ -45,6 +49,11 @@ public:
     , size_(size)
   {}
 
+  ConstParallelDispatcher(type const *ptr, std::size_t const &size)
+    : pointer_(const_cast<type *>(ptr))
+    , size_(size)
+  {}
+
   type Reduce(VectorRegisterType (*vector_reduction)(VectorRegisterType const &,
                                                      VectorRegisterType const &)) const
   {
@@ -526,6 +535,69 @@ public:
     return ret;
   }
 
+  /// Multi-threaded reductions
+  /// @{
+
+  /**
+   * Reduce the elements with a vector reduction, as Reduce over the whole range, splitting the work
+   * between the threads of the shared pool for the larger arrays
+   *
+   * The range is split into shares of whole cache lines, so that every share starts on an aligned
+   * boundary and no two threads touch the same line. The split only depends on the number of
+   * elements and the results of the shares are combined in order, so that the result does not
+   * depend on the number of threads.
+   *
+   * @param vector_reduction The reduction of two registers
+   * @return The reduction of the elements
+   */
+  type ParallelReduce(VectorRegisterType (*vector_reduction)(VectorRegisterType const &,
+                                                             VectorRegisterType const &)) const
+  {
+    std::vector<type> partials = ForEachShare([this, vector_reduction](std::size_t offset,
+                                                                       std::size_t length) {
+      return Reduce(TrivialRange(offset, offset + length), vector_reduction);
+    });
+
+    type ret = 0;
+    for (auto const &partial : partials)
+    {
+      VectorRegisterType c(ret);
+      c   = vector_reduction(c, VectorRegisterType(partial));
+      ret = first_element(c);
+    }
+
+    return ret;
+  }
+
+  /**
+   * Sum the results of a vector function of the elements and those of the other arrays, as
+   * SumReduce, splitting the work between the threads of the shared pool for the larger arrays
+   * (see ParallelReduce)
+   *
+   * @param vector_reduce The function of the registers of this and the other arrays
+   * @param args The other arrays, of at least the size of this one
+   * @return The sum of the results
+   */
+  template <typename F, typename... Args>
+  type ParallelSumReduce(F &&vector_reduce, Args const &... args) const
+  {
+    std::vector<type> partials =
+        ForEachShare([this, &vector_reduce, &args...](std::size_t offset, std::size_t length) {
+          ConstParallelDispatcher share(pointer_ + offset, length);
+          return share.SumReduce(TrivialRange(0, length), vector_reduce,
+                                 Window{args.pointer() + offset, length}...);
+        });
+
+    type ret = 0;
+    for (auto const &partial : partials)
+    {
+      ret += partial;
+    }
+
+    return ret;
+  }
+  /// @}
+
   type const *pointer() const
   {
     return pointer_;
@@ -540,6 +612,65 @@ public:
   }
 
 protected:
+  static constexpr std::size_t CACHE_LINE_SIZE = 64;
+  static constexpr std::size_t LINES_PER_SHARE = 1024;  ///< The cache lines of a share (64 KiB)
+
+  /// A part of another array, read by a share of a multi-threaded reduction
+  struct Window
+  {
+    type const *data;
+    std::size_t length;
+
+    type const *pointer() const
+    {
+      return data;
+    }
+
+    std::size_t size() const
+    {
+      return length;
+    }
+  };
+
+  /// The elements of a share of a multi-threaded reduction, a whole number of cache lines
+  static constexpr std::size_t ElementsPerShare()
+  {
+    return LINES_PER_SHARE * std::max<std::size_t>(CACHE_LINE_SIZE / sizeof(type), 1);
+  }
+
+  /**
+   * Call function(offset, length) for every share of the range on the threads of the pool
+   *
+   * @return The results of the shares, in order
+   */
+  template <typename Function>
+  std::vector<type> ForEachShare(Function const &function) const
+  {
+    std::size_t const share      = ElementsPerShare();
+    std::size_t const num_shares = (size_ + share - 1) / share;
+
+    std::vector<type> partials(num_shares, type(0));
+    if (num_shares == 1)
+    {
+      partials[0] = function(0, size_);
+    }
+    else if (num_shares > 1)
+    {
+      auto const reduce_shares = [this, share, &function, &partials](std::size_t begin,
+                                                                     std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          std::size_t const offset = i * share;
+          partials[i]              = function(offset, std::min(share, size_ - offset));
+        }
+      };
+
+      threading::SingletonPool::GetInstance().ParallelFor(0, num_shares, 1, reduce_shares);
+    }
+
+    return partials;
+  }
+
   type *pointer()
   {
     return pointer_;
@@ -17,6 +17,7 @@
 //
 //------------------------------------------------------------------------------
 
+#include "vectorise/memory/array_pool.hpp"
 #include "vectorise/memory/iterator.hpp"
 #include "vectorise/memory/parallel_dispatcher.hpp"
 #include "vectorise/memory/vector_slice.hpp"
@@ -53,13 +54,30 @@ public:
 
     if (n > 0)
     {
-      data_ = std::shared_ptr<T>(
-          reinterpret_cast<Type *>(_mm_malloc(this->padded_size() * sizeof(Type), 16)), _mm_free);
+      static_assert(std::size_t(SuperType::E_SIMD_ALIGNMENT) <= ArrayPool::ALIGNMENT,
+                    "The pool does not align its blocks for this type");
+
+      std::size_t const size = this->padded_size() * sizeof(Type);
+
+      data_ = std::shared_ptr<T>(reinterpret_cast<Type *>(ArrayPool::Allocate(size)),
+                                 ArrayPool::Deleter(size));
 
       this->pointer_ = data_.get();
     }
   }
 
+  /**
+   * Wrap a region of memory which is owned elsewhere, for example a read only file mapping. The
+   * region is kept alive by the (aliasing) shared pointer and no padding is available past its end.
+   *
+   * @param data The shared pointer to the start of the region
+   * @param n The number of elements in the region
+   */
+  SharedArray(DataType data, SizeType const &n)
+    : SuperType(data.get(), n)
+    , data_(std::move(data))
+  {}
+
   SharedArray() = default;
   SharedArray(SharedArray const &other)
     : SuperType(other.data_.get(), other.size())
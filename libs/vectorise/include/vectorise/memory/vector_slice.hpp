@@ -52,6 +52,7 @@ public:
         (E_SIMD_COUNT_IM > 0 ? E_SIMD_COUNT_IM
                              : 1),  // Note that if a type is too big to fit, we pretend it can
     E_LOG_SIMD_COUNT = fetch::meta::Log2<E_SIMD_COUNT>::value,
+    E_SIMD_ALIGNMENT = (E_SIMD_SIZE > 16 ? E_SIMD_SIZE : 16),  // the vector registers load aligned
     IS_SHARED        = 0
   };
 
@@ -0,0 +1,613 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include "vectorise/info.hpp"
+#include "vectorise/info_neon.hpp"
+#include "vectorise/register.hpp"
+
+#include <arm_neon.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace fetch {
+namespace vectorize {
+
+// NEON integers
+template <typename T>
+class VectorRegister<T, 128>
+{
+public:
+  using type             = T;
+  using mm_register_type = int32x4_t;
+
+  enum
+  {
+    E_VECTOR_SIZE   = 128,
+    E_REGISTER_SIZE = sizeof(mm_register_type),
+    E_BLOCK_COUNT   = E_REGISTER_SIZE / sizeof(type)
+  };
+
+  static_assert((E_BLOCK_COUNT * sizeof(type)) == E_REGISTER_SIZE,
+                "type cannot be contained in the given register size.");
+
+  VectorRegister() = default;
+  VectorRegister(type const *d)
+  {
+    data_ = vreinterpretq_s32_u8(vld1q_u8(reinterpret_cast<uint8_t const *>(d)));
+  }
+  VectorRegister(type const &c)
+  {
+    alignas(16) type constant[E_BLOCK_COUNT];
+    for (std::size_t i = 0; i < std::size_t(E_BLOCK_COUNT); ++i)
+    {
+      constant[i] = c;
+    }
+    data_ = vreinterpretq_s32_u8(vld1q_u8(reinterpret_cast<uint8_t const *>(constant)));
+  }
+  VectorRegister(mm_register_type const &d)
+    : data_(d)
+  {}
+  VectorRegister(mm_register_type &&d)
+    : data_(d)
+  {}
+
+  explicit operator mm_register_type()
+  {
+    return data_;
+  }
+
+  void Store(type *ptr) const
+  {
+    vst1q_u8(reinterpret_cast<uint8_t *>(ptr), vreinterpretq_u8_s32(data_));
+  }
+  void Stream(type *ptr) const
+  {
+    Store(ptr);
+  }
+
+  mm_register_type const &data() const
+  {
+    return data_;
+  }
+  mm_register_type &data()
+  {
+    return data_;
+  }
+
+private:
+  mm_register_type data_;
+};
+
+template <>
+class VectorRegister<float, 128>
+{
+public:
+  using type             = float;
+  using mm_register_type = float32x4_t;
+
+  enum
+  {
+    E_VECTOR_SIZE   = 128,
+    E_REGISTER_SIZE = sizeof(mm_register_type),
+    E_BLOCK_COUNT   = E_REGISTER_SIZE / sizeof(type)
+  };
+
+  static_assert((E_BLOCK_COUNT * sizeof(type)) == E_REGISTER_SIZE,
+                "type cannot be contained in the given register size.");
+
+  VectorRegister() = default;
+  VectorRegister(type const *d)
+  {
+    data_ = vld1q_f32(d);
+  }
+  VectorRegister(mm_register_type const &d)
+    : data_(d)
+  {}
+  VectorRegister(mm_register_type &&d)
+    : data_(d)
+  {}
+  VectorRegister(type const &c)
+  {
+    data_ = vdupq_n_f32(c);
+  }
+
+  explicit operator mm_register_type()
+  {
+    return data_;
+  }
+
+  void Store(type *ptr) const
+  {
+    vst1q_f32(ptr, data_);
+  }
+  void Stream(type *ptr) const
+  {
+    vst1q_f32(ptr, data_);
+  }
+
+  mm_register_type const &data() const
+  {
+    return data_;
+  }
+  mm_register_type &data()
+  {
+    return data_;
+  }
+
+private:
+  mm_register_type data_;
+};
+
+template <>
+class VectorRegister<double, 128>
+{
+public:
+  using type             = double;
+  using mm_register_type = float64x2_t;
+
+  enum
+  {
+    E_VECTOR_SIZE   = 128,
+    E_REGISTER_SIZE = sizeof(mm_register_type),
+    E_BLOCK_COUNT   = E_REGISTER_SIZE / sizeof(type)
+  };
+
+  static_assert((E_BLOCK_COUNT * sizeof(type)) == E_REGISTER_SIZE,
+                "type cannot be contained in the given register size.");
+
+  VectorRegister() = default;
+  VectorRegister(type const *d)
+  {
+    data_ = vld1q_f64(d);
+  }
+  VectorRegister(mm_register_type const &d)
+    : data_(d)
+  {}
+  VectorRegister(mm_register_type &&d)
+    : data_(d)
+  {}
+  VectorRegister(type const &c)
+  {
+    data_ = vdupq_n_f64(c);
+  }
+
+  explicit operator mm_register_type()
+  {
+    return data_;
+  }
+
+  void Store(type *ptr) const
+  {
+    vst1q_f64(ptr, data_);
+  }
+  void Stream(type *ptr) const
+  {
+    vst1q_f64(ptr, data_);
+  }
+
+  mm_register_type const &data() const
+  {
+    return data_;
+  }
+  mm_register_type &data()
+  {
+    return data_;
+  }
+
+private:
+  mm_register_type data_;
+};
+
+#define FETCH_ADD_OPERATOR(type, fnc)                                            \
+  inline VectorRegister<type, 128> operator-(VectorRegister<type, 128> const &x) \
+  {                                                                              \
+    return VectorRegister<type, 128>(fnc(x.data()));                             \
+  }
+
+FETCH_ADD_OPERATOR(int32_t, vnegq_s32)
+FETCH_ADD_OPERATOR(float, vnegq_f32)
+FETCH_ADD_OPERATOR(double, vnegq_f64)
+#undef FETCH_ADD_OPERATOR
+
+#define FETCH_ADD_OPERATOR(op, type, fnc)                                          \
+  inline VectorRegister<type, 128> operator op(VectorRegister<type, 128> const &a, \
+                                               VectorRegister<type, 128> const &b) \
+  {                                                                                \
+    VectorRegister<type, 128>::mm_register_type ret = fnc(a.data(), b.data());     \
+    return VectorRegister<type, 128>(ret);                                         \
+  }
+
+FETCH_ADD_OPERATOR(+, int32_t, vaddq_s32)
+FETCH_ADD_OPERATOR(-, int32_t, vsubq_s32)
+FETCH_ADD_OPERATOR(*, int32_t, vmulq_s32)
+
+// the sums, differences and (low halves of) products are identical for unsigned integers
+FETCH_ADD_OPERATOR(+, uint32_t, vaddq_s32)
+FETCH_ADD_OPERATOR(-, uint32_t, vsubq_s32)
+FETCH_ADD_OPERATOR(*, uint32_t, vmulq_s32)
+
+FETCH_ADD_OPERATOR(*, float, vmulq_f32)
+FETCH_ADD_OPERATOR(-, float, vsubq_f32)
+FETCH_ADD_OPERATOR(/, float, vdivq_f32)
+FETCH_ADD_OPERATOR(+, float, vaddq_f32)
+
+FETCH_ADD_OPERATOR(*, double, vmulq_f64)
+FETCH_ADD_OPERATOR(-, double, vsubq_f64)
+FETCH_ADD_OPERATOR(/, double, vdivq_f64)
+FETCH_ADD_OPERATOR(+, double, vaddq_f64)
+
+#undef FETCH_ADD_OPERATOR
+
+// there is no integer division instruction, divide element wise (by zero yields zero)
+#define FETCH_ADD_OPERATOR(type)                                                 \
+  inline VectorRegister<type, 128> operator/(VectorRegister<type, 128> const &a, \
+                                             VectorRegister<type, 128> const &b) \
+  {                                                                              \
+    alignas(16) type d1[4];                                                      \
+    alignas(16) type d2[4];                                                      \
+    alignas(16) type ret[4];                                                     \
+    a.Store(d1);                                                                 \
+    b.Store(d2);                                                                 \
+    for (std::size_t i = 0; i < 4; ++i)                                          \
+    {                                                                            \
+      ret[i] = d2[i] != 0 ? type(d1[i] / d2[i]) : type(0);                       \
+    }                                                                            \
+    return VectorRegister<type, 128>(ret);                                       \
+  }
+
+FETCH_ADD_OPERATOR(int32_t)
+FETCH_ADD_OPERATOR(uint32_t)
+
+#undef FETCH_ADD_OPERATOR
+
+// integer comparisons set all the bits of the matching elements, as for SSE
+#define FETCH_ADD_OPERATOR(op, type, fnc)                                             \
+  inline VectorRegister<type, 128> operator op(VectorRegister<type, 128> const &a,    \
+                                               VectorRegister<type, 128> const &b)    \
+  {                                                                                   \
+    return VectorRegister<type, 128>(vreinterpretq_s32_u32(fnc(a.data(), b.data()))); \
+  }
+
+FETCH_ADD_OPERATOR(==, int32_t, vceqq_s32)
+FETCH_ADD_OPERATOR(<, int32_t, vcltq_s32)
+
+#undef FETCH_ADD_OPERATOR
+
+// floating point comparisons set the matching elements to one, as for SSE
+#define FETCH_ADD_OPERATOR(op, type, fnc)                                          \
+  inline VectorRegister<type, 128> operator op(VectorRegister<type, 128> const &a, \
+                                               VectorRegister<type, 128> const &b) \
+  {                                                                                \
+    uint32x4_t const mask = fnc(a.data(), b.data());                               \
+    uint32x4_t const one  = vreinterpretq_u32_f32(vdupq_n_f32(1.0f));              \
+    return VectorRegister<type, 128>(vreinterpretq_f32_u32(vandq_u32(mask, one))); \
+  }
+
+FETCH_ADD_OPERATOR(==, float, vceqq_f32)
+FETCH_ADD_OPERATOR(>=, float, vcgeq_f32)
+FETCH_ADD_OPERATOR(>, float, vcgtq_f32)
+FETCH_ADD_OPERATOR(<=, float, vcleq_f32)
+FETCH_ADD_OPERATOR(<, float, vcltq_f32)
+
+#undef FETCH_ADD_OPERATOR
+
+#define FETCH_ADD_OPERATOR(op, type, fnc)                                          \
+  inline VectorRegister<type, 128> operator op(VectorRegister<type, 128> const &a, \
+                                               VectorRegister<type, 128> const &b) \
+  {                                                                                \
+    uint64x2_t const mask = fnc(a.data(), b.data());                               \
+    uint64x2_t const one  = vreinterpretq_u64_f64(vdupq_n_f64(1.0));               \
+    return VectorRegister<type, 128>(vreinterpretq_f64_u64(vandq_u64(mask, one))); \
+  }
+
+FETCH_ADD_OPERATOR(==, double, vceqq_f64)
+FETCH_ADD_OPERATOR(>=, double, vcgeq_f64)
+FETCH_ADD_OPERATOR(>, double, vcgtq_f64)
+FETCH_ADD_OPERATOR(<=, double, vcleq_f64)
+FETCH_ADD_OPERATOR(<, double, vcltq_f64)
+
+#undef FETCH_ADD_OPERATOR
+
+// there are no inequality comparisons, these complement the equality masks
+inline VectorRegister<float, 128> operator!=(VectorRegister<float, 128> const &a,
+                                             VectorRegister<float, 128> const &b)
+{
+  uint32x4_t const mask = vmvnq_u32(vceqq_f32(a.data(), b.data()));
+  uint32x4_t const one  = vreinterpretq_u32_f32(vdupq_n_f32(1.0f));
+  return VectorRegister<float, 128>(vreinterpretq_f32_u32(vandq_u32(mask, one)));
+}
+
+inline VectorRegister<double, 128> operator!=(VectorRegister<double, 128> const &a,
+                                              VectorRegister<double, 128> const &b)
+{
+  uint64x2_t const mask = vceqq_f64(a.data(), b.data());
+  uint64x2_t const one  = vreinterpretq_u64_f64(vdupq_n_f64(1.0));
+  return VectorRegister<double, 128>(vreinterpretq_f64_u64(vbicq_u64(one, mask)));
+}
+
+// FREE FUNCTIONS
+inline VectorRegister<float, 128> max(VectorRegister<float, 128> const &a,
+                                      VectorRegister<float, 128> const &b)
+{
+  return VectorRegister<float, 128>(vmaxq_f32(a.data(), b.data()));
+}
+
+inline VectorRegister<float, 128> min(VectorRegister<float, 128> const &a,
+                                      VectorRegister<float, 128> const &b)
+{
+  return VectorRegister<float, 128>(vminq_f32(a.data(), b.data()));
+}
+
+inline VectorRegister<float, 128> sqrt(VectorRegister<float, 128> const &a)
+{
+  return VectorRegister<float, 128>(vsqrtq_f32(a.data()));
+}
+
+inline VectorRegister<float, 128> abs(VectorRegister<float, 128> const &a)
+{
+  return VectorRegister<float, 128>(vabsq_f32(a.data()));
+}
+
+inline VectorRegister<float, 128> approx_exp(VectorRegister<float, 128> const &x)
+{
+  enum
+  {
+    mantissa = 23,
+    exponent = 8,
+  };
+
+  constexpr float                  multiplier      = float(1ull << mantissa);
+  constexpr float                  exponent_offset = (float(((1ull << (exponent - 1)) - 1)));
+  const VectorRegister<float, 128> a(float(multiplier / M_LN2));
+  const VectorRegister<float, 128> b(float(exponent_offset * multiplier - 60801));
+
+  VectorRegister<float, 128> y    = a * x + b;
+  int32x4_t                  conv = vcvtnq_s32_f32(y.data());
+
+  return VectorRegister<float, 128>(vreinterpretq_f32_s32(conv));
+}
+
+inline VectorRegister<float, 128> approx_log(VectorRegister<float, 128> const &x)
+{
+  enum
+  {
+    mantissa = 23,
+    exponent = 8,
+  };
+
+  constexpr float                  multiplier      = float(1ull << mantissa);
+  constexpr float                  exponent_offset = (float(((1ull << (exponent - 1)) - 1)));
+  const VectorRegister<float, 128> a(float(M_LN2 / multiplier));
+  const VectorRegister<float, 128> b(float(exponent_offset * multiplier - 60801));
+
+  int32x4_t conv = vreinterpretq_s32_f32(x.data());
+
+  VectorRegister<float, 128> y(vcvtq_f32_s32(conv));
+
+  return a * (y - b);
+}
+
+inline VectorRegister<float, 128> approx_reciprocal(VectorRegister<float, 128> const &x)
+{
+  return VectorRegister<float, 128>(vrecpeq_f32(x.data()));
+}
+
+inline VectorRegister<double, 128> max(VectorRegister<double, 128> const &a,
+                                       VectorRegister<double, 128> const &b)
+{
+  return VectorRegister<double, 128>(vmaxq_f64(a.data(), b.data()));
+}
+
+inline VectorRegister<double, 128> min(VectorRegister<double, 128> const &a,
+                                       VectorRegister<double, 128> const &b)
+{
+  return VectorRegister<double, 128>(vminq_f64(a.data(), b.data()));
+}
+
+inline VectorRegister<double, 128> sqrt(VectorRegister<double, 128> const &a)
+{
+  return VectorRegister<double, 128>(vsqrtq_f64(a.data()));
+}
+
+inline VectorRegister<double, 128> abs(VectorRegister<double, 128> const &a)
+{
+  return VectorRegister<double, 128>(vabsq_f64(a.data()));
+}
+
+inline VectorRegister<double, 128> approx_exp(VectorRegister<double, 128> const &x)
+{
+  enum
+  {
+    mantissa = 20,
+    exponent = 11,
+  };
+
+  constexpr double                  multiplier      = double(1ull << mantissa);
+  constexpr double                  exponent_offset = (double(((1ull << (exponent - 1)) - 1)));
+  const VectorRegister<double, 128> a(double(multiplier / M_LN2));
+  const VectorRegister<double, 128> b(double(exponent_offset * multiplier - 60801));
+
+  VectorRegister<double, 128> y = a * x + b;
+
+  // the integer forms the upper 32 bits of each element, leaving the lower bits of the mantissa
+  int64x2_t conv = vcvtnq_s64_f64(y.data());
+  conv           = vshlq_n_s64(conv, 32);
+
+  return VectorRegister<double, 128>(vreinterpretq_f64_s64(conv));
+}
+
+inline VectorRegister<double, 128> approx_log(VectorRegister<double, 128> const &x)
+{
+  enum
+  {
+    mantissa = 20,
+    exponent = 11,
+  };
+
+  constexpr double                  multiplier      = double(1ull << mantissa);
+  constexpr double                  exponent_offset = (double(((1ull << (exponent - 1)) - 1)));
+  const VectorRegister<double, 128> a(double(M_LN2 / multiplier));
+  const VectorRegister<double, 128> b(double(exponent_offset * multiplier - 60801));
+
+  // only the upper 32 bits of each element are considered
+  int64x2_t conv = vshrq_n_s64(vreinterpretq_s64_f64(x.data()), 32);
+
+  VectorRegister<double, 128> y(vcvtq_f64_s64(conv));
+
+  return a * (y - b);
+}
+
+inline VectorRegister<double, 128> approx_reciprocal(VectorRegister<double, 128> const &x)
+{
+  return VectorRegister<double, 128>(vrecpeq_f64(x.data()));
+}
+
+inline VectorRegister<double, 128> vector_zero_below_element(VectorRegister<double, 128> const &a,
+                                                             int const &                        n)
+{
+  alignas(16) uint64_t const mask[2] = {uint64_t(-(0 >= n)), uint64_t(-(1 >= n))};
+
+  uint64x2_t conv = vandq_u64(vreinterpretq_u64_f64(a.data()), vld1q_u64(mask));
+
+  return VectorRegister<double, 128>(vreinterpretq_f64_u64(conv));
+}
+
+inline VectorRegister<double, 128> vector_zero_above_element(VectorRegister<double, 128> const &a,
+                                                             int const &                        n)
+{
+  alignas(16) uint64_t const mask[2] = {uint64_t(-(0 <= n)), uint64_t(-(1 <= n))};
+
+  uint64x2_t conv = vandq_u64(vreinterpretq_u64_f64(a.data()), vld1q_u64(mask));
+
+  return VectorRegister<double, 128>(vreinterpretq_f64_u64(conv));
+}
+
+inline VectorRegister<double, 128> shift_elements_left(VectorRegister<double, 128> const &x)
+{
+  return VectorRegister<double, 128>(vextq_f64(vdupq_n_f64(0.0), x.data(), 1));
+}
+
+inline VectorRegister<double, 128> shift_elements_right(VectorRegister<double, 128> const &x)
+{
+  return VectorRegister<double, 128>(vextq_f64(x.data(), vdupq_n_f64(0.0), 1));
+}
+
+inline double first_element(VectorRegister<double, 128> const &x)
+{
+  return vgetq_lane_f64(x.data(), 0);
+}
+
+// Floats
+inline VectorRegister<float, 128> vector_zero_below_element(VectorRegister<float, 128> const &a,
+                                                            int const &                       n)
+{
+  alignas(16) uint32_t const mask[4] = {uint32_t(-(0 >= n)), uint32_t(-(1 >= n)),
+                                        uint32_t(-(2 >= n)), uint32_t(-(3 >= n))};
+
+  uint32x4_t conv = vandq_u32(vreinterpretq_u32_f32(a.data()), vld1q_u32(mask));
+
+  return VectorRegister<float, 128>(vreinterpretq_f32_u32(conv));
+}
+
+inline VectorRegister<float, 128> vector_zero_above_element(VectorRegister<float, 128> const &a,
+                                                            int const &                       n)
+{
+  alignas(16) uint32_t const mask[4] = {uint32_t(-(0 <= n)), uint32_t(-(1 <= n)),
+                                        uint32_t(-(2 <= n)), uint32_t(-(3 <= n))};
+
+  uint32x4_t conv = vandq_u32(vreinterpretq_u32_f32(a.data()), vld1q_u32(mask));
+
+  return VectorRegister<float, 128>(vreinterpretq_f32_u32(conv));
+}
+
+inline VectorRegister<float, 128> shift_elements_left(VectorRegister<float, 128> const &x)
+{
+  return VectorRegister<float, 128>(vextq_f32(vdupq_n_f32(0.0f), x.data(), 3));
+}
+
+inline VectorRegister<float, 128> shift_elements_right(VectorRegister<float, 128> const &x)
+{
+  return VectorRegister<float, 128>(vextq_f32(x.data(), vdupq_n_f32(0.0f), 1));
+}
+
+inline float first_element(VectorRegister<float, 128> const &x)
+{
+  return vgetq_lane_f32(x.data(), 0);
+}
+
+// Integers
+inline uint32_t first_element(VectorRegister<uint32_t, 128> const &x)
+{
+  return static_cast<uint32_t>(vgetq_lane_s32(x.data(), 0));
+}
+
+inline VectorRegister<uint32_t, 128> shift_elements_left(VectorRegister<uint32_t, 128> const &x)
+{
+  return VectorRegister<uint32_t, 128>(vextq_s32(vdupq_n_s32(0), x.data(), 3));
+}
+
+inline VectorRegister<uint32_t, 128> shift_elements_right(VectorRegister<uint32_t, 128> const &x)
+{
+  return VectorRegister<uint32_t, 128>(vextq_s32(x.data(), vdupq_n_s32(0), 1));
+}
+
+inline int32_t first_element(VectorRegister<int32_t, 128> const &x)
+{
+  return vgetq_lane_s32(x.data(), 0);
+}
+
+inline VectorRegister<int32_t, 128> shift_elements_left(VectorRegister<int32_t, 128> const &x)
+{
+  return VectorRegister<int32_t, 128>(vextq_s32(vdupq_n_s32(0), x.data(), 3));
+}
+
+inline VectorRegister<int32_t, 128> shift_elements_right(VectorRegister<int32_t, 128> const &x)
+{
+  return VectorRegister<int32_t, 128>(vextq_s32(x.data(), vdupq_n_s32(0), 1));
+}
+
+inline double reduce(VectorRegister<double, 128> const &x)
+{
+  return vaddvq_f64(x.data());
+}
+
+inline float reduce(VectorRegister<float, 128> const &x)
+{
+  return vaddvq_f32(x.data());
+}
+
+inline bool all_less_than(VectorRegister<double, 128> const &x,
+                          VectorRegister<double, 128> const &y)
+{
+  uint32x4_t r = vreinterpretq_u32_u64(vcltq_f64(x.data(), y.data()));
+  return vminvq_u32(r) != 0;
+}
+
+inline bool any_less_than(VectorRegister<double, 128> const &x,
+                          VectorRegister<double, 128> const &y)
+{
+  uint32x4_t r = vreinterpretq_u32_u64(vcltq_f64(x.data(), y.data()));
+  return vmaxvq_u32(r) != 0;
+}
+
+}  // namespace vectorize
+}  // namespace fetch
+#endif
@@ -38,9 +38,11 @@ struct VectorRegisterSize
 {
   enum
   {
-#ifdef __AVX__
+#ifdef __AVX512F__
+    value = 512
+#elif defined __AVX__
     value = 256
-#elif defined __SSE__
+#elif defined __SSE__ || (defined __ARM_NEON && defined __aarch64__)
     value = 128
 #else
     value = 32
@@ -58,7 +60,11 @@ struct VectorRegisterSize
     };                                \
   }
 
-#ifdef __AVX2__
+#ifdef __AVX512F__
+
+ADD_REGISTER_SIZE(int, 512);
+
+#elif defined __AVX2__
 
 ADD_REGISTER_SIZE(int, 256);
 
@@ -80,6 +86,12 @@ ADD_REGISTER_SIZE(int, 128);
 ADD_REGISTER_SIZE(double, 128);
 ADD_REGISTER_SIZE(float, 128);
 
+#elif defined __ARM_NEON && defined __aarch64__
+
+ADD_REGISTER_SIZE(int, 128);
+ADD_REGISTER_SIZE(double, 128);
+ADD_REGISTER_SIZE(float, 128);
+
 #else
 
 ADD_REGISTER_SIZE(int, sizeof(int));
@@ -105,6 +117,24 @@ constexpr bool has_avx2()
 #endif
 }
 
+constexpr bool has_avx512f()
+{
+#ifdef __AVX512F__
+  return true;
+#else
+  return false;
+#endif
+}
+
+constexpr bool has_neon()
+{
+#if defined(__ARM_NEON) && defined(__aarch64__)
+  return true;
+#else
+  return false;
+#endif
+}
+
 constexpr bool has_sse()
 {
 #ifdef __SSE__
@@ -17,6 +17,7 @@
 //
 //------------------------------------------------------------------------------
 
+#ifdef __SSE__
 #include "vectorise/info.hpp"
 #include "vectorise/info_sse.hpp"
 #include "vectorise/register.hpp"
@@ -583,3 +584,4 @@ inline bool any_less_than(VectorRegister<double, 128> const &x,
 
 }  // namespace vectorize
 }  // namespace fetch
+#endif
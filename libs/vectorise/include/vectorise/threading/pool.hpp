@@ -17,25 +17,81 @@
 //
 //------------------------------------------------------------------------------
 
-#include "core/mutex.hpp"
 #include "core/threading.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <future>
-#include <queue>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace fetch {
 namespace threading {
 
+class Pool;
+
+/**
+ * A lightweight handle on a group of tasks run on a pool. Unlike a future per task, the group only
+ * keeps a count of the outstanding tasks and the first error raised by any of them.
+ *
+ * Waiting on the group runs the pending tasks of the pool on the calling thread, so that a task
+ * which itself waits on a group (nested parallelism) keeps the pool busy rather than blocking one
+ * of its workers.
+ */
+class TaskGroup
+{
+public:
+  // Construction / Destruction
+  explicit TaskGroup(Pool &pool)
+    : pool_(pool)
+  {}
+  TaskGroup(TaskGroup const &) = delete;
+  TaskGroup(TaskGroup &&)      = delete;
+  ~TaskGroup();
+
+  template <typename F>
+  void Run(F &&function);
+  void Wait();
+
+  // Operators
+  TaskGroup &operator=(TaskGroup const &) = delete;
+  TaskGroup &operator=(TaskGroup &&) = delete;
+
+private:
+  void Drain();
+
+  Pool &                   pool_;
+  std::atomic<std::size_t> outstanding_{0};  ///< The number of tasks yet to complete
+  std::mutex               error_lock_;
+  std::exception_ptr       error_;  ///< The first error raised by one of the tasks
+};
+
+/**
+ * A work stealing thread pool
+ *
+ * Each worker has its own deque of tasks. Tasks posted from a worker are pushed onto (and popped
+ * from) the back of its own deque, while idle workers steal from the front of the other deques.
+ * Tasks posted from outside the pool are placed on a shared deque. Workers which find no work
+ * yield for a while before parking until the next task is posted.
+ */
 class Pool
 {
 public:
+  using Task = std::function<void()>;
+
+  // Construction / Destruction
   Pool()
-    : Pool(2 * std::thread::hardware_concurrency())
+    : Pool(std::max<std::size_t>(std::thread::hardware_concurrency(), 1))
   {}
 
   Pool(std::size_t const &n, std::string name = std::string{})
@@ -43,32 +99,81 @@ public:
   {
     for (std::size_t i = 0; i < n; ++i)
     {
-      workers_.emplace_back([this, i]() {
+      workers_.emplace_back(std::make_unique<Worker>());
+    }
+
+    // only start the threads once all the deques exist, since they steal from each other
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      workers_[i]->thread = std::thread([this, i]() {
         if (!name_.empty())
         {
           SetThreadName(name_, i);
         }
 
-        this->Work();
+        this->Work(i);
       });
     }
   }
 
+  Pool(Pool const &) = delete;
+  Pool(Pool &&)      = delete;
+
   ~Pool()
   {
     running_ = false;
 
     {
-      std::lock_guard<std::mutex> lock(mutex_);
-      condition_.notify_all();
+      std::lock_guard<std::mutex> lock(idle_lock_);
+      idle_cv_.notify_all();
     }
 
-    for (auto &w : workers_)
+    for (auto &worker : workers_)
     {
-      w.join();
+      worker->thread.join();
     }
   }
 
+  /**
+   * Post a task to the pool, without any means of waiting for it. The task must not throw.
+   *
+   * @param function The task to be run
+   */
+  template <typename F>
+  void Post(F &&function)
+  {
+    ++pending_;
+
+    WorkerId const &current = CurrentWorker();
+    if (current.pool == this)
+    {
+      Worker &worker = *workers_[current.index];
+
+      std::lock_guard<std::mutex> lock(worker.lock);
+      worker.tasks.emplace_back(std::forward<F>(function));
+      ++queued_;
+    }
+    else
+    {
+      std::lock_guard<std::mutex> lock(shared_lock_);
+      shared_.emplace_back(std::forward<F>(function));
+      ++queued_;
+    }
+
+    // pairs with the idle count in Work, either the task is seen or the idle worker is
+    if (idle_ != 0)
+    {
+      {
+        std::lock_guard<std::mutex> lock(idle_lock_);
+      }
+      idle_cv_.notify_one();
+    }
+  }
+
+  /**
+   * Dispatch a task to the pool, returning a future for its result. Prefer `Post` or a
+   * `TaskGroup` where the result is not needed, since the future allocates per task.
+   */
   template <typename F, typename... Args>
   std::future<typename std::result_of<F(Args...)>::type> Dispatch(F &&f, Args &&... args)
   {
@@ -76,73 +181,316 @@ public:
     using task_type   = std::packaged_task<return_type()>;
 
     std::shared_ptr<task_type> task =
-        std::make_shared<task_type>(std::bind(f, std::forward<Args>(args)...));
+        std::make_shared<task_type>(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+
+    auto result = task->get_future();
+    Post([task]() { (*task)(); });
+
+    return result;
+  }
 
+  /**
+   * Call function(begin, end) over the range [begin, end) split into pieces of at most grain
+   * elements, each starting at a multiple of grain from the start of the range. The range is
+   * split in halves recursively, so that idle workers steal the larger pieces first. Returns once
+   * every piece has completed, rethrowing the first error raised by any of them.
+   *
+   * @param begin The start of the range
+   * @param end The end of the range
+   * @param grain The maximum number of elements of each piece
+   * @param function The function to be called on each piece
+   */
+  template <typename Function>
+  void ParallelFor(std::size_t begin, std::size_t end, std::size_t grain, Function &&function)
+  {
+    if (begin >= end)
     {
-      std::lock_guard<std::mutex> lock(mutex_);
-      tasks_.emplace([task]() { (*task)(); });
+      return;
     }
 
-    condition_.notify_one();
-    return task->get_future();
+    grain = std::max<std::size_t>(grain, 1);
+
+    TaskGroup group{*this};
+    group.Run([this, &group, &function, begin, end, grain]() {
+      Split(group, begin, end, grain, function);
+    });
+    group.Wait();
   }
 
+  /**
+   * Wait for all the tasks posted to the pool to complete, running pending tasks on the calling
+   * thread in the meantime
+   */
   void Wait()
   {
-    while (!Empty())
-    {
-      std::this_thread::sleep_for(std::chrono::nanoseconds(1));
-    }
-    while (tasks_in_progress_ != 0)
+    while (pending_ != 0)
     {
-      std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+      if (!RunPendingTask())
+      {
+        std::this_thread::yield();
+      }
     }
   }
 
   bool Empty()
   {
-    std::unique_lock<std::mutex> lock(mutex_);
-    return tasks_.empty();
+    return queued_ == 0;
+  }
+
+  std::size_t NumWorkers() const
+  {
+    return workers_.size();
+  }
+
+  /**
+   * Run one of the pending tasks of the pool on the calling thread, if there are any
+   *
+   * @return true if a task was run, otherwise false
+   */
+  bool RunPendingTask()
+  {
+    Task task;
+    if (!TakeTask(task))
+    {
+      return false;
+    }
+
+    task();
+    --pending_;
+
+    return true;
   }
 
+  // Operators
+  Pool &operator=(Pool const &) = delete;
+  Pool &operator=(Pool &&) = delete;
+
 private:
-  void Work()
+  static constexpr std::size_t IDLE_ROUNDS = 64;  ///< The yields before a worker parks
+
+  using Tasks = std::deque<Task>;
+
+  struct Worker
   {
-    while (running_)
+    std::mutex  lock;
+    Tasks       tasks;  ///< The tasks posted by this worker
+    std::thread thread;
+  };
+
+  struct WorkerId
+  {
+    Pool const *pool{nullptr};
+    std::size_t index{0};
+  };
+
+  using WorkerPtr = std::unique_ptr<Worker>;
+  using Workers   = std::vector<WorkerPtr>;
+
+  static WorkerId &CurrentWorker()
+  {
+    static thread_local WorkerId current{};
+    return current;
+  }
+
+  template <typename Function>
+  void Split(TaskGroup &group, std::size_t begin, std::size_t end, std::size_t grain,
+             Function &function)
+  {
+    // hand the upper halves to the pool and keep splitting the lower one
+    while ((end - begin) > grain)
     {
-      std::function<void()> task = NextTask();
-      if (task)
+      std::size_t const pieces = (end - begin + grain - 1) / grain;
+      std::size_t const middle = begin + ((pieces / 2) * grain);
+
+      group.Run([this, &group, &function, middle, end, grain]() {
+        Split(group, middle, end, grain, function);
+      });
+
+      end = middle;
+    }
+
+    function(begin, end);
+  }
+
+  bool TakeTask(Task &task)
+  {
+    WorkerId const &current = CurrentWorker();
+    bool const      is_worker = (current.pool == this);
+
+    // the most recently posted task of our own deque is the most likely to be in cache
+    if (is_worker && PopBack(*workers_[current.index], task))
+    {
+      return true;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(shared_lock_);
+      if (!shared_.empty())
+      {
+        task = std::move(shared_.front());
+        shared_.pop_front();
+        --queued_;
+        return true;
+      }
+    }
+
+    // steal the oldest task from one of the other workers
+    std::size_t const num_workers = workers_.size();
+    std::size_t const start       = is_worker ? current.index + 1 : next_victim_++;
+    for (std::size_t i = 0; i < num_workers; ++i)
+    {
+      std::size_t const victim = (start + i) % num_workers;
+      if (is_worker && (victim == current.index))
+      {
+        continue;
+      }
+
+      if (StealFront(*workers_[victim], task))
       {
-        task();
-        --tasks_in_progress_;
+        return true;
       }
     }
+
+    return false;
+  }
+
+  bool PopBack(Worker &worker, Task &task)
+  {
+    std::lock_guard<std::mutex> lock(worker.lock);
+    if (worker.tasks.empty())
+    {
+      return false;
+    }
+
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    --queued_;
+
+    return true;
   }
 
-  std::function<void()> NextTask()
+  bool StealFront(Worker &worker, Task &task)
   {
-    std::unique_lock<std::mutex> lock(mutex_);
-    condition_.wait(lock, [this] { return (!bool(running_)) || (!tasks_.empty()); });
-    if (!bool(running_))
+    std::lock_guard<std::mutex> lock(worker.lock);
+    if (worker.tasks.empty())
     {
-      return std::function<void()>();
+      return false;
     }
 
-    std::function<void()> task = tasks_.front();
-    ++tasks_in_progress_;
+    task = std::move(worker.tasks.front());
+    worker.tasks.pop_front();
+    --queued_;
 
-    tasks_.pop();
-    return task;
+    return true;
   }
 
-  std::string                       name_{};
-  std::atomic<uint32_t>             tasks_in_progress_{0};
-  std::atomic<bool>                 running_{true};
-  std::mutex                        mutex_;
-  std::vector<std::thread>          workers_;
-  std::queue<std::function<void()>> tasks_;
-  std::condition_variable           condition_;
+  void Work(std::size_t index)
+  {
+    CurrentWorker() = WorkerId{this, index};
+
+    std::size_t idle_rounds{0};
+    while (running_)
+    {
+      if (RunPendingTask())
+      {
+        idle_rounds = 0;
+        continue;
+      }
+
+      if (++idle_rounds < IDLE_ROUNDS)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+
+      idle_rounds = 0;
+
+      // park until the next task is posted
+      std::unique_lock<std::mutex> lock(idle_lock_);
+      ++idle_;
+      idle_cv_.wait(lock, [this]() { return !running_ || (queued_ != 0); });
+      --idle_;
+    }
+  }
+
+  std::string              name_{};
+  std::atomic<bool>        running_{true};
+  std::atomic<std::size_t> pending_{0};      ///< The number of tasks posted but not completed
+  std::atomic<std::size_t> queued_{0};       ///< The number of tasks posted but not started
+  std::atomic<std::size_t> idle_{0};         ///< The number of parked workers
+  std::atomic<std::size_t> next_victim_{0};  ///< Spreads the steals of non-worker threads
+  Workers                  workers_;
+  std::mutex               shared_lock_;
+  Tasks                    shared_;  ///< The tasks posted from outside the pool
+  std::mutex               idle_lock_;
+  std::condition_variable  idle_cv_;
 };
 
+/**
+ * Run a task as part of the group
+ *
+ * @param function The task to be run
+ */
+template <typename F>
+void TaskGroup::Run(F &&function)
+{
+  ++outstanding_;
+
+  pool_.Post([this, task = std::forward<F>(function)]() mutable {
+    try
+    {
+      task();
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(error_lock_);
+      if (!error_)
+      {
+        error_ = std::current_exception();
+      }
+    }
+
+    // the group may be destroyed as soon as the count drops, this must be the last access
+    --outstanding_;
+  });
+}
+
+/**
+ * Wait for all the tasks of the group to complete, running pending tasks of the pool in the
+ * meantime. Rethrows the first error raised by any of the tasks.
+ */
+inline void TaskGroup::Wait()
+{
+  Drain();
+
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock(error_lock_);
+    std::swap(error, error_);
+  }
+
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+}
+
+inline TaskGroup::~TaskGroup()
+{
+  // the tasks may reference the group (and the caller's stack), they must complete first
+  Drain();
+}
+
+inline void TaskGroup::Drain()
+{
+  while (outstanding_ != 0)
+  {
+    if (!pool_.RunPendingTask())
+    {
+      std::this_thread::yield();
+    }
+  }
+}
+
 }  // namespace threading
 }  // namespace fetch
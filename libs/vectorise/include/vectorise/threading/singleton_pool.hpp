@@ -37,7 +37,7 @@ private:
   SingletonPool(SingletonPool const &)  = delete;
   SingletonPool(SingletonPool const &&) = delete;
   SingletonPool()
-    : Pool(){};
+    : Pool(std::max<std::size_t>(std::thread::hardware_concurrency(), 1), "Compute"){};
 };
 
 }  // namespace threading
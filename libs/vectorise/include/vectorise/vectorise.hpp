@@ -18,8 +18,10 @@
 //------------------------------------------------------------------------------
 
 #include "vectorise/avx.hpp"
+#include "vectorise/avx512.hpp"
 #include "vectorise/info.hpp"
 #include "vectorise/iterator.hpp"
 #include "vectorise/math.hpp"
+#include "vectorise/neon.hpp"
 #include "vectorise/register.hpp"
 #include "vectorise/sse.hpp"
@@ -0,0 +1,240 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "vectorise/info.hpp"
+#include "vectorise/platform.hpp"
+#include "vectorise/vectorise.hpp"
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+using namespace fetch::vectorize;
+
+TEST(vectorise_avx512_gtest, cpu_features)
+{
+  // a build targeting a vector extension must only ever be run where it is supported
+  EXPECT_GE(GetNativeVectorSize(), std::size_t(fetch::platform::VectorRegisterSize<float>::value));
+  EXPECT_TRUE(!fetch::platform::has_avx512f() || GetCpuFeatures().avx512f);
+  EXPECT_TRUE(!fetch::platform::has_neon() || GetCpuFeatures().neon);
+}
+
+#ifdef __AVX512F__
+
+TEST(vectorise_avx512_gtest, register_test1)
+{
+  alignas(64) int a[16];
+  alignas(64) int b[16];
+  alignas(64) int c[16] = {0};
+
+  for (int i = 0; i < 16; ++i)
+  {
+    a[i] = i + 1;
+    b[i] = 2 * (i + 1);
+  }
+
+  VectorRegister<int, 512> r1(a), r2(b), r3;
+
+  r3 = r1 * r2;
+  r3 = r3 - r1;
+  r3.Store(c);
+
+  for (int i = 0; i < 16; ++i)
+  {
+    EXPECT_EQ(c[i], (i + 1) * (2 * i + 1));
+  }
+}
+
+TEST(vectorise_avx512_gtest, register_test2)
+{
+  alignas(64) float a[16];
+  alignas(64) float b[16];
+  alignas(64) float c[16] = {0};
+
+  for (int i = 0; i < 16; ++i)
+  {
+    a[i] = float(i + 1);
+    b[i] = float(1 << (i % 8));
+  }
+
+  VectorRegister<float, 512> r1(a), r2(b), r3, cst(3);
+
+  r3 = r1 * r2;
+  r3 = cst * r3 - r1;
+  r3.Store(c);
+
+  for (std::size_t i = 0; i < 16; ++i)
+  {
+    EXPECT_EQ(c[i], 3 * a[i] * b[i] - a[i]);
+  }
+
+  EXPECT_EQ(first_element(r3), c[0]);
+  EXPECT_EQ(reduce(r1), 136.0f);
+}
+
+TEST(vectorise_avx512_gtest, register_test3)
+{
+  alignas(64) double a[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  alignas(64) double b[8] = {2, 4, 8, 16, 32, 64, 128, 256};
+  alignas(64) double c[8] = {0};
+
+  VectorRegister<double, 512> r1(a), r2(b), r3, cst(3.2);
+
+  r3 = r1 * r2;
+  r3 = cst * r3 - r1;
+  r3.Store(c);
+
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    EXPECT_EQ(c[i], 3.2 * (a[i] * b[i]) - a[i]);
+  }
+
+  EXPECT_EQ(first_element(r3), c[0]);
+  EXPECT_EQ(reduce(r1), 36.0);
+}
+
+TEST(vectorise_avx512_gtest, free_functions)
+{
+  alignas(64) double a[8] = {1, -2, 3, -4, 5, -6, 7, -8};
+  alignas(64) double b[8] = {-1, 2, -3, 4, -5, 6, -7, 8};
+  alignas(64) double c[8] = {0};
+
+  VectorRegister<double, 512> r1(a), r2(b);
+
+  max(r1, r2).Store(c);
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    EXPECT_EQ(c[i], std::max(a[i], b[i]));
+  }
+
+  min(r1, r2).Store(c);
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    EXPECT_EQ(c[i], std::min(a[i], b[i]));
+  }
+
+  sqrt(abs(r1)).Store(c);
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    EXPECT_EQ(c[i], std::sqrt(std::fabs(a[i])));
+  }
+
+  (r1 < r2).Store(c);
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    EXPECT_EQ(c[i], a[i] < b[i] ? 1.0 : 0.0);
+  }
+
+  shift_elements_right(r1).Store(c);
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    EXPECT_EQ(c[i], i < 7 ? a[i + 1] : 0.0);
+  }
+
+  shift_elements_left(r1).Store(c);
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    EXPECT_EQ(c[i], i > 0 ? a[i - 1] : 0.0);
+  }
+
+  vector_zero_below_element(r1, 3).Store(c);
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    EXPECT_EQ(c[i], i >= 3 ? a[i] : 0.0);
+  }
+
+  vector_zero_above_element(r1, 3).Store(c);
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    EXPECT_EQ(c[i], i <= 3 ? a[i] : 0.0);
+  }
+
+  EXPECT_TRUE(any_less_than(r1, r2));
+  EXPECT_FALSE(all_less_than(r1, r2));
+}
+
+TEST(vectorise_avx512_gtest, approximations)
+{
+  alignas(64) float  a[16];
+  alignas(64) float  c[16];
+  alignas(64) float  expected_c[16];
+  alignas(64) double d[8];
+  alignas(64) double e[8];
+  alignas(64) double expected_e[8];
+
+  for (std::size_t i = 0; i < 16; ++i)
+  {
+    a[i] = 0.5f * float(i) - 3.0f;
+  }
+
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    d[i] = double(i) - 3.5;
+  }
+
+  // the approximations must match those of the SSE registers exactly
+  approx_exp(VectorRegister<float, 512>(a)).Store(c);
+  for (std::size_t i = 0; i < 16; i += 4)
+  {
+    approx_exp(VectorRegister<float, 128>(a + i)).Store(expected_c + i);
+  }
+
+  for (std::size_t i = 0; i < 16; ++i)
+  {
+    EXPECT_EQ(c[i], expected_c[i]);
+    EXPECT_NEAR(c[i] / std::exp(a[i]), 1.0, 0.1);
+  }
+
+  approx_log(VectorRegister<float, 512>(c)).Store(c);
+  for (std::size_t i = 0; i < 16; i += 4)
+  {
+    approx_log(VectorRegister<float, 128>(expected_c + i)).Store(expected_c + i);
+  }
+
+  for (std::size_t i = 0; i < 16; ++i)
+  {
+    EXPECT_EQ(c[i], expected_c[i]);
+    EXPECT_NEAR(c[i], a[i], 0.1);
+  }
+
+  approx_exp(VectorRegister<double, 512>(d)).Store(e);
+  for (std::size_t i = 0; i < 8; i += 2)
+  {
+    approx_exp(VectorRegister<double, 128>(d + i)).Store(expected_e + i);
+  }
+
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    EXPECT_EQ(e[i], expected_e[i]);
+    EXPECT_NEAR(e[i] / std::exp(d[i]), 1.0, 0.1);
+  }
+
+  approx_log(VectorRegister<double, 512>(e)).Store(e);
+  for (std::size_t i = 0; i < 8; i += 2)
+  {
+    approx_log(VectorRegister<double, 128>(expected_e + i)).Store(expected_e + i);
+  }
+
+  for (std::size_t i = 0; i < 8; ++i)
+  {
+    EXPECT_EQ(e[i], expected_e[i]);
+    EXPECT_NEAR(e[i], d[i], 0.1);
+  }
+}
+
+#endif
@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "vectorise/vectorise.hpp"
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+
+using namespace fetch::vectorize;
+
+TEST(vectorise_neon_gtest, register_test1)
+{
+  alignas(16) int a[4] = {1, 2, 3, 4};
+  alignas(16) int b[4] = {2, 4, 8, 16};
+  alignas(16) int c[4] = {0};
+
+  VectorRegister<int, 128> r1(a), r2(b), r3;
+
+  r3 = r1 * r2;
+  r3 = r3 - r1;
+  r3.Store(c);
+
+  EXPECT_EQ(c[0], 1);
+  EXPECT_EQ(c[1], 6);
+  EXPECT_EQ(c[2], 21);
+  EXPECT_EQ(c[3], 60);
+}
+
+TEST(vectorise_neon_gtest, register_test2)
+{
+  alignas(16) float a[4] = {1, 2, 3, 4};
+  alignas(16) float b[4] = {2, 4, 8, 16};
+  alignas(16) float c[4] = {0};
+
+  VectorRegister<float, 128> r1(a), r2(b), r3, cst(3);
+
+  r3 = r1 * r2;
+  r3 = cst * r3 - r1;
+  r3.Store(c);
+
+  EXPECT_EQ(c[0], 5);
+  EXPECT_EQ(c[1], 22);
+  EXPECT_EQ(c[2], 69);
+  EXPECT_EQ(c[3], 188);
+
+  EXPECT_EQ(first_element(r3), 5);
+  EXPECT_EQ(reduce(r1), 10);
+}
+
+TEST(vectorise_neon_gtest, register_test3)
+{
+  alignas(16) double a[2] = {1, 2};
+  alignas(16) double b[2] = {2, 4};
+  alignas(16) double c[2] = {0};
+
+  VectorRegister<double, 128> r1(a), r2(b), r3, cst(3.2);
+
+  r3 = r1 * r2;
+  r3 = cst * r3 - r1;
+  r3.Store(c);
+
+  EXPECT_EQ(c[0], 3.2 * 2 - 1);
+  EXPECT_EQ(c[1], 3.2 * 8 - 2);
+}
+
+TEST(vectorise_neon_gtest, free_functions)
+{
+  alignas(16) float a[4] = {1, -4, 9, -16};
+  alignas(16) float b[4] = {-1, 4, -9, 16};
+  alignas(16) float c[4] = {0};
+
+  VectorRegister<float, 128> r1(a), r2(b);
+
+  max(r1, r2).Store(c);
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(c[i], std::max(a[i], b[i]));
+  }
+
+  min(r1, r2).Store(c);
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(c[i], std::min(a[i], b[i]));
+  }
+
+  sqrt(abs(r1)).Store(c);
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(c[i], std::sqrt(std::fabs(a[i])));
+  }
+
+  (r1 != r2).Store(c);
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(c[i], 1.0f);
+  }
+
+  shift_elements_right(r1).Store(c);
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(c[i], i < 3 ? a[i + 1] : 0.0f);
+  }
+
+  shift_elements_left(r1).Store(c);
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(c[i], i > 0 ? a[i - 1] : 0.0f);
+  }
+
+  vector_zero_below_element(r1, 2).Store(c);
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    EXPECT_EQ(c[i], i >= 2 ? a[i] : 0.0f);
+  }
+}
+
+TEST(vectorise_neon_gtest, approximations)
+{
+  alignas(16) float  a[4] = {-2.0f, -0.5f, 1.0f, 3.0f};
+  alignas(16) float  c[4];
+  alignas(16) double d[2] = {-1.5, 2.5};
+  alignas(16) double e[2];
+
+  // the approximations are accurate to within a few percent
+  approx_exp(VectorRegister<float, 128>(a)).Store(c);
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    EXPECT_NEAR(c[i] / std::exp(a[i]), 1.0, 0.1);
+  }
+
+  approx_log(VectorRegister<float, 128>(c)).Store(c);
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    EXPECT_NEAR(c[i], a[i], 0.1);
+  }
+
+  approx_exp(VectorRegister<double, 128>(d)).Store(e);
+  for (std::size_t i = 0; i < 2; ++i)
+  {
+    EXPECT_NEAR(e[i] / std::exp(d[i]), 1.0, 0.1);
+  }
+
+  approx_log(VectorRegister<double, 128>(e)).Store(e);
+  for (std::size_t i = 0; i < 2; ++i)
+  {
+    EXPECT_NEAR(e[i], d[i], 0.1);
+  }
+}
+
+#endif
@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "vectorise/memory/array_pool.hpp"
+#include "vectorise/memory/shared_array.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+
+using namespace fetch::memory;
+
+TEST(ArrayPoolTest, block_sizes_cover_the_request)
+{
+  for (std::size_t size = 1; size < 100000; size += 37)
+  {
+    std::size_t const block = ArrayPool::BlockSize(size);
+    EXPECT_GE(block, size);
+    EXPECT_LE(block, std::max<std::size_t>(64, size + (size / 4) + 1));
+  }
+}
+
+TEST(ArrayPoolTest, freed_blocks_are_reused_for_the_same_size_class)
+{
+  ArrayPool::Trim();
+
+  void *first = ArrayPool::Allocate(1000);
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(first) % 64, 0);
+  ArrayPool::Free(first, 1000);
+  EXPECT_EQ(ArrayPool::CachedBytes(), ArrayPool::BlockSize(1000));
+
+  // a request in the same size class gets the same block back
+  void *second = ArrayPool::Allocate(1010);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(ArrayPool::CachedBytes(), 0);
+  ArrayPool::Free(second, 1010);
+
+  ArrayPool::Trim();
+  EXPECT_EQ(ArrayPool::CachedBytes(), 0);
+}
+
+TEST(ArrayPoolTest, large_blocks_are_not_cached)
+{
+  ArrayPool::Trim();
+
+  std::size_t const size  = ArrayPool::MAX_BLOCK_SIZE + 1;
+  void *            block = ArrayPool::Allocate(size);
+  ASSERT_NE(block, nullptr);
+  ArrayPool::Free(block, size);
+  EXPECT_EQ(ArrayPool::CachedBytes(), 0);
+}
+
+TEST(ArrayPoolTest, shared_arrays_return_their_memory_to_the_pool)
+{
+  ArrayPool::Trim();
+
+  uint64_t const *data = nullptr;
+  {
+    SharedArray<uint64_t> array(1000);
+    SharedArray<uint64_t> copy = array;
+    data                       = array.pointer();
+  }
+  EXPECT_GT(ArrayPool::CachedBytes(), 0);
+
+  SharedArray<uint64_t> array(1000);
+  EXPECT_EQ(array.pointer(), data);
+}
+
+TEST(ArrayPoolTest, blocks_can_be_freed_on_another_thread)
+{
+  ArrayPool::Trim();
+
+  SharedArray<double> array(500);
+  std::size_t         cached_on_thread = 0;
+
+  std::thread thread([&array, &cached_on_thread]() {
+    array            = SharedArray<double>();
+    cached_on_thread = ArrayPool::CachedBytes();
+  });
+  thread.join();
+
+  // the block went to the free lists of the other thread, which released them when it exited
+  EXPECT_GT(cached_on_thread, 0);
+  EXPECT_EQ(ArrayPool::CachedBytes(), 0);
+}
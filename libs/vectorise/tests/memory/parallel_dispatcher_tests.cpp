@@ -0,0 +1,146 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "vectorise/memory/shared_array.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace {
+
+template <typename T>
+class ParallelDispatcherTest : public ::testing::Test
+{
+};
+
+using MyTypes = ::testing::Types<float, double>;
+TYPED_TEST_CASE(ParallelDispatcherTest, MyTypes);
+
+// sizes below, at and above the size of a share, and of several shares with a partial last one
+std::vector<std::size_t> const SIZES = {0, 1, 7, 1000, 16384, 16387, 100003};
+
+template <typename T>
+fetch::memory::SharedArray<T> MakeArray(std::size_t size, std::size_t seed)
+{
+  fetch::memory::SharedArray<T> array(size);
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    array[i] = static_cast<T>(((i + seed) * 7) % 13) / T(4) - T(1.5);
+  }
+  return array;
+}
+
+template <typename T>
+double Tolerance(std::size_t size)
+{
+  return (std::is_same<T, float>::value ? 1e-5 : 1e-12) * static_cast<double>(size + 1);
+}
+
+TYPED_TEST(ParallelDispatcherTest, parallel_sum_reduce)
+{
+  using VectorRegisterType = typename fetch::memory::SharedArray<TypeParam>::VectorRegisterType;
+
+  for (std::size_t size : SIZES)
+  {
+    auto const array = MakeArray<TypeParam>(size, 1);
+
+    double expected = 0;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      expected += static_cast<double>(array[i]);
+    }
+
+    TypeParam const sum =
+        array.in_parallel().ParallelSumReduce([](VectorRegisterType const &x) { return x; });
+    EXPECT_NEAR(static_cast<double>(sum), expected, Tolerance<TypeParam>(size)) << size;
+  }
+}
+
+TYPED_TEST(ParallelDispatcherTest, parallel_sum_reduce_with_other_arrays)
+{
+  using VectorRegisterType = typename fetch::memory::SharedArray<TypeParam>::VectorRegisterType;
+
+  for (std::size_t size : SIZES)
+  {
+    auto const a = MakeArray<TypeParam>(size, 1);
+    auto const b = MakeArray<TypeParam>(size, 5);
+
+    double expected = 0;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      double const d = static_cast<double>(a[i]) - static_cast<double>(b[i]);
+      expected += d * d;
+    }
+
+    // the tail of the last share is excluded, even though (x - y)^2 is not zero for the padding
+    TypeParam const total = a.in_parallel().ParallelSumReduce(
+        [](VectorRegisterType const &x, VectorRegisterType const &y) {
+          VectorRegisterType const d = x - y;
+          return d * d + VectorRegisterType(TypeParam(1));
+        },
+        b);
+    EXPECT_NEAR(static_cast<double>(total), expected + static_cast<double>(size),
+                Tolerance<TypeParam>(size) * 10)
+        << size;
+  }
+}
+
+TYPED_TEST(ParallelDispatcherTest, parallel_reduce)
+{
+  for (std::size_t size : SIZES)
+  {
+    auto const array = MakeArray<TypeParam>(size, 3);
+
+    double expected = 0;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      expected += static_cast<double>(array[i]);
+    }
+
+    using VectorRegisterType = typename fetch::memory::SharedArray<TypeParam>::VectorRegisterType;
+    TypeParam const sum      = array.in_parallel().ParallelReduce(
+        [](VectorRegisterType const &x, VectorRegisterType const &y) { return x + y; });
+    EXPECT_NEAR(static_cast<double>(sum), expected, Tolerance<TypeParam>(size)) << size;
+  }
+}
+
+TYPED_TEST(ParallelDispatcherTest, parallel_reductions_are_deterministic)
+{
+  using VectorRegisterType = typename fetch::memory::SharedArray<TypeParam>::VectorRegisterType;
+
+  // values of very different magnitudes, whose sum depends on the order they are added in
+  fetch::memory::SharedArray<TypeParam> array(200003);
+  for (std::size_t i = 0; i < array.size(); ++i)
+  {
+    array[i] = static_cast<TypeParam>(std::pow(10.0, static_cast<double>(i % 9) - 4.0)) *
+               static_cast<TypeParam>((i % 2) == 0 ? 1 : -1);
+  }
+
+  auto const identity = [](VectorRegisterType const &x) { return x; };
+  TypeParam const first = array.in_parallel().ParallelSumReduce(identity);
+
+  for (std::size_t i = 0; i < 20; ++i)
+  {
+    EXPECT_EQ(array.in_parallel().ParallelSumReduce(identity), first);
+  }
+}
+
+}  // namespace
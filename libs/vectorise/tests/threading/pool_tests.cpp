@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "vectorise/threading/pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+using fetch::threading::Pool;
+using fetch::threading::TaskGroup;
+
+TEST(PoolTest, every_posted_task_is_run)
+{
+  Pool                     pool{4};
+  std::atomic<std::size_t> count{0};
+
+  for (std::size_t i = 0; i < 10000; ++i)
+  {
+    pool.Post([&count]() { ++count; });
+  }
+
+  pool.Wait();
+  EXPECT_EQ(count, 10000);
+  EXPECT_TRUE(pool.Empty());
+}
+
+TEST(PoolTest, pool_without_workers_runs_tasks_on_the_waiting_thread)
+{
+  Pool        pool{0};
+  std::size_t count{0};
+
+  pool.Post([&count]() { ++count; });
+  EXPECT_EQ(pool.Dispatch([]() { return 42; }).wait_for(std::chrono::seconds{0}),
+            std::future_status::timeout);
+
+  pool.Wait();
+  EXPECT_EQ(count, 1);
+}
+
+TEST(PoolTest, parallel_for_covers_the_range_in_grain_sized_pieces)
+{
+  static constexpr std::size_t BEGIN = 7;
+  static constexpr std::size_t END   = 10007;
+  static constexpr std::size_t GRAIN = 64;
+
+  Pool                                  pool{4};
+  std::vector<std::atomic<std::size_t>> visits(END);
+  for (auto &visit : visits)
+  {
+    visit = 0;
+  }
+
+  pool.ParallelFor(BEGIN, END, GRAIN, [&visits](std::size_t begin, std::size_t end) {
+    // every piece starts on a grain boundary and is no larger than the grain
+    EXPECT_EQ((begin - BEGIN) % GRAIN, 0);
+    EXPECT_LE(end - begin, GRAIN);
+
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      ++visits[i];
+    }
+  });
+
+  for (std::size_t i = 0; i < END; ++i)
+  {
+    ASSERT_EQ(visits[i], (i < BEGIN) ? 0 : 1);
+  }
+}
+
+TEST(PoolTest, nested_parallel_loops_do_not_exhaust_the_workers)
+{
+  // far more outer pieces than workers, each of which waits on an inner loop
+  Pool                     pool{2};
+  std::atomic<std::size_t> count{0};
+
+  pool.ParallelFor(0, 64, 1, [&pool, &count](std::size_t, std::size_t) {
+    pool.ParallelFor(0, 100, 10, [&count](std::size_t begin, std::size_t end) {
+      count += end - begin;
+    });
+  });
+
+  EXPECT_EQ(count, 6400);
+}
+
+TEST(PoolTest, task_group_reports_the_first_error_after_all_tasks_complete)
+{
+  Pool                     pool{4};
+  std::atomic<std::size_t> completed{0};
+
+  TaskGroup group{pool};
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    group.Run([&completed, i]() {
+      ++completed;
+      if (i == 50)
+      {
+        throw std::runtime_error("failed");
+      }
+    });
+  }
+
+  EXPECT_THROW(group.Wait(), std::runtime_error);
+  EXPECT_EQ(completed, 100);
+
+  // the error is only reported once
+  EXPECT_NO_THROW(group.Wait());
+}
@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "vectorise/math/transcendental.hpp"
+#include "vectorise/memory/range.hpp"
+#include "vectorise/memory/shared_array.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+using fetch::vectorize::Accuracy;
+
+template <typename T>
+class TranscendentalTest : public ::testing::Test
+{
+public:
+  using ArrayType    = fetch::memory::SharedArray<T>;
+  using RegisterType = typename ArrayType::VectorRegisterType;
+
+  static ArrayType Exp(ArrayType const &x, Accuracy accuracy)
+  {
+    ArrayType ret(x.size());
+    ret.in_parallel().Apply(fetch::memory::TrivialRange(0, x.size()),
+                            [accuracy](RegisterType const &a, RegisterType &b) {
+                              b = fetch::vectorize::polynomial_exp(a, accuracy);
+                            },
+                            x);
+    return ret;
+  }
+
+  static ArrayType Log(ArrayType const &x, Accuracy accuracy)
+  {
+    ArrayType ret(x.size());
+    ret.in_parallel().Apply(fetch::memory::TrivialRange(0, x.size()),
+                            [accuracy](RegisterType const &a, RegisterType &b) {
+                              b = fetch::vectorize::polynomial_log(a, accuracy);
+                            },
+                            x);
+    return ret;
+  }
+
+  static double Tolerance(Accuracy accuracy)
+  {
+    switch (accuracy)
+    {
+    case Accuracy::APPROXIMATE:
+      return 1e-3;
+    case Accuracy::FAST:
+      return 1e-5;
+    case Accuracy::PRECISE:
+      break;
+    }
+
+    return 4 * static_cast<double>(std::numeric_limits<T>::epsilon());
+  }
+};
+
+using FloatingTypes = ::testing::Types<float, double>;
+TYPED_TEST_CASE(TranscendentalTest, FloatingTypes);
+
+TYPED_TEST(TranscendentalTest, exp_relative_error_is_bounded)
+{
+  using ArrayType = typename TestFixture::ArrayType;
+
+  std::size_t const N = 2001;
+  ArrayType         x(N);
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    x[i] = static_cast<TypeParam>(-80.0 + (0.08 * static_cast<double>(i)));
+  }
+
+  for (auto accuracy : {Accuracy::APPROXIMATE, Accuracy::FAST, Accuracy::PRECISE})
+  {
+    ArrayType const ret = TestFixture::Exp(x, accuracy);
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      double const expected = std::exp(static_cast<double>(x[i]));
+      EXPECT_LE(std::fabs(static_cast<double>(ret[i]) - expected) / expected,
+                TestFixture::Tolerance(accuracy))
+          << "at " << x[i];
+    }
+  }
+}
+
+TYPED_TEST(TranscendentalTest, log_relative_error_is_bounded)
+{
+  using ArrayType = typename TestFixture::ArrayType;
+
+  std::size_t const N = 2001;
+  ArrayType         x(N);
+  for (std::size_t i = 0; i < N; ++i)
+  {
+    x[i] = static_cast<TypeParam>(std::exp(-30.0 + (0.03 * static_cast<double>(i))));
+  }
+
+  for (auto accuracy : {Accuracy::APPROXIMATE, Accuracy::FAST, Accuracy::PRECISE})
+  {
+    ArrayType const ret = TestFixture::Log(x, accuracy);
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      double const expected = std::log(static_cast<double>(x[i]));
+      double const error    = std::fabs(static_cast<double>(ret[i]) - expected);
+
+      // close to one the logarithm itself vanishes, so the error is taken as absolute there
+      EXPECT_LE(error / std::max(std::fabs(expected), 1.0), TestFixture::Tolerance(accuracy))
+          << "at " << x[i];
+    }
+  }
+}
+
+TYPED_TEST(TranscendentalTest, special_values)
+{
+  using ArrayType = typename TestFixture::ArrayType;
+
+  TypeParam const infinity = std::numeric_limits<TypeParam>::infinity();
+  TypeParam const nan      = std::numeric_limits<TypeParam>::quiet_NaN();
+  TypeParam const denormal = std::numeric_limits<TypeParam>::denorm_min();
+
+  ArrayType x(8);
+  x[0] = TypeParam{0};
+  x[1] = TypeParam{-1};
+  x[2] = infinity;
+  x[3] = -infinity;
+  x[4] = nan;
+  x[5] = TypeParam{1};
+  x[6] = denormal;
+  x[7] = TypeParam{1000};
+
+  ArrayType const exp = TestFixture::Exp(x, Accuracy::PRECISE);
+  EXPECT_EQ(exp[0], TypeParam{1});
+  EXPECT_NEAR(exp[1], std::exp(TypeParam{-1}), TestFixture::Tolerance(Accuracy::PRECISE));
+  EXPECT_EQ(exp[2], infinity);
+  EXPECT_EQ(exp[3], TypeParam{0});
+  EXPECT_TRUE(std::isnan(exp[4]));
+  EXPECT_EQ(exp[7], infinity);
+
+  ArrayType const log = TestFixture::Log(x, Accuracy::PRECISE);
+  EXPECT_EQ(log[0], -infinity);
+  EXPECT_TRUE(std::isnan(log[1]));
+  EXPECT_EQ(log[2], infinity);
+  EXPECT_TRUE(std::isnan(log[3]));
+  EXPECT_TRUE(std::isnan(log[4]));
+  EXPECT_EQ(log[5], TypeParam{0});
+  EXPECT_NEAR(log[6], std::log(denormal), std::fabs(std::log(denormal)) * 1e-6);
+}
@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "benchmark/benchmark.h"
+#include "vm/lexer.hpp"
+
+// Must define YYSTYPE and YY_EXTRA_TYPE *before* including the flex-generated header
+#define YYSTYPE fetch::vm::Token
+#define YY_EXTRA_TYPE fetch::vm::Location *
+#include "vm/tokeniser.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+using fetch::vm::Token;
+using Tokens = std::vector<Token>;
+
+// A token contract in the style of those deployed on the ledger, mixing annotations, comments,
+// state access, numeric literals of the different widths and string literals
+char const *CONTRACT = R"(
+/*
+ * Simple fungible token
+ */
+@init
+function setup(owner : Address)
+  var supply = State<UInt64>("total_supply", 1000000000u64);
+  var balance = State<UInt64>(owner, 0u64);
+  balance.set(supply.get());
+endfunction
+
+// move funds between two accounts, failing if the sender cannot cover the amount
+@action
+function transfer(from : Address, to : Address, amount : UInt64)
+  var from_balance = State<UInt64>(from, 0u64);
+  var to_balance = State<UInt64>(to, 0u64);
+  if (from_balance.get() < amount)
+    return;
+  endif
+  from_balance.set(from_balance.get() - amount);
+  to_balance.set(to_balance.get() + amount);
+endfunction
+
+@query
+function balance(address : Address) : UInt64
+  var state = State<UInt64>(address, 0u64);
+  return state.get();
+endfunction
+
+function fees(amounts : Array<Float64>, rate : Float64) : Float64
+  var total = 0.0;
+  for (i in 0:amounts.count() - 1)
+    total += amounts[i] * rate + 1.5e-3;
+  endfor
+  var message : String = "total fees: " + toString(total);
+  Print(message);
+  return total;
+endfunction
+)";
+
+std::string Corpus(int64_t copies)
+{
+  std::string corpus;
+  for (int64_t i = 0; i < copies; ++i)
+  {
+    corpus += CONTRACT;
+  }
+  return corpus;
+}
+
+void GeneratedTokenise(std::string const &source, Tokens &tokens)
+{
+  tokens.clear();
+  fetch::vm::Location location;
+  yyscan_t            scanner;
+  yylex_init_extra(&location, &scanner);
+  YY_BUFFER_STATE bp = yy_scan_string(source.data(), scanner);
+  yy_switch_to_buffer(bp, scanner);
+  Token token;
+  do
+  {
+    yylex(&token, scanner);
+    tokens.push_back(token);
+  } while (token.kind != Token::Kind::EndOfInput);
+  yy_delete_buffer(bp, scanner);
+  yylex_destroy(scanner);
+}
+
+void BM_GeneratedTokeniser(benchmark::State &state)
+{
+  std::string const source = Corpus(state.range(0));
+  Tokens            tokens;
+  for (auto _ : state)
+  {
+    GeneratedTokenise(source, tokens);
+    benchmark::DoNotOptimize(tokens.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(source.size()));
+}
+BENCHMARK(BM_GeneratedTokeniser)->RangeMultiplier(4)->Range(1, 256);
+
+void BM_Lexer(benchmark::State &state)
+{
+  std::string const source = Corpus(state.range(0));
+  Tokens            tokens;
+  fetch::vm::Lexer  lexer;
+  for (auto _ : state)
+  {
+    lexer.Tokenise(source, tokens);
+    benchmark::DoNotOptimize(tokens.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(source.size()));
+}
+BENCHMARK(BM_Lexer)->RangeMultiplier(4)->Range(1, 256);
+
+}  // namespace
+
+BENCHMARK_MAIN();
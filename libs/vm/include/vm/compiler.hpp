@@ -19,6 +19,7 @@
 
 #include "vm/analyser.hpp"
 #include "vm/generator.hpp"
+#include "vm/optimiser.hpp"
 #include "vm/parser.hpp"
 
 namespace fetch {
@@ -34,6 +35,20 @@ public:
   ~Compiler();
   bool Compile(std::string const &source, std::string const &name, Script &script, Strings &errors);
 
+  /// @name Optimisation
+  /// @{
+  void SetOptimisation(bool enable)
+  {
+    optimise_ = enable;
+  }
+
+  /// The instructions saved by the optimiser on the most recent successful compilation
+  Optimiser::Report const &optimiser_report() const
+  {
+    return optimiser_report_;
+  }
+  /// @}
+
 private:
   void CreateClassType(std::string const &name, TypeId id)
   {
@@ -82,9 +97,12 @@ private:
     analyser_.EnableIndexOperator(type_id, input_type_ids, output_type_id);
   }
 
-  Parser    parser_;
-  Analyser  analyser_;
-  Generator generator_;
+  Parser            parser_;
+  Analyser          analyser_;
+  Generator         generator_;
+  Optimiser         optimiser_;
+  Optimiser::Report optimiser_report_;
+  bool              optimise_{true};
 
   friend class Module;
 };
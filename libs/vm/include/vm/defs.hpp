@@ -19,6 +19,7 @@
 
 #include "meta/type_util.hpp"
 #include "vm/common.hpp"
+#include "vm/object_arena.hpp"
 #include <cmath>
 
 namespace fetch {
@@ -182,6 +183,17 @@ public:
     ref_count_ = 1;
   }
 
+  // objects are pooled in the arena of the executing VM (see ObjectArena)
+  static void *operator new(std::size_t size)
+  {
+    return ObjectArena::Allocate(size);
+  }
+
+  static void operator delete(void *ptr) noexcept
+  {
+    ObjectArena::Deallocate(ptr);
+  }
+
   virtual size_t GetHashCode();
   virtual bool   IsEqual(Ptr<Object> const &lhso, Ptr<Object> const &rhso);
   virtual bool   IsNotEqual(Ptr<Object> const &lhso, Ptr<Object> const &rhso);
@@ -0,0 +1,229 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fetch {
+namespace vm {
+
+/**
+ * An open addressing hash map for keys of primitive types, used by the VM maps.
+ *
+ * The first SMALL_CAPACITY entries are held inline and found with a linear scan, which avoids any
+ * allocation and hashing for the small maps which are typical of contract code. Larger maps move
+ * to a power of two sized table of slots with linear probing, so that a lookup touches a few
+ * adjacent slots instead of chasing the nodes of a chained hash table.
+ *
+ * Entries are never removed, so the references to the values stay valid until the next insertion.
+ *
+ * @tparam Key The key type, which must be trivially copyable
+ * @tparam Value The value type, which must be default constructible
+ */
+template <typename Key, typename Value>
+class FlatMap
+{
+public:
+  static_assert(std::is_trivially_copyable<Key>::value, "the keys must be trivially copyable");
+
+  static constexpr std::size_t SMALL_CAPACITY = 8;
+
+  std::size_t size() const
+  {
+    return size_;
+  }
+
+  bool empty() const
+  {
+    return size_ == 0;
+  }
+
+  /**
+   * Look up the value of a key
+   *
+   * @param key The key to be found
+   * @return A pointer to the value, or nullptr if the key is not present
+   */
+  Value *Find(Key const &key)
+  {
+    if (table_.empty())
+    {
+      for (std::size_t i = 0; i < size_; ++i)
+      {
+        if (small_[i].key == key)
+        {
+          return &small_[i].value;
+        }
+      }
+      return nullptr;
+    }
+
+    for (std::size_t index = Index(key);; index = (index + 1) & mask_)
+    {
+      Slot &slot = table_[index];
+      if (!slot.used)
+      {
+        return nullptr;
+      }
+      if (slot.key == key)
+      {
+        return &slot.value;
+      }
+    }
+  }
+
+  Value const *Find(Key const &key) const
+  {
+    return const_cast<FlatMap *>(this)->Find(key);
+  }
+
+  /**
+   * Look up the value of a key, inserting a default constructed value if it is not present
+   *
+   * @param key The key to be found
+   * @return The value of the key
+   */
+  Value &operator[](Key const &key)
+  {
+    Value *value = Find(key);
+    if (value != nullptr)
+    {
+      return *value;
+    }
+
+    if (table_.empty())
+    {
+      if (size_ < SMALL_CAPACITY)
+      {
+        Slot &slot = small_[size_++];
+        slot.key   = key;
+        return slot.value;
+      }
+      Rehash(MIN_TABLE_SIZE);
+    }
+    else if (((size_ + 1) * MAX_LOAD_DENOMINATOR) > (table_.size() * MAX_LOAD_NUMERATOR))
+    {
+      Rehash(table_.size() * 2);
+    }
+
+    ++size_;
+    return Insert(key).value;
+  }
+
+private:
+  static constexpr std::size_t MIN_TABLE_SIZE = 2 * SMALL_CAPACITY;
+
+  // the table grows once it would be more than three quarters full
+  static constexpr std::size_t MAX_LOAD_NUMERATOR   = 3;
+  static constexpr std::size_t MAX_LOAD_DENOMINATOR = 4;
+
+  static constexpr uint64_t GOLDEN_RATIO = 0x9E3779B97F4A7C15ull;
+
+  struct Slot
+  {
+    Key   key{};
+    Value value{};
+    bool  used{false};
+  };
+
+  using SmallSlots = std::array<Slot, SMALL_CAPACITY>;
+  using Slots      = std::vector<Slot>;
+
+  /**
+   * The first slot to probe for a key. The hash is spread over the table with a Fibonacci multiply
+   * so that regular keys (like consecutive integers) do not end up in the same run of slots.
+   */
+  std::size_t Index(Key const &key) const
+  {
+    auto const hash = static_cast<uint64_t>(std::hash<Key>{}(key));
+    return static_cast<std::size_t>((hash * GOLDEN_RATIO) >> shift_);
+  }
+
+  /// Claim the slot for a key which is known not to be present
+  Slot &Insert(Key const &key)
+  {
+    std::size_t index = Index(key);
+    while (table_[index].used)
+    {
+      index = (index + 1) & mask_;
+    }
+
+    Slot &slot = table_[index];
+    slot.key   = key;
+    slot.used  = true;
+    return slot;
+  }
+
+  void Rehash(std::size_t table_size)
+  {
+    Slots previous(table_size);
+    std::swap(table_, previous);
+    mask_  = table_size - 1;
+    shift_ = 64;
+    for (std::size_t size = table_size; size > 1; size >>= 1)
+    {
+      --shift_;
+    }
+
+    if (previous.empty())
+    {
+      // moving out of the inline storage
+      for (std::size_t i = 0; i < size_; ++i)
+      {
+        Insert(small_[i].key).value = std::move(small_[i].value);
+        small_[i].value             = Value{};
+      }
+    }
+    else
+    {
+      for (auto &slot : previous)
+      {
+        if (slot.used)
+        {
+          Insert(slot.key).value = std::move(slot.value);
+        }
+      }
+    }
+  }
+
+  SmallSlots  small_{};
+  Slots       table_;
+  std::size_t size_{0};
+  std::size_t mask_{0};
+  uint32_t    shift_{64};
+};
+
+template <typename Key, typename Value>
+constexpr std::size_t FlatMap<Key, Value>::SMALL_CAPACITY;
+template <typename Key, typename Value>
+constexpr std::size_t FlatMap<Key, Value>::MIN_TABLE_SIZE;
+template <typename Key, typename Value>
+constexpr std::size_t FlatMap<Key, Value>::MAX_LOAD_NUMERATOR;
+template <typename Key, typename Value>
+constexpr std::size_t FlatMap<Key, Value>::MAX_LOAD_DENOMINATOR;
+template <typename Key, typename Value>
+constexpr uint64_t FlatMap<Key, Value>::GOLDEN_RATIO;
+
+}  // namespace vm
+}  // namespace fetch
@@ -17,6 +17,9 @@
 //
 //------------------------------------------------------------------------------
 
+#include "core/byte_array/byte_array.hpp"
+#include "core/byte_array/const_byte_array.hpp"
+
 #include <cstdint>
 #include <string>
 
@@ -29,6 +32,8 @@ namespace vm {
 class IoObserverInterface
 {
 public:
+  using ConstByteArray = byte_array::ConstByteArray;
+
   // Construction / Destruction
   IoObserverInterface()          = default;
   virtual ~IoObserverInterface() = default;
@@ -77,7 +82,74 @@ public:
   virtual Status Exists(std::string const &key) = 0;
 
   /// @}
+
+  /// @name Buffer View Interface
+  /// @{
+
+  /**
+   * Get a view of a value in the state store. Implementations which already hold the value in
+   * a shared buffer can return it directly, rather than copying it into a caller provided buffer.
+   *
+   * @param key The key to be accessed
+   * @param value The view to be populated, which is never modified by the observer afterwards
+   * @return OK if the read was successful, PERMISSION_DENIED if the key is incorrect, otherwise
+   * ERROR
+   */
+  virtual Status ReadView(std::string const &key, ConstByteArray &value);
+
+  /**
+   * Write a value to the state store. Since the buffer is immutable implementations are free to
+   * keep a reference to it, rather than copying it.
+   *
+   * @param key The key to be accessed
+   * @param value The value to be written
+   * @return OK if the write was successful, PERMISSION_DENIED if the key is incorrect, otherwise
+   * ERROR
+   */
+  virtual Status WriteView(std::string const &key, ConstByteArray const &value);
+
+  /// @}
+
+private:
+  static constexpr uint64_t INITIAL_VIEW_SIZE = 64;
 };
 
+/**
+ * The fallback for observers which only implement the basic interface, reads the value through a
+ * temporary buffer
+ */
+inline IoObserverInterface::Status IoObserverInterface::ReadView(std::string const &key,
+                                                                 ConstByteArray &   value)
+{
+  byte_array::ByteArray buffer;
+  buffer.Resize(std::size_t{INITIAL_VIEW_SIZE});
+
+  uint64_t size   = buffer.size();
+  Status   status = Read(key, buffer.pointer(), size);
+
+  if (Status::BUFFER_TOO_SMALL == status)
+  {
+    buffer.Resize(size);
+    status = Read(key, buffer.pointer(), size);
+  }
+
+  if (Status::OK == status)
+  {
+    buffer.Resize(size);
+    value = buffer;
+  }
+
+  return status;
+}
+
+/**
+ * The fallback for observers which only implement the basic interface
+ */
+inline IoObserverInterface::Status IoObserverInterface::WriteView(std::string const &   key,
+                                                                  ConstByteArray const &value)
+{
+  return Write(key, value.pointer(), value.size());
+}
+
 }  // namespace vm
 }  // namespace fetch
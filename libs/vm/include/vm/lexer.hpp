@@ -0,0 +1,66 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "vm/token.hpp"
+
+#include <string>
+#include <vector>
+
+namespace fetch {
+namespace vm {
+
+/**
+ * Hand written lexer for the scripting language.
+ *
+ * Every character is classified through a single lookup table, which selects the scanning routine
+ * for the token that it starts. The runs of whitespace, identifier characters and comments are
+ * skipped sixteen bytes at a time where SSE2 is available.
+ *
+ * The tokens produced are identical to those of the flex generated tokeniser (see
+ * scripts/tokeniser.l), apart from a "//" comment on the last line of the input: it is skipped,
+ * where the generated tokeniser required the comment to end in a newline.
+ */
+class Lexer
+{
+public:
+  using Tokens = std::vector<Token>;
+
+  void Tokenise(std::string const &source, Tokens &tokens);
+
+private:
+  using Kind = Token::Kind;
+
+  char const *ScanNumber(char const *p);
+  char const *ScanString(char const *p);
+  char const *ScanIdentifier(char const *p, Kind kind);
+  char const *ScanOperator(char const *p);
+  char const *SkipBlockComment(char const *p);
+  char const *SkipLineComment(char const *p);
+
+  char const *Emit(Kind kind, char const *end);
+
+  char const *begin_{nullptr};
+  char const *end_{nullptr};
+  char const *start_{nullptr};  ///< The start of the current token
+  uint16_t    line_{1};
+  Tokens *    tokens_{nullptr};
+};
+
+}  // namespace vm
+}  // namespace fetch
@@ -17,8 +17,11 @@
 //
 //------------------------------------------------------------------------------
 
+#include "vm/flat_map.hpp"
 #include "vm/vm.hpp"
 
+#include <unordered_map>
+
 namespace fetch {
 namespace vm {
 
@@ -74,10 +77,47 @@ struct E<T, typename std::enable_if_t<IsPtr<T>::value>>
   }
 };
 
+/**
+ * The container of the entries of a map, selected by the type of the keys. The primitive keys are
+ * held directly in an open addressing map, while the object keys are hashed and compared through
+ * the objects.
+ */
+template <typename Key, typename = void>
+struct MapContainer
+{
+  using Type = std::unordered_map<Variant, Variant, H<Key>, E<Key>>;
+
+  static Variant *Find(Type &map, Variant const &keyv)
+  {
+    auto it = map.find(keyv);
+    return (it != map.end()) ? &(it->second) : nullptr;
+  }
+
+  static Variant &Get(Type &map, Variant const &keyv)
+  {
+    return map[keyv];
+  }
+};
+template <typename Key>
+struct MapContainer<Key, IfIsPrimitive<Key>>
+{
+  using Type = FlatMap<Key, Variant>;
+
+  static Variant *Find(Type &map, Variant const &keyv)
+  {
+    return map.Find(keyv.primitive.Get<Key>());
+  }
+
+  static Variant &Get(Type &map, Variant const &keyv)
+  {
+    return map[keyv.primitive.Get<Key>()];
+  }
+};
+
 template <typename Key, typename Value>
 struct Map : public IMap
 {
-  using Pair = std::pair<Variant, Variant>;
+  using Container = MapContainer<Key>;
 
   Map(VM *vm, TypeId type_id)
     : IMap(vm, type_id)
@@ -91,11 +131,11 @@ struct Map : public IMap
 
   Value *Find(Variant &keyv)
   {
-    auto it = map.find(keyv);
-    if (it != map.end())
+    Variant *value = Container::Find(map, keyv);
+    if (value != nullptr)
     {
       keyv.Reset();
-      void *ptr = &(it->second);
+      void *ptr = value;
       return static_cast<Value *>(ptr);
     }
     RuntimeError("map key does not exist");
@@ -139,7 +179,7 @@ struct Map : public IMap
   template <typename U>
   IfIsPrimitive<U> Store(Variant &keyv, Variant &valuev)
   {
-    map.insert(Pair(keyv, valuev));
+    Container::Get(map, keyv) = std::move(valuev);
   }
 
   template <typename U>
@@ -147,7 +187,7 @@ struct Map : public IMap
   {
     if (keyv.object)
     {
-      map.insert(Pair(keyv, valuev));
+      Container::Get(map, keyv) = std::move(valuev);
       return;
     }
     RuntimeError("map key is null reference");
@@ -162,7 +202,7 @@ struct Map : public IMap
     keyv.Reset();
   }
 
-  std::unordered_map<Variant, Variant, H<Key>, E<Key>> map;
+  typename Container::Type map;
 };
 
 template <typename Key, template <typename, typename> class Container = Map>
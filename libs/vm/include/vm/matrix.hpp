@@ -21,6 +21,9 @@
 #include "math/tensor.hpp"
 #include "vm/vm.hpp"
 
+#include <algorithm>
+#include <vector>
+
 namespace fetch {
 namespace vm {
 
@@ -31,21 +34,34 @@ public:
   virtual ~IMatrix() = default;
   static Ptr<IMatrix> Constructor(VM *vm, TypeId type_id, int32_t rows, int32_t columns);
 
+  virtual int32_t      Rows() const      = 0;
+  virtual int32_t      Columns() const   = 0;
+  virtual Ptr<IMatrix> Transpose() const = 0;
+
 protected:
   IMatrix(VM *vm, TypeId type_id)
     : Object(vm, type_id)
   {}
 };
 
+/**
+ * The VM matrix type. The elements are held column major in a math::Tensor, so the elementwise
+ * operations run over the storage a whole SIMD register at a time, and the inner loops of the
+ * matrix product and the transpose walk contiguous columns.
+ */
 template <typename T>
 struct Matrix : public IMatrix
 {
+  using TensorType         = fetch::math::Tensor<T>;
+  using SizeType           = typename TensorType::SizeType;
+  using VectorRegisterType = typename TensorType::VectorRegisterType;
+
   Matrix()          = delete;
   virtual ~Matrix() = default;
 
   Matrix(VM *vm, TypeId type_id, size_t rows, size_t columns)
     : IMatrix(vm, type_id)
-    , matrix(std::vector<typename fetch::math::Tensor<T>::SizeType>(columns, rows))
+    , matrix(std::vector<SizeType>{rows, columns})
   {}
 
   static Ptr<Matrix> AcquireMatrix(VM *vm, TypeId type_id, size_t rows, size_t columns)
@@ -53,51 +69,62 @@ struct Matrix : public IMatrix
     return Ptr<Matrix>(new Matrix(vm, type_id, rows, columns));
   }
 
+  virtual int32_t Rows() const override
+  {
+    return static_cast<int32_t>(rows());
+  }
+
+  virtual int32_t Columns() const override
+  {
+    return static_cast<int32_t>(columns());
+  }
+
+  virtual Ptr<IMatrix> Transpose() const override
+  {
+    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, columns(), rows());
+    Transpose(matrix, m->matrix);
+    return m;
+  }
+
   virtual void RightAdd(Variant &lhsv, Variant &rhsv) override
   {
-    bool const   lhs_matrix_is_modifiable = lhsv.object.RefCount() == 1;
-    Ptr<Matrix>  lhs                      = lhsv.object;
-    T            rhs                      = rhsv.primitive.Get<T>();
-    size_t const lhs_rows                 = lhs->matrix.shape()[0];
-    size_t const lhs_columns              = lhs->matrix.shape()[1];
+    bool const  lhs_matrix_is_modifiable = lhsv.object.RefCount() == 1;
+    Ptr<Matrix> lhs                      = lhsv.object;
+    T           rhs                      = rhsv.primitive.Get<T>();
     if (lhs_matrix_is_modifiable)
     {
-      lhs->matrix.InlineAdd(rhs);
+      Add(lhs->matrix, rhs, lhs->matrix);
       return;
     }
-    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, lhs_rows, lhs_columns);
-    fetch::math::Add(lhs->matrix, rhs, m->matrix);
+    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, lhs->rows(), lhs->columns());
+    Add(lhs->matrix, rhs, m->matrix);
     lhsv.Assign(std::move(m), lhsv.type_id);
   }
 
   virtual void Add(Ptr<Object> &lhso, Ptr<Object> &rhso) override
   {
-    bool const   lhs_matrix_is_modifiable = lhso.RefCount() == 1;
-    bool const   rhs_matrix_is_modifiable = rhso.RefCount() == 1;
-    Ptr<Matrix>  lhs                      = lhso;
-    Ptr<Matrix>  rhs                      = rhso;
-    size_t const lhs_rows                 = lhs->matrix.shape()[0];
-    size_t const lhs_columns              = lhs->matrix.shape()[1];
-    size_t const rhs_rows                 = rhs->matrix.shape()[0];
-    size_t const rhs_columns              = rhs->matrix.shape()[1];
-    if ((lhs_rows != rhs_rows) || (lhs_columns != rhs_columns))
+    bool const  lhs_matrix_is_modifiable = lhso.RefCount() == 1;
+    bool const  rhs_matrix_is_modifiable = rhso.RefCount() == 1;
+    Ptr<Matrix> lhs                      = lhso;
+    Ptr<Matrix> rhs                      = rhso;
+    if (!SameShape(*lhs, *rhs))
     {
       RuntimeError("invalid operation");
       return;
     }
     if (lhs_matrix_is_modifiable)
     {
-      lhs->matrix.InlineAdd(rhs->matrix);
+      Add(lhs->matrix, rhs->matrix, lhs->matrix);
       return;
     }
     if (rhs_matrix_is_modifiable)
     {
-      rhs->matrix.InlineAdd(lhs->matrix);
+      Add(lhs->matrix, rhs->matrix, rhs->matrix);
       lhso = std::move(rhs);
       return;
     }
-    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, lhs_rows, lhs_columns);
-    fetch::math::Add(lhs->matrix, rhs->matrix, m->matrix);
+    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, lhs->rows(), lhs->columns());
+    Add(lhs->matrix, rhs->matrix, m->matrix);
     lhso = std::move(m);
   }
 
@@ -105,70 +132,60 @@ struct Matrix : public IMatrix
   {
     Ptr<Matrix> lhs = lhso;
     T           rhs = rhsv.primitive.Get<T>();
-    lhs->matrix.InlineAdd(rhs);
+    Add(lhs->matrix, rhs, lhs->matrix);
   }
 
   virtual void AddAssign(Ptr<Object> &lhso, Ptr<Object> &rhso) override
   {
-    Ptr<Matrix>  lhs         = lhso;
-    Ptr<Matrix>  rhs         = rhso;
-    size_t const lhs_rows    = lhs->matrix.shape()[0];
-    size_t const lhs_columns = lhs->matrix.shape()[1];
-    size_t const rhs_rows    = rhs->matrix.shape()[0];
-    size_t const rhs_columns = rhs->matrix.shape()[1];
-    if ((lhs_rows != rhs_rows) || (lhs_columns != rhs_columns))
+    Ptr<Matrix> lhs = lhso;
+    Ptr<Matrix> rhs = rhso;
+    if (!SameShape(*lhs, *rhs))
     {
       RuntimeError("invalid operation");
       return;
     }
-    lhs->matrix.InlineAdd(rhs->matrix);
+    Add(lhs->matrix, rhs->matrix, lhs->matrix);
   }
 
   virtual void RightSubtract(Variant &lhsv, Variant &rhsv) override
   {
-    bool const   lhs_matrix_is_modifiable = lhsv.object.RefCount() == 1;
-    Ptr<Matrix>  lhs                      = lhsv.object;
-    T            rhs                      = rhsv.primitive.Get<T>();
-    size_t const lhs_rows                 = lhs->matrix.shape()[0];
-    size_t const lhs_columns              = lhs->matrix.shape()[1];
+    bool const  lhs_matrix_is_modifiable = lhsv.object.RefCount() == 1;
+    Ptr<Matrix> lhs                      = lhsv.object;
+    T           rhs                      = rhsv.primitive.Get<T>();
     if (lhs_matrix_is_modifiable)
     {
-      lhs->matrix.InlineSubtract(rhs);
+      Subtract(lhs->matrix, rhs, lhs->matrix);
       return;
     }
-    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, lhs_rows, lhs_columns);
-    fetch::math::Subtract(lhs->matrix, rhs, m->matrix);
+    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, lhs->rows(), lhs->columns());
+    Subtract(lhs->matrix, rhs, m->matrix);
     lhsv.Assign(std::move(m), lhsv.type_id);
   }
 
   virtual void Subtract(Ptr<Object> &lhso, Ptr<Object> &rhso) override
   {
-    bool const   lhs_matrix_is_modifiable = lhso.RefCount() == 1;
-    bool const   rhs_matrix_is_modifiable = rhso.RefCount() == 1;
-    Ptr<Matrix>  lhs                      = lhso;
-    Ptr<Matrix>  rhs                      = rhso;
-    size_t const lhs_rows                 = lhs->matrix.shape()[0];
-    size_t const lhs_columns              = lhs->matrix.shape()[1];
-    size_t const rhs_rows                 = rhs->matrix.shape()[0];
-    size_t const rhs_columns              = rhs->matrix.shape()[1];
-    if ((lhs_rows != rhs_rows) || (lhs_columns != rhs_columns))
+    bool const  lhs_matrix_is_modifiable = lhso.RefCount() == 1;
+    bool const  rhs_matrix_is_modifiable = rhso.RefCount() == 1;
+    Ptr<Matrix> lhs                      = lhso;
+    Ptr<Matrix> rhs                      = rhso;
+    if (!SameShape(*lhs, *rhs))
     {
       RuntimeError("invalid operation");
       return;
     }
     if (lhs_matrix_is_modifiable)
     {
-      lhs->matrix.InlineSubtract(rhs->matrix);
+      Subtract(lhs->matrix, rhs->matrix, lhs->matrix);
       return;
     }
     if (rhs_matrix_is_modifiable)
     {
-      rhs->matrix.InlineReverseSubtract(lhs->matrix);
+      Subtract(lhs->matrix, rhs->matrix, rhs->matrix);
       lhso = std::move(rhs);
       return;
     }
-    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, lhs_rows, lhs_columns);
-    fetch::math::Subtract(lhs->matrix, rhs->matrix, m->matrix);
+    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, lhs->rows(), lhs->columns());
+    Subtract(lhs->matrix, rhs->matrix, m->matrix);
     lhso = std::move(m);
   }
 
@@ -176,76 +193,63 @@ struct Matrix : public IMatrix
   {
     Ptr<Matrix> lhs = lhso;
     T           rhs = rhsv.primitive.Get<T>();
-    lhs->matrix.InlineSubtract(rhs);
+    Subtract(lhs->matrix, rhs, lhs->matrix);
   }
 
   virtual void SubtractAssign(Ptr<Object> &lhso, Ptr<Object> &rhso) override
   {
-    Ptr<Matrix>  lhs         = lhso;
-    Ptr<Matrix>  rhs         = rhso;
-    size_t const lhs_rows    = lhs->matrix.shape()[0];
-    size_t const lhs_columns = lhs->matrix.shape()[1];
-    size_t const rhs_rows    = rhs->matrix.shape()[0];
-    size_t const rhs_columns = rhs->matrix.shape()[1];
-    if ((lhs_rows != rhs_rows) || (lhs_columns != rhs_columns))
+    Ptr<Matrix> lhs = lhso;
+    Ptr<Matrix> rhs = rhso;
+    if (!SameShape(*lhs, *rhs))
     {
       RuntimeError("invalid operation");
       return;
     }
-    lhs->matrix.InlineSubtract(rhs->matrix);
+    Subtract(lhs->matrix, rhs->matrix, lhs->matrix);
   }
 
   virtual void LeftMultiply(Variant &lhsv, Variant &rhsv) override
   {
-    bool const   rhs_matrix_is_modifiable = rhsv.object.RefCount() == 1;
-    T            lhs                      = lhsv.primitive.Get<T>();
-    Ptr<Matrix>  rhs                      = rhsv.object;
-    size_t const rhs_rows                 = rhs->matrix.shape()[0];
-    size_t const rhs_columns              = rhs->matrix.shape()[1];
+    bool const  rhs_matrix_is_modifiable = rhsv.object.RefCount() == 1;
+    T           lhs                      = lhsv.primitive.Get<T>();
+    Ptr<Matrix> rhs                      = rhsv.object;
     if (rhs_matrix_is_modifiable)
     {
-      rhs->matrix.InlineMultiply(lhs);
+      Multiply(rhs->matrix, lhs, rhs->matrix);
       lhsv = std::move(rhsv);
       return;
     }
-    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, rhs_rows, rhs_columns);
-    fetch::math::Multiply(rhs->matrix, lhs, m->matrix);
+    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, rhs->rows(), rhs->columns());
+    Multiply(rhs->matrix, lhs, m->matrix);
     lhsv.Assign(std::move(m), rhsv.type_id);
   }
 
   virtual void RightMultiply(Variant &lhsv, Variant &rhsv) override
   {
-    bool const   lhs_matrix_is_modifiable = lhsv.object.RefCount() == 1;
-    Ptr<Matrix>  lhs                      = lhsv.object;
-    T            rhs                      = rhsv.primitive.Get<T>();
-    size_t const lhs_rows                 = lhs->matrix.shape()[0];
-    size_t const lhs_columns              = lhs->matrix.shape()[1];
+    bool const  lhs_matrix_is_modifiable = lhsv.object.RefCount() == 1;
+    Ptr<Matrix> lhs                      = lhsv.object;
+    T           rhs                      = rhsv.primitive.Get<T>();
     if (lhs_matrix_is_modifiable)
     {
-      lhs->matrix.InlineMultiply(rhs);
+      Multiply(lhs->matrix, rhs, lhs->matrix);
       return;
     }
-    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, lhs_rows, lhs_columns);
-    fetch::math::Multiply(lhs->matrix, rhs, m->matrix);
+    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, lhs->rows(), lhs->columns());
+    Multiply(lhs->matrix, rhs, m->matrix);
     lhsv.Assign(std::move(m), lhsv.type_id);
   }
 
   virtual void Multiply(Ptr<Object> &lhso, Ptr<Object> &rhso) override
   {
-    Ptr<Matrix>  lhs         = lhso;
-    Ptr<Matrix>  rhs         = rhso;
-    size_t const lhs_rows    = lhs->matrix.shape()[0];
-    size_t const lhs_columns = lhs->matrix.shape()[1];
-    size_t const rhs_rows    = rhs->matrix.shape()[0];
-    size_t const rhs_columns = rhs->matrix.shape()[1];
-    if (lhs_columns != rhs_rows)
+    Ptr<Matrix> lhs = lhso;
+    Ptr<Matrix> rhs = rhso;
+    if (lhs->columns() != rhs->rows())
     {
       RuntimeError("invalid operation");
       return;
     }
-    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, lhs_rows, rhs_columns);
-    // TODO(tfr): use blas
-    TODO_FAIL("Use BLAS TODO");
+    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, lhs->rows(), rhs->columns());
+    Dot(lhs->matrix, rhs->matrix, m->matrix);
     lhso = std::move(m);
   }
 
@@ -253,26 +257,12 @@ struct Matrix : public IMatrix
   {
     Ptr<Matrix> lhs = lhso;
     T           rhs = rhsv.primitive.Get<T>();
-    lhs->matrix.InlineMultiply(rhs);
+    Multiply(lhs->matrix, rhs, lhs->matrix);
   }
 
   virtual void MultiplyAssign(Ptr<Object> &lhso, Ptr<Object> &rhso) override
   {
-    Ptr<Matrix>  lhs         = lhso;
-    Ptr<Matrix>  rhs         = rhso;
-    size_t const lhs_rows    = lhs->matrix.shape()[0];
-    size_t const lhs_columns = lhs->matrix.shape()[1];
-    size_t const rhs_rows    = rhs->matrix.shape()[0];
-    size_t const rhs_columns = rhs->matrix.shape()[1];
-    if (lhs_columns != rhs_rows)
-    {
-      RuntimeError("invalid operation");
-      return;
-    }
-    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, lhs_rows, rhs_columns);
-    // TODO(tfr): Use blas
-    TODO_FAIL("Use BLAS");
-    lhso = std::move(m);
+    Multiply(lhso, rhso);
   }
 
   virtual void RightDivide(Variant &lhsv, Variant &rhsv) override
@@ -285,15 +275,13 @@ struct Matrix : public IMatrix
       RuntimeError("division by zero");
       return;
     }
-    size_t const lhs_rows    = lhs->matrix.shape()[0];
-    size_t const lhs_columns = lhs->matrix.shape()[1];
     if (lhs_matrix_is_modifiable)
     {
-      lhs->matrix.InlineDivide(rhs);
+      Divide(lhs->matrix, rhs, lhs->matrix);
       return;
     }
-    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, lhs_rows, lhs_columns);
-    fetch::math::Divide(lhs->matrix, rhs, m->matrix);
+    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, lhs->rows(), lhs->columns());
+    Divide(lhs->matrix, rhs, m->matrix);
     lhsv.Assign(std::move(m), lhsv.type_id);
   }
 
@@ -303,7 +291,7 @@ struct Matrix : public IMatrix
     T           rhs = rhsv.primitive.Get<T>();
     if (math::IsNonZero(rhs))
     {
-      lhs->matrix.InlineDivide(rhs);
+      Divide(lhs->matrix, rhs, lhs->matrix);
       return;
     }
     RuntimeError("division by zero");
@@ -311,19 +299,15 @@ struct Matrix : public IMatrix
 
   virtual void UnaryMinus(Ptr<Object> &object) override
   {
-    bool const   matrix_is_modifiable = object.RefCount() == 1;
-    Ptr<Matrix>  operand              = object;
-    size_t const rows                 = operand->matrix.shape()[0];
-    size_t const columns              = operand->matrix.shape()[1];
-
-    // TODO(tfr): implement unary minus
+    bool const  matrix_is_modifiable = object.RefCount() == 1;
+    Ptr<Matrix> operand              = object;
     if (matrix_is_modifiable)
     {
-      operand->matrix.InlineMultiply(T(-1));
+      Multiply(operand->matrix, T(-1), operand->matrix);
       return;
     }
-    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, rows, columns);
-    fetch::math::Multiply(operand->matrix, T(-1), m->matrix);
+    Ptr<Matrix> m = AcquireMatrix(vm_, type_id_, operand->rows(), operand->columns());
+    Multiply(operand->matrix, T(-1), m->matrix);
     object = std::move(m);
   }
 
@@ -345,14 +329,12 @@ struct Matrix : public IMatrix
       return nullptr;
     }
     rowv.Reset();
-    size_t const rows    = matrix.shape()[0];
-    size_t const columns = matrix.shape()[1];
-    if ((row >= rows) || (column >= columns))
+    if ((row >= rows()) || (column >= columns()))
     {
       RuntimeError("index out of bounds");
       return nullptr;
     }
-    return &matrix.At(column, row);
+    return &matrix.At(row, column);
   }
 
   virtual void *FindElement() override
@@ -380,9 +362,135 @@ struct Matrix : public IMatrix
     }
   }
 
-  fetch::math::Tensor<T> matrix;
+  TensorType matrix;
+
+private:
+  /// The tile edge of the transpose, so that both the source and destination tiles stay in cache
+  static constexpr SizeType TRANSPOSE_TILE = 32;
+
+  SizeType rows() const
+  {
+    return matrix.shape()[0];
+  }
+
+  SizeType columns() const
+  {
+    return matrix.shape()[1];
+  }
+
+  static bool SameShape(Matrix const &a, Matrix const &b)
+  {
+    return (a.rows() == b.rows()) && (a.columns() == b.columns());
+  }
+
+  /// @name Elementwise Kernels
+  /// The result may be one of the operands, since every register is loaded before it is stored
+  /// @{
+  static void Add(TensorType const &a, TensorType const &b, TensorType &ret)
+  {
+    ret.data().in_parallel().Apply(
+        [](VectorRegisterType const &x, VectorRegisterType const &y, VectorRegisterType &z) {
+          z = x + y;
+        },
+        a.data(), b.data());
+  }
+
+  static void Add(TensorType const &a, T scalar, TensorType &ret)
+  {
+    VectorRegisterType const val(scalar);
+    ret.data().in_parallel().Apply(
+        [val](VectorRegisterType const &x, VectorRegisterType &z) { z = x + val; }, a.data());
+  }
+
+  static void Subtract(TensorType const &a, TensorType const &b, TensorType &ret)
+  {
+    ret.data().in_parallel().Apply(
+        [](VectorRegisterType const &x, VectorRegisterType const &y, VectorRegisterType &z) {
+          z = x - y;
+        },
+        a.data(), b.data());
+  }
+
+  static void Subtract(TensorType const &a, T scalar, TensorType &ret)
+  {
+    VectorRegisterType const val(scalar);
+    ret.data().in_parallel().Apply(
+        [val](VectorRegisterType const &x, VectorRegisterType &z) { z = x - val; }, a.data());
+  }
+
+  static void Multiply(TensorType const &a, T scalar, TensorType &ret)
+  {
+    VectorRegisterType const val(scalar);
+    ret.data().in_parallel().Apply(
+        [val](VectorRegisterType const &x, VectorRegisterType &z) { z = x * val; }, a.data());
+  }
+
+  static void Divide(TensorType const &a, T scalar, TensorType &ret)
+  {
+    VectorRegisterType const val(scalar);
+    ret.data().in_parallel().Apply(
+        [val](VectorRegisterType const &x, VectorRegisterType &z) { z = x / val; }, a.data());
+  }
+  /// @}
+
+  /**
+   * Compute ret = a.b, accumulating each column of the result from the columns of a (scaled by the
+   * elements of the matching column of b), so that every inner loop runs over contiguous memory
+   */
+  static void Dot(TensorType const &a, TensorType const &b, TensorType &ret)
+  {
+    SizeType const rows    = a.shape()[0];
+    SizeType const inner   = a.shape()[1];
+    SizeType const columns = b.shape()[1];
+    T const *      a_data  = a.data().pointer();
+    T const *      b_data  = b.data().pointer();
+    T *            r_data  = ret.data().pointer();
+
+    for (SizeType j = 0; j < columns; ++j)
+    {
+      T *const r_column = r_data + (j * rows);
+      std::fill(r_column, r_column + rows, T{0});
+
+      for (SizeType k = 0; k < inner; ++k)
+      {
+        T const        factor   = b_data[k + (j * inner)];
+        T const *const a_column = a_data + (k * rows);
+        for (SizeType i = 0; i < rows; ++i)
+        {
+          r_column[i] += a_column[i] * factor;
+        }
+      }
+    }
+  }
+
+  static void Transpose(TensorType const &a, TensorType &ret)
+  {
+    SizeType const rows    = a.shape()[0];
+    SizeType const columns = a.shape()[1];
+    T const *      a_data  = a.data().pointer();
+    T *            r_data  = ret.data().pointer();
+
+    for (SizeType jj = 0; jj < columns; jj += TRANSPOSE_TILE)
+    {
+      SizeType const j_end = std::min(jj + TRANSPOSE_TILE, columns);
+      for (SizeType ii = 0; ii < rows; ii += TRANSPOSE_TILE)
+      {
+        SizeType const i_end = std::min(ii + TRANSPOSE_TILE, rows);
+        for (SizeType j = jj; j < j_end; ++j)
+        {
+          for (SizeType i = ii; i < i_end; ++i)
+          {
+            r_data[j + (i * columns)] = a_data[i + (j * rows)];
+          }
+        }
+      }
+    }
+  }
 };
 
+template <typename T>
+constexpr typename Matrix<T>::SizeType Matrix<T>::TRANSPOSE_TILE;
+
 inline Ptr<IMatrix> IMatrix::Constructor(VM *vm, TypeId type_id, int32_t rows, int32_t columns)
 {
   TypeInfo const &type_info       = vm->GetTypeInfo(type_id);
@@ -30,27 +30,41 @@
 #include "vm/state.hpp"
 #include "vm/vm.hpp"
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 namespace fetch {
 namespace vm {
 
+/**
+ * The bindings which scripts are compiled and executed against.
+ *
+ * Copying a module is cheap: the copy shares the bindings (and the VM tables built from them) with
+ * the original, until either of them registers something new.
+ */
 class Module
 {
 public:
   Module();
+  Module(Module const &other);
   ~Module() = default;
 
+  Module &operator=(Module const &) = delete;
+
   template <typename ObjectType>
   class ClassInterface
   {
   public:
-    ClassInterface(Module *module__, TypeId type_id__)
+    ClassInterface(Module *module__, TypeId type_id__, std::string const &type_name__)
     {
-      module_  = module__;
-      type_id_ = type_id__;
+      module_    = module__;
+      type_id_   = type_id__;
+      type_name_ = type_name__;
     }
 
     template <typename... Ts>
-    ClassInterface &CreateTypeConstuctor()
+    ClassInterface &CreateTypeConstuctor(ChargeAmount charge = DEFAULT_OPCODE_CHARGE)
     {
       TypeId         type_id__ = type_id_;
       Opcode         opcode    = module_->GetNextOpcode();
@@ -64,13 +78,14 @@ public:
       OpcodeHandler handler = [](VM *vm) {
         InvokeTypeConstructor<ObjectType, Ts...>(vm, vm->instruction_->type_id);
       };
-      module_->AddOpcodeHandler(opcode, handler);
+      module_->AddOpcodeHandler(opcode, handler, charge, type_name_);
       return *this;
     }
 
     template <typename ReturnType, typename... Ts>
     ClassInterface &CreateTypeFunction(std::string const &name,
-                                       ReturnType (*f)(VM *, TypeId, Ts...))
+                                       ReturnType (*f)(VM *, TypeId, Ts...),
+                                       ChargeAmount charge = DEFAULT_OPCODE_CHARGE)
     {
       TypeId         type_id__ = type_id_;
       Opcode         opcode    = module_->GetNextOpcode();
@@ -86,24 +101,26 @@ public:
       OpcodeHandler handler = [f](VM *vm) {
         InvokeTypeFunction(vm, vm->instruction_->data.ui16, vm->instruction_->type_id, f);
       };
-      module_->AddOpcodeHandler(opcode, handler);
+      module_->AddOpcodeHandler(opcode, handler, charge, type_name_ + "." + name);
       return *this;
     }
 
     template <typename ReturnType, typename... Ts>
     ClassInterface &CreateInstanceFunction(std::string const &name,
-                                           ReturnType (ObjectType::*f)(Ts...))
+                                           ReturnType (ObjectType::*f)(Ts...),
+                                           ChargeAmount charge = DEFAULT_OPCODE_CHARGE)
     {
       using InstanceFunction = ReturnType (ObjectType::*)(Ts...);
-      return InternalCreateInstanceFunction<ReturnType, InstanceFunction, Ts...>(name, f);
+      return InternalCreateInstanceFunction<ReturnType, InstanceFunction, Ts...>(name, f, charge);
     }
 
     template <typename ReturnType, typename... Ts>
     ClassInterface &CreateInstanceFunction(std::string const &name,
-                                           ReturnType (ObjectType::*f)(Ts...) const)
+                                           ReturnType (ObjectType::*f)(Ts...) const,
+                                           ChargeAmount charge = DEFAULT_OPCODE_CHARGE)
     {
       using InstanceFunction = ReturnType (ObjectType::*)(Ts...) const;
-      return InternalCreateInstanceFunction<ReturnType, InstanceFunction, Ts...>(name, f);
+      return InternalCreateInstanceFunction<ReturnType, InstanceFunction, Ts...>(name, f, charge);
     }
 
     ClassInterface &EnableOperator(Operator op)
@@ -134,7 +151,8 @@ public:
 
   private:
     template <typename ReturnType, typename InstanceFunction, typename... Ts>
-    ClassInterface &InternalCreateInstanceFunction(std::string const &name, InstanceFunction f)
+    ClassInterface &InternalCreateInstanceFunction(std::string const &name, InstanceFunction f,
+                                                   ChargeAmount charge)
     {
       TypeId         type_id__ = type_id_;
       Opcode         opcode    = module_->GetNextOpcode();
@@ -151,16 +169,18 @@ public:
       OpcodeHandler handler = [f](VM *vm) {
         InvokeInstanceFunction(vm, vm->instruction_->type_id, f);
       };
-      module_->AddOpcodeHandler(opcode, handler);
+      module_->AddOpcodeHandler(opcode, handler, charge, type_name_ + "." + name);
       return *this;
     }
 
-    Module *module_;
-    TypeId  type_id_;
+    Module *    module_;
+    TypeId      type_id_;
+    std::string type_name_;  ///< Only used to name the opcodes of the bindings
   };
 
   template <typename ReturnType, typename... Ts>
-  void CreateFreeFunction(std::string const &name, ReturnType (*f)(VM *, Ts...))
+  void CreateFreeFunction(std::string const &name, ReturnType (*f)(VM *, Ts...),
+                          ChargeAmount charge = DEFAULT_OPCODE_CHARGE)
   {
     Opcode         opcode = GetNextOpcode();
     TypeIndexArray type_index_array;
@@ -173,7 +193,7 @@ public:
     };
     AddCompilerSetupFunction(compiler_setup_function);
     OpcodeHandler handler = [f](VM *vm) { InvokeFreeFunction(vm, vm->instruction_->type_id, f); };
-    AddOpcodeHandler(opcode, handler);
+    AddOpcodeHandler(opcode, handler, charge, name);
   }
 
   template <typename ObjectType>
@@ -185,7 +205,7 @@ public:
       compiler->CreateClassType(name, type_id);
     };
     AddCompilerSetupFunction(compiler_setup_function);
-    return ClassInterface<ObjectType>(this, type_id);
+    return ClassInterface<ObjectType>(this, type_id, name);
   }
 
   // e.g. CreateTemplateInstantiationType<Array, Ptr<MyClass>>(TypeIds::IArray);
@@ -194,14 +214,14 @@ public:
   {
     using InstantiationType = Template<T, Ts...>;
     TypeIndex type_index    = TypeIndex(typeid(InstantiationType));
-    TypeId    type_id       = registered_types_.GetTypeId(type_index);
+    TypeId    type_id       = bindings_->registered_types.GetTypeId(type_index);
     if (type_id != TypeIds::Unknown)
     {
       // The instantiation has been created already
       return;
     }
     type_id = GetNextTypeId();
-    registered_types_.RegisterType(type_index, type_id);
+    RegisterType(type_index, type_id);
     TypeIndexArray type_index_array;
     UnrollTypes<T, Ts...>::Unroll(type_index_array);
     TypeIdArray type_id_array    = GetTypeIds(type_index_array);
@@ -211,58 +231,90 @@ public:
     AddCompilerSetupFunction(compiler_setup_function);
   }
 
+  /**
+   * Override the charge for executing one of the builtin opcodes (see Opcodes). The charges of the
+   * bindings are given when they are created.
+   *
+   * @param opcode The opcode to be charged
+   * @param charge The charge for each execution of the opcode
+   */
+  void SetOpcodeCharge(Opcode opcode, ChargeAmount charge)
+  {
+    MutableBindings().opcode_charge_overrides.emplace_back(opcode, charge);
+  }
+
+  /**
+   * Identifies how many types and opcodes have been allocated by the bindings of this module. The
+   * bytecode of a compiled script is only valid for modules with the same layout.
+   *
+   * @return The layout identifier
+   */
+  uint32_t LayoutId() const
+  {
+    return (static_cast<uint32_t>(bindings_->next_type_id) << 16u) |
+           static_cast<uint32_t>(bindings_->next_opcode);
+  }
+
+  VM::TablesPtr vm_tables() const;
+
 private:
   template <typename ObjectType>
-  ClassInterface<ObjectType> RegisterClassType(TypeId type_id)
+  ClassInterface<ObjectType> RegisterClassType(TypeId type_id, std::string const &name)
   {
     RegisterType(TypeIndex(typeid(ObjectType)), type_id);
-    return ClassInterface<ObjectType>(this, type_id);
+    return ClassInterface<ObjectType>(this, type_id, name);
   }
 
   template <typename ObjectType>
-  ClassInterface<ObjectType> RegisterTemplateType(TypeId type_id)
+  ClassInterface<ObjectType> RegisterTemplateType(TypeId type_id, std::string const &name)
   {
     RegisterType(TypeIndex(typeid(ObjectType)), type_id);
-    return ClassInterface<ObjectType>(this, type_id);
+    return ClassInterface<ObjectType>(this, type_id, name);
   }
 
   void CompilerSetup(Compiler *compiler)
   {
-    for (auto const &compiler_setup_function : compiler_setup_functions_)
+    for (auto const &compiler_setup_function : bindings_->compiler_setup_functions)
     {
       compiler_setup_function(compiler);
     }
   }
 
-  void VMSetup(VM *vm)
+  using CompilerSetupFunction = std::function<void(Compiler *)>;
+  using OpcodeCharge          = std::pair<Opcode, ChargeAmount>;
+
+  struct Bindings
   {
-    for (auto const &info : opcode_handler_info_array_)
-    {
-      vm->AddOpcodeHandler(info);
-    }
-    vm->SetRegisteredTypes(registered_types_);
-  }
+    TypeId                             next_type_id{TypeIds::NumReserved};
+    Opcode                             next_opcode{Opcodes::NumReserved};
+    RegisteredTypes                    registered_types;
+    std::vector<CompilerSetupFunction> compiler_setup_functions;
+    std::vector<OpcodeHandlerInfo>     opcode_handler_info_array;
+    std::vector<OpcodeCharge>          opcode_charge_overrides;
+  };
 
-  using CompilerSetupFunction = std::function<void(Compiler *)>;
+  using BindingsPtr = std::shared_ptr<Bindings>;
+
+  Bindings &MutableBindings();
 
   TypeId GetNextTypeId()
   {
-    return next_type_id_++;
+    return MutableBindings().next_type_id++;
   }
 
   Opcode GetNextOpcode()
   {
-    return next_opcode_++;
+    return MutableBindings().next_opcode++;
   }
 
   void RegisterType(TypeIndex type_index, TypeId type_id)
   {
-    registered_types_.RegisterType(type_index, type_id);
+    MutableBindings().registered_types.RegisterType(type_index, type_id);
   }
 
   TypeId GetTypeId(TypeIndex type_index) const
   {
-    TypeId const type_id = registered_types_.GetTypeId(type_index);
+    TypeId const type_id = bindings_->registered_types.GetTypeId(type_index);
     if (type_id != TypeIds::Unknown)
     {
       return type_id;
@@ -283,19 +335,18 @@ private:
 
   void AddCompilerSetupFunction(CompilerSetupFunction function)
   {
-    compiler_setup_functions_.push_back(function);
+    MutableBindings().compiler_setup_functions.push_back(function);
   }
 
-  void AddOpcodeHandler(Opcode opcode, OpcodeHandler handler)
+  void AddOpcodeHandler(Opcode opcode, OpcodeHandler handler, ChargeAmount charge,
+                        std::string const &name)
   {
-    opcode_handler_info_array_.push_back(OpcodeHandlerInfo(opcode, handler));
+    MutableBindings().opcode_handler_info_array.push_back(
+        OpcodeHandlerInfo(opcode, handler, charge, name));
   }
 
-  TypeId                             next_type_id_;
-  Opcode                             next_opcode_;
-  RegisteredTypes                    registered_types_;
-  std::vector<CompilerSetupFunction> compiler_setup_functions_;
-  std::vector<OpcodeHandlerInfo>     opcode_handler_info_array_;
+  BindingsPtr           bindings_;   ///< Shared with the copies of this module until modified
+  mutable VM::TablesPtr vm_tables_;  ///< Built on first use, only accessed atomically
 
   friend class Compiler;
   friend class VM;
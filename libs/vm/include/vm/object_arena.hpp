@@ -0,0 +1,145 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace fetch {
+namespace vm {
+
+/**
+ * Pooled allocator for the objects created while a script is running.
+ *
+ * Memory is carved out of large chunks with a bump pointer and recycled through per size class
+ * free lists, so the many short lived objects of a contract call do not each go to the heap. While
+ * a Scope is active every VM object created on the thread is allocated from the arena, otherwise
+ * objects fall back to the heap. Each block records the arena that it came from, which means that
+ * objects that escape the execution (for example the returned value) remain valid: the arena is
+ * only rewound once it has no live blocks, and is only destroyed when its owner has released it and
+ * the last block has been freed.
+ *
+ * Like the VM itself the arena is not thread safe, objects must be released on the thread which is
+ * executing the owning VM (or once that VM has finished).
+ */
+class ObjectArena
+{
+public:
+  static constexpr std::size_t CHUNK_SIZE          = 64 * 1024;
+  static constexpr std::size_t GRANULARITY         = 16;
+  static constexpr std::size_t MAX_BLOCK_SIZE      = 1024;  ///< Larger objects use the heap
+  static constexpr std::size_t MAX_RETAINED_CHUNKS = 16;    ///< Chunks kept over a reset
+
+  /**
+   * Makes an arena the allocation target of the current thread for its lifetime
+   */
+  class Scope
+  {
+  public:
+    explicit Scope(ObjectArena *arena);
+    Scope(Scope const &) = delete;
+    Scope(Scope &&)      = delete;
+    ~Scope();
+
+    Scope &operator=(Scope const &) = delete;
+    Scope &operator=(Scope &&) = delete;
+
+  private:
+    ObjectArena *previous_;
+  };
+
+  static ObjectArena *Create();
+  void                Release();
+
+  void Reset();
+
+  std::size_t live_blocks() const
+  {
+    return live_blocks_;
+  }
+
+  std::size_t reserved_bytes() const
+  {
+    return chunks_.size() * CHUNK_SIZE;
+  }
+
+  /**
+   * Accumulate the number of GRANULARITY sized units allocated while this arena is current,
+   * including the objects which are too large for the arena
+   *
+   * @param counter The counter to be incremented, or nullptr to stop counting
+   */
+  void SetAllocationCounter(uint64_t *counter)
+  {
+    allocation_counter_ = counter;
+  }
+
+  /// @name Object Allocation
+  /// @{
+  static void *Allocate(std::size_t size);
+  static void  Deallocate(void *ptr) noexcept;
+  /// @}
+
+  // Operators
+  ObjectArena &operator=(ObjectArena const &) = delete;
+  ObjectArena &operator=(ObjectArena &&) = delete;
+
+private:
+  static constexpr std::size_t NUM_SIZE_CLASSES = MAX_BLOCK_SIZE / GRANULARITY;
+
+  /// Prefix of every block, padded so that objects keep the default new alignment
+  struct alignas(GRANULARITY) Header
+  {
+    ObjectArena *arena;
+    std::size_t  size_class;
+  };
+
+  struct FreeBlock
+  {
+    FreeBlock *next;
+  };
+
+  using Chunk      = std::unique_ptr<uint8_t[]>;
+  using Chunks     = std::vector<Chunk>;
+  using FreeBlocks = std::array<FreeBlock *, NUM_SIZE_CLASSES>;
+
+  // Construction / Destruction (through Create and Release)
+  ObjectArena();
+  ObjectArena(ObjectArena const &) = delete;
+  ObjectArena(ObjectArena &&)      = delete;
+  ~ObjectArena() = default;
+
+  Header *AllocateBlock(std::size_t block_size);
+  void    RecycleBlock(Header *header) noexcept;
+
+  static thread_local ObjectArena *current_;
+
+  Chunks      chunks_;
+  std::size_t chunk_index_{0};  ///< The chunk currently being carved up
+  std::size_t offset_{0};       ///< The bump pointer into the current chunk
+  FreeBlocks  free_blocks_;
+  std::size_t live_blocks_{0};
+  bool        released_{false};
+  uint64_t *  allocation_counter_{nullptr};
+};
+
+}  // namespace vm
+}  // namespace fetch
@@ -19,6 +19,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <string>
 
 namespace fetch {
 namespace vm {
@@ -127,20 +128,74 @@ static Opcode const VariableObjectDivideAssign   = 106;
 static Opcode const ElementDivideAssign          = 107;
 static Opcode const ElementRightDivideAssign     = 108;
 static Opcode const ElementObjectDivideAssign    = 109;
+
+// Superinstructions, these are never emitted by the generator, only by the optimiser
+static Opcode const VariableInc                   = 110;
+static Opcode const VariableDec                   = 111;
+static Opcode const VariableAddConstant           = 112;
+static Opcode const VariableSubtractConstant      = 113;
+static Opcode const EqualJumpIfFalse              = 114;
+static Opcode const NotEqualJumpIfFalse           = 115;
+static Opcode const LessThanJumpIfFalse           = 116;
+static Opcode const LessThanOrEqualJumpIfFalse    = 117;
+static Opcode const GreaterThanJumpIfFalse        = 118;
+static Opcode const GreaterThanOrEqualJumpIfFalse = 119;
+
+// Type specialised arithmetic, emitted by the generator for operands of a known primitive type
+static Opcode const Int32Add                      = 120;
+static Opcode const Int32Subtract                 = 121;
+static Opcode const Int32Multiply                 = 122;
+static Opcode const Int32Divide                   = 123;
+static Opcode const Int32Modulo                   = 124;
+static Opcode const UInt32Add                     = 125;
+static Opcode const UInt32Subtract                = 126;
+static Opcode const UInt32Multiply                = 127;
+static Opcode const UInt32Divide                  = 128;
+static Opcode const UInt32Modulo                  = 129;
+static Opcode const Int64Add                      = 130;
+static Opcode const Int64Subtract                 = 131;
+static Opcode const Int64Multiply                 = 132;
+static Opcode const Int64Divide                   = 133;
+static Opcode const Int64Modulo                   = 134;
+static Opcode const UInt64Add                     = 135;
+static Opcode const UInt64Subtract                = 136;
+static Opcode const UInt64Multiply                = 137;
+static Opcode const UInt64Divide                  = 138;
+static Opcode const UInt64Modulo                  = 139;
+static Opcode const Float32Add                    = 140;
+static Opcode const Float32Subtract               = 141;
+static Opcode const Float32Multiply               = 142;
+static Opcode const Float32Divide                 = 143;
+static Opcode const Float64Add                    = 144;
+static Opcode const Float64Subtract               = 145;
+static Opcode const Float64Multiply               = 146;
+static Opcode const Float64Divide                 = 147;
 static Opcode const NumReserved                  = 500;
 }  // namespace Opcodes
 
 class VM;
 using OpcodeHandler = std::function<void(VM *)>;
+
+/// The unit in which the cost of executing a script is measured
+using ChargeAmount = uint64_t;
+
+/// The charge for an opcode which has not been given one explicitly
+static ChargeAmount const DEFAULT_OPCODE_CHARGE = 1;
+
 struct OpcodeHandlerInfo
 {
-  OpcodeHandlerInfo(Opcode opcode__, OpcodeHandler handler__)
+  OpcodeHandlerInfo(Opcode opcode__, OpcodeHandler handler__,
+                    ChargeAmount charge__ = DEFAULT_OPCODE_CHARGE, std::string name__ = "")
   {
     opcode  = opcode__;
     handler = handler__;
+    charge  = charge__;
+    name    = std::move(name__);
   }
   Opcode        opcode;
   OpcodeHandler handler;
+  ChargeAmount  charge;
+  std::string   name;  ///< Used in the profiler output
 };
 
 }  // namespace vm
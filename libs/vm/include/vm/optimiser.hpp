@@ -0,0 +1,71 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "vm/defs.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace fetch {
+namespace vm {
+
+/**
+ * Rewrites the naive stack code produced by the Generator so that fewer instructions need to be
+ * executed. The passes are purely local and preserve the observable behaviour of the script,
+ * including the runtime errors which it can raise.
+ */
+class Optimiser
+{
+public:
+  /**
+   * The number of instructions removed by each of the optimisation passes
+   */
+  struct Report
+  {
+    std::size_t constant_folding{0};   ///< Arithmetic on constant operands done at compile time
+    std::size_t dead_stores{0};        ///< Values which were computed but never used
+    std::size_t jump_threading{0};     ///< Jumps which became jumps to the next instruction
+    std::size_t superinstructions{0};  ///< Instruction sequences fused into a single opcode
+    std::size_t jumps_threaded{0};     ///< Jumps which were retargeted past another jump
+
+    std::size_t total() const
+    {
+      return constant_folding + dead_stores + jump_threading + superinstructions;
+    }
+  };
+
+  Optimiser()  = default;
+  ~Optimiser() = default;
+
+  Report Optimise(Script &script);
+
+private:
+  using Flags = std::vector<bool>;
+
+  std::size_t FoldConstants(Script::Function &function);
+  std::size_t RemoveDeadStores(Script::Function &function);
+  std::size_t FuseInstructions(Script::Function &function);
+  std::size_t ThreadJumps(Script::Function &function, std::size_t &jumps_threaded);
+
+  static Flags       FindJumpTargets(Script::Instructions const &instructions);
+  static std::size_t Compact(Script::Function &function, Flags const &removed);
+};
+
+}  // namespace vm
+}  // namespace fetch
@@ -0,0 +1,154 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "vm/opcodes.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fetch {
+namespace vm {
+
+/**
+ * Instrumenting profiler for the VM. When attached to a VM (see VM::SetProfiler) every executed
+ * instruction is counted against the call stack of user functions and the source line it came
+ * from, and the time spent in the handlers of the module bindings is measured.
+ *
+ * The counts accumulate over all the executions until the profiler is reset, and can be exported
+ * in the folded stack format which is understood by the common flamegraph tools, i.e.
+ *
+ *   main;fib;fib 1234
+ */
+class Profiler
+{
+public:
+  using Clock    = std::chrono::steady_clock;
+  using Duration = Clock::duration;
+
+  static constexpr std::size_t DEFAULT_MAX_ENTRIES = 20;
+
+  struct OpcodeStats
+  {
+    uint64_t count{0};            ///< The number of times the opcode was executed
+    Duration module_call_time{};  ///< The time spent in the handler, only for module opcodes
+  };
+
+  // Construction / Destruction
+  Profiler();
+  Profiler(Profiler const &) = delete;
+  Profiler(Profiler &&)      = delete;
+  ~Profiler()                = default;
+
+  void SetOpcodeName(Opcode opcode, std::string const &name);
+
+  /// @name Recording
+  /// @{
+  void Enter(std::string const &function_name);
+  void Leave();
+  void EndExecution();
+
+  /**
+   * Count an executed instruction against the current function
+   *
+   * @param opcode The opcode of the instruction
+   * @param line The source line of the instruction
+   */
+  void RecordInstruction(Opcode opcode, uint16_t line)
+  {
+    if (opcode >= opcode_stats_.size())
+    {
+      opcode_stats_.resize(std::size_t{opcode} + 1u);
+    }
+    ++opcode_stats_[opcode].count;
+    ++nodes_[current_].line_counts[line];
+    current_line_ = line;
+    ++instruction_count_;
+  }
+
+  /**
+   * Add the time spent in the handler of a module opcode
+   *
+   * @param opcode The opcode of the module binding
+   * @param duration The time spent in the handler
+   */
+  void RecordModuleCall(Opcode opcode, Duration duration)
+  {
+    opcode_stats_[opcode].module_call_time += duration;
+  }
+  /// @}
+
+  /// @name Reporting
+  /// @{
+  void WriteFoldedStacks(std::ostream &stream, bool with_lines = false) const;
+  void WriteReport(std::ostream &stream, std::size_t max_entries = DEFAULT_MAX_ENTRIES) const;
+
+  uint64_t instruction_count() const
+  {
+    return instruction_count_;
+  }
+
+  OpcodeStats const &opcode_stats(Opcode opcode) const;
+  std::string        OpcodeName(Opcode opcode) const;
+  /// @}
+
+  void Reset();
+
+  // Operators
+  Profiler &operator=(Profiler const &) = delete;
+  Profiler &operator=(Profiler &&) = delete;
+
+private:
+  static constexpr std::size_t ROOT = 0;
+
+  using ChildKey   = std::pair<std::string, uint16_t>;  ///< The function and the line of the call
+  using Children   = std::map<ChildKey, std::size_t>;
+  using LineCounts = std::map<uint16_t, uint64_t>;
+
+  /**
+   * A function in the call tree, which is distinct for every call site
+   */
+  struct Node
+  {
+    std::string name;
+    uint16_t    call_line{0};  ///< The line in the parent function which called this one
+    std::size_t parent{ROOT};
+    Children    children;
+    LineCounts  line_counts;  ///< The instructions executed in this function, by source line
+  };
+
+  using Nodes            = std::vector<Node>;
+  using OpcodeStatsArray = std::vector<OpcodeStats>;
+  using OpcodeNames      = std::vector<std::string>;
+
+  Nodes            nodes_;
+  std::size_t      current_{ROOT};
+  uint16_t         current_line_{0};
+  uint64_t         instruction_count_{0};
+  OpcodeStatsArray opcode_stats_;
+  OpcodeNames      opcode_names_;
+};
+
+}  // namespace vm
+}  // namespace fetch
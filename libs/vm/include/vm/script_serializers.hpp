@@ -0,0 +1,255 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/serializers/stl_types.hpp"
+#include "vm/defs.hpp"
+#include "vm/opcodes.hpp"
+#include "vm/typeids.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace fetch {
+namespace vm {
+
+template <typename T>
+void Serialize(T &s, TypeInfo const &info)
+{
+  s << info.name << info.id << static_cast<uint16_t>(info.category) << info.parameter_type_ids;
+}
+
+template <typename T>
+void Deserialize(T &s, TypeInfo &info)
+{
+  uint16_t category{0};
+  s >> info.name >> info.id >> category >> info.parameter_type_ids;
+  info.category = static_cast<TypeCategory>(category);
+}
+
+template <typename T>
+void Serialize(T &s, Script::Instruction const &instruction)
+{
+  s << instruction.opcode << instruction.line << instruction.index << instruction.type_id
+    << instruction.data.ui64;
+}
+
+template <typename T>
+void Deserialize(T &s, Script::Instruction &instruction)
+{
+  s >> instruction.opcode >> instruction.line >> instruction.index >> instruction.type_id >>
+      instruction.data.ui64;
+}
+
+template <typename T>
+void Serialize(T &s, Script::Variable const &variable)
+{
+  s << variable.name << variable.type_id;
+}
+
+template <typename T>
+void Deserialize(T &s, Script::Variable &variable)
+{
+  s >> variable.name >> variable.type_id;
+}
+
+template <typename T>
+void Serialize(T &s, Script::AnnotationLiteral const &literal)
+{
+  s << static_cast<uint16_t>(literal.type);
+
+  switch (literal.type)
+  {
+  case Script::AnnotationLiteralType::Boolean:
+    s << static_cast<uint8_t>(literal.boolean ? 1 : 0);
+    break;
+  case Script::AnnotationLiteralType::Integer:
+    s << literal.integer;
+    break;
+  case Script::AnnotationLiteralType::Real:
+    s << literal.real;
+    break;
+  case Script::AnnotationLiteralType::String:
+  case Script::AnnotationLiteralType::Identifier:
+    s << literal.str;
+    break;
+  case Script::AnnotationLiteralType::Unknown:
+    break;
+  }
+}
+
+template <typename T>
+void Deserialize(T &s, Script::AnnotationLiteral &literal)
+{
+  uint16_t type{0};
+  s >> type;
+
+  switch (static_cast<Script::AnnotationLiteralType>(type))
+  {
+  case Script::AnnotationLiteralType::Boolean:
+  {
+    uint8_t boolean{0};
+    s >> boolean;
+    literal.SetBoolean(boolean != 0);
+    break;
+  }
+  case Script::AnnotationLiteralType::Integer:
+  {
+    int64_t integer{0};
+    s >> integer;
+    literal.SetInteger(integer);
+    break;
+  }
+  case Script::AnnotationLiteralType::Real:
+  {
+    double real{0};
+    s >> real;
+    literal.SetReal(real);
+    break;
+  }
+  case Script::AnnotationLiteralType::String:
+  {
+    std::string str;
+    s >> str;
+    literal.SetString(str);
+    break;
+  }
+  case Script::AnnotationLiteralType::Identifier:
+  {
+    std::string str;
+    s >> str;
+    literal.SetIdentifier(str);
+    break;
+  }
+  case Script::AnnotationLiteralType::Unknown:
+    literal = Script::AnnotationLiteral{};
+    break;
+  }
+}
+
+template <typename T>
+void Serialize(T &s, Script::AnnotationElement const &element)
+{
+  s << static_cast<uint16_t>(element.type) << element.name << element.value;
+}
+
+template <typename T>
+void Deserialize(T &s, Script::AnnotationElement &element)
+{
+  uint16_t type{0};
+  s >> type >> element.name >> element.value;
+  element.type = static_cast<Script::AnnotationElementType>(type);
+}
+
+template <typename T>
+void Serialize(T &s, Script::Annotation const &annotation)
+{
+  s << annotation.name << annotation.elements;
+}
+
+template <typename T>
+void Deserialize(T &s, Script::Annotation &annotation)
+{
+  s >> annotation.name >> annotation.elements;
+}
+
+template <typename T>
+void Serialize(T &s, Script::Function const &function)
+{
+  s << function.name << function.annotations << static_cast<int32_t>(function.num_variables)
+    << static_cast<int32_t>(function.num_parameters) << function.return_type_id;
+
+  // neither variables nor instructions are default constructible, so they are written manually
+  s << static_cast<uint64_t>(function.variables.size());
+  for (auto const &variable : function.variables)
+  {
+    s << variable;
+  }
+
+  s << static_cast<uint64_t>(function.instructions.size());
+  for (auto const &instruction : function.instructions)
+  {
+    s << instruction;
+  }
+}
+
+template <typename T>
+void Deserialize(T &s, Script::Function &function)
+{
+  int32_t  num_variables{0};
+  int32_t  num_parameters{0};
+  uint64_t count{0};
+
+  s >> function.name >> function.annotations >> num_variables >> num_parameters >>
+      function.return_type_id;
+
+  function.num_variables  = num_variables;
+  function.num_parameters = num_parameters;
+
+  s >> count;
+  function.variables.clear();
+  function.variables.reserve(count);
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    function.variables.emplace_back(std::string{}, TypeIds::Unknown);
+    s >> function.variables.back();
+  }
+
+  s >> count;
+  function.instructions.clear();
+  function.instructions.reserve(count);
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    function.instructions.emplace_back(Opcodes::Unknown, uint16_t{0});
+    s >> function.instructions.back();
+  }
+}
+
+template <typename T>
+void Serialize(T &s, Script const &script)
+{
+  s << script.name << script.type_info_table << script.strings;
+
+  s << static_cast<uint64_t>(script.functions.size());
+  for (auto const &function : script.functions)
+  {
+    s << function;
+  }
+}
+
+template <typename T>
+void Deserialize(T &s, Script &script)
+{
+  uint64_t count{0};
+
+  s >> script.name >> script.type_info_table >> script.strings >> count;
+
+  script.functions.clear();
+  script.map.clear();
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    Script::Function function{std::string{}, Script::Annotations{}, 0, TypeIds::Unknown};
+    s >> function;
+
+    // rebuilds the function name lookup
+    script.AddFunction(function);
+  }
+}
+
+}  // namespace vm
+}  // namespace fetch
@@ -64,45 +64,29 @@ inline IoObserverInterface::Status WriteHelper(std::string const &name, T const
 inline IoObserverInterface::Status ReadHelper(std::string const &name, Ptr<Address> &val,
                                               IoObserverInterface &io)
 {
-  auto const exists_status = io.Exists(name);
-  if (exists_status != IoObserverInterface::Status::OK)
-  {
-    return exists_status;
-  }
-
-  // create an initial buffer size
-  std::vector<uint8_t> bytes(256, 0);
-
-  uint64_t buffer_size = bytes.size();
-  auto     result      = io.Read(name, bytes.data(), buffer_size);
+  // the view refers to the buffer held by the observer, so the value is only copied once
+  IoObserverInterface::ConstByteArray value;
+  auto const                          result = io.ReadView(name, value);
 
   if (IoObserverInterface::Status::OK == result)
   {
-    // chop down the size of the buffer
-    bytes.resize(buffer_size);
-  }
-  else if (IoObserverInterface::Status::BUFFER_TOO_SMALL == result)
-  {
-    // increase the buffer size
-    bytes.resize(buffer_size);
+    std::vector<uint8_t> bytes(value.size());
+    value.ReadBytes(bytes.data(), bytes.size());
 
-    // make the second call to the io observer
-    result = io.Read(name, bytes.data(), buffer_size);
+    // get the type to convert itself
+    val->FromBytes(std::move(bytes));
   }
 
-  // get the type to convert itself
-  val->FromBytes(std::move(bytes));
-
   return result;
 }
 
 inline IoObserverInterface::Status WriteHelper(std::string const &name, Ptr<Address> const &val,
                                                IoObserverInterface &io)
 {
-  // convert the object to bytes
-  auto bytes = val->ToBytes();
+  // convert the object to bytes, the observer is free to keep the (immutable) buffer
+  auto const bytes = val->ToBytes();
 
-  return io.Write(name, bytes.data(), bytes.size());
+  return io.WriteView(name, IoObserverInterface::ConstByteArray{bytes.data(), bytes.size()});
 }
 
 template <typename T>
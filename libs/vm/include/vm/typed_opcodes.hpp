@@ -0,0 +1,44 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "vm/opcodes.hpp"
+#include "vm/typeids.hpp"
+
+namespace fetch {
+namespace vm {
+
+/**
+ * Get the type specialised version of a primitive arithmetic opcode
+ *
+ * @param opcode The generic opcode, i.e. Add, Subtract, Multiply, Divide or Modulo
+ * @param type_id The type of both of the operands
+ * @return The specialised opcode, or Opcodes::Unknown if there is no specialisation for the type
+ */
+Opcode GetTypedArithmeticOpcode(Opcode opcode, TypeId type_id);
+
+/**
+ * Get the generic opcode which a type specialised arithmetic opcode was derived from
+ *
+ * @param opcode The opcode to be mapped
+ * @return The generic opcode, or the opcode itself if it is not type specialised
+ */
+Opcode GetGenericArithmeticOpcode(Opcode opcode);
+
+}  // namespace vm
+}  // namespace fetch
@@ -21,9 +21,14 @@
 #include "vm/defs.hpp"
 #include "vm/io_observer_interface.hpp"
 #include "vm/string.hpp"
+#include <algorithm>
 #include <cassert>
-
+#include <cstddef>
+#include <limits>
+#include <memory>
 #include <sstream>
+#include <string>
+#include <vector>
 
 namespace fetch {
 namespace vm {
@@ -98,6 +103,7 @@ struct AssignParameters<POSITION>
 
 // Forward declarations
 class Module;
+class Profiler;
 
 class ParameterPack
 {
@@ -193,12 +199,118 @@ private:
 class VM
 {
 public:
+  /**
+   * The strategy used to dispatch instructions to their handlers
+   *
+   * HANDLER_TABLE - every instruction is looked up in the opcode handler table
+   * THREADED      - the function instructions are pre-decoded into a stream of jump targets which
+   *                 are dispatched with computed goto (or a switch when it is not available)
+   */
+  enum class DispatchMode
+  {
+    HANDLER_TABLE,
+    THREADED
+  };
+
+  /**
+   * The limits on the resources that a single execution can use. The stacks are grown on demand
+   * up to these limits, so raising them does not make the VM more expensive to construct.
+   */
+  struct Limits
+  {
+    std::size_t stack_size;        ///< The maximum number of variables and temporaries
+    std::size_t frame_stack_size;  ///< The maximum depth of user function calls
+    std::size_t max_live_objects;  ///< The maximum number of object variables in scope
+    std::size_t max_range_loops;   ///< The maximum depth of nested range loops
+  };
+
+  static Limits DefaultLimits();
+
+  /**
+   * The dispatch tables which a VM is set up from. They only depend on the bindings of the module,
+   * so they are built once and shared by all the VMs constructed from it (see Module::vm_tables).
+   */
+  struct Tables
+  {
+    std::vector<OpcodeHandler> handlers;
+    std::vector<std::string>   names;    ///< The names of the opcodes, for the profiler
+    std::vector<ChargeAmount>  charges;  ///< The charge for each opcode
+    RegisteredTypes            registered_types;
+  };
+
+  using TablesPtr = std::shared_ptr<Tables const>;
+
+  static TablesPtr CreateTables(Module const &module);
+
   VM(Module *module);
-  ~VM() = default;
+  VM(Module *module, Limits const &limits);
+  ~VM();
+
+  void LoadModule(Module const &module);
+
+  Limits const &limits() const
+  {
+    return limits_;
+  }
+
+  void Reset();
+
+  /**
+   * Get the number of objects allocated by the executions of this VM which are still referenced
+   *
+   * @return The number of live objects
+   */
+  std::size_t live_objects() const
+  {
+    return arena_->live_blocks();
+  }
+
+  /// @name Charges
+  /// @{
+
+  /**
+   * Set the maximum charge that a single execution may use before it is aborted. Every instruction
+   * is charged according to the charge table of the module, and allocating objects is charged one
+   * unit per ObjectArena::GRANULARITY bytes.
+   *
+   * @param limit The maximum charge, or zero for no limit
+   */
+  void SetChargeLimit(ChargeAmount limit)
+  {
+    charge_limit_ = (limit != 0) ? limit : std::numeric_limits<ChargeAmount>::max();
+  }
+
+  ChargeAmount charge_limit() const
+  {
+    return (charge_limit_ != std::numeric_limits<ChargeAmount>::max()) ? charge_limit_ : 0;
+  }
+
+  /**
+   * Get the charge used by the current (or last) execution
+   *
+   * @return The charge total
+   */
+  ChargeAmount charge_total() const
+  {
+    return charge_total_;
+  }
+
+  void IncreaseChargeTotal(ChargeAmount amount);
+  /// @}
+
+  DispatchMode dispatch_mode() const
+  {
+    return dispatch_mode_;
+  }
+
+  void SetDispatchMode(DispatchMode mode)
+  {
+    dispatch_mode_ = mode;
+  }
 
   RegisteredTypes const &registered_types() const
   {
-    return registered_types_;
+    return tables_->registered_types;
   }
 
   template <typename... Ts>
@@ -206,7 +318,7 @@ public:
                std::string &console_output, Variant &output, Ts const &... parameters)
 
   {
-    ParameterPack parameter_pack{registered_types_};
+    ParameterPack parameter_pack{tables_->registered_types};
 
     if (!parameter_pack.Add(parameters...))
     {
@@ -227,7 +339,11 @@ public:
     {
       auto const num_parameters = static_cast<std::size_t>(f->num_parameters);
 
-      if (parameters.size() == num_parameters)
+      if (!ReserveStack(static_cast<std::size_t>(f->num_variables)))
+      {
+        error = "stack overflow";
+      }
+      else if (parameters.size() == num_parameters)
       {
         // loop through the parameters, type check and populate the stack
         for (std::size_t i = 0; i < num_parameters; ++i)
@@ -277,7 +393,7 @@ public:
   template <typename T>
   TypeId GetTypeId()
   {
-    return registered_types_.GetTypeId(std::type_index(typeid(T)));
+    return tables_->registered_types.GetTypeId(std::type_index(typeid(T)));
   }
 
   template <typename T, typename... Args>
@@ -302,16 +418,24 @@ public:
     return *io_observer_;
   }
 
+  /// @name Profiling
+  /// @{
+  void SetProfiler(Profiler *profiler);
+
+  Profiler *profiler() const
+  {
+    return profiler_;
+  }
+  /// @}
+
   void AddOutputLine(std::string const &line)
   {
     output_buffer_ << line << '\n';
   }
 
 private:
-  static const int FRAME_STACK_SIZE = 50;
-  static const int STACK_SIZE       = 5000;
-  static const int MAX_LIVE_OBJECTS = 200;
-  static const int MAX_RANGE_LOOPS  = 50;
+  static constexpr std::size_t INITIAL_STACK_SIZE     = 64;
+  static constexpr std::size_t INITIAL_AUXILIARY_SIZE = 8;
 
   struct Frame
   {
@@ -335,13 +459,14 @@ private:
     int   scope_number;
   };
 
-  std::vector<OpcodeHandler> opcode_handlers_;
-  RegisteredTypes            registered_types_;
-  Script::Function const *   function_;
-  std::vector<Ptr<String>>   strings_;
-  Frame                      frame_stack_[FRAME_STACK_SIZE];
-  int                        frame_sp_;
-  int                        bsp_;
+  Limits const             limits_;
+  ObjectArena *            arena_;   ///< The pool for the objects created by the executions
+  TablesPtr                tables_;  ///< The handlers and types of the module
+  Script::Function const * function_;
+  std::vector<Ptr<String>> strings_;
+  std::vector<Frame>       frame_stack_;
+  int                      frame_sp_;
+  int                      bsp_;
 
   template <typename T>
   friend struct StackGetter;
@@ -360,14 +485,15 @@ private:
   template <typename ReturnType, typename TypeFunction, typename... Ts>
   friend struct TypeFunctionInvokerHelper;
 
-  Script const *script_;
-  Variant       stack_[STACK_SIZE];
-  int           sp_;
+  Script const *       script_;
+  std::vector<Variant> stack_;  ///< Never reallocated, so references to slots stay valid
+  int                  stack_size_{0};
+  int                  sp_;
 
-  ForRangeLoop               range_loop_stack_[MAX_RANGE_LOOPS];
-  int                        range_loop_sp_;
-  LiveObjectInfo             live_object_stack_[MAX_LIVE_OBJECTS];
-  int                        live_object_sp_;
+  std::vector<ForRangeLoop>   range_loop_stack_;
+  int                         range_loop_sp_;
+  std::vector<LiveObjectInfo> live_object_stack_;
+  int                         live_object_sp_;
   int                        pc_;
   Script::Instruction const *instruction_;
   bool                       stop_;
@@ -375,13 +501,75 @@ private:
   std::ostringstream         output_buffer_;
 
   IoObserverInterface *io_observer_{nullptr};
+  DispatchMode         dispatch_mode_{DispatchMode::THREADED};
+
+  Profiler *profiler_{nullptr};
+
+  std::vector<ChargeAmount> opcode_charges_;  ///< The charge table, indexed by opcode
+  ChargeAmount              charge_total_{0};
+  ChargeAmount              charge_limit_{std::numeric_limits<ChargeAmount>::max()};
 
   bool Execute(std::string &error, Variant &output);
+  void ExecuteHandlerTable();
+  void ExecuteThreaded();
+  void ExecuteProfiled();
+  void InvokeOpcodeHandler();
   void Destruct(int scope_number);
+  bool ReserveStack(std::size_t size);
+  void ChargeLimitReached();
+
+  /**
+   * Charge for the current instruction
+   *
+   * @return true if the execution is still within its charge limit, otherwise false
+   */
+  bool ChargeInstruction()
+  {
+    Opcode const opcode = instruction_->opcode;
+    if (opcode < opcode_charges_.size())
+    {
+      charge_total_ += opcode_charges_[opcode];
+    }
+    if (charge_total_ > charge_limit_)
+    {
+      ChargeLimitReached();
+      return false;
+    }
+    return true;
+  }
+  void GrowStack();
+
+  /**
+   * Make sure that an auxiliary stack has room for another entry, growing it if required
+   *
+   * @param stack The auxiliary stack
+   * @param sp The current stack pointer
+   * @param limit The maximum size of the stack
+   * @return true if there is room for the entry, otherwise false
+   */
+  template <typename T>
+  static bool ReserveNext(std::vector<T> &stack, int sp, std::size_t limit)
+  {
+    auto const required = static_cast<std::size_t>(sp + 2);
+    if (required <= stack.size())
+    {
+      return true;
+    }
+    if (required > limit)
+    {
+      return false;
+    }
+    stack.resize(std::min(std::max(required, stack.size() * 2), limit));
+    return true;
+  }
 
   Variant &Push()
   {
-    return stack_[++sp_];
+    if (++sp_ >= stack_size_)
+    {
+      GrowStack();
+    }
+    return stack_[static_cast<std::size_t>(sp_)];
   }
 
   Variant &Pop()
@@ -406,20 +594,6 @@ public:
 private:
   // fix these
 
-  void AddOpcodeHandler(OpcodeHandlerInfo const &info)
-  {
-    if (info.opcode >= opcode_handlers_.size())
-    {
-      opcode_handlers_.resize(size_t(info.opcode + 1));
-    }
-    opcode_handlers_[info.opcode] = info.handler;
-  }
-
-  void SetRegisteredTypes(RegisteredTypes const &registered_types)
-  {
-    registered_types_ = registered_types;
-  }
-
   Variant &GetVariable(Index variable_index)
   {
     return stack_[bsp_ + variable_index];
@@ -1054,48 +1228,48 @@ private:
   }
 
   template <typename Op>
-  void ExecuteIntegerAssignOp(TypeId type_id, void *lhs, Variant &rhsv)
+  void ExecuteIntegerAssignOp(TypeId type_id, void *lhs, Primitive &rhs)
   {
     switch (type_id)
     {
     case TypeIds::Int8:
     {
-      Op::Apply(this, *static_cast<int8_t *>(lhs), rhsv.primitive.i8);
+      Op::Apply(this, *static_cast<int8_t *>(lhs), rhs.i8);
       break;
     }
     case TypeIds::Byte:
     {
-      Op::Apply(this, *static_cast<uint8_t *>(lhs), rhsv.primitive.ui8);
+      Op::Apply(this, *static_cast<uint8_t *>(lhs), rhs.ui8);
       break;
     }
     case TypeIds::Int16:
     {
-      Op::Apply(this, *static_cast<int16_t *>(lhs), rhsv.primitive.i16);
+      Op::Apply(this, *static_cast<int16_t *>(lhs), rhs.i16);
       break;
     }
     case TypeIds::UInt16:
     {
-      Op::Apply(this, *static_cast<uint16_t *>(lhs), rhsv.primitive.ui16);
+      Op::Apply(this, *static_cast<uint16_t *>(lhs), rhs.ui16);
       break;
     }
     case TypeIds::Int32:
     {
-      Op::Apply(this, *static_cast<int32_t *>(lhs), rhsv.primitive.i32);
+      Op::Apply(this, *static_cast<int32_t *>(lhs), rhs.i32);
       break;
     }
     case TypeIds::UInt32:
     {
-      Op::Apply(this, *static_cast<uint32_t *>(lhs), rhsv.primitive.ui32);
+      Op::Apply(this, *static_cast<uint32_t *>(lhs), rhs.ui32);
       break;
     }
     case TypeIds::Int64:
     {
-      Op::Apply(this, *static_cast<int64_t *>(lhs), rhsv.primitive.i64);
+      Op::Apply(this, *static_cast<int64_t *>(lhs), rhs.i64);
       break;
     }
     case TypeIds::UInt64:
     {
-      Op::Apply(this, *static_cast<uint64_t *>(lhs), rhsv.primitive.ui64);
+      Op::Apply(this, *static_cast<uint64_t *>(lhs), rhs.ui64);
       break;
     }
     default:
@@ -1106,58 +1280,58 @@ private:
   }
 
   template <typename Op>
-  void ExecuteNumberAssignOp(TypeId type_id, void *lhs, Variant &rhsv)
+  void ExecuteNumberAssignOp(TypeId type_id, void *lhs, Primitive &rhs)
   {
     switch (type_id)
     {
     case TypeIds::Int8:
     {
-      Op::Apply(this, *static_cast<int8_t *>(lhs), rhsv.primitive.i8);
+      Op::Apply(this, *static_cast<int8_t *>(lhs), rhs.i8);
       break;
     }
     case TypeIds::Byte:
     {
-      Op::Apply(this, *static_cast<uint8_t *>(lhs), rhsv.primitive.ui8);
+      Op::Apply(this, *static_cast<uint8_t *>(lhs), rhs.ui8);
       break;
     }
     case TypeIds::Int16:
     {
-      Op::Apply(this, *static_cast<int16_t *>(lhs), rhsv.primitive.i16);
+      Op::Apply(this, *static_cast<int16_t *>(lhs), rhs.i16);
       break;
     }
     case TypeIds::UInt16:
     {
-      Op::Apply(this, *static_cast<uint16_t *>(lhs), rhsv.primitive.ui16);
+      Op::Apply(this, *static_cast<uint16_t *>(lhs), rhs.ui16);
       break;
     }
     case TypeIds::Int32:
     {
-      Op::Apply(this, *static_cast<int32_t *>(lhs), rhsv.primitive.i32);
+      Op::Apply(this, *static_cast<int32_t *>(lhs), rhs.i32);
       break;
     }
     case TypeIds::UInt32:
     {
-      Op::Apply(this, *static_cast<uint32_t *>(lhs), rhsv.primitive.ui32);
+      Op::Apply(this, *static_cast<uint32_t *>(lhs), rhs.ui32);
       break;
     }
     case TypeIds::Int64:
     {
-      Op::Apply(this, *static_cast<int64_t *>(lhs), rhsv.primitive.i64);
+      Op::Apply(this, *static_cast<int64_t *>(lhs), rhs.i64);
       break;
     }
     case TypeIds::UInt64:
     {
-      Op::Apply(this, *static_cast<uint64_t *>(lhs), rhsv.primitive.ui64);
+      Op::Apply(this, *static_cast<uint64_t *>(lhs), rhs.ui64);
       break;
     }
     case TypeIds::Float32:
     {
-      Op::Apply(this, *static_cast<float *>(lhs), rhsv.primitive.f32);
+      Op::Apply(this, *static_cast<float *>(lhs), rhs.f32);
       break;
     }
     case TypeIds::Float64:
     {
-      Op::Apply(this, *static_cast<double *>(lhs), rhsv.primitive.f64);
+      Op::Apply(this, *static_cast<double *>(lhs), rhs.f64);
       break;
     }
     default:
@@ -1194,7 +1368,7 @@ private:
   void DoIncDecOp(TypeId type_id, void *lhs)
   {
     Variant &rhsv = Push();
-    ExecuteIntegerAssignOp<Op>(type_id, lhs, rhsv);
+    ExecuteIntegerAssignOp<Op>(type_id, lhs, rhsv.primitive);
     rhsv.type_id = instruction_->type_id;
   }
 
@@ -1240,6 +1414,24 @@ private:
     rhsv.Reset();
   }
 
+  /**
+   * Apply an arithmetic operation to operands whose type was already known to the generator, so
+   * that no dispatch on the type id is required at runtime
+   *
+   * @tparam Op The operation to be applied
+   * @tparam T The primitive type of both of the operands
+   * @tparam member The member of the primitive which holds a value of type T
+   */
+  template <typename Op, typename T, T Primitive::*member>
+  void DoTypedNumberOp()
+  {
+    Variant &rhsv = Pop();
+    Variant &lhsv = Top();
+    Op::Apply(this, lhsv.primitive.*member, rhsv.primitive.*member);
+    // the operands are primitives, so there is never an object to be released
+    rhsv.type_id = TypeIds::Unknown;
+  }
+
   template <typename Op>
   void DoLeftOp()
   {
@@ -1286,7 +1478,7 @@ private:
   void DoIntegerAssignOp(TypeId type_id, void *lhs)
   {
     Variant &rhsv = Pop();
-    ExecuteIntegerAssignOp<Op>(type_id, lhs, rhsv);
+    ExecuteIntegerAssignOp<Op>(type_id, lhs, rhsv.primitive);
     rhsv.Reset();
   }
 
@@ -1294,7 +1486,7 @@ private:
   void DoNumberAssignOp(TypeId type_id, void *lhs)
   {
     Variant &rhsv = Pop();
-    ExecuteNumberAssignOp<Op>(type_id, lhs, rhsv);
+    ExecuteNumberAssignOp<Op>(type_id, lhs, rhsv.primitive);
     rhsv.Reset();
   }
 
@@ -1338,6 +1530,37 @@ private:
     DoNumberAssignOp<Op>(instruction_->type_id, &variable.primitive);
   }
 
+  template <typename Op>
+  void DoVariableInPlaceIncDecOp()
+  {
+    Variant & variable = GetVariable(instruction_->index);
+    Primitive unused;
+    unused.Zero();
+    ExecuteIntegerAssignOp<Op>(instruction_->type_id, &variable.primitive, unused);
+  }
+
+  template <typename Op>
+  void DoVariableConstantAssignOp()
+  {
+    Variant & variable = GetVariable(instruction_->index);
+    Primitive rhs      = instruction_->data;
+    ExecuteNumberAssignOp<Op>(instruction_->type_id, &variable.primitive, rhs);
+  }
+
+  template <typename Op>
+  void DoRelationalJumpIfFalseOp()
+  {
+    Variant &rhsv = Pop();
+    Variant &lhsv = Pop();
+    ExecuteRelationalOp<Op>(instruction_->type_id, lhsv, rhsv);
+    if (lhsv.primitive.ui8 == 0)
+    {
+      pc_ = instruction_->index;
+    }
+    lhsv.Reset();
+    rhsv.Reset();
+  }
+
   template <typename Op>
   void DoVariableRightAssignOp()
   {
@@ -1523,6 +1746,44 @@ private:
   void ElementDivideAssign();
   void ElementRightDivideAssign();
   void ElementObjectDivideAssign();
+  void VariableInc();
+  void VariableDec();
+  void VariableAddConstant();
+  void VariableSubtractConstant();
+  void EqualJumpIfFalse();
+  void NotEqualJumpIfFalse();
+  void LessThanJumpIfFalse();
+  void LessThanOrEqualJumpIfFalse();
+  void GreaterThanJumpIfFalse();
+  void GreaterThanOrEqualJumpIfFalse();
+  void Int32Add();
+  void Int32Subtract();
+  void Int32Multiply();
+  void Int32Divide();
+  void Int32Modulo();
+  void UInt32Add();
+  void UInt32Subtract();
+  void UInt32Multiply();
+  void UInt32Divide();
+  void UInt32Modulo();
+  void Int64Add();
+  void Int64Subtract();
+  void Int64Multiply();
+  void Int64Divide();
+  void Int64Modulo();
+  void UInt64Add();
+  void UInt64Subtract();
+  void UInt64Multiply();
+  void UInt64Divide();
+  void UInt64Modulo();
+  void Float32Add();
+  void Float32Subtract();
+  void Float32Multiply();
+  void Float32Divide();
+  void Float64Add();
+  void Float64Subtract();
+  void Float64Multiply();
+  void Float64Divide();
 
   friend class Object;
   friend class Module;
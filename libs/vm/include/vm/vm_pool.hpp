@@ -0,0 +1,97 @@
+#pragma once
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "core/mutex.hpp"
+#include "vm/vm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace fetch {
+namespace vm {
+
+class Module;
+
+/**
+ * Keeps constructed VM instances for reuse, so that the cost of building the opcode handler table
+ * and the stacks is not paid on every contract call.
+ *
+ * The instances are grouped by the layout of the module that they were constructed from (see
+ * Module::LayoutId), since a VM only depends on the opcodes and types which its module registers.
+ * This means that callers with different module instances of the same layout, like the executors,
+ * share the same VMs. Acquired VMs are returned to the pool when the lease is destroyed.
+ */
+class VMPool
+{
+public:
+  static constexpr std::size_t DEFAULT_MAX_IDLE = 32;
+
+  /**
+   * Returns a leased VM to its pool
+   */
+  class Recycler
+  {
+  public:
+    Recycler() = default;
+    Recycler(VMPool *pool, uint32_t layout_id);
+
+    void operator()(VM *vm) const;
+
+  private:
+    VMPool * pool_{nullptr};
+    uint32_t layout_id_{0};
+  };
+
+  using Lease = std::unique_ptr<VM, Recycler>;
+
+  // Construction / Destruction
+  explicit VMPool(std::size_t max_idle = DEFAULT_MAX_IDLE);
+  VMPool(std::size_t max_idle, VM::Limits const &limits);
+  VMPool(VMPool const &) = delete;
+  VMPool(VMPool &&)      = delete;
+  ~VMPool()              = default;
+
+  Lease Acquire(Module &module);
+
+  std::size_t idle() const;
+
+  // Operators
+  VMPool &operator=(VMPool const &) = delete;
+  VMPool &operator=(VMPool &&) = delete;
+
+private:
+  using Mutex   = mutex::Mutex;
+  using VMPtr   = std::unique_ptr<VM>;
+  using VMs     = std::vector<VMPtr>;
+  using IdleVMs = std::unordered_map<uint32_t, VMs>;
+
+  void Recycle(uint32_t layout_id, VM *vm);
+
+  std::size_t const max_idle_;
+  VM::Limits const  limits_;
+  mutable Mutex     lock_{__LINE__, __FILE__};
+  IdleVMs           idle_;  ///< The VMs available for reuse, by module layout
+  std::size_t       num_idle_{0};
+};
+
+}  // namespace vm
+}  // namespace fetch
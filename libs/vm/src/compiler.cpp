@@ -53,6 +53,8 @@ bool Compiler::Compile(std::string const &source, std::string const &name, Scrip
 
   generator_.Generate(root, type_info_table, name, script);
 
+  optimiser_report_ = optimise_ ? optimiser_.Optimise(script) : Optimiser::Report{};
+
   root->Reset();
   root = nullptr;
   return true;
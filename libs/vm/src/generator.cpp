@@ -17,6 +17,8 @@
 //------------------------------------------------------------------------------
 
 #include "vm/generator.hpp"
+#include "vm/typed_opcodes.hpp"
+
 #include <sstream>
 
 namespace fetch {
@@ -1135,6 +1137,13 @@ void Generator::HandleBinaryOp(ExpressionNodePtr const &node)
   }
   }  // switch
 
+  // arithmetic on operands of a known primitive type need not dispatch on the type at runtime
+  Opcode const typed_opcode = GetTypedArithmeticOpcode(opcode, type_id);
+  if (typed_opcode != Opcodes::Unknown)
+  {
+    opcode = typed_opcode;
+  }
+
   for (size_t i = 0; i < node->children.size(); ++i)
   {
     HandleExpression(ConvertToExpressionNodePtr(node->children[i]));
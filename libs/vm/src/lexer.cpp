@@ -0,0 +1,559 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "vm/lexer.hpp"
+
+#include <cstddef>
+#include <cstring>
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define FETCH_VM_LEXER_SSE2
+#endif
+
+namespace fetch {
+namespace vm {
+namespace {
+
+using Kind = Token::Kind;
+
+enum CharacterClass : uint8_t
+{
+  OTHER = 0,
+  WHITESPACE,
+  NEWLINE,
+  DIGIT,
+  IDENTIFIER_START,
+  QUOTE,
+  AT,
+  DOT,
+  SLASH,
+  OPERATOR
+};
+
+/**
+ * The tokens which an operator character can start, alone, followed by '=' or doubled
+ */
+struct OperatorKinds
+{
+  Kind single;
+  Kind with_equals;
+  Kind doubled;
+};
+
+/**
+ * The lookup tables for the classification of the characters
+ */
+struct CharacterTable
+{
+  constexpr CharacterTable()
+    : classes{}
+    , operators{}
+  {
+    for (auto &entry : operators)
+    {
+      entry = {Kind::Unknown, Kind::Unknown, Kind::Unknown};
+    }
+    for (int c = 'a'; c <= 'z'; ++c)
+    {
+      classes[c]             = IDENTIFIER_START;
+      classes[c - 'a' + 'A'] = IDENTIFIER_START;
+    }
+    for (int c = '0'; c <= '9'; ++c)
+    {
+      classes[c] = DIGIT;
+    }
+    classes[int{'_'}]  = IDENTIFIER_START;
+    classes[int{' '}]  = WHITESPACE;
+    classes[int{'\t'}] = WHITESPACE;
+    classes[int{'\r'}] = WHITESPACE;
+    classes[int{'\n'}] = NEWLINE;
+    classes[int{'"'}]  = QUOTE;
+    classes[int{'\''}] = QUOTE;
+    classes[int{'@'}]  = AT;
+    classes[int{'.'}]  = DOT;
+    classes[int{'/'}]  = SLASH;
+
+    SetOperator(',', Kind::Comma, Kind::Unknown, Kind::Unknown);
+    SetOperator(':', Kind::Colon, Kind::Unknown, Kind::Unknown);
+    SetOperator(';', Kind::SemiColon, Kind::Unknown, Kind::Unknown);
+    SetOperator('(', Kind::LeftParenthesis, Kind::Unknown, Kind::Unknown);
+    SetOperator(')', Kind::RightParenthesis, Kind::Unknown, Kind::Unknown);
+    SetOperator('[', Kind::LeftSquareBracket, Kind::Unknown, Kind::Unknown);
+    SetOperator(']', Kind::RightSquareBracket, Kind::Unknown, Kind::Unknown);
+    SetOperator('%', Kind::Modulo, Kind::ModuloAssign, Kind::Unknown);
+    SetOperator('+', Kind::Plus, Kind::AddAssign, Kind::Inc);
+    SetOperator('-', Kind::Minus, Kind::SubtractAssign, Kind::Dec);
+    SetOperator('*', Kind::Multiply, Kind::MultiplyAssign, Kind::Unknown);
+    SetOperator('=', Kind::Assign, Kind::Equal, Kind::Unknown);
+    SetOperator('!', Kind::Not, Kind::NotEqual, Kind::Unknown);
+    SetOperator('<', Kind::LessThan, Kind::LessThanOrEqual, Kind::Unknown);
+    SetOperator('>', Kind::GreaterThan, Kind::GreaterThanOrEqual, Kind::Unknown);
+    SetOperator('&', Kind::Unknown, Kind::Unknown, Kind::And);
+    SetOperator('|', Kind::Unknown, Kind::Unknown, Kind::Or);
+  }
+
+  constexpr void SetOperator(char c, Kind single, Kind with_equals, Kind doubled)
+  {
+    classes[int(c)]   = OPERATOR;
+    operators[int(c)] = {single, with_equals, doubled};
+  }
+
+  CharacterClass classes[256];
+  OperatorKinds  operators[256];
+};
+
+constexpr CharacterTable CHARACTERS{};
+
+struct Keyword
+{
+  char const *text;
+  std::size_t length;
+  Kind        kind;
+};
+
+constexpr std::size_t MAX_KEYWORD_LENGTH = 11;
+
+constexpr Keyword KEYWORDS[] = {
+    {"true", 4, Kind::True},
+    {"false", 5, Kind::False},
+    {"null", 4, Kind::Null},
+    {"function", 8, Kind::Function},
+    {"endfunction", 11, Kind::EndFunction},
+    {"while", 5, Kind::While},
+    {"endwhile", 8, Kind::EndWhile},
+    {"for", 3, Kind::For},
+    {"in", 2, Kind::In},
+    {"endfor", 6, Kind::EndFor},
+    {"if", 2, Kind::If},
+    {"elseif", 6, Kind::ElseIf},
+    {"else", 4, Kind::Else},
+    {"endif", 5, Kind::EndIf},
+    {"var", 3, Kind::Var},
+    {"return", 6, Kind::Return},
+    {"break", 5, Kind::Break},
+    {"continue", 8, Kind::Continue}};
+
+CharacterClass ClassOf(char c)
+{
+  return CHARACTERS.classes[static_cast<uint8_t>(c)];
+}
+
+bool IsDigit(char c)
+{
+  return ClassOf(c) == DIGIT;
+}
+
+bool IsIdentifierCharacter(char c)
+{
+  CharacterClass const character_class = ClassOf(c);
+  return (character_class == IDENTIFIER_START) || (character_class == DIGIT);
+}
+
+Kind KeywordKind(char const *text, std::size_t length)
+{
+  if (length <= MAX_KEYWORD_LENGTH)
+  {
+    for (auto const &keyword : KEYWORDS)
+    {
+      if ((keyword.length == length) && (keyword.text[0] == text[0]) &&
+          (std::memcmp(keyword.text, text, length) == 0))
+      {
+        return keyword.kind;
+      }
+    }
+  }
+  return Kind::Identifier;
+}
+
+char const *SkipDigits(char const *p, char const *end)
+{
+  while ((p < end) && IsDigit(*p))
+  {
+    ++p;
+  }
+  return p;
+}
+
+#ifdef FETCH_VM_LEXER_SSE2
+constexpr std::ptrdiff_t BLOCK_SIZE = 16;
+
+__m128i Load(char const *p)
+{
+  return _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+}
+
+__m128i InRange(__m128i block, char lower, char upper)
+{
+  // the characters above 0x7f are negative, so they are outside of all the (ASCII) ranges
+  return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(static_cast<char>(lower - 1))),
+                       _mm_cmplt_epi8(block, _mm_set1_epi8(static_cast<char>(upper + 1))));
+}
+
+/// The offset of the first character in the block which does not match, or BLOCK_SIZE
+std::ptrdiff_t FirstMismatch(__m128i matches)
+{
+  auto const mask = static_cast<unsigned>(_mm_movemask_epi8(matches));
+  return (mask == 0xFFFFu) ? BLOCK_SIZE : __builtin_ctz(~mask);
+}
+#endif
+
+/// Skip the characters which can continue an identifier
+char const *SkipIdentifierCharacters(char const *p, char const *end)
+{
+#ifdef FETCH_VM_LEXER_SSE2
+  while ((end - p) >= BLOCK_SIZE)
+  {
+    __m128i const block = Load(p);
+
+    // setting bit 5 folds the upper case letters onto the lower case ones (and nothing else)
+    __m128i const letters    = InRange(_mm_or_si128(block, _mm_set1_epi8(0x20)), 'a', 'z');
+    __m128i const digits     = InRange(block, '0', '9');
+    __m128i const underscore = _mm_cmpeq_epi8(block, _mm_set1_epi8('_'));
+
+    std::ptrdiff_t const offset =
+        FirstMismatch(_mm_or_si128(_mm_or_si128(letters, digits), underscore));
+    p += offset;
+    if (offset != BLOCK_SIZE)
+    {
+      return p;
+    }
+  }
+#endif
+  while ((p < end) && IsIdentifierCharacter(*p))
+  {
+    ++p;
+  }
+  return p;
+}
+
+/// Skip spaces, tabs and carriage returns (newlines are counted by the caller)
+char const *SkipWhitespace(char const *p, char const *end)
+{
+#ifdef FETCH_VM_LEXER_SSE2
+  while ((end - p) >= BLOCK_SIZE)
+  {
+    __m128i const block = Load(p);
+    __m128i const spaces =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),
+                                  _mm_cmpeq_epi8(block, _mm_set1_epi8('\t'))),
+                     _mm_cmpeq_epi8(block, _mm_set1_epi8('\r')));
+
+    std::ptrdiff_t const offset = FirstMismatch(spaces);
+    p += offset;
+    if (offset != BLOCK_SIZE)
+    {
+      return p;
+    }
+  }
+#endif
+  while ((p < end) && (ClassOf(*p) == WHITESPACE))
+  {
+    ++p;
+  }
+  return p;
+}
+
+/// Find the next star or newline inside a block comment
+char const *FindStarOrNewline(char const *p, char const *end)
+{
+#ifdef FETCH_VM_LEXER_SSE2
+  while ((end - p) >= BLOCK_SIZE)
+  {
+    __m128i const block = Load(p);
+    __m128i const found = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('*')),
+                                       _mm_cmpeq_epi8(block, _mm_set1_epi8('\n')));
+
+    auto const mask = static_cast<unsigned>(_mm_movemask_epi8(found));
+    if (mask != 0)
+    {
+      return p + __builtin_ctz(mask);
+    }
+    p += BLOCK_SIZE;
+  }
+#endif
+  while ((p < end) && (*p != '*') && (*p != '\n'))
+  {
+    ++p;
+  }
+  return p;
+}
+
+}  // namespace
+
+/**
+ * Split the source text into tokens, the last of which is always EndOfInput
+ *
+ * @param source The source text, which ends at the first NUL character (if any)
+ * @param tokens The tokens of the source
+ */
+void Lexer::Tokenise(std::string const &source, Tokens &tokens)
+{
+  begin_  = source.c_str();
+  end_    = begin_ + std::strlen(begin_);
+  line_   = 1;
+  tokens_ = &tokens;
+  tokens.clear();
+
+  char const *p = begin_;
+  while (p < end_)
+  {
+    start_ = p;
+    switch (ClassOf(*p))
+    {
+    case WHITESPACE:
+      p = SkipWhitespace(p + 1, end_);
+      break;
+    case NEWLINE:
+      ++line_;
+      ++p;
+      break;
+    case DIGIT:
+      p = ScanNumber(p);
+      break;
+    case IDENTIFIER_START:
+      p = ScanIdentifier(p, Kind::Identifier);
+      break;
+    case QUOTE:
+      p = ScanString(p);
+      break;
+    case AT:
+      p = ((p + 1 < end_) && (ClassOf(p[1]) == IDENTIFIER_START))
+              ? ScanIdentifier(p + 1, Kind::AnnotationIdentifier)
+              : Emit(Kind::Unknown, p + 1);
+      break;
+    case DOT:
+      p = ((p + 1 < end_) && IsDigit(p[1])) ? ScanNumber(p) : Emit(Kind::Dot, p + 1);
+      break;
+    case SLASH:
+      if ((p + 1 < end_) && (p[1] == '*'))
+      {
+        p = SkipBlockComment(p + 2);
+      }
+      else if ((p + 1 < end_) && (p[1] == '/'))
+      {
+        p = SkipLineComment(p + 2);
+      }
+      else
+      {
+        bool const assign = (p + 1 < end_) && (p[1] == '=');
+        p = assign ? Emit(Kind::DivideAssign, p + 2) : Emit(Kind::Divide, p + 1);
+      }
+      break;
+    case OPERATOR:
+      p = ScanOperator(p);
+      break;
+    case OTHER:
+      p = Emit(Kind::Unknown, p + 1);
+      break;
+    }
+  }
+
+  start_ = end_;
+  Emit(Kind::EndOfInput, end_);
+}
+
+/**
+ * Scan an integer (with an optional width suffix like "u64") or a real number (with an optional
+ * exponent and "f" suffix). Numbers may start with a decimal point, as in ".5".
+ */
+char const *Lexer::ScanNumber(char const *p)
+{
+  char const *q           = SkipDigits(p, end_);
+  bool const  has_integer = q != p;
+  bool        is_real     = false;
+
+  if ((q < end_) && (*q == '.'))
+  {
+    char const *fraction = SkipDigits(q + 1, end_);
+    if (has_integer || (fraction != q + 1))
+    {
+      q       = fraction;
+      is_real = true;
+    }
+  }
+
+  if ((q < end_) && ((*q == 'e') || (*q == 'E')))
+  {
+    char const *exponent = q + 1;
+    if ((exponent < end_) && ((*exponent == '+') || (*exponent == '-')))
+    {
+      ++exponent;
+    }
+    char const *exponent_end = SkipDigits(exponent, end_);
+    if (exponent_end != exponent)
+    {
+      q       = exponent_end;
+      is_real = true;
+    }
+  }
+
+  if (is_real)
+  {
+    return ((q < end_) && (*q == 'f')) ? Emit(Kind::Float32, q + 1) : Emit(Kind::Float64, q);
+  }
+
+  if ((q + 1 < end_) && ((*q == 'i') || (*q == 'u')))
+  {
+    bool const is_signed = *q == 'i';
+    if (q[1] == '8')
+    {
+      return Emit(is_signed ? Kind::Integer8 : Kind::UnsignedInteger8, q + 2);
+    }
+    if (q + 2 < end_)
+    {
+      if ((q[1] == '1') && (q[2] == '6'))
+      {
+        return Emit(is_signed ? Kind::Integer16 : Kind::UnsignedInteger16, q + 3);
+      }
+      if ((q[1] == '3') && (q[2] == '2'))
+      {
+        return Emit(is_signed ? Kind::Integer32 : Kind::UnsignedInteger32, q + 3);
+      }
+      if ((q[1] == '6') && (q[2] == '4'))
+      {
+        return Emit(is_signed ? Kind::Integer64 : Kind::UnsignedInteger64, q + 3);
+      }
+    }
+  }
+
+  return Emit(Kind::Integer32, q);
+}
+
+/**
+ * Scan a string literal. A string which runs into the end of the line is a BadString (which
+ * includes the newline), while one which runs into the end of the input (or into a backslash which
+ * escapes nothing) leaves the quote as an Unknown token.
+ */
+char const *Lexer::ScanString(char const *p)
+{
+  char const  quote = *p;
+  char const *q     = p + 1;
+  while (q < end_)
+  {
+    char const c = *q;
+    if (c == quote)
+    {
+      return Emit(Kind::String, q + 1);
+    }
+    if (c == '\n')
+    {
+      Emit(Kind::BadString, q + 1);
+      ++line_;
+      return q + 1;
+    }
+    if (c == '\\')
+    {
+      if ((q + 1 == end_) || (q[1] == '\n'))
+      {
+        break;
+      }
+      ++q;
+    }
+    ++q;
+  }
+  return Emit(Kind::Unknown, p + 1);
+}
+
+/**
+ * Scan an identifier or a keyword, the first character of which has already been checked
+ */
+char const *Lexer::ScanIdentifier(char const *p, Kind kind)
+{
+  char const *q = SkipIdentifierCharacters(p + 1, end_);
+  if (kind == Kind::Identifier)
+  {
+    kind = KeywordKind(p, static_cast<std::size_t>(q - p));
+  }
+  return Emit(kind, q);
+}
+
+char const *Lexer::ScanOperator(char const *p)
+{
+  OperatorKinds const &kinds = CHARACTERS.operators[static_cast<uint8_t>(*p)];
+  if (p + 1 < end_)
+  {
+    if ((p[1] == '=') && (kinds.with_equals != Kind::Unknown))
+    {
+      return Emit(kinds.with_equals, p + 2);
+    }
+    if ((p[1] == *p) && (kinds.doubled != Kind::Unknown))
+    {
+      return Emit(kinds.doubled, p + 2);
+    }
+  }
+  return Emit(kinds.single, p + 1);
+}
+
+/**
+ * Skip the rest of a block comment, which is unterminated if it runs into the end of the input
+ */
+char const *Lexer::SkipBlockComment(char const *p)
+{
+  for (;;)
+  {
+    p = FindStarOrNewline(p, end_);
+    if (p == end_)
+    {
+      return p;
+    }
+    if (*p == '\n')
+    {
+      ++line_;
+    }
+    else if ((p + 1 < end_) && (p[1] == '/'))
+    {
+      return p + 2;
+    }
+    ++p;
+  }
+}
+
+char const *Lexer::SkipLineComment(char const *p)
+{
+  auto const *newline =
+      static_cast<char const *>(std::memchr(p, '\n', static_cast<std::size_t>(end_ - p)));
+  if (newline == nullptr)
+  {
+    return end_;
+  }
+  ++line_;
+  return newline + 1;
+}
+
+/**
+ * Add the token which runs from the start of the current token
+ *
+ * @param kind The kind of the token
+ * @param end The end of the token
+ * @return The end of the token
+ */
+char const *Lexer::Emit(Kind kind, char const *end)
+{
+  tokens_->emplace_back();
+  Token &token = tokens_->back();
+  token.kind   = kind;
+  token.offset = static_cast<uint32_t>(start_ - begin_);
+  token.line   = line_;
+  token.length = static_cast<uint16_t>(end - start_);
+  token.text.assign(start_, end);
+  return end;
+}
+
+}  // namespace vm
+}  // namespace fetch
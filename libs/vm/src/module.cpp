@@ -22,10 +22,8 @@ namespace fetch {
 namespace vm {
 
 Module::Module()
+  : bindings_{std::make_shared<Bindings>()}
 {
-  next_type_id_ = TypeIds::NumReserved;
-  next_opcode_  = Opcodes::NumReserved;
-
   RegisterType(TypeIndex(typeid(TemplateParameter)), TypeIds::TemplateParameter1);
   RegisterType(TypeIndex(typeid(TemplateParameter1)), TypeIds::TemplateParameter1);
   RegisterType(TypeIndex(typeid(TemplateParameter2)), TypeIds::TemplateParameter2);
@@ -42,11 +40,15 @@ Module::Module()
   RegisterType(TypeIndex(typeid(uint64_t)), TypeIds::UInt64);
   RegisterType(TypeIndex(typeid(float)), TypeIds::Float32);
   RegisterType(TypeIndex(typeid(double)), TypeIds::Float64);
-  RegisterClassType<String>(TypeIds::String);
+  RegisterClassType<String>(TypeIds::String, "String");
 
-  RegisterTemplateType<IMatrix>(TypeIds::IMatrix).CreateTypeConstuctor<int32_t, int32_t>();
+  auto imatrix = RegisterTemplateType<IMatrix>(TypeIds::IMatrix, "Matrix");
+  imatrix.CreateTypeConstuctor<int32_t, int32_t>();
+  imatrix.CreateInstanceFunction("rows", &IMatrix::Rows);
+  imatrix.CreateInstanceFunction("columns", &IMatrix::Columns);
+  imatrix.CreateInstanceFunction("transpose", &IMatrix::Transpose);
 
-  auto iarray = RegisterTemplateType<IArray>(TypeIds::IArray);
+  auto iarray = RegisterTemplateType<IArray>(TypeIds::IArray, "Array");
   iarray.CreateTypeConstuctor<int32_t>();
   iarray.CreateInstanceFunction("count", &IArray::Count);
 
@@ -63,16 +65,16 @@ Module::Module()
   CreateTemplateInstantiationType<Array, double>(TypeIds::IArray);
   CreateTemplateInstantiationType<Array, Ptr<String>>(TypeIds::IArray);
 
-  auto imap = RegisterTemplateType<IMap>(TypeIds::IMap);
+  auto imap = RegisterTemplateType<IMap>(TypeIds::IMap, "Map");
   imap.CreateTypeConstuctor<>();
   imap.CreateInstanceFunction("count", &IMap::Count);
 
-  auto address = RegisterClassType<Address>(TypeIds::Address);
+  auto address = RegisterClassType<Address>(TypeIds::Address, "Address");
   address.CreateTypeConstuctor<>();
   address.CreateTypeConstuctor<Ptr<String>>();
   address.CreateInstanceFunction("signed_tx", &Address::HasSignedTx);
 
-  auto istate = RegisterTemplateType<IState>(TypeIds::IState);
+  auto istate = RegisterTemplateType<IState>(TypeIds::IState, "State");
   istate.CreateTypeConstuctor<Ptr<String>, TemplateParameter>();
   istate.CreateTypeConstuctor<Ptr<Address>, TemplateParameter>();
   istate.CreateInstanceFunction("get", &IState::Get);
@@ -80,5 +82,48 @@ Module::Module()
   istate.CreateInstanceFunction("existed", &IState::Existed);
 }
 
+/**
+ * Construct a module which shares the bindings of another one. Registering anything with either
+ * module afterwards gives it its own copy of the bindings.
+ *
+ * @param other The module to be copied
+ */
+Module::Module(Module const &other)
+  : bindings_{other.bindings_}
+  , vm_tables_{std::atomic_load(&other.vm_tables_)}
+{}
+
+/**
+ * Get the tables which the VMs for this module are set up from, building them on first use
+ *
+ * @return The VM tables
+ */
+VM::TablesPtr Module::vm_tables() const
+{
+  VM::TablesPtr tables = std::atomic_load(&vm_tables_);
+  if (!tables)
+  {
+    // concurrent callers might both build the tables, but they are identical
+    tables = VM::CreateTables(*this);
+    std::atomic_store(&vm_tables_, tables);
+  }
+  return tables;
+}
+
+/**
+ * Get the bindings for modification, copying them first if they are shared with another module
+ *
+ * @return The bindings of this module
+ */
+Module::Bindings &Module::MutableBindings()
+{
+  if (bindings_.use_count() > 1)
+  {
+    bindings_ = std::make_shared<Bindings>(*bindings_);
+  }
+  std::atomic_store(&vm_tables_, VM::TablesPtr{});
+  return *bindings_;
+}
+
 }  // namespace vm
 }  // namespace fetch
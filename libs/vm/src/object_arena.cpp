@@ -0,0 +1,219 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+#include "vm/object_arena.hpp"
+
+#include <cassert>
+#include <new>
+
+namespace fetch {
+namespace vm {
+
+constexpr std::size_t ObjectArena::CHUNK_SIZE;
+constexpr std::size_t ObjectArena::GRANULARITY;
+constexpr std::size_t ObjectArena::MAX_BLOCK_SIZE;
+constexpr std::size_t ObjectArena::MAX_RETAINED_CHUNKS;
+constexpr std::size_t ObjectArena::NUM_SIZE_CLASSES;
+
+thread_local ObjectArena *ObjectArena::current_{nullptr};
+
+ObjectArena::Scope::Scope(ObjectArena *arena)
+  : previous_{current_}
+{
+  current_ = arena;
+}
+
+ObjectArena::Scope::~Scope()
+{
+  current_ = previous_;
+}
+
+ObjectArena::ObjectArena()
+{
+  free_blocks_.fill(nullptr);
+}
+
+/**
+ * Create a new arena, to be released by its owner
+ *
+ * @return The new arena
+ */
+ObjectArena *ObjectArena::Create()
+{
+  return new ObjectArena;
+}
+
+/**
+ * Signal that the owner has finished with the arena. It is destroyed straight away unless some of
+ * its blocks are still in use, in which case it is destroyed when the last of them is freed.
+ */
+void ObjectArena::Release()
+{
+  assert(!released_);
+  released_ = true;
+
+  if (live_blocks_ == 0)
+  {
+    delete this;
+  }
+}
+
+/**
+ * Rewind the arena so that its chunks can be reused from the start. This only has an effect when
+ * there are no live blocks, objects which are still referenced are never moved or invalidated.
+ */
+void ObjectArena::Reset()
+{
+  if (live_blocks_ != 0)
+  {
+    return;
+  }
+
+  if (chunks_.size() > MAX_RETAINED_CHUNKS)
+  {
+    chunks_.resize(MAX_RETAINED_CHUNKS);
+  }
+
+  chunk_index_ = 0;
+  offset_      = 0;
+  free_blocks_.fill(nullptr);
+}
+
+/**
+ * Allocate the memory for an object, from the arena of the current scope if there is one
+ *
+ * @param size The size of the object in bytes
+ * @return The pointer to the memory for the object
+ */
+void *ObjectArena::Allocate(std::size_t size)
+{
+  std::size_t const block_size =
+      ((size + sizeof(Header) + GRANULARITY - 1) / GRANULARITY) * GRANULARITY;
+
+  Header *header{nullptr};
+
+  if ((current_ != nullptr) && (current_->allocation_counter_ != nullptr))
+  {
+    *current_->allocation_counter_ += block_size / GRANULARITY;
+  }
+
+  if ((current_ != nullptr) && (block_size <= MAX_BLOCK_SIZE))
+  {
+    header = current_->AllocateBlock(block_size);
+  }
+  else
+  {
+    header             = static_cast<Header *>(::operator new(block_size));
+    header->arena      = nullptr;
+    header->size_class = 0;
+  }
+
+  return header + 1;
+}
+
+/**
+ * Free the memory of an object, returning it to the arena that it was allocated from
+ *
+ * @param ptr The pointer to the memory of the object
+ */
+void ObjectArena::Deallocate(void *ptr) noexcept
+{
+  if (ptr == nullptr)
+  {
+    return;
+  }
+
+  Header *header = static_cast<Header *>(ptr) - 1;
+
+  if (header->arena != nullptr)
+  {
+    header->arena->RecycleBlock(header);
+  }
+  else
+  {
+    ::operator delete(header);
+  }
+}
+
+/**
+ * Take a block from the free list of its size class, or failing that from the current chunk
+ *
+ * @param block_size The size of the block (including the header)
+ * @return The header of the block
+ */
+ObjectArena::Header *ObjectArena::AllocateBlock(std::size_t block_size)
+{
+  std::size_t const size_class = (block_size / GRANULARITY) - 1;
+
+  Header *header{nullptr};
+
+  FreeBlock *&free_block = free_blocks_[size_class];
+  if (free_block != nullptr)
+  {
+    header     = reinterpret_cast<Header *>(free_block);
+    free_block = free_block->next;
+  }
+  else
+  {
+    // move on to the next chunk when the current one has been used up
+    if (chunk_index_ < chunks_.size() && (offset_ + block_size > CHUNK_SIZE))
+    {
+      ++chunk_index_;
+      offset_ = 0;
+    }
+
+    if (chunk_index_ == chunks_.size())
+    {
+      chunks_.emplace_back(new uint8_t[CHUNK_SIZE]);
+      offset_ = 0;
+    }
+
+    header = reinterpret_cast<Header *>(chunks_[chunk_index_].get() + offset_);
+    offset_ += block_size;
+  }
+
+  header->arena      = this;
+  header->size_class = size_class;
+  ++live_blocks_;
+
+  return header;
+}
+
+/**
+ * Return a block to the free list of its size class
+ *
+ * @param header The header of the block
+ */
+void ObjectArena::RecycleBlock(Header *header) noexcept
+{
+  assert(live_blocks_ > 0);
+
+  std::size_t const size_class = header->size_class;
+
+  // the free list link overlays the header, which is rewritten on allocation
+  auto *block              = reinterpret_cast<FreeBlock *>(header);
+  block->next              = free_blocks_[size_class];
+  free_blocks_[size_class] = block;
+
+  if ((--live_blocks_ == 0) && released_)
+  {
+    delete this;
+  }
+}
+
+}  // namespace vm
+}  // namespace fetch
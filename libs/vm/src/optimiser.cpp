@@ -0,0 +1,676 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "vm/optimiser.hpp"
+#include "vm/opcodes.hpp"
+#include "vm/typed_opcodes.hpp"
+#include "vm/typeids.hpp"
+
+#include <cstdint>
+
+namespace fetch {
+namespace vm {
+namespace {
+
+using Instruction  = Script::Instruction;
+using Instructions = Script::Instructions;
+
+bool IsJump(Opcode opcode)
+{
+  switch (opcode)
+  {
+  case Opcodes::Break:
+  case Opcodes::Continue:
+  case Opcodes::Jump:
+  case Opcodes::JumpIfFalse:
+  case Opcodes::JumpIfTrue:
+  case Opcodes::ForRangeIterate:
+  case Opcodes::EqualJumpIfFalse:
+  case Opcodes::NotEqualJumpIfFalse:
+  case Opcodes::LessThanJumpIfFalse:
+  case Opcodes::LessThanOrEqualJumpIfFalse:
+  case Opcodes::GreaterThanJumpIfFalse:
+  case Opcodes::GreaterThanOrEqualJumpIfFalse:
+  {
+    return true;
+  }
+  default:
+  {
+    return false;
+  }
+  }  // switch
+}
+
+// Determine if the opcode reads the variable given by the instruction index
+bool ReadsVariable(Opcode opcode)
+{
+  switch (opcode)
+  {
+  case Opcodes::PushVariable:
+  case Opcodes::ForRangeInit:
+  case Opcodes::ForRangeTerminate:
+  case Opcodes::VariablePrefixInc:
+  case Opcodes::VariablePrefixDec:
+  case Opcodes::VariablePostfixInc:
+  case Opcodes::VariablePostfixDec:
+  case Opcodes::VariableModuloAssign:
+  case Opcodes::VariableAddAssign:
+  case Opcodes::VariableRightAddAssign:
+  case Opcodes::VariableObjectAddAssign:
+  case Opcodes::VariableSubtractAssign:
+  case Opcodes::VariableRightSubtractAssign:
+  case Opcodes::VariableObjectSubtractAssign:
+  case Opcodes::VariableMultiplyAssign:
+  case Opcodes::VariableRightMultiplyAssign:
+  case Opcodes::VariableObjectMultiplyAssign:
+  case Opcodes::VariableDivideAssign:
+  case Opcodes::VariableRightDivideAssign:
+  case Opcodes::VariableObjectDivideAssign:
+  case Opcodes::VariableInc:
+  case Opcodes::VariableDec:
+  case Opcodes::VariableAddConstant:
+  case Opcodes::VariableSubtractConstant:
+  {
+    return true;
+  }
+  default:
+  {
+    return false;
+  }
+  }  // switch
+}
+
+// Determine if the opcode only pushes a value on to the stack without any other side effects
+bool IsPurePush(Opcode opcode)
+{
+  return (opcode == Opcodes::PushConstant) || (opcode == Opcodes::PushString) ||
+         (opcode == Opcodes::PushNull) || (opcode == Opcodes::PushVariable);
+}
+
+bool IsPrimitiveType(TypeId type_id)
+{
+  return (type_id >= TypeIds::Bool) && (type_id <= TypeIds::Float64);
+}
+
+bool IsNumberType(TypeId type_id)
+{
+  return (type_id >= TypeIds::Int8) && (type_id <= TypeIds::Float64);
+}
+
+Opcode GetRelationalJumpOpcode(Opcode opcode)
+{
+  switch (opcode)
+  {
+  case Opcodes::Equal:
+  {
+    return Opcodes::EqualJumpIfFalse;
+  }
+  case Opcodes::NotEqual:
+  {
+    return Opcodes::NotEqualJumpIfFalse;
+  }
+  case Opcodes::LessThan:
+  {
+    return Opcodes::LessThanJumpIfFalse;
+  }
+  case Opcodes::LessThanOrEqual:
+  {
+    return Opcodes::LessThanOrEqualJumpIfFalse;
+  }
+  case Opcodes::GreaterThan:
+  {
+    return Opcodes::GreaterThanJumpIfFalse;
+  }
+  case Opcodes::GreaterThanOrEqual:
+  {
+    return Opcodes::GreaterThanOrEqualJumpIfFalse;
+  }
+  default:
+  {
+    return Opcodes::Unknown;
+  }
+  }  // switch
+}
+
+/**
+ * Apply an arithmetic operation to a pair of constants in the same way as the VM would at runtime
+ *
+ * @param type_id The type of both of the operands
+ * @param lhs The left hand operand, which is replaced with the result
+ * @param rhs The right hand operand
+ * @param op The operation to be applied
+ * @return true if the type could be folded, otherwise false
+ */
+template <typename Op>
+bool FoldNumberOp(TypeId type_id, Primitive &lhs, Primitive const &rhs, Op const &op)
+{
+  switch (type_id)
+  {
+  case TypeIds::Int8:
+  {
+    lhs.i8 = static_cast<int8_t>(op(lhs.i8, rhs.i8));
+    return true;
+  }
+  case TypeIds::Byte:
+  {
+    lhs.ui8 = static_cast<uint8_t>(op(lhs.ui8, rhs.ui8));
+    return true;
+  }
+  case TypeIds::Int16:
+  {
+    lhs.i16 = static_cast<int16_t>(op(lhs.i16, rhs.i16));
+    return true;
+  }
+  case TypeIds::UInt16:
+  {
+    lhs.ui16 = static_cast<uint16_t>(op(lhs.ui16, rhs.ui16));
+    return true;
+  }
+  case TypeIds::Int32:
+  {
+    lhs.i32 = static_cast<int32_t>(op(lhs.i32, rhs.i32));
+    return true;
+  }
+  case TypeIds::UInt32:
+  {
+    lhs.ui32 = static_cast<uint32_t>(op(lhs.ui32, rhs.ui32));
+    return true;
+  }
+  case TypeIds::Int64:
+  {
+    lhs.i64 = static_cast<int64_t>(op(lhs.i64, rhs.i64));
+    return true;
+  }
+  case TypeIds::UInt64:
+  {
+    lhs.ui64 = static_cast<uint64_t>(op(lhs.ui64, rhs.ui64));
+    return true;
+  }
+  case TypeIds::Float32:
+  {
+    lhs.f32 = static_cast<float>(op(lhs.f32, rhs.f32));
+    return true;
+  }
+  case TypeIds::Float64:
+  {
+    lhs.f64 = static_cast<double>(op(lhs.f64, rhs.f64));
+    return true;
+  }
+  default:
+  {
+    return false;
+  }
+  }  // switch
+}
+
+bool FoldBinaryOp(Opcode opcode, TypeId type_id, Primitive &lhs, Primitive const &rhs)
+{
+  // division and modulo are left to the VM since they can raise runtime errors
+  switch (GetGenericArithmeticOpcode(opcode))
+  {
+  case Opcodes::Add:
+  {
+    return FoldNumberOp(type_id, lhs, rhs, [](auto a, auto b) { return a + b; });
+  }
+  case Opcodes::Subtract:
+  {
+    return FoldNumberOp(type_id, lhs, rhs, [](auto a, auto b) { return a - b; });
+  }
+  case Opcodes::Multiply:
+  {
+    return FoldNumberOp(type_id, lhs, rhs, [](auto a, auto b) { return a * b; });
+  }
+  default:
+  {
+    return false;
+  }
+  }  // switch
+}
+
+bool FoldUnaryOp(Opcode opcode, TypeId type_id, Primitive &value)
+{
+  switch (opcode)
+  {
+  case Opcodes::UnaryMinus:
+  {
+    return FoldNumberOp(type_id, value, value, [](auto a, auto /*b*/) { return -a; });
+  }
+  case Opcodes::Not:
+  {
+    if (type_id != TypeIds::Bool)
+    {
+      return false;
+    }
+    value.ui8 = (value.ui8 == 0) ? 1 : 0;
+    return true;
+  }
+  default:
+  {
+    return false;
+  }
+  }  // switch
+}
+
+}  // namespace
+
+/**
+ * Optimise all of the functions in the script
+ *
+ * @param script The script which has just been produced by the generator
+ * @return The report of the instructions saved by each of the passes
+ */
+Optimiser::Report Optimiser::Optimise(Script &script)
+{
+  Report report;
+
+  for (auto &function : script.functions)
+  {
+    report.constant_folding += FoldConstants(function);
+    report.dead_stores += RemoveDeadStores(function);
+    report.superinstructions += FuseInstructions(function);
+    report.jump_threading += ThreadJumps(function, report.jumps_threaded);
+  }
+
+  return report;
+}
+
+/**
+ * Evaluate arithmetic on constant operands, i.e. replace the sequence PushConstant, PushConstant,
+ * Add with a single PushConstant of the result. Nested expressions fold in a single pass since
+ * the result of a fold can be the operand of the next one.
+ *
+ * @param function The function to be optimised
+ * @return The number of instructions removed
+ */
+std::size_t Optimiser::FoldConstants(Script::Function &function)
+{
+  Instructions &           instructions = function.instructions;
+  Flags const              targets      = FindJumpTargets(instructions);
+  Flags                    removed(instructions.size(), false);
+  std::vector<std::size_t> kept;
+
+  // none of the instructions after the first one of a sequence may be a jump target
+  auto const is_straight_line = [&targets](std::size_t first, std::size_t last) {
+    for (std::size_t i = first + 1; i <= last; ++i)
+    {
+      if (targets[i])
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  for (std::size_t i = 0; i < instructions.size(); ++i)
+  {
+    Instruction const &instruction = instructions[i];
+    std::size_t const  num_kept    = kept.size();
+
+    if (num_kept >= 2)
+    {
+      Instruction &lhs = instructions[kept[num_kept - 2]];
+      Instruction &rhs = instructions[kept[num_kept - 1]];
+
+      if ((lhs.opcode == Opcodes::PushConstant) && (rhs.opcode == Opcodes::PushConstant) &&
+          (lhs.type_id == instruction.type_id) && (rhs.type_id == instruction.type_id) &&
+          is_straight_line(kept[num_kept - 2], i) &&
+          FoldBinaryOp(instruction.opcode, instruction.type_id, lhs.data, rhs.data))
+      {
+        removed[kept[num_kept - 1]] = true;
+        removed[i]                  = true;
+        kept.pop_back();
+        continue;
+      }
+    }
+
+    if (num_kept >= 1)
+    {
+      Instruction &operand = instructions[kept[num_kept - 1]];
+
+      if ((operand.opcode == Opcodes::PushConstant) && (operand.type_id == instruction.type_id) &&
+          is_straight_line(kept[num_kept - 1], i) &&
+          FoldUnaryOp(instruction.opcode, instruction.type_id, operand.data))
+      {
+        removed[i] = true;
+        continue;
+      }
+    }
+
+    kept.push_back(i);
+  }
+
+  return Compact(function, removed);
+}
+
+/**
+ * Remove values which are computed but never used. Stores to primitive variables which are never
+ * read are turned into discards, and pure pushes which are immediately discarded are removed.
+ *
+ * @param function The function to be optimised
+ * @return The number of instructions removed
+ */
+std::size_t Optimiser::RemoveDeadStores(Script::Function &function)
+{
+  Instructions &instructions = function.instructions;
+  Flags         read(function.variables.size(), false);
+
+  for (auto const &instruction : instructions)
+  {
+    if (ReadsVariable(instruction.opcode) && (instruction.index < read.size()))
+    {
+      read[instruction.index] = true;
+    }
+  }
+
+  for (auto &instruction : instructions)
+  {
+    bool const is_store = (instruction.opcode == Opcodes::PopToVariable) ||
+                          ((instruction.opcode == Opcodes::VarDeclareAssign) &&
+                           (instruction.data.i32 == -1));
+
+    if (is_store && (instruction.index < read.size()) && !read[instruction.index] &&
+        IsPrimitiveType(function.variables[instruction.index].type_id))
+    {
+      instruction.opcode = Opcodes::Discard;
+    }
+  }
+
+  Flags const targets = FindJumpTargets(instructions);
+  Flags       removed(instructions.size(), false);
+
+  for (std::size_t i = 0; i + 1 < instructions.size(); ++i)
+  {
+    if (IsPurePush(instructions[i].opcode) && (instructions[i + 1].opcode == Opcodes::Discard) &&
+        !targets[i + 1])
+    {
+      removed[i]     = true;
+      removed[i + 1] = true;
+      ++i;
+    }
+  }
+
+  return Compact(function, removed);
+}
+
+/**
+ * Replace common instruction sequences with a single superinstruction
+ *
+ * @param function The function to be optimised
+ * @return The number of instructions removed
+ */
+std::size_t Optimiser::FuseInstructions(Script::Function &function)
+{
+  Instructions &instructions = function.instructions;
+  Flags const   targets      = FindJumpTargets(instructions);
+  Flags         removed(instructions.size(), false);
+  std::size_t   i = 0;
+
+  // determine if the sequences starting at i has the given length and is free of jump targets
+  auto const is_sequence = [&](std::size_t length) {
+    if (i + length > instructions.size())
+    {
+      return false;
+    }
+    for (std::size_t j = i + 1; j < i + length; ++j)
+    {
+      if (targets[j])
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  auto const fuse = [&](std::size_t length) {
+    for (std::size_t j = i + 1; j < i + length; ++j)
+    {
+      removed[j] = true;
+    }
+    i += length;
+  };
+
+  while (i < instructions.size())
+  {
+    Instruction &first = instructions[i];
+
+    // x++; x--; ++x; --x; as statements: VariablePostfixInc, Discard -> VariableInc
+    if (is_sequence(2) && (instructions[i + 1].opcode == Opcodes::Discard))
+    {
+      if ((first.opcode == Opcodes::VariablePrefixInc) ||
+          (first.opcode == Opcodes::VariablePostfixInc))
+      {
+        first.opcode = Opcodes::VariableInc;
+        fuse(2);
+        continue;
+      }
+      if ((first.opcode == Opcodes::VariablePrefixDec) ||
+          (first.opcode == Opcodes::VariablePostfixDec))
+      {
+        first.opcode = Opcodes::VariableDec;
+        fuse(2);
+        continue;
+      }
+    }
+
+    // x = x + c; x = c + x; x = x - c: PushVariable, PushConstant, Add, PopToVariable
+    if (is_sequence(4) && (instructions[i + 3].opcode == Opcodes::PopToVariable))
+    {
+      Instruction const &second = instructions[i + 1];
+      Instruction const &op     = instructions[i + 2];
+      Instruction const &store  = instructions[i + 3];
+
+      Opcode const generic = GetGenericArithmeticOpcode(op.opcode);
+
+      bool const is_add         = generic == Opcodes::Add;
+      bool const is_subtract    = generic == Opcodes::Subtract;
+      bool const same_type      = IsNumberType(store.type_id) && (first.type_id == store.type_id) &&
+                             (second.type_id == store.type_id) && (op.type_id == store.type_id);
+      bool const variable_first = (first.opcode == Opcodes::PushVariable) &&
+                                  (first.index == store.index) &&
+                                  (second.opcode == Opcodes::PushConstant);
+      bool const constant_first = (first.opcode == Opcodes::PushConstant) &&
+                                  (second.opcode == Opcodes::PushVariable) &&
+                                  (second.index == store.index);
+
+      if (same_type && ((variable_first && (is_add || is_subtract)) || (constant_first && is_add)))
+      {
+        Primitive const constant = variable_first ? second.data : first.data;
+
+        first.opcode = is_add ? Opcodes::VariableAddConstant : Opcodes::VariableSubtractConstant;
+        first.index  = store.index;
+        first.data   = constant;
+        fuse(4);
+        continue;
+      }
+    }
+
+    if (is_sequence(2))
+    {
+      Instruction const &second = instructions[i + 1];
+
+      // x += c; x -= c: PushConstant, VariableAddAssign
+      if ((first.opcode == Opcodes::PushConstant) && IsNumberType(second.type_id) &&
+          (first.type_id == second.type_id) &&
+          ((second.opcode == Opcodes::VariableAddAssign) ||
+           (second.opcode == Opcodes::VariableSubtractAssign)))
+      {
+        first.opcode = (second.opcode == Opcodes::VariableAddAssign)
+                           ? Opcodes::VariableAddConstant
+                           : Opcodes::VariableSubtractConstant;
+        first.index = second.index;
+        fuse(2);
+        continue;
+      }
+
+      if (second.opcode == Opcodes::JumpIfFalse)
+      {
+        // if (a < b): LessThan, JumpIfFalse -> LessThanJumpIfFalse
+        Opcode const fused = GetRelationalJumpOpcode(first.opcode);
+        if (fused != Opcodes::Unknown)
+        {
+          first.opcode = fused;
+          first.index  = second.index;
+          fuse(2);
+          continue;
+        }
+
+        // if (!a): Not, JumpIfFalse -> JumpIfTrue
+        if (first.opcode == Opcodes::Not)
+        {
+          first.opcode = Opcodes::JumpIfTrue;
+          first.index  = second.index;
+          fuse(2);
+          continue;
+        }
+      }
+    }
+
+    ++i;
+  }
+
+  return Compact(function, removed);
+}
+
+/**
+ * Retarget jumps which land on an unconditional jump to the final destination, and remove the
+ * unconditional jumps which (then) only jump to the next instruction
+ *
+ * @param function The function to be optimised
+ * @param jumps_threaded Incremented by the number of jumps which were retargeted
+ * @return The number of instructions removed
+ */
+std::size_t Optimiser::ThreadJumps(Script::Function &function, std::size_t &jumps_threaded)
+{
+  Instructions &    instructions = function.instructions;
+  std::size_t const size         = instructions.size();
+  Flags             removed(size, false);
+
+  for (auto &instruction : instructions)
+  {
+    if (!IsJump(instruction.opcode))
+    {
+      continue;
+    }
+
+    // follow the chain of unconditional jumps, the hop limit guards against jump cycles
+    Index target = instruction.index;
+    for (std::size_t hops = 0; (target < size) && (hops < size); ++hops)
+    {
+      Instruction const &next = instructions[target];
+      if ((next.opcode != Opcodes::Jump) || (next.index == target))
+      {
+        break;
+      }
+      target = next.index;
+    }
+
+    if (target != instruction.index)
+    {
+      instruction.index = target;
+      ++jumps_threaded;
+    }
+  }
+
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    if ((instructions[i].opcode == Opcodes::Jump) && (instructions[i].index == i + 1))
+    {
+      removed[i] = true;
+    }
+  }
+
+  return Compact(function, removed);
+}
+
+/**
+ * Determine which of the instructions are the target of a jump
+ *
+ * @param instructions The instructions of the function
+ * @return The flags for each instruction, plus one for the end of the function
+ */
+Optimiser::Flags Optimiser::FindJumpTargets(Script::Instructions const &instructions)
+{
+  Flags targets(instructions.size() + 1, false);
+
+  for (auto const &instruction : instructions)
+  {
+    if (IsJump(instruction.opcode) && (instruction.index < targets.size()))
+    {
+      targets[instruction.index] = true;
+    }
+  }
+
+  return targets;
+}
+
+/**
+ * Erase the removed instructions and update the jump targets to match. A jump to a removed
+ * instruction is updated to jump to the next remaining one.
+ *
+ * @param function The function to be compacted
+ * @param removed The flags of the instructions which are to be removed
+ * @return The number of instructions removed
+ */
+std::size_t Optimiser::Compact(Script::Function &function, Flags const &removed)
+{
+  Instructions &    instructions = function.instructions;
+  std::size_t const size         = instructions.size();
+
+  // the new pc of each of the instructions, and one past the end of the function
+  std::vector<Index> remap(size + 1);
+  Index              pc = 0;
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    remap[i] = pc;
+    if (!removed[i])
+    {
+      ++pc;
+    }
+  }
+  remap[size] = pc;
+
+  if (pc == size)
+  {
+    return 0;
+  }
+
+  Instructions compacted;
+  compacted.reserve(pc);
+  for (std::size_t i = 0; i < size; ++i)
+  {
+    if (removed[i])
+    {
+      continue;
+    }
+
+    compacted.push_back(instructions[i]);
+
+    Instruction &instruction = compacted.back();
+    if (IsJump(instruction.opcode) && (instruction.index <= size))
+    {
+      instruction.index = remap[instruction.index];
+    }
+  }
+
+  instructions = std::move(compacted);
+
+  return size - pc;
+}
+
+}  // namespace vm
+}  // namespace fetch
@@ -17,13 +17,9 @@
 //------------------------------------------------------------------------------
 
 #include "vm/parser.hpp"
+#include "vm/lexer.hpp"
 #include <sstream>
 
-// Must define YYSTYPE and YY_EXTRA_TYPE *before* including the flex-generated header
-#define YYSTYPE fetch::vm::Token
-#define YY_EXTRA_TYPE fetch::vm::Location *
-#include "vm/tokeniser.hpp"
-
 namespace fetch {
 namespace vm {
 
@@ -69,21 +65,9 @@ BlockNodePtr Parser::Parse(std::string const &source, Strings &errors)
 
 void Parser::Tokenise(std::string const &source)
 {
-  tokens_.clear();
-  Location location;
-  yyscan_t scanner;
-  yylex_init_extra(&location, &scanner);
-  YY_BUFFER_STATE bp = yy_scan_string(source.data(), scanner);
-  yy_switch_to_buffer(bp, scanner);
   // There is always at least one token: the last is EndOfInput
-  Token token;
-  do
-  {
-    yylex(&token, scanner);
-    tokens_.push_back(token);
-  } while (token.kind != Token::Kind::EndOfInput);
-  yy_delete_buffer(bp, scanner);
-  yylex_destroy(scanner);
+  Lexer lexer;
+  lexer.Tokenise(source, tokens_);
 }
 
 bool Parser::ParseBlock(BlockNode &node)
@@ -0,0 +1,277 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "vm/profiler.hpp"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace fetch {
+namespace vm {
+namespace {
+
+using FoldedStacks = std::map<std::string, uint64_t>;
+using Microseconds = std::chrono::duration<double, std::micro>;
+
+template <typename Entries>
+void SortByCount(Entries &entries)
+{
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](auto const &a, auto const &b) { return a.second > b.second; });
+}
+
+}  // namespace
+
+constexpr std::size_t Profiler::DEFAULT_MAX_ENTRIES;
+constexpr std::size_t Profiler::ROOT;
+
+Profiler::Profiler()
+  : nodes_(1)
+{}
+
+/**
+ * Set the name which is used for an opcode in the report
+ *
+ * @param opcode The opcode
+ * @param name The name of the opcode
+ */
+void Profiler::SetOpcodeName(Opcode opcode, std::string const &name)
+{
+  if (opcode >= opcode_names_.size())
+  {
+    opcode_names_.resize(std::size_t{opcode} + 1u);
+  }
+  opcode_names_[opcode] = name;
+}
+
+/**
+ * Signal that a user function has been called from the current function, at the line of the last
+ * recorded instruction
+ *
+ * @param function_name The name of the function being called
+ */
+void Profiler::Enter(std::string const &function_name)
+{
+  ChildKey key{function_name, current_line_};
+
+  auto it = nodes_[current_].children.find(key);
+  if (it == nodes_[current_].children.end())
+  {
+    Node node;
+    node.name      = function_name;
+    node.call_line = current_line_;
+    node.parent    = current_;
+    nodes_.push_back(std::move(node));
+
+    it = nodes_[current_].children.emplace(std::move(key), nodes_.size() - 1u).first;
+  }
+
+  current_      = it->second;
+  current_line_ = 0;
+}
+
+/**
+ * Signal that the current function has returned to its caller
+ */
+void Profiler::Leave()
+{
+  if (current_ != ROOT)
+  {
+    current_line_ = nodes_[current_].call_line;
+    current_      = nodes_[current_].parent;
+  }
+}
+
+/**
+ * Signal the end of an execution, which unwinds all the functions that are still active (for
+ * example when a runtime error occurred)
+ */
+void Profiler::EndExecution()
+{
+  current_      = ROOT;
+  current_line_ = 0;
+}
+
+/**
+ * Write the instruction counts in the folded stack format, one line per distinct call stack with
+ * the frames separated by semicolons followed by the number of instructions
+ *
+ * @param stream The stream to be written to
+ * @param with_lines Whether the frames are annotated with the source line, i.e. "fib:12"
+ */
+void Profiler::WriteFoldedStacks(std::ostream &stream, bool with_lines) const
+{
+  FoldedStacks stacks;
+
+  // the frames of each node, built while walking the tree from the root
+  std::vector<std::string> prefixes(nodes_.size());
+  std::vector<std::size_t> pending{ROOT};
+  while (!pending.empty())
+  {
+    std::size_t const index = pending.back();
+    Node const &      node  = nodes_[index];
+    pending.pop_back();
+
+    for (auto const &line_count : node.line_counts)
+    {
+      std::string stack = prefixes[index] + node.name;
+      if (with_lines)
+      {
+        stack += ':' + std::to_string(line_count.first);
+      }
+      stacks[stack] += line_count.second;
+    }
+
+    for (auto const &child : node.children)
+    {
+      std::string &prefix = prefixes[child.second];
+      if (index != ROOT)
+      {
+        prefix = prefixes[index] + node.name;
+        if (with_lines)
+        {
+          prefix += ':' + std::to_string(child.first.second);
+        }
+        prefix += ';';
+      }
+      pending.push_back(child.second);
+    }
+  }
+
+  for (auto const &stack : stacks)
+  {
+    // instructions which were recorded outside of any function have no frames
+    if (!stack.first.empty())
+    {
+      stream << stack.first << ' ' << stack.second << '\n';
+    }
+  }
+}
+
+/**
+ * Write a human readable summary of the hottest opcodes and source lines, and of the time spent in
+ * the module bindings
+ *
+ * @param stream The stream to be written to
+ * @param max_entries The maximum number of entries in each section
+ */
+void Profiler::WriteReport(std::ostream &stream, std::size_t max_entries) const
+{
+  using Entry   = std::pair<std::string, uint64_t>;
+  using Entries = std::vector<Entry>;
+
+  double const total = static_cast<double>(std::max<uint64_t>(instruction_count_, 1));
+
+  auto const write_counts = [&stream, max_entries, total](Entries &entries) {
+    SortByCount(entries);
+    for (std::size_t i = 0, end = std::min(entries.size(), max_entries); i < end; ++i)
+    {
+      stream << "  " << std::left << std::setw(40) << entries[i].first << std::right
+             << std::setw(14) << entries[i].second << std::setw(9) << std::fixed
+             << std::setprecision(2) << (100.0 * static_cast<double>(entries[i].second) / total)
+             << "%\n";
+    }
+  };
+
+  stream << "Instructions: " << instruction_count_ << "\n\nOpcodes:\n";
+  Entries opcodes;
+  for (std::size_t opcode = 0; opcode < opcode_stats_.size(); ++opcode)
+  {
+    if (opcode_stats_[opcode].count != 0)
+    {
+      opcodes.emplace_back(OpcodeName(static_cast<Opcode>(opcode)), opcode_stats_[opcode].count);
+    }
+  }
+  write_counts(opcodes);
+
+  stream << "\nLines:\n";
+  FoldedStacks lines;
+  for (auto const &node : nodes_)
+  {
+    for (auto const &line_count : node.line_counts)
+    {
+      lines[node.name + ':' + std::to_string(line_count.first)] += line_count.second;
+    }
+  }
+  Entries line_entries(lines.begin(), lines.end());
+  write_counts(line_entries);
+
+  stream << "\nModule calls:\n";
+  std::vector<std::pair<Opcode, Duration>> module_calls;
+  for (std::size_t opcode = Opcodes::NumReserved; opcode < opcode_stats_.size(); ++opcode)
+  {
+    auto const &stats = opcode_stats_[opcode];
+    if (stats.count != 0)
+    {
+      module_calls.emplace_back(static_cast<Opcode>(opcode), stats.module_call_time);
+    }
+  }
+  SortByCount(module_calls);
+  for (std::size_t i = 0, end = std::min(module_calls.size(), max_entries); i < end; ++i)
+  {
+    Opcode const   opcode = module_calls[i].first;
+    uint64_t const calls  = opcode_stats_[opcode].count;
+    double const   micros = Microseconds(module_calls[i].second).count();
+    stream << "  " << std::left << std::setw(40) << OpcodeName(opcode) << std::right
+           << std::setw(14) << calls << std::setw(14) << std::fixed << std::setprecision(1)
+           << micros << " us" << std::setw(12) << std::setprecision(3)
+           << (micros / static_cast<double>(calls)) << " us/call\n";
+  }
+}
+
+/**
+ * Get the statistics which have been recorded for an opcode
+ *
+ * @param opcode The opcode
+ * @return The statistics of the opcode
+ */
+Profiler::OpcodeStats const &Profiler::opcode_stats(Opcode opcode) const
+{
+  static OpcodeStats const EMPTY{};
+  return (opcode < opcode_stats_.size()) ? opcode_stats_[opcode] : EMPTY;
+}
+
+/**
+ * Get the name of an opcode, falling back to its number when no name has been set
+ *
+ * @param opcode The opcode
+ * @return The name of the opcode
+ */
+std::string Profiler::OpcodeName(Opcode opcode) const
+{
+  if ((opcode < opcode_names_.size()) && !opcode_names_[opcode].empty())
+  {
+    return opcode_names_[opcode];
+  }
+  return "opcode " + std::to_string(opcode);
+}
+
+/**
+ * Discard all the recorded counts, the opcode names are kept
+ */
+void Profiler::Reset()
+{
+  nodes_             = Nodes(1);
+  current_           = ROOT;
+  current_line_      = 0;
+  instruction_count_ = 0;
+  opcode_stats_.clear();
+}
+
+}  // namespace vm
+}  // namespace fetch
@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "vm/typed_opcodes.hpp"
+
+#include <cstddef>
+
+namespace fetch {
+namespace vm {
+namespace {
+
+struct TypedArithmeticOpcode
+{
+  Opcode generic;
+  TypeId type_id;
+  Opcode typed;
+};
+
+// ordered by the specialised opcode, which are allocated consecutively
+TypedArithmeticOpcode const TYPED_ARITHMETIC_OPCODES[] = {
+    {Opcodes::Add, TypeIds::Int32, Opcodes::Int32Add},
+    {Opcodes::Subtract, TypeIds::Int32, Opcodes::Int32Subtract},
+    {Opcodes::Multiply, TypeIds::Int32, Opcodes::Int32Multiply},
+    {Opcodes::Divide, TypeIds::Int32, Opcodes::Int32Divide},
+    {Opcodes::Modulo, TypeIds::Int32, Opcodes::Int32Modulo},
+    {Opcodes::Add, TypeIds::UInt32, Opcodes::UInt32Add},
+    {Opcodes::Subtract, TypeIds::UInt32, Opcodes::UInt32Subtract},
+    {Opcodes::Multiply, TypeIds::UInt32, Opcodes::UInt32Multiply},
+    {Opcodes::Divide, TypeIds::UInt32, Opcodes::UInt32Divide},
+    {Opcodes::Modulo, TypeIds::UInt32, Opcodes::UInt32Modulo},
+    {Opcodes::Add, TypeIds::Int64, Opcodes::Int64Add},
+    {Opcodes::Subtract, TypeIds::Int64, Opcodes::Int64Subtract},
+    {Opcodes::Multiply, TypeIds::Int64, Opcodes::Int64Multiply},
+    {Opcodes::Divide, TypeIds::Int64, Opcodes::Int64Divide},
+    {Opcodes::Modulo, TypeIds::Int64, Opcodes::Int64Modulo},
+    {Opcodes::Add, TypeIds::UInt64, Opcodes::UInt64Add},
+    {Opcodes::Subtract, TypeIds::UInt64, Opcodes::UInt64Subtract},
+    {Opcodes::Multiply, TypeIds::UInt64, Opcodes::UInt64Multiply},
+    {Opcodes::Divide, TypeIds::UInt64, Opcodes::UInt64Divide},
+    {Opcodes::Modulo, TypeIds::UInt64, Opcodes::UInt64Modulo},
+    {Opcodes::Add, TypeIds::Float32, Opcodes::Float32Add},
+    {Opcodes::Subtract, TypeIds::Float32, Opcodes::Float32Subtract},
+    {Opcodes::Multiply, TypeIds::Float32, Opcodes::Float32Multiply},
+    {Opcodes::Divide, TypeIds::Float32, Opcodes::Float32Divide},
+    {Opcodes::Add, TypeIds::Float64, Opcodes::Float64Add},
+    {Opcodes::Subtract, TypeIds::Float64, Opcodes::Float64Subtract},
+    {Opcodes::Multiply, TypeIds::Float64, Opcodes::Float64Multiply},
+    {Opcodes::Divide, TypeIds::Float64, Opcodes::Float64Divide},
+};
+
+}  // namespace
+
+Opcode GetTypedArithmeticOpcode(Opcode opcode, TypeId type_id)
+{
+  for (auto const &entry : TYPED_ARITHMETIC_OPCODES)
+  {
+    if ((entry.generic == opcode) && (entry.type_id == type_id))
+    {
+      return entry.typed;
+    }
+  }
+  return Opcodes::Unknown;
+}
+
+Opcode GetGenericArithmeticOpcode(Opcode opcode)
+{
+  std::size_t const count = sizeof(TYPED_ARITHMETIC_OPCODES) / sizeof(TYPED_ARITHMETIC_OPCODES[0]);
+  Opcode const      first = TYPED_ARITHMETIC_OPCODES[0].typed;
+
+  if ((opcode >= first) && (std::size_t(opcode - first) < count))
+  {
+    return TYPED_ARITHMETIC_OPCODES[opcode - first].generic;
+  }
+  return opcode;
+}
+
+}  // namespace vm
+}  // namespace fetch
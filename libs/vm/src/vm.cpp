@@ -18,124 +18,324 @@
 
 #include "vm/vm.hpp"
 #include "vm/module.hpp"
+#include "vm/profiler.hpp"
 #include <sstream>
 
 namespace fetch {
 namespace vm {
 
+// The builtin opcodes paired with the member function which handles each of them. Opcodes from
+// extension modules are not part of this list, they are always dispatched through the handler
+// table.
+#define FETCH_VM_BUILTIN_OPCODES(X)                                                                \
+  X(VarDeclare, VarDeclare)                                                                        \
+  X(VarDeclareAssign, VarDeclareAssign)                                                            \
+  X(PushConstant, PushConstant)                                                                    \
+  X(PushString, PushString)                                                                        \
+  X(PushNull, PushNull)                                                                            \
+  X(PushVariable, PushVariable)                                                                    \
+  X(PushElement, PushElement)                                                                      \
+  X(PopToVariable, PopToVariable)                                                                  \
+  X(PopToElement, PopToElement)                                                                    \
+  X(Discard, Discard)                                                                              \
+  X(Destruct, Destruct)                                                                            \
+  X(Break, Break)                                                                                  \
+  X(Continue, Continue)                                                                            \
+  X(Jump, Jump)                                                                                    \
+  X(JumpIfFalse, JumpIfFalse)                                                                      \
+  X(JumpIfTrue, JumpIfTrue)                                                                        \
+  X(Return, Return)                                                                                \
+  X(ReturnValue, Return)                                                                           \
+  X(ToInt8, ToInt8)                                                                                \
+  X(ToByte, ToByte)                                                                                \
+  X(ToInt16, ToInt16)                                                                              \
+  X(ToUInt16, ToUInt16)                                                                            \
+  X(ToInt32, ToInt32)                                                                              \
+  X(ToUInt32, ToUInt32)                                                                            \
+  X(ToInt64, ToInt64)                                                                              \
+  X(ToUInt64, ToUInt64)                                                                            \
+  X(ToFloat32, ToFloat32)                                                                          \
+  X(ToFloat64, ToFloat64)                                                                          \
+  X(ForRangeInit, ForRangeInit)                                                                    \
+  X(ForRangeIterate, ForRangeIterate)                                                              \
+  X(ForRangeTerminate, ForRangeTerminate)                                                          \
+  X(InvokeUserFunction, InvokeUserFunction)                                                        \
+  X(Equal, Equal)                                                                                  \
+  X(ObjectEqual, ObjectEqual)                                                                      \
+  X(NotEqual, NotEqual)                                                                            \
+  X(ObjectNotEqual, ObjectNotEqual)                                                                \
+  X(LessThan, LessThan)                                                                            \
+  X(ObjectLessThan, ObjectLessThan)                                                                \
+  X(LessThanOrEqual, LessThanOrEqual)                                                              \
+  X(ObjectLessThanOrEqual, ObjectLessThanOrEqual)                                                  \
+  X(GreaterThan, GreaterThan)                                                                      \
+  X(ObjectGreaterThan, ObjectGreaterThan)                                                          \
+  X(GreaterThanOrEqual, GreaterThanOrEqual)                                                        \
+  X(ObjectGreaterThanOrEqual, ObjectGreaterThanOrEqual)                                            \
+  X(And, And)                                                                                      \
+  X(Or, Or)                                                                                        \
+  X(Not, Not)                                                                                      \
+  X(VariablePrefixInc, VariablePrefixInc)                                                          \
+  X(VariablePrefixDec, VariablePrefixDec)                                                          \
+  X(VariablePostfixInc, VariablePostfixInc)                                                        \
+  X(VariablePostfixDec, VariablePostfixDec)                                                        \
+  X(ElementPrefixInc, ElementPrefixInc)                                                            \
+  X(ElementPrefixDec, ElementPrefixDec)                                                            \
+  X(ElementPostfixInc, ElementPostfixInc)                                                          \
+  X(ElementPostfixDec, ElementPostfixDec)                                                          \
+  X(Modulo, Modulo)                                                                                \
+  X(VariableModuloAssign, VariableModuloAssign)                                                    \
+  X(ElementModuloAssign, ElementModuloAssign)                                                      \
+  X(UnaryMinus, UnaryMinus)                                                                        \
+  X(ObjectUnaryMinus, ObjectUnaryMinus)                                                            \
+  X(Add, Add)                                                                                      \
+  X(LeftAdd, LeftAdd)                                                                              \
+  X(RightAdd, RightAdd)                                                                            \
+  X(ObjectAdd, ObjectAdd)                                                                          \
+  X(VariableAddAssign, VariableAddAssign)                                                          \
+  X(VariableRightAddAssign, VariableRightAddAssign)                                                \
+  X(VariableObjectAddAssign, VariableObjectAddAssign)                                              \
+  X(ElementAddAssign, ElementAddAssign)                                                            \
+  X(ElementRightAddAssign, ElementRightAddAssign)                                                  \
+  X(ElementObjectAddAssign, ElementObjectAddAssign)                                                \
+  X(Subtract, Subtract)                                                                            \
+  X(LeftSubtract, LeftSubtract)                                                                    \
+  X(RightSubtract, RightSubtract)                                                                  \
+  X(ObjectSubtract, ObjectSubtract)                                                                \
+  X(VariableSubtractAssign, VariableSubtractAssign)                                                \
+  X(VariableRightSubtractAssign, VariableRightSubtractAssign)                                      \
+  X(VariableObjectSubtractAssign, VariableObjectSubtractAssign)                                    \
+  X(ElementSubtractAssign, ElementSubtractAssign)                                                  \
+  X(ElementRightSubtractAssign, ElementRightSubtractAssign)                                        \
+  X(ElementObjectSubtractAssign, ElementObjectSubtractAssign)                                      \
+  X(Multiply, Multiply)                                                                            \
+  X(LeftMultiply, LeftMultiply)                                                                    \
+  X(RightMultiply, RightMultiply)                                                                  \
+  X(ObjectMultiply, ObjectMultiply)                                                                \
+  X(VariableMultiplyAssign, VariableMultiplyAssign)                                                \
+  X(VariableRightMultiplyAssign, VariableRightMultiplyAssign)                                      \
+  X(VariableObjectMultiplyAssign, VariableObjectMultiplyAssign)                                    \
+  X(ElementMultiplyAssign, ElementMultiplyAssign)                                                  \
+  X(ElementRightMultiplyAssign, ElementRightMultiplyAssign)                                        \
+  X(ElementObjectMultiplyAssign, ElementObjectMultiplyAssign)                                      \
+  X(Divide, Divide)                                                                                \
+  X(LeftDivide, LeftDivide)                                                                        \
+  X(RightDivide, RightDivide)                                                                      \
+  X(ObjectDivide, ObjectDivide)                                                                    \
+  X(VariableDivideAssign, VariableDivideAssign)                                                    \
+  X(VariableRightDivideAssign, VariableRightDivideAssign)                                          \
+  X(VariableObjectDivideAssign, VariableObjectDivideAssign)                                        \
+  X(ElementDivideAssign, ElementDivideAssign)                                                      \
+  X(ElementRightDivideAssign, ElementRightDivideAssign)                                            \
+  X(ElementObjectDivideAssign, ElementObjectDivideAssign)                                          \
+  X(VariableInc, VariableInc)                                                                      \
+  X(VariableDec, VariableDec)                                                                      \
+  X(VariableAddConstant, VariableAddConstant)                                                      \
+  X(VariableSubtractConstant, VariableSubtractConstant)                                            \
+  X(EqualJumpIfFalse, EqualJumpIfFalse)                                                            \
+  X(NotEqualJumpIfFalse, NotEqualJumpIfFalse)                                                      \
+  X(LessThanJumpIfFalse, LessThanJumpIfFalse)                                                      \
+  X(LessThanOrEqualJumpIfFalse, LessThanOrEqualJumpIfFalse)                                        \
+  X(GreaterThanJumpIfFalse, GreaterThanJumpIfFalse)                                                \
+  X(GreaterThanOrEqualJumpIfFalse, GreaterThanOrEqualJumpIfFalse)                                  \
+  X(Int32Add, Int32Add)                                                                            \
+  X(Int32Subtract, Int32Subtract)                                                                  \
+  X(Int32Multiply, Int32Multiply)                                                                  \
+  X(Int32Divide, Int32Divide)                                                                      \
+  X(Int32Modulo, Int32Modulo)                                                                      \
+  X(UInt32Add, UInt32Add)                                                                          \
+  X(UInt32Subtract, UInt32Subtract)                                                                \
+  X(UInt32Multiply, UInt32Multiply)                                                                \
+  X(UInt32Divide, UInt32Divide)                                                                    \
+  X(UInt32Modulo, UInt32Modulo)                                                                    \
+  X(Int64Add, Int64Add)                                                                            \
+  X(Int64Subtract, Int64Subtract)                                                                  \
+  X(Int64Multiply, Int64Multiply)                                                                  \
+  X(Int64Divide, Int64Divide)                                                                      \
+  X(Int64Modulo, Int64Modulo)                                                                      \
+  X(UInt64Add, UInt64Add)                                                                          \
+  X(UInt64Subtract, UInt64Subtract)                                                                \
+  X(UInt64Multiply, UInt64Multiply)                                                                \
+  X(UInt64Divide, UInt64Divide)                                                                    \
+  X(UInt64Modulo, UInt64Modulo)                                                                    \
+  X(Float32Add, Float32Add)                                                                        \
+  X(Float32Subtract, Float32Subtract)                                                              \
+  X(Float32Multiply, Float32Multiply)                                                              \
+  X(Float32Divide, Float32Divide)                                                                  \
+  X(Float64Add, Float64Add)                                                                        \
+  X(Float64Subtract, Float64Subtract)                                                              \
+  X(Float64Multiply, Float64Multiply)                                                              \
+  X(Float64Divide, Float64Divide)
+
+constexpr std::size_t VM::INITIAL_STACK_SIZE;
+constexpr std::size_t VM::INITIAL_AUXILIARY_SIZE;
+
+/**
+ * Get the default execution limits
+ *
+ * @return The default limits
+ */
+VM::Limits VM::DefaultLimits()
+{
+  Limits limits{};
+  limits.stack_size       = 32768;
+  limits.frame_stack_size = 1024;
+  limits.max_live_objects = 8192;
+  limits.max_range_loops  = 256;
+  return limits;
+}
+
 VM::VM(Module *module)
+  : VM(module, DefaultLimits())
+{}
+
+VM::VM(Module *module, Limits const &limits)
+  : limits_{limits}
+  , arena_{ObjectArena::Create()}
+  , frame_stack_(std::min(INITIAL_AUXILIARY_SIZE, limits.frame_stack_size))
+  , range_loop_stack_(std::min(INITIAL_AUXILIARY_SIZE, limits.max_range_loops))
+  , live_object_stack_(std::min(INITIAL_AUXILIARY_SIZE, limits.max_live_objects))
+{
+  // the capacity for the whole stack is reserved (but not constructed) up front, with a spare slot
+  // to park the stack pointer on overflow, so that growing it never invalidates any references
+  stack_.reserve(limits_.stack_size + 1);
+  ReserveStack(std::min(INITIAL_STACK_SIZE, limits_.stack_size));
+
+  LoadModule(*module);
+
+  // the objects allocated by the executions are charged for
+  arena_->SetAllocationCounter(&charge_total_);
+}
+
+VM::~VM()
+{
+  // the arena outlives any objects which are still referenced
+  arena_->SetAllocationCounter(nullptr);
+  arena_->Release();
+}
+
+/**
+ * Prepare the VM to be reused for an unrelated execution, dropping the console output, the IO
+ * observer and the profiler of the previous one. The storage of the stacks is retained.
+ */
+void VM::Reset()
+{
+  output_buffer_.str(std::string{});
+  output_buffer_.clear();
+  io_observer_  = nullptr;
+  profiler_     = nullptr;
+  charge_total_ = 0;
+  SetChargeLimit(0);
+}
+
+/**
+ * Attach a profiler which records every instruction of the following executions. Profiled
+ * executions always go through the handler table, regardless of the dispatch mode.
+ *
+ * @param profiler The profiler, or nullptr to stop profiling
+ */
+void VM::SetProfiler(Profiler *profiler)
+{
+  profiler_ = profiler;
+  if (profiler_ != nullptr)
+  {
+    auto const &names = tables_->names;
+    for (std::size_t opcode = 0; opcode < names.size(); ++opcode)
+    {
+      if (!names[opcode].empty())
+      {
+        profiler_->SetOpcodeName(static_cast<Opcode>(opcode), names[opcode]);
+      }
+    }
+  }
+}
+
+/**
+ * Build the dispatch tables for a module, from the builtin opcodes and the bindings of the module
+ *
+ * @param module The module
+ * @return The tables, which can be shared by any number of VMs
+ */
+VM::TablesPtr VM::CreateTables(Module const &module)
+{
+  static std::vector<OpcodeHandlerInfo> const builtins = {
+#define FETCH_VM_HANDLER_INFO(OPCODE, HANDLER)                                                     \
+  {Opcodes::OPCODE, [](VM *vm) { vm->HANDLER(); }, DEFAULT_OPCODE_CHARGE, #OPCODE},
+      FETCH_VM_BUILTIN_OPCODES(FETCH_VM_HANDLER_INFO)
+#undef FETCH_VM_HANDLER_INFO
+  };
+
+  auto        tables   = std::make_shared<Tables>();
+  auto const &bindings = *module.bindings_;
+
+  std::size_t const size =
+      std::max(std::size_t{Opcodes::NumReserved}, std::size_t{bindings.next_opcode});
+  tables->handlers.resize(size);
+  tables->names.resize(size);
+  tables->charges.assign(size, DEFAULT_OPCODE_CHARGE);
+  tables->registered_types = bindings.registered_types;
+
+  auto add = [&tables](OpcodeHandlerInfo const &info) {
+    if (info.opcode < tables->handlers.size())
+    {
+      tables->handlers[info.opcode] = info.handler;
+      tables->names[info.opcode]    = info.name;
+      tables->charges[info.opcode]  = info.charge;
+    }
+  };
+  std::for_each(builtins.begin(), builtins.end(), add);
+  std::for_each(bindings.opcode_handler_info_array.begin(),
+                bindings.opcode_handler_info_array.end(), add);
+
+  for (auto const &entry : bindings.opcode_charge_overrides)
+  {
+    if (entry.first < tables->charges.size())
+    {
+      tables->charges[entry.first] = entry.second;
+    }
+  }
+
+  return tables;
+}
+
+/**
+ * Set up the handlers, types and charges from a module. This is also used to switch a pooled VM to
+ * another module with the same layout.
+ *
+ * @param module The module
+ */
+void VM::LoadModule(Module const &module)
 {
-  std::vector<OpcodeHandlerInfo> array = {
-      {Opcodes::VarDeclare, [](VM *vm) { vm->VarDeclare(); }},
-      {Opcodes::VarDeclareAssign, [](VM *vm) { vm->VarDeclareAssign(); }},
-      {Opcodes::PushConstant, [](VM *vm) { vm->PushConstant(); }},
-      {Opcodes::PushString, [](VM *vm) { vm->PushString(); }},
-      {Opcodes::PushNull, [](VM *vm) { vm->PushNull(); }},
-      {Opcodes::PushVariable, [](VM *vm) { vm->PushVariable(); }},
-      {Opcodes::PushElement, [](VM *vm) { vm->PushElement(); }},
-      {Opcodes::PopToVariable, [](VM *vm) { vm->PopToVariable(); }},
-      {Opcodes::PopToElement, [](VM *vm) { vm->PopToElement(); }},
-      {Opcodes::Discard, [](VM *vm) { vm->Discard(); }},
-      {Opcodes::Destruct, [](VM *vm) { vm->Destruct(); }},
-      {Opcodes::Break, [](VM *vm) { vm->Break(); }},
-      {Opcodes::Continue, [](VM *vm) { vm->Continue(); }},
-      {Opcodes::Jump, [](VM *vm) { vm->Jump(); }},
-      {Opcodes::JumpIfFalse, [](VM *vm) { vm->JumpIfFalse(); }},
-      {Opcodes::JumpIfTrue, [](VM *vm) { vm->JumpIfTrue(); }},
-      {Opcodes::Return, [](VM *vm) { vm->Return(); }},
-      {Opcodes::ReturnValue, [](VM *vm) { vm->Return(); }},
-      {Opcodes::ToInt8, [](VM *vm) { vm->ToInt8(); }},
-      {Opcodes::ToByte, [](VM *vm) { vm->ToByte(); }},
-      {Opcodes::ToInt16, [](VM *vm) { vm->ToInt16(); }},
-      {Opcodes::ToUInt16, [](VM *vm) { vm->ToUInt16(); }},
-      {Opcodes::ToInt32, [](VM *vm) { vm->ToInt32(); }},
-      {Opcodes::ToUInt32, [](VM *vm) { vm->ToUInt32(); }},
-      {Opcodes::ToInt64, [](VM *vm) { vm->ToInt64(); }},
-      {Opcodes::ToUInt64, [](VM *vm) { vm->ToUInt64(); }},
-      {Opcodes::ToFloat32, [](VM *vm) { vm->ToFloat32(); }},
-      {Opcodes::ToFloat64, [](VM *vm) { vm->ToFloat64(); }},
-      {Opcodes::ForRangeInit, [](VM *vm) { vm->ForRangeInit(); }},
-      {Opcodes::ForRangeIterate, [](VM *vm) { vm->ForRangeIterate(); }},
-      {Opcodes::ForRangeTerminate, [](VM *vm) { vm->ForRangeTerminate(); }},
-      {Opcodes::InvokeUserFunction, [](VM *vm) { vm->InvokeUserFunction(); }},
-      {Opcodes::Equal, [](VM *vm) { vm->Equal(); }},
-      {Opcodes::ObjectEqual, [](VM *vm) { vm->ObjectEqual(); }},
-      {Opcodes::NotEqual, [](VM *vm) { vm->NotEqual(); }},
-      {Opcodes::ObjectNotEqual, [](VM *vm) { vm->ObjectNotEqual(); }},
-      {Opcodes::LessThan, [](VM *vm) { vm->LessThan(); }},
-      {Opcodes::ObjectLessThan, [](VM *vm) { vm->ObjectLessThan(); }},
-      {Opcodes::LessThanOrEqual, [](VM *vm) { vm->LessThanOrEqual(); }},
-      {Opcodes::ObjectLessThanOrEqual, [](VM *vm) { vm->ObjectLessThanOrEqual(); }},
-      {Opcodes::GreaterThan, [](VM *vm) { vm->GreaterThan(); }},
-      {Opcodes::ObjectGreaterThan, [](VM *vm) { vm->ObjectGreaterThan(); }},
-      {Opcodes::GreaterThanOrEqual, [](VM *vm) { vm->GreaterThanOrEqual(); }},
-      {Opcodes::ObjectGreaterThanOrEqual, [](VM *vm) { vm->ObjectGreaterThanOrEqual(); }},
-      {Opcodes::And, [](VM *vm) { vm->And(); }},
-      {Opcodes::Or, [](VM *vm) { vm->Or(); }},
-      {Opcodes::Not, [](VM *vm) { vm->Not(); }},
-      {Opcodes::VariablePrefixInc, [](VM *vm) { vm->VariablePrefixInc(); }},
-      {Opcodes::VariablePrefixDec, [](VM *vm) { vm->VariablePrefixDec(); }},
-      {Opcodes::VariablePostfixInc, [](VM *vm) { vm->VariablePostfixInc(); }},
-      {Opcodes::VariablePostfixDec, [](VM *vm) { vm->VariablePostfixDec(); }},
-      {Opcodes::ElementPrefixInc, [](VM *vm) { vm->ElementPrefixInc(); }},
-      {Opcodes::ElementPrefixDec, [](VM *vm) { vm->ElementPrefixDec(); }},
-      {Opcodes::ElementPostfixInc, [](VM *vm) { vm->ElementPostfixInc(); }},
-      {Opcodes::ElementPostfixDec, [](VM *vm) { vm->ElementPostfixDec(); }},
-      {Opcodes::Modulo, [](VM *vm) { vm->Modulo(); }},
-      {Opcodes::VariableModuloAssign, [](VM *vm) { vm->VariableModuloAssign(); }},
-      {Opcodes::ElementModuloAssign, [](VM *vm) { vm->ElementModuloAssign(); }},
-      {Opcodes::UnaryMinus, [](VM *vm) { vm->UnaryMinus(); }},
-      {Opcodes::ObjectUnaryMinus, [](VM *vm) { vm->ObjectUnaryMinus(); }},
-      {Opcodes::Add, [](VM *vm) { vm->Add(); }},
-      {Opcodes::LeftAdd, [](VM *vm) { vm->LeftAdd(); }},
-      {Opcodes::RightAdd, [](VM *vm) { vm->RightAdd(); }},
-      {Opcodes::ObjectAdd, [](VM *vm) { vm->ObjectAdd(); }},
-      {Opcodes::VariableAddAssign, [](VM *vm) { vm->VariableAddAssign(); }},
-      {Opcodes::VariableRightAddAssign, [](VM *vm) { vm->VariableRightAddAssign(); }},
-      {Opcodes::VariableObjectAddAssign, [](VM *vm) { vm->VariableObjectAddAssign(); }},
-      {Opcodes::ElementAddAssign, [](VM *vm) { vm->ElementAddAssign(); }},
-      {Opcodes::ElementRightAddAssign, [](VM *vm) { vm->ElementRightAddAssign(); }},
-      {Opcodes::ElementObjectAddAssign, [](VM *vm) { vm->ElementObjectAddAssign(); }},
-      {Opcodes::Subtract, [](VM *vm) { vm->Subtract(); }},
-      {Opcodes::LeftSubtract, [](VM *vm) { vm->LeftSubtract(); }},
-      {Opcodes::RightSubtract, [](VM *vm) { vm->RightSubtract(); }},
-      {Opcodes::ObjectSubtract, [](VM *vm) { vm->ObjectSubtract(); }},
-      {Opcodes::VariableSubtractAssign, [](VM *vm) { vm->VariableSubtractAssign(); }},
-      {Opcodes::VariableRightSubtractAssign, [](VM *vm) { vm->VariableRightSubtractAssign(); }},
-      {Opcodes::VariableObjectSubtractAssign, [](VM *vm) { vm->VariableObjectSubtractAssign(); }},
-      {Opcodes::ElementSubtractAssign, [](VM *vm) { vm->ElementSubtractAssign(); }},
-      {Opcodes::ElementRightSubtractAssign, [](VM *vm) { vm->ElementRightSubtractAssign(); }},
-      {Opcodes::ElementObjectSubtractAssign, [](VM *vm) { vm->ElementObjectSubtractAssign(); }},
-      {Opcodes::Multiply, [](VM *vm) { vm->Multiply(); }},
-      {Opcodes::LeftMultiply, [](VM *vm) { vm->LeftMultiply(); }},
-      {Opcodes::RightMultiply, [](VM *vm) { vm->RightMultiply(); }},
-      {Opcodes::ObjectMultiply, [](VM *vm) { vm->ObjectMultiply(); }},
-      {Opcodes::VariableMultiplyAssign, [](VM *vm) { vm->VariableMultiplyAssign(); }},
-      {Opcodes::VariableRightMultiplyAssign, [](VM *vm) { vm->VariableRightMultiplyAssign(); }},
-      {Opcodes::VariableObjectMultiplyAssign, [](VM *vm) { vm->VariableObjectMultiplyAssign(); }},
-      {Opcodes::ElementMultiplyAssign, [](VM *vm) { vm->ElementMultiplyAssign(); }},
-      {Opcodes::ElementRightMultiplyAssign, [](VM *vm) { vm->ElementRightMultiplyAssign(); }},
-      {Opcodes::ElementObjectMultiplyAssign, [](VM *vm) { vm->ElementObjectMultiplyAssign(); }},
-      {Opcodes::Divide, [](VM *vm) { vm->Divide(); }},
-      {Opcodes::LeftDivide, [](VM *vm) { vm->LeftDivide(); }},
-      {Opcodes::RightDivide, [](VM *vm) { vm->RightDivide(); }},
-      {Opcodes::ObjectDivide, [](VM *vm) { vm->ObjectDivide(); }},
-      {Opcodes::VariableDivideAssign, [](VM *vm) { vm->VariableDivideAssign(); }},
-      {Opcodes::VariableRightDivideAssign, [](VM *vm) { vm->VariableRightDivideAssign(); }},
-      {Opcodes::VariableObjectDivideAssign, [](VM *vm) { vm->VariableObjectDivideAssign(); }},
-      {Opcodes::ElementDivideAssign, [](VM *vm) { vm->ElementDivideAssign(); }},
-      {Opcodes::ElementRightDivideAssign, [](VM *vm) { vm->ElementRightDivideAssign(); }},
-      {Opcodes::ElementObjectDivideAssign, [](VM *vm) { vm->ElementObjectDivideAssign(); }}};
-  opcode_handlers_ = std::vector<OpcodeHandler>(Opcodes::NumReserved, nullptr);
-  for (auto const &info : array)
-  {
-    AddOpcodeHandler(info);
-  }
-  module->VMSetup(this);
+  tables_         = module.vm_tables();
+  opcode_charges_ = tables_->charges;
+}
+
+/**
+ * Add a charge from a handler whose cost depends on its inputs, for example a module function
+ * which operates on a whole container. The execution is aborted if this exceeds the charge limit.
+ *
+ * @param amount The charge to be added
+ */
+void VM::IncreaseChargeTotal(ChargeAmount amount)
+{
+  charge_total_ += amount;
+  if (charge_total_ > charge_limit_)
+  {
+    ChargeLimitReached();
+  }
+}
+
+void VM::ChargeLimitReached()
+{
+  RuntimeError("charge limit reached (" + std::to_string(charge_limit_) + ")");
 }
 
 bool VM::Execute(std::string &error, Variant &output)
 {
+  // all the objects created by the script (including the string constants) come from the arena,
+  // which is rewound after the call unless some of them are still referenced
+  ObjectArena::Scope const arena_scope{arena_};
+
   size_t const num_strings = script_->strings.size();
   strings_                 = std::vector<Ptr<String>>(num_strings);
   for (size_t i = 0; i < num_strings; ++i)
@@ -151,24 +351,27 @@ bool VM::Execute(std::string &error, Variant &output)
   pc_             = 0;
   instruction_    = nullptr;
   stop_           = false;
+  charge_total_   = 0;
   error_.clear();
   error.clear();
-  do
+  if (profiler_ != nullptr)
   {
-    instruction_ = &function_->instructions[size_t(pc_)];
-    ++pc_;
-    OpcodeHandler handler = opcode_handlers_[instruction_->opcode];
-    if (handler)
-    {
-      handler(this);
-    }
-    else
-    {
-      RuntimeError("unknown opcode");
-      break;
-    }
-  } while (!stop_);
+    ExecuteProfiled();
+  }
+  else if (dispatch_mode_ == DispatchMode::THREADED)
+  {
+    ExecuteThreaded();
+  }
+  else
+  {
+    ExecuteHandlerTable();
+  }
   strings_.clear();
+  if (error_.empty() && (charge_total_ > charge_limit_))
+  {
+    // the final instructions allocated more than the remaining charge
+    ChargeLimitReached();
+  }
   bool const ok = error_.empty();
   if (ok)
   {
@@ -178,19 +381,223 @@ bool VM::Execute(std::string &error, Variant &output)
       Variant &result = stack_[sp_--];
       output          = std::move(result);
     }
+    arena_->Reset();
     // Success
     return true;
   }
   // We've got a runtime error
   // Reset all variables
-  for (int i = 0; i < STACK_SIZE; ++i)
+  for (auto &variable : stack_)
   {
-    stack_[i].Reset();
+    variable.Reset();
   }
+  arena_->Reset();
   error = error_;
   return false;
 }
 
+/**
+ * Run the current function by looking up every instruction in the opcode handler table
+ */
+void VM::ExecuteHandlerTable()
+{
+  do
+  {
+    instruction_ = &function_->instructions[size_t(pc_)];
+    if (!ChargeInstruction())
+    {
+      return;
+    }
+    ++pc_;
+    InvokeOpcodeHandler();
+  } while (!stop_);
+}
+
+/**
+ * The handler table loop, with every instruction recorded by the profiler. The calls and returns
+ * of user functions are detected from the changes in the depth of the frame stack, and the
+ * handlers of the module opcodes are timed.
+ */
+void VM::ExecuteProfiled()
+{
+  Profiler &profiler = *profiler_;
+  profiler.Enter(function_->name);
+  do
+  {
+    instruction_ = &function_->instructions[size_t(pc_)];
+    if (!ChargeInstruction())
+    {
+      break;
+    }
+    Opcode const opcode = instruction_->opcode;
+    profiler.RecordInstruction(opcode, instruction_->line);
+    ++pc_;
+
+    int const depth = frame_sp_;
+    if (opcode >= Opcodes::NumReserved)
+    {
+      auto const start = Profiler::Clock::now();
+      InvokeOpcodeHandler();
+      profiler.RecordModuleCall(opcode, Profiler::Clock::now() - start);
+    }
+    else
+    {
+      InvokeOpcodeHandler();
+    }
+
+    if (frame_sp_ > depth)
+    {
+      profiler.Enter(function_->name);
+    }
+    else if (frame_sp_ < depth)
+    {
+      profiler.Leave();
+    }
+  } while (!stop_);
+  profiler.EndExecution();
+}
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+#if defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wgnu-label-as-value"
+#endif
+
+/**
+ * Run the current function with a direct threaded interpreter.
+ *
+ * With GCC and clang the instructions of every function in the script are pre-decoded into a
+ * stream of label addresses, so that each handler ends with an indirect jump straight to the
+ * handler of the next instruction. The builtin handlers are called directly rather than through
+ * the std::function handler table, only module opcodes still take the table route. On other
+ * compilers this falls back to a switch over the opcode.
+ */
+void VM::ExecuteThreaded()
+{
+#if defined(__GNUC__)
+  using Target  = void *;
+  using Targets = std::vector<Target>;
+
+  // map the opcodes onto their labels, anything not builtin is resolved through the handler table
+  std::vector<Target> labels(Opcodes::NumReserved, &&handler_table);
+#define FETCH_VM_LABEL_TARGET(OPCODE, HANDLER) labels[Opcodes::OPCODE] = &&opcode_##OPCODE;
+  FETCH_VM_BUILTIN_OPCODES(FETCH_VM_LABEL_TARGET)
+#undef FETCH_VM_LABEL_TARGET
+
+  // pre-decode the instruction stream and the charges of every function which might be called
+  Script::Functions const &              functions = script_->functions;
+  std::vector<Targets>                   streams(functions.size());
+  std::vector<std::vector<ChargeAmount>> charge_streams(functions.size());
+  for (std::size_t i = 0; i < functions.size(); ++i)
+  {
+    Script::Instructions const &instructions  = functions[i].instructions;
+    Targets &                   stream        = streams[i];
+    std::vector<ChargeAmount> & charge_stream = charge_streams[i];
+
+    stream.reserve(instructions.size());
+    charge_stream.reserve(instructions.size());
+    for (auto const &instruction : instructions)
+    {
+      stream.push_back((instruction.opcode < labels.size()) ? labels[instruction.opcode]
+                                                            : &&handler_table);
+      charge_stream.push_back(
+          (instruction.opcode < opcode_charges_.size()) ? opcode_charges_[instruction.opcode] : 0);
+    }
+  }
+
+  Script::Function const *current_function = function_;
+  std::size_t             function_index   = std::size_t(function_ - functions.data());
+  Target const *          stream           = streams[function_index].data();
+  ChargeAmount const *    charges          = charge_streams[function_index].data();
+
+  // the stream needs to be switched whenever a call or return has changed the current function
+#define FETCH_VM_DISPATCH()                                                                       \
+  if (stop_)                                                                                      \
+  {                                                                                               \
+    return;                                                                                       \
+  }                                                                                               \
+  if (function_ != current_function)                                                              \
+  {                                                                                               \
+    current_function = function_;                                                                 \
+    function_index   = std::size_t(function_ - functions.data());                                 \
+    stream           = streams[function_index].data();                                            \
+    charges          = charge_streams[function_index].data();                                     \
+  }                                                                                               \
+  instruction_ = &function_->instructions[std::size_t(pc_)];                                      \
+  charge_total_ += charges[pc_];                                                                  \
+  if (charge_total_ > charge_limit_)                                                              \
+  {                                                                                               \
+    ChargeLimitReached();                                                                         \
+    return;                                                                                       \
+  }                                                                                               \
+  goto *stream[pc_++]
+
+  FETCH_VM_DISPATCH();
+
+handler_table:
+  InvokeOpcodeHandler();
+  FETCH_VM_DISPATCH();
+
+#define FETCH_VM_LABEL_HANDLER(OPCODE, HANDLER) \
+  opcode_##OPCODE : HANDLER();                  \
+  FETCH_VM_DISPATCH();
+  FETCH_VM_BUILTIN_OPCODES(FETCH_VM_LABEL_HANDLER)
+#undef FETCH_VM_LABEL_HANDLER
+#undef FETCH_VM_DISPATCH
+
+#else
+  do
+  {
+    instruction_ = &function_->instructions[std::size_t(pc_)];
+    if (!ChargeInstruction())
+    {
+      return;
+    }
+    ++pc_;
+
+    switch (instruction_->opcode)
+    {
+#define FETCH_VM_CASE_HANDLER(OPCODE, HANDLER) \
+  case Opcodes::OPCODE:                        \
+    HANDLER();                                 \
+    break;
+      FETCH_VM_BUILTIN_OPCODES(FETCH_VM_CASE_HANDLER)
+#undef FETCH_VM_CASE_HANDLER
+    default:
+      InvokeOpcodeHandler();
+      break;
+    }
+  } while (!stop_);
+#endif
+}
+
+#if defined(__clang__)
+#pragma clang diagnostic pop
+#endif
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+/**
+ * Invoke the handler table entry for the current instruction
+ */
+void VM::InvokeOpcodeHandler()
+{
+  Opcode const opcode = instruction_->opcode;
+  auto const &handlers = tables_->handlers;
+  if ((opcode < handlers.size()) && handlers[opcode])
+  {
+    handlers[opcode](this);
+  }
+  else
+  {
+    RuntimeError("unknown opcode");
+  }
+}
+
 void VM::RuntimeError(std::string const &message)
 {
   std::stringstream stream;
@@ -199,6 +606,53 @@ void VM::RuntimeError(std::string const &message)
   stop_  = true;
 }
 
+/**
+ * Grow the stack so that it has at least the specified number of slots
+ *
+ * @param size The required number of slots
+ * @return true if successful, false if this would exceed the stack size limit
+ */
+bool VM::ReserveStack(std::size_t size)
+{
+  auto const current = static_cast<std::size_t>(stack_size_);
+  if (size <= current)
+  {
+    return true;
+  }
+  if (size > limits_.stack_size)
+  {
+    return false;
+  }
+
+  std::size_t const new_size = std::max(size, std::min(current * 2, limits_.stack_size));
+  if (new_size > stack_.size())
+  {
+    // always within the reserved capacity
+    stack_.resize(new_size);
+  }
+  stack_size_ = static_cast<int>(new_size);
+
+  return true;
+}
+
+/**
+ * Called when the stack pointer has moved past the end of the stack
+ */
+void VM::GrowStack()
+{
+  if (!ReserveStack(static_cast<std::size_t>(sp_) + 1))
+  {
+    RuntimeError("stack overflow");
+
+    // park the stack pointer on the spare slot, so the current handler can complete safely
+    if (stack_.size() <= limits_.stack_size)
+    {
+      stack_.resize(limits_.stack_size + 1);
+    }
+    sp_ = static_cast<int>(limits_.stack_size);
+  }
+}
+
 void VM::Destruct(int scope_number)
 {
   // Destruct all live objects in the current frame and with scope >= scope_number
@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+#include "vm/vm_pool.hpp"
+#include "vm/module.hpp"
+
+#include <utility>
+
+namespace fetch {
+namespace vm {
+
+constexpr std::size_t VMPool::DEFAULT_MAX_IDLE;
+
+VMPool::Recycler::Recycler(VMPool *pool, uint32_t layout_id)
+  : pool_{pool}
+  , layout_id_{layout_id}
+{}
+
+void VMPool::Recycler::operator()(VM *vm) const
+{
+  if (pool_ != nullptr)
+  {
+    pool_->Recycle(layout_id_, vm);
+  }
+  else
+  {
+    delete vm;
+  }
+}
+
+/**
+ * Construct a pool of VMs with the default execution limits
+ *
+ * @param max_idle The maximum number of VMs kept for reuse
+ */
+VMPool::VMPool(std::size_t max_idle)
+  : VMPool(max_idle, VM::DefaultLimits())
+{}
+
+/**
+ * Construct a pool of VMs
+ *
+ * @param max_idle The maximum number of VMs kept for reuse
+ * @param limits The execution limits of the VMs
+ */
+VMPool::VMPool(std::size_t max_idle, VM::Limits const &limits)
+  : max_idle_{max_idle}
+  , limits_{limits}
+{}
+
+/**
+ * Acquire a VM for the specified module, reusing an idle instance when there is one
+ *
+ * @param module The module which the VM is for
+ * @return The leased VM, which is returned to the pool when it is destroyed
+ */
+VMPool::Lease VMPool::Acquire(Module &module)
+{
+  uint32_t const layout_id = module.LayoutId();
+
+  {
+    FETCH_LOCK(lock_);
+
+    auto it = idle_.find(layout_id);
+    if ((it != idle_.end()) && !it->second.empty())
+    {
+      VMPtr vm = std::move(it->second.back());
+      it->second.pop_back();
+      --num_idle_;
+
+      // modules with the same layout can still bind different handlers and charges
+      vm->LoadModule(module);
+
+      return Lease{vm.release(), Recycler{this, layout_id}};
+    }
+  }
+
+  // constructing the VM sets up the module bindings, which is done outside the lock
+  return Lease{new VM(&module, limits_), Recycler{this, layout_id}};
+}
+
+/**
+ * Get the number of VMs which are available for reuse
+ *
+ * @return The number of idle VMs
+ */
+std::size_t VMPool::idle() const
+{
+  FETCH_LOCK(lock_);
+  return num_idle_;
+}
+
+/**
+ * Return a VM to the pool, or destroy it if the pool is full or it can not be reused
+ *
+ * @param layout_id The layout of the module the VM was constructed from
+ * @param vm The VM being returned
+ */
+void VMPool::Recycle(uint32_t layout_id, VM *vm)
+{
+  VMPtr instance{vm};
+
+  // a VM whose objects are still referenced elsewhere can not be handed to another thread, since
+  // its arena is not thread safe
+  if (!instance || (instance->live_objects() != 0))
+  {
+    return;
+  }
+
+  instance->Reset();
+
+  FETCH_LOCK(lock_);
+
+  if (num_idle_ < max_idle_)
+  {
+    idle_[layout_id].emplace_back(std::move(instance));
+    ++num_idle_;
+  }
+}
+
+}  // namespace vm
+}  // namespace fetch
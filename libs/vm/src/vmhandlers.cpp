@@ -30,6 +30,11 @@ void VM::VarDeclare()
   Variant &variable = GetVariable(instruction_->index);
   if (instruction_->data.i32 != -1)
   {
+    if (!ReserveNext(live_object_stack_, live_object_sp_, limits_.max_live_objects))
+    {
+      RuntimeError("too many live objects");
+      return;
+    }
     variable.Construct(Ptr<Object>(), instruction_->type_id);
     LiveObjectInfo &info = live_object_stack_[++live_object_sp_];
     info.frame_sp        = frame_sp_;
@@ -50,6 +55,11 @@ void VM::VarDeclareAssign()
   variable          = std::move(Pop());
   if (instruction_->data.i32 != -1)
   {
+    if (!ReserveNext(live_object_stack_, live_object_sp_, limits_.max_live_objects))
+    {
+      RuntimeError("too many live objects");
+      return;
+    }
     LiveObjectInfo &info = live_object_stack_[++live_object_sp_];
     info.frame_sp        = frame_sp_;
     info.variable_index  = instruction_->index;
@@ -286,6 +296,11 @@ void VM::ForRangeInit()
     targetv.Reset();
     startv.Reset();
   }
+  if (!ReserveNext(range_loop_stack_, range_loop_sp_, limits_.max_range_loops))
+  {
+    RuntimeError("too many nested range loops");
+    return;
+  }
   range_loop_stack_[++range_loop_sp_] = loop;
 }
 
@@ -443,16 +458,22 @@ void VM::InvokeUserFunction()
   frame.function = function_;
   frame.bsp      = bsp_;
   frame.pc       = pc_;
-  if (frame_sp_ >= FRAME_STACK_SIZE - 1)
+  if (!ReserveNext(frame_stack_, frame_sp_, limits_.frame_stack_size))
   {
     RuntimeError("frame stack overflow");
     return;
   }
+  Script::Function const *function   = &(script_->functions[index]);
+  int const               num_locals = function->num_variables - function->num_parameters;
+  if (!ReserveStack(static_cast<std::size_t>(sp_ + num_locals + 1)))
+  {
+    RuntimeError("stack overflow");
+    return;
+  }
   frame_stack_[++frame_sp_] = frame;
-  function_                 = &(script_->functions[index]);
+  function_                 = function;
   bsp_                      = sp_ - function_->num_parameters + 1;  // first parameter
   pc_                       = 0;
-  int const num_locals      = function_->num_variables - function_->num_parameters;
   sp_ += num_locals;
 }
 
@@ -816,5 +837,203 @@ void VM::ElementObjectDivideAssign()
   DoElementObjectAssignOp<ObjectDivideAssignOp>();
 }
 
+//
+// Superinstruction Handlers
+//
+
+void VM::VariableInc()
+{
+  DoVariableInPlaceIncDecOp<PrefixIncOp>();
+}
+
+void VM::VariableDec()
+{
+  DoVariableInPlaceIncDecOp<PrefixDecOp>();
+}
+
+void VM::VariableAddConstant()
+{
+  DoVariableConstantAssignOp<AddOp>();
+}
+
+void VM::VariableSubtractConstant()
+{
+  DoVariableConstantAssignOp<SubtractOp>();
+}
+
+void VM::EqualJumpIfFalse()
+{
+  DoRelationalJumpIfFalseOp<EqualOp>();
+}
+
+void VM::NotEqualJumpIfFalse()
+{
+  DoRelationalJumpIfFalseOp<NotEqualOp>();
+}
+
+void VM::LessThanJumpIfFalse()
+{
+  DoRelationalJumpIfFalseOp<LessThanOp>();
+}
+
+void VM::LessThanOrEqualJumpIfFalse()
+{
+  DoRelationalJumpIfFalseOp<LessThanOrEqualOp>();
+}
+
+void VM::GreaterThanJumpIfFalse()
+{
+  DoRelationalJumpIfFalseOp<GreaterThanOp>();
+}
+
+void VM::GreaterThanOrEqualJumpIfFalse()
+{
+  DoRelationalJumpIfFalseOp<GreaterThanOrEqualOp>();
+}
+
+//
+// Type Specialised Arithmetic Handlers
+//
+
+void VM::Int32Add()
+{
+  DoTypedNumberOp<AddOp, int32_t, &Primitive::i32>();
+}
+
+void VM::Int32Subtract()
+{
+  DoTypedNumberOp<SubtractOp, int32_t, &Primitive::i32>();
+}
+
+void VM::Int32Multiply()
+{
+  DoTypedNumberOp<MultiplyOp, int32_t, &Primitive::i32>();
+}
+
+void VM::Int32Divide()
+{
+  DoTypedNumberOp<DivideOp, int32_t, &Primitive::i32>();
+}
+
+void VM::Int32Modulo()
+{
+  DoTypedNumberOp<ModuloOp, int32_t, &Primitive::i32>();
+}
+
+void VM::UInt32Add()
+{
+  DoTypedNumberOp<AddOp, uint32_t, &Primitive::ui32>();
+}
+
+void VM::UInt32Subtract()
+{
+  DoTypedNumberOp<SubtractOp, uint32_t, &Primitive::ui32>();
+}
+
+void VM::UInt32Multiply()
+{
+  DoTypedNumberOp<MultiplyOp, uint32_t, &Primitive::ui32>();
+}
+
+void VM::UInt32Divide()
+{
+  DoTypedNumberOp<DivideOp, uint32_t, &Primitive::ui32>();
+}
+
+void VM::UInt32Modulo()
+{
+  DoTypedNumberOp<ModuloOp, uint32_t, &Primitive::ui32>();
+}
+
+void VM::Int64Add()
+{
+  DoTypedNumberOp<AddOp, int64_t, &Primitive::i64>();
+}
+
+void VM::Int64Subtract()
+{
+  DoTypedNumberOp<SubtractOp, int64_t, &Primitive::i64>();
+}
+
+void VM::Int64Multiply()
+{
+  DoTypedNumberOp<MultiplyOp, int64_t, &Primitive::i64>();
+}
+
+void VM::Int64Divide()
+{
+  DoTypedNumberOp<DivideOp, int64_t, &Primitive::i64>();
+}
+
+void VM::Int64Modulo()
+{
+  DoTypedNumberOp<ModuloOp, int64_t, &Primitive::i64>();
+}
+
+void VM::UInt64Add()
+{
+  DoTypedNumberOp<AddOp, uint64_t, &Primitive::ui64>();
+}
+
+void VM::UInt64Subtract()
+{
+  DoTypedNumberOp<SubtractOp, uint64_t, &Primitive::ui64>();
+}
+
+void VM::UInt64Multiply()
+{
+  DoTypedNumberOp<MultiplyOp, uint64_t, &Primitive::ui64>();
+}
+
+void VM::UInt64Divide()
+{
+  DoTypedNumberOp<DivideOp, uint64_t, &Primitive::ui64>();
+}
+
+void VM::UInt64Modulo()
+{
+  DoTypedNumberOp<ModuloOp, uint64_t, &Primitive::ui64>();
+}
+
+void VM::Float32Add()
+{
+  DoTypedNumberOp<AddOp, float, &Primitive::f32>();
+}
+
+void VM::Float32Subtract()
+{
+  DoTypedNumberOp<SubtractOp, float, &Primitive::f32>();
+}
+
+void VM::Float32Multiply()
+{
+  DoTypedNumberOp<MultiplyOp, float, &Primitive::f32>();
+}
+
+void VM::Float32Divide()
+{
+  DoTypedNumberOp<DivideOp, float, &Primitive::f32>();
+}
+
+void VM::Float64Add()
+{
+  DoTypedNumberOp<AddOp, double, &Primitive::f64>();
+}
+
+void VM::Float64Subtract()
+{
+  DoTypedNumberOp<SubtractOp, double, &Primitive::f64>();
+}
+
+void VM::Float64Multiply()
+{
+  DoTypedNumberOp<MultiplyOp, double, &Primitive::f64>();
+}
+
+void VM::Float64Divide()
+{
+  DoTypedNumberOp<DivideOp, double, &Primitive::f64>();
+}
+
 }  // namespace vm
 }  // namespace fetch
@@ -0,0 +1,198 @@
+//------------------------------------------------------------------------------
+//
+//   Copyright 2018-2019 Fetch.AI Limited
+//
+//   Licensed under the Apache License, Version 2.0 (the "License");
+//   you may not use this file except in compliance with the License.
+//   You may obtain a copy of the License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the License is distributed on an "AS IS" BASIS,
+//   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//   See the License for the specific language governing permissions and
+//   limitations under the License.
+//
+//------------------------------------------------------------------------------
+
+#include "benchmark/benchmark.h"
+#include "vm/profiler.hpp"
+#include "vm_modules/vm_factory.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using fetch::vm_modules::VMFactory;
+
+char const *ARITHMETIC = R"(
+function main() : Int32
+  var total : Int32 = 0;
+  for (i in 0:9999)
+    total = total + (i * 3) - (i / 2);
+  endfor
+  return total;
+endfunction
+)";
+
+char const *CONTAINERS = R"(
+function main() : Int32
+  var values = Array<Int32>(1000);
+  var doubled = Map<Int32, Int32>();
+  for (i in 0:999)
+    values[i] = i;
+    doubled[i] = values[i] * 2;
+  endfor
+  var total : Int32 = 0;
+  for (i in 0:999)
+    total = total + doubled[i] - values[i];
+  endfor
+  return total;
+endfunction
+)";
+
+char const *STRINGS = R"(
+function main() : String
+  var text : String = "";
+  for (i in 0:499)
+    text = text + "x" + toString(i);
+  endfor
+  return text;
+endfunction
+)";
+
+char const *MATH_CALLS = R"(
+function main() : Float64
+  var total : Int32 = 0;
+  var distance = 0.0;
+  for (i in 0:9999)
+    total = total + Abs(i - 5000);
+    distance = Abs(distance - 1.5);
+  endfor
+  return distance;
+endfunction
+)";
+
+char const *ML_CALLS = R"(
+function main() : Float32
+  var shape = Array<UInt64>(2);
+  shape[0] = 16u64;
+  shape[1] = 16u64;
+  var error = MeanSquareError();
+  var total = 0.0f;
+  for (i in 0:99)
+    var prediction = Tensor(shape);
+    var truth = Tensor(shape);
+    total = total + error.Forward(prediction, truth);
+  endfor
+  return total;
+endfunction
+)";
+
+/**
+ * A compiled script with a VM to execute it, which also knows the number of instructions that an
+ * execution of it takes
+ */
+class Program
+{
+public:
+  explicit Program(char const *source)
+    : module_{VMFactory::GetModule()}
+  {
+    auto const errors = VMFactory::Compile(module_, source, script_);
+    if (!errors.empty())
+    {
+      throw std::runtime_error("Unable to compile benchmark: " + errors.front());
+    }
+
+    vm_ = VMFactory::GetVM(module_);
+
+    // count the instructions of an execution (outside of the timed loop)
+    fetch::vm::Profiler profiler;
+    vm_->SetProfiler(&profiler);
+    Run();
+    vm_->SetProfiler(nullptr);
+    instructions_ = profiler.instruction_count();
+  }
+
+  void Run()
+  {
+    if (!vm_->Execute(script_, "main", error_, console_, output_))
+    {
+      throw std::runtime_error("Unable to execute benchmark: " + error_);
+    }
+  }
+
+  uint64_t instructions() const
+  {
+    return instructions_;
+  }
+
+private:
+  std::shared_ptr<fetch::vm::Module> module_;
+  fetch::vm::Script                  script_;
+  std::unique_ptr<fetch::vm::VM>     vm_;
+  std::string                        error_;
+  std::string                        console_;
+  fetch::vm::Variant                 output_;
+  uint64_t                           instructions_{0};
+};
+
+void Execute(benchmark::State &state, char const *source)
+{
+  Program program{source};
+  for (auto _ : state)
+  {
+    program.Run();
+  }
+
+  // the inverted rate of the instructions is the time taken by each one
+  auto const instructions = static_cast<double>(program.instructions());
+  state.counters["time/opcode"] = benchmark::Counter(
+      instructions, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+  state.counters["opcodes"] = instructions;
+}
+
+void BM_Compile(benchmark::State &state)
+{
+  std::string source;
+  for (auto const *function : {ARITHMETIC, CONTAINERS, STRINGS, MATH_CALLS, ML_CALLS})
+  {
+    source += function;
+
+    // every function needs a distinct name
+    source.replace(source.rfind("main"), 4, "main" + std::to_string(source.size()));
+  }
+
+  auto const module = VMFactory::GetModule();
+  {
+    fetch::vm::Script script;
+    if (!VMFactory::Compile(module, source, script).empty())
+    {
+      throw std::runtime_error("Unable to compile benchmark");
+    }
+  }
+
+  for (auto _ : state)
+  {
+    fetch::vm::Script script;
+    auto const        errors = VMFactory::Compile(module, source, script);
+    benchmark::DoNotOptimize(errors.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(source.size()));
+}
+BENCHMARK(BM_Compile);
+
+BENCHMARK_CAPTURE(Execute, Arithmetic, ARITHMETIC);
+BENCHMARK_CAPTURE(Execute, Containers, CONTAINERS);
+BENCHMARK_CAPTURE(Execute, Strings, STRINGS);
+BENCHMARK_CAPTURE(Execute, MathModuleCalls, MATH_CALLS);
+BENCHMARK_CAPTURE(Execute, MLModuleCalls, ML_CALLS);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -23,6 +23,7 @@
 #include "vm/compiler.hpp"
 #include "vm/module.hpp"
 #include "vm/vm.hpp"
+#include "vm/vm_pool.hpp"
 
 #include "vm_modules/core/print.hpp"
 #include "vm_modules/core/type_convert.hpp"
@@ -50,27 +51,15 @@ public:
    * Get a module, the VMFactory will add whatever bindings etc. are considered in the 'standard
    * library'
    *
+   * The standard library is only bound once per process and the module returned shares it (along
+   * with the VM tables built from it) until the caller registers further bindings of its own.
+   *
    * @return: The module
    */
   static std::shared_ptr<fetch::vm::Module> GetModule()
   {
-    auto module = std::make_shared<fetch::vm::Module>();
-
-    // core modules
-    CreatePrint(module);
-    CreateToString(module);
-
-    // math modules
-    CreateAbs(module);
-    CreateRand(module);
-
-    // ml modules - order is important!!
-    ml::CreateTensor(module);
-    ml::CreateGraph(module);
-    ml::CreateCrossEntropy(module);
-    ml::CreateMeanSquareError(module);
-
-    return module;
+    static std::shared_ptr<fetch::vm::Module const> const prototype = CreatePrototype();
+    return std::make_shared<fetch::vm::Module>(*prototype);
   }
 
   /**
@@ -125,6 +114,45 @@ public:
   {
     return std::make_unique<fetch::vm::VM>(module.get());
   }
+
+  /**
+   * Acquire a VM from the process wide pool, which is shared between all the modules with the same
+   * bindings. The VM is returned to the pool when the lease goes out of scope.
+   *
+   * @param: module Module which the user has added bindings to
+   *
+   * @return: The leased instance of the VM
+   */
+  static fetch::vm::VMPool::Lease AcquireVM(std::shared_ptr<fetch::vm::Module> const &module)
+  {
+    static fetch::vm::VMPool pool;
+    return pool.Acquire(*module);
+  }
+
+private:
+  static std::shared_ptr<fetch::vm::Module const> CreatePrototype()
+  {
+    auto module = std::make_shared<fetch::vm::Module>();
+
+    // core modules
+    CreatePrint(module);
+    CreateToString(module);
+
+    // math modules
+    CreateAbs(module);
+    CreateRand(module);
+
+    // ml modules - order is important!!
+    ml::CreateTensor(module);
+    ml::CreateGraph(module);
+    ml::CreateCrossEntropy(module);
+    ml::CreateMeanSquareError(module);
+
+    // build the VM tables up front, so that they are shared by all the copies
+    module->vm_tables();
+
+    return module;
+  }
 };
 
 }  // namespace vm_modules
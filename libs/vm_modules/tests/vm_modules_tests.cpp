@@ -17,10 +17,19 @@
 //------------------------------------------------------------------------------
 
 #include "vm/io_observer_interface.hpp"
+#include "vm/lexer.hpp"
+#include "vm/profiler.hpp"
 #include "vm_modules/vm_factory.hpp"
 
 #include <gtest/gtest.h>
 
+#include <sstream>
+
+// Must define YYSTYPE and YY_EXTRA_TYPE *before* including the flex-generated header
+#define YYSTYPE fetch::vm::Token
+#define YY_EXTRA_TYPE fetch::vm::Location *
+#include "vm/tokeniser.hpp"
+
 using namespace fetch;
 using namespace fetch::vm_modules;
 
@@ -160,3 +169,341 @@ TEST_F(VMTests, CheckCustomBinding)
 
   EXPECT_EQ(binding_called_count, 3);
 }
+
+TEST_F(VMTests, CheckModuleCopiesShareBindingsUntilModified)
+{
+  auto other = VMFactory::GetModule();
+
+  // the copies of the standard library share their VM tables
+  EXPECT_EQ(module_->vm_tables(), other->vm_tables());
+  EXPECT_EQ(module_->LayoutId(), other->LayoutId());
+
+  // registering a binding only affects the module which it is registered with
+  AddBinding("CustomBinding", &CustomBinding);
+  EXPECT_NE(module_->vm_tables(), other->vm_tables());
+  EXPECT_NE(module_->LayoutId(), other->LayoutId());
+  EXPECT_EQ(other->LayoutId(), VMFactory::GetModule()->LayoutId());
+
+  const std::string source =
+      " function main() "
+      "   CustomBinding();"
+      " endfunction ";
+
+  ASSERT_TRUE(Compile(source));
+
+  fetch::vm::Script        script;
+  std::vector<std::string> errors = VMFactory::Compile(other, source, script);
+  EXPECT_FALSE(errors.empty());
+}
+
+TEST_F(VMTests, CheckPooledVMIsReused)
+{
+  const std::string source =
+      " function main() "
+      "   Print('Hello, world');"
+      " endfunction ";
+
+  ASSERT_TRUE(Compile(source));
+
+  fetch::vm::VM *first{nullptr};
+
+  {
+    auto vm = VMFactory::AcquireVM(module_);
+    first   = vm.get();
+
+    std::string        error;
+    std::string        console;
+    fetch::vm::Variant output;
+    ASSERT_TRUE(vm->Execute(script_, "main", error, console, output));
+    EXPECT_EQ(console, "Hello, world\n");
+  }
+
+  // a different module instance with the same bindings shares the pooled VM
+  auto vm = VMFactory::AcquireVM(VMFactory::GetModule());
+  EXPECT_EQ(first, vm.get());
+
+  // the console output of the previous execution has been dropped
+  std::string        error;
+  std::string        console;
+  fetch::vm::Variant output;
+  ASSERT_TRUE(vm->Execute(script_, "main", error, console, output));
+  EXPECT_EQ(console, "Hello, world\n");
+}
+
+TEST_F(VMTests, CheckDeepRecursion)
+{
+  const std::string source =
+      " function depth(n : Int32) : Int32 "
+      "   if (n == 0) "
+      "     return 0; "
+      "   endif "
+      "   return depth(n - 1) + 1; "
+      " endfunction "
+      " function main() : Int32 "
+      "   return depth(500); "
+      " endfunction ";
+
+  ASSERT_TRUE(Compile(source));
+
+  vm_ = VMFactory::GetVM(module_);
+
+  std::string        error;
+  std::string        console;
+  fetch::vm::Variant output;
+  ASSERT_TRUE(vm_->Execute(script_, "main", error, console, output));
+  EXPECT_EQ(output.Get<int32_t>(), 500);
+}
+
+TEST_F(VMTests, CheckChargeLimitAbortsExecution)
+{
+  const std::string source =
+      " function main() "
+      "   var i = 0; "
+      "   while (true) "
+      "     i += 1; "
+      "   endwhile "
+      " endfunction ";
+
+  ASSERT_TRUE(Compile(source));
+
+  vm_ = VMFactory::GetVM(module_);
+  vm_->SetChargeLimit(10000);
+
+  std::string        error;
+  std::string        console;
+  fetch::vm::Variant output;
+  EXPECT_FALSE(vm_->Execute(script_, "main", error, console, output));
+  EXPECT_NE(error.find("charge limit reached"), std::string::npos);
+  EXPECT_GT(vm_->charge_total(), 10000u);
+}
+
+static void ExpensiveBinding(fetch::vm::VM * /*vm*/)
+{}
+
+TEST_F(VMTests, CheckModuleFunctionCharges)
+{
+  const std::string source =
+      " function main() "
+      "   ExpensiveBinding(); "
+      " endfunction ";
+
+  module_->CreateFreeFunction("ExpensiveBinding", &ExpensiveBinding, 1000);
+
+  ASSERT_TRUE(Compile(source));
+
+  vm_ = VMFactory::GetVM(module_);
+
+  std::string        error;
+  std::string        console;
+  fetch::vm::Variant output;
+  ASSERT_TRUE(vm_->Execute(script_, "main", error, console, output));
+  EXPECT_GE(vm_->charge_total(), 1000u);
+
+  vm_->SetChargeLimit(999);
+  EXPECT_FALSE(vm_->Execute(script_, "main", error, console, output));
+}
+
+TEST_F(VMTests, CheckTypedArithmetic)
+{
+  const std::string source =
+      " function main() "
+      "   var a = toInt64(-7); "
+      "   var b = toInt64(2); "
+      "   Print(toString(a * b - a / b + a % b)); "
+      "   var c = toUInt64(10); "
+      "   var d = toUInt64(3); "
+      "   Print(toString(c - d * (c / d) + c % d)); "
+      "   var x = toFloat64(3); "
+      "   var y = toFloat64(2); "
+      "   Print(toString(x / y + x * y - x)); "
+      "   var i = 5; "
+      "   var j = 0; "
+      "   Print(toString(i / j)); "
+      " endfunction ";
+
+  ASSERT_TRUE(Compile(source));
+
+  vm_ = VMFactory::GetVM(module_);
+
+  std::string        error;
+  std::string        console;
+  fetch::vm::Variant output;
+  EXPECT_FALSE(vm_->Execute(script_, "main", error, console, output));
+  EXPECT_EQ(console, "-12\n2\n4.500000\n");
+  EXPECT_NE(error.find("division by zero"), std::string::npos);
+}
+
+TEST_F(VMTests, CheckMatrixOperations)
+{
+  const std::string source =
+      " function main() "
+      "   var a = Matrix<Float64>(2, 3); "
+      "   a[0, 0] = 1.0; a[0, 1] = 2.0; a[0, 2] = 3.0; "
+      "   a[1, 0] = 4.0; a[1, 1] = 5.0; a[1, 2] = 6.0; "
+      "   var b = a.transpose(); "
+      "   Print(toString(b.rows()) + 'x' + toString(b.columns())); "
+      "   var c = a * b; "
+      "   Print(toString(c[0, 0]) + ' ' + toString(c[0, 1]) + ' ' + toString(c[1, 1])); "
+      "   var d = a + a * 2.0; "
+      "   d -= a; "
+      "   Print(toString(d[1, 2]) + ' ' + toString(-d[0, 1])); "
+      "   var e = a * a; "
+      " endfunction ";
+
+  ASSERT_TRUE(Compile(source));
+
+  vm_ = VMFactory::GetVM(module_);
+
+  std::string        error;
+  std::string        console;
+  fetch::vm::Variant output;
+  EXPECT_FALSE(vm_->Execute(script_, "main", error, console, output));
+  EXPECT_EQ(console, "3x2\n14.000000 32.000000 77.000000\n12.000000 -4.000000\n");
+  EXPECT_NE(error.find("invalid operation"), std::string::npos);
+}
+
+TEST_F(VMTests, CheckMapOperations)
+{
+  const std::string source =
+      " function main() "
+      "   var small = Map<Int32, Int32>(); "
+      "   small[3] = 30; "
+      "   small[3] = 31; "
+      "   Print(toString(small.count()) + ' ' + toString(small[3])); "
+      "   var large = Map<Int64, Float64>(); "
+      "   for (i in 0:99) "
+      "     large[toInt64(i * 7)] = toFloat64(i); "
+      "   endfor "
+      "   Print(toString(large.count()) + ' ' + toString(large[toInt64(693)])); "
+      "   var names = Map<String, Int32>(); "
+      "   names['one'] = 1; "
+      "   names['two'] = 2; "
+      "   names['one'] = 11; "
+      "   Print(toString(names.count()) + ' ' + toString(names['one'])); "
+      "   Print(toString(large[toInt64(1)])); "
+      " endfunction ";
+
+  ASSERT_TRUE(Compile(source));
+
+  vm_ = VMFactory::GetVM(module_);
+
+  std::string        error;
+  std::string        console;
+  fetch::vm::Variant output;
+  EXPECT_FALSE(vm_->Execute(script_, "main", error, console, output));
+  EXPECT_EQ(console, "1 31\n100 99.000000\n2 11\n");
+  EXPECT_NE(error.find("map key does not exist"), std::string::npos);
+}
+
+TEST_F(VMTests, CheckProfilerRecordsCallStacks)
+{
+  const std::string source =
+      "function fib(n : Int32) : Int32\n"
+      "  if (n < 2)\n"
+      "    return n;\n"
+      "  endif\n"
+      "  return fib(n - 1) + fib(n - 2);\n"
+      "endfunction\n"
+      "function main()\n"
+      "  Print(toString(fib(5)));\n"
+      "endfunction\n";
+
+  ASSERT_TRUE(Compile(source));
+
+  vm_ = VMFactory::GetVM(module_);
+
+  fetch::vm::Profiler profiler;
+  vm_->SetProfiler(&profiler);
+
+  std::string        error;
+  std::string        console;
+  fetch::vm::Variant output;
+  ASSERT_TRUE(vm_->Execute(script_, "main", error, console, output));
+  EXPECT_EQ(console, "5\n");
+
+  std::ostringstream folded;
+  profiler.WriteFoldedStacks(folded);
+
+  // every instruction is attributed to exactly one stack
+  std::istringstream lines{folded.str()};
+  std::string        stack;
+  uint64_t           count = 0;
+  uint64_t           total = 0;
+  bool               found_main{false};
+  bool               found_recursion{false};
+  while (lines >> stack >> count)
+  {
+    found_main |= (stack == "main");
+    found_recursion |= (stack == "main;fib;fib;fib;fib");
+    total += count;
+  }
+  EXPECT_TRUE(found_main);
+  EXPECT_TRUE(found_recursion);
+  EXPECT_EQ(total, profiler.instruction_count());
+
+  std::ostringstream folded_lines;
+  profiler.WriteFoldedStacks(folded_lines, true);
+  EXPECT_NE(folded_lines.str().find("main:8;fib:5;fib:5;fib:3 "), std::string::npos);
+
+  std::ostringstream report;
+  profiler.WriteReport(report);
+  EXPECT_NE(report.str().find("Print"), std::string::npos);
+}
+
+namespace {
+
+std::vector<fetch::vm::Token> GeneratedTokenise(std::string const &source)
+{
+  std::vector<fetch::vm::Token> tokens;
+  fetch::vm::Location           location;
+  yyscan_t                      scanner;
+  yylex_init_extra(&location, &scanner);
+  YY_BUFFER_STATE bp = yy_scan_string(source.data(), scanner);
+  yy_switch_to_buffer(bp, scanner);
+  fetch::vm::Token token;
+  do
+  {
+    yylex(&token, scanner);
+    tokens.push_back(token);
+  } while (token.kind != fetch::vm::Token::Kind::EndOfInput);
+  yy_delete_buffer(bp, scanner);
+  yylex_destroy(scanner);
+  return tokens;
+}
+
+}  // namespace
+
+TEST(LexerTests, CheckLexerMatchesGeneratedTokeniser)
+{
+  std::vector<std::string> const sources = {
+      "",
+      "function main()\n  var x : Int32 = 42;\nendfunction\n",
+      "1 2i8 3u8 4i16 5u16 6i32 7u32 8i64 9u64 10i 11u1 .5 1. 1.5f 2e10 3E-2f 4.e+3 5e 6.f\n",
+      "'single' \"double\" \"esc\\\"aped\" \"bad\n\"line\\\n\" 'open",
+      "/* block\n comment **/ a /* unterminated\n",
+      "// line comment\nb // another\nc\r\n\td",
+      "@init @action @ x @_y",
+      "a+=b-=c*=d/=e%=f==g!=h<=i>=j&&k||l++m--n & o | p ! q < r > s = t / u",
+      "f(a, b)[c]: d; e.f ~ $x \xe2\x82\xac"
+      "true false null while endwhile for in endfor if elseif else endif var return break",
+      "continue endfunction functions if_ _if iffy ABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789",
+      "Map<String, Array<Float64>> m = Map<String, Array<Float64>>();\n"};
+
+  fetch::vm::Lexer              lexer;
+  std::vector<fetch::vm::Token> tokens;
+  for (auto const &source : sources)
+  {
+    lexer.Tokenise(source, tokens);
+    auto const expected = GeneratedTokenise(source);
+
+    ASSERT_EQ(tokens.size(), expected.size()) << source;
+    for (std::size_t i = 0; i < tokens.size(); ++i)
+    {
+      EXPECT_EQ(tokens[i].kind, expected[i].kind) << source << " @ " << i;
+      EXPECT_EQ(tokens[i].offset, expected[i].offset) << source << " @ " << i;
+      EXPECT_EQ(tokens[i].line, expected[i].line) << source << " @ " << i;
+      EXPECT_EQ(tokens[i].length, expected[i].length) << source << " @ " << i;
+      EXPECT_EQ(tokens[i].text, expected[i].text) << source << " @ " << i;
+    }
+  }
+}